@@ -2,6 +2,7 @@
 
 #include <BsCorePrerequisites.h>
 #include <AI/WalkMode.hpp>
+#include <AI/WaypointIndex.hpp>
 #include <AI/WeaponMode.hpp>
 #include <Math/BsVector3.h>
 #include <RTTI/RTTIUtil.hpp>
@@ -17,9 +18,6 @@ namespace BsZenLib
 
 namespace REGoth
 {
-  class Waypoint;
-  using HWaypoint = bs::GameObjectHandle<Waypoint>;
-
   class Character;
   using HCharacter = bs::GameObjectHandle<Character>;
 
@@ -238,7 +236,7 @@ namespace REGoth
        * Route the NPC has to go if this is a ST_GoRoute.
        * If empty, targetPos is used.
        */
-      bs::Vector<HWaypoint> route;
+      bs::Vector<WaypointIndex> route;
 
       /**
        * Object we are going to if this is a ST_GotoVob
@@ -358,6 +356,12 @@ namespace REGoth
        */
       bs::String state;
 
+      /**
+       * Symbol of the function named `state`, if known. Not saved, the name is looked up
+       * again after loading.
+       */
+      Scripting::SymbolIndex stateFunction = Scripting::SYMBOL_INDEX_INVALID;
+
       /**
        * Whether the old state should be ended properly, or be interrupted and canceled.
        */
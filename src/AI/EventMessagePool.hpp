@@ -0,0 +1,147 @@
+#pragma once
+#include <BsCorePrerequisites.h>
+#include <Threading/BsThreading.h>
+#include <core/MemoryAccounting.hpp>
+#include <memory>
+
+namespace REGoth
+{
+  namespace AI
+  {
+    /**
+     * Hands out memory for objects of a single size, e.g. one kind of EventMessage. Freed
+     * blocks are kept in a free list and handed out again, so after the first few messages
+     * no more memory is taken from the heap.
+     *
+     * There is one pool per size and alignment, see instance(). Messages may be created and
+     * released by scripts running on worker threads, so the pool is guarded by a mutex.
+     */
+    template <size_t ElemSize, size_t Alignment>
+    class EventMessagePool
+    {
+    public:
+      /**
+       * @return The pool for blocks of the given size. Never destroyed, as messages kept by
+       *         static objects may be released after the pool would have been.
+       */
+      static EventMessagePool& instance()
+      {
+        static EventMessagePool* s_instance = new EventMessagePool();
+
+        return *s_instance;
+      }
+
+      void* alloc()
+      {
+        bs::Lock lock(mMutex);
+
+        if (!mFree) grow();
+
+        FreeBlock* block = mFree;
+        mFree            = block->next;
+
+        return block;
+      }
+
+      void free(void* data)
+      {
+        bs::Lock lock(mMutex);
+
+        FreeBlock* block = static_cast<FreeBlock*>(data);
+        block->next      = mFree;
+        mFree            = block;
+      }
+
+    private:
+      EventMessagePool() = default;
+
+      struct FreeBlock
+      {
+        FreeBlock* next;
+      };
+
+      /**
+       * A free block is overwritten by the free list, so they need to fit a pointer.
+       */
+      struct alignas(Alignment > alignof(FreeBlock) ? Alignment : alignof(FreeBlock)) Block
+      {
+        bs::UINT8 data[ElemSize > sizeof(FreeBlock) ? ElemSize : sizeof(FreeBlock)];
+      };
+
+      static constexpr size_t BLOCKS_PER_CHUNK = 64;
+
+      /**
+       * Adds a new chunk of blocks to the free list. Chunks are never released.
+       */
+      void grow()
+      {
+        Block* chunk = new Block[BLOCKS_PER_CHUNK];
+
+        gMemoryAccounting().track(MemoryTag::EventMessages, sizeof(Block) * BLOCKS_PER_CHUNK);
+
+        for (size_t i = 0; i < BLOCKS_PER_CHUNK; i++)
+        {
+          FreeBlock* block = reinterpret_cast<FreeBlock*>(&chunk[i]);
+          block->next      = mFree;
+          mFree            = block;
+        }
+      }
+
+      FreeBlock* mFree = nullptr;
+      bs::Mutex mMutex;
+    };
+
+    /**
+     * Allocator for `std::allocate_shared()`, taking single objects from the EventMessagePool
+     * of their type. Since `std::allocate_shared()` puts the object and its reference counts
+     * into one block, every kind of message gets its own pool.
+     */
+    template <typename T>
+    struct EventMessageAllocator
+    {
+      using value_type = T;
+
+      EventMessageAllocator() = default;
+
+      template <typename U>
+      EventMessageAllocator(const EventMessageAllocator<U>&)
+      {
+      }
+
+      T* allocate(size_t n)
+      {
+        if (n != 1) return std::allocator<T>().allocate(n);
+
+        return static_cast<T*>(EventMessagePool<sizeof(T), alignof(T)>::instance().alloc());
+      }
+
+      void deallocate(T* data, size_t n)
+      {
+        if (n != 1) return std::allocator<T>().deallocate(data, n);
+
+        EventMessagePool<sizeof(T), alignof(T)>::instance().free(data);
+      }
+
+      template <typename U>
+      bool operator==(const EventMessageAllocator<U>&) const
+      {
+        return true;
+      }
+
+      template <typename U>
+      bool operator!=(const EventMessageAllocator<U>&) const
+      {
+        return false;
+      }
+    };
+
+    /**
+     * @return Shared copy of the given message, allocated from the pool of its type.
+     */
+    template <typename T>
+    bs::SPtr<T> allocateEventMessage(const T& msg)
+    {
+      return std::allocate_shared<T>(EventMessageAllocator<T>(), msg);
+    }
+  }  // namespace AI
+}  // namespace REGoth
@@ -0,0 +1,86 @@
+#include "LineOfSightQueue.hpp"
+#include <Physics/BsPhysics.h>
+#include <Scene/BsSceneManager.h>
+#include <Utility/BsTime.h>
+#include <exception/Throw.hpp>
+#include <world/PhysicsLayers.hpp>
+
+namespace REGoth
+{
+  namespace AI
+  {
+    bs::SPtr<LineOfSightQuery> LineOfSightQueue::request(const bs::Vector3& from,
+                                                         const bs::Vector3& to)
+    {
+      auto query   = bs::bs_shared_ptr_new<LineOfSightQuery>();
+      query->mFrom = from;
+      query->mTo   = to;
+
+      mPending.push_back(query);
+
+      return query;
+    }
+
+    void LineOfSightQueue::update()
+    {
+      bs::UINT64 frame = bs::gTime().getFrameIdx();
+
+      if (frame == mLastResolvedFrame) return;
+
+      mLastResolvedFrame = frame;
+
+      if (mPending.empty()) return;
+
+      auto physicsScene = bs::gSceneManager().getMainScene()->getPhysicsScene();
+
+      if (!physicsScene)
+      {
+        REGOTH_THROW(InvalidStateException, "Needs a physics scene!");
+      }
+
+      bs::UINT32 batchSize = 0;
+
+      for (const bs::SPtr<LineOfSightQuery>& query : mPending)
+      {
+        // Nobody is waiting for this one anymore
+        if (query.use_count() == 1) continue;
+
+        query->mIsVisible = isLineVisible(*physicsScene, query->mFrom, query->mTo);
+        query->mIsDone    = true;
+
+        batchSize += 1;
+      }
+
+      mStats.lastBatchSize = batchSize;
+      mStats.numBatches += 1;
+      mStats.numQueries += batchSize;
+
+      mPending.clear();
+    }
+
+    bool LineOfSightQueue::isLineVisible(bs::PhysicsScene& physicsScene, const bs::Vector3& from,
+                                         const bs::Vector3& to)
+    {
+      bs::PhysicsQueryHit hit;
+
+      // FIXME: This breaks when the creature should go down a slope but is
+      // standing on the top of it right now
+
+      bs::Vector3 dir = to - from;
+      float distance  = dir.length();
+
+      if (distance == 0.0f) return true;
+
+      dir /= distance;
+
+      // Characters and small props are walked around, only the level itself blocks the way
+      if (!rayCastLevelGeometry(physicsScene, from, dir, hit, distance))
+      {
+        return true;
+      }
+
+      // It's okay if the hit is further back than our target point
+      return hit.distance > distance;
+    }
+  }  // namespace AI
+}  // namespace REGoth
@@ -0,0 +1,107 @@
+#pragma once
+#include <BsCorePrerequisites.h>
+#include <Math/BsVector3.h>
+
+namespace bs
+{
+  class PhysicsScene;
+}
+
+namespace REGoth
+{
+  namespace AI
+  {
+    class LineOfSightQueue;
+
+    /**
+     * A single line of sight check, see LineOfSightQueue::request().
+     */
+    class LineOfSightQuery
+    {
+    public:
+      /**
+       * @return Whether the check has been done.
+       */
+      bool isDone() const
+      {
+        return mIsDone;
+      }
+
+      /**
+       * @return Whether nothing blocks the line. Only valid once isDone().
+       */
+      bool isVisible() const
+      {
+        return mIsVisible;
+      }
+
+    private:
+      friend class LineOfSightQueue;
+
+      bs::Vector3 mFrom;
+      bs::Vector3 mTo;
+      bool mIsDone    = false;
+      bool mIsVisible = false;
+    };
+
+    /**
+     * Collects the line of sight checks of all pathfinders of a world and does them
+     * together, once per frame.
+     *
+     * Pathfinders smoothing their routes or following an entity need to know whether they can
+     * go to some point directly. Instead of everyone doing their own raycasts whenever they
+     * like, the checks are requested here and done all at once the next time update() is
+     * called in a new frame. The results are then picked up by whoever asked for them.
+     *
+     * The physics scene has no way to do multiple raycasts as a batch, so they are done one
+     * after another, but in a tight loop instead of spread all over the frame.
+     */
+    class LineOfSightQueue
+    {
+    public:
+      /**
+       * How many checks have been done and how many batches they were done in.
+       */
+      struct Stats
+      {
+        bs::UINT32 lastBatchSize = 0;
+        bs::UINT64 numBatches    = 0;
+        bs::UINT64 numQueries    = 0;
+      };
+
+      /**
+       * Requests checking whether the line between the given points is blocked by anything.
+       * The check is done during the next call to update() in a later frame.
+       */
+      bs::SPtr<LineOfSightQuery> request(const bs::Vector3& from, const bs::Vector3& to);
+
+      /**
+       * Does all requested checks, if it hasn't already been done in this frame. Cheap to call
+       * multiple times per frame, so everyone using the queue can call it before looking at
+       * their results.
+       */
+      void update();
+
+      const Stats& stats() const
+      {
+        return mStats;
+      }
+
+      /**
+       * Does a single check right away, for those who can't wait.
+       *
+       * @return Whether nothing in the physics scene blocks the line between the given points.
+       */
+      static bool isLineVisible(bs::PhysicsScene& physicsScene, const bs::Vector3& from,
+                                const bs::Vector3& to);
+
+    private:
+      bs::Vector<bs::SPtr<LineOfSightQuery>> mPending;
+
+      /** Index of the frame the pending queries have last been resolved in */
+      bs::UINT64 mLastResolvedFrame = 0;
+
+      Stats mStats;
+    };
+  }  // namespace AI
+}  // namespace REGoth
@@ -1,18 +1,24 @@
 #include "Pathfinder.hpp"
+#include <AI/LineOfSightQueue.hpp>
 #include <Math/BsRay.h>
 #include <Math/BsVector2.h>
 #include <Physics/BsPhysics.h>
 #include <RTTI/RTTI_Pathfinder.hpp>
 #include <Scene/BsSceneManager.h>
+#include <algorithm>
 #include <components/GameWorld.hpp>
 #include <components/Waynet.hpp>
-#include <components/Waypoint.hpp>
+#include <core/DebugDrawBatches.hpp>
+#include <core/Profiling.hpp>
 #include <log/logging.hpp>
+#include <world/PhysicsLayers.hpp>
 
-static const float MAX_SIDE_DIFFERENCE_TO_REACH_POSITION     = 1.0f;  // Meters
-static const float MAX_HEIGHT_DIFFERENCE_TO_REACH_POSITION   = 2.0f;  // Meters
-static const float MAX_TARGET_ENTITY_MOVEMENT_BEFORE_REROUTE = 5.0f;  // Meters
-static const float MAX_POINT_DISTANCE_FOR_CLEANUP            = 5.0f;  // Meters
+static const float MAX_SIDE_DIFFERENCE_TO_REACH_POSITION     = 1.0f;   // Meters
+static const float MAX_HEIGHT_DIFFERENCE_TO_REACH_POSITION   = 2.0f;   // Meters
+static const float MAX_TARGET_ENTITY_MOVEMENT_BEFORE_REROUTE = 5.0f;   // Meters
+static const float MAX_POINT_DISTANCE_FOR_CLEANUP            = 5.0f;   // Meters
+static const float MAX_ROUTE_EXTENSION_LENGTH                = 20.0f;  // Meters
+static const bs::UINT32 MAX_ROUTE_EXTENSIONS                 = 8;
 
 namespace REGoth
 {
@@ -25,6 +31,10 @@ namespace REGoth
 
     Pathfinder::~Pathfinder()
     {
+      if (!mDrawnRoute.empty())
+      {
+        gDebugDrawBatches().removeBatch(DebugDrawCategory::Routes, debugDrawOwner());
+      }
     }
 
     Pathfinder::MovementReport Pathfinder::checkMoveToLocation(const bs::Vector3& from,
@@ -79,7 +89,7 @@ namespace REGoth
       bs::PhysicsQueryHit hit;
 
       const bs::Vector3 up = bs::Vector3::UNIT_Y;
-      if (!physicsScene().rayCast(floorposition, up, hit))
+      if (!rayCastLevelGeometry(physicsScene(), floorposition, up, hit))
       {
         return std::numeric_limits<float>::max();
       }
@@ -92,7 +102,7 @@ namespace REGoth
       return acos(normal.y);
     }
 
-    HWaypoint Pathfinder::findNextVisibleWaypoint(const bs::Vector3& from) const
+    WaypointIndex Pathfinder::findNextVisibleWaypoint(const bs::Vector3& from) const
     {
       // TODO: Check for obstructions
       return mWaynet->findClosestWaypointTo(from).closest;
@@ -100,6 +110,8 @@ namespace REGoth
 
     bool Pathfinder::hasActiveRouteBeenCompleted(const bs::Vector3& positionNow) const
     {
+      if (isWaitingForWay()) return false;
+
       if (!mActiveRoute.targetEntity)
 
         // FIXME: This goes wrong if an npc ever gets stuck or the heights don't match
@@ -121,8 +133,26 @@ namespace REGoth
     Pathfinder::Instruction Pathfinder::updateToNextInstructionToTarget(
         const bs::Vector3& positionNow)
     {
+      REGOTH_PROFILE_SCOPE("Pathfinder");
+
       Instruction inst;
 
+      if (mLineOfSightQueue)
+      {
+        mLineOfSightQueue->update();
+      }
+
+      collectPendingWay();
+      continueRouteCleanup();
+      updateTargetEntityVisibility(positionNow);
+
+      if (isWaitingForWay())
+      {
+        inst.targetPosition  = positionNow;
+        inst.isWaitingForWay = true;
+        return inst;
+      }
+
       if (hasNextRouteTargetBeenReached(positionNow))
       {
         if (!mActiveRoute.positionsToGo.empty())
@@ -131,8 +161,12 @@ namespace REGoth
         }
       }
 
+      bool isDrawingRoutes = gDebugDrawBatches().isCategoryEnabled(DebugDrawCategory::Routes);
+
       if (hasActiveRouteBeenCompleted(positionNow))
       {
+        if (isDrawingRoutes) debugDrawRoute(positionNow);
+
         inst.targetPosition = positionNow;
         return inst;
       }
@@ -141,7 +175,10 @@ namespace REGoth
       {
         if (isTargetAnEntity())
         {
-          startNewRouteTo(positionNow, mActiveRoute.targetEntity);
+          if (!extendRouteToTargetEntity())
+          {
+            startNewRouteTo(positionNow, mActiveRoute.targetEntity);
+          }
         }
         else
         {
@@ -152,6 +189,8 @@ namespace REGoth
 
       inst.targetPosition = getCurrentTargetPosition(positionNow);
 
+      if (isDrawingRoutes) debugDrawRoute(positionNow);
+
       return inst;
     }
 
@@ -196,7 +235,7 @@ namespace REGoth
     bs::Vector3 Pathfinder::getCurrentTargetPosition(const bs::Vector3& positionNow) const
     {
       bs::Vector3 targetEntityPosition = getTargetEntityPosition();
-      if (isTargetAnEntity() && canDirectlyMovetoLocation(positionNow, targetEntityPosition))
+      if (isTargetAnEntity() && canSeeTargetEntity(positionNow))
       {
         return targetEntityPosition;
       }
@@ -216,40 +255,80 @@ namespace REGoth
       // Must be set for getTargetEntityPosition to work
       mActiveRoute.targetEntity = entity;
 
-      startNewRouteTo(positionNow, getTargetEntityPosition());
-
-      // startNewRouteTo appends the position to go to if it's off the waynet, we can't have that
-      // when the target could be moving
-      if (!mActiveRoute.positionsToGo.empty())
-      {
-        mActiveRoute.positionsToGo.pop_back();
-      }
-
-      mActiveRoute.targetEntity = entity;
-
       // Save start position to see when the entity moved too far
       mActiveRoute.targetEntityPositionOnStart = getTargetEntityPosition();
+
+      startRouteTo(positionNow, mActiveRoute.targetEntityPositionOnStart);
     }
 
     void Pathfinder::startNewRouteTo(const bs::Vector3& positionNow, const bs::Vector3& position)
+    {
+      mActiveRoute.targetEntity = {};
+
+      startRouteTo(positionNow, position);
+    }
+
+    void Pathfinder::startRouteTo(const bs::Vector3& positionNow, const bs::Vector3& position)
     {
       mActiveRoute.positionsToGo.clear();
       mActiveRoute.lastKnownPosition   = positionNow;
-      mActiveRoute.targetEntity        = {};
       mActiveRoute.isTargetUnreachable = false;
+      mActiveRoute.targetWaypoint      = NO_WAYPOINT;
+      mActiveRoute.numExtensions       = 0;
+
+      // Whatever was searched or checked before doesn't matter anymore
+      mPendingWay             = {};
+      mRouteCleanup           = {};
+      mTargetEntityVisibility = {};
 
       if (isTargetReachedByPosition(positionNow, position)) return;
 
-      if (canDirectlyMovetoLocation(positionNow, position))
+      bool canDirectlyMove = canDirectlyMovetoLocation(positionNow, position);
+
+      // Following an entity keeps checking whether it can be seen, start with what we know
+      mTargetEntityVisibility.isVisible = canDirectlyMove;
+
+      if (canDirectlyMove)
       {
-        mActiveRoute.positionsToGo.push_back(position);
+        // A target entity is gone to directly once it can be seen, so there's no need
+        // to put its position onto the route, where it could get outdated.
+        if (!isTargetAnEntity())
+        {
+          mActiveRoute.positionsToGo.push_back(position);
+        }
+
         return;
       }
 
-      HWaypoint nearestWpToTarget = mWaynet->findClosestWaypointTo(position).closest;
-      HWaypoint nearestWpToStart  = mWaynet->findClosestWaypointTo(positionNow).closest;
+      WaypointIndex nearestWpToTarget = mWaynet->findClosestWaypointTo(position).closest;
+      WaypointIndex nearestWpToStart  = mWaynet->findClosestWaypointTo(positionNow).closest;
+
+      if (nearestWpToTarget == NO_WAYPOINT || nearestWpToStart == NO_WAYPOINT)
+      {
+        // No waynet at all, nothing we can do
+        mActiveRoute.isTargetUnreachable = true;
+        return;
+      }
+
+      mPendingWay.request  = mWaynet->requestWay(nearestWpToStart, nearestWpToTarget);
+      mPendingWay.position = position;
+      mPendingWay.from     = nearestWpToStart;
+      mPendingWay.to       = nearestWpToTarget;
+
+      // Might have been in the route cache, no need to wait for the next update then
+      collectPendingWay();
+    }
+
+    void Pathfinder::collectPendingWay()
+    {
+      if (!isWaitingForWay()) return;
+
+      bs::Vector<WaypointIndex> path;
+
+      if (!mWaynet->collectWay(*mPendingWay.request, path)) return;
 
-      bs::Vector<HWaypoint> path = mWaynet->findWay(nearestWpToStart, nearestWpToTarget);
+      PendingWay done = mPendingWay;
+      mPendingWay     = {};
 
       if (path.empty())
       {
@@ -257,65 +336,156 @@ namespace REGoth
         // via the waynet, just exit here.
         mActiveRoute.isTargetUnreachable = true;
 
-        REGOTH_LOG(Info, Uncategorized, "[Pathfinder] No path from {0} to {1}",
-                   nearestWpToStart->SO()->getName(), nearestWpToTarget->SO()->getName());
+        REGOTH_LOG(Info, AI, "[Pathfinder] No path from {0} to {1}",
+                   mWaynet->waypointName(done.from), mWaynet->waypointName(done.to));
         return;
       }
 
-      for (auto wp : path)
-      {
-        const bs::Vector3& wpPosition = wp->SO()->getTransform().pos();
+      followWay(path, done.position);
+    }
 
-        mActiveRoute.positionsToGo.push_back(wpPosition);
+    void Pathfinder::followWay(const bs::Vector<WaypointIndex>& path,
+                               const bs::Vector3& position)
+    {
+      for (WaypointIndex wp : path)
+      {
+        mActiveRoute.positionsToGo.push_back(mWaynet->waypointPosition(wp));
       }
 
       bool isDestinationOffWaynet = false;
 
-      if (mActiveRoute.positionsToGo.empty())
+      if (!isTargetReachedByPosition(mActiveRoute.positionsToGo.back(), position))
       {
         isDestinationOffWaynet = true;
       }
 
-      if (!isTargetReachedByPosition(mActiveRoute.positionsToGo.back(), position))
+      // If the last position is off the waynet, add it as explicit position. Can't have that
+      // when the target is an entity, which could be moving.
+      if (isDestinationOffWaynet && !isTargetAnEntity())
       {
-        isDestinationOffWaynet = true;
+        mActiveRoute.positionsToGo.push_back(position);
       }
 
-      // If the last position is off the waynet, add it as explicit position
-      if (isDestinationOffWaynet)
+      if (isTargetAnEntity())
       {
-        mActiveRoute.positionsToGo.push_back(position);
+        mActiveRoute.targetWaypoint = path.back();
       }
 
       cleanupRoute();
     }
 
+    bool Pathfinder::extendRouteToTargetEntity()
+    {
+      if (!isTargetAnEntity() || mActiveRoute.targetWaypoint == NO_WAYPOINT) return false;
+
+      // Already left the waynet to go to the entity directly, no way to extend
+      if (mActiveRoute.positionsToGo.empty()) return false;
+
+      if (mActiveRoute.numExtensions >= MAX_ROUTE_EXTENSIONS) return false;
+
+      bs::Vector3 targetEntityPosition = getTargetEntityPosition();
+
+      WaypointIndex nearestWpToTarget =
+          mWaynet->findClosestWaypointTo(targetEntityPosition).closest;
+
+      if (nearestWpToTarget == NO_WAYPOINT) return false;
+
+      bs::Vector<WaypointIndex> extension;
+
+      if (nearestWpToTarget != mActiveRoute.targetWaypoint)
+      {
+        // Both ends are close to each other, so this search doesn't have to look at much
+        extension = mWaynet->findWay(mActiveRoute.targetWaypoint, nearestWpToTarget);
+
+        if (extension.empty()) return false;
+
+        float length = 0.0f;
+
+        for (size_t i = 1; i < extension.size(); i++)
+        {
+          length += mWaynet->waypointPosition(extension[i - 1])
+                        .distance(mWaynet->waypointPosition(extension[i]));
+        }
+
+        if (length > MAX_ROUTE_EXTENSION_LENGTH) return false;
+      }
+
+      bs::List<bs::Vector3>& positions = mActiveRoute.positionsToGo;
+
+      for (size_t i = 1; i < extension.size(); i++)
+      {
+        const bs::Vector3& wpPosition = mWaynet->waypointPosition(extension[i]);
+
+        // Going back the way we came? Then don't go there and back again.
+        if (positions.size() >= 2 && *std::next(positions.rbegin()) == wpPosition)
+        {
+          positions.pop_back();
+        }
+        else
+        {
+          positions.push_back(wpPosition);
+        }
+      }
+
+      mActiveRoute.targetWaypoint              = nearestWpToTarget;
+      mActiveRoute.targetEntityPositionOnStart = targetEntityPosition;
+      mActiveRoute.numExtensions += 1;
+
+      if (!extension.empty())
+      {
+        cleanupRoute();
+      }
+
+      return true;
+    }
+
     bool Pathfinder::canDirectlyMovetoLocation(const bs::Vector3& from, const bs::Vector3& to) const
     {
       if (isTargetReachedByPosition(from, to)) return true;
 
-      bs::PhysicsQueryHit hit;
+      return LineOfSightQueue::isLineVisible(physicsScene(), from, to);
+    }
 
-      // FIXME: This breaks when the creature should go down a slope but is
-      // standing on the top of it right now
+    void Pathfinder::debugDrawRoute(const bs::Vector3& positionNow)
+    {
+      const bs::List<bs::Vector3>& positions = mActiveRoute.positionsToGo;
 
-      bs::Vector3 dir = to - from;
-      float distance  = dir.length();
+      // Only redrawn once a position has been reached or the route changed, as redrawing
+      // means handing all debug lines to bsf again
+      if (positions.size() == mDrawnRoute.size() &&
+          std::equal(positions.begin(), positions.end(), mDrawnRoute.begin()))
+      {
+        return;
+      }
 
-      dir /= distance;
+      mDrawnRoute.assign(positions.begin(), positions.end());
 
-      if (!physicsScene().rayCast(from, dir, hit))
+      if (mDrawnRoute.empty())
       {
-        return true;
+        gDebugDrawBatches().removeBatch(DebugDrawCategory::Routes, debugDrawOwner());
+        return;
+      }
+
+      bs::Vector<bs::Vector3> linePoints;
+      linePoints.reserve(mDrawnRoute.size() * 2);
+
+      bs::Vector3 from = positionNow;
+
+      for (const bs::Vector3& to : mDrawnRoute)
+      {
+        linePoints.push_back(from);
+        linePoints.push_back(to);
+
+        from = to;
       }
 
-      // It's okay if the hit is furhter back than our target point
-      return hit.distance > distance;
+      gDebugDrawBatches().setBatch(DebugDrawCategory::Routes, debugDrawOwner(),
+                                   std::move(linePoints), {mDrawnRoute.back()});
     }
 
-    void Pathfinder::debugDrawRoute(const bs::Vector3& positionNow)
+    bs::UINT64 Pathfinder::debugDrawOwner() const
     {
-      // TODO: Implement using bsf
+      return (bs::UINT64)(uintptr_t)this;
     }
 
     bool Pathfinder::hasTargetEntityMovedTooFar() const
@@ -342,6 +512,15 @@ namespace REGoth
 
       if (mActiveRoute.positionsToGo.size() < 3) return;
 
+      if (mLineOfSightQueue)
+      {
+        mRouteCleanup          = {};
+        mRouteCleanup.isActive = true;
+
+        continueRouteCleanup();
+        return;
+      }
+
       bool removed;
 
       do
@@ -390,6 +569,158 @@ namespace REGoth
       return canMoveDirectlytoNext;
     }
 
+    void Pathfinder::continueRouteCleanup()
+    {
+      if (!mRouteCleanup.isActive) return;
+
+      bs::List<bs::Vector3>& positions = mActiveRoute.positionsToGo;
+
+      if (!mRouteCleanup.candidates.empty())
+      {
+        // All candidates were requested at once, so they will be done at once
+        if (!mRouteCleanup.candidates.front().query->isDone()) return;
+
+        bool hasRemovedPositions = false;
+
+        for (const CleanupCandidate& candidate : mRouteCleanup.candidates)
+        {
+          if (!candidate.query->isVisible()) continue;
+
+          // Positions might have been reached in the meantime, so look for it again
+          for (auto it = positions.begin(); it != positions.end(); it++)
+          {
+            if (it == positions.begin() || std::next(it) == positions.end()) continue;
+
+            if (*std::prev(it) == candidate.previous && *it == candidate.position &&
+                *std::next(it) == candidate.next)
+            {
+              positions.erase(it);
+              hasRemovedPositions = true;
+              break;
+            }
+          }
+        }
+
+        mRouteCleanup.candidates.clear();
+
+        finishRouteCleanupStep(hasRemovedPositions);
+        return;
+      }
+
+      if (positions.size() < 3)
+      {
+        mRouteCleanup.isActive = false;
+        return;
+      }
+
+      // Every other step starts at the second position, so all positions get their turn
+      bool skipNext            = (mRouteCleanup.step % 2) == 1;
+      bool hasRemovedPositions = false;
+
+      const float maxDistToPrevSq = MAX_POINT_DISTANCE_FOR_CLEANUP * MAX_POINT_DISTANCE_FOR_CLEANUP;
+
+      for (auto it = std::next(positions.begin()); it != std::prev(positions.end());)
+      {
+        if (skipNext)
+        {
+          skipNext = false;
+          it++;
+          continue;
+        }
+
+        auto prev = std::prev(it);
+        auto next = std::next(it);
+
+        // Only remove points which aren't too far appart
+        if (((*it) - (*prev)).squaredLength() > maxDistToPrevSq)
+        {
+          it++;
+          continue;
+        }
+
+        const bool samePosition =
+            isTargetReachedByPosition(*prev, *it) || isTargetReachedByPosition(*next, *it);
+
+        const bool detour = isTargetReachedByPosition(*prev, *next);
+
+        if (samePosition || detour)
+        {
+          it                  = positions.erase(it);
+          hasRemovedPositions = true;
+          continue;
+        }
+
+        CleanupCandidate candidate;
+        candidate.previous = *prev;
+        candidate.position = *it;
+        candidate.next     = *next;
+        candidate.query    = mLineOfSightQueue->request(*prev, *next);
+
+        mRouteCleanup.candidates.push_back(candidate);
+
+        skipNext = true;
+        it++;
+      }
+
+      if (mRouteCleanup.candidates.empty())
+      {
+        finishRouteCleanupStep(hasRemovedPositions);
+      }
+      else if (hasRemovedPositions)
+      {
+        mRouteCleanup.stepsWithoutRemoval = 0;
+      }
+    }
+
+    void Pathfinder::finishRouteCleanupStep(bool hasRemovedPositions)
+    {
+      mRouteCleanup.step += 1;
+
+      if (hasRemovedPositions)
+      {
+        mRouteCleanup.stepsWithoutRemoval = 0;
+      }
+      else
+      {
+        mRouteCleanup.stepsWithoutRemoval += 1;
+      }
+
+      // Both halves of the positions have been looked at without finding anything to remove
+      if (mRouteCleanup.stepsWithoutRemoval >= 2)
+      {
+        mRouteCleanup.isActive = false;
+      }
+    }
+
+    void Pathfinder::updateTargetEntityVisibility(const bs::Vector3& positionNow)
+    {
+      if (!isTargetAnEntity() || !mLineOfSightQueue) return;
+
+      TargetEntityVisibility& visibility = mTargetEntityVisibility;
+
+      if (visibility.query && visibility.query->isDone())
+      {
+        visibility.isVisible = visibility.query->isVisible();
+        visibility.query     = nullptr;
+      }
+
+      if (!visibility.query)
+      {
+        visibility.query = mLineOfSightQueue->request(positionNow, getTargetEntityPosition());
+      }
+    }
+
+    bool Pathfinder::canSeeTargetEntity(const bs::Vector3& positionNow) const
+    {
+      bs::Vector3 targetEntityPosition = getTargetEntityPosition();
+
+      if (!mLineOfSightQueue) return canDirectlyMovetoLocation(positionNow, targetEntityPosition);
+
+      if (isTargetReachedByPosition(positionNow, targetEntityPosition)) return true;
+
+      return mTargetEntityVisibility.isVisible;
+    }
+
     bool Pathfinder::shouldReRoute(const bs::Vector3& positionNow) const
     {
       // FIXME: canDirectlyMovetoLocation fails if the npc should move up/down a (walkable) hill like
@@ -424,7 +755,7 @@ namespace REGoth
 
       if (mActiveRoute.positionsToGo.empty())
       {
-        if (!canDirectlyMovetoLocation(positionNow, getTargetEntityPosition()))
+        if (!canSeeTargetEntity(positionNow))
         {
           return true;
         }
@@ -1,5 +1,6 @@
 #pragma once
 #include <BsCorePrerequisites.h>
+#include <AI/WaypointIndex.hpp>
 #include <Math/BsVector3.h>
 #include <RTTI/RTTIUtil.hpp>
 
@@ -12,11 +13,12 @@ namespace REGoth
   class Waynet;
   using HWaynet = bs::GameObjectHandle<Waynet>;
 
-  class Waypoint;
-  using HWaypoint = bs::GameObjectHandle<Waypoint>;
-
   namespace AI
   {
+    class LineOfSightQuery;
+    class LineOfSightQueue;
+    class WayRequest;
+
     /**
      * Wrapper around the waynet. Can find paths to certain locations and
      * give instructions onto how to get there from a given point.
@@ -30,6 +32,12 @@ namespace REGoth
       struct Instruction
       {
         bs::Vector3 targetPosition;
+
+        /**
+         * Set while the way through the waynet is still being searched. The creature should
+         * stay where it is until then.
+         */
+        bool isWaitingForWay = false;
       };
 
       struct UserConfiguration
@@ -59,14 +67,36 @@ namespace REGoth
         // or it might be completely off the waynet with no way to figure out how to get there.
         // If such a case is detected, we don't want to waste time trying over and over again.
         bool isTargetUnreachable = false;
+
+        // Last waypoint of the way through the waynet to a target entity. When the entity moves,
+        // the way is extended from here instead of searching a new one, see
+        // extendRouteToTargetEntity().
+        WaypointIndex targetWaypoint = NO_WAYPOINT;
+
+        // How often the way has been extended since it was searched
+        bs::UINT32 numExtensions = 0;
       };
 
       Pathfinder(HWaynet waynet);
       virtual ~Pathfinder();
 
+      /**
+       * Starts a new route to the given target.
+       *
+       * If the route goes through the waynet, the way is searched in the background, see
+       * Waynet::requestWay(). Until it has been found, the instructions say to wait.
+       */
       void startNewRouteTo(const bs::Vector3& positionNow, const bs::Vector3& target);
       void startNewRouteTo(const bs::Vector3& positionNow, bs::HSceneObject entity);
 
+      /**
+       * @return Whether the way through the waynet for the active route is still being searched.
+       */
+      bool isWaitingForWay() const
+      {
+        return mPendingWay.request != nullptr;
+      }
+
       /**
        * @return The next target position on the way to the location set via startNewRouteTo.
        *         If the target has been reached, positionNow is returned, so you should always check
@@ -79,6 +109,28 @@ namespace REGoth
        */
       bool hasActiveRouteBeenCompleted(const bs::Vector3& positionNow) const;
 
+      /**
+       * Makes the line of sight checks for smoothing the route and following entities go
+       * through the given queue, so they are done together with those of other pathfinders.
+       * Results then arrive a frame later.
+       *
+       * Without a queue, all checks are done right away. Not saved, has to be set again after
+       * loading.
+       */
+      void setLineOfSightQueue(LineOfSightQueue* queue)
+      {
+        mLineOfSightQueue = queue;
+      }
+
+      /**
+       * Sets the waynet routes go through. Worlds loaded from a delta save get their waynet
+       * only after the characters have been loaded, see GameWorld::saveDelta().
+       */
+      void setWaynet(HWaynet waynet)
+      {
+        mWaynet = waynet;
+      }
+
       /**
        * Information about the creature using this pathfinder
        */
@@ -140,7 +192,23 @@ namespace REGoth
       /**
        * Finds the next visible waypoint from the given location.
        */
-      HWaypoint findNextVisibleWaypoint(const bs::Vector3& from) const;
+      WaypointIndex findNextVisibleWaypoint(const bs::Vector3& from) const;
+
+      /**
+       * Starts a route to the given position, leaving mActiveRoute.targetEntity as it is.
+       */
+      void startRouteTo(const bs::Vector3& positionNow, const bs::Vector3& position);
+
+      /**
+       * Fills the active route from the result of the pending way request, if it is done.
+       */
+      void collectPendingWay();
+
+      /**
+       * Fills the active route with the given way through the waynet, which leads to the given
+       * position.
+       */
+      void followWay(const bs::Vector<WaypointIndex>& path, const bs::Vector3& position);
 
       /**
        * @return Whether the next position on the route has been reached
@@ -172,20 +240,44 @@ namespace REGoth
       bs::Vector3 getCurrentTargetPosition(const bs::Vector3& positionNow) const;
 
       /**
-       * Draws lines on where to go to
+       * Draws lines on where to go to, from the given position to the end of the route, while
+       * DebugDrawCategory::Routes is enabled. Called on every update then, but only hands the
+       * route to DebugDrawBatches when it has changed.
        */
       void debugDrawRoute(const bs::Vector3& positionNow);
 
+      /**
+       * @return Owner of the batch of the route, see DebugDrawBatches::setBatch().
+       */
+      bs::UINT64 debugDrawOwner() const;
+
       /**
        * @return Whether the target entity has moved too far from the spot it was when we started the
        * route
        */
       bool hasTargetEntityMovedTooFar() const;
 
+      /**
+       * Moves the end of the active route to where the target entity is now, by going on from
+       * the last waypoint of the route to the waypoint closest to the entity. Following an
+       * entity only needs a short search around it that way, instead of searching the whole way
+       * again every few meters.
+       *
+       * Gives up if the route doesn't lead through the waynet anymore, if the entity got too far
+       * away from the end of the route or if the route has been extended too often already,
+       * since the extended way gets less and less likely to be the shortest one.
+       *
+       * @return Whether the route has been extended. If not, a new route has to be started.
+       */
+      bool extendRouteToTargetEntity();
+
       /**
        * Sometimes, the waynet isn't exactly detailed and NPCs take some weird looking detours
        * instead of going straight. This function uses raytraces to check which points on the route
        * can be erased because there are not obstacles on the way to them
+       *
+       * With a line of sight queue set, this only starts the cleanup, which is then done over the
+       * next frames, see continueRouteCleanup().
        */
       void cleanupRoute();
 
@@ -194,6 +286,29 @@ namespace REGoth
        */
       bool canRoutePositionBeRemoved(std::list<bs::Vector3>::iterator it);
 
+      /**
+       * Does the next step of cleaning up the route with the line of sight queue, see
+       * cleanupRoute(). Each step looks at every other position of the route, so positions
+       * next to each other are never removed based on outdated checks.
+       */
+      void continueRouteCleanup();
+
+      /**
+       * Ends the current step of cleaning up the route.
+       */
+      void finishRouteCleanupStep(bool hasRemovedPositions);
+
+      /**
+       * Keeps the line of sight check to the target entity going. See canSeeTargetEntity().
+       */
+      void updateTargetEntityVisibility(const bs::Vector3& positionNow);
+
+      /**
+       * @return Whether the target entity could be gone to directly. With a line of sight queue
+       *         set, this is the result of the last finished check.
+       */
+      bool canSeeTargetEntity(const bs::Vector3& positionNow) const;
+
       /**
        * @return Whether the currently active route is considered not up-to-date and should be
        *         redone. This happens for example, when a target entity moved too far or something is
@@ -217,8 +332,72 @@ namespace REGoth
        */
       Route mActiveRoute;
 
+      /**
+       * Way through the waynet being searched for the active route. Not saved, a loaded route
+       * that was still waiting for its way has to be started again.
+       */
+      struct PendingWay
+      {
+        bs::SPtr<WayRequest> request;
+
+        /** Position the route leads to */
+        bs::Vector3 position;
+
+        /** Where the way starts and ends, for logging */
+        WaypointIndex from = NO_WAYPOINT;
+        WaypointIndex to   = NO_WAYPOINT;
+      };
+
+      PendingWay mPendingWay;
+
+      /**
+       * Possibly removable position of the route, waiting for its line of sight check.
+       */
+      struct CleanupCandidate
+      {
+        bs::Vector3 previous;
+        bs::Vector3 position;
+        bs::Vector3 next;
+
+        /** Whether *previous* and *next* can see each other */
+        bs::SPtr<LineOfSightQuery> query;
+      };
+
+      /**
+       * Cleanup of the active route done through the line of sight queue, see
+       * continueRouteCleanup(). Not saved, a loaded route just stays as it is.
+       */
+      struct RouteCleanup
+      {
+        bool isActive = false;
+
+        bs::Vector<CleanupCandidate> candidates;
+
+        bs::UINT32 step                = 0;
+        bs::UINT32 stepsWithoutRemoval = 0;
+      };
+
+      RouteCleanup mRouteCleanup;
+
+      /**
+       * Last known line of sight to the target entity, see canSeeTargetEntity().
+       */
+      struct TargetEntityVisibility
+      {
+        bool isVisible = false;
+
+        bs::SPtr<LineOfSightQuery> query;
+      };
+
+      TargetEntityVisibility mTargetEntityVisibility;
+
+      LineOfSightQueue* mLineOfSightQueue = nullptr;
+
       HWaynet mWaynet;
 
+      /** Positions to go to when the route has last been drawn, see debugDrawRoute() */
+      bs::Vector<bs::Vector3> mDrawnRoute;
+
     public:
       REGOTH_DECLARE_RTTI_FOR_REFLECTABLE(Pathfinder);
 
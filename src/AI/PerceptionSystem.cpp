@@ -0,0 +1,237 @@
+#include "PerceptionSystem.hpp"
+#include <algorithm>
+#include <Scene/BsSceneObject.h>
+#include <Utility/BsTime.h>
+#include <components/Character.hpp>
+#include <components/GameWorld.hpp>
+#include <components/Item.hpp>
+#include <scripting/ScriptVMForGameWorld.hpp>
+
+namespace REGoth
+{
+  namespace AI
+  {
+    constexpr float PerceptionSystem::DEFAULT_PERCEPTION_TIME;
+
+    Scripting::SymbolIndex PerceptionSystem::Perceiver::functionOf(PerceptionType type) const
+    {
+      for (const auto& p : perceptions)
+      {
+        if (p.first == (bs::INT32)type) return p.second;
+      }
+
+      return Scripting::SYMBOL_INDEX_INVALID;
+    }
+
+    void PerceptionSystem::enablePerception(HCharacter character, bs::INT32 type,
+                                            Scripting::SymbolIndex function)
+    {
+      Perceiver& perceiver = perceiverOf(character);
+
+      for (auto& p : perceiver.perceptions)
+      {
+        if (p.first == type)
+        {
+          p.second = function;
+          return;
+        }
+      }
+
+      perceiver.perceptions.push_back({type, function});
+    }
+
+    void PerceptionSystem::disablePerception(HCharacter character, bs::INT32 type)
+    {
+      auto it = mPerceiverIndices.find(character.getInstanceId());
+
+      if (it == mPerceiverIndices.end()) return;
+
+      auto& perceptions = mPerceivers[it->second].perceptions;
+
+      perceptions.erase(std::remove_if(perceptions.begin(), perceptions.end(),
+                                       [type](const std::pair<bs::INT32, Scripting::SymbolIndex>& p) {
+                                         return p.first == type;
+                                       }),
+                        perceptions.end());
+    }
+
+    void PerceptionSystem::setPerceptionTime(HCharacter character, float seconds)
+    {
+      Perceiver& perceiver = perceiverOf(character);
+
+      perceiver.perceptionTime = seconds;
+
+      // Don't make the character wait longer than the new time for its next check
+      perceiver.timeUntilNext = std::min(perceiver.timeUntilNext, seconds);
+    }
+
+    void PerceptionSystem::removeCharacter(HCharacter character)
+    {
+      auto it = mPerceiverIndices.find(character.getInstanceId());
+
+      if (it == mPerceiverIndices.end()) return;
+
+      size_t index = it->second;
+      mPerceiverIndices.erase(it);
+
+      // Order doesn't matter, so move the last one into the gap
+      if (index != mPerceivers.size() - 1)
+      {
+        mPerceivers[index] = std::move(mPerceivers.back());
+        mPerceiverIndices[mPerceivers[index].character.getInstanceId()] = index;
+      }
+
+      mPerceivers.pop_back();
+    }
+
+    PerceptionSystem::Perceiver& PerceptionSystem::perceiverOf(HCharacter character)
+    {
+      auto it = mPerceiverIndices.find(character.getInstanceId());
+
+      if (it != mPerceiverIndices.end()) return mPerceivers[it->second];
+
+      mPerceiverIndices[character.getInstanceId()] = mPerceivers.size();
+
+      mPerceivers.emplace_back();
+      mPerceivers.back().character = character;
+
+      return mPerceivers.back();
+    }
+
+    void PerceptionSystem::update()
+    {
+      bs::UINT64 frame = bs::gTime().getFrameIdx();
+
+      if (frame == mLastUpdateFrame) return;
+
+      float now = bs::gTime().getTime();
+
+      // Nothing to catch up on in the very first frame
+      float timePassed = (mLastUpdateFrame == ~0ULL) ? 0.0f : now - mLastUpdateTime;
+
+      mLastUpdateFrame = frame;
+      mLastUpdateTime  = now;
+
+      if (!mWorld) return;
+
+      Stats stats;
+      stats.numPerceivers = (bs::UINT32)mPerceivers.size();
+
+      mPendingCalls.clear();
+
+      for (Perceiver& perceiver : mPerceivers)
+      {
+        perceiver.timeUntilNext -= timePassed;
+
+        if (perceiver.timeUntilNext > 0.0f) continue;
+
+        // Don't try to catch up on checks missed during a long frame
+        perceiver.timeUntilNext = perceiver.perceptionTime;
+
+        if (perceiver.perceptions.empty()) continue;
+        if (perceiver.character.isDestroyed()) continue;
+
+        perceive(perceiver);
+
+        stats.numChecked += 1;
+      }
+
+      Scripting::ScriptVMForGameWorld& vm = mWorld->scriptVM();
+
+      for (const PerceptionCall& call : mPendingCalls)
+      {
+        // One of the calls before might have gotten rid of something
+        if (call.self.isDestroyed()) continue;
+        if (call.other && call.other.isDestroyed()) continue;
+        if (call.item && call.item.isDestroyed()) continue;
+
+        if (call.other) call.other->useAsOther();
+        if (call.item) call.item->useAsItem();
+
+        vm.runFunctionOnSelf(call.function, call.self);
+
+        stats.numFired += 1;
+      }
+
+      mPendingCalls.clear();
+
+      mLastStats = stats;
+    }
+
+    void PerceptionSystem::perceive(const Perceiver& perceiver)
+    {
+      const HCharacter& self = perceiver.character;
+
+      Scripting::SymbolIndex assessPlayer = perceiver.functionOf(PerceptionType::AssessPlayer);
+      Scripting::SymbolIndex assessItem   = perceiver.functionOf(PerceptionType::AssessItem);
+
+      if (assessPlayer == Scripting::SYMBOL_INDEX_INVALID &&
+          assessItem == Scripting::SYMBOL_INDEX_INVALID)
+      {
+        return;
+      }
+
+      bs::INT32 senses = self->senses();
+      float range      = self->sensesRange();
+
+      if (senses == 0 || range <= 0.0f) return;
+
+      const bs::Transform& transform = self->SO()->getTransform();
+      const bs::Vector3 position     = transform.pos();
+      const bs::Vector3 forward      = transform.getForward();
+
+      // Hearing and smelling work in all directions, seeing only up to 90 degrees to the side
+      bool isOnlySeeing = (senses & (SENSE_HEAR | SENSE_SMELL)) == 0;
+
+      auto canSense = [&](const bs::Vector3& target) {
+        if (!isOnlySeeing) return true;
+
+        return forward.dot(target - position) >= 0.0f;
+      };
+
+      if (assessPlayer != Scripting::SYMBOL_INDEX_INVALID)
+      {
+        HCharacter hero = mWorld->hero();
+
+        if (hero && hero != self)
+        {
+          const bs::Vector3 heroPosition = hero->SO()->getTransform().pos();
+
+          if (heroPosition.squaredDistance(position) < range * range && canSense(heroPosition))
+          {
+            mPendingCalls.push_back({assessPlayer, self, hero, {}});
+          }
+        }
+      }
+
+      if (assessItem != Scripting::SYMBOL_INDEX_INVALID)
+      {
+        mWorld->findItemsInRange(range, position, mNearbyItems);
+
+        // Only the closest item is assessed, like in the original
+        HItem closest;
+        float closestDistanceSq = 0.0f;
+
+        for (const HItem& item : mNearbyItems)
+        {
+          const bs::Vector3 itemPosition = item->SO()->getTransform().pos();
+
+          if (!canSense(itemPosition)) continue;
+
+          float distanceSq = itemPosition.squaredDistance(position);
+
+          if (!closest || distanceSq < closestDistanceSq)
+          {
+            closest           = item;
+            closestDistanceSq = distanceSq;
+          }
+        }
+
+        if (closest)
+        {
+          mPendingCalls.push_back({assessItem, self, {}, closest});
+        }
+      }
+    }
+  }  // namespace AI
+}  // namespace REGoth
@@ -0,0 +1,188 @@
+#pragma once
+#include <BsCorePrerequisites.h>
+#include <scripting/ScriptTypes.hpp>
+
+namespace REGoth
+{
+  class GameWorld;
+  using HGameWorld = bs::GameObjectHandle<GameWorld>;
+
+  class Character;
+  using HCharacter = bs::GameObjectHandle<Character>;
+
+  class Item;
+  using HItem = bs::GameObjectHandle<Item>;
+
+  namespace AI
+  {
+    /**
+     * Perceptions the scripts can enable via `Npc_PercEnable`. Values as in `AI_CONSTANTS.D`.
+     *
+     * Only the *active* ones are checked by the PerceptionSystem. The others are passive,
+     * they react to things happening, like being hit, and are to be fired by whoever
+     * makes them happen.
+     */
+    enum class PerceptionType : bs::INT32
+    {
+      AssessPlayer  = 1,
+      AssessEnemy   = 2,
+      AssessFighter = 3,
+      AssessBody    = 4,
+      AssessItem    = 5,
+    };
+
+    /**
+     * Bits of `C_NPC.senses`. Values as in `AI_CONSTANTS.D`.
+     */
+    enum Sense : bs::INT32
+    {
+      SENSE_SEE   = 1 << 0,
+      SENSE_HEAR  = 1 << 1,
+      SENSE_SMELL = 1 << 2,
+    };
+
+    /**
+     * Checks the active perceptions of all characters of a world in a single pass.
+     *
+     * In Gothic, characters notice what's around them through perceptions: Scripts enable
+     * them with `Npc_PercEnable` and a function to call, e.g. `B_AssessPlayer` for
+     * `PERC_ASSESSPLAYER`. Every few seconds, as set by `Npc_SetPercTime`, the engine looks at
+     * what the character can sense and calls the functions of the perceptions that apply,
+     * with `OTHER` or `ITEM` set to what it noticed.
+     *
+     * Instead of every character looking around by itself, all characters with enabled
+     * perceptions are kept in one list here and checked together once per frame, at most.
+     * Characters whose perception time hasn't passed yet are skipped. Those who are due
+     * only look at the hero and at the items within their senses range, found through
+     * GameWorld::findItemsInRange() into a buffer which is reused for every character.
+     *
+     * What a character can sense depends on `C_NPC.senses`: Hearing and smelling work in all
+     * directions, seeing only for what's in front of it. There are no line of sight checks.
+     *
+     * Of the active perceptions, only `PERC_ASSESSPLAYER` and `PERC_ASSESSITEM` are fired so
+     * far. The others need attitudes, fight modes and death, which characters don't have yet.
+     *
+     * Every GameWorld has one, see GameWorld::perceptionSystem(). Not saved, the scripts
+     * enable the perceptions again when the characters start their states.
+     */
+    class PerceptionSystem
+    {
+    public:
+      /**
+       * How much work the last pass was.
+       */
+      struct Stats
+      {
+        bs::UINT32 numPerceivers = 0;
+        bs::UINT32 numChecked    = 0;
+        bs::UINT32 numFired      = 0;
+      };
+
+      /**
+       * Perception time of characters which never had one set, in seconds.
+       */
+      static constexpr float DEFAULT_PERCEPTION_TIME = 5.0f;
+
+      /**
+       * Sets the world whose characters and items are perceived.
+       */
+      void setWorld(HGameWorld world)
+      {
+        mWorld = world;
+      }
+
+      /**
+       * Makes the given character call `function` when it perceives something of the given
+       * type. Replaces the function set before, if any. See `Npc_PercEnable`.
+       */
+      void enablePerception(HCharacter character, bs::INT32 type,
+                            Scripting::SymbolIndex function);
+
+      /**
+       * See `Npc_PercDisable`.
+       */
+      void disablePerception(HCharacter character, bs::INT32 type);
+
+      /**
+       * Sets how many seconds pass between two checks of the perceptions of the given
+       * character. See `Npc_SetPercTime`.
+       */
+      void setPerceptionTime(HCharacter character, float seconds);
+
+      /**
+       * Forgets everything about the given character, e.g. because it has been destroyed.
+       */
+      void removeCharacter(HCharacter character);
+
+      /**
+       * Checks the perceptions of all characters which are due, if that hasn't been done in
+       * this frame already. Cheap to call multiple times per frame, so every character can
+       * call it before running its own AI.
+       */
+      void update();
+
+      const Stats& lastStats() const
+      {
+        return mLastStats;
+      }
+
+    private:
+      /**
+       * Character with at least one perception enabled or a perception time set.
+       */
+      struct Perceiver
+      {
+        HCharacter character;
+
+        float perceptionTime = DEFAULT_PERCEPTION_TIME;
+        float timeUntilNext  = DEFAULT_PERCEPTION_TIME;
+
+        /** Enabled perceptions, as type and function. Only ever a handful. */
+        bs::Vector<std::pair<bs::INT32, Scripting::SymbolIndex>> perceptions;
+
+        Scripting::SymbolIndex functionOf(PerceptionType type) const;
+      };
+
+      /**
+       * @return Entry of the given character, created if there is none yet.
+       */
+      Perceiver& perceiverOf(HCharacter character);
+
+      /**
+       * Script function to call once all perceivers have looked around. Calling them right
+       * away could enable perceptions, which would change mPerceivers while going through it.
+       */
+      struct PerceptionCall
+      {
+        Scripting::SymbolIndex function;
+        HCharacter self;
+        HCharacter other;
+        HItem item;
+      };
+
+      /**
+       * Looks at what the given perceiver can sense and adds the calls of the perceptions that
+       * apply to mPendingCalls.
+       */
+      void perceive(const Perceiver& perceiver);
+
+      HGameWorld mWorld;
+
+      /** Kept in one place, so a pass goes through them one after another */
+      bs::Vector<Perceiver> mPerceivers;
+
+      /** Index into mPerceivers by the instance ID of the character */
+      bs::UnorderedMap<bs::UINT64, size_t> mPerceiverIndices;
+
+      /** Reused for every perceiver and pass, so a pass doesn't allocate */
+      bs::Vector<HItem> mNearbyItems;
+      bs::Vector<PerceptionCall> mPendingCalls;
+
+      /** Index of the frame and time of the last pass */
+      bs::UINT64 mLastUpdateFrame = ~0ULL;
+      float mLastUpdateTime       = 0.0f;
+
+      Stats mLastStats;
+    };
+  }  // namespace AI
+}  // namespace REGoth
@@ -0,0 +1,277 @@
+#include "PointIndex.hpp"
+#include <algorithm>
+#include <core/Jobs.hpp>
+#include <core/Profiling.hpp>
+
+namespace REGoth
+{
+  namespace AI
+  {
+    constexpr bs::UINT32 PointIndex::NO_POINT;
+    constexpr bs::UINT32 PointIndex::LEAF_SIZE;
+    constexpr bs::UINT32 PointIndex::POSITIONS_PER_TASK;
+
+    PointIndex::PointIndex(const bs::Vector<bs::Vector3>& positions)
+    {
+      mPoints.reserve(positions.size());
+
+      for (bs::UINT32 i = 0; i < (bs::UINT32)positions.size(); i++)
+      {
+        mPoints.push_back({positions[i], i});
+      }
+
+      mSplitAxes.resize(mPoints.size(), 0);
+
+      build(0, numPoints());
+    }
+
+    void PointIndex::build(bs::UINT32 begin, bs::UINT32 end)
+    {
+      if (end - begin < 2) return;
+
+      // Split along the axis the points are spread out the most, which for the mostly flat
+      // worlds of Gothic will rarely be the vertical one.
+      bs::Vector3 lower = mPoints[begin].position;
+      bs::Vector3 upper = mPoints[begin].position;
+
+      for (bs::UINT32 i = begin + 1; i < end; i++)
+      {
+        lower = bs::Vector3::min(lower, mPoints[i].position);
+        upper = bs::Vector3::max(upper, mPoints[i].position);
+      }
+
+      bs::Vector3 extent = upper - lower;
+      bs::UINT8 axis     = 0;
+
+      if (extent.y > extent[axis]) axis = 1;
+      if (extent.z > extent[axis]) axis = 2;
+
+      bs::UINT32 middle = begin + (end - begin) / 2;
+
+      std::nth_element(mPoints.begin() + begin, mPoints.begin() + middle, mPoints.begin() + end,
+                       [axis](const Point& a, const Point& b) {
+                         return a.position[axis] < b.position[axis];
+                       });
+
+      mSplitAxes[middle] = axis;
+
+      build(begin, middle);
+      build(middle + 1, end);
+    }
+
+    void PointIndex::findClosest(const bs::Vector3& position, bs::UINT32 k,
+                                 bs::Vector<bs::UINT32>& result) const
+    {
+      findClosest(position, k, {}, result);
+    }
+
+    void PointIndex::findClosest(const bs::Vector3& position, bs::UINT32 k,
+                                 const std::function<bool(bs::UINT32)>& isAccepted,
+                                 bs::Vector<bs::UINT32>& result) const
+    {
+      result.clear();
+
+      if (k == 0) return;
+
+      // Max-heap of the best points found so far, so the worst one can be replaced quickly
+      bs::Vector<Candidate> candidates;
+      candidates.reserve(std::min(k, numPoints()) + 1);
+
+      findClosestIn(0, numPoints(), position, k, isAccepted, candidates);
+
+      std::sort_heap(candidates.begin(), candidates.end());
+
+      result.reserve(candidates.size());
+
+      for (const Candidate& c : candidates)
+      {
+        result.push_back(c.index);
+      }
+    }
+
+    void PointIndex::findClosestIn(bs::UINT32 begin, bs::UINT32 end, const bs::Vector3& position,
+                                   bs::UINT32 k,
+                                   const std::function<bool(bs::UINT32)>& isAccepted,
+                                   bs::Vector<Candidate>& candidates) const
+    {
+      if (begin >= end) return;
+
+      bs::UINT32 middle  = begin + (end - begin) / 2;
+      const Point& point = mPoints[middle];
+
+      float squaredDistance = (point.position - position).squaredLength();
+
+      // Points not accepted are skipped, their subtrees still need to be searched though
+      bool isCandidate = !isAccepted || isAccepted(point.index);
+
+      if (!isCandidate)
+      {
+        // pass
+      }
+      else if (candidates.size() < k)
+      {
+        candidates.push_back({squaredDistance, point.index});
+        std::push_heap(candidates.begin(), candidates.end());
+      }
+      else if (squaredDistance < candidates.front().squaredDistance)
+      {
+        std::pop_heap(candidates.begin(), candidates.end());
+        candidates.back() = {squaredDistance, point.index};
+        std::push_heap(candidates.begin(), candidates.end());
+      }
+
+      if (end - begin == 1) return;
+
+      bs::UINT8 axis     = mSplitAxes[middle];
+      float toSplitPlane = position[axis] - point.position[axis];
+
+      bool isLeftNear = toSplitPlane < 0.0f;
+
+      if (isLeftNear)
+      {
+        findClosestIn(begin, middle, position, k, isAccepted, candidates);
+      }
+      else
+      {
+        findClosestIn(middle + 1, end, position, k, isAccepted, candidates);
+      }
+
+      // The other side can only contain something better if it's closer than the worst
+      // point found so far
+      if (candidates.size() < k ||
+          toSplitPlane * toSplitPlane < candidates.front().squaredDistance)
+      {
+        if (isLeftNear)
+        {
+          findClosestIn(middle + 1, end, position, k, isAccepted, candidates);
+        }
+        else
+        {
+          findClosestIn(begin, middle, position, k, isAccepted, candidates);
+        }
+      }
+    }
+
+    void PointIndex::findClosestTwo(const bs::Vector3& position, bs::UINT32& closest,
+                                    bs::UINT32& secondClosest) const
+    {
+      ClosestTwo best;
+
+      findClosestTwoIn(0, numPoints(), position, best);
+
+      closest       = best.indices[0];
+      secondClosest = best.indices[1] == NO_POINT ? best.indices[0] : best.indices[1];
+    }
+
+    void PointIndex::findClosestTwo(const bs::Vector<bs::Vector3>& positions,
+                                    bs::Vector<bs::UINT32>& closest,
+                                    bs::Vector<bs::UINT32>& secondClosest) const
+    {
+      REGOTH_PROFILE_SCOPE("PointIndex::findClosestTwo");
+
+      closest.resize(positions.size());
+      secondClosest.resize(positions.size());
+
+      // Each position only writes its own entries, the index itself is never modified
+      Jobs::parallelFor("PointIndex", (bs::UINT32)positions.size(), POSITIONS_PER_TASK,
+                        [&](bs::UINT32 first, bs::UINT32 end) {
+                          for (bs::UINT32 i = first; i < end; i++)
+                          {
+                            findClosestTwo(positions[i], closest[i], secondClosest[i]);
+                          }
+                        });
+    }
+
+    void PointIndex::findClosestTwoIn(bs::UINT32 begin, bs::UINT32 end,
+                                      const bs::Vector3& position, ClosestTwo& best) const
+    {
+      if (begin >= end) return;
+
+      if (end - begin <= LEAF_SIZE)
+      {
+        // The whole subtree, no need to know how it's split
+        for (bs::UINT32 i = begin; i < end; i++)
+        {
+          float dx = mPoints[i].position.x - position.x;
+          float dy = mPoints[i].position.y - position.y;
+          float dz = mPoints[i].position.z - position.z;
+
+          best.offer(dx * dx + dy * dy + dz * dz, mPoints[i].index);
+        }
+
+        return;
+      }
+
+      bs::UINT32 middle  = begin + (end - begin) / 2;
+      const Point& point = mPoints[middle];
+
+      best.offer((point.position - position).squaredLength(), point.index);
+
+      bs::UINT8 axis     = mSplitAxes[middle];
+      float toSplitPlane = position[axis] - point.position[axis];
+
+      bool isLeftNear = toSplitPlane < 0.0f;
+
+      if (isLeftNear)
+      {
+        findClosestTwoIn(begin, middle, position, best);
+      }
+      else
+      {
+        findClosestTwoIn(middle + 1, end, position, best);
+      }
+
+      // Same as in findClosestIn(), the second best decides whether the other side matters
+      if (toSplitPlane * toSplitPlane < best.squaredDistances[1])
+      {
+        if (isLeftNear)
+        {
+          findClosestTwoIn(middle + 1, end, position, best);
+        }
+        else
+        {
+          findClosestTwoIn(begin, middle, position, best);
+        }
+      }
+    }
+
+    void PointIndex::findInRange(const bs::Vector3& position, float radius,
+                                 bs::Vector<bs::UINT32>& result) const
+    {
+      result.clear();
+
+      findInRangeIn(0, numPoints(), position, radius * radius, result);
+    }
+
+    void PointIndex::findInRangeIn(bs::UINT32 begin, bs::UINT32 end, const bs::Vector3& position,
+                                   float squaredRadius, bs::Vector<bs::UINT32>& result) const
+    {
+      if (begin >= end) return;
+
+      bs::UINT32 middle  = begin + (end - begin) / 2;
+      const Point& point = mPoints[middle];
+
+      if ((point.position - position).squaredLength() <= squaredRadius)
+      {
+        result.push_back(point.index);
+      }
+
+      if (end - begin == 1) return;
+
+      bs::UINT8 axis     = mSplitAxes[middle];
+      float toSplitPlane = position[axis] - point.position[axis];
+
+      bool isOtherSideInRange = toSplitPlane * toSplitPlane <= squaredRadius;
+
+      if (toSplitPlane < 0.0f || isOtherSideInRange)
+      {
+        findInRangeIn(begin, middle, position, squaredRadius, result);
+      }
+
+      if (toSplitPlane >= 0.0f || isOtherSideInRange)
+      {
+        findInRangeIn(middle + 1, end, position, squaredRadius, result);
+      }
+    }
+  }  // namespace AI
+}  // namespace REGoth
@@ -0,0 +1,173 @@
+#pragma once
+#include <BsCorePrerequisites.h>
+#include <Math/BsVector3.h>
+#include <functional>
+#include <limits>
+
+namespace REGoth
+{
+  namespace AI
+  {
+    /**
+     * K-d tree over a fixed set of positions, used to find the points close to some location
+     * without going through all of them.
+     *
+     * Points are identified by their index in the vector the index was built from. The tree is
+     * stored implicitly: The points are sorted so that the middle of every range splits it,
+     * with closer points to the left and the others to the right.
+     *
+     * Once built, the index is never modified, so it can be queried from multiple threads
+     * at once.
+     */
+    class PointIndex
+    {
+    public:
+      /** Returned when there is no point at all */
+      static constexpr bs::UINT32 NO_POINT = 0xFFFFFFFF;
+
+      /**
+       * Ranges of at most this many points are scanned as a whole by findClosestTwo() instead
+       * of going further down the tree. Scanning a few points that lie next to each other in
+       * memory in one tight loop is quicker than branching for each of them, and the loop is
+       * simple enough for the compiler to vectorize.
+       */
+      static constexpr bs::UINT32 LEAF_SIZE = 8;
+
+      /** Positions per task of the batched findClosestTwo() */
+      static constexpr bs::UINT32 POSITIONS_PER_TASK = 256;
+
+      PointIndex() = default;
+
+      /**
+       * Builds the index.
+       *
+       * @param  positions  Positions of all points.
+       */
+      PointIndex(const bs::Vector<bs::Vector3>& positions);
+
+      bs::UINT32 numPoints() const
+      {
+        return (bs::UINT32)mPoints.size();
+      }
+
+      /**
+       * Finds the `k` points closest to the given position.
+       *
+       * @param  result  Filled with the indices of the found points, closest first. Contains less
+       *                 than `k` points if there are not enough.
+       */
+      void findClosest(const bs::Vector3& position, bs::UINT32 k,
+                       bs::Vector<bs::UINT32>& result) const;
+
+      /**
+       * Like findClosest(), but only considers the points `isAccepted` returns true for. The
+       * others are skipped while searching, so the search still only looks at the part of the
+       * tree close to the position instead of filtering afterwards.
+       *
+       * @param  isAccepted  Called with the index of every point looked at.
+       */
+      void findClosest(const bs::Vector3& position, bs::UINT32 k,
+                       const std::function<bool(bs::UINT32)>& isAccepted,
+                       bs::Vector<bs::UINT32>& result) const;
+
+      /**
+       * Finds the two points closest to the given position, which is what most queries need.
+       * Unlike findClosest(), this doesn't allocate and keeps the best two in plain variables
+       * instead of a heap.
+       *
+       * @param  closest        Set to the closest point. NO_POINT if there are none at all.
+       * @param  secondClosest  Set to the second closest point. The same as `closest` if there
+       *                        is only one point, like findClosest() with `k = 2` would.
+       */
+      void findClosestTwo(const bs::Vector3& position, bs::UINT32& closest,
+                          bs::UINT32& secondClosest) const;
+
+      /**
+       * findClosestTwo() for many positions at once, e.g. for all characters asking during the
+       * same update. Large batches are spread across the worker threads.
+       *
+       * @param  closest        Filled with the closest point to each position, same order.
+       * @param  secondClosest  Filled with the second closest point to each position.
+       */
+      void findClosestTwo(const bs::Vector<bs::Vector3>& positions,
+                          bs::Vector<bs::UINT32>& closest,
+                          bs::Vector<bs::UINT32>& secondClosest) const;
+
+      /**
+       * Finds all points within the given distance of the position.
+       *
+       * @param  result  Filled with the indices of the found points, in no particular order.
+       */
+      void findInRange(const bs::Vector3& position, float radius,
+                       bs::Vector<bs::UINT32>& result) const;
+
+    private:
+      struct Point
+      {
+        bs::Vector3 position;
+        bs::UINT32 index;
+      };
+
+      /**
+       * A found point while searching in findClosest().
+       */
+      struct Candidate
+      {
+        float squaredDistance;
+        bs::UINT32 index;
+
+        bool operator<(const Candidate& other) const
+        {
+          return squaredDistance < other.squaredDistance;
+        }
+      };
+
+      /**
+       * Sorts the points in [begin, end) into a subtree.
+       */
+      void build(bs::UINT32 begin, bs::UINT32 end);
+
+      void findClosestIn(bs::UINT32 begin, bs::UINT32 end, const bs::Vector3& position,
+                         bs::UINT32 k, const std::function<bool(bs::UINT32)>& isAccepted,
+                         bs::Vector<Candidate>& candidates) const;
+
+      void findInRangeIn(bs::UINT32 begin, bs::UINT32 end, const bs::Vector3& position,
+                         float squaredRadius, bs::Vector<bs::UINT32>& result) const;
+
+      /**
+       * The best two points found so far by findClosestTwo().
+       */
+      struct ClosestTwo
+      {
+        float squaredDistances[2] = {std::numeric_limits<float>::max(),
+                                     std::numeric_limits<float>::max()};
+        bs::UINT32 indices[2]     = {NO_POINT, NO_POINT};
+
+        void offer(float squaredDistance, bs::UINT32 index)
+        {
+          if (squaredDistance < squaredDistances[0])
+          {
+            squaredDistances[1] = squaredDistances[0];
+            indices[1]          = indices[0];
+            squaredDistances[0] = squaredDistance;
+            indices[0]          = index;
+          }
+          else if (squaredDistance < squaredDistances[1])
+          {
+            squaredDistances[1] = squaredDistance;
+            indices[1]          = index;
+          }
+        }
+      };
+
+      void findClosestTwoIn(bs::UINT32 begin, bs::UINT32 end, const bs::Vector3& position,
+                            ClosestTwo& best) const;
+
+      /** Points, sorted into the tree */
+      bs::Vector<Point> mPoints;
+
+      /** Axis the range with the point at the same place as its middle is split at */
+      bs::Vector<bs::UINT8> mSplitAxes;
+    };
+  }  // namespace AI
+}  // namespace REGoth
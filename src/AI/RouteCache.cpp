@@ -0,0 +1,74 @@
+#include "RouteCache.hpp"
+
+namespace REGoth
+{
+  namespace AI
+  {
+    RouteCache::RouteCache(bs::UINT32 capacity)
+        : mCapacity(capacity)
+    {
+    }
+
+    bool RouteCache::find(bs::UINT32 from, bs::UINT32 to, bs::Vector<bs::UINT32>& path)
+    {
+      auto it = mIndex.find(keyOf(from, to));
+
+      if (it == mIndex.end())
+      {
+        mStats.numMisses += 1;
+        return false;
+      }
+
+      mStats.numHits += 1;
+
+      // Move to the front, since it has just been used
+      mEntries.splice(mEntries.begin(), mEntries, it->second);
+
+      path = it->second->path;
+
+      return true;
+    }
+
+    void RouteCache::insert(bs::UINT32 from, bs::UINT32 to, const bs::Vector<bs::UINT32>& path)
+    {
+      if (mCapacity == 0) return;
+
+      bs::UINT64 key = keyOf(from, to);
+      auto it        = mIndex.find(key);
+
+      if (it != mIndex.end())
+      {
+        it->second->path = path;
+        mEntries.splice(mEntries.begin(), mEntries, it->second);
+        return;
+      }
+
+      mEntries.push_front({key, path});
+      mIndex[key] = mEntries.begin();
+
+      shrinkToCapacity();
+    }
+
+    void RouteCache::clear()
+    {
+      mEntries.clear();
+      mIndex.clear();
+    }
+
+    void RouteCache::setCapacity(bs::UINT32 capacity)
+    {
+      mCapacity = capacity;
+
+      shrinkToCapacity();
+    }
+
+    void RouteCache::shrinkToCapacity()
+    {
+      while (mEntries.size() > mCapacity)
+      {
+        mIndex.erase(mEntries.back().key);
+        mEntries.pop_back();
+      }
+    }
+  }  // namespace AI
+}  // namespace REGoth
@@ -0,0 +1,97 @@
+#pragma once
+#include <BsCorePrerequisites.h>
+
+namespace REGoth
+{
+  namespace AI
+  {
+    /**
+     * Remembers the ways found between waypoints, so they don't have to be searched again.
+     *
+     * Characters following their daily routine walk the same ways every game day, so most
+     * searches ask for a way that has been found before. Ways are stored as the indices of the
+     * waypoints to visit, see WaynetGraph.
+     *
+     * Once full, the way used the longest time ago is dropped to make room (LRU).
+     */
+    class RouteCache
+    {
+    public:
+      struct Stats
+      {
+        bs::UINT64 numHits   = 0;
+        bs::UINT64 numMisses = 0;
+      };
+
+      /**
+       * @param  capacity  Maximum number of ways to remember.
+       */
+      RouteCache(bs::UINT32 capacity = 1024);
+
+      /**
+       * Looks up the way between the given waypoints.
+       *
+       * @param  path  Set to the remembered way, if there is one. Empty if it is known that
+       *               there is no way.
+       *
+       * @return Whether a way, or the knowledge that there is none, was remembered.
+       */
+      bool find(bs::UINT32 from, bs::UINT32 to, bs::Vector<bs::UINT32>& path);
+
+      /**
+       * Remembers the given way. Pass an empty path to remember that there is no way.
+       */
+      void insert(bs::UINT32 from, bs::UINT32 to, const bs::Vector<bs::UINT32>& path);
+
+      /**
+       * Forgets all ways, e.g. since the waynet changed. Keeps the statistics.
+       */
+      void clear();
+
+      /**
+       * Changes how many ways are remembered at most, dropping the oldest ones if needed.
+       */
+      void setCapacity(bs::UINT32 capacity);
+
+      bs::UINT32 capacity() const
+      {
+        return mCapacity;
+      }
+
+      bs::UINT32 size() const
+      {
+        return (bs::UINT32)mIndex.size();
+      }
+
+      const Stats& stats() const
+      {
+        return mStats;
+      }
+
+    private:
+      struct Entry
+      {
+        bs::UINT64 key;
+        bs::Vector<bs::UINT32> path;
+      };
+
+      static bs::UINT64 keyOf(bs::UINT32 from, bs::UINT32 to)
+      {
+        return ((bs::UINT64)from << 32) | to;
+      }
+
+      /**
+       * Drops the least recently used entries until there are no more than mCapacity.
+       */
+      void shrinkToCapacity();
+
+      /** Most recently used first */
+      bs::List<Entry> mEntries;
+
+      bs::UnorderedMap<bs::UINT64, bs::List<Entry>::iterator> mIndex;
+
+      bs::UINT32 mCapacity;
+      Stats mStats;
+    };
+  }  // namespace AI
+}  // namespace REGoth
@@ -40,6 +40,7 @@ namespace REGoth
 
     ScriptState::~ScriptState()
     {
+      forgetActiveTaskEnd();
     }
 
     void ScriptState::interruptActiveState()
@@ -78,7 +79,7 @@ namespace REGoth
       mNextState.name        = s_NativeStateNames[index];
       mNextState.nativeState = state;
 
-      fillStateScriptFunctions(mNextState);
+      fillStateScriptFunctions(mNextState, Scripting::SYMBOL_INDEX_INVALID);
 
       // Native states can never be routine states
       mNextState.isRoutineState = false;
@@ -86,9 +87,10 @@ namespace REGoth
       mNextState.isValid = true;
     }
 
-    void ScriptState::startScriptAIState(const bs::String& state)
+    void ScriptState::startScriptAIState(const bs::String& state,
+                                         Scripting::SymbolIndex stateFunction)
     {
-      REGOTH_LOG(Info, Uncategorized, "[ScriptState] Starting state {0} on npc {1}", state,
+      REGOTH_LOG(Info, AI, "[ScriptState] Starting state {0} on npc {1}", state,
                  mHostCharacter->SO()->getName());
 
       // Save script variables used by the state
@@ -100,7 +102,7 @@ namespace REGoth
       mNextState.name        = state;
       mNextState.nativeState = NativeState::ScriptBased;
 
-      fillStateScriptFunctions(mNextState);
+      fillStateScriptFunctions(mNextState, stateFunction);
 
       // Script states CAN be routine states, so while this is set to false here, it will
       // be set to true in startRoutineState() which calls this method first
@@ -109,9 +111,10 @@ namespace REGoth
       mNextState.isValid = true;
     }
 
-    void ScriptState::startRoutineState(const bs::String& state)
+    void ScriptState::startRoutineState(const bs::String& state,
+                                        Scripting::SymbolIndex stateFunction)
     {
-      startScriptAIState(state);
+      startScriptAIState(state, stateFunction);
 
       mNextState.isRoutineState = true;
     }
@@ -127,46 +130,25 @@ namespace REGoth
       mCurrentState.isRoutineState = oldIsRoutineState;
     }
 
-    void ScriptState::fillStateScriptFunctions(AIState& state)
+    void ScriptState::fillStateScriptFunctions(AIState& state,
+                                               Scripting::SymbolIndex stateFunction)
     {
-      const bs::String end       = state.name + "_END";
-      const bs::String loop      = state.name + "_LOOP";
-      const bs::String interrupt = state.name + "_INTERRUPT";
-      const auto& symbols        = scriptVM().scriptSymbolsConst();
+      const auto& symbols = scriptVM().scriptSymbolsConst();
 
-      // No check whether this exists here, let getSymbol throw if the main-function does not exist
-      mNextState.symIndex = symbols.getSymbol<Scripting::SymbolScriptFunction>(state.name).index;
-
-      // End, Loop and Interrupt are optional
-      if (symbols.hasSymbolWithName(end))
-      {
-        const auto& symbol = symbols.getSymbol<Scripting::SymbolScriptFunction>(end);
-        mNextState.symEnd  = symbol.index;
-      }
-      else
+      if (stateFunction == Scripting::SYMBOL_INDEX_INVALID)
       {
-        mNextState.symEnd = Scripting::SYMBOL_INDEX_INVALID;
+        // No check whether this exists here, let getSymbol throw if the main-function does not
+        // exist
+        stateFunction = symbols.getSymbol<Scripting::SymbolScriptFunction>(state.name).index;
       }
 
-      if (symbols.hasSymbolWithName(loop))
-      {
-        const auto& symbol = symbols.getSymbol<Scripting::SymbolScriptFunction>(loop);
-        mNextState.symLoop = symbol.index;
-      }
-      else
-      {
-        mNextState.symLoop = Scripting::SYMBOL_INDEX_INVALID;
-      }
+      // End, Loop and Interrupt are optional and invalid if missing
+      Scripting::AIStateFunctions functions = scriptVM().aiStateFunctions(stateFunction);
 
-      if (symbols.hasSymbolWithName(interrupt))
-      {
-        const auto& symbol      = symbols.getSymbol<Scripting::SymbolScriptFunction>(interrupt);
-        mNextState.symInterrupt = symbol.index;
-      }
-      else
-      {
-        mNextState.symInterrupt = Scripting::SYMBOL_INDEX_INVALID;
-      }
+      state.symIndex     = functions.main;
+      state.symLoop      = functions.loop;
+      state.symEnd       = functions.end;
+      state.symInterrupt = functions.interrupt;
     }
 
     bool ScriptState::applyStateChange()
@@ -206,10 +188,7 @@ namespace REGoth
 
       if (isInRoutine())
       {
-        bs::INT32 hour   = mWorld->gameclock()->getHour();
-        bs::INT32 minute = mWorld->gameclock()->getMinute();
-
-        if (!isTimeInTaskRange(activeTask(), hour, minute))
+        if (hasActiveTaskEnded())
         {
           startNewRoutineTaskMatchingTime();
         }
@@ -276,7 +255,9 @@ namespace REGoth
 
           if (mCurrentState.phase == AIState::Phase::Uninitialized)
           {
-            // TODO: Set perception-time to 5000
+            // States which want something else call Npc_SetPercTime in their start function
+            mWorld->perceptionSystem().setPerceptionTime(
+                mHostCharacter, PerceptionSystem::DEFAULT_PERCEPTION_TIME);
 
             if (mCurrentState.symIndex != Scripting::SYMBOL_INDEX_INVALID)
             {
@@ -341,9 +322,6 @@ namespace REGoth
 
     void ScriptState::doAIStateDuringShrink()
     {
-      bs::INT32 hour   = mWorld->gameclock()->getHour();
-      bs::INT32 minute = mWorld->gameclock()->getMinute();
-
       if (mRoutine.hasRoutine)
       {
         bool isDoingScriptState = mCurrentState.isValid || mNextState.isValid;
@@ -354,7 +332,7 @@ namespace REGoth
           // teleported to the position they should be at according to their currently
           // active routine state. This is why Diego will be already in the old-camp
           // when you reach it, even though you just saw him walking very slowly towards it.
-          if (!isTimeInTaskRange(activeTask(), hour, minute))
+          if (hasActiveTaskEnded())
           {
             startNewRoutineTaskMatchingTime();
           }
@@ -441,7 +419,7 @@ namespace REGoth
         // Set current waypoint of script instance
         mHostCharacter->setCurrentWaypoint(task.waypoint);
 
-        startRoutineState(task.scriptFunction);
+        startRoutineState(task.scriptFunction, task.scriptFunctionIndex);
         requestEndActiveState();
 
         return applyStateChange();
@@ -492,6 +470,7 @@ namespace REGoth
       }
 
       mRoutine.hasRoutine = true;  // At least one routine-target present
+      forgetActiveTaskEnd();
     }
 
     void ScriptState::reinitRoutine()
@@ -502,6 +481,7 @@ namespace REGoth
       mRoutine.routine.clear();
       mRoutine.activeRoutineIndex    = 0;
       mRoutine.shouldStartNewRoutine = true;
+      forgetActiveTaskEnd();
 
       if (!routine.empty())
       {
@@ -527,6 +507,7 @@ namespace REGoth
     {
       mRoutine.hasRoutine = false;
       mRoutine.routine.clear();
+      forgetActiveTaskEnd();
     }
 
     void ScriptState::setCurrentStateTime(float time)
@@ -547,6 +528,51 @@ namespace REGoth
       return mRoutine.routine[mRoutine.activeRoutineIndex];
     }
 
+    bool ScriptState::hasActiveTaskEnded()
+    {
+      if (mRoutine.isTaskEndKnown && !mRoutine.hasTaskEndBeenReached) return false;
+
+      // Either the end has been reached or the time was set, like by a script. Both need to
+      // look at the task again.
+      forgetActiveTaskEnd();
+
+      const RoutineTask& task = activeTask();
+
+      bs::INT32 hour   = mWorld->gameclock()->getHour();
+      bs::INT32 minute = mWorld->gameclock()->getMinute();
+
+      if (!isTimeInTaskRange(task, hour, minute)) return true;
+
+      watchActiveTaskEnd(task);
+
+      return false;
+    }
+
+    void ScriptState::watchActiveTaskEnd(const RoutineTask& task)
+    {
+      // Only sets a flag, so nothing happens while the clock is still triggering
+      auto onEnd = [this]() { mRoutine.hasTaskEndBeenReached = true; };
+
+      const auto& clock = mWorld->gameclock();
+
+      mRoutine.onTaskEndReached = clock->onTimeReached(task.hoursEnd, task.minutesEnd, onEnd);
+      mRoutine.onTimeSet        = clock->onTimeSet.connect(onEnd);
+
+      mRoutine.isTaskEndKnown        = true;
+      mRoutine.hasTaskEndBeenReached = false;
+    }
+
+    void ScriptState::forgetActiveTaskEnd()
+    {
+      if (!mRoutine.isTaskEndKnown) return;
+
+      mRoutine.onTaskEndReached.disconnect();
+      mRoutine.onTimeSet.disconnect();
+
+      mRoutine.isTaskEndKnown        = false;
+      mRoutine.hasTaskEndBeenReached = false;
+    }
+
     bool ScriptState::isTimeInTaskRange(const RoutineTask& task, bs::INT32 hours, bs::INT32 minutes)
     {
       auto tbigger = [&](int h1, int m1, int h2, int m2) {
@@ -582,12 +608,13 @@ namespace REGoth
       for (RoutineTask& e : mRoutine.routine)
       {
         // Don't start the same routine again
-        if (i == mRoutine.activeRoutineIndex)
+        if (i != mRoutine.activeRoutineIndex)
         {
           if (isTimeInTaskRange(e, hour, minute))
           {
             mRoutine.activeRoutineIndex    = i;
             mRoutine.shouldStartNewRoutine = true;
+            forgetActiveTaskEnd();
 
             return;
           }
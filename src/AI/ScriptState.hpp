@@ -1,5 +1,6 @@
 #pragma once
 #include <BsCorePrerequisites.h>
+#include <Utility/BsEvent.h>
 #include <RTTI/RTTIUtil.hpp>
 #include <scripting/ScriptTypes.hpp>
 
@@ -120,13 +121,19 @@ namespace REGoth
        *                be an instruction-function, like `B_SOMETHING`, which is just executed
        *                straight away. This seems weird to have here, but it's like the original
        *                is doing it.
+       * @param  stateFunction  Symbol of the function named `state`, if known. Otherwise it
+       *                        is looked up by name.
        */
-      void startScriptAIState(const bs::String& state);
+      void startScriptAIState(
+          const bs::String& state,
+          Scripting::SymbolIndex stateFunction = Scripting::SYMBOL_INDEX_INVALID);
 
       /**
        * Same as startScriptAIState(), but for states used for Routines.
        */
-      void startRoutineState(const bs::String& state);
+      void startRoutineState(
+          const bs::String& state,
+          Scripting::SymbolIndex stateFunction = Scripting::SYMBOL_INDEX_INVALID);
 
       /**
        * Runs a simple script instruction, such as `B_SOMETHING`.
@@ -239,6 +246,9 @@ namespace REGoth
         bs::String scriptFunction;
         bs::String waypoint;
 
+        // Symbol of scriptFunction, if known. Not saved, looked up by name after loading.
+        Scripting::SymbolIndex scriptFunctionIndex = Scripting::SYMBOL_INDEX_INVALID;
+
         REGOTH_DECLARE_RTTI_FOR_REFLECTABLE(RoutineTask);
       };
 
@@ -330,8 +340,11 @@ namespace REGoth
        * on start of the state. If the state is running, we need to call `ZS_TALK_LOOP`
        * and if it ended, we need to call `ZS_STATE_END`. Therefore, we search for these
        * tagged function names and store their symbol indices for faster access.
+       *
+       * The tagged functions are taken from the table the script VM made once after loading
+       * its symbols, see ScriptVMForGameWorld::aiStateFunctions().
        */
-      void fillStateScriptFunctions(AIState& state);
+      void fillStateScriptFunctions(AIState& state, Scripting::SymbolIndex stateFunction);
 
       /**
        * @return Whether the time passed in lays in between the start- and stop times defined in
@@ -354,6 +367,25 @@ namespace REGoth
        */
       RoutineTask& activeTask();
 
+      /**
+       * @return Whether the game time left the range of the active task, so a new one has to
+       *         be found. Once the time is known to be inside the task, the game clock tells
+       *         when that changes, see watchActiveTaskEnd().
+       */
+      bool hasActiveTaskEnded();
+
+      /**
+       * Subscribes to the game clock reaching the end of the given task or the time being
+       * set, which sets `mRoutine.hasTaskEndBeenReached`.
+       */
+      void watchActiveTaskEnd(const RoutineTask& task);
+
+      /**
+       * Disconnects from the game clock, so hasActiveTaskEnded() looks at the time again.
+       * Needs to be called whenever the active task changes.
+       */
+      void forgetActiveTaskEnd();
+
       // Currently executed AI-state
       AIState mCurrentState;
 
@@ -389,6 +421,13 @@ namespace REGoth
 
         // Whether any routine has been registered yet
         bool hasRoutine = false;
+
+        // Whether the game clock tells when the active task ends, see watchActiveTaskEnd().
+        // Not saved, the clock is subscribed to again after loading.
+        bool isTaskEndKnown        = false;
+        bool hasTaskEndBeenReached = false;
+        bs::HEvent onTaskEndReached;
+        bs::HEvent onTimeSet;
       } mRoutine;
 
     public:
@@ -0,0 +1,112 @@
+#include "ScriptStateScheduler.hpp"
+#include <Scene/BsSceneObject.h>
+#include <Utility/BsTime.h>
+#include <components/Character.hpp>
+#include <components/GameClock.hpp>
+#include <components/GameWorld.hpp>
+
+namespace REGoth
+{
+  namespace AI
+  {
+    ScriptStateScheduler::Tier ScriptStateScheduler::tierOf(const bs::Vector3& position)
+    {
+      startFrameIfNeeded();
+
+      if (!mHasHero) return Tier::Near;
+
+      float distanceSq = position.squaredDistance(mHeroPosition);
+
+      if (distanceSq < mSettings.nearDistance * mSettings.nearDistance)
+      {
+        return Tier::Near;
+      }
+      else if (distanceSq < mSettings.farDistance * mSettings.farDistance)
+      {
+        return Tier::Medium;
+      }
+      else
+      {
+        return Tier::Far;
+      }
+    }
+
+    bool ScriptStateScheduler::shouldRun(const bs::Vector3& position, float timeSinceLastRun)
+    {
+      Tier tier = tierOf(position);
+
+      if (tier == Tier::Near) return true;
+
+      float interval = (tier == Tier::Medium) ? mSettings.mediumInterval : mSettings.farInterval;
+
+      if (timeSinceLastRun < interval) return false;
+
+      if (mSettings.maxStepsPerFrame != 0 &&
+          mCurrentFrameStats.numSteps > mSettings.maxStepsPerFrame)
+      {
+        mCurrentFrameStats.numCoalesced += 1;
+        return false;
+      }
+
+      bs::UINT64 budget = (bs::UINT64)(mSettings.budgetMilliseconds * 1000000.0f);
+
+      if (budget != 0 && mCurrentFrameStats.nanosecondsUsed >= budget)
+      {
+        mCurrentFrameStats.numDeferred += 1;
+        return false;
+      }
+
+      return true;
+    }
+
+    bool ScriptStateScheduler::shouldJumpRoutines()
+    {
+      startFrameIfNeeded();
+
+      return mTimeScale >= mSettings.routineJumpTimeScale;
+    }
+
+    void ScriptStateScheduler::beginStep()
+    {
+      startFrameIfNeeded();
+
+      mCurrentFrameStats.numSteps += 1;
+    }
+
+    void ScriptStateScheduler::recordRun(bs::UINT64 nanoseconds)
+    {
+      startFrameIfNeeded();
+
+      mCurrentFrameStats.numRun += 1;
+      mCurrentFrameStats.nanosecondsUsed += nanoseconds;
+    }
+
+    void ScriptStateScheduler::startFrameIfNeeded()
+    {
+      bs::UINT64 frame = bs::gTime().getFrameIdx();
+
+      if (frame == mCurrentFrame) return;
+
+      mLastFrameStats    = mCurrentFrameStats;
+      mCurrentFrameStats = FrameStats();
+      mCurrentFrame      = frame;
+
+      HCharacter hero;
+      mTimeScale = 1.0f;
+
+      if (mWorld)
+      {
+        hero       = mWorld->hero();
+        mTimeScale = mWorld->gameclock()->getTimeScale();
+      }
+
+      mHasHero = false;
+
+      if (hero)
+      {
+        mHasHero      = true;
+        mHeroPosition = hero->SO()->getTransform().pos();
+      }
+    }
+  }  // namespace AI
+}  // namespace REGoth
@@ -0,0 +1,188 @@
+#pragma once
+#include <BsCorePrerequisites.h>
+#include <Math/BsVector3.h>
+
+namespace REGoth
+{
+  class GameWorld;
+  using HGameWorld = bs::GameObjectHandle<GameWorld>;
+
+  namespace AI
+  {
+    /**
+     * Settings of the ScriptStateScheduler. Distances are in meters, times in seconds.
+     */
+    struct ScriptStateSchedulerSettings
+    {
+      /**
+       * Characters closer to the hero than this run their script states on every fixed update.
+       */
+      float nearDistance = 30.0f;
+
+      /**
+       * Characters farther away from the hero than this are in the far tier.
+       * Between nearDistance and farDistance they are in the medium tier.
+       */
+      float farDistance = 80.0f;
+
+      /**
+       * Time between two runs of the script states of characters in the medium tier.
+       */
+      float mediumInterval = 0.25f;
+
+      /**
+       * Time between two runs of the script states of characters in the far tier.
+       */
+      float farInterval = 1.0f;
+
+      /**
+       * Milliseconds script states may take per frame. Once used up, characters outside the
+       * near tier wait for the next frame. 0 means no limit.
+       */
+      float budgetMilliseconds = 2.0f;
+
+      /**
+       * Fixed updates per frame in which characters outside the near tier may run. After a
+       * slow frame, bs:f runs several fixed updates back to back to catch up. Running every
+       * tier in all of them would make the next frame slow as well. 0 means no limit.
+       */
+      bs::UINT32 maxStepsPerFrame = 2;
+
+      /**
+       * From this time scale of the game clock on, characters don't walk along their daily
+       * routines anymore. They are teleported to the waypoint of their current routine task
+       * instead, like characters far away from the camera, see GameClock::setTimeScale().
+       * Otherwise they would never arrive before the task ends.
+       */
+      float routineJumpTimeScale = 8.0f;
+    };
+
+    /**
+     * Decides how often the script states of a character are run, depending on how far
+     * away from the hero the character is.
+     *
+     * Running the script states of every character on every fixed update is quite expensive,
+     * but most characters are too far away from the player for anyone to notice whether they
+     * do their thing a little later. So characters are put into one of three tiers:
+     *
+     *  - *Near*: Run on every fixed update,
+     *  - *Medium*: Run every ScriptStateSchedulerSettings::mediumInterval seconds,
+     *  - *Far*: Run every ScriptStateSchedulerSettings::farInterval seconds.
+     *
+     * Characters which are not run collect the time that passed and get all of it once they
+     * run again, so their states take as long as they would have otherwise.
+     *
+     * In addition, the time script states take per frame is limited. Once the budget is
+     * used up, only characters in the near tier are run until the next frame starts. The same
+     * goes for fixed updates past ScriptStateSchedulerSettings::maxStepsPerFrame within one
+     * frame: Characters outside the near tier then get the time of those steps coalesced into
+     * their next run.
+     *
+     * Every GameWorld has one scheduler, see GameWorld::scriptStateScheduler().
+     * It is not saved, the settings have to be set again after loading.
+     */
+    class ScriptStateScheduler
+    {
+    public:
+      enum class Tier
+      {
+        Near,
+        Medium,
+        Far,
+      };
+
+      /**
+       * Counters of a single frame.
+       */
+      struct FrameStats
+      {
+        bs::UINT32 numRun          = 0;
+        bs::UINT32 numDeferred     = 0;
+        bs::UINT32 numCoalesced    = 0;
+        bs::UINT32 numSteps        = 0;
+        bs::UINT64 nanosecondsUsed = 0;
+      };
+
+      ScriptStateScheduler() = default;
+
+      /**
+       * Sets the world whose hero the distances are measured to.
+       */
+      void setWorld(HGameWorld world)
+      {
+        mWorld = world;
+      }
+
+      void setSettings(const ScriptStateSchedulerSettings& settings)
+      {
+        mSettings = settings;
+      }
+
+      const ScriptStateSchedulerSettings& settings() const
+      {
+        return mSettings;
+      }
+
+      /**
+       * @return Tier of a character at the given position. If there is no hero, every
+       *         character is in the near tier.
+       */
+      Tier tierOf(const bs::Vector3& position);
+
+      /**
+       * @param  position          Where the character is.
+       * @param  timeSinceLastRun  Seconds since the script states of the character have been run
+       *                           the last time.
+       *
+       * @return Whether the script states of the character at the given position should be run
+       *         now. If so, recordRun() has to be called afterwards.
+       */
+      bool shouldRun(const bs::Vector3& position, float timeSinceLastRun);
+
+      /**
+       * @return Whether the game clock runs so fast that characters should jump between their
+       *         routine tasks instead of running their script states, see
+       *         ScriptStateSchedulerSettings::routineJumpTimeScale.
+       */
+      bool shouldJumpRoutines();
+
+      /**
+       * To be called once per fixed update, before any character asks shouldRun().
+       */
+      void beginStep();
+
+      /**
+       * To be called after running the script states of a character. Counts against the budget
+       * of the current frame.
+       */
+      void recordRun(bs::UINT64 nanoseconds);
+
+      /**
+       * @return Counters of the last completed frame.
+       */
+      const FrameStats& lastFrameStats() const
+      {
+        return mLastFrameStats;
+      }
+
+    private:
+      /**
+       * Resets the budget and looks up where the hero is and how fast the game clock runs,
+       * once a new frame has started.
+       */
+      void startFrameIfNeeded();
+
+      HGameWorld mWorld;
+      ScriptStateSchedulerSettings mSettings;
+
+      bs::UINT64 mCurrentFrame = ~0ULL;
+      FrameStats mCurrentFrameStats;
+      FrameStats mLastFrameStats;
+
+      bool mHasHero = false;
+      bs::Vector3 mHeroPosition;
+
+      float mTimeScale = 1.0f;
+    };
+  }  // namespace AI
+}  // namespace REGoth
@@ -0,0 +1,54 @@
+#pragma once
+#include <BsCorePrerequisites.h>
+#include <atomic>
+
+namespace REGoth
+{
+  class Waynet;
+
+  namespace AI
+  {
+    class WaynetGraph;
+    class WaynetHierarchy;
+
+    /**
+     * A way search running in the background, see Waynet::requestWay().
+     *
+     * The search is done by a task of the bs::TaskScheduler on the WaynetGraph which was
+     * current when the request was made. Since a graph is never modified, nothing has to be
+     * locked. The result is picked up by Waynet::collectWay() on the main thread.
+     */
+    class WayRequest
+    {
+    public:
+      /**
+       * @return Whether the search has finished and the result can be collected.
+       */
+      bool isDone() const
+      {
+        return mIsDone.load(std::memory_order_acquire);
+      }
+
+    private:
+      friend class REGoth::Waynet;
+
+      bs::UINT32 mFrom = 0;
+      bs::UINT32 mTo   = 0;
+
+      /** Graph to search on. Kept alive by the request, even if the waynet rebuilds its own. */
+      bs::SPtr<const WaynetGraph> mGraph;
+
+      /** If set, used to search instead of mGraph, see WaynetHierarchy. */
+      bs::SPtr<const WaynetHierarchy> mHierarchy;
+
+      /** Indices of the waypoints to visit. Empty if there is no way. */
+      bs::Vector<bs::UINT32> mPath;
+
+      /** Only set once mPath has been written completely */
+      std::atomic<bool> mIsDone = {false};
+
+      /** Whether the result came out of the route cache */
+      bool mIsFromCache = false;
+    };
+  }  // namespace AI
+}  // namespace REGoth
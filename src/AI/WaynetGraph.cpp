@@ -0,0 +1,110 @@
+#include "WaynetGraph.hpp"
+#include "WaynetSearch.hpp"
+#include <cmath>
+
+namespace REGoth
+{
+  namespace AI
+  {
+    constexpr bs::UINT32 WaynetGraph::NO_NODE;
+
+    /**
+     * One context per thread, so searches on different threads don't get into each others way.
+     */
+    static thread_local WaynetSearchContext s_SearchContext;
+
+    WaynetGraph::WaynetGraph(const bs::Vector<bs::Vector3>& positions,
+                             const bs::Vector<bs::Vector<bs::UINT32>>& neighbours)
+    {
+      mPositionsX.reserve(positions.size());
+      mPositionsY.reserve(positions.size());
+      mPositionsZ.reserve(positions.size());
+
+      for (const bs::Vector3& p : positions)
+      {
+        mPositionsX.push_back(p.x);
+        mPositionsY.push_back(p.y);
+        mPositionsZ.push_back(p.z);
+      }
+
+      mOffsets.reserve(positions.size() + 1);
+
+      for (bs::UINT32 node = 0; node < (bs::UINT32)positions.size(); node++)
+      {
+        mOffsets.push_back((bs::UINT32)mNeighbours.size());
+
+        for (bs::UINT32 next : neighbours[node])
+        {
+          mNeighbours.push_back(next);
+          mEdgeLengths.push_back(positions[node].distance(positions[next]));
+        }
+      }
+
+      mOffsets.push_back((bs::UINT32)mNeighbours.size());
+    }
+
+    bool WaynetGraph::findWay(bs::UINT32 from, bs::UINT32 to, bs::Vector<bs::UINT32>& path,
+                              WaynetSearchStats* stats) const
+    {
+      if (from >= numNodes() || to >= numNodes()) return false;
+
+      // A* with the straight distance to the target as heuristic. Since the edges are weighted
+      // by their actual length, the heuristic never overestimates and the first time the target
+      // is taken from the open list, the shortest way has been found.
+      WaynetSearchContext& search = s_SearchContext;
+
+      auto forEachEdge = [this](bs::UINT32 node, auto visit) {
+        for (bs::UINT32 edge = mOffsets[node]; edge < mOffsets[node + 1]; edge++)
+        {
+          visit(mNeighbours[edge], mEdgeLengths[edge]);
+        }
+      };
+
+      auto distanceToTarget = [this, to](bs::UINT32 node) { return distance(node, to); };
+
+      if (!searchWaynet(search, numNodes(), from, to, forEachEdge, distanceToTarget, stats))
+      {
+        return false;
+      }
+
+      search.collectPath(to, path);
+
+      return true;
+    }
+
+    float WaynetGraph::distance(bs::UINT32 a, bs::UINT32 b) const
+    {
+      float dx = mPositionsX[a] - mPositionsX[b];
+      float dy = mPositionsY[a] - mPositionsY[b];
+      float dz = mPositionsZ[a] - mPositionsZ[b];
+
+      return std::sqrt(dx * dx + dy * dy + dz * dz);
+    }
+
+    /**
+     * FNV-1a over the raw bytes of the given values.
+     */
+    template <typename T>
+    static void hashValues(const bs::Vector<T>& values, bs::UINT64& hash)
+    {
+      const bs::UINT8* bytes = reinterpret_cast<const bs::UINT8*>(values.data());
+
+      for (size_t i = 0; i < values.size() * sizeof(T); i++)
+      {
+        hash ^= bytes[i];
+        hash *= 0x100000001b3ull;
+      }
+    }
+
+    bs::UINT64 WaynetGraph::hash() const
+    {
+      bs::UINT64 hash = 0xcbf29ce484222325ull;
+
+      hashValues(mOffsets, hash);
+      hashValues(mNeighbours, hash);
+      hashValues(mEdgeLengths, hash);
+
+      return hash;
+    }
+  }  // namespace AI
+}  // namespace REGoth
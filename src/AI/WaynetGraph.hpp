@@ -0,0 +1,113 @@
+#pragma once
+#include <BsCorePrerequisites.h>
+#include <Math/BsVector3.h>
+#include <limits>
+
+namespace REGoth
+{
+  namespace AI
+  {
+    struct WaynetSearchStats;
+
+    /**
+     * Flat copy of the connections between the waypoints of a Waynet.
+     *
+     * The Waynet keeps the paths of every waypoint in a list of its own. This graph keeps
+     * everything the searches need in a few plain arrays instead:
+     *
+     *  - The neighbours of all nodes in *Compressed Sparse Row*-format: The neighbours of
+     *    node `n` are stored at `neighbours[offsets[n]]` up to `neighbours[offsets[n + 1]]`,
+     *  - The length of every edge, at the same place as the neighbour it leads to,
+     *  - The positions of all nodes, one array per axis.
+     *
+     * Nodes are identified by the index of their waypoint inside the Waynet.
+     *
+     * Once built, the graph is never modified, so it can be searched from multiple threads
+     * at once. The Waynet builds a new one whenever waypoints or paths are added,
+     * see Waynet::graph().
+     */
+    class WaynetGraph
+    {
+    public:
+      static constexpr bs::UINT32 NO_NODE = std::numeric_limits<bs::UINT32>::max();
+
+      WaynetGraph() = default;
+
+      /**
+       * Builds the graph.
+       *
+       * @param  positions   Position of every node.
+       * @param  neighbours  Nodes every node is connected to, one list per node.
+       */
+      WaynetGraph(const bs::Vector<bs::Vector3>& positions,
+                  const bs::Vector<bs::Vector<bs::UINT32>>& neighbours);
+
+      bs::UINT32 numNodes() const
+      {
+        return (bs::UINT32)mPositionsX.size();
+      }
+
+      bs::Vector3 position(bs::UINT32 node) const
+      {
+        return bs::Vector3(mPositionsX[node], mPositionsY[node], mPositionsZ[node]);
+      }
+
+      /**
+       * @return Range of edges going out from the given node. Use neighbourOf() and
+       *         edgeLength() to look at them.
+       */
+      bs::UINT32 firstEdgeOf(bs::UINT32 node) const
+      {
+        return mOffsets[node];
+      }
+
+      bs::UINT32 endEdgeOf(bs::UINT32 node) const
+      {
+        return mOffsets[node + 1];
+      }
+
+      bs::UINT32 neighbourOf(bs::UINT32 edge) const
+      {
+        return mNeighbours[edge];
+      }
+
+      float edgeLength(bs::UINT32 edge) const
+      {
+        return mEdgeLengths[edge];
+      }
+
+      /**
+       * Finds the shortest way between the given nodes.
+       *
+       * @param  path  Filled with all nodes to visit, including `from` and `to`, if a way
+       *               was found.
+       *
+       * @param  stats Optional, counts the work done by the search.
+       *
+       * @return Whether a way was found.
+       */
+      bool findWay(bs::UINT32 from, bs::UINT32 to, bs::Vector<bs::UINT32>& path,
+                   WaynetSearchStats* stats = nullptr) const;
+
+      /**
+       * @return Straight distance between the given nodes.
+       */
+      float distance(bs::UINT32 a, bs::UINT32 b) const;
+
+      /**
+       * @return Hash over the nodes and edges, to tell whether something built for a graph,
+       *         like a saved WaynetNextHopTable, still fits this one.
+       */
+      bs::UINT64 hash() const;
+
+    private:
+      bs::Vector<bs::UINT32> mOffsets;
+      bs::Vector<bs::UINT32> mNeighbours;
+      bs::Vector<float> mEdgeLengths;
+
+      bs::Vector<float> mPositionsX;
+      bs::Vector<float> mPositionsY;
+      bs::Vector<float> mPositionsZ;
+    };
+  }  // namespace AI
+}  // namespace REGoth
@@ -0,0 +1,336 @@
+#include "WaynetHierarchy.hpp"
+#include "WaynetGraph.hpp"
+#include "WaynetSearch.hpp"
+#include <cmath>
+
+namespace REGoth
+{
+  namespace AI
+  {
+    constexpr float WaynetHierarchy::DEFAULT_CLUSTER_SIZE;
+
+    /**
+     * One context per thread and kind of search, so searches on different threads don't get
+     * into each others way.
+     */
+    static thread_local WaynetSearchContext s_ClusterSearchContext;
+    static thread_local WaynetSearchContext s_AbstractSearchContext;
+
+    WaynetHierarchy::WaynetHierarchy(bs::SPtr<const WaynetGraph> graph, float clusterSize)
+        : mGraph(std::move(graph))
+        , mClusterSize(clusterSize)
+    {
+      const WaynetGraph& g      = *mGraph;
+      const bs::UINT32 numNodes = g.numNodes();
+
+      // Put every node into the cluster of the grid cell it is in
+      bs::UnorderedMap<bs::UINT64, bs::UINT32> clusterOfCell;
+      mClusterOf.resize(numNodes);
+
+      for (bs::UINT32 node = 0; node < numNodes; node++)
+      {
+        bs::Vector3 position = g.position(node);
+
+        bs::INT32 cellX = (bs::INT32)std::floor(position.x / mClusterSize);
+        bs::INT32 cellZ = (bs::INT32)std::floor(position.z / mClusterSize);
+        bs::UINT64 cell = ((bs::UINT64)(bs::UINT32)cellX << 32) | (bs::UINT32)cellZ;
+
+        auto it = clusterOfCell.find(cell);
+
+        if (it == clusterOfCell.end())
+        {
+          it = clusterOfCell.insert({cell, mNumClusters}).first;
+          mNumClusters += 1;
+        }
+
+        mClusterOf[node] = it->second;
+      }
+
+      // Reverse all edges, by counting the incoming edges of every node first
+      mReverseOffsets.assign(numNodes + 1, 0);
+
+      for (bs::UINT32 node = 0; node < numNodes; node++)
+      {
+        for (bs::UINT32 edge = g.firstEdgeOf(node); edge < g.endEdgeOf(node); edge++)
+        {
+          mReverseOffsets[g.neighbourOf(edge) + 1] += 1;
+        }
+      }
+
+      for (bs::UINT32 node = 0; node < numNodes; node++)
+      {
+        mReverseOffsets[node + 1] += mReverseOffsets[node];
+      }
+
+      mReverseNeighbours.resize(mReverseOffsets.back());
+      mReverseEdgeLengths.resize(mReverseOffsets.back());
+
+      bs::Vector<bs::UINT32> nextReverseEdge(mReverseOffsets.begin(), mReverseOffsets.end() - 1);
+
+      for (bs::UINT32 node = 0; node < numNodes; node++)
+      {
+        for (bs::UINT32 edge = g.firstEdgeOf(node); edge < g.endEdgeOf(node); edge++)
+        {
+          bs::UINT32 reverse = nextReverseEdge[g.neighbourOf(edge)]++;
+
+          mReverseNeighbours[reverse]  = node;
+          mReverseEdgeLengths[reverse] = g.edgeLength(edge);
+        }
+      }
+
+      // Both ends of every path between two clusters are portals
+      mPortalOf.assign(numNodes, WaynetGraph::NO_NODE);
+      mPortalsOfCluster.resize(mNumClusters);
+
+      auto makePortal = [&](bs::UINT32 node) {
+        if (mPortalOf[node] != WaynetGraph::NO_NODE) return;
+
+        mPortalOf[node] = (bs::UINT32)mPortals.size();
+        mPortalsOfCluster[mClusterOf[node]].push_back(mPortalOf[node]);
+        mPortals.push_back(node);
+      };
+
+      for (bs::UINT32 node = 0; node < numNodes; node++)
+      {
+        for (bs::UINT32 edge = g.firstEdgeOf(node); edge < g.endEdgeOf(node); edge++)
+        {
+          bs::UINT32 next = g.neighbourOf(edge);
+
+          if (mClusterOf[node] != mClusterOf[next])
+          {
+            makePortal(node);
+            makePortal(next);
+          }
+        }
+      }
+
+      // Abstract graph: The paths between clusters and the ways inside them
+      bs::Vector<PortalCost> costs;
+      mPortalOffsets.reserve(mPortals.size() + 1);
+
+      for (bs::UINT32 portal = 0; portal < (bs::UINT32)mPortals.size(); portal++)
+      {
+        bs::UINT32 node = mPortals[portal];
+
+        mPortalOffsets.push_back((bs::UINT32)mPortalNeighbours.size());
+
+        for (bs::UINT32 edge = g.firstEdgeOf(node); edge < g.endEdgeOf(node); edge++)
+        {
+          bs::UINT32 next = g.neighbourOf(edge);
+
+          if (mClusterOf[node] != mClusterOf[next])
+          {
+            mPortalNeighbours.push_back(mPortalOf[next]);
+            mPortalEdgeCosts.push_back(g.edgeLength(edge));
+          }
+        }
+
+        findPortalCosts(node, false, costs, nullptr);
+
+        for (const PortalCost& c : costs)
+        {
+          if (c.portal == portal) continue;
+
+          mPortalNeighbours.push_back(c.portal);
+          mPortalEdgeCosts.push_back(c.cost);
+        }
+      }
+
+      mPortalOffsets.push_back((bs::UINT32)mPortalNeighbours.size());
+    }
+
+    bool WaynetHierarchy::findWay(bs::UINT32 from, bs::UINT32 to, bs::Vector<bs::UINT32>& path,
+                                  WaynetSearchStats* stats) const
+    {
+      const WaynetGraph& g = *mGraph;
+
+      if (from >= g.numNodes() || to >= g.numNodes()) return false;
+
+      // Short ways don't gain anything from the detour over the abstract graph
+      if (mClusterOf[from] == mClusterOf[to] || g.distance(from, to) < mClusterSize)
+      {
+        return g.findWay(from, to, path, stats);
+      }
+
+      return findWayAcrossClusters(from, to, path, stats);
+    }
+
+    bool WaynetHierarchy::findWayAcrossClusters(bs::UINT32 from, bs::UINT32 to,
+                                                bs::Vector<bs::UINT32>& path,
+                                                WaynetSearchStats* stats) const
+    {
+      const WaynetGraph& g = *mGraph;
+
+      bs::Vector<PortalCost> startCosts;
+      bs::Vector<PortalCost> targetCosts;
+
+      findPortalCosts(from, false, startCosts, stats);
+      findPortalCosts(to, true, targetCosts, stats);
+
+      // Stuck inside the cluster?
+      if (startCosts.empty() || targetCosts.empty()) return false;
+
+      // On top of the portals, the abstract graph has two more nodes for the start and target,
+      // which are connected to the portals of their clusters
+      const bs::UINT32 start         = numPortals();
+      const bs::UINT32 target        = numPortals() + 1;
+      const bs::UINT32 targetCluster = mClusterOf[to];
+
+      auto forEachEdge = [&](bs::UINT32 node, auto visit) {
+        if (node == start)
+        {
+          for (const PortalCost& c : startCosts)
+          {
+            visit(c.portal, c.cost);
+          }
+
+          return;
+        }
+
+        for (bs::UINT32 edge = mPortalOffsets[node]; edge < mPortalOffsets[node + 1]; edge++)
+        {
+          visit(mPortalNeighbours[edge], mPortalEdgeCosts[edge]);
+        }
+
+        if (mClusterOf[mPortals[node]] != targetCluster) return;
+
+        for (const PortalCost& c : targetCosts)
+        {
+          if (c.portal == node)
+          {
+            visit(target, c.cost);
+            break;
+          }
+        }
+      };
+
+      auto distanceToTarget = [&](bs::UINT32 node) {
+        if (node == target) return 0.0f;
+
+        return g.distance(node == start ? from : mPortals[node], to);
+      };
+
+      WaynetSearchContext& search = s_AbstractSearchContext;
+
+      if (!searchWaynet(search, numPortals() + 2, start, target, forEachEdge, distanceToTarget,
+                        stats))
+      {
+        return false;
+      }
+
+      bs::Vector<bs::UINT32> abstractPath;
+      search.collectPath(target, abstractPath);
+
+      // Refine the way between every two nodes on the abstract way
+      path.clear();
+      path.push_back(from);
+
+      bs::Vector<bs::UINT32> segment;
+      bs::UINT32 previous = from;
+
+      for (bs::UINT32 i = 1; i < (bs::UINT32)abstractPath.size(); i++)
+      {
+        bs::UINT32 a    = abstractPath[i];
+        bs::UINT32 node = a == target ? to : mPortals[a];
+
+        // Start or target might be portals themselves
+        if (node == previous) continue;
+
+        if (mClusterOf[previous] != mClusterOf[node])
+        {
+          // Nodes in different clusters are only connected by direct paths
+          path.push_back(node);
+        }
+        else
+        {
+          if (!findWayInCluster(previous, node, segment, stats)) return false;
+
+          path.insert(path.end(), segment.begin() + 1, segment.end());
+        }
+
+        previous = node;
+      }
+
+      return true;
+    }
+
+    void WaynetHierarchy::findPortalCosts(bs::UINT32 node, bool isReverse,
+                                          bs::Vector<PortalCost>& costs,
+                                          WaynetSearchStats* stats) const
+    {
+      const WaynetGraph& g     = *mGraph;
+      const bs::UINT32 cluster = mClusterOf[node];
+
+      auto forEachEdge = [&](bs::UINT32 current, auto visit) {
+        if (isReverse)
+        {
+          for (bs::UINT32 edge = mReverseOffsets[current]; edge < mReverseOffsets[current + 1];
+               edge++)
+          {
+            bs::UINT32 next = mReverseNeighbours[edge];
+
+            if (mClusterOf[next] == cluster) visit(next, mReverseEdgeLengths[edge]);
+          }
+        }
+        else
+        {
+          for (bs::UINT32 edge = g.firstEdgeOf(current); edge < g.endEdgeOf(current); edge++)
+          {
+            bs::UINT32 next = g.neighbourOf(edge);
+
+            if (mClusterOf[next] == cluster) visit(next, g.edgeLength(edge));
+          }
+        }
+      };
+
+      auto noHeuristic = [](bs::UINT32) { return 0.0f; };
+
+      WaynetSearchContext& search = s_ClusterSearchContext;
+
+      searchWaynet(search, g.numNodes(), node, WaynetGraph::NO_NODE, forEachEdge, noHeuristic,
+                   stats);
+
+      costs.clear();
+
+      for (bs::UINT32 portal : mPortalsOfCluster[cluster])
+      {
+        bs::UINT32 portalNode = mPortals[portal];
+
+        if (search.isReached(portalNode))
+        {
+          costs.push_back({portal, search.nodes[portalNode].cost});
+        }
+      }
+    }
+
+    bool WaynetHierarchy::findWayInCluster(bs::UINT32 from, bs::UINT32 to,
+                                           bs::Vector<bs::UINT32>& path,
+                                           WaynetSearchStats* stats) const
+    {
+      const WaynetGraph& g     = *mGraph;
+      const bs::UINT32 cluster = mClusterOf[from];
+
+      auto forEachEdge = [&](bs::UINT32 current, auto visit) {
+        for (bs::UINT32 edge = g.firstEdgeOf(current); edge < g.endEdgeOf(current); edge++)
+        {
+          bs::UINT32 next = g.neighbourOf(edge);
+
+          if (mClusterOf[next] == cluster) visit(next, g.edgeLength(edge));
+        }
+      };
+
+      auto distanceToTarget = [&](bs::UINT32 node) { return g.distance(node, to); };
+
+      WaynetSearchContext& search = s_ClusterSearchContext;
+
+      if (!searchWaynet(search, g.numNodes(), from, to, forEachEdge, distanceToTarget, stats))
+      {
+        return false;
+      }
+
+      search.collectPath(to, path);
+
+      return true;
+    }
+  }  // namespace AI
+}  // namespace REGoth
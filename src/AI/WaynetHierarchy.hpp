@@ -0,0 +1,132 @@
+#pragma once
+#include <BsCorePrerequisites.h>
+
+namespace REGoth
+{
+  namespace AI
+  {
+    class WaynetGraph;
+    struct WaynetSearchStats;
+
+    /**
+     * Splits a WaynetGraph into clusters to speed up searching long ways (HPA*).
+     *
+     * A search across the whole world with plain A* looks at a big part of the waynet, since
+     * the straight line to the target usually isn't what the waynet looks like. To not have to
+     * do that, the waynet is split into square clusters on the ground. Waypoints with paths
+     * into other clusters are called *portals*. When building the hierarchy, the shortest ways
+     * inside each cluster between all of its portals are searched. Together with the paths
+     * between the clusters, this gives a much smaller *abstract* graph of only the portals.
+     *
+     * To find a long way, it is first searched on the abstract graph. Then the way is refined
+     * by searching the actual way between each pair of portals, which only has to look at the
+     * waypoints inside a single cluster.
+     *
+     * Since all ways inside the clusters are exact, the found ways are as short as the ones
+     * found by WaynetGraph::findWay(), but might go through different waypoints if there are
+     * multiple equally long ways.
+     *
+     * Like the graph, the hierarchy is never modified once built, so it can be searched from
+     * multiple threads.
+     */
+    class WaynetHierarchy
+    {
+    public:
+      /**
+       * Default edge length of the clusters, in meters.
+       */
+      static constexpr float DEFAULT_CLUSTER_SIZE = 100.0f;
+
+      /**
+       * Builds the hierarchy. This searches ways inside all clusters, so it might take a moment
+       * for large waynets.
+       *
+       * @param  graph        Graph to build the hierarchy for. Kept alive by the hierarchy.
+       * @param  clusterSize  Edge length of the clusters, in meters.
+       */
+      WaynetHierarchy(bs::SPtr<const WaynetGraph> graph,
+                      float clusterSize = DEFAULT_CLUSTER_SIZE);
+
+      /**
+       * @return Graph the hierarchy was built for.
+       */
+      const WaynetGraph& graph() const
+      {
+        return *mGraph;
+      }
+
+      /**
+       * Finds the shortest way between the given nodes, like WaynetGraph::findWay(). Ways
+       * shorter than a cluster are searched on the graph directly.
+       */
+      bool findWay(bs::UINT32 from, bs::UINT32 to, bs::Vector<bs::UINT32>& path,
+                   WaynetSearchStats* stats = nullptr) const;
+
+      bs::UINT32 numClusters() const
+      {
+        return mNumClusters;
+      }
+
+      bs::UINT32 numPortals() const
+      {
+        return (bs::UINT32)mPortals.size();
+      }
+
+    private:
+      /**
+       * Portal and the cost of the way to or from it.
+       */
+      struct PortalCost
+      {
+        bs::UINT32 portal;
+        float cost;
+      };
+
+      /**
+       * Searches the abstract graph and refines the way. Only for nodes in different clusters.
+       */
+      bool findWayAcrossClusters(bs::UINT32 from, bs::UINT32 to, bs::Vector<bs::UINT32>& path,
+                                 WaynetSearchStats* stats) const;
+
+      /**
+       * Finds the costs of the shortest ways inside the cluster of `node`, either from `node`
+       * to all portals of the cluster or, if `isReverse` is set, from all of them to `node`.
+       */
+      void findPortalCosts(bs::UINT32 node, bool isReverse, bs::Vector<PortalCost>& costs,
+                           WaynetSearchStats* stats) const;
+
+      /**
+       * Finds the shortest way from `from` to `to` which doesn't leave their cluster.
+       */
+      bool findWayInCluster(bs::UINT32 from, bs::UINT32 to, bs::Vector<bs::UINT32>& path,
+                            WaynetSearchStats* stats) const;
+
+      bs::SPtr<const WaynetGraph> mGraph;
+
+      float mClusterSize;
+      bs::UINT32 mNumClusters = 0;
+
+      /** Cluster of every node */
+      bs::Vector<bs::UINT32> mClusterOf;
+
+      /** Index into mPortals of every node, NO_NODE if the node is no portal */
+      bs::Vector<bs::UINT32> mPortalOf;
+
+      /** Node of every portal */
+      bs::Vector<bs::UINT32> mPortals;
+
+      /** Portals inside every cluster */
+      bs::Vector<bs::Vector<bs::UINT32>> mPortalsOfCluster;
+
+      /** Abstract graph over the portals, in the same format as the edges of WaynetGraph */
+      bs::Vector<bs::UINT32> mPortalOffsets;
+      bs::Vector<bs::UINT32> mPortalNeighbours;
+      bs::Vector<float> mPortalEdgeCosts;
+
+      /** Reversed edges of the graph, needed to search from the target back to the portals */
+      bs::Vector<bs::UINT32> mReverseOffsets;
+      bs::Vector<bs::UINT32> mReverseNeighbours;
+      bs::Vector<float> mReverseEdgeLengths;
+    };
+  }  // namespace AI
+}  // namespace REGoth
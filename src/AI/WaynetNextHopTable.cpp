@@ -0,0 +1,167 @@
+#include "WaynetNextHopTable.hpp"
+#include "WaynetGraph.hpp"
+#include "WaynetSearch.hpp"
+#include <FileSystem/BsDataStream.h>
+#include <FileSystem/BsFileSystem.h>
+#include <cstring>
+
+namespace REGoth
+{
+  namespace AI
+  {
+    constexpr bs::UINT64 WaynetNextHopTable::DEFAULT_MEMORY_BUDGET;
+    constexpr bs::UINT16 WaynetNextHopTable::NO_HOP;
+    constexpr bs::UINT32 WaynetNextHopTable::FILE_VERSION;
+
+    /**
+     * Start of a saved table, to recognize it and to know what it was built for.
+     */
+    struct NextHopTableFileHeader
+    {
+      char magic[4]        = {'R', 'G', 'N', 'H'};
+      bs::UINT32 version   = 0;
+      bs::UINT32 numNodes  = 0;
+      bs::UINT32 padding   = 0;
+      bs::UINT64 graphHash = 0;
+    };
+
+    WaynetNextHopTable::WaynetNextHopTable(const WaynetGraph& graph)
+        : mNumNodes(graph.numNodes())
+        , mGraphHash(graph.hash())
+    {
+      mNextHops.assign((size_t)mNumNodes * mNumNodes, NO_HOP);
+
+      WaynetSearchContext search;
+
+      auto forEachEdge = [&](bs::UINT32 node, auto visit) {
+        for (bs::UINT32 edge = graph.firstEdgeOf(node); edge < graph.endEdgeOf(node); edge++)
+        {
+          visit(graph.neighbourOf(edge), graph.edgeLength(edge));
+        }
+      };
+
+      auto noHeuristic = [](bs::UINT32) { return 0.0f; };
+
+      bs::Vector<bs::UINT32> firstHop(mNumNodes);
+      bs::Vector<bs::UINT32> unresolved;
+
+      for (bs::UINT32 from = 0; from < mNumNodes; from++)
+      {
+        // Shortest ways to everything reachable from here
+        searchWaynet(search, mNumNodes, from, WaynetGraph::NO_NODE, forEachEdge, noHeuristic,
+                     nullptr);
+
+        std::fill(firstHop.begin(), firstHop.end(), WaynetGraph::NO_NODE);
+
+        bs::UINT16* row = &mNextHops[(size_t)from * mNumNodes];
+        row[from]       = (bs::UINT16)from;
+
+        for (bs::UINT32 to = 0; to < mNumNodes; to++)
+        {
+          if (to == from || !search.isReached(to)) continue;
+
+          // Go back along the way until a node is found whose first hop is known, or which
+          // is the first hop itself. Everything on the way there shares the same first hop.
+          bs::UINT32 node = to;
+          unresolved.clear();
+
+          while (firstHop[node] == WaynetGraph::NO_NODE && search.nodes[node].previous != from)
+          {
+            unresolved.push_back(node);
+            node = search.nodes[node].previous;
+          }
+
+          if (firstHop[node] == WaynetGraph::NO_NODE)
+          {
+            firstHop[node] = node;
+          }
+
+          for (bs::UINT32 n : unresolved)
+          {
+            firstHop[n] = firstHop[node];
+          }
+
+          row[to] = (bs::UINT16)firstHop[node];
+        }
+      }
+    }
+
+    bool WaynetNextHopTable::isSuitableFor(bs::UINT32 numNodes, bs::UINT64 memoryBudget)
+    {
+      if (numNodes == 0 || numNodes >= NO_HOP) return false;
+
+      return (bs::UINT64)numNodes * numNodes * sizeof(bs::UINT16) <= memoryBudget;
+    }
+
+    bs::SPtr<WaynetNextHopTable> WaynetNextHopTable::load(const bs::Path& path,
+                                                          bs::UINT64 graphHash)
+    {
+      if (!bs::FileSystem::exists(path)) return nullptr;
+
+      bs::SPtr<bs::DataStream> stream = bs::FileSystem::openFile(path, true);
+
+      if (!stream) return nullptr;
+
+      NextHopTableFileHeader header;
+      NextHopTableFileHeader expected;
+
+      if (stream->read(&header, sizeof(header)) != sizeof(header)) return nullptr;
+
+      if (std::memcmp(header.magic, expected.magic, sizeof(header.magic)) != 0) return nullptr;
+      if (header.version != FILE_VERSION) return nullptr;
+      if (header.graphHash != graphHash) return nullptr;
+      if (header.numNodes >= NO_HOP) return nullptr;
+
+      auto table        = bs::bs_shared_ptr_new<WaynetNextHopTable>();
+      table->mNumNodes  = header.numNodes;
+      table->mGraphHash = header.graphHash;
+      table->mNextHops.resize((size_t)header.numNodes * header.numNodes);
+
+      size_t numBytes = table->mNextHops.size() * sizeof(bs::UINT16);
+
+      if (stream->read(table->mNextHops.data(), numBytes) != numBytes) return nullptr;
+
+      return table;
+    }
+
+    void WaynetNextHopTable::save(const bs::Path& path) const
+    {
+      bs::SPtr<bs::DataStream> stream = bs::FileSystem::createAndOpenFile(path);
+
+      if (!stream) return;
+
+      NextHopTableFileHeader header;
+      header.version   = FILE_VERSION;
+      header.numNodes  = mNumNodes;
+      header.graphHash = mGraphHash;
+
+      stream->write(&header, sizeof(header));
+      stream->write(mNextHops.data(), mNextHops.size() * sizeof(bs::UINT16));
+      stream->close();
+    }
+
+    bool WaynetNextHopTable::findWay(bs::UINT32 from, bs::UINT32 to,
+                                     bs::Vector<bs::UINT32>& path) const
+    {
+      if (from >= mNumNodes || to >= mNumNodes) return false;
+
+      if (from != to && nextHop(from, to) == NO_HOP) return false;
+
+      path.clear();
+      path.push_back(from);
+
+      // Each hop is taken from a different search, so with ties between equally long ways
+      // (e.g. waypoints on top of each other) they could in theory lead in circles
+      for (bs::UINT32 node = from; node != to;)
+      {
+        node = nextHop(node, to);
+
+        if (node == NO_HOP || path.size() > mNumNodes) return false;
+
+        path.push_back(node);
+      }
+
+      return true;
+    }
+  }  // namespace AI
+}  // namespace REGoth
@@ -0,0 +1,93 @@
+#pragma once
+#include <BsCorePrerequisites.h>
+
+namespace REGoth
+{
+  namespace AI
+  {
+    class WaynetGraph;
+
+    /**
+     * Shortest ways between all pairs of waypoints of a small waynet.
+     *
+     * For every pair of waypoints, the table stores which waypoint to go to next on the
+     * shortest way from one to the other. Finding a way is then only a matter of following
+     * the table, without searching anything.
+     *
+     * The table needs two bytes per pair of waypoints, so this only makes sense for small
+     * waynets like the ones of Gothic 1, see isSuitableFor(). Building it takes a search from
+     * every waypoint, so it is saved to disk and loaded from there on the next start, see
+     * load() and save().
+     *
+     * Like the graph, the table is never modified once built, so it can be used from
+     * multiple threads.
+     */
+    class WaynetNextHopTable
+    {
+    public:
+      /**
+       * Default for the memory a table may take, in bytes.
+       */
+      static constexpr bs::UINT64 DEFAULT_MEMORY_BUDGET = 8 * 1024 * 1024;
+
+      /**
+       * Empty table without any nodes, see load().
+       */
+      WaynetNextHopTable() = default;
+
+      /**
+       * Builds the table by searching the shortest ways from every waypoint.
+       */
+      WaynetNextHopTable(const WaynetGraph& graph);
+
+      /**
+       * @return Whether a table for a graph with the given number of nodes could be built and
+       *         would take no more than the given number of bytes.
+       */
+      static bool isSuitableFor(bs::UINT32 numNodes, bs::UINT64 memoryBudget);
+
+      /**
+       * Loads a table saved by save().
+       *
+       * @param  graphHash  Hash of the graph the table is needed for, see WaynetGraph::hash().
+       *
+       * @return The loaded table. Empty if the file doesn't exist, is damaged or was saved for
+       *         a different graph.
+       */
+      static bs::SPtr<WaynetNextHopTable> load(const bs::Path& path, bs::UINT64 graphHash);
+
+      /**
+       * Saves the table, so it can be loaded by load().
+       */
+      void save(const bs::Path& path) const;
+
+      /**
+       * Finds the shortest way between the given nodes, like WaynetGraph::findWay().
+       */
+      bool findWay(bs::UINT32 from, bs::UINT32 to, bs::Vector<bs::UINT32>& path) const;
+
+      bs::UINT32 numNodes() const
+      {
+        return mNumNodes;
+      }
+
+    private:
+      /** Marks pairs of nodes without a way between them */
+      static constexpr bs::UINT16 NO_HOP = 0xFFFF;
+
+      /** Increase whenever the file format changes */
+      static constexpr bs::UINT32 FILE_VERSION = 1;
+
+      bs::UINT16 nextHop(bs::UINT32 from, bs::UINT32 to) const
+      {
+        return mNextHops[(size_t)from * mNumNodes + to];
+      }
+
+      bs::UINT32 mNumNodes  = 0;
+      bs::UINT64 mGraphHash = 0;
+
+      /** Next node to go to, row by row: All targets of node 0 first, then of node 1 and so on */
+      bs::Vector<bs::UINT16> mNextHops;
+    };
+  }  // namespace AI
+}  // namespace REGoth
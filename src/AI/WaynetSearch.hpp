@@ -0,0 +1,184 @@
+#pragma once
+#include <BsCorePrerequisites.h>
+#include <algorithm>
+#include <limits>
+
+namespace REGoth
+{
+  namespace AI
+  {
+    /**
+     * How much work searches on the waynet did, e.g. to compare different ways of searching.
+     */
+    struct WaynetSearchStats
+    {
+      bs::UINT64 numSearches = 0;
+
+      /** Nodes taken from the open list and looked at */
+      bs::UINT64 numExpanded = 0;
+    };
+
+    /**
+     * Everything a search over some waynet graph needs. Kept around between searches, so
+     * nothing has to be allocated once it has grown to the size of the graph.
+     *
+     * Instead of resetting all nodes for every search, each node is stamped with the search
+     * it was last written by. Nodes with an older stamp have not been reached yet.
+     */
+    struct WaynetSearchContext
+    {
+      static constexpr bs::UINT32 NO_NODE = std::numeric_limits<bs::UINT32>::max();
+
+      struct Node
+      {
+        float cost          = 0.0f;
+        bs::UINT32 previous = NO_NODE;
+        bs::UINT32 stamp    = 0;
+        bool isClosed       = false;
+      };
+
+      /**
+       * Entry of the open list. A node may be in there multiple times if a shorter way to it
+       * was found later, the outdated entries are skipped once the node is closed.
+       */
+      struct OpenEntry
+      {
+        float estimate;
+        bs::UINT32 node;
+
+        bool operator<(const OpenEntry& other) const
+        {
+          // Makes the std heap functions put the smallest estimate on top
+          return estimate > other.estimate;
+        }
+      };
+
+      void startSearch(size_t numNodes)
+      {
+        if (nodes.size() < numNodes)
+        {
+          nodes.resize(numNodes);
+        }
+
+        open.clear();
+
+        stamp += 1;
+
+        // After wrapping around, old stamps could look like they're from this search
+        if (stamp == 0)
+        {
+          for (Node& n : nodes)
+          {
+            n.stamp = 0;
+          }
+
+          stamp = 1;
+        }
+      }
+
+      bool isReached(bs::UINT32 node) const
+      {
+        return nodes[node].stamp == stamp;
+      }
+
+      void reach(bs::UINT32 node, float cost, bs::UINT32 previous, float estimate)
+      {
+        Node& n    = nodes[node];
+        n.cost     = cost;
+        n.previous = previous;
+        n.stamp    = stamp;
+        n.isClosed = false;
+
+        open.push_back({estimate, node});
+        std::push_heap(open.begin(), open.end());
+      }
+
+      bs::UINT32 popClosest()
+      {
+        std::pop_heap(open.begin(), open.end());
+        bs::UINT32 node = open.back().node;
+        open.pop_back();
+
+        return node;
+      }
+
+      /**
+       * Collects the way to the given node, which must have been reached.
+       *
+       * @param  path  Filled with all nodes from the start of the search to `to`.
+       */
+      void collectPath(bs::UINT32 to, bs::Vector<bs::UINT32>& path) const
+      {
+        path.clear();
+
+        for (bs::UINT32 n = to; n != NO_NODE; n = nodes[n].previous)
+        {
+          path.push_back(n);
+        }
+
+        std::reverse(path.begin(), path.end());
+      }
+
+      bs::Vector<Node> nodes;
+      bs::Vector<OpenEntry> open;
+      bs::UINT32 stamp = 0;
+    };
+
+    /**
+     * A* over any graph, see WaynetGraph::findWay().
+     *
+     * To not search for a target but to find the costs to everything reachable (Dijkstra), pass
+     * NO_NODE as `to` and a heuristic that always returns 0. The costs can be read from the
+     * context afterwards.
+     *
+     * @param  forEachEdge  Called as `forEachEdge(node, visit)` and has to call
+     *                      `visit(next, length)` for every edge going out of `node`.
+     * @param  heuristic    Called as `heuristic(node)`, must not overestimate the cost of the
+     *                      way from `node` to `to`.
+     *
+     * @return Whether `to` has been reached.
+     */
+    template <typename ForEachEdge, typename Heuristic>
+    bool searchWaynet(WaynetSearchContext& search, bs::UINT32 numNodes, bs::UINT32 from,
+                      bs::UINT32 to, ForEachEdge forEachEdge, Heuristic heuristic,
+                      WaynetSearchStats* stats)
+    {
+      search.startSearch(numNodes);
+      search.reach(from, 0.0f, WaynetSearchContext::NO_NODE, heuristic(from));
+
+      if (stats) stats->numSearches += 1;
+
+      while (!search.open.empty())
+      {
+        bs::UINT32 current = search.popClosest();
+
+        WaynetSearchContext::Node& node = search.nodes[current];
+
+        if (node.isClosed) continue;
+
+        node.isClosed = true;
+
+        if (stats) stats->numExpanded += 1;
+
+        if (current == to) return true;
+
+        const float currentCost = node.cost;
+
+        forEachEdge(current, [&](bs::UINT32 next, float length) {
+          float cost = currentCost + length;
+
+          if (search.isReached(next))
+          {
+            const WaynetSearchContext::Node& nextNode = search.nodes[next];
+
+            if (nextNode.isClosed || nextNode.cost <= cost) return;
+          }
+
+          search.reach(next, cost, current, cost + heuristic(next));
+        });
+      }
+
+      return false;
+    }
+  }  // namespace AI
+}  // namespace REGoth
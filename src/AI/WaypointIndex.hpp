@@ -0,0 +1,15 @@
+#pragma once
+#include <BsPrerequisites.h>
+#include <limits>
+
+namespace REGoth
+{
+  /**
+   * Identifies a waypoint by its index inside the Waynet of its world. Waypoints are plain
+   * data kept by the Waynet, see Waynet::waypointPosition() and the like.
+   */
+  using WaypointIndex = bs::UINT32;
+
+  /** Stands for no waypoint at all, e.g. if none was found */
+  constexpr WaypointIndex NO_WAYPOINT = std::numeric_limits<bs::UINT32>::max();
+}  // namespace REGoth
@@ -15,9 +15,12 @@
 #pragma once
 #include "RTTI_TypeIDs.hpp"
 #include <BsCorePrerequisites.h>
+#include <FileSystem/BsDataStream.h>
 #include <Reflection/BsRTTIType.h>
 #include <Scene/BsSceneObject.h>
+#include <cstring>
 #include <exception/Throw.hpp>
+#include <type_traits>
 
 /**
  * For use in the actual components header. Declares the functions for accessing
@@ -160,3 +163,212 @@ private:                                                         \
   {                                                                                        \
     return TID_REGOTH_##classname;                                                         \
   }
+
+namespace REGoth
+{
+  /**
+   * Packs many small values into one contiguous buffer, to be saved as a single data block
+   * field instead of going through reflection value by value. Meant for types with lots of
+   * plain data, like the script symbols, see RTTI_ScriptSymbolStorage.
+   *
+   * Values are written as-is, arrays are prefixed with their length. Strings are collected
+   * into a table which is put in front of the values, so every string is only stored once and
+   * referred to by its index. Read back via RTTIBlobReader, in the same order.
+   *
+   * Example, for a data block field of an RTTI class:
+   *
+   *    bs::SPtr<bs::DataStream> getBlob(OwnerType* obj, bs::UINT32& size)
+   *    {
+   *      RTTIBlobWriter writer;
+   *      writer.writeString(obj->name);
+   *      writer.writeArray(obj->values);
+   *
+   *      return writer.finish(size);
+   *    }
+   */
+  class RTTIBlobWriter
+  {
+  public:
+    template <typename T>
+    void write(const T& value)
+    {
+      static_assert(std::is_trivially_copyable<T>::value, "Only plain values can be copied");
+
+      append(&value, sizeof(T));
+    }
+
+    template <typename T>
+    void writeArray(const bs::Vector<T>& values)
+    {
+      static_assert(std::is_trivially_copyable<T>::value, "Only plain values can be copied");
+
+      write((bs::UINT32)values.size());
+      append(values.data(), values.size() * sizeof(T));
+    }
+
+    void writeString(const bs::String& value)
+    {
+      auto it = mStringIndices.find(value);
+
+      if (it == mStringIndices.end())
+      {
+        it = mStringIndices.emplace(value, (bs::UINT32)mStrings.size()).first;
+        mStrings.push_back(value);
+      }
+
+      write(it->second);
+    }
+
+    void writeStrings(const bs::Vector<bs::String>& values)
+    {
+      write((bs::UINT32)values.size());
+
+      for (const bs::String& value : values)
+      {
+        writeString(value);
+      }
+    }
+
+    /**
+     * @param  size  Size of the returned stream in bytes.
+     *
+     * @return Everything written so far, with the string table in front.
+     */
+    bs::SPtr<bs::DataStream> finish(bs::UINT32& size) const
+    {
+      size_t numBytes = sizeof(bs::UINT32) + mValues.size();
+
+      for (const bs::String& s : mStrings)
+      {
+        numBytes += sizeof(bs::UINT32) + s.size();
+      }
+
+      auto stream    = bs::bs_shared_ptr_new<bs::MemoryDataStream>(numBytes);
+      bs::UINT8* out = stream->data();
+
+      auto put = [&](const void* data, size_t n) {
+        std::memcpy(out, data, n);
+        out += n;
+      };
+
+      bs::UINT32 numStrings = (bs::UINT32)mStrings.size();
+      put(&numStrings, sizeof(numStrings));
+
+      for (const bs::String& s : mStrings)
+      {
+        bs::UINT32 length = (bs::UINT32)s.size();
+        put(&length, sizeof(length));
+        put(s.data(), s.size());
+      }
+
+      put(mValues.data(), mValues.size());
+
+      size = (bs::UINT32)numBytes;
+      return stream;
+    }
+
+  private:
+    void append(const void* data, size_t numBytes)
+    {
+      const bs::UINT8* bytes = (const bs::UINT8*)data;
+      mValues.insert(mValues.end(), bytes, bytes + numBytes);
+    }
+
+    bs::Vector<bs::UINT8> mValues;
+    bs::Vector<bs::String> mStrings;
+    bs::UnorderedMap<bs::String, bs::UINT32> mStringIndices;
+  };
+
+  /**
+   * Reads back what an RTTIBlobWriter has written. Throws if the data ends too early or
+   * refers to strings which are not there, e.g. because the save is broken.
+   */
+  class RTTIBlobReader
+  {
+  public:
+    RTTIBlobReader(const bs::SPtr<bs::DataStream>& stream, bs::UINT32 size)
+    {
+      mBytes.resize(size);
+
+      if (stream->read(mBytes.data(), size) != size)
+      {
+        REGOTH_THROW(InvalidStateException, "Blob is shorter than it should be.");
+      }
+
+      bs::UINT32 numStrings = read<bs::UINT32>();
+      mStrings.reserve(numStrings);
+
+      for (bs::UINT32 i = 0; i < numStrings; i++)
+      {
+        bs::UINT32 length = read<bs::UINT32>();
+        mStrings.emplace_back((const char*)take(length), length);
+      }
+    }
+
+    template <typename T>
+    T read()
+    {
+      static_assert(std::is_trivially_copyable<T>::value, "Only plain values can be copied");
+
+      T value;
+      std::memcpy(&value, take(sizeof(T)), sizeof(T));
+
+      return value;
+    }
+
+    template <typename T>
+    void readArray(bs::Vector<T>& values)
+    {
+      static_assert(std::is_trivially_copyable<T>::value, "Only plain values can be copied");
+
+      bs::UINT32 count = read<bs::UINT32>();
+      values.resize(count);
+
+      if (count > 0)
+      {
+        std::memcpy(values.data(), take(count * sizeof(T)), count * sizeof(T));
+      }
+    }
+
+    const bs::String& readString()
+    {
+      bs::UINT32 index = read<bs::UINT32>();
+
+      if (index >= mStrings.size())
+      {
+        REGOTH_THROW(InvalidStateException, "Blob refers to a string which doesn't exist.");
+      }
+
+      return mStrings[index];
+    }
+
+    void readStrings(bs::Vector<bs::String>& values)
+    {
+      bs::UINT32 count = read<bs::UINT32>();
+      values.resize(count);
+
+      for (bs::String& value : values)
+      {
+        value = readString();
+      }
+    }
+
+  private:
+    const bs::UINT8* take(size_t numBytes)
+    {
+      if (numBytes > mBytes.size() - mPosition)
+      {
+        REGOTH_THROW(InvalidStateException, "Blob ended while reading from it.");
+      }
+
+      const bs::UINT8* data = mBytes.data() + mPosition;
+      mPosition += numBytes;
+
+      return data;
+    }
+
+    bs::Vector<bs::UINT8> mBytes;
+    bs::Vector<bs::String> mStrings;
+    size_t mPosition = 0;
+  };
+}  // namespace REGoth
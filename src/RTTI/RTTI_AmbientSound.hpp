@@ -0,0 +1,25 @@
+#pragma once
+#include "RTTIUtil.hpp"
+#include <components/AmbientSound.hpp>
+
+namespace REGoth
+{
+  class RTTI_AmbientSound : public bs::RTTIType<AmbientSound, bs::Component, RTTI_AmbientSound>
+  {
+    BS_BEGIN_RTTI_MEMBERS
+    BS_RTTI_MEMBER_PLAIN(mSoundFile, 0)
+    BS_RTTI_MEMBER_PLAIN(mRadius, 1)
+    BS_RTTI_MEMBER_PLAIN(mVolume, 2)
+    BS_RTTI_MEMBER_PLAIN(mMode, 3)
+    BS_RTTI_MEMBER_PLAIN(mRandomDelay, 4)
+    BS_RTTI_MEMBER_PLAIN(mRandomDelayVariance, 5)
+    BS_END_RTTI_MEMBERS
+
+  public:
+    RTTI_AmbientSound()
+    {
+    }
+
+    REGOTH_IMPLEMENT_RTTI_CLASS_FOR_COMPONENT(AmbientSound)
+  };
+}  // namespace REGoth
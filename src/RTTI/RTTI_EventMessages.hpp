@@ -56,7 +56,7 @@ namespace REGoth
         : public bs::RTTIType<MovementMessage, NpcMessage, RTTI_MovementMessage>
     {
       BS_BEGIN_RTTI_MEMBERS
-      BS_RTTI_MEMBER_REFL_ARRAY(route, 0)
+      BS_RTTI_MEMBER_PLAIN(route, 5)
       BS_RTTI_MEMBER_REFL(targetObject, 1)
       BS_RTTI_MEMBER_PLAIN(targetPosition, 2)
       BS_RTTI_MEMBER_PLAIN(walkMode, 3)
@@ -18,14 +18,232 @@ namespace REGoth
     BS_RTTI_MEMBER_REFL(mGameClock, 4)
     BS_RTTI_MEMBER_REFL_ARRAY(mAllCharacters, 5)
     BS_RTTI_MEMBER_REFL_ARRAY(mAllItems, 6)
+    BS_RTTI_MEMBER_PLAIN(mIsStreamed, 9)
+    BS_RTTI_MEMBER_PLAIN(mIsSavedWithoutStaticParts, 10)
     BS_END_RTTI_MEMBERS
 
+    bs::HSceneObject& getNamedObject(OwnerType* obj, UINT32 idx)
+    {
+      return mNamedObjects[idx];
+    }
+
+    void setNamedObject(OwnerType* obj, UINT32 idx, bs::HSceneObject& val)
+    {
+      mNamedObjects[idx] = val;
+    }
+
+    UINT32 getSizeNamedObjects(OwnerType* obj)
+    {
+      return (UINT32)mNamedObjects.size();
+    }
+
+    void setSizeNamedObjects(OwnerType* obj, UINT32 val)
+    {
+      mNamedObjects.resize(val);
+    }
+
+    bs::String& getObjectName(OwnerType* obj, UINT32 idx)
+    {
+      return mObjectNames[idx];
+    }
+
+    void setObjectName(OwnerType* obj, UINT32 idx, bs::String& val)
+    {
+      mObjectNames[idx] = val;
+    }
+
+    UINT32 getSizeObjectNames(OwnerType* obj)
+    {
+      return (UINT32)mObjectNames.size();
+    }
+
+    void setSizeObjectNames(OwnerType* obj, UINT32 val)
+    {
+      mObjectNames.resize(val);
+    }
+
+    // The generator is restored as a whole once both halves of its state are known
+    bs::UINT64& getRandomState(OwnerType* obj)
+    {
+      mRandomState = obj->mRandom.state();
+      return mRandomState;
+    }
+
+    void setRandomState(OwnerType* obj, bs::UINT64& val)
+    {
+      mRandomState = val;
+    }
+
+    bs::UINT64& getRandomIncrement(OwnerType* obj)
+    {
+      mRandomIncrement = obj->mRandom.increment();
+      return mRandomIncrement;
+    }
+
+    void setRandomIncrement(OwnerType* obj, bs::UINT64& val)
+    {
+      mRandomIncrement = val;
+    }
+
+    // Dormant items are saved as one array per member, see onSerializationStarted()
+    bs::String& getDormantItemInstance(OwnerType* obj, UINT32 idx)
+    {
+      return mDormantItemInstances[idx];
+    }
+
+    void setDormantItemInstance(OwnerType* obj, UINT32 idx, bs::String& val)
+    {
+      mDormantItemInstances[idx] = val;
+    }
+
+    UINT32 getSizeDormantItemInstances(OwnerType* obj)
+    {
+      return (UINT32)mDormantItemInstances.size();
+    }
+
+    void setSizeDormantItemInstances(OwnerType* obj, UINT32 val)
+    {
+      mDormantItemInstances.resize(val);
+    }
+
+    bs::Vector3& getDormantItemPosition(OwnerType* obj, UINT32 idx)
+    {
+      return mDormantItemPositions[idx];
+    }
+
+    void setDormantItemPosition(OwnerType* obj, UINT32 idx, bs::Vector3& val)
+    {
+      mDormantItemPositions[idx] = val;
+    }
+
+    UINT32 getSizeDormantItemPositions(OwnerType* obj)
+    {
+      return (UINT32)mDormantItemPositions.size();
+    }
+
+    void setSizeDormantItemPositions(OwnerType* obj, UINT32 val)
+    {
+      mDormantItemPositions.resize(val);
+    }
+
+    bs::Quaternion& getDormantItemRotation(OwnerType* obj, UINT32 idx)
+    {
+      return mDormantItemRotations[idx];
+    }
+
+    void setDormantItemRotation(OwnerType* obj, UINT32 idx, bs::Quaternion& val)
+    {
+      mDormantItemRotations[idx] = val;
+    }
+
+    UINT32 getSizeDormantItemRotations(OwnerType* obj)
+    {
+      return (UINT32)mDormantItemRotations.size();
+    }
+
+    void setSizeDormantItemRotations(OwnerType* obj, UINT32 val)
+    {
+      mDormantItemRotations.resize(val);
+    }
+
     public:
     RTTI_GameWorld()
     {
+      addReflectableArrayField("namedObjects", 7,                         //
+                               &RTTI_GameWorld::getNamedObject,           //
+                               &RTTI_GameWorld::getSizeNamedObjects,      //
+                               &RTTI_GameWorld::setNamedObject,           //
+                               &RTTI_GameWorld::setSizeNamedObjects);     //
+
+      addPlainArrayField("objectNames", 8,                                //
+                         &RTTI_GameWorld::getObjectName,                  //
+                         &RTTI_GameWorld::getSizeObjectNames,             //
+                         &RTTI_GameWorld::setObjectName,                  //
+                         &RTTI_GameWorld::setSizeObjectNames);            //
+
+      addPlainField("randomState", 11,                                    //
+                    &RTTI_GameWorld::getRandomState,                      //
+                    &RTTI_GameWorld::setRandomState);                     //
+
+      addPlainField("randomIncrement", 12,                                //
+                    &RTTI_GameWorld::getRandomIncrement,                  //
+                    &RTTI_GameWorld::setRandomIncrement);                 //
+
+      addPlainArrayField("dormantItemInstances", 13,                      //
+                         &RTTI_GameWorld::getDormantItemInstance,         //
+                         &RTTI_GameWorld::getSizeDormantItemInstances,    //
+                         &RTTI_GameWorld::setDormantItemInstance,         //
+                         &RTTI_GameWorld::setSizeDormantItemInstances);   //
+
+      addPlainArrayField("dormantItemPositions", 14,                      //
+                         &RTTI_GameWorld::getDormantItemPosition,         //
+                         &RTTI_GameWorld::getSizeDormantItemPositions,    //
+                         &RTTI_GameWorld::setDormantItemPosition,         //
+                         &RTTI_GameWorld::setSizeDormantItemPositions);   //
+
+      addPlainArrayField("dormantItemRotations", 15,                      //
+                         &RTTI_GameWorld::getDormantItemRotation,         //
+                         &RTTI_GameWorld::getSizeDormantItemRotations,    //
+                         &RTTI_GameWorld::setDormantItemRotation,         //
+                         &RTTI_GameWorld::setSizeDormantItemRotations);   //
+    }
+
+    void onSerializationStarted(bs::IReflectable* _obj, bs::SerializationContext* context) override
+    {
+      auto obj = static_cast<GameWorld*>(_obj);
+
+      for (const auto& v : obj->mSceneObjectsByName)
+      {
+        if (v.second.isDestroyed()) continue;
+
+        mObjectNames.push_back(v.first);
+        mNamedObjects.push_back(v.second);
+      }
+
+      for (const GroundItems::DormantItem& item : obj->mGroundItems.dormantItems())
+      {
+        mDormantItemInstances.push_back(item.instance);
+        mDormantItemPositions.push_back(item.position);
+        mDormantItemRotations.push_back(item.rotation);
+      }
+    }
+
+    void onDeserializationEnded(bs::IReflectable* _obj, bs::SerializationContext* context) override
+    {
+      auto obj = static_cast<GameWorld*>(_obj);
+
+      // The handles are only resolved later, so the names can't be taken from the objects
+      for (bs::UINT32 i = 0; i < (bs::UINT32)mObjectNames.size(); i++)
+      {
+        obj->mSceneObjectsByName[mObjectNames[i]] = mNamedObjects[i];
+      }
+
+      // Saves from before ground items have none of these
+      for (bs::UINT32 i = 0; i < (bs::UINT32)mDormantItemInstances.size(); i++)
+      {
+        if (i >= mDormantItemPositions.size() || i >= mDormantItemRotations.size()) break;
+
+        obj->mGroundItems.addDormantItem(mDormantItemInstances[i], mDormantItemPositions[i],
+                                         mDormantItemRotations[i]);
+      }
+
+      // Saves from before the generator was saved keep the one seeded on construction
+      if (mRandomIncrement != 0)
+      {
+        obj->mRandom.setState(mRandomState, mRandomIncrement);
+      }
     }
 
     REGOTH_IMPLEMENT_RTTI_CLASS_FOR_COMPONENT(GameWorld)
+
+    bs::Vector<bs::HSceneObject> mNamedObjects;
+    bs::Vector<bs::String> mObjectNames;
+    bs::UINT64 mRandomState     = 0;
+    bs::UINT64 mRandomIncrement = 0;
+
+    bs::Vector<bs::String> mDormantItemInstances;
+    bs::Vector<bs::Vector3> mDormantItemPositions;
+    bs::Vector<bs::Quaternion> mDormantItemRotations;
   };
 
 }  // namespace REGoth
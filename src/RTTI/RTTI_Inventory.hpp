@@ -7,15 +7,55 @@ namespace REGoth
   class RTTI_Inventory
       : public bs::RTTIType<Inventory, bs::Component, RTTI_Inventory>
   {
+    using ItemsMap = bs::Map<bs::String, bs::UINT32>;
+
     BS_BEGIN_RTTI_MEMBERS
-    BS_RTTI_MEMBER_PLAIN(mItemCountByInstance, 0)
+    // BS_RTTI_MEMBER_PLAIN(mItemCountByInstance, 0) // Added manually, see constructor
+    BS_RTTI_MEMBER_REFL(mGameWorld, 1)
     BS_END_RTTI_MEMBERS
 
+    // Items are saved by name, since symbol indices change with the script files. See
+    // Inventory::mapLoadedItems().
+    ItemsMap& getItems(OwnerType* obj)
+    {
+      return mItems;
+    }
+
+    void setItems(OwnerType* obj, ItemsMap& val)
+    {
+      mItems = val;
+    }
+
   public:
     RTTI_Inventory()
     {
+      addPlainField("mItemCountByInstance", 0,         //
+                    &RTTI_Inventory::getItems,         //
+                    &RTTI_Inventory::setItems);        //
+    }
+
+    void onSerializationStarted(bs::IReflectable* _obj, bs::SerializationContext* context) override
+    {
+      auto obj = static_cast<Inventory*>(_obj);
+
+      mItems.clear();
+
+      for (const auto& stack : obj->allItems())
+      {
+        mItems[obj->itemName(stack.instance)] = stack.count;
+      }
+    }
+
+    void onDeserializationEnded(bs::IReflectable* _obj, bs::SerializationContext* context) override
+    {
+      auto obj = static_cast<Inventory*>(_obj);
+
+      obj->mItems.clear();
+      obj->mLoadedItems = mItems;
     }
 
     REGOTH_IMPLEMENT_RTTI_CLASS_FOR_COMPONENT(Inventory)
+
+    ItemsMap mItems;
   };
 }  // namespace REGoth
@@ -0,0 +1,22 @@
+#pragma once
+#include "RTTIUtil.hpp"
+#include <components/LevelChangeTrigger.hpp>
+
+namespace REGoth
+{
+  class RTTI_LevelChangeTrigger
+      : public bs::RTTIType<LevelChangeTrigger, bs::Component, RTTI_LevelChangeTrigger>
+  {
+    BS_BEGIN_RTTI_MEMBERS
+    BS_RTTI_MEMBER_PLAIN(mZenFile, 0)
+    BS_RTTI_MEMBER_PLAIN(mStartVobName, 1)
+    BS_END_RTTI_MEMBERS
+
+  public:
+    RTTI_LevelChangeTrigger()
+    {
+    }
+
+    REGOTH_IMPLEMENT_RTTI_CLASS_FOR_COMPONENT(LevelChangeTrigger)
+  };
+}  // namespace REGoth
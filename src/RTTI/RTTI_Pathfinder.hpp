@@ -22,6 +22,7 @@ namespace REGoth
       BS_RTTI_MEMBER_PLAIN_NAMED(targetEntityPositionOnStart,
                                 mActiveRoute.targetEntityPositionOnStart, 7)
       BS_RTTI_MEMBER_REFL(mWaynet, 8)
+      BS_RTTI_MEMBER_PLAIN_NAMED(targetWaypoint, mActiveRoute.targetWaypoint, 10)
       BS_END_RTTI_MEMBERS
 
     public:
@@ -14,12 +14,45 @@ namespace REGoth
       BS_BEGIN_RTTI_MEMBERS
       BS_RTTI_MEMBER_PLAIN(mPC, 0)
       BS_RTTI_MEMBER_PLAIN(mCallDepth, 1)
-      BS_RTTI_MEMBER_PLAIN_ARRAY(mDatFileData, 2)
+      // BS_RTTI_MEMBER_PLAIN_ARRAY(mDatFileData, 2) // Added manually, see constructor
       BS_END_RTTI_MEMBERS
 
+      // The program is shared with other VMs, so it is copied out and in. See DaedalusProgram.
+      bs::UINT8& getDatFileByte(OwnerType* obj, UINT32 idx)
+      {
+        return mDatFileData[idx];
+      }
+
+      void setDatFileByte(OwnerType* obj, UINT32 idx, bs::UINT8& val)
+      {
+        mDatFileData[idx] = val;
+      }
+
+      UINT32 getSizeDatFileData(OwnerType* obj)
+      {
+        return (UINT32)mDatFileData.size();
+      }
+
+      void setSizeDatFileData(OwnerType* obj, UINT32 val)
+      {
+        mDatFileData.resize(val);
+      }
+
     public:
       RTTI_DaedalusVM()
       {
+        addPlainArrayField("mDatFileData", 2,                     //
+                           &RTTI_DaedalusVM::getDatFileByte,      //
+                           &RTTI_DaedalusVM::getSizeDatFileData,  //
+                           &RTTI_DaedalusVM::setDatFileByte,      //
+                           &RTTI_DaedalusVM::setSizeDatFileData); //
+      }
+
+      void onSerializationStarted(bs::IReflectable* _obj, bs::SerializationContext* context) override
+      {
+        auto obj = static_cast<DaedalusVM*>(_obj);
+
+        mDatFileData = obj->mProgram->datFileData();
       }
 
       void onDeserializationEnded(bs::IReflectable* _obj, bs::SerializationContext* context) override
@@ -27,18 +60,24 @@ namespace REGoth
         auto obj = static_cast<DaedalusVM*>(_obj);
 
         // Can't save the DAT-files datastructure, but we can save the raw dat-file as
-        // a workaround until we come up with something else.
-        obj->mDatFile = bs::bs_shared_ptr_new<Daedalus::DATFile>(obj->mDatFileData.data(),
-                                                                 obj->mDatFileData.size());
+        // a workaround until we come up with something else. Other VMs with the same scripts
+        // keep sharing it.
+        obj->mProgram = DaedalusProgram::share(std::move(mDatFileData));
+        obj->decodeInstructions();
+        obj->pinConstantStrings();
 
         obj->mClassVarResolver = bs::bs_shared_ptr_new<DaedalusClassVarResolver>(
-            obj->mScriptSymbols, obj->mScriptObjects);
+            obj->mScriptSymbols, obj->mScriptObjects, obj->mClassTemplates);
 
         obj->mClassTemplates.createClassTemplates(obj->mScriptSymbols);
-        obj->registerAllExternals();
+        obj->mScriptObjects.bindClassLayouts(obj->mClassTemplates);
+        obj->resolveVariables();
+        obj->setupExternals();
       }
 
       REGOTH_IMPLEMENT_RTTI_CLASS_ABSTRACT(DaedalusVM)
+
+      std::vector<bs::UINT8> mDatFileData;
     };
   }  // namespace Scripting
   // namespace Scripting
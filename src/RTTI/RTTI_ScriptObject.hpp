@@ -11,22 +11,181 @@ namespace REGoth
 
     class RTTI_ScriptObject : public bs::RTTIType<ScriptObject, bs::IReflectable, RTTI_ScriptObject>
     {
+      using IntsMap             = bs::Map<bs::String, ScriptInts>;
+      using FloatsMap           = bs::Map<bs::String, ScriptFloats>;
+      using StringsMap          = bs::Map<bs::String, ScriptStrings>;
+      using FunctionPointersMap = bs::Map<bs::String, bs::UINT32>;
+
       BS_BEGIN_RTTI_MEMBERS
       BS_RTTI_MEMBER_PLAIN(className, 0)
       BS_RTTI_MEMBER_PLAIN(handle, 1)
-      BS_RTTI_MEMBER_PLAIN(ints, 2)
-      BS_RTTI_MEMBER_PLAIN(floats, 3)
-      BS_RTTI_MEMBER_PLAIN(strings, 4)
-      BS_RTTI_MEMBER_PLAIN(functionPointers, 5)
+      // BS_RTTI_MEMBER_PLAIN(ints, 2) // Commented out: Added manually, see constructor
+      // BS_RTTI_MEMBER_PLAIN(floats, 3) // Commented out: Added manually, see constructor
+      // BS_RTTI_MEMBER_PLAIN(strings, 4) // Commented out: Added manually, see constructor
+      // BS_RTTI_MEMBER_PLAIN(functionPointers, 5) // Commented out: Added manually, see constructor
       BS_RTTI_MEMBER_PLAIN(instanceName, 6)
       BS_END_RTTI_MEMBERS
 
+      // Members are saved by name, since the layout of the class may change between saving
+      // and loading. They are put into the object once its layout is bound again.
+      //
+      // All of them go into the `members` blob now, which is much quicker than going through
+      // the maps value by value. The separate fields are only still read from older saves.
+      IntsMap& getInts(OwnerType* obj)
+      {
+        return mNoMembers.ints;
+      }
+
+      void setInts(OwnerType* obj, IntsMap& val)
+      {
+        mMembers.ints.insert(val.begin(), val.end());
+      }
+
+      FloatsMap& getFloats(OwnerType* obj)
+      {
+        return mNoMembers.floats;
+      }
+
+      void setFloats(OwnerType* obj, FloatsMap& val)
+      {
+        mMembers.floats.insert(val.begin(), val.end());
+      }
+
+      StringsMap& getStrings(OwnerType* obj)
+      {
+        return mNoMembers.strings;
+      }
+
+      void setStrings(OwnerType* obj, StringsMap& val)
+      {
+        mMembers.strings.insert(val.begin(), val.end());
+      }
+
+      FunctionPointersMap& getFunctionPointers(OwnerType* obj)
+      {
+        return mNoMembers.functionPointers;
+      }
+
+      void setFunctionPointers(OwnerType* obj, FunctionPointersMap& val)
+      {
+        mMembers.functionPointers.insert(val.begin(), val.end());
+      }
+
+      bs::SPtr<bs::DataStream> getMembersBlob(OwnerType* obj, UINT32& size)
+      {
+        RTTIBlobWriter writer;
+
+        writer.write((UINT32)mMembers.ints.size());
+        for (const auto& m : mMembers.ints)
+        {
+          writer.writeString(m.first);
+          writer.writeArray(m.second);
+        }
+
+        writer.write((UINT32)mMembers.floats.size());
+        for (const auto& m : mMembers.floats)
+        {
+          writer.writeString(m.first);
+          writer.writeArray(m.second);
+        }
+
+        writer.write((UINT32)mMembers.strings.size());
+        for (const auto& m : mMembers.strings)
+        {
+          writer.writeString(m.first);
+          writer.writeStrings(m.second);
+        }
+
+        writer.write((UINT32)mMembers.functionPointers.size());
+        for (const auto& m : mMembers.functionPointers)
+        {
+          writer.writeString(m.first);
+          writer.write(m.second);
+        }
+
+        return writer.finish(size);
+      }
+
+      void setMembersBlob(OwnerType* obj, const bs::SPtr<bs::DataStream>& value, UINT32 size)
+      {
+        RTTIBlobReader reader(value, size);
+
+        for (UINT32 i = 0, n = reader.read<UINT32>(); i < n; i++)
+        {
+          const bs::String& name = reader.readString();
+          reader.readArray(mMembers.ints[name]);
+        }
+
+        for (UINT32 i = 0, n = reader.read<UINT32>(); i < n; i++)
+        {
+          const bs::String& name = reader.readString();
+          reader.readArray(mMembers.floats[name]);
+        }
+
+        for (UINT32 i = 0, n = reader.read<UINT32>(); i < n; i++)
+        {
+          const bs::String& name = reader.readString();
+          reader.readStrings(mMembers.strings[name]);
+        }
+
+        for (UINT32 i = 0, n = reader.read<UINT32>(); i < n; i++)
+        {
+          const bs::String& name = reader.readString();
+          UINT32 address         = reader.read<UINT32>();
+
+          mMembers.functionPointers[name] = address;
+        }
+      }
+
     public:
       RTTI_ScriptObject()
       {
+        addPlainField("ints", 2,                                       //
+                      &RTTI_ScriptObject::getInts,                     //
+                      &RTTI_ScriptObject::setInts);                    //
+        addPlainField("floats", 3,                                     //
+                      &RTTI_ScriptObject::getFloats,                   //
+                      &RTTI_ScriptObject::setFloats);                  //
+        addPlainField("strings", 4,                                    //
+                      &RTTI_ScriptObject::getStrings,                  //
+                      &RTTI_ScriptObject::setStrings);                 //
+        addPlainField("functionPointers", 5,                           //
+                      &RTTI_ScriptObject::getFunctionPointers,         //
+                      &RTTI_ScriptObject::setFunctionPointers);        //
+        addDataBlockField("members", 7,                                //
+                          &RTTI_ScriptObject::getMembersBlob,          //
+                          &RTTI_ScriptObject::setMembersBlob);         //
+      }
+
+      void onSerializationStarted(bs::IReflectable* _obj, bs::SerializationContext* context) override
+      {
+        auto obj = static_cast<ScriptObject*>(_obj);
+
+        mMembers = obj->membersByName();
+      }
+
+      void onDeserializationStarted(bs::IReflectable* _obj,
+                                    bs::SerializationContext* context) override
+      {
+        // Merged from the blob and, in older saves, from the separate fields
+        mMembers = {};
+      }
+
+      void onDeserializationEnded(bs::IReflectable* _obj, bs::SerializationContext* context) override
+      {
+        auto obj = static_cast<ScriptObject*>(_obj);
+
+        // The layout will be bound by the ScriptVM once the class templates are available,
+        // see ScriptObjectStorage::bindClassLayouts().
+        obj->mLoadedMembers = bs::bs_shared_ptr_new<ScriptObjectMembersByName>(mMembers);
       }
 
       REGOTH_IMPLEMENT_RTTI_CLASS_FOR_REFLECTABLE(ScriptObject)
+
+      ScriptObjectMembersByName mMembers;
+
+      /** What the fields of older saves are written as */
+      ScriptObjectMembersByName mNoMembers;
     };
   }  // namespace Scripting
 }  // namespace REGoth
@@ -76,10 +76,15 @@ namespace REGoth
       {
         auto obj = static_cast<ScriptObjectMapping*>(_obj);
 
-        for (const auto& v : obj->mScriptToSceneObjectMapping)
+        mScriptHandles.clear();
+        mObjects.clear();
+
+        for (const auto& mapped : obj->mSceneObjectsBySlot)
         {
-          mScriptHandles.push_back(v.first);
-          mObjects.push_back(v.second);
+          if (mapped.scriptObject == SCRIPT_OBJECT_HANDLE_INVALID) continue;
+
+          mScriptHandles.push_back(mapped.scriptObject);
+          mObjects.push_back(mapped.sceneObject);
         }
       }
 
@@ -89,7 +94,7 @@ namespace REGoth
 
         for (bs::UINT32 i = 0; i < (bs::UINT32)mScriptHandles.size(); i++)
         {
-          obj->mScriptToSceneObjectMapping[mScriptHandles[i]] = mObjects[i];
+          obj->map(mScriptHandles[i], mObjects[i]);
         }
       }
       REGOTH_IMPLEMENT_RTTI_CLASS_FOR_REFLECTABLE(ScriptObjectMapping)
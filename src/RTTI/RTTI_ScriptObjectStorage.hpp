@@ -15,7 +15,7 @@ namespace REGoth
       BS_BEGIN_RTTI_MEMBERS
       // BS_RTTI_MEMBER_PLAIN(mObjects, 0) // Commented out: Added manually, see constructor
       // BS_RTTI_MEMBER_PLAIN(mObjectHandles, 1) // Commented out: Added manually, see constructor
-      BS_RTTI_MEMBER_PLAIN(mNextHandle, 2)
+      // Field 2 used to be mNextHandle, which is not needed anymore since handles are reused
       BS_END_RTTI_MEMBERS
 
       ScriptObject& getObject(OwnerType* obj, UINT32 idx)
@@ -78,10 +78,12 @@ namespace REGoth
       {
         auto obj = static_cast<ScriptObjectStorage*>(_obj);
 
-        for (const auto& v : obj->mObjects)
+        for (const auto& slot : obj->mSlots)
         {
-          mObjectHandles.push_back(v.first);
-          mObjects.push_back(v.second);
+          if (!slot.isAlive) continue;
+
+          mObjectHandles.push_back(slot.object.handle);
+          mObjects.push_back(slot.object);
         }
       }
 
@@ -91,8 +93,10 @@ namespace REGoth
 
         for (bs::UINT32 i = 0; i < (bs::UINT32)mObjectHandles.size(); i++)
         {
-          obj->mObjects[mObjectHandles[i]] = mObjects[i];
+          obj->insertWithHandle(mObjectHandles[i], mObjects[i]);
         }
+
+        obj->rebuildFreeSlots();
       }
 
       REGOTH_IMPLEMENT_RTTI_CLASS_FOR_REFLECTABLE(ScriptObjectStorage)
@@ -12,18 +12,254 @@ namespace REGoth
     class RTTI_ScriptSymbolStorage
         : public bs::RTTIType<ScriptSymbolStorage, bs::IReflectable, RTTI_ScriptSymbolStorage>
     {
+      using SymbolsByNameMap = bs::Map<bs::String, SymbolIndex>;
+
       BS_BEGIN_RTTI_MEMBERS
-      BS_RTTI_MEMBER_PLAIN(mSymbolsByName, 1)
-      BS_RTTI_MEMBER_REFLPTR_ARRAY(mStorage, 2)
+      // BS_RTTI_MEMBER_PLAIN(mSymbolsByName, 1) // Commented out: Added manually, see constructor
+      // BS_RTTI_MEMBER_REFLPTR_ARRAY(mStorage, 2) // Commented out: Added manually, see constructor
       BS_RTTI_MEMBER_PLAIN(mFunctionsByAddress, 3)
       BS_END_RTTI_MEMBERS
 
+      // The symbols live inside arenas now and are saved into the `symbols` blob in one go,
+      // which is much quicker than going through every symbol as its own reflectable. The
+      // separate fields are only still read from older saves, which stored them that way.
+      SymbolsByNameMap& getSymbolsByName(OwnerType* obj)
+      {
+        return mSymbolsByName;
+      }
+
+      void setSymbolsByName(OwnerType* obj, SymbolsByNameMap& val)
+      {
+        // Rebuilt while the symbols are added again
+      }
+
+      bs::SPtr<SymbolBase> getSymbol(OwnerType* obj, UINT32 idx)
+      {
+        return mSymbols[idx];
+      }
+
+      void setSymbol(OwnerType* obj, UINT32 idx, bs::SPtr<SymbolBase> val)
+      {
+        mSymbols[idx] = val;
+      }
+
+      UINT32 getSizeSymbols(OwnerType* obj)
+      {
+        return (UINT32)mSymbols.size();
+      }
+
+      void setSizeSymbols(OwnerType* obj, UINT32 val)
+      {
+        mSymbols.resize(val);
+      }
+
+      bs::SPtr<bs::DataStream> getSymbolsBlob(OwnerType* obj, UINT32& size)
+      {
+        RTTIBlobWriter writer;
+        writer.write((UINT32)obj->mSymbols.size());
+
+        for (const SymbolBase* symbol : obj->mSymbols)
+        {
+          writeSymbol(writer, *symbol);
+        }
+
+        return writer.finish(size);
+      }
+
+      void setSymbolsBlob(OwnerType* obj, const bs::SPtr<bs::DataStream>& value, UINT32 size)
+      {
+        RTTIBlobReader reader(value, size);
+
+        for (UINT32 i = 0, n = reader.read<UINT32>(); i < n; i++)
+        {
+          readSymbol(reader, *obj);
+        }
+      }
+
+      static void writeSymbol(RTTIBlobWriter& writer, const SymbolBase& symbol)
+      {
+        writer.write(symbol.type);
+        writer.writeString(symbol.name);
+        writer.write(symbol.index);
+        writer.write(symbol.parent);
+        writer.write(symbol.isClassVar);
+        writer.write(symbol.isKeptAfterLoad);
+
+        switch (symbol.type)
+        {
+          case SymbolType::Int:
+            writer.writeArray(static_cast<const SymbolInt&>(symbol).ints);
+            break;
+
+          case SymbolType::Float:
+            writer.writeArray(static_cast<const SymbolFloat&>(symbol).floats);
+            break;
+
+          case SymbolType::String:
+            writer.writeStrings(static_cast<const SymbolString&>(symbol).strings);
+            break;
+
+          case SymbolType::ScriptFunction:
+          {
+            const auto& function = static_cast<const SymbolScriptFunction&>(symbol);
+            writer.write(function.address);
+            writer.write(function.returnType);
+            break;
+          }
+
+          case SymbolType::ExternalFunction:
+            writer.write(static_cast<const SymbolExternalFunction&>(symbol).returnType);
+            break;
+
+          case SymbolType::Prototype:
+            writer.write(static_cast<const SymbolPrototype&>(symbol).constructorAddress);
+            break;
+
+          case SymbolType::Instance:
+          {
+            const auto& instance = static_cast<const SymbolInstance&>(symbol);
+            writer.write(instance.constructorAddress);
+            writer.write(instance.instance);
+            break;
+          }
+
+          default:
+            break;
+        }
+      }
+
+      static void readSymbol(RTTIBlobReader& reader, ScriptSymbolStorage& storage)
+      {
+        SymbolType type = reader.read<SymbolType>();
+
+        // Reads what all symbols have into the given one, then appends a copy of it
+        auto append = [&](SymbolBase& symbol, auto readSpecific) {
+          symbol.type            = type;
+          symbol.name            = reader.readString();
+          symbol.index           = reader.read<SymbolIndex>();
+          symbol.parent          = reader.read<SymbolIndex>();
+          symbol.isClassVar      = reader.read<bool>();
+          symbol.isKeptAfterLoad = reader.read<bool>();
+
+          readSpecific();
+
+          storage.appendSymbolCopy(symbol);
+        };
+
+        switch (type)
+        {
+          case SymbolType::Int:
+          {
+            SymbolInt symbol;
+            append(symbol, [&]() { reader.readArray(symbol.ints); });
+            break;
+          }
+
+          case SymbolType::Float:
+          {
+            SymbolFloat symbol;
+            append(symbol, [&]() { reader.readArray(symbol.floats); });
+            break;
+          }
+
+          case SymbolType::String:
+          {
+            SymbolString symbol;
+            append(symbol, [&]() { reader.readStrings(symbol.strings); });
+            break;
+          }
+
+          case SymbolType::Class:
+          {
+            SymbolClass symbol;
+            append(symbol, []() {});
+            break;
+          }
+
+          case SymbolType::ScriptFunction:
+          {
+            SymbolScriptFunction symbol;
+            append(symbol, [&]() {
+              symbol.address    = reader.read<UINT32>();
+              symbol.returnType = reader.read<ReturnType>();
+            });
+            break;
+          }
+
+          case SymbolType::ExternalFunction:
+          {
+            SymbolExternalFunction symbol;
+            append(symbol, [&]() { symbol.returnType = reader.read<ReturnType>(); });
+            break;
+          }
+
+          case SymbolType::Prototype:
+          {
+            SymbolPrototype symbol;
+            append(symbol, [&]() { symbol.constructorAddress = reader.read<UINT32>(); });
+            break;
+          }
+
+          case SymbolType::Instance:
+          {
+            SymbolInstance symbol;
+            append(symbol, [&]() {
+              symbol.constructorAddress = reader.read<UINT32>();
+              symbol.instance           = reader.read<ScriptObjectHandle>();
+            });
+            break;
+          }
+
+          default:
+          {
+            SymbolUnsupported symbol;
+            append(symbol, []() {});
+            break;
+          }
+        }
+      }
+
     public:
       RTTI_ScriptSymbolStorage()
       {
+        addPlainField("mSymbolsByName", 1,                                       //
+                      &RTTI_ScriptSymbolStorage::getSymbolsByName,               //
+                      &RTTI_ScriptSymbolStorage::setSymbolsByName);              //
+
+        addReflectablePtrArrayField("mStorage", 2,                               //
+                                    &RTTI_ScriptSymbolStorage::getSymbol,        //
+                                    &RTTI_ScriptSymbolStorage::getSizeSymbols,   //
+                                    &RTTI_ScriptSymbolStorage::setSymbol,        //
+                                    &RTTI_ScriptSymbolStorage::setSizeSymbols);  //
+
+        addDataBlockField("symbols", 4,                                          //
+                          &RTTI_ScriptSymbolStorage::getSymbolsBlob,             //
+                          &RTTI_ScriptSymbolStorage::setSymbolsBlob);            //
+      }
+
+      void onDeserializationStarted(bs::IReflectable* _obj,
+                                    bs::SerializationContext* context) override
+      {
+        // Filled by the fields of older saves only
+        mSymbols.clear();
+      }
+
+      void onDeserializationEnded(bs::IReflectable* _obj, bs::SerializationContext* context) override
+      {
+        auto obj = static_cast<ScriptSymbolStorage*>(_obj);
+
+        for (const auto& symbol : mSymbols)
+        {
+          obj->appendSymbolCopy(*symbol);
+        }
+
+        obj->buildQueryIndices();
       }
 
       REGOTH_IMPLEMENT_RTTI_CLASS_FOR_REFLECTABLE(ScriptSymbolStorage)
+
+      SymbolsByNameMap mSymbolsByName;
+      bs::Vector<bs::SPtr<SymbolBase>> mSymbols;
     };
   }  // namespace Scripting
   // namespace Scripting
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "RTTIUtil.hpp"
+#include <scripting/ScriptVMSnapshot.hpp>
+
+namespace REGoth
+{
+  namespace Scripting
+  {
+    class RTTI_ScriptVMSnapshot
+        : public bs::RTTIType<ScriptVMSnapshot, bs::IReflectable, RTTI_ScriptVMSnapshot>
+    {
+      using UINT32 = bs::UINT32;
+      using UINT64 = bs::UINT64;
+
+      BS_BEGIN_RTTI_MEMBERS
+      BS_RTTI_MEMBER_PLAIN(version, 0)
+      BS_RTTI_MEMBER_PLAIN(sourceHash, 1)
+      BS_RTTI_MEMBER_REFL(symbols, 2)
+      BS_RTTI_MEMBER_REFL(objects, 3)
+      BS_RTTI_MEMBER_REFL(mapping, 4)
+      BS_END_RTTI_MEMBERS
+
+    public:
+      RTTI_ScriptVMSnapshot()
+      {
+      }
+
+      REGOTH_IMPLEMENT_RTTI_CLASS_FOR_REFLECTABLE(ScriptVMSnapshot)
+    };
+  }  // namespace Scripting
+}  // namespace REGoth
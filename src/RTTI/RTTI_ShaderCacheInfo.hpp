@@ -0,0 +1,25 @@
+#pragma once
+
+#include "RTTIUtil.hpp"
+#include <engine-content/ShaderCacheInfo.hpp>
+
+namespace REGoth
+{
+  class RTTI_ShaderCacheInfo
+      : public bs::RTTIType<ShaderCacheInfo, bs::IReflectable, RTTI_ShaderCacheInfo>
+  {
+    BS_BEGIN_RTTI_MEMBERS
+    BS_RTTI_MEMBER_PLAIN(version, 0)
+    BS_RTTI_MEMBER_PLAIN(renderAPI, 1)
+    BS_RTTI_MEMBER_PLAIN(names, 2)
+    BS_RTTI_MEMBER_PLAIN(sourceHashes, 3)
+    BS_END_RTTI_MEMBERS
+
+  public:
+    RTTI_ShaderCacheInfo()
+    {
+    }
+
+    REGOTH_IMPLEMENT_RTTI_CLASS_FOR_REFLECTABLE(ShaderCacheInfo)
+  };
+}  // namespace REGoth
@@ -6,19 +6,51 @@ namespace REGoth
 {
   class RTTI_StoryInformation : public bs::RTTIType<StoryInformation, bs::Component, RTTI_StoryInformation>
   {
+    using KnownInfosSet = bs::Set<bs::String>;
 
     BS_BEGIN_RTTI_MEMBERS
-    // Explicitly Not serialized: mAllInfos
-    BS_RTTI_MEMBER_PLAIN(mKnownInfos, 0)
+    // Explicitly Not serialized: mAllInfos, mAllInfosVersion, mKnownInfosVersion
+    // BS_RTTI_MEMBER_PLAIN(mKnownInfos, 0) // Commented out: Added manually, see constructor
     BS_RTTI_MEMBER_REFL(mSelf, 1)
     BS_RTTI_MEMBER_REFL(mGameWorld, 2)
     BS_END_RTTI_MEMBERS
 
+    // Known infos are saved by name, since their dense indices are only known to the
+    // script VM. See StoryInformation::mapKnownInfoNames().
+    KnownInfosSet& getKnownInfos(OwnerType* obj)
+    {
+      return mKnownInfos;
+    }
+
+    void setKnownInfos(OwnerType* obj, KnownInfosSet& val)
+    {
+      mKnownInfos = val;
+    }
+
   public:
     RTTI_StoryInformation()
     {
+      addPlainField("mKnownInfos", 0,                          //
+                    &RTTI_StoryInformation::getKnownInfos,     //
+                    &RTTI_StoryInformation::setKnownInfos);    //
+    }
+
+    void onSerializationStarted(bs::IReflectable* _obj, bs::SerializationContext* context) override
+    {
+      auto obj = static_cast<StoryInformation*>(_obj);
+
+      mKnownInfos = obj->knownInfoNames();
+    }
+
+    void onDeserializationEnded(bs::IReflectable* _obj, bs::SerializationContext* context) override
+    {
+      auto obj = static_cast<StoryInformation*>(_obj);
+
+      obj->setKnownInfoNames(mKnownInfos);
     }
 
     REGOTH_IMPLEMENT_RTTI_CLASS_FOR_COMPONENT(StoryInformation)
+
+    KnownInfosSet mKnownInfos;
   };
 }  // namespace REGoth
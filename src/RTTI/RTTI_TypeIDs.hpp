@@ -14,7 +14,6 @@ namespace REGoth
     TID_REGOTH_VisualInteractiveObject      = 600006,
     TID_REGOTH_ScriptObjectStorage          = 600007,
     TID_REGOTH_ScriptObject                 = 600008,
-    TID_REGOTH_Waypoint                     = 600009,
     TID_REGOTH_Waynet                       = 600010,
     TID_REGOTH_VisualStaticMesh             = 600011,
     TID_REGOTH_NodeVisuals                  = 600012,
@@ -73,5 +72,13 @@ namespace REGoth
     TID_REGOTH_StoryInformation             = 600065,
     TID_REGOTH_Inventory                    = 600066,
     TID_REGOTH_UIInventory                  = 600067,
+    TID_REGOTH_ScriptVMSnapshot             = 600068,
+    TID_REGOTH_WorldCacheInfo               = 600069,
+    TID_REGOTH_CachedPackageIndex           = 600070,
+    TID_REGOTH_VdfsIndexCache               = 600071,
+    TID_REGOTH_UIProfilerOverlay            = 600072,
+    TID_REGOTH_AmbientSound                 = 600073,
+    TID_REGOTH_ShaderCacheInfo              = 600074,
+    TID_REGOTH_LevelChangeTrigger           = 600075,
   };
 }  // namespace REGoth
@@ -0,0 +1,21 @@
+#pragma once
+#include "RTTIUtil.hpp"
+#include <components/UIProfilerOverlay.hpp>
+
+namespace REGoth
+{
+  class RTTI_UIProfilerOverlay
+      : public bs::RTTIType<UIProfilerOverlay, UIElement, RTTI_UIProfilerOverlay>
+  {
+    BS_BEGIN_RTTI_MEMBERS
+    // This class should not be serialized
+    BS_END_RTTI_MEMBERS
+
+  public:
+    RTTI_UIProfilerOverlay()
+    {
+    }
+
+    REGOTH_IMPLEMENT_RTTI_CLASS_FOR_COMPONENT(UIProfilerOverlay)
+  };
+}  // namespace REGoth
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "RTTIUtil.hpp"
+#include <original-content/VdfsIndexCache.hpp>
+
+namespace REGoth
+{
+  class RTTI_CachedPackageIndex
+      : public bs::RTTIType<CachedPackageIndex, bs::IReflectable, RTTI_CachedPackageIndex>
+  {
+    BS_BEGIN_RTTI_MEMBERS
+    BS_RTTI_MEMBER_PLAIN(path, 0)
+    BS_RTTI_MEMBER_PLAIN(fileSize, 1)
+    BS_RTTI_MEMBER_PLAIN(modifiedTime, 2)
+    BS_RTTI_MEMBER_PLAIN(timestamp, 3)
+    BS_RTTI_MEMBER_PLAIN(names, 4)
+    BS_RTTI_MEMBER_PLAIN(offsets, 5)
+    BS_RTTI_MEMBER_PLAIN(sizes, 6)
+    BS_END_RTTI_MEMBERS
+
+  public:
+    RTTI_CachedPackageIndex()
+    {
+    }
+
+    REGOTH_IMPLEMENT_RTTI_CLASS_FOR_REFLECTABLE(CachedPackageIndex)
+  };
+
+  class RTTI_VdfsIndexCache
+      : public bs::RTTIType<VdfsIndexCache, bs::IReflectable, RTTI_VdfsIndexCache>
+  {
+    BS_BEGIN_RTTI_MEMBERS
+    BS_RTTI_MEMBER_PLAIN(version, 0)
+    BS_RTTI_MEMBER_REFLPTR_ARRAY(packages, 1)
+    BS_END_RTTI_MEMBERS
+
+  public:
+    RTTI_VdfsIndexCache()
+    {
+    }
+
+    REGOTH_IMPLEMENT_RTTI_CLASS_FOR_REFLECTABLE(VdfsIndexCache)
+  };
+}  // namespace REGoth
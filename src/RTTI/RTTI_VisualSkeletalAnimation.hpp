@@ -20,6 +20,7 @@ namespace REGoth
     BS_RTTI_MEMBER_REFL(mRootMotionLastClip, 6)
     BS_RTTI_MEMBER_PLAIN(mRootMotionLastTime, 7)
     BS_RTTI_MEMBER_REFL(mPlayingMainAnimation, 8)
+    BS_RTTI_MEMBER_PLAIN(mPendingVisual, 9)
     BS_END_RTTI_MEMBERS
 
   public:
@@ -34,7 +35,13 @@ namespace REGoth
       // Might have saved an empty visual, which is indeed okay to do
       if (obj->mModelScript)
       {
-        obj->createAnimationMap();
+        obj->createAnimationTable();
+      }
+
+      // Picked up by update() once loaded, like after setVisualAsync()
+      if (!obj->mPendingVisual.empty())
+      {
+        obj->mPendingModelScript = gOriginalGameResources().modelScriptAsync(obj->mPendingVisual);
       }
     }
 
@@ -10,6 +10,11 @@ namespace REGoth
   {
     BS_BEGIN_RTTI_MEMBERS
     BS_RTTI_MEMBER_REFL(mRenderable, 0)
+    BS_RTTI_MEMBER_REFL(mFullMesh, 1)
+    BS_RTTI_MEMBER_REFL_ARRAY(mLODs, 2)
+    BS_RTTI_MEMBER_PLAIN(mIsBatchable, 3)
+    BS_RTTI_MEMBER_PLAIN(mIsMerged, 4)
+    BS_RTTI_MEMBER_PLAIN(mMeshFileNames, 5)
     BS_END_RTTI_MEMBERS
 
   public:
@@ -10,8 +10,11 @@ namespace REGoth
     using UINT32 = bs::UINT32;
 
     BS_BEGIN_RTTI_MEMBERS
-    BS_RTTI_MEMBER_REFL_ARRAY(mWaypoints, 0)
     BS_RTTI_MEMBER_REFL_ARRAY(mFreepoints, 1)
+    BS_RTTI_MEMBER_PLAIN(mWaypointNames, 2)
+    BS_RTTI_MEMBER_PLAIN(mWaypointPositions, 3)
+    BS_RTTI_MEMBER_PLAIN(mWaypointDirections, 4)
+    BS_RTTI_MEMBER_PLAIN(mPaths, 5)
     BS_END_RTTI_MEMBERS
 
   public:
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "RTTIUtil.hpp"
+#include <world/WorldCacheInfo.hpp>
+
+namespace REGoth
+{
+  class RTTI_WorldCacheInfo
+      : public bs::RTTIType<WorldCacheInfo, bs::IReflectable, RTTI_WorldCacheInfo>
+  {
+    BS_BEGIN_RTTI_MEMBERS
+    BS_RTTI_MEMBER_PLAIN(version, 0)
+    BS_RTTI_MEMBER_PLAIN(zenFile, 1)
+    BS_RTTI_MEMBER_PLAIN(zenHash, 2)
+    BS_RTTI_MEMBER_PLAIN(scriptHash, 3)
+    BS_RTTI_MEMBER_PLAIN(isStreamed, 4)
+    BS_RTTI_MEMBER_PLAIN(visualHashes, 5)
+    BS_END_RTTI_MEMBERS
+
+  public:
+    RTTI_WorldCacheInfo()
+    {
+    }
+
+    REGOTH_IMPLEMENT_RTTI_CLASS_FOR_REFLECTABLE(WorldCacheInfo)
+  };
+}  // namespace REGoth
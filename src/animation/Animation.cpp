@@ -4,6 +4,8 @@
 
 namespace REGoth
 {
+  constexpr float AnimationState::RootMotionSamples::SAMPLE_RATE;
+
   bs::Vector3 AnimationState::getRootMotionSince(bs::HAnimationClip clip, float then, float now)
   {
     using namespace bs;
@@ -28,4 +30,53 @@ namespace REGoth
 
     return positionNow - positionThen;
   }
+
+  AnimationState::RootMotionSamples AnimationState::sampleRootMotion(bs::HAnimationClip clip)
+  {
+    RootMotionSamples samples;
+
+    if (!clip->getRootMotion()) return samples;
+
+    const auto& curve = clip->getRootMotion()->position;
+
+    enum : bool
+    {
+      Wrap  = true,
+      Clamp = false
+    };
+
+    const float rate = RootMotionSamples::SAMPLE_RATE;
+
+    samples.length = clip->getLength();
+
+    // The last sample is at or after the end of the clip, where the curve is clamped
+    bs::UINT32 numSamples = (bs::UINT32)bs::Math::ceilToInt(samples.length * rate) + 1;
+
+    samples.positions.reserve(numSamples);
+
+    for (bs::UINT32 i = 0; i < numSamples; i++)
+    {
+      samples.positions.push_back(curve.evaluate(i / rate, Clamp));
+    }
+
+    return samples;
+  }
+
+  bs::Vector3 AnimationState::RootMotionSamples::positionAt(float time) const
+  {
+    if (positions.empty()) return bs::Vector3(bs::BsZero);
+
+    float sample   = bs::Math::clamp(time, 0.0f, length) * SAMPLE_RATE;
+    bs::UINT32 idx = (bs::UINT32)sample;
+
+    if (idx + 1 >= positions.size()) return positions.back();
+
+    return bs::Math::lerp(sample - (float)idx, positions[idx], positions[idx + 1]);
+  }
+
+  bs::Vector3 AnimationState::getRootMotionSince(const RootMotionSamples& samples, float then,
+                                                 float now)
+  {
+    return samples.positionAt(now) - samples.positionAt(then);
+  }
 }  // namespace REGoth
@@ -3,6 +3,7 @@
 
 #pragma once
 #include <BsPrerequisites.h>
+#include <core/MemoryAccounting.hpp>
 #include <Math/BsVector3.h>
 
 namespace REGoth
@@ -10,5 +11,41 @@ namespace REGoth
   namespace AnimationState
   {
     bs::Vector3 getRootMotionSince(bs::HAnimationClip clip, float then, float now);
-  }
-}
+
+    /**
+     * Position of the root motion of a clip, sampled at a fixed rate. Evaluating the root
+     * motion curve means searching for the right keyframes every time, while these only need
+     * an index computed from the time and a linear interpolation.
+     *
+     * Clips without root motion have no samples.
+     */
+    struct RootMotionSamples
+    {
+      /** Samples per second */
+      static constexpr float SAMPLE_RATE = 60.0f;
+
+      /** Length of the sampled clip in seconds */
+      float length = 0.0f;
+
+      /**
+       * One position per sample, the last one at or after the end of the clip.
+       */
+      TrackedVector<bs::Vector3, MemoryTag::Animation> positions;
+
+      /**
+       * @return Root motion position at the given time, clamped to the clip's length.
+       */
+      bs::Vector3 positionAt(float time) const;
+    };
+
+    /**
+     * Samples the root motion curve of the given clip, see RootMotionSamples.
+     */
+    RootMotionSamples sampleRootMotion(bs::HAnimationClip clip);
+
+    /**
+     * Same as getRootMotionSince(), but using the samples taken via sampleRootMotion().
+     */
+    bs::Vector3 getRootMotionSince(const RootMotionSamples& samples, float then, float now);
+  }  // namespace AnimationState
+}  // namespace REGoth
@@ -0,0 +1,34 @@
+#include "AnimationLod.hpp"
+#include <Animation/BsSkeleton.h>
+
+namespace REGoth
+{
+  AnimationLodSettings& gAnimationLodSettings()
+  {
+    static AnimationLodSettings settings;
+    return settings;
+  }
+
+  bs::SkeletonMask createReducedDetailMask(const bs::SPtr<bs::Skeleton>& skeleton)
+  {
+    bs::SkeletonMaskBuilder builder(skeleton);
+
+    // Bones of the original skeletons are named like `BIP01 R FINGER01`
+    const char* detailBones[] = {"FINGER", "TOE"};
+
+    for (bs::UINT32 i = 0; i < skeleton->getNumBones(); i++)
+    {
+      const bs::String& name = skeleton->getBoneInfo(i).name;
+
+      for (const char* detail : detailBones)
+      {
+        if (name.find(detail) != bs::String::npos)
+        {
+          builder.setBoneState(name, false);
+        }
+      }
+    }
+
+    return builder.getMask();
+  }
+}  // namespace REGoth
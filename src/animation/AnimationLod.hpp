@@ -0,0 +1,43 @@
+/**\file
+ */
+
+#pragma once
+#include <BsPrerequisites.h>
+#include <Animation/BsSkeletonMask.h>
+
+namespace REGoth
+{
+  /**
+   * How much of the skeletal animation of characters is evaluated, depending on how far
+   * away from the main camera they are. Distances are in meters.
+   *
+   * There is one global set of settings, set by the Engine from EngineConfig::animationLod.
+   * See VisualSkeletalAnimation.
+   */
+  struct AnimationLodSettings
+  {
+    /**
+     * Characters farther away from the main camera than this don't evaluate the bones of
+     * their fingers and toes, see createReducedDetailMask().
+     */
+    float reducedDetailDistance = 20.0f;
+
+    /**
+     * Whether characters outside of the view of all cameras skip evaluating their skeleton.
+     * Their animations still advance, so root motion is unaffected, see
+     * VisualSkeletalAnimation::resolveFrameRootMotion().
+     */
+    bool isCullingOffscreen = true;
+  };
+
+  /**
+   * Global access to the animation LOD settings.
+   */
+  AnimationLodSettings& gAnimationLodSettings();
+
+  /**
+   * @return Mask for the given skeleton which disables all bones too small to notice from
+   *         far away, like fingers and toes.
+   */
+  bs::SkeletonMask createReducedDetailMask(const bs::SPtr<bs::Skeleton>& skeleton);
+}  // namespace REGoth
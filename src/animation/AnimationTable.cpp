@@ -0,0 +1,363 @@
+#include "AnimationTable.hpp"
+#include "StateNaming.hpp"
+#include <Animation/BsAnimationClip.h>
+#include <exception/Throw.hpp>
+
+namespace REGoth
+{
+  static const AI::WeaponMode ALL_WEAPON_MODES[] = {
+      AI::WeaponMode::None,      AI::WeaponMode::OneHanded, AI::WeaponMode::TwoHanded,
+      AI::WeaponMode::Bow,       AI::WeaponMode::Crossbow,  AI::WeaponMode::Magic,
+      AI::WeaponMode::Fist,
+  };
+
+  static const AI::WalkMode ALL_WALK_MODES[] = {
+      AI::WalkMode::Run,   AI::WalkMode::Walk, AI::WalkMode::Sneak,
+      AI::WalkMode::Water, AI::WalkMode::Swim, AI::WalkMode::Dive,
+  };
+
+  constexpr size_t NUM_WALK_MODES = sizeof(ALL_WALK_MODES) / sizeof(ALL_WALK_MODES[0]);
+
+  static size_t tagMapIndex(AI::WeaponMode weaponMode, AI::WalkMode walkMode)
+  {
+    return (size_t)weaponMode * NUM_WALK_MODES + (size_t)walkMode;
+  }
+
+  static const Locomotion ALL_LOCOMOTIONS[] = {
+      Locomotion::Stand,
+      Locomotion::Forward,
+      Locomotion::Backward,
+  };
+
+  constexpr size_t NUM_LOCOMOTIONS = sizeof(ALL_LOCOMOTIONS) / sizeof(ALL_LOCOMOTIONS[0]);
+
+  /**
+   * @return Name of the given state without weapon- and walk-mode, see findState().
+   */
+  static const char* locomotionStateName(Locomotion locomotion)
+  {
+    switch (locomotion)
+    {
+      case Locomotion::Stand:
+        return "";
+      case Locomotion::Forward:
+        return "L";
+      case Locomotion::Backward:
+        return "BL";
+      default:
+        REGOTH_THROW(InvalidParametersException, "Invalid Locomotion");
+    }
+  }
+
+  static size_t strafeClipIndex(AI::WalkMode walkMode, StrafeDirection direction)
+  {
+    return (size_t)walkMode * 2 + (direction == StrafeDirection::Left ? 0 : 1);
+  }
+
+  /** What describeClip() returns for clips not part of the table */
+  static const AnimationClipRecord UNKNOWN_CLIP_RECORD;
+
+  AnimationTable::AnimationTable(BsZenLib::Res::HModelScriptFile modelScript)
+  {
+    if (!modelScript)
+    {
+      REGOTH_THROW(InvalidParametersException, "No model script given!");
+    }
+
+    for (auto anim : modelScript->getAnimations())
+    {
+      // Clips are named like `HUMANS-S_RUNL`
+      const bs::String& fullName = anim->getName();
+      bs::String name            = fullName.substr(fullName.find_first_of('-') + 1);
+
+      mClipsByName[name] = anim;
+
+      // Same as taking apart the name of the playing clip, see CharacterAI
+      bs::String stateName = AnimationState::getStateName(name);
+
+      AnimationClipRecord& record = mClipRecords[anim.getUUID()];
+      record.hasStateName         = !stateName.empty();
+      record.isInterruptable      = name.find("-T_") == bs::String::npos;
+      record.isStanding           = stateName == "RUN" || stateName == "WALK";
+
+      if (name.size() > 2 && name[0] == 'S' && name[1] == '_')
+      {
+        AnimationStateIndex state = addState(name);
+
+        if (state != ANIMATION_STATE_INVALID)
+        {
+          mStateClips[state] = anim;
+        }
+
+        record.state = state;
+      }
+      else if (name.size() > 2 && name[0] == 'T' && name[1] == '_')
+      {
+        // Matches what AnimationState::constructTransitionAnimationName() creates
+        size_t separator = name.find("_2_");
+
+        // Transitions like `T_JUMPB` don't come from a specific state
+        if (separator == bs::String::npos) continue;
+
+        AnimationStateIndex from = addState("S_" + name.substr(2, separator - 2));
+        AnimationStateIndex to   = addState("S_" + name.substr(separator + 3));
+
+        if (from != ANIMATION_STATE_INVALID && to != ANIMATION_STATE_INVALID)
+        {
+          mTransitionClips[transitionKey(from, to)] = anim;
+        }
+      }
+    }
+
+    mapStatesByTag();
+    parseEvents();
+    findLocomotion();
+  }
+
+  bs::SPtr<const AnimationTable> AnimationTable::forModelScript(
+      BsZenLib::Res::HModelScriptFile modelScript)
+  {
+    struct SharedTable
+    {
+      BsZenLib::Res::HModelScriptFile modelScript;
+      bs::SPtr<const AnimationTable> table;
+    };
+
+    // The handle is kept to notice a different model script loaded under the same name
+    static bs::UnorderedMap<bs::String, SharedTable> sTables;
+
+    if (!modelScript)
+    {
+      REGOTH_THROW(InvalidParametersException, "No model script given!");
+    }
+
+    SharedTable& shared = sTables[modelScript->getName()];
+
+    if (!shared.table || shared.modelScript != modelScript)
+    {
+      shared.modelScript = modelScript;
+      shared.table       = bs::bs_shared_ptr_new<AnimationTable>(modelScript);
+    }
+
+    return shared.table;
+  }
+
+  AnimationStateIndex AnimationTable::addState(const bs::String& stateAnimation)
+  {
+    auto it = mStatesByAnimation.find(stateAnimation);
+
+    if (it != mStatesByAnimation.end()) return it->second;
+
+    if (AnimationState::getStateName(stateAnimation).empty()) return ANIMATION_STATE_INVALID;
+
+    AnimationStateIndex state = (AnimationStateIndex)mStateClips.size();
+
+    mStateClips.emplace_back();
+    mStatesByAnimation[stateAnimation] = state;
+
+    return state;
+  }
+
+  void AnimationTable::mapStatesByTag()
+  {
+    mStatesByTag.clear();
+    mStatesByTag.resize(tagMapIndex(AI::WeaponMode::Fist, AI::WalkMode::Dive) + 1);
+
+    for (AI::WeaponMode weaponMode : ALL_WEAPON_MODES)
+    {
+      for (AI::WalkMode walkMode : ALL_WALK_MODES)
+      {
+        bs::String prefix = "S_" + AnimationState::getWeaponModeTag(weaponMode) +
+                            AnimationState::getWalkModeTag(walkMode);
+
+        auto& states = mStatesByTag[tagMapIndex(weaponMode, walkMode)];
+
+        for (const auto& s : mStatesByAnimation)
+        {
+          if (s.first.compare(0, prefix.size(), prefix) == 0)
+          {
+            states[s.first.substr(prefix.size())] = s.second;
+          }
+        }
+      }
+    }
+  }
+
+  void AnimationTable::findLocomotion()
+  {
+    mLocomotionStates.assign(mStatesByTag.size() * NUM_LOCOMOTIONS, ANIMATION_STATE_INVALID);
+
+    for (AI::WeaponMode weaponMode : ALL_WEAPON_MODES)
+    {
+      for (AI::WalkMode walkMode : ALL_WALK_MODES)
+      {
+        for (Locomotion locomotion : ALL_LOCOMOTIONS)
+        {
+          size_t index = tagMapIndex(weaponMode, walkMode) * NUM_LOCOMOTIONS + (size_t)locomotion;
+
+          mLocomotionStates[index] =
+              findState(weaponMode, walkMode, locomotionStateName(locomotion));
+        }
+      }
+    }
+
+    mStrafeClips.clear();
+    mStrafeClips.resize(NUM_WALK_MODES * 2);
+
+    // Only these are played by CharacterAI
+    for (AI::WalkMode walkMode : {AI::WalkMode::Run, AI::WalkMode::Walk, AI::WalkMode::Sneak})
+    {
+      bs::String prefix = "T_" + AnimationState::getWalkModeTag(walkMode) + "STRAFE";
+
+      mStrafeClips[strafeClipIndex(walkMode, StrafeDirection::Left)]  = findClip(prefix + "L");
+      mStrafeClips[strafeClipIndex(walkMode, StrafeDirection::Right)] = findClip(prefix + "R");
+    }
+
+    mStandState   = findState("S_STAND");
+    mJumpState    = findState("S_JUMP");
+    mJumpBackClip = findClip("T_JUMPB");
+  }
+
+  void AnimationTable::parseEvents()
+  {
+    for (const auto& c : mClipsByName)
+    {
+      for (const bs::AnimationEvent& event : c.second->mClip->getEvents())
+      {
+        if (mEvents.find(event.name) != mEvents.end()) continue;
+
+        AnimationEventRecord record = parseEvent(event.name);
+
+        if (record.type == AnimationEventType::PlayClip)
+        {
+          record.clip = findClip(record.action);
+        }
+
+        mEvents[event.name] = std::move(record);
+      }
+    }
+  }
+
+  AnimationEventRecord AnimationTable::parseEvent(const bs::String& event)
+  {
+    AnimationEventRecord record;
+
+    // Commands could come in the form of "COMMAND:ACTION" or just "COMMAND"
+    size_t separator = event.find_first_of(':');
+
+    bs::String command = event.substr(0, separator);
+
+    if (separator != bs::String::npos)
+    {
+      record.action = event.substr(separator + 1);
+    }
+
+    if (command == "STOP")
+    {
+      record.type = AnimationEventType::Stop;
+    }
+    else if (command == "PLAYCLIP")
+    {
+      record.type = AnimationEventType::PlayClip;
+    }
+    else if (command == "MORPHMESHANI")
+    {
+      record.type = AnimationEventType::MorphMeshAnimation;
+    }
+
+    return record;
+  }
+
+  const AnimationEventRecord* AnimationTable::findEvent(const bs::String& event) const
+  {
+    auto it = mEvents.find(event);
+
+    if (it == mEvents.end()) return nullptr;
+
+    return &it->second;
+  }
+
+  HZAnimationClip AnimationTable::findClip(const bs::String& name) const
+  {
+    auto it = mClipsByName.find(name);
+
+    if (it == mClipsByName.end()) return {};
+
+    return it->second;
+  }
+
+  AnimationStateIndex AnimationTable::findState(const bs::String& stateAnimation) const
+  {
+    auto it = mStatesByAnimation.find(stateAnimation);
+
+    if (it == mStatesByAnimation.end()) return ANIMATION_STATE_INVALID;
+
+    return it->second;
+  }
+
+  AnimationStateIndex AnimationTable::findState(AI::WeaponMode weaponMode, AI::WalkMode walkMode,
+                                                const bs::String& state) const
+  {
+    const auto& states = mStatesByTag[tagMapIndex(weaponMode, walkMode)];
+
+    auto it = states.find(state);
+
+    if (it == states.end()) return ANIMATION_STATE_INVALID;
+
+    return it->second;
+  }
+
+  AnimationStateIndex AnimationTable::locomotionState(AI::WeaponMode weaponMode,
+                                                      AI::WalkMode walkMode,
+                                                      Locomotion locomotion) const
+  {
+    return mLocomotionStates[tagMapIndex(weaponMode, walkMode) * NUM_LOCOMOTIONS +
+                             (size_t)locomotion];
+  }
+
+  HZAnimationClip AnimationTable::strafeClip(AI::WalkMode walkMode,
+                                             StrafeDirection direction) const
+  {
+    return mStrafeClips[strafeClipIndex(walkMode, direction)];
+  }
+
+  const AnimationClipRecord& AnimationTable::describeClip(HZAnimationClip clip) const
+  {
+    if (!clip) return UNKNOWN_CLIP_RECORD;
+
+    auto it = mClipRecords.find(clip.getUUID());
+
+    if (it == mClipRecords.end()) return UNKNOWN_CLIP_RECORD;
+
+    return it->second;
+  }
+
+  HZAnimationClip AnimationTable::stateClip(AnimationStateIndex state) const
+  {
+    if (state >= mStateClips.size()) return {};
+
+    return mStateClips[state];
+  }
+
+  HZAnimationClip AnimationTable::transitionClip(AnimationStateIndex from,
+                                                 AnimationStateIndex to) const
+  {
+    if (from == ANIMATION_STATE_INVALID || to == ANIMATION_STATE_INVALID) return {};
+
+    auto it = mTransitionClips.find(transitionKey(from, to));
+
+    if (it == mTransitionClips.end()) return {};
+
+    return it->second;
+  }
+
+  const AnimationState::RootMotionSamples& AnimationTable::rootMotion(
+      const bs::HAnimationClip& clip) const
+  {
+    auto it = mRootMotions.find(clip->getName());
+
+    if (it != mRootMotions.end()) return it->second;
+
+    return mRootMotions[clip->getName()] = AnimationState::sampleRootMotion(clip);
+  }
+}  // namespace REGoth
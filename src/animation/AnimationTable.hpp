@@ -0,0 +1,299 @@
+/**\file
+ */
+
+#pragma once
+#include "Animation.hpp"
+#include <BsPrerequisites.h>
+#include <AI/WalkMode.hpp>
+#include <AI/WeaponMode.hpp>
+#include <BsZenLib/ZenResources.hpp>
+
+namespace REGoth
+{
+  using HZAnimationClip = BsZenLib::Res::HZAnimation;
+
+  /**
+   * Index of a state inside an AnimationTable, like `RUNL` for `S_RUNL`. Only valid for the
+   * table it came from.
+   */
+  typedef bs::UINT32 AnimationStateIndex;
+
+  enum : AnimationStateIndex
+  {
+    ANIMATION_STATE_INVALID = UINT32_MAX
+  };
+
+  /**
+   * The states of moving around in every weapon- and walk-mode, see
+   * AnimationTable::locomotionState().
+   */
+  enum class Locomotion : bs::UINT8
+  {
+    Stand,    /**< State without a name, like `S_1HRUN` */
+    Forward,  /**< State `L`, like `S_1HRUNL` */
+    Backward, /**< State `BL`, like `S_1HWALKBL`. Running has none. */
+  };
+
+  enum class StrafeDirection
+  {
+    Left,
+    Right,
+  };
+
+  /**
+   * What is known about a clip of the model script, so the playing clip doesn't have to be
+   * taken apart by name. See AnimationTable::describeClip().
+   */
+  struct AnimationClipRecord
+  {
+    /** State of a state animation like `S_RUNL`. ANIMATION_STATE_INVALID for other clips. */
+    AnimationStateIndex state = ANIMATION_STATE_INVALID;
+
+    /** Whether AnimationState::getStateName() knows the naming scheme of the clip */
+    bool hasStateName = false;
+
+    /** See VisualSkeletalAnimation::isPlayingAnimationInterruptable() */
+    bool isInterruptable = true;
+
+    /** Whether the clip is the state animation of `RUN` or `WALK`, see CharacterAI::isStanding() */
+    bool isStanding = false;
+  };
+
+  /**
+   * What an event inside an animation clip does, see AnimationEventRecord.
+   */
+  enum class AnimationEventType
+  {
+    Stop,               /**< `STOP`: Stops playing the clip */
+    PlayClip,           /**< `PLAYCLIP:<NAME>`: Plays the next animation */
+    MorphMeshAnimation, /**< `MORPHMESHANI:<NAME>`: Animates a morph mesh, like the face */
+    Unknown,
+  };
+
+  /**
+   * An animation event, parsed from the `COMMAND:ACTION` string it is triggered with.
+   */
+  struct AnimationEventRecord
+  {
+    AnimationEventType type = AnimationEventType::Unknown;
+
+    /** What follows the command, e.g. the name of the animation to play */
+    bs::String action;
+
+    /** For AnimationEventType::PlayClip: The clip to play. Invalid if it doesn't exist. */
+    HZAnimationClip clip;
+  };
+
+  /**
+   * The animations of a model script, prepared so an animation to play can be found without
+   * putting together its name first.
+   *
+   * All states mentioned by the state animations (`S_RUNL`) and transition animations
+   * (`T_RUN_2_RUNL`) of the model script get an AnimationStateIndex. The clip of a state and
+   * the transition between two states are then looked up by those indices. See the
+   * functions inside StateNaming.hpp on how the names are made up.
+   *
+   * The states CharacterAI moves characters through are looked up once for every weapon- and
+   * walk-mode, see locomotionState(). Together with describeClip() for the playing clip, going
+   * from one state into the next takes a few lookups without any names.
+   *
+   * Tables only depend on their model script, so all visuals with the same model script share
+   * the same table, see forModelScript().
+   */
+  class AnimationTable
+  {
+  public:
+    AnimationTable(BsZenLib::Res::HModelScriptFile modelScript);
+
+    /**
+     * @return The table shared by everything using the given model script. It is created the
+     *         first time the model script is seen, or again if it has been reloaded.
+     */
+    static bs::SPtr<const AnimationTable> forModelScript(
+        BsZenLib::Res::HModelScriptFile modelScript);
+
+    /**
+     * @param  name  The UPPERCASE animation name without the model script (`S_RUNL`)
+     *
+     * @return Animation clip for the given animation name. Invalid if not found.
+     */
+    HZAnimationClip findClip(const bs::String& name) const;
+
+    /**
+     * @param  stateAnimation  Name of a state animation, like `S_RUNL`. The animation itself
+     *                         doesn't need to exist, e.g. `S_STAND`.
+     *
+     * @return The state the given animation is for. ANIMATION_STATE_INVALID if none of the
+     *         animations mention that state.
+     */
+    AnimationStateIndex findState(const bs::String& stateAnimation) const;
+
+    /**
+     * Same as findState() with the name from AnimationState::constructStateAnimationName().
+     *
+     * @param  state  Name of the state without the walk mode, like `L`.
+     */
+    AnimationStateIndex findState(AI::WeaponMode weaponMode, AI::WalkMode walkMode,
+                                  const bs::String& state) const;
+
+    /**
+     * Same as findState() for the states of moving around, looked up when creating the table.
+     *
+     * @return ANIMATION_STATE_INVALID if the model script doesn't have that state, like
+     *         running backwards.
+     */
+    AnimationStateIndex locomotionState(AI::WeaponMode weaponMode, AI::WalkMode walkMode,
+                                        Locomotion locomotion) const;
+
+    /**
+     * @return The state `S_STAND`, which some transitions like `T_JUMP_2_STAND` come from or
+     *         go to without an animation of its own.
+     */
+    AnimationStateIndex standState() const
+    {
+      return mStandState;
+    }
+
+    /**
+     * @return The state `S_JUMP`.
+     */
+    AnimationStateIndex jumpState() const
+    {
+      return mJumpState;
+    }
+
+    /**
+     * @return The clip for stepping sideways in the given walk-mode, like `T_RUNSTRAFEL`.
+     *         Invalid for walk-modes other than running, walking and sneaking.
+     */
+    HZAnimationClip strafeClip(AI::WalkMode walkMode, StrafeDirection direction) const;
+
+    /**
+     * @return The clip `T_JUMPB`, which is played for going backwards when running.
+     */
+    HZAnimationClip jumpBackClip() const
+    {
+      return mJumpBackClip;
+    }
+
+    /**
+     * @return What is known about the given clip of this model script. The record of an
+     *         unknown clip if it isn't one.
+     */
+    const AnimationClipRecord& describeClip(HZAnimationClip clip) const;
+
+    /**
+     * @return The state animation clip of the given state. Invalid if there is none, e.g.
+     *         for states which are only mentioned by transitions.
+     */
+    HZAnimationClip stateClip(AnimationStateIndex state) const;
+
+    /**
+     * @return The clip for going from one state into another. Invalid if there is none, which
+     *         means the transition is not possible.
+     */
+    HZAnimationClip transitionClip(AnimationStateIndex from, AnimationStateIndex to) const;
+
+    /**
+     * @return The sampled root motion of the given clip of this model script. Sampled the
+     *         first time it is asked for, as most clips are never played. The returned
+     *         reference stays valid as long as the table exists.
+     */
+    const AnimationState::RootMotionSamples& rootMotion(const bs::HAnimationClip& clip) const;
+
+    /**
+     * @param  event  The event string as triggered by the animation, like `PLAYCLIP:S_RUN`.
+     *
+     * @return The parsed event, if it belongs to a clip of this model script. nullptr
+     *         otherwise, see parseEvent().
+     */
+    const AnimationEventRecord* findEvent(const bs::String& event) const;
+
+    /**
+     * Parses the given event string. Clips to play are not looked up.
+     */
+    static AnimationEventRecord parseEvent(const bs::String& event);
+
+  private:
+    /**
+     * @return Index of the given state name, which is added if it didn't exist yet.
+     */
+    AnimationStateIndex addState(const bs::String& stateAnimation);
+
+    /**
+     * Fills mStatesByTag, once all states are known.
+     */
+    void mapStatesByTag();
+
+    /**
+     * Fills mEvents, once all clips are known.
+     */
+    void parseEvents();
+
+    /**
+     * Fills mLocomotionStates and the other states and clips CharacterAI plays, once all
+     * states are known.
+     */
+    void findLocomotion();
+
+    static bs::UINT64 transitionKey(AnimationStateIndex from, AnimationStateIndex to)
+    {
+      return (bs::UINT64)from << 32 | to;
+    }
+
+    /**
+     * All animations of the model script, keyed by their name without the model script.
+     */
+    bs::UnorderedMap<bs::String, HZAnimationClip> mClipsByName;
+
+    /**
+     * State animation names like `S_RUNL` -> state.
+     */
+    bs::UnorderedMap<bs::String, AnimationStateIndex> mStatesByAnimation;
+
+    /**
+     * One map per weapon- and walk-mode combination, see findState(). Keyed by what's left
+     * of the state name after the tags of both modes, like `L` for `S_1HRUNL`.
+     */
+    bs::Vector<bs::UnorderedMap<bs::String, AnimationStateIndex>> mStatesByTag;
+
+    /**
+     * State animation clip of every state, by AnimationStateIndex.
+     */
+    bs::Vector<HZAnimationClip> mStateClips;
+
+    /**
+     * Transition clips, by transitionKey().
+     */
+    bs::UnorderedMap<bs::UINT64, HZAnimationClip> mTransitionClips;
+
+    /**
+     * See describeClip(), keyed by the UUID of the clip.
+     */
+    bs::UnorderedMap<bs::UUID, AnimationClipRecord> mClipRecords;
+
+    /**
+     * See locomotionState(). One entry per Locomotion for every weapon- and walk-mode.
+     */
+    bs::Vector<AnimationStateIndex> mLocomotionStates;
+
+    /**
+     * See strafeClip(), by walk-mode and direction.
+     */
+    bs::Vector<HZAnimationClip> mStrafeClips;
+
+    AnimationStateIndex mStandState = ANIMATION_STATE_INVALID;
+    AnimationStateIndex mJumpState  = ANIMATION_STATE_INVALID;
+    HZAnimationClip mJumpBackClip;
+
+    /**
+     * See rootMotion(). Keyed by the full name of the clip.
+     */
+    mutable bs::UnorderedMap<bs::String, AnimationState::RootMotionSamples> mRootMotions;
+
+    /**
+     * The events of all clips, keyed by their event string.
+     */
+    bs::UnorderedMap<bs::String, AnimationEventRecord> mEvents;
+  };
+}  // namespace REGoth
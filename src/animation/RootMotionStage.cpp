@@ -0,0 +1,52 @@
+#include "RootMotionStage.hpp"
+#include <chrono>
+#include <components/VisualSkeletalAnimation.hpp>
+#include <core/Jobs.hpp>
+#include <core/Profiling.hpp>
+
+namespace REGoth
+{
+  constexpr bs::UINT32 RootMotionStage::VISUALS_PER_TASK;
+
+  void RootMotionStage::run(const bs::Vector<VisualSkeletalAnimation*>& visuals)
+  {
+    REGOTH_PROFILE_SCOPE("RootMotionStage");
+
+    auto start = std::chrono::high_resolution_clock::now();
+
+    for (VisualSkeletalAnimation* visual : visuals)
+    {
+      visual->prepareFrameRootMotion();
+    }
+
+    bs::UINT32 numVisuals = (bs::UINT32)visuals.size();
+    bs::UINT32 numTasks   = 0;
+
+    if (mIsParallel)
+    {
+      numTasks = Jobs::parallelFor("RootMotion", numVisuals, VISUALS_PER_TASK,
+                                   [&visuals](bs::UINT32 first, bs::UINT32 last) {
+                                     REGOTH_PROFILE_SCOPE("RootMotionTask");
+
+                                     for (bs::UINT32 i = first; i < last; i++)
+                                     {
+                                       visuals[i]->computeFrameRootMotion();
+                                     }
+                                   });
+    }
+    else
+    {
+      for (VisualSkeletalAnimation* visual : visuals)
+      {
+        visual->computeFrameRootMotion();
+      }
+    }
+
+    auto end = std::chrono::high_resolution_clock::now();
+
+    mLastStats.numVisuals = numVisuals;
+    mLastStats.numTasks   = numTasks;
+    mLastStats.nanosecondsUsed =
+        (bs::UINT64)std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+  }
+}  // namespace REGoth
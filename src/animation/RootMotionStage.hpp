@@ -0,0 +1,70 @@
+/**\file
+ */
+
+#pragma once
+#include <BsPrerequisites.h>
+
+namespace REGoth
+{
+  class VisualSkeletalAnimation;
+
+  /**
+   * Resolves the root motion of many visuals at once, before the characters' AI consumes it
+   * during its fixed update.
+   *
+   * Reading how far the animations have advanced has to be done on the calling thread, but
+   * computing the actual motion from that only touches the visual itself. With enough
+   * visuals, that part is spread across the task scheduler's workers. The skeletons
+   * themselves are sampled and blended by bs:f's animation system, which already does that
+   * on its own workers.
+   *
+   * Every GameWorld has one stage, run on its fixed update, see GameWorld::rootMotionStage().
+   */
+  class RootMotionStage
+  {
+  public:
+    /**
+     * Visuals computed by a single task. Fewer visuals are computed on the calling thread,
+     * since starting a task costs more than that.
+     */
+    static constexpr bs::UINT32 VISUALS_PER_TASK = 64;
+
+    /**
+     * Counters of the last run.
+     */
+    struct Stats
+    {
+      bs::UINT32 numVisuals      = 0;
+      bs::UINT32 numTasks        = 0;
+      bs::UINT64 nanosecondsUsed = 0;
+    };
+
+    /**
+     * Resolves the root motion of the given visuals. Each visual returns the result on its
+     * next call to VisualSkeletalAnimation::resolveFrameRootMotion().
+     */
+    void run(const bs::Vector<VisualSkeletalAnimation*>& visuals);
+
+    /**
+     * Whether the computation may be spread across worker threads. On by default.
+     */
+    void setParallel(bool isParallel)
+    {
+      mIsParallel = isParallel;
+    }
+
+    bool isParallel() const
+    {
+      return mIsParallel;
+    }
+
+    const Stats& lastStats() const
+    {
+      return mLastStats;
+    }
+
+  private:
+    bool mIsParallel = true;
+    Stats mLastStats;
+  };
+}  // namespace REGoth
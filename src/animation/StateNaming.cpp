@@ -10,7 +10,7 @@ const AI::WeaponMode ALL_WEAPON_MODES[] = {
     AI::WeaponMode::Fist,
 };
 
-static bs::String getWeaponAniTag(AI::WeaponMode weapon)
+bs::String AnimationState::getWeaponModeTag(AI::WeaponMode weapon)
 {
   using namespace AI;
 
@@ -35,7 +35,7 @@ static bs::String getWeaponAniTag(AI::WeaponMode weapon)
   }
 }
 
-static bs::String getWalkModeAniTag(AI::WalkMode walkMode)
+bs::String AnimationState::getWalkModeTag(AI::WalkMode walkMode)
 {
   using namespace AI;
 
@@ -61,14 +61,14 @@ static bs::String getWalkModeAniTag(AI::WalkMode walkMode)
 bs::String AnimationState::constructStateAnimationName(AI::WeaponMode weaponMode,
                                                        AI::WalkMode walkMode, const bs::String& name)
 {
-  return "S_" + getWeaponAniTag(weaponMode) + getWalkModeAniTag(walkMode) + name;
+  return "S_" + getWeaponModeTag(weaponMode) + getWalkModeTag(walkMode) + name;
 }
 
 bs::String AnimationState::constructTransitionAnimationName(AI::WeaponMode weaponMode,
                                                             const bs::String& from,
                                                             const bs::String& to)
 {
-  const bs::String weaponAniTag = getWeaponAniTag(weaponMode);
+  const bs::String weaponAniTag = getWeaponModeTag(weaponMode);
 
   return "T_" + weaponAniTag + from + "_2_" + weaponAniTag + to;
 }
@@ -92,7 +92,7 @@ AI::WeaponMode AnimationState::getWeaponMode(const bs::String& animation)
 
   for (AI::WeaponMode m : ALL_WEAPON_MODES)
   {
-    bs::String weaponModeTag = getWeaponAniTag(m);
+    bs::String weaponModeTag = getWeaponModeTag(m);
 
     if (animation.substr(2, weaponModeTag.length()) == weaponModeTag)
     {
@@ -107,7 +107,7 @@ bs::String AnimationState::stripWeaponModeFromAnimationName(const bs::String& an
 {
   for (AI::WeaponMode m : ALL_WEAPON_MODES)
   {
-    bs::String weaponModeTag = getWeaponAniTag(m);
+    bs::String weaponModeTag = getWeaponModeTag(m);
 
     if (animation.substr(0, weaponModeTag.length()) == weaponModeTag)
     {
@@ -91,5 +91,17 @@ namespace REGoth
      */
     bs::String stripWeaponModeFromAnimationName(const bs::String& animation);
 
+    /**
+     * @return The tag animation names use for the given weapon mode, e.g. `1H` for
+     *         `AI::WeaponMode::OneHanded`. Empty for `AI::WeaponMode::None`.
+     */
+    bs::String getWeaponModeTag(AI::WeaponMode weaponMode);
+
+    /**
+     * @return The tag animation names use for the given walk mode, e.g. `SNEAK` for
+     *         `AI::WalkMode::Sneak`.
+     */
+    bs::String getWalkModeTag(AI::WalkMode walkMode);
+
   }  // namespace Animation
 }  // namespace REGoth
@@ -0,0 +1,23 @@
+#include "AmbientSound.hpp"
+#include <RTTI/RTTI_AmbientSound.hpp>
+
+namespace REGoth
+{
+  AmbientSound::AmbientSound(const bs::HSceneObject& parent, const bs::String& soundFile,
+                             float radius, float volume, Mode mode)
+      : bs::Component(parent)
+      , mSoundFile(soundFile)
+      , mRadius(radius)
+      , mVolume(volume)
+      , mMode(mode)
+  {
+    setName("AmbientSound");
+  }
+
+  AmbientSound::~AmbientSound()
+  {
+  }
+
+  REGOTH_DEFINE_RTTI(AmbientSound)
+
+}  // namespace REGoth
@@ -0,0 +1,93 @@
+#pragma once
+#include <RTTI/RTTIUtil.hpp>
+#include <Scene/BsComponent.h>
+
+namespace REGoth
+{
+  class AmbientSound;
+  using HAmbientSound = bs::GameObjectHandle<AmbientSound>;
+
+  /**
+   * A sound placed in the world, like crows cawing or a river rushing. Imported from the
+   * zCVobSound vobs of a ZEN.
+   *
+   * This only describes the sound. Whether it is actually audible is decided by
+   * AmbientSoundVoices, which only gives the closest sounds a voice.
+   */
+  class AmbientSound : public bs::Component
+  {
+  public:
+    /**
+     * How the sound is played, like `sndMode` of zCVobSound.
+     */
+    enum class Mode : bs::UINT8
+    {
+      Loop   = 0,
+      Once   = 1,
+      Random = 2, /**< Played again after a random delay, see setRandomDelay() */
+    };
+
+    AmbientSound(const bs::HSceneObject& parent, const bs::String& soundFile, float radius,
+                 float volume, Mode mode);
+    virtual ~AmbientSound();
+
+    /**
+     * Sets the delay between two plays of a sound in Mode::Random, in seconds.
+     *
+     * @param  delay     Average delay.
+     * @param  variance  The delay is off by up to this much in either direction.
+     */
+    void setRandomDelay(float delay, float variance)
+    {
+      mRandomDelay         = delay;
+      mRandomDelayVariance = variance;
+    }
+
+    /** Name of the WAV-file inside the VDFS */
+    const bs::String& soundFile() const
+    {
+      return mSoundFile;
+    }
+
+    /** Distance up to which the sound can be heard, in meters */
+    float radius() const
+    {
+      return mRadius;
+    }
+
+    /** Between 0 and 1 */
+    float volume() const
+    {
+      return mVolume;
+    }
+
+    Mode mode() const
+    {
+      return mMode;
+    }
+
+    float randomDelay() const
+    {
+      return mRandomDelay;
+    }
+
+    float randomDelayVariance() const
+    {
+      return mRandomDelayVariance;
+    }
+
+  private:
+    bs::String mSoundFile;
+    float mRadius              = 0.0f;
+    float mVolume              = 1.0f;
+    Mode mMode                 = Mode::Loop;
+    float mRandomDelay         = 0.0f;
+    float mRandomDelayVariance = 0.0f;
+
+  public:
+    REGOTH_DECLARE_RTTI(AmbientSound)
+
+  protected:
+    AmbientSound() = default;  // For RTTI
+  };
+}  // namespace REGoth
@@ -9,9 +9,13 @@
 
 namespace REGoth
 {
+  /** Side length of the grid cells anchors are sorted into, in meters */
+  constexpr float ANCHOR_GRID_CELL_SIZE = 25.0f;
+
   AnchoredTextLabels::AnchoredTextLabels(const bs::HSceneObject& parent, const bs::HGUIWidget& gui)
       : Component(parent)
       , mGui(gui)
+      , mAnchorGrid(ANCHOR_GRID_CELL_SIZE)
       , mMaximumDistance(std::numeric_limits<float>::max())
   {
     // Set a name for the component, so we can find it later if needed
@@ -30,20 +34,19 @@ namespace REGoth
     {
       bs::GUIPanel* mainPanel = mGui->getPanel();
 
-      for (const auto& anchoredLabel : mLabels)
+      for (const auto& pooled : mLabelPool)
       {
-        mainPanel->removeElement(anchoredLabel.mLabel);
+        mainPanel->removeElement(pooled.mLabel);
       }
     }
   }
 
   void AnchoredTextLabels::addLabel(const bs::Vector3& anchorPosition, const bs::HString& text)
   {
-    bs::GUILabel* label = bs::GUILabel::create(text);
-    mLabels.emplace_back(AnchoredLabel{anchorPosition, label});
+    AnchorIndex index = {mAnchors.size()};
 
-    bs::GUIPanel* mainPanel = mGui->getPanel();
-    mainPanel->addElement(label);
+    mAnchors.emplace_back(Anchor{anchorPosition, text});
+    mAnchorGrid.insert(index, anchorPosition);
   }
 
   void AnchoredTextLabels::setMaximumDistance(float maximumDistance)
@@ -59,20 +62,53 @@ namespace REGoth
 
     const bs::Transform& cameraTransform = camera->getTransform();
 
-    for (const auto& anchoredLabel : mLabels)
+    // Looks at all anchors if there is no maximum distance
+    mAnchorGrid.findInRange(cameraTransform.getPosition(), mMaximumDistance, mNearbyAnchors);
+
+    size_t numShown = 0;
+
+    for (AnchorIndex index : mNearbyAnchors)
     {
+      const Anchor& anchor = mAnchors[index.mIndex];
+
       // Only show labels with an anchor point in front of the camera
-      if (isPointWithinForwardDrawDistance(cameraTransform, anchoredLabel.mWorldPosition))
-      {
-        auto anchorPointOnScreen = camera->worldToScreenPoint(anchoredLabel.mWorldPosition);
-        anchoredLabel.mLabel->setPosition(anchorPointOnScreen.x, anchorPointOnScreen.y);
-        anchoredLabel.mLabel->setVisible(true);
-      }
-      else
+      if (!isPointWithinForwardDrawDistance(cameraTransform, anchor.mWorldPosition)) continue;
+
+      PooledLabel& pooled = pooledLabel(numShown);
+
+      // Changing the content makes the GUI update its layout, so only do so when needed
+      if (pooled.mAnchorIndex != index.mIndex)
       {
-        anchoredLabel.mLabel->setVisible(false);
+        pooled.mLabel->setContent(bs::GUIContent(anchor.mText));
+        pooled.mAnchorIndex = index.mIndex;
       }
+
+      auto anchorPointOnScreen = camera->worldToScreenPoint(anchor.mWorldPosition);
+      pooled.mLabel->setPosition(anchorPointOnScreen.x, anchorPointOnScreen.y);
+      pooled.mLabel->setVisible(true);
+
+      numShown += 1;
     }
+
+    // Labels not needed anymore stay in the pool for later frames
+    for (size_t i = numShown; i < mNumLabelsShown; i++)
+    {
+      mLabelPool[i].mLabel->setVisible(false);
+    }
+
+    mNumLabelsShown = numShown;
+  }
+
+  AnchoredTextLabels::PooledLabel& AnchoredTextLabels::pooledLabel(size_t n)
+  {
+    if (n < mLabelPool.size()) return mLabelPool[n];
+
+    bs::GUILabel* label = bs::GUILabel::create(bs::HString());
+    mGui->getPanel()->addElement(label);
+
+    mLabelPool.emplace_back(PooledLabel{label, std::numeric_limits<bs::UINT64>::max()});
+
+    return mLabelPool.back();
   }
 
   bool AnchoredTextLabels::isPointWithinForwardDrawDistance(const bs::Transform& cameraTransform,
@@ -85,7 +121,7 @@ namespace REGoth
 
     bool isInFrontOfCamera = positionalDifference.dot(cameraForward) > 0.f;
     bool isWithinDistance =
-        positionalDifference.isZeroLength() || positionalDifference.length() <= mMaximumDistance;
+        positionalDifference.squaredLength() <= mMaximumDistance * mMaximumDistance;
 
     return isInFrontOfCamera && isWithinDistance;
   }
@@ -3,12 +3,18 @@
 #include <BsPrerequisites.h>
 #include <Math/BsVector3.h>
 #include <Scene/BsComponent.h>
+#include <world/SpatialHash.hpp>
 
 namespace REGoth
 {
   /**
    * Component that manages a set of text labels which are anchored at 3D world positions
    * and drawn to the GUI widget component of the parent scene object.
+   *
+   * Anchors are kept inside a SpatialHash, so only the ones within the maximum distance of
+   * the camera are looked at each frame. GUI labels are only created for the anchors actually
+   * on screen and are handed to other anchors once theirs go out of view, so there can be
+   * many more anchors than labels.
    */
   class AnchoredTextLabels : public bs::Component
   {
@@ -31,17 +37,54 @@ namespace REGoth
     void update() override;
 
   private:
-    struct AnchoredLabel
+    struct Anchor
     {
       bs::Vector3 mWorldPosition;
+      bs::HString mText;
+    };
+
+    /**
+     * Index into mAnchors, wrapped so it can be stored inside the SpatialHash.
+     */
+    struct AnchorIndex
+    {
+      bs::UINT64 mIndex;
+
+      bs::UINT64 getInstanceId() const
+      {
+        return mIndex;
+      }
+    };
+
+    /**
+     * A label of the pool and which anchor it currently shows.
+     */
+    struct PooledLabel
+    {
       bs::GUILabel* mLabel;
+      bs::UINT64 mAnchorIndex;
     };
 
     bool isPointWithinForwardDrawDistance(const bs::Transform& cameraTransform,
                                           const bs::Vector3& point) const;
 
+    /**
+     * @return The label to use for the n-th visible anchor of this frame, created if the pool
+     *         doesn't have enough yet.
+     */
+    PooledLabel& pooledLabel(size_t n);
+
     bs::HGUIWidget mGui;
-    bs::Vector<AnchoredLabel> mLabels;
+    bs::Vector<Anchor> mAnchors;
+    SpatialHash<AnchorIndex> mAnchorGrid;
+
+    /** Anchors near the camera, reused every frame to not allocate */
+    bs::Vector<AnchorIndex> mNearbyAnchors;
+
+    bs::Vector<PooledLabel> mLabelPool;
+
+    /** How many labels of the pool were shown last frame */
+    size_t mNumLabelsShown = 0;
 
     float mMaximumDistance;
   };
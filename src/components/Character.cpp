@@ -9,9 +9,9 @@
 #include <components/StoryInformation.hpp>
 #include <components/VisualCharacter.hpp>
 #include <components/Waynet.hpp>
-#include <components/Waypoint.hpp>
 #include <log/logging.hpp>
 #include <scripting/ScriptVMForGameWorld.hpp>
+#include <world/PhysicsLayers.hpp>
 
 namespace REGoth
 {
@@ -24,6 +24,9 @@ namespace REGoth
 
   void Character::onInitialized()
   {
+    // Not saved, so needed after deserializing as well
+    setNotifyFlags(bs::TCF_Transform);
+
     // Only run this when we're not getting deserialized
     if (!hasInstantiatedScriptObject())
     {
@@ -34,26 +37,62 @@ namespace REGoth
       // FIXME: Assign the radius and height set via the visuals bounding box
       controller->setRadius(0.35f);
       controller->setHeight(0.5f);
+      controller->setLayer(PhysicsLayer::CHARACTERS);
 
-      auto visual    = SO()->addComponent<VisualCharacter>();
-      auto ai        = SO()->addComponent<CharacterAI>(gameWorld());
-      auto inventory = SO()->addComponent<Inventory>();
+      mVisual    = SO()->addComponent<VisualCharacter>();
+      mAI        = SO()->addComponent<CharacterAI>(gameWorld());
+      mInventory = SO()->addComponent<Inventory>(gameWorld());
 
-      auto eventQueue =
-          SO()->addComponent<CharacterEventQueue>(thisCharacter, ai, visual, gameWorld());
+      mEventQueue =
+          SO()->addComponent<CharacterEventQueue>(thisCharacter, mAI, mVisual, gameWorld());
 
       ScriptBackedBy::onInitialized();
 
       // Needs a valid script object to initialize
-      auto infos = SO()->addComponent<StoryInformation>(gameWorld(), thisCharacter);
+      mStoryInformation = SO()->addComponent<StoryInformation>(gameWorld(), thisCharacter);
 
       // If we don't init the routine now, the character won't have its default routine
       // Must also come *after* the script object has been created since this might run
       // some scripts.
-      eventQueue->reinitRoutine();
+      mEventQueue->reinitRoutine();
+    }
+    else
+    {
+      findOwnComponents();
     }
   }
 
+  void Character::findOwnComponents()
+  {
+    mAI               = SO()->getComponent<CharacterAI>();
+    mEventQueue       = SO()->getComponent<CharacterEventQueue>();
+    mInventory        = SO()->getComponent<Inventory>();
+    mStoryInformation = SO()->getComponent<StoryInformation>();
+    mVisual           = SO()->getComponent<VisualCharacter>();
+  }
+
+  void Character::onDestroyed()
+  {
+    HGameWorld world = gameWorld();
+
+    if (world && !world.isDestroyed())
+    {
+      world->onCharacterDestroyed(bs::static_object_cast<Character>(getHandle()));
+    }
+
+    ScriptBackedBy::onDestroyed();
+  }
+
+  void Character::onTransformChanged(bs::TransformChangedFlags flags)
+  {
+    HGameWorld world = gameWorld();
+
+    // Might not be set up yet while deserializing
+    if (!world || world.isDestroyed()) return;
+
+    world->onCharacterMoved(bs::static_object_cast<Character>(getHandle()));
+  }
+
   void Character::useAsHero()
   {
     gameWorld()->scriptVM().setHero(scriptObject());
@@ -170,7 +209,7 @@ namespace REGoth
 
       bs::String functionName = "RTN_" + newDailyRoutine + "_" + bs::toString(id);
 
-      REGOTH_LOG(Info, Uncategorized, "[Character] Set Routine of {0} to {1}", SO()->getName(),
+      REGOTH_LOG(Info, AI, "[Character] Set Routine of {0} to {1}", SO()->getName(),
                  functionName);
 
       const auto& fn =
@@ -198,22 +237,44 @@ namespace REGoth
     return scriptObjectData().stringValue("WP");
   }
 
+  bs::INT32 Character::senses() const
+  {
+    return scriptObjectData().intValue("SENSES");
+  }
+
+  float Character::sensesRange() const
+  {
+    // Scripts use centimeters
+    return scriptObjectData().intValue("SENSES_RANGE") / 100.0f;
+  }
+
+  bs::INT32 Character::voice() const
+  {
+    return scriptObjectData().intValue("VOICE");
+  }
+
   bs::String Character::getNextWaypoint()
   {
     const bs::Vector3& pos = SO()->getTransform().pos();
 
-    auto wp = gameWorld()->waynet()->findClosestWaypointTo(pos).secondClosest;
+    HWaynet waynet   = gameWorld()->waynet();
+    WaypointIndex wp = waynet->findClosestWaypointTo(pos).secondClosest;
+
+    if (wp == NO_WAYPOINT) return "";
 
-    return wp->SO()->getName();
+    return waynet->waypointName(wp);
   }
 
   bs::String Character::getNearestWaypoint()
   {
     const bs::Vector3& pos = SO()->getTransform().pos();
 
-    auto wp = gameWorld()->waynet()->findClosestWaypointTo(pos).closest;
+    HWaynet waynet   = gameWorld()->waynet();
+    WaypointIndex wp = waynet->findClosestWaypointTo(pos).closest;
+
+    if (wp == NO_WAYPOINT) return "";
 
-    return wp->SO()->getName();
+    return waynet->waypointName(wp);
   }
 
   void Character::exchangeRoutine(const bs::String& routineName)
@@ -281,16 +342,17 @@ namespace REGoth
 
   float Character::getDistanceToWaypoint(const bs::String& waypoint) const
   {
-    HWaypoint wp = gameWorld()->waynet()->findWaypoint(waypoint);
+    HWaynet waynet   = gameWorld()->waynet();
+    WaypointIndex wp = waynet->findWaypoint(waypoint);
 
-    if (!wp)
+    if (wp == NO_WAYPOINT)
     {
-      REGOTH_LOG(Warning, Uncategorized,
+      REGOTH_LOG(Warning, AI,
                  "[Character] Waypoint {0} does not exist! (getDistanceToWaypoint)", waypoint);
       return -1.0f;
     }
 
-    return getDistanceToObject(wp->SO());
+    return SO()->getTransform().pos().distance(waynet->waypointPosition(wp));
   }
 
   bool Character::isNearCharacter(HCharacter other) const
@@ -307,12 +369,12 @@ namespace REGoth
     return p1.distance(p2);
   }
 
-  const bs::Vector<Scripting::ScriptObjectHandle>& Character::allInfosForThisCharacter() const
+  Scripting::DialogueInfoSpan Character::allInfosForThisCharacter() const
   {
-    return scriptVM().allInfosOfNpc(scriptObjectData().instanceName);
+    return scriptVM().dialogueInfosOfNpc(scriptObjectData().instanceName);
   }
 
-  bs::Vector<HCharacter> Character::findCharactersInRange(float range) const
+  ScratchVector<HCharacter> Character::findCharactersInRange(float range) const
   {
     return gameWorld()->findCharactersInRange(range, SO()->getTransform().pos());
   }
@@ -1,12 +1,29 @@
 #pragma once
 #include "ScriptBackedBy.hpp"
 #include <BsPrerequisites.h>
+#include <core/FrameScratch.hpp>
+#include <scripting/DialogueInfo.hpp>
 
 namespace REGoth
 {
   class Character;
   using HCharacter = bs::GameObjectHandle<Character>;
 
+  class CharacterAI;
+  using HCharacterAI = bs::GameObjectHandle<CharacterAI>;
+
+  class CharacterEventQueue;
+  using HCharacterEventQueue = bs::GameObjectHandle<CharacterEventQueue>;
+
+  class Inventory;
+  using HInventory = bs::GameObjectHandle<Inventory>;
+
+  class StoryInformation;
+  using HStoryInformation = bs::GameObjectHandle<StoryInformation>;
+
+  class VisualCharacter;
+  using HVisualCharacter = bs::GameObjectHandle<VisualCharacter>;
+
   /**
    * Character logic. Implements most of the * externals.
    */
@@ -16,6 +33,42 @@ namespace REGoth
     Character(const bs::HSceneObject& parent, const bs::String& instance, HGameWorld gameWorld);
 
     void onInitialized() override;
+    void onDestroyed() override;
+
+    /**
+     * Lets the world know where this character is now, see GameWorld::onCharacterMoved().
+     */
+    void onTransformChanged(bs::TransformChangedFlags flags) override;
+
+    /**
+     * The other components every character has. Looked up once when the character is
+     * initialized, so these don't have to search through the components of the scene object
+     * like `getComponent<>()` does.
+     */
+    HCharacterAI ai() const
+    {
+      return mAI;
+    }
+
+    HCharacterEventQueue eventQueue() const
+    {
+      return mEventQueue;
+    }
+
+    HInventory inventory() const
+    {
+      return mInventory;
+    }
+
+    HStoryInformation storyInformation() const
+    {
+      return mStoryInformation;
+    }
+
+    HVisualCharacter visual() const
+    {
+      return mVisual;
+    }
 
     /**
      * Registers this character as the hero. The hero will most likely be the player,
@@ -94,6 +147,22 @@ namespace REGoth
      */
     void setCurrentWaypoint(const bs::String& waypoint);
 
+    /**
+     * @return What this character can sense, as bits of `C_NPC.senses`, see AI::Sense.
+     */
+    bs::INT32 senses() const;
+
+    /**
+     * @return How far this character can sense, in meters.
+     */
+    float sensesRange() const;
+
+    /**
+     * @return Voice this character speaks with, as index of the SVM-instance of the voice, see
+     *         Scripting::SvmTable.
+     */
+    bs::INT32 voice() const;
+
     /**
      * @return On monsters, this will return the AI-state the monster should
      *         automatically start after spawning.
@@ -359,21 +428,37 @@ namespace REGoth
     bool checkInfo(bool important);
 
     /**
-     * All *Information*-Instances for this Character. See DaedalusVMForGameWorld::allInfosOfNpc().
+     * All *Information*-Instances for this Character. See
+     * DaedalusVMForGameWorld::dialogueInfosOfNpc().
      *
      * This is more like raw data. Use the `StoryInformation`-component to actually work with these.
      */
-    const bs::Vector<Scripting::ScriptObjectHandle>& allInfosForThisCharacter() const;
+    Scripting::DialogueInfoSpan allInfosForThisCharacter() const;
 
     /**
      * Returns a list of all characters standing near this character, in the specified range.
      *
-     * @note This list will also include this character!
+     * @note This list will also include this character! It lives in frame memory, see
+     *       GameWorld::findCharactersInRange().
      */
-    bs::Vector<HCharacter> findCharactersInRange(float range) const;
+    ScratchVector<HCharacter> findCharactersInRange(float range) const;
 
     bs::INT32 GetStateTime();
 
+  private:
+    /**
+     * Fills the handles returned by ai(), eventQueue() and so on after loading. New
+     * characters keep the handles of the components they create.
+     */
+    void findOwnComponents();
+
+    // Not saved, found again after loading
+    HCharacterAI mAI;
+    HCharacterEventQueue mEventQueue;
+    HInventory mInventory;
+    HStoryInformation mStoryInformation;
+    HVisualCharacter mVisual;
+
   public:
     REGOTH_DECLARE_RTTI(Character);
 
@@ -2,15 +2,14 @@
 #include <Components/BsCCamera.h>
 #include <Components/BsCCharacterController.h>
 #include <RTTI/RTTI_CharacterAI.hpp>
-#include <Scene/BsSceneManager.h>
 #include <Scene/BsSceneObject.h>
-#include <animation/StateNaming.hpp>
 #include <components/Character.hpp>
 #include <components/GameWorld.hpp>
 #include <components/StoryInformation.hpp>
 #include <components/VisualCharacter.hpp>
 #include <exception/Throw.hpp>
 #include <log/logging.hpp>
+#include <scripting/ScriptVMForGameWorld.hpp>
 
 namespace REGoth
 {
@@ -20,24 +19,20 @@ namespace REGoth
   /** Multiplicator of how fast the character can turn while holding a weapon. */
   constexpr float TURN_SPEED_MULTIPLICATOR_WITH_WEAPON = 2.0f;
 
-  /**
-   * How far away the character can be from the camera until it should disable physics.
-   * Must be larger than the range which activates physics again, ACTIVATE_PHYSICS_RANGE_METERS.
-   * See https://regoth-project.github.io/REGoth-bs/content/characters.html
-   *
-   * TODO: Make this configurable.
-   */
-  constexpr float DEACTIVATE_PHYSICS_RANGE_METERS = 45.0;
-
-  /** See DEACTIVATE_PHYSICS_RANGE_METERS */
-  constexpr float ACTIVATE_PHYSICS_RANGE_METERS = 40.0;
-
   /** Acceleration of the Y-Axis while falling */
   constexpr float FALLING_ACCELERATION_Y = -9.81f;
 
   /** Constant velocity to apply downwards to keep the player on the ground */
   constexpr float DOWNWARDS_VELOCITY_WHILE_WALKING = -10.0f;
 
+  /** How fast characters without physics move towards their target (Meters/Second) */
+  constexpr float KINEMATIC_SPEED_RUN   = 3.0f;
+  constexpr float KINEMATIC_SPEED_WALK  = 1.5f;
+  constexpr float KINEMATIC_SPEED_SNEAK = 1.0f;
+
+  /** How often a character idling on solid ground checks whether it is still there (Seconds) */
+  constexpr float GROUND_CHECK_INTERVAL = 1.0f;
+
   CharacterAI::CharacterAI(const bs::HSceneObject& parent, HGameWorld world)
       : bs::Component(parent)
       , mWorld(world)
@@ -61,6 +56,16 @@ namespace REGoth
           bs::StringUtil::format("Scene Object {0} does not have a CCharacterController component!",
                                  SO()->getName()));
     }
+
+    // Spread the checks of characters created together over the interval
+    mTimeUntilGroundCheck = GROUND_CHECK_INTERVAL * (float)(SO()->getInstanceId() % 16) / 16.0f;
+  }
+
+  void CharacterAI::onInitialized()
+  {
+    bs::Component::onInitialized();
+
+    mWorld->registerCharacterAI(bs::static_object_cast<CharacterAI>(getHandle()));
   }
 
   void CharacterAI::deactivatePhysics()
@@ -71,28 +76,14 @@ namespace REGoth
   void CharacterAI::activatePhysics()
   {
     mIsPhysicsActive = true;
-  }
-
-  bool CharacterAI::shouldDisablePhysics() const
-  {
-    const auto& mainCamera     = bs::gSceneManager().getMainCamera();
-    const auto& cameraPosition = mainCamera->getTransform().pos();
-    const auto& soPosition     = SO()->getTransform().pos();
 
-    float maxRangeSq = DEACTIVATE_PHYSICS_RANGE_METERS * DEACTIVATE_PHYSICS_RANGE_METERS;
-
-    return cameraPosition.squaredDistance(soPosition) > maxRangeSq;
+    // Might have been teleported or the world changed while physics was off
+    wakePhysics();
   }
 
-  bool CharacterAI::shouldEnablePhysics() const
+  void CharacterAI::wakePhysics()
   {
-    const auto& mainCamera     = bs::gSceneManager().getMainCamera();
-    const auto& cameraPosition = mainCamera->getTransform().pos();
-    const auto& soPosition     = SO()->getTransform().pos();
-
-    float minRangeSq = ACTIVATE_PHYSICS_RANGE_METERS * ACTIVATE_PHYSICS_RANGE_METERS;
-
-    return cameraPosition.squaredDistance(soPosition) < minRangeSq;
+    mIsStandingOnSolidGround = false;
   }
 
   bool CharacterAI::isPhysicsActive() const
@@ -100,48 +91,34 @@ namespace REGoth
     return mIsPhysicsActive;
   }
 
-  void CharacterAI::handlePhysicsActivation()
+  bool CharacterAI::needsFrameRootMotion() const
   {
-    if (mIsPhysicsActive)
-    {
-      if (shouldDisablePhysics())
-      {
-        deactivatePhysics();
-
-        REGOTH_LOG(Info, Uncategorized, "[CharacterAI] Deactivate physics on {0}", SO()->getName());
-      }
-    }
-    else
-    {
-      if (shouldEnablePhysics())
-      {
-        activatePhysics();
+    if (!mIsPhysicsActive) return false;
+    if (!mVisual) return false;
 
-        REGOTH_LOG(Info, Uncategorized, "[CharacterAI]   Activate physics on {0}", SO()->getName());
-      }
-    }
+    return !mVisual->isPlayingIdleAnimation();
   }
 
   bool CharacterAI::goForward()
   {
-    bs::String anim = AnimationState::constructStateAnimationName(mWeaponMode, mWalkMode, "L");
-
-    return tryTransitionToState("L");
+    return tryTransitionToLocomotion(Locomotion::Forward);
   }
 
   bool CharacterAI::goBackward()
   {
     // Some movement states have an explict state for moving back. The default
     // running state does not.
-    if (doesStateExist("BL"))
+    if (doesLocomotionExist(Locomotion::Backward))
     {
-      return tryTransitionToState("BL");
+      return tryTransitionToLocomotion(Locomotion::Backward);
     }
     else
     {
       if (!isStateSwitchAllowed()) return false;
 
-      return tryPlayTransitionAnimationTo("T_JUMPB");
+      const AnimationTable* table = mVisual->animationTable();
+
+      return table && tryPlayClip(table->jumpBackClip());
     }
 
     return false;
@@ -149,36 +126,28 @@ namespace REGoth
 
   bool CharacterAI::strafeLeft()
   {
-    if (!isStateSwitchAllowed()) return false;
-
-    switch (mWalkMode)
-    {
-      case AI::WalkMode::Run:
-        return tryPlayTransitionAnimationTo("T_RUNSTRAFEL");
-      case AI::WalkMode::Walk:
-        return tryPlayTransitionAnimationTo("T_WALKSTRAFEL");
-      case AI::WalkMode::Sneak:
-        return tryPlayTransitionAnimationTo("T_SNEAKSTRAFEL");
-      default:
-        return false;
-    }
+    return strafe(StrafeDirection::Left);
   }
 
   bool CharacterAI::strafeRight()
+  {
+    return strafe(StrafeDirection::Right);
+  }
+
+  bool CharacterAI::strafe(StrafeDirection direction)
   {
     if (!isStateSwitchAllowed()) return false;
 
-    switch (mWalkMode)
-    {
-      case AI::WalkMode::Run:
-        return tryPlayTransitionAnimationTo("T_RUNSTRAFER");
-      case AI::WalkMode::Walk:
-        return tryPlayTransitionAnimationTo("T_WALKSTRAFER");
-      case AI::WalkMode::Sneak:
-        return tryPlayTransitionAnimationTo("T_SNEAKSTRAFER");
-      default:
-        return false;
-    }
+    const AnimationTable* table = mVisual->animationTable();
+
+    if (!table) return false;
+
+    // Only running, walking and sneaking have clips for it
+    HZAnimationClip clip = table->strafeClip(mWalkMode, direction);
+
+    if (!clip) return false;
+
+    return tryPlayClip(clip);
   }
 
   bool CharacterAI::turnLeft()
@@ -200,11 +169,13 @@ namespace REGoth
 
   bool CharacterAI::stopMoving()
   {
-    if (tryTransitionToState("")) return true;
+    if (tryTransitionToLocomotion(Locomotion::Stand)) return true;
+
+    const AnimationTable* table = mVisual->animationTable();
 
     // The "STAND" state doesn't really exist but some animation reference it, like
     // the animation "T_JUMP_2_STAND".
-    if (tryPlayTransitionAnimationTo("S_STAND")) return true;
+    if (table && tryTransitionToState(table->standState())) return true;
 
     return false;
   }
@@ -226,25 +197,24 @@ namespace REGoth
     if (!isStateSwitchAllowed()) return false;
     if (mIsInAir) return false;
 
-    return tryPlayTransitionAnimationTo("S_JUMP");
+    const AnimationTable* table = mVisual->animationTable();
+
+    return table && tryTransitionToState(table->jumpState());
   }
 
-  bool CharacterAI::tryPlayTransitionAnimationTo(const bs::String& anim)
+  bool CharacterAI::tryTransitionToState(AnimationStateIndex state)
   {
     // Cannot play animations if the character has no model yet
     if (!mVisual->hasVisual()) return false;
 
-    bs::String playingNow = mVisual->getPlayingAnimationName();
-    auto clipPlayingNow   = mVisual->findAnimationClip(playingNow);
+    auto clipPlayingNow = mVisual->playingClip();
 
-    bs::String animToPlay = mVisual->findAnimationToTransitionTo(anim);
-    auto clip             = mVisual->findAnimationClip(animToPlay);
+    auto clip = mVisual->findClipToTransitionTo(state);
 
     // Already in target anim
     if (clip == clipPlayingNow) return true;
 
     // If there is no clip, then the transition isn't meant to be possible.
-    // That also includes the empty string.
     if (!clip)
     {
       // However, some animations refer to a special "Stand" anim, which doesn't exist
@@ -252,8 +222,7 @@ namespace REGoth
       // or walking mode.
       if (isStanding())
       {
-        animToPlay = mVisual->findAnimationToTransitionTo("S_STAND", anim);
-        clip       = mVisual->findAnimationClip(animToPlay);
+        clip = mVisual->findClipToTransitionTo(mVisual->animationTable()->standState(), state);
       }
     }
 
@@ -267,47 +236,71 @@ namespace REGoth
     return true;
   }
 
-  bool CharacterAI::tryTransitionToState(const bs::String& state)
+  bool CharacterAI::tryPlayClip(HZAnimationClip clip)
   {
-    if (!isStateSwitchAllowed()) return false;
+    // Cannot play animations if the character has no model yet
+    if (!mVisual->hasVisual()) return false;
+
+    // Already in target anim
+    if (clip == mVisual->playingClip()) return true;
+
+    if (!clip) return false;
+
+    if (!mVisual->isAnimationPlaying(clip))
+    {
+      mVisual->playAnimationClip(clip);
+    }
 
-    bs::String anim = AnimationState::constructStateAnimationName(mWeaponMode, mWalkMode, state);
+    return true;
+  }
+
+  bool CharacterAI::tryTransitionToLocomotion(Locomotion locomotion)
+  {
+    if (!isStateSwitchAllowed()) return false;
 
-    return tryPlayTransitionAnimationTo(anim);
+    return tryTransitionToState(locomotionState(mWeaponMode, mWalkMode, locomotion));
   }
 
-  bool CharacterAI::doesStateExist(const bs::String& state) const
+  AnimationStateIndex CharacterAI::locomotionState(AI::WeaponMode weaponMode,
+                                                   AI::WalkMode walkMode,
+                                                   Locomotion locomotion) const
   {
-    bs::String anim = AnimationState::constructStateAnimationName(mWeaponMode, mWalkMode, state);
+    const AnimationTable* table = mVisual->animationTable();
+
+    if (!table) return ANIMATION_STATE_INVALID;
 
-    return mVisual->findAnimationClip(anim);
+    return table->locomotionState(weaponMode, walkMode, locomotion);
   }
 
-  bool CharacterAI::isStanding() const
+  bool CharacterAI::doesLocomotionExist(Locomotion locomotion) const
   {
-    bs::String currentAnimation = mVisual->getPlayingAnimationName();
-    bs::String currentState     = AnimationState::getStateName(currentAnimation);
+    const AnimationTable* table = mVisual->animationTable();
 
-    if (currentState == "RUN") return true;
+    if (!table) return false;
 
-    if (currentState == "WALK") return true;
+    return table->stateClip(locomotionState(mWeaponMode, mWalkMode, locomotion));
+  }
 
-    return false;
+  bool CharacterAI::isStanding() const
+  {
+    return mVisual->playingClipRecord().isStanding;
   }
 
   bool CharacterAI::isStateSwitchAllowed()
   {
-    mVisual                = SO()->getComponent<VisualCharacter>();
-    bs::String playingAnim = mVisual->getPlayingAnimationName();
+    mVisual = SO()->getComponent<VisualCharacter>();
 
-    if (playingAnim.empty()) return true;
+    // Nothing is playing while the visual is still loading
+    if (!mVisual->hasVisual()) return true;
 
-    bs::String state = AnimationState::getStateName(playingAnim);
+    if (!mVisual->playingClip()) return true;
+
+    const AnimationClipRecord& playing = mVisual->playingClipRecord();
 
     // Playing some weird animation we don't know the naming scheme for?
-    if (state.empty()) return false;
+    if (!playing.hasStateName) return false;
 
-    if (!mVisual->isPlayingAnimationInterruptable()) return false;
+    if (!playing.isInterruptable) return false;
 
     return true;
   }
@@ -338,6 +331,42 @@ namespace REGoth
     return isAtPosition(position);
   }
 
+  void CharacterAI::moveKinematicTowards(const bs::Vector3& position)
+  {
+    float speed = KINEMATIC_SPEED_RUN;
+
+    switch (mWalkMode)
+    {
+      case AI::WalkMode::Walk:
+        speed = KINEMATIC_SPEED_WALK;
+        break;
+
+      case AI::WalkMode::Sneak:
+        speed = KINEMATIC_SPEED_SNEAK;
+        break;
+
+      default:
+        break;
+    }
+
+    const bs::Vector3 positionNow = SO()->getTransform().pos();
+    const bs::Vector3 toTarget    = position - positionNow;
+
+    float distance = toTarget.length();
+    float step     = speed * bs::gTime().getFixedFrameDelta();
+
+    instantTurnToPosition(position);
+
+    if (distance <= step)
+    {
+      SO()->setPosition(position);
+    }
+    else
+    {
+      SO()->setPosition(positionNow + toTarget * (step / distance));
+    }
+  }
+
   bool CharacterAI::isAtPosition(const bs::Vector3& position)
   {
     return (SO()->getTransform().pos() - position).length() < 0.5f;
@@ -350,14 +379,17 @@ namespace REGoth
 
   void CharacterAI::fixedUpdate()
   {
-    handlePhysicsActivation();
+    // pass
+  }
 
+  void CharacterAI::processFixedUpdate()
+  {
     if (!mIsPhysicsActive)
     {
       return;
     }
 
-    if (isTurningAllowed())
+    if (isTurningAllowed() && !mIsTurningPerFrame)
     {
       handleTurning();
     }
@@ -366,8 +398,9 @@ namespace REGoth
 
     bs::Vector3 rootMotion = bs::Vector3::ZERO;
 
-    if (!mVisual->isPlayingIdleAnimation())
+    if (needsFrameRootMotion())
     {
+      // Usually resolved by the RootMotionStage of the world already
       rootMotion = mVisual->resolveFrameRootMotion();
 
       // Rotate by the scene objects rotation
@@ -378,6 +411,17 @@ namespace REGoth
       rootMotion *= -1.0;
     }
 
+    if (!needsToUpdatePhysics(rootMotion))
+    {
+      // Something might have moved the ground away, e.g. a mover
+      mTimeUntilGroundCheck -= bs::gTime().getFixedFrameDelta();
+
+      if (mTimeUntilGroundCheck > 0.0f) return;
+
+      mTimeUntilGroundCheck += GROUND_CHECK_INTERVAL;
+      wakePhysics();
+    }
+
     if (needsToUpdatePhysics(rootMotion))
     {
       const float frameDelta = bs::gTime().getFixedFrameDelta();
@@ -417,7 +461,14 @@ namespace REGoth
     return false;
   }
 
-  void CharacterAI::handleTurning()
+  void CharacterAI::turnForFrame(float frameDeltaSeconds)
+  {
+    if (!mIsTurningPerFrame || !mIsPhysicsActive || !isTurningAllowed()) return;
+
+    handleTurning(frameDeltaSeconds / bs::gTime().getFixedFrameDelta());
+  }
+
+  void CharacterAI::handleTurning(float numFixedUpdates)
   {
     float frameTurn = 0.0f;
 
@@ -436,6 +487,8 @@ namespace REGoth
         break;
     }
 
+    frameTurn *= numFixedUpdates;
+
     if (fabs(frameTurn) > 0.0001f)
     {
       SO()->rotate(bs::Vector3::UNIT_Y, bs::Radian(frameTurn));
@@ -464,22 +517,25 @@ namespace REGoth
 
   void CharacterAI::teleport(const bs::String& waypoint)
   {
-    bs::HSceneObject so = mWorld->findObjectByName(waypoint);
+    bs::Transform transform;
 
-    if (!so)
+    if (!mWorld->findSpawnPoint(waypoint, transform))
     {
       // Usually we would throw here, but Gothic has some invalid waypoints inside it's scripts
       // so we would break the original games if we did that. Resort to a warning for those,
       // better than nothing, I guess.
-      REGOTH_LOG(Warning, Uncategorized,
+      REGOTH_LOG(Warning, AI,
                  "[CharacterAI] Teleport failed, waypoint doesn't exist: {0}", waypoint);
       return;
     }
 
-    SO()->setPosition(so->getTransform().pos());
+    SO()->setPosition(transform.pos());
+
+    // The new position might not be on the ground
+    wakePhysics();
 
     // Turn the same way the waypoint is oriented, but have the character keep looking forward
-    bs::Vector3 forwardCenterd = so->getTransform().getForward();
+    bs::Vector3 forwardCenterd = transform.getForward();
 
     forwardCenterd.y = 0;
     forwardCenterd.normalize();
@@ -530,9 +586,9 @@ namespace REGoth
 
   bool CharacterAI::changeWalkMode(AI::WalkMode walkMode)
   {
-    bs::String stateTarget = AnimationState::constructStateAnimationName(mWeaponMode, walkMode, "");
+    AnimationStateIndex stateTarget = locomotionState(mWeaponMode, walkMode, Locomotion::Stand);
 
-    bool wasAllowed = tryPlayTransitionAnimationTo(stateTarget);
+    bool wasAllowed = tryTransitionToState(stateTarget);
 
     if (wasAllowed)
     {
@@ -558,9 +614,9 @@ namespace REGoth
     {
       // Model exists, check if the state transition is possible
 
-      bs::String stateTarget = AnimationState::constructStateAnimationName(mode, mWalkMode, "");
+      AnimationStateIndex stateTarget = locomotionState(mode, mWalkMode, Locomotion::Stand);
 
-      bool wasAllowed = tryPlayTransitionAnimationTo(stateTarget);
+      bool wasAllowed = tryTransitionToState(stateTarget);
 
       if (wasAllowed)
       {
@@ -572,7 +628,7 @@ namespace REGoth
         // FIXME: We're missing some aniAliases, for example, "T_RUN_2_SNEAK" exists,
         //        and "T_SNEAK_2_RUN" is just the same animation but in reverse. This
         //        is defined using an aniAlias, which does not seem to be implemented.
-        auto c = mVisual->findAnimationClip(stateTarget);
+        auto c = mVisual->animationTable()->stateClip(stateTarget);
 
         if (c)
         {
@@ -649,6 +705,19 @@ namespace REGoth
 
   void CharacterAI::output(bs::HSceneObject characterSO, const bs::String& svmName)
   {
+    HCharacter self = SO()->getComponent<Character>();
+
+    const Scripting::SvmTable& svms = mWorld->scriptVM().svmTable();
+    const bs::String& outputName    = svms.outputName(self->voice(), svms.findKey(svmName));
+
+    if (outputName.empty())
+    {
+      REGOTH_LOG(Warning, AI, "[CharacterAI] {0} has nothing to say for {1} with voice {2}",
+                 SO()->getName(), svmName, self->voice());
+      return;
+    }
+
+    self->eventQueue()->pushOutput(characterSO, outputName);
   }
 
   void CharacterAI::processInfos()
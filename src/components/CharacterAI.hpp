@@ -5,6 +5,7 @@
 #include <AI/WalkMode.hpp>
 #include <AI/WeaponMode.hpp>
 #include <RTTI/RTTIUtil.hpp>
+#include <animation/AnimationTable.hpp>
 
 namespace REGoth
 {
@@ -28,6 +29,9 @@ namespace REGoth
      *
      * During physics sleep, no movement is being calculated and applied to the
      * Character-Controller. To enable physics again, see activatePhysics().
+     *
+     * Usually done by the SectorActivation of the world, depending on how far away the
+     * character is from the hero.
      */
     void deactivatePhysics();
 
@@ -43,6 +47,29 @@ namespace REGoth
      */
     bool isPhysicsActive() const;
 
+    /**
+     * Makes the character controller look for the ground again on the next fixed update.
+     *
+     * A character standing idle on solid ground is not moved by its controller at all. Call
+     * this after moving the character by other means than the controller, or if the ground
+     * below it might have changed.
+     */
+    void wakePhysics();
+
+    /**
+     * @return Whether the next fixed update is going to move the character by the root motion
+     *         of its animation. See RootMotionStage.
+     */
+    bool needsFrameRootMotion() const;
+
+    /**
+     * @return The visual this character is animated by.
+     */
+    HVisualCharacter visual() const
+    {
+      return mVisual;
+    }
+
     /**
      * Virtual input to the character. Calling these functions is equivalent to
      * holding down a button on the keyboard. If `goForward` is called, the Character
@@ -108,6 +135,17 @@ namespace REGoth
      */
     bool gotoPositionStraight(const bs::Vector3& position);
 
+    /**
+     * Moves the character a fixed update closer to the given position in a straight line,
+     * without physics or animations. Used for characters whose physics are turned off, since
+     * they are too far away from the hero, see deactivatePhysics().
+     *
+     * The speed depends on the walk mode. The character is not moved past the position.
+     *
+     * @param  position  Position to go to.
+     */
+    void moveKinematicTowards(const bs::Vector3& position);
+
     /**
      * Checks whether the character is at the given postiion.
      *
@@ -126,8 +164,37 @@ namespace REGoth
 
     // Component -----------------------------------------------------------------------------------
 
+    void onInitialized() override;
+
+    /**
+     * Does nothing, the GameWorld moves all characters in one go, right after resolving their
+     * root motion. See GameWorld::moveCharacters().
+     */
     void fixedUpdate() override;
 
+    /**
+     * Turns and moves the character by its root motion and physics, once per fixed update.
+     * Called by GameWorld::moveCharacters().
+     */
+    void processFixedUpdate();
+
+    /**
+     * Makes the character turn by turnForFrame() instead of once per fixed update, so turning
+     * follows the frame rate. Used for the hero while controlled live, see
+     * CharacterKeyboardInput.
+     */
+    void setTurningPerFrame(bool isTurningPerFrame)
+    {
+      mIsTurningPerFrame = isTurningPerFrame;
+    }
+
+    /**
+     * Turns the character in the direction set by turnLeft() or turnRight() by as much as
+     * the fixed updates during the given time would. Only does something after
+     * setTurningPerFrame().
+     */
+    void turnForFrame(float frameDeltaSeconds);
+
     // AI - Externals ------------------------------------------------------------------------------
 
     void teleport(const bs::String& waypoint);
@@ -191,40 +258,13 @@ namespace REGoth
     bool isStanding() const;
 
   private:
-    /**
-     * Checks whether the character is so far away from the player that it should
-     * deactivate physics to save some performance. Note that there exists another
-     * method for checking whether to *activate* physics again. If the character
-     * stands between the distances required for both these methods, both will
-     * return false.
-     *
-     * See https://regoth-project.github.io/REGoth-bs/content/characters.html
-     */
-    bool shouldDisablePhysics() const;
-
-    /**
-     * Checks whether the character is so close to the player that it should
-     * wake up and activate physics. Note that there exists another
-     * method for checking whether to *deactivate* physics. If the character
-     * stands between the distances required for both these methods, both will
-     * return false.
-     *
-     * See https://regoth-project.github.io/REGoth-bs/content/characters.html
-     */
-    bool shouldEnablePhysics() const;
-
-    /**
-     * Activates, deactivates or keeps the current state of whether the physics
-     * of this character are enabled. To be called every couple frames.
-     */
-    void handlePhysicsActivation();
-
     /**
      * Applies the currently set turning parameters to the character.
      *
-     * Expected to be called inside fixedUpdate().
+     * @param  numFixedUpdates  How many fixed updates worth of turning to apply, fractions
+     *                          when turning per frame. See turnForFrame().
      */
-    void handleTurning();
+    void handleTurning(float numFixedUpdates = 1.0f);
 
     /**
      * If the character is not standing on solid ground, we need to increase
@@ -241,22 +281,39 @@ namespace REGoth
     bool needsToUpdatePhysics(const bs::Vector3& rootMotion) const;
 
     /**
-     * Tries to transition to the given animation name.
-     *
-     * @param  Animation to transition to, eg `S_RUNL` or `T_JUMPB`.
+     * Tries to play a transition to reach the given state of the animation table, like the
+     * one of `S_RUNL`.
      *
      * @return true, if the transition was possible.
      */
-    bool tryPlayTransitionAnimationTo(const bs::String& anim);
+    bool tryTransitionToState(AnimationStateIndex state);
 
     /**
-     * Tries to play a transition to reach the given state.
+     * Tries to play the given clip which doesn't need a transition, like `T_JUMPB`.
      *
-     * @param Name of the state, e.g. "L"
+     * @return true, if the clip is playing now.
+     */
+    bool tryPlayClip(HZAnimationClip clip);
+
+    /**
+     * Tries to play a transition to reach the given state of moving around in the current
+     * weapon- and walk-mode.
      *
      * @return True, if the transition was possible.
      */
-    bool tryTransitionToState(const bs::String& state);
+    bool tryTransitionToLocomotion(Locomotion locomotion);
+
+    /**
+     * Steps sideways, if the walk-mode allows for it.
+     */
+    bool strafe(StrafeDirection direction);
+
+    /**
+     * @return The state of the given kind of moving around, see
+     *         AnimationTable::locomotionState(). Invalid if there is no visual yet.
+     */
+    AnimationStateIndex locomotionState(AI::WeaponMode weaponMode, AI::WalkMode walkMode,
+                                        Locomotion locomotion) const;
 
     /**
      * Checks whether the given state exists for the current combination
@@ -265,14 +322,12 @@ namespace REGoth
      * is no state for moving backwards but a single animation `T_JUMPB` is
      * played which just returns to the idle state.
      *
-     * @param  state  State name to check, e.g. "L"
-     *
      * @return Whether there are animations for the given state. For instance,
-     *         if the character is *Walking* and holding a 1-hand weapon and the
-     *         state *L* is queried, an animation with the name `S_1HWALKK` would
-     *         be searched.
+     *         if the character is *Walking* and holding a 1-hand weapon and
+     *         Locomotion::Backward is queried, the clip of `S_1HWALKBL` would
+     *         be looked up.
      */
-    bool doesStateExist(const bs::String& state) const;
+    bool doesLocomotionExist(Locomotion locomotion) const;
 
     // Visual attached to this character
     HVisualCharacter mVisual;
@@ -292,6 +347,9 @@ namespace REGoth
     // Direction the character is currently turning in
     TurnDirection mTurnDirection = TurnDirection::None;
 
+    // Whether turning is done by turnForFrame() instead of processFixedUpdate()
+    bool mIsTurningPerFrame = false;
+
     // Whether Physics is being processed for this character
     bool mIsPhysicsActive = true;
 
@@ -302,6 +360,9 @@ namespace REGoth
     // Whether this character is currently in air, not standing on anything.
     bool mIsInAir = false;
 
+    // Time until a character idling on solid ground checks whether it is still there.
+    float mTimeUntilGroundCheck = 0.0f;
+
     // Whether the character is running, sneaking, etc
     AI::WalkMode mWalkMode = AI::WalkMode::Run;
 
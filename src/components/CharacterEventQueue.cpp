@@ -2,6 +2,7 @@
 #include <AI/ScriptState.hpp>
 #include <RTTI/RTTI_CharacterEventQueue.hpp>
 #include <Scene/BsSceneObject.h>
+#include <chrono>
 #include <components/Character.hpp>
 #include <components/CharacterAI.hpp>
 #include <components/GameWorld.hpp>
@@ -42,6 +43,15 @@ namespace REGoth
     {
       mPathfinder = bs::bs_shared_ptr_new<AI::Pathfinder>(mWorld->waynet());
     }
+    else
+    {
+      // A delta save doesn't hold the waynet, see GameWorld::saveDelta()
+      mPathfinder->setWaynet(mWorld->waynet());
+    }
+
+    mPathfinder->setLineOfSightQueue(&mWorld->lineOfSightQueue());
+
+    mWorld->registerEventQueue(bs::static_object_cast<CharacterEventQueue>(getHandle()));
 
     if (!mScriptState)
     {
@@ -71,6 +81,22 @@ namespace REGoth
     bs::Vector3 pos                  = positionNow();
     AI::Pathfinder::Instruction inst = mPathfinder->updateToNextInstructionToTarget(pos);
 
+    if (inst.isWaitingForWay)
+    {
+      // Stand around until we know where to go
+      mCharacterAI->stopMoving();
+      return;
+    }
+
+    if (!mCharacterAI->isPhysicsActive())
+    {
+      // Too far away from the hero to be simulated, see SectorActivation. Once the character
+      // is un-shrunk, this starts running the proper way again from where it is then.
+      mCharacterAI->stopMoving();
+      mCharacterAI->moveKinematicTowards(inst.targetPosition);
+      return;
+    }
+
     if (!mPathfinder->isTargetReachedByPosition(pos, inst.targetPosition))
     {
       // TODO: Might want to smoothly turn instead
@@ -136,7 +162,7 @@ namespace REGoth
         break;
 
       default:
-        REGOTH_LOG(Warning, Uncategorized, "[CharacterEventQueue] Unhandled Event Type: {0}",
+        REGOTH_LOG(Warning, AI, "[CharacterEventQueue] Unhandled Event Type: {0}",
                    (int)message->messageType);
         done = true;
         break;
@@ -179,7 +205,7 @@ namespace REGoth
         isDone = true;
         break;
       default:
-        REGOTH_LOG(Warning, Uncategorized,
+        REGOTH_LOG(Warning, AI,
                    "[CharacterEventQueue] Unhandled WeaponMode-Sub Type: {0}", (int)message.subType);
         isDone = true;
         break;
@@ -235,7 +261,7 @@ namespace REGoth
         break;
 
       default:
-        REGOTH_LOG(Warning, Uncategorized,
+        REGOTH_LOG(Warning, AI,
                    "[CharacterEventQueue] Unhandled MovementMessage-Sub Type: {0}",
                    (int)message.subType);
         isDone = true;
@@ -287,7 +313,7 @@ namespace REGoth
         }
         else
         {
-          mScriptState->startScriptAIState(message.state);
+          mScriptState->startScriptAIState(message.state, message.stateFunction);
         }
 
         if (message.interruptOldState)
@@ -305,16 +331,21 @@ namespace REGoth
         break;
 
       case AI::StateMessage::ST_Wait:
-        message.waitTime -= bs::gTime().getFixedFrameDelta();
+        message.waitTime -= timeSinceLastProcessed();
 
         if (message.waitTime <= 0)
         {
           isDone = true;
         }
+        else
+        {
+          // Nothing to do until the time is up
+          sleepFor(message.waitTime);
+        }
         break;
 
       default:
-        REGOTH_LOG(Warning, Uncategorized,
+        REGOTH_LOG(Warning, AI,
                    "[CharacterEventQueue] Unhandled StateMessage-Sub Type: {0}",
                    (int)message.subType);
         isDone = true;
@@ -343,9 +374,8 @@ namespace REGoth
 
         if (message.isFirstRun)
         {
-          // REGOTH_LOG(Info, Uncategorized, bs::StringUtil::format(
-          //     "[CharacterEventQueue] {0} - PlayAni start: {1}", SO()->getName(),
-          //     message.animation));
+          REGOTH_LOG(Verbose, AI, "[CharacterEventQueue] {0} - PlayAni start: {1}",
+                     SO()->getName(), message.animation);
 
           message.playingClip = mVisualCharacter->findAnimationClip(message.animation);
 
@@ -364,15 +394,21 @@ namespace REGoth
 
           if (isDone)
           {
-            // REGOTH_LOG(Info, Uncategorized,
-            //     bs::StringUtil::format("[CharacterEventQueue] {0} - PlayAni done: {1}",
-            //                            SO()->getName(), message.animation));
+            REGOTH_LOG(Verbose, AI, "[CharacterEventQueue] {0} - PlayAni done: {1}",
+                       SO()->getName(), message.animation);
           }
         }
         break;
 
+      case AI::ConversationMessage::ST_Output:
+        // Neither the sound nor the subtitle are played yet, but the line is known already
+        REGOTH_LOG(Verbose, AI, "[CharacterEventQueue] {0} - Output: {1}", SO()->getName(),
+                   message.name);
+        isDone = true;
+        break;
+
       default:
-        REGOTH_LOG(Warning, Uncategorized,
+        REGOTH_LOG(Warning, AI,
                    "[CharacterEventQueue] Unhandled Conversation-Sub Type: {0}",
                    (int)message.subType);
         isDone = true;
@@ -392,16 +428,43 @@ namespace REGoth
 
   void CharacterEventQueue::fixedUpdate()
   {
-    EventQueue::fixedUpdate();
+    // pass
+  }
 
-    if (mCharacterAI->isPhysicsActive())
-    {
-      mScriptState->doAIState(bs::gTime().getFixedFrameDelta());
-    }
-    else
+  void CharacterEventQueue::processFixedUpdate()
+  {
+    HCharacterEventQueue hthis = bs::static_object_cast<CharacterEventQueue>(getHandle());
+
+    EventQueue::processFixedUpdate();
+
+    // A message might have removed the character from the world
+    if (hthis.isDestroyed()) return;
+
+    AI::ScriptStateScheduler& scheduler = mWorld->scriptStateScheduler();
+
+    // When fast-forwarding, characters near the camera couldn't keep up walking either
+    if (!mCharacterAI->isPhysicsActive() || scheduler.shouldJumpRoutines())
     {
       mScriptState->doAIStateDuringShrink();
+      return;
     }
+
+    mTimeSinceLastAIState += bs::gTime().getFixedFrameDelta();
+
+    // Only the first character to get here in a frame actually checks the perceptions
+    mWorld->perceptionSystem().update();
+
+    if (!scheduler.shouldRun(positionNow(), mTimeSinceLastAIState)) return;
+
+    auto start = std::chrono::steady_clock::now();
+
+    // States skipped by the scheduler get all the time that has passed in the meantime
+    mScriptState->doAIState(mTimeSinceLastAIState);
+    mTimeSinceLastAIState = 0.0f;
+
+    auto duration = std::chrono::steady_clock::now() - start;
+    scheduler.recordRun(
+        (bs::UINT64)std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count());
   }
 
   SharedEMessage CharacterEventQueue::pushGotoPosition(const bs::Vector3& position)
@@ -450,7 +513,8 @@ namespace REGoth
 
   SharedEMessage CharacterEventQueue::pushStartScriptState(const bs::String& state,
                                                            const bs::String& waypoint,
-                                                           HCharacter other, HCharacter victim)
+                                                           HCharacter other, HCharacter victim,
+                                                           Scripting::SymbolIndex stateFunction)
   {
     AI::StateMessage msg;
 
@@ -464,13 +528,14 @@ namespace REGoth
     msg.victim  = victim;
     msg.state   = state;
 
+    msg.stateFunction = stateFunction;
+
     return onMessage(msg);
   }
 
-  SharedEMessage CharacterEventQueue::pushInterruptAndStartScriptState(const bs::String& state,
-                                                                       const bs::String& waypoint,
-                                                                       HCharacter other,
-                                                                       HCharacter victim)
+  SharedEMessage CharacterEventQueue::pushInterruptAndStartScriptState(
+      const bs::String& state, const bs::String& waypoint, HCharacter other, HCharacter victim,
+      Scripting::SymbolIndex stateFunction)
   {
     AI::StateMessage msg;
 
@@ -484,6 +549,8 @@ namespace REGoth
     msg.victim  = victim;
     msg.state   = state;
 
+    msg.stateFunction = stateFunction;
+
     return onMessage(msg);
   }
 
@@ -497,6 +564,18 @@ namespace REGoth
     return onMessage(msg);
   }
 
+  SharedEMessage CharacterEventQueue::pushOutput(bs::HSceneObject target,
+                                                 const bs::String& outputName)
+  {
+    AI::ConversationMessage msg;
+
+    msg.subType = AI::ConversationMessage::ST_Output;
+    msg.name    = outputName;
+    msg.target  = target;
+
+    return onMessage(msg);
+  }
+
   SharedEMessage CharacterEventQueue::pushGoToFistModeImmediate()
   {
     AI::WeaponMessage msg;
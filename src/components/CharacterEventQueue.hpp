@@ -75,21 +75,36 @@ namespace REGoth
 
     /**
      * Push a message which starts a new script state after ending the current one gracefully.
+     *
+     * @param  stateFunction  Symbol of the function named `state`, if known, so starting the
+     *                        state doesn't need to look it up.
      */
-    SharedEMessage pushStartScriptState(const bs::String& state, const bs::String& waypoint,
-                                        HCharacter other, HCharacter victim);
+    SharedEMessage pushStartScriptState(
+        const bs::String& state, const bs::String& waypoint, HCharacter other, HCharacter victim,
+        Scripting::SymbolIndex stateFunction = Scripting::SYMBOL_INDEX_INVALID);
     /**
      * Push a message which interrupts the currently active script state starts a new one.
+     *
+     * @copydetails pushStartScriptState
      */
-    SharedEMessage pushInterruptAndStartScriptState(const bs::String& state,
-                                                    const bs::String& waypoint, HCharacter other,
-                                                    HCharacter victim);
+    SharedEMessage pushInterruptAndStartScriptState(
+        const bs::String& state, const bs::String& waypoint, HCharacter other, HCharacter victim,
+        Scripting::SymbolIndex stateFunction = Scripting::SYMBOL_INDEX_INVALID);
 
     /**
      * Push a message which will make the character play an animation.
      */
     SharedEMessage pushPlayAnimation(const bs::String animation);
 
+    /**
+     * Push a message which will make the character say a line.
+     *
+     * @param  target      Character spoken to. Can be empty.
+     * @param  outputName  Name of the line, which is also the name of its sound file without
+     *                     extension, e.g. `DIA_ADDON_GREG_HELLO_01_00`.
+     */
+    SharedEMessage pushOutput(bs::HSceneObject target, const bs::String& outputName);
+
     /**
      * Push a message which will make the character go into fist-mode immediately.
      */
@@ -111,6 +126,12 @@ namespace REGoth
      */
     float getCurrentStateRunningTime() const;
 
+    /**
+     * Processes the messages of the queue and runs the script state of the character, once
+     * per fixed update. Called by GameWorld::processEventQueues().
+     */
+    void processFixedUpdate() override;
+
   protected:
     void onInitialized() override;
 
@@ -125,7 +146,8 @@ namespace REGoth
     void startRouteToObject(bs::HSceneObject target);
 
     /**
-     * Lets the Character move along the currently active route in the Pathfinder.
+     * Lets the Character move along the currently active route in the Pathfinder. Shrunk
+     * characters are moved there without physics, see CharacterAI::moveKinematicTowards().
      */
     void travelActiveRoute();
 
@@ -145,7 +167,8 @@ namespace REGoth
     virtual void onExecuteEventAction(SharedEMessage message, bs::HSceneObject sender) override;
 
     /**
-     * Cyclic update
+     * Does nothing, the GameWorld processes all character event queues in one go, see
+     * GameWorld::processEventQueues().
      */
     virtual void fixedUpdate() override;
 
@@ -172,6 +195,11 @@ namespace REGoth
     bs::SPtr<AI::Pathfinder> mPathfinder;
     bs::SPtr<AI::ScriptState> mScriptState;
 
+    /**
+     * Time collected while the AI::ScriptStateScheduler did not let the script state run.
+     */
+    float mTimeSinceLastAIState = 0.0f;
+
   public:
     REGOTH_DECLARE_RTTI(CharacterEventQueue)
 
@@ -1,9 +1,13 @@
 #include "CharacterKeyboardInput.hpp"
 #include <RTTI/RTTI_CharacterKeyboardInput.hpp>
+#include <Utility/BsTime.h>
 #include <components/Character.hpp>
 #include <components/CharacterAI.hpp>
 #include <components/CharacterEventQueue.hpp>
 #include <components/GameWorld.hpp>
+#include <components/GameplayUI.hpp>
+#include <components/UIFocusText.hpp>
+#include <core/InputReplay.hpp>
 #include <exception/Throw.hpp>
 #include <log/logging.hpp>
 
@@ -37,6 +41,7 @@ namespace REGoth
     mJump              = bs::VirtualButton("Jump");
     mAction            = bs::VirtualButton("Action");
     mQuickSave         = bs::VirtualButton("QuickSave");
+    mReloadScripts     = bs::VirtualButton("ReloadScripts");
 
     mCharacter = SO()->getComponent<Character>();
 
@@ -65,11 +70,58 @@ namespace REGoth
           bs::StringUtil::format("Scene Object {0} does not have a CharacterEventQueue component!",
                                  SO()->getName()));
     }
+
+    mCharacterAI->setTurningPerFrame(isSampledPerFrame());
+    mWorld->registerKeyboardInput(bs::static_object_cast<CharacterKeyboardInput>(getHandle()));
+  }
+
+  void CharacterKeyboardInput::onDestroyed()
+  {
+    // Other characters, or a hero controlled by something else, turn once per fixed update
+    if (!mCharacterAI.isDestroyed()) mCharacterAI->setTurningPerFrame(false);
+
+    bs::Component::onDestroyed();
+  }
+
+  bool CharacterKeyboardInput::isSampledPerFrame() const
+  {
+    return gInputReplay().mode() == InputReplay::Mode::Live;
   }
 
   void CharacterKeyboardInput::update()
   {
-    if (bs::gVirtualInput().isButtonDown(mAction))
+    updateFocus();
+
+    gInputReplay().onFrame(bs::gTime().getFrameDelta());
+
+    // Presses are acted on by the next fixed update, so they can be recorded along with the
+    // movement, see InputReplay
+    auto pressed = [&](const bs::VirtualButton& button, ReplayButton replayButton) {
+      if (bs::gVirtualInput().isButtonDown(button))
+      {
+        mPendingPressed |= ReplayTick::bit(replayButton);
+      }
+    };
+
+    pressed(mAction, ReplayButton::Action);
+    pressed(mToggleWalking, ReplayButton::ToggleWalking);
+    pressed(mToggleSneaking, ReplayButton::ToggleSneaking);
+    pressed(mToggleMeleeWeapon, ReplayButton::ToggleMeleeWeapon);
+    pressed(mJump, ReplayButton::Jump);
+    pressed(mQuickSave, ReplayButton::QuickSave);
+    pressed(mReloadScripts, ReplayButton::ReloadScripts);
+
+    if (isSampledPerFrame())
+    {
+      handleHeld(sampleHeld());
+
+      mCharacterAI->turnForFrame(bs::gTime().getFrameDelta());
+    }
+  }
+
+  void CharacterKeyboardInput::handlePresses(const ReplayTick& tick)
+  {
+    if (tick.wasPressed(ReplayButton::Action))
     {
       auto thisCharacter = SO()->getComponent<Character>();
 
@@ -81,7 +133,7 @@ namespace REGoth
         // Skip self
         if (c->SO() == SO()) continue;
 
-        auto eventQueue = c->SO()->getComponent<CharacterEventQueue>();
+        auto eventQueue = c->eventQueue();
 
         REGOTH_LOG(Info, Uncategorized, "[CharacterKeyboardInput] Talk to: {0}", c->SO()->getName());
         eventQueue->clear();  // FIXME: Find out what's blocking the new message
@@ -90,51 +142,115 @@ namespace REGoth
       }
     }
 
-    if (bs::gVirtualInput().isButtonDown(mToggleWalking))
+    if (tick.wasPressed(ReplayButton::ToggleWalking))
     {
       mCharacterAI->tryToggleWalking();
     }
 
-    if (bs::gVirtualInput().isButtonDown(mToggleSneaking))
+    if (tick.wasPressed(ReplayButton::ToggleSneaking))
     {
       mCharacterAI->tryToggleSneaking();
     }
 
-    if (bs::gVirtualInput().isButtonDown(mToggleMeleeWeapon))
+    if (tick.wasPressed(ReplayButton::ToggleMeleeWeapon))
     {
       mCharacterAI->tryToggleMeleeWeapon();
     }
 
-    if (bs::gVirtualInput().isButtonDown(mJump))
+    if (tick.wasPressed(ReplayButton::Jump))
     {
       mCharacterAI->jump();
     }
 
-    if (bs::gVirtualInput().isButtonDown(mQuickSave))
+    if (tick.wasPressed(ReplayButton::QuickSave))
+    {
+      mWorld->save(GameWorld::startingSaveName(mWorld->worldName() + ".ZEN"));
+    }
+
+    if (tick.wasPressed(ReplayButton::ReloadScripts))
     {
-      mWorld->save("WorldViewer-" + mWorld->worldName() + ".ZEN");
+      mWorld->reloadScripts();
     }
   }
 
-  void CharacterKeyboardInput::fixedUpdate()
+  void CharacterKeyboardInput::updateFocus()
+  {
+    const bs::Transform& transform = SO()->getTransform();
+    FocusSelection& selection      = mWorld->focusSelection();
+
+    bool hasChanged =
+        selection.update(transform.pos(), transform.getForward(), bs::gTime().getFrameDelta());
+
+    // Tests without UI still move around
+    if (!hasChanged || !hasGameplayUI()) return;
+
+    HFocusable focus = selection.focus();
+
+    if (focus)
+    {
+      gGameplayUI()->focusText()->putTextAbove(focus);
+    }
+    else
+    {
+      gGameplayUI()->focusText()->clearText();
+    }
+  }
+
+  void CharacterKeyboardInput::processFixedUpdate()
   {
     // Always keep the user controllers physics active
     mCharacterAI->activatePhysics();
 
-    if (bs::gVirtualInput().isButtonHeld(mMoveForward))
+    ReplayTick live = sampleHeld();
+    live.pressed    = mPendingPressed;
+    mPendingPressed = 0;
+
+    ReplayTick tick = gInputReplay().tick(live);
+
+    handlePresses(tick);
+
+    // Already done by update() when live
+    if (!isSampledPerFrame()) handleHeld(tick);
+  }
+
+  ReplayTick CharacterKeyboardInput::sampleHeld() const
+  {
+    ReplayTick live;
+
+    auto held = [&](const bs::VirtualButton& button, ReplayButton replayButton) {
+      if (bs::gVirtualInput().isButtonHeld(button))
+      {
+        live.held |= ReplayTick::bit(replayButton);
+      }
+    };
+
+    held(mMoveForward, ReplayButton::MoveForward);
+    held(mMoveBack, ReplayButton::MoveBack);
+    held(mStrafeLeft, ReplayButton::StrafeLeft);
+    held(mStrafeRight, ReplayButton::StrafeRight);
+    held(mTurnLeft, ReplayButton::TurnLeft);
+    held(mTurnRight, ReplayButton::TurnRight);
+    held(mFastMove, ReplayButton::FastMove);
+
+    return live;
+  }
+
+  void CharacterKeyboardInput::handleHeld(const ReplayTick& tick)
+  {
+    if (tick.isHeld(ReplayButton::MoveForward))
     {
       mCharacterAI->goForward();
     }
-    else if (bs::gVirtualInput().isButtonHeld(mMoveBack))
+    else if (tick.isHeld(ReplayButton::MoveBack))
     {
       mCharacterAI->goBackward();
     }
-    else if (bs::gVirtualInput().isButtonHeld(mStrafeLeft))
+    else if (tick.isHeld(ReplayButton::StrafeLeft))
     {
       // FIXME: Should be strafeLeft, but has to be strafeRight here since the world is mirrored
       mCharacterAI->strafeRight();
     }
-    else if (bs::gVirtualInput().isButtonHeld(mStrafeRight))
+    else if (tick.isHeld(ReplayButton::StrafeRight))
     {
       // FIXME: Should be strafeRight, but has to be strafeLeft here since the world is mirrored
       mCharacterAI->strafeLeft();
@@ -144,12 +260,12 @@ namespace REGoth
       mCharacterAI->stopMoving();
     }
 
-    if (bs::gVirtualInput().isButtonHeld(mTurnLeft))
+    if (tick.isHeld(ReplayButton::TurnLeft))
     {
       // FIXME: Should be turnLeft, but has to be turnRight here since the world is mirrored
       mCharacterAI->turnRight();
     }
-    else if (bs::gVirtualInput().isButtonHeld(mTurnRight))
+    else if (tick.isHeld(ReplayButton::TurnRight))
     {
       // FIXME: Should be turnRight, but has to be turnLeft here since the world is mirrored
       mCharacterAI->turnLeft();
@@ -159,7 +275,7 @@ namespace REGoth
       mCharacterAI->stopTurning();
     }
 
-    if (bs::gVirtualInput().isButtonHeld(mFastMove))
+    if (tick.isHeld(ReplayButton::FastMove))
     {
       mCharacterAI->fastMove(4.0f);
     }
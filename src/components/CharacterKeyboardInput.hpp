@@ -3,6 +3,7 @@
 #include <Input/BsVirtualInput.h>
 #include <RTTI/RTTIUtil.hpp>
 #include <Scene/BsComponent.h>
+#include <core/InputReplay.hpp>
 
 namespace REGoth
 {
@@ -21,6 +22,12 @@ namespace REGoth
   /**
    * Component which queries keyboard input and makes the character it is attached to
    * move accordingly.
+   *
+   * Held buttons are sampled every frame while playing live, so the hero starts and stops
+   * moving in the frame a button changes, and turns by the time of each frame instead of a
+   * fixed amount per fixed update. Presses and everything recorded or played back by
+   * InputReplay go through processFixedUpdate(), which the world runs before any other
+   * character, see GameWorld::processPlayerInput().
    */
   class CharacterKeyboardInput : public bs::Component
   {
@@ -28,15 +35,46 @@ namespace REGoth
     CharacterKeyboardInput(const bs::HSceneObject& parent, HGameWorld world);
     virtual ~CharacterKeyboardInput();
 
+    /**
+     * Acts on the buttons pressed since the last fixed update and, unless playing live, on
+     * the held ones. Called by GameWorld::processPlayerInput().
+     */
+    void processFixedUpdate();
 
   protected:
-
-    /** Triggered once per frame. Allows the component to handle input and move. */
-    void fixedUpdate() override;
+    /** Triggered once per frame. Samples the buttons and moves the hero while live. */
     void update() override;
     void onInitialized() override;
+    void onDestroyed() override;
 
   private:
+    /**
+     * @return Whether held buttons are acted on every frame. Not while recording or playing
+     *         back, as those go by fixed update.
+     */
+    bool isSampledPerFrame() const;
+
+    /**
+     * @return The buttons held right now.
+     */
+    ReplayTick sampleHeld() const;
+
+    /**
+     * Moves and turns the character as the held buttons of the given tick say.
+     */
+    void handleHeld(const ReplayTick& tick);
+
+    /**
+     * Lets the world choose what the character is focusing and shows its text, if the focus
+     * has changed, see FocusSelection.
+     */
+    void updateFocus();
+
+    /**
+     * Acts on the buttons pressed during the given tick, see InputReplay.
+     */
+    void handlePresses(const ReplayTick& tick);
+
     /**
      * Input key cache
      */
@@ -53,6 +91,10 @@ namespace REGoth
     bs::VirtualButton mJump;
     bs::VirtualButton mAction;
     bs::VirtualButton mQuickSave;
+    bs::VirtualButton mReloadScripts;
+
+    /** Buttons pressed since the last fixed update, see ReplayTick::pressed */
+    bs::UINT32 mPendingPressed = 0;
 
     // Handle to the CharacterAI component attached to the scene object
     HCharacter mCharacter;
@@ -1,6 +1,8 @@
 #include "EventQueue.hpp"
 #include <RTTI/RTTI_EventQueue.hpp>
 #include <Scene/BsSceneObject.h>
+#include <Utility/BsTime.h>
+#include <algorithm>
 #include <exception/Throw.hpp>
 
 namespace REGoth
@@ -27,6 +29,8 @@ namespace REGoth
     else
     {
       mEventQueue.push_back(message);
+
+      wakeUp();
     }
   }
 
@@ -39,7 +43,40 @@ namespace REGoth
 
   void EventQueue::fixedUpdate()
   {
+    processFixedUpdate();
+  }
+
+  void EventQueue::processFixedUpdate()
+  {
+    float deltaTime = bs::gTime().getFixedFrameDelta();
+
+    if (mSleepState == SleepState::Idle) return;
+
+    mTimeSinceLastProcessed += deltaTime;
+
+    if (mSleepState == SleepState::Timed)
+    {
+      mSleepTimeLeft -= deltaTime;
+
+      if (mSleepTimeLeft > 0.0f) return;
+
+      mSleepState = SleepState::Awake;
+    }
+
     processMessageQueue();
+
+    mTimeSinceLastProcessed = 0.0f;
+  }
+
+  void EventQueue::wakeUp()
+  {
+    if (mSleepState == SleepState::Idle)
+    {
+      // Nothing was going on while sleeping, so don't let the next message think otherwise
+      mTimeSinceLastProcessed = 0.0f;
+    }
+
+    mSleepState = SleepState::Awake;
   }
 
   void EventQueue::processMessageQueue()
@@ -56,22 +93,23 @@ namespace REGoth
       }
     }
 
-    // Remove deleted messages from last time
-    for (auto it = mEventQueue.begin(); it != mEventQueue.end();)
-    {
-      if ((*it)->deleted)
-      {
-        it = mEventQueue.erase(it);
-      }
-      else
-      {
-        it++;
-      }
-    }
+    // Remove deleted messages from last time, in a single pass keeping the order
+    auto isDeleted = [](const SharedEMessage& ev) { return ev->deleted; };
+
+    mEventQueue.erase(std::remove_if(mEventQueue.begin(), mEventQueue.end(), isDeleted),
+                      mEventQueue.end());
+
+    mRequestedSleepTime = 0.0f;
 
-    // Process messages as far as we can
-    for (SharedEMessage ev : mEventQueue)
+    bs::UINT32 numProcessed = 0;
+    bool isLastDone         = false;
+
+    // Process messages as far as we can. By index again, as the host might push messages.
+    for (size_t i = 0; i < mEventQueue.size(); i++)
     {
+      // Keeps the message alive, even when the host clears the queue
+      SharedEMessage ev = mEventQueue[i];
+
       bs::HSceneObject sender = {};  // TODO: Don't we need that?
       sendMessageToHost(ev, sender);
 
@@ -81,8 +119,21 @@ namespace REGoth
       // Mark as done if this wasn't a job
       if (!ev->isJob) ev->deleted = true;
 
+      numProcessed += 1;
+      isLastDone = ev->deleted;
+
       if (!ev->isOverlay) break;
     }
+
+    if (mEventQueue.empty())
+    {
+      mSleepState = SleepState::Idle;
+    }
+    else if (mRequestedSleepTime > 0.0f && numProcessed == 1 && !isLastDone)
+    {
+      mSleepState    = SleepState::Timed;
+      mSleepTimeLeft = mRequestedSleepTime;
+    }
   }
 
   SharedEMessage EventQueue::findLastConversationMessageWith(bs::HSceneObject other)
@@ -90,10 +141,10 @@ namespace REGoth
     auto begin = mEventQueue.rbegin();
     auto end   = mEventQueue.rend();
 
-    auto lastConvMessageIterator = std::find_if(begin, end, [&](SharedEMessage ev) {
+    auto lastConvMessageIterator = std::find_if(begin, end, [&](const SharedEMessage& ev) {
       if (!ev->isOverlay && ev->messageType == AI::EventMessageType::Conversation)
       {
-        auto conv = reinterpret_cast<AI::ConversationMessage*>(ev.get());
+        auto conv = static_cast<const AI::ConversationMessage*>(ev.get());
         return conv->target == other;
       }
       return false;
@@ -128,23 +179,30 @@ namespace REGoth
     // Let the EM wait for this talking-action to complete
     bs::SPtr<AI::ConversationMessage> queuedWait = onMessage(wait);
 
-    other->onMessageDone.connect([queuedWait](SharedEMessage msg) {
+    bs::GameObjectHandle<EventQueue> thisQueue = bs::static_object_cast<EventQueue>(getHandle());
+
+    other->onMessageDone.connect([queuedWait, thisQueue](SharedEMessage msg) {
       // Once this event fires, we're done waiting
       queuedWait->canceled = true;
+
+      if (!thisQueue.isDestroyed()) thisQueue->wakeUp();
     });
   }
 
   void EventQueue::clear()
   {
-    for (SharedEMessage ev : mEventQueue)
+    for (const SharedEMessage& ev : mEventQueue)
     {
       ev->deleted = true;
     }
+
+    // Deleted messages are removed while processing the queue
+    wakeUp();
   }
 
   bool EventQueue::isEmpty()
   {
-    for (SharedEMessage ev : mEventQueue)
+    for (const SharedEMessage& ev : mEventQueue)
     {
       if (!ev->deleted) return false;
     }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <AI/EventMessage.hpp>
+#include <AI/EventMessagePool.hpp>
 #include <RTTI/RTTIUtil.hpp>
 #include <Scene/BsComponent.h>
 
@@ -58,6 +59,18 @@ namespace REGoth
    * overlay. That will be the last event passed to the object.
    *
    *
+   * Sleeping
+   * ========
+   *
+   * Most queues are empty or waiting for something most of the time. To not go
+   * through the queue on every update cycle for nothing, a queue falls asleep
+   * once it is empty. It wakes up again once a message is queued.
+   *
+   * The host object can also let the queue sleep for some time while it is
+   * handling a message, see sleepFor(). Queuing a message wakes the queue up
+   * early.
+   *
+   *
    * User Implementation
    * ===================
    *
@@ -85,8 +98,8 @@ namespace REGoth
     template <typename T>
     bs::SPtr<T> onMessageFromObject(const T& msg, bs::HSceneObject sender)
     {
-      // Copy over the data from the given message
-      auto copyDerived = bs::bs_shared_ptr_new<T>(msg);
+      // Copy over the data from the given message. Pooled, scripts push lots of these.
+      auto copyDerived = AI::allocateEventMessage<T>(msg);
 
       // Handle the message and potentially add it to the queue
       handleMessage(copyDerived, sender);
@@ -145,6 +158,37 @@ namespace REGoth
      */
     void clear();
 
+    /**
+     * @return Number of messages in the queue, including deleted ones which have not been
+     *         removed yet.
+     */
+    size_t numMessages() const
+    {
+      return mEventQueue.size();
+    }
+
+    /**
+     * @return Whether the queue is currently asleep, see *Sleeping* above.
+     */
+    bool isSleeping() const
+    {
+      return mSleepState != SleepState::Awake;
+    }
+
+    /**
+     * Makes the queue process its messages again on the next update cycle.
+     */
+    void wakeUp();
+
+    /**
+     * Processes the queue for a single fixed update cycle. Done by fixedUpdate(), unless a
+     * specialized queue is processed by someone else, like CharacterEventQueue.
+     *
+     * @note This might lead to the destruction of the host-vob and this object in response to
+     *       a message!
+     */
+    virtual void processFixedUpdate();
+
   protected:
     /**
      * Called cyclically for the first message in the queue. Override this
@@ -156,6 +200,27 @@ namespace REGoth
      */
     virtual void onExecuteEventAction(SharedEMessage message, bs::HSceneObject sender) = 0;
 
+    /**
+     * To be called from onExecuteEventAction(): Stops processing the queue for the given
+     * time, since the message won't be done before that anyways.
+     *
+     * Only has an effect if the message is not done yet and the only one processed in this
+     * cycle, i.e. there are no overlay messages in front of it.
+     */
+    void sleepFor(float seconds)
+    {
+      mRequestedSleepTime = seconds;
+    }
+
+    /**
+     * @return Seconds since the messages have been processed the last time. This is longer than
+     *         a single update cycle if the queue has been sleeping.
+     */
+    float timeSinceLastProcessed() const
+    {
+      return mTimeSinceLastProcessed;
+    }
+
     /**
      * Cyclic update
      */
@@ -201,6 +266,21 @@ namespace REGoth
      */
     bs::Vector<SharedEMessage> mEventQueue;
 
+    enum class SleepState
+    {
+      Awake,
+      Idle,   /** Empty, sleeping until a message arrives */
+      Timed,  /** Sleeping until mSleepTimeLeft runs out or a message arrives */
+    };
+
+    /**
+     * Sleeping is not saved, a loaded queue will take a single cycle to fall asleep again.
+     */
+    SleepState mSleepState        = SleepState::Awake;
+    float mSleepTimeLeft          = 0.0f;
+    float mRequestedSleepTime     = 0.0f;
+    float mTimeSinceLastProcessed = 0.0f;
+
   public:
     REGOTH_DECLARE_RTTI(EventQueue)
 
@@ -8,8 +8,6 @@ namespace REGoth
       : bs::Component(parent)
   {
     setName("Focusable");
-
-    tryExtractHeightFromRenderable();
   }
 
   Focusable::~Focusable()
@@ -28,11 +26,19 @@ namespace REGoth
 
   void Focusable::setTextHeight(float height)
   {
-    mHeightOffset = height;
+    mHeightOffset  = height;
+    mIsHeightKnown = true;
   }
 
   float Focusable::getTextHeight() const
   {
+    // The visual is usually added after this component, so this can't be done on creation
+    if (!mIsHeightKnown)
+    {
+      mHeightOffset  = tryExtractHeightFromRenderable();
+      mIsHeightKnown = true;
+    }
+
     return mHeightOffset;
   }
 
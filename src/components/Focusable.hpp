@@ -36,8 +36,9 @@ namespace REGoth
      * should be displayed. By default the top of the renderables bounding box will
      * be used if possible. For more complex objects you may need to set this manually.
      *
-     * Also note that the renderable is only queried at component creation. It its bounding box
-     * changes afterwards, you will need to set the height here manually too.
+     * Also note that the renderable is only queried the first time the height is needed, as
+     * reading its bounds isn't free. If its bounding box changes afterwards, you will need to
+     * set the height here manually too.
      */
     void setTextHeight(float height);
 
@@ -57,7 +58,10 @@ namespace REGoth
     REGOTH_DECLARE_RTTI(Focusable)
 
     bs::String mText;
-    float mHeightOffset = 0.0f;
+    mutable float mHeightOffset = 0.0f;
+
+    /** Whether mHeightOffset was set or taken from the renderable already */
+    mutable bool mIsHeightKnown = false;
 
   protected:
     Focusable() = default;  // For RTTI
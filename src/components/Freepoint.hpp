@@ -5,7 +5,11 @@
 namespace REGoth
 {
   /**
-   * TODO: Documentation of Freepoint
+   * A spot in the world characters go to to do something there, like sitting at a campfire.
+   * See Waynet for how they are found.
+   *
+   * A freepoint can be reserved by a single character, so others looking for a free spot
+   * skip it, see Waynet::reserveFreepoint().
    */
   class Freepoint : public bs::Component
   {
@@ -13,7 +17,26 @@ namespace REGoth
     Freepoint(const bs::HSceneObject& parent);
     virtual ~Freepoint();
 
+    /**
+     * @return Whether the given scene object may use this freepoint, which is the case if
+     *         it is not reserved by anybody else. Freepoints reserved by scene objects which
+     *         have been destroyed since are free again.
+     */
+    bool isAvailableFor(const bs::HSceneObject& occupant) const
+    {
+      return mOccupant.isDestroyed() || mOccupant == occupant;
+    }
+
   private:
+    /** For reserving */
+    friend class Waynet;
+
+    /**
+     * Scene object of the character having reserved this freepoint. Not saved, characters
+     * reserve their freepoints again when their routine restarts after loading.
+     */
+    bs::HSceneObject mOccupant;
+
   public:
     REGOTH_DECLARE_RTTI(Freepoint)
 
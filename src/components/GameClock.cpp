@@ -1,7 +1,9 @@
 #include "GameClock.hpp"
+#include <algorithm>
 #include <Math/BsMath.h>
 #include <RTTI/RTTI_GameClock.hpp>
 #include <Scene/BsSceneObject.h>
+#include <exception/Throw.hpp>
 
 namespace REGoth
 {
@@ -11,6 +13,7 @@ namespace REGoth
   // see
   // https://forum.worldofplayers.de/forum/threads/396326?p=6231841&viewfull=1#post6231841
   constexpr float CLOCK_SPEED_FACTOR = SECONDS_IN_A_DAY / 6000;
+  constexpr bs::INT32 MINUTES_IN_A_DAY = 24 * 60;
 
   GameClock::GameClock(const bs::HSceneObject& parent)
       : bs::Component(parent)
@@ -21,8 +24,65 @@ namespace REGoth
   {
     float delta = bs::gTime().getFixedFrameDelta();
 
+    bs::INT32 minutesBefore = getTotalMinutes();
+
     mElapsedSeconds += delta;
-    mElapsedIngameSeconds += delta * CLOCK_SPEED_FACTOR;
+    mElapsedIngameSeconds += delta * CLOCK_SPEED_FACTOR * mTimeScale;
+
+    bs::INT32 minutesNow = getTotalMinutes();
+
+    // Usually no minute or a single one has passed. Should a frame take very long, every time
+    // of day is still triggered no more than once.
+    bs::INT32 first = std::max(minutesBefore + 1, minutesNow - MINUTES_IN_A_DAY + 1);
+
+    for (bs::INT32 minute = first; minute <= minutesNow; minute++)
+    {
+      triggerMinute(minute);
+    }
+  }
+
+  void GameClock::setTimeScale(float timeScale)
+  {
+    if (timeScale <= 0.0f)
+    {
+      REGOTH_THROW(InvalidParametersException, "Time scale must be larger than 0.");
+    }
+
+    mTimeScale = timeScale;
+  }
+
+  bs::HEvent GameClock::onTimeReached(bs::INT32 hour, bs::INT32 min,
+                                      std::function<void()> callback)
+  {
+    bs::INT32 minuteOfDay = ((hour % 24) * 60 + min % 60 + MINUTES_IN_A_DAY) % MINUTES_IN_A_DAY;
+
+    return mSchedule[minuteOfDay].connect(std::move(callback));
+  }
+
+  bs::INT32 GameClock::getTotalMinutes() const
+  {
+    return bs::Math::floorToPosInt(mElapsedIngameSeconds / SECONDS_IN_A_MINUTE);
+  }
+
+  void GameClock::triggerMinute(bs::INT32 totalMinutes)
+  {
+    bs::INT32 minuteOfDay = totalMinutes % MINUTES_IN_A_DAY;
+    bs::INT32 hour        = minuteOfDay / 60;
+    bs::INT32 min         = minuteOfDay % 60;
+
+    onMinute(hour, min);
+
+    if (min == 0)
+    {
+      onHour(hour);
+    }
+
+    auto it = mSchedule.find(minuteOfDay);
+
+    if (it != mSchedule.end())
+    {
+      it->second();
+    }
   }
 
   bs::INT32 GameClock::getDay() const
@@ -122,6 +182,8 @@ namespace REGoth
   {
     mElapsedIngameSeconds =
         day * SECONDS_IN_A_DAY + hour * SECONDS_IN_AN_HOUR + min * SECONDS_IN_A_MINUTE;
+
+    onTimeSet();
   }
 
   REGOTH_DEFINE_RTTI(GameClock)
@@ -2,7 +2,9 @@
 #include <BsPrerequisites.h>
 #include <RTTI/RTTIUtil.hpp>
 #include <Scene/BsComponent.h>
+#include <Utility/BsEvent.h>
 #include <Utility/BsTime.h>
+#include <functional>
 
 namespace REGoth
 {
@@ -10,6 +12,11 @@ namespace REGoth
    * Component that handles play and ingame time.
    * Offers externals for timespecific Wld_* functions.
    * Shall be instantiated with the World.
+   *
+   * Instead of asking for the time every frame, code waiting for a certain time can subscribe
+   * to onMinute, onHour or a time of day via onTimeReached(). Those are triggered from
+   * fixedUpdate() for every ingame minute the clock passes. Setting the time directly doesn't
+   * trigger them, only onTimeSet.
    */
   class GameClock : public bs::Component
   {
@@ -83,12 +90,74 @@ namespace REGoth
 
     void setDay(bs::UINT32 day);
 
+    /**
+     * Sets how much faster than usual the ingame time passes, e.g. to fast-forward days while
+     * testing daily routines. Play time is not affected. Not saved.
+     *
+     * Characters only keep up with their routines at high time scales by skipping the walk to
+     * the next routine waypoint, see ScriptStateSchedulerSettings::routineJumpTimeScale.
+     *
+     * @param  timeScale  1 for normal speed. Must be larger than 0.
+     */
+    void setTimeScale(float timeScale);
+
+    /**
+     * @return How much faster than usual the ingame time passes, see setTimeScale().
+     */
+    float getTimeScale() const
+    {
+      return mTimeScale;
+    }
+
+    /**
+     * Registers a callback to be triggered every day once the clock reaches the given time of
+     * day (hh:mm).
+     *
+     * @return Handle to disconnect the callback with. Must be disconnected before whatever the
+     *         callback refers to goes away.
+     */
+    bs::HEvent onTimeReached(bs::INT32 hour, bs::INT32 min, std::function<void()> callback);
+
+    /**
+     * Triggered whenever a new ingame minute starts, with the time of day (hh:mm) it starts.
+     */
+    bs::Event<void(bs::INT32 hour, bs::INT32 min)> onMinute;
+
+    /**
+     * Triggered whenever a new ingame hour starts, right after onMinute.
+     */
+    bs::Event<void(bs::INT32 hour)> onHour;
+
+    /**
+     * Triggered after the time has been set via setTime() or setDay(). None of the minutes
+     * skipped or gone back are triggered, so subscribers have to look at the time again.
+     */
+    bs::Event<void()> onTimeSet;
+
   private:
     float mElapsedSeconds       = 0.0f;
     float mElapsedIngameSeconds = 0.0f;
+    float mTimeScale            = 1.0f;
+
+    /**
+     * Callbacks registered via onTimeReached(), sorted by their minute of the day. Not saved,
+     * subscribers register again when loaded.
+     */
+    bs::Map<bs::INT32, bs::Event<void()>> mSchedule;
 
     void setTime(bs::UINT32 day, bs::UINT8 hour, bs::UINT8 min);
 
+    /**
+     * @return Ingame minutes passed since the start of the first day.
+     */
+    bs::INT32 getTotalMinutes() const;
+
+    /**
+     * Triggers all subscriptions for the start of the given ingame minute, see
+     * getTotalMinutes().
+     */
+    void triggerMinute(bs::INT32 totalMinutes);
+
   public:
     REGOTH_DECLARE_RTTI(GameClock)
 
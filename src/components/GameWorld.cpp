@@ -1,29 +1,56 @@
 #include "GameWorld.hpp"
 #include <BsZenLib/ImportPath.hpp>
+#include <Components/BsCLight.h>
+#include <FileSystem/BsFileSystem.h>
 #include <RTTI/RTTI_GameWorld.hpp>
+#include <Renderer/BsCamera.h>
 #include <Resources/BsResources.h>
 #include <Scene/BsPrefab.h>
 #include <Scene/BsSceneManager.h>
+#include <algorithm>
+#include <chrono>
+#include <components/AmbientSound.hpp>
 #include <components/Character.hpp>
+#include <components/CharacterAI.hpp>
+#include <components/CharacterEventQueue.hpp>
+#include <components/CharacterKeyboardInput.hpp>
 #include <components/Focusable.hpp>
+#include <components/Freepoint.hpp>
 #include <components/GameClock.hpp>
 #include <components/Item.hpp>
+#include <components/LevelChangeTrigger.hpp>
 #include <components/VisualCharacter.hpp>
+#include <components/VisualStaticMesh.hpp>
 #include <components/Waynet.hpp>
+#include <core/DebugDrawBatches.hpp>
+#include <core/FrameMonitor.hpp>
+#include <core/InputReplay.hpp>
+#include <core/Metrics.hpp>
+#include <core/Profiling.hpp>
+#include <core/StartupProfiler.hpp>
 #include <daedalus/DATFile.h>
 #include <exception/Throw.hpp>
 #include <log/logging.hpp>
+#include <original-content/OriginalGameResources.hpp>
+#include <original-content/PhysicsMeshCache.hpp>
+#include <original-content/TextureStreaming.hpp>
 #include <original-content/VirtualFileSystem.hpp>
 #include <scripting/ScriptVMForGameWorld.hpp>
+#include <world/PortalMap.hpp>
+#include <world/WorldCacheInfo.hpp>
 #include <world/internals/ConstructFromZEN.hpp>
+#include <world/internals/ImportSingleVob.hpp>
 
 namespace REGoth
 {
   const char* const WORLD_STARTPOINT = "STARTPOINT";
 
-  GameWorld::GameWorld(const bs::HSceneObject& parent, const bs::String& zenFile)
+  GameWorld::GameWorld(const bs::HSceneObject& parent, const bs::String& zenFile,
+                       ZenLoading loading)
       : bs::Component(parent)
       , mZenFile(zenFile)
+      , mIsStreamed(loading == ZenLoading::Streamed)
+      , mRandom(gInputReplay().randomSeed())
   {
     setName("GameWorld");
   }
@@ -31,6 +58,7 @@ namespace REGoth
   GameWorld::GameWorld(const bs::HSceneObject& parent, Empty /* empty */)
       : bs::Component(parent)
       , mZenFile("")
+      , mRandom(gInputReplay().randomSeed())
   {
     setName("GameWorld");
   }
@@ -43,8 +71,13 @@ namespace REGoth
   {
     HGameWorld thisWorld = bs::static_object_cast<GameWorld>(getHandle());
 
-    // Always do this after importing or deserializing
-    fillFindByNameCache();
+    mScriptStateScheduler.setWorld(thisWorld);
+    mPerceptionSystem.setWorld(thisWorld);
+    mSectorActivation.setWorld(thisWorld);
+    mFocusSelection.setWorld(thisWorld);
+    mWorldStreaming.setWorld(thisWorld);
+    mGroundItems.setWorld(thisWorld);
+    mWorldSnapshots.setWorld(thisWorld);
 
     // FIXME: Enable these again if BsSceneManager::findComponents works at this point.
     //        It seems to be too early for the components to be found when deserializing the world...
@@ -53,14 +86,46 @@ namespace REGoth
     // findAllItems();
 
     // If this is true here, we're being de-serialized
-    if (mIsInitialized) return;
+    if (mIsInitialized)
+    {
+      if (mIsSavedWithoutStaticParts)
+      {
+        attachStaticParts();
+      }
+
+      // Saves from before the index was saved don't have it
+      if (mSceneObjectsByName.empty())
+      {
+        fillFindByNameIndex();
+      }
+
+      setupWaynetCaches();
+      rebuildSpatialHashes();
+      setupSectorActivation();
+      setupPortalVisibility();
+      setupLightBudget();
+      setupAmbientSoundVoices();
+      setupGroundItems();
+      setupWorldPreloading();
+
+      if (mIsStreamed)
+      {
+        mWorldStreaming.start(mZenFile);
+      }
+
+      return;
+    }
 
     initScriptVM();
 
     if (!mZenFile.empty())
     {
       // Import the ZEN and add all scene objects as children to this SO.
-      bs::HSceneObject so = Internals::constructFromZEN(thisWorld, mZenFile);
+      bs::HSceneObject so;
+      {
+        REGOTH_STARTUP_STEP("Import world");
+        so = mIsStreamed ? importStreamedZEN() : Internals::constructFromZEN(thisWorld, mZenFile);
+      }
 
       if (!so)
       {
@@ -68,6 +133,7 @@ namespace REGoth
       }
 
       findWaynet();
+      setupWaynetCaches();
     }
     else
     {
@@ -75,6 +141,19 @@ namespace REGoth
       mWaynet = SO()->addComponent<Waynet>();
     }
 
+    fillFindByNameIndex();
+    setupSectorActivation();
+    setupPortalVisibility();
+    setupLightBudget();
+    setupAmbientSoundVoices();
+    setupGroundItems();
+    setupWorldPreloading();
+
+    if (mIsStreamed)
+    {
+      mWorldStreaming.start(mZenFile);
+    }
+
     onImportedZEN();
 
     mGameClock = SO()->addComponent<GameClock>();
@@ -83,326 +162,1281 @@ namespace REGoth
     mIsInitialized = true;
   }
 
-  void GameWorld::findAllCharacters()
+  void GameWorld::update()
   {
-    mAllCharacters = bs::gSceneManager().findComponents<Character>(false);
-  }
+    gFrameScratch().endFrame();
+    gStartupProfiler().onFrameStarted();
+    gFrameMonitor().onFrameStarted();
+    gMetrics().onFrameStarted();
 
-  void GameWorld::findAllItems()
-  {
-    mAllItems = bs::gSceneManager().findComponents<Item>(false);
+    if (gMetrics().isExportDue())
+    {
+      recordMetrics();
+      gMetrics().exportNow();
+    }
+
+    gDebugDrawBatches().redrawIfChanged();
+
+    gOriginalGameResources().finishQueuedImports();
   }
 
-  HItem GameWorld::insertItem(const bs::String& instance, const bs::Transform& transform)
+  void GameWorld::fixedUpdate()
   {
-    HGameWorld thisWorld = bs::static_object_cast<GameWorld>(getHandle());
+    using Clock = std::chrono::high_resolution_clock;
 
-    bs::HSceneObject itemSO = bs::SceneObject::create(instance);
-    itemSO->setParent(SO());
+    auto toNanoseconds = [](Clock::duration d) {
+      return (bs::UINT64)std::chrono::duration_cast<std::chrono::nanoseconds>(d).count();
+    };
 
-    itemSO->setPosition(transform.pos());
-    itemSO->setRotation(transform.rot());
+    auto start = Clock::now();
 
-    auto item = itemSO->addComponent<Item>(instance, thisWorld);
+    processPlayerInput();
 
-    auto focusable = itemSO->addComponent<Focusable>();
+    auto playerInputDone = Clock::now();
 
-    // TODO: Figure out the correct name to use for the focus text
-    focusable->setText(instance);
+    processEventQueues();
 
-    mAllItems.push_back(item);
+    auto eventQueuesDone = Clock::now();
 
-    return item;
+    resolveRootMotion();
+
+    auto rootMotionDone = Clock::now();
+
+    moveCharacters();
+
+    auto movementDone = Clock::now();
+
+    updateStreaming();
+
+    // After everything has moved, so clients get to see where things ended up
+    mWorldSnapshots.update();
+
+    if (mScriptVM)
+    {
+      mScriptObjectCollector.update(*mScriptVM);
+    }
+
+    auto end = Clock::now();
+
+    mLastFixedUpdateStats.nanosecondsPlayerInput = toNanoseconds(playerInputDone - start);
+    mLastFixedUpdateStats.nanosecondsEventQueues = toNanoseconds(eventQueuesDone - playerInputDone);
+    mLastFixedUpdateStats.nanosecondsRootMotion  = toNanoseconds(rootMotionDone - eventQueuesDone);
+    mLastFixedUpdateStats.nanosecondsMovement    = toNanoseconds(movementDone - rootMotionDone);
+    mLastFixedUpdateStats.nanosecondsStreaming   = toNanoseconds(end - movementDone);
   }
 
-  HItem GameWorld::insertItem(const bs::String& instance, const bs::String& spawnPoint)
+  void GameWorld::updateStreaming()
   {
-    bs::HSceneObject spawnPointSO = findObjectByName(spawnPoint);
-    bs::Transform transform;
+    REGOTH_FRAME_PHASE("Streaming");
+
+    HCharacter heroCharacter = hero();
+    bs::Vector3 center;
 
-    if (spawnPointSO)
+    if (heroCharacter)
     {
-      transform = spawnPointSO->getTransform();
+      center = heroCharacter->SO()->getTransform().pos();
     }
     else
     {
-      // FIXME: What to do on invalid spawnpoints?
-      // REGOTH_THROW(InvalidParametersException,
-      //     bs::StringUtil::format("Spawnpoint {0} for item of instance {1} does not exist!",
-      //                            spawnPoint, instance));
+      // Viewers without a hero still want to see what's around the camera
+      const auto& mainCamera = bs::gSceneManager().getMainCamera();
+
+      if (!mainCamera) return;
+
+      center = mainCamera->getTransform().pos();
     }
 
-    return insertItem(instance, transform);
+    if (mIsStreamed)
+    {
+      mWorldStreaming.update(center);
+    }
+
+    mSectorActivation.update(center);
+    mGroundItems.update(center);
+
+    if (heroCharacter)
+    {
+      mWorldPreloading.update(center);
+    }
+
+    const auto& mainCamera = bs::gSceneManager().getMainCamera();
+
+    if (mainCamera)
+    {
+      mPortalVisibility.update(*mainCamera);
+      mLightBudget.update(mainCamera->getTransform().pos());
+      mAmbientSoundVoices.update(mainCamera->getTransform().pos());
+    }
+
+    gTextureStreaming().update();
   }
 
-  HCharacter GameWorld::insertCharacter(const bs::String& instance, const bs::Transform& transform)
+  void GameWorld::recordMetrics()
   {
-    HGameWorld thisWorld = bs::static_object_cast<GameWorld>(getHandle());
+    Metrics& metrics = gMetrics();
 
-    bs::HSceneObject characterSO = bs::SceneObject::create(instance);
-    characterSO->setParent(SO());
+    if (mScriptVM)
+    {
+      metrics.setCounter("vm.instructions", mScriptVM->numExecutedInstructions());
+    }
 
-    characterSO->setPosition(transform.pos());
-    characterSO->setRotation(transform.rot());
+    using Tier = AI::ScriptStateScheduler::Tier;
 
-    // All script-inserted characters will be disabled right after inserting them so they
-    // don't cause the game to slow down. If they are all active, physics will be calculated
-    // even for those out of reach which takes a huge hit on performance.
-    // The character-controller will be enabled by the AI or user input.
-    // ai->deactivatePhysics(); // Commented out for testing
+    // Where the characters are right now, as the scheduler sees it
+    bs::UINT32 numCharactersPerTier[3] = {0, 0, 0};
 
-    auto character = characterSO->addComponent<Character>(instance, thisWorld);
+    for (const HCharacter& character : mAllCharacters)
+    {
+      if (character.isDestroyed()) continue;
 
-    mAllCharacters.push_back(character);
+      Tier tier = mScriptStateScheduler.tierOf(character->SO()->getTransform().pos());
+      numCharactersPerTier[(size_t)tier] += 1;
+    }
 
-    return character;
-  }
+    metrics.setGauge("ai.characters.near", numCharactersPerTier[(size_t)Tier::Near]);
+    metrics.setGauge("ai.characters.medium", numCharactersPerTier[(size_t)Tier::Medium]);
+    metrics.setGauge("ai.characters.far", numCharactersPerTier[(size_t)Tier::Far]);
+    metrics.setGauge("ai.characters.active", mSectorActivation.stats().numActiveCharacters);
 
-  HCharacter GameWorld::insertCharacter(const bs::String& instance, const bs::String& spawnPoint)
-  {
-    bs::HSceneObject spawnPointSO = findObjectByName(spawnPoint);
-    bs::Transform transform;
+    const auto& scheduling = mScriptStateScheduler.lastFrameStats();
+
+    metrics.setGauge("ai.script_states.run_per_frame", scheduling.numRun);
+    metrics.setGauge("ai.script_states.deferred_per_frame", scheduling.numDeferred);
+
+    size_t numMessages  = 0;
+    size_t mostMessages = 0;
+    bs::UINT32 numAwake = 0;
 
-    if (spawnPointSO)
+    for (const HCharacterEventQueue& queue : mEventQueues)
     {
-      transform = spawnPointSO->getTransform();
+      if (queue.isDestroyed()) continue;
+
+      numMessages += queue->numMessages();
+      mostMessages = std::max(mostMessages, queue->numMessages());
+
+      if (!queue->isSleeping()) numAwake += 1;
     }
-    else
+
+    metrics.setGauge("ai.event_queues", (double)mEventQueues.size());
+    metrics.setGauge("ai.event_queues.awake", numAwake);
+    metrics.setGauge("ai.event_queues.messages", (double)numMessages);
+    metrics.setGauge("ai.event_queues.most_messages", (double)mostMessages);
+
+    if (mWaynet)
     {
-      // FIXME: What to do on invalid spawnpoints?
-      // REGOTH_THROW(
-      //     InvalidParametersException,
-      //     bs::StringUtil::format("Spawnpoint '{0}' for character of instance {1} does not
-      //     exist!",
-      //                            spawnPoint, instance));
+      metrics.setCounter("waynet.searches", mWaynet->searchStats().numSearches);
+      metrics.setCounter("waynet.searched_nodes", mWaynet->searchStats().numExpanded);
+      metrics.setCounter("waynet.route_cache.hits", mWaynet->routeCache().stats().numHits);
+      metrics.setCounter("waynet.route_cache.misses", mWaynet->routeCache().stats().numMisses);
     }
 
-    transform.move(
-        bs::Vector3(0, 0.5f, 0));  // FIXME: Can we move the center to the feet somehow instead?
+    metrics.setCounter("ai.line_of_sight.queries", mLineOfSightQueue.stats().numQueries);
+    metrics.setGauge("ai.perception.checked", mPerceptionSystem.lastStats().numChecked);
+
+    const auto& physicsMeshes = gPhysicsMeshCache().stats();
 
-    REGOTH_LOG(Info, Uncategorized, "[GameWorld] Insert Character {0} at {1}", instance, spawnPoint);
+    metrics.setCounter("resources.physics_meshes.hits", physicsMeshes.numHits);
+    metrics.setCounter("resources.physics_meshes.loaded", physicsMeshes.numLoaded);
+    metrics.setCounter("resources.physics_meshes.cooked", physicsMeshes.numCooked);
 
-    return insertCharacter(instance, transform);
+    metrics.setGauge("world.streaming.instantiated_sectors",
+                     mWorldStreaming.stats().numInstantiatedSectors);
+    metrics.setGauge("world.streaming.loading_sectors", mWorldStreaming.stats().numLoadingSectors);
+    metrics.setGauge("world.ground_items.dormant", mGroundItems.stats().numDormantItems);
+    metrics.setGauge("world.ground_items.materialized", mGroundItems.stats().numMaterializedItems);
+    metrics.setGauge("world.preloaded_worlds", mWorldPreloading.stats().numPreloadedWorlds);
+    metrics.setGauge("world.snapshots.clients", mWorldSnapshots.stats().numClients);
+    metrics.setGauge("world.snapshots.bytes_sent", mWorldSnapshots.stats().numBytesSent);
+
+    metrics.setGauge("scripting.objects.pending", mScriptObjectCollector.stats().numPending);
+    metrics.setCounter("scripting.objects.destroyed", mScriptObjectCollector.stats().numDestroyed);
   }
 
-  void GameWorld::initScriptVM()
+  void GameWorld::moveCharacters()
   {
-    bs::Vector<bs::UINT8> data = gVirtualFileSystem().readFile("GOTHIC.DAT");
+    REGOTH_FRAME_PHASE("CharacterMovement");
 
-    mScriptVM = bs::bs_shared_ptr_new<Scripting::ScriptVMForGameWorld>(
-        bs::static_object_cast<GameWorld>(getHandle()), data);
+    // By index, in case moving a character makes it register something
+    for (size_t i = 0; i < mCharacterAIs.size(); i++)
+    {
+      if (mCharacterAIs[i].isDestroyed()) continue;
 
-    mScriptVM->initialize();
+      HCharacterAI ai = mCharacterAIs[i];
+      ai->processFixedUpdate();
+    }
   }
 
-  HGameWorld GameWorld::importZEN(const bs::String& zenFile)
+  void GameWorld::registerEventQueue(HCharacterEventQueue queue)
   {
-    bs::HSceneObject rootSO = bs::SceneObject::create("root");
-
-    return rootSO->addComponent<GameWorld>(zenFile);
+    mEventQueues.push_back(queue);
   }
 
-  void GameWorld::onImportedZEN()
+  void GameWorld::registerCharacterAI(HCharacterAI ai)
   {
+    mCharacterAIs.push_back(ai);
   }
 
-  void GameWorld::runInitScripts()
+  void GameWorld::registerKeyboardInput(HCharacterKeyboardInput input)
   {
-    mScriptVM->initializeWorld(worldName());
+    mKeyboardInput = input;
   }
 
-  HGameWorld GameWorld::createEmpty()
+  void GameWorld::processPlayerInput()
   {
-    bs::HSceneObject rootSO = bs::SceneObject::create("root");
+    REGOTH_FRAME_PHASE("PlayerInput");
 
-    return rootSO->addComponent<GameWorld>(EmptyWorld);
+    if (mKeyboardInput.isDestroyed()) return;
+
+    mKeyboardInput->processFixedUpdate();
   }
 
-  void GameWorld::findWaynet()
+  void GameWorld::processEventQueues()
   {
-    bs::HSceneObject waynetSO = SO()->findChild("Waynet");
-
-    if (!waynetSO)
-    {
-      REGOTH_THROW(InvalidStateException, "No waynet found in this world?");
-    }
+    REGOTH_FRAME_PHASE("EventQueues");
 
-    HWaynet waynet = waynetSO->getComponent<Waynet>();
+    mScriptStateScheduler.beginStep();
 
-    if (!waynet)
+    // By index, as handling a message or running a script state may insert characters
+    for (size_t i = 0; i < mEventQueues.size(); i++)
     {
-      REGOTH_THROW(InvalidStateException, "Waynet does not have Waynet component?");
+      // Might have been destroyed by a queue processed before
+      if (mEventQueues[i].isDestroyed()) continue;
+
+      HCharacterEventQueue queue = mEventQueues[i];
+      queue->processFixedUpdate();
     }
 
-    mWaynet = waynet;
-  }
+    auto isDestroyed = [](const HCharacterEventQueue& q) { return q.isDestroyed(); };
 
-  bs::String GameWorld::worldName() const
-  {
-    return mZenFile.substr(0, mZenFile.find_first_of('.'));
+    mEventQueues.erase(std::remove_if(mEventQueues.begin(), mEventQueues.end(), isDestroyed),
+                       mEventQueues.end());
   }
 
-  HCharacter GameWorld::hero() const
+  void GameWorld::resolveRootMotion()
   {
-    auto scriptObject = mScriptVM->heroInstance();
+    REGOTH_FRAME_PHASE("RootMotion");
 
-    if (scriptObject == Scripting::SCRIPT_OBJECT_HANDLE_INVALID) return {};
+    mRootMotionVisuals.clear();
 
-    bs::HSceneObject heroSO = mScriptVM->mapping().getMappedSceneObject(scriptObject);
+    auto isDestroyed = [](const HCharacterAI& ai) { return ai.isDestroyed(); };
 
-    return heroSO->getComponent<Character>();
+    mCharacterAIs.erase(std::remove_if(mCharacterAIs.begin(), mCharacterAIs.end(), isDestroyed),
+                        mCharacterAIs.end());
+
+    for (const HCharacterAI& ai : mCharacterAIs)
+    {
+      if (!ai->needsFrameRootMotion()) continue;
+
+      mRootMotionVisuals.push_back(ai->visual().get());
+    }
+
+    mRootMotionStage.run(mRootMotionVisuals);
   }
 
-  bs::HSceneObject GameWorld::findObjectByName(const bs::String& name)
+  bs::HSceneObject GameWorld::importStreamedZEN()
   {
-    auto it = mSceneObjectsByNameCached.find(name);
+    HGameWorld thisWorld = bs::static_object_cast<GameWorld>(getHandle());
 
-    if (it != mSceneObjectsByNameCached.end())
+    if (WorldStreaming::hasCache(mZenFile))
     {
-      // Found it in cache!
-      if (!it->second.isDestroyed())
-      {
-        return it->second;
-      }
-      else
-      {
-        // If the object was destroyed, act like the object wasn't found, the cache might be outdated
-        // and there is such an object now.
-      }
+      return Internals::constructFromZEN(thisWorld, mZenFile, Internals::StaticParts::Skip);
     }
 
-    bs::HSceneObject so = SO()->findChild(name);
+    bs::Vector<bs::HSceneObject> staticObjects;
+
+    bs::HSceneObject so = Internals::constructFromZEN(
+        thisWorld, mZenFile, Internals::StaticParts::Import, &staticObjects);
 
     if (so)
     {
-      mSceneObjectsByNameCached[name] = so;
+      WorldStreaming::createCache(mZenFile, staticObjects);
     }
 
     return so;
   }
 
-  void GameWorld::fillFindByNameCache()
+  void GameWorld::setupSectorActivation()
   {
-    mSceneObjectsByNameCached.clear();
+    mSectorActivation.reset(mAllCharacters);
 
-    std::function<void(bs::HSceneObject)> visit = [&](bs::HSceneObject parent) {
-      for (bs::UINT32 i = 0; i < parent->getNumChildren(); i++)
-      {
-        bs::HSceneObject child = parent->getChild(i);
+    // Vobs are imported as direct children of the world. Those with just a mesh are static,
+    // others, like items, have something to do even when nobody is around.
+    for (bs::UINT32 i = 0; i < SO()->getNumChildren(); i++)
+    {
+      bs::HSceneObject child = SO()->getChild(i);
+
+      if (!child->getComponent<VisualStaticMesh>()) continue;
+      if (child->getComponent<Item>()) continue;
+
+      mSectorActivation.addStaticVob(child);
+    }
+  }
+
+  void GameWorld::setupPortalVisibility()
+  {
+    mPortalVisibility.reset(mZenFile.empty() ? nullptr
+                                             : PortalMap::load(PortalMap::cachePathFor(mZenFile)));
 
-        bs::String name = child->getName();
+    bs::String worldMeshName = mZenFile + ".worldmesh";
 
-        if (!name.empty())
+    // Same static vobs as in setupSectorActivation(), plus the tiles of the world mesh. Those
+    // of a streamed world are streamed in later and never culled.
+    for (bs::UINT32 i = 0; i < SO()->getNumChildren(); i++)
+    {
+      bs::HSceneObject child = SO()->getChild(i);
+
+      if (child->getName() == worldMeshName)
+      {
+        for (bs::UINT32 tile = 0; tile < child->getNumChildren(); tile++)
         {
-          mSceneObjectsByNameCached[name] = child;
+          mPortalVisibility.addStaticObject(child->getChild(tile));
         }
 
-        visit(child);
+        continue;
       }
-    };
 
-    visit(SO());
+      if (!child->getComponent<VisualStaticMesh>()) continue;
+      if (child->getComponent<Item>()) continue;
+
+      mPortalVisibility.addStaticObject(child);
+    }
   }
 
-  bs::Vector<HCharacter> GameWorld::findCharactersInRange(float rangeInMeters,
-                                                          const bs::Vector3& around) const
+  void GameWorld::setupLightBudget()
   {
-    float rangeSq = rangeInMeters * rangeInMeters;
+    mLightBudget.reset();
 
-    bs::Vector<HCharacter> result;
-
-    for (HCharacter c : mAllCharacters)
+    // Turned off lights are on deactivated scene objects, see LightBudget
+    for (const bs::HLight& light : bs::gSceneManager().findComponents<bs::CLight>(false))
     {
-      const bs::Vector3& pos = c->SO()->getTransform().pos();
-
-      if (pos.squaredDistance(around) < rangeSq)
-      {
-        result.push_back(c);
-      }
+      mLightBudget.addLight(light);
     }
+  }
 
-    return result;
+  void GameWorld::setupAmbientSoundVoices()
+  {
+    mAmbientSoundVoices.reset();
+
+    for (const HAmbientSound& sound : bs::gSceneManager().findComponents<AmbientSound>(false))
+    {
+      mAmbientSoundVoices.addSound(sound);
+    }
   }
 
-  bs::Vector<HItem> GameWorld::findItemsInRange(float rangeInMeters, const bs::Vector3& around) const
+  void GameWorld::setupGroundItems()
   {
-    float rangeSq = rangeInMeters * rangeInMeters;
+    // The dormant ones are there already, from the import or the save
+    mGroundItems.reset(mAllItems);
+  }
 
-    bs::Vector<HItem> result;
+  void GameWorld::setupWorldPreloading()
+  {
+    mWorldPreloading.reset();
 
-    for (HItem i : mAllItems)
+    for (const HLevelChangeTrigger& trigger :
+         bs::gSceneManager().findComponents<LevelChangeTrigger>(false))
     {
-      if (i->SO()->getTransform().pos().squaredDistance(around) < rangeSq)
-      {
-        result.push_back(i);
-      }
+      mWorldPreloading.addTrigger(trigger);
     }
+  }
 
-    return result;
+  void GameWorld::findAllCharacters()
+  {
+    mAllCharacters = bs::gSceneManager().findComponents<Character>(false);
+
+    rebuildSpatialHashes();
   }
 
-  bs::Vector<HWaypoint> GameWorld::findWay(const bs::Vector3& from, const bs::Vector3& to)
+  void GameWorld::findAllItems()
   {
-    HWaypoint waypointFrom = waynet()->findClosestWaypointTo(from).closest;
-    HWaypoint waypointTo   = waynet()->findClosestWaypointTo(to).closest;
+    mAllItems = bs::gSceneManager().findComponents<Item>(false);
 
-    return waynet()->findWay(waypointFrom, waypointTo);
+    rebuildSpatialHashes();
   }
 
-  bs::Vector<HWaypoint> GameWorld::findWay(const bs::String& from, const bs::String& to)
+  void GameWorld::rebuildSpatialHashes()
   {
-    HWaypoint waypointFrom = waynet()->findWaypoint(from);
-    HWaypoint waypointTo   = waynet()->findWaypoint(to);
+    mCharactersByPosition.clear();
+    mItemsByPosition.clear();
 
-    if (!waypointFrom)
+    for (HCharacter c : mAllCharacters)
     {
-      auto offWaynetFrom = findObjectByName(from);
+      if (c.isDestroyed()) continue;
 
-      if (!offWaynetFrom) return {};
+      mCharactersByPosition.insert(c, c->SO()->getTransform().pos());
+      c->updateMappedPosition();
+    }
 
-      const auto& positionFrom = offWaynetFrom->getTransform().pos();
+    for (HItem i : mAllItems)
+    {
+      if (i.isDestroyed()) continue;
 
-      waypointFrom = waynet()->findClosestWaypointTo(positionFrom).closest;
+      mItemsByPosition.insert(i, i->SO()->getTransform().pos());
+      i->updateMappedPosition();
     }
+  }
 
-    if (!waypointTo)
-    {
-      auto offWaynetTo = findObjectByName(to);
+  HItem GameWorld::insertItem(const bs::String& instance, const bs::Transform& transform)
+  {
+    HGameWorld thisWorld = bs::static_object_cast<GameWorld>(getHandle());
+
+    bs::HSceneObject itemSO = bs::SceneObject::create(instance);
+    itemSO->setParent(SO());
+
+    itemSO->setPosition(transform.pos());
+    itemSO->setRotation(transform.rot());
 
-      if (!offWaynetTo) return {};
+    auto item = itemSO->addComponent<Item>(instance, thisWorld);
 
-      const auto& positionTo = offWaynetTo->getTransform().pos();
+    auto focusable = itemSO->addComponent<Focusable>();
 
-      waypointTo = waynet()->findClosestWaypointTo(positionTo).closest;
-    }
+    // TODO: Figure out the correct name to use for the focus text
+    focusable->setText(instance);
 
-    if (!waypointFrom) return {};
-    if (!waypointTo) return {};
+    mAllItems.push_back(item);
+    mItemsByPosition.insert(item, itemSO->getTransform().pos());
+    mGroundItems.onItemInserted(item);
+    item->updateMappedPosition();
+    addToFindByNameIndex(itemSO);
 
-    return waynet()->findWay(waypointFrom, waypointTo);
+    return item;
   }
 
-  void GameWorld::save(const bs::String& saveName)
+  HItem GameWorld::insertItem(const bs::String& instance, const bs::String& spawnPoint)
   {
-    bs::HPrefab cached = bs::Prefab::create(SO());
+    bs::Transform transform;
 
-    enum
+    if (!findSpawnPoint(spawnPoint, transform))
     {
-      Overwrite    = true,
-      KeepExisting = false,
-    };
+      // FIXME: What to do on invalid spawnpoints?
+      // REGOTH_THROW(InvalidParametersException,
+      //     bs::StringUtil::format("Spawnpoint {0} for item of instance {1} does not exist!",
+      //                            spawnPoint, instance));
+    }
 
-    // TODO: Should store at savegame location
-    bs::Path path = BsZenLib::GothicPathToCachedWorld(saveName);
-    bs::gResources().save(cached, path, Overwrite);
+    return insertItem(instance, transform);
   }
 
-  bs::HPrefab GameWorld::load(const bs::String& saveName)
+  HCharacter GameWorld::insertCharacter(const bs::String& instance, const bs::Transform& transform)
   {
-    // TODO: Should load at savegame location
-    bs::Path path = BsZenLib::GothicPathToCachedWorld(saveName);
+    HGameWorld thisWorld = bs::static_object_cast<GameWorld>(getHandle());
 
-    return bs::gResources().load<bs::Prefab>(path);
+    bs::HSceneObject characterSO = bs::SceneObject::create(instance);
+    characterSO->setParent(SO());
+
+    characterSO->setPosition(transform.pos());
+    characterSO->setRotation(transform.rot());
+
+    // All script-inserted characters will be disabled right after inserting them so they
+    // don't cause the game to slow down. If they are all active, physics will be calculated
+    // even for those out of reach which takes a huge hit on performance.
+    // The character-controller will be enabled by the AI or user input.
+    // ai->deactivatePhysics(); // Commented out for testing
+
+    auto character = characterSO->addComponent<Character>(instance, thisWorld);
+
+    mAllCharacters.push_back(character);
+    mCharactersByPosition.insert(character, characterSO->getTransform().pos());
+    character->updateMappedPosition();
+    addToFindByNameIndex(characterSO);
+    mSectorActivation.onCharacterInserted(character);
+
+    return character;
+  }
+
+  HCharacter GameWorld::insertCharacter(const bs::String& instance, const bs::String& spawnPoint)
+  {
+    bs::Transform transform;
+
+    if (!findSpawnPoint(spawnPoint, transform))
+    {
+      // FIXME: What to do on invalid spawnpoints?
+      // REGOTH_THROW(
+      //     InvalidParametersException,
+      //     bs::StringUtil::format("Spawnpoint '{0}' for character of instance {1} does not
+      //     exist!",
+      //                            spawnPoint, instance));
+    }
+
+    REGOTH_LOG(Info, World, "[GameWorld] Insert Character {0} at {1}", instance, spawnPoint);
+
+    return insertCharacter(instance, characterTransformAtSpawnPoint(transform));
+  }
+
+  bs::Transform GameWorld::characterTransformAtSpawnPoint(bs::Transform spawnPoint)
+  {
+    // FIXME: Can we move the center to the feet somehow instead?
+    spawnPoint.move(bs::Vector3(0, 0.5f, 0));
+
+    return spawnPoint;
+  }
+
+  void GameWorld::insertInBulk(const bs::Vector<Insertion>& insertions)
+  {
+    // Spawn points are shared by many insertions, e.g. all items in a chest
+    bs::UnorderedMap<bs::String, bs::Transform> spawnPoints;
+    bs::UnorderedSet<bs::String> missingSpawnPoints;
+    bs::UINT32 numCharacters = 0;
+
+    for (const Insertion& insertion : insertions)
+    {
+      if (spawnPoints.find(insertion.spawnPoint) == spawnPoints.end())
+      {
+        if (!findSpawnPoint(insertion.spawnPoint, spawnPoints[insertion.spawnPoint]))
+        {
+          missingSpawnPoints.insert(insertion.spawnPoint);
+        }
+      }
+
+      if (insertion.kind == Insertion::Kind::Character) numCharacters += 1;
+    }
+
+    bs::UINT32 numItems = (bs::UINT32)insertions.size() - numCharacters;
+
+    mAllCharacters.reserve(mAllCharacters.size() + numCharacters);
+    mAllItems.reserve(mAllItems.size() + numItems);
+    mSceneObjectsByName.reserve(mSceneObjectsByName.size() + insertions.size());
+
+    bs::UINT32 numMissingSpawnPoints = 0;
+
+    for (const Insertion& insertion : insertions)
+    {
+      const bs::Transform& transform = spawnPoints[insertion.spawnPoint];
+
+      if (missingSpawnPoints.count(insertion.spawnPoint) != 0)
+      {
+        // FIXME: What to do on invalid spawnpoints? See insertCharacter().
+        numMissingSpawnPoints += 1;
+      }
+
+      if (insertion.kind == Insertion::Kind::Character)
+      {
+        insertCharacter(insertion.instance, characterTransformAtSpawnPoint(transform));
+      }
+      else
+      {
+        insertItem(insertion.instance, transform);
+      }
+    }
+
+    REGOTH_LOG(Info, World,
+               "[GameWorld] Inserted {0} characters and {1} items, {2} without spawn point",
+               numCharacters, numItems, numMissingSpawnPoints);
+  }
+
+  void GameWorld::insertQueued()
+  {
+    // Inserting runs the constructors of the instances, which might queue even more
+    while (!mQueuedInsertions.empty())
+    {
+      bs::Vector<Insertion> insertions = std::move(mQueuedInsertions);
+      mQueuedInsertions.clear();
+
+      insertInBulk(insertions);
+    }
+  }
+
+  void GameWorld::reloadScripts()
+  {
+    std::vector<bs::UINT8> data;
+    gVirtualFileSystem().readFile("GOTHIC.DAT", data);
+
+    mScriptVM->reloadDAT(Scripting::DaedalusProgram::share(std::move(data)));
+  }
+
+  void GameWorld::initScriptVM()
+  {
+    REGOTH_STARTUP_STEP("DAT conversion");
+
+    std::vector<bs::UINT8> data;
+    gVirtualFileSystem().readFile("GOTHIC.DAT", data);
+
+    // Worlds running at the same time share the parsed DAT-file, see DaedalusProgram
+    mScriptVM = bs::bs_shared_ptr_new<Scripting::ScriptVMForGameWorld>(
+        bs::static_object_cast<GameWorld>(getHandle()),
+        Scripting::DaedalusProgram::share(std::move(data)));
+
+    // Converting the symbols and creating all information instances takes a while, so keep
+    // the result around until the scripts change.
+    bs::Path snapshot = BsZenLib::GothicPathToCachedWorld("GOTHIC.DAT.SCRIPTVM");
+
+    if (!mScriptVM->initializeFromSnapshot(snapshot))
+    {
+      mScriptVM->initialize();
+      mScriptVM->saveSnapshot(snapshot);
+    }
+  }
+
+  HGameWorld GameWorld::importZEN(const bs::String& zenFile, ZenLoading loading)
+  {
+    bs::HSceneObject rootSO = bs::SceneObject::create("root");
+
+    return rootSO->addComponent<GameWorld>(zenFile, loading);
+  }
+
+  void GameWorld::onImportedZEN()
+  {
+  }
+
+  void GameWorld::runInitScripts()
+  {
+    REGOTH_STARTUP_STEP("Init scripts");
+
+    mScriptVM->initializeWorld(worldName());
+
+    // The visuals set by the scripts have been loading in the background meanwhile. Waiting
+    // for the rest here keeps characters from popping in once the world is shown.
+    for (HCharacter character : mAllCharacters)
+    {
+      if (character.isDestroyed()) continue;
+
+      character->visual()->finishLoadingVisual();
+    }
+  }
+
+  HGameWorld GameWorld::createEmpty()
+  {
+    bs::HSceneObject rootSO = bs::SceneObject::create("root");
+
+    return rootSO->addComponent<GameWorld>(EmptyWorld);
+  }
+
+  void GameWorld::findWaynet()
+  {
+    bs::HSceneObject waynetSO = SO()->findChild("Waynet");
+
+    if (!waynetSO)
+    {
+      REGOTH_THROW(InvalidStateException, "No waynet found in this world?");
+    }
+
+    HWaynet waynet = waynetSO->getComponent<Waynet>();
+
+    if (!waynet)
+    {
+      REGOTH_THROW(InvalidStateException, "Waynet does not have Waynet component?");
+    }
+
+    mWaynet = waynet;
+  }
+
+  void GameWorld::setupWaynetCaches()
+  {
+    if (mZenFile.empty() || !mWaynet) return;
+
+    // Finding all shortest ways of a small waynet takes a while, keep them next to the world
+    mWaynet->setNextHopTableCache(BsZenLib::GothicPathToCachedWorld(mZenFile + ".NEXTHOPS"));
+  }
+
+  bs::String GameWorld::worldName() const
+  {
+    return mZenFile.substr(0, mZenFile.find_first_of('.'));
+  }
+
+  HCharacter GameWorld::hero() const
+  {
+    auto scriptObject = mScriptVM->heroInstance();
+
+    if (scriptObject == Scripting::SCRIPT_OBJECT_HANDLE_INVALID) return {};
+
+    bs::HSceneObject heroSO = mScriptVM->mapping().getMappedSceneObject(scriptObject);
+
+    return heroSO->getComponent<Character>();
+  }
+
+  bs::HSceneObject GameWorld::findObjectByName(const bs::String& name)
+  {
+    auto it = mSceneObjectsByName.find(name);
+
+    if (it == mSceneObjectsByName.end()) return {};
+
+    // Objects other than characters and items aren't expected to be destroyed, but if one is,
+    // act like it was never there
+    if (it->second.isDestroyed())
+    {
+      mSceneObjectsByName.erase(it);
+      return {};
+    }
+
+    return it->second;
+  }
+
+  bool GameWorld::findSpawnPoint(const bs::String& name, bs::Transform& transform)
+  {
+    WaypointIndex waypoint = waynet()->findWaypoint(name);
+
+    if (waypoint != NO_WAYPOINT)
+    {
+      transform = waynet()->waypointTransform(waypoint);
+      return true;
+    }
+
+    HFreepoint freepoint = waynet()->findFreepoint(name);
+
+    if (freepoint)
+    {
+      transform = freepoint->SO()->getTransform();
+      return true;
+    }
+
+    bs::HSceneObject so = findObjectByName(name);
+
+    if (!so) return false;
+
+    transform = so->getTransform();
+    return true;
+  }
+
+  void GameWorld::fillFindByNameIndex()
+  {
+    mSceneObjectsByName.clear();
+
+    // Depth first like findChild(), so the object found first by name is the same
+    bs::Vector<bs::HSceneObject> toVisit;
+    toVisit.push_back(SO());
+
+    while (!toVisit.empty())
+    {
+      bs::HSceneObject parent = toVisit.back();
+      toVisit.pop_back();
+
+      for (bs::UINT32 i = parent->getNumChildren(); i > 0; i--)
+      {
+        toVisit.push_back(parent->getChild(i - 1));
+      }
+
+      if (parent != SO())
+      {
+        addToFindByNameIndex(parent);
+      }
+    }
+  }
+
+  void GameWorld::addToFindByNameIndex(bs::HSceneObject so)
+  {
+    const bs::String& name = so->getName();
+
+    if (name.empty()) return;
+
+    bs::HSceneObject& entry = mSceneObjectsByName[name];
+
+    if (!entry || entry.isDestroyed())
+    {
+      entry = so;
+    }
+  }
+
+  void GameWorld::removeFromFindByNameIndex(bs::HSceneObject so)
+  {
+    auto it = mSceneObjectsByName.find(so->getName());
+
+    if (it != mSceneObjectsByName.end() && it->second == so)
+    {
+      mSceneObjectsByName.erase(it);
+    }
+  }
+
+  void GameWorld::findCharactersInRange(float rangeInMeters, const bs::Vector3& around,
+                                        bs::Vector<HCharacter>& result) const
+  {
+    mCharactersByPosition.findInRange(around, rangeInMeters, result);
+  }
+
+  ScratchVector<HCharacter> GameWorld::findCharactersInRange(float rangeInMeters,
+                                                             const bs::Vector3& around) const
+  {
+    ScratchVector<HCharacter> result = makeScratchVector<HCharacter>();
+    mCharactersByPosition.findInRange(around, rangeInMeters, result);
+
+    return result;
+  }
+
+  void GameWorld::findItemsInRange(float rangeInMeters, const bs::Vector3& around,
+                                   bs::Vector<HItem>& result) const
+  {
+    mItemsByPosition.findInRange(around, rangeInMeters, result);
+  }
+
+  ScratchVector<HItem> GameWorld::findItemsInRange(float rangeInMeters,
+                                                   const bs::Vector3& around) const
+  {
+    ScratchVector<HItem> result = makeScratchVector<HItem>();
+    mItemsByPosition.findInRange(around, rangeInMeters, result);
+
+    return result;
+  }
+
+  void GameWorld::onCharacterMoved(HCharacter character)
+  {
+    mCharactersByPosition.move(character, character->SO()->getTransform().pos());
+    character->updateMappedPosition();
+  }
+
+  void GameWorld::onItemMoved(HItem item)
+  {
+    mItemsByPosition.move(item, item->SO()->getTransform().pos());
+    item->updateMappedPosition();
+  }
+
+  void GameWorld::onCharacterDestroyed(HCharacter character)
+  {
+    mCharactersByPosition.remove(character);
+    mPerceptionSystem.removeCharacter(character);
+    mSectorActivation.removeCharacter(character);
+    removeFromFindByNameIndex(character->SO());
+
+    if (!mWaynet.isDestroyed())
+    {
+      mWaynet->releaseFreepointOf(character->SO());
+    }
+  }
+
+  void GameWorld::onItemDestroyed(HItem item)
+  {
+    // Items come and go with GroundItems, so the list would only ever grow otherwise
+    auto it = std::find(mAllItems.begin(), mAllItems.end(), item);
+
+    if (it != mAllItems.end())
+    {
+      *it = mAllItems.back();
+      mAllItems.pop_back();
+    }
+
+    mItemsByPosition.remove(item);
+    removeFromFindByNameIndex(item->SO());
+  }
+
+  bs::Vector<WaypointIndex> GameWorld::findWay(const bs::Vector3& from, const bs::Vector3& to)
+  {
+    WaypointIndex waypointFrom = waynet()->findClosestWaypointTo(from).closest;
+    WaypointIndex waypointTo   = waynet()->findClosestWaypointTo(to).closest;
+
+    return waynet()->findWay(waypointFrom, waypointTo);
+  }
+
+  bs::Vector<WaypointIndex> GameWorld::findWay(const bs::String& from, const bs::String& to)
+  {
+    WaypointIndex waypointFrom = waynet()->findWaypoint(from);
+    WaypointIndex waypointTo   = waynet()->findWaypoint(to);
+
+    bs::Transform offWaynet;
+
+    if (waypointFrom == NO_WAYPOINT)
+    {
+      if (!findSpawnPoint(from, offWaynet)) return {};
+
+      waypointFrom = waynet()->findClosestWaypointTo(offWaynet.pos()).closest;
+    }
+
+    if (waypointTo == NO_WAYPOINT)
+    {
+      if (!findSpawnPoint(to, offWaynet)) return {};
+
+      waypointTo = waynet()->findClosestWaypointTo(offWaynet.pos()).closest;
+    }
+
+    if (waypointFrom == NO_WAYPOINT) return {};
+    if (waypointTo == NO_WAYPOINT) return {};
+
+    return waynet()->findWay(waypointFrom, waypointTo);
+  }
+
+  void GameWorld::save(const bs::String& saveName, Internals::StaticGeometry staticGeometry)
+  {
+    if (staticGeometry == Internals::StaticGeometry::Merge)
+    {
+      Internals::mergeStaticGeometry(SO(), saveName);
+
+      // Merged vobs are gone, the new ones need to be known by sector
+      setupSectorActivation();
+      setupPortalVisibility();
+    }
+
+    // Leftover script objects would be saved as well
+    if (mScriptVM)
+    {
+      mScriptObjectCollector.collect(*mScriptVM);
+    }
+
+    bs::HPrefab cached = bs::Prefab::create(SO());
+
+    enum
+    {
+      Overwrite    = true,
+      KeepExisting = false,
+    };
+
+    // Worlds are large and decompressing them is quicker than reading all of it from disk.
+    // Loading finds out on its own whether a file is compressed, so older saves still load.
+    enum
+    {
+      Compress = true,
+    };
+
+    // TODO: Should store at savegame location
+    bs::Path path = BsZenLib::GothicPathToCachedWorld(saveName);
+    bs::gResources().save(cached, path, Overwrite, Compress);
+
+    // Lets loadOrImportZEN() find out whether the save is still up to date
+    if (!mZenFile.empty())
+    {
+      WorldCacheInfo::describe(mZenFile, mIsStreamed, SO())->save(WorldCacheInfo::pathFor(path));
+    }
+  }
+
+  void GameWorld::saveDelta(const bs::String& saveName)
+  {
+    enum
+    {
+      Overwrite = true,
+      Compress  = true,
+    };
+
+    // TODO: Should store at savegame location
+    bs::Path path = BsZenLib::GothicPathToCachedWorld(saveName);
+    bs::gResources().save(createDelta(), path, Overwrite, Compress);
+
+    // Otherwise load() would still pick up an older asynchronous save
+    if (bs::FileSystem::exists(asyncSavePath(saveName)))
+    {
+      bs::FileSystem::remove(asyncSavePath(saveName));
+    }
+  }
+
+  PendingSave GameWorld::saveDeltaAsync(const bs::String& saveName)
+  {
+    bs::HPrefab delta = createDelta();
+
+    // TODO: Should store at savegame location
+    // The regular save is kept to fall back to until this one has been read, see load()
+    return SaveGameFile::writeAsync(*delta.get(), asyncSavePath(saveName));
+  }
+
+  bs::HPrefab GameWorld::createDelta()
+  {
+    if (mZenFile.empty())
+    {
+      REGOTH_THROW(InvalidStateException, "Only worlds imported from a ZEN have static parts.");
+    }
+
+    for (HCharacter character : mAllCharacters)
+    {
+      if (!character.isDestroyed() && character->SO()->getParent() != SO())
+      {
+        character->SO()->setParent(SO());
+      }
+    }
+
+    for (HItem item : mAllItems)
+    {
+      if (!item.isDestroyed() && item->SO()->getParent() != SO())
+      {
+        item->SO()->setParent(SO());
+      }
+    }
+
+    bs::Vector<bs::HSceneObject> staticChildren;
+
+    for (bs::UINT32 i = 0; i < SO()->getNumChildren(); i++)
+    {
+      bs::HSceneObject child = SO()->getChild(i);
+
+      if (!isDynamicPart(child))
+      {
+        staticChildren.push_back(child);
+      }
+    }
+
+    // Moved out while the delta is made, so it doesn't see them
+    bs::HSceneObject staticParts = bs::SceneObject::create("StaticParts");
+
+    for (bs::HSceneObject child : staticChildren)
+    {
+      child->setParent(staticParts);
+    }
+
+    enum
+    {
+      Overwrite = true,
+      Compress  = true,
+    };
+
+    bs::Path staticPath = staticPartsPath(mZenFile);
+
+    if (!bs::FileSystem::exists(staticPath))
+    {
+      bs::gResources().save(bs::Prefab::create(staticParts), staticPath, Overwrite, Compress);
+
+      // Otherwise the next full save would refer to that prefab instead of holding them
+      staticParts->breakPrefabLink();
+    }
+
+    mIsSavedWithoutStaticParts = true;
+    bs::HPrefab delta          = bs::Prefab::create(SO());
+    mIsSavedWithoutStaticParts = false;
+
+    for (bs::HSceneObject child : staticChildren)
+    {
+      child->setParent(SO());
+    }
+
+    staticParts->destroy();
+
+    return delta;
+  }
+
+  bs::Path GameWorld::asyncSavePath(const bs::String& saveName)
+  {
+    return BsZenLib::GothicPathToCachedWorld(saveName + ".SAV");
+  }
+
+  bs::Path GameWorld::staticPartsPath(const bs::String& zenFile)
+  {
+    return BsZenLib::GothicPathToCachedWorld(zenFile + ".STATIC");
+  }
+
+  bool GameWorld::isDynamicPart(bs::HSceneObject child) const
+  {
+    return child->getComponent<Character>() || child->getComponent<Item>();
+  }
+
+  void GameWorld::attachStaticParts()
+  {
+    bs::HPrefab prefab = bs::gResources().load<bs::Prefab>(staticPartsPath(mZenFile));
+
+    if (!prefab)
+    {
+      REGOTH_THROW(InvalidStateException, "Static parts of " + mZenFile + " have not been saved.");
+    }
+
+    bs::HSceneObject staticParts = prefab->instantiate();
+    staticParts->breakPrefabLink();
+
+    while (staticParts->getNumChildren() > 0)
+    {
+      staticParts->getChild(0)->setParent(SO());
+    }
+
+    staticParts->destroy();
+
+    mIsSavedWithoutStaticParts = false;
+
+    findWaynet();
+
+    // Entries of static objects couldn't be resolved when loading
+    fillFindByNameIndex();
+  }
+
+  bs::HPrefab GameWorld::load(const bs::String& saveName)
+  {
+    REGOTH_STARTUP_STEP("World cache load");
+
+    // TODO: Should load at savegame location
+    bs::Path path = BsZenLib::GothicPathToCachedWorld(saveName);
+
+    // Written by saveDeltaAsync(), always newer than the regular save if both exist
+    if (bs::FileSystem::exists(asyncSavePath(saveName)))
+    {
+      bs::SPtr<bs::IReflectable> object = SaveGameFile::read(asyncSavePath(saveName));
+
+      if (!object || !bs::rtti_is_of_type<bs::Prefab>(object.get()))
+      {
+        REGOTH_LOG(Warning, World, "[GameWorld] Save {0} is broken, trying the regular save",
+                   saveName);
+
+        return bs::gResources().load<bs::Prefab>(path);
+      }
+
+      bs::SPtr<bs::Prefab> prefab = std::static_pointer_cast<bs::Prefab>(object);
+      prefab->_setThisPtr(prefab);
+      prefab->initialize();
+
+      // Has been read once, so nothing to fall back to is needed anymore
+      if (bs::FileSystem::exists(path))
+      {
+        bs::FileSystem::remove(path);
+      }
+
+      return bs::static_resource_cast<bs::Prefab>(bs::gResources()._createResourceHandle(prefab));
+    }
+
+    return bs::gResources().load<bs::Prefab>(path);
+  }
+
+  HGameWorld GameWorld::loadOrImportZEN(const bs::String& zenFile, const bs::String& saveName,
+                                        const std::function<void(HGameWorld)>& onImported,
+                                        ZenLoading loading)
+  {
+    using Staleness = WorldCacheInfo::Staleness;
+
+    bs::Path path = BsZenLib::GothicPathToCachedWorld(saveName);
+
+    bs::SPtr<WorldCacheInfo> info = WorldCacheInfo::load(WorldCacheInfo::pathFor(path));
+
+    // Saves from before the information was written have to be made again, too
+    Staleness staleness = Staleness::ZenChanged;
+    bs::Vector<bs::String> changedVisuals;
+
+    if (info && bs::FileSystem::exists(path))
+    {
+      staleness =
+          info->compareWithGameFiles(zenFile, loading == ZenLoading::Streamed, changedVisuals);
+    }
+
+    for (const bs::String& visual : changedVisuals)
+    {
+      Internals::removeCachedStaticMesh(visual);
+    }
+
+    // Delta saves of the outdated world are outdated as well, but not worth keeping track of
+    if (staleness != Staleness::UpToDate && bs::FileSystem::exists(staticPartsPath(zenFile)))
+    {
+      bs::FileSystem::remove(staticPartsPath(zenFile));
+    }
+
+    if (staleness == Staleness::UpToDate || staleness == Staleness::VisualsChanged)
+    {
+      bs::HPrefab prefab = load(saveName);
+      HGameWorld world;
+
+      if (prefab)
+      {
+        REGOTH_STARTUP_STEP("Prefab instantiate");
+        world = prefab->instantiate()->getComponent<GameWorld>();
+      }
+
+      if (world && staleness == Staleness::UpToDate)
+      {
+        return world;
+      }
+
+      if (world && world->reloadChangedVisuals(changedVisuals))
+      {
+        REGOTH_LOG(Info, World, "[GameWorld] Updated {0} changed static meshes in {1}",
+                   changedVisuals.size(), saveName);
+
+        world->save(saveName);
+
+        return world;
+      }
+
+      if (world)
+      {
+        world->SO()->destroy(true);
+      }
+    }
+
+    if (staleness == Staleness::ZenChanged)
+    {
+      Internals::removeCachedWorldMesh(zenFile);
+      WorldStreaming::removeCache(zenFile);
+    }
+
+    REGOTH_LOG(Info, World, "[GameWorld] {0} is outdated, importing {1} again",
+               saveName, zenFile);
+
+    HGameWorld world = importZEN(zenFile, loading);
+
+    if (onImported)
+    {
+      onImported(world);
+    }
+
+    world->save(saveName);
+
+    return world;
+  }
+
+  bs::String GameWorld::startingSaveName(const bs::String& zenFile)
+  {
+    return "WorldViewer-" + zenFile;
+  }
+
+  bs::String GameWorld::worldStateSaveName(const bs::String& zenFile)
+  {
+    return "WorldState-" + zenFile;
+  }
+
+  void GameWorld::saveWorldState()
+  {
+    saveDelta(worldStateSaveName(mZenFile));
+  }
+
+  HGameWorld GameWorld::loadWorldState(const bs::String& zenFile,
+                                       const std::function<void(HGameWorld)>& onImported,
+                                       ZenLoading loading)
+  {
+    bs::String saveName = worldStateSaveName(zenFile);
+
+    // loadOrImportZEN() removes the static parts once the ZEN changed, making the delta useless
+    bool isSaved = bs::FileSystem::exists(BsZenLib::GothicPathToCachedWorld(saveName)) ||
+                   bs::FileSystem::exists(asyncSavePath(saveName));
+
+    if (isSaved && bs::FileSystem::exists(staticPartsPath(zenFile)))
+    {
+      bs::HPrefab prefab = load(saveName);
+
+      if (prefab)
+      {
+        REGOTH_STARTUP_STEP("Prefab instantiate");
+        return prefab->instantiate()->getComponent<GameWorld>();
+      }
+    }
+
+    return loadOrImportZEN(zenFile, startingSaveName(zenFile), onImported, loading);
+  }
+
+  bs::Vector<bs::Path> GameWorld::worldStatePaths(const bs::String& zenFile)
+  {
+    bs::Path statePath = BsZenLib::GothicPathToCachedWorld(worldStateSaveName(zenFile));
+
+    if (bs::FileSystem::exists(statePath) && bs::FileSystem::exists(staticPartsPath(zenFile)))
+    {
+      return {statePath, staticPartsPath(zenFile)};
+    }
+
+    return {BsZenLib::GothicPathToCachedWorld(startingSaveName(zenFile))};
+  }
+
+  bool GameWorld::reloadChangedVisuals(const bs::Vector<bs::String>& visuals)
+  {
+    bs::UnorderedSet<bs::String> changed(visuals.begin(), visuals.end());
+
+    bs::Vector<bs::HSceneObject> affected;
+    bs::Vector<bs::HSceneObject> open = {SO()};
+
+    while (!open.empty())
+    {
+      bs::HSceneObject so = open.back();
+      open.pop_back();
+
+      for (bs::UINT32 i = 0; i < so->getNumChildren(); i++)
+      {
+        open.push_back(so->getChild(i));
+      }
+
+      HVisualStaticMesh visual = so->getComponent<VisualStaticMesh>();
+
+      if (!visual) continue;
+
+      for (const bs::String& file : visual->meshFileNames())
+      {
+        if (changed.find(file) == changed.end()) continue;
+
+        // The merged mesh would have to be made again from the original vobs
+        if (visual->isMerged()) return false;
+
+        affected.push_back(so);
+        break;
+      }
+    }
+
+    for (bs::HSceneObject so : affected)
+    {
+      Internals::reloadStaticMesh(so);
+    }
+
+    return true;
   }
 
   REGOTH_DEFINE_RTTI(GameWorld)
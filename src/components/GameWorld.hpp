@@ -2,8 +2,29 @@
 
 #include <BsPrerequisites.h>
 #include <Scene/BsComponent.h>
+#include <functional>
 
+#include <AI/LineOfSightQueue.hpp>
+#include <AI/PerceptionSystem.hpp>
+#include <AI/ScriptStateScheduler.hpp>
+#include <AI/WaypointIndex.hpp>
 #include <RTTI/RTTIUtil.hpp>
+#include <animation/RootMotionStage.hpp>
+#include <core/FrameScratch.hpp>
+#include <core/Random.hpp>
+#include <scripting/ScriptObjectCollector.hpp>
+#include <world/AmbientSoundVoices.hpp>
+#include <world/FocusSelection.hpp>
+#include <world/GroundItems.hpp>
+#include <world/LightBudget.hpp>
+#include <world/PortalVisibility.hpp>
+#include <world/SectorActivation.hpp>
+#include <world/SpatialHash.hpp>
+#include <world/SaveGameFile.hpp>
+#include <world/internals/MergeStaticGeometry.hpp>
+#include <world/WorldPreloading.hpp>
+#include <world/WorldSnapshots.hpp>
+#include <world/WorldStreaming.hpp>
 
 namespace REGoth
 {
@@ -19,12 +40,18 @@ namespace REGoth
   class Character;
   using HCharacter = bs::GameObjectHandle<Character>;
 
+  class CharacterAI;
+  using HCharacterAI = bs::GameObjectHandle<CharacterAI>;
+
+  class CharacterEventQueue;
+  using HCharacterEventQueue = bs::GameObjectHandle<CharacterEventQueue>;
+
+  class CharacterKeyboardInput;
+  using HCharacterKeyboardInput = bs::GameObjectHandle<CharacterKeyboardInput>;
+
   class GameWorld;
   using HGameWorld = bs::GameObjectHandle<GameWorld>;
 
-  class Waypoint;
-  using HWaypoint = bs::GameObjectHandle<Waypoint>;
-
   extern const char* const WORLD_STARTPOINT;
 
   namespace Scripting
@@ -79,6 +106,20 @@ namespace REGoth
    *    prefab->instantiate();
    *
    *
+   * Saves made via `saveDelta()` instead only hold what changes while playing: Characters,
+   * items, the script VM, the clock and everything else attached to the world itself. The
+   * static parts of the world, like its mesh, vobs and waynet, are saved once per ZEN and
+   * attached again when the delta is loaded via `load()` just like a full save.
+   *
+   *
+   * Example to import a ZEN once and load it from a save from then on, as long as the
+   * game files it was made from don't change:
+   *
+   *    HGameWorld gameWorld = GameWorld::loadOrImportZEN(
+   *        "OLDWORLD.ZEN", GameWorld::startingSaveName("OLDWORLD.ZEN"),
+   *        [](HGameWorld world) { world->runInitScripts(); });
+   *
+   *
    * World Script Engine
    * ===================
    *
@@ -91,6 +132,10 @@ namespace REGoth
    * Therefore, the GameWorld component also instantiates the correct Script VM
    * for executing world related script code, see `ScriptVMForGameWorld`.
    *
+   * Every world has a VM of its own, but the DAT-file itself never changes and is shared by
+   * all worlds of the process, see `Scripting::DaedalusProgram`. So many worlds running side
+   * by side only cost what each of them changes.
+   *
    *
    * Script Externals
    * ================
@@ -111,10 +156,23 @@ namespace REGoth
       EmptyWorld,
     };
 
+    /**
+     * How much of a ZEN is brought into the scene, see importZEN().
+     */
+    enum class ZenLoading
+    {
+      /** Everything is imported at once */
+      Full,
+
+      /** The static parts are streamed in around the hero, see WorldStreaming */
+      Streamed,
+    };
+
     /**
      * Imports a world from ZEN. See importZEN().
      */
-    GameWorld(const bs::HSceneObject& parent, const bs::String& zenFile);
+    GameWorld(const bs::HSceneObject& parent, const bs::String& zenFile,
+              ZenLoading loading = ZenLoading::Full);
     GameWorld(const bs::HSceneObject& parent, Empty empty);
 
     virtual ~GameWorld() override;
@@ -145,6 +203,185 @@ namespace REGoth
       return mGameClock;
     }
 
+    /**
+     * @return  Scheduler deciding when the script states of the characters in this world are run.
+     */
+    AI::ScriptStateScheduler& scriptStateScheduler()
+    {
+      return mScriptStateScheduler;
+    }
+
+    /**
+     * @return  Random numbers of this world, e.g. for `Hlp_Random`. Saved with the world and
+     *          seeded from gInputReplay(), so replays roll the same numbers. Only to be used
+     *          from the main thread, hand workers a Random::stream() instead.
+     */
+    Random& random()
+    {
+      return mRandom;
+    }
+
+    /**
+     * Adds the given queue to the ones processed by this world on every fixed update, see
+     * processEventQueues(). Destroyed queues are dropped automatically.
+     */
+    void registerEventQueue(HCharacterEventQueue queue);
+
+    /**
+     * Adds the given AI to the ones this world resolves root motion for and moves on every
+     * fixed update, see resolveRootMotion() and moveCharacters(). Destroyed AIs are dropped
+     * automatically.
+     */
+    void registerCharacterAI(HCharacterAI ai);
+
+    /**
+     * Sets the input of the player, which is handled first on every fixed update, see
+     * processPlayerInput(). There is only one, the last one set wins.
+     */
+    void registerKeyboardInput(HCharacterKeyboardInput input);
+
+    /**
+     * @return  Stage resolving the root motion of all moving characters on every fixed update.
+     */
+    RootMotionStage& rootMotionStage()
+    {
+      return mRootMotionStage;
+    }
+
+    /**
+     * How long the phases of the last fixed update took, see fixedUpdate().
+     */
+    struct FixedUpdateStats
+    {
+      bs::UINT64 nanosecondsPlayerInput = 0;
+      bs::UINT64 nanosecondsEventQueues = 0;
+      bs::UINT64 nanosecondsRootMotion  = 0;
+      bs::UINT64 nanosecondsMovement    = 0;
+      bs::UINT64 nanosecondsStreaming   = 0;
+    };
+
+    const FixedUpdateStats& lastFixedUpdateStats() const
+    {
+      return mLastFixedUpdateStats;
+    }
+
+    /**
+     * @return  Queue the pathfinders of the characters in this world do their line of sight
+     *          checks through.
+     */
+    AI::LineOfSightQueue& lineOfSightQueue()
+    {
+      return mLineOfSightQueue;
+    }
+
+    /**
+     * @return  Checks what the characters in this world perceive.
+     */
+    AI::PerceptionSystem& perceptionSystem()
+    {
+      return mPerceptionSystem;
+    }
+
+    /**
+     * @return  Decides which parts of this world are fully simulated.
+     */
+    SectorActivation& sectorActivation()
+    {
+      return mSectorActivation;
+    }
+
+    /**
+     * @return  Hides the static parts of this world which can't be seen through the portals.
+     */
+    PortalVisibility& portalVisibility()
+    {
+      return mPortalVisibility;
+    }
+
+    /**
+     * @return  Decides which of the lights of this world are turned on.
+     */
+    LightBudget& lightBudget()
+    {
+      return mLightBudget;
+    }
+
+    /**
+     * @return  Decides which of the ambient sounds of this world are playing.
+     */
+    AmbientSoundVoices& ambientSoundVoices()
+    {
+      return mAmbientSoundVoices;
+    }
+
+    /**
+     * @return  Decides which of the items lying around in this world are full items.
+     */
+    GroundItems& groundItems()
+    {
+      return mGroundItems;
+    }
+
+    /**
+     * @return  Loads the worlds the level changes of this one lead to ahead of time.
+     */
+    WorldPreloading& worldPreloading()
+    {
+      return mWorldPreloading;
+    }
+
+    /**
+     * @return  Tells the clients of a server what goes on in this world around them.
+     */
+    WorldSnapshots& worldSnapshots()
+    {
+      return mWorldSnapshots;
+    }
+
+    /**
+     * @return  Destroys the script objects of this world nothing refers to anymore.
+     */
+    Scripting::ScriptObjectCollector& scriptObjectCollector()
+    {
+      return mScriptObjectCollector;
+    }
+
+    /**
+     * @return  Decides which object the hero is focusing.
+     */
+    FocusSelection& focusSelection()
+    {
+      return mFocusSelection;
+    }
+
+    /**
+     * @return  Streams in the static parts of this world, if it is streamed.
+     */
+    WorldStreaming& worldStreaming()
+    {
+      return mWorldStreaming;
+    }
+
+    /**
+     * @return  Whether the static parts of this world are streamed in, see ZenLoading.
+     */
+    bool isStreamed() const
+    {
+      return mIsStreamed;
+    }
+
+    /**
+     * Reads GOTHIC.DAT again and switches the script VM over to it, keeping the state of the
+     * world. Meant for trying out changed scripts without restarting, see
+     * Scripting::DaedalusVM::reloadDAT().
+     *
+     * @note   Components only keeping the index of a symbol, like the state functions of a
+     *         running AI state, are not told about this. Changes to the symbols before the
+     *         ones they refer to can make them call the wrong function until they look it up
+     *         again, e.g. when the next state is started.
+     */
+    void reloadScripts();
+
     /**
      * Access to the worlds ScriptVM with GOTHIC.DAT loaded.
      */
@@ -166,9 +403,14 @@ namespace REGoth
      * Since importing a ZEN can take a while, you can `save()` the
      * world afterwards and load from the save, which is much quicker.
      *
+     * A streamed world caches its static parts by sector the first time it
+     * is imported. From then on, those are not imported anymore, but only
+     * loaded where the hero or camera is, see WorldStreaming.
+     *
      * @return Handle to the imported GameWorld.
      */
-    static HGameWorld importZEN(const bs::String& zenFile);
+    static HGameWorld importZEN(const bs::String& zenFile,
+                                ZenLoading loading = ZenLoading::Full);
 
     /**
      * Creates an empty world.
@@ -178,22 +420,116 @@ namespace REGoth
     /**
      * Saves the current world and everything that goes with it to a
      * savegame with the given name.
+     *
+     * Optionally, the static geometry of the world is merged first, so the
+     * save holds far fewer scene objects and loads quicker. The world keeps
+     * the merged geometry afterwards. See Internals::mergeStaticGeometry().
      */
-    void save(const bs::String& saveName);
+    void save(const bs::String& saveName,
+              Internals::StaticGeometry staticGeometry = Internals::StaticGeometry::Keep);
 
     /**
-     * Loads the world with the given name previously saved via save().
+     * Saves only the dynamic state of this world to a savegame with the given name: The
+     * characters and items with everything attached to them, the script VM, the clock and
+     * the other components of the world itself.
+     *
+     * Everything else are the static parts of the world. They are saved separately once per
+     * ZEN the first time a delta of it is saved, see staticPartsPath(), and reused from then
+     * on. Loading the delta via load() attaches them again.
      *
-     * Throws if the save does not exist.
+     * Items and characters placed inside the ZEN are moved to be direct children of this SO
+     * first, so they don't end up in the static parts.
+     *
+     * References from characters to static objects are not kept, like that of a message to
+     * the mob it is about. Routes are found again through the waynet.
+     *
+     * Throws if the world wasn't imported from a ZEN.
+     */
+    void saveDelta(const bs::String& saveName);
+
+    /**
+     * Like saveDelta(), but only the snapshot of the world is taken right away. Compressing
+     * and writing it happens in the background, so quicksaving while playing doesn't hitch.
+     * Check the returned save once per frame to show its progress.
+     *
+     * The save is found by load() as well. A regular save under the same name is kept until
+     * load() has read this one, to fall back to if it turns out to be broken. Don't start
+     * another save under the same name before it is done.
+     */
+    PendingSave saveDeltaAsync(const bs::String& saveName);
+
+    /**
+     * Loads the world with the given name previously saved via save(), saveDelta() or
+     * saveDeltaAsync().
+     *
+     * If the save written by saveDeltaAsync() can't be read, the one written by save() or
+     * saveDelta() under the same name is loaded instead.
      *
      * @note   This is static since it makes no sense to create an empty
      *         world first since the prefab will already contain a properly
      *         set up scene object anyways.
      *
-     * @return Prefab of the saved world.
+     * @return Prefab of the saved world. Empty if there is no save which can be read.
      */
     static bs::HPrefab load(const bs::String& saveName);
 
+    /**
+     * Loads the world saved under the given name, unless the game files it was made from
+     * changed, see WorldCacheInfo. Otherwise, the ZEN is imported again, set up by the given
+     * function and saved under that name.
+     *
+     * If only some static meshes changed, just those are imported again and the vobs
+     * showing them are updated, unless they have been merged with others. Anything cached
+     * for what changed is thrown away.
+     *
+     * @param  zenFile     ZEN-file to import, e.g. `NEWWORLD.ZEN`.
+     * @param  saveName    Name of the save holding the world, see startingSaveName().
+     * @param  onImported  Sets up a freshly imported world before it is saved, e.g. by
+     *                     inserting the hero and running the init scripts.
+     * @param  loading     See importZEN().
+     */
+    static HGameWorld loadOrImportZEN(const bs::String& zenFile, const bs::String& saveName,
+                                      const std::function<void(HGameWorld)>& onImported,
+                                      ZenLoading loading = ZenLoading::Full);
+
+    /**
+     * @return Name of the save holding the given ZEN right after it has been imported and
+     *         set up, see loadOrImportZEN().
+     */
+    static bs::String startingSaveName(const bs::String& zenFile);
+
+    /**
+     * @return Name of the save holding the world of the given ZEN while the hero is in another
+     *         one, see saveWorldState().
+     */
+    static bs::String worldStateSaveName(const bs::String& zenFile);
+
+    /**
+     * Saves what changed in this world under worldStateSaveName(), so loadWorldState() finds
+     * it like it was left once the hero comes back. To be called before the hero moves over
+     * into another world. See saveDelta().
+     */
+    void saveWorldState();
+
+    /**
+     * Loads the world of the given ZEN as it was left, see saveWorldState(). Worlds the hero
+     * hasn't been to yet are loaded via loadOrImportZEN() from startingSaveName().
+     *
+     * Loading is quick if WorldPreloading has loaded the saves ahead of time.
+     *
+     * @param  onImported  See loadOrImportZEN().
+     * @param  loading     See importZEN().
+     */
+    static HGameWorld loadWorldState(const bs::String& zenFile,
+                                     const std::function<void(HGameWorld)>& onImported,
+                                     ZenLoading loading = ZenLoading::Full);
+
+    /**
+     * @return The saves loadWorldState() would load for the given ZEN, some of which may not
+     *         exist yet.
+     */
+    static bs::Vector<bs::Path> worldStatePaths(const bs::String& zenFile);
+
     /**
      * Runs the worlds init script.
      *
@@ -262,6 +598,44 @@ namespace REGoth
      */
     HCharacter insertCharacter(const bs::String& instance, const bs::Transform& transform);
 
+    /**
+     * A character or item to insert at a spawn point, see insertInBulk().
+     */
+    struct Insertion
+    {
+      enum class Kind
+      {
+        Character,
+        Item,
+      };
+
+      Kind kind;
+      bs::String instance;
+      bs::String spawnPoint;
+    };
+
+    /**
+     * Inserts many characters and items at their spawn points, in the given order. Does the
+     * same as calling insertCharacter() and insertItem() for each of them, but looks up every
+     * spawn point only once, makes room for all new objects up front and logs a summary
+     * instead of every single insertion. The world init scripts insert thousands of objects.
+     */
+    void insertInBulk(const bs::Vector<Insertion>& insertions);
+
+    /**
+     * Remembers the given insertion to be done later by insertQueued().
+     */
+    void queueInsertion(Insertion insertion)
+    {
+      mQueuedInsertions.push_back(std::move(insertion));
+    }
+
+    /**
+     * Does all insertions queued via queueInsertion() through insertInBulk(), including those
+     * queued while doing them.
+     */
+    void insertQueued();
+
     /**
      * @return The character currently set as hero. Empty handle if no hero is currently set.
      */
@@ -274,9 +648,9 @@ namespace REGoth
      * is faster than using bs::SceneObject::findChild(), which will recursivly go
      * through all children and check every single one of them.
      *
-     * If there are multiple objects with the given name, which one will be returned is
-     * undefined. Also, while this method does access a cached list of all objects, it
-     * may doesn't find an object and has to search for it which could take a little longer.
+     * Only the objects imported from the ZEN and the characters and items inserted
+     * afterwards can be found. If there are multiple objects with the given name, the one
+     * which was there first is returned.
      *
      * @param  name  Name to search for.
      *
@@ -284,31 +658,123 @@ namespace REGoth
      */
     bs::HSceneObject findObjectByName(const bs::String& name);
 
+    /**
+     * Finds the spot scripts mean by the given name, which is the waypoint with that name or,
+     * if there is none, the freepoint or any other object with it, see Waynet::findWaypoint(),
+     * Waynet::findFreepoint() and findObjectByName(). All of these are hash map lookups.
+     * Scripts use all of these as spawn points and destinations.
+     *
+     * @param  transform  Set to the transform of the spot, if it was found.
+     *
+     * @return Whether anything with the given name exists.
+     */
+    bool findSpawnPoint(const bs::String& name, bs::Transform& transform);
+
     /**
      * Finds all characters which are in the given range around the given location.
+     *
+     * Only looks at the characters close by, see SpatialHash.
+     *
+     * @param  result  Filled with the characters found, in no particular order. Anything in
+     *                 there is dropped, so the same vector can be reused to not allocate on
+     *                 every call.
+     *
+     * The overload without `result` returns the characters in frame memory, see
+     * FrameScratch, so it doesn't allocate either. Don't keep that list beyond the update.
      */
-    bs::Vector<HCharacter> findCharactersInRange(float rangeInMeters,
-                                                 const bs::Vector3& around) const;
+    void findCharactersInRange(float rangeInMeters, const bs::Vector3& around,
+                               bs::Vector<HCharacter>& result) const;
+    ScratchVector<HCharacter> findCharactersInRange(float rangeInMeters,
+                                                    const bs::Vector3& around) const;
     /**
      * Finds all items which are in the given range around the given location.
+     * See findCharactersInRange().
      */
-    bs::Vector<HItem> findItemsInRange(float rangeInMeters, const bs::Vector3& around) const;
+    void findItemsInRange(float rangeInMeters, const bs::Vector3& around,
+                          bs::Vector<HItem>& result) const;
+    ScratchVector<HItem> findItemsInRange(float rangeInMeters, const bs::Vector3& around) const;
+
+    /**
+     * To be called by characters and items whenever their scene object has moved, so they
+     * can be found by findCharactersInRange() and findItemsInRange().
+     */
+    void onCharacterMoved(HCharacter character);
+    void onItemMoved(HItem item);
+
+    /**
+     * To be called by characters and items when they are destroyed.
+     */
+    void onCharacterDestroyed(HCharacter character);
+    void onItemDestroyed(HItem item);
 
     /**
      * Finds a way between two locations given by name.
      *
-     * For both names, the method first determines whether they belong to a freepoint. If not,
-     * all objects are searched for one with that name, which includes freepoints and other
-     * objects.
+     * For both names, the method first determines whether they belong to a waypoint. If not,
+     * the way starts or ends at the waypoint closest to what findSpawnPoint() finds instead.
      *
      * @return List of all waypoints that need to be visited. Will be empty if no path was found.
      */
-    bs::Vector<HWaypoint> findWay(const bs::String& from, const bs::String& to);
-    bs::Vector<HWaypoint> findWay(const bs::Vector3& from, const bs::Vector3& to);
+    bs::Vector<WaypointIndex> findWay(const bs::String& from, const bs::String& to);
+    bs::Vector<WaypointIndex> findWay(const bs::Vector3& from, const bs::Vector3& to);
 
   protected:
     void onInitialized() override;
 
+    /**
+     * Ends the frame of gFrameScratch(), so everything the game logic allocated there during
+     * the last frame is released. Also tells gStartupProfiler(), gFrameMonitor() and
+     * gMetrics() that a frame has started.
+     */
+    void update() override;
+
+    /**
+     * Runs the game logic of the world in a fixed order of phases, so every phase sees what
+     * the ones before it did during the same update:
+     *
+     *  1. processPlayerInput(): The player decides what the hero does,
+     *  2. processEventQueues(): Scripts and AI decide what the characters do,
+     *  3. resolveRootMotion(): The animations tell how far the characters want to move,
+     *  4. moveCharacters(): The characters move and turn,
+     *  5. updateStreaming(): What's loaded and active follows where the hero is now.
+     */
+    void fixedUpdate() override;
+
+    /**
+     * Acts on the input of the player, before any script or AI runs. That way, the input of
+     * a frame moves the hero during the very next fixed update and doesn't wait for the
+     * script states of the other characters, however much of their budget those take.
+     */
+    void processPlayerInput();
+
+    /**
+     * Runs mRootMotionStage on all characters whose AI is going to ask for root motion.
+     */
+    void resolveRootMotion();
+
+    /**
+     * Moves all characters by their root motion and physics, instead of every CharacterAI
+     * doing so in its own fixedUpdate().
+     */
+    void moveCharacters();
+
+    /**
+     * Streams in the world, activates its sectors and streams textures around the hero, or
+     * around the camera if there is no hero.
+     */
+    void updateStreaming();
+
+    /**
+     * Hands the stats of this world's subsystems to gMetrics(), right before it exports them.
+     */
+    void recordMetrics();
+
+    /**
+     * Processes the event queues and script states of all characters in one loop, instead of
+     * every CharacterEventQueue doing so in its own fixedUpdate().
+     */
+    void processEventQueues();
+
     /**
      * Called when a ZEN-file has been successfully imported.
      */
@@ -328,10 +794,62 @@ namespace REGoth
     void findWaynet();
 
     /**
-     * Clears and fills the mSceneObjectsByNameCached map with objects being
-     * in the scene right now.
+     * @return Where the static parts of worlds imported from the given ZEN are saved, see
+     *         saveDelta().
      */
-    void fillFindByNameCache();
+    static bs::Path staticPartsPath(const bs::String& zenFile);
+
+    /**
+     * @return Where saveDeltaAsync() writes the save with the given name to.
+     */
+    static bs::Path asyncSavePath(const bs::String& saveName);
+
+    /**
+     * @return Prefab of the dynamic parts of this world, see saveDelta(). Saves the static
+     *         parts first if they haven't been yet.
+     */
+    bs::HPrefab createDelta();
+
+    /**
+     * @return Whether the given direct child of this SO goes into a delta save.
+     */
+    bool isDynamicPart(bs::HSceneObject child) const;
+
+    /**
+     * Instantiates the static parts saved for this world's ZEN and makes them children of
+     * this SO again, after loading a delta save.
+     *
+     * Throws if they have not been saved.
+     */
+    void attachStaticParts();
+
+    /**
+     * Tells the waynet where to keep the data it computes from the waypoints, so it doesn't
+     * need to be computed again on the next start. Does nothing on worlds without a ZEN.
+     */
+    void setupWaynetCaches();
+
+    /**
+     * @return Where a character is placed when inserted at a spawn point with the given
+     *         transform.
+     */
+    static bs::Transform characterTransformAtSpawnPoint(bs::Transform spawnPoint);
+
+    /**
+     * Clears and fills mSceneObjectsByName with the objects being in the scene right now.
+     */
+    void fillFindByNameIndex();
+
+    /**
+     * Adds the given object to mSceneObjectsByName, unless there is another live object with
+     * the same name already.
+     */
+    void addToFindByNameIndex(bs::HSceneObject so);
+
+    /**
+     * Removes the given object from mSceneObjectsByName, if it is the one found by its name.
+     */
+    void removeFromFindByNameIndex(bs::HSceneObject so);
 
     /**
      * Fills mAllCharacters, mAllItems, and so on.
@@ -339,11 +857,73 @@ namespace REGoth
     void findAllCharacters();
     void findAllItems();
 
+    /**
+     * Fills mCharactersByPosition and mItemsByPosition from mAllCharacters and mAllItems.
+     */
+    void rebuildSpatialHashes();
+
+    /**
+     * Sets up mSectorActivation with the characters and static vobs of this world.
+     */
+    void setupSectorActivation();
+
+    /**
+     * Sets up mPortalVisibility with the cached portal map of this world, the static vobs and
+     * the tiles of the world mesh.
+     */
+    void setupPortalVisibility();
+
+    /**
+     * Sets up mLightBudget with the lights of this world.
+     */
+    void setupLightBudget();
+
+    /**
+     * Sets up mAmbientSoundVoices with the ambient sounds of this world.
+     */
+    void setupAmbientSoundVoices();
+
+    /**
+     * Sets up mGroundItems with the items of this world.
+     */
+    void setupGroundItems();
+
+    /**
+     * Sets up mWorldPreloading with the level changes of this world.
+     */
+    void setupWorldPreloading();
+
+    /**
+     * Imports the ZEN of a streamed world. Creates the sector cache first, if there is none.
+     *
+     * @return See Internals::constructFromZEN().
+     */
+    bs::HSceneObject importStreamedZEN();
+
+    /**
+     * Sets up the vobs showing the given static meshes again, see
+     * Internals::reloadStaticMesh().
+     *
+     * @return False if some of them were merged into a single mesh, which needs a full
+     *         import to be made again. Nothing has been changed then.
+     */
+    bool reloadChangedVisuals(const bs::Vector<bs::String>& visuals);
+
     /**
      * ZEN-File this world was created from, e.g. `NEWWORLD.ZEN`.
      */
     bs::String mZenFile;
 
+    /**
+     * Whether the static parts of this world are streamed in, see ZenLoading.
+     */
+    bool mIsStreamed = false;
+
+    /**
+     * Only set while saving a delta, so loading it knows to attach the static parts again.
+     */
+    bool mIsSavedWithoutStaticParts = false;
+
     /**
      * Access to the Waynet of this world.
      */
@@ -360,13 +940,115 @@ namespace REGoth
     bs::SPtr<Scripting::ScriptVMForGameWorld> mScriptVM;
 
     /**
-     * Contains a list of most scene objects by their names. This is used to find
-     * object quicker than using findChild(), but it might be missing some objects,
-     * so remember to do an actual findChild() if your object wasn't found in here.
-     *
-     * Does not need to be saved as the cache can be built up on the fly again.
+     * Not saved, the game sets it up again after loading.
+     */
+    AI::ScriptStateScheduler mScriptStateScheduler;
+
+    /**
+     * See random(). Saved.
      */
-    bs::UnorderedMap<bs::String, bs::HSceneObject> mSceneObjectsByNameCached;
+    Random mRandom;
+
+    /**
+     * Not saved, only holds the settings of the stage.
+     */
+    RootMotionStage mRootMotionStage;
+
+    /** Visuals passed to mRootMotionStage, kept to not allocate every fixed update */
+    bs::Vector<VisualSkeletalAnimation*> mRootMotionVisuals;
+
+    /**
+     * See registerEventQueue(). Not saved, queues register again once they are loaded.
+     */
+    bs::Vector<HCharacterEventQueue> mEventQueues;
+
+    /**
+     * See registerCharacterAI(). Kept next to each other, so the loops over all characters on
+     * every fixed update don't have to look up the AI component of each character first. Not
+     * saved, AIs register again once they are loaded.
+     */
+    bs::Vector<HCharacterAI> mCharacterAIs;
+
+    /** See registerKeyboardInput(). Not saved, registers again once loaded. */
+    HCharacterKeyboardInput mKeyboardInput;
+
+    /** See lastFixedUpdateStats() */
+    FixedUpdateStats mLastFixedUpdateStats;
+
+    /**
+     * Not saved, only holds the checks of a single frame.
+     */
+    AI::LineOfSightQueue mLineOfSightQueue;
+
+    /**
+     * Not saved, the scripts enable the perceptions again after loading.
+     */
+    AI::PerceptionSystem mPerceptionSystem;
+
+    /**
+     * See queueInsertion(). Not saved, the scripts only queue insertions while inserting
+     * is bound to happen before the next save.
+     */
+    bs::Vector<Insertion> mQueuedInsertions;
+
+    /**
+     * Not saved, set up again after loading from the characters and vobs.
+     */
+    SectorActivation mSectorActivation;
+
+    /**
+     * Not saved, set up again after loading from the cached portal map.
+     */
+    PortalVisibility mPortalVisibility;
+
+    /**
+     * Not saved, set up again after loading from the lights of the vobs.
+     */
+    LightBudget mLightBudget;
+
+    /**
+     * Not saved, set up again after loading from the ambient sounds of the vobs.
+     */
+    AmbientSoundVoices mAmbientSoundVoices;
+
+    /**
+     * Only the dormant items are saved, see RTTI_GameWorld. The rest is set up again after
+     * loading from the items of the world.
+     */
+    GroundItems mGroundItems;
+
+    /**
+     * Not saved, set up again after loading from the level changes of the world.
+     */
+    WorldPreloading mWorldPreloading;
+
+    /**
+     * Not saved, clients connect again after loading.
+     */
+    WorldSnapshots mWorldSnapshots;
+
+    /**
+     * Not saved, unreferenced objects are looked for again after loading.
+     */
+    Scripting::ScriptObjectCollector mScriptObjectCollector;
+
+    /**
+     * Not saved, the focus is chosen again after loading.
+     */
+    FocusSelection mFocusSelection;
+
+    /**
+     * Not saved, started again after loading and instances of sectors saved with the world
+     * are thrown away.
+     */
+    WorldStreaming mWorldStreaming;
+
+    /**
+     * Scene objects by their names, see findObjectByName(). Filled once after importing the ZEN
+     * and then kept up to date while characters and items come and go. Saved, so loading a
+     * world doesn't need to go through the whole scene again.
+     */
+    bs::UnorderedMap<bs::String, bs::HSceneObject> mSceneObjectsByName;
 
     /**
      * Access to every character, item and others. Not saved, can be built after loading.
@@ -375,6 +1057,14 @@ namespace REGoth
     bs::Vector<HCharacter> mAllCharacters;
     bs::Vector<HItem> mAllItems;
 
+    /**
+     * Characters and items by where they are, see findCharactersInRange(). Not saved, since
+     * they are rebuilt from the lists above after loading and kept up to date by the
+     * characters and items themselves.
+     */
+    SpatialHash<HCharacter> mCharactersByPosition;
+    SpatialHash<HItem> mItemsByPosition;
+
     /**
      * Used to skip onInitialized() when loading via RTTI.
      */
@@ -7,6 +7,7 @@
 #include <components/UIDialogueChoice.hpp>
 #include <components/UIFocusText.hpp>
 #include <components/UIInventory.hpp>
+#include <components/UIProfilerOverlay.hpp>
 #include <components/UISubtitleBox.hpp>
 #include <exception/Throw.hpp>
 
@@ -47,6 +48,11 @@ namespace REGoth
     {
       mInventoryUI = addChildElement<UIInventory>("UIInventory");
     }
+
+    if (!mProfilerOverlay)
+    {
+      mProfilerOverlay = addChildElement<UIProfilerOverlay>("UIProfilerOverlay");
+    }
   }
 
   void GameplayUI::createGlobal(bs::HCamera camera)
@@ -88,5 +94,10 @@ namespace REGoth
     return s_GameplayUI;
   }
 
+  bool hasGameplayUI()
+  {
+    return (bool)s_GameplayUI;
+  }
+
   REGOTH_DEFINE_RTTI(GameplayUI)
 }  // namespace REGoth
@@ -16,6 +16,9 @@ namespace REGoth
   class UIInventory;
   using HUIInventory = bs::GameObjectHandle<UIInventory>;
 
+  class UIProfilerOverlay;
+  using HUIProfilerOverlay = bs::GameObjectHandle<UIProfilerOverlay>;
+
   class GameplayUI;
   using HGameplayUI = bs::GameObjectHandle<GameplayUI>;
 
@@ -111,6 +114,7 @@ namespace REGoth
     HUISubtitleBox mSubtitleBox;
     HUIFocusText mFocusText;
     HUIInventory mInventoryUI;
+    HUIProfilerOverlay mProfilerOverlay;
 
   private:
   public:
@@ -129,4 +133,10 @@ namespace REGoth
    * Throws, if GameplayUI::createGlobal() has not been called.
    */
   HGameplayUI gGameplayUI();
+
+  /**
+   * @return Whether GameplayUI::createGlobal() has been called, i.e. gGameplayUI() doesn't
+   *         throw.
+   */
+  bool hasGameplayUI();
 }  // namespace REGoth
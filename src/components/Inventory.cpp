@@ -1,11 +1,15 @@
 #include "Inventory.hpp"
+#include <algorithm>
 #include <RTTI/RTTI_Inventory.hpp>
+#include <components/GameWorld.hpp>
 #include <log/logging.hpp>
+#include <scripting/ScriptVMForGameWorld.hpp>
 
 namespace REGoth
 {
-  Inventory::Inventory(const bs::HSceneObject& parent)
+  Inventory::Inventory(const bs::HSceneObject& parent, HGameWorld gameWorld)
       : bs::Component(parent)
+      , mGameWorld(gameWorld)
   {
     setName("Inventory");
   }
@@ -14,76 +18,214 @@ namespace REGoth
   {
   }
 
-  bool Inventory::hasItem(const bs::String& instance) const
+  bool Inventory::hasItem(Scripting::SymbolIndex instance) const
   {
-    throwIfNotUpperCase(instance);
+    return itemCount(instance) != 0;
+  }
 
-    return mItemCountByInstance.find(instance) != mItemCountByInstance.end();
+  bool Inventory::hasItem(const bs::String& instance) const
+  {
+    return hasItem(findInstance(instance));
   }
 
-  bs::UINT32 Inventory::itemCount(const bs::String& instance) const
+  bs::UINT32 Inventory::itemCount(Scripting::SymbolIndex instance) const
   {
-    throwIfNotUpperCase(instance);
+    auto it = findStack(instance);
 
-    auto it = mItemCountByInstance.find(instance);
+    if (it == mItems.end() || it->instance != instance) return 0;
 
-    if (it == mItemCountByInstance.end()) return 0;
+    return it->count;
+  }
 
-    return it->second;
+  bs::UINT32 Inventory::itemCount(const bs::String& instance) const
+  {
+    return itemCount(findInstance(instance));
+  }
+
+  void Inventory::giveItem(Scripting::SymbolIndex instance, bs::UINT32 count)
+  {
+    giveItems({{instance, count}});
   }
 
   void Inventory::giveItem(const bs::String& instance, bs::UINT32 count)
   {
-    throwIfNotUpperCase(instance);
+    giveItem(findInstance(instance), count);
+  }
+
+  void Inventory::giveItems(const bs::Vector<ItemStack>& items)
+  {
+    for (const auto& item : items)
+    {
+      if (item.count == 0)
+      {
+        REGOTH_THROW(InvalidParametersException, "Count cannot be 0");
+      }
+    }
 
-    REGOTH_LOG(Info, Uncategorized, "[Inventory] Add {0}x item {1} to Inventory of {2}", count,
-               instance, SO()->getName());
+    bs::Vector<Scripting::SymbolIndex> changed;
+    changed.reserve(items.size());
 
-    if (count == 0)
+    for (const auto& item : items)
     {
-      REGOTH_THROW(InvalidParametersException, "Count cannot be 0");
+      REGOTH_LOG(Info, Uncategorized, "[Inventory] Add {0}x item {1} to Inventory of {2}",
+                 item.count, itemName(item.instance), SO()->getName());
+
+      addToStack(item.instance, item.count);
+      changed.push_back(item.instance);
     }
 
-    mItemCountByInstance[instance] += 1;
+    mItemsVersion += 1;
 
-    OnItemChanged(instance);
+    OnItemsChanged(changed);
+  }
+
+  void Inventory::removeItem(Scripting::SymbolIndex instance, bs::UINT32 count)
+  {
+    removeItems({{instance, count}});
   }
 
   void Inventory::removeItem(const bs::String& instance, bs::UINT32 count)
   {
-    throwIfNotUpperCase(instance);
+    removeItem(findInstance(instance), count);
+  }
 
-    auto it = mItemCountByInstance.find(instance);
+  void Inventory::removeItems(const bs::Vector<ItemStack>& items)
+  {
+    // Check everything first, so nothing is removed if one of them fails. The same instance
+    // might be in there more than once.
+    bs::Map<Scripting::SymbolIndex, bs::UINT32> countByInstance;
 
-    if (it == mItemCountByInstance.end())
+    for (const auto& item : items)
     {
-      REGOTH_THROW(InvalidParametersException,
-                   bs::StringUtil::format("Trying to remove items of instance {1}, but there "
-                                          "are none of those in this inventory!",
-                                          instance));
+      countByInstance[item.instance] += item.count;
     }
 
-    if (it->second < count)
+    for (const auto& p : countByInstance)
     {
-      REGOTH_THROW(InvalidParametersException,
-                   bs::StringUtil::format("Trying to remove {0} items of instance {1}, but there "
-                                          "are only {2} instances of those in this inventory!",
-                                          count, instance, it->second));
+      bs::UINT32 available = itemCount(p.first);
+
+      if (available == 0)
+      {
+        REGOTH_THROW(InvalidParametersException,
+                     bs::StringUtil::format("Trying to remove items of instance {0}, but there "
+                                            "are none of those in this inventory!",
+                                            itemName(p.first)));
+      }
+
+      if (available < p.second)
+      {
+        REGOTH_THROW(InvalidParametersException,
+                     bs::StringUtil::format("Trying to remove {0} items of instance {1}, but "
+                                            "there are only {2} instances of those in this "
+                                            "inventory!",
+                                            p.second, itemName(p.first), available));
+      }
     }
 
-    it->second -= count;
+    bs::Vector<Scripting::SymbolIndex> changed;
+    changed.reserve(items.size());
 
-    if (it->second == 0)
+    for (const auto& item : items)
     {
-      mItemCountByInstance.erase(it);
+      removeFromStack(item.instance, item.count);
+      changed.push_back(item.instance);
     }
 
-    OnItemChanged(instance);
+    mItemsVersion += 1;
+
+    OnItemsChanged(changed);
+  }
+
+  const bs::Vector<Inventory::ItemStack>& Inventory::allItems() const
+  {
+    mapLoadedItems();
+
+    return mItems;
+  }
+
+  const bs::String& Inventory::itemName(Scripting::SymbolIndex instance) const
+  {
+    return mGameWorld->scriptVM().scriptSymbolsConst().getSymbolName(instance);
   }
 
-  const bs::Map<bs::String, bs::UINT32>& Inventory::allItems() const
+  Scripting::SymbolIndex Inventory::findInstance(const bs::String& instance) const
   {
-    return mItemCountByInstance;
+    const auto& symbols = mGameWorld->scriptVM().scriptSymbolsConst();
+
+    if (!symbols.hasSymbolWithName(instance))
+    {
+      throwIfNotUpperCase(instance);
+
+      REGOTH_THROW(InvalidParametersException, "Unknown item instance: " + instance);
+    }
+
+    return symbols.findIndexBySymbolName(instance);
+  }
+
+  bs::Vector<Inventory::ItemStack>::iterator Inventory::findStack(
+      Scripting::SymbolIndex instance)
+  {
+    mapLoadedItems();
+
+    return std::lower_bound(
+        mItems.begin(), mItems.end(), instance,
+        [](const ItemStack& stack, Scripting::SymbolIndex s) { return stack.instance < s; });
+  }
+
+  bs::Vector<Inventory::ItemStack>::const_iterator Inventory::findStack(
+      Scripting::SymbolIndex instance) const
+  {
+    return const_cast<Inventory*>(this)->findStack(instance);
+  }
+
+  void Inventory::addToStack(Scripting::SymbolIndex instance, bs::UINT32 count)
+  {
+    auto it = findStack(instance);
+
+    if (it == mItems.end() || it->instance != instance)
+    {
+      mItems.insert(it, ItemStack{instance, count});
+    }
+    else
+    {
+      it->count += count;
+    }
+  }
+
+  void Inventory::removeFromStack(Scripting::SymbolIndex instance, bs::UINT32 count)
+  {
+    auto it = findStack(instance);
+
+    it->count -= count;
+
+    if (it->count == 0)
+    {
+      mItems.erase(it);
+    }
+  }
+
+  void Inventory::mapLoadedItems() const
+  {
+    if (mLoadedItems.empty()) return;
+
+    // Moved out first, adding to the stacks looks at mLoadedItems again
+    bs::Map<bs::String, bs::UINT32> loaded = std::move(mLoadedItems);
+    mLoadedItems.clear();
+
+    const auto& symbols = mGameWorld->scriptVM().scriptSymbolsConst();
+
+    for (const auto& p : loaded)
+    {
+      if (!symbols.hasSymbolWithName(p.first) || p.second == 0)
+      {
+        REGOTH_LOG(Warning, Uncategorized, "[Inventory] Dropping unknown item {0} of {1}",
+                   p.first, SO()->getName());
+        continue;
+      }
+
+      const_cast<Inventory*>(this)->addToStack(symbols.findIndexBySymbolName(p.first),
+                                               p.second);
+    }
   }
 
   void Inventory::throwIfNotUpperCase(const bs::String& instance) const
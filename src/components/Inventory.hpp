@@ -2,9 +2,13 @@
 #include <RTTI/RTTIUtil.hpp>
 #include <Scene/BsComponent.h>
 #include <Utility/BsEvent.h>
+#include <scripting/ScriptTypes.hpp>
 
 namespace REGoth
 {
+  class GameWorld;
+  using HGameWorld = bs::GameObjectHandle<GameWorld>;
+
   class Inventory;
   using HInventory = bs::GameObjectHandle<Inventory>;
 
@@ -25,35 +29,74 @@ namespace REGoth
   class Inventory : public bs::Component
   {
   public:
-    Inventory(const bs::HSceneObject& parent);
+    Inventory(const bs::HSceneObject& parent, HGameWorld gameWorld);
     virtual ~Inventory();
 
+    /**
+     * Some items of the same instance.
+     */
+    struct ItemStack
+    {
+      /**
+       * Symbol of the script instance of the item, e.g. of `ITFOAPPLE`.
+       */
+      Scripting::SymbolIndex instance;
+
+      bs::UINT32 count;
+    };
+
     /**
      * Checks whether at least one item of the given instance is inside the inventory.
      *
-     * @param  instance  UPPERCASE Script instance name of the item to check.
+     * @param  instance  Symbol of the script instance of the item to check.
      *
      * @return Whether there is at least one item of the given instance in the inventory.
      */
+    bool hasItem(Scripting::SymbolIndex instance) const;
+
+    /**
+     * @copydoc hasItem(Scripting::SymbolIndex) const
+     *
+     * @param  instance  UPPERCASE Script instance name of the item to check.
+     */
     bool hasItem(const bs::String& instance) const;
 
     /**
-     * @param  instance  UPPERCASE Script instance name of the item to look for.
+     * @param  instance  Symbol of the script instance of the item to look for.
      *
      * @return How many items of the given instance are inside the inventory. Returns 0
      *         if there are none.
      */
+    bs::UINT32 itemCount(Scripting::SymbolIndex instance) const;
+
+    /**
+     * @copydoc itemCount(Scripting::SymbolIndex) const
+     *
+     * @param  instance  UPPERCASE Script instance name of the item to look for.
+     */
     bs::UINT32 itemCount(const bs::String& instance) const;
 
     /**
      * Creates items of the given instance and adds them to the inventory. Multiple items
      * can be added at once by modifying the `count` parameter.
      *
-     * @param  instance  UPPERCASE Script instance name of the item to create.
+     * @param  instance  Symbol of the script instance of the item to create.
      * @param  count     (Optional) How many instances of the item to add to the inventory.
      */
+    void giveItem(Scripting::SymbolIndex instance, bs::UINT32 count = 1);
+
+    /**
+     * @copydoc giveItem(Scripting::SymbolIndex, bs::UINT32)
+     *
+     * @param  instance  UPPERCASE Script instance name of the item to create.
+     */
     void giveItem(const bs::String& instance, bs::UINT32 count = 1);
 
+    /**
+     * Adds all of the given items at once, triggering OnItemsChanged only once.
+     */
+    void giveItems(const bs::Vector<ItemStack>& items);
+
     /**
      * Removes items of the given instance from the inventory. Multiple items can be removed
      * at once by modifying the `count` parameter.
@@ -61,34 +104,95 @@ namespace REGoth
      * Throws if no such item exists, so you should check that first.
      * Throws if not enough items exist.
      *
-     * @param  instance  UPPERCASE Script instance name of the item to remove.
+     * @param  instance  Symbol of the script instance of the item to remove.
      * @param  count     (Optional) How many instances of the item to remove from the inventory.
      */
+    void removeItem(Scripting::SymbolIndex instance, bs::UINT32 count = 1);
+
+    /**
+     * @copydoc removeItem(Scripting::SymbolIndex, bs::UINT32)
+     *
+     * @param  instance  UPPERCASE Script instance name of the item to remove.
+     */
     void removeItem(const bs::String& instance, bs::UINT32 count = 1);
 
     /**
-     * @return All item instances held by this inventory. Does not contain any
-     *         count information. All instances of which there is at least one
-     *         item of in the inventory will be included.
+     * Removes all of the given items at once, triggering OnItemsChanged only once.
+     *
+     * Throws like removeItem(). Nothing is removed then.
+     */
+    void removeItems(const bs::Vector<ItemStack>& items);
+
+    /**
+     * @return All items held by this inventory, sorted by their instance symbol. There is
+     *         exactly one stack for every instance of which there is at least one item.
      */
-    const bs::Map<bs::String, bs::UINT32>& allItems() const;
+    const bs::Vector<ItemStack>& allItems() const;
 
-    using OnItemCallback = void(const bs::String& instance);
- 
-    /** Events triggered when items got added or removed */
-    bs::Event<OnItemCallback> OnItemChanged;
+    /**
+     * @return Script instance name of the given item instance, e.g. `ITFOAPPLE`.
+     */
+    const bs::String& itemName(Scripting::SymbolIndex instance) const;
+
+    /**
+     * @return Changes whenever items are added or removed. Not serialized.
+     */
+    bs::UINT32 itemsVersion() const
+    {
+      return mItemsVersion;
+    }
+
+    using OnItemsCallback = void(const bs::Vector<Scripting::SymbolIndex>& instances);
+
+    /** Events triggered when items got added or removed, with the instances which changed */
+    bs::Event<OnItemsCallback> OnItemsChanged;
 
   private:
+    /**
+     * @return Symbol of the item instance with the given name. Throws if there is none.
+     */
+    Scripting::SymbolIndex findInstance(const bs::String& instance) const;
 
     void throwIfNotUpperCase(const bs::String& instance) const;
 
     /**
-     * Map of Item Instance to how many of those we have in this inventory.
-     * There should not be any instance with an amount of 0 in here, so if you
-     * just want to know whether there is at least one instance of an item in
-     * this inventory, it's enough to check whether such a key exists.
+     * @return Where the stack of the given instance is or would have to be inserted.
      */
-    bs::Map<bs::String, bs::UINT32> mItemCountByInstance;
+    bs::Vector<ItemStack>::iterator findStack(Scripting::SymbolIndex instance);
+    bs::Vector<ItemStack>::const_iterator findStack(Scripting::SymbolIndex instance) const;
+
+    /**
+     * Adds or removes items without triggering OnItemsChanged.
+     */
+    void addToStack(Scripting::SymbolIndex instance, bs::UINT32 count);
+    void removeFromStack(Scripting::SymbolIndex instance, bs::UINT32 count);
+
+    /**
+     * Moves the items inside mLoadedItems into mItems. Needs the script VM, which is why
+     * this is only done once the inventory is used after loading a saved game.
+     */
+    void mapLoadedItems() const;
+
+    /**
+     * How many items of each instance there are in this inventory, sorted by the instance.
+     * There should not be any stack with a count of 0 in here, so if you just want to know
+     * whether there is at least one instance of an item in this inventory, it's enough to
+     * check whether such a stack exists.
+     *
+     * Serialized by name, see RTTI_Inventory.
+     */
+    mutable bs::Vector<ItemStack> mItems;
+
+    /**
+     * Items loaded from a saved game which have not been put into mItems, by name. See
+     * mapLoadedItems().
+     */
+    mutable bs::Map<bs::String, bs::UINT32> mLoadedItems;
+
+    /** See itemsVersion() */
+    bs::UINT32 mItemsVersion = 0;
+
+    HGameWorld mGameWorld;
 
   public:
     REGOTH_DECLARE_RTTI(Inventory)
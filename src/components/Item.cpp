@@ -1,7 +1,10 @@
 #include "Item.hpp"
 #include "Visual.hpp"
 #include <RTTI/RTTI_Item.hpp>
+#include <Scene/BsSceneObject.h>
+#include <components/GameWorld.hpp>
 #include <scripting/ScriptObject.hpp>
+#include <scripting/ScriptVMForGameWorld.hpp>
 
 namespace REGoth
 {
@@ -11,10 +14,18 @@ namespace REGoth
     setName("Item");
   }
 
+  void Item::useAsItem()
+  {
+    gameWorld()->scriptVM().setItem(scriptObject());
+  }
+
   void Item::onInitialized()
   {
     bool isNewScriptObject = !hasInstantiatedScriptObject();
 
+    // Not saved, so needed after deserializing as well
+    setNotifyFlags(bs::TCF_Transform);
+
     ScriptBackedBy::onInitialized();
 
     // When loading a world from a saved prefab, the visual will already have been created.
@@ -26,9 +37,26 @@ namespace REGoth
 
   void Item::onDestroyed()
   {
+    HGameWorld world = gameWorld();
+
+    if (world && !world.isDestroyed())
+    {
+      world->onItemDestroyed(bs::static_object_cast<Item>(getHandle()));
+    }
+
     ScriptBackedBy::onDestroyed();
   }
 
+  void Item::onTransformChanged(bs::TransformChangedFlags flags)
+  {
+    HGameWorld world = gameWorld();
+
+    // Might not be set up yet while deserializing
+    if (!world || world.isDestroyed()) return;
+
+    world->onItemMoved(bs::static_object_cast<Item>(getHandle()));
+  }
+
   void Item::createVisual()
   {
     bs::String visual = scriptObjectData().stringValue("VISUAL");
@@ -17,11 +17,21 @@ namespace REGoth
   public:
     Item(const bs::HSceneObject& parent, const bs::String& instance, HGameWorld gameWorld);
 
+    /**
+     * Sets this item to be referenced by `ITEM` inside the scripts.
+     */
+    void useAsItem();
+
   protected:
 
     void onInitialized() override;
     void onDestroyed() override;
 
+    /**
+     * Lets the world know where this item is now, see GameWorld::onItemMoved().
+     */
+    void onTransformChanged(bs::TransformChangedFlags flags) override;
+
   private:
 
     /**
@@ -0,0 +1,22 @@
+#include "LevelChangeTrigger.hpp"
+#include <RTTI/RTTI_LevelChangeTrigger.hpp>
+
+namespace REGoth
+{
+  LevelChangeTrigger::LevelChangeTrigger(const bs::HSceneObject& parent,
+                                         const bs::String& zenFile,
+                                         const bs::String& startVobName)
+      : bs::Component(parent)
+      , mZenFile(zenFile)
+      , mStartVobName(startVobName)
+  {
+    setName("LevelChangeTrigger");
+  }
+
+  LevelChangeTrigger::~LevelChangeTrigger()
+  {
+  }
+
+  REGOTH_DEFINE_RTTI(LevelChangeTrigger)
+
+}  // namespace REGoth
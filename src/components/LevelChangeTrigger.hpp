@@ -0,0 +1,46 @@
+#pragma once
+#include <RTTI/RTTIUtil.hpp>
+#include <Scene/BsComponent.h>
+
+namespace REGoth
+{
+  class LevelChangeTrigger;
+  using HLevelChangeTrigger = bs::GameObjectHandle<LevelChangeTrigger>;
+
+  /**
+   * A place where the hero moves over into another world, like the pass from Khorinis into
+   * the Valley of Mines. Imported from the oCTriggerChangeLevel vobs of a ZEN.
+   *
+   * This only describes where the level change leads to. WorldPreloading uses it to load the
+   * other world in the background before the hero gets there.
+   */
+  class LevelChangeTrigger : public bs::Component
+  {
+  public:
+    LevelChangeTrigger(const bs::HSceneObject& parent, const bs::String& zenFile,
+                       const bs::String& startVobName);
+    virtual ~LevelChangeTrigger();
+
+    /** ZEN-file of the world the trigger leads to, e.g. `OLDWORLD.ZEN` */
+    const bs::String& zenFile() const
+    {
+      return mZenFile;
+    }
+
+    /** Name of the vob in the other world the hero is put at */
+    const bs::String& startVobName() const
+    {
+      return mStartVobName;
+    }
+
+  private:
+    bs::String mZenFile;
+    bs::String mStartVobName;
+
+  public:
+    REGOTH_DECLARE_RTTI(LevelChangeTrigger)
+
+  protected:
+    LevelChangeTrigger() = default;  // For RTTI
+  };
+}  // namespace REGoth
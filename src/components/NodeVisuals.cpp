@@ -8,6 +8,7 @@
 #include <components/Visual.hpp>
 #include <components/VisualStaticMesh.hpp>
 #include <log/logging.hpp>
+#include <original-content/SharedMaterials.hpp>
 
 namespace REGoth
 {
@@ -47,13 +48,14 @@ namespace REGoth
     bs::HBone bone = boneSO->addComponent<bs::CBone>();
     bone->setBoneName(node);
 
-    bool hasCreated = Visual::addToSceneObject(boneSO, visual);
+    // Usually done in the middle of the game, like when drawing a weapon
+    bool hasCreated = Visual::addToSceneObject(boneSO, visual, Visual::Loading::InBackground);
 
     if (!hasCreated)
     {
       clearNodeAttachment(node);
 
-      REGOTH_LOG(Warning, Uncategorized, "[NodeVisuals] Failed to attach visual '{0}' to node '{1}'",
+      REGOTH_LOG(Warning, Anim, "[NodeVisuals] Failed to attach visual '{0}' to node '{1}'",
                  visual, node);
     }
   }
@@ -77,7 +79,7 @@ namespace REGoth
 
     bs::HRenderable renderable = boneSO->addComponent<bs::CRenderable>();
     renderable->setMesh(mesh->getMesh());
-    renderable->setMaterials(mesh->getMaterials());
+    renderable->setMaterials(gSharedMaterials().find(mesh->getMaterials()));
   }
 
   void NodeVisuals::clearNodeAttachment(const bs::String& node)
@@ -90,6 +92,15 @@ namespace REGoth
     }
   }
 
+  bs::HSceneObject NodeVisuals::findNodeAttachment(const bs::String& node) const
+  {
+    bs::HSceneObject bone = SO()->findChild(node);
+
+    if (bone.isDestroyed()) return {};
+
+    return bone;
+  }
+
   bs::SPtr<bs::Skeleton> NodeVisuals::getSkeleton() const
   {
     bs::HRenderable renderable = SO()->getComponent<bs::CRenderable>();
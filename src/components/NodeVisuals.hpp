@@ -55,6 +55,13 @@ namespace REGoth
      */
     void clearNodeAttachment(const bs::String& node);
 
+    /**
+     * @param  node  Name of the node to look at.
+     *
+     * @return The scene object attached to the given node. Invalid if there is none.
+     */
+    bs::HSceneObject findNodeAttachment(const bs::String& node) const;
+
   private:
     /**
      * @return The current skeleton used by the scene objects renderable component.
@@ -30,6 +30,11 @@ namespace REGoth
     }
   }
 
+  void ScriptBackedBy::updateMappedPosition()
+  {
+    gameWorld()->scriptVM().mapping().setMappedPosition(mScriptObject, SO()->getTransform().pos());
+  }
+
   void ScriptBackedBy::onDestroyed()
   {
     if (gameWorld()->scriptVM().scriptObjects().isValid(mScriptObject))
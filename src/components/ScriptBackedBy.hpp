@@ -8,6 +8,7 @@ namespace REGoth
 {
   namespace Scripting
   {
+    class ScriptObjectMapping;
     class ScriptVMForGameWorld;
     struct ScriptObject;
   }  // namespace Scripting
@@ -51,6 +52,21 @@ namespace REGoth
                    const bs::String& instance, HGameWorld gameWorld);
     virtual ~ScriptBackedBy();
 
+    /**
+     * Tells the script object mapping where this scene object is now, see
+     * ScriptObjectMapping::setMappedPosition(). To be called whenever the scene object moved.
+     */
+    void updateMappedPosition();
+
+    /**
+     * @return Name of the instance the backing script object was created from, e.g.
+     *         `ITFO_APPLE`.
+     */
+    const bs::String& scriptInstance() const
+    {
+      return mScriptInstance;
+    }
+
   protected:
     void onInitialized() override;
     void onDestroyed() override;
@@ -89,6 +105,9 @@ namespace REGoth
     }
 
   private:
+    /** For looking up the script object of a scene object */
+    friend class Scripting::ScriptObjectMapping;
+
     /**
      * Instanciates the class backing this component. Must be called early, otherwise
      * exceptions will be thrown when accessing the script object data.
@@ -1,10 +1,18 @@
 #include <components/Sky.hpp>
 
+#include <cmath>
+#include <cstring>
 #include <memory>
 
+#include <Components/BsCRenderable.h>
+#include <Material/BsMaterial.h>
+#include <Math/BsMath.h>
+#include <Mesh/BsMesh.h>
+#include <RenderAPI/BsVertexDataDesc.h>
 #include <RenderAPI/BsViewport.h>
 #include <Renderer/BsCamera.h>
 #include <Scene/BsSceneManager.h>
+#include <Scene/BsSceneObject.h>
 
 #include <RTTI/RTTI_Sky.hpp>
 #include <components/GameClock.hpp>
@@ -14,8 +22,21 @@
 
 namespace REGoth
 {
+  /** Rings and segments of the dome mesh. The layers are sampled per pixel, so few suffice. */
+  constexpr bs::UINT32 DOME_RINGS    = 8;
+  constexpr bs::UINT32 DOME_SEGMENTS = 16;
+
+  /** Half the size of the plane mesh, relative to its height above the camera */
+  constexpr float PLANE_HALF_SIZE = 50.0f;
+
+  /** Layer speeds are given in texture repetitions per this many seconds */
+  constexpr float LAYER_SPEED_SECONDS = 100.0f;
+
+  /** The sky is drawn around the camera, wherever that is. Used to keep it from being culled. */
+  constexpr float SKY_BOUNDS_EXTENT = 1000000.0f;
+
   Sky::Sky(const bs::HSceneObject& parent, HGameWorld gameWorld, const RenderMode& renderMode,
-           const bs::Color& skyColor)
+           const bs::Color& skyColor, const bs::HShader& skyShader)
       : bs::Component{parent}
       , mSkyStateGen{skyColor, gameWorld->worldName()}
       , mGameWorld{gameWorld}
@@ -23,11 +44,7 @@ namespace REGoth
   {
     setName("Sky");
 
-    // TODO: Implement sky dome support for Gothic II.
-    if (renderMode == RenderMode::Dome)
-    {
-      REGOTH_THROW(NotImplementedException, "Dome sky not yet implemented.");
-    }
+    createSkyRenderable(skyShader);
   }
 
   Sky::~Sky()
@@ -38,12 +55,25 @@ namespace REGoth
   void Sky::update()
   {
     // Update the sky state.
-    const float dayRatio                     = mGameWorld->gameclock()->getDayRatio();
-    std::shared_ptr<const SkyState> skyState = mSkyStateGen.update(dayRatio);
+    const float dayRatio     = mGameWorld->gameclock()->getDayRatio();
+    const SkyState& skyState = mSkyStateGen.update(dayRatio);
+
+    // The fog only changes once per game minute or when the camera moves up or down
+    bool hasFogChanged = !mHasRenderedFog || skyState.fogColor != mRenderedFogColor ||
+                         skyState.fogNear != mRenderedFogNear ||
+                         skyState.fogFar != mRenderedFogFar;
+
+    if (hasFogChanged)
+    {
+      renderFog(skyState.fogColor, skyState.fogNear, skyState.fogFar);
 
-    // Render fog and sky.
-    renderFog(skyState->fogColor, skyState->fogNear, skyState->fogFar);
-    renderSky();
+      mRenderedFogColor = skyState.fogColor;
+      mRenderedFogNear  = skyState.fogNear;
+      mRenderedFogFar   = skyState.fogFar;
+      mHasRenderedFog   = true;
+    }
+
+    renderSky(skyState);
   }
 
   void Sky::renderFog(const bs::Color& fogColor, float fogNear, float fogFar) const
@@ -56,9 +86,168 @@ namespace REGoth
     camera->getViewport()->setClearColorValue(fogColor);
   }
 
-  void Sky::renderSky() const
+  void Sky::renderSky(const SkyState& skyState)
+  {
+    if (!mSkyMaterial) return;
+
+    SkyMaterialParams params;
+    params.domeColorUpper     = skyState.domeColorUpper;
+    params.fogColor           = skyState.fogColor;
+    params.skyLayerTexture    = skyState.skyLayer.texture;
+    params.cloudsLayerTexture = skyState.cloudsLayer.texture;
+    params.skyLayerSpeed      = skyState.skyLayer.textureSpeed / LAYER_SPEED_SECONDS;
+    params.cloudsLayerSpeed   = skyState.cloudsLayer.textureSpeed / LAYER_SPEED_SECONDS;
+    params.skyLayerAlpha      = skyState.skyLayer.textureAlpha;
+    params.skyLayerScale      = skyState.skyLayer.textureScale;
+    params.cloudsLayerAlpha   = skyState.cloudsLayer.textureAlpha;
+    params.cloudsLayerScale   = skyState.cloudsLayer.textureScale;
+
+    // Scrolling is done by the shader, so this only changes along with the sky state
+    if (mHasRenderedSky && params == mRenderedSkyParams) return;
+
+    mSkyMaterial->setColor("gDomeColorUpper", params.domeColorUpper);
+    mSkyMaterial->setColor("gFogColor", params.fogColor);
+    mSkyMaterial->setVec2("gSkyLayerSpeed", params.skyLayerSpeed);
+    mSkyMaterial->setVec2("gCloudsLayerSpeed", params.cloudsLayerSpeed);
+    mSkyMaterial->setFloat("gSkyLayerAlpha", params.skyLayerAlpha);
+    mSkyMaterial->setFloat("gSkyLayerScale", params.skyLayerScale);
+    mSkyMaterial->setFloat("gCloudsLayerAlpha", params.cloudsLayerAlpha);
+    mSkyMaterial->setFloat("gCloudsLayerScale", params.cloudsLayerScale);
+
+    if (!mHasRenderedSky || params.skyLayerTexture != mRenderedSkyParams.skyLayerTexture)
+    {
+      mSkyMaterial->setTexture("gSkyLayerTex", params.skyLayerTexture);
+    }
+
+    if (!mHasRenderedSky || params.cloudsLayerTexture != mRenderedSkyParams.cloudsLayerTexture)
+    {
+      mSkyMaterial->setTexture("gCloudsLayerTex", params.cloudsLayerTexture);
+    }
+
+    mRenderedSkyParams = params;
+    mHasRenderedSky    = true;
+  }
+
+  void Sky::createSkyRenderable(const bs::HShader& skyShader)
+  {
+    if (!skyShader)
+    {
+      REGOTH_THROW(InvalidParametersException, "No sky shader given!");
+    }
+
+    mSkyMaterial = bs::Material::create(skyShader);
+
+    bs::HMesh mesh = mRenderMode == RenderMode::Dome ? createDomeMesh() : createPlaneMesh();
+
+    // Created from scratch by every game session, so there is nothing to save
+    mSkySO = bs::SceneObject::create("SkyMesh", bs::SOF_DontSave);
+    mSkySO->setParent(SO());
+
+    bs::HRenderable renderable = mSkySO->addComponent<bs::CRenderable>();
+    renderable->setMesh(mesh);
+    renderable->setMaterial(mSkyMaterial);
+
+    const bs::Vector3 extent(SKY_BOUNDS_EXTENT, SKY_BOUNDS_EXTENT, SKY_BOUNDS_EXTENT);
+    renderable->setOverrideBounds(bs::AABox(-extent, extent));
+    renderable->setUseOverrideBounds(true);
+  }
+
+  bs::HMesh Sky::createDomeMesh()
+  {
+    // DOME_RINGS rings starting at the horizon, plus the single vertex at the top
+    const bs::UINT32 numVertices = DOME_RINGS * DOME_SEGMENTS + 1;
+    const bs::UINT32 numIndices  = ((DOME_RINGS - 1) * 6 + 3) * DOME_SEGMENTS;
+
+    bs::SPtr<bs::VertexDataDesc> vertexDesc = bs::VertexDataDesc::create();
+    vertexDesc->addVertElem(bs::VET_FLOAT3, bs::VES_POSITION);
+
+    bs::SPtr<bs::MeshData> data =
+        bs::MeshData::create(numVertices, numIndices, vertexDesc, bs::IT_32BIT);
+
+    bs::Vector<bs::Vector3> positions;
+    positions.reserve(numVertices);
+
+    // Ring 0 lies on the horizon
+    for (bs::UINT32 ring = 0; ring < DOME_RINGS; ring++)
+    {
+      float elevation = 0.5f * bs::Math::PI * ring / DOME_RINGS;
+
+      for (bs::UINT32 segment = 0; segment < DOME_SEGMENTS; segment++)
+      {
+        float azimuth = 2.0f * bs::Math::PI * segment / DOME_SEGMENTS;
+
+        positions.push_back(bs::Vector3(std::cos(elevation) * std::cos(azimuth),
+                                        std::sin(elevation),
+                                        std::cos(elevation) * std::sin(azimuth)));
+      }
+    }
+
+    const bs::UINT32 top = (bs::UINT32)positions.size();
+    positions.push_back(bs::Vector3::UNIT_Y);
+
+    data->setVertexData(bs::VES_POSITION, positions.data(),
+                        (bs::UINT32)(positions.size() * sizeof(bs::Vector3)));
+
+    bs::UINT32* indices = data->getIndices32();
+
+    for (bs::UINT32 segment = 0; segment < DOME_SEGMENTS; segment++)
+    {
+      bs::UINT32 next = (segment + 1) % DOME_SEGMENTS;
+
+      for (bs::UINT32 ring = 0; ring + 1 < DOME_RINGS; ring++)
+      {
+        bs::UINT32 lower = ring * DOME_SEGMENTS;
+        bs::UINT32 upper = lower + DOME_SEGMENTS;
+
+        *indices++ = lower + segment;
+        *indices++ = upper + segment;
+        *indices++ = lower + next;
+
+        *indices++ = lower + next;
+        *indices++ = upper + segment;
+        *indices++ = upper + next;
+      }
+
+      bs::UINT32 last = (DOME_RINGS - 1) * DOME_SEGMENTS;
+
+      *indices++ = last + segment;
+      *indices++ = top;
+      *indices++ = last + next;
+    }
+
+    return bs::Mesh::create(data);
+  }
+
+  bs::HMesh Sky::createPlaneMesh()
+  {
+    bs::SPtr<bs::VertexDataDesc> vertexDesc = bs::VertexDataDesc::create();
+    vertexDesc->addVertElem(bs::VET_FLOAT3, bs::VES_POSITION);
+
+    bs::SPtr<bs::MeshData> data = bs::MeshData::create(4, 6, vertexDesc, bs::IT_32BIT);
+
+    const bs::Vector3 positions[] = {
+        bs::Vector3(-PLANE_HALF_SIZE, 1.0f, -PLANE_HALF_SIZE),
+        bs::Vector3(PLANE_HALF_SIZE, 1.0f, -PLANE_HALF_SIZE),
+        bs::Vector3(PLANE_HALF_SIZE, 1.0f, PLANE_HALF_SIZE),
+        bs::Vector3(-PLANE_HALF_SIZE, 1.0f, PLANE_HALF_SIZE),
+    };
+
+    data->setVertexData(bs::VES_POSITION, const_cast<bs::Vector3*>(positions), sizeof(positions));
+
+    const bs::UINT32 indices[] = {0, 1, 2, 0, 2, 3};
+    std::memcpy(data->getIndices32(), indices, sizeof(indices));
+
+    return bs::Mesh::create(data);
+  }
+
+  bool Sky::SkyMaterialParams::operator==(const SkyMaterialParams& other) const
   {
-    // TODO: Render sky.
+    return domeColorUpper == other.domeColorUpper && fogColor == other.fogColor &&
+           skyLayerTexture == other.skyLayerTexture &&
+           cloudsLayerTexture == other.cloudsLayerTexture &&
+           skyLayerSpeed == other.skyLayerSpeed && cloudsLayerSpeed == other.cloudsLayerSpeed &&
+           skyLayerAlpha == other.skyLayerAlpha && skyLayerScale == other.skyLayerScale &&
+           cloudsLayerAlpha == other.cloudsLayerAlpha && cloudsLayerScale == other.cloudsLayerScale;
   }
 
   REGOTH_DEFINE_RTTI(Sky)
@@ -12,7 +12,12 @@ namespace REGoth
   using HGameWorld = bs::GameObjectHandle<GameWorld>;
 
   /**
-   * TODO: Documentation of Sky
+   * Draws the sky and sets the fog according to the time of day, see SkyStateGenerator.
+   *
+   * The sky is a single mesh with a single material, both created on construction: A dome in
+   * RenderMode::Dome and a plane above the camera in RenderMode::Plane. The shader (`Sky.bsl`)
+   * draws it around the camera behind everything else and scrolls and blends the layers, so
+   * each frame only the material parameters which the sky state changed are written.
    */
   class Sky : public bs::Component
   {
@@ -27,19 +32,67 @@ namespace REGoth
     };
 
     Sky(const bs::HSceneObject& parent, HGameWorld gameWorld, const RenderMode& renderMode,
-        const bs::Color& skyColor);
+        const bs::Color& skyColor, const bs::HShader& skyShader);
     virtual ~Sky() override;
 
     void update() override;
 
   private:
+    /**
+     * Everything inside the `SkyParams` block of the sky shader, plus the layer textures.
+     */
+    struct SkyMaterialParams
+    {
+      bs::Color domeColorUpper;
+      bs::Color fogColor;
+      bs::HTexture skyLayerTexture;
+      bs::HTexture cloudsLayerTexture;
+      bs::Vector2 skyLayerSpeed;
+      bs::Vector2 cloudsLayerSpeed;
+      float skyLayerAlpha    = 0.0f;
+      float skyLayerScale    = 0.0f;
+      float cloudsLayerAlpha = 0.0f;
+      float cloudsLayerScale = 0.0f;
+
+      bool operator==(const SkyMaterialParams& other) const;
+    };
+
     void renderFog(const bs::Color& color, float fogNear, float fogFar) const;
-    void renderSky() const;
+    void renderSky(const SkyState& skyState);
+
+    /**
+     * Creates the scene object drawing the sky with the given shader.
+     */
+    void createSkyRenderable(const bs::HShader& skyShader);
+
+    /**
+     * @return Mesh of a unit half sphere, open at the bottom.
+     */
+    static bs::HMesh createDomeMesh();
+
+    /**
+     * @return Mesh of a large horizontal quad one unit above the origin.
+     */
+    static bs::HMesh createPlaneMesh();
 
     SkyStateGenerator mSkyStateGen{bs::Color{}, bs::String{}};
     HGameWorld mGameWorld;
     const RenderMode mRenderMode = RenderMode::Plane;
 
+    /** What renderFog() was last called with, so it's only called on changes */
+    bool mHasRenderedFog = false;
+    bs::Color mRenderedFogColor;
+    float mRenderedFogNear = 0.0f;
+    float mRenderedFogFar  = 0.0f;
+
+    /** Draws the sky. Not saved, created again on construction */
+    bs::HSceneObject mSkySO;
+    bs::HMaterial mSkyMaterial;
+
+    /** What the sky material was last set to by renderSky(), so it's only set on changes */
+    bool mHasRenderedSky = false;
+    SkyMaterialParams mRenderedSkyParams;
+
   public:
     REGOTH_DECLARE_RTTI(Sky)
 
@@ -1,5 +1,6 @@
 #include <components/SkyStateGenerator.hpp>
 
+#include <algorithm>
 #include <memory>
 #include <tuple>
 
@@ -153,10 +154,12 @@ std::vector<SkyState> initPresets(const bs::Color& skyColor, const bs::String& w
   return presets;
 }
 
+constexpr bs::UINT32 SkyStateGenerator::LOOKUP_TABLE_SIZE;
+
 SkyStateGenerator::SkyStateGenerator(const bs::Color& skyColor, const bs::String& worldName)
     : mSkyStatePresets{initPresets(skyColor, worldName)}
 {
-  mCurrentSkyState = std::make_shared<SkyState>();
+  buildLookupTable();
 }
 
 SkyStateGenerator::~SkyStateGenerator()
@@ -164,17 +167,21 @@ SkyStateGenerator::~SkyStateGenerator()
   // pass
 }
 
-const std::shared_ptr<const SkyState> SkyStateGenerator::update(float dayRatio)
+const SkyState& SkyStateGenerator::update(float dayRatio)
 {
   // Set time to current state.
-  mCurrentSkyState->time = std::fmod(dayRatio + 0.5f, 1.0f);
+  mCurrentSkyState.time = std::fmod(dayRatio + 0.5f, 1.0f);
+
+  bs::UINT32 entry = static_cast<bs::UINT32>(mCurrentSkyState.time * LOOKUP_TABLE_SIZE);
+  entry            = std::min(entry, LOOKUP_TABLE_SIZE - 1);
 
-  // Find two presets to interpolate between by index.
-  bs::UINT32 p1i, p2i;
-  std::tie(p1i, p2i) = findPresetIndices();
+  if (entry != mAppliedEntry)
+  {
+    applyLookupEntry(mLookupTable[entry]);
+    mAppliedEntry = entry;
+  }
 
-  // Interpolate presets and save to current state.
-  interpolatePresets(mSkyStatePresets[p1i], mSkyStatePresets[p2i]);
+  updateFog(mLookupTable[entry].fogColor);
 
   // FIXME: There is some stuff about levelchanges here. Like, "turn off rain when on dragonisland"
 
@@ -183,7 +190,24 @@ const std::shared_ptr<const SkyState> SkyStateGenerator::update(float dayRatio)
   return mCurrentSkyState;
 }
 
-std::tuple<bs::UINT32, bs::UINT32> SkyStateGenerator::findPresetIndices() const
+void SkyStateGenerator::buildLookupTable()
+{
+  mLookupTable.clear();
+  mLookupTable.reserve(LOOKUP_TABLE_SIZE);
+
+  for (bs::UINT32 i = 0; i < LOOKUP_TABLE_SIZE; ++i)
+  {
+    // Sample the middle of the minute, so looking up by rounding down is as close as possible
+    const float time = (i + 0.5f) / LOOKUP_TABLE_SIZE;
+
+    bs::UINT32 p1i, p2i;
+    std::tie(p1i, p2i) = findPresetIndices(time);
+
+    mLookupTable.push_back(interpolatePresets(p1i, p2i, time));
+  }
+}
+
+std::tuple<bs::UINT32, bs::UINT32> SkyStateGenerator::findPresetIndices(float time) const
 {
   bs::UINT32 presetsCount = static_cast<bs::UINT32>(mSkyStatePresets.size());
 
@@ -196,7 +220,7 @@ std::tuple<bs::UINT32, bs::UINT32> SkyStateGenerator::findPresetIndices() const
     // *before* the current time.  The target state is then the one right after.  Since it's easier
     // to search for the target state, which is the first state which has a time larger than the
     // current time, we search for that. The start state is the one right before it.
-    if (mCurrentSkyState->time < mSkyStatePresets[i].time)
+    if (time < mSkyStatePresets[i].time)
     {
       // Subtracting 1 will not cause a negative numbers here since the first state has a time of
       // 0.0, so the check should never pass for it.  If everything is set up correctly that is.
@@ -209,32 +233,65 @@ std::tuple<bs::UINT32, bs::UINT32> SkyStateGenerator::findPresetIndices() const
   return {p1i, p2i};
 }
 
-void SkyStateGenerator::interpolatePresets(const SkyState& p1, const SkyState& p2)
+SkyStateGenerator::LookupEntry SkyStateGenerator::interpolatePresets(bs::UINT32 p1i,
+                                                                     bs::UINT32 p2i,
+                                                                     float time) const
 {
+  const SkyState& p1 = mSkyStatePresets[p1i];
+  const SkyState& p2 = mSkyStatePresets[p2i];
+
   // Handle case time >= 0.75f
   const float timeS1 = p2.time < p1.time ? p2.time + 1.0f : p2.time;
 
   // Scale up time difference to [0,1]
-  const float t = (mCurrentSkyState->time - p1.time) / (timeS1 - p1.time);
+  const float t = (time - p1.time) / (timeS1 - p1.time);
 
   // Interpolate values
-  mCurrentSkyState->baseColor      = p1.baseColor + t * (p2.baseColor - p1.baseColor);
-  mCurrentSkyState->fogColor       = p1.fogColor + t * (p2.fogColor - p1.fogColor);
-  mCurrentSkyState->fogDistance    = p1.fogDistance + t * (p2.fogDistance - p1.fogDistance);
-  mCurrentSkyState->domeColorUpper = p1.domeColorUpper + t * (p2.domeColorUpper - p1.domeColorUpper);
+  LookupEntry entry;
+  entry.baseColor      = p1.baseColor + t * (p2.baseColor - p1.baseColor);
+  entry.fogColor       = p1.fogColor + t * (p2.fogColor - p1.fogColor);
+  entry.fogDistance    = p1.fogDistance + t * (p2.fogDistance - p1.fogDistance);
+  entry.domeColorUpper = p1.domeColorUpper + t * (p2.domeColorUpper - p1.domeColorUpper);
 
-  mCurrentSkyState->cloudsLayer = p1.cloudsLayer;
-  mCurrentSkyState->cloudsLayer.textureAlpha =
+  entry.preset = p1i;
+
+  entry.cloudsLayerAlpha =
       bs::Math::lerp(t, p1.cloudsLayer.textureAlpha, p2.cloudsLayer.textureAlpha);
-  mCurrentSkyState->cloudsLayer.textureScale =
+  entry.cloudsLayerScale =
       bs::Math::lerp(t, p1.cloudsLayer.textureScale, p2.cloudsLayer.textureScale);
 
-  mCurrentSkyState->skyLayer = p1.skyLayer;
-  mCurrentSkyState->skyLayer.textureAlpha =
-      bs::Math::lerp(t, p1.skyLayer.textureAlpha, p2.skyLayer.textureAlpha);
-  mCurrentSkyState->skyLayer.textureScale =
-      bs::Math::lerp(t, p1.skyLayer.textureScale, p2.skyLayer.textureScale);
+  entry.skyLayerAlpha = bs::Math::lerp(t, p1.skyLayer.textureAlpha, p2.skyLayer.textureAlpha);
+  entry.skyLayerScale = bs::Math::lerp(t, p1.skyLayer.textureScale, p2.skyLayer.textureScale);
+
+  return entry;
+}
+
+void SkyStateGenerator::applyLookupEntry(const LookupEntry& entry)
+{
+  mCurrentSkyState.baseColor      = entry.baseColor;
+  mCurrentSkyState.domeColorUpper = entry.domeColorUpper;
+  mCurrentSkyState.fogDistance    = entry.fogDistance;
+
+  // Copying the layers copies their texture names, so only do that when the preset changes
+  if (entry.preset != mAppliedPreset)
+  {
+    const SkyState& preset = mSkyStatePresets[entry.preset];
 
+    mCurrentSkyState.isSunActive = preset.isSunActive;
+    mCurrentSkyState.cloudsLayer = preset.cloudsLayer;
+    mCurrentSkyState.skyLayer    = preset.skyLayer;
+
+    mAppliedPreset = entry.preset;
+  }
+
+  mCurrentSkyState.cloudsLayer.textureAlpha = entry.cloudsLayerAlpha;
+  mCurrentSkyState.cloudsLayer.textureScale = entry.cloudsLayerScale;
+  mCurrentSkyState.skyLayer.textureAlpha    = entry.skyLayerAlpha;
+  mCurrentSkyState.skyLayer.textureScale    = entry.skyLayerScale;
+}
+
+void SkyStateGenerator::updateFog(const bs::Color& fogColor)
+{
   const float farPlane              = bs::gSceneManager().getMainCamera()->getFarClipDistance();
   const bs::Vector3& cameraPosition = bs::gSceneManager().getMainCamera()->getTransform().pos();
 
@@ -257,21 +314,21 @@ void SkyStateGenerator::interpolatePresets(const SkyState& p1, const SkyState& p
   fogScale = bs::Math::clamp(fogScale, 0.0f, 1.0f);
 
   // Fog should be at least our set distance
-  fogScale = bs::Math::max(mCurrentSkyState->fogDistance, fogScale);
+  fogScale = bs::Math::max(mCurrentSkyState.fogDistance, fogScale);
 
-  mCurrentSkyState->fogFar = fogMidrange + (1.0f - fogScale) * fogMidDelta;
+  mCurrentSkyState.fogFar = fogMidrange + (1.0f - fogScale) * fogMidDelta;
 
   // Apply some user value
   // FIXME: This should have a getter/setter and all that stuff
   const float userFogScale = 1.0f;
-  mCurrentSkyState->fogFar *= userFogScale;
-  mCurrentSkyState->fogNear = mCurrentSkyState->fogFar * 0.3f;
+  mCurrentSkyState.fogFar *= userFogScale;
+  mCurrentSkyState.fogNear = mCurrentSkyState.fogFar * 0.3f;
 
   // REGoth - specific: Let the fog be a little closer because of the long view-distances
-  mCurrentSkyState->fogNear *= 0.5f;
+  mCurrentSkyState.fogNear *= 0.5f;
 
-  mCurrentSkyState->fogFar *= 0.4f;
-  mCurrentSkyState->fogNear *= 0.4f;
+  mCurrentSkyState.fogFar *= 0.4f;
+  mCurrentSkyState.fogNear *= 0.4f;
 
   // Fix up the fog color. The fog should get less intense with decrasing fogFar
 
@@ -279,8 +336,7 @@ void SkyStateGenerator::interpolatePresets(const SkyState& p1, const SkyState& p
   const bs::Color base = bs::Color(0.299f, 0.587f, 0.114f);
 
   // Original engine uses only the red component here as well. Who knows why.
-  const bs::Color baseColor = bs::Color(mCurrentSkyState->fogColor.r, mCurrentSkyState->fogColor.r,
-                                        mCurrentSkyState->fogColor.r);
+  const bs::Color baseColor = bs::Color(fogColor.r, fogColor.r, fogColor.r);
 
   // Calculate intensity
   const float intensityValue =
@@ -290,8 +346,7 @@ void SkyStateGenerator::interpolatePresets(const SkyState& p1, const SkyState& p
   const float intensityScale = fogScale * 0.5f;
 
   // Calculate actual fog color
-  mCurrentSkyState->fogColor =
-      (1.0f - intensityScale) * mCurrentSkyState->fogColor + intensityScale * intensity;
+  mCurrentSkyState.fogColor = (1.0f - intensityScale) * fogColor + intensityScale * intensity;
 }
 
 bs::Color SkyStateGenerator::getPolyCloudsLayerColor()
@@ -299,17 +354,17 @@ bs::Color SkyStateGenerator::getPolyCloudsLayerColor()
   bs::Color color;
 
   // At night.
-  if (mCurrentSkyState->time >= 0.25f && mCurrentSkyState->time <= 0.75f)
+  if (mCurrentSkyState.time >= 0.25f && mCurrentSkyState.time <= 0.75f)
   {
     color = bs::Color::White;
   }
   else
   {
-    color = mCurrentSkyState->domeColorUpper;
+    color = mCurrentSkyState.domeColorUpper;
   }
 
   // At night, we want to keep the clouds white instead of getting a blueish tint.
-  if (mCurrentSkyState->time >= 0.35f && mCurrentSkyState->time <= 0.65f)
+  if (mCurrentSkyState.time >= 0.35f && mCurrentSkyState.time <= 0.65f)
   {
     color = 0.5f * (color + bs::Color::White);
   }
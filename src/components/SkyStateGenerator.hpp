@@ -73,6 +73,10 @@ namespace REGoth
    * Since sky rendering is a pretty complex topic in the original game, this class contains a lot of
    * magic numbers of which we are not quite sure why many of them were chosen.  Probably only
    * because it looked good.
+   *
+   * The interpolation between the presets only depends on the time, so it is done once for every
+   * minute of the day on construction and looked up from there.  Only the fog, which also depends
+   * on the camera, is calculated on every update.
    */
   class SkyStateGenerator
   {
@@ -86,39 +90,91 @@ namespace REGoth
      * @param  dayRatio  Value in range [0, 1) where 0 means start of day and (nearly) 1 end of day.
      *                   For example, if the clock reads 0:00, this would need to be 0.  If the clock
      *                   reads 23:59 this would need to be close to 1.
-     * @return The current sky state after update.
+     * @return The current sky state after update.  Stays valid as long as this generator exists,
+     *         but changes with the next update.
      */
-    const std::shared_ptr<const SkyState> update(float dayRatio);
+    const SkyState& update(float dayRatio);
+
+    /** Number of entries in the lookup table, one per minute of the day */
+    static constexpr bs::UINT32 LOOKUP_TABLE_SIZE = 24 * 60;
 
   private:
+    /**
+     * The time dependent part of a `SkyState`, see mLookupTable.  Strings and textures of the
+     * layers are taken from the preset interpolated from, so entries can be copied freely.
+     */
+    struct LookupEntry
+    {
+      bs::Color baseColor;
+      bs::Color fogColor;
+      bs::Color domeColorUpper;
+      float fogDistance;
+
+      /** Index of the preset the layers come from */
+      bs::UINT32 preset;
+
+      float cloudsLayerAlpha;
+      float cloudsLayerScale;
+      float skyLayerAlpha;
+      float skyLayerScale;
+    };
     /**
      * @return Color of the coulds layer as poly (layer 1).
      */
     bs::Color getPolyCloudsLayerColor();
 
     /**
-     * Finds the two sky states we need to interpolate between for the current time.
+     * Finds the two sky states we need to interpolate between for the given time.
      *
-     * For example, if the current time is 0.28, this will find the sky states for time 0.25 and the
-     * one for 0.30.  The current time is read from `mCurrentSkyState`.
+     * For example, if the time is 0.28, this will find the sky states for time 0.25 and the
+     * one for 0.30.
      *
      * @return 2-Tuple of indices of the presets to interpolate
      */
-    std::tuple<unsigned int, unsigned int> findPresetIndices() const;
+    std::tuple<unsigned int, unsigned int> findPresetIndices(float time) const;
+
+    /**
+     * Fills `mLookupTable` by interpolating the presets.
+     */
+    void buildLookupTable();
+
+    /**
+     * Interpolates the two given sky states by index for the given time.
+     */
+    LookupEntry interpolatePresets(bs::UINT32 p1i, bs::UINT32 p2i, float time) const;
 
     /**
-     * Interpolates the two given sky states and stores the result into `mCurrentSkyState`.
+     * Copies the given entry of the lookup table into `mCurrentSkyState`.
      */
-    void interpolatePresets(const SkyState& p1, const SkyState& p2);
+    void applyLookupEntry(const LookupEntry& entry);
+
+    /**
+     * Calculates the fog of `mCurrentSkyState` from the position of the camera.
+     *
+     * @param  fogColor  Fog color of the lookup table entry, which is adjusted for the camera.
+     */
+    void updateFog(const bs::Color& fogColor);
 
     /**
      * Collection of `SkyState` presets to interpolate between.
      */
     const std::vector<SkyState> mSkyStatePresets;
 
+    /**
+     * Interpolated presets, one entry per minute of the day, indexed by time.
+     */
+    std::vector<LookupEntry> mLookupTable;
+
+    /**
+     * Entry of `mLookupTable` and preset `mCurrentSkyState` was last filled from, so
+     * it's only touched when the time has moved on to another entry.
+     */
+    bs::UINT32 mAppliedEntry  = UINT32_MAX;
+    bs::UINT32 mAppliedPreset = UINT32_MAX;
+
     /**
      * `SkyState` reflecting the current status of the sky.
      */
-    std::shared_ptr<SkyState> mCurrentSkyState;
+    SkyState mCurrentSkyState;
   };
 }  // namespace REGoth
@@ -4,6 +4,7 @@
 #include <components/GameWorld.hpp>
 #include <exception/Throw.hpp>
 #include <log/logging.hpp>
+#include <original-content/VirtualFileSystem.hpp>
 #include <scripting/ScriptSymbolQueries.hpp>
 #include <scripting/ScriptVMForGameWorld.hpp>
 
@@ -26,57 +27,34 @@ namespace REGoth
   {
   }
 
-  void StoryInformation::onInitialized()
+  Scripting::DialogueInfoSpan StoryInformation::allInfos() const
   {
-    if (mAllInfos.empty())
-    {
-      findAllInfos();
-    }
-  }
+    bs::UINT32 version = mGameWorld->scriptVM().dialogueInfosVersion();
 
-  void StoryInformation::findAllInfos()
-  {
-    auto& objectStorage = mGameWorld->scriptVM().scriptObjects();
-    auto& symbolStorage = mGameWorld->scriptVM().scriptSymbols();
-
-    for (Scripting::ScriptObjectHandle h : mSelf->allInfosForThisCharacter())
+    // The VM builds its infos again after restoring a snapshot, which moves them in memory
+    if (mAllInfosVersion != version)
     {
-      auto& data = objectStorage.get(h);
-
-      DialogueInfo info;
-      info.name        = data.instanceName;
-      info.priority    = data.intValue("NR");
-      info.isPermanent = data.intValue("PERMANENT") != 0;
-      info.isImportant = data.intValue("IMPORTANT") != 0;
-      info.isTrade     = data.intValue("TRADE") != 0;
-      info.choiceText  = data.stringValue("DESCRIPTION");
-
-      info.conditionFunction =
-          symbolStorage.findFunctionByAddress(data.functionPointerValue("CONDITION"));
-      info.informationFunction =
-          symbolStorage.findFunctionByAddress(data.functionPointerValue("INFORMATION"));
-
-      bs::UINT32 index = mAllInfos.size();
-
-      mAllInfos.emplace_back(info);
-
-      REGOTH_LOG(Info, Uncategorized, "[StoryInformation] Info {0} for {1}", info.name,
-                 mSelf->getName());
+      mAllInfos        = mSelf->allInfosForThisCharacter();
+      mAllInfosVersion = version;
     }
+
+    return mAllInfos;
   }
 
-  bs::Vector<const StoryInformation::DialogueInfo*> StoryInformation::gatherAvailableDialogueLines(
-      HCharacter other) const
+  ScratchVector<const StoryInformation::DialogueInfo*>
+  StoryInformation::gatherAvailableDialogueLines(HCharacter other) const
   {
-    HStoryInformation otherInfo = other->SO()->getComponent<StoryInformation>();
+    HStoryInformation otherInfo = other->storyInformation();
 
-    bs::Vector<const StoryInformation::DialogueInfo*> result;
+    Scripting::DialogueInfoSpan infos = allInfos();
 
-    for (bs::UINT32 i = 0; i < (bs::UINT32)mAllInfos.size(); i++)
+    ScratchVector<const DialogueInfo*> result = makeScratchVector<const DialogueInfo*>();
+
+    for (bs::UINT32 i = 0; i < infos.size(); i++)
     {
       if (isDialogueInfoAvaliable(i, other, otherInfo))
       {
-        result.push_back(&mAllInfos[i]);
+        result.push_back(&infos[i]);
       }
     }
 
@@ -86,9 +64,9 @@ namespace REGoth
   bool StoryInformation::isDialogueInfoAvaliable(bs::UINT32 index, HCharacter other,
                                                  HStoryInformation otherInfo) const
   {
-    const auto& info = mAllInfos[index];
+    const auto& info = allInfos()[index];
 
-    if (!info.isPermanent && otherInfo->knowsInfo(info.name))
+    if (!info.isPermanent && otherInfo->knowsInfo(info.index))
     {
       return false;
     }
@@ -98,12 +76,108 @@ namespace REGoth
 
   bool StoryInformation::knowsInfo(const bs::String& name) const
   {
-    return mKnownInfos.find(name) != mKnownInfos.end();
+    Scripting::DialogueInfoIndex index = mGameWorld->scriptVM().dialogueInfoIndex(name);
+
+    if (index != Scripting::DIALOGUE_INFO_INDEX_INVALID)
+    {
+      return knowsInfo(index);
+    }
+
+    return mKnownInfoNames.find(name) != mKnownInfoNames.end();
+  }
+
+  bool StoryInformation::knowsInfo(Scripting::DialogueInfoIndex index) const
+  {
+    mapKnownInfoNames();
+
+    return index < mKnownInfos.size() && mKnownInfos[index];
   }
 
   void StoryInformation::giveKnowledgeAboutInfo(const bs::String& name)
   {
-    mKnownInfos.insert(name);
+    Scripting::DialogueInfoIndex index = mGameWorld->scriptVM().dialogueInfoIndex(name);
+
+    if (index != Scripting::DIALOGUE_INFO_INDEX_INVALID)
+    {
+      giveKnowledgeAboutInfo(index);
+    }
+    else if (mKnownInfoNames.insert(name).second)
+    {
+      mKnownInfosVersion += 1;
+    }
+  }
+
+  void StoryInformation::giveKnowledgeAboutInfo(Scripting::DialogueInfoIndex index)
+  {
+    mapKnownInfoNames();
+
+    if (index >= mKnownInfos.size())
+    {
+      mKnownInfos.resize(mGameWorld->scriptVM().numDialogueInfos(), false);
+    }
+
+    if (!mKnownInfos.at(index))
+    {
+      mKnownInfos[index] = true;
+      mKnownInfosVersion += 1;
+    }
+  }
+
+  bs::Set<bs::String> StoryInformation::knownInfoNames() const
+  {
+    mapKnownInfoNames();
+
+    bs::Set<bs::String> names = mKnownInfoNames;
+
+    for (bs::UINT32 i = 0; i < (bs::UINT32)mKnownInfos.size(); i++)
+    {
+      if (mKnownInfos[i])
+      {
+        names.insert(mGameWorld->scriptVM().dialogueInfo(i).name);
+      }
+    }
+
+    return names;
+  }
+
+  void StoryInformation::setKnownInfoNames(const bs::Set<bs::String>& names)
+  {
+    mKnownInfos.clear();
+    mKnownInfoNames        = names;
+    mKnownInfoNamesVersion = 0;
+    mKnownInfosVersion += 1;
+  }
+
+  void StoryInformation::mapKnownInfoNames() const
+  {
+    if (mKnownInfoNames.empty()) return;
+
+    auto& vm = mGameWorld->scriptVM();
+
+    // Names which can't be mapped now won't be until the dialogue infos are built again
+    if (mKnownInfoNamesVersion == vm.dialogueInfosVersion()) return;
+
+    mKnownInfoNamesVersion = vm.dialogueInfosVersion();
+
+    for (auto it = mKnownInfoNames.begin(); it != mKnownInfoNames.end();)
+    {
+      Scripting::DialogueInfoIndex index = vm.dialogueInfoIndex(*it);
+
+      if (index == Scripting::DIALOGUE_INFO_INDEX_INVALID)
+      {
+        it++;
+        continue;
+      }
+
+      if (index >= mKnownInfos.size())
+      {
+        mKnownInfos.resize(vm.numDialogueInfos(), false);
+      }
+
+      mKnownInfos[index] = true;
+
+      it = mKnownInfoNames.erase(it);
+    }
   }
 
   void StoryInformation::startDialogueWith(HCharacter other)
@@ -116,12 +190,12 @@ namespace REGoth
     }
 
     gGameplayUI()->choices()->setOnChoiceCallback([this, other](UIDialogueChoice::Choice choice) {
-      REGOTH_LOG(Info, Uncategorized, "[StoryInformation] Choice taken: {0} ({1})", choice.text,
+      REGOTH_LOG(Info, VM, "[StoryInformation] Choice taken: {0} ({1})", choice.text,
                  choice.instanceName);
 
       if (!choice.instanceName.empty())
       {
-        HStoryInformation otherInfo = other->SO()->getComponent<StoryInformation>();
+        HStoryInformation otherInfo = other->storyInformation();
 
         otherInfo->giveKnowledgeAboutInfo(choice.instanceName);
       }
@@ -153,6 +227,47 @@ namespace REGoth
     c.scriptFunction = infoFunction;
 
     gGameplayUI()->choices()->addChoice(c);
+
+    // The lines are read from the VDFS once spoken, so get them loading while a choice is made
+    prefetchLinesOf(infoFunction);
+  }
+
+  void StoryInformation::prefetchLinesOf(Scripting::SymbolIndex infoFunction)
+  {
+    if (infoFunction == Scripting::SYMBOL_INDEX_INVALID) return;
+
+    auto& vm = mGameWorld->scriptVM();
+
+    const Scripting::DialogueOutputs& outputs = vm.dialogueOutputsOf(infoFunction);
+    const Scripting::SvmTable& svms           = vm.svmTable();
+
+    bs::Vector<bs::INT32> voices = {mSelf->voice()};
+
+    HCharacter hero = mGameWorld->hero();
+
+    if (hero && hero != mSelf) voices.push_back(hero->voice());
+
+    bs::Vector<bs::String> files;
+    files.reserve(outputs.outputNames.size() + outputs.svmKeys.size() * voices.size());
+
+    for (const bs::String& outputName : outputs.outputNames)
+    {
+      files.push_back(Scripting::SvmTable::soundFileOf(outputName));
+    }
+
+    for (Scripting::SvmKey key : outputs.svmKeys)
+    {
+      for (bs::INT32 voice : voices)
+      {
+        const bs::String& outputName = svms.outputName(voice, key);
+
+        if (!outputName.empty()) files.push_back(Scripting::SvmTable::soundFileOf(outputName));
+      }
+    }
+
+    if (files.empty()) return;
+
+    gVirtualFileSystem().prefetch(files);
   }
 
   void StoryInformation::clearChoices()
@@ -1,5 +1,7 @@
 #pragma once
+#include "scripting/DialogueInfo.hpp"
 #include "scripting/ScriptTypes.hpp"
+#include <core/FrameScratch.hpp>
 #include <RTTI/RTTIUtil.hpp>
 #include <Scene/BsComponent.h>
 
@@ -78,63 +80,19 @@ namespace REGoth
     virtual ~StoryInformation();
 
     /**
-     * Native version if the `C_INFO` script class for efficiency.
+     * Native version if the `C_INFO` script class, shared by all characters. See
+     * Scripting::DialogueInfo.
      */
-    struct DialogueInfo
-    {
-      /**
-       * Instance name of this info
-       */
-      bs::String name;
-
-      /**
-       * Called `nr` in the original script files. This defines the order the dialogue lines
-       * should be displayed in the UI. However, sometimes those numbers are not unique, some are
-       * missing, so `priority` is the better name here. Low numbers mean higher priority.
-       */
-      bs::UINT32 priority;
-
-      /**
-       * Script function to execute to check whether this information should be avaialble to the
-       * user in the UI. If this returns 0, it should not be shown.
-       */
-      Scripting::SymbolIndex conditionFunction;
-
-      /**
-       * Script function to execute once the user has chosen this dialogue line. This usually
-       * does the back-and-forth conversation.
-       */
-      Scripting::SymbolIndex informationFunction;
-
-      /**
-       * Whether this information should disapper once you talked about it once.
-       */
-      bool isPermanent;
-
-      /**
-       * If true, the NPC should start talking to the hero as soon as the hero comes into range.
-       * This is often used for guards who are supposed to stop the player from entering
-       * certain locations.
-       */
-      bool isImportant;
-
-      /**
-       * If true, this information will open the trade window.
-       */
-      bool isTrade;
-
-      /**
-       * The text to display to the user in the UI. Called `description` inside scripts.
-       */
-      bs::String choiceText;
-    };
+    using DialogueInfo = Scripting::DialogueInfo;
 
     /**
      * Assembles a list of all dialogue lines to be shown to the user in the UI.
      *
      * @param  other  Dialogue-Parter. Usually this is the hero.
+     *
+     * @return The lines, in frame memory, see FrameScratch.
      */
-    bs::Vector<const DialogueInfo*> gatherAvailableDialogueLines(HCharacter other) const;
+    ScratchVector<const DialogueInfo*> gatherAvailableDialogueLines(HCharacter other) const;
 
     /**
      * @return Whether the character knows the given info.
@@ -145,6 +103,13 @@ namespace REGoth
      */
     bool knowsInfo(const bs::String& name) const;
 
+    /**
+     * @copydoc knowsInfo(const bs::String&)
+     *
+     * @param  index  Dense index of the *Information*-Instance, see Scripting::DialogueInfoIndex.
+     */
+    bool knowsInfo(Scripting::DialogueInfoIndex index) const;
+
     /**
      * Lets this character remember that someone talked about the given info with them.
      *
@@ -154,6 +119,32 @@ namespace REGoth
      */
     void giveKnowledgeAboutInfo(const bs::String& name);
 
+    /**
+     * @copydoc giveKnowledgeAboutInfo(const bs::String&)
+     *
+     * @param  index  Dense index of the *Information*-Instance, see Scripting::DialogueInfoIndex.
+     */
+    void giveKnowledgeAboutInfo(Scripting::DialogueInfoIndex index);
+
+    /**
+     * @return Names of all *Information*-Instances this character knows. This is what gets
+     *         saved, so saves don't depend on the dense indices.
+     */
+    bs::Set<bs::String> knownInfoNames() const;
+
+    /**
+     * Replaces all known infos with the given ones, e.g. after loading a saved game.
+     */
+    void setKnownInfoNames(const bs::Set<bs::String>& names);
+
+    /**
+     * @return Changes whenever this character learns about another info. Not serialized.
+     */
+    bs::UINT32 knownInfosVersion() const
+    {
+      return mKnownInfosVersion;
+    }
+
     /**
      * TODO: Refactor, so this doesn't need to access the UI internally. I'd like this class to
      *       be more of a dumb thing to the *Information*-instances, rather than one that accesses
@@ -177,15 +168,12 @@ namespace REGoth
      */
     void clearChoices();
 
-  protected:
-    void onInitialized() override;
-
   private:
     /**
-     * Looks through all script symbols to find all *Information*-Instances available to this
-     * character.
+     * @return All *Information*-Instances available to this character. Looked up from the
+     *         script VM, which only builds them once for all characters.
      */
-    void findAllInfos();
+    Scripting::DialogueInfoSpan allInfos() const;
 
     /**
      * @return Whether the given DialogueInfos dialogue line should be shown to the user in the UI.
@@ -200,17 +188,44 @@ namespace REGoth
     bool isDialogueInfoAvaliable(bs::UINT32 index, HCharacter other,
                                  HStoryInformation otherInfo) const;
 
+    /**
+     * Moves the names inside mKnownInfoNames which have a dense index by now into
+     * mKnownInfos. Only does something once the script VM has built its dialogue infos.
+     */
+    void mapKnownInfoNames() const;
+
+    /**
+     * Gets the sound files of what the given information function says loading, so they are
+     * there once a choice has been made. SVMs are prefetched in the voices of this character
+     * and of the hero, since either may say them.
+     */
+    void prefetchLinesOf(Scripting::SymbolIndex infoFunction);
+
   public:
     REGOTH_DECLARE_RTTI(StoryInformation)
 
     /** All possible infos to talk about with this character. These are static and
-        can be gathered directly from the scripts on startup.
+        owned by the script VM, see allInfos().
         Not serialized, can be generated from script symbols easily. */
-    bs::Vector<DialogueInfo> mAllInfos;
+    mutable Scripting::DialogueInfoSpan mAllInfos;
+
+    /** Version of the script VMs dialogue infos mAllInfos points into. 0 if not looked up yet. */
+    mutable bs::UINT32 mAllInfosVersion = 0;
+
+    /** Which *Information*-Instances this character knows, by their dense index. See
+        Scripting::DialogueInfoIndex. Serialized by name, see knownInfoNames(). */
+    mutable bs::Vector<bool> mKnownInfos;
+
+    /** Known *Information*-Instances without a dense index, e.g. loaded from a saved game
+        before the script VM has built its dialogue infos. Contains names such as
+        `INFO_THORUS_WORKFORGOMEZ`. See mapKnownInfoNames(). */
+    mutable bs::Set<bs::String> mKnownInfoNames;
+
+    /** Version of the script VMs dialogue infos mKnownInfoNames has been mapped with */
+    mutable bs::UINT32 mKnownInfoNamesVersion = 0;
 
-    /** Set of *Information*-Instances this character knows. Contains names such as
-       `INFO_THORUS_WORKFORGOMEZ` */
-    bs::Set<bs::String> mKnownInfos;
+    /** See knownInfosVersion() */
+    bs::UINT32 mKnownInfosVersion = 0;
 
     HCharacter mSelf;
     HGameWorld mGameWorld;
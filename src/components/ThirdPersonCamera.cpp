@@ -21,6 +21,8 @@ namespace REGoth
 
     mOldLookAt = characterPosition();
     SO()->setPosition(characterPosition());
+
+    mCollision.reset();
   }
 
   void ThirdPersonCamera::modifyDistance(float delta)
@@ -79,6 +81,11 @@ namespace REGoth
     newPosition = bs::Vector3::lerp(0.05f, oldPosition, newPosition);
     newLookAt   = bs::Vector3::lerp(0.10f, mOldLookAt, newLookAt);
 
+    // Checked against the head rather than the smoothed look-at, which might be inside a wall
+    // when the character has just walked around a corner
+    bs::Vector3 pivot = characterPosition() + bs::Vector3(0, 1.4f, 0);
+    newPosition       = mCollision.resolve(pivot, newPosition, dt);
+
     SO()->setPosition(newPosition);
     SO()->lookAt(newLookAt);
 
@@ -2,6 +2,7 @@
 #include <BsPrerequisites.h>
 #include <Scene/BsComponent.h>
 #include <RTTI/RTTIUtil.hpp>
+#include <world/CameraCollision.hpp>
 
 namespace REGoth
 {
@@ -91,6 +92,11 @@ namespace REGoth
      * Position looked at in the previous update cycle, for smoothing.
      */
     bs::Vector3 mOldLookAt;
+
+    /**
+     * Keeps the camera out of the walls. Not saved.
+     */
+    CameraCollision mCollision;
   public:
     REGOTH_DECLARE_RTTI(ThirdPersonCamera)
 
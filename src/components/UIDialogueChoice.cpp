@@ -24,33 +24,74 @@ namespace REGoth
   {
     bs::UINT32 index = mChoices.size();
 
+    ChoiceButton& pooled = nextButton(choice.text + " - " + choice.instanceName);
+
     mChoices.push_back(choice);
 
-    auto button = mScrollArea->getLayout().addNewElement<bs::GUIButton>(bs::HString(choice.text + " - " + choice.instanceName));
-    mChoiceButtons.push_back(button);
+    pooled.button->setActive(true);
+    pooled.onClick =
+        pooled.button->onClick.connect([this, index]() { mOnChoice(mChoices[index]); });
+  }
+
+  UIDialogueChoice::ChoiceButton& UIDialogueChoice::nextButton(const bs::String& text)
+  {
+    size_t next = mChoices.size();
+
+    for (size_t i = next; i < mButtonPool.size(); i++)
+    {
+      if (mButtonPool[i].text != text) continue;
+
+      if (i != next)
+      {
+        ChoiceButton found = mButtonPool[i];
+
+        mScrollArea->getLayout().removeElement(found.button);
+        mScrollArea->getLayout().insertElement((bs::UINT32)next, found.button);
+
+        mButtonPool.erase(mButtonPool.begin() + i);
+        mButtonPool.insert(mButtonPool.begin() + next, found);
+      }
 
-    button->onClick.connect([this, index]() { mOnChoice(mChoices[index]); });
+      return mButtonPool[next];
+    }
+
+    // No button laid out for this text yet, so one has to be (re-)laid out
+    if (next == mButtonPool.size())
+    {
+      ChoiceButton created;
+      created.button = mScrollArea->getLayout().addNewElement<bs::GUIButton>(bs::HString(text));
+      created.text   = text;
+
+      mButtonPool.push_back(created);
+
+      return mButtonPool.back();
+    }
+
+    ChoiceButton& reused = mButtonPool[next];
+    reused.button->setContent(bs::GUIContent(bs::HString(text)));
+    reused.text = text;
+
+    return reused;
   }
 
   void UIDialogueChoice::clearChoices()
   {
-    for (bs::GUIButton* pButton : mChoiceButtons)
+    // Kept for the next choices, inactive ones don't take up space inside the layout
+    for (size_t i = 0; i < mChoices.size(); i++)
     {
-      mScrollArea->getLayout().removeElement(pButton);
+      mButtonPool[i].onClick.disconnect();
+      mButtonPool[i].button->setActive(false);
     }
 
-    mChoiceButtons.clear();
     mChoices.clear();
   }
 
-  void UIDialogueChoice::update()
+  void UIDialogueChoice::updateLayout(const bs::Rect2I& parentBounds)
   {
-    UIElement::update();
-
-    bs::Rect2I bounds = parentLayout().getBounds();
+    bs::Rect2I bounds = parentBounds;
 
-    bounds.y      = parentLayout().getBounds().height * 0.80f;
-    bounds.height = parentLayout().getBounds().height - bounds.y;
+    bounds.y      = parentBounds.height * 0.80f;
+    bounds.height = parentBounds.height - bounds.y;
 
     layout().setBounds(bounds);
     mScrollArea->setWidth(layout().getBounds().width);
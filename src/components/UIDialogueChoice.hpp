@@ -29,6 +29,10 @@ namespace REGoth
    * has been taken.
    *
    * Once a choice has been taken by the user, the `onChoice`-callback is triggered.
+   *
+   * Scripts clear and add the same choices over and over, like the one to end the
+   * dialogue. Laying out the text of a button again each time is not needed, so cleared
+   * buttons are kept and handed to a new choice with the same text if possible.
    */
   class UIDialogueChoice : public UIElement
   {
@@ -71,14 +75,31 @@ namespace REGoth
     void clearChoices();
 
   protected:
-    /** Triggered once per frame. Allows the component to handle input and move. */
-    void update() override;
+    void updateLayout(const bs::Rect2I& parentBounds) override;
 
   private:
+    /**
+     * A button of the pool and the text it was laid out for.
+     */
+    struct ChoiceButton
+    {
+      bs::GUIButton* button = nullptr;
+      bs::String text;
+      bs::HEvent onClick;
+    };
+
+    /**
+     * @return The button to show the next choice with. Moved in place inside the layout, if
+     *         it came from further down the pool, see ChoiceButton.
+     */
+    ChoiceButton& nextButton(const bs::String& text);
+
     bs::Vector<Choice> mChoices;
-    bs::Vector<bs::GUIButton*> mChoiceButtons;
     bs::GUIScrollArea* mScrollArea;
 
+    /** In the order of the layout. The first mChoices.size() ones are in use. */
+    bs::Vector<ChoiceButton> mButtonPool;
+
     OnChoiceCallback mOnChoice;
 
   public:
@@ -51,6 +51,34 @@ namespace REGoth
     layout().setVisible(false);
   }
 
+  void UIElement::update()
+  {
+    bs::Component::update();
+
+    bs::Rect2I parentBounds;
+
+    if (mParentUiElement)
+    {
+      parentBounds = parentLayout().getBounds();
+
+      if (parentBounds != mLastParentBounds)
+      {
+        mLastParentBounds = parentBounds;
+        markDirty(DIRTY_LAYOUT);
+      }
+    }
+
+    if (mDirtyFlags == 0) return;
+
+    // Cleared first, so updates can mark things dirty again for the next frame
+    bs::UINT32 flags = mDirtyFlags;
+    mDirtyFlags      = 0;
+
+    if (flags & DIRTY_LAYOUT) updateLayout(parentBounds);
+    if (flags & DIRTY_TEXT) updateText();
+    if (flags & DIRTY_POSITION) updatePosition();
+  }
+
   bs::HSceneObject UIElement::addChildSceneObject(const bs::String& name)
   {
     auto so = bs::SceneObject::create(name);
@@ -102,7 +130,7 @@ namespace REGoth
 
     if (!t)
     {
-      REGOTH_LOG(Warning, Uncategorized, "[UIElement] Failed to load texture: {0}", texture);
+      REGOTH_LOG(Warning, UI, "[UIElement] Failed to load texture: {0}", texture);
 
       return {};
     }
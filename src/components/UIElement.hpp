@@ -1,4 +1,5 @@
 #pragma once
+#include <Math/BsRect2I.h>
 #include <RTTI/RTTIUtil.hpp>
 #include <Scene/BsComponent.h>
 
@@ -17,6 +18,13 @@ namespace REGoth
    *
    * The root `UIElement` gives the `bs::GUIPanel` for the other components to
    * draw on. Components can also decide to register their own sub-layout.
+   *
+   * Touching bs:f's GUI elements makes them lay out again, so UI-Elements should only do
+   * so when something they show has changed. For that, they mark what needs to be updated
+   * via markDirty() and do the actual work inside updateLayout(), updateText() and
+   * updatePosition(), which are only called on the next update() if needed. Changes of the
+   * bounds of the parent layout, like when the window is resized, mark the layout dirty
+   * automatically.
    */
   class UIElement : public bs::Component
   {
@@ -43,6 +51,60 @@ namespace REGoth
     void hide();
 
   protected:
+    /**
+     * What has changed since the last update, see markDirty().
+     */
+    enum DirtyFlags : bs::UINT32
+    {
+      DIRTY_LAYOUT   = 1 << 0, /**< Size or placement inside the parent, see updateLayout() */
+      DIRTY_TEXT     = 1 << 1, /**< Contents of labels and buttons, see updateText() */
+      DIRTY_POSITION = 1 << 2, /**< Position on screen, see updatePosition() */
+      DIRTY_ALL      = DIRTY_LAYOUT | DIRTY_TEXT | DIRTY_POSITION,
+    };
+
+    /**
+     * Marks the given parts of this UI-Element to be updated on the next update().
+     *
+     * @param  flags  Combination of DirtyFlags.
+     */
+    void markDirty(bs::UINT32 flags)
+    {
+      mDirtyFlags |= flags;
+    }
+
+    /**
+     * Calls the update functions for everything marked dirty. UI-Elements overriding this to
+     * look for changes themselves should call this last, so changes they find are handled
+     * in the same frame.
+     */
+    void update() override;
+
+    /**
+     * Called on update() if DIRTY_LAYOUT is set.
+     *
+     * @param  parentBounds  Bounds of the parent layout. Empty for the root UI-Element.
+     */
+    virtual void updateLayout(const bs::Rect2I& parentBounds)
+    {
+      // pass
+    }
+
+    /**
+     * Called on update() if DIRTY_TEXT is set.
+     */
+    virtual void updateText()
+    {
+      // pass
+    }
+
+    /**
+     * Called on update() if DIRTY_POSITION is set.
+     */
+    virtual void updatePosition()
+    {
+      // pass
+    }
+
     /**
      * Adds an UIElement as child to this one.
      *
@@ -107,6 +169,12 @@ namespace REGoth
     bs::GUILayout* mGuiLayout;
     HUIElement mParentUiElement;
 
+    /** Combination of DirtyFlags. Everything is dirty at first, so it's set up once. */
+    bs::UINT32 mDirtyFlags = DIRTY_ALL;
+
+    /** Bounds of the parent layout at the last update, to notice changes */
+    bs::Rect2I mLastParentBounds;
+
   public:
     REGOTH_DECLARE_RTTI(UIElement)
 
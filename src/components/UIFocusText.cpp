@@ -24,7 +24,14 @@ namespace REGoth
   {
     mFocusedObject = focusable;
 
-    mLabelAboveObject->setContent(bs::GUIContent(bs::HString(focusable->getText())));
+    markDirty(DIRTY_TEXT | DIRTY_POSITION);
+  }
+
+  void UIFocusText::clearText()
+  {
+    mFocusedObject = {};
+
+    mLabelAboveObject->setVisible(false);
   }
 
   void UIFocusText::setMaximumDistance(float maximumDistanceInMeters)
@@ -35,6 +42,35 @@ namespace REGoth
   }
 
   void UIFocusText::update()
+  {
+    if (mFocusedObject)
+    {
+      const bs::Transform& cameraTransform = camera().getTransform();
+      const bs::Vector3& targetPosition    = mFocusedObject->SO()->getTransform().pos();
+
+      if (cameraTransform.getPosition() != mLastCameraPosition ||
+          cameraTransform.getRotation() != mLastCameraRotation ||
+          targetPosition != mLastTargetPosition)
+      {
+        mLastCameraPosition = cameraTransform.getPosition();
+        mLastCameraRotation = cameraTransform.getRotation();
+        mLastTargetPosition = targetPosition;
+
+        markDirty(DIRTY_POSITION);
+      }
+    }
+
+    UIElement::update();
+  }
+
+  void UIFocusText::updateText()
+  {
+    if (!mFocusedObject) return;
+
+    mLabelAboveObject->setContent(bs::GUIContent(bs::HString(mFocusedObject->getText())));
+  }
+
+  void UIFocusText::updatePosition()
   {
     if (!mFocusedObject) return;
 
@@ -80,9 +116,8 @@ namespace REGoth
 
     if (!isInFrontOfCamera)
       return false;
-    else if (positionalDifference.isZeroLength())
-      return true;
-    else if (positionalDifference.length() <= mMaximumDistanceInMeters)
+    else if (positionalDifference.squaredLength() <=
+             mMaximumDistanceInMeters * mMaximumDistanceInMeters)
       return true;
     else
       return false;
@@ -101,8 +136,7 @@ namespace REGoth
   {
     if (!mFocusedObject) return 0.0f;
 
-    // TODO: Ask focus component about the height
-    return 0.3f;
+    return mFocusedObject->getTextHeight();
   }
 
   REGOTH_DEFINE_RTTI(UIFocusText)
@@ -1,5 +1,7 @@
 #pragma once
 #include "UIElement.hpp"
+#include <Math/BsQuaternion.h>
+#include <Math/BsVector3.h>
 #include <RTTI/RTTIUtil.hpp>
 
 namespace REGoth
@@ -18,6 +20,9 @@ namespace REGoth
    * is moved to those projected coordinates.
    *
    * The focusable can also define a Y-Offset so the label can be drawn *above* the objects.
+   *
+   * The label is only moved if the camera or the focused object have moved since the last
+   * frame.
    */
   class UIFocusText : public UIElement
   {
@@ -30,6 +35,11 @@ namespace REGoth
      */
     void putTextAbove(HFocusable focusable);
 
+    /**
+     * Hides the text until putTextAbove() is called again.
+     */
+    void clearText();
+
     /**
      * Set the maximum distance to which the label in front of the camera is drawn.
      */
@@ -39,6 +49,9 @@ namespace REGoth
     /** Triggered once per frame. Allows the component to handle input and move. */
     void update() override;
 
+    void updateText() override;
+    void updatePosition() override;
+
   private:
     /**
      * Once the target is out of range or behind the camera, the label should not
@@ -71,18 +84,24 @@ namespace REGoth
 
     /**
      * This will query the focusable-component of the focused object for the offset to
-     * the Y axis which will place the label above the object.
+     * the Y axis which will place the label above the object, see Focusable::getTextHeight().
      *
      * If there is no object in focus or its height cannot be calculated, 0 is returned.
      */
     float getLabelYOffset() const;
 
     bs::GUILabel* mLabelAboveObject;
-    float mMaximumDistanceInMeters = 2.0;
+    /** Measured from the camera, which can be a few meters behind the hero */
+    float mMaximumDistanceInMeters = 10.0;
 
     /** The Scene-Object to draw the text above (if valid) */
     HFocusable mFocusedObject;
 
+    /** Where camera and focused object were when the label was moved last */
+    bs::Vector3 mLastCameraPosition;
+    bs::Quaternion mLastCameraRotation;
+    bs::Vector3 mLastTargetPosition;
+
   public:
     REGOTH_DECLARE_RTTI(UIFocusText)
 
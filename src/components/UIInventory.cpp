@@ -4,13 +4,17 @@
 #include <GUI/BsGUILayoutY.h>
 #include <GUI/BsGUIPanel.h>
 #include <GUI/BsGUIScrollArea.h>
+#include <GUI/BsGUISpace.h>
 #include <RTTI/RTTI_UIInventory.hpp>
 #include <components/Inventory.hpp>
 #include <exception/Throw.hpp>
 #include <log/logging.hpp>
+#include <algorithm>
 
 namespace REGoth
 {
+  constexpr bs::UINT32 UIInventory::ROW_HEIGHT;
+
   UIInventory::UIInventory(const bs::HSceneObject& parent, HUIElement parentUiElement)
       : UIElement(parent, parentUiElement, new bs::GUIPanel())
   {
@@ -18,6 +22,12 @@ namespace REGoth
 
     mScrollArea = layout().addNewElement<bs::GUIScrollArea>(bs::ScrollBarType::ShowIfDoesntFit,
                                                             bs::ScrollBarType::NeverShow);
+
+    bs::GUILayout& scrollLayout = mScrollArea->getLayout();
+
+    mSpaceAbove = scrollLayout.addNewElement<bs::GUIFixedSpace>(0);
+    mRowLayout  = scrollLayout.addNewElement<bs::GUILayoutY>();
+    mSpaceBelow = scrollLayout.addNewElement<bs::GUIFixedSpace>(0);
   }
 
   UIInventory::~UIInventory()
@@ -36,10 +46,14 @@ namespace REGoth
     if (mViewedInventory)
     {
       mRegisteredOnItemChangedEvent =
-          mViewedInventory->OnItemChanged.connect([this](const bs::String& instance) {
-            // Get notified when the viewed inventory changes
-            onInventoryItemUpdated(instance);
-          });
+          mViewedInventory->OnItemsChanged.connect(
+              [this](const bs::Vector<Scripting::SymbolIndex>& instances) {
+                // Get notified when the viewed inventory changes
+                for (Scripting::SymbolIndex instance : instances)
+                {
+                  onInventoryItemUpdated(mViewedInventory->itemName(instance));
+                }
+              });
 
       forceUpdateAll();
     }
@@ -64,14 +78,12 @@ namespace REGoth
     }
   }
 
-  void UIInventory::update()
+  void UIInventory::updateLayout(const bs::Rect2I& parentBounds)
   {
-    UIElement::update();
-
-    bs::Rect2I bounds = parentLayout().getBounds();
+    bs::Rect2I bounds = parentBounds;
 
     bounds.y      = 0;
-    bounds.height = parentLayout().getBounds().height;
+    bounds.height = parentBounds.height;
     bounds.width  = 180;
 
     layout().setBounds(bounds);
@@ -79,23 +91,102 @@ namespace REGoth
     mScrollArea->setHeight(layout().getBounds().height);
   }
 
-  void UIInventory::removeAll()
+  void UIInventory::update()
   {
-    for (const auto& instance : allInstancesInInventory())
+    // Rows partially visible at the top and bottom need a button as well
+    size_t firstVisible = (size_t)(mScrollArea->getVerticalScroll() / ROW_HEIGHT);
+    size_t numVisible   = layout().getBounds().height / ROW_HEIGHT + 2;
+
+    if (firstVisible != mFirstVisibleRow || numVisible != mNumVisibleRows)
     {
-      removeUIElementsFromItem(mItemsByInstance[instance]);
+      mFirstVisibleRow = firstVisible;
+      mNumVisibleRows  = numVisible;
+
+      markDirty(DIRTY_TEXT);
     }
 
+    UIElement::update();
+  }
+
+  void UIInventory::updateText()
+  {
+    if (mIsRowListDirty)
+    {
+      mRows           = allInstancesInInventory();
+      mIsRowListDirty = false;
+    }
+
+    size_t first = std::min(mFirstVisibleRow, mRows.size());
+    size_t count = std::min(mNumVisibleRows, mRows.size() - first);
+
+    mSpaceAbove->setSize((bs::UINT32)(first * ROW_HEIGHT));
+    mSpaceBelow->setSize((bs::UINT32)((mRows.size() - first - count) * ROW_HEIGHT));
+
+    for (size_t i = 0; i < count; i++)
+    {
+      const bs::String& instance = mRows[first + i];
+      const Item& item           = mItemsByInstance[instance];
+      RowButton& row             = rowButton(i);
+
+      if (i >= mNumRowButtonsShown)
+      {
+        row.button->setActive(true);
+      }
+
+      if (row.shownInstance == instance && row.shownCount == item.count) continue;
+
+      auto content = bs::StringUtil::format("{0} ({1})", item.name, item.count);
+      row.button->setContent(bs::GUIContent(bs::HString(content)));
+
+      row.shownInstance = instance;
+      row.shownCount    = item.count;
+    }
+
+    // Inactive elements don't take up space inside the layout
+    for (size_t i = count; i < mNumRowButtonsShown; i++)
+    {
+      mRowButtons[i].button->setActive(false);
+    }
+
+    mNumRowButtonsShown = count;
+  }
+
+  UIInventory::RowButton& UIInventory::rowButton(size_t n)
+  {
+    if (n < mRowButtons.size()) return mRowButtons[n];
+
+    RowButton row;
+    row.button = mRowLayout->addNewElement<bs::GUIButton>(bs::HString("<none>"));
+    row.button->setHeight(ROW_HEIGHT);
+
+    mRowButtons.push_back(row);
+
+    return mRowButtons.back();
+  }
+
+  void UIInventory::removeAll()
+  {
     mItemsByInstance.clear();
+
+    mIsRowListDirty = true;
+    markDirty(DIRTY_TEXT);
   }
 
   void UIInventory::forceUpdateAll()
   {
-    removeAll();
+    // onInventoryItemUpdated() only adds or removes the difference, which leaves out the
+    // items no longer inside the inventory at all
+    for (const auto& instance : allInstancesInInventory())
+    {
+      if (!mViewedInventory->hasItem(instance))
+      {
+        removeItemFromList(instance);
+      }
+    }
 
-    for (const auto& p : mViewedInventory->allItems())
+    for (const auto& stack : mViewedInventory->allItems())
     {
-      onInventoryItemUpdated(p.first);
+      onInventoryItemUpdated(mViewedInventory->itemName(stack.instance));
     }
   }
 
@@ -143,7 +234,7 @@ namespace REGoth
       item.count = count;
       item.name  = name;
 
-      createUIElementsForItem(item);
+      mIsRowListDirty = true;
 
       updateItemThumbnail(item);
     }
@@ -189,32 +280,16 @@ namespace REGoth
       return;
     }
 
-    auto& item = it->second;
-
-    removeUIElementsFromItem(item);
-
     mItemsByInstance.erase(it);
-  }
-
-  void UIInventory::updateItemThumbnail(Item& item)
-  {
-    auto content = bs::StringUtil::format("{0} ({1})", item.name, item.count);
 
-    item.button->setContent(bs::GUIContent(bs::HString(content)));
+    mIsRowListDirty = true;
+    markDirty(DIRTY_TEXT);
   }
 
-  void UIInventory::createUIElementsForItem(Item& item)
-  {
-    if (item.button) return;
-
-    item.button = mScrollArea->getLayout().addNewElement<bs::GUIButton>(bs::HString("<none>"));
-  }
-
-  void UIInventory::removeUIElementsFromItem(Item& item)
+  void UIInventory::updateItemThumbnail(Item& item)
   {
-    mScrollArea->getLayout().removeElement(item.button);
-
-    item.button = nullptr;
+    // The visible rows compare against what they show, so there is nothing to remember
+    markDirty(DIRTY_TEXT);
   }
 
   REGOTH_DEFINE_RTTI(UIInventory)
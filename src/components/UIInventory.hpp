@@ -8,7 +8,13 @@ namespace REGoth
   using HInventory = bs::GameObjectHandle<Inventory>;
 
   /**
-   * TODO: Documentation of UIInventory
+   * Lists the items of an inventory, one row per item instance.
+   *
+   * Traders and chests can hold hundreds of different items, so only the rows which are
+   * currently visible inside the scroll area get a GUI element. Those are taken from a small
+   * pool and handed to other rows while scrolling. All rows have the same height, so the
+   * rows above and below the visible ones are replaced by spaces of the right size, which
+   * keeps the scroll bar working as if all rows were there.
    */
   class UIInventory : public UIElement
   {
@@ -25,10 +31,22 @@ namespace REGoth
     struct Item
     {
       bs::String name;
-      bs::UINT32 count      = 0;
+      bs::UINT32 count = 0;
+    };
+
+    /**
+     * A button of the pool and what it currently shows, so it's only changed if needed.
+     */
+    struct RowButton
+    {
       bs::GUIButton* button = nullptr;
+      bs::String shownInstance;
+      bs::UINT32 shownCount = 0;
     };
 
+    /** Height of a single row in pixels */
+    static constexpr bs::UINT32 ROW_HEIGHT = 24;
+
     /**
      * Clears the complete list.
      *
@@ -37,7 +55,8 @@ namespace REGoth
     void removeAll();
 
     /**
-     * Removes all items from the UI and regenerates them from the viewed inventory.
+     * Makes the UI show exactly the items of the viewed inventory. Items already shown are
+     * kept, only the ones which changed are updated.
      */
     void forceUpdateAll();
 
@@ -76,20 +95,54 @@ namespace REGoth
     void removeItem(const bs::String& instance, bs::UINT32 count = 1);
 
     /**
-     * Updates the gui thumbnail of the given item instance with a new count, image, etc.
+     * Marks the gui thumbnail of the given item instance to be updated with a new count,
+     * image, etc. on the next update, so multiple changes in one frame only update it once.
+     * Thumbnails of rows not visible are not updated at all.
      */
     void updateItemThumbnail(Item& item);
-    void createUIElementsForItem(Item& item);
-    void removeUIElementsFromItem(Item& item);
     void removeItemFromList(const bs::String& instance);
     bs::Vector<bs::String> allInstancesInInventory() const;
 
-    /** Triggered once per frame. Allows the component to handle input and move. */
+    /** Triggered once per frame. Checks whether other rows have been scrolled into view. */
     void update() override;
 
+    void updateLayout(const bs::Rect2I& parentBounds) override;
+
+    /**
+     * Gives the visible rows their buttons and resizes the spaces standing in for the
+     * others.
+     */
+    void updateText() override;
+
+    /**
+     * @return The button of the pool for the n-th visible row, created if there are not
+     *         enough yet.
+     */
+    RowButton& rowButton(size_t n);
+
   private:
     bs::GUIScrollArea* mScrollArea;
 
+    /** Stand-ins for the rows above and below the visible ones */
+    bs::GUIFixedSpace* mSpaceAbove;
+    bs::GUIFixedSpace* mSpaceBelow;
+
+    /** Holds the buttons of the visible rows, between the spaces */
+    bs::GUILayout* mRowLayout;
+
+    bs::Vector<RowButton> mRowButtons;
+
+    /** How many buttons of the pool are active */
+    size_t mNumRowButtonsShown = 0;
+
+    /** Instances of all rows, in display order. Rebuilt if items are added or removed. */
+    bs::Vector<bs::String> mRows;
+    bool mIsRowListDirty = true;
+
+    /** Which rows are inside the scroll area, see update() */
+    size_t mFirstVisibleRow = 0;
+    size_t mNumVisibleRows  = 0;
+
     bs::Map<const bs::String, Item> mItemsByInstance;
 
     /**
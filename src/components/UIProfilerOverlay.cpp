@@ -0,0 +1,89 @@
+#include "UIProfilerOverlay.hpp"
+#include <GUI/BsGUILabel.h>
+#include <GUI/BsGUIPanel.h>
+#include <RTTI/RTTI_UIProfilerOverlay.hpp>
+#include <Utility/BsTime.h>
+#include <core/FrameMonitor.hpp>
+#include <core/MemoryAccounting.hpp>
+#include <core/Profiling.hpp>
+
+namespace REGoth
+{
+  constexpr bs::UINT32 UIProfilerOverlay::MAX_SCOPES_SHOWN;
+  constexpr float UIProfilerOverlay::REFRESH_INTERVAL;
+
+  UIProfilerOverlay::UIProfilerOverlay(const bs::HSceneObject& parent,
+                                       HUIElement parentUiElement)
+      : UIElement(parent, parentUiElement, new bs::GUIPanel())
+  {
+    setName("UIProfilerOverlay");
+
+    mText = layout().addNewElement<bs::GUILabel>(bs::HString(""));
+    mText->setVisible(false);
+  }
+
+  UIProfilerOverlay::~UIProfilerOverlay()
+  {
+  }
+
+  void UIProfilerOverlay::update()
+  {
+    bool isEnabled = gProfiler().isEnabled() || gFrameMonitor().isEnabled();
+
+    if (isEnabled != mIsShown)
+    {
+      mText->setVisible(isEnabled);
+      mIsShown = isEnabled;
+    }
+
+    if (isEnabled)
+    {
+      mTimeUntilRefresh -= bs::gTime().getFrameDelta();
+
+      if (mTimeUntilRefresh <= 0.0f)
+      {
+        mTimeUntilRefresh = REFRESH_INTERVAL;
+        refreshText();
+      }
+    }
+
+    UIElement::update();
+  }
+
+  void UIProfilerOverlay::refreshText()
+  {
+    bs::String text = bs::StringUtil::format("Frame: {0} ms\n",
+                                             bs::gTime().getFrameDelta() * 1000.0f);
+
+    bs::Vector<Profiler::ScopeTotal> totals = gProfiler().lastFrameTotals();
+
+    for (size_t i = 0; i < totals.size() && i < MAX_SCOPES_SHOWN; i++)
+    {
+      text += bs::StringUtil::format("{0}: {1} ms ({2}x)\n", totals[i].name,
+                                     totals[i].nanoseconds / 1000000.0, totals[i].numCalls);
+    }
+
+    text += "\n" + gMemoryAccounting().reportText();
+    text += "\n" + gFrameMonitor().reportText();
+
+    mPendingText = text;
+    markDirty(DIRTY_TEXT);
+  }
+
+  void UIProfilerOverlay::updateLayout(const bs::Rect2I& parentBounds)
+  {
+    layout().setPosition(parentBounds.width / 100, parentBounds.height / 100);
+    layout().setWidth(parentBounds.width / 3);
+    layout().setHeight(parentBounds.height / 2);
+
+    mText->setWidth(parentBounds.width / 3);
+    mText->setHeight(parentBounds.height / 2);
+  }
+
+  void UIProfilerOverlay::updateText()
+  {
+    mText->setContent(bs::GUIContent(bs::HString(mPendingText)));
+  }
+
+  REGOTH_DEFINE_RTTI(UIProfilerOverlay)
+}  // namespace REGoth
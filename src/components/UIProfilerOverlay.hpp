@@ -0,0 +1,51 @@
+#pragma once
+#include "UIElement.hpp"
+#include <RTTI/RTTIUtil.hpp>
+
+namespace REGoth
+{
+  /**
+   * Shows the most expensive scopes recorded by gProfiler() during the last frame in the top
+   * left corner of the screen, followed by the memory taken by the engine's systems, see
+   * gMemoryAccounting(), and the allocations and hitches seen by gFrameMonitor(). Only visible
+   * while the profiler or the frame monitor is enabled, which is done via `--profile` or
+   * `--frame-monitor`, see EngineConfig::isProfiling and EngineConfig::isMonitoringFrames.
+   */
+  class UIProfilerOverlay : public UIElement
+  {
+  public:
+    UIProfilerOverlay(const bs::HSceneObject& parent, HUIElement parentUiElement);
+    virtual ~UIProfilerOverlay();
+
+  protected:
+    void update() override;
+    void updateLayout(const bs::Rect2I& parentBounds) override;
+    void updateText() override;
+
+  private:
+    /**
+     * Puts together the text for the totals of the last frame, the memory report and the
+     * report of the frame monitor.
+     */
+    void refreshText();
+
+    /** Number of scopes shown at most */
+    static constexpr bs::UINT32 MAX_SCOPES_SHOWN = 16;
+
+    /** Seconds between two refreshes of the text, so it can still be read */
+    static constexpr float REFRESH_INTERVAL = 0.5f;
+
+    bs::GUILabel* mText;
+    float mTimeUntilRefresh = 0.0f;
+    bool mIsShown           = false;
+
+    /** Shown on the next updateText() */
+    bs::String mPendingText;
+
+  public:
+    REGOTH_DECLARE_RTTI(UIProfilerOverlay)
+
+  protected:
+    UIProfilerOverlay() = default;  // For RTTI
+  };
+}  // namespace REGoth
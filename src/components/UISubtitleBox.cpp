@@ -19,7 +19,9 @@ namespace REGoth
 
     mBackgroundBox = layout().addNewElement<bs::GUITexture>("GothicDialogueBoxBackground");
 
-    mText = layout().addNewElement<bs::GUILabel>(bs::HString("Hello World!"));
+    mText = layout().addNewElement<bs::GUILabel>(bs::HString(mDialogueText));
+
+    setBoxVisible(false);
   }
 
   UISubtitleBox::~UISubtitleBox()
@@ -28,20 +30,11 @@ namespace REGoth
 
   void UISubtitleBox::update()
   {
-    UIElement::update();
-
-    bs::Rect2I parentBounds  = parentLayout().getBounds();
-    bs::UINT32 thirdOfParent = parentBounds.width / 3;
-
-    layout().setPosition(thirdOfParent, parentBounds.height * 0.01);
-    layout().setWidth(thirdOfParent * mBoxSizeRatio);
-    layout().setHeight(parentBounds.height * 0.1 * mBoxSizeRatio);
-
+    // Only the animations change the size of the box, while open or closed nothing happens
     switch (mState)
     {
       case State::Closed:
-        mBackgroundBox->setVisible(false);
-        mText->setVisible(false);
+      case State::Open:
         break;
 
       case State::Growing:
@@ -51,12 +44,10 @@ namespace REGoth
         if (mBoxSizeRatio >= 1)
         {
           mState = State::Open;
+          setBoxVisible(true);
         }
-        break;
 
-      case State::Open:
-        mBackgroundBox->setVisible(true);
-        mText->setVisible(true);
+        markDirty(DIRTY_LAYOUT);
         break;
 
       case State::Shrinking:
@@ -66,10 +57,34 @@ namespace REGoth
         if (mBoxSizeRatio <= 0)
         {
           mState = State::Closed;
+          setBoxVisible(false);
         }
 
+        markDirty(DIRTY_LAYOUT);
         break;
     }
+
+    UIElement::update();
+  }
+
+  void UISubtitleBox::updateLayout(const bs::Rect2I& parentBounds)
+  {
+    bs::UINT32 thirdOfParent = parentBounds.width / 3;
+
+    layout().setPosition(thirdOfParent, parentBounds.height * 0.01);
+    layout().setWidth(thirdOfParent * mBoxSizeRatio);
+    layout().setHeight(parentBounds.height * 0.1 * mBoxSizeRatio);
+  }
+
+  void UISubtitleBox::updateText()
+  {
+    mText->setContent(bs::HString(mDialogueText));
+  }
+
+  void UISubtitleBox::setBoxVisible(bool isVisible)
+  {
+    mBackgroundBox->setVisible(isVisible);
+    mText->setVisible(isVisible);
   }
 
   void UISubtitleBox::open()
@@ -93,7 +108,10 @@ namespace REGoth
 
   void UISubtitleBox::setDialogueText(const bs::String& text)
   {
-    mText->setContent(bs::HString(text));
+    if (text == mDialogueText) return;
+
+    mDialogueText = text;
+    markDirty(DIRTY_TEXT);
   }
 
   bool UISubtitleBox::isDoingAnimation() const
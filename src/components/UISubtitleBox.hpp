@@ -60,13 +60,24 @@ namespace REGoth
     /** Triggered once per frame. Allows the component to handle input and move. */
     void update() override;
 
+    void updateLayout(const bs::Rect2I& parentBounds) override;
+    void updateText() override;
+
   private:
+    /**
+     * Shows or hides the box and its text.
+     */
+    void setBoxVisible(bool isVisible);
+
     bs::GUITexture* mBackgroundBox = nullptr;
     bs::GUILabel* mText            = nullptr;
 
-    State mState = State::Closed;
+    State mState        = State::Closed;
     float mBoxSizeRatio = 0.0f;
 
+    /** See setDialogueText() */
+    bs::String mDialogueText = "Hello World!";
+
   public:
     REGOTH_DECLARE_RTTI(UISubtitleBox)
 
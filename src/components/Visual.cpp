@@ -38,21 +38,37 @@ namespace REGoth
     }
   }
 
-  bool Visual::addToSceneObject(bs::HSceneObject so, const bs::String& visual)
+  bool Visual::addToSceneObject(bs::HSceneObject so, const bs::String& visual, Loading loading)
   {
     VisualKind kind = guessVisualKind(visual);
 
     if (kind == VisualKind::StaticMesh)
     {
       HVisualStaticMesh mesh = so->addComponent<VisualStaticMesh>();
-      mesh->setMesh(visual);
+
+      if (loading == Loading::InBackground)
+      {
+        mesh->setMeshAsync(visual);
+      }
+      else
+      {
+        mesh->setMesh(visual);
+      }
 
       return true;
     }
     else if (kind == VisualKind::MorphMesh)
     {
       HVisualMorphMesh mesh = so->addComponent<VisualMorphMesh>();
-      mesh->setMesh(visual);
+
+      if (loading == Loading::InBackground)
+      {
+        mesh->setMeshAsync(visual);
+      }
+      else
+      {
+        mesh->setMesh(visual);
+      }
 
       return true;
     }
@@ -32,6 +32,18 @@ namespace REGoth
      */
     VisualKind guessVisualKind(const bs::String& visual);
 
+    /**
+     * When the resources of a visual are loaded, see addToSceneObject().
+     */
+    enum class Loading
+    {
+      /** Right away, the visual is complete once it has been added */
+      Immediately,
+
+      /** In the background, the visual shows up a few frames later */
+      InBackground,
+    };
+
     /**
      * Creates a matching visual component and attaches it to the given scene object.
      *
@@ -41,11 +53,17 @@ namespace REGoth
      *         `.ASC` are also used for character models. So don't use this function
      *         for characters, please.
      *
-     * @param  so      Scene-Object to create the component for.
-     * @param  visual  Name of the visual to create (The filename, that is), like `STONE.3DS`.
+     * Static and morph meshes can be loaded in the background, so visuals created in the
+     * middle of the game don't make it hitch. Interactive objects are always loaded right away,
+     * since their animations are set up right after.
+     *
+     * @param  so       Scene-Object to create the component for.
+     * @param  visual   Name of the visual to create (The filename, that is), like `STONE.3DS`.
+     * @param  loading  When to load the resources of the visual.
      *
      * @return Whether a visual component has been created.
      */
-    bool addToSceneObject(bs::HSceneObject so, const bs::String& visual);
+    bool addToSceneObject(bs::HSceneObject so, const bs::String& visual,
+                          Loading loading = Loading::Immediately);
   }
 }
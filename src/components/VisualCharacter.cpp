@@ -1,5 +1,6 @@
 #include "VisualCharacter.hpp"
 #include "original-content/VirtualFileSystem.hpp"
+#include <original-content/CharacterVariantCache.hpp>
 #include <Animation/BsAnimationClip.h>
 #include <BsZenLib/ImportPath.hpp>
 #include <BsZenLib/ImportSkeletalMesh.hpp>
@@ -12,6 +13,7 @@
 #include <animation/Animation.hpp>
 #include <animation/StateNaming.hpp>
 #include <components/NodeVisuals.hpp>
+#include <components/VisualMorphMesh.hpp>
 #include <exception/Throw.hpp>
 #include <log/logging.hpp>
 
@@ -30,13 +32,59 @@ namespace REGoth
     setName("VisualCharacter");
   }
 
-  void VisualCharacter::setBodyMesh(const bs::String& bodyMesh)
+  void VisualCharacter::setBodyMesh(const bs::String& bodyMesh, bs::UINT32 bodyTextureIdx,
+                                    bs::UINT32 bodySkinColorIdx)
   {
-    if (!modelScript())
+    if (!modelScript() && !isLoadingVisual())
     {
       REGOTH_THROW(InvalidStateException, "No model script set! Has setVisual() been called?");
     }
 
+    // Needed by meshMaterials() when setting the mesh
+    mBodyState.bodyVisual       = bodyMesh;
+    mBodyState.bodyTextureIdx   = bodyTextureIdx;
+    mBodyState.bodySkinColorIdx = bodySkinColorIdx;
+
+    // Set by onVisualLoaded() instead
+    if (isLoadingVisual()) return;
+
+    updateBodyMesh();
+  }
+
+  void VisualCharacter::setHeadMesh(const bs::String& headmesh, bs::UINT32 headTextureIdx,
+                                    bs::UINT32 teethTextureIdx)
+  {
+    mBodyState.headVisual      = headmesh;
+    mBodyState.headTextureIdx  = headTextureIdx;
+    mBodyState.teethTextureIdx = teethTextureIdx;
+
+    // Choose MMB as default filetype of no extension was given
+    if (!mBodyState.headVisual.empty() &&
+        mBodyState.headVisual.find_first_of('.') == bs::String::npos)
+    {
+      mBodyState.headVisual += ".MMB";
+    }
+
+    // Set by onVisualLoaded() instead
+    if (isLoadingVisual()) return;
+
+    updateHeadMesh();
+  }
+
+  void VisualCharacter::onVisualLoaded()
+  {
+    if (!mBodyState.bodyVisual.empty())
+    {
+      updateBodyMesh();
+    }
+
+    updateHeadMesh();
+  }
+
+  void VisualCharacter::updateBodyMesh()
+  {
+    const bs::String& bodyMesh = mBodyState.bodyVisual;
+
     // Those sometimes come with file extension.
     bs::String bodyMeshNoExt                = bodyMesh.substr(0, bodyMesh.find_last_of('.'));
     BsZenLib::Res::HMeshWithMaterials hmesh = modelScript()->getMeshByName(bodyMeshNoExt);
@@ -62,41 +110,42 @@ namespace REGoth
     }
   }
 
-  void VisualCharacter::setHeadMesh(const bs::String& headmesh, bs::UINT32 headTextureIdx,
-                                    bs::UINT32 teethTextureIdx)
+  void VisualCharacter::updateHeadMesh()
   {
-    mBodyState.headVisual      = headmesh;
-    mBodyState.headTextureIdx  = headTextureIdx;
-    mBodyState.teethTextureIdx = teethTextureIdx;
+    using namespace bs;
 
-    // Choose MMB as default filetype of no extension was given
-    if (!mBodyState.headVisual.empty() &&
-        mBodyState.headVisual.find_first_of('.') == bs::String::npos)
+    if (mBodyState.headVisual.empty())
     {
-      mBodyState.headVisual += ".MMB";
+      nodeVisuals()->clearNodeAttachment(MODEL_NODE_NAME_HEAD);
+      return;
     }
 
-    updateHeadMesh();
-  }
+    nodeVisuals()->attachVisualToNode(MODEL_NODE_NAME_HEAD, mBodyState.headVisual);
 
-  void VisualCharacter::updateBodyMesh()
-  {
+    HSceneObject headSO = nodeVisuals()->findNodeAttachment(MODEL_NODE_NAME_HEAD);
+
+    if (!headSO) return;
+
+    // Heads are morph meshes, which load in the background and pick up the variant then
+    HVisualMorphMesh head = headSO->getComponent<VisualMorphMesh>();
+
+    if (!head) return;
+
+    CharacterTextureVariant variant;
+    variant.textureIdx = mBodyState.headTextureIdx;
+    variant.colorIdx   = mBodyState.bodySkinColorIdx;
+    variant.teethIdx   = mBodyState.teethTextureIdx;
+
+    head->setTextureVariant(variant);
   }
 
-  void VisualCharacter::updateHeadMesh()
+  bs::Vector<bs::HMaterial> VisualCharacter::meshMaterials() const
   {
-    using namespace bs;
-
-    if (!mBodyState.headVisual.empty())
-    {
-      nodeVisuals()->attachVisualToNode(MODEL_NODE_NAME_HEAD, mBodyState.headVisual);
-    }
-    else
-    {
-      nodeVisuals()->clearNodeAttachment(MODEL_NODE_NAME_HEAD);
-    }
+    CharacterTextureVariant variant;
+    variant.textureIdx = mBodyState.bodyTextureIdx;
+    variant.colorIdx   = mBodyState.bodySkinColorIdx;
 
-    // TODO: Fix texture and color
+    return gCharacterVariantCache().materials(mesh(), variant);
   }
 
   bs::Vector<bs::String> VisualCharacter::listPossibleDefaultAnimations() const
@@ -30,19 +30,29 @@ namespace REGoth
     /**
      * Sets the body mesh.
      *
-     * Throws if the body mesh is not listed inside the model script.
+     * Throws if the body mesh is not listed inside the model script. While the visual is
+     * loading, the body mesh is only remembered and set once it has been loaded.
      *
-     * @param  bodyMesh  Name of the body mesh to use, e.g. `HUM_BODY_NAKED0`. The
-     *                   file extension can be omitted.
+     * Characters with the same body mesh and texture variant share their materials, see
+     * CharacterVariantCache.
+     *
+     * @param  bodyMesh          Name of the body mesh to use, e.g. `HUM_BODY_NAKED0`. The
+     *                           file extension can be omitted.
+     * @param  bodyTextureIdx    Variant of the body texture.
+     * @param  bodySkinColorIdx  Skin color of body and head.
      */
-    void setBodyMesh(const bs::String& bodyMesh);
+    void setBodyMesh(const bs::String& bodyMesh, bs::UINT32 bodyTextureIdx = 0,
+                     bs::UINT32 bodySkinColorIdx = 0);
 
     /**
-     * Sets the headmesh for this model.
+     * Sets the headmesh for this model. Like the body mesh, this waits for the visual if it is
+     * still loading.
      *
      * @param  head  File of the mesh to use as head, e.g. `HUM_HEAD.MMB`. The file
      *               extension is not required. If none was given, `.MMB` will be
      *               assumed.
+     * @param  headTextureIdx   Variant of the face texture.
+     * @param  teethTextureIdx  Variant of the teeth texture.
      */
     void setHeadMesh(const bs::String& headmesh, bs::UINT32 headTextureIdx = 0,
                      bs::UINT32 teethTextureIdx = 0);
@@ -50,9 +60,21 @@ namespace REGoth
   protected:
     bs::Vector<bs::String> listPossibleDefaultAnimations() const override;
 
+    /**
+     * @return The body materials in the texture variant of the body state.
+     */
+    bs::Vector<bs::HMaterial> meshMaterials() const override;
+
+    /**
+     * Sets the body and head meshes given while the visual was loading.
+     */
+    void onVisualLoaded() override;
+
   private:
     /**
-     * Replaces the current body mesh of this model from the current body-state
+     * Replaces the current body mesh of this model from the current body-state.
+     *
+     * Throws if the model script has no meshes at all.
      */
     void updateBodyMesh();
 
@@ -17,8 +17,43 @@ namespace REGoth
 
   void VisualMorphMesh::setMesh(const bs::String& originalMeshFileName)
   {
-    auto mesh = gOriginalGameResources().morphMesh(originalMeshFileName);
+    mPendingMesh = {};
 
+    showMesh(originalMeshFileName, gOriginalGameResources().morphMesh(originalMeshFileName));
+  }
+
+  void VisualMorphMesh::setMeshAsync(const bs::String& originalMeshFileName)
+  {
+    mPendingMesh         = gOriginalGameResources().morphMeshAsync(originalMeshFileName);
+    mPendingMeshFileName = originalMeshFileName;
+  }
+
+  void VisualMorphMesh::setTextureVariant(const CharacterTextureVariant& variant)
+  {
+    if (variant == mTextureVariant) return;
+
+    mTextureVariant = variant;
+
+    if (mMesh)
+    {
+      mRenderable->setMaterials(gCharacterVariantCache().materials(mMesh, mTextureVariant));
+    }
+  }
+
+  void VisualMorphMesh::update()
+  {
+    if (!mPendingMesh.isRequested() || !mPendingMesh.isReady()) return;
+
+    BsZenLib::Res::HMeshWithMaterials mesh = mPendingMesh.get();
+
+    mPendingMesh = {};
+
+    showMesh(mPendingMeshFileName, mesh);
+  }
+
+  void VisualMorphMesh::showMesh(const bs::String& originalMeshFileName,
+                                 BsZenLib::Res::HMeshWithMaterials mesh)
+  {
     if (!mesh)
     {
       REGOTH_LOG(Warning, Uncategorized, "[VisualMorphMesh] Failed to load mesh: {0}",
@@ -26,8 +61,10 @@ namespace REGoth
       return;
     }
 
+    mMesh = mesh;
+
     mRenderable->setMesh(mesh->getMesh());
-    mRenderable->setMaterials(mesh->getMaterials());
+    mRenderable->setMaterials(gCharacterVariantCache().materials(mesh, mTextureVariant));
   }
 
   bs::HRenderable VisualMorphMesh::createRenderable()
@@ -7,6 +7,8 @@
 #include <BsZenLib/ZenResources.hpp>
 #include <Scene/BsComponent.h>
 #include <RTTI/RTTIUtil.hpp>
+#include <original-content/CharacterVariantCache.hpp>
+#include <original-content/OriginalGameResources.hpp>
 
 namespace REGoth
 {
@@ -29,8 +31,30 @@ namespace REGoth
      */
     void setMesh(const bs::String& originalMeshFileName);
 
+    /**
+     * Like setMesh(), but loads the mesh in the background. Nothing is displayed until it has
+     * been loaded, see VisualStaticMesh::setMeshAsync().
+     */
+    void setMeshAsync(const bs::String& originalMeshFileName);
+
+    /**
+     * Shows the mesh in the given texture variant, like a head with a different face. The
+     * materials are shared with every other mesh in the same variant, see
+     * CharacterVariantCache. Also applies to meshes set later.
+     */
+    void setTextureVariant(const CharacterTextureVariant& variant);
+
+    /** Triggered once per frame. Picks up the mesh set via setMeshAsync(). */
+    void update() override;
+
   private:
 
+    /**
+     * Displays the given mesh loaded from the given file.
+     */
+    void showMesh(const bs::String& originalMeshFileName,
+                  BsZenLib::Res::HMeshWithMaterials mesh);
+
     /**
      * Creates the renderable on the scene object
      */
@@ -49,6 +73,22 @@ namespace REGoth
      */
     bs::HRenderable mRenderable;
 
+    /**
+     * Mesh currently shown, to apply a different texture variant to.
+     */
+    BsZenLib::Res::HMeshWithMaterials mMesh;
+
+    /**
+     * See setTextureVariant(). Not saved, like the mesh.
+     */
+    CharacterTextureVariant mTextureVariant;
+
+    /**
+     * Mesh being loaded for setMeshAsync(). Not saved, see VisualStaticMesh.
+     */
+    PendingResource<BsZenLib::Res::HMeshWithMaterials> mPendingMesh;
+    bs::String mPendingMeshFileName;
+
   public:
     REGOTH_DECLARE_RTTI(VisualMorphMesh)
 
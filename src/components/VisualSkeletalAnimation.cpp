@@ -6,16 +6,30 @@
 #include <Debug/BsDebug.h>
 #include <Mesh/BsMesh.h>
 #include <RTTI/RTTI_VisualSkeletalAnimation.hpp>
+#include <Renderer/BsCamera.h>
+#include <Scene/BsSceneManager.h>
 #include <Scene/BsSceneObject.h>
+#include <Utility/BsTime.h>
 #include <animation/Animation.hpp>
+#include <animation/AnimationLod.hpp>
 #include <animation/StateNaming.hpp>
 #include <components/NodeVisuals.hpp>
+#include <core/Profiling.hpp>
 #include <exception/Throw.hpp>
 #include <log/logging.hpp>
 #include <original-content/OriginalGameResources.hpp>
+#include <original-content/SharedMaterials.hpp>
 
 namespace REGoth
 {
+  constexpr float VisualSkeletalAnimation::LOD_CHECK_INTERVAL;
+
+  /**
+   * How much closer than the reduced detail distance the camera has to get to switch back to
+   * full detail.
+   */
+  constexpr float LOD_HYSTERESIS = 0.9f;
+
   VisualSkeletalAnimation::VisualSkeletalAnimation(const bs::HSceneObject& parent)
       : bs::Component(parent)
   {
@@ -61,20 +75,18 @@ namespace REGoth
     deleteObjectSubtree();
     mModelScript = modelScript;
 
-    createAnimationMap();
+    createAnimationTable();
   }
 
-  void VisualSkeletalAnimation::createAnimationMap()
+  void VisualSkeletalAnimation::createAnimationTable()
   {
     if (!mModelScript)
     {
       REGOTH_THROW(InvalidStateException, "No model script set!");
     }
 
-    for (auto anim : mModelScript->getAnimations())
-    {
-      mAnimationClips[anim->getName()] = anim;
-    }
+    mAnimationTable    = AnimationTable::forModelScript(mModelScript);
+    mRootMotionSamples = nullptr;
   }
 
   void VisualSkeletalAnimation::setMesh(BsZenLib::Res::HMeshWithMaterials mesh)
@@ -119,6 +131,9 @@ namespace REGoth
 
   void VisualSkeletalAnimation::setVisual(const bs::String& visual)
   {
+    mPendingModelScript = {};
+    mPendingVisual.clear();
+
     auto modelScript = gOriginalGameResources().modelScript(visual);
 
     if (!modelScript)
@@ -126,12 +141,61 @@ namespace REGoth
       REGOTH_THROW(InvalidParametersException, "Model Script " + visual + " could not be loaded!");
     }
 
+    showVisual(modelScript);
+  }
+
+  void VisualSkeletalAnimation::setVisualAsync(const bs::String& visual)
+  {
+    mPendingModelScript = gOriginalGameResources().modelScriptAsync(visual);
+    mPendingVisual      = visual;
+
+    // Loaded before, so there is no need to wait for the next frame
+    if (mPendingModelScript.isReady())
+    {
+      showPendingVisual();
+    }
+  }
+
+  void VisualSkeletalAnimation::finishLoadingVisual()
+  {
+    if (!isLoadingVisual()) return;
+
+    mPendingModelScript.wait();
+
+    showPendingVisual();
+  }
+
+  void VisualSkeletalAnimation::showPendingVisual()
+  {
+    BsZenLib::Res::HModelScriptFile modelScript = mPendingModelScript.get();
+    bs::String visual                           = mPendingVisual;
+
+    mPendingModelScript = {};
+    mPendingVisual.clear();
+
+    if (!modelScript || modelScript->getMeshes().empty())
+    {
+      REGOTH_LOG(Error, Anim, "[VisualSkeletalAnimation] Model Script {0} could not be loaded!",
+                 visual);
+      return;
+    }
+
+    showVisual(modelScript);
+    onVisualLoaded();
+  }
+
+  void VisualSkeletalAnimation::showVisual(BsZenLib::Res::HModelScriptFile modelScript)
+  {
     setModelScript(modelScript);
 
     // Using the first registered mesh as the default seems to be like the original is doing it
     useFirstMeshOfModelScript();
   }
 
+  void VisualSkeletalAnimation::onVisualLoaded()
+  {
+  }
+
   bool VisualSkeletalAnimation::hasVisual() const
   {
     if (!mModelScript)
@@ -219,74 +283,83 @@ namespace REGoth
     using namespace bs;
 
     mSubRenderable->setMesh(mMesh->getMesh());
-    mSubRenderable->setMaterials(mMesh->getMaterials());
+    mSubRenderable->setMaterials(meshMaterials());
+  }
+
+  bs::Vector<bs::HMaterial> VisualSkeletalAnimation::meshMaterials() const
+  {
+    return gSharedMaterials().find(mMesh->getMaterials());
   }
 
   void VisualSkeletalAnimation::setupAnimationComponent()
   {
     using namespace bs;
 
+    mSubAnimation->setEnableCull(gAnimationLodSettings().isCullingOffscreen);
+
+    // A new sub-tree starts out with all bones evaluated
+    mIsDetailReduced = false;
+
+    // Spread out the checks of characters created at the same time
+    mTimeUntilLODCheck = LOD_CHECK_INTERVAL * (float)(SO()->getInstanceId() % 16) / 16.0f;
+
     // Subscribe to animation events
-    mSubAnimation->onEventTriggered.connect([this](auto clip, auto string) {
+    mSubAnimation->onEventTriggered.connect([this](const auto& clip, const auto& string) {
       // Call objects actual method
       this->onAnimationEvent(clip, string);
     });
   }
 
-  void VisualSkeletalAnimation::onAnimationEvent(const bs::HAnimationClip& clip, bs::String string)
+  void VisualSkeletalAnimation::onAnimationEvent(const bs::HAnimationClip& clip,
+                                                 const bs::String& string)
   {
-    using namespace bs;
-
     throwIfNotReadyForRendering();
 
-    // Commands could come in the form of "COMMAND:ACTION" or just "COMMAND"
-    size_t separator = string.find_first_of(':');
-    bs::String command;
-    bs::String action;
+    // Events of the clips of the model script have been parsed when creating the table
+    const AnimationEventRecord* event =
+        mAnimationTable ? mAnimationTable->findEvent(string) : nullptr;
 
-    if (separator != bs::String::npos)
-    {
-      command = string.substr(0, separator);
-      action  = string.substr(command.length() + 1);
-    }
-    else
-    {
-      command = string;
-    }
+    AnimationEventRecord parsed;
 
-    bs::AnimationClipState state;
-    mSubAnimation->getState(clip, state);
-
-    if (command == "STOP")
-    {
-      playAnimationClip({});
-    }
-    else if (command == "PLAYCLIP")
+    if (!event)
     {
-      // gDebug().logDebug("[VisualSkeletalAnimation] " + SO()->getName() + " - " + clip->getName() +
-      //                   ": event PLAYCLIP: " + action);
+      parsed = AnimationTable::parseEvent(string);
 
-      auto clip = findAnimationClip(action);
-
-      if (clip)
+      if (parsed.type == AnimationEventType::PlayClip)
       {
-        playAnimationClip(clip);
+        parsed.clip = findAnimationClip(parsed.action);
       }
-      else
-      {
-        REGOTH_LOG(Warning, Uncategorized, "[VisualSkeletalAnimation] Unknown next animation: {0}",
-                   action);
-      }
-    }
-    else if (command == "MORPHMESHANI")
-    {
-      REGOTH_LOG(Warning, Uncategorized,
-                 "[VisualSkeletalAnimation] Unimplemented morph-mesh ani: {0}", action);
+
+      event = &parsed;
     }
-    else
+
+    switch (event->type)
     {
-      REGOTH_LOG(Warning, Uncategorized, "[VisualSkeletalAnimation] Unknown animation event: {0}",
-                 string);
+      case AnimationEventType::Stop:
+        playAnimationClip({});
+        break;
+
+      case AnimationEventType::PlayClip:
+        if (event->clip)
+        {
+          playAnimationClip(event->clip);
+        }
+        else
+        {
+          REGOTH_LOG(Warning, Anim,
+                     "[VisualSkeletalAnimation] Unknown next animation: {0}", event->action);
+        }
+        break;
+
+      case AnimationEventType::MorphMeshAnimation:
+        REGOTH_LOG(Warning, Anim,
+                   "[VisualSkeletalAnimation] Unimplemented morph-mesh ani: {0}", event->action);
+        break;
+
+      case AnimationEventType::Unknown:
+        REGOTH_LOG(Warning, Anim,
+                   "[VisualSkeletalAnimation] Unknown animation event: {0}", string);
+        break;
     }
   }
 
@@ -312,8 +385,9 @@ namespace REGoth
 
       if (layer > 0)
       {
-        // REGOTH_LOG(Info, Uncategorized, bs::StringUtil::format(
-        //     "[VisualSkeletalAnimation] Layered animation {1} not implemented", clip->getName()));
+        REGOTH_LOG(Verbose, Anim,
+                   "[VisualSkeletalAnimation] Layered animation {0} not implemented",
+                   clip->getName());
 
         // Commented out: Doesn't work yet
         // mSubAnimation->blendAdditive(clip, 1.0f, 0.0f, (bs::UINT32)layer);
@@ -359,20 +433,15 @@ namespace REGoth
     return {};
   }
 
-  bs::String VisualSkeletalAnimation::findAnimationToTransitionTo(const bs::String& stateAnim) const
+  HZAnimationClip VisualSkeletalAnimation::findClipToTransitionTo(
+      const bs::String& stateAnim) const
   {
-    bs::String stateNow = getStateFromPlayingAnimation();
-
-    // getStateFromPlayingAnimation returns a string without the leading S_
-    if (!stateNow.empty())
-    {
-      stateNow = "S_" + stateNow;
-    }
-
-    return findAnimationToTransitionTo(stateNow, stateAnim);
+    // Only state animations are found by the animation table, so transitions being played
+    // right now don't count as a state to go from.
+    return findClipToTransitionTo(getPlayingAnimationName(), stateAnim);
   }
 
-  bs::String VisualSkeletalAnimation::findAnimationToTransitionTo(const bs::String& fromAnim,
+  HZAnimationClip VisualSkeletalAnimation::findClipToTransitionTo(const bs::String& fromAnim,
                                                                   const bs::String& toAnim) const
   {
     // No animation being played should not happen during normal operation, but if it does,
@@ -380,42 +449,75 @@ namespace REGoth
     // might have been an other issue.
     if (!mSubAnimation->isPlaying())
     {
-      return toAnim;
+      return findAnimationClip(toAnim);
     }
 
     // Some animations are directly reachable, like S_RUN -> T_JUMPB. Whether the transition makes
     // sense has to be checked elsewhere.
     if (!AnimationState::isTransitionNeeded(toAnim))
     {
-      return toAnim;
+      return findAnimationClip(toAnim);
     }
 
-    bs::String from = AnimationState::getStateName(fromAnim);
-    bs::String to   = AnimationState::getStateName(toAnim);
+    if (!mAnimationTable) return {};
+
+    // Invalid if the transition wasn't meant to be possible
+    return mAnimationTable->transitionClip(mAnimationTable->findState(fromAnim),
+                                           mAnimationTable->findState(toAnim));
+  }
 
-    bs::String transition =
-        AnimationState::constructTransitionAnimationName(AI::WeaponMode::None, from, to);
+  HZAnimationClip VisualSkeletalAnimation::findClipToTransitionTo(AnimationStateIndex state) const
+  {
+    if (!mAnimationTable) return {};
 
-    // Transition not possible since it wasn't meant to be possible
-    if (transition.empty())
+    // Same as the version taking names, see there
+    if (!mSubAnimation->isPlaying())
     {
-      return "";
+      return mAnimationTable->stateClip(state);
     }
 
-    return transition;
+    return findClipToTransitionTo(playingClipRecord().state, state);
   }
 
-  HZAnimationClip VisualSkeletalAnimation::findAnimationClip(const bs::String& name) const
+  HZAnimationClip VisualSkeletalAnimation::findClipToTransitionTo(AnimationStateIndex from,
+                                                                  AnimationStateIndex to) const
   {
-    using namespace bs;
+    if (!mAnimationTable) return {};
 
-    bs::String actualName = mModelScript->getName() + "-" + name;
+    return mAnimationTable->transitionClip(from, to);
+  }
+
+  HZAnimationClip VisualSkeletalAnimation::playingClip() const
+  {
+    // Every clip is played through playAnimationClip(), which keeps track of it
+    if (!mSubAnimation || !mSubAnimation->isPlaying()) return {};
+
+    return mPlayingMainAnimation;
+  }
+
+  const AnimationClipRecord& VisualSkeletalAnimation::playingClipRecord() const
+  {
+    static const AnimationClipRecord noClip;
+
+    if (!mAnimationTable) return noClip;
+
+    return mAnimationTable->describeClip(playingClip());
+  }
+
+  HZAnimationClip VisualSkeletalAnimation::findAnimationClip(const bs::String& name) const
+  {
+    if (!mAnimationTable) return {};
 
-    auto result = mAnimationClips.find(actualName);
+    return mAnimationTable->findClip(name);
+  }
 
-    if (result == mAnimationClips.end()) return {};
+  HZAnimationClip VisualSkeletalAnimation::findStateAnimationClip(AI::WeaponMode weaponMode,
+                                                                  AI::WalkMode walkMode,
+                                                                  const bs::String& state) const
+  {
+    if (!mAnimationTable) return {};
 
-    return result->second;
+    return mAnimationTable->stateClip(mAnimationTable->findState(weaponMode, walkMode, state));
   }
 
   bool VisualSkeletalAnimation::isAnimationPlaying(HZAnimationClip clip) const
@@ -445,9 +547,7 @@ namespace REGoth
 
   bool VisualSkeletalAnimation::isPlayingAnimationInterruptable() const
   {
-    bs::String name = getPlayingAnimationName();
-
-    return name.find("-T_") == bs::String::npos;
+    return playingClipRecord().isInterruptable;
   }
 
   bool VisualSkeletalAnimation::isPlayingFlyingAnimation() const
@@ -465,11 +565,23 @@ namespace REGoth
 
   bs::Vector3 VisualSkeletalAnimation::resolveFrameRootMotion()
   {
-    if (!mSubAnimation) return bs::Vector3(bs::BsZero);
+    prepareFrameRootMotion();
+    computeFrameRootMotion();
 
-    bs::HAnimationClip clipNow = mSubAnimation->getClip(0);
+    // Includes what a RootMotionStage resolved before
+    bs::Vector3 motion  = mResolvedRootMotion;
+    mResolvedRootMotion = bs::Vector3(bs::BsZero);
+
+    return motion;
+  }
+
+  void VisualSkeletalAnimation::prepareFrameRootMotion()
+  {
+    mPendingRootMotion = {};
 
-    bs::Vector3 motion = bs::Vector3(bs::BsZero);
+    if (!mSubAnimation) return;
+
+    bs::HAnimationClip clipNow = mSubAnimation->getClip(0);
 
     if (mRootMotionLastClip != clipNow)
     {
@@ -485,11 +597,18 @@ namespace REGoth
 
       mRootMotionLastTime = 0.0f;
       mRootMotionLastClip = clipNow;
+      mRootMotionSamples  = nullptr;
     }
 
     if (!clipNow)
     {
-      return motion;
+      return;
+    }
+
+    // Not saved, so also looked up again after loading
+    if (!mRootMotionSamples && mAnimationTable)
+    {
+      mRootMotionSamples = &mAnimationTable->rootMotion(clipNow);
     }
 
     bs::AnimationClipState state;
@@ -519,19 +638,32 @@ namespace REGoth
         // motion += AnimationState::getRootMotionSince(clipNow, 0.0f, now);
         // motion += AnimationState::getRootMotionSince(clipNow, then, clipNow->getLength());
       }
+      else if (mRootMotionSamples)
+      {
+        mPendingRootMotion.then      = then;
+        mPendingRootMotion.now       = now;
+        mPendingRootMotion.isPending = true;
+      }
       else
       {
-        motion += AnimationState::getRootMotionSince(clipNow, then, now);
+        mResolvedRootMotion += AnimationState::getRootMotionSince(clipNow, then, now);
       }
 
-      // REGOTH_LOG(Info, Uncategorized, bs::StringUtil::format("RootMotion {0} -> {1}: {2}",
-      // then, now, bs::toString(motion)));
+      REGOTH_LOG(VeryVerbose, Anim, "[VisualSkeletalAnimation] RootMotion {0} -> {1}", then, now);
     }
 
     mRootMotionLastTime = state.time;
     mRootMotionLastClip = clipNow;
+  }
 
-    return motion;
+  void VisualSkeletalAnimation::computeFrameRootMotion()
+  {
+    if (!mPendingRootMotion.isPending) return;
+
+    mResolvedRootMotion += AnimationState::getRootMotionSince(
+        *mRootMotionSamples, mPendingRootMotion.then, mPendingRootMotion.now);
+
+    mPendingRootMotion.isPending = false;
   }
 
   bool VisualSkeletalAnimation::isPlayingIdleAnimation() const
@@ -551,6 +683,59 @@ namespace REGoth
     }
   }
 
+  void VisualSkeletalAnimation::update()
+  {
+    REGOTH_PROFILE_SCOPE("VisualSkeletalAnimation");
+
+    if (isLoadingVisual() && mPendingModelScript.isReady())
+    {
+      showPendingVisual();
+    }
+
+    if (!mSubAnimation || !mMesh) return;
+
+    mTimeUntilLODCheck -= bs::gTime().getFrameDelta();
+
+    if (mTimeUntilLODCheck > 0.0f) return;
+
+    mTimeUntilLODCheck += LOD_CHECK_INTERVAL;
+
+    const auto& mainCamera = bs::gSceneManager().getMainCamera();
+
+    if (!mainCamera) return;
+
+    float distance  = mainCamera->getTransform().pos().distance(SO()->getTransform().pos());
+    float threshold = gAnimationLodSettings().reducedDetailDistance;
+
+    // Staying less detailed until the camera is a bit closer than where it switched
+    if (mIsDetailReduced) threshold *= LOD_HYSTERESIS;
+
+    bool isReduced = distance > threshold;
+
+    if (isReduced != mIsDetailReduced)
+    {
+      setDetailReduced(isReduced);
+    }
+  }
+
+  void VisualSkeletalAnimation::setDetailReduced(bool isReduced)
+  {
+    const auto& skeleton = mMesh->getMesh()->getSkeleton();
+
+    if (!skeleton) return;
+
+    if (isReduced)
+    {
+      mSubAnimation->setMask(createReducedDetailMask(skeleton));
+    }
+    else
+    {
+      mSubAnimation->setMask(bs::SkeletonMask());
+    }
+
+    mIsDetailReduced = isReduced;
+  }
+
   bool VisualSkeletalAnimation::isClipLooping(HZAnimationClip clip) const
   {
     return clip->mIsLooping;
@@ -7,13 +7,14 @@
 #include <BsZenLib/ZenResources.hpp>
 #include <RTTI/RTTIUtil.hpp>
 #include <Scene/BsComponent.h>
+#include <animation/AnimationTable.hpp>
+#include <original-content/OriginalGameResources.hpp>
 
 namespace REGoth
 {
   class RTTI_VisualSkeletalAnimation;
   class NodeVisuals;
-  using HNodeVisuals    = bs::GameObjectHandle<NodeVisuals>;
-  using HZAnimationClip = BsZenLib::Res::HZAnimation;
+  using HNodeVisuals = bs::GameObjectHandle<NodeVisuals>;
 
   /**
    * Component for rendering an object animated using skeletal animation (Player, NPC, Monster).
@@ -37,6 +38,13 @@ namespace REGoth
    *
    * Therefore, this component needs to know the model script and the mesh
    * that it should display from that model script.
+   *
+   * # Level of detail
+   *
+   * Characters far away from the main camera don't evaluate small bones like fingers and
+   * characters outside of the view don't evaluate their skeleton at all, see
+   * AnimationLodSettings. Root motion is read from the animation clips directly, so it keeps
+   * working either way.
    */
   class VisualSkeletalAnimation : public bs::Component
   {
@@ -78,6 +86,29 @@ namespace REGoth
      */
     void setVisual(const bs::String& visual);
 
+    /**
+     * Like setVisual(), but loads the model script in the background. Whatever was shown
+     * before stays until then, which is nothing for a new character. Visuals which have been
+     * loaded before are shown right away.
+     *
+     * Logs instead of throwing if the visual does not exist.
+     */
+    void setVisualAsync(const bs::String& visual);
+
+    /**
+     * @return Whether the visual set via setVisualAsync() is still being loaded.
+     */
+    bool isLoadingVisual() const
+    {
+      return mPendingModelScript.isRequested();
+    }
+
+    /**
+     * Blocks until the visual set via setVisualAsync() has been loaded and shows it. Does
+     * nothing if none is being loaded.
+     */
+    void finishLoadingVisual();
+
     /**
      * @return Whether a visual has been assigned to this component, so that it can play animations.
      * 
@@ -96,6 +127,23 @@ namespace REGoth
      */
     bs::Vector3 resolveFrameRootMotion();
 
+    /**
+     * First half of resolveFrameRootMotion(): Reads how far the animation has advanced from
+     * the animation component. Not thread-safe.
+     *
+     * Together with computeFrameRootMotion(), this allows a RootMotionStage to resolve the
+     * root motion of many visuals in parallel. The result is then returned by the next call
+     * to resolveFrameRootMotion().
+     */
+    void prepareFrameRootMotion();
+
+    /**
+     * Second half of resolveFrameRootMotion(): Computes the root motion prepared by
+     * prepareFrameRootMotion(). Only touches this visual, so visuals can be computed on
+     * different threads at the same time.
+     */
+    void computeFrameRootMotion();
+
     /**
      * @return True, if the main animation has the "Idle"-flag set.
      *
@@ -120,6 +168,15 @@ namespace REGoth
      */
     HZAnimationClip findAnimationClip(const bs::String& name) const;
 
+    /**
+     * Finds the state animation clip like findAnimationClip() would for the name created
+     * by AnimationState::constructStateAnimationName(), without creating that name.
+     *
+     * @return Animation clip for the given state. Invalid if not found.
+     */
+    HZAnimationClip findStateAnimationClip(AI::WeaponMode weaponMode, AI::WalkMode walkMode,
+                                           const bs::String& state) const;
+
     /**
      * Plays the given animation clip.
      */
@@ -149,15 +206,41 @@ namespace REGoth
      * right now to go to that state, e.g. because it's falling and needs to land first.
      *
      * Some animations do not need any transitions, or maybe no animation is currently
-     * being played, for which the target states animation name is returned.
+     * being played, for which the target states animation clip is returned.
      *
-     * @return Name of the animation to play to reach the given state. Empty string
-     *         if the transition is not possible.
+     * @return Clip of the animation to play to reach the given state. Invalid if the
+     *         transition is not possible.
      */
-    bs::String findAnimationToTransitionTo(const bs::String& stateAnim) const;
-    bs::String findAnimationToTransitionTo(const bs::String& fromAnim,
+    HZAnimationClip findClipToTransitionTo(const bs::String& stateAnim) const;
+    HZAnimationClip findClipToTransitionTo(const bs::String& fromAnim,
                                            const bs::String& toAnim) const;
 
+    /**
+     * Same as findClipToTransitionTo() with the state from the animation table, so no name
+     * has to be put together. See AnimationTable::locomotionState().
+     */
+    HZAnimationClip findClipToTransitionTo(AnimationStateIndex state) const;
+    HZAnimationClip findClipToTransitionTo(AnimationStateIndex from,
+                                           AnimationStateIndex to) const;
+
+    /**
+     * @return The animations of the model script. nullptr if none has been set.
+     */
+    const AnimationTable* animationTable() const
+    {
+      return mAnimationTable.get();
+    }
+
+    /**
+     * @return The clip which is playing right now. Invalid if none.
+     */
+    HZAnimationClip playingClip() const;
+
+    /**
+     * @return What the animation table knows about playingClip().
+     */
+    const AnimationClipRecord& playingClipRecord() const;
+
     /**
      * @return Whether the given animation is currently playing
      */
@@ -200,6 +283,15 @@ namespace REGoth
      */
     void setDebugAnimationSpeedFactor(float factor);
 
+    /** Seconds between two checks of how detailed the animation should be */
+    static constexpr float LOD_CHECK_INTERVAL = 0.5f;
+
+    /**
+     * Triggered once per frame. Picks up the visual set via setVisualAsync() and switches the
+     * level of detail of the animation.
+     */
+    void update() override;
+
   protected:
     void onInitialized() override;
 
@@ -210,9 +302,16 @@ namespace REGoth
     virtual bs::Vector<bs::String> listPossibleDefaultAnimations() const;
 
     /**
-     * Called when a animation event was triggered
+     * Called when a animation event was triggered. See AnimationTable::findEvent() for the
+     * events known.
      */
-    virtual void onAnimationEvent(const bs::HAnimationClip& clip, bs::String string);
+    virtual void onAnimationEvent(const bs::HAnimationClip& clip, const bs::String& string);
+
+    /**
+     * Called once the visual set via setVisualAsync() is shown, with the first mesh of its
+     * model script.
+     */
+    virtual void onVisualLoaded();
 
     /**
      * Access to the current model-script for sub-classes.
@@ -230,6 +329,12 @@ namespace REGoth
       return mMesh;
     }
 
+    /**
+     * @return The materials to draw the current mesh with. By default those of the mesh
+     *         itself.
+     */
+    virtual bs::Vector<bs::HMaterial> meshMaterials() const;
+
     /**
      * Access to attaching something to specific nodes for sub-classes.
      */
@@ -246,9 +351,19 @@ namespace REGoth
 
   private:
     /**
-     * Fills mAnimations.
+     * Assigns the AnimationTable shared by all visuals using mModelScript.
      */
-    void createAnimationMap();
+    void createAnimationTable();
+
+    /**
+     * Sets the given model script and its first mesh, see setVisual().
+     */
+    void showVisual(BsZenLib::Res::HModelScriptFile modelScript);
+
+    /**
+     * Shows the visual set via setVisualAsync(), which must have been loaded.
+     */
+    void showPendingVisual();
 
     /**
      * @return Whether the given mesh is registered inside the currently set model script
@@ -290,6 +405,12 @@ namespace REGoth
      */
     void addDefaultAttachments();
 
+    /**
+     * Enables or disables evaluating the small bones of the skeleton, see
+     * createReducedDetailMask().
+     */
+    void setDetailReduced(bool isReduced);
+
     /**
      * Whether the given clip should be played as looping. If not, it will likely
      * switch to a different animation when it's done.
@@ -306,6 +427,13 @@ namespace REGoth
     BsZenLib::Res::HModelScriptFile mModelScript; /**< Model-script of the displayed model */
     BsZenLib::Res::HMeshWithMaterials mMesh; /**< Currently displayed mesh, from the model script */
 
+    /**
+     * Visual being loaded for setVisualAsync(). Only the name is saved, the model script is
+     * requested again after loading.
+     */
+    PendingResource<BsZenLib::Res::HModelScriptFile> mPendingModelScript;
+    bs::String mPendingVisual;
+
     // Object Sub Tree --------------------------------------------------------
     bs::Vector<bs::HSceneObject> mSubObjects; /**< All created sub-objects by this component */
 
@@ -314,13 +442,33 @@ namespace REGoth
     HNodeVisuals mSubNodeVisuals;   /**< The NodeVisuals-Component created inside a sub object */
 
     // Animation --------------------------------------------------------------
-    bs::Map<bs::String, HZAnimationClip> mAnimationClips; /**< Animation names -> Clip */
+    bs::SPtr<const AnimationTable> mAnimationTable; /**< Animations of the model script */
     bs::HAnimationClip mRootMotionLastClip; /**< Last clip we got the root motion from */
     float mRootMotionLastTime = 0.0f; /**< Last time the animation was queried for root motion */
 
+    /** Root motion of mRootMotionLastClip, owned by mAnimationTable. Not saved. */
+    const AnimationState::RootMotionSamples* mRootMotionSamples = nullptr;
+
+    /** Time range computeFrameRootMotion() works on, set by prepareFrameRootMotion() */
+    struct PendingRootMotion
+    {
+      float then     = 0.0f;
+      float now      = 0.0f;
+      bool isPending = false;
+    };
+
+    PendingRootMotion mPendingRootMotion;
+
+    /** Root motion not yet returned by resolveFrameRootMotion(). Not saved. */
+    bs::Vector3 mResolvedRootMotion = bs::Vector3(bs::BsZero);
+
     HZAnimationClip mPlayingMainAnimation; /**< Handle of the currently playing main animation. May
                                               be invalid. */
 
+    // Level of detail --------------------------------------------------------
+    bool mIsDetailReduced    = false; /**< See setDetailReduced(). Not saved. */
+    float mTimeUntilLODCheck = 0.0f;
+
   public:
     REGOTH_DECLARE_RTTI(VisualSkeletalAnimation)
 
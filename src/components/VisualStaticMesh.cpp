@@ -1,13 +1,27 @@
 #include "VisualStaticMesh.hpp"
 #include <Components/BsCRenderable.h>
 #include <RTTI/RTTI_VisualStaticMesh.hpp>
+#include <Mesh/BsMesh.h>
+#include <Renderer/BsCamera.h>
+#include <Scene/BsSceneManager.h>
 #include <Scene/BsSceneObject.h>
+#include <Utility/BsTime.h>
 #include <log/logging.hpp>
 #include <original-content/OriginalGameResources.hpp>
+#include <original-content/SharedMaterials.hpp>
 #include <original-content/VirtualFileSystem.hpp>
 
 namespace REGoth
 {
+  constexpr float VisualStaticMesh::LOD_DISTANCE_PER_RADIUS;
+  constexpr float VisualStaticMesh::LOD_CHECK_INTERVAL;
+
+  /**
+   * How much closer than where it was switched to a less detailed version the camera has to
+   * get to switch back.
+   */
+  constexpr float LOD_HYSTERESIS = 0.9f;
+
   VisualStaticMesh::VisualStaticMesh(const bs::HSceneObject& parent)
       : bs::Component(parent)
   {
@@ -16,8 +30,20 @@ namespace REGoth
 
   void VisualStaticMesh::setMesh(const bs::String& originalMeshFileName)
   {
-    auto mesh = gOriginalGameResources().staticMesh(originalMeshFileName);
+    mPendingMesh = {};
+
+    showMesh(originalMeshFileName, gOriginalGameResources().staticMesh(originalMeshFileName));
+  }
+
+  void VisualStaticMesh::setMeshAsync(const bs::String& originalMeshFileName)
+  {
+    mPendingMesh         = gOriginalGameResources().staticMeshAsync(originalMeshFileName);
+    mPendingMeshFileName = originalMeshFileName;
+  }
 
+  void VisualStaticMesh::showMesh(const bs::String& originalMeshFileName,
+                                  BsZenLib::Res::HMeshWithMaterials mesh)
+  {
     if (!mesh)
     {
       REGOTH_LOG(Warning, Uncategorized, "[VisualStaticMesh] Failed to load mesh: {0}",
@@ -26,7 +52,91 @@ namespace REGoth
     }
 
     mRenderable->setMesh(mesh->getMesh());
-    mRenderable->setMaterials(mesh->getMaterials());
+    mRenderable->setMaterials(gSharedMaterials().find(mesh->getMaterials()));
+
+    mFullMesh      = mesh->getMesh();
+    mLODs          = gOriginalGameResources().staticMeshLODs(originalMeshFileName);
+    mMeshFileNames = {originalMeshFileName};
+    mCurrentLOD    = 0;
+    mIsMerged      = false;
+
+    // Spread out the checks of vobs created at the same time
+    mTimeUntilLODCheck = LOD_CHECK_INTERVAL * (float)(SO()->getInstanceId() % 16) / 16.0f;
+  }
+
+  void VisualStaticMesh::setBatchedMesh(bs::HMesh mesh, const bs::Vector<bs::HMaterial>& materials,
+                                        const bs::Vector<bs::String>& meshFileNames)
+  {
+    mPendingMesh = {};
+
+    mRenderable->setMesh(mesh);
+    mRenderable->setMaterials(materials);
+
+    mFullMesh      = mesh;
+    mMeshFileNames = meshFileNames;
+    mCurrentLOD    = 0;
+    mIsMerged      = true;
+    mLODs.clear();
+  }
+
+  bs::Vector<bs::HMaterial> VisualStaticMesh::materials() const
+  {
+    return mRenderable->getMaterials();
+  }
+
+  void VisualStaticMesh::update()
+  {
+    if (mPendingMesh.isRequested())
+    {
+      if (!mPendingMesh.isReady()) return;
+
+      BsZenLib::Res::HMeshWithMaterials mesh = mPendingMesh.get();
+
+      mPendingMesh = {};
+
+      showMesh(mPendingMeshFileName, mesh);
+    }
+
+    if (mLODs.empty() || !mFullMesh) return;
+
+    mTimeUntilLODCheck -= bs::gTime().getFrameDelta();
+
+    if (mTimeUntilLODCheck > 0.0f) return;
+
+    mTimeUntilLODCheck += LOD_CHECK_INTERVAL;
+
+    const auto& mainCamera = bs::gSceneManager().getMainCamera();
+
+    if (!mainCamera) return;
+
+    float distance = mainCamera->getTransform().pos().distance(SO()->getTransform().pos());
+
+    bs::UINT32 lod = lodForDistance(distance);
+
+    if (lod == mCurrentLOD) return;
+
+    mRenderable->setMesh(lod == 0 ? mFullMesh : mLODs[lod - 1]);
+    mCurrentLOD = lod;
+  }
+
+  bs::UINT32 VisualStaticMesh::lodForDistance(float distance) const
+  {
+    float radius = mFullMesh->getProperties().getBounds().getSphere().getRadius();
+    float step   = radius * LOD_DISTANCE_PER_RADIUS;
+
+    bs::UINT32 lod = 0;
+
+    for (bs::UINT32 i = 1; i <= (bs::UINT32)mLODs.size(); i++)
+    {
+      float threshold = step * i;
+
+      // Staying less detailed until the camera is a bit closer than where it switched
+      if (i <= mCurrentLOD) threshold *= LOD_HYSTERESIS;
+
+      if (distance > threshold) lod = i;
+    }
+
+    return lod;
   }
 
   bs::HRenderable VisualStaticMesh::createRenderable()
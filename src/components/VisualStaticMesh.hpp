@@ -7,6 +7,7 @@
 #include <BsZenLib/ZenResources.hpp>
 #include <RTTI/RTTIUtil.hpp>
 #include <Scene/BsComponent.h>
+#include <original-content/OriginalGameResources.hpp>
 
 namespace REGoth
 {
@@ -15,6 +16,10 @@ namespace REGoth
    *
    * After this component is intialized, there will be a renderable component
    * attached to the scene object.
+   *
+   * Larger meshes come with less detailed versions, see staticMeshLODs(). Depending
+   * on how far away the main camera is compared to the size of the mesh, the renderable
+   * is switched to one of those. The distance is only checked a few times per second.
    */
   class VisualStaticMesh : public bs::Component
   {
@@ -29,8 +34,118 @@ namespace REGoth
      */
     void setMesh(const bs::String& originalMeshFileName);
 
+    /**
+     * Like setMesh(), but loads the mesh in the background. Nothing is displayed until it has
+     * been loaded, which is checked once per frame. Meant for visuals created in the middle of
+     * the game, which would otherwise make it hitch.
+     *
+     * @param  originalMeshFile  The name of the mesh file the original game would
+     *                           have set (e.g. "STONE.3DS").
+     */
+    void setMeshAsync(const bs::String& originalMeshFileName);
+
+    /**
+     * @return Whether the mesh set via setMeshAsync() is still being loaded.
+     */
+    bool isLoadingMesh() const
+    {
+      return mPendingMesh.isRequested();
+    }
+
+    /**
+     * Displays a mesh merged from the meshes of several vobs, which all use the given
+     * materials. See Internals::batchStaticMeshInstances().
+     *
+     * @param  meshFileNames  Original mesh files the merged mesh was made from, see
+     *                        meshFileNames().
+     */
+    void setBatchedMesh(bs::HMesh mesh, const bs::Vector<bs::HMaterial>& materials,
+                        const bs::Vector<bs::String>& meshFileNames);
+
+    /**
+     * @return Whether the mesh has been merged from those of several vobs, see
+     *         setBatchedMesh().
+     */
+    bool isMerged() const
+    {
+      return mIsMerged;
+    }
+
+    /**
+     * @return The original mesh files displayed, like "STONE.3DS". Several for a merged mesh,
+     *         in no particular order.
+     */
+    const bs::Vector<bs::String>& meshFileNames() const
+    {
+      return mMeshFileNames;
+    }
+
+    /**
+     * @return The mesh displayed at full detail. Empty if none has been set.
+     */
+    bs::HMesh mesh() const
+    {
+      return mFullMesh;
+    }
+
+    /**
+     * @return Materials of the mesh, one per sub-mesh.
+     */
+    bs::Vector<bs::HMaterial> materials() const;
+
+    /**
+     * @return Whether there are less detailed versions of the mesh.
+     */
+    bool hasLODs() const
+    {
+      return !mLODs.empty();
+    }
+
+    /**
+     * Whether the mesh may be merged with those of other vobs into a single renderable,
+     * see Internals::batchStaticMeshInstances(). Turn this off for vobs which are going to
+     * be moved, hidden or otherwise handled on their own. On by default.
+     */
+    void setBatchable(bool isBatchable)
+    {
+      mIsBatchable = isBatchable;
+    }
+
+    bool isBatchable() const
+    {
+      return mIsBatchable;
+    }
+
+    /**
+     * Distance to the main camera at which the next less detailed version of the mesh is
+     * used, in multiples of the radius of the mesh's bounds. Switching back to the more
+     * detailed version happens a bit closer, so the mesh doesn't flicker between both.
+     */
+    static constexpr float LOD_DISTANCE_PER_RADIUS = 15.0f;
+
+    /** Seconds between two checks of which version of the mesh to use */
+    static constexpr float LOD_CHECK_INTERVAL = 0.5f;
+
+    /**
+     * Triggered once per frame. Picks up the mesh set via setMeshAsync() and switches between
+     * the versions of the mesh.
+     */
+    void update() override;
+
   private:
 
+    /**
+     * Displays the given mesh loaded from the given file.
+     */
+    void showMesh(const bs::String& originalMeshFileName,
+                  BsZenLib::Res::HMeshWithMaterials mesh);
+
+    /**
+     * @return Which version of the mesh to use when the main camera is the given distance
+     *         away. 0 is the full detail mesh.
+     */
+    bs::UINT32 lodForDistance(float distance) const;
+
     /**
      * Creates the renderable on the scene object
      */
@@ -49,6 +164,46 @@ namespace REGoth
      */
     bs::HRenderable mRenderable;
 
+    /**
+     * Full detail mesh set via setMesh().
+     */
+    bs::HMesh mFullMesh;
+
+    /**
+     * Less detailed versions of mFullMesh, each coarser than the one before.
+     */
+    bs::Vector<bs::HMesh> mLODs;
+
+    /**
+     * Version of the mesh displayed right now. Not saved, the first check after
+     * loading sets it.
+     */
+    bs::UINT32 mCurrentLOD = 0;
+
+    float mTimeUntilLODCheck = 0.0f;
+
+    /**
+     * Mesh being loaded for setMeshAsync(). Not saved, a mesh that was still loading is
+     * missing after loading.
+     */
+    PendingResource<BsZenLib::Res::HMeshWithMaterials> mPendingMesh;
+    bs::String mPendingMeshFileName;
+
+    /**
+     * See meshFileNames().
+     */
+    bs::Vector<bs::String> mMeshFileNames;
+
+    /**
+     * See setBatchable().
+     */
+    bool mIsBatchable = true;
+
+    /**
+     * See isMerged().
+     */
+    bool mIsMerged = false;
+
   public:
     REGOTH_DECLARE_RTTI(VisualStaticMesh)
 
@@ -1,10 +1,12 @@
 #include "Waynet.hpp"
-#include <Debug/BsDebugDraw.h>
 #include <RTTI/RTTI_Waynet.hpp>
 #include <Scene/BsSceneObject.h>
+#include <AI/WaynetHierarchy.hpp>
+#include <Threading/BsTaskScheduler.h>
 #include <components/AnchoredTextLabels.hpp>
 #include <components/Freepoint.hpp>
-#include <components/Waypoint.hpp>
+#include <core/DebugDrawBatches.hpp>
+#include <core/Profiling.hpp>
 
 namespace REGoth
 {
@@ -13,82 +15,196 @@ namespace REGoth
   {
   }
 
-  HWaypoint Waynet::findWaypoint(const bs::String& name)
+  WaypointIndex Waynet::findWaypoint(const bs::String& name)
   {
-    bs::HSceneObject waypointSO = SO()->findChild(name);
+    if (!mIsNameIndexBuilt) buildNameIndex();
 
-    if (!waypointSO) return {};
+    // Scripts pass upper case names almost always, only copy the name if it isn't
+    auto it = mWaypointsByName.find(name);
 
-    return waypointSO->getComponent<Waypoint>();
+    if (it == mWaypointsByName.end())
+    {
+      it = mWaypointsByName.find(nameKeyOf(name));
+    }
+
+    if (it == mWaypointsByName.end()) return NO_WAYPOINT;
+
+    return it->second;
+  }
+
+  HFreepoint Waynet::findFreepoint(const bs::String& name)
+  {
+    if (!mIsNameIndexBuilt) buildNameIndex();
+
+    auto it = mFreepointsByName.find(name);
+
+    if (it == mFreepointsByName.end())
+    {
+      it = mFreepointsByName.find(nameKeyOf(name));
+    }
+
+    if (it == mFreepointsByName.end()) return {};
+
+    return mFreepoints[it->second];
   }
 
-  void Waynet::addWaypoint(HWaypoint waypoint)
+  void Waynet::buildNameIndex()
   {
-    mWaypoints.push_back(waypoint);
-    mWaypoints.back()->mIndex = mWaypoints.size() - 1;
+    mWaypointsByName.clear();
+    mWaypointsByName.reserve(mWaypointNames.size());
+
+    // Only inserted if not there yet, so the first one with a name is found
+    for (WaypointIndex i = 0; i < numWaypoints(); i++)
+    {
+      mWaypointsByName.insert({nameKeyOf(mWaypointNames[i]), i});
+    }
+
+    mFreepointsByName.clear();
+    mFreepointsByName.reserve(mFreepoints.size());
+
+    for (bs::UINT32 i = 0; i < (bs::UINT32)mFreepoints.size(); i++)
+    {
+      mFreepointsByName.insert({nameKeyOf(mFreepoints[i]->SO()->getName()), i});
+    }
+
+    mIsNameIndexBuilt = true;
+  }
+
+  bs::String Waynet::nameKeyOf(const bs::String& name)
+  {
+    bs::String key = name;
+    bs::StringUtil::toUpperCase(key);
+
+    return key;
+  }
+
+  WaypointIndex Waynet::addWaypoint(const bs::String& name, const bs::Vector3& position,
+                                    const bs::Vector3& direction)
+  {
+    mWaypointNames.push_back(name);
+    mWaypointPositions.push_back(position);
+    mWaypointDirections.push_back(direction);
+    mPaths.emplace_back();
+
+    mIsGraphOutdated = true;
+
+    WaypointIndex waypoint = numWaypoints() - 1;
+
+    if (mIsNameIndexBuilt)
+    {
+      mWaypointsByName.insert({nameKeyOf(name), waypoint});
+    }
+
+    return waypoint;
+  }
+
+  void Waynet::addPath(WaypointIndex from, WaypointIndex to)
+  {
+    mPaths[from].push_back(to);
+
+    mIsGraphOutdated = true;
+  }
+
+  bs::Transform Waynet::waypointTransform(WaypointIndex waypoint) const
+  {
+    bs::Transform transform;
+    transform.setPosition(mWaypointPositions[waypoint]);
+
+    // Same as what setForward() does on a scene object
+    bs::Quaternion rotation;
+    rotation.lookRotation(mWaypointDirections[waypoint]);
+    transform.setRotation(rotation);
+
+    return transform;
   }
 
   void Waynet::addFreepoint(HFreepoint freepoint)
   {
     mFreepoints.push_back(freepoint);
+
+    mFreepointPositions.clear();
+    mFreepointGroups.clear();
+
+    if (mIsNameIndexBuilt)
+    {
+      mFreepointsByName.insert(
+          {nameKeyOf(freepoint->SO()->getName()), (bs::UINT32)mFreepoints.size() - 1});
+    }
   }
 
   void Waynet::debugDraw(const REGoth::HAnchoredTextLabels& textLabels)
   {
-    bs::DebugDraw::instance().setColor(bs::Color::Red);
+    bs::Vector<bs::Vector3> linePoints;
 
-    for (HWaypoint from : allWaypoints())
+    for (WaypointIndex from = 0; from < numWaypoints(); from++)
     {
-      const bs::Transform& fromTransform = from->SO()->getTransform();
+      const bs::Vector3& fromPosition = mWaypointPositions[from];
+
+      textLabels->addLabel(fromPosition + bs::Vector3::UNIT_Y * 0.5f,
+                           bs::HString(mWaypointNames[from]));
 
-      textLabels->addLabel(fromTransform.pos() + fromTransform.getUp() * 0.5f,
-                           bs::HString(from->SO()->getName()));
-      for (HWaypoint to : from->allPaths())
+      for (WaypointIndex to : mPaths[from])
       {
-        bs::DebugDraw::instance().drawLine(fromTransform.pos(), to->SO()->getTransform().pos());
+        // Paths go both ways, one line is enough
+        if (to < from) continue;
+
+        linePoints.push_back(fromPosition);
+        linePoints.push_back(mWaypointPositions[to]);
       }
     }
+
+    gDebugDrawBatches().setBatch(DebugDrawCategory::Waynet, (bs::UINT64)(uintptr_t)this,
+                                 std::move(linePoints), mWaypointPositions);
   }
 
   Waynet::ClosestWaypoints Waynet::findClosestWaypointTo(const bs::Vector3& position)
   {
-    if (!hasCachedWaypointPositions())
-    {
-      populateWaypointPositionCache();
-    }
+    graph();
 
-    // No waypoints at all?
-    if (mWaypointPositions.empty())
-    {
-      return {};
-    }
+    // Both are NO_WAYPOINT if there are no waypoints at all
+    ClosestWaypoints result;
+    mWaypointIndex.findClosestTwo(position, result.closest, result.secondClosest);
 
-    bs::UINT32 secondNearestIndex = 0;
-    float secondNearestDistance   = std::numeric_limits<float>().max();
+    return result;
+  }
 
-    bs::UINT32 nearestIndex = 0;
-    float nearestDistance   = std::numeric_limits<float>().max();
+  void Waynet::findClosestWaypointsTo(const bs::Vector<bs::Vector3>& positions,
+                                      bs::Vector<ClosestWaypoints>& result)
+  {
+    // Build the index here, the search itself only reads it and may run on any thread
+    graph();
 
-    for (bs::UINT32 i = 0; i < (bs::UINT32)mWaypointPositions.size(); i++)
-    {
-      float thisDistance = (position - mWaypointPositions[i]).squaredLength();
+    bs::Vector<WaypointIndex> closest;
+    bs::Vector<WaypointIndex> secondClosest;
+    mWaypointIndex.findClosestTwo(positions, closest, secondClosest);
 
-      if (thisDistance < nearestDistance)
-      {
-        nearestDistance = thisDistance;
-        nearestIndex    = i;
-      }
+    result.resize(positions.size());
 
-      if (thisDistance > nearestDistance && thisDistance < secondNearestDistance)
-      {
-        secondNearestDistance = thisDistance;
-        secondNearestIndex    = i;
-      }
+    for (size_t i = 0; i < positions.size(); i++)
+    {
+      result[i].closest       = closest[i];
+      result[i].secondClosest = secondClosest[i];
     }
+  }
 
-    ClosestWaypoints result;
-    result.closest       = mWaypoints[nearestIndex];
-    result.secondClosest = mWaypoints[secondNearestIndex];
+  bs::Vector<WaypointIndex> Waynet::findClosestWaypoints(const bs::Vector3& position,
+                                                         bs::UINT32 count)
+  {
+    graph();
+
+    bs::Vector<WaypointIndex> result;
+    mWaypointIndex.findClosest(position, count, result);
+
+    return result;
+  }
+
+  bs::Vector<WaypointIndex> Waynet::findWaypointsInRange(const bs::Vector3& position,
+                                                         float radius)
+  {
+    graph();
+
+    bs::Vector<WaypointIndex> result;
+    mWaypointIndex.findInRange(position, radius, result);
 
     return result;
   }
@@ -96,175 +212,313 @@ namespace REGoth
   Waynet::ClosestFreepoints Waynet::findClosestFreepointTo(const bs::String& name,
                                                            const bs::Vector3& position)
   {
-    if (!hasCachedFreepointPositions())
+    bs::Vector<HFreepoint> closest = findClosestFreepoints(name, position, 2);
+
+    // No matching freepoints at all?
+    if (closest.empty())
     {
-      populateFreepointPositionCache();
+      return {};
     }
 
-    // No freepoints at all?
-    if (mFreepointPositions.empty())
+    ClosestFreepoints result;
+    result.closest       = closest.front();
+    result.secondClosest = closest.back();
+
+    return result;
+  }
+
+  bs::Vector<HFreepoint> Waynet::findClosestFreepoints(const bs::String& name,
+                                                       const bs::Vector3& position,
+                                                       bs::UINT32 count)
+  {
+    const FreepointGroup& group = freepointGroup(name);
+
+    bs::Vector<bs::UINT32> points;
+    group.index.findClosest(position, count, points);
+
+    return freepointsOf(group, points);
+  }
+
+  bs::Vector<HFreepoint> Waynet::findFreepointsInRange(const bs::String& name,
+                                                       const bs::Vector3& position, float radius)
+  {
+    const FreepointGroup& group = freepointGroup(name);
+
+    bs::Vector<bs::UINT32> points;
+    group.index.findInRange(position, radius, points);
+
+    return freepointsOf(group, points);
+  }
+
+  bs::Vector<HFreepoint> Waynet::findClosestAvailableFreepoints(const bs::String& name,
+                                                                const bs::Vector3& position,
+                                                                bs::UINT32 count,
+                                                                const bs::HSceneObject& occupant)
+  {
+    const FreepointGroup& group = freepointGroup(name);
+
+    auto isAvailable = [&](bs::UINT32 point) {
+      return mFreepoints[group.freepoints[point]]->isAvailableFor(occupant);
+    };
+
+    bs::Vector<bs::UINT32> points;
+    group.index.findClosest(position, count, isAvailable, points);
+
+    return freepointsOf(group, points);
+  }
+
+  bool Waynet::reserveFreepoint(HFreepoint freepoint, const bs::HSceneObject& occupant)
+  {
+    if (!freepoint->isAvailableFor(occupant)) return false;
+
+    releaseFreepointOf(occupant);
+
+    freepoint->mOccupant = occupant;
+    mReservedFreepoints[occupant->getInstanceId()] = freepoint;
+
+    return true;
+  }
+
+  void Waynet::releaseFreepointOf(const bs::HSceneObject& occupant)
+  {
+    auto it = mReservedFreepoints.find(occupant->getInstanceId());
+
+    if (it == mReservedFreepoints.end()) return;
+
+    HFreepoint freepoint = it->second;
+    mReservedFreepoints.erase(it);
+
+    if (freepoint.isDestroyed()) return;
+
+    // Might have been taken over by somebody else after the occupant was gone
+    if (freepoint->mOccupant == occupant)
     {
-      return {};
+      freepoint->mOccupant = {};
     }
+  }
 
-    bs::UINT32 secondNearestIndex = 0;
-    float secondNearestDistance   = std::numeric_limits<float>().max();
+  HFreepoint Waynet::reservedFreepointOf(const bs::HSceneObject& occupant) const
+  {
+    auto it = mReservedFreepoints.find(occupant->getInstanceId());
+
+    if (it == mReservedFreepoints.end()) return {};
 
-    bs::UINT32 nearestIndex = 0;
-    float nearestDistance   = std::numeric_limits<float>().max();
+    return it->second;
+  }
 
-    for (bs::UINT32 i = 0; i < (bs::UINT32)mFreepointPositions.size(); i++)
+  const Waynet::FreepointGroup& Waynet::freepointGroup(const bs::String& name)
+  {
+    auto it = mFreepointGroups.find(name);
+
+    if (it != mFreepointGroups.end()) return it->second;
+
+    if (!hasCachedFreepointPositions())
     {
-      float thisDistance = (position - mFreepointPositions[i]).squaredLength();
+      populateFreepointPositionCache();
+    }
 
-      if (thisDistance < nearestDistance)
-      {
-        nearestDistance = thisDistance;
-        nearestIndex    = i;
-      }
+    FreepointGroup group;
+    bs::Vector<bs::Vector3> positions;
 
-      if (thisDistance > nearestDistance && thisDistance < secondNearestDistance)
-      {
-        secondNearestDistance = thisDistance;
-        secondNearestIndex    = i;
-      }
+    for (bs::UINT32 i = 0; i < (bs::UINT32)mFreepoints.size(); i++)
+    {
+      bs::String freepointName = mFreepoints[i]->SO()->getName();
+      bs::StringUtil::toUpperCase(freepointName);
+
+      if (freepointName.find(name) == bs::String::npos) continue;
+
+      group.freepoints.push_back(i);
+      positions.push_back(mFreepointPositions[i]);
     }
 
-    ClosestFreepoints result;
-    result.closest       = mFreepoints[nearestIndex];
-    result.secondClosest = mFreepoints[secondNearestIndex];
+    group.index = AI::PointIndex(positions);
 
-    return result;
+    return mFreepointGroups[name] = std::move(group);
   }
 
-  bs::Vector<HWaypoint> Waynet::findWay(HWaypoint from, HWaypoint to)
+  bs::Vector<HFreepoint> Waynet::freepointsOf(const FreepointGroup& group,
+                                              const bs::Vector<bs::UINT32>& points) const
   {
-    if (!hasCachedWaypointPositions())
+    bs::Vector<HFreepoint> result;
+    result.reserve(points.size());
+
+    for (bs::UINT32 point : points)
     {
-      populateWaypointPositionCache();
+      result.push_back(mFreepoints[group.freepoints[point]]);
     }
 
-    if (!from || !to)
-      return {};
+    return result;
+  }
 
-    // FIXME: This is not a very fast implementation. Improve!
-    // FIXME: The FIXME above is as old as old REGoth. And now part of REGoth-bs! Wohoo!
-    //        Please please, somebody, improve this. This code is absolutely bat-shit ugly.
-    //        Not even I understand it anymore. When I wrote this, only God and I were knew
-    //        how it worked. Now only God knows.
-    //
-    //        Commets tagged with PM are from Present Me. Have fun!
+  bs::Vector<WaypointIndex> Waynet::findWay(WaypointIndex from, WaypointIndex to)
+  {
+    if (from == NO_WAYPOINT || to == NO_WAYPOINT)
+      return {};
 
-    // Simple Dijkstra-Implementation. Totally non-optimized.
+    const AI::WaynetGraph& waynetGraph = graph();
 
-    constexpr size_t NO_NODE = SIZE_MAX;
+    bs::Vector<bs::UINT32> indices;
 
-    // Give all other nodes a distance of infinity // PM: What other nodes?!
-    std::vector<float> distances(mWaypoints.size(), FLT_MAX);
-    std::vector<size_t> prev(mWaypoints.size(), NO_NODE);
+    // Looking up the table is as fast as the route cache, don't push other ways out of it
+    if (mNextHopTable)
+    {
+      mSearchStats.numSearches += 1;
 
-    std::set<size_t> unvisitedSet;
+      if (!mNextHopTable->findWay(from, to, indices)) return {};
 
-    // PM: Remember a complete set of all waypoints for speed. Waypoints are not
-    //     supposed to be created during gamplay.
-    static std::set<size_t> unvisitedSetCached;
+      return indices;
+    }
 
-    if (unvisitedSetCached.empty())
+    if (!mRouteCache.find(from, to, indices))
     {
-      // Fill a set with 0..n, all nodes are unvisited right now
-      for (size_t i = 0; i < mWaypoints.size(); i++)
+      bool isFound = mIsHierarchicalSearchEnabled
+                         ? mHierarchy->findWay(from, to, indices, &mSearchStats)
+                         : waynetGraph.findWay(from, to, indices, &mSearchStats);
+
+      if (!isFound)
       {
-        unvisitedSetCached.insert(i);
+        indices.clear();
       }
+
+      mRouteCache.insert(from, to, indices);
     }
 
-    unvisitedSet = unvisitedSetCached;
+    return indices;
+  }
+
+  bs::SPtr<AI::WayRequest> Waynet::requestWay(WaypointIndex from, WaypointIndex to)
+  {
+    if (from == NO_WAYPOINT || to == NO_WAYPOINT)
+      return {};
 
-    // Init startnode with a distance of 0
-    distances[from->mIndex] = 0.0f;
+    // Make sure the graph is up to date and anything cached has been found on it
+    graph();
 
-    // PM: Awesome coding style #1: Use names as short as possible! This might have made
-    // sense as some article on the algorithm used the same name, but who knows
-    // where that may be? Anyways, could mean "current node", could mean something else.
-    size_t cn = from->mIndex;
+    auto request   = bs::bs_shared_ptr_new<AI::WayRequest>();
+    request->mFrom = from;
+    request->mTo   = to;
 
-    do
+    // Not worth a task, looking up the table is quicker than starting one
+    if (mNextHopTable)
     {
-      // PM: I don't even know, too many loops, too deeply nested.
-      // Whatever, let's hope it doesn't break..
-      for (auto e : mWaypoints[cn]->allPaths())
+      if (!mNextHopTable->findWay(request->mFrom, request->mTo, request->mPath))
       {
-        bs::UINT32 index = e->mIndex;
-        if (unvisitedSet.find(index) != unvisitedSet.end())
-        {
-          // Check if this actually was a shorter path
-          float tentativeDist =
-              distances[cn] + (mWaypointPositions[cn] - mWaypointPositions[index]).squaredLength();
-          if (distances[index] > tentativeDist)
-          {
-            distances[index] = tentativeDist;
-            prev[index]      = cn;
-          }
-        }
+        request->mPath.clear();
       }
 
-      unvisitedSet.erase(cn);
+      request->mIsFromCache = true;
+      request->mIsDone.store(true, std::memory_order_release);
+
+      return request;
+    }
+
+    if (mRouteCache.find(request->mFrom, request->mTo, request->mPath))
+    {
+      request->mIsFromCache = true;
+      request->mIsDone.store(true, std::memory_order_release);
+
+      return request;
+    }
+
+    request->mGraph = mGraph;
+
+    if (mIsHierarchicalSearchEnabled)
+    {
+      request->mHierarchy = mHierarchy;
+    }
+
+    auto task = bs::Task::create("WaynetSearch", [request]() {
+      REGOTH_PROFILE_SCOPE("WaynetSearch");
+
+      AI::WayRequest& r = *request;
 
-      if (!unvisitedSet.empty())
+      bool isFound = r.mHierarchy ? r.mHierarchy->findWay(r.mFrom, r.mTo, r.mPath)
+                                  : r.mGraph->findWay(r.mFrom, r.mTo, r.mPath);
+
+      if (!isFound)
       {
-        size_t smallest = *unvisitedSet.begin();
-        for (size_t n : unvisitedSet)
-        {
-          if (distances[smallest] > distances[n])
-          {
-            smallest = n;
-          }
-        }
-
-        cn = smallest;
+        r.mPath.clear();
       }
 
-      // PM: Now that's a condition. Good look figuring that out, ouch. Look, we even have a
-      // unsigned -1 in there! I love unsigned negative numbers!
-    } while (unvisitedSet.find(to->mIndex) != unvisitedSet.end() && cn != NO_NODE &&
-             cn != to->mIndex);
+      r.mIsDone.store(true, std::memory_order_release);
+    });
+
+    bs::TaskScheduler::instance().addTask(task);
 
-    // No path found
-    if (cn == NO_NODE) return {};
+    return request;
+  }
 
-    // Put path together
-    bs::Vector<HWaypoint> path;
-    cn = to->mIndex;
+  bool Waynet::collectWay(AI::WayRequest& request, bs::Vector<WaypointIndex>& path)
+  {
+    if (!request.isDone()) return false;
 
-    while (prev[cn] != NO_NODE)
+    // Found on an outdated graph? Still a valid way, since waypoints are only ever added,
+    // but it shouldn't be remembered.
+    if (!request.mIsFromCache && request.mGraph == mGraph && !mIsGraphOutdated)
     {
-      path.push_back(mWaypoints[cn]);
-      cn = prev[cn];
+      mRouteCache.insert(request.mFrom, request.mTo, request.mPath);
     }
 
-    // Happens on short paths // PM: What are you talking about? Back of the path not being the same
-    //                        // as the starting pos? How does that happen??
-    if (!path.empty() && path.back() != from)
+    // Only the main thread touches the request from here on, don't keep the graph alive
+    request.mGraph     = nullptr;
+    request.mHierarchy = nullptr;
+
+    path = request.mPath;
+
+    return true;
+  }
+
+  const AI::WaynetGraph& Waynet::graph()
+  {
+    if (mIsGraphOutdated)
     {
-      path.push_back(from);
-    };
+      rebuildGraph();
+    }
+
+    return *mGraph;
+  }
+
+  void Waynet::rebuildGraph()
+  {
+    mGraph           = bs::bs_shared_ptr_new<AI::WaynetGraph>(mWaypointPositions, mPaths);
+    mWaypointIndex   = AI::PointIndex(mWaypointPositions);
+    mIsGraphOutdated = false;
 
-    // PM: Seems like I fucked up the order at some point and just rolled with reversing afterwards.
-    //     Nice! Efficient!
-    std::reverse(path.begin(), path.end());
+    mHierarchy    = nullptr;
+    mNextHopTable = nullptr;
 
-    return path;
+    if (AI::WaynetNextHopTable::isSuitableFor(mGraph->numNodes(), mNextHopTableBudget))
+    {
+      loadOrBuildNextHopTable();
+    }
+    else
+    {
+      mHierarchy = bs::bs_shared_ptr_new<AI::WaynetHierarchy>(mGraph);
+    }
+
+    // Ways found on the old graph might not be the shortest anymore
+    mRouteCache.clear();
   }
 
-  void Waynet::populateWaypointPositionCache()
+  void Waynet::loadOrBuildNextHopTable()
   {
-    mWaypointPositions.clear();
-    mWaypointPositions.reserve(mWaypoints.size());
+    bs::UINT64 graphHash = mGraph->hash();
 
-    for (HWaypoint wp : allWaypoints())
+    if (!mNextHopTablePath.isEmpty())
     {
-      mWaypointPositions.push_back(wp->SO()->getTransform().pos());
+      mNextHopTable = AI::WaynetNextHopTable::load(mNextHopTablePath, graphHash);
+
+      if (mNextHopTable) return;
     }
+
+    auto table = bs::bs_shared_ptr_new<AI::WaynetNextHopTable>(*mGraph);
+
+    if (!mNextHopTablePath.isEmpty())
+    {
+      table->save(mNextHopTablePath);
+    }
+
+    mNextHopTable = table;
   }
 
   void Waynet::populateFreepointPositionCache()
@@ -278,11 +532,6 @@ namespace REGoth
     }
   }
 
-  bool Waynet::hasCachedWaypointPositions() const
-  {
-    return !mWaypointPositions.empty();
-  }
-
   bool Waynet::hasCachedFreepointPositions() const
   {
     return !mFreepointPositions.empty();
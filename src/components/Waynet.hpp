@@ -1,6 +1,14 @@
 #pragma once
 #include <BsPrerequisites.h>
 #include <Scene/BsComponent.h>
+#include <Scene/BsTransform.h>
+#include <AI/PointIndex.hpp>
+#include <AI/RouteCache.hpp>
+#include <AI/WayRequest.hpp>
+#include <AI/WaynetSearch.hpp>
+#include <AI/WaynetGraph.hpp>
+#include <AI/WaynetNextHopTable.hpp>
+#include <AI/WaypointIndex.hpp>
 #include <RTTI/RTTIUtil.hpp>
 
 namespace REGoth
@@ -8,12 +16,14 @@ namespace REGoth
   class Waynet;
   using HWaynet = bs::GameObjectHandle<Waynet>;
 
-  class Waypoint;
-  using HWaypoint = bs::GameObjectHandle<Waypoint>;
-
   class Freepoint;
   using HFreepoint = bs::GameObjectHandle<Freepoint>;
 
+  namespace AI
+  {
+    class WaynetHierarchy;
+  }
+
   class AnchoredTextLabels;
   using HAnchoredTextLabels = bs::GameObjectHandle<AnchoredTextLabels>;
 
@@ -62,13 +72,17 @@ namespace REGoth
    * random order every so often.
    *
    *
-   * Scene Object structure
-   * ======================
+   * Waypoints as plain data
+   * =======================
    *
-   * The object this component is attached to will be the parent of all
-   * Waypoints this waynet has. So to search for a waypoint, you could simply
-   * search the children of the Waynet-SO. Since this is a rather slow
-   * operation, see findWaypoint() for alternatives.
+   * Waypoints are not scene objects. Their names, positions, directions and paths are
+   * kept by the Waynet in plain arrays and saved along with it, and a waypoint is
+   * referred to by its index into those, see WaypointIndex. Worlds have thousands of
+   * waypoints, which would otherwise all be scene objects of their own, only to have their
+   * position read by the searches.
+   *
+   * Freepoints on the other hand are vobs with a Freepoint-component, since characters
+   * reserve them, see reserveFreepoint().
    *
    */
   class Waynet : public bs::Component
@@ -82,18 +96,29 @@ namespace REGoth
      * Note that this will *only* look for actual waypoints. In Gothic, while the name
      * Waypoint means exactly what one expects, when a script-function asks for a waypoint
      * it could also mean a freepoint. So if you want to be on the safe-side, then use
-     * GameWorld::findObjectByName(), which is also faster.
+     * GameWorld::findSpawnPoint(), which looks for both.
+     *
+     * Names are matched regardless of case and looked up in a hash map, see
+     * buildNameIndex(). If multiple waypoints have the same name, the first one is found.
      *
      * @param  name  Name of the Waypoint to look for.
      *
-     * @return Handle to the waypoint. Invalid if not found.
+     * @return Index of the waypoint. NO_WAYPOINT if not found.
      */
-    HWaypoint findWaypoint(const bs::String& name);
+    WaypointIndex findWaypoint(const bs::String& name);
+
+    /**
+     * Finds a freepoint by its exact name, regardless of case. Unlike findClosestFreepointTo(),
+     * this doesn't match parts of names.
+     *
+     * @return The freepoint. Empty, if there is none with that name.
+     */
+    HFreepoint findFreepoint(const bs::String& name);
 
     struct ClosestWaypoints
     {
-      HWaypoint closest;
-      HWaypoint secondClosest;
+      WaypointIndex closest       = NO_WAYPOINT;
+      WaypointIndex secondClosest = NO_WAYPOINT;
     };
 
     /**
@@ -109,6 +134,32 @@ namespace REGoth
      */
     ClosestWaypoints findClosestWaypointTo(const bs::Vector3& position);
 
+    /**
+     * findClosestWaypointTo() for many positions at once. Prefer this over calling
+     * findClosestWaypointTo() for each of them when there are many, since large batches are
+     * searched on all worker threads.
+     *
+     * @param  positions  Positions to search around.
+     * @param  result     Filled with the closest waypoints to each position, same order.
+     */
+    void findClosestWaypointsTo(const bs::Vector<bs::Vector3>& positions,
+                                bs::Vector<ClosestWaypoints>& result);
+
+    /**
+     * Searches the given number of waypoints closest to the given position.
+     *
+     * Like findClosestWaypointTo(), this ignores obstructions and connections.
+     *
+     * @return Found waypoints, closest first. Less than `count`, if there aren't enough.
+     */
+    bs::Vector<WaypointIndex> findClosestWaypoints(const bs::Vector3& position,
+                                                   bs::UINT32 count);
+
+    /**
+     * @return All waypoints within `radius` meters of the given position, in no particular order.
+     */
+    bs::Vector<WaypointIndex> findWaypointsInRange(const bs::Vector3& position, float radius);
+
     struct ClosestFreepoints
     {
       HFreepoint closest;
@@ -121,19 +172,161 @@ namespace REGoth
      * Does not check whether the Freepoint is obstructed by anything and
      * ignores all waypoint connections.
      *
+     * Like in the original, only Freepoints whose name contains `name` are
+     * considered, so `ROAM` will find `FP_ROAM_OW_SNAPPER_01`. An empty name
+     * matches all Freepoints.
+     *
+     * @param  name      Part of the name of the Freepoints to look for, upper case.
      * @param  position  Position to search around.
      *
      * @return Closest Freepoint to the given position. Should only be empty
-     *         if no Freepoint exists at all.
+     *         if no matching Freepoint exists at all.
      */
     ClosestFreepoints findClosestFreepointTo(const bs::String& name, const bs::Vector3& position);
 
     /**
-     * Finds a way between two waypoints in the given waypoint instance
+     * Searches the given number of matching Freepoints closest to the given position.
+     * See findClosestFreepointTo() on how `name` is matched.
+     *
+     * @return Found Freepoints, closest first. Less than `count`, if there aren't enough.
+     */
+    bs::Vector<HFreepoint> findClosestFreepoints(const bs::String& name,
+                                                 const bs::Vector3& position, bs::UINT32 count);
+
+    /**
+     * @return All matching Freepoints within `radius` meters of the given position, in no
+     *         particular order. See findClosestFreepointTo() on how `name` is matched.
+     */
+    bs::Vector<HFreepoint> findFreepointsInRange(const bs::String& name,
+                                                 const bs::Vector3& position, float radius);
+
+    /**
+     * Like findClosestFreepoints(), but skips Freepoints reserved by anybody other than
+     * `occupant`, see reserveFreepoint(). Reserved points are skipped while searching, so
+     * this is as fast as findClosestFreepoints() even when most of them are taken.
+     *
+     * @param  occupant  Scene object of the character looking for a free spot.
+     */
+    bs::Vector<HFreepoint> findClosestAvailableFreepoints(const bs::String& name,
+                                                          const bs::Vector3& position,
+                                                          bs::UINT32 count,
+                                                          const bs::HSceneObject& occupant);
+
+    /**
+     * Reserves the given Freepoint for the given character, so others looking for a free
+     * spot via findClosestAvailableFreepoints() skip it. A character only holds a single
+     * Freepoint, so the one reserved before by the same character is released.
+     *
+     * @param  freepoint  Freepoint to reserve.
+     * @param  occupant   Scene object of the character reserving it.
+     *
+     * @return False, if the Freepoint is already reserved by somebody else.
+     */
+    bool reserveFreepoint(HFreepoint freepoint, const bs::HSceneObject& occupant);
+
+    /**
+     * Releases the Freepoint reserved by the given character, if there is one.
+     */
+    void releaseFreepointOf(const bs::HSceneObject& occupant);
+
+    /**
+     * @return The Freepoint reserved by the given character. Empty, if there is none.
+     */
+    HFreepoint reservedFreepointOf(const bs::HSceneObject& occupant) const;
+
+    /**
+     * Finds the shortest way between two waypoints of this waynet.
+     *
+     * Ways found before are remembered, see routeCache(). On small waynets, all ways are
+     * looked up in a table instead, see setNextHopTableBudget().
+     *
+     * @return List of all waypoints that need to be visited, including `from` and `to`.
+     *         Will be empty if no path was found.
+     */
+    bs::Vector<WaypointIndex> findWay(WaypointIndex from, WaypointIndex to);
+
+    /**
+     * Starts searching the shortest way between two waypoints of this waynet in the
+     * background, so a lot of searches at once don't stall the frame.
      *
-     * @return List of all waypoints that need to be visited. Will be empty if no path was found.
+     * If the way is in the route cache, the request is done right away. Otherwise the search
+     * runs as a task on the bs::TaskScheduler. Use collectWay() to get the result.
+     *
+     * @return Request to pass to collectWay(). Empty, if `from` or `to` is NO_WAYPOINT.
+     */
+    bs::SPtr<AI::WayRequest> requestWay(WaypointIndex from, WaypointIndex to);
+
+    /**
+     * Picks up the result of a request made by requestWay(). To be called on the main thread.
+     *
+     * @param  path  Set to what findWay() would have returned, if the request is done.
+     *
+     * @return Whether the request is done. If not, try again later.
      */
-    bs::Vector<HWaypoint> findWay(HWaypoint from, HWaypoint to);
+    bool collectWay(AI::WayRequest& request, bs::Vector<WaypointIndex>& path);
+
+    /**
+     * Whether long ways are searched on the clusters of the waynet first, see
+     * AI::WaynetHierarchy. Enabled by default. Both find equally long ways, this only changes
+     * how much work the search is.
+     */
+    void setHierarchicalSearchEnabled(bool enabled)
+    {
+      mIsHierarchicalSearchEnabled = enabled;
+    }
+
+    /**
+     * Where to save the table of all shortest ways, see setNextHopTableBudget(). Without one,
+     * the table is built again every time the graph is. Usually set by the GameWorld to a file
+     * next to the cached world.
+     */
+    void setNextHopTableCache(const bs::Path& path)
+    {
+      mNextHopTablePath = path;
+      mIsGraphOutdated  = true;
+    }
+
+    /**
+     * How much memory the table of all shortest ways may take, in bytes. If the waynet is small
+     * enough for the table to fit, it is used instead of any search, see
+     * AI::WaynetNextHopTable. Otherwise ways are searched, see
+     * setHierarchicalSearchEnabled(). Set to 0 to never use the table.
+     */
+    void setNextHopTableBudget(bs::UINT64 bytes)
+    {
+      mNextHopTableBudget = bytes;
+      mIsGraphOutdated    = true;
+    }
+
+    /**
+     * @return Whether ways are looked up in the table of all shortest ways instead of
+     *         being searched.
+     */
+    bool hasNextHopTable()
+    {
+      graph();
+
+      return mNextHopTable != nullptr;
+    }
+
+    /**
+     * @return How much work the searches done by findWay() were, ways found in the route cache
+     *         don't count. Searches started by requestWay() aren't counted either, since they
+     *         run on other threads.
+     */
+    const AI::WaynetSearchStats& searchStats() const
+    {
+      return mSearchStats;
+    }
+
+    /**
+     * @return Cache of the ways found by findWay(). Cleared whenever waypoints or paths
+     *         are added. Use this to look at its statistics or change its capacity.
+     */
+    AI::RouteCache& routeCache()
+    {
+      return mRouteCache;
+    }
 
     /**
      * Registers the given freepoint in the waynet.
@@ -141,16 +334,55 @@ namespace REGoth
     void addFreepoint(HFreepoint freepoint);
 
     /**
-     * Registers the given waypoint in the waynet.
+     * Adds a waypoint to the waynet.
+     *
+     * @param  name       Name to find the waypoint by, see findWaypoint().
+     * @param  position   Where the waypoint is, in world space.
+     * @param  direction  Which way characters put at the waypoint face.
+     *
+     * @return Index of the new waypoint.
      */
-    void addWaypoint(HWaypoint waypoint);
+    WaypointIndex addWaypoint(const bs::String& name, const bs::Vector3& position,
+                              const bs::Vector3& direction);
 
     /**
-     * @return List of all waypoints.
+     * Adds a one-way path between two waypoints of this waynet. For a path usable in both
+     * directions, call this a second time with `from` and `to` swapped.
      */
-    const bs::Vector<HWaypoint>& allWaypoints()
+    void addPath(WaypointIndex from, WaypointIndex to);
+
+    bs::UINT32 numWaypoints() const
+    {
+      return (bs::UINT32)mWaypointNames.size();
+    }
+
+    const bs::String& waypointName(WaypointIndex waypoint) const
+    {
+      return mWaypointNames[waypoint];
+    }
+
+    const bs::Vector3& waypointPosition(WaypointIndex waypoint) const
+    {
+      return mWaypointPositions[waypoint];
+    }
+
+    const bs::Vector3& waypointDirection(WaypointIndex waypoint) const
     {
-      return mWaypoints;
+      return mWaypointDirections[waypoint];
+    }
+
+    /**
+     * @return Transform of a character or item put at the given waypoint, facing its
+     *         direction.
+     */
+    bs::Transform waypointTransform(WaypointIndex waypoint) const;
+
+    /**
+     * @return All waypoints the given one has a path to.
+     */
+    const bs::Vector<WaypointIndex>& pathsOf(WaypointIndex waypoint) const
+    {
+      return mPaths[waypoint];
     }
 
     /**
@@ -162,38 +394,140 @@ namespace REGoth
     }
 
     /**
-     * Draws the waynet as lines.
+     * Draws the waynet as lines and the waypoints as crosses with their names. Only needs
+     * to be called once, see DebugDrawBatches.
      */
     void debugDraw(const REGoth::HAnchoredTextLabels& textLabels);
 
   private:
+    /**
+     * @return Flat copy of the waypoints and their paths, which is what the searches run on.
+     *         Rebuilt if waypoints or paths have been added since it was last built.
+     */
+    const AI::WaynetGraph& graph();
+
+    /**
+     * Builds mGraph from the registered waypoints and their paths.
+     */
+    void rebuildGraph();
+
+    /**
+     * Loads the table of all shortest ways for mGraph from mNextHopTablePath, or builds and
+     * saves it if it's not there or outdated.
+     */
+    void loadOrBuildNextHopTable();
+
+    /**
+     * Fills mWaypointsByName and mFreepointsByName. Not saved, so done the first time a name
+     * is looked up after importing or loading.
+     */
+    void buildNameIndex();
 
     /**
-     * Fills mWaypointPositions with the positions from all registered waypoints.
+     * @return Key of the given name in mWaypointsByName and mFreepointsByName.
+     */
+    static bs::String nameKeyOf(const bs::String& name);
+
+    /**
+     * Freepoints matching a name, see findClosestFreepointTo().
+     */
+    struct FreepointGroup
+    {
+      /** Indices into mFreepoints */
+      bs::Vector<bs::UINT32> freepoints;
+
+      /** Over the positions of the freepoints above, in the same order */
+      AI::PointIndex index;
+    };
+
+    /**
+     * @return Group of the freepoints matching the given name. Created the first time
+     *         a name is asked for.
+     */
+    const FreepointGroup& freepointGroup(const bs::String& name);
+
+    /**
+     * Fills mFreepointPositions with the positions from all registered freepoints.
      *
      * Will drop anything already in the vector and thus can be called multiple times.
      */
-    void populateWaypointPositionCache();
     void populateFreepointPositionCache();
 
     /**
-     * @return Whether mWaypointPositions has been filled with data.
+     * @return Whether mFreepointPositions has been filled with data.
      *
-     * @note To fill it, use populateWaypointPositionCache().
+     * @note To fill it, use populateFreepointPositionCache().
      */
-    bool hasCachedWaypointPositions() const;
     bool hasCachedFreepointPositions() const;
 
-    bs::Vector<HWaypoint> mWaypoints;
+    /**
+     * Converts the given points of a freepoint group to handles.
+     */
+    bs::Vector<HFreepoint> freepointsOf(const FreepointGroup& group,
+                                        const bs::Vector<bs::UINT32>& points) const;
+
+    /**
+     * The waypoints, all with the same order. Paths hold the waypoints each one has a path
+     * to.
+     */
+    bs::Vector<bs::String> mWaypointNames;
+    bs::Vector<bs::Vector3> mWaypointPositions;
+    bs::Vector<bs::Vector3> mWaypointDirections;
+    bs::Vector<bs::Vector<WaypointIndex>> mPaths;
+
     bs::Vector<HFreepoint> mFreepoints;
 
     /**
      * Cached positions for faster access during searches.
-     * Waypoints are supposed to be static, so it's okay to cache these.
+     * Freepoints are supposed to be static, so it's okay to cache these.
      */
-    bs::Vector<bs::Vector3> mWaypointPositions;
     bs::Vector<bs::Vector3> mFreepointPositions;
 
+    /**
+     * Freepoints by the names they were searched for. Most searches only use a handful of
+     * names like `STAND` or `ROAM`, so this stays small.
+     */
+    bs::UnorderedMap<bs::String, FreepointGroup> mFreepointGroups;
+
+    /**
+     * Waypoints and freepoints by their upper case name, see findWaypoint() and
+     * findFreepoint(). Built along with each other by buildNameIndex().
+     */
+    bs::UnorderedMap<bs::String, WaypointIndex> mWaypointsByName;
+    bs::UnorderedMap<bs::String, bs::UINT32> mFreepointsByName;
+    bool mIsNameIndexBuilt = false;
+
+    /**
+     * Freepoints by the instance ID of the scene object which reserved them, see
+     * reserveFreepoint(). The other way around is stored inside the Freepoint itself.
+     */
+    bs::UnorderedMap<bs::UINT64, HFreepoint> mReservedFreepoints;
+
+    /**
+     * What all waypoint searches run on, all built at the same time. Not saved, since they
+     * can be built from the waypoints, which is done the first time they are needed after
+     * loading. The graph is shared with the searches started by requestWay().
+     *
+     * Only one of the hierarchy and the next hop table is built, depending on whether the
+     * table fits into mNextHopTableBudget.
+     */
+    bs::SPtr<const AI::WaynetGraph> mGraph;
+    bs::SPtr<const AI::WaynetHierarchy> mHierarchy;
+    bs::SPtr<const AI::WaynetNextHopTable> mNextHopTable;
+    AI::PointIndex mWaypointIndex;
+    bool mIsGraphOutdated = true;
+
+    /**
+     * Ways found on mGraph, see routeCache().
+     */
+    AI::RouteCache mRouteCache;
+
+    bool mIsHierarchicalSearchEnabled = true;
+    AI::WaynetSearchStats mSearchStats;
+
+    bs::Path mNextHopTablePath;
+    bs::UINT64 mNextHopTableBudget = AI::WaynetNextHopTable::DEFAULT_MEMORY_BUDGET;
+
   public:
     REGOTH_DECLARE_RTTI(Waynet)
 
@@ -0,0 +1,135 @@
+#include "DebugDrawBatches.hpp"
+#include <Debug/BsDebugDraw.h>
+
+namespace REGoth
+{
+  constexpr float DebugDrawBatches::POINT_SIZE;
+
+  DebugDrawBatches::DebugDrawBatches()
+  {
+    category(DebugDrawCategory::Waynet).color = bs::Color::Red;
+    category(DebugDrawCategory::Routes).color = bs::Color::Green;
+
+    // Filled by every moving character while enabled, see AI::Pathfinder::debugDrawRoute()
+    category(DebugDrawCategory::Routes).isEnabled = false;
+  }
+
+  void DebugDrawBatches::setBatch(DebugDrawCategory categoryOfBatch, bs::UINT64 owner,
+                                  bs::Vector<bs::Vector3> linePoints,
+                                  const bs::Vector<bs::Vector3>& points)
+  {
+    const float halfSize = POINT_SIZE * 0.5f;
+
+    linePoints.reserve(linePoints.size() + points.size() * 6);
+
+    for (const bs::Vector3& point : points)
+    {
+      linePoints.push_back(point - bs::Vector3::UNIT_X * halfSize);
+      linePoints.push_back(point + bs::Vector3::UNIT_X * halfSize);
+      linePoints.push_back(point - bs::Vector3::UNIT_Y * halfSize);
+      linePoints.push_back(point + bs::Vector3::UNIT_Y * halfSize);
+      linePoints.push_back(point - bs::Vector3::UNIT_Z * halfSize);
+      linePoints.push_back(point + bs::Vector3::UNIT_Z * halfSize);
+    }
+
+    Category& c      = category(categoryOfBatch);
+    c.batches[owner] = std::move(linePoints);
+
+    onCategoryChanged(c);
+  }
+
+  void DebugDrawBatches::removeBatch(DebugDrawCategory categoryOfBatch, bs::UINT64 owner)
+  {
+    Category& c = category(categoryOfBatch);
+
+    if (c.batches.erase(owner) == 0) return;
+
+    onCategoryChanged(c);
+  }
+
+  void DebugDrawBatches::clearCategory(DebugDrawCategory categoryToClear)
+  {
+    Category& c = category(categoryToClear);
+
+    if (c.batches.empty()) return;
+
+    c.batches.clear();
+    onCategoryChanged(c);
+  }
+
+  void DebugDrawBatches::setCategoryEnabled(DebugDrawCategory categoryToSet, bool isEnabled)
+  {
+    Category& c = category(categoryToSet);
+
+    if (c.isEnabled == isEnabled) return;
+
+    c.isEnabled = isEnabled;
+    mHasChanged = true;
+  }
+
+  bool DebugDrawBatches::isCategoryEnabled(DebugDrawCategory categoryToCheck) const
+  {
+    return category(categoryToCheck).isEnabled;
+  }
+
+  void DebugDrawBatches::redrawIfChanged()
+  {
+    if (!mHasChanged) return;
+
+    mHasChanged = false;
+
+    bs::DebugDraw& debugDraw = bs::DebugDraw::instance();
+    debugDraw.clear();
+
+    mStats.numRedraws += 1;
+    mStats.numSegments = 0;
+
+    for (Category& c : mCategories)
+    {
+      if (!c.isEnabled) continue;
+
+      if (!c.isMerged)
+      {
+        c.merged.clear();
+
+        for (const auto& it : c.batches)
+        {
+          c.merged.insert(c.merged.end(), it.second.begin(), it.second.end());
+        }
+
+        c.isMerged = true;
+      }
+
+      if (c.merged.empty()) continue;
+
+      debugDraw.setColor(c.color);
+      debugDraw.drawLineList(c.merged);
+
+      mStats.numSegments += c.merged.size() / 2;
+    }
+  }
+
+  DebugDrawBatches::Category& DebugDrawBatches::category(DebugDrawCategory category)
+  {
+    return mCategories[(size_t)category];
+  }
+
+  const DebugDrawBatches::Category& DebugDrawBatches::category(DebugDrawCategory category) const
+  {
+    return mCategories[(size_t)category];
+  }
+
+  void DebugDrawBatches::onCategoryChanged(Category& category)
+  {
+    category.isMerged = false;
+
+    // Changes to categories which aren't drawn only show once they are enabled
+    if (category.isEnabled) mHasChanged = true;
+  }
+
+  DebugDrawBatches& gDebugDrawBatches()
+  {
+    static DebugDrawBatches batches;
+    return batches;
+  }
+}  // namespace REGoth
@@ -0,0 +1,117 @@
+/**\file
+ */
+#pragma once
+#include <BsPrerequisites.h>
+#include <Image/BsColor.h>
+
+namespace REGoth
+{
+  /**
+   * What a debug line belongs to. Every category is drawn in its own color and can be turned
+   * on and off on its own.
+   */
+  enum class DebugDrawCategory : bs::UINT8
+  {
+    Waynet,  ///< Paths between the waypoints, drawn once after the world has been loaded
+    Routes,  ///< Where the characters are going, off by default
+    Count,
+  };
+
+  /**
+   * Retained debug lines, so static data like the waynet doesn't have to be handed to
+   * bs::DebugDraw segment by segment, and the things which do change only cost something
+   * when they actually change.
+   *
+   * Lines are kept in batches. A batch belongs to a category and an owner chosen by whoever
+   * fills it, e.g. the address of the pathfinder whose route it shows. Points are drawn as
+   * small crosses, so they end up in the same line list. Whenever a batch has changed, the
+   * batches of every enabled category are merged and handed to bs::DebugDraw again, one line
+   * list per category. Until the next change, bs::DebugDraw keeps drawing those without
+   * anyone touching the lines.
+   *
+   * As bs::DebugDraw is cleared on every redraw, nothing else should draw through it while
+   * batches are in use. Only to be used from the main thread. There is one global instance,
+   * see gDebugDrawBatches().
+   */
+  class DebugDrawBatches
+  {
+  public:
+    /** Length of the arms of the crosses drawn for points, in meters */
+    static constexpr float POINT_SIZE = 0.25f;
+
+    struct Stats
+    {
+      /** How often everything has been handed to bs::DebugDraw */
+      bs::UINT64 numRedraws = 0;
+
+      /** Line segments handed over on the last redraw */
+      bs::UINT64 numSegments = 0;
+    };
+
+    DebugDrawBatches();
+
+    /**
+     * Replaces the lines of the given batch, creating it if needed.
+     *
+     * @param  linePoints  Two per segment: start and end.
+     * @param  points      Drawn as crosses of POINT_SIZE.
+     */
+    void setBatch(DebugDrawCategory category, bs::UINT64 owner,
+                  bs::Vector<bs::Vector3> linePoints, const bs::Vector<bs::Vector3>& points = {});
+
+    /**
+     * Removes the given batch, if there is one.
+     */
+    void removeBatch(DebugDrawCategory category, bs::UINT64 owner);
+
+    /**
+     * Removes all batches of the given category.
+     */
+    void clearCategory(DebugDrawCategory category);
+
+    void setCategoryEnabled(DebugDrawCategory category, bool isEnabled);
+    bool isCategoryEnabled(DebugDrawCategory category) const;
+
+    /**
+     * Hands everything to bs::DebugDraw again if anything has changed since the last time.
+     * To be called once per frame.
+     */
+    void redrawIfChanged();
+
+    const Stats& stats() const
+    {
+      return mStats;
+    }
+
+  private:
+    struct Category
+    {
+      bs::Color color;
+      bool isEnabled = true;
+
+      /** Line points by owner */
+      bs::UnorderedMap<bs::UINT64, bs::Vector<bs::Vector3>> batches;
+
+      /** All batches in one list, rebuilt on the next redraw if `isMerged` is not set */
+      bs::Vector<bs::Vector3> merged;
+      bool isMerged = true;
+    };
+
+    Category& category(DebugDrawCategory category);
+    const Category& category(DebugDrawCategory category) const;
+
+    /**
+     * Must be called whenever the lines of the given category have changed.
+     */
+    void onCategoryChanged(Category& category);
+
+    Category mCategories[(size_t)DebugDrawCategory::Count];
+    bool mHasChanged = false;
+    Stats mStats;
+  };
+
+  /**
+   * @return The debug lines of the engine, see DebugDrawBatches.
+   */
+  DebugDrawBatches& gDebugDrawBatches();
+}  // namespace REGoth
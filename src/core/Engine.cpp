@@ -5,10 +5,14 @@
 #include <memory>
 
 #include <BsApplication.h>
+#include <Components/BsCAudioListener.h>
 #include <Components/BsCCamera.h>
+#include <FileSystem/BsDataStream.h>
 #include <FileSystem/BsFileSystem.h>
 #include <Importer/BsImporter.h>
 #include <Input/BsVirtualInput.h>
+#include <Resources/BsResourceManifest.h>
+#include <Resources/BsResources.h>
 #include <Scene/BsSceneObject.h>
 
 #include <BsZenLib/ImportMaterial.hpp>
@@ -17,11 +21,21 @@
 
 #include <cxxopts.hpp>
 
+#include <animation/AnimationLod.hpp>
+#include <core/FrameMonitor.hpp>
+#include <core/InputReplay.hpp>
+#include <core/Metrics.hpp>
+#include <core/MemoryAccounting.hpp>
+#include <core/Profiling.hpp>
+#include <core/StartupProfiler.hpp>
 #include <engine-content/EngineContent.hpp>
 #include <exception/Throw.hpp>
 #include <log/logging.hpp>
 #include <original-content/OriginalGameFiles.hpp>
+#include <original-content/ResourceManifestJournal.hpp>
+#include <original-content/TextureStreaming.hpp>
 #include <original-content/VirtualFileSystem.hpp>
+#include <scripting/daedalus/DaedalusNativeModule.hpp>
 
 using namespace REGoth;
 
@@ -41,14 +55,31 @@ void Engine::loadGamePackages()
 
   gVirtualFileSystem().setPathToEngineExecutable(config()->engineExecutablePath.toString());
 
-  REGOTH_LOG(Info, Uncategorized, "[VDFS] Indexing packages: ");
+  if (!config()->fileTracePath.isEmpty())
+  {
+    gVirtualFileSystem().setFileTraceEnabled(true);
+  }
 
-  for (auto p : files.allVdfsPackages())
+  // A content pack already contains everything from the packages and the _work directory
+  if (!config()->contentPackPath.isEmpty())
   {
-    REGOTH_LOG(Info, Uncategorized, "[VDFS]  - {0}", p.getFilename());
-    gVirtualFileSystem().loadPackage(p);
+    REGOTH_LOG(Info, Uncategorized, "[VDFS] Loading content pack: {0}",
+               config()->contentPackPath.toString());
+
+    if (!gVirtualFileSystem().loadPackage(config()->contentPackPath))
+    {
+      REGOTH_THROW(FileNotFoundException,
+                   "Failed to load content pack: " + config()->contentPackPath.toString());
+    }
+
+    loadModPackages(files);
+    return;
   }
 
+  // Directories of unchanged packages are remembered across runs
+  gVirtualFileSystem().loadPackages(files.allVdfsPackages(),
+                                    BsZenLib::GothicPathToCachedWorld("VDFS.INDEX"));
+
   gVirtualFileSystem().mountDirectory(files.vdfsFileEntryPoint());
 
   loadModPackages(files);
@@ -66,9 +97,127 @@ void Engine::saveCachedResourceManifests()
   REGOTH_LOG(Info, Uncategorized, "[Engine]   - Gothic Cache");
   BsZenLib::SaveResourceManifest();
 
-  // Engine-Content manifest is saved after every resource load since
-  // there are only a few resources to handle. If that ever takes too long
-  // the manifest should be saved here.
+  // Everything journaled is part of the saved manifest now
+  gGothicCacheJournal().clear();
+
+  if (mEngineContent)
+  {
+    REGOTH_LOG(Info, Uncategorized, "[Engine]   - REGoth Assets");
+    mEngineContent->saveResourceManifest();
+  }
+}
+
+void Engine::saveFileTrace()
+{
+  if (config()->fileTracePath.isEmpty()) return;
+
+  bs::String text;
+  for (const bs::String& file : gVirtualFileSystem().fileTrace())
+  {
+    text += file + "\n";
+  }
+
+  bs::SPtr<bs::DataStream> stream = bs::FileSystem::createAndOpenFile(config()->fileTracePath);
+
+  if (!stream)
+  {
+    REGOTH_LOG(Error, Uncategorized, "[Engine] Failed to write file trace to {0}",
+               config()->fileTracePath.toString());
+    return;
+  }
+
+  stream->write(text.data(), text.size());
+  stream->close();
+
+  REGOTH_LOG(Info, Uncategorized, "[Engine] Wrote file trace to {0}",
+             config()->fileTracePath.toString());
+}
+
+void Engine::setupLogging()
+{
+  Logging::setMaxVerbosity(config()->logVerbosity);
+  Logging::setAsync(!config()->isLoggingSynchronous);
+}
+
+void Engine::setupProfiler()
+{
+  if (config()->isProfiling || !config()->profileTracePath.isEmpty() ||
+      config()->isMonitoringFrames)
+  {
+    gProfiler().setEnabled(true);
+  }
+
+  if (config()->isMonitoringFrames)
+  {
+    gFrameMonitor().setHitchThreshold(config()->hitchThresholdMs);
+    gFrameMonitor().setLogsHitches(config()->isHeadless);
+    gFrameMonitor().setEnabled(true);
+  }
+
+  if (!config()->startupProfilePath.isEmpty())
+  {
+    gStartupProfiler().enable(config()->startupProfilePath);
+  }
+
+  if (!config()->metricsPath.isEmpty())
+  {
+    gMetrics().enable(config()->metricsPath, config()->metricsInterval);
+  }
+}
+
+void Engine::saveProfileTrace()
+{
+  if (config()->profileTracePath.isEmpty()) return;
+
+  gProfiler().writeChromeTrace(config()->profileTracePath);
+}
+
+void Engine::saveMemoryReport()
+{
+  if (config()->memoryReportPath.isEmpty()) return;
+
+  gMemoryAccounting().writeReport(config()->memoryReportPath);
+}
+
+void Engine::saveMetrics()
+{
+  gMetrics().exportNow();
+}
+
+void Engine::saveStartupProfile()
+{
+  gStartupProfiler().writeReportIfPending();
+}
+
+void Engine::setupReplay()
+{
+  gInputReplay().setRandomSeed(config()->scriptRandomSeed);
+
+  if (!config()->replayPlayPath.isEmpty())
+  {
+    gInputReplay().startPlayback(config()->replayPlayPath, config()->replayStatsPath);
+  }
+  else if (!config()->replayRecordPath.isEmpty())
+  {
+    gInputReplay().startRecording(config()->replayRecordPath);
+  }
+}
+
+void Engine::saveReplay()
+{
+  gInputReplay().finish();
+}
+
+void Engine::logFrameMonitorSummary()
+{
+  gFrameMonitor().logSummary();
+}
+
+void Engine::loadScriptNativeModule()
+{
+  if (config()->scriptNativeModulePath.isEmpty()) return;
+
+  Scripting::gDaedalusNativeModules().load(config()->scriptNativeModulePath);
 }
 
 bool Engine::hasFoundGameFiles()
@@ -94,7 +243,30 @@ void Engine::initializeBsf()
   using namespace bs;
 
   VideoMode videoMode{config()->resolutionX, config()->resolutionY};
-  Application::startUp(videoMode, "REGoth", config()->isFullscreen);
+
+  if (config()->isHeadless)
+  {
+    START_UP_DESC desc = Application::buildStartUpDesc(videoMode, "REGoth", false);
+
+    // The null plugins accept everything and do nothing, so all components can stay as they
+    // are. Physics, input and animation still use the real plugins.
+    desc.renderAPI                = "bsfNullRenderAPI";
+    desc.renderer                 = "bsfNullRenderer";
+    desc.audio                    = "bsfNullAudio";
+    desc.primaryWindowDesc.hidden = true;
+    desc.primaryWindowDesc.vsync  = false;
+
+    REGOTH_LOG(Info, Uncategorized, "[Engine] Starting headless");
+
+    Application::startUp(desc);
+  }
+  else
+  {
+    Application::startUp(videoMode, "REGoth", config()->isFullscreen);
+  }
+
+  gTextureStreaming().setBudget((UINT64)config()->textureBudgetMegabytes * 1024 * 1024);
+  gAnimationLodSettings() = config()->animationLod;
 }
 
 void Engine::loadCachedResourceManifests()
@@ -114,6 +286,17 @@ void Engine::loadCachedResourceManifests()
 
   REGOTH_LOG(Info, Uncategorized, "[Engine]   - Original Gothic Assets");
   BsZenLib::LoadResourceManifest();
+
+  // Resources cached after the manifest was last saved, e.g. before a crash. They are
+  // registered with a manifest of their own, as the one of BsZenLib can't be reached.
+  bs::SPtr<bs::ResourceManifest> journaled = bs::ResourceManifest::create("gothic-journal");
+  bs::UINT32 numJournaled = gGothicCacheJournal().replay(*journaled);
+
+  if (numJournaled > 0)
+  {
+    REGOTH_LOG(Info, Uncategorized, "[Engine]   - {0} resources from the journal", numJournaled);
+    bs::gResources().registerResourceManifest(journaled);
+  }
 }
 
 void Engine::setupInput()
@@ -141,6 +324,7 @@ void Engine::setupInput()
   inputConfig->registerButton("ToggleMeleeWeapon", BC_1);
   inputConfig->registerButton("Action", BC_LCONTROL);
   inputConfig->registerButton("QuickSave", BC_F5);
+  inputConfig->registerButton("ReloadScripts", BC_F9);
 
   // Camera controls for axes (analog input, e.g. mouse or gamepad thumbstick)
   // These return values in [-1.0, 1.0] range.
@@ -158,6 +342,9 @@ void Engine::setupMainCamera()
   sceneCamera->setMain(true);
   sceneCamera->setMSAACount(1);
 
+  // Ambient sounds are heard from where the camera is, see AmbientSoundVoices
+  sceneCameraSO->addComponent<CAudioListener>();
+
   // Disable some fancy rendering
   auto rs = sceneCamera->getRenderSettings();
 
@@ -211,6 +398,9 @@ void Engine::run()
 
 void Engine::shutdown()
 {
+  // Everything logged from here on is written right away
+  Logging::shutdown();
+
   if (bs::Application::isStarted())
   {
     REGOTH_LOG(Info, Uncategorized, "[Engine] Shutting down bs::f");
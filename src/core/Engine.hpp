@@ -54,6 +54,9 @@ namespace REGoth
      *  1. `Data/` (`*.vdf`)
      *  2. `_world/` (Recursive)
      *  3. `Data/modvdf/` (`*.mod`, recursive)
+     *
+     * Only touches the VDFS, so `runEngine()` runs this on a worker thread while the main
+     * thread goes on with the rest of the startup.
      */
     void loadGamePackages();
 
@@ -61,7 +64,8 @@ namespace REGoth
      * Called by `loadOriginalGamePackages()`. Can be overriden by the user to load specific
      * MOD-packages.
      *
-     * To load a MOD-package, use `gVirtualFileSystem().loadPackage(p)`.
+     * To load a MOD-package, use `gVirtualFileSystem().loadPackage(p)`. Called on a worker
+     * thread, see `loadGamePackages()`, so this should not touch anything but the VDFS.
      *
      * @param  files  Reference to `OriginalGameFiles` object, which has some utility methods to
      *                access files in the original game directory.
@@ -77,20 +81,90 @@ namespace REGoth
     bool hasFoundGameFiles();
 
     /**
-     * Initializes `bsf` and opens the window.
+     * Initializes `bsf` and opens the window. If `EngineConfig::isHeadless` is set, bs:f
+     * is started with its null render API, renderer and audio instead and the window stays
+     * hidden.
      */
     void initializeBsf();
 
     /**
-     * Load all resource manifests written by previous runs of REGoth.
+     * Load all resource manifests written by previous runs of REGoth, including what has been
+     * journaled since they were last saved, see ResourceManifestJournal.
      */
     void loadCachedResourceManifests();
 
     /**
-     * Save resource manifests containing resources loaded during this run.
+     * Save resource manifests containing resources loaded during this run, as a whole. Clears
+     * their journals.
      */
     void saveCachedResourceManifests();
 
+    /**
+     * Writes the files read from the VDFS during this run, if recording them was enabled via
+     * `EngineConfig::fileTracePath`. One UPPERCASE file name per line, in the order they were
+     * first read. See REGothContentPacker.
+     */
+    void saveFileTrace();
+
+    /**
+     * Applies the log verbosity and whether to log on a background thread, see
+     * REGoth::Logging.
+     */
+    void setupLogging();
+
+    /**
+     * Turns on gProfiler(), if `EngineConfig::isProfiling` is set or a trace is to be written,
+     * gStartupProfiler(), if `EngineConfig::startupProfilePath` is set, gFrameMonitor(),
+     * if `EngineConfig::isMonitoringFrames` is set, and gMetrics(), if
+     * `EngineConfig::metricsPath` is set. Doesn't need bs:f to be running, so the
+     * startup of bs:f can be recorded as well.
+     */
+    void setupProfiler();
+
+    /**
+     * Writes what gProfiler() recorded to `EngineConfig::profileTracePath`, if set.
+     */
+    void saveProfileTrace();
+
+    /**
+     * Writes the report of gMemoryAccounting() to `EngineConfig::memoryReportPath`, if set.
+     */
+    void saveMemoryReport();
+
+    /**
+     * Writes the metrics of gMetrics() one last time, if enabled.
+     */
+    void saveMetrics();
+
+    /**
+     * Writes the report of gStartupProfiler() to `EngineConfig::startupProfilePath`, if set
+     * and not written already because the first frame never finished.
+     */
+    void saveStartupProfile();
+
+    /**
+     * Seeds `Hlp_Random` and starts recording or playing back the input of the hero via
+     * gInputReplay(), as set in the EngineConfig.
+     */
+    void setupReplay();
+
+    /**
+     * Writes the recording of gInputReplay(), or the frame times of its playback, if not
+     * done already.
+     */
+    void saveReplay();
+
+    /**
+     * Logs the summary of gFrameMonitor(), if enabled.
+     */
+    void logFrameMonitorSummary();
+
+    /**
+     * Loads the native module of the scripts at `EngineConfig::scriptNativeModulePath`, if
+     * set, see Scripting::DaedalusNativeModules. Needs bs:f to be running.
+     */
+    void loadScriptNativeModule();
+
     /**
      * Assign buttons and axis to control the game.
      */
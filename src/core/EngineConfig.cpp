@@ -38,6 +38,40 @@ std::stringstream& REGoth::operator>>(std::stringstream& str, Sky::RenderMode& r
   return str;
 }
 
+std::stringstream& bs::operator>>(std::stringstream& str, bs::LogVerbosity& verbosity)
+{
+  bs::String level{str.str().c_str()};
+  bs::StringUtil::toLowerCase(level);
+  if (level == "fatal")
+  {
+    verbosity = bs::LogVerbosity::Fatal;
+  }
+  else if (level == "error")
+  {
+    verbosity = bs::LogVerbosity::Error;
+  }
+  else if (level == "warning")
+  {
+    verbosity = bs::LogVerbosity::Warning;
+  }
+  else if (level == "info")
+  {
+    verbosity = bs::LogVerbosity::Info;
+  }
+  else if (level == "verbose")
+  {
+    verbosity = bs::LogVerbosity::Verbose;
+  }
+  else
+  {
+    REGOTH_THROW(InvalidParametersException,
+                 "Log verbosity cannot be \"" + level +
+                     "\".  Possible values: \"fatal\", \"error\", \"warning\", \"info\", "
+                     "\"verbose\".");
+  }
+  return str;
+}
+
 EngineConfig::~EngineConfig()
 {
   // pass
@@ -63,10 +97,130 @@ void EngineConfig::registerCLIEngineOptions(cxxopts::Options& options)
                      cxxopts::value<unsigned int>(resolutionY), "[PX]");
   options.add_option(vidgrp, "", "video-fullscreen", "If set, the game runs in fullscreen mode",
                      cxxopts::value<bool>(isFullscreen), "");
+  options.add_option(vidgrp, "", "headless",
+                     "If set, the game runs without window, rendering, GUI and audio",
+                     cxxopts::value<bool>(isHeadless), "");
   options.add_option(vidgrp, "", "video-sky-mode",
                      "Sky render mode, either \"plane\" or \"dome\".  Note: \"dome\" can only be "
                      "used in Gothic II",
                      cxxopts::value<Sky::RenderMode>(skyRenderMode), "[plane|dome]");
+  options.add_option(vidgrp, "", "video-texture-budget",
+                     "GPU memory the textures of the scene may take before they lose detail",
+                     cxxopts::value<unsigned int>(textureBudgetMegabytes), "[MB]");
+  options.add_option(vidgrp, "", "video-anim-detail-distance",
+                     "Characters farther away from the camera than this skip animating their "
+                     "fingers and toes",
+                     cxxopts::value<float>(animationLod.reducedDetailDistance), "[METERS]");
+  options.add_option(vidgrp, "", "video-anim-cull-offscreen",
+                     "Whether characters outside of the view skip evaluating their animations",
+                     cxxopts::value<bool>(animationLod.isCullingOffscreen), "[true|false]");
+
+  // VDFS options.
+  const std::string vdfsgrp = "VDFS";
+  options.add_option(vdfsgrp, "", "vdfs-content-pack",
+                     "Content pack made by REGothContentPacker to load instead of the game's "
+                     "packages and _work directory",
+                     cxxopts::value<bs::Path>(contentPackPath), "[PATH]");
+  options.add_option(vdfsgrp, "", "vdfs-record-trace",
+                     "Write the names of the files read from the VDFS to this file on exit, in "
+                     "the order they were first read",
+                     cxxopts::value<bs::Path>(fileTracePath), "[PATH]");
+
+  // Logging options.
+  const std::string loggrp = "Logging";
+  options.add_option(loggrp, "", "log-verbosity", "Most verbose level of messages to log",
+                     cxxopts::value<bs::LogVerbosity>(logVerbosity),
+                     "[fatal|error|warning|info|verbose]");
+  options.add_option(loggrp, "", "log-sync",
+                     "If set, messages are logged right away instead of on a background thread",
+                     cxxopts::value<bool>(isLoggingSynchronous), "");
+
+  // Profiling options.
+  const std::string profgrp = "Profiling";
+  options.add_option(profgrp, "", "profile",
+                     "If set, the time spent in the engine's systems is shown in an overlay",
+                     cxxopts::value<bool>(isProfiling), "");
+  options.add_option(profgrp, "", "profile-trace",
+                     "Write the time spent in the engine's systems to this file on exit, to be "
+                     "viewed in Chrome's about:tracing or Perfetto",
+                     cxxopts::value<bs::Path>(profileTracePath), "[PATH]");
+  options.add_option(profgrp, "", "memory-report",
+                     "Write how much memory the engine's systems take to this file on exit",
+                     cxxopts::value<bs::Path>(memoryReportPath), "[PATH]");
+  options.add_option(profgrp, "", "profile-startup",
+                     "Write the time, bytes read and allocations of every step of the startup "
+                     "to this file as JSON, once the first frame is done",
+                     cxxopts::value<bs::Path>(startupProfilePath), "[PATH]");
+  options.add_option(profgrp, "", "frame-monitor",
+                     "If set, the allocations of every frame and frames taking too long are "
+                     "shown in the overlay and summed up in the log on exit",
+                     cxxopts::value<bool>(isMonitoringFrames), "");
+  options.add_option(profgrp, "", "hitch-threshold",
+                     "Frames taking longer than this many milliseconds count as hitches",
+                     cxxopts::value<float>(hitchThresholdMs), "[MS]");
+  options.add_option(profgrp, "", "metrics",
+                     "Write throughput, queue lengths and memory of the engine's systems to this "
+                     "file every --metrics-interval seconds, as JSON or, if it ends in .prom, "
+                     "for Prometheus",
+                     cxxopts::value<bs::Path>(metricsPath), "[PATH]");
+  options.add_option(profgrp, "", "metrics-interval", "Seconds between two writes of --metrics",
+                     cxxopts::value<float>(metricsInterval), "[SECONDS]");
+
+  // Replay options.
+  const std::string replaygrp = "Replay";
+  options.add_option(replaygrp, "", "replay-record",
+                     "Record the input of the hero to this file, written on exit",
+                     cxxopts::value<bs::Path>(replayRecordPath), "[PATH]");
+  options.add_option(replaygrp, "", "replay-play",
+                     "Play back the input recorded to this file instead of the live one and quit "
+                     "once done",
+                     cxxopts::value<bs::Path>(replayPlayPath), "[PATH]");
+  options.add_option(replaygrp, "", "replay-stats",
+                     "Write the frame times of --replay-play to this file as JSON",
+                     cxxopts::value<bs::Path>(replayStatsPath), "[PATH]");
+  options.add_option(replaygrp, "", "script-random-seed",
+                     "Seed of Hlp_Random. Replays use the seed they were recorded with",
+                     cxxopts::value<bs::UINT32>(scriptRandomSeed), "[SEED]");
+
+  // AI options.
+  const std::string aigrp = "AI";
+  options.add_option(aigrp, "", "ai-near-distance",
+                     "Characters closer to the hero than this run their script states every update",
+                     cxxopts::value<float>(scriptStateScheduling.nearDistance), "[METERS]");
+  options.add_option(aigrp, "", "ai-far-distance",
+                     "Characters farther away from the hero than this run their script states "
+                     "every --ai-far-interval seconds, others every --ai-medium-interval seconds",
+                     cxxopts::value<float>(scriptStateScheduling.farDistance), "[METERS]");
+  options.add_option(aigrp, "", "ai-medium-interval",
+                     "Time between script state updates of characters at medium distance",
+                     cxxopts::value<float>(scriptStateScheduling.mediumInterval), "[SECONDS]");
+  options.add_option(aigrp, "", "ai-far-interval",
+                     "Time between script state updates of characters far away",
+                     cxxopts::value<float>(scriptStateScheduling.farInterval), "[SECONDS]");
+  options.add_option(aigrp, "", "ai-script-budget",
+                     "Time script states may take per frame before characters which are not near "
+                     "the hero have to wait.  0 means no limit",
+                     cxxopts::value<float>(scriptStateScheduling.budgetMilliseconds), "[MS]");
+  options.add_option(aigrp, "", "ai-max-steps-per-frame",
+                     "Fixed updates per frame in which characters which are not near the hero "
+                     "run their script states. 0 means no limit",
+                     cxxopts::value<bs::UINT32>(scriptStateScheduling.maxStepsPerFrame),
+                     "[NUM]");
+  options.add_option(aigrp, "", "ai-routine-jump-time-scale",
+                     "From this --time-scale on, characters are teleported along their daily "
+                     "routines instead of walking",
+                     cxxopts::value<float>(scriptStateScheduling.routineJumpTimeScale), "[SCALE]");
+  options.add_option(aigrp, "", "time-scale",
+                     "How much faster than usual the ingame time passes, e.g. 100 to simulate a "
+                     "day in a minute",
+                     cxxopts::value<float>(timeScale), "[SCALE]");
+
+  // Script options.
+  const std::string scriptgrp = "Scripts";
+  options.add_option(scriptgrp, "", "script-native-module",
+                     "Run the scripts compiled into this shared library by REGothDaedalusAOT, "
+                     "if it has been compiled from the same DAT-file",
+                     cxxopts::value<bs::Path>(scriptNativeModulePath), "[PATH]");
 
   // Allow game-assets to also be a positional.
   options.parse_positional({"game-assets"});
@@ -129,6 +283,22 @@ void EngineConfig::verifyCLIEngineOptions()
   // Now that originalAssetsPath is determined, try to derive the game type.
   gameType = OriginalGameFiles{originalAssetsPath}.gameType();
 
+  if (animationLod.reducedDetailDistance < 0.0f)
+  {
+    REGOTH_THROW(InvalidStateException, "--video-anim-detail-distance must not be negative.");
+  }
+
+  if (scriptStateScheduling.nearDistance > scriptStateScheduling.farDistance)
+  {
+    REGOTH_THROW(InvalidStateException,
+                 "--ai-near-distance must not be larger than --ai-far-distance.");
+  }
+
+  if (timeScale <= 0.0f)
+  {
+    REGOTH_THROW(InvalidStateException, "--time-scale must be larger than 0.");
+  }
+
   // In Gothic 1, the sky render mode cannot be "dome".
   if (gameType == GameType::Gothic1 && skyRenderMode == Sky::RenderMode::Dome)
   {
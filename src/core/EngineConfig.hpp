@@ -1,8 +1,14 @@
 #pragma once
 
+#include <Debug/BsDebug.h>
 #include <FileSystem/BsPath.h>
 
+#include <AI/ScriptStateScheduler.hpp>
+#include <animation/AnimationLod.hpp>
+#include <core/FrameMonitor.hpp>
 #include <core/GameType.hpp>
+#include <core/InputReplay.hpp>
+#include <core/Metrics.hpp>
 
 #include <cxxopts.hpp>
 
@@ -18,6 +24,15 @@ namespace bs
    * @return The original stringstream.
    */
   std::stringstream& operator>>(std::stringstream& str, bs::Path& path);
+
+  /**
+   * Allows using the `bs::LogVerbosity` data type together with `cxxopts`.
+   *
+   * @param str Input stringstream.
+   * @param verbosity Verbosity to write data to.
+   * @return The original stringstream.
+   */
+  std::stringstream& operator>>(std::stringstream& str, bs::LogVerbosity& verbosity);
 }  // namespace bs
 
 namespace REGoth
@@ -110,9 +125,139 @@ namespace REGoth
      */
     bool isFullscreen = false;
 
+    /**
+     * Whether to run without window, rendering, GUI, sky and audio, e.g. for simulation runs
+     * on a server. Scripts, AI, pathfinding and physics still run, as fast as they can since
+     * no frames have to be drawn.
+     */
+    bool isHeadless = false;
+
     /**
      * The sky render mode of the game.
      */
     Sky::RenderMode skyRenderMode = Sky::RenderMode::Plane;
+
+    /**
+     * Megabytes of GPU memory the streamed textures of the scene may take, see
+     * TextureStreaming.
+     */
+    unsigned int textureBudgetMegabytes = 512;
+
+    /**
+     * Content pack to load instead of the packages and the `_work` directory of the game.
+     * Empty to load those.
+     */
+    bs::Path contentPackPath;
+
+    /**
+     * Where to write the files read from the VDFS to, see VirtualFileSystem::fileTrace().
+     * Empty to not record them.
+     */
+    bs::Path fileTracePath;
+
+    /**
+     * Most verbose level to log, see REGoth::Logging::setMaxVerbosity(). Levels more verbose
+     * than the one bs:f has been built with are never logged.
+     */
+    bs::LogVerbosity logVerbosity = bs::LogVerbosity::Any;
+
+    /**
+     * Whether to write log messages right away on the logging thread instead of on a
+     * background thread, e.g. to not lose any when debugging a crash. See
+     * REGoth::Logging::setAsync().
+     */
+    bool isLoggingSynchronous = false;
+
+    /**
+     * Whether to record the time spent in the scopes marked via REGOTH_PROFILE_SCOPE() and
+     * show them in an overlay, see UIProfilerOverlay.
+     */
+    bool isProfiling = false;
+
+    /**
+     * Where to write the recorded scopes to on exit, as Chrome trace. Empty to not write
+     * them. Turns on profiling as well.
+     */
+    bs::Path profileTracePath;
+
+    /**
+     * Where to write the memory taken by the engine's systems to on exit, see
+     * MemoryAccounting. Empty to not write it.
+     */
+    bs::Path memoryReportPath;
+
+    /**
+     * Where to write how long each step of the startup took to, as JSON, once the first frame
+     * is done. See StartupProfiler. Empty to not write it.
+     */
+    bs::Path startupProfilePath;
+
+    /**
+     * Whether to count the allocations of every frame and look out for hitches, see
+     * FrameMonitor. Turns on profiling as well, so it's known what a hitch was spent on.
+     */
+    bool isMonitoringFrames = false;
+
+    /**
+     * Frames taking longer than this many milliseconds count as hitches, see
+     * FrameMonitor::setHitchThreshold().
+     */
+    float hitchThresholdMs = FrameMonitor::DEFAULT_HITCH_THRESHOLD_MS;
+
+    /**
+     * Where to write the metrics of the engine to every `metricsInterval` seconds, see
+     * Metrics. Empty to not write them.
+     */
+    bs::Path metricsPath;
+
+    /**
+     * Seconds between two writes of the metrics to `metricsPath`.
+     */
+    float metricsInterval = Metrics::DEFAULT_EXPORT_INTERVAL;
+
+    /**
+     * Where to write the input of the hero to on exit, see InputReplay. Empty to not record.
+     */
+    bs::Path replayRecordPath;
+
+    /**
+     * Recording to play back instead of the live input, see InputReplay. Empty to play live.
+     */
+    bs::Path replayPlayPath;
+
+    /**
+     * Where to write the frame times of the playback of `replayPlayPath` to, as JSON. Empty
+     * to only log them.
+     */
+    bs::Path replayStatsPath;
+
+    /**
+     * Seed of `Hlp_Random`, unless a replay is played back, which brings its own.
+     */
+    bs::UINT32 scriptRandomSeed = InputReplay::DEFAULT_RANDOM_SEED;
+
+    /**
+     * Native module of scripts compiled ahead of time to load, see
+     * Scripting::DaedalusNativeModule. Empty to interpret all scripts.
+     */
+    bs::Path scriptNativeModulePath;
+
+    /**
+     * How often the script states of characters are run, depending on their distance
+     * to the hero. See AI::ScriptStateScheduler.
+     */
+    AI::ScriptStateSchedulerSettings scriptStateScheduling;
+
+    /**
+     * How much faster than usual the ingame time passes, e.g. to fast-forward days while
+     * testing daily routines. See GameClock::setTimeScale().
+     */
+    float timeScale = 1.0f;
+
+    /**
+     * How much of the animations of characters is evaluated, depending on their distance to
+     * the camera. See AnimationLodSettings.
+     */
+    AnimationLodSettings animationLod;
   };
 }  // namespace REGoth
@@ -0,0 +1,303 @@
+#include "FrameMonitor.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <log/logging.hpp>
+#include <new>
+
+#ifndef REGOTH_COUNT_ALLOCATIONS
+#  define REGOTH_COUNT_ALLOCATIONS 0
+#endif
+
+namespace REGoth
+{
+  constexpr bs::UINT32 FrameMonitor::MAX_PHASES;
+  constexpr bs::UINT32 FrameMonitor::MAX_HITCHES_KEPT;
+  constexpr bs::UINT32 FrameMonitor::MAX_SCOPES_PER_HITCH;
+  constexpr float FrameMonitor::DEFAULT_HITCH_THRESHOLD_MS;
+
+  // Plain integers, as they are touched before any constructor might have run
+  static thread_local bs::UINT64 s_ThreadNumAllocations = 0;
+  static thread_local bs::UINT64 s_ThreadBytes          = 0;
+  static std::atomic<bs::UINT64> s_NumAllocations       = {0};
+  static std::atomic<bs::UINT64> s_Bytes                = {0};
+
+  static void countAllocation(size_t size)
+  {
+    s_ThreadNumAllocations += 1;
+    s_ThreadBytes += size;
+
+    s_NumAllocations.fetch_add(1, std::memory_order_relaxed);
+    s_Bytes.fetch_add(size, std::memory_order_relaxed);
+  }
+
+  bool isCountingAllocations()
+  {
+    return REGOTH_COUNT_ALLOCATIONS != 0;
+  }
+
+  AllocationCount allocationsOfThisThread()
+  {
+    AllocationCount count;
+    count.numAllocations = s_ThreadNumAllocations;
+    count.bytes          = s_ThreadBytes;
+
+    return count;
+  }
+
+  AllocationCount allocationsOfAllThreads()
+  {
+    AllocationCount count;
+    count.numAllocations = s_NumAllocations.load(std::memory_order_relaxed) +
+                           bs::MemoryCounter::getNumAllocs();
+    count.bytes = s_Bytes.load(std::memory_order_relaxed);
+
+    return count;
+  }
+
+  void FrameMonitor::setEnabled(bool enabled)
+  {
+    mIsEnabled = enabled;
+
+    // The frame running right now was only partly seen
+    mHasFrameStarted = false;
+  }
+
+  void FrameMonitor::onFrameStarted()
+  {
+    if (gProfiler().isEnabled())
+    {
+      gProfiler().endFrame();
+    }
+
+    if (!mIsEnabled) return;
+
+    auto now                    = std::chrono::steady_clock::now();
+    AllocationCount allocations = allocationsOfAllThreads();
+
+    if (mHasFrameStarted)
+    {
+      mCurrentFrame.milliseconds =
+          std::chrono::duration<float, std::milli>(now - mFrameStart).count();
+      mCurrentFrame.allocations = allocations - mAllocationsAtFrameStart;
+
+      mNumFrames += 1;
+      mTotalAllocations.numAllocations += mCurrentFrame.allocations.numAllocations;
+      mTotalAllocations.bytes += mCurrentFrame.allocations.bytes;
+      mMostAllocationsInAFrame =
+          std::max(mMostAllocationsInAFrame, mCurrentFrame.allocations.numAllocations);
+      mLongestFrameMs = std::max(mLongestFrameMs, mCurrentFrame.milliseconds);
+
+      if (mCurrentFrame.allocations.numAllocations == 0)
+      {
+        mNumAllocationFreeFrames += 1;
+      }
+
+      if (mCurrentFrame.milliseconds > mHitchThresholdMs)
+      {
+        Hitch hitch;
+        hitch.stats = mCurrentFrame;
+
+        // The profiler's frame has just ended as well, so these are the scopes of this frame
+        if (gProfiler().isEnabled())
+        {
+          hitch.scopes = gProfiler().lastFrameTotals();
+
+          if (hitch.scopes.size() > MAX_SCOPES_PER_HITCH)
+          {
+            hitch.scopes.resize(MAX_SCOPES_PER_HITCH);
+          }
+        }
+
+        if (mLogsHitches) logHitch(hitch);
+
+        if (mHitches.size() >= MAX_HITCHES_KEPT)
+        {
+          mHitches.erase(mHitches.begin());
+        }
+
+        mHitches.push_back(std::move(hitch));
+        mNumHitches += 1;
+      }
+
+      std::swap(mLastFrame, mCurrentFrame);
+    }
+
+    mHasFrameStarted         = true;
+    mFrameStart              = now;
+    mAllocationsAtFrameStart = allocations;
+
+    mCurrentFrame.frame = mNumFrames;
+    mCurrentFrame.phases.clear();
+  }
+
+  void FrameMonitor::recordPhase(const char* name, bs::UINT64 nanoseconds,
+                                 const AllocationCount& allocations)
+  {
+    auto it = std::find_if(mCurrentFrame.phases.begin(), mCurrentFrame.phases.end(),
+                           [name](const PhaseStats& phase) { return phase.name == name; });
+
+    if (it == mCurrentFrame.phases.end())
+    {
+      if (mCurrentFrame.phases.size() >= MAX_PHASES) return;
+
+      mCurrentFrame.phases.emplace_back();
+      it = mCurrentFrame.phases.end() - 1;
+
+      it->name = name;
+    }
+
+    it->numRuns += 1;
+    it->nanoseconds += nanoseconds;
+    it->allocations.numAllocations += allocations.numAllocations;
+    it->allocations.bytes += allocations.bytes;
+  }
+
+  bs::String FrameMonitor::reportText() const
+  {
+    if (!mIsEnabled) return "";
+
+    bs::String text =
+        bs::StringUtil::format("Allocations: {0} ({1} KiB), {2} of {3} frames without\n",
+                               mLastFrame.allocations.numAllocations,
+                               mLastFrame.allocations.bytes / 1024, mNumAllocationFreeFrames,
+                               mNumFrames);
+
+    for (const PhaseStats& phase : mLastFrame.phases)
+    {
+      text += bs::StringUtil::format("  {0}: {1} ({2} KiB)\n", phase.name,
+                                     phase.allocations.numAllocations,
+                                     phase.allocations.bytes / 1024);
+    }
+
+    text += bs::StringUtil::format("Hitches over {0} ms: {1}\n", mHitchThresholdMs, mNumHitches);
+
+    if (!mHitches.empty())
+    {
+      const Hitch& hitch = mHitches.back();
+
+      text += bs::StringUtil::format("  Last: frame {0}, {1} ms\n", hitch.stats.frame,
+                                     hitch.stats.milliseconds);
+
+      for (const Profiler::ScopeTotal& scope : hitch.scopes)
+      {
+        text += bs::StringUtil::format("    {0}: {1} ms\n", scope.name,
+                                       scope.nanoseconds / 1000000.0);
+      }
+    }
+
+    return text;
+  }
+
+  void FrameMonitor::logHitch(const Hitch& hitch) const
+  {
+    bs::String scopes;
+
+    for (const Profiler::ScopeTotal& scope : hitch.scopes)
+    {
+      scopes +=
+          bs::StringUtil::format(", {0} {1} ms", scope.name, scope.nanoseconds / 1000000.0);
+    }
+
+    REGOTH_LOG(Warning, Uncategorized,
+               "[FrameMonitor] Hitch in frame {0}: {1} ms, {2} allocations{3}", hitch.stats.frame,
+               hitch.stats.milliseconds, hitch.stats.allocations.numAllocations, scopes);
+  }
+
+  void FrameMonitor::logSummary() const
+  {
+    if (!mIsEnabled || mNumFrames == 0) return;
+
+    if (!isCountingAllocations())
+    {
+      REGOTH_LOG(Info, Uncategorized,
+                 "[FrameMonitor] Built without REGOTH_COUNT_ALLOCATIONS, only allocations of "
+                 "bs:f are counted");
+    }
+
+    REGOTH_LOG(Info, Uncategorized,
+               "[FrameMonitor] {0} frames, {1} without allocations, {2} allocations ({3} KiB) "
+               "per frame on average, at most {4}",
+               mNumFrames, mNumAllocationFreeFrames,
+               (double)mTotalAllocations.numAllocations / mNumFrames,
+               (double)mTotalAllocations.bytes / mNumFrames / 1024.0, mMostAllocationsInAFrame);
+
+    REGOTH_LOG(Info, Uncategorized,
+               "[FrameMonitor] {0} hitches over {1} ms, the longest frame took {2} ms",
+               mNumHitches, mHitchThresholdMs, mLongestFrameMs);
+
+    for (const Hitch& hitch : mHitches)
+    {
+      logHitch(hitch);
+    }
+  }
+
+  FrameMonitor& gFrameMonitor()
+  {
+    static FrameMonitor monitor;
+    return monitor;
+  }
+}  // namespace REGoth
+
+#if REGOTH_COUNT_ALLOCATIONS
+
+// Replacing the global allocation functions in the same translation unit as the counters
+// makes sure they are linked whenever the counters are used.
+
+void* operator new(size_t size)
+{
+  REGoth::countAllocation(size);
+
+  if (void* p = std::malloc(size ? size : 1)) return p;
+
+  throw std::bad_alloc();
+}
+
+void* operator new[](size_t size)
+{
+  return operator new(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+  REGoth::countAllocation(size);
+
+  return std::malloc(size ? size : 1);
+}
+
+void* operator new[](size_t size, const std::nothrow_t& nothrow) noexcept
+{
+  return operator new(size, nothrow);
+}
+
+void operator delete(void* p) noexcept
+{
+  std::free(p);
+}
+
+void operator delete[](void* p) noexcept
+{
+  std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+  std::free(p);
+}
+
+void operator delete[](void* p, size_t) noexcept
+{
+  std::free(p);
+}
+
+void operator delete(void* p, const std::nothrow_t&) noexcept
+{
+  std::free(p);
+}
+
+void operator delete[](void* p, const std::nothrow_t&) noexcept
+{
+  std::free(p);
+}
+
+#endif
@@ -0,0 +1,255 @@
+/**\file
+ */
+#pragma once
+#include <BsPrerequisites.h>
+#include <chrono>
+#include <core/Profiling.hpp>
+
+namespace REGoth
+{
+  /**
+   * Number and size of heap allocations.
+   */
+  struct AllocationCount
+  {
+    bs::UINT64 numAllocations = 0;
+
+    /** Requested bytes. Not known for allocations only counted by bs:f. */
+    bs::UINT64 bytes = 0;
+
+    AllocationCount operator-(const AllocationCount& other) const
+    {
+      AllocationCount result;
+      result.numAllocations = numAllocations - other.numAllocations;
+      result.bytes          = bytes - other.bytes;
+
+      return result;
+    }
+  };
+
+  /**
+   * @return Whether the global `operator new` counts allocations, which is the case if built
+   *         with `REGOTH_COUNT_ALLOCATIONS`. Otherwise only what bs:f allocates via
+   *         `bs_alloc` is counted, as far as bs:f has been built with profiling.
+   */
+  bool isCountingAllocations();
+
+  /**
+   * @return Allocations of the calling thread via `operator new` since it was started.
+   */
+  AllocationCount allocationsOfThisThread();
+
+  /**
+   * @return Allocations of all threads via `operator new` and `bs_alloc` since the start.
+   */
+  AllocationCount allocationsOfAllThreads();
+
+  /**
+   * Counts heap allocations per frame and per phase of the frame and flags frames taking
+   * longer than a threshold, so allocation-free frames and hitches can be worked towards.
+   *
+   * A frame is the time from one onFrameStarted() to the next. Phases are the parts of a
+   * frame marked via REGOTH_FRAME_PHASE(), e.g. the phases of GameWorld::fixedUpdate(). Only
+   * allocations of the main thread are counted per phase, everything else counts towards the
+   * frame only.
+   *
+   * For a frame taking longer than the hitch threshold, the scopes recorded by gProfiler()
+   * during that frame are kept, so it's known what was going on. The last few hitches are
+   * shown by the profiler overlay, see UIProfilerOverlay, and logged on exit together with a
+   * summary, see logSummary(). Without a UI, hitches can also be logged right away, see
+   * setLogsHitches().
+   *
+   * Off by default and turned on via `--frame-monitor`, see EngineConfig::isMonitoringFrames.
+   * Only to be used from the main thread. There is one global instance, see gFrameMonitor().
+   */
+  class FrameMonitor
+  {
+  public:
+    /** Phases counted per frame at most, any others count towards the frame only */
+    static constexpr bs::UINT32 MAX_PHASES = 16;
+
+    /** Hitches kept at most, older ones are dropped */
+    static constexpr bs::UINT32 MAX_HITCHES_KEPT = 32;
+
+    /** Most expensive scopes kept per hitch */
+    static constexpr bs::UINT32 MAX_SCOPES_PER_HITCH = 8;
+
+    /** Default for setHitchThreshold(), two frames at 60 Hz */
+    static constexpr float DEFAULT_HITCH_THRESHOLD_MS = 33.3f;
+
+    /**
+     * What happened during a single phase of a frame. A phase may run more than once per
+     * frame, e.g. if there have been several fixed updates.
+     */
+    struct PhaseStats
+    {
+      const char* name       = nullptr;
+      bs::UINT32 numRuns     = 0;
+      bs::UINT64 nanoseconds = 0;
+      AllocationCount allocations;
+    };
+
+    struct FrameStats
+    {
+      bs::UINT64 frame   = 0;
+      float milliseconds = 0.0f;
+      AllocationCount allocations;
+
+      /** Phases run during the frame, in the order they first ran */
+      bs::Vector<PhaseStats> phases;
+    };
+
+    /**
+     * A frame which took longer than the threshold.
+     */
+    struct Hitch
+    {
+      FrameStats stats;
+
+      /** Most expensive scopes of the frame, empty if gProfiler() is off */
+      bs::Vector<Profiler::ScopeTotal> scopes;
+    };
+
+    void setEnabled(bool enabled);
+
+    bool isEnabled() const
+    {
+      return mIsEnabled;
+    }
+
+    /**
+     * Frames taking longer than this many milliseconds are treated as hitches.
+     */
+    void setHitchThreshold(float milliseconds)
+    {
+      mHitchThresholdMs = milliseconds;
+    }
+
+    /**
+     * Whether to log every hitch as warning once it is detected, e.g. when running headless.
+     */
+    void setLogsHitches(bool logsHitches)
+    {
+      mLogsHitches = logsHitches;
+    }
+
+    /**
+     * Ends the last frame and starts a new one. Also ends the frame of gProfiler(), if it is
+     * enabled. To be called once per frame.
+     */
+    void onFrameStarted();
+
+    /**
+     * Adds a run of the given phase to the current frame, see FramePhase.
+     *
+     * @param  name  Name of the phase. Must stay valid for as long as the monitor.
+     */
+    void recordPhase(const char* name, bs::UINT64 nanoseconds,
+                     const AllocationCount& allocations);
+
+    /**
+     * @return What happened during the last frame which has ended.
+     */
+    const FrameStats& lastFrame() const
+    {
+      return mLastFrame;
+    }
+
+    /**
+     * @return The last hitches, the oldest first.
+     */
+    const bs::Vector<Hitch>& hitches() const
+    {
+      return mHitches;
+    }
+
+    /**
+     * @return Allocations of the last frame and its phases and the last hitch, as shown by
+     *         the profiler overlay.
+     */
+    bs::String reportText() const;
+
+    /**
+     * Logs how many allocations the frames did and all hitches kept.
+     */
+    void logSummary() const;
+
+  private:
+    void logHitch(const Hitch& hitch) const;
+
+    bool mIsEnabled         = false;
+    bool mLogsHitches       = false;
+    float mHitchThresholdMs = DEFAULT_HITCH_THRESHOLD_MS;
+
+    bool mHasFrameStarted = false;
+    std::chrono::steady_clock::time_point mFrameStart;
+    AllocationCount mAllocationsAtFrameStart;
+    FrameStats mCurrentFrame;
+    FrameStats mLastFrame;
+
+    bs::Vector<Hitch> mHitches;
+
+    /** Totals over all frames ended so far */
+    bs::UINT64 mNumFrames               = 0;
+    bs::UINT64 mNumAllocationFreeFrames = 0;
+    bs::UINT64 mNumHitches              = 0;
+    bs::UINT64 mMostAllocationsInAFrame = 0;
+    AllocationCount mTotalAllocations;
+    float mLongestFrameMs = 0.0f;
+  };
+
+  /**
+   * @return The monitor REGOTH_FRAME_PHASE() records to.
+   */
+  FrameMonitor& gFrameMonitor();
+
+  /**
+   * Records the time and the allocations of the calling thread from its construction to its
+   * destruction as a phase of the current frame, if gFrameMonitor() is enabled at
+   * construction. See REGOTH_FRAME_PHASE().
+   */
+  class FramePhase
+  {
+  public:
+    FramePhase(const char* name)
+        : mName(name)
+        , mIsRecording(gFrameMonitor().isEnabled())
+    {
+      if (mIsRecording)
+      {
+        mAllocationsAtStart = allocationsOfThisThread();
+        mStart              = std::chrono::steady_clock::now();
+      }
+    }
+
+    ~FramePhase()
+    {
+      if (mIsRecording)
+      {
+        auto duration = std::chrono::steady_clock::now() - mStart;
+
+        gFrameMonitor().recordPhase(
+            mName,
+            (bs::UINT64)std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count(),
+            allocationsOfThisThread() - mAllocationsAtStart);
+      }
+    }
+
+    FramePhase(const FramePhase&) = delete;
+    FramePhase& operator=(const FramePhase&) = delete;
+
+  private:
+    const char* mName;
+    bool mIsRecording;
+    std::chrono::steady_clock::time_point mStart;
+    AllocationCount mAllocationsAtStart;
+  };
+}  // namespace REGoth
+
+/**
+ * Marks the rest of the current scope as phase of the frame with the given name, which has to
+ * be a string literal. See FrameMonitor. Also records it as scope to gProfiler().
+ */
+#define REGOTH_FRAME_PHASE(name)                                                      \
+  REGOTH_PROFILE_SCOPE(name);                                                         \
+  ::REGoth::FramePhase REGOTH_PROFILE_CONCAT(regothFramePhase, __LINE__)(name)
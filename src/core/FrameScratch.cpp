@@ -0,0 +1,63 @@
+#include "FrameScratch.hpp"
+#include <algorithm>
+#include <core/MemoryAccounting.hpp>
+
+namespace REGoth
+{
+  constexpr size_t FrameScratch::CHUNK_SIZE;
+
+  FrameScratch::~FrameScratch()
+  {
+    for (const Chunk& chunk : mChunks)
+    {
+      gMemoryAccounting().untrack(MemoryTag::FrameScratch, chunk.size);
+    }
+  }
+
+  void* FrameScratch::allocate(size_t bytes, size_t alignment)
+  {
+    for (;;)
+    {
+      while (mCurrentChunk < mChunks.size())
+      {
+        Chunk& chunk = mChunks[mCurrentChunk];
+
+        // Chunks start at the alignment of `new`, so aligning the offset is enough
+        size_t start = (mOffset + alignment - 1) & ~(alignment - 1);
+
+        if (start + bytes <= chunk.size)
+        {
+          mOffset = start + bytes;
+          mBytesUsed += bytes;
+
+          return chunk.data.get() + start;
+        }
+
+        mCurrentChunk += 1;
+        mOffset = 0;
+      }
+
+      Chunk chunk;
+      chunk.size = std::max(CHUNK_SIZE, bytes + alignment);
+      chunk.data.reset(new bs::UINT8[chunk.size]);
+
+      gMemoryAccounting().track(MemoryTag::FrameScratch, chunk.size);
+
+      mChunks.push_back(std::move(chunk));
+    }
+  }
+
+  void FrameScratch::endFrame()
+  {
+    mCurrentChunk = 0;
+    mOffset       = 0;
+    mBytesUsed    = 0;
+    mOwnerThread  = std::this_thread::get_id();
+  }
+
+  FrameScratch& gFrameScratch()
+  {
+    static FrameScratch scratch;
+    return scratch;
+  }
+}  // namespace REGoth
@@ -0,0 +1,151 @@
+/**\file
+ */
+#pragma once
+#include <BsPrerequisites.h>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace REGoth
+{
+  /**
+   * Linear allocator for data which is only needed until the end of the frame, like the
+   * results of the queries the game logic makes every frame. Allocating is bumping an offset
+   * into a chunk of memory, freeing does nothing. Everything is released at once by
+   * endFrame(), which the game world calls once per frame, see GameWorld::update().
+   *
+   * Chunks are kept across frames, so once the largest frame has been seen no more memory is
+   * taken from the heap. They are counted via gMemoryAccounting().
+   *
+   * Only the thread calling endFrame() may allocate from it, see ScratchAllocator for how
+   * other threads are handled. There is one global instance, see gFrameScratch().
+   */
+  class FrameScratch
+  {
+  public:
+    /** Size of a chunk. Larger allocations get a chunk of their own */
+    static constexpr size_t CHUNK_SIZE = 256 * 1024;
+
+    FrameScratch() = default;
+    ~FrameScratch();
+
+    FrameScratch(const FrameScratch&) = delete;
+    FrameScratch& operator=(const FrameScratch&) = delete;
+
+    /**
+     * @return Memory valid until the next endFrame(). Alignments up to the one of
+     *         `std::max_align_t` are supported.
+     */
+    void* allocate(size_t bytes, size_t alignment);
+
+    /**
+     * Makes all memory handed out so far available again. Anything allocated before must not
+     * be used anymore. Also makes the calling thread the one allowed to allocate.
+     */
+    void endFrame();
+
+    /**
+     * @return Whether the calling thread may allocate, see endFrame().
+     */
+    bool isOwnerThread() const
+    {
+      return mOwnerThread == std::this_thread::get_id();
+    }
+
+    /**
+     * @return Bytes handed out since the last endFrame().
+     */
+    size_t bytesUsed() const
+    {
+      return mBytesUsed;
+    }
+
+  private:
+    struct Chunk
+    {
+      std::unique_ptr<bs::UINT8[]> data;
+      size_t size = 0;
+    };
+
+    bs::Vector<Chunk> mChunks;
+    size_t mCurrentChunk = 0;
+    size_t mOffset       = 0;
+    size_t mBytesUsed    = 0;
+    std::thread::id mOwnerThread;
+  };
+
+  /**
+   * @return The frame scratch the game logic allocates its per-frame results from.
+   */
+  FrameScratch& gFrameScratch();
+
+  /**
+   * Allocator for standard containers taking memory from a FrameScratch. Allocators without
+   * one use the heap, which is what makeScratchVector() hands out on threads other than the
+   * owner of the scratch, so results can also be asked for from worker threads.
+   */
+  template <typename T>
+  struct ScratchAllocator
+  {
+    using value_type = T;
+
+    ScratchAllocator() = default;
+
+    explicit ScratchAllocator(FrameScratch* frameScratch)
+        : scratch(frameScratch)
+    {
+    }
+
+    template <typename U>
+    ScratchAllocator(const ScratchAllocator<U>& other)
+        : scratch(other.scratch)
+    {
+    }
+
+    T* allocate(size_t n)
+    {
+      if (!scratch) return std::allocator<T>().allocate(n);
+
+      return static_cast<T*>(scratch->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T* data, size_t n)
+    {
+      // Frame memory is released as a whole
+      if (!scratch) std::allocator<T>().deallocate(data, n);
+    }
+
+    FrameScratch* scratch = nullptr;
+  };
+
+  template <typename T, typename U>
+  bool operator==(const ScratchAllocator<T>& a, const ScratchAllocator<U>& b)
+  {
+    return a.scratch == b.scratch;
+  }
+
+  template <typename T, typename U>
+  bool operator!=(const ScratchAllocator<T>& a, const ScratchAllocator<U>& b)
+  {
+    return a.scratch != b.scratch;
+  }
+
+  /**
+   * Vector living in frame memory, as returned by queries of the game logic. Must not be kept
+   * beyond the current update, copy it into a `bs::Vector` for that.
+   */
+  template <typename T>
+  using ScratchVector = std::vector<T, ScratchAllocator<T>>;
+
+  /**
+   * @return Empty vector in the memory of gFrameScratch(), or on the heap if the calling
+   *         thread may not allocate from it.
+   */
+  template <typename T>
+  ScratchVector<T> makeScratchVector()
+  {
+    FrameScratch& scratch = gFrameScratch();
+
+    return ScratchVector<T>(ScratchAllocator<T>(scratch.isOwnerThread() ? &scratch : nullptr));
+  }
+}  // namespace REGoth
@@ -2,10 +2,10 @@
 
 #include <Components/BsCCamera.h>
 #include <Image/BsColor.h>
-#include <Scene/BsPrefab.h>
 
 #include <components/Character.hpp>
 #include <components/CharacterKeyboardInput.hpp>
+#include <components/GameClock.hpp>
 #include <components/GameWorld.hpp>
 #include <components/GameplayUI.hpp>
 #include <components/Sky.hpp>
@@ -21,34 +21,32 @@ void Gothic1Game::setupMainCamera()
 
 void Gothic1Game::setupScene()
 {
-  const bs::String WORLD    = "WORLD.ZEN";
-  const bs::String SAVEGAME = "WorldViewer-" + WORLD;
+  const bs::String WORLD = "WORLD.ZEN";
 
-  bs::HPrefab worldPrefab = GameWorld::load(SAVEGAME);
-  HGameWorld world;
+  HGameWorld world = GameWorld::loadOrImportZEN(
+      WORLD, GameWorld::startingSaveName(WORLD), [](HGameWorld imported) {
+        HCharacter hero = imported->insertCharacter("PC_HERO", WORLD_STARTPOINT);
+        hero->useAsHero();
+        hero->SO()->addComponent<CharacterKeyboardInput>(imported);
 
-  if (!worldPrefab)
-  {
-    world = GameWorld::importZEN(WORLD);
-
-    HCharacter hero = world->insertCharacter("PC_HERO", WORLD_STARTPOINT);
-    hero->useAsHero();
-    hero->SO()->addComponent<CharacterKeyboardInput>(world);
+        imported->runInitScripts();
+      });
 
-    world->runInitScripts();
+  world->scriptStateScheduler().setSettings(config()->scriptStateScheduling);
+  world->gameclock()->setTimeScale(config()->timeScale);
 
-    world->save(SAVEGAME);
+  // Nothing to draw the sky and the dialogue window onto when headless
+  if (config()->isHeadless)
+  {
+    world->scriptVM().setDialogueUIEnabled(false);
   }
   else
   {
-    bs::HSceneObject worldSO = worldPrefab->instantiate();
-
-    world = worldSO->getComponent<GameWorld>();
+    const bs::Color skyColor = bs::Color{114, 93, 82} / 255.0f;
+    world->SO()->addComponent<Sky>(world, Sky::RenderMode::Plane, skyColor,
+                                   mEngineContent->loadShaders().sky);
   }
 
-  const bs::Color skyColor = bs::Color{114, 93, 82} / 255.0f;
-  world->SO()->addComponent<Sky>(world, Sky::RenderMode::Plane, skyColor);
-
   bs::HSceneObject heroSO = world->SO()->findChild("PC_HERO");
 
   if (!heroSO)
@@ -60,5 +58,8 @@ void Gothic1Game::setupScene()
 
   mThirdPersonCamera->follow(hero);
 
-  GameplayUI::createGlobal(mMainCamera);
+  if (!config()->isHeadless)
+  {
+    GameplayUI::createGlobal(mMainCamera);
+  }
 }
@@ -0,0 +1,228 @@
+#include "InputReplay.hpp"
+#include <BsApplication.h>
+#include <FileSystem/BsDataStream.h>
+#include <FileSystem/BsFileSystem.h>
+#include <algorithm>
+#include <exception/Throw.hpp>
+#include <log/logging.hpp>
+#include <sstream>
+#include <string>
+
+namespace REGoth
+{
+  constexpr bs::UINT32 InputReplay::VERSION;
+  constexpr bs::UINT32 InputReplay::DEFAULT_RANDOM_SEED;
+
+  /** First word of every recording */
+  static const char* const REPLAY_MAGIC = "REGothReplay";
+
+  void InputReplay::startRecording(const bs::Path& path)
+  {
+    mMode = Mode::Recording;
+    mPath = path;
+
+    mRuns.clear();
+
+    REGOTH_LOG(Info, Uncategorized, "[InputReplay] Recording to {0}, seed {1}", path.toString(),
+               mRandomSeed);
+  }
+
+  void InputReplay::startPlayback(const bs::Path& path, const bs::Path& statsPath)
+  {
+    bs::SPtr<bs::DataStream> stream = bs::FileSystem::openFile(path);
+
+    if (!stream)
+    {
+      REGOTH_THROW(InvalidParametersException, "Cannot open replay " + path.toString());
+    }
+
+    // Text format: magic and version, the seed, then one run per line, see writeRecording()
+    std::istringstream in(stream->getAsString().c_str());
+    std::string magic;
+    bs::UINT32 version = 0;
+    std::string seedKey;
+    bs::UINT32 seed = 0;
+
+    in >> magic >> version >> seedKey >> seed;
+
+    if (!in || magic != REPLAY_MAGIC || version != VERSION || seedKey != "seed")
+    {
+      REGOTH_THROW(InvalidParametersException,
+                   "Not a replay of version " + bs::toString(VERSION) + ": " + path.toString());
+    }
+
+    mRuns.clear();
+
+    ReplayTick tick;
+    bs::UINT32 repeat;
+
+    while (in >> std::hex >> tick.held >> tick.pressed >> std::dec >> repeat)
+    {
+      mRuns.emplace_back(tick, repeat);
+    }
+
+    mMode           = Mode::Playback;
+    mPath           = path;
+    mStatsPath      = statsPath;
+    mRandomSeed     = seed;
+    mPlaybackRun    = 0;
+    mPlaybackRepeat = 0;
+
+    REGOTH_LOG(Info, Uncategorized, "[InputReplay] Playing {0}, {1} runs, seed {2}",
+               path.toString(), mRuns.size(), seed);
+  }
+
+  ReplayTick InputReplay::tick(const ReplayTick& live)
+  {
+    switch (mMode)
+    {
+      case Mode::Recording:
+        if (!mRuns.empty() && mRuns.back().first == live)
+        {
+          mRuns.back().second += 1;
+        }
+        else
+        {
+          mRuns.emplace_back(live, 1);
+        }
+        return live;
+
+      case Mode::Playback:
+        while (mPlaybackRun < mRuns.size() && mPlaybackRepeat >= mRuns[mPlaybackRun].second)
+        {
+          mPlaybackRun += 1;
+          mPlaybackRepeat = 0;
+        }
+
+        if (mPlaybackRun >= mRuns.size())
+        {
+          // Everything has been played
+          finish();
+          return ReplayTick();
+        }
+
+        mPlaybackRepeat += 1;
+        return mRuns[mPlaybackRun].first;
+
+      case Mode::Live:
+      default:
+        return live;
+    }
+  }
+
+  void InputReplay::onFrame(float frameDeltaSeconds)
+  {
+    if (mMode != Mode::Playback || mIsFinished) return;
+
+    mFrameTimesMs.push_back(frameDeltaSeconds * 1000.0f);
+  }
+
+  void InputReplay::finish()
+  {
+    if (mIsFinished) return;
+
+    mIsFinished = true;
+
+    if (mMode == Mode::Recording)
+    {
+      writeRecording();
+    }
+    else if (mMode == Mode::Playback)
+    {
+      reportFrameTimes();
+
+      bs::gApplication().quitRequested();
+    }
+  }
+
+  bool InputReplay::writeRecording() const
+  {
+    bs::SPtr<bs::DataStream> stream = bs::FileSystem::createAndOpenFile(mPath);
+
+    if (!stream)
+    {
+      REGOTH_LOG(Error, Uncategorized, "[InputReplay] Failed to write recording to {0}",
+                 mPath.toString());
+      return false;
+    }
+
+    std::ostringstream out;
+    out << REPLAY_MAGIC << " " << VERSION << "\n";
+    out << "seed " << mRandomSeed << "\n";
+
+    for (const auto& run : mRuns)
+    {
+      out << std::hex << run.first.held << " " << run.first.pressed << " " << std::dec
+          << run.second << "\n";
+    }
+
+    std::string text = out.str();
+
+    stream->write(text.data(), text.size());
+    stream->close();
+
+    REGOTH_LOG(Info, Uncategorized, "[InputReplay] Wrote {0} runs to {1}", mRuns.size(),
+               mPath.toString());
+
+    return true;
+  }
+
+  void InputReplay::reportFrameTimes() const
+  {
+    if (mFrameTimesMs.empty()) return;
+
+    bs::Vector<float> sorted = mFrameTimesMs;
+    std::sort(sorted.begin(), sorted.end());
+
+    auto percentile = [&](float p) {
+      size_t index = (size_t)(p * (float)(sorted.size() - 1) + 0.5f);
+      return sorted[index];
+    };
+
+    double totalMs = 0.0;
+
+    for (float ms : sorted)
+    {
+      totalMs += ms;
+    }
+
+    double meanMs = totalMs / (double)sorted.size();
+
+    REGOTH_LOG(Info, Uncategorized,
+               "[InputReplay] {0} frames, mean {1} ms, median {2} ms, 95th {3} ms, 99th {4} ms, "
+               "max {5} ms",
+               sorted.size(), meanMs, percentile(0.5f), percentile(0.95f), percentile(0.99f),
+               sorted.back());
+
+    if (mStatsPath.isEmpty()) return;
+
+    bs::SPtr<bs::DataStream> stream = bs::FileSystem::createAndOpenFile(mStatsPath);
+
+    if (!stream)
+    {
+      REGOTH_LOG(Error, Uncategorized, "[InputReplay] Failed to write frame times to {0}",
+                 mStatsPath.toString());
+      return;
+    }
+
+    std::ostringstream json;
+    json << "{\"replay\": \"" << mPath.toString().c_str() << "\", \"frames\": " << sorted.size()
+         << ", \"totalMs\": " << totalMs << ", \"meanMs\": " << meanMs
+         << ", \"medianMs\": " << percentile(0.5f) << ", \"p95Ms\": " << percentile(0.95f)
+         << ", \"p99Ms\": " << percentile(0.99f) << ", \"maxMs\": " << sorted.back() << "}\n";
+
+    std::string text = json.str();
+
+    stream->write(text.data(), text.size());
+    stream->close();
+
+    REGOTH_LOG(Info, Uncategorized, "[InputReplay] Wrote frame times to {0}",
+               mStatsPath.toString());
+  }
+
+  InputReplay& gInputReplay()
+  {
+    static InputReplay replay;
+    return replay;
+  }
+}  // namespace REGoth
@@ -0,0 +1,184 @@
+/**\file
+ */
+#pragma once
+#include <BsPrerequisites.h>
+#include <utility>
+
+namespace REGoth
+{
+  /**
+   * Buttons of the hero which are recorded, see InputReplay.
+   */
+  enum class ReplayButton
+  {
+    MoveForward,
+    MoveBack,
+    TurnLeft,
+    TurnRight,
+    StrafeLeft,
+    StrafeRight,
+    FastMove,
+    ToggleWalking,
+    ToggleSneaking,
+    ToggleMeleeWeapon,
+    Jump,
+    Action,
+    QuickSave,
+    ReloadScripts,
+    Count,
+  };
+
+  /**
+   * Buttons of the hero during a single fixed update, one bit per ReplayButton.
+   */
+  struct ReplayTick
+  {
+    /** Buttons held down during the tick */
+    bs::UINT32 held = 0;
+
+    /** Buttons pressed since the last tick */
+    bs::UINT32 pressed = 0;
+
+    bool isHeld(ReplayButton button) const
+    {
+      return (held & bit(button)) != 0;
+    }
+
+    bool wasPressed(ReplayButton button) const
+    {
+      return (pressed & bit(button)) != 0;
+    }
+
+    static bs::UINT32 bit(ReplayButton button)
+    {
+      return 1u << (bs::UINT32)button;
+    }
+
+    bool operator==(const ReplayTick& other) const
+    {
+      return held == other.held && pressed == other.pressed;
+    }
+  };
+
+  /**
+   * Records the input of the hero and plays it back, so the same session can be run again,
+   * e.g. to compare the frame times of two builds along the same route through a world.
+   *
+   * Input is recorded per fixed update, see CharacterKeyboardInput, which is what moves the
+   * hero. Buttons pressed during a frame count towards the next fixed update. Together with
+   * the seed of `Hlp_Random`, see randomSeed(), this makes the hero do the same on playback.
+   * Whatever depends on the frame time, like the ingame clock or animations, may still drift
+   * a little between runs with different frame rates.
+   *
+   * On playback, the time of every frame is recorded. Once all recorded input has been
+   * played, statistics of the frame times are logged, optionally written as JSON, and the
+   * application quits.
+   *
+   * There is one global instance, see gInputReplay().
+   */
+  class InputReplay
+  {
+  public:
+    enum class Mode
+    {
+      Live,      /**< Input is used as is and not recorded */
+      Recording, /**< Input is used and recorded, written by finish() */
+      Playback,  /**< Recorded input is used instead of the live one */
+    };
+
+    /**
+     * Version of the recording format. Recordings of other versions can't be played back.
+     */
+    static constexpr bs::UINT32 VERSION = 1;
+
+    /**
+     * Seed of the random numbers of every world, see GameWorld::random(), unless set
+     * otherwise.
+     */
+    static constexpr bs::UINT32 DEFAULT_RANDOM_SEED = 5489;
+
+    /**
+     * Sets the seed of the random numbers of new worlds for live sessions and recordings.
+     */
+    void setRandomSeed(bs::UINT32 seed)
+    {
+      mRandomSeed = seed;
+    }
+
+    /**
+     * @return Seed to use for `Hlp_Random`. On playback, the seed of the recording.
+     */
+    bs::UINT32 randomSeed() const
+    {
+      return mRandomSeed;
+    }
+
+    Mode mode() const
+    {
+      return mMode;
+    }
+
+    /**
+     * Starts recording. The recording is written to the given file by finish().
+     */
+    void startRecording(const bs::Path& path);
+
+    /**
+     * Loads the given recording to be played back. Throws if it can't be read.
+     *
+     * @param  statsPath  Where to write the statistics of the frame times to once the
+     *                    playback is done. Empty to only log them.
+     */
+    void startPlayback(const bs::Path& path, const bs::Path& statsPath);
+
+    /**
+     * To be called once per fixed update with the buttons of the player.
+     *
+     * @return The buttons to act on: the recorded ones on playback, the given ones otherwise.
+     */
+    ReplayTick tick(const ReplayTick& live);
+
+    /**
+     * To be called once per frame, to record the frame times of a playback.
+     */
+    void onFrame(float frameDeltaSeconds);
+
+    /**
+     * Writes the recording or the frame time statistics of a playback, whichever is going
+     * on. Does nothing after the first call.
+     */
+    void finish();
+
+  private:
+    /**
+     * Logs and writes the statistics of the recorded frame times.
+     */
+    void reportFrameTimes() const;
+
+    bool writeRecording() const;
+
+    Mode mMode             = Mode::Live;
+    bs::UINT32 mRandomSeed = DEFAULT_RANDOM_SEED;
+    bs::Path mPath;
+    bs::Path mStatsPath;
+
+    /**
+     * Recorded ticks, run length encoded: The tick of every run followed by how often it
+     * repeats.
+     */
+    bs::Vector<std::pair<ReplayTick, bs::UINT32>> mRuns;
+
+    /** Run and repetition inside it to be played next */
+    size_t mPlaybackRun        = 0;
+    bs::UINT32 mPlaybackRepeat = 0;
+
+    bs::Vector<float> mFrameTimesMs;
+
+    bool mIsFinished = false;
+  };
+
+  /**
+   * @return The replay CharacterKeyboardInput records to and plays from.
+   */
+  InputReplay& gInputReplay();
+}  // namespace REGoth
@@ -0,0 +1,69 @@
+#include "Jobs.hpp"
+#include <Threading/BsTaskScheduler.h>
+#include <algorithm>
+#include <exception/Throw.hpp>
+
+namespace REGoth
+{
+  namespace Jobs
+  {
+    JobGroup::JobGroup(const bs::String& name)
+        : mName(name)
+    {
+    }
+
+    JobGroup::~JobGroup()
+    {
+      wait();
+    }
+
+    bs::SPtr<bs::Task> JobGroup::run(std::function<void()> work, bs::SPtr<bs::Task> after)
+    {
+      auto task = bs::Task::create(mName, std::move(work), bs::TaskPriority::Normal, after);
+
+      bs::TaskScheduler::instance().addTask(task);
+      mTasks.push_back(task);
+
+      return task;
+    }
+
+    void JobGroup::wait()
+    {
+      for (const auto& task : mTasks)
+      {
+        task->wait();
+      }
+
+      mTasks.clear();
+    }
+
+    bs::UINT32 parallelFor(const bs::String& name, bs::UINT32 count, bs::UINT32 chunkSize,
+                           const std::function<void(bs::UINT32, bs::UINT32)>& work)
+    {
+      if (chunkSize == 0)
+      {
+        REGOTH_THROW(InvalidParametersException, "Chunk size cannot be 0!");
+      }
+
+      if (count == 0) return 0;
+
+      JobGroup group(name);
+
+      for (bs::UINT32 first = chunkSize; first < count; first += chunkSize)
+      {
+        bs::UINT32 last = std::min(first + chunkSize, count);
+
+        group.run([&work, first, last]() { work(first, last); });
+      }
+
+      bs::UINT32 numTasks = group.numPending();
+
+      // The first range, while the workers have the others
+      work(0, std::min(chunkSize, count));
+
+      group.wait();
+
+      return numTasks;
+    }
+  }  // namespace Jobs
+}  // namespace REGoth
@@ -0,0 +1,76 @@
+#pragma once
+#include <BsPrerequisites.h>
+#include <functional>
+
+namespace bs
+{
+  class Task;
+}
+
+namespace REGoth
+{
+  namespace Jobs
+  {
+    /**
+     * Work started on bs:f's task scheduler which is waited for as a whole, e.g. everything
+     * a stage of the frame has handed to the workers. Waits for all of its work when
+     * destroyed, so nothing started by it can outlive data captured by reference.
+     *
+     * Work can depend on other work started before, so simple task graphs can be built.
+     */
+    class JobGroup
+    {
+    public:
+      JobGroup(const bs::String& name);
+      ~JobGroup();
+
+      JobGroup(const JobGroup&) = delete;
+      JobGroup& operator=(const JobGroup&) = delete;
+
+      /**
+       * Starts the given work on a worker thread.
+       *
+       * @param  work   What to do.
+       * @param  after  Work which has to be finished before this one starts, as returned by
+       *                an earlier run(). May be null.
+       *
+       * @return The task doing the work. Can be waited for on its own.
+       */
+      bs::SPtr<bs::Task> run(std::function<void()> work, bs::SPtr<bs::Task> after = nullptr);
+
+      /**
+       * Blocks until all work started so far is done.
+       */
+      void wait();
+
+      /**
+       * @return Number of tasks started via run() since the last wait().
+       */
+      bs::UINT32 numPending() const
+      {
+        return (bs::UINT32)mTasks.size();
+      }
+
+    private:
+      bs::String mName;
+      bs::Vector<bs::SPtr<bs::Task>> mTasks;
+    };
+
+    /**
+     * Calls the given function for consecutive ranges of `[0, count)` with at most `chunkSize`
+     * indices each, spread across bs:f's task scheduler. The first range is done on the
+     * calling thread, which would only be waiting otherwise. Returns once all ranges are done.
+     *
+     * If there is only a single range, no task is started at all.
+     *
+     * @param  name       Name of the tasks, for profiling.
+     * @param  count      Number of indices.
+     * @param  chunkSize  Indices per range. Should be large enough to be worth starting a task.
+     * @param  work       Called with the first index and the index after the last one.
+     *
+     * @return Number of tasks started.
+     */
+    bs::UINT32 parallelFor(const bs::String& name, bs::UINT32 count, bs::UINT32 chunkSize,
+                           const std::function<void(bs::UINT32, bs::UINT32)>& work);
+  }  // namespace Jobs
+}  // namespace REGoth
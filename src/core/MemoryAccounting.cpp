@@ -0,0 +1,98 @@
+#include "MemoryAccounting.hpp"
+#include <FileSystem/BsDataStream.h>
+#include <FileSystem/BsFileSystem.h>
+#include <log/logging.hpp>
+
+namespace REGoth
+{
+  const char* memoryTagName(MemoryTag tag)
+  {
+    switch (tag)
+    {
+      case MemoryTag::ScriptSymbols:
+        return "Script symbols";
+      case MemoryTag::ScriptObjects:
+        return "Script objects";
+      case MemoryTag::EventMessages:
+        return "Event messages";
+      case MemoryTag::Animation:
+        return "Animation";
+      case MemoryTag::VDFS:
+        return "VDFS";
+      case MemoryTag::FrameScratch:
+        return "Frame scratch";
+      default:
+        return "Unknown";
+    }
+  }
+
+  bs::Vector<MemoryAccounting::TagTotal> MemoryAccounting::totals() const
+  {
+    bs::Vector<TagTotal> result;
+
+    for (size_t i = 0; i < (size_t)MemoryTag::Count; i++)
+    {
+      const Counter& c = mCounters[i];
+
+      TagTotal total;
+      total.tag            = (MemoryTag)i;
+      total.bytes          = c.bytes.load(std::memory_order_relaxed);
+      total.peakBytes      = c.peakBytes.load(std::memory_order_relaxed);
+      total.numAllocations = c.numAllocations.load(std::memory_order_relaxed);
+
+      result.push_back(total);
+    }
+
+    return result;
+  }
+
+  bs::String MemoryAccounting::reportText() const
+  {
+    constexpr double MEGABYTE = 1024.0 * 1024.0;
+
+    bs::String text;
+
+    for (const TagTotal& t : totals())
+    {
+      text += bs::StringUtil::format("{0}: {1} MB (peak {2} MB, {3} allocations)\n",
+                                     memoryTagName(t.tag), t.bytes / MEGABYTE,
+                                     t.peakBytes / MEGABYTE, t.numAllocations);
+    }
+
+    // Both stay 0 unless bs:f has been built with profiling
+    text += bs::StringUtil::format("bs:f: {0} allocations, {1} frees\n",
+                                   bs::MemoryCounter::getNumAllocs(),
+                                   bs::MemoryCounter::getNumFrees());
+
+    return text;
+  }
+
+  bool MemoryAccounting::writeReport(const bs::Path& path) const
+  {
+    bs::SPtr<bs::DataStream> stream = bs::FileSystem::createAndOpenFile(path);
+
+    if (!stream)
+    {
+      REGOTH_LOG(Error, Uncategorized, "[MemoryAccounting] Failed to write report to {0}",
+                 path.toString());
+      return false;
+    }
+
+    bs::String text = reportText();
+
+    stream->write(text.data(), text.size());
+    stream->close();
+
+    REGOTH_LOG(Info, Uncategorized, "[MemoryAccounting] Wrote report to {0}", path.toString());
+
+    return true;
+  }
+
+  MemoryAccounting& gMemoryAccounting()
+  {
+    // Never destroyed, as tracked containers of static objects may be freed after it would be
+    static MemoryAccounting* s_instance = new MemoryAccounting();
+
+    return *s_instance;
+  }
+}  // namespace REGoth
@@ -0,0 +1,187 @@
+/**\file
+ */
+#pragma once
+#include <BsPrerequisites.h>
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <vector>
+
+namespace REGoth
+{
+  /**
+   * Subsystems whose memory is accounted for separately, see MemoryAccounting.
+   */
+  enum class MemoryTag
+  {
+    ScriptSymbols, /**< Symbols of the loaded DAT-file, see Scripting::ScriptSymbolStorage */
+    ScriptObjects, /**< Slots and member values of script objects */
+    EventMessages, /**< Pooled event messages, see AI::EventMessagePool */
+    Animation,     /**< Sampled root motion of animation clips, see AnimationTable */
+    VDFS,          /**< Files read into memory instead of viewed inside a mapped package */
+    FrameScratch,  /**< Chunks of the per-frame allocator, see REGoth::FrameScratch */
+    Count,
+  };
+
+  /**
+   * @return Readable name of the given tag.
+   */
+  const char* memoryTagName(MemoryTag tag);
+
+  /**
+   * Keeps count of the memory taken by the subsystems listed in MemoryTag, on any thread.
+   *
+   * Subsystems either allocate their bulk data through a TrackedAllocator or report what they
+   * allocate via track() and untrack() themselves. Only memory allocated that way is counted,
+   * so the totals are a lower bound of what a subsystem takes. Everything bs:f allocates on
+   * its own, like scene objects and resources, is only visible through the allocation counts
+   * of `bs::MemoryCounter`, as far as bs:f has been built with profiling.
+   *
+   * The report is shown by the profiler overlay, see UIProfilerOverlay, and can be written
+   * on exit via `--memory-report`, see EngineConfig::memoryReportPath.
+   *
+   * There is one global instance, see gMemoryAccounting().
+   */
+  class MemoryAccounting
+  {
+  public:
+    /**
+     * What has been counted for a single tag.
+     */
+    struct TagTotal
+    {
+      MemoryTag tag;
+      bs::UINT64 bytes          = 0;
+      bs::UINT64 peakBytes      = 0;
+      bs::UINT64 numAllocations = 0;
+    };
+
+    MemoryAccounting() = default;
+
+    /**
+     * Counts the given bytes as allocated by the given subsystem.
+     */
+    void track(MemoryTag tag, size_t bytes)
+    {
+      Counter& c = mCounters[(size_t)tag];
+
+      bs::UINT64 now  = c.bytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+      bs::UINT64 peak = c.peakBytes.load(std::memory_order_relaxed);
+
+      while (now > peak &&
+             !c.peakBytes.compare_exchange_weak(peak, now, std::memory_order_relaxed))
+      {
+        // Retry with the peak another thread has stored
+      }
+
+      c.numAllocations.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /**
+     * Counts the given bytes as freed by the given subsystem.
+     */
+    void untrack(MemoryTag tag, size_t bytes)
+    {
+      Counter& c = mCounters[(size_t)tag];
+
+      c.bytes.fetch_sub(bytes, std::memory_order_relaxed);
+      c.numAllocations.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    /**
+     * @return What has been counted so far for every tag, in the order of MemoryTag.
+     */
+    bs::Vector<TagTotal> totals() const;
+
+    /**
+     * @return The totals as readable text, one line per tag, followed by the allocation
+     *         counts of bs:f.
+     */
+    bs::String reportText() const;
+
+    /**
+     * Writes reportText() to the given file.
+     *
+     * @return Whether that worked.
+     */
+    bool writeReport(const bs::Path& path) const;
+
+  private:
+    struct Counter
+    {
+      std::atomic<bs::UINT64> bytes          = {0};
+      std::atomic<bs::UINT64> peakBytes      = {0};
+      std::atomic<bs::UINT64> numAllocations = {0};
+    };
+
+    Counter mCounters[(size_t)MemoryTag::Count];
+  };
+
+  /**
+   * @return The instance TrackedAllocator counts to.
+   */
+  MemoryAccounting& gMemoryAccounting();
+
+  /**
+   * Allocator for standard containers, which counts everything it allocates towards the given
+   * tag inside gMemoryAccounting(). Apart from that it allocates like `std::allocator`.
+   */
+  template <typename T, MemoryTag Tag>
+  struct TrackedAllocator
+  {
+    using value_type = T;
+
+    template <typename U>
+    struct rebind
+    {
+      using other = TrackedAllocator<U, Tag>;
+    };
+
+    TrackedAllocator() = default;
+
+    template <typename U>
+    TrackedAllocator(const TrackedAllocator<U, Tag>&)
+    {
+    }
+
+    T* allocate(size_t n)
+    {
+      T* data = std::allocator<T>().allocate(n);
+
+      gMemoryAccounting().track(Tag, n * sizeof(T));
+
+      return data;
+    }
+
+    void deallocate(T* data, size_t n)
+    {
+      gMemoryAccounting().untrack(Tag, n * sizeof(T));
+
+      std::allocator<T>().deallocate(data, n);
+    }
+  };
+
+  template <typename T, typename U, MemoryTag Tag>
+  bool operator==(const TrackedAllocator<T, Tag>&, const TrackedAllocator<U, Tag>&)
+  {
+    return true;
+  }
+
+  template <typename T, typename U, MemoryTag Tag>
+  bool operator!=(const TrackedAllocator<T, Tag>&, const TrackedAllocator<U, Tag>&)
+  {
+    return false;
+  }
+
+  /**
+   * Vector whose memory is counted towards the given tag, see TrackedAllocator.
+   */
+  template <typename T, MemoryTag Tag>
+  using TrackedVector = std::vector<T, TrackedAllocator<T, Tag>>;
+
+  /**
+   * Deque whose memory is counted towards the given tag, see TrackedAllocator.
+   */
+  template <typename T, MemoryTag Tag>
+  using TrackedDeque = std::deque<T, TrackedAllocator<T, Tag>>;
+}  // namespace REGoth
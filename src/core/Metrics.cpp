@@ -0,0 +1,304 @@
+#include "Metrics.hpp"
+#include <FileSystem/BsDataStream.h>
+#include <FileSystem/BsFileSystem.h>
+#include <algorithm>
+#include <core/FrameMonitor.hpp>
+#include <core/MemoryAccounting.hpp>
+#include <cstdio>
+#include <iterator>
+#include <log/logging.hpp>
+
+namespace REGoth
+{
+  constexpr float Metrics::DEFAULT_EXPORT_INTERVAL;
+  constexpr double Metrics::FRAME_TIME_BUCKETS[];
+
+  /**
+   * @return The given value with enough digits to keep byte counts exact, without the noise
+   *         printing all digits of a double gives.
+   */
+  static bs::String formatMetricValue(double value)
+  {
+    char text[32];
+    std::snprintf(text, sizeof(text), "%.15g", value);
+
+    return text;
+  }
+
+  /**
+   * @return The given name as allowed by Prometheus, e.g. `regoth_ai_event_queues_messages`.
+   */
+  static bs::String prometheusName(const bs::String& name)
+  {
+    bs::String result = "regoth_" + name;
+    std::replace(result.begin(), result.end(), '.', '_');
+
+    return result;
+  }
+
+  void Metrics::Histogram::observe(double value)
+  {
+    count += 1;
+    sum += value;
+
+    for (size_t i = 0; i < upperBounds.size(); i++)
+    {
+      if (value <= upperBounds[i]) cumulativeCounts[i] += 1;
+    }
+  }
+
+  void Metrics::enable(const bs::Path& path, float intervalSeconds)
+  {
+    mIsEnabled      = true;
+    mPath           = path;
+    mExportInterval = intervalSeconds;
+    mStart          = Clock::now();
+    mLastExport     = mStart;
+
+    mFrameTimes = Histogram();
+    mFrameTimes.upperBounds.assign(std::begin(FRAME_TIME_BUCKETS), std::end(FRAME_TIME_BUCKETS));
+    mFrameTimes.cumulativeCounts.resize(mFrameTimes.upperBounds.size(), 0);
+
+    REGOTH_LOG(Info, Uncategorized, "[Metrics] Exporting to {0} every {1} seconds",
+               path.toString(), intervalSeconds);
+  }
+
+  void Metrics::addToCounter(const bs::String& name, bs::UINT64 amount)
+  {
+    mCounters[name].total += amount;
+  }
+
+  void Metrics::setCounter(const bs::String& name, bs::UINT64 total)
+  {
+    Counter& counter = mCounters[name];
+
+    if (total < counter.total)
+    {
+      counter.totalAtLastExport = 0;
+    }
+
+    counter.total = total;
+  }
+
+  void Metrics::setGauge(const bs::String& name, double value)
+  {
+    mGauges[name] = value;
+  }
+
+  void Metrics::observe(const bs::String& name, double value,
+                        const bs::Vector<double>& upperBounds)
+  {
+    auto it = mHistograms.find(name);
+
+    if (it == mHistograms.end())
+    {
+      Histogram histogram;
+      histogram.upperBounds = upperBounds;
+      histogram.cumulativeCounts.resize(upperBounds.size(), 0);
+
+      it = mHistograms.emplace(name, std::move(histogram)).first;
+    }
+
+    it->second.observe(value);
+  }
+
+  void Metrics::onFrameStarted()
+  {
+    if (!mIsEnabled) return;
+
+    Clock::time_point now = Clock::now();
+
+    if (mHasFrameStarted)
+    {
+      mFrameTimes.observe(std::chrono::duration<double, std::milli>(now - mFrameStart).count());
+    }
+
+    mHasFrameStarted = true;
+    mFrameStart      = now;
+  }
+
+  bool Metrics::isExportDue() const
+  {
+    if (!mIsEnabled) return false;
+
+    return std::chrono::duration<float>(Clock::now() - mLastExport).count() >= mExportInterval;
+  }
+
+  bool Metrics::exportNow()
+  {
+    if (!mIsEnabled) return false;
+
+    Clock::time_point now  = Clock::now();
+    double secondsExported = std::chrono::duration<double>(now - mLastExport).count();
+    mLastExport            = now;
+
+    recordMemory();
+
+    setGauge("engine.uptime_seconds", secondsSinceStart());
+    setCounter("engine.frames", mFrameTimes.count);
+    mHistograms["engine.frame_ms"] = mFrameTimes;
+
+    for (auto& it : mCounters)
+    {
+      Counter& counter = it.second;
+
+      if (secondsExported > 0.0)
+      {
+        counter.perSecond = (counter.total - counter.totalAtLastExport) / secondsExported;
+      }
+
+      counter.totalAtLastExport = counter.total;
+    }
+
+    bool isPrometheus = mPath.getExtension() == ".prom";
+    bs::String text   = isPrometheus ? prometheusText() : jsonText();
+
+    // Written next to it first, so whoever reads the file never sees half of it
+    bs::Path tempPath = mPath;
+    tempPath.setFilename(mPath.getFilename() + ".tmp");
+
+    bs::SPtr<bs::DataStream> stream = bs::FileSystem::createAndOpenFile(tempPath);
+
+    if (!stream)
+    {
+      REGOTH_LOG(Error, Uncategorized, "[Metrics] Failed to write metrics to {0}",
+                 tempPath.toString());
+      return false;
+    }
+
+    stream->write(text.data(), text.size());
+    stream->close();
+
+    bs::FileSystem::move(tempPath, mPath, true);
+
+    return true;
+  }
+
+  void Metrics::recordMemory()
+  {
+    for (const MemoryAccounting::TagTotal& total : gMemoryAccounting().totals())
+    {
+      bs::String name = bs::String("memory.") + memoryTagName(total.tag);
+
+      setGauge(name + ".bytes", (double)total.bytes);
+      setGauge(name + ".peak_bytes", (double)total.peakBytes);
+      setGauge(name + ".allocations", (double)total.numAllocations);
+    }
+
+    setCounter("memory.heap_allocations", allocationsOfAllThreads().numAllocations);
+  }
+
+  double Metrics::secondsSinceStart() const
+  {
+    return std::chrono::duration<double>(Clock::now() - mStart).count();
+  }
+
+  bs::String Metrics::jsonText() const
+  {
+    // Braces are kept out of the format strings, as those would be taken as placeholders
+    bs::String json = "{\n  \"counters\": {";
+
+    const char* separator = "\n";
+
+    for (const auto& it : mCounters)
+    {
+      json += separator;
+      json += bs::StringUtil::format("    \"{0}\": ", it.first);
+      json += "{";
+      json += bs::StringUtil::format("\"total\": {0}, \"perSecond\": {1}", it.second.total,
+                                     formatMetricValue(it.second.perSecond));
+      json += "}";
+
+      separator = ",\n";
+    }
+
+    json += "\n  },\n  \"gauges\": {";
+    separator = "\n";
+
+    for (const auto& it : mGauges)
+    {
+      json += separator;
+      json += bs::StringUtil::format("    \"{0}\": {1}", it.first, formatMetricValue(it.second));
+
+      separator = ",\n";
+    }
+
+    json += "\n  },\n  \"histograms\": {";
+    separator = "\n";
+
+    for (const auto& it : mHistograms)
+    {
+      const Histogram& histogram = it.second;
+
+      json += separator;
+      json += bs::StringUtil::format("    \"{0}\": ", it.first);
+      json += "{";
+      json += bs::StringUtil::format("\"count\": {0}, \"sum\": {1}, \"buckets\": [",
+                                     histogram.count, formatMetricValue(histogram.sum));
+
+      for (size_t i = 0; i < histogram.upperBounds.size(); i++)
+      {
+        json += i == 0 ? "{" : ", {";
+        json += bs::StringUtil::format("\"le\": {0}, \"count\": {1}",
+                                       formatMetricValue(histogram.upperBounds[i]),
+                                       histogram.cumulativeCounts[i]);
+        json += "}";
+      }
+
+      json += "]}";
+
+      separator = ",\n";
+    }
+
+    json += "\n  }\n}\n";
+
+    return json;
+  }
+
+  bs::String Metrics::prometheusText() const
+  {
+    bs::String text;
+
+    for (const auto& it : mCounters)
+    {
+      bs::String name = prometheusName(it.first) + "_total";
+
+      text += bs::StringUtil::format("# TYPE {0} counter\n", name);
+      text += bs::StringUtil::format("{0} {1}\n", name, it.second.total);
+    }
+
+    for (const auto& it : mGauges)
+    {
+      bs::String name = prometheusName(it.first);
+
+      text += bs::StringUtil::format("# TYPE {0} gauge\n", name);
+      text += bs::StringUtil::format("{0} {1}\n", name, formatMetricValue(it.second));
+    }
+
+    for (const auto& it : mHistograms)
+    {
+      const Histogram& histogram = it.second;
+      bs::String name            = prometheusName(it.first);
+
+      text += bs::StringUtil::format("# TYPE {0} histogram\n", name);
+
+      for (size_t i = 0; i < histogram.upperBounds.size(); i++)
+      {
+        text += name + "_bucket{le=\"" + formatMetricValue(histogram.upperBounds[i]) + "\"} ";
+        text += bs::toString(histogram.cumulativeCounts[i]) + "\n";
+      }
+
+      text += name + "_bucket{le=\"+Inf\"} " + bs::toString(histogram.count) + "\n";
+      text += bs::StringUtil::format("{0}_sum {1}\n", name, formatMetricValue(histogram.sum));
+      text += bs::StringUtil::format("{0}_count {1}\n", name, histogram.count);
+    }
+
+    return text;
+  }
+
+  Metrics& gMetrics()
+  {
+    static Metrics metrics;
+    return metrics;
+  }
+}  // namespace REGoth
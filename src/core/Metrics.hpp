@@ -0,0 +1,160 @@
+/**\file
+ */
+#pragma once
+#include <BsPrerequisites.h>
+#include <chrono>
+
+namespace REGoth
+{
+  /**
+   * Numbers describing a long running engine instance, written to a file every few seconds so
+   * leaks and drops in throughput can be spotted over hours, e.g. on a server.
+   *
+   * Three kinds of metrics are kept by name:
+   *
+   *  - *Counters* only go up, like the number of instructions the scripts have executed.
+   *    Every export also contains how much they went up per second since the last one.
+   *  - *Gauges* are a value at the time of the export, like the number of queued messages.
+   *  - *Histograms* count observed values into buckets, like the time of every frame.
+   *
+   * Names are dot-separated, e.g. `ai.event_queues.messages`. The subsystems don't know about
+   * the metrics themselves. Instead, the stats they keep anyway are read once per export, see
+   * GameWorld::recordMetrics(). The time of every frame and the memory of every MemoryTag are
+   * recorded by the metrics themselves.
+   *
+   * Files ending in `.prom` are written in the text format of Prometheus, so they can be
+   * picked up by the textfile collector of its node exporter. Anything else is written as
+   * JSON. The file is replaced as a whole, so readers never see half of it.
+   *
+   * Off by default and turned on via `--metrics`, see EngineConfig::metricsPath. Only to be
+   * used from the main thread. There is one global instance, see gMetrics().
+   */
+  class Metrics
+  {
+  public:
+    /** Default for the seconds between two exports, see enable() */
+    static constexpr float DEFAULT_EXPORT_INTERVAL = 10.0f;
+
+    /** Upper bounds of the buckets of the frame time histogram, in milliseconds */
+    static constexpr double FRAME_TIME_BUCKETS[] = {4, 8, 12, 16.7, 25, 33.3, 50, 100, 250, 1000};
+
+    struct Counter
+    {
+      bs::UINT64 total = 0;
+
+      /** How much the total went up per second between the last two exports */
+      double perSecond = 0.0;
+
+      /** Total at the time of the last export */
+      bs::UINT64 totalAtLastExport = 0;
+    };
+
+    struct Histogram
+    {
+      /**
+       * Upper bounds of the buckets, ascending. Values above the last one only count towards
+       * `count`.
+       */
+      bs::Vector<double> upperBounds;
+
+      /** Values observed at or below each upper bound, same size as `upperBounds` */
+      bs::Vector<bs::UINT64> cumulativeCounts;
+
+      bs::UINT64 count = 0;
+      double sum       = 0.0;
+
+      void observe(double value);
+    };
+
+    /**
+     * Starts exporting to the given file every `intervalSeconds` seconds of real time.
+     */
+    void enable(const bs::Path& path, float intervalSeconds = DEFAULT_EXPORT_INTERVAL);
+
+    bool isEnabled() const
+    {
+      return mIsEnabled;
+    }
+
+    /**
+     * Adds to the given counter, creating it if needed.
+     */
+    void addToCounter(const bs::String& name, bs::UINT64 amount = 1);
+
+    /**
+     * Sets the total of the given counter, for subsystems counting on their own. A total
+     * lower than before means the subsystem started over, e.g. because the scripts have been
+     * reloaded, so the counter starts over as well.
+     */
+    void setCounter(const bs::String& name, bs::UINT64 total);
+
+    void setGauge(const bs::String& name, double value);
+
+    /**
+     * Counts the given value into the given histogram.
+     *
+     * @param  upperBounds  Buckets to use if the histogram doesn't exist yet, ascending.
+     */
+    void observe(const bs::String& name, double value, const bs::Vector<double>& upperBounds);
+
+    /**
+     * Records the time of the frame which has just ended. To be called once per frame.
+     */
+    void onFrameStarted();
+
+    /**
+     * @return Whether it's time for exportNow(). Never if not enabled.
+     */
+    bool isExportDue() const;
+
+    /**
+     * Records the memory of every MemoryTag, works out the counters per second and writes
+     * everything to the file given to enable().
+     *
+     * @return Whether writing worked.
+     */
+    bool exportNow();
+
+    /**
+     * @return All metrics as JSON.
+     */
+    bs::String jsonText() const;
+
+    /**
+     * @return All metrics in the text format of Prometheus, prefixed with `regoth_`.
+     */
+    bs::String prometheusText() const;
+
+  private:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * Sets the gauges of the memory of every MemoryTag and the counter of all allocations.
+     */
+    void recordMemory();
+
+    double secondsSinceStart() const;
+
+    bool mIsEnabled = false;
+    bs::Path mPath;
+    float mExportInterval = DEFAULT_EXPORT_INTERVAL;
+
+    Clock::time_point mStart;
+    Clock::time_point mLastExport;
+
+    bool mHasFrameStarted = false;
+    Clock::time_point mFrameStart;
+
+    /** Kept apart from the others, so recording a frame doesn't have to look it up by name */
+    Histogram mFrameTimes;
+
+    bs::Map<bs::String, Counter> mCounters;
+    bs::Map<bs::String, double> mGauges;
+    bs::Map<bs::String, Histogram> mHistograms;
+  };
+
+  /**
+   * @return The metrics of the engine, see Metrics.
+   */
+  Metrics& gMetrics();
+}  // namespace REGoth
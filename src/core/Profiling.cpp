@@ -0,0 +1,131 @@
+#include "Profiling.hpp"
+#include <FileSystem/BsDataStream.h>
+#include <FileSystem/BsFileSystem.h>
+#include <algorithm>
+#include <cstdio>
+#include <log/logging.hpp>
+
+namespace REGoth
+{
+  constexpr bs::UINT32 Profiler::MAX_EVENTS;
+
+  Profiler::Profiler()
+      : mStart(std::chrono::steady_clock::now())
+  {
+  }
+
+  bs::UINT64 Profiler::now() const
+  {
+    auto elapsed = std::chrono::steady_clock::now() - mStart;
+
+    return (bs::UINT64)std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+  }
+
+  void Profiler::record(const char* name, bs::UINT64 start, bs::UINT64 end)
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    ScopeTotal& total = mCurrentTotals[name];
+    total.name        = name;
+    total.numCalls += 1;
+    total.nanoseconds += end - start;
+
+    if (mEvents.size() < MAX_EVENTS)
+    {
+      mEvents.push_back({name, threadNumber(), start, end - start});
+
+      if (mEvents.size() == MAX_EVENTS)
+      {
+        REGOTH_LOG(Warning, Uncategorized,
+                   "[Profiler] Recorded {0} scopes, the trace won't contain any more",
+                   MAX_EVENTS);
+      }
+    }
+  }
+
+  bs::UINT32 Profiler::threadNumber()
+  {
+    auto it = mThreadNumbers.find(std::this_thread::get_id());
+
+    if (it != mThreadNumbers.end()) return it->second;
+
+    bs::UINT32 number = (bs::UINT32)mThreadNumbers.size();
+    mThreadNumbers[std::this_thread::get_id()] = number;
+
+    return number;
+  }
+
+  void Profiler::endFrame()
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    mLastTotals.clear();
+
+    for (const auto& t : mCurrentTotals)
+    {
+      mLastTotals.push_back(t.second);
+    }
+
+    auto isMoreExpensive = [](const ScopeTotal& a, const ScopeTotal& b) {
+      return a.nanoseconds > b.nanoseconds;
+    };
+
+    std::sort(mLastTotals.begin(), mLastTotals.end(), isMoreExpensive);
+
+    mCurrentTotals.clear();
+  }
+
+  bs::Vector<Profiler::ScopeTotal> Profiler::lastFrameTotals() const
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    return mLastTotals;
+  }
+
+  bool Profiler::writeChromeTrace(const bs::Path& path) const
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    bs::SPtr<bs::DataStream> stream = bs::FileSystem::createAndOpenFile(path);
+
+    if (!stream)
+    {
+      REGOTH_LOG(Error, Uncategorized, "[Profiler] Failed to write trace to {0}",
+                 path.toString());
+      return false;
+    }
+
+    // Times are in microseconds. Names are string literals, so they need no escaping.
+    bs::String text = "{\"traceEvents\":[\n";
+
+    for (size_t i = 0; i < mEvents.size(); i++)
+    {
+      const Event& e = mEvents[i];
+
+      char line[256];
+      std::snprintf(line, sizeof(line),
+                    "{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,"
+                    "\"ts\":%.3f,\"dur\":%.3f}%s\n",
+                    e.name, e.thread, e.start / 1000.0, e.duration / 1000.0,
+                    (i + 1 < mEvents.size()) ? "," : "");
+
+      text += line;
+    }
+
+    text += "]}\n";
+
+    stream->write(text.data(), text.size());
+    stream->close();
+
+    REGOTH_LOG(Info, Uncategorized, "[Profiler] Wrote {0} scopes to {1}", mEvents.size(),
+               path.toString());
+
+    return true;
+  }
+
+  Profiler& gProfiler()
+  {
+    static Profiler profiler;
+    return profiler;
+  }
+}  // namespace REGoth
@@ -0,0 +1,160 @@
+/**\file
+ */
+#pragma once
+#include <BsPrerequisites.h>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+namespace REGoth
+{
+  /**
+   * Records how much time is spent inside named scopes, on any thread. Scopes are marked via
+   * REGOTH_PROFILE_SCOPE().
+   *
+   * Off by default, so a scope only costs checking whether the profiler is on. Once enabled,
+   * two things are recorded:
+   *
+   *  - The calls and total time of every scope since the last endFrame(), as shown by the
+   *    profiler overlay, see UIProfilerOverlay.
+   *  - Every single scope with its thread, start and duration, to be exported as a trace
+   *    for Chrome's `about:tracing` or Perfetto, see writeChromeTrace(). Recording stops
+   *    once MAX_EVENTS have been recorded, so a long session doesn't fill all memory.
+   *
+   * There is one global profiler, see gProfiler().
+   */
+  class Profiler
+  {
+  public:
+    /** Scopes of a trace recorded at most */
+    static constexpr bs::UINT32 MAX_EVENTS = 4000000;
+
+    /**
+     * How often a scope was entered and how much time was spent inside.
+     */
+    struct ScopeTotal
+    {
+      const char* name       = nullptr;
+      bs::UINT32 numCalls    = 0;
+      bs::UINT64 nanoseconds = 0;
+    };
+
+    Profiler();
+
+    void setEnabled(bool enabled)
+    {
+      mIsEnabled.store(enabled, std::memory_order_relaxed);
+    }
+
+    bool isEnabled() const
+    {
+      return mIsEnabled.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @return Nanoseconds since the profiler was created.
+     */
+    bs::UINT64 now() const;
+
+    /**
+     * Records that the given scope was left.
+     *
+     * @param  name   Name of the scope. Must stay valid for as long as the profiler.
+     * @param  start  When the scope was entered, see now().
+     * @param  end    When the scope was left, see now().
+     */
+    void record(const char* name, bs::UINT64 start, bs::UINT64 end);
+
+    /**
+     * Moves the totals recorded since the last call to lastFrameTotals(). Expected to be
+     * called once per frame.
+     */
+    void endFrame();
+
+    /**
+     * @return Totals of every scope entered during the last frame, the most expensive first.
+     */
+    bs::Vector<ScopeTotal> lastFrameTotals() const;
+
+    /**
+     * Writes all recorded scopes as trace in Chrome's JSON format.
+     *
+     * @return Whether that worked.
+     */
+    bool writeChromeTrace(const bs::Path& path) const;
+
+  private:
+    struct Event
+    {
+      const char* name;
+      bs::UINT32 thread;
+      bs::UINT64 start;
+      bs::UINT64 duration;
+    };
+
+    /**
+     * @return Small number for the calling thread, to be independent from how the platform
+     *         identifies threads. Must be called with mMutex locked.
+     */
+    bs::UINT32 threadNumber();
+
+    std::atomic<bool> mIsEnabled = {false};
+    std::chrono::steady_clock::time_point mStart;
+
+    mutable std::mutex mMutex;
+    bs::Vector<Event> mEvents;
+    bs::UnorderedMap<const char*, ScopeTotal> mCurrentTotals;
+    bs::Vector<ScopeTotal> mLastTotals;
+    bs::UnorderedMap<std::thread::id, bs::UINT32> mThreadNumbers;
+  };
+
+  /**
+   * @return The profiler REGOTH_PROFILE_SCOPE() records to.
+   */
+  Profiler& gProfiler();
+
+  /**
+   * Records the time from its construction to its destruction to gProfiler(), if enabled at
+   * construction. See REGOTH_PROFILE_SCOPE().
+   */
+  class ProfileScope
+  {
+  public:
+    ProfileScope(const char* name)
+        : mName(name)
+        , mIsRecording(gProfiler().isEnabled())
+    {
+      if (mIsRecording)
+      {
+        mStart = gProfiler().now();
+      }
+    }
+
+    ~ProfileScope()
+    {
+      if (mIsRecording)
+      {
+        gProfiler().record(mName, mStart, gProfiler().now());
+      }
+    }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+  private:
+    const char* mName;
+    bool mIsRecording;
+    bs::UINT64 mStart = 0;
+  };
+}  // namespace REGoth
+
+#define REGOTH_PROFILE_CONCAT_INNER(a, b) a##b
+#define REGOTH_PROFILE_CONCAT(a, b) REGOTH_PROFILE_CONCAT_INNER(a, b)
+
+/**
+ * Records the time until the end of the current scope to gProfiler() under the given name,
+ * which has to be a string literal.
+ */
+#define REGOTH_PROFILE_SCOPE(name) \
+  ::REGoth::ProfileScope REGOTH_PROFILE_CONCAT(regothProfileScope, __LINE__)(name)
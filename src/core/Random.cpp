@@ -0,0 +1,50 @@
+#include "Random.hpp"
+
+namespace REGoth
+{
+  constexpr bs::UINT64 Random::MULTIPLIER;
+
+  /**
+   * SplitMix64 finalizer, spreads similar inputs like consecutive indices over all bits.
+   */
+  static bs::UINT64 mix(bs::UINT64 value)
+  {
+    value = (value ^ (value >> 30u)) * 0xbf58476d1ce4e5b9ull;
+    value = (value ^ (value >> 27u)) * 0x94d049bb133111ebull;
+
+    return value ^ (value >> 31u);
+  }
+
+  void Random::seed(bs::UINT64 seed, bs::UINT64 streamIndex)
+  {
+    // Initialization as done by the reference implementation. Any odd increment is a
+    // sequence of its own.
+    mState     = 0;
+    mIncrement = (streamIndex << 1u) | 1u;
+
+    next();
+    mState += seed;
+    next();
+  }
+
+  bs::UINT32 Random::below(bs::UINT32 bound)
+  {
+    if (bound == 0) return 0;
+
+    // Rejecting the few values which don't fit into a whole number of bounds, so every result
+    // is equally likely, unlike a plain modulo
+    bs::UINT32 threshold = (0u - bound) % bound;
+
+    for (;;)
+    {
+      bs::UINT32 value = next();
+
+      if (value >= threshold) return value % bound;
+    }
+  }
+
+  Random Random::stream(bs::UINT64 streamIndex) const
+  {
+    return Random(mix(mState ^ mix(streamIndex)), mix(mIncrement + streamIndex));
+  }
+}  // namespace REGoth
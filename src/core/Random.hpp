@@ -0,0 +1,110 @@
+/**\file
+ */
+#pragma once
+#include <BsPrerequisites.h>
+
+namespace REGoth
+{
+  /**
+   * Small and fast pseudo random number generator, PCG32 (XSH RR variant).
+   *
+   * Every GameWorld owns one, see GameWorld::random(), which is saved with the world, so the
+   * scripts roll the same numbers after loading and on replays, see InputReplay. Its whole
+   * state are two integers, which makes it cheap to copy.
+   *
+   * Not thread safe. To use random numbers on worker threads, take an independent stream per
+   * piece of work via stream() before handing it out, e.g. one per character.
+   */
+  class Random
+  {
+  public:
+    /**
+     * @param  seed          Start of the sequence.
+     * @param  streamIndex   Which of the independent sequences to use for that seed.
+     */
+    Random(bs::UINT64 seed = 0, bs::UINT64 streamIndex = 0)
+    {
+      this->seed(seed, streamIndex);
+    }
+
+    /**
+     * Restarts the generator, see Random().
+     */
+    void seed(bs::UINT64 seed, bs::UINT64 streamIndex = 0);
+
+    /**
+     * @return The next 32 random bits.
+     */
+    bs::UINT32 next()
+    {
+      bs::UINT64 old = mState;
+      mState         = old * MULTIPLIER + mIncrement;
+
+      bs::UINT32 xorShifted = (bs::UINT32)(((old >> 18u) ^ old) >> 27u);
+      bs::UINT32 rotation   = (bs::UINT32)(old >> 59u);
+
+      return (xorShifted >> rotation) | (xorShifted << ((0u - rotation) & 31u));
+    }
+
+    /**
+     * @return Uniformly distributed number in [0, bound). 0 if the bound is 0.
+     */
+    bs::UINT32 below(bs::UINT32 bound);
+
+    /**
+     * @return Uniformly distributed number in [0, 1).
+     */
+    float nextFloat()
+    {
+      // 24 bits are all a float can hold below 1
+      return (float)(next() >> 8) * (1.0f / 16777216.0f);
+    }
+
+    /**
+     * @return Uniformly distributed number in [min, max).
+     */
+    float range(float min, float max)
+    {
+      return min + (max - min) * nextFloat();
+    }
+
+    /**
+     * Derives a generator which is independent of this one and of the streams with other
+     * indices. Doesn't advance this generator, so taking the same stream twice without
+     * drawing in between yields the same numbers.
+     *
+     * Meant to hand out random numbers to work on other threads, deterministically no
+     * matter which thread runs what: Take the streams on the owning thread, e.g. indexed by
+     * character, and draw from this generator once per update to get fresh ones next time.
+     */
+    Random stream(bs::UINT64 streamIndex) const;
+
+    /**
+     * Internal state, to save and restore the generator, see setState().
+     */
+    bs::UINT64 state() const
+    {
+      return mState;
+    }
+
+    bs::UINT64 increment() const
+    {
+      return mIncrement;
+    }
+
+    /**
+     * Restores a state returned by state() and increment().
+     */
+    void setState(bs::UINT64 state, bs::UINT64 increment)
+    {
+      mState     = state;
+      mIncrement = increment | 1u;
+    }
+
+  private:
+    static constexpr bs::UINT64 MULTIPLIER = 6364136223846793005ull;
+
+    bs::UINT64 mState     = 0;
+    bs::UINT64 mIncrement = 1;
+  };
+}  // namespace REGoth
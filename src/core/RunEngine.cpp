@@ -1,18 +1,28 @@
 #include <core/RunEngine.hpp>
 
+#include <exception>
 #include <iostream>
 #include <string>
 
 #include <FileSystem/BsPath.h>
 
 #include <core/Engine.hpp>
+#include <core/Jobs.hpp>
+#include <core/StartupProfiler.hpp>
 #include <log/logging.hpp>
 
 using namespace REGoth;
 
 int REGoth::runEngine(Engine& engine)
 {
-  engine.initializeBsf();
+  engine.setupLogging();
+  engine.setupProfiler();
+  engine.setupReplay();
+
+  {
+    REGOTH_STARTUP_STEP("Start bs:f");
+    engine.initializeBsf();
+  }
 
   REGOTH_LOG(Info, Uncategorized, "[Main] Running Engine");
   REGOTH_LOG(Info, Uncategorized, "[Main]  - Engine executable: {0}",
@@ -20,24 +30,45 @@ int REGoth::runEngine(Engine& engine)
   REGOTH_LOG(Info, Uncategorized, "[Main]  - Game directory:    {0}",
              engine.config()->originalAssetsPath.toString());
 
-  REGOTH_LOG(Info, Uncategorized, "[Main] Finding REGoth content-directory");
-  engine.findEngineContent();
-
-  REGOTH_LOG(Info, Uncategorized, "[Main] Loading original game packages");
-  engine.loadGamePackages();
+  // Indexing the VDFS is mostly waiting for the disk and doesn't depend on anything but
+  // bs:f's task scheduler, so it happens on a worker while the main thread prepares
+  // everything else. Nothing before setupScene() reads from the VDFS.
+  std::exception_ptr packagesError;
+  Jobs::JobGroup startup("Startup");
+
+  REGOTH_LOG(Info, Uncategorized, "[Main] Loading original game packages in the background");
+  startup.run([&]() {
+    try
+    {
+      REGOTH_STARTUP_STEP("Mount VDFS");
+      engine.loadGamePackages();
+    }
+    catch (...)
+    {
+      packagesError = std::current_exception();
+    }
+  });
 
-  if (!engine.hasFoundGameFiles())
+  REGOTH_LOG(Info, Uncategorized, "[Main] Finding REGoth content-directory");
   {
-    REGOTH_LOG(Fatal, Uncategorized,
-               "No files loaded into the VDFS - is the game assets path correct?");
-    return EXIT_FAILURE;
+    REGOTH_STARTUP_STEP("Find engine content");
+    engine.findEngineContent();
   }
 
   REGOTH_LOG(Info, Uncategorized, "[Engine] Load cached resource manifests");
-  engine.loadCachedResourceManifests();
+  {
+    REGOTH_STARTUP_STEP("Load resource manifests");
+    engine.loadCachedResourceManifests();
+  }
 
   REGOTH_LOG(Info, Uncategorized, "[Engine] Loading Shaders");
-  engine.setShaders();
+  {
+    REGOTH_STARTUP_STEP("Load shaders");
+    engine.setShaders();
+  }
+
+  REGOTH_LOG(Info, Uncategorized, "[Engine] Loading native scripts");
+  engine.loadScriptNativeModule();
 
   REGOTH_LOG(Info, Uncategorized, "[Engine] Setting up input");
   engine.setupInput();
@@ -45,15 +76,45 @@ int REGoth::runEngine(Engine& engine)
   REGOTH_LOG(Info, Uncategorized, "[Engine] Setting up Main Camera");
   engine.setupMainCamera();
 
+  {
+    REGOTH_STARTUP_STEP("Wait for game packages");
+    startup.wait();
+  }
+
+  if (packagesError) std::rethrow_exception(packagesError);
+
+  if (!engine.hasFoundGameFiles())
+  {
+    REGOTH_LOG(Fatal, Uncategorized,
+               "No files loaded into the VDFS - is the game assets path correct?");
+    return EXIT_FAILURE;
+  }
+
   REGOTH_LOG(Info, Uncategorized, "[Engine] Setting up Scene");
-  engine.setupScene();
+  {
+    REGOTH_STARTUP_STEP("Set up scene");
+    engine.setupScene();
+  }
 
   REGOTH_LOG(Info, Uncategorized, "[Engine] Save cached resource manifests");
-  engine.saveCachedResourceManifests();
+  {
+    REGOTH_STARTUP_STEP("Save resource manifests");
+    engine.saveCachedResourceManifests();
+  }
+
+  gStartupProfiler().logTimeline();
 
   REGOTH_LOG(Info, Uncategorized, "[Engine] Run");
   engine.run();
 
+  engine.saveFileTrace();
+  engine.saveProfileTrace();
+  engine.saveMemoryReport();
+  engine.saveMetrics();
+  engine.saveStartupProfile();
+  engine.saveReplay();
+  engine.logFrameMonitorSummary();
+
   REGOTH_LOG(Info, Uncategorized, "[Engine] Save cached resource manifests");
   engine.saveCachedResourceManifests();
 
@@ -0,0 +1,211 @@
+#include "StartupProfiler.hpp"
+#include <FileSystem/BsDataStream.h>
+#include <FileSystem/BsFileSystem.h>
+#include <core/MemoryAccounting.hpp>
+#include <fstream>
+#include <log/logging.hpp>
+#include <string>
+
+#if BS_PLATFORM == BS_PLATFORM_WIN32
+#  define WIN32_LEAN_AND_MEAN
+#  include <windows.h>
+#endif
+
+namespace REGoth
+{
+  /**
+   * @return Bytes this process has read so far via read calls. Reads of memory mapped files,
+   *         like the packages, only show up as page faults and aren't counted. 0 if unknown.
+   */
+  static bs::UINT64 processBytesRead()
+  {
+#if BS_PLATFORM == BS_PLATFORM_WIN32
+    IO_COUNTERS counters;
+
+    if (!GetProcessIoCounters(GetCurrentProcess(), &counters)) return 0;
+
+    return counters.ReadTransferCount;
+#elif BS_PLATFORM == BS_PLATFORM_LINUX
+    std::ifstream io("/proc/self/io");
+    std::string key;
+    bs::UINT64 value;
+
+    while (io >> key >> value)
+    {
+      if (key == "rchar:") return value;
+    }
+
+    return 0;
+#else
+    return 0;
+#endif
+  }
+
+  StartupProfiler::StartupProfiler()
+      : mStart(Clock::now())
+      , mMainThread(std::this_thread::get_id())
+  {
+  }
+
+  void StartupProfiler::enable(const bs::Path& reportPath)
+  {
+    mReportPath = reportPath;
+  }
+
+  bool StartupProfiler::isRecording() const
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    return mNumFramesStarted < 2;
+  }
+
+  StartupProfiler::Counters StartupProfiler::takeCounters() const
+  {
+    Counters counters;
+
+    if (!isEnabled()) return counters;
+
+    counters.bytesRead = processBytesRead();
+
+    for (const MemoryAccounting::TagTotal& t : gMemoryAccounting().totals())
+    {
+      counters.trackedBytes += t.bytes;
+    }
+
+    // Stays 0 unless bs:f has been built with profiling
+    counters.numBsfAllocations = bs::MemoryCounter::getNumAllocs();
+
+    return counters;
+  }
+
+  double StartupProfiler::nowMs() const
+  {
+    return std::chrono::duration<double, std::milli>(Clock::now() - mStart).count();
+  }
+
+  void StartupProfiler::record(const char* name, double startMs, const Counters& start)
+  {
+    Counters end = takeCounters();
+
+    Step step;
+    step.name              = name;
+    step.startMs           = startMs;
+    step.endMs             = nowMs();
+    step.isOnWorker        = std::this_thread::get_id() != mMainThread;
+    step.bytesRead         = end.bytesRead - start.bytesRead;
+    step.trackedBytes      = (bs::INT64)end.trackedBytes - (bs::INT64)start.trackedBytes;
+    step.numBsfAllocations = end.numBsfAllocations - start.numBsfAllocations;
+
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    if (mNumFramesStarted >= 2) return;
+
+    mSteps.push_back(step);
+  }
+
+  void StartupProfiler::onFrameStarted()
+  {
+    if (!isRecording()) return;
+
+    // The first frame is done once the second one starts
+    bool isFirstFrameDone;
+    {
+      std::lock_guard<std::mutex> lock(mMutex);
+
+      isFirstFrameDone = mNumFramesStarted == 1;
+
+      if (mNumFramesStarted == 0)
+      {
+        mFirstFrameStartMs = nowMs();
+        mFirstFrameStart   = takeCounters();
+      }
+    }
+
+    if (isFirstFrameDone)
+    {
+      record("First frame", mFirstFrameStartMs, mFirstFrameStart);
+    }
+
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    mNumFramesStarted += 1;
+
+    if (isFirstFrameDone)
+    {
+      REGOTH_LOG(Info, Uncategorized, "[StartupProfiler] First frame done after {0} ms",
+                 mSteps.back().endMs);
+
+      if (isEnabled() && !mIsReportWritten) mIsReportWritten = writeReport();
+    }
+  }
+
+  void StartupProfiler::logTimeline() const
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    REGOTH_LOG(Info, Uncategorized, "[StartupProfiler] Startup timeline:");
+
+    for (const Step& s : mSteps)
+    {
+      REGOTH_LOG(Info, Uncategorized, "[StartupProfiler]  - {0}: {1} ms to {2} ms ({3} ms){4}",
+                 s.name, s.startMs, s.endMs, s.endMs - s.startMs,
+                 s.isOnWorker ? ", on a worker" : "");
+    }
+
+    REGOTH_LOG(Info, Uncategorized, "[StartupProfiler]  - First frame after {0} ms", nowMs());
+  }
+
+  void StartupProfiler::writeReportIfPending()
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    if (isEnabled() && !mIsReportWritten) mIsReportWritten = writeReport();
+  }
+
+  bool StartupProfiler::writeReport() const
+  {
+    bs::String json = "{\"steps\": [\n";
+
+    for (size_t i = 0; i < mSteps.size(); i++)
+    {
+      const Step& s = mSteps[i];
+
+      // Braces are kept out of the format strings, as those would be taken as placeholders
+      json += "  {";
+      json += bs::StringUtil::format(
+          "\"name\": \"{0}\", \"startMs\": {1}, \"durationMs\": {2}, \"onWorker\": {3}, ",
+          s.name, s.startMs, s.endMs - s.startMs, s.isOnWorker ? "true" : "false");
+      json += bs::StringUtil::format("\"bytesRead\": {0}, \"trackedBytes\": {1}, ",
+                                     s.bytesRead, s.trackedBytes);
+      json += bs::StringUtil::format("\"bsfAllocations\": {0}", s.numBsfAllocations);
+      json += i + 1 < mSteps.size() ? "},\n" : "}\n";
+    }
+
+    json += bs::StringUtil::format("], \"firstFrameDone\": {0}, \"totalMs\": {1}",
+                                   mNumFramesStarted >= 2 ? "true" : "false", nowMs());
+    json += "}\n";
+
+    bs::SPtr<bs::DataStream> stream = bs::FileSystem::createAndOpenFile(mReportPath);
+
+    if (!stream)
+    {
+      REGOTH_LOG(Error, Uncategorized, "[StartupProfiler] Failed to write report to {0}",
+                 mReportPath.toString());
+      return false;
+    }
+
+    stream->write(json.data(), json.size());
+    stream->close();
+
+    REGOTH_LOG(Info, Uncategorized, "[StartupProfiler] Wrote report to {0}",
+               mReportPath.toString());
+
+    return true;
+  }
+
+  StartupProfiler& gStartupProfiler()
+  {
+    static StartupProfiler profiler;
+    return profiler;
+  }
+}  // namespace REGoth
@@ -0,0 +1,174 @@
+/**\file
+ */
+#pragma once
+#include <BsPrerequisites.h>
+#include <chrono>
+#include <core/Profiling.hpp>
+#include <mutex>
+#include <thread>
+
+namespace REGoth
+{
+  /**
+   * Records the steps the engine goes through until the first frame has been drawn, like
+   * mounting the VDFS, converting GOTHIC.DAT or loading the cached world. Steps are marked
+   * via REGOTH_STARTUP_STEP() and may run on any thread.
+   *
+   * The time of every step is always recorded, so the timeline can be logged, see
+   * logTimeline(). If enabled via `--profile-startup`, see EngineConfig::startupProfilePath,
+   * every step also records how many bytes the process read, how much memory the systems
+   * counted by gMemoryAccounting() took and how many allocations bs:f made meanwhile. These
+   * are counted for the process as a whole, so steps running at the same time see each
+   * other's. The report is then written as JSON once the first frame is done, so time to
+   * first frame can be tracked across runs.
+   *
+   * Steps started after the first frame are not recorded, so loading a world later on doesn't
+   * end up in here. There is one global instance, see gStartupProfiler().
+   */
+  class StartupProfiler
+  {
+  public:
+    /**
+     * What the process did during a single step.
+     */
+    struct Step
+    {
+      const char* name             = nullptr;
+      double startMs               = 0.0;
+      double endMs                 = 0.0;
+      bool isOnWorker              = false;
+      bs::UINT64 bytesRead         = 0;
+      bs::INT64 trackedBytes       = 0;
+      bs::UINT64 numBsfAllocations = 0;
+    };
+
+    /**
+     * Process wide counters, taken at the start and the end of a step.
+     */
+    struct Counters
+    {
+      bs::UINT64 bytesRead         = 0;
+      bs::UINT64 trackedBytes      = 0;
+      bs::UINT64 numBsfAllocations = 0;
+    };
+
+    StartupProfiler();
+
+    /**
+     * Turns on taking the counters of every step and sets where to write the report to once
+     * the first frame is done. Must be called before the first step starts, as the path is
+     * read from any thread without locking.
+     */
+    void enable(const bs::Path& reportPath);
+
+    bool isEnabled() const
+    {
+      return !mReportPath.isEmpty();
+    }
+
+    /**
+     * @return Whether steps are still recorded, which is until the first frame is done.
+     */
+    bool isRecording() const;
+
+    /**
+     * @return The counters right now. All 0 if not enabled.
+     */
+    Counters takeCounters() const;
+
+    /**
+     * @return Milliseconds since the profiler was created, which is about when the process
+     *         started.
+     */
+    double nowMs() const;
+
+    /**
+     * Records a finished step, see StartupStep.
+     */
+    void record(const char* name, double startMs, const Counters& start);
+
+    /**
+     * To be called at the start of every frame. The first frame is recorded as a step of its
+     * own, after which the report is written and recording stops.
+     */
+    void onFrameStarted();
+
+    /**
+     * Logs all steps recorded so far.
+     */
+    void logTimeline() const;
+
+    /**
+     * Writes the report to the path given to enable(), unless that has been done already.
+     * Used on exit, in case a first frame never happened.
+     */
+    void writeReportIfPending();
+
+  private:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * Writes all recorded steps as JSON. Must be called with mMutex locked.
+     */
+    bool writeReport() const;
+
+    Clock::time_point mStart;
+    std::thread::id mMainThread;
+    bs::Path mReportPath;
+
+    mutable std::mutex mMutex;
+    bs::Vector<Step> mSteps;
+    bs::UINT32 mNumFramesStarted = 0;
+    double mFirstFrameStartMs    = 0.0;
+    Counters mFirstFrameStart;
+    bool mIsReportWritten = false;
+  };
+
+  /**
+   * @return The profiler REGOTH_STARTUP_STEP() records to.
+   */
+  StartupProfiler& gStartupProfiler();
+
+  /**
+   * Records the time from its construction to its destruction as a step of the startup, see
+   * REGOTH_STARTUP_STEP().
+   */
+  class StartupStep
+  {
+  public:
+    StartupStep(const char* name)
+        : mName(name)
+        , mIsRecording(gStartupProfiler().isRecording())
+    {
+      if (mIsRecording)
+      {
+        mStartMs       = gStartupProfiler().nowMs();
+        mStartCounters = gStartupProfiler().takeCounters();
+      }
+    }
+
+    ~StartupStep()
+    {
+      if (mIsRecording)
+      {
+        gStartupProfiler().record(mName, mStartMs, mStartCounters);
+      }
+    }
+
+    StartupStep(const StartupStep&) = delete;
+    StartupStep& operator=(const StartupStep&) = delete;
+
+  private:
+    const char* mName;
+    bool mIsRecording;
+    double mStartMs = 0.0;
+    StartupProfiler::Counters mStartCounters;
+  };
+}  // namespace REGoth
+
+/**
+ * Records the time until the end of the current scope to gStartupProfiler() as a step of the
+ * startup. The name has to be a string literal.
+ */
+#define REGOTH_STARTUP_STEP(name) \
+  ::REGoth::StartupStep REGOTH_PROFILE_CONCAT(regothStartupStep, __LINE__)(name)
@@ -1,14 +1,28 @@
 #include "EngineContent.hpp"
 #include "internal/FindEngineContent.hpp"
 #include <BsZenLib/ImportPath.hpp>
+#include <FileSystem/BsDataStream.h>
 #include <FileSystem/BsFileSystem.h>
 #include <Importer/BsImporter.h>
+#include <RenderAPI/BsRenderAPI.h>
 #include <Resources/BsResourceManifest.h>
 #include <Resources/BsResources.h>
 #include <exception/Throw.hpp>
+#include <log/logging.hpp>
 
 const bs::String REGOTH_CONTENT_MANIFEST_NAME = "engine-cache";
 
+/**
+ * Number of journaled resources after which the manifest is saved as a whole.
+ */
+const bs::UINT32 REGOTH_CONTENT_JOURNAL_COMPACT_AFTER = 16;
+
+/**
+ * Start of the 64-bit FNV-1a hash shader sources are compared by, see ShaderCacheInfo.
+ */
+constexpr bs::UINT64 REGOTH_SHADER_HASH_OFFSET_BASIS = 14695981039346656037ULL;
+constexpr bs::UINT64 REGOTH_SHADER_HASH_PRIME        = 1099511628211ULL;
+
 namespace REGoth
 {
   EngineContent::EngineContent(const bs::Path& executablePath)
@@ -44,39 +58,108 @@ namespace REGoth
     else
     {
       mResourceManifest = bs::ResourceManifest::create(REGOTH_CONTENT_MANIFEST_NAME);
+
+      bs::gResources().registerResourceManifest(mResourceManifest);
     }
+
+    mJournal = bs::bs_unique_ptr_new<ResourceManifestJournal>(
+        BsZenLib::GetCacheDirectory() + (REGOTH_CONTENT_MANIFEST_NAME + ".journal"),
+        BsZenLib::GetCacheDirectory());
+
+    mJournal->replay(*mResourceManifest);
   }
 
   EngineContent::Shaders EngineContent::loadShaders()
   {
     throwOnMissingResourceManifest();
 
+    if (!mShaderCacheInfo)
+    {
+      loadShaderCacheInfo();
+    }
+
     Shaders r;
 
     r.opaque = loadOrImportShader("World.bsl");
+    r.sky    = loadOrImportShader("Sky.bsl");
 
     return r;
   }
 
+  /**
+   * @return Where the ShaderCacheInfo is saved, next to the resource manifest.
+   */
+  static bs::Path shaderCacheInfoPath()
+  {
+    return BsZenLib::GetCacheDirectory() + (REGOTH_CONTENT_MANIFEST_NAME + ".shaders");
+  }
+
+  /**
+   * @return Hash of the contents of the given file. 0 if it can't be read.
+   */
+  static bs::UINT64 hashShaderSource(const bs::Path& path)
+  {
+    bs::SPtr<bs::DataStream> stream = bs::FileSystem::openFile(path, true);
+
+    if (!stream) return 0;
+
+    bs::Vector<bs::UINT8> data(stream->size());
+    stream->read(data.data(), data.size());
+
+    bs::UINT64 hash = REGOTH_SHADER_HASH_OFFSET_BASIS;
+
+    for (bs::UINT8 byte : data)
+    {
+      hash ^= byte;
+      hash *= REGOTH_SHADER_HASH_PRIME;
+    }
+
+    return hash;
+  }
+
   bs::HShader EngineContent::loadOrImportShader(const bs::String& name)
   {
-    if (bs::FileSystem::isFile(BsZenLib::GothicPathToCachedShader(name)))
+    bs::Path sourcePath = contentPath() + "shaders" + name;
+    bs::Path cachePath  = BsZenLib::GothicPathToCachedShader(name);
+    bs::UINT64 hash     = hashShaderSource(sourcePath);
+
+    if (bs::FileSystem::isFile(cachePath) && mShaderCacheInfo->isUpToDate(name, hash))
     {
-      return bs::gResources().load<bs::Shader>(BsZenLib::GothicPathToCachedShader(name));
+      return bs::gResources().load<bs::Shader>(cachePath);
     }
     else
     {
-      bs::HShader shader = bs::gImporter().import<bs::Shader>(contentPath() + "shaders" + name);
+      REGOTH_LOG(Info, Uncategorized, "[EngineContent] Importing shader {0} for {1}", name,
+                 mShaderCacheInfo->renderAPI);
+
+      bs::HShader shader = bs::gImporter().import<bs::Shader>(sourcePath);
 
       if (shader)
       {
-        addResourceToManifestAndSave(shader, BsZenLib::GothicPathToCachedShader(name));
+        addResourceToManifestAndSave(shader, cachePath);
+
+        mShaderCacheInfo->setImported(name, hash);
+        mShaderCacheInfo->save(shaderCacheInfoPath());
       }
 
       return shader;
     }
   }
 
+  void EngineContent::loadShaderCacheInfo()
+  {
+    bs::String renderAPI = bs::ct::RenderAPI::instance().getName().c_str();
+
+    mShaderCacheInfo = ShaderCacheInfo::load(shaderCacheInfoPath());
+
+    // Shaders from another render API have to be imported again, all of them
+    if (!mShaderCacheInfo || mShaderCacheInfo->renderAPI != renderAPI)
+    {
+      mShaderCacheInfo            = bs::bs_shared_ptr_new<ShaderCacheInfo>();
+      mShaderCacheInfo->renderAPI = renderAPI;
+    }
+  }
+
   void EngineContent::throwOnMissingResourceManifest()
   {
     if (!mResourceManifest)
@@ -99,14 +182,22 @@ namespace REGoth
     bs::gResources().save(resource, path, Overwrite);
 
     mResourceManifest->registerResource(resource.getUUID(), path);
+    mJournal->append(resource.getUUID(), path);
 
-    saveResourceManifest();
+    if (mJournal->numEntries() >= REGOTH_CONTENT_JOURNAL_COMPACT_AFTER)
+    {
+      saveResourceManifest();
+    }
   }
 
   void EngineContent::saveResourceManifest()
   {
+    if (!mResourceManifest) return;
+
     bs::Path manifestPath = BsZenLib::GothicPathToCachedManifest(REGOTH_CONTENT_MANIFEST_NAME);
     bs::ResourceManifest::save(mResourceManifest, manifestPath, BsZenLib::GetCacheDirectory());
+
+    mJournal->clear();
   }
 
 }  // namespace REGoth
@@ -1,5 +1,7 @@
 #pragma once
 #include <BsPrerequisites.h>
+#include <engine-content/ShaderCacheInfo.hpp>
+#include <original-content/ResourceManifestJournal.hpp>
 
 namespace REGoth
 {
@@ -10,8 +12,9 @@ namespace REGoth
    * Since this class also imports and loads resources, it comes with its own
    * resource manifest. This manifest is also managed here.
    *
-   * All resources loaded here, are automatically added to the ResourceManifest, and
-   * the manifest itself is saved after each added resource.
+   * All resources loaded here, are automatically added to the ResourceManifest and appended
+   * to its journal, see ResourceManifestJournal. The manifest itself is only saved as a whole
+   * every few resources and on saveResourceManifest().
    */
   class EngineContent
   {
@@ -45,12 +48,17 @@ namespace REGoth
     struct Shaders
     {
       bs::HShader opaque;
+      bs::HShader sky;
     };
 
     /**
      * Loads the shader stored inside the `content`-directory. Will also handle
      * importing and caching.
      *
+     * A cached shader is imported again if its source changed or it has been compiled for
+     * another render API, see ShaderCacheInfo. Since this is done on startup, entering a
+     * world never waits for shaders to be compiled.
+     *
      * Throws if the `content`-directory was not found or one shader does
      * not exist.
      *
@@ -59,6 +67,11 @@ namespace REGoth
      */
     Shaders loadShaders();
 
+    /**
+     * Saves the whole resource manifest and clears its journal.
+     */
+    void saveResourceManifest();
+
   private:
 
     /**
@@ -78,9 +91,14 @@ namespace REGoth
      */
     bs::HShader loadOrImportShader(const bs::String& name);
 
+    /**
+     * Loads the ShaderCacheInfo, or starts a new one if none was saved for the active render
+     * API.
+     */
+    void loadShaderCacheInfo();
+
     void throwOnMissingResourceManifest();
     void addResourceToManifestAndSave(bs::HResource resource, const bs::Path& path);
-    void saveResourceManifest();
 
     /**
      * Path to REGoth's `content`-directory, e.g. `/home/nameless/REGoth/content/`.
@@ -91,5 +109,15 @@ namespace REGoth
      * Resource-Manifest for REGoth's content.
      */
     bs::SPtr<bs::ResourceManifest> mResourceManifest;
+
+    /**
+     * Resources added to the manifest since it was last saved.
+     */
+    bs::UPtr<ResourceManifestJournal> mJournal;
+
+    /**
+     * What the cached shaders have been imported from, see loadShaderCacheInfo().
+     */
+    bs::SPtr<ShaderCacheInfo> mShaderCacheInfo;
   };
 }
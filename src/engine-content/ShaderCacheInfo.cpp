@@ -0,0 +1,77 @@
+#include "ShaderCacheInfo.hpp"
+#include <FileSystem/BsFileSystem.h>
+#include <RTTI/RTTI_ShaderCacheInfo.hpp>
+#include <Serialization/BsFileSerializer.h>
+#include <log/logging.hpp>
+
+namespace REGoth
+{
+  constexpr bs::UINT32 ShaderCacheInfo::VERSION;
+
+  bs::SPtr<ShaderCacheInfo> ShaderCacheInfo::load(const bs::Path& path)
+  {
+    if (!bs::FileSystem::exists(path)) return nullptr;
+
+    bs::SPtr<bs::IReflectable> decoded;
+
+    try
+    {
+      bs::FileDecoder decoder(path);
+      decoded = decoder.decode();
+    }
+    catch (const std::exception& e)
+    {
+      REGOTH_LOG(Warning, Uncategorized, "[ShaderCacheInfo] Failed to read {0}: {1}",
+                 path.toString(), e.what());
+      return nullptr;
+    }
+
+    if (!decoded || !bs::rtti_is_of_type<ShaderCacheInfo>(decoded.get()))
+    {
+      REGOTH_LOG(Warning, Uncategorized, "[ShaderCacheInfo] {0} is not a shader cache info",
+                 path.toString());
+      return nullptr;
+    }
+
+    auto info = std::static_pointer_cast<ShaderCacheInfo>(decoded);
+
+    if (info->version != VERSION) return nullptr;
+
+    return info;
+  }
+
+  void ShaderCacheInfo::save(const bs::Path& path) const
+  {
+    bs::FileEncoder encoder(path);
+    encoder.encode(const_cast<ShaderCacheInfo*>(this));
+  }
+
+  bool ShaderCacheInfo::isUpToDate(const bs::String& name, bs::UINT64 sourceHash) const
+  {
+    for (size_t i = 0; i < names.size() && i < sourceHashes.size(); i++)
+    {
+      if (names[i] == name) return sourceHashes[i] == sourceHash;
+    }
+
+    return false;
+  }
+
+  void ShaderCacheInfo::setImported(const bs::String& name, bs::UINT64 sourceHash)
+  {
+    sourceHashes.resize(names.size());
+
+    for (size_t i = 0; i < names.size(); i++)
+    {
+      if (names[i] == name)
+      {
+        sourceHashes[i] = sourceHash;
+        return;
+      }
+    }
+
+    names.push_back(name);
+    sourceHashes.push_back(sourceHash);
+  }
+
+  REGOTH_DEFINE_RTTI(ShaderCacheInfo)
+}  // namespace REGoth
@@ -0,0 +1,70 @@
+/** \file
+ */
+
+#pragma once
+
+#include <BsPrerequisites.h>
+#include <RTTI/RTTIUtil.hpp>
+#include <Reflection/BsIReflectable.h>
+
+namespace REGoth
+{
+  /**
+   * What the shaders cached by EngineContent have been imported from, stored next to them.
+   *
+   * Cached shaders used to be loaded whenever they were there. Since a shader is compiled
+   * for the render API active while it is imported, a cache written by a headless run with
+   * the null render API or from an older version of `content/shaders` kept being used. With
+   * this, a cached shader is only used if both its source and the render API still match,
+   * otherwise it is imported again, see isUpToDate().
+   */
+  class ShaderCacheInfo : public bs::IReflectable
+  {
+  public:
+    /**
+     * Version of the cache format. Has to be increased whenever something about how shaders
+     * are imported changes, so that old caches are not used anymore.
+     */
+    static constexpr bs::UINT32 VERSION = 1;
+
+    ShaderCacheInfo() = default;
+
+    /**
+     * @return The info saved at the given path. Empty if there is none, it can't be read or
+     *         it has been saved with another VERSION.
+     */
+    static bs::SPtr<ShaderCacheInfo> load(const bs::Path& path);
+
+    void save(const bs::Path& path) const;
+
+    /**
+     * @return Whether the cached shader with the given name has been imported from a source
+     *         with the given hash.
+     */
+    bool isUpToDate(const bs::String& name, bs::UINT64 sourceHash) const;
+
+    /**
+     * Notes that the shader with the given name has been imported from a source with the
+     * given hash and cached.
+     */
+    void setImported(const bs::String& name, bs::UINT64 sourceHash);
+
+    /**
+     * Format version the info has been saved with.
+     */
+    bs::UINT32 version = VERSION;
+
+    /**
+     * Render API all cached shaders have been compiled for, e.g. `bsfVulkanRenderAPI`.
+     */
+    bs::String renderAPI;
+
+    /**
+     * The cached shaders, one entry per shader in each array.
+     */
+    bs::Vector<bs::String> names;
+    bs::Vector<bs::UINT64> sourceHashes;
+
+    REGOTH_DECLARE_RTTI_FOR_REFLECTABLE(ShaderCacheInfo)
+  };
+}  // namespace REGoth
@@ -0,0 +1,226 @@
+#include "logging.hpp"
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace REGoth
+{
+  namespace LogCategories
+  {
+    using namespace ::bs;
+
+    BS_LOG_CATEGORY_IMPL(VM)
+    BS_LOG_CATEGORY_IMPL(AI)
+    BS_LOG_CATEGORY_IMPL(VDFS)
+    BS_LOG_CATEGORY_IMPL(World)
+    BS_LOG_CATEGORY_IMPL(Anim)
+    BS_LOG_CATEGORY_IMPL(UI)
+  }  // namespace LogCategories
+
+  namespace Logging
+  {
+    std::atomic<bs::INT32> gVerbosityLimits[MAX_FILTERED_CATEGORIES];
+
+    /**
+     * Queue of entries written by a background thread.
+     *
+     * Logging threads push onto a lock-free stack. The writer takes the whole stack at once,
+     * reverses it to get the entries in the order they were pushed, then formats and writes
+     * them. Writing is serialized via a mutex only the writer and flush() take, so the order
+     * of the entries is kept even if both write at the same time.
+     */
+    class LogQueue
+    {
+    public:
+      LogQueue()
+      {
+        // Constructed first, so it's destroyed after the queue has written everything
+        bs::gDebug();
+      }
+
+      ~LogQueue()
+      {
+        stop();
+      }
+
+      void push(Entry* entry)
+      {
+        if (!mIsAsync.load(std::memory_order_relaxed) ||
+            entry->verbosity <= bs::LogVerbosity::Error)
+        {
+          std::unique_ptr<Entry> owned(entry);
+
+          // Write whatever came before, so the error isn't seemingly logged too early
+          std::lock_guard<std::mutex> lock(mWriteMutex);
+
+          writeQueued();
+          write(*owned);
+
+          return;
+        }
+
+        ensureWriterIsRunning();
+
+        entry->next = mHead.load(std::memory_order_relaxed);
+
+        while (!mHead.compare_exchange_weak(entry->next, entry, std::memory_order_release,
+                                            std::memory_order_relaxed))
+        {
+          // entry->next now holds the head pushed by another thread, try again
+        }
+
+        // No lock taken, so a wakeup may be missed. The writer also wakes up on its own.
+        mWakeUp.notify_one();
+      }
+
+      void setAsync(bool async)
+      {
+        mIsAsync.store(async, std::memory_order_relaxed);
+
+        if (!async) flush();
+      }
+
+      void flush()
+      {
+        std::lock_guard<std::mutex> lock(mWriteMutex);
+
+        writeQueued();
+      }
+
+      void stop()
+      {
+        mIsAsync.store(false, std::memory_order_relaxed);
+
+        {
+          std::lock_guard<std::mutex> lock(mThreadMutex);
+
+          mIsStopping = true;
+        }
+
+        mWakeUp.notify_one();
+
+        if (mWriter.joinable()) mWriter.join();
+
+        flush();
+      }
+
+    private:
+      void ensureWriterIsRunning()
+      {
+        if (mIsWriterRunning.load(std::memory_order_acquire)) return;
+
+        std::lock_guard<std::mutex> lock(mThreadMutex);
+
+        if (mIsWriterRunning.load(std::memory_order_relaxed) || mIsStopping) return;
+
+        mWriter = std::thread([this]() { runWriter(); });
+        mIsWriterRunning.store(true, std::memory_order_release);
+      }
+
+      void runWriter()
+      {
+        for (;;)
+        {
+          {
+            std::lock_guard<std::mutex> lock(mWriteMutex);
+
+            writeQueued();
+          }
+
+          std::unique_lock<std::mutex> lock(mThreadMutex);
+
+          if (mIsStopping) return;
+
+          mWakeUp.wait_for(lock, std::chrono::milliseconds(10));
+        }
+      }
+
+      /**
+       * Writes everything pushed so far. Must be called with mWriteMutex locked.
+       */
+      void writeQueued()
+      {
+        Entry* head = mHead.exchange(nullptr, std::memory_order_acquire);
+
+        // The stack has the newest entry on top
+        Entry* ordered = nullptr;
+
+        while (head)
+        {
+          Entry* next = head->next;
+          head->next  = ordered;
+          ordered     = head;
+          head        = next;
+        }
+
+        while (ordered)
+        {
+          std::unique_ptr<Entry> entry(ordered);
+          ordered = ordered->next;
+
+          write(*entry);
+        }
+      }
+
+      void write(const Entry& entry)
+      {
+        bs::gDebug().log(entry.format(), entry.verbosity, entry.category);
+      }
+
+      std::atomic<Entry*> mHead  = {nullptr};
+      std::atomic<bool> mIsAsync = {true};
+      std::mutex mWriteMutex;
+
+      std::mutex mThreadMutex;
+      std::condition_variable mWakeUp;
+      std::thread mWriter;
+      std::atomic<bool> mIsWriterRunning = {false};
+      bool mIsStopping = false;
+    };
+
+    static LogQueue& queue()
+    {
+      static LogQueue s_queue;
+      return s_queue;
+    }
+
+    void setMaxVerbosity(bs::UINT32 category, bs::LogVerbosity verbosity)
+    {
+      if (category >= MAX_FILTERED_CATEGORIES) return;
+
+      bs::INT32 limit = static_cast<bs::INT32>(verbosity) + 1;
+
+      gVerbosityLimits[category].store(limit, std::memory_order_relaxed);
+    }
+
+    void setMaxVerbosity(bs::LogVerbosity verbosity)
+    {
+      for (bs::UINT32 category = 0; category < MAX_FILTERED_CATEGORIES; category++)
+      {
+        setMaxVerbosity(category, verbosity);
+      }
+    }
+
+    void setAsync(bool async)
+    {
+      queue().setAsync(async);
+    }
+
+    void flush()
+    {
+      queue().flush();
+    }
+
+    void shutdown()
+    {
+      queue().stop();
+    }
+
+    void push(Entry* entry)
+    {
+      queue().push(entry);
+    }
+  }  // namespace Logging
+}  // namespace REGoth
@@ -1,20 +1,325 @@
 #pragma once
 
 #include <Debug/BsDebug.h>
+#include <atomic>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+/**
+ * Most verbose level compiled in for REGoth's log categories, unless set for a category via
+ * `REGOTH_LOG_VERBOSITY_<CATEGORY>`, e.g. `-DREGOTH_LOG_VERBOSITY_VM=VeryVerbose`. Debug
+ * builds keep verbose messages, release builds stop at Info. Messages above the level of
+ * their category compile to nothing, arguments included.
+ */
+#ifndef REGOTH_LOG_VERBOSITY_DEFAULT
+#  ifdef NDEBUG
+#    define REGOTH_LOG_VERBOSITY_DEFAULT Info
+#  else
+#    define REGOTH_LOG_VERBOSITY_DEFAULT Verbose
+#  endif
+#endif
+
+#ifndef REGOTH_LOG_VERBOSITY_VM
+#  define REGOTH_LOG_VERBOSITY_VM REGOTH_LOG_VERBOSITY_DEFAULT
+#endif
+
+#ifndef REGOTH_LOG_VERBOSITY_AI
+#  define REGOTH_LOG_VERBOSITY_AI REGOTH_LOG_VERBOSITY_DEFAULT
+#endif
+
+#ifndef REGOTH_LOG_VERBOSITY_VDFS
+#  define REGOTH_LOG_VERBOSITY_VDFS REGOTH_LOG_VERBOSITY_DEFAULT
+#endif
+
+#ifndef REGOTH_LOG_VERBOSITY_WORLD
+#  define REGOTH_LOG_VERBOSITY_WORLD REGOTH_LOG_VERBOSITY_DEFAULT
+#endif
+
+#ifndef REGOTH_LOG_VERBOSITY_ANIM
+#  define REGOTH_LOG_VERBOSITY_ANIM REGOTH_LOG_VERBOSITY_DEFAULT
+#endif
+
+#ifndef REGOTH_LOG_VERBOSITY_UI
+#  define REGOTH_LOG_VERBOSITY_UI REGOTH_LOG_VERBOSITY_DEFAULT
+#endif
+
+namespace REGoth
+{
+  /**
+   * REGoth's own log categories, to be used with REGOTH_LOG(). Everything not fitting any of
+   * these goes to `Uncategorized`. IDs start at 100 to stay clear of the ones of bs:f.
+   */
+  namespace LogCategories
+  {
+    BS_LOG_CATEGORY(VM, 100)    /**< Script VM and externals */
+    BS_LOG_CATEGORY(AI, 101)    /**< Character AI, event queues and pathfinding */
+    BS_LOG_CATEGORY(VDFS, 102)  /**< Packages and files of the virtual file system */
+    BS_LOG_CATEGORY(World, 103) /**< World import, caching, saving and streaming */
+    BS_LOG_CATEGORY(Anim, 104)  /**< Animation playback and root motion */
+    BS_LOG_CATEGORY(UI, 105)    /**< UI elements */
+  }  // namespace LogCategories
+
+  /**
+   * Finds the log categories of both REGoth and bs:f, so REGOTH_LOG() can name either
+   * without pulling them into the scope of the caller.
+   */
+  namespace LogCategoryLookup
+  {
+    using namespace ::bs;
+    using namespace ::REGoth::LogCategories;
+
+    /**
+     * Most verbose level bs:f keeps in any category.
+     */
+    constexpr LogVerbosity BSF_LOG_VERBOSITY = BS_LOG_VERBOSITY;
+  }  // namespace LogCategoryLookup
+
+  namespace Logging
+  {
+    /**
+     * Most verbose level compiled in for the given log category, see
+     * REGOTH_LOG_VERBOSITY_DEFAULT. Categories of bs:f keep everything up to
+     * BS_LOG_VERBOSITY.
+     */
+    template <typename Category>
+    struct CompiledVerbosity
+    {
+      static constexpr bs::LogVerbosity value = bs::LogVerbosity::Any;
+    };
+
+#define REGOTH_LOG_COMPILED_VERBOSITY(category, verbosity)                 \
+  template <>                                                              \
+  struct CompiledVerbosity<::REGoth::LogCategories::LogCategory##category> \
+  {                                                                        \
+    static constexpr bs::LogVerbosity value = bs::LogVerbosity::verbosity; \
+  };
+
+    REGOTH_LOG_COMPILED_VERBOSITY(VM, REGOTH_LOG_VERBOSITY_VM)
+    REGOTH_LOG_COMPILED_VERBOSITY(AI, REGOTH_LOG_VERBOSITY_AI)
+    REGOTH_LOG_COMPILED_VERBOSITY(VDFS, REGOTH_LOG_VERBOSITY_VDFS)
+    REGOTH_LOG_COMPILED_VERBOSITY(World, REGOTH_LOG_VERBOSITY_WORLD)
+    REGOTH_LOG_COMPILED_VERBOSITY(Anim, REGOTH_LOG_VERBOSITY_ANIM)
+    REGOTH_LOG_COMPILED_VERBOSITY(UI, REGOTH_LOG_VERBOSITY_UI)
+
+#undef REGOTH_LOG_COMPILED_VERBOSITY
+
+    /**
+     * Number of log categories which can be filtered at runtime, see setMaxVerbosity().
+     * Categories with higher IDs are only filtered at compile time.
+     */
+    constexpr bs::UINT32 MAX_FILTERED_CATEGORIES = 128;
+
+    /**
+     * Per category, the first level not logged anymore, checked by REGOTH_LOG() before
+     * anything is formatted. 0 if only BS_LOG_VERBOSITY applies, so the filters work from
+     * the start of static initialization. Use isEnabled() and setMaxVerbosity() instead of
+     * accessing this directly.
+     */
+    extern std::atomic<bs::INT32> gVerbosityLimits[MAX_FILTERED_CATEGORIES];
+
+    /**
+     * @return Whether messages of the given verbosity and category are logged right now.
+     */
+    inline bool isEnabled(bs::LogVerbosity verbosity, bs::UINT32 category)
+    {
+      if (category >= MAX_FILTERED_CATEGORIES) return true;
+
+      bs::INT32 limit = gVerbosityLimits[category].load(std::memory_order_relaxed);
+
+      return limit == 0 || static_cast<bs::INT32>(verbosity) < limit;
+    }
+
+    /**
+     * Sets the most verbose level to log for the given category, e.g. `LogVerbosity::Warning`
+     * to only log warnings and errors from then on. Levels more verbose than BS_LOG_VERBOSITY
+     * are never logged, as they are compiled out.
+     */
+    void setMaxVerbosity(bs::UINT32 category, bs::LogVerbosity verbosity);
+
+    /**
+     * Sets the most verbose level to log for all categories, see above.
+     */
+    void setMaxVerbosity(bs::LogVerbosity verbosity);
+
+    /**
+     * Sets whether messages are handed to a background thread, which formats and writes
+     * them. This is the default, so logging doesn't slow down the logging thread. Errors
+     * and fatal messages are always written right away, after everything queued before.
+     */
+    void setAsync(bool async);
+
+    /**
+     * Writes all queued messages on the calling thread and returns once they are written.
+     */
+    void flush();
+
+    /**
+     * Writes all queued messages, stops the background thread and logs everything right
+     * away from then on. To be called before shutting down bs:f.
+     */
+    void shutdown();
+
+    /**
+     * Message format of a log entry. String literals are kept as pointers, everything else
+     * is copied, as the entry may be formatted after the caller has moved on.
+     */
+    class Message
+    {
+    public:
+      template <size_t N>
+      Message(const char (&literal)[N])
+          : mLiteral(literal)
+      {
+      }
+
+      Message(bs::String text)
+          : mText(std::move(text))
+      {
+      }
+
+      const char* c_str() const
+      {
+        return mLiteral ? mLiteral : mText.c_str();
+      }
+
+    private:
+      const char* mLiteral = nullptr;
+      bs::String mText;
+    };
+
+    /**
+     * Log entry waiting to be formatted and written, see push().
+     */
+    struct Entry
+    {
+      Entry(bs::LogVerbosity verbosity, bs::UINT32 category, Message message)
+          : verbosity(verbosity)
+          , category(category)
+          , message(std::move(message))
+      {
+      }
+
+      virtual ~Entry() = default;
+
+      /**
+       * @return The message with all arguments filled in.
+       */
+      virtual bs::String format() const = 0;
+
+      Entry* next = nullptr;
+      bs::LogVerbosity verbosity;
+      bs::UINT32 category;
+      Message message;
+    };
+
+    /**
+     * How an argument of a log call is stored until it is formatted. C strings are copied,
+     * as they most likely point into a string owned by the caller.
+     */
+    template <typename T>
+    struct StoredArg
+    {
+      using type = typename std::decay<T>::type;
+    };
+
+    template <>
+    struct StoredArg<const char*>
+    {
+      using type = bs::String;
+    };
+
+    template <>
+    struct StoredArg<char*>
+    {
+      using type = bs::String;
+    };
+
+    template <typename T>
+    using StoredArgT = typename StoredArg<typename std::decay<T>::type>::type;
+
+    /**
+     * Entry with the arguments of the log call, formatted once written.
+     */
+    template <typename... Args>
+    struct FormattedEntry : Entry
+    {
+      template <typename... CallArgs>
+      FormattedEntry(bs::LogVerbosity verbosity, bs::UINT32 category, Message message,
+                     CallArgs&&... callArgs)
+          : Entry(verbosity, category, std::move(message))
+          , args(std::forward<CallArgs>(callArgs)...)
+      {
+      }
+
+      bs::String format() const override
+      {
+        return formatWith(std::index_sequence_for<Args...>());
+      }
+
+      template <size_t... I>
+      bs::String formatWith(std::index_sequence<I...>) const
+      {
+        return bs::StringUtil::format(message.c_str(), std::get<I>(args)...);
+      }
+
+      std::tuple<Args...> args;
+    };
+
+    /**
+     * Queues the entry or writes it right away, depending on its verbosity and setAsync().
+     * Takes ownership of the entry. Never blocks on other logging threads while queueing.
+     */
+    void push(Entry* entry);
+
+    /**
+     * Logs the given message, see REGOTH_LOG().
+     */
+    template <typename... Args>
+    void log(bs::LogVerbosity verbosity, bs::UINT32 category, Message message, Args&&... args)
+    {
+      push(new FormattedEntry<StoredArgT<Args>...>(verbosity, category, std::move(message),
+                                                   std::forward<Args>(args)...));
+    }
+  }  // namespace Logging
+}  // namespace REGoth
+
+/**
+ * Whether messages of the given verbosity and category are compiled in at all. A constant,
+ * so work only needed for a message can be skipped as well, e.g.
+ * `if (REGOTH_LOG_IS_COMPILED(Verbose, VM) && ...)`.
+ */
+#define REGOTH_LOG_IS_COMPILED(verbosity, category)                                   \
+  (::bs::LogVerbosity::verbosity <= ::REGoth::LogCategoryLookup::BSF_LOG_VERBOSITY && \
+   ::bs::LogVerbosity::verbosity <=                                                   \
+       ::REGoth::Logging::CompiledVerbosity<                                          \
+           ::REGoth::LogCategoryLookup::LogCategory##category>::value)
+
+/**
+ * ID of the given log category of REGoth or bs:f.
+ */
+#define REGOTH_LOG_CATEGORY_ID(category) ::REGoth::LogCategoryLookup::LogCategory##category::_id
 
 /**
  * Wrapper around bs::gDebug().log(...), similar to BS_LOG, which is a bit too verbose.
  *
  * BS_LOG will output the location of the log call by default, which includes the rather lengthy
  * function signature.
+ *
+ * The category is either one of REGoth::LogCategories or of bs:f. Messages more verbose than
+ * compiled in for their category compile to nothing, see REGOTH_LOG_IS_COMPILED(). The others
+ * are filtered by the verbosity set for their category at runtime before anything is
+ * evaluated, see REGoth::Logging::setMaxVerbosity(). The arguments are copied and formatted,
+ * together with the message, on a background thread, see REGoth::Logging::setAsync().
  */
-#define REGOTH_LOG(verbosity, category, message, ...)                                        \
-  do                                                                                         \
-  {                                                                                          \
-    using namespace ::bs;                                                                    \
-    if (static_cast<INT32>(LogVerbosity::verbosity) <= static_cast<INT32>(BS_LOG_VERBOSITY)) \
-    {                                                                                        \
-      gDebug().log(StringUtil::format(message, ##__VA_ARGS__), LogVerbosity::verbosity,      \
-                   LogCategory##category::_id);                                              \
-    }                                                                                        \
+#define REGOTH_LOG(verbosity, category, message, ...)                                            \
+  do                                                                                             \
+  {                                                                                              \
+    using namespace ::bs;                                                                        \
+    if (REGOTH_LOG_IS_COMPILED(verbosity, category) &&                                           \
+        ::REGoth::Logging::isEnabled(LogVerbosity::verbosity, REGOTH_LOG_CATEGORY_ID(category))) \
+    {                                                                                            \
+      ::REGoth::Logging::log(LogVerbosity::verbosity, REGOTH_LOG_CATEGORY_ID(category),          \
+                             message, ##__VA_ARGS__);                                            \
+    }                                                                                            \
   } while (0)
@@ -0,0 +1,381 @@
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <BsApplication.h>
+#include <Components/BsCCamera.h>
+#include <FileSystem/BsDataStream.h>
+#include <FileSystem/BsFileSystem.h>
+#include <Scene/BsComponent.h>
+#include <Scene/BsSceneObject.h>
+#include <String/BsString.h>
+#include <Utility/BsTime.h>
+
+#include <core.hpp>
+#include <components/Character.hpp>
+#include <components/CharacterAI.hpp>
+#include <components/GameWorld.hpp>
+#include <components/VisualCharacter.hpp>
+#include <exception/Throw.hpp>
+#include <log/logging.hpp>
+
+/**
+ * Spawns more and more characters moving around in a world and logs how long their
+ * animations take per frame.
+ *
+ * For every count given via `--counts`, characters are added until there are that many.
+ * Every new character is put into a random state of moving around, e.g. walking backwards
+ * while turning, so more than one clip gets sampled. The numbers come from a generator
+ * seeded via `--seed`, so every run does the same.
+ *
+ * Then the game runs for `--frames` frames with the RootMotionStage of the world computing
+ * in parallel and for another `--frames` frames with it computing on the main thread. For
+ * both, the average time per frame of the phases of GameWorld::fixedUpdate() is logged:
+ * event queues, root motion and moving the characters. The rest of the frame is mostly the
+ * skeletal animation done by bs:f's animation system, which samples the clips and uploads
+ * the bones on its own and can't be split further from here.
+ *
+ * All results are also written as a single JSON object, to the file given via `--output`
+ * or to stdout, so runs can be compared across commits.
+ */
+struct AnimationBenchmarkConfig : public REGoth::EngineConfig
+{
+  virtual void registerCLIOptions(cxxopts::Options& opts) override
+  {
+    const std::string grp = "AnimationBenchmark";
+    opts.add_option(grp, "w", "world", "Name of the world to load",
+                    cxxopts::value<bs::String>(world), "[NAME]");
+    opts.add_option(grp, "", "instance", "Script instance of the characters to spawn",
+                    cxxopts::value<bs::String>(instance), "[NAME]");
+    opts.add_option(grp, "", "counts", "Comma separated numbers of characters to measure with",
+                    cxxopts::value<std::vector<bs::UINT32>>(counts), "[NUMS]");
+    opts.add_option(grp, "", "frames", "Number of frames to measure each count for",
+                    cxxopts::value<bs::UINT32>(numFrames), "[NUM]");
+    opts.add_option(grp, "", "seed", "Seed of the random states of the characters",
+                    cxxopts::value<bs::UINT32>(seed), "[NUM]");
+    opts.add_option(grp, "", "output", "Write the results as JSON to PATH instead of stdout",
+                    cxxopts::value<bs::String>(outputPath), "[PATH]");
+  }
+
+  virtual void verifyCLIOptions() override
+  {
+    if (world.empty())
+    {
+      REGOTH_THROW(InvalidStateException, "World cannot be empty.");
+    }
+
+    if (counts.empty())
+    {
+      REGOTH_THROW(InvalidStateException, "Need at least one count.");
+    }
+
+    if (numFrames == 0)
+    {
+      REGOTH_THROW(InvalidStateException, "Need at least one frame.");
+    }
+
+    bs::StringUtil::toUpperCase(world);
+    if (!bs::StringUtil::endsWith(world, ".ZEN"))
+    {
+      world += ".ZEN";
+    }
+
+    bs::StringUtil::toUpperCase(instance);
+  }
+
+  bs::String world;
+  bs::String instance            = "PC_HERO";
+  std::vector<bs::UINT32> counts = {25, 50, 100, 200};
+  bs::UINT32 numFrames           = 200;
+  bs::UINT32 seed                = 5489;
+  bs::String outputPath;
+};
+
+/**
+ * Does the measuring, since that needs the game to run.
+ */
+class AnimationBenchmarkRunner : public bs::Component
+{
+public:
+  AnimationBenchmarkRunner(const bs::HSceneObject& parent, REGoth::HGameWorld world,
+                           const AnimationBenchmarkConfig* config)
+      : bs::Component(parent)
+      , mWorld(world)
+      , mConfig(config)
+      , mRandom(config->seed)
+  {
+    setName("AnimationBenchmarkRunner");
+  }
+
+  void onInitialized() override
+  {
+    spawnCharacters();
+  }
+
+  void update() override
+  {
+    Measurement& m = currentMeasurement();
+    m.frameSeconds += bs::gTime().getFrameDelta();
+    m.numFrames += 1;
+
+    mFrame += 1;
+
+    mWorld->rootMotionStage().setParallel(mFrame < mConfig->numFrames);
+
+    if (mFrame < 2 * mConfig->numFrames) return;
+
+    report();
+
+    mNextCount += 1;
+
+    if (mNextCount == mConfig->counts.size())
+    {
+      writeResults();
+      bs::gApplication().quitRequested();
+      return;
+    }
+
+    spawnCharacters();
+  }
+
+  void fixedUpdate() override
+  {
+    // Depending on the order of components, these might be the stats of the fixed update
+    // before. Either way, every fixed update is counted once.
+    const REGoth::GameWorld::FixedUpdateStats& stats = mWorld->lastFixedUpdateStats();
+
+    Measurement& m = currentMeasurement();
+    m.eventQueuesNanoseconds += stats.nanosecondsEventQueues;
+    m.rootMotionNanoseconds += stats.nanosecondsRootMotion;
+    m.movementNanoseconds += stats.nanosecondsMovement;
+  }
+
+private:
+  struct Measurement
+  {
+    bs::UINT64 eventQueuesNanoseconds = 0;
+    bs::UINT64 rootMotionNanoseconds  = 0;
+    bs::UINT64 movementNanoseconds    = 0;
+    double frameSeconds               = 0;
+    bs::UINT32 numFrames              = 0;
+
+    /** Average per frame, in milliseconds */
+    double perFrameMs(double nanoseconds) const
+    {
+      return nanoseconds / 1000000.0 / numFrames;
+    }
+
+    double frameMs() const
+    {
+      return frameSeconds * 1000.0 / numFrames;
+    }
+
+    /** What the frame took besides the phases of the fixed updates */
+    double restMs() const
+    {
+      return frameMs() - perFrameMs((double)(eventQueuesNanoseconds + rootMotionNanoseconds +
+                                             movementNanoseconds));
+    }
+  };
+
+  Measurement& currentMeasurement()
+  {
+    return mFrame < mConfig->numFrames ? mParallel : mSerial;
+  }
+
+  /**
+   * Spawns characters until there are as many as the next count and puts the new ones into
+   * a random state of moving around.
+   */
+  void spawnCharacters()
+  {
+    using namespace REGoth;
+
+    const bs::Vector3 center = mWorld->hero()->SO()->getTransform().pos();
+
+    // Spread out on a grid, so they don't all stand inside each other
+    constexpr bs::UINT32 CHARACTERS_PER_ROW = 16;
+    constexpr float SPACING                 = 2.0f;
+
+    bs::UINT32 count = mConfig->counts[mNextCount];
+
+    while (mCharacters.size() < count)
+    {
+      bs::UINT32 i = (bs::UINT32)mCharacters.size();
+
+      bs::Transform transform;
+      transform.setPosition(center + bs::Vector3((i % CHARACTERS_PER_ROW) * SPACING, 0.0f,
+                                                 (i / CHARACTERS_PER_ROW + 1) * SPACING));
+
+      HCharacter character = mWorld->insertCharacter(mConfig->instance, transform);
+
+      // Model scripts load in the background, but the states need the animations right away
+      character->visual()->finishLoadingVisual();
+
+      startRandomMovement(character);
+
+      mCharacters.push_back(character);
+    }
+
+    mFrame    = 0;
+    mParallel = {};
+    mSerial   = {};
+
+    mWorld->rootMotionStage().setParallel(true);
+  }
+
+  void startRandomMovement(REGoth::HCharacter character)
+  {
+    REGoth::HCharacterAI ai = character->ai();
+
+    if (mRandom() % 2 == 0) ai->tryToggleWalking();
+
+    switch (mRandom() % 5)
+    {
+      case 0:
+        ai->goForward();
+        break;
+
+      case 1:
+        ai->goBackward();
+        break;
+
+      case 2:
+        ai->strafeLeft();
+        break;
+
+      case 3:
+        ai->strafeRight();
+        break;
+
+      default:
+        ai->stopMoving();
+        break;
+    }
+
+    // Turning keeps the moving ones around where they started
+    switch (mRandom() % 3)
+    {
+      case 0:
+        ai->turnLeft();
+        break;
+
+      case 1:
+        ai->turnRight();
+        break;
+
+      default:
+        break;
+    }
+  }
+
+  void report()
+  {
+    auto record = [this](const char* mode, const Measurement& m) {
+      REGOTH_LOG(Info, Uncategorized,
+                 "[AnimationBenchmark] {0} characters, {1}: frame {2} ms, event queues {3} ms, "
+                 "root motion {4} ms, movement {5} ms, rest {6} ms",
+                 mCharacters.size(), mode, m.frameMs(),
+                 m.perFrameMs((double)m.eventQueuesNanoseconds),
+                 m.perFrameMs((double)m.rootMotionNanoseconds),
+                 m.perFrameMs((double)m.movementNanoseconds), m.restMs());
+
+      if (!mResultsJson.empty()) mResultsJson += ", ";
+
+      mResultsJson += "{";
+      mResultsJson += "\"characters\": " + bs::toString((bs::UINT32)mCharacters.size()) + ", ";
+      mResultsJson += "\"mode\": \"" + bs::String(mode) + "\", ";
+      mResultsJson += "\"frameMs\": " + bs::toString(m.frameMs()) + ", ";
+      mResultsJson += "\"eventQueuesMs\": " +
+                      bs::toString(m.perFrameMs((double)m.eventQueuesNanoseconds)) + ", ";
+      mResultsJson += "\"rootMotionMs\": " +
+                      bs::toString(m.perFrameMs((double)m.rootMotionNanoseconds)) + ", ";
+      mResultsJson += "\"movementMs\": " +
+                      bs::toString(m.perFrameMs((double)m.movementNanoseconds)) + ", ";
+      mResultsJson += "\"restMs\": " + bs::toString(m.restMs());
+      mResultsJson += "}";
+    };
+
+    record("parallel", mParallel);
+    record("serial", mSerial);
+  }
+
+  void writeResults() const
+  {
+    bs::String json = "{";
+    json += "\"instance\": \"" + mConfig->instance + "\", ";
+    json += "\"frames\": " + bs::toString(mConfig->numFrames) + ", ";
+    json += "\"results\": [" + mResultsJson + "]";
+    json += "}";
+
+    if (mConfig->outputPath.empty())
+    {
+      std::cout << json << std::endl;
+    }
+    else
+    {
+      bs::SPtr<bs::DataStream> stream = bs::FileSystem::createAndOpenFile(mConfig->outputPath);
+      stream->write(json.data(), json.size());
+      stream->close();
+    }
+  }
+
+  REGoth::HGameWorld mWorld;
+  const AnimationBenchmarkConfig* mConfig;
+
+  bs::Vector<REGoth::HCharacter> mCharacters;
+  size_t mNextCount = 0;
+  bs::UINT32 mFrame = 0;
+  Measurement mParallel;
+  Measurement mSerial;
+  std::mt19937 mRandom;
+
+  /** Results of all counts so far, separated by commas, see writeResults() */
+  bs::String mResultsJson;
+};
+
+class REGothAnimationBenchmark : public REGoth::Engine
+{
+public:
+  REGothAnimationBenchmark(std::unique_ptr<const AnimationBenchmarkConfig>&& config)
+      : mConfig{std::move(config)}
+  {
+    // pass
+  }
+
+  const AnimationBenchmarkConfig* config() const override
+  {
+    return mConfig.get();
+  }
+
+  void setupScene() override
+  {
+    using namespace REGoth;
+
+    // No init scripts, so the spawned characters are the only ones
+    HGameWorld world = GameWorld::importZEN(config()->world);
+
+    HCharacter hero = world->insertCharacter("PC_HERO", WORLD_STARTPOINT);
+    hero->useAsHero();
+
+    // Look at the characters, so they aren't culled
+    const bs::Vector3 center = hero->SO()->getTransform().pos();
+    mMainCamera->SO()->setPosition(center + bs::Vector3(0.0f, 10.0f, -10.0f));
+    mMainCamera->SO()->lookAt(center + bs::Vector3(0.0f, 0.0f, 10.0f));
+
+    world->SO()->addComponent<AnimationBenchmarkRunner>(world, config());
+  }
+
+private:
+  std::unique_ptr<const AnimationBenchmarkConfig> mConfig;
+};
+
+int main(int argc, char** argv)
+{
+  auto config = REGoth::parseArguments<AnimationBenchmarkConfig>(argc, argv);
+  REGothAnimationBenchmark engine{std::move(config)};
+
+  return REGoth::runEngine(engine);
+}
@@ -0,0 +1,777 @@
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <BsApplication.h>
+#include <FileSystem/BsDataStream.h>
+#include <FileSystem/BsFileSystem.h>
+#include <Scene/BsSceneObject.h>
+#include <String/BsString.h>
+
+#include <core.hpp>
+#include <components/Character.hpp>
+#include <components/CharacterEventQueue.hpp>
+#include <components/GameWorld.hpp>
+#include <components/Inventory.hpp>
+#include <components/Waynet.hpp>
+#include <core/Random.hpp>
+#include <exception/Throw.hpp>
+#include <log/logging.hpp>
+#include <original-content/VirtualFileSystem.hpp>
+#include <scripting/ScriptClassTemplates.hpp>
+#include <scripting/ScriptObjectStorage.hpp>
+#include <scripting/ScriptSymbolQueries.hpp>
+#include <scripting/ScriptSymbolStorage.hpp>
+#include <scripting/ScriptVMForGameWorld.hpp>
+#include <scripting/daedalus/DaedalusClassVarResolver.hpp>
+#include <scripting/daedalus/DaedalusStack.hpp>
+#include <scripting/daedalus/DaedalusStringPool.hpp>
+
+/**
+ * Results of the benchmarks end up here, so the compiler can't drop the work producing them.
+ */
+static volatile bs::UINT64 s_Sink = 0;
+
+/**
+ * Suite of micro benchmarks for the hot paths of the engine, to hold optimizations against.
+ *
+ * Every benchmark runs its body in batches, growing the batch until it takes at least
+ * `--min-time`. The batch is then timed `--repetitions` times. The log shows the median, the
+ * fastest and the slowest time per iteration. With `--out`, the results are also written as
+ * JSON, so runs of different builds can be compared by a script.
+ *
+ * Most benchmarks work on synthetic data of a fixed size, generated from a fixed seed, so
+ * their numbers only change with the code. The scripts of the game are needed for the
+ * Inventory, the VDFS is read from the game files. Benchmarks on characters, their event
+ * queues and the real waynet only run if a world is given via `--world`.
+ */
+struct BenchmarksConfig : public REGoth::EngineConfig
+{
+  virtual void registerCLIOptions(cxxopts::Options& opts) override
+  {
+    const std::string grp = "Benchmarks";
+    opts.add_option(grp, "", "filter", "Only run benchmarks whose name contains this",
+                    cxxopts::value<bs::String>(filter), "[TEXT]");
+    opts.add_option(grp, "", "min-time", "Time a batch of iterations has to take at least",
+                    cxxopts::value<float>(minTimeMilliseconds), "[MS]");
+    opts.add_option(grp, "", "repetitions", "How often to time the batch of every benchmark",
+                    cxxopts::value<bs::UINT32>(numRepetitions), "[NUM]");
+    opts.add_option(grp, "", "out", "Write the results to this file as JSON",
+                    cxxopts::value<bs::Path>(outPath), "[PATH]");
+    opts.add_option(grp, "w", "world",
+                    "World to run the benchmarks on characters and the real waynet in",
+                    cxxopts::value<bs::String>(world), "[NAME]");
+  }
+
+  virtual void verifyCLIOptions() override
+  {
+    if (numRepetitions == 0)
+    {
+      REGOTH_THROW(InvalidParametersException, "Need at least one repetition.");
+    }
+
+    if (world.empty()) return;
+
+    bs::StringUtil::toUpperCase(world);
+    if (!bs::StringUtil::endsWith(world, ".ZEN"))
+    {
+      world += ".ZEN";
+    }
+  }
+
+  bs::String filter;
+  float minTimeMilliseconds = 100.0f;
+  bs::UINT32 numRepetitions = 5;
+  bs::Path outPath;
+  bs::String world;
+};
+
+class REGothBenchmarks : public REGoth::Engine
+{
+public:
+  REGothBenchmarks(std::unique_ptr<const BenchmarksConfig>&& config)
+      : mConfig{std::move(config)}
+  {
+    // pass
+  }
+
+  const BenchmarksConfig* config() const override
+  {
+    return mConfig.get();
+  }
+
+  void setupScene() override
+  {
+    using namespace REGoth;
+
+    benchmarkDaedalusStack();
+    benchmarkScriptObjectStorage();
+    benchmarkClassVarResolution();
+    benchmarkSyntheticWaynet();
+    benchmarkVirtualFileSystem();
+
+    HGameWorld world = config()->world.empty() ? GameWorld::createEmpty()
+                                               : GameWorld::importZEN(config()->world);
+
+    benchmarkInventory(world);
+
+    if (!config()->world.empty())
+    {
+      HCharacter hero = world->insertCharacter("PC_HERO", WORLD_STARTPOINT);
+      hero->useAsHero();
+
+      world->runInitScripts();
+
+      benchmarkWorldWaynet(world);
+      benchmarkCharacters(world);
+      benchmarkWorldSnapshots(world);
+    }
+
+    writeResults();
+
+    bs::gApplication().quitRequested();
+  }
+
+private:
+  struct Result
+  {
+    bs::String name;
+    bs::UINT64 iterations;
+
+    /** Time per iteration, over all repetitions */
+    double medianNanoseconds;
+    double minNanoseconds;
+    double maxNanoseconds;
+  };
+
+  /**
+   * Runs `body(iterations)` until a batch takes long enough, then times the batch a few
+   * times, see BenchmarksConfig. The body has to do the same work every time it is called.
+   */
+  void run(const bs::String& name, const std::function<void(bs::UINT64)>& body)
+  {
+    if (!config()->filter.empty() && name.find(config()->filter) == bs::String::npos) return;
+
+    using Clock = std::chrono::high_resolution_clock;
+
+    auto timeBatch = [&](bs::UINT64 iterations) {
+      auto start = Clock::now();
+
+      body(iterations);
+
+      return std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+    };
+
+    // Whatever the benchmarked code logs would be measured as well
+    REGoth::Logging::setMaxVerbosity(bs::LogVerbosity::Warning);
+
+    const double minNanoseconds = config()->minTimeMilliseconds * 1000000.0;
+
+    bs::UINT64 iterations = 1;
+    double nanoseconds    = timeBatch(iterations);
+
+    while (nanoseconds < minNanoseconds)
+    {
+      // Aim a bit above the minimum, so the next batch most likely is the last one
+      double factor = nanoseconds > 0.0 ? minNanoseconds * 1.4 / nanoseconds : 10.0;
+
+      iterations  = (bs::UINT64)(iterations * std::min(10.0, std::max(2.0, factor)));
+      nanoseconds = timeBatch(iterations);
+    }
+
+    bs::Vector<double> perIteration;
+
+    for (bs::UINT32 i = 0; i < config()->numRepetitions; i++)
+    {
+      perIteration.push_back(timeBatch(iterations) / iterations);
+    }
+
+    REGoth::Logging::setMaxVerbosity(config()->logVerbosity);
+
+    std::sort(perIteration.begin(), perIteration.end());
+
+    Result result;
+    result.name              = name;
+    result.iterations        = iterations;
+    result.medianNanoseconds = perIteration[perIteration.size() / 2];
+    result.minNanoseconds    = perIteration.front();
+    result.maxNanoseconds    = perIteration.back();
+
+    REGOTH_LOG(Info, Uncategorized,
+               "[Benchmarks] {0}: {1} ns (min {2} ns, max {3} ns, {4} iterations)", name,
+               result.medianNanoseconds, result.minNanoseconds, result.maxNanoseconds,
+               iterations);
+
+    mResults.push_back(result);
+  }
+
+  void writeResults()
+  {
+    if (config()->outPath.isEmpty()) return;
+
+    std::ostringstream json;
+    json << "{\"benchmarks\": [";
+
+    for (size_t i = 0; i < mResults.size(); i++)
+    {
+      const Result& result = mResults[i];
+
+      json << (i > 0 ? "," : "") << "\n  {\"name\": \"" << result.name.c_str()
+           << "\", \"iterations\": " << result.iterations
+           << ", \"medianNs\": " << result.medianNanoseconds
+           << ", \"minNs\": " << result.minNanoseconds
+           << ", \"maxNs\": " << result.maxNanoseconds << "}";
+    }
+
+    json << "\n]}\n";
+
+    bs::SPtr<bs::DataStream> stream = bs::FileSystem::createAndOpenFile(config()->outPath);
+
+    if (!stream)
+    {
+      REGOTH_THROW(InvalidStateException,
+                   "Cannot write benchmark results to " + config()->outPath.toString());
+    }
+
+    std::string text = json.str();
+
+    stream->write(text.data(), text.size());
+    stream->close();
+  }
+
+  void benchmarkDaedalusStack()
+  {
+    using namespace REGoth::Scripting;
+
+    DaedalusStringPool strings;
+    DaedalusStack stack(strings);
+
+    run("DaedalusStack/PushPopInt", [&](bs::UINT64 iterations) {
+      bs::UINT64 sum = 0;
+
+      for (bs::UINT64 i = 0; i < iterations; i++)
+      {
+        stack.pushInt((bs::INT32)i);
+        stack.pushInt(1);
+        sum += stack.popInt() + stack.popInt();
+      }
+
+      s_Sink = sum;
+    });
+
+    run("DaedalusStack/PushPopFloat", [&](bs::UINT64 iterations) {
+      float sum = 0.0f;
+
+      for (bs::UINT64 i = 0; i < iterations; i++)
+      {
+        stack.pushFloat(0.5f);
+        sum += stack.popFloat();
+      }
+
+      s_Sink = (bs::UINT64)sum;
+    });
+
+    bs::INT32 variable = 0;
+
+    run("DaedalusStack/PushPopIntVariable", [&](bs::UINT64 iterations) {
+      bs::UINT64 sum = 0;
+
+      for (bs::UINT64 i = 0; i < iterations; i++)
+      {
+        stack.pushIntVariable(variable);
+        sum += *(bs::INT32*)stack.popIntVariable().global;
+      }
+
+      s_Sink = sum;
+    });
+  }
+
+  /**
+   * Handles of a few thousand script objects, in random order, so lookups don't just walk
+   * along the storage.
+   */
+  static bs::Vector<REGoth::Scripting::ScriptObjectHandle> createObjects(
+      REGoth::Scripting::ScriptObjectStorage& storage,
+      const std::function<void(REGoth::Scripting::ScriptObject&)>& init)
+  {
+    bs::Vector<REGoth::Scripting::ScriptObjectHandle> handles;
+
+    for (bs::UINT32 i = 0; i < NUM_SYNTHETIC_OBJECTS; i++)
+    {
+      REGoth::Scripting::ScriptObject& object = storage.create();
+      init(object);
+
+      handles.push_back(object.handle);
+    }
+
+    shuffle(handles);
+
+    return handles;
+  }
+
+  /**
+   * Brings the given values into a random order, the same on every run.
+   */
+  template <typename T>
+  static void shuffle(bs::Vector<T>& values)
+  {
+    REGoth::Random random(SEED);
+
+    for (size_t i = values.size(); i > 1; i--)
+    {
+      std::swap(values[i - 1], values[random.below((bs::UINT32)i)]);
+    }
+  }
+
+  void benchmarkScriptObjectStorage()
+  {
+    using namespace REGoth::Scripting;
+
+    ScriptObjectStorage storage;
+    auto handles = createObjects(storage, [](ScriptObject&) {});
+
+    run("ScriptObjectStorage/Get", [&](bs::UINT64 iterations) {
+      bs::UINT64 sum = 0;
+
+      for (bs::UINT64 i = 0; i < iterations; i++)
+      {
+        sum += storage.get(handles[i % handles.size()]).handle;
+      }
+
+      s_Sink = sum;
+    });
+
+    run("ScriptObjectStorage/IsValid", [&](bs::UINT64 iterations) {
+      bs::UINT64 sum = 0;
+
+      for (bs::UINT64 i = 0; i < iterations; i++)
+      {
+        sum += storage.isValid(handles[i % handles.size()]) ? 1 : 0;
+      }
+
+      s_Sink = sum;
+    });
+  }
+
+  /**
+   * Resolves a member of a synthetic class, `C_BENCHMARK.VALUE`, on script objects set as
+   * *Current Instance*, like the VM does for every access of a class variable.
+   */
+  void benchmarkClassVarResolution()
+  {
+    using namespace REGoth::Scripting;
+
+    ScriptSymbolStorage symbols;
+
+    SymbolIndex classSymbol = symbols.appendSymbol<SymbolClass>("C_BENCHMARK");
+    symbols.getSymbolBase(classSymbol).isClassVar      = false;
+    symbols.getSymbolBase(classSymbol).isKeptAfterLoad = false;
+
+    SymbolIndex memberSymbol = symbols.appendSymbol<SymbolInt>("C_BENCHMARK.VALUE");
+
+    SymbolInt& member      = symbols.getSymbol<SymbolInt>(memberSymbol);
+    member.parent          = classSymbol;
+    member.isClassVar      = true;
+    member.isKeptAfterLoad = false;
+    member.ints.resize(1);
+
+    symbols.buildQueryIndices();
+
+    ScriptClassTemplates templates;
+    templates.createClassTemplates(symbols);
+
+    ScriptObjectStorage objects;
+    auto handles = createObjects(objects, [&](ScriptObject& object) {
+      object.className = "C_BENCHMARK";
+      object.bindLayout(templates.getClassLayout("C_BENCHMARK"));
+    });
+
+    DaedalusClassVarResolver resolver(symbols, objects, templates);
+
+    run("DaedalusClassVarResolver/ResolveInts", [&](bs::UINT64 iterations) {
+      bs::UINT64 sum = 0;
+
+      for (bs::UINT64 i = 0; i < iterations; i++)
+      {
+        resolver.setCurrentInstance(handles[i % handles.size()]);
+        sum += resolver.resolveClassVariableInts(memberSymbol)[0] += 1;
+      }
+
+      s_Sink = sum;
+    });
+  }
+
+  /**
+   * Grid of waypoints 2 m apart, with paths to the neighbours, like the open parts of a world.
+   */
+  void benchmarkSyntheticWaynet()
+  {
+    using namespace REGoth;
+
+    const bs::UINT32 size = 64;
+
+    bs::HSceneObject waynetSO = bs::SceneObject::create("Waynet");
+    HWaynet waynet            = waynetSO->addComponent<Waynet>();
+
+    bs::Vector<WaypointIndex> grid;
+
+    for (bs::UINT32 y = 0; y < size; y++)
+    {
+      for (bs::UINT32 x = 0; x < size; x++)
+      {
+        grid.push_back(waynet->addWaypoint(bs::StringUtil::format("WP_{0}_{1}", x, y),
+                                           bs::Vector3(x * 2.0f, 0.0f, y * 2.0f),
+                                           bs::Vector3::UNIT_Z));
+      }
+    }
+
+    for (bs::UINT32 y = 0; y < size; y++)
+    {
+      for (bs::UINT32 x = 0; x < size; x++)
+      {
+        WaypointIndex waypoint = grid[y * size + x];
+
+        if (x + 1 < size)
+        {
+          waynet->addPath(waypoint, grid[y * size + x + 1]);
+          waynet->addPath(grid[y * size + x + 1], waypoint);
+        }
+
+        if (y + 1 < size)
+        {
+          waynet->addPath(waypoint, grid[(y + 1) * size + x]);
+          waynet->addPath(grid[(y + 1) * size + x], waypoint);
+        }
+      }
+    }
+
+    // The grid is searched, not looked up
+    waynet->setNextHopTableBudget(0);
+    waynet->routeCache().setCapacity(0);
+
+    benchmarkWaynet("Synthetic", waynet);
+
+    waynetSO->destroy();
+  }
+
+  void benchmarkWorldWaynet(REGoth::HGameWorld world)
+  {
+    benchmarkWaynet(world->worldName(), world->waynet());
+  }
+
+  void benchmarkWaynet(const bs::String& name, REGoth::HWaynet waynet)
+  {
+    using namespace REGoth;
+
+    bs::UINT32 numWaypoints = waynet->numWaypoints();
+
+    if (numWaypoints == 0) return;
+
+    Random random(SEED);
+
+    bs::Vector<std::pair<WaypointIndex, WaypointIndex>> pairs;
+    bs::Vector<bs::Vector3> positions;
+
+    for (bs::UINT32 i = 0; i < NUM_QUERIES; i++)
+    {
+      WaypointIndex from = random.below(numWaypoints);
+      WaypointIndex to   = random.below(numWaypoints);
+
+      pairs.push_back({from, to});
+
+      bs::Vector3 offset(random.range(-10.0f, 10.0f), 0.0f, random.range(-10.0f, 10.0f));
+      positions.push_back(waynet->waypointPosition(from) + offset);
+    }
+
+    run("Waynet/" + name + "/findWay", [&](bs::UINT64 iterations) {
+      bs::UINT64 sum = 0;
+
+      for (bs::UINT64 i = 0; i < iterations; i++)
+      {
+        const auto& pair = pairs[i % pairs.size()];
+
+        sum += waynet->findWay(pair.first, pair.second).size();
+      }
+
+      s_Sink = sum;
+    });
+
+    run("Waynet/" + name + "/findClosestWaypointTo", [&](bs::UINT64 iterations) {
+      bs::UINT64 sum = 0;
+
+      for (bs::UINT64 i = 0; i < iterations; i++)
+      {
+        const bs::Vector3& around = positions[i % positions.size()];
+
+        sum += waynet->findClosestWaypointTo(around).closest != NO_WAYPOINT ? 1 : 0;
+      }
+
+      s_Sink = sum;
+    });
+
+    run("Waynet/" + name + "/findClosestWaypointsTo", [&](bs::UINT64 iterations) {
+      bs::UINT64 sum = 0;
+      bs::Vector<Waynet::ClosestWaypoints> result;
+
+      // One iteration is one batch of all positions
+      for (bs::UINT64 i = 0; i < iterations; i++)
+      {
+        waynet->findClosestWaypointsTo(positions, result);
+
+        sum += result.size();
+      }
+
+      s_Sink = sum;
+    });
+  }
+
+  /**
+   * Reads a fixed selection of files from the VDFS into the same buffer over and over.
+   */
+  void benchmarkVirtualFileSystem()
+  {
+    using namespace REGoth;
+
+    const bs::Vector<bs::String>& allFiles = gVirtualFileSystem().listAllFiles();
+
+    if (allFiles.empty()) return;
+
+    Random random(SEED);
+    bs::Vector<bs::String> files;
+
+    for (bs::UINT32 i = 0; i < NUM_QUERIES; i++)
+    {
+      files.push_back(allFiles[random.below((bs::UINT32)allFiles.size())]);
+    }
+
+    std::vector<bs::UINT8> data;
+
+    run("VirtualFileSystem/readFile", [&](bs::UINT64 iterations) {
+      bs::UINT64 sum = 0;
+
+      for (bs::UINT64 i = 0; i < iterations; i++)
+      {
+        gVirtualFileSystem().readFile(files[i % files.size()], data);
+        sum += data.size();
+      }
+
+      s_Sink = sum;
+    });
+
+    run("VirtualFileSystem/hasFile", [&](bs::UINT64 iterations) {
+      bs::UINT64 sum = 0;
+
+      for (bs::UINT64 i = 0; i < iterations; i++)
+      {
+        sum += gVirtualFileSystem().hasFile(files[i % files.size()]) ? 1 : 0;
+      }
+
+      s_Sink = sum;
+    });
+  }
+
+  /**
+   * Fills an inventory with a few hundred different items of the scripts, then gives, looks up
+   * and removes items of it.
+   */
+  void benchmarkInventory(REGoth::HGameWorld world)
+  {
+    using namespace REGoth;
+    using namespace REGoth::Scripting;
+
+    SymbolIndexSpan itemSpan =
+        Queries::findAllInstancesOfClass(world->scriptVM().scriptSymbolsConst(), "C_ITEM");
+
+    bs::Vector<SymbolIndex> items(itemSpan.begin(), itemSpan.end());
+
+    if (items.empty()) return;
+
+    bs::HSceneObject so = bs::SceneObject::create("Inventory");
+    HInventory inventory = so->addComponent<Inventory>(world);
+
+    shuffle(items);
+    items.resize(std::min<size_t>(items.size(), 300));
+
+    for (SymbolIndex item : items)
+    {
+      inventory->giveItem(item, 2);
+    }
+
+    run("Inventory/GiveRemove", [&](bs::UINT64 iterations) {
+      for (bs::UINT64 i = 0; i < iterations; i++)
+      {
+        SymbolIndex item = items[i % items.size()];
+
+        inventory->giveItem(item);
+        inventory->removeItem(item);
+      }
+    });
+
+    run("Inventory/itemCount", [&](bs::UINT64 iterations) {
+      bs::UINT64 sum = 0;
+
+      for (bs::UINT64 i = 0; i < iterations; i++)
+      {
+        sum += inventory->itemCount(items[i % items.size()]);
+      }
+
+      s_Sink = sum;
+    });
+
+    so->destroy();
+  }
+
+  /**
+   * Looks for characters around the waypoints of the world and processes their event queues,
+   * like GameWorld::processEventQueues() does on every fixed update.
+   */
+  void benchmarkCharacters(REGoth::HGameWorld world)
+  {
+    using namespace REGoth;
+
+    HWaynet waynet          = world->waynet();
+    bs::UINT32 numWaypoints = waynet->numWaypoints();
+
+    bs::Vector<HCharacter> characters;
+    world->findCharactersInRange(1000000.0f, bs::Vector3::ZERO, characters);
+
+    if (numWaypoints == 0 || characters.empty()) return;
+
+    Random random(SEED);
+    bs::Vector<bs::Vector3> positions;
+
+    for (bs::UINT32 i = 0; i < NUM_QUERIES; i++)
+    {
+      WaypointIndex around = random.below(numWaypoints);
+
+      positions.push_back(waynet->waypointPosition(around));
+    }
+
+    bs::Vector<HCharacter> found;
+
+    run("GameWorld/findCharactersInRange", [&](bs::UINT64 iterations) {
+      bs::UINT64 sum = 0;
+
+      for (bs::UINT64 i = 0; i < iterations; i++)
+      {
+        world->findCharactersInRange(10.0f, positions[i % positions.size()], found);
+        sum += found.size();
+      }
+
+      s_Sink = sum;
+    });
+
+    bs::Vector<HCharacterEventQueue> queues;
+
+    for (const HCharacter& character : characters)
+    {
+      queues.push_back(character->SO()->getComponent<CharacterEventQueue>());
+    }
+
+    run("CharacterEventQueue/processFixedUpdate", [&](bs::UINT64 iterations) {
+      for (bs::UINT64 i = 0; i < iterations; i++)
+      {
+        const HCharacterEventQueue& queue = queues[i % queues.size()];
+
+        if (queue.isDestroyed()) continue;
+
+        queue->processFixedUpdate();
+      }
+    });
+  }
+
+  /**
+   * Takes snapshots for clients spread over the world, each of them acknowledging every
+   * snapshot right away, like all of them would on a good connection.
+   */
+  void benchmarkWorldSnapshots(REGoth::HGameWorld world)
+  {
+    using namespace REGoth;
+
+    bs::Vector<HCharacter> characters;
+    world->findCharactersInRange(1000000.0f, bs::Vector3::ZERO, characters);
+
+    if (characters.empty()) return;
+
+    WorldSnapshots& snapshots = world->worldSnapshots();
+    snapshots.reset();
+
+    Random random(SEED);
+    bs::Vector<bs::UINT32> clients;
+
+    for (bs::UINT32 i = 0; i < NUM_SNAPSHOT_CLIENTS; i++)
+    {
+      const HCharacter& viewed = characters[random.below((bs::UINT32)characters.size())];
+
+      clients.push_back(snapshots.addClient(viewed->SO()->getTransform().pos()));
+    }
+
+    // Clients rebuild what the server sent, which has to be what it has taken
+    bs::Vector<bs::Vector<WorldSnapshot>> received(clients.size());
+
+    auto takeAndAcknowledge = [&]() {
+      snapshots.takeSnapshots();
+
+      for (size_t i = 0; i < clients.size(); i++)
+      {
+        WorldSnapshot snapshot;
+
+        if (!WorldSnapshots::decode(snapshots.packetFor(clients[i]), received[i], snapshot))
+        {
+          REGOTH_THROW(InvalidStateException, "Failed to decode a world snapshot");
+        }
+
+        snapshots.acknowledge(clients[i], snapshot.sequence);
+
+        received[i] = {std::move(snapshot)};
+      }
+    };
+
+    takeAndAcknowledge();
+
+    REGOTH_LOG(Info, Uncategorized,
+               "[Benchmarks] WorldSnapshots: {0} clients, {1} entities, {2} bytes in full",
+               snapshots.stats().numClients, snapshots.stats().numEntities,
+               snapshots.stats().numBytesSent);
+
+    run("WorldSnapshots/takeSnapshots", [&](bs::UINT64 iterations) {
+      for (bs::UINT64 i = 0; i < iterations; i++)
+      {
+        takeAndAcknowledge();
+      }
+    });
+
+    REGOTH_LOG(Info, Uncategorized,
+               "[Benchmarks] WorldSnapshots: {0} bytes as delta to the acknowledged snapshot",
+               snapshots.stats().numBytesSent);
+
+    snapshots.reset();
+  }
+
+  /** Seed of all synthetic data, so every run does the same work */
+  static constexpr bs::UINT64 SEED = 1;
+
+  static constexpr bs::UINT32 NUM_SYNTHETIC_OBJECTS = 4096;
+  static constexpr bs::UINT32 NUM_QUERIES           = 1000;
+  static constexpr bs::UINT32 NUM_SNAPSHOT_CLIENTS  = 32;
+
+  bs::Vector<Result> mResults;
+  std::unique_ptr<const BenchmarksConfig> mConfig;
+};
+
+constexpr bs::UINT64 REGothBenchmarks::SEED;
+constexpr bs::UINT32 REGothBenchmarks::NUM_SYNTHETIC_OBJECTS;
+constexpr bs::UINT32 REGothBenchmarks::NUM_QUERIES;
+constexpr bs::UINT32 REGothBenchmarks::NUM_SNAPSHOT_CLIENTS;
+
+int main(int argc, char** argv)
+{
+  auto config = REGoth::parseArguments<BenchmarksConfig>(argc, argv);
+  REGothBenchmarks engine{std::move(config)};
+
+  return REGoth::runEngine(engine);
+}
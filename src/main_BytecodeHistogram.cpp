@@ -0,0 +1,179 @@
+#include <algorithm>
+#include <memory>
+#include <string>
+
+#include <BsApplication.h>
+#include <String/BsString.h>
+
+#include <daedalus/DATFile.h>
+
+#include <core.hpp>
+#include <exception/Throw.hpp>
+#include <log/logging.hpp>
+#include <original-content/VirtualFileSystem.hpp>
+#include <scripting/ScriptSymbolStorage.hpp>
+#include <scripting/daedalus/DATSymbolStorageLoader.hpp>
+#include <scripting/daedalus/DaedalusDisassembler.hpp>
+#include <scripting/daedalus/DaedalusInstructionMemory.hpp>
+
+/**
+ * Counts how often every opcode and every short sequence of opcodes appears inside the
+ * bytecode of a DAT-file and how many superinstructions the VM would create from it.
+ *
+ * This is meant to find out which sequences are worth to be fused into superinstructions,
+ * see `DaedalusSuperinstruction`. Since Gothic 1 and 2 come with different scripts, run this
+ * on both.
+ */
+struct BytecodeHistogramConfig : public REGoth::EngineConfig
+{
+  virtual void registerCLIOptions(cxxopts::Options& opts) override
+  {
+    const std::string grp = "BytecodeHistogram";
+    opts.add_option(grp, "", "dat", "Name of the DAT-file to look at",
+                    cxxopts::value<bs::String>(datFile), "[NAME]");
+    opts.add_option(grp, "", "top", "Number of entries to show per histogram",
+                    cxxopts::value<bs::UINT32>(numTopEntries), "[NUM]");
+  }
+
+  virtual void verifyCLIOptions() override
+  {
+    bs::StringUtil::toUpperCase(datFile);
+  }
+
+  bs::String datFile       = "GOTHIC.DAT";
+  bs::UINT32 numTopEntries = 30;
+};
+
+/**
+ * Logs the entries with the highest counts.
+ */
+static void logHistogram(const bs::String& title, const bs::Map<bs::String, bs::UINT32>& histogram,
+                         bs::UINT32 numTopEntries)
+{
+  bs::Vector<std::pair<bs::String, bs::UINT32>> sorted(histogram.begin(), histogram.end());
+
+  std::sort(sorted.begin(), sorted.end(),
+            [](const auto& a, const auto& b) { return a.second > b.second; });
+
+  if (sorted.size() > numTopEntries)
+  {
+    sorted.resize(numTopEntries);
+  }
+
+  REGOTH_LOG(Info, Uncategorized, "[BytecodeHistogram] {0}:", title);
+
+  for (const auto& entry : sorted)
+  {
+    REGOTH_LOG(Info, Uncategorized, "[BytecodeHistogram]   {0} {1}", entry.second, entry.first);
+  }
+}
+
+class REGothBytecodeHistogram : public REGoth::Engine
+{
+public:
+  REGothBytecodeHistogram(std::unique_ptr<const BytecodeHistogramConfig>&& config)
+      : mConfig{std::move(config)}
+  {
+    // pass
+  }
+
+  const BytecodeHistogramConfig* config() const override
+  {
+    return mConfig.get();
+  }
+
+  void setupScene() override
+  {
+    using namespace REGoth;
+    using namespace REGoth::Scripting;
+
+    FileView data = gVirtualFileSystem().viewFile(config()->datFile);
+
+    if (data.empty())
+    {
+      REGOTH_THROW(InvalidStateException, "Failed to read " + config()->datFile);
+    }
+
+    auto datFile = bs::bs_shared_ptr_new<Daedalus::DATFile>(data.data(), data.size());
+
+    ScriptSymbolStorage symbols;
+    convertDatToREGothSymbolStorage(symbols, *datFile);
+
+    DaedalusInstructionMemory instructions;
+    instructions.reset(datFile);
+    instructions.decodeAllFunctions(symbols);
+
+    // Straight-line code only, a sequence never continues after the control flow left
+    bs::Vector<std::pair<bs::UINT32, DaedalusInstruction>> decoded;
+
+    instructions.forEachDecodedInstruction(
+        [&](bs::UINT32 address, const DaedalusInstruction& instruction) {
+          decoded.push_back({address, instruction});
+        });
+
+    bs::Map<bs::String, bs::UINT32> opcodes;
+    bs::Map<bs::String, bs::UINT32> sequences[3];
+
+    for (size_t i = 0; i < decoded.size(); i++)
+    {
+      opcodes[opcodeName(decoded[i].second.op)] += 1;
+
+      bs::String sequence = opcodeName(decoded[i].second.op);
+
+      for (size_t length = 2; length <= 4 && i + length - 1 < decoded.size(); length++)
+      {
+        const auto& previous = decoded[i + length - 2];
+        const auto& current  = decoded[i + length - 1];
+
+        bool isFollowing = previous.first + previous.second.size == current.first;
+        bool canContinue = previous.second.op != Daedalus::EParOp_Ret &&
+                           previous.second.op != Daedalus::EParOp_Jump;
+
+        if (!isFollowing || !canContinue) break;
+
+        sequence += "; " + opcodeName(current.second.op);
+        sequences[length - 2][sequence] += 1;
+      }
+    }
+
+    REGOTH_LOG(Info, Uncategorized, "[BytecodeHistogram] {0}: {1} instructions",
+               config()->datFile, decoded.size());
+
+    logHistogram("Opcodes", opcodes, config()->numTopEntries);
+    logHistogram("Pairs", sequences[0], config()->numTopEntries);
+    logHistogram("Triples", sequences[1], config()->numTopEntries);
+    logHistogram("Quadruples", sequences[2], config()->numTopEntries);
+
+    // Done by the VM before fusing, see DaedalusVM::decodeInstructions()
+    DaedalusFoldingStats folding = instructions.foldConstants(symbols);
+
+    REGOTH_LOG(Info, Uncategorized,
+               "[BytecodeHistogram] Constant folding: {0} constants inlined, {1} operations "
+               "folded, {2} branches removed",
+               folding.numInlinedConstants, folding.numFoldedOperations,
+               folding.numRemovedBranches);
+
+    bs::Map<bs::String, bs::UINT32> superinstructions;
+
+    for (const auto& fused : instructions.fuseSuperinstructions(symbols))
+    {
+      superinstructions[opcodeName(fused.first)] = fused.second;
+    }
+
+    logHistogram("Superinstructions created by the VM", superinstructions,
+                 config()->numTopEntries);
+
+    bs::gApplication().quitRequested();
+  }
+
+private:
+  std::unique_ptr<const BytecodeHistogramConfig> mConfig;
+};
+
+int main(int argc, char** argv)
+{
+  auto config = REGoth::parseArguments<BytecodeHistogramConfig>(argc, argv);
+  REGothBytecodeHistogram engine{std::move(config)};
+
+  return REGoth::runEngine(engine);
+}
@@ -0,0 +1,289 @@
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+
+#include <BsApplication.h>
+#include <Resources/BsResources.h>
+#include <Scene/BsSceneObject.h>
+#include <String/BsString.h>
+
+#include <BsZenLib/ImportFont.hpp>
+#include <BsZenLib/ImportMorphMesh.hpp>
+#include <BsZenLib/ImportSkeletalMesh.hpp>
+#include <BsZenLib/ImportStaticMesh.hpp>
+#include <BsZenLib/ImportTexture.hpp>
+#include <BsZenLib/ZenResources.hpp>
+
+#include <core.hpp>
+#include <components/GameWorld.hpp>
+#include <core/Jobs.hpp>
+#include <exception/Throw.hpp>
+#include <log/logging.hpp>
+#include <original-content/VirtualFileSystem.hpp>
+
+/**
+ * Imports all resources found in the game files into the BsZenLib cache, so the game doesn't
+ * have to do it on the first run, one resource at a time as it comes across them.
+ *
+ * The files of each kind are imported in parallel on all cores. Resources which have already
+ * been cached are skipped, so running the warmer again after a mod was installed only imports
+ * what is new. The resource manifest is written once after everything has been imported.
+ *
+ * Worlds are imported last, one after another, which caches their world meshes and the
+ * resources of their vobs. They are not saved, since the games set up a new world before
+ * saving it, see GameWorld::loadOrImportZEN().
+ */
+struct CacheWarmerConfig : public REGoth::EngineConfig
+{
+  virtual void registerCLIOptions(cxxopts::Options& opts) override
+  {
+    const std::string grp = "CacheWarmer";
+    opts.add_option(grp, "", "skip-worlds", "If set, the worlds (ZEN) are not imported",
+                    cxxopts::value<bool>(isSkippingWorlds), "");
+    opts.add_option(grp, "", "sequential",
+                    "If set, the files are imported one after another instead of in parallel",
+                    cxxopts::value<bool>(isSequential), "");
+  }
+
+  virtual void verifyCLIOptions() override
+  {
+    // pass
+  }
+
+  bool isSkippingWorlds = false;
+  bool isSequential     = false;
+};
+
+class REGothCacheWarmer : public REGoth::Engine
+{
+public:
+  REGothCacheWarmer(std::unique_ptr<const CacheWarmerConfig>&& config)
+      : mConfig{std::move(config)}
+  {
+    // pass
+  }
+
+  const CacheWarmerConfig* config() const override
+  {
+    return mConfig.get();
+  }
+
+  void setupScene() override
+  {
+    using namespace REGoth;
+
+    auto start = std::chrono::high_resolution_clock::now();
+
+    // Compiled textures are named after the file they were made from, e.g. `STONE-C.TEX`
+    warmUp("Textures", ".TEX", originalNameOfTexture, BsZenLib::HasCachedTexture,
+           [](const bs::String& name) {
+             return !!BsZenLib::ImportAndCacheTexture(name, gVirtualFileSystem().getFileIndex());
+           });
+
+    // Static meshes are referred to by the name of the original 3DS file, even if only the
+    // compiled MRM exists
+    warmUp("Static Meshes", ".3DS", keepOriginalName, BsZenLib::HasCachedStaticMesh,
+           importStaticMesh);
+    warmUp("Static Meshes", ".MRM", originalNameOfStaticMesh, BsZenLib::HasCachedStaticMesh,
+           importStaticMesh);
+
+    warmUp("Model Scripts", ".MDS", keepOriginalName, BsZenLib::HasCachedMDS,
+           [](const bs::String& name) {
+             return !!BsZenLib::ImportAndCacheMDS(name, gVirtualFileSystem().getFileIndex());
+           });
+
+    warmUp("Morph Meshes", ".MMB", keepOriginalName, BsZenLib::HasCachedMorphMesh,
+           [](const bs::String& name) {
+             return !!BsZenLib::ImportAndCacheMorphMesh(name, gVirtualFileSystem().getFileIndex());
+           });
+
+    warmUp("Fonts", ".FNT", keepOriginalName, BsZenLib::HasCachedFont,
+           [](const bs::String& name) {
+             return !!BsZenLib::ImportAndCacheFont(name, gVirtualFileSystem().getFileIndex());
+           });
+
+    if (!config()->isSkippingWorlds)
+    {
+      warmUpWorlds();
+    }
+
+    auto end = std::chrono::high_resolution_clock::now();
+
+    REGOTH_LOG(Info, Uncategorized, "[CacheWarmer] Done after {0} s: {1} imported, {2} failed",
+               std::chrono::duration<double>(end - start).count(), mNumImported, mNumFailed);
+
+    // The manifest is saved by runEngine() once the scene has been set up
+    bs::gApplication().quitRequested();
+  }
+
+  /**
+   * @return Number of files which could not be imported.
+   */
+  bs::UINT32 numFailures() const
+  {
+    return mNumFailed;
+  }
+
+private:
+  using OriginalName   = std::function<bs::String(const bs::String&)>;
+  using HasCached      = std::function<bool(const bs::String&)>;
+  using ImportAndCache = std::function<bool(const bs::String&)>;
+
+  /**
+   * Imports all files with the given extension which haven't been cached yet.
+   *
+   * @param  kind          What the files are, for logging.
+   * @param  extension     Extension of the files in the VDFS, with leading dot.
+   * @param  originalName  Turns the name of a file into the name the resource is loaded by.
+   * @param  hasCached     Whether a resource has already been cached.
+   * @param  import        Imports and caches a resource. Returns whether that worked.
+   */
+  void warmUp(const char* kind, const bs::String& extension, const OriginalName& originalName,
+              const HasCached& hasCached, const ImportAndCache& import)
+  {
+    using namespace REGoth;
+
+    bs::Vector<bs::String> missing;
+
+    for (const bs::String& file : gVirtualFileSystem().listByExtension(extension))
+    {
+      bs::String name = originalName(file);
+
+      if (!hasCached(name))
+      {
+        missing.push_back(name);
+      }
+    }
+
+    REGOTH_LOG(Info, Uncategorized, "[CacheWarmer] {0} ({1}): Importing {2} files", kind,
+               extension, missing.size());
+
+    std::atomic<bs::UINT32> numFailed{0};
+
+    auto importOne = [&](const bs::String& name) {
+      bool isImported = false;
+
+      try
+      {
+        isImported = import(name);
+      }
+      catch (const bs::Exception& e)
+      {
+        REGOTH_LOG(Warning, Uncategorized, "[CacheWarmer] {0}: {1}", name, e.getFullDescription());
+      }
+
+      if (!isImported)
+      {
+        REGOTH_LOG(Warning, Uncategorized, "[CacheWarmer] Failed to import: {0}", name);
+        numFailed += 1;
+      }
+    };
+
+    if (config()->isSequential)
+    {
+      for (const bs::String& name : missing)
+      {
+        importOne(name);
+      }
+    }
+    else
+    {
+      Jobs::JobGroup group("CacheWarmer");
+
+      for (const bs::String& name : missing)
+      {
+        group.run([&importOne, &name]() { importOne(name); });
+      }
+
+      group.wait();
+    }
+
+    mNumImported += (bs::UINT32)missing.size() - numFailed;
+    mNumFailed += numFailed;
+
+    // Everything is in the cache now, no need to keep it around
+    bs::gResources().unloadAllUnused();
+  }
+
+  /**
+   * Imports all worlds, so their world meshes and the resources their vobs use get cached.
+   */
+  void warmUpWorlds()
+  {
+    using namespace REGoth;
+
+    for (const bs::String& zen : gVirtualFileSystem().listByExtension(".ZEN"))
+    {
+      REGOTH_LOG(Info, Uncategorized, "[CacheWarmer] Importing world: {0}", zen);
+
+      try
+      {
+        HGameWorld world = GameWorld::importZEN(zen);
+
+        if (world)
+        {
+          world->SO()->destroy(true);
+          mNumImported += 1;
+          continue;
+        }
+      }
+      catch (const bs::Exception& e)
+      {
+        REGOTH_LOG(Warning, Uncategorized, "[CacheWarmer] {0}: {1}", zen, e.getFullDescription());
+      }
+
+      REGOTH_LOG(Warning, Uncategorized, "[CacheWarmer] Failed to import world: {0}", zen);
+      mNumFailed += 1;
+    }
+
+    bs::gResources().unloadAllUnused();
+  }
+
+  static bs::String keepOriginalName(const bs::String& file)
+  {
+    return file;
+  }
+
+  static bs::String originalNameOfTexture(const bs::String& file)
+  {
+    bs::String base = file.substr(0, file.find_last_of('.'));
+
+    if (bs::StringUtil::endsWith(base, "-C"))
+    {
+      base = base.substr(0, base.size() - 2);
+    }
+
+    return base + ".TGA";
+  }
+
+  static bs::String originalNameOfStaticMesh(const bs::String& file)
+  {
+    return file.substr(0, file.find_last_of('.')) + ".3DS";
+  }
+
+  static bool importStaticMesh(const bs::String& name)
+  {
+    return !!BsZenLib::ImportAndCacheStaticMesh(name, REGoth::gVirtualFileSystem().getFileIndex());
+  }
+
+  bs::UINT32 mNumImported = 0;
+  bs::UINT32 mNumFailed   = 0;
+  std::unique_ptr<const CacheWarmerConfig> mConfig;
+};
+
+int main(int argc, char** argv)
+{
+  auto config = REGoth::parseArguments<CacheWarmerConfig>(argc, argv);
+  REGothCacheWarmer engine{std::move(config)};
+
+  int result = REGoth::runEngine(engine);
+
+  if (result == EXIT_SUCCESS && engine.numFailures() > 0)
+  {
+    return EXIT_FAILURE;
+  }
+
+  return result;
+}
@@ -19,7 +19,6 @@
 #include <components/Item.hpp>
 #include <components/ThirdPersonCamera.hpp>
 #include <components/Waynet.hpp>
-#include <components/Waypoint.hpp>
 #include <exception/Throw.hpp>
 #include <original-content/VirtualFileSystem.hpp>
 
@@ -72,15 +71,7 @@ public:
 
     // Add some waypoint
     bs::String wpName = "ADW_ENTRANCE";
-    {
-      bs::HSceneObject wpSO = bs::SceneObject::create(wpName);
-
-      wpSO->setParent(world->waynet()->SO());
-      wpSO->setPosition(bs::Vector3(0, 0, 0));
-
-      REGoth::HWaypoint wp = wpSO->addComponent<REGoth::Waypoint>();
-      world->waynet()->addWaypoint(wp);
-    }
+    world->waynet()->addWaypoint(wpName, bs::Vector3(0, 0, 0), bs::Vector3::UNIT_Z);
 
     REGoth::HCharacter character = world->insertCharacter("PC_HERO", wpName);
     character->useAsHero();
@@ -26,7 +26,6 @@
 #include <components/GameWorld.hpp>
 #include <components/VisualCharacter.hpp>
 #include <components/Waynet.hpp>
-#include <components/Waypoint.hpp>
 #include <log/logging.hpp>
 #include <original-content/VirtualFileSystem.hpp>
 
@@ -0,0 +1,327 @@
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <ctime>
+#include <limits>
+#include <memory>
+
+#include <BsApplication.h>
+#include <FileSystem/BsDataStream.h>
+#include <FileSystem/BsFileSystem.h>
+#include <String/BsString.h>
+
+#include <core.hpp>
+#include <exception/Throw.hpp>
+#include <log/logging.hpp>
+#include <original-content/VirtualFileSystem.hpp>
+
+/**
+ * Writes all files of the VDFS into a single content pack, which can be loaded instead of the
+ * game's packages and `_work` directory via `--vdfs-content-pack`.
+ *
+ * The pack contains every file as the VDFS resolves it, so files overridden by newer packages
+ * or the `_work` directory are only stored once. Files listed in a trace recorded with
+ * `--vdfs-record-trace` come first, in the order they were read during that run, so starting
+ * the game reads the pack mostly front to back. All other files follow sorted by name.
+ *
+ * The pack is a regular VDF package, so ZenLib's file index loads it like any other. Every
+ * file starts on a page boundary, so files are aligned inside the memory-mapped pack, see
+ * MappedPackage.
+ */
+struct ContentPackerConfig : public REGoth::EngineConfig
+{
+  virtual void registerCLIOptions(cxxopts::Options& opts) override
+  {
+    const std::string grp = "ContentPacker";
+    opts.add_option(grp, "o", "output", "Where to write the content pack to",
+                    cxxopts::value<bs::Path>(outputPath), "[PATH]");
+    opts.add_option(grp, "", "trace",
+                    "File trace recorded with --vdfs-record-trace to order the files by",
+                    cxxopts::value<bs::Path>(tracePath), "[PATH]");
+  }
+
+  virtual void verifyCLIOptions() override
+  {
+    if (outputPath.isEmpty())
+    {
+      REGOTH_THROW(InvalidStateException, "Output path cannot be empty.");
+    }
+  }
+
+  bs::Path outputPath;
+  bs::Path tracePath;
+};
+
+/** Every file inside the pack starts at a multiple of this */
+constexpr bs::UINT64 CONTENT_PACK_ALIGNMENT = 4096;
+
+/** Layout of a VDF package, see MappedPackage */
+constexpr size_t VDF_COMMENT_SIZE       = 256;
+constexpr size_t VDF_ENTRY_NAME_SIZE    = 64;
+constexpr bs::UINT32 VDF_ENTRY_LAST     = 0x40000000;
+constexpr bs::UINT32 VDF_ATTRIBUTE_FILE = 0x20;
+constexpr bs::UINT32 VDF_VERSION        = 0x50;
+
+#pragma pack(push, 1)
+struct VdfHeader
+{
+  char comment[VDF_COMMENT_SIZE];
+  char signature[16];
+  bs::UINT32 numEntries;
+  bs::UINT32 numFiles;
+  bs::UINT32 timestamp;
+  bs::UINT32 dataSize;
+  bs::UINT32 rootOffset;
+  bs::UINT32 version;
+};
+
+struct VdfEntry
+{
+  char name[VDF_ENTRY_NAME_SIZE];
+  bs::UINT32 offset;
+  bs::UINT32 size;
+  bs::UINT32 type;
+  bs::UINT32 attributes;
+};
+#pragma pack(pop)
+
+class REGothContentPacker : public REGoth::Engine
+{
+public:
+  REGothContentPacker(std::unique_ptr<const ContentPackerConfig>&& config)
+      : mConfig{std::move(config)}
+  {
+    // pass
+  }
+
+  const ContentPackerConfig* config() const override
+  {
+    return mConfig.get();
+  }
+
+  void setupScene() override
+  {
+    auto start = std::chrono::high_resolution_clock::now();
+
+    bs::Vector<bs::String> files = orderFiles();
+    bool isWritten               = writePack(files);
+
+    auto end = std::chrono::high_resolution_clock::now();
+
+    if (isWritten)
+    {
+      REGOTH_LOG(Info, Uncategorized, "[ContentPacker] Wrote {0} files to {1} in {2} s",
+                 files.size(), config()->outputPath.toString(),
+                 std::chrono::duration<double>(end - start).count());
+    }
+
+    mIsFailed = !isWritten;
+
+    bs::gApplication().quitRequested();
+  }
+
+  bool isFailed() const
+  {
+    return mIsFailed;
+  }
+
+private:
+  /**
+   * @return All files of the VDFS which fit into a VDF package, the ones inside the trace
+   *         first.
+   */
+  bs::Vector<bs::String> orderFiles() const
+  {
+    using namespace REGoth;
+
+    bs::Vector<bs::String> all = gVirtualFileSystem().listAllFiles();
+    std::sort(all.begin(), all.end());
+
+    bs::Vector<bs::String> ordered;
+    bs::UnorderedSet<bs::String> isOrdered;
+
+    if (!config()->tracePath.isEmpty())
+    {
+      bs::SPtr<bs::DataStream> stream = bs::FileSystem::openFile(config()->tracePath);
+
+      if (!stream)
+      {
+        REGOTH_THROW(FileNotFoundException,
+                     "Failed to read trace: " + config()->tracePath.toString());
+      }
+
+      for (bs::String line : bs::StringUtil::split(stream->getAsString(), "\n"))
+      {
+        bs::StringUtil::trim(line);
+        bs::StringUtil::toUpperCase(line);
+
+        // Files might have been removed since the trace was recorded
+        if (line.empty() || !gVirtualFileSystem().hasFile(line)) continue;
+
+        if (isOrdered.insert(line).second)
+        {
+          ordered.push_back(line);
+        }
+      }
+
+      REGOTH_LOG(Info, Uncategorized, "[ContentPacker] {0} files ordered by trace",
+                 ordered.size());
+    }
+
+    for (const bs::String& file : all)
+    {
+      if (isOrdered.insert(file).second)
+      {
+        ordered.push_back(file);
+      }
+    }
+
+    // Names in a VDF directory have a fixed size
+    auto isTooLong = [](const bs::String& file) { return file.size() > VDF_ENTRY_NAME_SIZE; };
+
+    for (const bs::String& file : ordered)
+    {
+      if (isTooLong(file))
+      {
+        REGOTH_LOG(Warning, Uncategorized, "[ContentPacker] Name too long, skipped: {0}", file);
+      }
+    }
+
+    ordered.erase(std::remove_if(ordered.begin(), ordered.end(), isTooLong), ordered.end());
+
+    return ordered;
+  }
+
+  /**
+   * Writes the given files as VDF package to the output path.
+   *
+   * @return Whether that worked.
+   */
+  bool writePack(const bs::Vector<bs::String>& files) const
+  {
+    using namespace REGoth;
+
+    bs::UINT64 directorySize = files.size() * sizeof(VdfEntry);
+    bs::UINT64 offset        = alignUp(sizeof(VdfHeader) + directorySize);
+
+    // The directory has to be written first but needs the sizes of all files, so the files
+    // are viewed twice. For files inside mapped packages that costs nothing.
+    bs::Vector<VdfEntry> entries(files.size());
+
+    for (size_t i = 0; i < files.size(); i++)
+    {
+      bs::UINT64 size = gVirtualFileSystem().viewFile(files[i]).size();
+
+      if (offset + size > std::numeric_limits<bs::UINT32>::max())
+      {
+        REGOTH_LOG(Error, Uncategorized, "[ContentPacker] Pack would be larger than 4 GB");
+        return false;
+      }
+
+      VdfEntry& entry = entries[i];
+      std::memset(entry.name, ' ', sizeof(entry.name));
+      std::memcpy(entry.name, files[i].data(), files[i].size());
+      entry.offset     = (bs::UINT32)offset;
+      entry.size       = (bs::UINT32)size;
+      entry.type       = (i + 1 == files.size()) ? VDF_ENTRY_LAST : 0;
+      entry.attributes = VDF_ATTRIBUTE_FILE;
+
+      offset = alignUp(offset + size);
+    }
+
+    VdfHeader header;
+    std::memset(header.comment, 0x1A, sizeof(header.comment));
+    const char comment[] = "REGoth content pack";
+    std::memcpy(header.comment, comment, sizeof(comment) - 1);
+    std::memcpy(header.signature, "PSVDSC_V2.00\n\r\n\r", sizeof(header.signature));
+    header.numEntries = (bs::UINT32)entries.size();
+    header.numFiles   = (bs::UINT32)entries.size();
+    header.timestamp  = dosTimestampNow();
+    header.dataSize   = (bs::UINT32)(offset - alignUp(sizeof(VdfHeader) + directorySize));
+    header.rootOffset = sizeof(VdfHeader);
+    header.version    = VDF_VERSION;
+
+    bs::SPtr<bs::DataStream> stream = bs::FileSystem::createAndOpenFile(config()->outputPath);
+
+    if (!stream)
+    {
+      REGOTH_LOG(Error, Uncategorized, "[ContentPacker] Failed to open {0}",
+                 config()->outputPath.toString());
+      return false;
+    }
+
+    bs::UINT64 written = 0;
+    stream->write(&header, sizeof(header));
+    stream->write(entries.data(), entries.size() * sizeof(VdfEntry));
+    written += sizeof(header) + entries.size() * sizeof(VdfEntry);
+
+    for (size_t i = 0; i < files.size(); i++)
+    {
+      written += writePadding(*stream, entries[i].offset - written);
+
+      FileView data = gVirtualFileSystem().viewFile(files[i]);
+      stream->write(data.data(), data.size());
+      written += data.size();
+    }
+
+    stream->close();
+
+    return true;
+  }
+
+  static bs::UINT64 alignUp(bs::UINT64 offset)
+  {
+    return (offset + CONTENT_PACK_ALIGNMENT - 1) / CONTENT_PACK_ALIGNMENT *
+           CONTENT_PACK_ALIGNMENT;
+  }
+
+  /**
+   * Writes the given number of zeros.
+   *
+   * @return Number of bytes written.
+   */
+  static bs::UINT64 writePadding(bs::DataStream& stream, bs::UINT64 numBytes)
+  {
+    static const bs::UINT8 zeros[CONTENT_PACK_ALIGNMENT] = {};
+
+    for (bs::UINT64 left = numBytes; left > 0;)
+    {
+      bs::UINT64 n = std::min(left, CONTENT_PACK_ALIGNMENT);
+      stream.write(zeros, (size_t)n);
+      left -= n;
+    }
+
+    return numBytes;
+  }
+
+  /**
+   * @return The current local time in the format VDF packages store their timestamp in.
+   */
+  static bs::UINT32 dosTimestampNow()
+  {
+    std::time_t now = std::time(nullptr);
+    std::tm* local  = std::localtime(&now);
+
+    return (bs::UINT32)(local->tm_year - 80) << 25 | (bs::UINT32)(local->tm_mon + 1) << 21 |
+           (bs::UINT32)local->tm_mday << 16 | (bs::UINT32)local->tm_hour << 11 |
+           (bs::UINT32)local->tm_min << 5 | (bs::UINT32)(local->tm_sec / 2);
+  }
+
+  bool mIsFailed = false;
+  std::unique_ptr<const ContentPackerConfig> mConfig;
+};
+
+int main(int argc, char** argv)
+{
+  auto config = REGoth::parseArguments<ContentPackerConfig>(argc, argv);
+  REGothContentPacker engine{std::move(config)};
+
+  int result = REGoth::runEngine(engine);
+
+  if (result == EXIT_SUCCESS && engine.isFailed())
+  {
+    return EXIT_FAILURE;
+  }
+
+  return result;
+}
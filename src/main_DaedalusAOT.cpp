@@ -0,0 +1,129 @@
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <BsApplication.h>
+#include <FileSystem/BsDataStream.h>
+#include <FileSystem/BsFileSystem.h>
+#include <String/BsString.h>
+
+#include <daedalus/DATFile.h>
+
+#include <core.hpp>
+#include <exception/Throw.hpp>
+#include <log/logging.hpp>
+#include <original-content/VirtualFileSystem.hpp>
+#include <scripting/ScriptSymbolStorage.hpp>
+#include <scripting/ScriptVMSnapshot.hpp>
+#include <scripting/daedalus/DATSymbolStorageLoader.hpp>
+#include <scripting/daedalus/DaedalusInstructionMemory.hpp>
+#include <scripting/daedalus/DaedalusNativeCompiler.hpp>
+
+/**
+ * Compiles the bytecode of a DAT-file ahead of time into C++, see DaedalusNativeModule.
+ *
+ * The generated file is to be built as native module via `regoth_add_daedalus_native_module()`,
+ * e.g. by setting `REGOTH_DAEDALUS_NATIVE_MODULE_SOURCE` when configuring, and loaded via
+ * `--script-native-module`. The module only fits the exact DAT-file it was generated from, any
+ * other DAT-file keeps being interpreted.
+ */
+struct DaedalusAOTConfig : public REGoth::EngineConfig
+{
+  virtual void registerCLIOptions(cxxopts::Options& opts) override
+  {
+    const std::string grp = "DaedalusAOT";
+    opts.add_option(grp, "", "dat", "Name of the DAT-file to compile",
+                    cxxopts::value<bs::String>(datFile), "[NAME]");
+    opts.add_option(grp, "", "out", "Where to write the generated C++ file to",
+                    cxxopts::value<bs::Path>(outPath), "[PATH]");
+  }
+
+  virtual void verifyCLIOptions() override
+  {
+    bs::StringUtil::toUpperCase(datFile);
+
+    if (outPath.isEmpty())
+    {
+      REGOTH_THROW(InvalidParametersException, "No output file given, see --out");
+    }
+  }
+
+  bs::String datFile = "GOTHIC.DAT";
+  bs::Path outPath;
+};
+
+class REGothDaedalusAOT : public REGoth::Engine
+{
+public:
+  REGothDaedalusAOT(std::unique_ptr<const DaedalusAOTConfig>&& config)
+      : mConfig{std::move(config)}
+  {
+    // pass
+  }
+
+  const DaedalusAOTConfig* config() const override
+  {
+    return mConfig.get();
+  }
+
+  void setupScene() override
+  {
+    using namespace REGoth;
+    using namespace REGoth::Scripting;
+
+    FileView data = gVirtualFileSystem().viewFile(config()->datFile);
+
+    if (data.empty())
+    {
+      REGOTH_THROW(InvalidStateException, "Failed to read " + config()->datFile);
+    }
+
+    // Same hash the VM looks the module up with, see DaedalusVM::decodeInstructions()
+    bs::UINT64 datHash =
+        hashSnapshotSource(std::vector<bs::UINT8>(data.data(), data.data() + data.size()));
+
+    auto datFile = bs::bs_shared_ptr_new<Daedalus::DATFile>(data.data(), data.size());
+
+    ScriptSymbolStorage symbols;
+    convertDatToREGothSymbolStorage(symbols, *datFile);
+
+    // No superinstructions, the compiler does better. It doesn't know about the values of
+    // constants though.
+    DaedalusInstructionMemory instructions;
+    instructions.reset(datFile);
+    instructions.decodeAllFunctions(symbols);
+    instructions.foldConstants(symbols);
+
+    DaedalusNativeModuleSource source =
+        generateDaedalusNativeModule(symbols, instructions, config()->datFile, datHash);
+
+    bs::SPtr<bs::DataStream> stream = bs::FileSystem::createAndOpenFile(config()->outPath);
+
+    if (!stream)
+    {
+      REGOTH_THROW(InvalidStateException, "Cannot write " + config()->outPath.toString());
+    }
+
+    stream->write(source.code.data(), source.code.size());
+    stream->close();
+
+    REGOTH_LOG(Info, Uncategorized,
+               "[DaedalusAOT] Compiled {0} functions with {1} instructions of {2} to {3}, {4} "
+               "left to the interpreter",
+               source.numFunctions, source.numInstructions, config()->datFile,
+               config()->outPath.toString(), source.numSkippedFunctions);
+
+    bs::gApplication().quitRequested();
+  }
+
+private:
+  std::unique_ptr<const DaedalusAOTConfig> mConfig;
+};
+
+int main(int argc, char** argv)
+{
+  auto config = REGoth::parseArguments<DaedalusAOTConfig>(argc, argv);
+  REGothDaedalusAOT engine{std::move(config)};
+
+  return REGoth::runEngine(engine);
+}
@@ -0,0 +1,258 @@
+#include <chrono>
+#include <limits>
+#include <memory>
+#include <string>
+
+#include <BsApplication.h>
+#include <Scene/BsSceneObject.h>
+#include <String/BsString.h>
+#include <Threading/BsTaskScheduler.h>
+
+#include <core.hpp>
+#include <components/Character.hpp>
+#include <components/GameWorld.hpp>
+#include <exception/Throw.hpp>
+#include <log/logging.hpp>
+#include <scripting/ScriptSymbolStorage.hpp>
+#include <scripting/ScriptVMForGameWorld.hpp>
+
+/**
+ * Loads the same world multiple times and runs the script ticks of all of them in
+ * parallel on the task scheduler, to see whether independent worlds can be tested
+ * at the same time.
+ *
+ * A script tick runs all `ZS_*_LOOP` functions on the characters of a world, see
+ * ScriptVMForGameWorld::runStateLoopFunctions(). Loading the worlds is done on the
+ * main thread, only the script ticks run on the workers.
+ *
+ * Every tick is run once with one world after another and once with all worlds in
+ * parallel, both timings are logged.
+ */
+struct ParallelScriptTestConfig : public REGoth::EngineConfig
+{
+  virtual void registerCLIOptions(cxxopts::Options& opts) override
+  {
+    const std::string grp = "ParallelScriptTest";
+    opts.add_option(grp, "w", "world", "Name of the world to load",
+                    cxxopts::value<bs::String>(world), "[NAME]");
+    opts.add_option(grp, "", "worlds", "Number of worlds to load",
+                    cxxopts::value<bs::UINT32>(numWorlds), "[NUM]");
+    opts.add_option(grp, "", "characters", "Number of characters per world to run scripts on",
+                    cxxopts::value<bs::UINT32>(numCharacters), "[NUM]");
+    opts.add_option(grp, "", "ticks", "Number of script ticks to run",
+                    cxxopts::value<bs::UINT32>(numTicks), "[NUM]");
+  }
+
+  virtual void verifyCLIOptions() override
+  {
+    if (world.empty())
+    {
+      REGOTH_THROW(InvalidStateException, "World cannot be empty.");
+    }
+
+    if (numWorlds == 0)
+    {
+      REGOTH_THROW(InvalidStateException, "Need at least one world.");
+    }
+
+    bs::StringUtil::toUpperCase(world);
+    if (!bs::StringUtil::endsWith(world, ".ZEN"))
+    {
+      world += ".ZEN";
+    }
+  }
+
+  bs::String world;
+  bs::UINT32 numWorlds     = 4;
+  bs::UINT32 numCharacters = 20;
+  bs::UINT32 numTicks      = 10;
+};
+
+/**
+ * A loaded world and the script tick to run on it.
+ */
+struct TestWorld
+{
+  REGoth::HGameWorld world;
+  bs::Vector<REGoth::Scripting::ScriptVMForGameWorld::StateLoopCall> tick;
+
+  /** Set if the tick threw on a worker, since exceptions can't leave the task */
+  bs::String error;
+};
+
+class REGothParallelScriptTest : public REGoth::Engine
+{
+public:
+  REGothParallelScriptTest(std::unique_ptr<const ParallelScriptTestConfig>&& config)
+      : mConfig{std::move(config)}
+  {
+    // pass
+  }
+
+  const ParallelScriptTestConfig* config() const override
+  {
+    return mConfig.get();
+  }
+
+  void setupScene() override
+  {
+    using namespace REGoth;
+
+    bs::Vector<TestWorld> worlds;
+
+    for (bs::UINT32 i = 0; i < config()->numWorlds; i++)
+    {
+      worlds.push_back(loadWorld(i));
+    }
+
+    REGOTH_LOG(Info, Uncategorized,
+               "[ParallelScriptTest] Running {0} ticks on {1} worlds, {2} calls per tick",
+               config()->numTicks, worlds.size(), worlds[0].tick.size());
+
+    double serialMs   = 0;
+    double parallelMs = 0;
+
+    for (bs::UINT32 i = 0; i < config()->numTicks; i++)
+    {
+      serialMs += runTickSerial(worlds);
+      parallelMs += runTickParallel(worlds);
+    }
+
+    REGOTH_LOG(Info, Uncategorized, "[ParallelScriptTest] One after another: {0} ms", serialMs);
+    REGOTH_LOG(Info, Uncategorized, "[ParallelScriptTest] In parallel:       {0} ms", parallelMs);
+
+    bs::gApplication().quitRequested();
+  }
+
+private:
+  TestWorld loadWorld(bs::UINT32 index)
+  {
+    using namespace REGoth;
+    using namespace REGoth::Scripting;
+
+    TestWorld result;
+    result.world = GameWorld::importZEN(config()->world);
+
+    ScriptVMForGameWorld& vm = result.world->scriptVM();
+
+    // There is no UI to open dialogues in and every world should roll its own dice
+    vm.setDialogueUIEnabled(false);
+    result.world->random().seed(index);
+
+    HCharacter hero = result.world->insertCharacter("PC_HERO", WORLD_STARTPOINT);
+    hero->useAsHero();
+
+    result.world->runInitScripts();
+
+    bs::Vector<SymbolIndex> loopFunctions = vm.scriptSymbols().query([](const SymbolBase& s) {
+      return s.type == SymbolType::ScriptFunction && bs::StringUtil::startsWith(s.name, "ZS_") &&
+             bs::StringUtil::endsWith(s.name, "_LOOP");
+    });
+
+    const float everywhere = std::numeric_limits<float>::max();
+
+    bs::Vector<HCharacter> characters;
+    result.world->findCharactersInRange(everywhere, hero->SO()->getTransform().pos(), characters);
+
+    if (characters.size() > config()->numCharacters)
+    {
+      characters.resize(config()->numCharacters);
+    }
+
+    for (HCharacter c : characters)
+    {
+      for (SymbolIndex f : loopFunctions)
+      {
+        ScriptVMForGameWorld::StateLoopCall call;
+        call.function = f;
+        call.self     = c;
+
+        result.tick.push_back(call);
+      }
+    }
+
+    return result;
+  }
+
+  /**
+   * Runs the tick of the given world. Safe to be called from any thread, as long as no other
+   * thread uses the same world.
+   */
+  static void runTick(TestWorld& world)
+  {
+    try
+    {
+      world.world->scriptVM().runStateLoopFunctions(world.tick);
+    }
+    catch (const std::exception& e)
+    {
+      world.error = e.what();
+    }
+  }
+
+  /**
+   * Throws if any of the worlds failed to run their tick.
+   */
+  static void checkForErrors(const bs::Vector<TestWorld>& worlds)
+  {
+    for (const TestWorld& world : worlds)
+    {
+      if (!world.error.empty())
+      {
+        REGOTH_THROW(InvalidStateException, "Script tick failed: " + world.error);
+      }
+    }
+  }
+
+  double runTickSerial(bs::Vector<TestWorld>& worlds)
+  {
+    auto start = std::chrono::high_resolution_clock::now();
+
+    for (TestWorld& world : worlds)
+    {
+      runTick(world);
+    }
+
+    auto end = std::chrono::high_resolution_clock::now();
+
+    checkForErrors(worlds);
+
+    return std::chrono::duration<double, std::milli>(end - start).count();
+  }
+
+  double runTickParallel(bs::Vector<TestWorld>& worlds)
+  {
+    auto start = std::chrono::high_resolution_clock::now();
+
+    bs::Vector<bs::SPtr<bs::Task>> tasks;
+
+    for (TestWorld& world : worlds)
+    {
+      auto task = bs::Task::create("ScriptTick", [&world]() { runTick(world); });
+
+      bs::TaskScheduler::instance().addTask(task);
+      tasks.push_back(task);
+    }
+
+    for (const auto& task : tasks)
+    {
+      task->wait();
+    }
+
+    auto end = std::chrono::high_resolution_clock::now();
+
+    checkForErrors(worlds);
+
+    return std::chrono::duration<double, std::milli>(end - start).count();
+  }
+
+  std::unique_ptr<const ParallelScriptTestConfig> mConfig;
+};
+
+int main(int argc, char** argv)
+{
+  auto config = REGoth::parseArguments<ParallelScriptTestConfig>(argc, argv);
+  REGothParallelScriptTest engine{std::move(config)};
+
+  return REGoth::runEngine(engine);
+}
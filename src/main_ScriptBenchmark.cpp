@@ -0,0 +1,280 @@
+#include <chrono>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <BsApplication.h>
+#include <Components/BsCCamera.h>
+#include <FileSystem/BsDataStream.h>
+#include <FileSystem/BsFileSystem.h>
+#include <Scene/BsSceneObject.h>
+#include <String/BsString.h>
+
+#include <core.hpp>
+#include <components/Character.hpp>
+#include <components/GameWorld.hpp>
+#include <exception/Throw.hpp>
+#include <log/logging.hpp>
+#include <scripting/ScriptSymbolStorage.hpp>
+#include <scripting/ScriptVMForGameWorld.hpp>
+
+/**
+ * Runs a fixed workload of script functions through all interpreter loops of the
+ * Daedalus VM and logs how long each of them took.
+ *
+ * The workload consists of all `ZS_*_LOOP` functions, executed on the characters of
+ * the loaded world, plus the helper functions given on the command line.
+ *
+ * If `--profile` is given, the workload is run once more with the profiler of the VM
+ * turned on, which then writes a report and a chrome trace.
+ */
+struct ScriptBenchmarkConfig : public REGoth::EngineConfig
+{
+  virtual void registerCLIOptions(cxxopts::Options& opts) override
+  {
+    const std::string grp = "ScriptBenchmark";
+    opts.add_option(grp, "w", "world", "Name of the world to load",
+                    cxxopts::value<bs::String>(world), "[NAME]");
+    opts.add_option(grp, "", "helpers",
+                    "Comma separated list of helper functions to run on every character, "
+                    "eg. B_ functions taking no arguments",
+                    cxxopts::value<std::vector<bs::String>>(helpers), "[NAMES]");
+    opts.add_option(grp, "", "characters", "Number of characters to run the functions on",
+                    cxxopts::value<bs::UINT32>(numCharacters), "[NUM]");
+    opts.add_option(grp, "", "iterations", "How often to repeat the whole workload",
+                    cxxopts::value<bs::UINT32>(numIterations), "[NUM]");
+    opts.add_option(grp, "", "profile",
+                    "Profile the workload and write the report to PATH.txt and a chrome trace "
+                    "to PATH.json",
+                    cxxopts::value<bs::String>(profilePath), "[PATH]");
+  }
+
+  virtual void verifyCLIOptions() override
+  {
+    if (world.empty())
+    {
+      REGOTH_THROW(InvalidStateException, "World cannot be empty.");
+    }
+
+    bs::StringUtil::toUpperCase(world);
+    if (!bs::StringUtil::endsWith(world, ".ZEN"))
+    {
+      world += ".ZEN";
+    }
+
+    for (bs::String& h : helpers)
+    {
+      bs::StringUtil::toUpperCase(h);
+    }
+  }
+
+  bs::String world;
+  std::vector<bs::String> helpers;
+  bs::UINT32 numCharacters = 20;
+  bs::UINT32 numIterations = 10;
+  bs::String profilePath;
+};
+
+static void writeTextFile(const bs::Path& path, const bs::String& text)
+{
+  bs::SPtr<bs::DataStream> stream = bs::FileSystem::createAndOpenFile(path);
+  stream->write(text.data(), text.size());
+  stream->close();
+}
+
+class REGothScriptBenchmark : public REGoth::Engine
+{
+public:
+  REGothScriptBenchmark(std::unique_ptr<const ScriptBenchmarkConfig>&& config)
+      : mConfig{std::move(config)}
+  {
+    // pass
+  }
+
+  const ScriptBenchmarkConfig* config() const override
+  {
+    return mConfig.get();
+  }
+
+  void setupScene() override
+  {
+    using namespace REGoth;
+    using namespace REGoth::Scripting;
+
+    HGameWorld world = GameWorld::importZEN(config()->world);
+
+    HCharacter hero = world->insertCharacter("PC_HERO", WORLD_STARTPOINT);
+    hero->useAsHero();
+
+    world->runInitScripts();
+
+    ScriptVMForGameWorld& vm = world->scriptVM();
+
+    bs::Vector<SymbolIndex> loopFunctions = vm.scriptSymbols().query([](const SymbolBase& s) {
+      return s.type == SymbolType::ScriptFunction && bs::StringUtil::startsWith(s.name, "ZS_") &&
+             bs::StringUtil::endsWith(s.name, "_LOOP");
+    });
+
+    bs::Vector<SymbolIndex> helperFunctions;
+    for (const bs::String& h : config()->helpers)
+    {
+      helperFunctions.push_back(vm.scriptSymbols().findIndexBySymbolName(h));
+    }
+
+    const float everywhere = std::numeric_limits<float>::max();
+
+    bs::Vector<HCharacter> characters =
+        world->findCharactersInRange(everywhere, hero->SO()->getTransform().pos());
+
+    if (characters.size() > config()->numCharacters)
+    {
+      characters.resize(config()->numCharacters);
+    }
+
+    REGOTH_LOG(Info, Uncategorized,
+               "[ScriptBenchmark] Running {0} loop- and {1} helper-functions on {2} characters, "
+               "{3} iterations",
+               loopFunctions.size(), helperFunctions.size(), characters.size(),
+               config()->numIterations);
+
+    auto runWorkload = [&]() {
+      auto start = std::chrono::high_resolution_clock::now();
+
+      for (bs::UINT32 i = 0; i < config()->numIterations; i++)
+      {
+        for (HCharacter c : characters)
+        {
+          for (SymbolIndex f : loopFunctions)
+          {
+            vm.runStateLoopFunction(f, c);
+          }
+
+          for (SymbolIndex f : helperFunctions)
+          {
+            vm.runFunctionOnSelf(f, c);
+          }
+        }
+      }
+
+      auto end = std::chrono::high_resolution_clock::now();
+
+      return std::chrono::duration<double, std::milli>(end - start).count();
+    };
+
+    // Same workload, but all loop-functions of an iteration are run in a single batch
+    bs::Vector<ScriptVMForGameWorld::StateLoopCall> batch;
+
+    for (HCharacter c : characters)
+    {
+      for (SymbolIndex f : loopFunctions)
+      {
+        ScriptVMForGameWorld::StateLoopCall call;
+        call.function = f;
+        call.self     = c;
+
+        batch.push_back(call);
+      }
+    }
+
+    ScriptVMForGameWorld::StateLoopBatchStats lastBatch;
+
+    auto runBatchedWorkload = [&]() {
+      auto start = std::chrono::high_resolution_clock::now();
+
+      for (bs::UINT32 i = 0; i < config()->numIterations; i++)
+      {
+        lastBatch = vm.runStateLoopFunctions(batch);
+
+        for (HCharacter c : characters)
+        {
+          for (SymbolIndex f : helperFunctions)
+          {
+            vm.runFunctionOnSelf(f, c);
+          }
+        }
+      }
+
+      auto end = std::chrono::high_resolution_clock::now();
+
+      return std::chrono::duration<double, std::milli>(end - start).count();
+    };
+
+    // Warm up, so both interpreters find all instructions decoded
+    vm.setInterpreter(DaedalusInterpreter::Switch);
+    runWorkload();
+
+    double switchMs = runWorkload();
+
+    vm.setInterpreter(DaedalusInterpreter::Threaded);
+    double threadedMs = runWorkload();
+    double batchedMs  = runBatchedWorkload();
+
+    // Decodes everything again, so warm up once more
+    vm.setSuperinstructionsEnabled(false);
+    runWorkload();
+
+    double threadedPlainMs = runWorkload();
+
+    vm.setSuperinstructionsEnabled(true);
+
+    vm.setConstantFoldingEnabled(false);
+    runWorkload();
+
+    double threadedUnfoldedMs = runWorkload();
+
+    vm.setConstantFoldingEnabled(true);
+
+    // Throws if folding changed what the scripts compute
+    vm.verifyConstantFolding();
+
+    REGOTH_LOG(Info, Uncategorized, "[ScriptBenchmark] Switch:   {0} ms", switchMs);
+    REGOTH_LOG(Info, Uncategorized, "[ScriptBenchmark] Threaded: {0} ms", threadedMs);
+    REGOTH_LOG(Info, Uncategorized, "[ScriptBenchmark] Threaded, batched: {0} ms", batchedMs);
+    REGOTH_LOG(Info, Uncategorized,
+               "[ScriptBenchmark]   Last batch: {0} calls of {1} functions in {2} ms",
+               lastBatch.numCalls, lastBatch.numFunctions, lastBatch.nanoseconds / 1000000.0);
+    REGOTH_LOG(Info, Uncategorized,
+               "[ScriptBenchmark] Threaded without superinstructions: {0} ms", threadedPlainMs);
+    REGOTH_LOG(Info, Uncategorized,
+               "[ScriptBenchmark] Threaded without constant folding: {0} ms", threadedUnfoldedMs);
+
+    if (!config()->profilePath.empty())
+    {
+      vm.setProfilingEnabled(true);
+      runWorkload();
+
+      const DaedalusProfiler& profiler = *vm.profiler();
+
+      bs::Path reportPath = config()->profilePath + ".txt";
+      bs::Path tracePath  = config()->profilePath + ".json";
+
+      writeTextFile(reportPath, profiler.createReport(vm.scriptSymbols()));
+      writeTextFile(tracePath, profiler.createChromeTrace(vm.scriptSymbols()));
+
+      vm.setProfilingEnabled(false);
+
+      REGOTH_LOG(Info, Uncategorized, "[ScriptBenchmark] Wrote profile to {0} and {1}",
+                 reportPath.toString(), tracePath.toString());
+    }
+
+#if !REGOTH_DAEDALUS_THREADED_DISPATCH
+    REGOTH_LOG(Warning, Uncategorized,
+               "[ScriptBenchmark] Built without REGOTH_DAEDALUS_THREADED_DISPATCH, the threaded "
+               "interpreter falls back to the switch!");
+#endif
+
+    bs::gApplication().quitRequested();
+  }
+
+private:
+  std::unique_ptr<const ScriptBenchmarkConfig> mConfig;
+};
+
+int main(int argc, char** argv)
+{
+  auto config = REGoth::parseArguments<ScriptBenchmarkConfig>(argc, argv);
+  REGothScriptBenchmark engine{std::move(config)};
+
+  return REGoth::runEngine(engine);
+}
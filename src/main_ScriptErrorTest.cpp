@@ -0,0 +1,149 @@
+#include <memory>
+
+#include <BsApplication.h>
+#include <String/BsString.h>
+
+#include <core.hpp>
+#include <exception/Throw.hpp>
+#include <log/logging.hpp>
+#include <original-content/VirtualFileSystem.hpp>
+#include <scripting/daedalus/DaedalusProgram.hpp>
+#include <scripting/daedalus/REGothDaedalusVM.hpp>
+
+/**
+ * Checks that the script VM can still be used after an external has thrown: Every external
+ * of the scripts throws, then the startup functions are run until one of them has called an
+ * external. Once the exception is caught, the VM must not consider itself running anymore,
+ * which is checked by reloading the scripts, see DaedalusVM::reloadDAT().
+ *
+ * Done once with the interpreter and once with the tracing VM, which runs calls on the native
+ * stack. Throws if the check fails.
+ */
+class ThrowingExternalsVM : public REGoth::Scripting::DaedalusVM
+{
+public:
+  using DaedalusVM::DaedalusVM;
+
+  /**
+   * Runs the startup functions until one of them has called an external.
+   *
+   * @return Whether any did.
+   */
+  bool runUntilExternalThrows()
+  {
+    using namespace REGoth::Scripting;
+
+    bs::Vector<SymbolIndex> startupFunctions = scriptSymbols().query([](const SymbolBase& s) {
+      return s.type == SymbolType::ScriptFunction &&
+             (bs::StringUtil::startsWith(s.name, "STARTUP_") ||
+              bs::StringUtil::startsWith(s.name, "INIT_"));
+    });
+
+    for (SymbolIndex function : startupFunctions)
+    {
+      mHasExternalThrown = false;
+
+      try
+      {
+        executeScriptFunction(scriptSymbols().getSymbolName(function));
+      }
+      catch (const std::exception&)
+      {
+        if (mHasExternalThrown) return true;
+      }
+    }
+
+    return false;
+  }
+
+  REGoth::Scripting::ScriptObjectHandle instanciateClass(
+      const bs::String& className, const bs::String& instanceName,
+      bs::HSceneObject mappedSceneObject) override
+  {
+    REGOTH_THROW(InvalidStateException, "Not needed by the test");
+  }
+
+  void initializeWorld(const bs::String& worldName) override
+  {
+    // No world to initialize
+  }
+
+protected:
+  void registerAllExternals() override
+  {
+    using namespace REGoth::Scripting;
+
+    using This = ThrowingExternalsVM;
+
+    for (SymbolIndex external : scriptSymbols().symbolsOfType(SymbolType::ExternalFunction))
+    {
+      registerExternal(scriptSymbols().getSymbolName(external),
+                       (externalCallback)&This::external_Throw);
+    }
+  }
+
+private:
+  void external_Throw()
+  {
+    mHasExternalThrown = true;
+
+    REGOTH_THROW(InvalidStateException, "Thrown by the external on purpose");
+  }
+
+  bool mHasExternalThrown = false;
+};
+
+class REGothScriptErrorTester : public REGoth::EmptyGame
+{
+public:
+  using REGoth::EmptyGame::EmptyGame;
+
+  void setupScene() override
+  {
+    runWith(false);
+    runWith(true);
+
+    REGOTH_LOG(Info, Uncategorized, "[ScriptErrorTest] Passed");
+
+    bs::gApplication().quitRequested();
+  }
+
+private:
+  void runWith(bool isTracingEnabled)
+  {
+    using namespace REGoth;
+
+    auto vm = bs::bs_shared_ptr_new<ThrowingExternalsVM>(loadProgram());
+    vm->initialize();
+    vm->setTracingEnabled(isTracingEnabled);
+
+    if (!vm->runUntilExternalThrows())
+    {
+      REGOTH_THROW(InvalidStateException, "No startup function has called an external");
+    }
+
+    // Throws if the VM thinks the scripts are still running
+    vm->reloadDAT(loadProgram());
+
+    REGOTH_LOG(Info, Uncategorized, "[ScriptErrorTest] Reloaded after a throwing external{0}",
+               isTracingEnabled ? " (tracing)" : "");
+  }
+
+  static bs::SPtr<const REGoth::Scripting::DaedalusProgram> loadProgram()
+  {
+    using namespace REGoth;
+
+    std::vector<bs::UINT8> data;
+    gVirtualFileSystem().readFile("GOTHIC.DAT", data);
+
+    return Scripting::DaedalusProgram::share(std::move(data));
+  }
+};
+
+int main(int argc, char** argv)
+{
+  auto config = REGoth::parseArguments<REGoth::EngineConfig>(argc, argv);
+  REGothScriptErrorTester engine{std::move(config)};
+
+  return REGoth::runEngine(engine);
+}
@@ -0,0 +1,701 @@
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <queue>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <BsApplication.h>
+#include <Scene/BsSceneObject.h>
+#include <String/BsString.h>
+
+#include <core.hpp>
+#include <components/Freepoint.hpp>
+#include <components/GameWorld.hpp>
+#include <components/Waynet.hpp>
+#include <core/FrameMonitor.hpp>
+#include <exception/Throw.hpp>
+#include <log/logging.hpp>
+
+/**
+ * Allocations done by the calling thread through `new`, if built with
+ * `REGOTH_COUNT_ALLOCATIONS`. Together with what bs:f counts for its own allocators, this
+ * tells how many allocations a query does.
+ */
+static bs::UINT64 numAllocations()
+{
+  return REGoth::allocationsOfThisThread().numAllocations + bs::MemoryCounter::getNumAllocs();
+}
+
+/**
+ * Finds ways between random pairs of waypoints in the given worlds and logs how long
+ * that took. Also times the queries for the closest waypoints and freepoints.
+ *
+ * Besides the totals, the latency of every single query is measured, so the log shows the
+ * median and the 99th percentile, along with the allocations per query.
+ *
+ * The results of the queries are checked against straight forward reference
+ * implementations: Ways must be as short as the ones found by a plain Dijkstra search, closest
+ * points as close as the ones found by looking at all of them. If any check fails, the
+ * benchmark exits with an error, so it can be used to catch regressions.
+ *
+ * The pairs are generated from a fixed seed, so runs with the same settings are
+ * comparable to each other.
+ */
+struct WaynetBenchmarkConfig : public REGoth::EngineConfig
+{
+  virtual void registerCLIOptions(cxxopts::Options& opts) override
+  {
+    const std::string grp = "WaynetBenchmark";
+    opts.add_option(grp, "w", "worlds", "Comma separated list of worlds to load",
+                    cxxopts::value<std::vector<bs::String>>(worlds), "[NAMES]");
+    opts.add_option(grp, "", "routes", "Number of routes to find per world",
+                    cxxopts::value<bs::UINT32>(numRoutes), "[NUM]");
+    opts.add_option(grp, "", "seed", "Seed for generating the waypoint pairs",
+                    cxxopts::value<bs::UINT32>(seed), "[NUM]");
+    opts.add_option(grp, "", "verify",
+                    "Number of queries per kind to check against the reference implementations",
+                    cxxopts::value<bs::UINT32>(numVerified), "[NUM]");
+  }
+
+  virtual void verifyCLIOptions() override
+  {
+    for (bs::String& world : worlds)
+    {
+      bs::StringUtil::toUpperCase(world);
+      if (!bs::StringUtil::endsWith(world, ".ZEN"))
+      {
+        world += ".ZEN";
+      }
+    }
+  }
+
+  std::vector<bs::String> worlds = {"NEWWORLD.ZEN", "OLDWORLD.ZEN"};
+  bs::UINT32 numRoutes           = 10000;
+  bs::UINT32 seed                = 1;
+  bs::UINT32 numVerified         = 1000;
+};
+
+class REGothWaynetBenchmark : public REGoth::Engine
+{
+public:
+  REGothWaynetBenchmark(std::unique_ptr<const WaynetBenchmarkConfig>&& config)
+      : mConfig{std::move(config)}
+  {
+    // pass
+  }
+
+  const WaynetBenchmarkConfig* config() const override
+  {
+    return mConfig.get();
+  }
+
+  /**
+   * @return Number of queries whose results didn't match the reference implementations.
+   */
+  bs::UINT32 numFailures() const
+  {
+    return mNumFailures;
+  }
+
+  void setupScene() override
+  {
+    using namespace REGoth;
+
+    for (const bs::String& worldName : config()->worlds)
+    {
+      HGameWorld world = GameWorld::importZEN(worldName);
+
+      benchmarkWaynet(worldName, world->waynet());
+    }
+
+    bs::gApplication().quitRequested();
+  }
+
+private:
+  using WaypointPair = std::pair<REGoth::WaypointIndex, REGoth::WaypointIndex>;
+
+  /**
+   * Copy of the waynet to check found ways against, built straight from the waypoints
+   * without going through anything the waynet does itself.
+   */
+  struct ReferenceWaynet
+  {
+    /** Outgoing paths of every waypoint, as target and length */
+    bs::Vector<bs::Vector<std::pair<bs::UINT32, float>>> paths;
+  };
+
+  static ReferenceWaynet buildReference(REGoth::HWaynet waynet)
+  {
+    ReferenceWaynet reference;
+    reference.paths.resize(waynet->numWaypoints());
+
+    for (bs::UINT32 i = 0; i < waynet->numWaypoints(); i++)
+    {
+      const bs::Vector3& from = waynet->waypointPosition(i);
+
+      for (REGoth::WaypointIndex to : waynet->pathsOf(i))
+      {
+        reference.paths[i].push_back({to, from.distance(waynet->waypointPosition(to))});
+      }
+    }
+
+    return reference;
+  }
+
+  /**
+   * @return Length of the shortest way between the given waypoints, found by Dijkstra.
+   *         Infinite if there is none.
+   */
+  static float referenceDistance(const ReferenceWaynet& reference, bs::UINT32 from,
+                                 bs::UINT32 to)
+  {
+    using Entry = std::pair<float, bs::UINT32>;
+
+    bs::Vector<float> costs(reference.paths.size(), std::numeric_limits<float>::infinity());
+    std::priority_queue<Entry, bs::Vector<Entry>, std::greater<Entry>> open;
+
+    costs[from] = 0.0f;
+    open.push({0.0f, from});
+
+    while (!open.empty())
+    {
+      Entry current = open.top();
+      open.pop();
+
+      if (current.second == to) return current.first;
+      if (current.first > costs[current.second]) continue;
+
+      for (const auto& path : reference.paths[current.second])
+      {
+        float cost = current.first + path.second;
+
+        if (cost < costs[path.first])
+        {
+          costs[path.first] = cost;
+          open.push({cost, path.first});
+        }
+      }
+    }
+
+    return std::numeric_limits<float>::infinity();
+  }
+
+  /**
+   * @return Length of the given way, if each waypoint has a path to the next one.
+   *         Negative if not.
+   */
+  static float referenceLength(const ReferenceWaynet& reference,
+                               const bs::Vector<REGoth::WaypointIndex>& way)
+  {
+    float length = 0.0f;
+
+    for (size_t i = 1; i < way.size(); i++)
+    {
+      bs::UINT32 from = way[i - 1];
+      bs::UINT32 to   = way[i];
+
+      const auto& paths = reference.paths[from];
+
+      auto it = std::find_if(paths.begin(), paths.end(),
+                             [to](const std::pair<bs::UINT32, float>& p) { return p.first == to; });
+
+      if (it == paths.end()) return -1.0f;
+
+      length += it->second;
+    }
+
+    return length;
+  }
+
+  /**
+   * Runs the given query `numQueries` times, passing the number of the run, and logs the
+   * median and 99th percentile of how long a single run took, plus the average number
+   * of allocations.
+   */
+  template <typename Query>
+  void measureQueries(const bs::String& worldName, const char* name, size_t numQueries,
+                      Query query)
+  {
+    bs::Vector<double> latencies;
+    latencies.reserve(numQueries);
+
+    bs::UINT64 allocationsBefore = numAllocations();
+
+    for (size_t i = 0; i < numQueries; i++)
+    {
+      auto start = std::chrono::high_resolution_clock::now();
+
+      query(i);
+
+      auto end = std::chrono::high_resolution_clock::now();
+
+      latencies.push_back(std::chrono::duration<double, std::micro>(end - start).count());
+    }
+
+    // Measuring allocates as well, but only once the vector is full
+    bs::UINT64 allocations = numAllocations() - allocationsBefore;
+
+    if (latencies.empty()) return;
+
+    std::sort(latencies.begin(), latencies.end());
+
+    double p50 = latencies[latencies.size() / 2];
+    double p99 = latencies[std::min(latencies.size() - 1, latencies.size() * 99 / 100)];
+
+    REGOTH_LOG(Info, Uncategorized,
+               "[WaynetBenchmark] {0}: {1}: p50 {2} us, p99 {3} us, max {4} us, "
+               "{5} allocations per query",
+               worldName, name, p50, p99, latencies.back(), (double)allocations / numQueries);
+  }
+
+  void reportFailure(const bs::String& worldName, const bs::String& what)
+  {
+    mNumFailures += 1;
+
+    // Only the first few, a broken search would flood the log otherwise
+    if (mNumFailures <= 10)
+    {
+      REGOTH_LOG(Error, Uncategorized, "[WaynetBenchmark] {0}: {1}", worldName, what);
+    }
+  }
+
+  void benchmarkWaynet(const bs::String& worldName, REGoth::HWaynet waynet)
+  {
+    using namespace REGoth;
+
+    if (waynet->numWaypoints() == 0)
+    {
+      REGOTH_LOG(Warning, Uncategorized, "[WaynetBenchmark] {0} has no waypoints", worldName);
+      return;
+    }
+
+    std::mt19937 random(config()->seed);
+    std::uniform_int_distribution<WaypointIndex> pick(0, waynet->numWaypoints() - 1);
+
+    bs::Vector<WaypointPair> pairs;
+    pairs.reserve(config()->numRoutes);
+
+    for (bs::UINT32 i = 0; i < config()->numRoutes; i++)
+    {
+      pairs.push_back({pick(random), pick(random)});
+    }
+
+    // Warm up, so caches inside the waynet are filled
+    waynet->findWay(pairs[0].first, pairs[0].second);
+
+    bs::UINT32 numNotFound  = 0;
+    bs::UINT64 numWaypoints = 0;
+
+    auto start = std::chrono::high_resolution_clock::now();
+
+    for (const auto& pair : pairs)
+    {
+      bs::Vector<WaypointIndex> path = waynet->findWay(pair.first, pair.second);
+
+      if (path.empty()) numNotFound += 1;
+
+      numWaypoints += path.size();
+    }
+
+    auto end = std::chrono::high_resolution_clock::now();
+
+    double ms = std::chrono::duration<double, std::milli>(end - start).count();
+
+    REGOTH_LOG(Info, Uncategorized,
+               "[WaynetBenchmark] {0}: {1} waypoints, {2} routes in {3} ms ({4} us per route)",
+               worldName, waynet->numWaypoints(), pairs.size(), ms, ms * 1000.0 / pairs.size());
+    REGOTH_LOG(Info, Uncategorized,
+               "[WaynetBenchmark] {0}: {1} without a way, {2} waypoints per route on average",
+               worldName, numNotFound, (double)numWaypoints / pairs.size());
+
+    ReferenceWaynet reference = buildReference(waynet);
+
+    benchmarkSearchModes(worldName, waynet, pairs, reference);
+    benchmarkRepeatedRoutes(worldName, waynet, pairs);
+    benchmarkRequestBurst(worldName, waynet, pairs);
+    benchmarkClosestQueries(worldName, waynet, random);
+
+    REGOTH_LOG(Info, Uncategorized, "[WaynetBenchmark] {0}: {1} failed checks", worldName,
+               mNumFailures);
+  }
+
+  /**
+   * Compares searching the flat waynet with searching the clusters first, see
+   * REGoth::AI::WaynetHierarchy, and with looking the ways up in the table of all shortest
+   * ways, see REGoth::AI::WaynetNextHopTable. The route cache is disabled, so every way is
+   * searched. The ways found are checked against the reference.
+   */
+  void benchmarkSearchModes(const bs::String& worldName, REGoth::HWaynet waynet,
+                            const bs::Vector<WaypointPair>& pairs,
+                            const ReferenceWaynet& reference)
+  {
+    REGoth::AI::RouteCache& cache = waynet->routeCache();
+    bs::UINT32 capacity           = cache.capacity();
+
+    cache.setCapacity(0);
+
+    // Without a budget for the table, the ways have to be searched
+    waynet->setNextHopTableBudget(0);
+
+    for (bool isHierarchical : {false, true})
+    {
+      waynet->setHierarchicalSearchEnabled(isHierarchical);
+
+      benchmarkSearchMode(worldName, isHierarchical ? "Hierarchical" : "Flat", waynet, pairs,
+                          reference);
+    }
+
+    waynet->setHierarchicalSearchEnabled(true);
+    waynet->setNextHopTableBudget(REGoth::AI::WaynetNextHopTable::DEFAULT_MEMORY_BUDGET);
+
+    if (waynet->hasNextHopTable())
+    {
+      benchmarkSearchMode(worldName, "Next hop table", waynet, pairs, reference);
+    }
+    else
+    {
+      REGOTH_LOG(Info, Uncategorized, "[WaynetBenchmark] {0}: Too large for a next hop table",
+                 worldName);
+    }
+
+    cache.setCapacity(capacity);
+  }
+
+  void benchmarkSearchMode(const bs::String& worldName, const char* mode,
+                           REGoth::HWaynet waynet, const bs::Vector<WaypointPair>& pairs,
+                           const ReferenceWaynet& reference)
+  {
+    // Warm up, so anything built from the waypoints is there before timing
+    waynet->findWay(pairs[0].first, pairs[0].second);
+
+    REGoth::AI::WaynetSearchStats before = waynet->searchStats();
+
+    auto start = std::chrono::high_resolution_clock::now();
+
+    for (const auto& pair : pairs)
+    {
+      waynet->findWay(pair.first, pair.second);
+    }
+
+    auto end = std::chrono::high_resolution_clock::now();
+
+    double ms = std::chrono::duration<double, std::milli>(end - start).count();
+
+    bs::UINT64 numExpanded = waynet->searchStats().numExpanded - before.numExpanded;
+
+    REGOTH_LOG(Info, Uncategorized,
+               "[WaynetBenchmark] {0}: {1} search: {2} us and {3} nodes expanded per route",
+               worldName, mode, ms * 1000.0 / pairs.size(), (double)numExpanded / pairs.size());
+
+    bs::String name = bs::String(mode) + " findWay";
+
+    measureQueries(worldName, name.c_str(), pairs.size(), [&](size_t i) {
+      waynet->findWay(pairs[i].first, pairs[i].second);
+    });
+
+    size_t numVerified = std::min<size_t>(pairs.size(), config()->numVerified);
+
+    for (size_t i = 0; i < numVerified; i++)
+    {
+      REGoth::WaypointIndex from = pairs[i].first;
+      REGoth::WaypointIndex to   = pairs[i].second;
+
+      bs::Vector<REGoth::WaypointIndex> way = waynet->findWay(from, to);
+
+      float expected = referenceDistance(reference, from, to);
+
+      bs::String route =
+          name + " from " + waynet->waypointName(from) + " to " + waynet->waypointName(to);
+
+      if (way.empty())
+      {
+        if (expected != std::numeric_limits<float>::infinity())
+        {
+          reportFailure(worldName, route + ": No way found, but there is one");
+        }
+
+        continue;
+      }
+
+      if (way.front() != from || way.back() != to)
+      {
+        reportFailure(worldName, route + ": Way doesn't start and end at the given waypoints");
+        continue;
+      }
+
+      float length = referenceLength(reference, way);
+
+      if (length < 0.0f)
+      {
+        reportFailure(worldName, route + ": Way uses paths that don't exist");
+      }
+      else if (length > expected + std::max(0.01f, expected * 0.0001f))
+      {
+        reportFailure(worldName, route + ": Way is " + bs::toString(length) +
+                                     " m long, the shortest is " + bs::toString(expected) + " m");
+      }
+    }
+  }
+
+  /**
+   * Like characters following their daily routines, walks the same few routes over and over,
+   * which should mostly be answered from the route cache of the waynet.
+   */
+  void benchmarkRepeatedRoutes(const bs::String& worldName, REGoth::HWaynet waynet,
+                               const bs::Vector<WaypointPair>& pairs)
+  {
+    const size_t numDistinct = std::min<size_t>(pairs.size(), waynet->routeCache().capacity());
+    const bs::UINT32 numDays = 10;
+
+    REGoth::AI::RouteCache::Stats before = waynet->routeCache().stats();
+
+    auto start = std::chrono::high_resolution_clock::now();
+
+    for (bs::UINT32 day = 0; day < numDays; day++)
+    {
+      for (size_t i = 0; i < numDistinct; i++)
+      {
+        waynet->findWay(pairs[i].first, pairs[i].second);
+      }
+    }
+
+    auto end = std::chrono::high_resolution_clock::now();
+
+    double ms = std::chrono::duration<double, std::milli>(end - start).count();
+
+    const REGoth::AI::RouteCache::Stats& after = waynet->routeCache().stats();
+
+    REGOTH_LOG(Info, Uncategorized,
+               "[WaynetBenchmark] {0}: {1} routes walked {2} times in {3} ms, {4} cache hits, "
+               "{5} misses",
+               worldName, numDistinct, numDays, ms, after.numHits - before.numHits,
+               after.numMisses - before.numMisses);
+  }
+
+  /**
+   * Like at a full hour, where lots of characters change their routine, requests many ways at
+   * once through Waynet::requestWay(). What matters is how long the main thread is busy
+   * issuing them, since the searches themselves run on the workers.
+   */
+  void benchmarkRequestBurst(const bs::String& worldName, REGoth::HWaynet waynet,
+                             const bs::Vector<WaypointPair>& pairs)
+  {
+    // Start without anything remembered, the burst should search every way
+    waynet->routeCache().clear();
+
+    auto start = std::chrono::high_resolution_clock::now();
+
+    bs::Vector<bs::SPtr<REGoth::AI::WayRequest>> requests;
+    requests.reserve(pairs.size());
+
+    for (const auto& pair : pairs)
+    {
+      requests.push_back(waynet->requestWay(pair.first, pair.second));
+    }
+
+    auto issued = std::chrono::high_resolution_clock::now();
+
+    bs::Vector<REGoth::WaypointIndex> path;
+
+    for (const auto& request : requests)
+    {
+      while (!waynet->collectWay(*request, path))
+      {
+        std::this_thread::yield();
+      }
+    }
+
+    auto end = std::chrono::high_resolution_clock::now();
+
+    double issueMs = std::chrono::duration<double, std::milli>(issued - start).count();
+    double totalMs = std::chrono::duration<double, std::milli>(end - start).count();
+
+    REGOTH_LOG(Info, Uncategorized,
+               "[WaynetBenchmark] {0}: Requested {1} ways in {2} ms, all found after {3} ms",
+               worldName, requests.size(), issueMs, totalMs);
+  }
+
+  /**
+   * Times the nearest-waypoint and nearest-freepoint queries the scripts use all the time,
+   * from positions scattered around the waypoints. The results are checked by looking at all
+   * waypoints and freepoints.
+   */
+  void benchmarkClosestQueries(const bs::String& worldName, REGoth::HWaynet waynet,
+                               std::mt19937& random)
+  {
+    using namespace REGoth;
+
+    std::uniform_int_distribution<WaypointIndex> pick(0, waynet->numWaypoints() - 1);
+    std::uniform_real_distribution<float> offset(-10.0f, 10.0f);
+
+    bs::Vector<bs::Vector3> positions;
+    positions.reserve(config()->numRoutes);
+
+    for (bs::UINT32 i = 0; i < config()->numRoutes; i++)
+    {
+      bs::Vector3 around = waynet->waypointPosition(pick(random));
+
+      positions.push_back(around + bs::Vector3(offset(random), 0.0f, offset(random)));
+    }
+
+    // Warm up, so the indices inside the waynet are built
+    waynet->findClosestWaypointTo(positions[0]);
+    waynet->findClosestFreepointTo("ROAM", positions[0]);
+
+    auto start = std::chrono::high_resolution_clock::now();
+
+    for (const bs::Vector3& position : positions)
+    {
+      waynet->findClosestWaypointTo(position);
+    }
+
+    auto middle = std::chrono::high_resolution_clock::now();
+
+    for (const bs::Vector3& position : positions)
+    {
+      waynet->findClosestFreepointTo("ROAM", position);
+    }
+
+    auto end = std::chrono::high_resolution_clock::now();
+
+    double waypointMs  = std::chrono::duration<double, std::milli>(middle - start).count();
+    double freepointMs = std::chrono::duration<double, std::milli>(end - middle).count();
+
+    REGOTH_LOG(Info, Uncategorized,
+               "[WaynetBenchmark] {0}: {1} closest waypoint queries in {2} ms, "
+               "closest ROAM-freepoint in {3} ms",
+               worldName, positions.size(), waypointMs, freepointMs);
+
+    measureQueries(worldName, "findClosestWaypointTo", positions.size(),
+                   [&](size_t i) { waynet->findClosestWaypointTo(positions[i]); });
+
+    bs::Vector<Waynet::ClosestWaypoints> batch;
+
+    auto batchStart = std::chrono::high_resolution_clock::now();
+    waynet->findClosestWaypointsTo(positions, batch);
+    auto batchEnd = std::chrono::high_resolution_clock::now();
+
+    double batchMs = std::chrono::duration<double, std::milli>(batchEnd - batchStart).count();
+
+    REGOTH_LOG(Info, Uncategorized,
+               "[WaynetBenchmark] {0}: {1} closest waypoint queries as one batch in {2} ms",
+               worldName, positions.size(), batchMs);
+
+    for (size_t i = 0; i < positions.size(); i++)
+    {
+      Waynet::ClosestWaypoints single = waynet->findClosestWaypointTo(positions[i]);
+
+      if (batch[i].closest != single.closest || batch[i].secondClosest != single.secondClosest)
+      {
+        reportFailure(worldName, "findClosestWaypointsTo " + bs::toString(positions[i]) +
+                                     ": Batch differs from findClosestWaypointTo");
+      }
+    }
+
+    measureQueries(worldName, "findClosestFreepointTo", positions.size(),
+                   [&](size_t i) { waynet->findClosestFreepointTo("ROAM", positions[i]); });
+
+    bs::Vector<HFreepoint> roamFreepoints;
+
+    for (HFreepoint fp : waynet->allFreepoints())
+    {
+      bs::String name = fp->SO()->getName();
+      bs::StringUtil::toUpperCase(name);
+
+      if (name.find("ROAM") != bs::String::npos) roamFreepoints.push_back(fp);
+    }
+
+    size_t numVerified = std::min<size_t>(positions.size(), config()->numVerified);
+
+    for (size_t i = 0; i < numVerified; i++)
+    {
+      const bs::Vector3& position = positions[i];
+
+      WaypointIndex waypoint = waynet->findClosestWaypointTo(position).closest;
+
+      if (!isClosestWaypoint(position, waypoint, waynet))
+      {
+        reportFailure(worldName, "findClosestWaypointTo " + bs::toString(position) +
+                                     ": There is a closer waypoint than " +
+                                     waynet->waypointName(waypoint));
+      }
+
+      HFreepoint freepoint = waynet->findClosestFreepointTo("ROAM", position).closest;
+
+      if (!freepoint)
+      {
+        if (!roamFreepoints.empty())
+        {
+          reportFailure(worldName, "findClosestFreepointTo " + bs::toString(position) +
+                                       ": No ROAM-freepoint found, but there are some");
+        }
+      }
+      else if (!isClosest(position, freepoint, roamFreepoints))
+      {
+        reportFailure(worldName, "findClosestFreepointTo " + bs::toString(position) +
+                                     ": There is a closer ROAM-freepoint than " +
+                                     freepoint->SO()->getName());
+      }
+    }
+  }
+
+  /**
+   * @return Whether none of the given candidates is closer to the position than `found`.
+   */
+  template <typename Handle>
+  static bool isClosest(const bs::Vector3& position, const Handle& found,
+                        const bs::Vector<Handle>& candidates)
+  {
+    float foundDistance = position.squaredDistance(found->SO()->getTransform().pos());
+
+    for (const Handle& candidate : candidates)
+    {
+      float distance = position.squaredDistance(candidate->SO()->getTransform().pos());
+
+      if (distance < foundDistance - 0.0001f) return false;
+    }
+
+    return true;
+  }
+
+  /**
+   * @return Whether none of the waypoints is closer to the position than `found`.
+   */
+  static bool isClosestWaypoint(const bs::Vector3& position, REGoth::WaypointIndex found,
+                                REGoth::HWaynet waynet)
+  {
+    float foundDistance = position.squaredDistance(waynet->waypointPosition(found));
+
+    for (bs::UINT32 i = 0; i < waynet->numWaypoints(); i++)
+    {
+      float distance = position.squaredDistance(waynet->waypointPosition(i));
+
+      if (distance < foundDistance - 0.0001f) return false;
+    }
+
+    return true;
+  }
+
+  bs::UINT32 mNumFailures = 0;
+  std::unique_ptr<const WaynetBenchmarkConfig> mConfig;
+};
+
+int main(int argc, char** argv)
+{
+  auto config = REGoth::parseArguments<WaynetBenchmarkConfig>(argc, argv);
+  REGothWaynetBenchmark engine{std::move(config)};
+
+  int result = REGoth::runEngine(engine);
+
+  if (result == EXIT_SUCCESS && engine.numFailures() > 0)
+  {
+    return EXIT_FAILURE;
+  }
+
+  return result;
+}
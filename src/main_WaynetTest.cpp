@@ -9,7 +9,7 @@
 #include <components/AnchoredTextLabels.hpp>
 #include <components/GameWorld.hpp>
 #include <components/Waynet.hpp>
-#include <components/Waypoint.hpp>
+#include <core/DebugDrawBatches.hpp>
 #include <exception/Throw.hpp>
 #include <original-content/VirtualFileSystem.hpp>
 
@@ -39,6 +39,8 @@ public:
     HGameWorld world = GameWorld::importZEN("OLDWORLD.ZEN");
 
     world->waynet()->debugDraw(mTextLabels);
+
+    gDebugDrawBatches().setCategoryEnabled(DebugDrawCategory::Routes, true);
   }
 
 protected:
@@ -0,0 +1,218 @@
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <BsApplication.h>
+#include <FileSystem/BsDataStream.h>
+#include <FileSystem/BsFileSystem.h>
+#include <Resources/BsResources.h>
+#include <Scene/BsPrefab.h>
+#include <Scene/BsSceneObject.h>
+#include <String/BsString.h>
+
+#if BS_PLATFORM == BS_PLATFORM_WIN32
+#  include <windows.h>
+#  include <psapi.h>
+#else
+#  include <sys/resource.h>
+#endif
+
+#include <BsZenLib/ImportPath.hpp>
+
+#include <core.hpp>
+#include <components/GameWorld.hpp>
+#include <exception/Throw.hpp>
+#include <log/logging.hpp>
+#include <original-content/VirtualFileSystem.hpp>
+#include <scripting/ScriptVMForGameWorld.hpp>
+
+/**
+ * Measures how long it takes to get a world into the game the different ways there are, so
+ * regressions in load times show up across commits:
+ *
+ *  1. Importing the ZEN,
+ *  2. saving the imported world as cache,
+ *  3. loading the cache and instantiating it,
+ *  4. restoring the script VM from its snapshot, see ScriptVM::initializeFromSnapshot().
+ *
+ * Besides the times, the sizes of the written files and the peak resident memory of the
+ * process are reported. Everything is logged and written as a single JSON object, to the
+ * file given via `--output` or to stdout, so scripts can collect and compare the results.
+ */
+struct WorldCacheBenchmarkConfig : public REGoth::EngineConfig
+{
+  virtual void registerCLIOptions(cxxopts::Options& opts) override
+  {
+    const std::string grp = "WorldCacheBenchmark";
+    opts.add_option(grp, "w", "world", "Name of the world to load",
+                    cxxopts::value<bs::String>(world), "[NAME]");
+    opts.add_option(grp, "", "output", "Write the results as JSON to PATH instead of stdout",
+                    cxxopts::value<bs::String>(outputPath), "[PATH]");
+  }
+
+  virtual void verifyCLIOptions() override
+  {
+    if (world.empty())
+    {
+      REGOTH_THROW(InvalidStateException, "World cannot be empty.");
+    }
+
+    bs::StringUtil::toUpperCase(world);
+    if (!bs::StringUtil::endsWith(world, ".ZEN"))
+    {
+      world += ".ZEN";
+    }
+  }
+
+  bs::String world = "OLDWORLD.ZEN";
+  bs::String outputPath;
+};
+
+/**
+ * @return Peak resident memory of this process so far in bytes. 0 if unknown.
+ */
+static bs::UINT64 peakResidentBytes()
+{
+#if BS_PLATFORM == BS_PLATFORM_WIN32
+  PROCESS_MEMORY_COUNTERS counters;
+
+  if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) return 0;
+
+  return counters.PeakWorkingSetSize;
+#else
+  struct rusage usage;
+
+  if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+
+#  if BS_PLATFORM == BS_PLATFORM_OSX
+  return (bs::UINT64)usage.ru_maxrss;
+#  else
+  // Linux reports kilobytes
+  return (bs::UINT64)usage.ru_maxrss * 1024;
+#  endif
+#endif
+}
+
+static bs::UINT64 fileSize(const bs::Path& path)
+{
+  if (!bs::FileSystem::exists(path)) return 0;
+
+  return bs::FileSystem::getFileSize(path);
+}
+
+/**
+ * @return How long the given function took in milliseconds.
+ */
+static double measureMs(const std::function<void()>& fn)
+{
+  auto start = std::chrono::high_resolution_clock::now();
+
+  fn();
+
+  auto end = std::chrono::high_resolution_clock::now();
+
+  return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+class REGothWorldCacheBenchmark : public REGoth::Engine
+{
+public:
+  REGothWorldCacheBenchmark(std::unique_ptr<const WorldCacheBenchmarkConfig>&& config)
+      : mConfig{std::move(config)}
+  {
+    // pass
+  }
+
+  const WorldCacheBenchmarkConfig* config() const override
+  {
+    return mConfig.get();
+  }
+
+  void setupScene() override
+  {
+    using namespace REGoth;
+
+    const bs::String saveGame = "WorldCacheBenchmark";
+    const bs::Path savePath   = BsZenLib::GothicPathToCachedWorld(saveGame);
+
+    HGameWorld imported;
+
+    double importMs = measureMs([&]() { imported = GameWorld::importZEN(config()->world); });
+    double saveMs   = measureMs([&]() { imported->save(saveGame); });
+
+    imported->SO()->destroy();
+
+    bs::HPrefab prefab;
+    bs::HSceneObject loaded;
+
+    double loadMs        = measureMs([&]() { prefab = GameWorld::load(saveGame); });
+    double instantiateMs = measureMs([&]() { loaded = prefab->instantiate(); });
+
+    HGameWorld world = loaded->getComponent<GameWorld>();
+
+    // Same as GameWorld does for a freshly imported world
+    const bs::Path snapshotPath = BsZenLib::GothicPathToCachedWorld("GOTHIC.DAT.SCRIPTVM");
+
+    std::vector<bs::UINT8> datFile;
+    gVirtualFileSystem().readFile("GOTHIC.DAT", datFile);
+
+    auto vm = bs::bs_shared_ptr_new<Scripting::ScriptVMForGameWorld>(
+        world, Scripting::DaedalusProgram::share(std::move(datFile)));
+
+    bool isRestored        = false;
+    double scriptRestoreMs = measureMs([&]() {
+      isRestored = vm->initializeFromSnapshot(snapshotPath);
+    });
+
+    vm = nullptr;
+
+    if (!isRestored)
+    {
+      REGOTH_LOG(Warning, Uncategorized,
+                 "[WorldCacheBenchmark] No up to date script VM snapshot at {0}",
+                 snapshotPath.toString());
+    }
+
+    bs::String json = "{";
+    json += "\"world\": \"" + config()->world + "\", ";
+    json += "\"importMs\": " + bs::toString(importMs) + ", ";
+    json += "\"cacheSaveMs\": " + bs::toString(saveMs) + ", ";
+    json += "\"cacheLoadMs\": " + bs::toString(loadMs) + ", ";
+    json += "\"instantiateMs\": " + bs::toString(instantiateMs) + ", ";
+    json += "\"scriptRestoreMs\": " + bs::toString(scriptRestoreMs) + ", ";
+    json += "\"isScriptRestored\": " + bs::String(isRestored ? "true" : "false") + ", ";
+    json += "\"cacheBytes\": " + bs::toString(fileSize(savePath)) + ", ";
+    json += "\"scriptSnapshotBytes\": " + bs::toString(fileSize(snapshotPath)) + ", ";
+    json += "\"peakResidentBytes\": " + bs::toString(peakResidentBytes());
+    json += "}";
+
+    REGOTH_LOG(Info, Uncategorized, "[WorldCacheBenchmark] {0}", json);
+
+    if (config()->outputPath.empty())
+    {
+      std::cout << json << std::endl;
+    }
+    else
+    {
+      bs::SPtr<bs::DataStream> stream = bs::FileSystem::createAndOpenFile(config()->outputPath);
+      stream->write(json.data(), json.size());
+      stream->close();
+    }
+
+    bs::gApplication().quitRequested();
+  }
+
+private:
+  std::unique_ptr<const WorldCacheBenchmarkConfig> mConfig;
+};
+
+int main(int argc, char** argv)
+{
+  auto config = REGoth::parseArguments<WorldCacheBenchmarkConfig>(argc, argv);
+  REGothWorldCacheBenchmark engine{std::move(config)};
+
+  return REGoth::runEngine(engine);
+}
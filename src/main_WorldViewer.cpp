@@ -3,7 +3,6 @@
 
 #include "BsFPSCamera.h"
 #include <Components/BsCCamera.h>
-#include <Scene/BsPrefab.h>
 #include <Scene/BsSceneObject.h>
 #include <String/BsString.h>
 
@@ -91,31 +90,18 @@ public:
   {
     using namespace REGoth;
 
-    const bs::String SAVEGAME = "WorldViewer-" + config()->world;
+    const bs::String& zenFile = config()->world;
 
-    bs::HPrefab worldPrefab = GameWorld::load(SAVEGAME);
-    HGameWorld world;
+    HGameWorld world = GameWorld::loadOrImportZEN(
+        zenFile, GameWorld::startingSaveName(zenFile), [](HGameWorld imported) {
+          HCharacter hero = imported->insertCharacter("PC_HERO", WORLD_STARTPOINT);
+          hero->useAsHero();
+          hero->SO()->addComponent<CharacterKeyboardInput>(imported);
 
-    if (!worldPrefab)
-    {
-      world = GameWorld::importZEN(config()->world);
-
-      HCharacter hero = world->insertCharacter("PC_HERO", WORLD_STARTPOINT);
-      hero->useAsHero();
-      hero->SO()->addComponent<CharacterKeyboardInput>(world);
-
-      // bs::HSceneObject diegoSO = world->insertCharacter("PC_THIEF", "WP_INTRO_FALL3")->SO();
-
-      world->runInitScripts();
+          // imported->insertCharacter("PC_THIEF", "WP_INTRO_FALL3");
 
-      world->save(SAVEGAME);
-    }
-    else
-    {
-      bs::HSceneObject worldSO = worldPrefab->instantiate();
-
-      world = worldSO->getComponent<GameWorld>();
-    }
+          imported->runInitScripts();
+        });
 
     bs::HSceneObject heroSO = world->SO()->findChild("PC_HERO");
 
@@ -130,7 +116,7 @@ public:
 
     REGoth::GameplayUI::createGlobal(mMainCamera);
 
-    auto inventory = hero->SO()->getComponent<Inventory>();
+    auto inventory = hero->inventory();
 
     inventory->giveItem("ITFOAPPLE");
     inventory->giveItem("ITFOAPPLE");
@@ -0,0 +1,121 @@
+#include "CharacterVariantCache.hpp"
+#include <Image/BsTexture.h>
+#include <Material/BsMaterial.h>
+#include <cctype>
+#include <log/logging.hpp>
+#include <original-content/OriginalGameResources.hpp>
+#include <original-content/SharedMaterials.hpp>
+
+namespace REGoth
+{
+  static const char* ALBEDO_TEXTURE_PARAMETER = "gAlbedoTex";
+
+  /**
+   * Replaces the number following the last occurrence of the given tag, like `_V` inside
+   * `HUM_HEAD_V0_C0.TGA`. Names without the tag are returned unchanged.
+   */
+  static bs::String replaceNumberAfter(const bs::String& name, const bs::String& tag,
+                                       bs::UINT32 number)
+  {
+    size_t tagStart = name.rfind(tag);
+
+    if (tagStart == bs::String::npos) return name;
+
+    size_t numberStart = tagStart + tag.size();
+    size_t numberEnd   = numberStart;
+
+    while (numberEnd < name.size() && std::isdigit((unsigned char)name[numberEnd]))
+    {
+      numberEnd += 1;
+    }
+
+    // Something like `_VOB` is not a variant
+    if (numberEnd == numberStart) return name;
+
+    return name.substr(0, numberStart) + bs::toString(number) + name.substr(numberEnd);
+  }
+
+  /**
+   * @param  name  UPPERCASE name of the texture of the default variant.
+   */
+  static bs::String variantTextureName(bs::String name, const CharacterTextureVariant& variant)
+  {
+    bool isTeeth = name.find("TEETH") != bs::String::npos;
+
+    name = replaceNumberAfter(name, "_V", isTeeth ? variant.teethIdx : variant.textureIdx);
+    name = replaceNumberAfter(name, "_C", variant.colorIdx);
+
+    return name;
+  }
+
+  const bs::Vector<bs::HMaterial>& CharacterVariantCache::materials(
+      const BsZenLib::Res::HMeshWithMaterials& mesh, const CharacterTextureVariant& variant)
+  {
+    bs::String key = mesh.getUUID().toString() + "_" + bs::toString(variant.textureIdx) + "_" +
+                     bs::toString(variant.colorIdx) + "_" + bs::toString(variant.teethIdx);
+
+    auto it = mMeshMaterials.find(key);
+
+    if (it != mMeshMaterials.end()) return it->second;
+
+    bs::Vector<bs::HMaterial> materials;
+
+    // Variants of materials looking the same are shared as well
+    for (const bs::HMaterial& original : gSharedMaterials().find(mesh->getMaterials()))
+    {
+      materials.push_back(variantMaterial(original, variant));
+    }
+
+    return mMeshMaterials[key] = std::move(materials);
+  }
+
+  bs::HMaterial CharacterVariantCache::variantMaterial(const bs::HMaterial& original,
+                                                       const CharacterTextureVariant& variant)
+  {
+    if (!original || !original->getShader()) return original;
+
+    if (!original->getShader()->hasTextureParam(ALBEDO_TEXTURE_PARAMETER)) return original;
+
+    bs::HTexture originalTexture = original->getTexture(ALBEDO_TEXTURE_PARAMETER);
+
+    if (!originalTexture) return original;
+
+    bs::String originalName = originalTexture->getName();
+    bs::StringUtil::toUpperCase(originalName);
+
+    bs::String textureName = variantTextureName(originalName, variant);
+
+    // Usually the default variant, which is what most characters use
+    if (textureName == originalName) return original;
+
+    bs::String key = original.getUUID().toString() + "_" + textureName;
+
+    auto it = mVariantMaterials.find(key);
+
+    if (it != mVariantMaterials.end()) return it->second;
+
+    bs::HTexture texture = gOriginalGameResources().texture(textureName);
+
+    if (!texture)
+    {
+      REGOTH_LOG(Warning, Uncategorized,
+                 "[CharacterVariantCache] Variant texture {0} not found, keeping {1}",
+                 textureName, originalTexture->getName());
+
+      // Remembered as well, so the texture isn't searched for again
+      return mVariantMaterials[key] = original;
+    }
+
+    bs::HMaterial material = original->clone();
+    material->setTexture(ALBEDO_TEXTURE_PARAMETER, texture);
+
+    return mVariantMaterials[key] = material;
+  }
+
+  CharacterVariantCache& gCharacterVariantCache()
+  {
+    static CharacterVariantCache s_instance;
+
+    return s_instance;
+  }
+}  // namespace REGoth
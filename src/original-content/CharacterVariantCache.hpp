@@ -0,0 +1,91 @@
+#pragma once
+#include <BsPrerequisites.h>
+#include <BsZenLib/ZenResources.hpp>
+
+namespace REGoth
+{
+  /**
+   * Which texture variant of a character's body or head to show, as set by the
+   * `MDL_SetVisualBody` script external.
+   *
+   * The original game encodes variants inside the texture names: `HUM_BODY_NAKED_V0_C0.TGA`
+   * is the first texture in the first skin color. Showing a different variant means replacing
+   * the numbers after `_V` and `_C`.
+   */
+  struct CharacterTextureVariant
+  {
+    bs::UINT32 textureIdx = 0; /**< Number after `_V`, e.g. the body or face texture */
+    bs::UINT32 colorIdx   = 0; /**< Number after `_C`, the skin color */
+    bs::UINT32 teethIdx   = 0; /**< Number after `_V` of teeth textures, only used by heads */
+
+    bool operator==(const CharacterTextureVariant& other) const
+    {
+      return textureIdx == other.textureIdx && colorIdx == other.colorIdx &&
+             teethIdx == other.teethIdx;
+    }
+
+    bool operator!=(const CharacterTextureVariant& other) const
+    {
+      return !(*this == other);
+    }
+  };
+
+  /**
+   * Provides the materials of body and head meshes in a given texture variant.
+   *
+   * Characters looking the same share the same materials instead of every one of them
+   * creating its own copies. Together with the meshes, which are already shared through the
+   * model script and OriginalGameResources, everything about the looks of two characters with
+   * the same body mesh, body texture, skin color, head mesh, head texture and teeth is the
+   * same resource, so the renderer binds them once.
+   *
+   * Materials are shared further down as well: A body material only depends on its original
+   * material and the variant texture, so a character with a different head still shares the
+   * body materials.
+   */
+  class CharacterVariantCache
+  {
+  public:
+    /**
+     * @param  mesh     Body or head mesh showing its original materials.
+     * @param  variant  Texture variant to show the mesh in.
+     *
+     * @return The materials of the given mesh, with their textures replaced by the given
+     *         variant. Materials which don't have a variant texture are kept as they are.
+     */
+    const bs::Vector<bs::HMaterial>& materials(const BsZenLib::Res::HMeshWithMaterials& mesh,
+                                               const CharacterTextureVariant& variant);
+
+    /**
+     * @return Number of material copies made for texture variants.
+     */
+    size_t numVariantMaterials() const
+    {
+      return mVariantMaterials.size();
+    }
+
+  private:
+    /**
+     * @return Copy of the given material showing the given variant texture. The original
+     *         material if the variant is what it already shows or if the variant texture
+     *         doesn't exist.
+     */
+    bs::HMaterial variantMaterial(const bs::HMaterial& original,
+                                  const CharacterTextureVariant& variant);
+
+    /**
+     * Materials of a mesh in a variant. Keyed by the mesh and the numbers of the variant.
+     */
+    bs::UnorderedMap<bs::String, bs::Vector<bs::HMaterial>> mMeshMaterials;
+
+    /**
+     * Keyed by the original material and the name of the variant texture.
+     */
+    bs::UnorderedMap<bs::String, bs::HMaterial> mVariantMaterials;
+  };
+
+  /**
+   * Global access to the character variant cache.
+   */
+  CharacterVariantCache& gCharacterVariantCache();
+}  // namespace REGoth
@@ -0,0 +1,252 @@
+#include "MappedPackage.hpp"
+#include <String/BsUnicode.h>
+#include <log/logging.hpp>
+#include <algorithm>
+#include <cstring>
+
+#if BS_PLATFORM == BS_PLATFORM_WIN32
+#  define WIN32_LEAN_AND_MEAN
+#  include <windows.h>
+#else
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+
+namespace REGoth
+{
+  /** Size of the header of a VDF package, which is followed by the directory */
+  constexpr size_t VDF_HEADER_SIZE = 296;
+
+  /** Offsets of the values inside the header */
+  constexpr size_t VDF_OFFSET_SIGNATURE   = 256;
+  constexpr size_t VDF_OFFSET_NUM_ENTRIES = 272;
+  constexpr size_t VDF_OFFSET_TIMESTAMP   = 280;
+  constexpr size_t VDF_OFFSET_ROOT_OFFSET = 288;
+
+  /** Size of an entry of the directory, which starts with the name */
+  constexpr size_t VDF_ENTRY_SIZE      = 80;
+  constexpr size_t VDF_ENTRY_NAME_SIZE = 64;
+
+  /** Set in the type of an entry if it is a directory instead of a file */
+  constexpr bs::UINT32 VDF_ENTRY_TYPE_DIRECTORY = 0x80000000;
+
+  static bs::UINT32 readUInt32(const bs::UINT8* data, size_t offset)
+  {
+    bs::UINT32 value;
+    std::memcpy(&value, data + offset, sizeof(value));
+
+    return value;
+  }
+
+  bs::SPtr<MappedPackage> MappedPackage::open(const bs::Path& path)
+  {
+    // Constructor is private, so bs_shared_ptr_new() can't be used
+    auto package   = bs::bs_shared_ptr(new (bs::bs_alloc<MappedPackage>()) MappedPackage());
+    package->mPath = path;
+
+    if (!package->map())
+    {
+      REGOTH_LOG(Warning, VDFS, "[MappedPackage] Failed to map package: {0}",
+                 path.toString());
+      return nullptr;
+    }
+
+    if (!package->readDirectory())
+    {
+      REGOTH_LOG(Warning, VDFS, "[MappedPackage] Not a valid VDF package: {0}",
+                 path.toString());
+      return nullptr;
+    }
+
+    return package;
+  }
+
+  bs::SPtr<MappedPackage> MappedPackage::open(const bs::Path& path, bs::UINT32 timestamp,
+                                              const bs::UnorderedMap<bs::String, Entry>& entries)
+  {
+    auto package   = bs::bs_shared_ptr(new (bs::bs_alloc<MappedPackage>()) MappedPackage());
+    package->mPath = path;
+
+    if (!package->map())
+    {
+      REGOTH_LOG(Warning, VDFS, "[MappedPackage] Failed to map package: {0}",
+                 path.toString());
+      return nullptr;
+    }
+
+    for (const auto& entry : entries)
+    {
+      if ((bs::UINT64)entry.second.offset + entry.second.size > package->mSize) return nullptr;
+    }
+
+    package->mTimestamp = timestamp;
+    package->mEntries   = entries;
+
+    return package;
+  }
+
+  MappedPackage::~MappedPackage()
+  {
+    unmap();
+  }
+
+  bool MappedPackage::readDirectory()
+  {
+    if (mSize < VDF_HEADER_SIZE) return false;
+
+    // Gothic and Gothic II use different line endings after the version
+    if (std::memcmp(mData + VDF_OFFSET_SIGNATURE, "PSVDSC_V2.00", 12) != 0) return false;
+
+    bs::UINT32 numEntries = readUInt32(mData, VDF_OFFSET_NUM_ENTRIES);
+    bs::UINT32 rootOffset = readUInt32(mData, VDF_OFFSET_ROOT_OFFSET);
+    mTimestamp            = readUInt32(mData, VDF_OFFSET_TIMESTAMP);
+
+    if (rootOffset + (bs::UINT64)numEntries * VDF_ENTRY_SIZE > mSize) return false;
+
+    // All entries are in one table, directories refer to the first entry inside them. Since
+    // the directory structure isn't kept, the table can just be read from front to back.
+    for (bs::UINT32 i = 0; i < numEntries; i++)
+    {
+      const bs::UINT8* entry = mData + rootOffset + i * VDF_ENTRY_SIZE;
+
+      Entry file;
+      file.offset          = readUInt32(entry, VDF_ENTRY_NAME_SIZE);
+      file.size            = readUInt32(entry, VDF_ENTRY_NAME_SIZE + 4);
+      bs::UINT32 entryType = readUInt32(entry, VDF_ENTRY_NAME_SIZE + 8);
+
+      if (entryType & VDF_ENTRY_TYPE_DIRECTORY) continue;
+
+      if ((bs::UINT64)file.offset + file.size > mSize)
+      {
+        REGOTH_LOG(Warning, VDFS, "[MappedPackage] Entry {0} of {1} is truncated", i,
+                   mPath.toString());
+        continue;
+      }
+
+      // Names are padded with spaces
+      size_t nameLength = VDF_ENTRY_NAME_SIZE;
+      while (nameLength > 0 && (entry[nameLength - 1] == ' ' || entry[nameLength - 1] == '\0'))
+      {
+        nameLength--;
+      }
+
+      bs::String name((const char*)entry, nameLength);
+      bs::StringUtil::toUpperCase(name);
+
+      mEntries[name] = file;
+    }
+
+    return true;
+  }
+
+#if BS_PLATFORM == BS_PLATFORM_WIN32
+
+  void MappedPackage::prefetch(bs::UINT64 /* offset */, bs::UINT64 /* size */) const
+  {
+    // PrefetchVirtualMemory() would need Windows 8, the mapping is read on demand instead
+  }
+
+  bool MappedPackage::map()
+  {
+    bs::WString widePath = bs::UTF8::toWide(mPath.toString());
+
+    HANDLE file = CreateFileW(widePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+    if (file == INVALID_HANDLE_VALUE) return false;
+
+    mFileHandle = file;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+    {
+      unmap();
+      return false;
+    }
+
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+    if (!mapping)
+    {
+      unmap();
+      return false;
+    }
+
+    mMappingHandle = mapping;
+
+    mData = (const bs::UINT8*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    mSize = (size_t)size.QuadPart;
+
+    if (!mData)
+    {
+      unmap();
+      return false;
+    }
+
+    return true;
+  }
+
+  void MappedPackage::unmap()
+  {
+    if (mData) UnmapViewOfFile(mData);
+    if (mMappingHandle) CloseHandle(mMappingHandle);
+    if (mFileHandle) CloseHandle(mFileHandle);
+
+    mData          = nullptr;
+    mSize          = 0;
+    mMappingHandle = nullptr;
+    mFileHandle    = nullptr;
+  }
+
+#else
+
+  void MappedPackage::prefetch(bs::UINT64 offset, bs::UINT64 size) const
+  {
+    if (!mData || offset >= mSize) return;
+
+    // madvise() wants the start to be aligned to a page
+    bs::UINT64 pageSize = (bs::UINT64)sysconf(_SC_PAGESIZE);
+    bs::UINT64 start    = offset - offset % pageSize;
+    bs::UINT64 end      = std::min<bs::UINT64>(offset + size, mSize);
+
+    madvise((void*)(mData + start), (size_t)(end - start), MADV_WILLNEED);
+  }
+
+  bool MappedPackage::map()
+  {
+    int fd = ::open(mPath.toString().c_str(), O_RDONLY);
+
+    if (fd < 0) return false;
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size == 0)
+    {
+      ::close(fd);
+      return false;
+    }
+
+    void* data = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+
+    // The mapping keeps the file open by itself
+    ::close(fd);
+
+    if (data == MAP_FAILED) return false;
+
+    mData = (const bs::UINT8*)data;
+    mSize = (size_t)info.st_size;
+
+    return true;
+  }
+
+  void MappedPackage::unmap()
+  {
+    if (mData) munmap((void*)mData, mSize);
+
+    mData = nullptr;
+    mSize = 0;
+  }
+
+#endif
+}  // namespace REGoth
@@ -0,0 +1,131 @@
+#pragma once
+#include <BsPrerequisites.h>
+#include <FileSystem/BsPath.h>
+
+namespace REGoth
+{
+  /**
+   * A VDF package mapped into memory.
+   *
+   * The whole package file is mapped read-only once, so the contents of the files inside it
+   * can be used right from the mapping without reading or copying them. Since the files of a
+   * VDF are stored uncompressed, that is all there is to reading one. The pages are shared
+   * with the OS page cache, so engine processes running at the same time don't each keep
+   * their own copy of the game files in memory.
+   *
+   * Only the directory of the package is parsed, into a flat list of files like the VDFS
+   * itself keeps one, see VirtualFileSystem.
+   */
+  class MappedPackage
+  {
+  public:
+    /**
+     * Where the contents of a file are found inside the package.
+     */
+    struct Entry
+    {
+      bs::UINT32 offset = 0;
+      bs::UINT32 size   = 0;
+    };
+
+    /**
+     * Maps the given VDF package and reads its directory.
+     *
+     * @param  path  Path of the package on disk.
+     *
+     * @return The mapped package. nullptr if the file could not be mapped or is not a valid
+     *         VDF package.
+     */
+    static bs::SPtr<MappedPackage> open(const bs::Path& path);
+
+    /**
+     * Maps the given VDF package, using a directory read from it before instead of reading
+     * it again, see VdfsIndexCache.
+     *
+     * @param  path       Path of the package on disk.
+     * @param  timestamp  Timestamp read from the package before.
+     * @param  entries    Directory read from the package before.
+     *
+     * @return The mapped package. nullptr if the file could not be mapped or the directory
+     *         doesn't fit the file.
+     */
+    static bs::SPtr<MappedPackage> open(const bs::Path& path, bs::UINT32 timestamp,
+                                        const bs::UnorderedMap<bs::String, Entry>& entries);
+
+    ~MappedPackage();
+
+    MappedPackage(const MappedPackage&) = delete;
+    MappedPackage& operator=(const MappedPackage&) = delete;
+
+    /**
+     * @return Files inside the package by their name, all UPPERCASE.
+     */
+    const bs::UnorderedMap<bs::String, Entry>& entries() const
+    {
+      return mEntries;
+    }
+
+    /**
+     * @return Pointer to the contents of the given file inside the mapping. Valid for as long
+     *         as the package is alive.
+     */
+    const bs::UINT8* data(const Entry& entry) const
+    {
+      return mData + entry.offset;
+    }
+
+    /**
+     * Tells the OS that the given range of the package is going to be read soon, so it can
+     * start loading it from disk in the background. Does not wait for that to happen.
+     *
+     * @param  offset  Start of the range inside the package.
+     * @param  size    Size of the range in bytes.
+     */
+    void prefetch(bs::UINT64 offset, bs::UINT64 size) const;
+
+    /**
+     * @return DOS timestamp of the package. Packages built later have larger timestamps.
+     */
+    bs::UINT32 timestamp() const
+    {
+      return mTimestamp;
+    }
+
+    const bs::Path& path() const
+    {
+      return mPath;
+    }
+
+  private:
+    MappedPackage() = default;
+
+    /**
+     * Maps the file at mPath into memory.
+     *
+     * @return Whether that worked.
+     */
+    bool map();
+
+    /**
+     * Unmaps the file, if it is mapped.
+     */
+    void unmap();
+
+    /**
+     * Parses the header and directory of the mapped package into mEntries.
+     *
+     * @return Whether the package is a valid VDF package.
+     */
+    bool readDirectory();
+
+    bs::Path mPath;
+    const bs::UINT8* mData = nullptr;
+    size_t mSize           = 0;
+    bs::UINT32 mTimestamp  = 0;
+    bs::UnorderedMap<bs::String, Entry> mEntries;
+
+    /** Platform specific handles of the file and the mapping */
+    void* mFileHandle    = nullptr;
+    void* mMappingHandle = nullptr;
+  };
+}  // namespace REGoth
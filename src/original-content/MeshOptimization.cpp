@@ -0,0 +1,255 @@
+#include "MeshOptimization.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace REGoth
+{
+  /**
+   * Score of a vertex used by the triangle drawn last. Lower than that of the vertices used
+   * just before, so the next triangle doesn't simply turn around on the same edge.
+   */
+  constexpr float MESH_OPTIMIZATION_LAST_TRIANGLE_SCORE = 0.75f;
+
+  /** How fast the score of a vertex drops with its position in the cache */
+  constexpr float MESH_OPTIMIZATION_CACHE_DECAY_POWER = 1.5f;
+
+  /**
+   * Bonus for vertices with few triangles left, so those are finished before they fall out of
+   * the cache and would have to be transformed again.
+   */
+  constexpr float MESH_OPTIMIZATION_VALENCE_BOOST_SCALE = 2.0f;
+  constexpr float MESH_OPTIMIZATION_VALENCE_BOOST_POWER = 0.5f;
+
+  /**
+   * @param  cachePosition     Position of the vertex in the simulated cache, -1 if it is not
+   *                           in there.
+   * @param  numOpenTriangles  Number of triangles using the vertex which are not drawn yet.
+   *
+   * @return How much drawing a triangle using the given vertex next is worth.
+   */
+  static float vertexScore(bs::INT32 cachePosition, bs::UINT32 numOpenTriangles)
+  {
+    if (numOpenTriangles == 0) return -1.0f;
+
+    float score = 0.0f;
+
+    if (cachePosition >= 0 && cachePosition < 3)
+    {
+      score = MESH_OPTIMIZATION_LAST_TRIANGLE_SCORE;
+    }
+    else if (cachePosition >= 3)
+    {
+      float scale = 1.0f / (MESH_OPTIMIZATION_VERTEX_CACHE_SIZE - 3);
+      score       = std::pow(1.0f - (cachePosition - 3) * scale,
+                       MESH_OPTIMIZATION_CACHE_DECAY_POWER);
+    }
+
+    return score + MESH_OPTIMIZATION_VALENCE_BOOST_SCALE *
+                       std::pow((float)numOpenTriangles, -MESH_OPTIMIZATION_VALENCE_BOOST_POWER);
+  }
+
+  bs::Vector<bs::UINT32> optimizeTriangleOrder(bs::UINT32* indices, bs::UINT32 numIndices,
+                                               bs::UINT32 numVertices)
+  {
+    bs::UINT32 numTriangles = numIndices / 3;
+
+    bs::Vector<bs::UINT32> order;
+    order.reserve(numTriangles);
+
+    if (numTriangles == 0) return order;
+
+    // Triangles using each vertex, the ones not drawn yet first. Those of vertex `v` start at
+    // `firstTriangle[v]`.
+    bs::Vector<bs::UINT32> firstTriangle(numVertices + 1, 0);
+    bs::Vector<bs::UINT32> numOpenTriangles(numVertices, 0);
+
+    for (bs::UINT32 i = 0; i < numTriangles * 3; i++)
+    {
+      numOpenTriangles[indices[i]] += 1;
+    }
+
+    for (bs::UINT32 v = 0; v < numVertices; v++)
+    {
+      firstTriangle[v + 1] = firstTriangle[v] + numOpenTriangles[v];
+    }
+
+    bs::Vector<bs::UINT32> trianglesOfVertex(numTriangles * 3);
+    bs::Vector<bs::UINT32> numFilled(numVertices, 0);
+
+    for (bs::UINT32 t = 0; t < numTriangles; t++)
+    {
+      for (bs::UINT32 k = 0; k < 3; k++)
+      {
+        bs::UINT32 v = indices[t * 3 + k];
+
+        trianglesOfVertex[firstTriangle[v] + numFilled[v]++] = t;
+      }
+    }
+
+    bs::Vector<bs::INT32> cachePositions(numVertices, -1);
+    bs::Vector<float> vertexScores(numVertices);
+    bs::Vector<float> triangleScores(numTriangles, 0.0f);
+    bs::Vector<bool> isDrawn(numTriangles, false);
+
+    for (bs::UINT32 v = 0; v < numVertices; v++)
+    {
+      vertexScores[v] = vertexScore(-1, numOpenTriangles[v]);
+    }
+
+    for (bs::UINT32 i = 0; i < numTriangles * 3; i++)
+    {
+      triangleScores[i / 3] += vertexScores[indices[i]];
+    }
+
+    // Most recently used vertices first. May hold up to 3 more than the cache while updating.
+    bs::Vector<bs::UINT32> cache;
+    bs::Vector<bs::UINT32> newCache;
+    cache.reserve(MESH_OPTIMIZATION_VERTEX_CACHE_SIZE + 3);
+    newCache.reserve(MESH_OPTIMIZATION_VERTEX_CACHE_SIZE + 3);
+
+    bs::INT64 best           = 0;
+    bs::UINT32 firstNotDrawn = 0;
+
+    while (order.size() < numTriangles)
+    {
+      // Nothing in the cache has triangles left: Go on with any triangle not drawn yet.
+      // Searching for the best one would make this quadratic.
+      if (best < 0)
+      {
+        while (isDrawn[firstNotDrawn])
+        {
+          firstNotDrawn++;
+        }
+
+        best = firstNotDrawn;
+      }
+
+      bs::UINT32 triangle       = (bs::UINT32)best;
+      const bs::UINT32* corners = indices + triangle * 3;
+
+      isDrawn[triangle] = true;
+      order.push_back(triangle);
+
+      newCache.clear();
+
+      for (bs::UINT32 k = 0; k < 3; k++)
+      {
+        bs::UINT32 v = corners[k];
+
+        // Move the triangle behind the still open ones of the vertex
+        bs::UINT32* open = trianglesOfVertex.data() + firstTriangle[v];
+        bs::UINT32 last  = numOpenTriangles[v] - 1;
+
+        for (bs::UINT32 i = 0; i < last; i++)
+        {
+          if (open[i] == triangle)
+          {
+            std::swap(open[i], open[last]);
+            break;
+          }
+        }
+
+        numOpenTriangles[v] -= 1;
+
+        // Degenerated triangles use a vertex more than once
+        if (std::find(newCache.begin(), newCache.end(), v) == newCache.end())
+        {
+          newCache.push_back(v);
+        }
+      }
+
+      for (bs::UINT32 v : cache)
+      {
+        if (v != corners[0] && v != corners[1] && v != corners[2])
+        {
+          newCache.push_back(v);
+        }
+      }
+
+      std::swap(cache, newCache);
+
+      // Vertices pushed out of the cache are updated one last time, their triangles lose the
+      // bonus of being cached
+      for (bs::UINT32 i = 0; i < (bs::UINT32)cache.size(); i++)
+      {
+        bs::UINT32 v = cache[i];
+
+        cachePositions[v] = i < MESH_OPTIMIZATION_VERTEX_CACHE_SIZE ? (bs::INT32)i : -1;
+        vertexScores[v]   = vertexScore(cachePositions[v], numOpenTriangles[v]);
+      }
+
+      best            = -1;
+      float bestScore = -1.0f;
+
+      for (bs::UINT32 v : cache)
+      {
+        const bs::UINT32* open = trianglesOfVertex.data() + firstTriangle[v];
+
+        for (bs::UINT32 i = 0; i < numOpenTriangles[v]; i++)
+        {
+          bs::UINT32 t           = open[i];
+          const bs::UINT32* tris = indices + t * 3;
+
+          triangleScores[t] =
+              vertexScores[tris[0]] + vertexScores[tris[1]] + vertexScores[tris[2]];
+
+          if (triangleScores[t] > bestScore)
+          {
+            best      = t;
+            bestScore = triangleScores[t];
+          }
+        }
+      }
+
+      if (cache.size() > MESH_OPTIMIZATION_VERTEX_CACHE_SIZE)
+      {
+        cache.resize(MESH_OPTIMIZATION_VERTEX_CACHE_SIZE);
+      }
+    }
+
+    bs::Vector<bs::UINT32> reordered(indices, indices + numTriangles * 3);
+
+    for (bs::UINT32 t = 0; t < numTriangles; t++)
+    {
+      for (bs::UINT32 k = 0; k < 3; k++)
+      {
+        indices[t * 3 + k] = reordered[order[t] * 3 + k];
+      }
+    }
+
+    return order;
+  }
+
+  bs::Vector<bs::UINT32> remapVerticesByFirstUse(bs::UINT32* indices, bs::UINT32 numIndices,
+                                                 bs::UINT32 numVertices)
+  {
+    constexpr bs::UINT32 NOT_MAPPED = 0xFFFFFFFF;
+
+    bs::Vector<bs::UINT32> newIndexOf(numVertices, NOT_MAPPED);
+    bs::Vector<bs::UINT32> origins;
+    origins.reserve(numVertices);
+
+    for (bs::UINT32 i = 0; i < numIndices; i++)
+    {
+      bs::UINT32& index = indices[i];
+
+      if (newIndexOf[index] == NOT_MAPPED)
+      {
+        newIndexOf[index] = (bs::UINT32)origins.size();
+        origins.push_back(index);
+      }
+
+      index = newIndexOf[index];
+    }
+
+    for (bs::UINT32 v = 0; v < numVertices; v++)
+    {
+      if (newIndexOf[v] == NOT_MAPPED)
+      {
+        origins.push_back(v);
+      }
+    }
+
+    return origins;
+  }
+}  // namespace REGoth
@@ -0,0 +1,46 @@
+#pragma once
+#include <BsPrerequisites.h>
+
+namespace REGoth
+{
+  /**
+   * Number of vertices the post-transform cache of the GPU is assumed to hold, see
+   * optimizeTriangleOrder(). Actual caches differ between GPUs, the order found works well
+   * for any size close to this.
+   */
+  constexpr bs::UINT32 MESH_OPTIMIZATION_VERTEX_CACHE_SIZE = 32;
+
+  /**
+   * Reorders the triangles of the given triangle list, so that consecutive triangles share
+   * as many vertices as possible and the GPU can reuse them from its post-transform cache
+   * instead of running the vertex shader again. Uses the linear-speed vertex cache
+   * optimization by Tom Forsyth.
+   *
+   * Meshes of the original game come in whatever order the modeling tool wrote them in,
+   * which usually is far from that.
+   *
+   * @param  indices      Indices of the triangles, three per triangle. Reordered in place.
+   * @param  numIndices   Number of indices, a multiple of three.
+   * @param  numVertices  Number of vertices the indices refer to.
+   *
+   * @return For each triangle in the new order, which triangle it was before. Data stored per
+   *         triangle has to be reordered along with it.
+   */
+  bs::Vector<bs::UINT32> optimizeTriangleOrder(bs::UINT32* indices, bs::UINT32 numIndices,
+                                               bs::UINT32 numVertices);
+
+  /**
+   * Numbers the vertices in the order they are first used by the given indices, so the GPU
+   * reads the vertex buffer mostly front to back. Best done after optimizeTriangleOrder().
+   * Vertices not used at all are moved to the end.
+   *
+   * @param  indices      Indices to remap. Changed in place to refer to the new numbers.
+   * @param  numIndices   Number of indices.
+   * @param  numVertices  Number of vertices the indices refer to.
+   *
+   * @return For each vertex in the new order, which vertex it was before. The vertex data has
+   *         to be reordered like that.
+   */
+  bs::Vector<bs::UINT32> remapVerticesByFirstUse(bs::UINT32* indices, bs::UINT32 numIndices,
+                                                 bs::UINT32 numVertices);
+}  // namespace REGoth
@@ -1,78 +1,208 @@
 #include "OriginalGameResources.hpp"
+#include <algorithm>
+#include <BsZenLib/ImportPath.hpp>
 #include <BsZenLib/ImportFont.hpp>
 #include <BsZenLib/ImportMorphMesh.hpp>
 #include <BsZenLib/ImportSkeletalMesh.hpp>
 #include <BsZenLib/ImportStaticMesh.hpp>
 #include <BsZenLib/ImportTexture.hpp>
+#include <BsZenLib/ZenResources.hpp>
+#include <FileSystem/BsFileSystem.h>
 #include <Image/BsSpriteTexture.h>
 #include <log/logging.hpp>
+#include <original-content/StaticMeshLOD.hpp>
 #include <original-content/VirtualFileSystem.hpp>
 
 namespace REGoth
 {
-  bs::HTexture OriginalGameResources::texture(const bs::String& originalFileName)
+  /**
+   * @return The given file name in UPPERCASE, which resources are remembered by.
+   */
+  static bs::String normalizedName(const bs::String& originalFileName)
   {
-    if (BsZenLib::HasCachedTexture(originalFileName))
-    {
-      return BsZenLib::LoadCachedTexture(originalFileName);
-    }
-    else
+    bs::String name = originalFileName;
+    bs::StringUtil::toUpperCase(name);
+
+    return name;
+  }
+
+  template <typename Handle, typename LoadFn>
+  Handle OriginalGameResources::findOrLoad(LoadedResources<Handle>& loaded,
+                                           const bs::String& originalFileName, LoadFn load)
+  {
+    bs::String name = normalizedName(originalFileName);
+
     {
-      return BsZenLib::ImportAndCacheTexture(originalFileName, gVirtualFileSystem().getFileIndex());
+      bs::Lock lock(mLoadedMutex);
+
+      auto it = loaded.find(name);
+
+      if (it != loaded.end())
+      {
+        it->second.numUses += 1;
+        return it->second.handle;
+      }
     }
+
+    // Not holding the lock, so other resources can be looked up while this one loads
+    Handle handle = load(name);
+
+    bs::Lock lock(mLoadedMutex);
+
+    // Some other thread might have loaded the same resource meanwhile, keep the first one
+    LoadedResource<Handle>& resource = loaded.emplace(name, LoadedResource<Handle>{handle, 0})
+                                           .first->second;
+    resource.numUses += 1;
+
+    return resource.handle;
+  }
+
+  /**
+   * How to get one kind of resource. Loading it from the cache only reads its file, so that can
+   * be done on any thread. Importing saves the resource and registers it in the manifest of the
+   * cache, which must only be done on the main thread.
+   */
+  template <typename Handle>
+  struct OriginalGameResourceLoader
+  {
+    bool (*isCached)(const bs::String& name);
+    Handle (*loadCached)(const bs::String& name);
+    Handle (*importAndCache)(const bs::String& name);
+  };
+
+  static const OriginalGameResourceLoader<bs::HTexture> s_TextureLoader = {
+      [](const bs::String& name) { return BsZenLib::HasCachedTexture(name); },
+      [](const bs::String& name) -> bs::HTexture { return BsZenLib::LoadCachedTexture(name); },
+      [](const bs::String& name) -> bs::HTexture {
+        return BsZenLib::ImportAndCacheTexture(name, gVirtualFileSystem().getFileIndex());
+      },
+  };
+
+  static const OriginalGameResourceLoader<BsZenLib::Res::HModelScriptFile>
+      s_ModelScriptLoader = {
+          [](const bs::String& name) { return BsZenLib::HasCachedMDS(name); },
+          [](const bs::String& name) -> BsZenLib::Res::HModelScriptFile {
+            return BsZenLib::LoadCachedMDS(name);
+          },
+          [](const bs::String& name) -> BsZenLib::Res::HModelScriptFile {
+            return BsZenLib::ImportAndCacheMDS(name, gVirtualFileSystem().getFileIndex());
+          },
+      };
+
+  static const OriginalGameResourceLoader<BsZenLib::Res::HMeshWithMaterials>
+      s_StaticMeshLoader = {
+          [](const bs::String& name) { return BsZenLib::HasCachedStaticMesh(name); },
+          [](const bs::String& name) -> BsZenLib::Res::HMeshWithMaterials {
+            return BsZenLib::LoadCachedStaticMesh(name);
+          },
+          [](const bs::String& name) -> BsZenLib::Res::HMeshWithMaterials {
+            return BsZenLib::ImportAndCacheStaticMesh(name, gVirtualFileSystem().getFileIndex());
+          },
+      };
+
+  static const OriginalGameResourceLoader<BsZenLib::Res::HMeshWithMaterials>
+      s_MorphMeshLoader = {
+          [](const bs::String& name) { return BsZenLib::HasCachedMorphMesh(name); },
+          [](const bs::String& name) -> BsZenLib::Res::HMeshWithMaterials {
+            return BsZenLib::LoadCachedMorphMesh(name);
+          },
+          [](const bs::String& name) -> BsZenLib::Res::HMeshWithMaterials {
+            return BsZenLib::ImportAndCacheMorphMesh(name, gVirtualFileSystem().getFileIndex());
+          },
+      };
+
+  static const OriginalGameResourceLoader<bs::HFont> s_FontLoader = {
+      [](const bs::String& name) { return BsZenLib::HasCachedFont(name); },
+      [](const bs::String& name) -> bs::HFont { return BsZenLib::LoadCachedFont(name); },
+      [](const bs::String& name) -> bs::HFont {
+        return BsZenLib::ImportAndCacheFont(name, gVirtualFileSystem().getFileIndex());
+      },
+  };
+
+  template <typename Handle>
+  Handle OriginalGameResources::loadOrImport(LoadedResources<Handle>& loaded,
+                                             const bs::String& originalFileName,
+                                             const OriginalGameResourceLoader<Handle>& loader)
+  {
+    return findOrLoad(loaded, originalFileName, [&loader](const bs::String& name) {
+      if (loader.isCached(name))
+      {
+        return loader.loadCached(name);
+      }
+      else
+      {
+        return loader.importAndCache(name);
+      }
+    });
+  }
+
+  bs::HTexture OriginalGameResources::texture(const bs::String& originalFileName)
+  {
+    return loadOrImport(mTextures, originalFileName, s_TextureLoader);
   }
 
   BsZenLib::Res::HModelScriptFile OriginalGameResources::modelScript(
       const bs::String& originalFileName)
   {
-    if (BsZenLib::HasCachedMDS(originalFileName))
-    {
-      return BsZenLib::LoadCachedMDS(originalFileName);
-    }
-    else
-    {
-      return BsZenLib::ImportAndCacheMDS(originalFileName, gVirtualFileSystem().getFileIndex());
-    }
+    return loadOrImport(mModelScripts, originalFileName, s_ModelScriptLoader);
   }
 
   BsZenLib::Res::HMeshWithMaterials OriginalGameResources::staticMesh(
       const bs::String& originalFileName)
   {
-    if (BsZenLib::HasCachedStaticMesh(originalFileName))
-    {
-      return BsZenLib::LoadCachedStaticMesh(originalFileName);
-    }
-    else
+    return loadOrImport(mStaticMeshes, originalFileName, s_StaticMeshLoader);
+  }
+
+  bs::Vector<bs::HMesh> OriginalGameResources::staticMeshLODs(const bs::String& originalFileName)
+  {
+    bs::String name = normalizedName(originalFileName);
+
+    auto it = mStaticMeshLODs.find(name);
+
+    if (it != mStaticMeshLODs.end()) return it->second;
+
+    bs::Vector<bs::HMesh> lods;
+
+    BsZenLib::Res::HMeshWithMaterials mesh = staticMesh(name);
+
+    if (mesh && mesh->getMesh())
     {
-      return BsZenLib::ImportAndCacheStaticMesh(originalFileName,
-                                                gVirtualFileSystem().getFileIndex());
+      lods = loadOrCreateStaticMeshLODs(name, mesh->getMesh());
     }
+
+    return mStaticMeshLODs[name] = lods;
   }
 
-  BsZenLib::Res::HMeshWithMaterials OriginalGameResources::morphMesh(
-      const bs::String& originalFileName)
+  void OriginalGameResources::removeCachedStaticMesh(const bs::String& originalFileName)
   {
-    if (BsZenLib::HasCachedMorphMesh(originalFileName))
+    bs::String name = normalizedName(originalFileName);
+
+    mStaticMeshLODs.erase(name);
+
     {
-      return BsZenLib::LoadCachedMorphMesh(originalFileName);
+      bs::Lock lock(mLoadedMutex);
+      mStaticMeshes.erase(name);
     }
-    else
+
+    removeCachedStaticMeshLODs(name);
+
+    bs::Path path = BsZenLib::GothicPathToCachedStaticMesh(name);
+
+    if (bs::FileSystem::exists(path))
     {
-      return BsZenLib::ImportAndCacheMorphMesh(originalFileName,
-                                               gVirtualFileSystem().getFileIndex());
+      bs::FileSystem::remove(path);
     }
   }
 
+  BsZenLib::Res::HMeshWithMaterials OriginalGameResources::morphMesh(
+      const bs::String& originalFileName)
+  {
+    return loadOrImport(mMorphMeshes, originalFileName, s_MorphMeshLoader);
+  }
+
   bs::HFont OriginalGameResources::font(const bs::String& originalFileName)
   {
-    if (BsZenLib::HasCachedFont(originalFileName))
-    {
-      return BsZenLib::LoadCachedFont(originalFileName);
-    }
-    else
-    {
-      return BsZenLib::ImportAndCacheFont(originalFileName, gVirtualFileSystem().getFileIndex());
-    }
+    return loadOrImport(mFonts, originalFileName, s_FontLoader);
   }
 
   bs::HSpriteTexture OriginalGameResources::sprite(const bs::String& originalFileName)
@@ -90,6 +220,202 @@ namespace REGoth
     return bs::SpriteTexture::create(t);
   }
 
+  template <typename Handle>
+  PendingResource<Handle> OriginalGameResources::loadAsync(
+      PendingResources<Handle>& pending, LoadedResources<Handle>& loaded,
+      const bs::String& originalFileName, const OriginalGameResourceLoader<Handle>& loader)
+  {
+    using State = typename PendingResource<Handle>::State;
+
+    bs::String name = normalizedName(originalFileName);
+
+    PendingResource<Handle> resource;
+    resource.mState = bs::bs_shared_ptr_new<State>();
+
+    // Loaded before? Nothing to wait for then.
+    {
+      bs::Lock lock(mLoadedMutex);
+
+      auto it = loaded.find(name);
+
+      if (it != loaded.end())
+      {
+        it->second.numUses += 1;
+
+        resource.mState->handle = it->second.handle;
+        resource.mState->isDone.store(true, std::memory_order_release);
+
+        return resource;
+      }
+    }
+
+    auto it = pending.find(name);
+
+    if (it != pending.end() && !it->second.isReady()) return it->second;
+
+    // Whatever has finished is among the loaded resources by now
+    for (auto p = pending.begin(); p != pending.end();)
+    {
+      if (p->second.isReady())
+      {
+        p = pending.erase(p);
+      }
+      else
+      {
+        ++p;
+      }
+    }
+
+    // The state owns the task, so the task must not own the state. If the resource has been
+    // forgotten about by the time it would be loaded, like on shutdown, loading it is skipped.
+    bs::WPtr<State> weakState = resource.mState;
+
+    // Importing saves the resource and registers it in the manifest, not safe on a worker
+
+    if (!loader.isCached(name))
+    {
+      mQueuedImports.push_back([this, weakState, &loaded, &loader, name]() {
+        bs::SPtr<State> state = weakState.lock();
+
+        if (!state) return;
+
+        state->handle = loadOrImport(loaded, name, loader);
+
+        if (!state->handle)
+        {
+          REGOTH_LOG(Warning, Uncategorized, "[OriginalGameResources] Failed to import: {0}",
+                     name);
+        }
+
+        state->isDone.store(true, std::memory_order_release);
+      });
+
+      return pending[name] = resource;
+    }
+
+    auto loadCached = loader.loadCached;
+
+    resource.mState->task = bs::Task::create(
+        "LoadOriginalGameResource", [this, weakState, &loaded, loadCached, name]() {
+          bs::SPtr<State> state = weakState.lock();
+
+          if (!state) return;
+
+          state->handle = findOrLoad(loaded, name, loadCached);
+
+          if (!state->handle)
+          {
+            REGOTH_LOG(Warning, Uncategorized,
+                       "[OriginalGameResources] Failed to load in background: {0}", name);
+          }
+
+          state->isDone.store(true, std::memory_order_release);
+        });
+
+    bs::TaskScheduler::instance().addTask(resource.mState->task);
+
+    return pending[name] = resource;
+  }
+
+  PendingResource<bs::HTexture> OriginalGameResources::textureAsync(
+      const bs::String& originalFileName)
+  {
+    return loadAsync<bs::HTexture>(mPendingTextures, mTextures, originalFileName,
+                                   s_TextureLoader);
+  }
+
+  PendingResource<BsZenLib::Res::HModelScriptFile> OriginalGameResources::modelScriptAsync(
+      const bs::String& originalFileName)
+  {
+    return loadAsync<BsZenLib::Res::HModelScriptFile>(
+        mPendingModelScripts, mModelScripts, originalFileName, s_ModelScriptLoader);
+  }
+
+  PendingResource<BsZenLib::Res::HMeshWithMaterials> OriginalGameResources::staticMeshAsync(
+      const bs::String& originalFileName)
+  {
+    return loadAsync<BsZenLib::Res::HMeshWithMaterials>(
+        mPendingStaticMeshes, mStaticMeshes, originalFileName, s_StaticMeshLoader);
+  }
+
+  PendingResource<BsZenLib::Res::HMeshWithMaterials> OriginalGameResources::morphMeshAsync(
+      const bs::String& originalFileName)
+  {
+    return loadAsync<BsZenLib::Res::HMeshWithMaterials>(
+        mPendingMorphMeshes, mMorphMeshes, originalFileName, s_MorphMeshLoader);
+  }
+
+  PendingResource<bs::HFont> OriginalGameResources::fontAsync(const bs::String& originalFileName)
+  {
+    return loadAsync<bs::HFont>(mPendingFonts, mFonts, originalFileName, s_FontLoader);
+  }
+
+  void OriginalGameResources::finishQueuedImports()
+  {
+    // Importing might queue more, e.g. the textures of a mesh
+    bs::Vector<std::function<void()>> imports;
+    imports.swap(mQueuedImports);
+
+    for (const auto& import : imports)
+    {
+      import();
+    }
+  }
+
+  void OriginalGameResources::forgetLoadedResources()
+  {
+    bs::Lock lock(mLoadedMutex);
+
+    mTextures.clear();
+    mModelScripts.clear();
+    mStaticMeshes.clear();
+    mMorphMeshes.clear();
+    mFonts.clear();
+
+    mStaticMeshLODs.clear();
+  }
+
+  /**
+   * Logs the given number of the most used resources of one kind.
+   */
+  template <typename Map>
+  static void logMostUsed(const char* kind, const Map& loaded, bs::UINT32 count)
+  {
+    bs::Vector<std::pair<bs::UINT32, bs::String>> uses;
+    uses.reserve(loaded.size());
+
+    for (const auto& entry : loaded)
+    {
+      uses.emplace_back(entry.second.numUses, entry.first);
+    }
+
+    count = std::min(count, (bs::UINT32)uses.size());
+
+    std::partial_sort(uses.begin(), uses.begin() + count, uses.end(),
+                      [](const std::pair<bs::UINT32, bs::String>& a,
+                         const std::pair<bs::UINT32, bs::String>& b) { return a.first > b.first; });
+
+    REGOTH_LOG(Info, Uncategorized, "[OriginalGameResources] {0}: {1} loaded", kind,
+               loaded.size());
+
+    for (bs::UINT32 i = 0; i < count; i++)
+    {
+      REGOTH_LOG(Info, Uncategorized, "[OriginalGameResources]   {0}: {1} uses", uses[i].second,
+                 uses[i].first);
+    }
+  }
+
+  void OriginalGameResources::logMostUsedResources(bs::UINT32 count) const
+  {
+    bs::Lock lock(mLoadedMutex);
+
+    logMostUsed("Textures", mTextures, count);
+    logMostUsed("Model Scripts", mModelScripts, count);
+    logMostUsed("Static Meshes", mStaticMeshes, count);
+    logMostUsed("Morph Meshes", mMorphMeshes, count);
+    logMostUsed("Fonts", mFonts, count);
+  }
+
   OriginalGameResources& gOriginalGameResources()
   {
     static OriginalGameResources s_instance;
@@ -1,5 +1,8 @@
 #pragma once
+#include <atomic>
+#include <functional>
 #include <BsPrerequisites.h>
+#include <Threading/BsTaskScheduler.h>
 
 namespace BsZenLib
 {
@@ -15,6 +18,68 @@ namespace BsZenLib
 
 namespace REGoth
 {
+  template <typename Handle>
+  struct OriginalGameResourceLoader;
+
+  /**
+   * Resource being loaded in the background, see OriginalGameResources::textureAsync() and
+   * its siblings. Check isReady() once per frame and pick up the resource with get() once
+   * it is.
+   */
+  template <typename Handle>
+  class PendingResource
+  {
+  public:
+    PendingResource() = default;
+
+    /**
+     * @return Whether a resource has been requested at all.
+     */
+    bool isRequested() const
+    {
+      return mState != nullptr;
+    }
+
+    /**
+     * @return Whether loading has finished, successfully or not. Also true if nothing has been
+     *         requested.
+     */
+    bool isReady() const
+    {
+      return !mState || mState->isDone.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @return The loaded resource. Empty if loading failed or hasn't finished yet.
+     */
+    Handle get() const
+    {
+      if (!mState || !isReady()) return {};
+
+      return mState->handle;
+    }
+
+    /**
+     * Blocks until loading has finished. Must be called from the main thread, since resources
+     * which have not been cached yet are imported there.
+     *
+     * @return The loaded resource. Empty if loading failed.
+     */
+    Handle wait() const;
+
+  private:
+    friend class OriginalGameResources;
+
+    struct State
+    {
+      std::atomic<bool> isDone{false};
+      Handle handle;
+      bs::SPtr<bs::Task> task;
+    };
+
+    bs::SPtr<State> mState;
+  };
+
   /**
    * This provides a global object to load resources from the original game.
    *
@@ -29,6 +94,16 @@ namespace REGoth
    * To make loading more efficient, a check whether the resource to load has been
    * cached is done. If it was not, the resource is imported into the cache so it
    * can be loaded quicker next time.
+   *
+   * Loading can also be done in the background, see textureAsync() and its siblings. Those
+   * are meant for resources needed in the middle of the game, where doing it right away would
+   * make the game hitch. Importing a resource saves it and registers it in the manifest of the
+   * cache, which the resource system doesn't allow from other threads. So resources which have
+   * not been cached yet are imported later on the main thread, see finishQueuedImports().
+   *
+   * Everything loaded is remembered by its file name, regardless of upper or lower case, so
+   * asking for the same resource again only costs a lookup. How often each resource has been
+   * asked for is counted, see logMostUsedResources().
    */
   class OriginalGameResources
   {
@@ -70,6 +145,28 @@ namespace REGoth
      */
     BsZenLib::Res::HMeshWithMaterials staticMesh(const bs::String& originalFileName);
 
+    /**
+     * Loads the less detailed versions of a Static Mesh (3DS) from the original game files.
+     *
+     * If they have not been generated before, they are generated and cached, see
+     * loadOrCreateStaticMeshLODs(). Whatever was found is remembered, so asking again for
+     * the same mesh is cheap.
+     *
+     * @param  originalFileName  File name as in the original game, e.g. `STONE.3DS`.
+     *
+     * @return Less detailed versions of the mesh, each coarser than the one before. Empty if
+     *         the mesh is not worth simplifying or failed to load.
+     */
+    bs::Vector<bs::HMesh> staticMeshLODs(const bs::String& originalFileName);
+
+    /**
+     * Removes a Static Mesh (3DS) and its less detailed versions from the cache, so they are
+     * imported from the original game files again next time. Meant for when those changed.
+     *
+     * @param  originalFileName  File name as in the original game, e.g. `STONE.3DS`.
+     */
+    void removeCachedStaticMesh(const bs::String& originalFileName);
+
     /**
      * Loads a MorphMesh (MMS/MMB) from the original game files.
      *
@@ -102,10 +199,171 @@ namespace REGoth
      * @return Sprite with the given texture. Empty handle if loading failed.
      */
     bs::HSpriteTexture sprite(const bs::String& originalFileName);
+
+    /**
+     * Like texture(), but loads the texture on a background thread. If it has not been cached
+     * yet, it is imported by the next call to finishQueuedImports() instead.
+     *
+     * Requesting a resource again while it is still being loaded gives the same pending
+     * resource, so it is never imported twice at the same time. Don't load it through the
+     * synchronous functions meanwhile, though.
+     *
+     * @note   Must be called from the main thread.
+     *
+     * @param  originalFileName  File name as in the original game, e.g. `STONE.TGA`.
+     */
+    PendingResource<bs::HTexture> textureAsync(const bs::String& originalFileName);
+
+    /**
+     * Like modelScript(), but loads the model script on a background thread, see
+     * textureAsync().
+     */
+    PendingResource<BsZenLib::Res::HModelScriptFile> modelScriptAsync(
+        const bs::String& originalFileName);
+
+    /**
+     * Like staticMesh(), but loads the mesh on a background thread, see textureAsync().
+     */
+    PendingResource<BsZenLib::Res::HMeshWithMaterials> staticMeshAsync(
+        const bs::String& originalFileName);
+
+    /**
+     * Like morphMesh(), but loads the mesh on a background thread, see textureAsync().
+     */
+    PendingResource<BsZenLib::Res::HMeshWithMaterials> morphMeshAsync(
+        const bs::String& originalFileName);
+
+    /**
+     * Like font(), but loads the font on a background thread, see textureAsync().
+     */
+    PendingResource<bs::HFont> fontAsync(const bs::String& originalFileName);
+
+    /**
+     * Imports the resources requested via textureAsync() and its siblings which had not been
+     * cached yet. To be called once per frame from the main thread.
+     */
+    void finishQueuedImports();
+
+    /**
+     * Forgets about all resources loaded so far, so bsf can unload those not used anymore.
+     * Meant for when a different world is loaded.
+     *
+     * @note   Must not be called while resources are loaded in the background.
+     */
+    void forgetLoadedResources();
+
+    /**
+     * Logs the given number of resources of each kind which have been asked for the most.
+     */
+    void logMostUsedResources(bs::UINT32 count) const;
+
+  private:
+    /**
+     * A resource remembered after loading it, see findOrLoad().
+     */
+    template <typename Handle>
+    struct LoadedResource
+    {
+      /** Empty if loading failed */
+      Handle handle;
+
+      /** How often the resource was asked for */
+      bs::UINT32 numUses = 0;
+    };
+
+    /**
+     * Loaded resources by file name in UPPERCASE.
+     */
+    template <typename Handle>
+    using LoadedResources = bs::UnorderedMap<bs::String, LoadedResource<Handle>>;
+
+    template <typename Handle>
+    using PendingResources = bs::UnorderedMap<bs::String, PendingResource<Handle>>;
+
+    /**
+     * Looks up a resource loaded before, or loads it with the given function and remembers it.
+     * Can be called from any thread.
+     *
+     * @param  loaded  Resources loaded so far.
+     * @param  load    Loads or imports the resource, given its name in UPPERCASE.
+     */
+    template <typename Handle, typename LoadFn>
+    Handle findOrLoad(LoadedResources<Handle>& loaded, const bs::String& originalFileName,
+                      LoadFn load);
+
+    /**
+     * Loads a resource via findOrLoad(), importing it if it has not been cached yet.
+     * Must be called from the main thread.
+     */
+    template <typename Handle>
+    Handle loadOrImport(LoadedResources<Handle>& loaded, const bs::String& originalFileName,
+                        const OriginalGameResourceLoader<Handle>& loader);
+
+    /**
+     * Starts a task loading a resource from the cache, unless it has been loaded already or is
+     * still being loaded. Resources which have not been cached yet are queued for
+     * finishQueuedImports() instead.
+     *
+     * @param  pending  Resources being loaded right now. Finished ones are removed from here.
+     * @param  loaded   Resources loaded so far.
+     * @param  loader   How to load or import the resource.
+     */
+    template <typename Handle>
+    PendingResource<Handle> loadAsync(PendingResources<Handle>& pending,
+                                      LoadedResources<Handle>& loaded,
+                                      const bs::String& originalFileName,
+                                      const OriginalGameResourceLoader<Handle>& loader);
+
+    /**
+     * Resources loaded so far. Guarded by mLoadedMutex, since background tasks add to them.
+     */
+    LoadedResources<bs::HTexture> mTextures;
+    LoadedResources<BsZenLib::Res::HModelScriptFile> mModelScripts;
+    LoadedResources<BsZenLib::Res::HMeshWithMaterials> mStaticMeshes;
+    LoadedResources<BsZenLib::Res::HMeshWithMaterials> mMorphMeshes;
+    LoadedResources<bs::HFont> mFonts;
+    mutable bs::Mutex mLoadedMutex;
+
+    /**
+     * Resources being loaded in the background, by file name.
+     */
+    PendingResources<bs::HTexture> mPendingTextures;
+    PendingResources<BsZenLib::Res::HModelScriptFile> mPendingModelScripts;
+    PendingResources<BsZenLib::Res::HMeshWithMaterials> mPendingStaticMeshes;
+    PendingResources<BsZenLib::Res::HMeshWithMaterials> mPendingMorphMeshes;
+    PendingResources<bs::HFont> mPendingFonts;
+
+    /**
+     * Imports waiting for finishQueuedImports(), see loadAsync().
+     */
+    bs::Vector<std::function<void()>> mQueuedImports;
+
+    /**
+     * Results of staticMeshLODs() by file name in UPPERCASE.
+     */
+    bs::UnorderedMap<bs::String, bs::Vector<bs::HMesh>> mStaticMeshLODs;
   };
 
   /**
    * Global access to the virtual file system.
    */
   OriginalGameResources& gOriginalGameResources();
+
+  template <typename Handle>
+  Handle PendingResource<Handle>::wait() const
+  {
+    if (!mState) return {};
+
+    // Resources which had been loaded already come without a task, as do those to be imported
+    if (mState->task)
+    {
+      mState->task->wait();
+    }
+    else if (!isReady())
+    {
+      gOriginalGameResources().finishQueuedImports();
+    }
+
+    return get();
+  }
 }
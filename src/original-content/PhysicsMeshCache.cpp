@@ -0,0 +1,177 @@
+#include "PhysicsMeshCache.hpp"
+#include "ResourceManifestJournal.hpp"
+#include <BsZenLib/ImportPath.hpp>
+#include <FileSystem/BsFileSystem.h>
+#include <Mesh/BsMesh.h>
+#include <Physics/BsPhysicsMesh.h>
+#include <Resources/BsResources.h>
+#include <Threading/BsTaskScheduler.h>
+#include <core/Jobs.hpp>
+#include <log/logging.hpp>
+
+namespace REGoth
+{
+  /**
+   * A physics mesh to be cooked on a worker thread.
+   */
+  struct CookingJob
+  {
+    bs::String name;
+    bs::Path path;
+    bs::SPtr<bs::MeshData> meshData;
+    bs::PhysicsMeshType type;
+
+    /** Set by the worker */
+    bs::SPtr<bs::PhysicsMesh> cooked;
+
+    bs::SPtr<bs::Task> task;
+  };
+
+  static bs::Path physicsMeshPath(const bs::String& name)
+  {
+    return BsZenLib::GothicPathToCachedStaticMesh(name + ".physics");
+  }
+
+  void PhysicsMeshCache::request(const bs::String& name, const bs::HMesh& mesh,
+                                 bs::PhysicsMeshType type)
+  {
+    if (mPhysicsMeshes.find(name) != mPhysicsMeshes.end())
+    {
+      mStats.numHits += 1;
+      return;
+    }
+
+    for (const Request& request : mRequests)
+    {
+      if (request.name == name)
+      {
+        mStats.numHits += 1;
+        return;
+      }
+    }
+
+    mRequests.push_back({name, mesh, type});
+  }
+
+  void PhysicsMeshCache::finishRequests()
+  {
+    if (mRequests.empty()) return;
+
+    bs::Vector<bs::SPtr<CookingJob>> jobs;
+
+    // Get all cached ones loading first, they don't need anything from this thread
+    for (const Request& request : mRequests)
+    {
+      bs::Path path = physicsMeshPath(request.name);
+
+      if (bs::FileSystem::exists(path))
+      {
+        mPhysicsMeshes[request.name] = bs::gResources().loadAsync<bs::PhysicsMesh>(path);
+        mStats.numLoaded += 1;
+        continue;
+      }
+
+      bs::SPtr<bs::MeshData> meshData = request.mesh ? request.mesh->getCachedData() : nullptr;
+
+      if (!meshData)
+      {
+        REGOTH_LOG(Warning, Uncategorized,
+                   "[PhysicsMeshCache] Cannot create physics mesh for {0}, no mesh data available!",
+                   request.name);
+        continue;
+      }
+
+      auto job      = bs::bs_shared_ptr_new<CookingJob>();
+      job->name     = request.name;
+      job->path     = path;
+      job->meshData = meshData;
+      job->type     = request.type;
+
+      jobs.push_back(job);
+    }
+
+    mRequests.clear();
+
+    if (!jobs.empty())
+    {
+      REGOTH_LOG(Info, Uncategorized, "[PhysicsMeshCache] Cooking {0} physics meshes",
+                 jobs.size());
+    }
+
+    // Cooking only reads the mesh data and doesn't touch the resource system, so many of them
+    // can run at once
+    Jobs::JobGroup group("CookPhysicsMesh");
+
+    for (auto& job : jobs)
+    {
+      CookingJob* j = job.get();
+
+      job->task =
+          group.run([j]() { j->cooked = bs::PhysicsMesh::_createPtr(j->meshData, j->type); });
+    }
+
+    enum
+    {
+      Overwrite    = true,
+      KeepExisting = false,
+    };
+
+    for (auto& job : jobs)
+    {
+      job->task->wait();
+
+      if (!job->cooked) continue;
+
+      bs::HPhysicsMesh physicsMesh = bs::static_resource_cast<bs::PhysicsMesh>(
+          bs::gResources()._createResourceHandle(job->cooked));
+
+      addToGothicCacheManifest(physicsMesh, job->path);
+      bs::gResources().save(physicsMesh, job->path, Overwrite);
+
+      mPhysicsMeshes[job->name] = physicsMesh;
+      mStats.numCooked += 1;
+    }
+
+    for (auto& p : mPhysicsMeshes)
+    {
+      p.second.blockUntilLoaded();
+    }
+  }
+
+  bs::HPhysicsMesh PhysicsMeshCache::get(const bs::String& name) const
+  {
+    auto it = mPhysicsMeshes.find(name);
+
+    if (it == mPhysicsMeshes.end()) return {};
+
+    return it->second;
+  }
+
+  bs::HPhysicsMesh PhysicsMeshCache::loadOrCreate(const bs::String& name, const bs::HMesh& mesh,
+                                                  bs::PhysicsMeshType type)
+  {
+    request(name, mesh, type);
+    finishRequests();
+
+    return get(name);
+  }
+
+  void PhysicsMeshCache::remove(const bs::String& name)
+  {
+    mPhysicsMeshes.erase(name);
+
+    bs::Path path = physicsMeshPath(name);
+
+    if (bs::FileSystem::exists(path))
+    {
+      bs::FileSystem::remove(path);
+    }
+  }
+
+  PhysicsMeshCache& gPhysicsMeshCache()
+  {
+    static PhysicsMeshCache s_instance;
+
+    return s_instance;
+  }
+}  // namespace REGoth
@@ -0,0 +1,106 @@
+#pragma once
+#include <BsPrerequisites.h>
+#include <Physics/BsPhysicsCommon.h>
+
+namespace REGoth
+{
+  /**
+   * Provides the triangle physics meshes made from render meshes, one per mesh.
+   *
+   * Every vob showing the same mesh shares the same physics mesh resource handle instead
+   * of loading or creating its own. Physics meshes are cached on disk like the original
+   * game resources, see BsZenLib::GothicPathToCachedStaticMesh().
+   *
+   * Creating a physics mesh means cooking it with PhysX, which takes a while. To not do that
+   * for one mesh after the other, request() all physics meshes needed first and then let
+   * finishRequests() load the cached ones in the background and cook the missing ones on the
+   * task scheduler's worker threads. Creating the resource handles and saving them to disk
+   * is then done on the calling thread.
+   */
+  class PhysicsMeshCache
+  {
+  public:
+    /**
+     * How the physics meshes asked for have been found so far.
+     */
+    struct Stats
+    {
+      /** Already known when requested */
+      bs::UINT64 numHits = 0;
+
+      /** Loaded from the disk cache */
+      bs::UINT64 numLoaded = 0;
+
+      /** Not cached anywhere, so they had to be cooked */
+      bs::UINT64 numCooked = 0;
+    };
+
+    /**
+     * Queues the physics mesh for the given mesh, if it isn't known already. The mesh must
+     * have CPU-caching enabled, so its data is available.
+     *
+     * @param  name  Name to remember and cache the physics mesh under, e.g. the mesh's name.
+     *               Physics meshes of different types made from the same mesh need different
+     *               names.
+     * @param  mesh  Mesh to make the physics mesh from.
+     * @param  type  Whether to collide with the triangles or the convex hull of the mesh.
+     */
+    void request(const bs::String& name, const bs::HMesh& mesh,
+                 bs::PhysicsMeshType type = bs::PhysicsMeshType::Triangle);
+
+    /**
+     * Loads or creates all physics meshes queued via request(). Blocks until all of them are
+     * available.
+     */
+    void finishRequests();
+
+    /**
+     * @return The physics mesh known under the given name. Empty if there is none (yet).
+     */
+    bs::HPhysicsMesh get(const bs::String& name) const;
+
+    /**
+     * Shortcut for request(), finishRequests() and get() for a single mesh.
+     */
+    bs::HPhysicsMesh loadOrCreate(const bs::String& name, const bs::HMesh& mesh,
+                                  bs::PhysicsMeshType type = bs::PhysicsMeshType::Triangle);
+
+    /**
+     * Forgets the physics mesh known under the given name and removes it from the disk cache,
+     * so it is created again next time. Meant for when the mesh it was made from changed.
+     */
+    void remove(const bs::String& name);
+
+    /**
+     * @return Number of physics meshes known.
+     */
+    size_t size() const
+    {
+      return mPhysicsMeshes.size();
+    }
+
+    const Stats& stats() const
+    {
+      return mStats;
+    }
+
+  private:
+    struct Request
+    {
+      bs::String name;
+      bs::HMesh mesh;
+      bs::PhysicsMeshType type;
+    };
+
+    bs::UnorderedMap<bs::String, bs::HPhysicsMesh> mPhysicsMeshes;
+
+    bs::Vector<Request> mRequests;
+
+    Stats mStats;
+  };
+
+  /**
+   * Global access to the physics mesh cache.
+   */
+  PhysicsMeshCache& gPhysicsMeshCache();
+}  // namespace REGoth
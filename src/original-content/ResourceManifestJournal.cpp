@@ -0,0 +1,115 @@
+#include "ResourceManifestJournal.hpp"
+#include <BsZenLib/ImportPath.hpp>
+#include <BsZenLib/ResourceManifest.hpp>
+#include <FileSystem/BsFileSystem.h>
+#include <Resources/BsResourceManifest.h>
+#include <fstream>
+#include <log/logging.hpp>
+#include <string>
+
+namespace REGoth
+{
+  ResourceManifestJournal::ResourceManifestJournal(const bs::Path& journalPath,
+                                                   const bs::Path& baseDirectory)
+      : mJournalPath(journalPath)
+      , mBaseDirectory(baseDirectory)
+  {
+  }
+
+  bs::UINT32 ResourceManifestJournal::replay(bs::ResourceManifest& manifest)
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    std::ifstream journal(mJournalPath.toString().c_str());
+    std::string line;
+    bs::UINT32 numRegistered = 0;
+
+    mNumEntries = 0;
+
+    // One entry per line: UUID, a tab, then the path relative to the base directory. A line
+    // cut short by a crash has no tab or an incomplete UUID and is skipped.
+    while (std::getline(journal, line))
+    {
+      size_t tab = line.find('\t');
+
+      if (tab == std::string::npos) continue;
+
+      bs::UUID uuid(bs::String(line.substr(0, tab).c_str()));
+      bs::Path path = mBaseDirectory + bs::Path(line.substr(tab + 1).c_str());
+
+      mNumEntries += 1;
+
+      if (uuid.empty() || !bs::FileSystem::isFile(path)) continue;
+
+      manifest.registerResource(uuid, path);
+      numRegistered += 1;
+    }
+
+    return numRegistered;
+  }
+
+  void ResourceManifestJournal::append(const bs::UUID& uuid, const bs::Path& path)
+  {
+    bs::Path relative = path;
+
+    if (mBaseDirectory.includes(path))
+    {
+      relative.makeRelative(mBaseDirectory);
+    }
+
+    std::string line = uuid.toString().c_str();
+    line += '\t';
+    line += relative.toString().c_str();
+    line += '\n';
+
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    std::ofstream journal(mJournalPath.toString().c_str(), std::ios::app | std::ios::binary);
+
+    if (!journal)
+    {
+      REGOTH_LOG(Warning, Uncategorized, "[ResourceManifestJournal] Failed to open {0}",
+                 mJournalPath.toString());
+      return;
+    }
+
+    journal.write(line.data(), line.size());
+    journal.flush();
+
+    mNumEntries += 1;
+  }
+
+  void ResourceManifestJournal::clear()
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    if (bs::FileSystem::exists(mJournalPath))
+    {
+      bs::FileSystem::remove(mJournalPath);
+    }
+
+    mNumEntries = 0;
+  }
+
+  bs::UINT32 ResourceManifestJournal::numEntries() const
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    return mNumEntries;
+  }
+
+  ResourceManifestJournal& gGothicCacheJournal()
+  {
+    static ResourceManifestJournal journal(
+        BsZenLib::GetCacheDirectory() + "gothic-cache.journal", BsZenLib::GetCacheDirectory());
+
+    return journal;
+  }
+
+  void addToGothicCacheManifest(bs::HResource resource, const bs::Path& path)
+  {
+    BsZenLib::AddToResourceManifest(resource, path);
+
+    gGothicCacheJournal().append(resource.getUUID(), path);
+  }
+}  // namespace REGoth
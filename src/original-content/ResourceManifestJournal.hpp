@@ -0,0 +1,76 @@
+/** \file
+ */
+
+#pragma once
+
+#include <BsPrerequisites.h>
+#include <mutex>
+
+namespace REGoth
+{
+  /**
+   * Journal of the resources added to a resource manifest since it has last been saved.
+   *
+   * Saving a resource manifest rewrites all of it, which gets slow as the cache grows and is
+   * therefore only done every now and then. Whatever was cached in between would be lost
+   * for the manifest on a crash, leaving files in the cache no one finds by UUID anymore.
+   * Instead, every added resource is also appended to the journal as a single line, which
+   * costs only as much as the entry itself. On the next start the journal is replayed into
+   * the manifest, see replay(). Once the whole manifest has been saved, the journal is
+   * cleared, see clear().
+   *
+   * Appending may happen from any thread.
+   */
+  class ResourceManifestJournal
+  {
+  public:
+    /**
+     * @param  journalPath    File to append the entries to.
+     * @param  baseDirectory  Paths of the entries are stored relative to this directory,
+     *                        like the manifest does with the cache directory.
+     */
+    ResourceManifestJournal(const bs::Path& journalPath, const bs::Path& baseDirectory);
+
+    /**
+     * Registers every entry of the journal whose file still exists with the given manifest.
+     *
+     * @return Number of entries registered.
+     */
+    bs::UINT32 replay(bs::ResourceManifest& manifest);
+
+    /**
+     * Appends the given resource to the journal and flushes it to disk.
+     */
+    void append(const bs::UUID& uuid, const bs::Path& path);
+
+    /**
+     * Removes all entries, to be called once the manifest has been saved as a whole.
+     */
+    void clear();
+
+    /**
+     * @return Number of entries in the journal, i.e. added since the manifest was last saved.
+     */
+    bs::UINT32 numEntries() const;
+
+  private:
+    bs::Path mJournalPath;
+    bs::Path mBaseDirectory;
+
+    mutable std::mutex mMutex;
+    bs::UINT32 mNumEntries = 0;
+  };
+
+  /**
+   * @return Journal of the resources REGoth adds to the cache of BsZenLib, see
+   *         addToGothicCacheManifest().
+   */
+  ResourceManifestJournal& gGothicCacheJournal();
+
+  /**
+   * Adds the given resource to the resource manifest of BsZenLib and to
+   * gGothicCacheJournal(), so it can still be found after a crash. To be used instead of
+   * `BsZenLib::AddToResourceManifest()` for everything REGoth caches on its own.
+   */
+  void addToGothicCacheManifest(bs::HResource resource, const bs::Path& path);
+}  // namespace REGoth
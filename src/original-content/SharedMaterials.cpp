@@ -0,0 +1,70 @@
+#include "SharedMaterials.hpp"
+#include <Image/BsTexture.h>
+#include <Material/BsMaterial.h>
+#include <Material/BsShader.h>
+
+namespace REGoth
+{
+  bs::HMaterial SharedMaterials::find(const bs::HMaterial& material)
+  {
+    if (!material || !material.isLoaded() || !material->getShader()) return material;
+
+    bs::String uuid = material.getUUID().toString();
+
+    auto it = mByMaterial.find(uuid);
+
+    if (it != mByMaterial.end()) return it->second;
+
+    bs::String key = looksKey(material);
+
+    auto looksIt = mByLooks.find(key);
+
+    if (looksIt == mByLooks.end())
+    {
+      mByLooks[key] = material;
+
+      return mByMaterial[uuid] = material;
+    }
+
+    mNumReplaced += 1;
+
+    return mByMaterial[uuid] = looksIt->second;
+  }
+
+  bs::Vector<bs::HMaterial> SharedMaterials::find(const bs::Vector<bs::HMaterial>& materials)
+  {
+    bs::Vector<bs::HMaterial> result;
+    result.reserve(materials.size());
+
+    for (const bs::HMaterial& material : materials)
+    {
+      result.push_back(find(material));
+    }
+
+    return result;
+  }
+
+  bs::String SharedMaterials::looksKey(const bs::HMaterial& material)
+  {
+    const bs::HShader& shader = material->getShader();
+
+    bs::String key = shader.getUUID().toString();
+
+    // Sorted by name, so the key doesn't depend on the order the parameters are stored in
+    for (const auto& param : shader->getTextureParams())
+    {
+      bs::HTexture texture = material->getTexture(param.first);
+
+      key += "_" + param.first + "=" + (texture ? texture.getUUID().toString() : "");
+    }
+
+    return key;
+  }
+
+  SharedMaterials& gSharedMaterials()
+  {
+    static SharedMaterials s_instance;
+
+    return s_instance;
+  }
+}  // namespace REGoth
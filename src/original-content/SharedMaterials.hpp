@@ -0,0 +1,71 @@
+#pragma once
+#include <BsPrerequisites.h>
+
+namespace REGoth
+{
+  /**
+   * Finds one material for all materials which look the same.
+   *
+   * Every mesh imported by BsZenLib comes with materials of its own, even though lots of
+   * meshes use the same textures. Two crates or all tiles of the world mesh showing the same
+   * wooden planks would have their own material each, so the renderer has to switch
+   * materials between them and can't sort or merge them by material.
+   *
+   * Materials are considered the same if they use the same shader and the same textures,
+   * which is all the materials created by BsZenLib differ in. Which material represents
+   * those is the first one found.
+   */
+  class SharedMaterials
+  {
+  public:
+    /**
+     * @return The material representing all materials looking like the given one.
+     */
+    bs::HMaterial find(const bs::HMaterial& material);
+
+    /**
+     * Same as find() for each of the given materials.
+     */
+    bs::Vector<bs::HMaterial> find(const bs::Vector<bs::HMaterial>& materials);
+
+    /**
+     * @return Number of materials replaced by another one looking the same.
+     */
+    bs::UINT32 numReplaced() const
+    {
+      return mNumReplaced;
+    }
+
+    /**
+     * @return Number of distinct materials found.
+     */
+    size_t numShared() const
+    {
+      return mByLooks.size();
+    }
+
+  private:
+    /**
+     * @return Key all materials looking the same share, see find().
+     */
+    static bs::String looksKey(const bs::HMaterial& material);
+
+    /**
+     * UUID of a material -> Material representing it. Saves building the key again whenever
+     * the same mesh is shown.
+     */
+    bs::UnorderedMap<bs::String, bs::HMaterial> mByMaterial;
+
+    /**
+     * Key of the looks -> Material representing them, see looksKey().
+     */
+    bs::UnorderedMap<bs::String, bs::HMaterial> mByLooks;
+
+    bs::UINT32 mNumReplaced = 0;
+  };
+
+  /**
+   * Global access to the shared materials.
+   */
+  SharedMaterials& gSharedMaterials();
+}  // namespace REGoth
@@ -0,0 +1,188 @@
+#include "SoundStreaming.hpp"
+#include <Audio/BsAudioClip.h>
+#include <FileSystem/BsDataStream.h>
+#include <Resources/BsResources.h>
+#include <log/logging.hpp>
+#include <cstring>
+
+namespace REGoth
+{
+  /**
+   * What the header of a WAV-file says about its samples.
+   */
+  struct WavInfo
+  {
+    bs::UINT32 numChannels = 0;
+    bs::UINT32 frequency   = 0;
+    bs::UINT32 bitDepth    = 0;
+
+    /** Where the samples are inside the file */
+    size_t dataOffset = 0;
+    size_t dataSize   = 0;
+  };
+
+  /**
+   * Reads the chunks of a RIFF WAV-file up to its samples.
+   *
+   * @return Whether the file contains PCM samples which can be played.
+   */
+  static bool readWavInfo(const FileView& file, WavInfo& info)
+  {
+    const bs::UINT8* data = file.data();
+    size_t size           = file.size();
+
+    auto readU16 = [&](size_t at) {
+      bs::UINT16 value;
+      std::memcpy(&value, data + at, sizeof(value));
+      return value;
+    };
+
+    auto readU32 = [&](size_t at) {
+      bs::UINT32 value;
+      std::memcpy(&value, data + at, sizeof(value));
+      return value;
+    };
+
+    if (size < 12) return false;
+    if (std::memcmp(data, "RIFF", 4) != 0 || std::memcmp(data + 8, "WAVE", 4) != 0) return false;
+
+    bool hasFormat = false;
+
+    for (size_t at = 12; at + 8 <= size;)
+    {
+      bs::UINT32 chunkSize = readU32(at + 4);
+      size_t chunkStart    = at + 8;
+
+      if (chunkSize > size - chunkStart) return false;
+
+      if (std::memcmp(data + at, "fmt ", 4) == 0 && chunkSize >= 16)
+      {
+        const bs::UINT16 formatPCM = 1;
+
+        if (readU16(chunkStart) != formatPCM) return false;
+
+        info.numChannels = readU16(chunkStart + 2);
+        info.frequency   = readU32(chunkStart + 4);
+        info.bitDepth    = readU16(chunkStart + 14);
+        hasFormat        = true;
+      }
+      else if (std::memcmp(data + at, "data", 4) == 0)
+      {
+        info.dataOffset = chunkStart;
+        info.dataSize   = chunkSize;
+
+        return hasFormat && info.numChannels > 0 && (info.bitDepth == 8 || info.bitDepth == 16);
+      }
+
+      // Chunks are padded to an even size
+      at = chunkStart + chunkSize + (chunkSize & 1);
+    }
+
+    return false;
+  }
+
+  bs::HAudioClip SoundStreaming::acquire(const bs::String& fileName)
+  {
+    auto it = mClips.find(fileName);
+
+    if (it != mClips.end())
+    {
+      it->second.numUsers += 1;
+      return it->second.clip;
+    }
+
+    if (mNotStreamable.find(fileName) != mNotStreamable.end()) return {};
+
+    StreamedClip streamed;
+    streamed.file = gVirtualFileSystem().viewFile(fileName);
+
+    WavInfo info;
+
+    if (streamed.file.empty() || !readWavInfo(streamed.file, info))
+    {
+      REGOTH_LOG(Warning, Uncategorized, "[SoundStreaming] Cannot play sound file {0}",
+                 fileName);
+
+      mNotStreamable.insert(fileName);
+      return {};
+    }
+
+    // The view outlives the clip, so the stream must not free it
+    auto samples = bs::bs_shared_ptr_new<bs::MemoryDataStream>(
+        const_cast<bs::UINT8*>(streamed.file.data()) + info.dataOffset, info.dataSize, false);
+
+    bs::AUDIO_CLIP_DESC desc;
+    desc.readMode    = bs::AudioReadMode::Stream;
+    desc.format      = bs::AudioFormat::PCM;
+    desc.frequency   = info.frequency;
+    desc.bitDepth    = info.bitDepth;
+    desc.numChannels = info.numChannels;
+    desc.is3D        = true;
+
+    bs::UINT32 numSamples = (bs::UINT32)(info.dataSize / (info.bitDepth / 8));
+
+    streamed.clip     = bs::AudioClip::create(samples, (bs::UINT32)info.dataSize, numSamples, desc);
+    streamed.numUsers = 1;
+
+    bs::HAudioClip clip = streamed.clip;
+    mClips.emplace(fileName, std::move(streamed));
+
+    return clip;
+  }
+
+  void SoundStreaming::release(const bs::String& fileName)
+  {
+    auto it = mClips.find(fileName);
+
+    if (it == mClips.end() || it->second.numUsers == 0) return;
+
+    it->second.numUsers -= 1;
+    it->second.lastReleased = ++mNumReleases;
+
+    trimCache();
+  }
+
+  void SoundStreaming::trimCache()
+  {
+    for (;;)
+    {
+      bs::UINT64 unusedBytes = 0;
+      auto oldest            = mClips.end();
+
+      for (auto it = mClips.begin(); it != mClips.end(); it++)
+      {
+        if (it->second.numUsers != 0) continue;
+
+        unusedBytes += it->second.file.size();
+
+        if (oldest == mClips.end() || it->second.lastReleased < oldest->second.lastReleased)
+        {
+          oldest = it;
+        }
+      }
+
+      if (unusedBytes <= SOUND_STREAMING_CACHE_BUDGET) return;
+
+      bs::gResources().release(oldest->second.clip);
+      mClips.erase(oldest);
+    }
+  }
+
+  void SoundStreaming::clear()
+  {
+    for (auto& it : mClips)
+    {
+      bs::gResources().release(it.second.clip);
+    }
+
+    mClips.clear();
+    mNotStreamable.clear();
+  }
+
+  SoundStreaming& gSoundStreaming()
+  {
+    static SoundStreaming s_instance;
+
+    return s_instance;
+  }
+}  // namespace REGoth
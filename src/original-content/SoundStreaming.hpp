@@ -0,0 +1,83 @@
+#pragma once
+#include <BsPrerequisites.h>
+#include <original-content/VirtualFileSystem.hpp>
+
+namespace REGoth
+{
+  /** Bytes of sound files which are kept around while unused, at most */
+  constexpr bs::UINT64 SOUND_STREAMING_CACHE_BUDGET = 16ull * 1024 * 1024;
+
+  /**
+   * Plays WAV-files right out of the VDFS, without decoding them up front.
+   *
+   * Every clip created via acquire() is a streaming audio clip reading its samples from a view
+   * of the file inside the VDFS. The audio backend decodes the part about to play in small
+   * chunks on its streaming thread, so creating a clip doesn't hitch and only takes the memory
+   * of its file, which for files inside a mapped package is none at all.
+   *
+   * Clips are kept until nobody has acquired them anymore and the cache of unused clips is
+   * over SOUND_STREAMING_CACHE_BUDGET, then the least recently used ones go first.
+   *
+   * Only uncompressed PCM WAV-files are supported, like most sounds of the original games.
+   */
+  class SoundStreaming
+  {
+  public:
+    /**
+     * @param  fileName  Name of a WAV-file inside the VDFS, e.g. `SFX_CROW.WAV`.
+     *
+     * @return Streaming clip of the given file, which is kept until release() is called as
+     *         often as this. Invalid handle if the file doesn't exist or is not supported.
+     */
+    bs::HAudioClip acquire(const bs::String& fileName);
+
+    /**
+     * Counterpart of acquire().
+     */
+    void release(const bs::String& fileName);
+
+    /**
+     * @return Number of clips around right now, used or not.
+     */
+    bs::UINT32 numClips() const
+    {
+      return (bs::UINT32)mClips.size();
+    }
+
+    /**
+     * Forgets about all clips, which must not be in use anymore.
+     */
+    void clear();
+
+  private:
+    struct StreamedClip
+    {
+      bs::HAudioClip clip;
+
+      /** Samples are read from here, so it needs to stay around as long as the clip does */
+      FileView file;
+
+      bs::UINT32 numUsers = 0;
+
+      /** Increased whenever any clip is released, to find the least recently used one */
+      bs::UINT64 lastReleased = 0;
+    };
+
+    /**
+     * Drops unused clips until the unused ones fit into SOUND_STREAMING_CACHE_BUDGET.
+     */
+    void trimCache();
+
+    bs::UnorderedMap<bs::String, StreamedClip> mClips;
+
+    /** Names of WAV-files which failed to load, so they aren't tried again */
+    bs::UnorderedSet<bs::String> mNotStreamable;
+
+    bs::UINT64 mNumReleases = 0;
+  };
+
+  /**
+   * Global access to the sound streaming.
+   */
+  SoundStreaming& gSoundStreaming();
+}  // namespace REGoth
@@ -0,0 +1,259 @@
+#include "StaticMeshLOD.hpp"
+#include "MeshOptimization.hpp"
+#include "ResourceManifestJournal.hpp"
+#include <BsZenLib/ImportPath.hpp>
+#include <FileSystem/BsFileSystem.h>
+#include <Mesh/BsMesh.h>
+#include <Resources/BsResources.h>
+#include <log/logging.hpp>
+#include <cmath>
+#include <cstring>
+
+namespace REGoth
+{
+  /**
+   * A version has to have at most this much of the triangles of the one before, otherwise
+   * it's not worth keeping.
+   */
+  constexpr float MAX_TRIANGLE_RATIO_PER_LOD = 0.75f;
+
+  /**
+   * Cells of the first version, in relation to the length of the diagonal through the
+   * bounding box of the mesh. Each following version doubles the cell size.
+   */
+  constexpr float FIRST_LOD_CELL_SIZE_FACTOR = 1.0f / 48.0f;
+
+  static bs::UINT64 clusterKey(bs::UINT32 subMesh, bs::INT32 x, bs::INT32 y, bs::INT32 z);
+  static bs::UINT32 triangleCount(const bs::HMesh& mesh);
+  static bs::Path lodPath(const bs::String& originalFileName, bs::UINT32 lod);
+
+  bs::HMesh simplifyMeshByClustering(const bs::HMesh& mesh, float cellSize)
+  {
+    bs::SPtr<bs::MeshData> data = mesh->getCachedData();
+
+    if (!data || cellSize <= 0.0f) return {};
+
+    bs::SPtr<bs::VertexDataDesc> vertexDesc = data->getVertexDesc();
+
+    const bs::MeshProperties& properties = mesh->getProperties();
+
+    bs::UINT32 numVertices = data->getNumVertices();
+    bs::UINT32 stride      = vertexDesc->getVertexStride(0);
+
+    const bs::UINT8* vertices  = data->getStreamData(0);
+    const bs::UINT8* positions = data->getElementData(bs::VES_POSITION);
+
+    if (!vertices || !positions || numVertices == 0) return {};
+
+    auto positionOf = [&](bs::UINT32 vertex) {
+      bs::Vector3 position;
+      std::memcpy(&position, positions + (size_t)vertex * stride, sizeof(position));
+      return position;
+    };
+
+    auto indexAt = [&](bs::UINT32 i) {
+      return data->getIndexType() == bs::IT_32BIT ? data->getIndices32()[i]
+                                                  : (bs::UINT32)data->getIndices16()[i];
+    };
+
+    bs::Vector3 boundsMin = properties.getBounds().getBox().getMin();
+
+    // Representative of each cluster and which vertex of the new mesh it became
+    bs::UnorderedMap<bs::UINT64, bs::UINT32> clusters;
+    bs::Vector<bs::UINT32> newVertexOrigins;
+    bs::Vector<bs::UINT32> newIndices;
+    bs::Vector<bs::SubMesh> newSubMeshes;
+
+    for (bs::UINT32 s = 0; s < properties.getNumSubMeshes(); s++)
+    {
+      const bs::SubMesh& subMesh = properties.getSubMesh(s);
+
+      if (subMesh.drawOp != bs::DOT_TRIANGLE_LIST) return {};
+
+      bs::SubMesh newSubMesh = subMesh;
+      newSubMesh.indexOffset = (bs::UINT32)newIndices.size();
+
+      auto clusterOf = [&](bs::UINT32 vertex) {
+        bs::Vector3 cell = (positionOf(vertex) - boundsMin) / cellSize;
+
+        bs::UINT64 key = clusterKey(s, (bs::INT32)std::floor(cell.x), (bs::INT32)std::floor(cell.y),
+                                    (bs::INT32)std::floor(cell.z));
+
+        auto it = clusters.find(key);
+
+        if (it != clusters.end()) return it->second;
+
+        newVertexOrigins.push_back(vertex);
+
+        return clusters[key] = (bs::UINT32)newVertexOrigins.size() - 1;
+      };
+
+      for (bs::UINT32 i = 0; i + 2 < subMesh.indexCount; i += 3)
+      {
+        bs::UINT32 a = clusterOf(indexAt(subMesh.indexOffset + i + 0));
+        bs::UINT32 b = clusterOf(indexAt(subMesh.indexOffset + i + 1));
+        bs::UINT32 c = clusterOf(indexAt(subMesh.indexOffset + i + 2));
+
+        // Collapsed into a line or a point
+        if (a == b || b == c || a == c) continue;
+
+        newIndices.push_back(a);
+        newIndices.push_back(b);
+        newIndices.push_back(c);
+      }
+
+      newSubMesh.indexCount = (bs::UINT32)newIndices.size() - newSubMesh.indexOffset;
+
+      // A material vanishing would look worse than a few more triangles
+      if (newSubMesh.indexCount == 0) return {};
+
+      newSubMeshes.push_back(newSubMesh);
+    }
+
+    if (newIndices.empty()) return {};
+
+    bs::UINT32 numNewVertices = (bs::UINT32)newVertexOrigins.size();
+
+    // Clustering leaves the triangles in the order of the original mesh, with most of their
+    // neighbours gone
+    for (const bs::SubMesh& subMesh : newSubMeshes)
+    {
+      optimizeTriangleOrder(newIndices.data() + subMesh.indexOffset, subMesh.indexCount,
+                            numNewVertices);
+    }
+
+    bs::Vector<bs::UINT32> fetchOrder =
+        remapVerticesByFirstUse(newIndices.data(), (bs::UINT32)newIndices.size(), numNewVertices);
+
+    // Small meshes, which most of them are, get away with half the index buffer
+    bs::IndexType indexType = numNewVertices <= 0xFFFF ? bs::IT_16BIT : bs::IT_32BIT;
+
+    bs::SPtr<bs::MeshData> newData = bs::MeshData::create(
+        numNewVertices, (bs::UINT32)newIndices.size(), vertexDesc, indexType);
+
+    bs::UINT8* newVertices = newData->getStreamData(0);
+
+    for (size_t v = 0; v < fetchOrder.size(); v++)
+    {
+      std::memcpy(newVertices + v * stride,
+                  vertices + (size_t)newVertexOrigins[fetchOrder[v]] * stride, stride);
+    }
+
+    if (indexType == bs::IT_16BIT)
+    {
+      bs::UINT16* indices16 = newData->getIndices16();
+
+      for (size_t i = 0; i < newIndices.size(); i++)
+      {
+        indices16[i] = (bs::UINT16)newIndices[i];
+      }
+    }
+    else
+    {
+      std::memcpy(newData->getIndices32(), newIndices.data(),
+                  newIndices.size() * sizeof(bs::UINT32));
+    }
+
+    bs::MESH_DESC desc;
+    desc.numVertices = numNewVertices;
+    desc.numIndices  = (bs::UINT32)newIndices.size();
+    desc.vertexDesc  = vertexDesc;
+    desc.indexType   = indexType;
+    desc.subMeshes   = newSubMeshes;
+    desc.usage       = bs::MU_STATIC | bs::MU_CPUCACHED;
+
+    return bs::Mesh::create(newData, desc);
+  }
+
+  bs::Vector<bs::HMesh> loadOrCreateStaticMeshLODs(const bs::String& originalFileName,
+                                                   const bs::HMesh& mesh)
+  {
+    bs::UINT32 numTriangles = triangleCount(mesh);
+
+    if (numTriangles < STATIC_MESH_MIN_TRIANGLES_FOR_LOD) return {};
+
+    bs::Vector<bs::HMesh> lods;
+
+    bs::Vector3 size = mesh->getProperties().getBounds().getBox().getSize();
+    float cellSize   = size.length() * FIRST_LOD_CELL_SIZE_FACTOR;
+
+    for (bs::UINT32 lod = 0; lod < STATIC_MESH_NUM_LODS; lod++, cellSize *= 2.0f)
+    {
+      bs::Path path = lodPath(originalFileName, lod);
+
+      if (bs::FileSystem::exists(path))
+      {
+        bs::HMesh cached = bs::gResources().load<bs::Mesh>(path);
+
+        if (!cached) break;
+
+        lods.push_back(cached);
+        continue;
+      }
+
+      bs::HMesh simplified = simplifyMeshByClustering(mesh, cellSize);
+
+      if (!simplified) break;
+
+      bs::UINT32 previousTriangles = lods.empty() ? numTriangles : triangleCount(lods.back());
+
+      if (triangleCount(simplified) > previousTriangles * MAX_TRIANGLE_RATIO_PER_LOD) break;
+
+      enum
+      {
+        Overwrite    = true,
+        KeepExisting = false,
+      };
+
+      simplified->setName(mesh->getName() + ".lod" + bs::toString(lod));
+
+      addToGothicCacheManifest(simplified, path);
+      bs::gResources().save(simplified, path, Overwrite);
+
+      lods.push_back(simplified);
+    }
+
+    return lods;
+  }
+
+  static bs::UINT64 clusterKey(bs::UINT32 subMesh, bs::INT32 x, bs::INT32 y, bs::INT32 z)
+  {
+    // Meshes are never split into more than a few thousand cells per axis
+    constexpr bs::UINT64 MASK = (1 << 18) - 1;
+
+    return ((bs::UINT64)subMesh << 54) | (((bs::UINT64)(bs::UINT32)x & MASK) << 36) |
+           (((bs::UINT64)(bs::UINT32)y & MASK) << 18) | ((bs::UINT64)(bs::UINT32)z & MASK);
+  }
+
+  static bs::UINT32 triangleCount(const bs::HMesh& mesh)
+  {
+    const bs::MeshProperties& properties = mesh->getProperties();
+
+    bs::UINT32 numIndices = 0;
+
+    for (bs::UINT32 s = 0; s < properties.getNumSubMeshes(); s++)
+    {
+      numIndices += properties.getSubMesh(s).indexCount;
+    }
+
+    return numIndices / 3;
+  }
+
+  void removeCachedStaticMeshLODs(const bs::String& originalFileName)
+  {
+    for (bs::UINT32 lod = 0; lod < STATIC_MESH_NUM_LODS; lod++)
+    {
+      bs::Path path = lodPath(originalFileName, lod);
+
+      if (bs::FileSystem::exists(path))
+      {
+        bs::FileSystem::remove(path);
+      }
+    }
+  }
+
+  static bs::Path lodPath(const bs::String& originalFileName, bs::UINT32 lod)
+  {
+    return BsZenLib::GothicPathToCachedStaticMesh(originalFileName + ".lod" + bs::toString(lod));
+  }
+}  // namespace REGoth
@@ -0,0 +1,61 @@
+#pragma once
+#include <BsPrerequisites.h>
+
+namespace REGoth
+{
+  /**
+   * Number of less detailed versions generated for a static mesh, see
+   * createStaticMeshLODs().
+   */
+  constexpr bs::UINT32 STATIC_MESH_NUM_LODS = 2;
+
+  /**
+   * Static meshes with fewer triangles than this are drawn at full detail at any distance,
+   * there is not much to win by simplifying them.
+   */
+  constexpr bs::UINT32 STATIC_MESH_MIN_TRIANGLES_FOR_LOD = 256;
+
+  /**
+   * Simplifies the given mesh by vertex clustering: The mesh is divided into cubes of the
+   * given size and all vertices of one sub-mesh inside the same cube are merged into the
+   * first of them found. Triangles which collapsed by that are removed. Since a vertex is
+   * only ever merged into one of the same sub-mesh, materials and texture coordinates stay
+   * intact.
+   *
+   * The triangles and vertices of the result are ordered for the vertex cache of the GPU, see
+   * optimizeTriangleOrder(). Indices are 16-bit if there are few enough vertices.
+   *
+   * Needs the mesh to be CPU-cached and to keep all its vertex data in a single stream,
+   * which is how BsZenLib imports static meshes.
+   *
+   * @param  mesh      Mesh to simplify.
+   * @param  cellSize  Length of a side of the cubes vertices are merged in.
+   *
+   * @return The simplified mesh. Empty if the mesh can't be simplified or a sub-mesh would
+   *         vanish completely.
+   */
+  bs::HMesh simplifyMeshByClustering(const bs::HMesh& mesh, float cellSize);
+
+  /**
+   * Creates the less detailed versions of the given static mesh and caches them next to
+   * the mesh, or loads them from cache if that has been done before.
+   *
+   * Every version has about half the triangles of the one before. Generating stops at
+   * STATIC_MESH_NUM_LODS versions or once simplifying doesn't remove enough anymore.
+   *
+   * @param  originalFileName  File name of the mesh as in the original game, e.g.
+   *                           `STONE.3DS`.
+   * @param  mesh              Full detail mesh loaded from that file.
+   *
+   * @return Less detailed versions of the mesh, each coarser than the one before. Empty if
+   *         the mesh is not worth simplifying.
+   */
+  bs::Vector<bs::HMesh> loadOrCreateStaticMeshLODs(const bs::String& originalFileName,
+                                                   const bs::HMesh& mesh);
+
+  /**
+   * Removes the less detailed versions of the given static mesh from the cache, so they
+   * are created again next time.
+   */
+  void removeCachedStaticMeshLODs(const bs::String& originalFileName);
+}  // namespace REGoth
@@ -0,0 +1,432 @@
+#include "TextureStreaming.hpp"
+#include <Components/BsCRenderable.h>
+#include <Image/BsPixelData.h>
+#include <Image/BsTexture.h>
+#include <Material/BsMaterial.h>
+#include <Material/BsShader.h>
+#include <Renderer/BsCamera.h>
+#include <Resources/BsResources.h>
+#include <RenderAPI/BsViewport.h>
+#include <Scene/BsSceneManager.h>
+#include <Scene/BsSceneObject.h>
+#include <Utility/BsTime.h>
+#include <log/logging.hpp>
+#include <original-content/VirtualFileSystem.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace REGoth
+{
+  /** Size of the header of a ZTEX file, before the palette and the mip levels */
+  constexpr size_t ZTEX_HEADER_SIZE = 36;
+
+  /** Pixel formats of ZTEX files which are block-compressed */
+  enum ZTEXFormat : bs::UINT32
+  {
+    ZTEX_DXT1 = 10,
+    ZTEX_DXT2 = 11,
+    ZTEX_DXT3 = 12,
+    ZTEX_DXT4 = 13,
+    ZTEX_DXT5 = 14,
+  };
+
+  /** Name of the texture parameter BsZenLib's materials sample the surface color from */
+  static const char* ALBEDO_TEXTURE_PARAMETER = "gAlbedoTex";
+
+  static bs::UINT32 readUInt32(const FileView& data, size_t offset)
+  {
+    bs::UINT32 value;
+    std::memcpy(&value, data.data() + offset, sizeof(value));
+
+    return value;
+  }
+
+  /**
+   * @return Name of the compiled ZTEX file of the given texture, like `STONE-C.TEX` for
+   *         `STONE.TGA`.
+   */
+  static bs::String compiledTextureFileName(const bs::String& textureName)
+  {
+    bs::String name = textureName.substr(0, textureName.find_last_of('.'));
+    bs::StringUtil::toUpperCase(name);
+
+    return name + "-C.TEX";
+  }
+
+  void TextureStreaming::update()
+  {
+    float now = bs::gTime().getTime();
+
+    if (now < mTimeOfNextCheck) return;
+
+    mTimeOfNextCheck = now + TEXTURE_STREAMING_CHECK_INTERVAL;
+
+    const auto& mainCamera = bs::gSceneManager().getMainCamera();
+
+    if (!mainCamera || !mainCamera->getViewport()) return;
+
+    // Texels needed along a texture stretched over something of radius 1 at distance 1
+    float screenHeight = (float)mainCamera->getViewport()->getPixelArea().height;
+    float aspectRatio  = std::max(mainCamera->getAspectRatio(), 0.01f);
+    float tanHalfFOV   = std::tan(mainCamera->getHorzFOV().valueRadians() * 0.5f) / aspectRatio;
+
+    float pixelsPerRadianAtDistance = screenHeight / std::max(tanHalfFOV, 0.01f);
+
+    for (auto& entry : mTextures)
+    {
+      entry.second.isNeededNow    = false;
+      entry.second.levelNeededNow = entry.second.info.numLevels;
+    }
+
+    findNeededLevels(bs::gSceneManager().getMainScene()->getRoot(), *mainCamera,
+                     pixelsPerRadianAtDistance);
+
+    for (auto& entry : mTextures)
+    {
+      StreamedTexture& texture = entry.second;
+
+      bs::UINT32 smallest =
+          levelForResolution(texture.info, (float)TEXTURE_STREAMING_MIN_RESOLUTION);
+      bs::UINT32 levelNow = texture.isNeededNow ? texture.levelNeededNow : smallest;
+
+      if (levelNow <= texture.neededLevel)
+      {
+        texture.neededLevel       = levelNow;
+        texture.checksSinceNeeded = 0;
+      }
+      else if (++texture.checksSinceNeeded > TEXTURE_STREAMING_KEEP_CHECKS)
+      {
+        texture.neededLevel       = levelNow;
+        texture.checksSinceNeeded = 0;
+      }
+    }
+
+    applyNeededLevels();
+  }
+
+  void TextureStreaming::findNeededLevels(const bs::HSceneObject& so, const bs::Camera& camera,
+                                          float pixelsPerRadianAtDistance)
+  {
+    if (!so->getActive()) return;
+
+    bs::HRenderable renderable = so->getComponent<bs::CRenderable>();
+
+    if (renderable)
+    {
+      bs::Sphere bounds = renderable->getBounds().getSphere();
+
+      // Standing inside of something needs the full resolution
+      float distance = camera.getTransform().pos().distance(bounds.getCenter());
+      distance       = std::max(distance - bounds.getRadius(), 1.0f);
+
+      float resolution = 2.0f * bounds.getRadius() / distance * pixelsPerRadianAtDistance;
+
+      for (const bs::HMaterial& material : renderable->getMaterials())
+      {
+        if (!material || !material->getShader()) continue;
+
+        if (!material->getShader()->hasTextureParam(ALBEDO_TEXTURE_PARAMETER)) continue;
+
+        bs::HTexture texture = material->getTexture(ALBEDO_TEXTURE_PARAMETER);
+
+        if (texture)
+        {
+          requestResolution(texture, resolution);
+        }
+      }
+    }
+
+    for (bs::UINT32 i = 0; i < so->getNumChildren(); i++)
+    {
+      findNeededLevels(so->getChild(i), camera, pixelsPerRadianAtDistance);
+    }
+  }
+
+  void TextureStreaming::requestResolution(const bs::HTexture& texture, float resolution)
+  {
+    StreamedTexture* streamed = findOrAdd(texture);
+
+    if (!streamed) return;
+
+    bs::UINT32 level = levelForResolution(streamed->info, resolution);
+
+    streamed->isNeededNow    = true;
+    streamed->levelNeededNow = std::min(streamed->levelNeededNow, level);
+  }
+
+  TextureStreaming::StreamedTexture* TextureStreaming::findOrAdd(const bs::HTexture& texture)
+  {
+    const bs::UUID& uuid = texture.getUUID();
+
+    auto it = mTextures.find(uuid);
+
+    if (it != mTextures.end()) return &it->second;
+
+    if (mNotStreamable.find(uuid) != mNotStreamable.end()) return nullptr;
+
+    if (!texture.isLoaded())
+    {
+      // Might still be loading, check again later
+      return nullptr;
+    }
+
+    StreamedTexture streamed;
+    streamed.handle   = texture;
+    streamed.fileName = compiledTextureFileName(texture->getName());
+
+    if (!gVirtualFileSystem().hasFile(streamed.fileName) ||
+        !readInfo(gVirtualFileSystem().viewFile(streamed.fileName), streamed.info))
+    {
+      mNotStreamable.insert(uuid);
+      return nullptr;
+    }
+
+    streamed.residentLevel  = streamed.info.numLevels;
+    streamed.neededLevel    = streamed.info.numLevels;
+    streamed.levelNeededNow = streamed.info.numLevels;
+
+    return &(mTextures[uuid] = streamed);
+  }
+
+  void TextureStreaming::applyNeededLevels()
+  {
+    auto targetLevelOf = [](const StreamedTexture& texture, bs::UINT32 bias) {
+      bs::UINT32 smallest =
+          levelForResolution(texture.info, (float)TEXTURE_STREAMING_MIN_RESOLUTION);
+
+      // Over budget, textures shrink, but not below the smallest size unless they're that
+      // small already
+      bs::UINT32 limit = std::max(smallest, texture.neededLevel);
+
+      return std::min(texture.neededLevel + bias, limit);
+    };
+
+    // Find how many levels all textures have to lose to fit into the budget
+    bs::UINT32 bias = 0;
+
+    for (; bias < 16; bias++)
+    {
+      bs::UINT64 total = 0;
+
+      for (const auto& entry : mTextures)
+      {
+        total += bytesFromLevel(entry.second.info, targetLevelOf(entry.second, bias));
+      }
+
+      if (total <= mBudget) break;
+    }
+
+    bs::Vector<StreamedTexture*> growing;
+    bs::UINT64 uploaded = 0;
+
+    for (auto& entry : mTextures)
+    {
+      StreamedTexture& texture = entry.second;
+
+      bs::UINT32 target = targetLevelOf(texture, bias);
+
+      if (target == texture.residentLevel) continue;
+
+      // Shrinking frees memory, so it's always done right away
+      if (target > texture.residentLevel && texture.residentLevel < texture.info.numLevels)
+      {
+        if (uploadLevel(texture, target))
+        {
+          uploaded += bytesFromLevel(texture.info, target);
+        }
+      }
+      else
+      {
+        growing.push_back(&texture);
+      }
+    }
+
+    // Textures which are farthest from the resolution they need first
+    std::sort(growing.begin(), growing.end(),
+              [&](const StreamedTexture* a, const StreamedTexture* b) {
+                return a->residentLevel - targetLevelOf(*a, bias) >
+                       b->residentLevel - targetLevelOf(*b, bias);
+              });
+
+    for (StreamedTexture* texture : growing)
+    {
+      bs::UINT32 target = targetLevelOf(*texture, bias);
+      bs::UINT64 bytes  = bytesFromLevel(texture->info, target);
+
+      if (uploaded > 0 && uploaded + bytes > TEXTURE_STREAMING_UPLOAD_PER_CHECK) break;
+
+      if (uploadLevel(*texture, target))
+      {
+        uploaded += bytes;
+      }
+    }
+  }
+
+  bool TextureStreaming::uploadLevel(StreamedTexture& texture, bs::UINT32 level)
+  {
+    // Points right into the package, so the levels are only copied into the pixel data
+    FileView data = gVirtualFileSystem().viewFile(texture.fileName);
+
+    const TextureInfo& info = texture.info;
+
+    TextureInfo fileInfo;
+    if (!readInfo(data, fileInfo) || fileInfo.numLevels != info.numLevels)
+    {
+      REGOTH_LOG(Warning, Uncategorized, "[TextureStreaming] Failed to read texture: {0}",
+                 texture.fileName);
+      return false;
+    }
+
+    // The levels are stored smallest first
+    bs::Vector<size_t> offsets(info.numLevels);
+    size_t offset = ZTEX_HEADER_SIZE;
+
+    for (bs::UINT32 l = info.numLevels; l-- > 0;)
+    {
+      offsets[l] = offset;
+      offset += bytesOfLevel(info, l);
+    }
+
+    if (offset > data.size())
+    {
+      REGOTH_LOG(Warning, Uncategorized, "[TextureStreaming] Texture is truncated: {0}",
+                 texture.fileName);
+      return false;
+    }
+
+    bs::TEXTURE_DESC desc;
+    desc.type    = bs::TEX_TYPE_2D;
+    desc.format  = info.format;
+    desc.width   = std::max(info.width >> level, 1u);
+    desc.height  = std::max(info.height >> level, 1u);
+    desc.numMips = info.numLevels - 1 - level;
+    desc.usage   = bs::TU_STATIC;
+    desc.hwGamma = texture.handle->getProperties().isHardwareGammaEnabled();
+
+    bs::SPtr<bs::Texture> replacement = bs::Texture::_createPtr(desc);
+
+    for (bs::UINT32 l = level; l < info.numLevels; l++)
+    {
+      bs::SPtr<bs::PixelData> pixels =
+          bs::PixelData::create(std::max(info.width >> l, 1u), std::max(info.height >> l, 1u), 1,
+                                info.format);
+
+      size_t size = std::min((size_t)pixels->getSize(), (size_t)bytesOfLevel(info, l));
+      std::memcpy(pixels->getData(), data.data() + offsets[l], size);
+
+      enum
+      {
+        DiscardEntireBuffer = true,
+      };
+
+      replacement->writeData(pixels, 0, l - level, DiscardEntireBuffer);
+    }
+
+    // Materials listen for changes of their textures, so they pick this up by themselves
+    bs::HResource handle = texture.handle;
+    bs::gResources().update(handle, replacement);
+
+    texture.residentLevel = level;
+
+    return true;
+  }
+
+  bs::UINT64 TextureStreaming::residentBytes() const
+  {
+    bs::UINT64 total = 0;
+
+    for (const auto& entry : mTextures)
+    {
+      const StreamedTexture& texture = entry.second;
+
+      if (texture.residentLevel < texture.info.numLevels)
+      {
+        total += bytesFromLevel(texture.info, texture.residentLevel);
+      }
+    }
+
+    return total;
+  }
+
+  void TextureStreaming::clear()
+  {
+    mTextures.clear();
+    mNotStreamable.clear();
+  }
+
+  bs::UINT32 TextureStreaming::levelForResolution(const TextureInfo& info, float resolution)
+  {
+    bs::UINT32 longerSide = std::max(info.width, info.height);
+    bs::UINT32 level      = 0;
+
+    while (level + 1 < info.numLevels && (float)(longerSide >> (level + 1)) >= resolution)
+    {
+      level += 1;
+    }
+
+    return level;
+  }
+
+  bs::UINT64 TextureStreaming::bytesFromLevel(const TextureInfo& info, bs::UINT32 level)
+  {
+    bs::UINT64 bytes = 0;
+
+    for (bs::UINT32 l = level; l < info.numLevels; l++)
+    {
+      bytes += bytesOfLevel(info, l);
+    }
+
+    return bytes;
+  }
+
+  bs::UINT64 TextureStreaming::bytesOfLevel(const TextureInfo& info, bs::UINT32 level)
+  {
+    bs::UINT64 blockSize = info.format == bs::PF_BC1 ? 8 : 16;
+    bs::UINT64 blocksX   = std::max((info.width >> level) / 4, 1u);
+    bs::UINT64 blocksY   = std::max((info.height >> level) / 4, 1u);
+
+    return blocksX * blocksY * blockSize;
+  }
+
+  bool TextureStreaming::readInfo(const FileView& data, TextureInfo& info)
+  {
+    if (data.size() < ZTEX_HEADER_SIZE) return false;
+
+    if (std::memcmp(data.data(), "ZTEX", 4) != 0) return false;
+
+    switch (readUInt32(data, 8))
+    {
+      case ZTEX_DXT1:
+        info.format = bs::PF_BC1;
+        break;
+
+      // Premultiplied alpha is rare enough to not be worth handling differently
+      case ZTEX_DXT2:
+      case ZTEX_DXT3:
+        info.format = bs::PF_BC2;
+        break;
+
+      case ZTEX_DXT4:
+      case ZTEX_DXT5:
+        info.format = bs::PF_BC3;
+        break;
+
+      default:
+        return false;
+    }
+
+    info.width     = readUInt32(data, 12);
+    info.height    = readUInt32(data, 16);
+    info.numLevels = std::max(readUInt32(data, 20), 1u);
+
+    return info.width > 0 && info.height > 0;
+  }
+
+  TextureStreaming& gTextureStreaming()
+  {
+    static TextureStreaming s_instance;
+
+    return s_instance;
+  }
+}  // namespace REGoth
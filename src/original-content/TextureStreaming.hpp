@@ -0,0 +1,199 @@
+#pragma once
+#include <BsPrerequisites.h>
+
+namespace REGoth
+{
+  class FileView;
+
+  /**
+   * Textures are never made smaller than this, in texels along their longer side. Also how
+   * large a texture is at most when it is first seen.
+   */
+  constexpr bs::UINT32 TEXTURE_STREAMING_MIN_RESOLUTION = 64;
+
+  /** Seconds between two checks of which textures are needed at which resolution */
+  constexpr float TEXTURE_STREAMING_CHECK_INTERVAL = 0.5f;
+
+  /**
+   * A texture is kept at the resolution it was needed at for this many checks after it was
+   * needed last, so it doesn't shrink and grow again when turning the camera around.
+   */
+  constexpr bs::UINT32 TEXTURE_STREAMING_KEEP_CHECKS = 6;
+
+  /** Bytes uploaded to the GPU per check at most, so streaming doesn't make the game hitch */
+  constexpr bs::UINT64 TEXTURE_STREAMING_UPLOAD_PER_CHECK = 32 * 1024 * 1024;
+
+  /** Bytes the streamed textures may take on the GPU, unless set otherwise */
+  constexpr bs::UINT64 TEXTURE_STREAMING_DEFAULT_BUDGET = 512ull * 1024 * 1024;
+
+  /**
+   * Keeps the textures of the meshes in the scene block-compressed, at the resolution they
+   * are seen at.
+   *
+   * The original game ships most of its textures as DXT compressed ZTEX files (`-C.TEX`),
+   * which already contain all mip levels. BsZenLib decompresses those when importing. For
+   * every texture used by a renderable in the scene, this loads the compressed data from the
+   * ZTEX file instead and puts it into the texture's resource handle, so all materials using
+   * the texture pick it up. Textures stored uncompressed in the original files are left alone.
+   *
+   * A few times per second, the renderables in the scene are checked against the main
+   * camera: The closer and larger one is on screen, the more mip levels its textures need.
+   * Textures get the levels they need, as long as all streamed textures fit into the budget
+   * set via setBudget(). Otherwise all textures lose levels until they do. Textures not
+   * needed anymore shrink down to the smallest size.
+   *
+   * Only the resource handles loaded right now are changed, nothing is written to the cache.
+   * Loading a texture from the cache again gives the decompressed one, which is then streamed
+   * again on the next check.
+   */
+  class TextureStreaming
+  {
+  public:
+    /**
+     * Checks which textures are needed at which resolution and loads or drops mip levels
+     * accordingly. Only does anything every TEXTURE_STREAMING_CHECK_INTERVAL seconds, so it
+     * can be called every update.
+     */
+    void update();
+
+    /**
+     * Sets how many bytes the streamed textures may take on the GPU. Lowering it shrinks
+     * textures on the next check.
+     */
+    void setBudget(bs::UINT64 bytes)
+    {
+      mBudget = bytes;
+    }
+
+    bs::UINT64 budget() const
+    {
+      return mBudget;
+    }
+
+    /**
+     * @return Bytes taken up on the GPU by the streamed textures right now.
+     */
+    bs::UINT64 residentBytes() const;
+
+    /**
+     * @return Number of textures being streamed.
+     */
+    bs::UINT32 numStreamedTextures() const
+    {
+      return (bs::UINT32)mTextures.size();
+    }
+
+    /**
+     * Forgets about all streamed textures. They keep the mip levels they have right now.
+     */
+    void clear();
+
+  private:
+    /**
+     * Header of a ZTEX file.
+     */
+    struct TextureInfo
+    {
+      bs::PixelFormat format = bs::PF_UNKNOWN;
+      bs::UINT32 width       = 0;
+      bs::UINT32 height      = 0;
+      bs::UINT32 numLevels   = 0;
+    };
+
+    struct StreamedTexture
+    {
+      bs::HTexture handle;
+
+      /** Name of the ZTEX file, e.g. `STONE-C.TEX` */
+      bs::String fileName;
+
+      TextureInfo info;
+
+      /** Largest mip level uploaded. numLevels if the texture hasn't been replaced yet. */
+      bs::UINT32 residentLevel = 0;
+
+      /** Largest mip level needed during the last few checks */
+      bs::UINT32 neededLevel = 0;
+
+      /** Checks since the texture was needed at neededLevel */
+      bs::UINT32 checksSinceNeeded = 0;
+
+      /** Largest mip level needed during the current check */
+      bs::UINT32 levelNeededNow = 0;
+
+      bool isNeededNow = false;
+    };
+
+    /**
+     * Goes through the scene and notes for every texture which mip level it needs.
+     */
+    void findNeededLevels(const bs::HSceneObject& so, const bs::Camera& camera,
+                          float pixelsPerRadianAtDistance);
+
+    /**
+     * Notes that the given texture needs to have at least the given resolution.
+     */
+    void requestResolution(const bs::HTexture& texture, float resolution);
+
+    /**
+     * @return The streamed texture for the given handle, or nullptr if it can't be streamed.
+     */
+    StreamedTexture* findOrAdd(const bs::HTexture& texture);
+
+    /**
+     * Picks the mip levels to upload so the budget is kept and replaces the textures whose
+     * level changed.
+     */
+    void applyNeededLevels();
+
+    /**
+     * Replaces the contents of the texture's handle with the given mip level and everything
+     * below it, loaded from the ZTEX file.
+     *
+     * @return Whether that worked.
+     */
+    bool uploadLevel(StreamedTexture& texture, bs::UINT32 level);
+
+    /**
+     * @return Mip level of the given texture with at least the given resolution.
+     */
+    static bs::UINT32 levelForResolution(const TextureInfo& info, float resolution);
+
+    /**
+     * @return Bytes taken up by the given mip level and all smaller ones.
+     */
+    static bs::UINT64 bytesFromLevel(const TextureInfo& info, bs::UINT32 level);
+
+    /**
+     * @return Bytes taken up by the given mip level alone.
+     */
+    static bs::UINT64 bytesOfLevel(const TextureInfo& info, bs::UINT32 level);
+
+    /**
+     * Reads the header of a ZTEX file.
+     *
+     * @return Whether the file is block-compressed in a format which can be streamed.
+     */
+    static bool readInfo(const FileView& data, TextureInfo& info);
+
+    /**
+     * Streamed textures by UUID of their resource.
+     */
+    bs::UnorderedMap<bs::UUID, StreamedTexture> mTextures;
+
+    /**
+     * UUIDs of textures which have no block-compressed ZTEX file, so they aren't looked up
+     * again.
+     */
+    bs::UnorderedSet<bs::UUID> mNotStreamable;
+
+    bs::UINT64 mBudget = TEXTURE_STREAMING_DEFAULT_BUDGET;
+
+    float mTimeOfNextCheck = 0.0f;
+  };
+
+  /**
+   * Global access to the texture streaming.
+   */
+  TextureStreaming& gTextureStreaming();
+}  // namespace REGoth
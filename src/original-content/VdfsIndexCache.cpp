@@ -0,0 +1,118 @@
+#include "VdfsIndexCache.hpp"
+#include "MappedPackage.hpp"
+#include <FileSystem/BsFileSystem.h>
+#include <RTTI/RTTI_VdfsIndexCache.hpp>
+#include <Serialization/BsFileSerializer.h>
+#include <log/logging.hpp>
+
+namespace REGoth
+{
+  constexpr bs::UINT32 VdfsIndexCache::VERSION;
+
+  bs::SPtr<CachedPackageIndex> CachedPackageIndex::describe(const MappedPackage& package)
+  {
+    auto index          = bs::bs_shared_ptr_new<CachedPackageIndex>();
+    index->path         = package.path().toString();
+    index->fileSize     = bs::FileSystem::getFileSize(package.path());
+    index->modifiedTime = (bs::UINT64)bs::FileSystem::getLastModifiedTime(package.path());
+    index->timestamp    = package.timestamp();
+
+    index->names.reserve(package.entries().size());
+    index->offsets.reserve(package.entries().size());
+    index->sizes.reserve(package.entries().size());
+
+    for (const auto& entry : package.entries())
+    {
+      index->names.push_back(entry.first);
+      index->offsets.push_back(entry.second.offset);
+      index->sizes.push_back(entry.second.size);
+    }
+
+    return index;
+  }
+
+  bool CachedPackageIndex::isUpToDate() const
+  {
+    bs::Path file = path;
+
+    if (!bs::FileSystem::isFile(file)) return false;
+
+    return bs::FileSystem::getFileSize(file) == fileSize &&
+           (bs::UINT64)bs::FileSystem::getLastModifiedTime(file) == modifiedTime;
+  }
+
+  bs::SPtr<MappedPackage> CachedPackageIndex::open() const
+  {
+    if (names.size() != offsets.size() || names.size() != sizes.size()) return nullptr;
+
+    bs::UnorderedMap<bs::String, MappedPackage::Entry> entries;
+    entries.reserve(names.size());
+
+    for (size_t i = 0; i < names.size(); i++)
+    {
+      MappedPackage::Entry entry;
+      entry.offset = offsets[i];
+      entry.size   = sizes[i];
+
+      entries[names[i]] = entry;
+    }
+
+    return MappedPackage::open(path, timestamp, entries);
+  }
+
+  bs::SPtr<VdfsIndexCache> VdfsIndexCache::load(const bs::Path& path)
+  {
+    if (!bs::FileSystem::exists(path)) return nullptr;
+
+    bs::SPtr<bs::IReflectable> decoded;
+
+    try
+    {
+      bs::FileDecoder decoder(path);
+      decoded = decoder.decode();
+    }
+    catch (const std::exception& e)
+    {
+      REGOTH_LOG(Warning, VDFS, "[VdfsIndexCache] Failed to read {0}: {1}",
+                 path.toString(), e.what());
+      return nullptr;
+    }
+
+    if (!decoded || !bs::rtti_is_of_type<VdfsIndexCache>(decoded.get()))
+    {
+      REGOTH_LOG(Warning, VDFS, "[VdfsIndexCache] {0} is not a VDFS index cache",
+                 path.toString());
+      return nullptr;
+    }
+
+    auto cache = std::static_pointer_cast<VdfsIndexCache>(decoded);
+
+    if (cache->version != VERSION) return nullptr;
+
+    return cache;
+  }
+
+  void VdfsIndexCache::save(const bs::Path& path) const
+  {
+    bs::FileEncoder encoder(path);
+    encoder.encode(const_cast<VdfsIndexCache*>(this));
+  }
+
+  bs::SPtr<CachedPackageIndex> VdfsIndexCache::find(const bs::Path& package) const
+  {
+    bs::String key = package.toString();
+
+    for (const auto& p : packages)
+    {
+      if (p && p->path == key)
+      {
+        return p->isUpToDate() ? p : nullptr;
+      }
+    }
+
+    return nullptr;
+  }
+
+  REGOTH_DEFINE_RTTI(CachedPackageIndex)
+  REGOTH_DEFINE_RTTI(VdfsIndexCache)
+}  // namespace REGoth
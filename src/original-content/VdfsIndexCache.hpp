@@ -0,0 +1,104 @@
+/** \file
+ */
+
+#pragma once
+
+#include <BsPrerequisites.h>
+#include <RTTI/RTTIUtil.hpp>
+#include <Reflection/BsIReflectable.h>
+
+namespace REGoth
+{
+  class MappedPackage;
+
+  /**
+   * Directory of a single package, as stored inside the VdfsIndexCache.
+   */
+  class CachedPackageIndex : public bs::IReflectable
+  {
+  public:
+    CachedPackageIndex() = default;
+
+    /**
+     * Describes the directory of the given mapped package.
+     */
+    static bs::SPtr<CachedPackageIndex> describe(const MappedPackage& package);
+
+    /**
+     * @return Whether the package file on disk still looks like when it was described.
+     */
+    bool isUpToDate() const;
+
+    /**
+     * Maps the package, using the cached directory.
+     *
+     * @return The mapped package. nullptr if that didn't work.
+     */
+    bs::SPtr<MappedPackage> open() const;
+
+    bs::String path;
+
+    /**
+     * Size and time of last modification of the package file. If either changed, the
+     * directory has to be read again.
+     */
+    bs::UINT64 fileSize     = 0;
+    bs::UINT64 modifiedTime = 0;
+
+    /**
+     * Timestamp stored inside the package, see MappedPackage::timestamp().
+     */
+    bs::UINT32 timestamp = 0;
+
+    /**
+     * The files inside the package, one entry per file in each array.
+     */
+    bs::Vector<bs::String> names;
+    bs::Vector<bs::UINT32> offsets;
+    bs::Vector<bs::UINT32> sizes;
+
+    REGOTH_DECLARE_RTTI_FOR_REFLECTABLE(CachedPackageIndex)
+  };
+
+  /**
+   * Directories of the VDF packages read on an earlier run, see
+   * VirtualFileSystem::loadPackages().
+   *
+   * Reading the directory of a package means touching the start of every package file on
+   * startup, which can take a while on slow disks or if the game is on a network drive.
+   * Packages are recognized by their path, size and time of last modification, so a package
+   * which has been modified or replaced has its directory read again.
+   */
+  class VdfsIndexCache : public bs::IReflectable
+  {
+  public:
+    /**
+     * Version of the cache format. Caches saved with another version are not used.
+     */
+    static constexpr bs::UINT32 VERSION = 1;
+
+    VdfsIndexCache() = default;
+
+    /**
+     * @return The cache saved at the given path. Empty if there is none or it can't be read.
+     */
+    static bs::SPtr<VdfsIndexCache> load(const bs::Path& path);
+
+    void save(const bs::Path& path) const;
+
+    /**
+     * @return The cached directory of the package at the given path, if it is still up to
+     *         date. nullptr otherwise.
+     */
+    bs::SPtr<CachedPackageIndex> find(const bs::Path& package) const;
+
+    /**
+     * Format version the cache has been saved with.
+     */
+    bs::UINT32 version = VERSION;
+
+    bs::Vector<bs::SPtr<CachedPackageIndex>> packages;
+
+    REGOTH_DECLARE_RTTI_FOR_REFLECTABLE(VdfsIndexCache)
+  };
+}  // namespace REGoth
@@ -1,8 +1,15 @@
 #include "VirtualFileSystem.hpp"
+#include "MappedPackage.hpp"
+#include "VdfsIndexCache.hpp"
 #include <FileSystem/BsFileSystem.h>
+#include <Threading/BsTaskScheduler.h>
+#include <Threading/BsThreading.h>
+#include <core/Profiling.hpp>
 #include <exception/Throw.hpp>
 #include <log/logging.hpp>
 #include <vdfs/fileIndex.h>
+#include <algorithm>
+#include <chrono>
 
 using namespace REGoth;
 
@@ -15,6 +22,102 @@ public:
   VDFS::FileIndex fileIndex;
   bool isFinalized = false;
 
+  /**
+   * A file inside one of the mapped packages.
+   */
+  struct MappedFile
+  {
+    const MappedPackage* package;
+    MappedPackage::Entry entry;
+  };
+
+  bs::Vector<bs::SPtr<MappedPackage>> mappedPackages;
+
+  /**
+   * Files inside the mapped packages by UPPERCASE name. Only holds the file from the newest
+   * package if the file is inside multiple ones.
+   */
+  bs::UnorderedMap<bs::String, MappedFile> mappedFiles;
+
+  /**
+   * UPPERCASE names of the files inside mounted directories. These are not viewed from the
+   * packages, even if they are inside one.
+   */
+  bs::UnorderedSet<bs::String> filesInDirectories;
+
+  /**
+   * Adds the files of the given mapped package to mappedFiles. Packages with the same
+   * timestamp override the ones added before them.
+   */
+  void addMappedPackage(const bs::SPtr<MappedPackage>& package)
+  {
+    for (const auto& entry : package->entries())
+    {
+      auto it = mappedFiles.find(entry.first);
+
+      if (it == mappedFiles.end() || it->second.package->timestamp() <= package->timestamp())
+      {
+        mappedFiles[entry.first] = MappedFile{package.get(), entry.second};
+      }
+    }
+
+    mappedPackages.push_back(package);
+  }
+
+  /**
+   * All known files, UPPERCASE. Only filled once the file index has been finalized, as are
+   * knownFiles and filesByExtension.
+   */
+  bs::Vector<bs::String> allFiles;
+
+  /**
+   * Same as allFiles, to look up whether a file exists.
+   */
+  bs::UnorderedSet<bs::String> knownFiles;
+
+  /**
+   * All known files by their UPPERCASE extension with leading dot, e.g. `.3DS`. Files
+   * without an extension are found under an empty one.
+   */
+  bs::UnorderedMap<bs::String, bs::Vector<bs::String>> filesByExtension;
+
+  /**
+   * Files in the order they were first read, see VirtualFileSystem::setFileTraceEnabled().
+   * Files may be read from any thread, so this is guarded by traceMutex.
+   */
+  bool isTracing = false;
+  bs::Vector<bs::String> trace;
+  bs::UnorderedSet<bs::String> tracedFiles;
+  bs::Mutex traceMutex;
+
+  /**
+   * Adds the file with the given UPPERCASE name to the trace, if it hasn't been read before.
+   */
+  void traceRead(const bs::String& upper)
+  {
+    if (!isTracing) return;
+
+    bs::Lock lock(traceMutex);
+
+    if (tracedFiles.insert(upper).second)
+    {
+      trace.push_back(upper);
+    }
+  }
+
+  /**
+   * @return The file inside the mapped packages with the given UPPERCASE name, nullptr if
+   *         the file has to be read through the file index.
+   */
+  const MappedFile* findMappedFile(const bs::String& upper) const
+  {
+    if (filesInDirectories.find(upper) != filesInDirectories.end()) return nullptr;
+
+    auto it = mappedFiles.find(upper);
+
+    return it != mappedFiles.end() ? &it->second : nullptr;
+  }
+
   bool isReadyToReadFiles()
   {
     if (!isFinalized)
@@ -31,6 +134,56 @@ public:
   {
     fileIndex.finalizeLoad();
     isFinalized = true;
+
+    indexKnownFiles();
+  }
+
+  /**
+   * Fills allFiles, knownFiles and filesByExtension from the finalized file index, so
+   * listing and looking up files doesn't need to convert the names every time.
+   */
+  void indexKnownFiles()
+  {
+    std::vector<std::string> allStl = fileIndex.getKnownFiles();
+
+    allFiles.clear();
+    allFiles.reserve(allStl.size());
+    knownFiles.reserve(allStl.size());
+
+    for (const std::string& stlName : allStl)
+    {
+      // Internal file index will return the files in the casing they were stored in.
+      // To be consistent, convert them all to uppercase here.
+      bs::String name = toUpper(stlName.c_str());
+
+      // The same file may be known from a package and a directory
+      if (!knownFiles.insert(name).second) continue;
+
+      size_t dot           = name.find_last_of('.');
+      bs::String extension = dot != bs::String::npos ? name.substr(dot) : bs::String();
+
+      filesByExtension[extension].push_back(name);
+      allFiles.push_back(std::move(name));
+    }
+  }
+
+  /**
+   * Makes sure the file index has been finalized, so files can be read and looked up.
+   */
+  void finalizeIfNeeded()
+  {
+    if (!isFinalized)
+    {
+      finalizeFileIndex();
+    }
+  }
+
+  static bs::String toUpper(const bs::String& s)
+  {
+    bs::String upper = s;
+    bs::StringUtil::toUpperCase(upper);
+
+    return upper;
   }
 };
 
@@ -50,13 +203,25 @@ void VirtualFileSystem::mountDirectory(const bs::Path& path)
     REGOTH_THROW(InvalidStateException, "Cannot mount directories on finalized file index.");
   }
 
-  REGOTH_LOG(Info, Uncategorized, "[VDFS] Mounting directory (recursive): {0}", path.toString());
+  auto start = std::chrono::high_resolution_clock::now();
 
-  auto onDirectory = [&](const bs::Path& p) {
-    bs::Path relative = p.getRelative(path);
-    REGOTH_LOG(Info, Uncategorized, "[VDFS]  - {0}", relative.toString());
+  bs::UINT32 numDirectories = 0;
+  bs::UINT32 numFiles       = 0;
 
+  auto onDirectory = [&](const bs::Path& p) {
     mInternal->fileIndex.mountFolder(p.toString().c_str());
+    numDirectories += 1;
+
+    return true;
+  };
+
+  // Files inside directories override the ones inside packages
+  auto onFile = [&](const bs::Path& p) {
+    bs::String name = p.getFilename();
+    bs::StringUtil::toUpperCase(name);
+
+    mInternal->filesInDirectories.insert(name);
+    numFiles += 1;
 
     return true;
   };
@@ -67,7 +232,13 @@ void VirtualFileSystem::mountDirectory(const bs::Path& path)
     NonRecursive = false,
   };
 
-  bs::FileSystem::iterate(path, nullptr, onDirectory, Recursive);
+  bs::FileSystem::iterate(path, onFile, onDirectory, Recursive);
+
+  auto end = std::chrono::high_resolution_clock::now();
+
+  REGOTH_LOG(Info, VDFS, "[VDFS] Mounted {0}: {1} directories, {2} files in {3} ms",
+             path.toString(), numDirectories, numFiles,
+             std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count());
 }
 
 bool VirtualFileSystem::loadPackage(const bs::Path& package)
@@ -79,76 +250,289 @@ bool VirtualFileSystem::loadPackage(const bs::Path& package)
     REGOTH_THROW(InvalidStateException, "Cannot load packages on finalized file index.");
   }
 
-  return mInternal->fileIndex.loadVDF(package.toString().c_str());
+  if (!mInternal->fileIndex.loadVDF(package.toString().c_str()))
+  {
+    return false;
+  }
+
+  // Files inside are still read through the file index if this fails
+  if (bs::SPtr<MappedPackage> mapped = MappedPackage::open(package))
+  {
+    mInternal->addMappedPackage(mapped);
+  }
+
+  return true;
 }
 
-bs::Vector<bs::String> VirtualFileSystem::listAllFiles()
+bs::UINT32 VirtualFileSystem::loadPackages(const bs::Vector<bs::Path>& packages,
+                                           const bs::Path& indexCache)
 {
-  std::vector<std::string> allStl = mInternal->fileIndex.getKnownFiles();
-  bs::Vector<bs::String> all(allStl.size());
+  throwOnMissingInternalState();
 
-  for (size_t i = 0; i < allStl.size(); i++)
+  if (mInternal->isFinalized)
   {
-    all[i] = allStl[i].c_str();
+    REGOTH_THROW(InvalidStateException, "Cannot load packages on finalized file index.");
+  }
 
-    // Internal file index will return the files in the casing they were stored in.
-    // To be consistent, convert them all to uppercase here.
-    bs::StringUtil::toUpperCase(all[i]);
+  auto start = std::chrono::high_resolution_clock::now();
+
+  bs::SPtr<VdfsIndexCache> cache;
+  if (!indexCache.isEmpty())
+  {
+    cache = VdfsIndexCache::load(indexCache);
   }
 
-  return all;
-}
+  // Mapping a package and parsing its directory doesn't touch anything shared, so all
+  // packages can be done at once. Each task only writes its own slots.
+  bs::Vector<bs::SPtr<MappedPackage>> mapped(packages.size());
+  bs::Vector<bs::UINT8> isFromCache(packages.size(), 0);
+  bs::Vector<bs::SPtr<bs::Task>> tasks;
+  tasks.reserve(packages.size());
 
-bs::Vector<bs::String> REGoth::VirtualFileSystem::listByExtension(const bs::String& ext)
-{
-  bs::Vector<bs::String> allFilesUpperCase = listAllFiles();
+  for (size_t i = 0; i < packages.size(); i++)
+  {
+    auto task = bs::Task::create("VDFS", [&packages, &mapped, &isFromCache, &cache, i]() {
+      bs::SPtr<CachedPackageIndex> cached = cache ? cache->find(packages[i]) : nullptr;
+
+      if (cached)
+      {
+        mapped[i]      = cached->open();
+        isFromCache[i] = mapped[i] ? 1 : 0;
+      }
+
+      if (!mapped[i])
+      {
+        mapped[i] = MappedPackage::open(packages[i]);
+      }
+    });
+
+    bs::TaskScheduler::instance().addTask(task);
+    tasks.push_back(task);
+  }
 
-  // Convert extension to UPPERCASE since all files returned by listAllFiles() are also
-  // uppercase. That way, we make the extension-parameter case insensitive.
-  bs::String extUpper = ext;
-  bs::StringUtil::toUpperCase(extUpper);
+  // The file index is not thread-safe, so it gets the packages one after another meanwhile
+  bs::UINT32 numLoaded = 0;
+  for (const bs::Path& package : packages)
+  {
+    if (mInternal->fileIndex.loadVDF(package.toString().c_str()))
+    {
+      numLoaded += 1;
+    }
+    else
+    {
+      REGOTH_LOG(Warning, VDFS, "[VDFS] Failed to load package: {0}",
+                 package.toString());
+    }
+  }
 
-  enum
+  for (const auto& task : tasks)
   {
-    RespectCase = false,
-    LowerCase   = true,
-  };
+    task->wait();
+  }
 
-  bs::Vector<bs::String> result;
-  for (const auto& fileName : allFilesUpperCase)
+  // Merge oldest first so newer packages override older ones, ties are broken by the order
+  // the packages were passed in. That way, the result doesn't depend on which task finished
+  // first.
+  bs::Vector<size_t> order;
+  for (size_t i = 0; i < mapped.size(); i++)
   {
-    // Respect case here since our only option is converting everything to lower case
-    // with endsWith(). Since all our input strings are known to be uppercase, we can
-    // just compare them without changing cases.
-    if (bs::StringUtil::endsWith(fileName, extUpper, RespectCase))
+    if (mapped[i]) order.push_back(i);
+  }
+
+  std::stable_sort(order.begin(), order.end(), [&mapped](size_t a, size_t b) {
+    return mapped[a]->timestamp() < mapped[b]->timestamp();
+  });
+
+  size_t numFiles     = 0;
+  size_t numFromCache = 0;
+  for (size_t i : order)
+  {
+    mInternal->addMappedPackage(mapped[i]);
+    numFiles += mapped[i]->entries().size();
+    numFromCache += isFromCache[i];
+  }
+
+  // Also drops packages which are gone, so the cache doesn't grow forever
+  if (!indexCache.isEmpty() && numFromCache != order.size())
+  {
+    VdfsIndexCache updated;
+
+    for (size_t i : order)
     {
-      result.push_back(fileName);
+      updated.packages.push_back(CachedPackageIndex::describe(*mapped[i]));
     }
+
+    updated.save(indexCache);
   }
 
-  return result;
+  auto end = std::chrono::high_resolution_clock::now();
+
+  REGOTH_LOG(Info, VDFS,
+             "[VDFS] Indexed {0} of {1} packages ({2} mapped, {3} from cache, {4} files) in {5} ms",
+             numLoaded, packages.size(), order.size(), numFromCache, numFiles,
+             std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count());
+
+  return numLoaded;
 }
 
-bs::Vector<bs::UINT8> VirtualFileSystem::readFile(const bs::String& file) const
+const bs::Vector<bs::String>& VirtualFileSystem::listAllFiles()
 {
   throwOnMissingInternalState();
 
-  if (!mInternal->isFinalized)
+  mInternal->finalizeIfNeeded();
+
+  return mInternal->allFiles;
+}
+
+const bs::Vector<bs::String>& VirtualFileSystem::listByExtension(const bs::String& ext)
+{
+  throwOnMissingInternalState();
+
+  mInternal->finalizeIfNeeded();
+
+  // Extensions are kept in UPPERCASE, so the extension-parameter is case insensitive
+  auto it = mInternal->filesByExtension.find(InternalVirtualFileSystem::toUpper(ext));
+
+  if (it == mInternal->filesByExtension.end())
   {
-    mInternal->finalizeFileIndex();
+    static const bs::Vector<bs::String> none;
+    return none;
   }
 
+  return it->second;
+}
+
+bs::Vector<bs::UINT8> VirtualFileSystem::readFile(const bs::String& file) const
+{
+  std::vector<bs::UINT8> stlData;
+
+  readFile(file, stlData);
+
+  return bs::Vector<bs::UINT8>(stlData.begin(), stlData.end());
+}
+
+bool VirtualFileSystem::readFile(const bs::String& file, std::vector<bs::UINT8>& data) const
+{
+  REGOTH_PROFILE_SCOPE("VDFS::readFile");
+
+  throwOnMissingInternalState();
+
+  mInternal->finalizeIfNeeded();
+
   if (!mInternal->isReadyToReadFiles())
   {
     REGOTH_THROW(InvalidStateException, "VDFS is not ready to read files yet.");
   }
 
-  std::vector<uint8_t> stlData;
+  data.clear();
 
-  mInternal->fileIndex.getFileData(file.c_str(), stlData);
+  bs::String upper = InternalVirtualFileSystem::toUpper(file);
 
-  // FIXME: Need some other way to get the file data so we don't have to copy the data here
-  return bs::Vector<bs::UINT8>(stlData.begin(), stlData.end());
+  // Saves asking the file index about files which don't exist
+  if (mInternal->knownFiles.find(upper) == mInternal->knownFiles.end()) return false;
+
+  mInternal->traceRead(upper);
+
+  if (const auto* mapped = mInternal->findMappedFile(upper))
+  {
+    const bs::UINT8* begin = mapped->package->data(mapped->entry);
+    data.assign(begin, begin + mapped->entry.size);
+
+    return true;
+  }
+
+  return mInternal->fileIndex.getFileData(file.c_str(), data);
+}
+
+FileView VirtualFileSystem::viewFile(const bs::String& file) const
+{
+  REGOTH_PROFILE_SCOPE("VDFS::viewFile");
+
+  throwOnMissingInternalState();
+
+  mInternal->finalizeIfNeeded();
+
+  bs::String upper = InternalVirtualFileSystem::toUpper(file);
+
+  if (const auto* mapped = mInternal->findMappedFile(upper))
+  {
+    mInternal->traceRead(upper);
+
+    return FileView(mapped->package->data(mapped->entry), mapped->entry.size);
+  }
+
+  std::vector<bs::UINT8> data;
+  readFile(file, data);
+
+  return FileView(std::move(data));
+}
+
+bs::UINT64 VirtualFileSystem::prefetch(const bs::Vector<bs::String>& files) const
+{
+  using MappedFile = InternalVirtualFileSystem::MappedFile;
+
+  throwOnMissingInternalState();
+
+  mInternal->finalizeIfNeeded();
+
+  bs::Vector<const MappedFile*> mapped;
+  mapped.reserve(files.size());
+
+  for (const bs::String& file : files)
+  {
+    if (const auto* m = mInternal->findMappedFile(InternalVirtualFileSystem::toUpper(file)))
+    {
+      mapped.push_back(m);
+    }
+  }
+
+  // Going through each package front to back lets neighbouring files be merged into a
+  // single range and keeps the disk from seeking back and forth
+  std::sort(mapped.begin(), mapped.end(), [](const MappedFile* a, const MappedFile* b) {
+    if (a->package != b->package) return a->package < b->package;
+
+    return a->entry.offset < b->entry.offset;
+  });
+
+  bs::UINT64 numBytes = 0;
+
+  for (size_t i = 0; i < mapped.size();)
+  {
+    const MappedPackage* package = mapped[i]->package;
+    bs::UINT64 start             = mapped[i]->entry.offset;
+    bs::UINT64 end               = start + mapped[i]->entry.size;
+
+    // Also merges the same file passed in twice
+    for (i++; i < mapped.size() && mapped[i]->package == package; i++)
+    {
+      bs::UINT64 nextStart = mapped[i]->entry.offset;
+
+      if (nextStart > end) break;
+
+      end = std::max<bs::UINT64>(end, nextStart + mapped[i]->entry.size);
+    }
+
+    package->prefetch(start, end - start);
+    numBytes += end - start;
+  }
+
+  return numBytes;
+}
+
+void VirtualFileSystem::setFileTraceEnabled(bool enabled)
+{
+  throwOnMissingInternalState();
+
+  mInternal->isTracing = enabled;
+}
+
+bs::Vector<bs::String> VirtualFileSystem::fileTrace() const
+{
+  throwOnMissingInternalState();
+
+  bs::Lock lock(mInternal->traceMutex);
+
+  return mInternal->trace;
 }
 
 bool REGoth::VirtualFileSystem::hasFile(const bs::String& file) const
@@ -159,7 +543,15 @@ bool REGoth::VirtualFileSystem::hasFile(const bs::String& file) const
                  "VDFS internal state not available, call setPathToEngineExecutable()");
   }
 
-  return mInternal->fileIndex.hasFile(file.c_str());
+  // Before finalizing, packages may still be added, so the file index has to be asked
+  if (!mInternal->isFinalized)
+  {
+    return mInternal->fileIndex.hasFile(file.c_str());
+  }
+
+  const auto& knownFiles = mInternal->knownFiles;
+
+  return knownFiles.find(InternalVirtualFileSystem::toUpper(file)) != knownFiles.end();
 }
 
 void REGoth::VirtualFileSystem::throwIfFileIsMissing(const bs::String& file,
@@ -191,10 +583,7 @@ const VDFS::FileIndex& VirtualFileSystem::getFileIndex()
 {
   throwOnMissingInternalState();
 
-  if (!mInternal->isFinalized)
-  {
-    mInternal->finalizeFileIndex();
-  }
+  mInternal->finalizeIfNeeded();
 
   return mInternal->fileIndex;
 }
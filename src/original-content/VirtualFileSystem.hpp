@@ -10,6 +10,9 @@
  * To get the data of a file, the FileIndex can be queried. It will resolve where the
  * real file is and load the data from it.
  *
+ * Packages are also mapped into memory, see MappedPackage. Files inside them can be viewed
+ * right inside the mapping using viewFile(), without reading or copying them.
+ *
  * See BsZenLib or ZenLib for more information.
  *
  *
@@ -23,6 +26,10 @@
  * To simplify things in REGoth, the directory structure is not preserved inside our
  * implementation of the VDFS. All files gathered into a single list.
  *
+ * If a file is inside multiple packages, the one from the package with the newest timestamp
+ * is viewed, as Gothic does it. Files inside mounted directories are always read through the
+ * FileIndex.
+ *
  *
  * # Design decisions
  *
@@ -37,6 +44,7 @@
 
 #include <BsPrerequisites.h>
 #include <FileSystem/BsPath.h>
+#include <core/MemoryAccounting.hpp>
 
 namespace VDFS
 {
@@ -45,6 +53,109 @@ namespace VDFS
 
 namespace REGoth
 {
+  /**
+   * Read-only contents of a file inside the VDFS, see VirtualFileSystem::viewFile().
+   *
+   * Usually points right into a memory-mapped package. Files which are not inside one are read
+   * into a buffer owned by the view instead. Either way, the data stays valid for as long as
+   * the view is alive. Views can only be moved, not copied.
+   */
+  class FileView
+  {
+  public:
+    FileView() = default;
+
+    FileView(const bs::UINT8* data, size_t size)
+        : mData{data}
+        , mSize{size}
+    {
+    }
+
+    explicit FileView(std::vector<bs::UINT8>&& owned)
+        : mOwned{std::move(owned)}
+        , mData{mOwned.data()}
+        , mSize{mOwned.size()}
+    {
+      if (mOwned.capacity() > 0)
+      {
+        gMemoryAccounting().track(MemoryTag::VDFS, mOwned.capacity());
+      }
+    }
+
+    ~FileView()
+    {
+      releaseOwned();
+    }
+
+    // Moving a vector keeps its memory, so mData stays valid. The moved-from vector is left
+    // empty, so only the view holding the buffer untracks it.
+    FileView(FileView&&) = default;
+
+    FileView& operator=(FileView&& other)
+    {
+      if (this == &other) return *this;
+
+      releaseOwned();
+
+      mOwned = std::move(other.mOwned);
+      mData  = other.mData;
+      mSize  = other.mSize;
+
+      return *this;
+    }
+
+    FileView(const FileView&) = delete;
+    FileView& operator=(const FileView&) = delete;
+
+    const bs::UINT8* data() const
+    {
+      return mData;
+    }
+
+    size_t size() const
+    {
+      return mSize;
+    }
+
+    bool empty() const
+    {
+      return mSize == 0;
+    }
+
+    const bs::UINT8* begin() const
+    {
+      return mData;
+    }
+
+    const bs::UINT8* end() const
+    {
+      return mData + mSize;
+    }
+
+    /**
+     * @return Whether the data points into a memory-mapped package.
+     */
+    bool isMapped() const
+    {
+      return mOwned.empty() && mSize > 0;
+    }
+
+  private:
+    void releaseOwned()
+    {
+      if (mOwned.capacity() == 0) return;
+
+      gMemoryAccounting().untrack(MemoryTag::VDFS, mOwned.capacity());
+
+      mOwned.clear();
+      mOwned.shrink_to_fit();
+    }
+
+    std::vector<bs::UINT8> mOwned;
+    const bs::UINT8* mData = nullptr;
+    size_t mSize           = 0;
+  };
+
   class InternalVirtualFileSystem;
   class VirtualFileSystem
   {
@@ -77,6 +188,26 @@ namespace REGoth
      */
     bool loadPackage(const bs::Path& package);
 
+    /**
+     * Loads many packages into the global file index, like loadPackage() does for a single
+     * one.
+     *
+     * The packages are mapped and their directories are read in parallel. If a file is inside
+     * multiple packages, the one from the newest package is used no matter the order the
+     * packages are passed in. Only a single summary line is logged.
+     *
+     * If a path to an index cache is given, the directories of packages which haven't changed
+     * since the last run are taken from there instead of reading them again, see
+     * VdfsIndexCache. The cache is updated if any package had to be read.
+     *
+     * @param  packages    Paths of the packages to load.
+     * @param  indexCache  (Optional) Where to keep the directories of the packages.
+     *
+     * @return Number of packages which could be loaded.
+     */
+    bs::UINT32 loadPackages(const bs::Vector<bs::Path>& packages,
+                            const bs::Path& indexCache = bs::Path::BLANK);
+
     /**
      * Mounts the directory at the given path.
      *
@@ -96,9 +227,12 @@ namespace REGoth
      * This will go through all packages and assemble a list containing all
      * known files names which one could read using readFile().
      *
+     * The list is built once when the file index is finalized, which this does if it hasn't
+     * happened yet.
+     *
      * @return Names of all files known to the index, all UPPERCASE.
      */
-    bs::Vector<bs::String> listAllFiles();
+    const bs::Vector<bs::String>& listAllFiles();
 
     /**
      * Returns a list of files with the given file extension.
@@ -106,9 +240,12 @@ namespace REGoth
      * @param  ext  File extension to look for, with leading dot. E.g. `.3DS`,
      *              case insensitive.
      *
+     * The files are sorted by extension once when the file index is finalized, see
+     * listAllFiles().
+     *
      * @return Names of all files with the given file extension, all UPPERCASE.
      */
-    bs::Vector<bs::String> listByExtension(const bs::String& ext);
+    const bs::Vector<bs::String>& listByExtension(const bs::String& ext);
 
 
     /**
@@ -125,6 +262,58 @@ namespace REGoth
      */
     bs::Vector<bs::UINT8> readFile(const bs::String& file) const;
 
+    /**
+     * Reads the contents of a file into the given buffer.
+     *
+     * Unlike the readFile() returning a bs::Vector, the data is not copied after reading it,
+     * since the file index reads into a buffer of exactly this type. The memory already held
+     * by the buffer is reused, so the same buffer can be passed for reading many files.
+     *
+     * @param  file  Case-insensitive name of the file, see readFile().
+     * @param  data  Buffer to replace the contents of. Empty if the file does not exist.
+     *
+     * @return Whether the file could be read.
+     */
+    bool readFile(const bs::String& file, std::vector<bs::UINT8>& data) const;
+
+    /**
+     * Gives access to the contents of a file without copying them, if possible.
+     *
+     * Files inside a package point right into the memory-mapped package. Everything else
+     * is read into a buffer kept by the returned view.
+     *
+     * @param  file  Case-insensitive name of the file, see readFile().
+     *
+     * @return View of the file's contents. Empty if the file does not exist.
+     */
+    FileView viewFile(const bs::String& file) const;
+
+    /**
+     * Hints that the given files are going to be read soon.
+     *
+     * The OS is asked to load the files inside mapped packages into memory in the background,
+     * ordered by where they are inside their package, so reading them later doesn't have to
+     * wait for the disk. Returns right away. Files which don't exist or are not inside a
+     * mapped package are skipped.
+     *
+     * @param  files  Case-insensitive names of the files, see readFile().
+     *
+     * @return Number of bytes hinted to be read.
+     */
+    bs::UINT64 prefetch(const bs::Vector<bs::String>& files) const;
+
+    /**
+     * Sets whether to remember which files are read, see fileTrace(). Off by default.
+     */
+    void setFileTraceEnabled(bool enabled);
+
+    /**
+     * @return UPPERCASE names of the files read via readFile() or viewFile() while the trace
+     *         was enabled, in the order they were first read. Files read by other modules
+     *         through getFileIndex() are not part of it.
+     */
+    bs::Vector<bs::String> fileTrace() const;
+
     /**
      * Searches through the file index to see if the given file has been registered
      * inside the file index.
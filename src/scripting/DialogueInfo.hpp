@@ -0,0 +1,134 @@
+#pragma once
+#include "ScriptTypes.hpp"
+#include "SvmTable.hpp"
+#include <BsPrerequisites.h>
+
+namespace REGoth
+{
+  namespace Scripting
+  {
+    /**
+     * Dense index of a DialogueInfo among the infos of all NPCs. Stays the same as long as the
+     * same script files are used. See DaedalusVMForGameWorld::dialogueInfoIndex().
+     */
+    typedef bs::UINT32 DialogueInfoIndex;
+
+    enum : DialogueInfoIndex
+    {
+      DIALOGUE_INFO_INDEX_INVALID = UINT32_MAX
+    };
+
+    /**
+     * Native version if the `C_INFO` script class for efficiency, see StoryInformation.
+     *
+     * There is only one of these per *Information*-Instance, kept by the script VM. See
+     * DaedalusVMForGameWorld::dialogueInfosOfNpc().
+     */
+    struct DialogueInfo
+    {
+      /**
+       * Instance name of this info
+       */
+      bs::String name;
+
+      /**
+       * Where this info is inside the dialogue infos of all NPCs.
+       */
+      DialogueInfoIndex index;
+
+      /**
+       * Called `nr` in the original script files. This defines the order the dialogue lines
+       * should be displayed in the UI. However, sometimes those numbers are not unique, some are
+       * missing, so `priority` is the better name here. Low numbers mean higher priority.
+       */
+      bs::UINT32 priority;
+
+      /**
+       * Script function to execute to check whether this information should be avaialble to the
+       * user in the UI. If this returns 0, it should not be shown.
+       */
+      SymbolIndex conditionFunction;
+
+      /**
+       * Script function to execute once the user has chosen this dialogue line. This usually
+       * does the back-and-forth conversation.
+       */
+      SymbolIndex informationFunction;
+
+      /**
+       * Whether this information should disapper once you talked about it once.
+       */
+      bool isPermanent;
+
+      /**
+       * If true, the NPC should start talking to the hero as soon as the hero comes into range.
+       * This is often used for guards who are supposed to stop the player from entering
+       * certain locations.
+       */
+      bool isImportant;
+
+      /**
+       * If true, this information will open the trade window.
+       */
+      bool isTrade;
+
+      /**
+       * The text to display to the user in the UI. Called `description` inside scripts.
+       */
+      bs::String choiceText;
+    };
+
+    /**
+     * What an information function says, found without running it. See
+     * DaedalusVMForGameWorld::dialogueOutputsOf().
+     */
+    struct DialogueOutputs
+    {
+      /**
+       * Lines passed to `AI_Output`, e.g. `DIA_ADDON_GREG_HELLO_01_00`. Sorted, no duplicates.
+       */
+      bs::Vector<bs::String> outputNames;
+
+      /**
+       * SVMs passed to `AI_OutputSVM`. Which line those are depends on the voice of whoever
+       * says them, see SvmTable. Sorted, no duplicates.
+       */
+      bs::Vector<SvmKey> svmKeys;
+    };
+
+    /**
+     * View onto the dialogue infos of a single NPC, owned by the script VM. Only valid as long
+     * as the VM doesn't rebuild its infos, see DaedalusVMForGameWorld::dialogueInfosVersion().
+     */
+    struct DialogueInfoSpan
+    {
+      const DialogueInfo* first = nullptr;
+      bs::UINT32 count          = 0;
+
+      const DialogueInfo* begin() const
+      {
+        return first;
+      }
+
+      const DialogueInfo* end() const
+      {
+        return first + count;
+      }
+
+      bs::UINT32 size() const
+      {
+        return count;
+      }
+
+      bool empty() const
+      {
+        return count == 0;
+      }
+
+      const DialogueInfo& operator[](bs::UINT32 index) const
+      {
+        return first[index];
+      }
+    };
+  }  // namespace Scripting
+}  // namespace REGoth
@@ -0,0 +1,55 @@
+#pragma once
+#include <BsPrerequisites.h>
+
+namespace REGoth
+{
+  namespace Scripting
+  {
+    /**
+     * Properties of a `C_ITEM` instance which are the same for every item created from it, like
+     * what it looks like or what it is worth.
+     *
+     * Taken from an object created once from the instance and kept by the script VM, so
+     * reading them doesn't need a script object of its own. See
+     * DaedalusVMForGameWorld::itemDefinition().
+     */
+    struct ItemDefinition
+    {
+      /**
+       * Name of the item as shown to the player, e.g. `Apple`.
+       */
+      bs::String name;
+
+      /**
+       * Text shown when the item is focused or looked at in the inventory. Usually the same as
+       * the name.
+       */
+      bs::String description;
+
+      /**
+       * Visual of the item lying in the world or being held, like `ITFO_APPLE.3DS`.
+       */
+      bs::String visual;
+
+      /**
+       * For armors: Body mesh of characters wearing it. Empty otherwise.
+       */
+      bs::String visualChange;
+
+      /**
+       * Price of the item when trading.
+       */
+      bs::INT32 value = 0;
+
+      /**
+       * Category of the item, like `ITEM_KAT_FOOD`.
+       */
+      bs::INT32 mainFlag = 0;
+
+      /**
+       * Further flags of the item, like `ITEM_MULTI`.
+       */
+      bs::INT32 flags = 0;
+    };
+  }  // namespace Scripting
+}  // namespace REGoth
@@ -0,0 +1,79 @@
+#include "ScriptClassLayout.hpp"
+#include "ScriptSymbols.hpp"
+#include <exception/Throw.hpp>
+
+namespace REGoth
+{
+  namespace Scripting
+  {
+    ScriptClassLayout::ScriptClassLayout(const bs::String& className)
+        : mClassName(className)
+    {
+    }
+
+    MemberSlotIndex ScriptClassLayout::addMember(const bs::String& name, SymbolType type,
+                                                 bs::UINT32 count)
+    {
+      MemberGroup& g = group(type);
+
+      if (g.slotsByName.find(name) != g.slotsByName.end())
+      {
+        REGOTH_THROW(InvalidParametersException,
+                     "Class " + mClassName + " already has a member " + name + " of type " +
+                         symbolTypeToString(type));
+      }
+
+      ScriptClassMember member;
+      member.name   = name;
+      member.offset = g.numValues;
+      member.count  = count;
+
+      MemberSlotIndex slot = (MemberSlotIndex)g.members.size();
+
+      g.members.push_back(member);
+      g.slotsByName[name] = slot;
+      g.numValues += count;
+
+      return slot;
+    }
+
+    MemberSlotIndex ScriptClassLayout::findSlot(SymbolType type, const bs::String& name) const
+    {
+      const MemberGroup& g = group(type);
+
+      auto it = g.slotsByName.find(name);
+
+      if (it == g.slotsByName.end()) return MEMBER_SLOT_INVALID;
+
+      return it->second;
+    }
+
+    const ScriptClassLayout::MemberGroup& ScriptClassLayout::group(SymbolType type) const
+    {
+      switch (type)
+      {
+        case SymbolType::Int:
+          return mInts;
+
+        case SymbolType::Float:
+          return mFloats;
+
+        case SymbolType::String:
+          return mStrings;
+
+        case SymbolType::ScriptFunction:
+          return mFunctionPointers;
+
+        default:
+          REGOTH_THROW(InvalidParametersException,
+                       "Unexpected member symbol type: " + symbolTypeToString(type));
+      }
+    }
+
+    ScriptClassLayout::MemberGroup& ScriptClassLayout::group(SymbolType type)
+    {
+      return const_cast<MemberGroup&>(
+          static_cast<const ScriptClassLayout*>(this)->group(type));
+    }
+  }  // namespace Scripting
+}  // namespace REGoth
@@ -0,0 +1,134 @@
+#pragma once
+#include "ScriptTypes.hpp"
+#include <BsPrerequisites.h>
+
+namespace REGoth
+{
+  namespace Scripting
+  {
+    /**
+     * A single member variable of a script class.
+     */
+    struct ScriptClassMember
+    {
+      /**
+       * Name of the member with the class name stripped, e.g. `VALUE` for `C_ITEM.VALUE`.
+       */
+      bs::String name;
+
+      /**
+       * Position of the first value of this member inside the value array of its type.
+       */
+      bs::UINT32 offset = 0;
+
+      /**
+       * Number of values, > 1 for arrays like `C_NPC.ATTRIBUTE`.
+       */
+      bs::UINT32 count = 0;
+    };
+
+    /**
+     * Describes where the member variables of a script class are stored within a script object.
+     *
+     * Script objects do not store their member variables by name. Instead, they hold one flat
+     * array of values per type (int, float, string, function pointer). The layout of a class tells
+     * which part of those arrays belongs to which member. The layout is created once per class
+     * and then shared by all objects of that class.
+     *
+     * Every member gets a *slot*, which is its index within the members of the same type.
+     * Slots are handed out in the order the members are added.
+     */
+    class ScriptClassLayout
+    {
+    public:
+      ScriptClassLayout(const bs::String& className);
+
+      /**
+       * Appends a member variable to the layout.
+       *
+       * Throws if the type is not supported for member variables or if a member of the same
+       * name and type has been added already.
+       *
+       * @param  name   Name of the member without the class name, e.g. `VALUE`.
+       * @param  type   Type of the member. One of Int, Float, String or ScriptFunction.
+       * @param  count  Number of array elements. Function pointers are always 1.
+       *
+       * @return Slot of the new member.
+       */
+      MemberSlotIndex addMember(const bs::String& name, SymbolType type, bs::UINT32 count);
+
+      /**
+       * @return Name of the class this layout describes.
+       */
+      const bs::String& className() const
+      {
+        return mClassName;
+      }
+
+      /**
+       * Looks up the slot of a member by its name.
+       *
+       * @return Slot of the member, MEMBER_SLOT_INVALID if it doesn't exist.
+       */
+      MemberSlotIndex findSlot(SymbolType type, const bs::String& name) const;
+
+      /**
+       * @return All members of the given type, indexed by slot.
+       */
+      const bs::Vector<ScriptClassMember>& members(SymbolType type) const
+      {
+        return group(type).members;
+      }
+
+      /**
+       * @return Total number of values of the given type an object of this class stores.
+       */
+      bs::UINT32 numValues(SymbolType type) const
+      {
+        return group(type).numValues;
+      }
+
+    private:
+      /**
+       * All members of the same type.
+       */
+      struct MemberGroup
+      {
+        bs::Vector<ScriptClassMember> members;
+        bs::UnorderedMap<bs::String, MemberSlotIndex> slotsByName;
+        bs::UINT32 numValues = 0;
+      };
+
+      /**
+       * Returns the group members of the given type are stored in.
+       * Throws if members of that type are not supported.
+       */
+      const MemberGroup& group(SymbolType type) const;
+      MemberGroup& group(SymbolType type);
+
+      bs::String mClassName;
+
+      MemberGroup mInts;
+      MemberGroup mFloats;
+      MemberGroup mStrings;
+      MemberGroup mFunctionPointers;
+    };
+
+    /**
+     * Slot of a member together with the layout it belongs to, so using it on an object of a
+     * different class can be detected. See ScriptObject::intSlot().
+     *
+     * Kept trivial, so it can be stored in unions. Invalid slots have no layout.
+     */
+    struct MemberSlot
+    {
+      const ScriptClassLayout* layout;
+      MemberSlotIndex index;
+
+      bool isValid() const
+      {
+        return layout != nullptr;
+      }
+    };
+  }  // namespace Scripting
+}  // namespace REGoth
@@ -15,6 +15,8 @@ namespace REGoth
     {
       auto classes = Queries::findAllClasses(scriptSymbols);
 
+      mMemberSlotsBySymbol.clear();
+
       for (SymbolIndex parent : classes)
       {
         SymbolClass& classSymbol = scriptSymbols.getSymbol<SymbolClass>(parent);
@@ -28,46 +30,53 @@ namespace REGoth
     }
 
     ScriptObject ScriptClassTemplates::createClassTemplate(const bs::String& className,
-                                                           const bs::Vector<SymbolIndex>& members,
+                                                           SymbolIndexSpan members,
                                                            const ScriptSymbolStorage& scriptSymbols)
     {
-      ScriptObject obj;
-      obj.className = className;
+      auto layout = bs::bs_shared_ptr_new<ScriptClassLayout>(className);
 
       for (SymbolIndex memberSymbolIndex : members)
       {
         SymbolBase& memberSymbol = scriptSymbols.getSymbolBase(memberSymbolIndex);
         bs::String name          = demangleMemberName(memberSymbol.name);
+        bs::UINT32 count;
 
         if (memberSymbol.type == SymbolType::Int)
         {
-          auto num = ((SymbolInt&)memberSymbol).ints.size();
-
-          obj.ints[name].resize(num, 0);
+          count = (bs::UINT32)((SymbolInt&)memberSymbol).ints.size();
         }
         else if (memberSymbol.type == SymbolType::Float)
         {
-          auto num = ((SymbolFloat&)memberSymbol).floats.size();
-
-          obj.floats[name].resize(num, 0.0f);
+          count = (bs::UINT32)((SymbolFloat&)memberSymbol).floats.size();
         }
         else if (memberSymbol.type == SymbolType::String)
         {
-          auto num = ((SymbolString&)memberSymbol).strings.size();
-
-          obj.strings[name].resize(num, "");
+          count = (bs::UINT32)((SymbolString&)memberSymbol).strings.size();
         }
         else if (memberSymbol.type == SymbolType::ScriptFunction)
         {
-          obj.functionPointers[name] = 0;
+          count = 1;
         }
         else
         {
           REGOTH_THROW(InvalidParametersException,
                        "Unexpected member symbol type: " + symbolTypeToString(memberSymbol.type));
         }
+
+        if (memberSymbolIndex >= mMemberSlotsBySymbol.size())
+        {
+          mMemberSlotsBySymbol.resize(memberSymbolIndex + 1, {nullptr, MEMBER_SLOT_INVALID});
+        }
+
+        MemberSlotIndex slot = layout->addMember(name, memberSymbol.type, count);
+
+        mMemberSlotsBySymbol[memberSymbolIndex] = {layout.get(), slot};
       }
 
+      ScriptObject obj;
+      obj.className = className;
+      obj.bindLayout(layout);
+
       return obj;
     }
 
@@ -1,6 +1,7 @@
 #pragma once
 #include <BsPrerequisites.h>
 #include <RTTI/RTTIUtil.hpp>
+#include <scripting/ScriptObject.hpp>
 #include <scripting/ScriptSymbolStorage.hpp>
 
 namespace REGoth
@@ -29,16 +30,17 @@ namespace REGoth
      *
      * # What exactly is a class template?
      *
-     * Our script objects are basically simple key/value-pairs. With a key for each
-     * member variable. The blank script object would have not one single key, but
-     * other code will expect an instance of a class to provide all member variables
-     * of that class!
+     * Our script objects store the values of their member variables inside flat arrays.
+     * Which values belong to which member variable is described by the layout of the
+     * class (see ScriptClassLayout), which is created here from the member symbols.
+     * A blank script object would not have a layout at all, but other code will expect
+     * an instance of a class to provide all member variables of that class!
      *
      * To be able to provide script objects which look like they were created from
-     * a certain class, we gather all member variables of that class and create
-     * keys for them in a script object (With default values). That script object
+     * a certain class, we gather all member variables of that class, build its layout
+     * and bind it to a script object (With default values). That script object
      * will be then used as a template: When someone wants to instanciate a class
-     * the template is copied to the new script object.
+     * the layout of the template is bound to the new script object.
      */
     class ScriptClassTemplates : public bs::IReflectable
     {
@@ -64,12 +66,42 @@ namespace REGoth
        */
       const ScriptObject& getClassTemplate(const bs::String& className) const;
 
+      /**
+       * Returns the layout of the given class. See ScriptClassLayout.
+       *
+       * Throws if the class does not exist.
+       */
+      const bs::SPtr<const ScriptClassLayout>& getClassLayout(const bs::String& className) const
+      {
+        return getClassTemplate(className).layout();
+      }
+
+      /**
+       * Returns the slot of the given member variable symbol, which can be used to access
+       * the members data on a script object without going through its name.
+       * See ScriptObject::intSlot().
+       *
+       * Slots are assigned when the templates are created, so no string operations
+       * are done here. See ScriptClassLayout.
+       *
+       * @param  memberSymbol  Symbol of the member variable, e.g. the one of `C_NPC.ATTRIBUTE`.
+       *
+       * @return Slot of the member, invalid if the symbol is not a member variable.
+       */
+      MemberSlot getMemberSlot(SymbolIndex memberSymbol) const
+      {
+        if (memberSymbol >= mMemberSlotsBySymbol.size()) return {nullptr, MEMBER_SLOT_INVALID};
+
+        return mMemberSlotsBySymbol[memberSymbol];
+      }
+
     private:
       /**
-       * Creates a single script class template. See createClassTemplates().
+       * Creates a single script class template together with the layout of the class.
+       * Also assigns the slots of all members of that class. See createClassTemplates().
        */
       ScriptObject createClassTemplate(const bs::String& className,
-                                       const bs::Vector<SymbolIndex>& members,
+                                       SymbolIndexSpan members,
                                        const ScriptSymbolStorage& scriptSymbols);
 
       /**
@@ -96,6 +128,13 @@ namespace REGoth
        */
       bs::Map<bs::String, ScriptObject> mClassTemplates;
 
+      /**
+       * Slot of every member variable symbol, indexed by SymbolIndex. Symbols which are no
+       * member variables have an invalid slot. Not saved, since createClassTemplates() is run
+       * again after loading.
+       */
+      bs::Vector<MemberSlot> mMemberSlotsBySymbol;
+
     public:
       REGOTH_DECLARE_RTTI_FOR_REFLECTABLE(ScriptClassTemplates)
     };
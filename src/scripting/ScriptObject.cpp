@@ -6,11 +6,138 @@ namespace REGoth
 {
   namespace Scripting
   {
+    /**
+     * Copies the values of every loaded member which also exists in the layout to its place.
+     */
+    template <typename T, typename Values>
+    static void restoreLoadedValues(const bs::Map<bs::String, bs::Vector<T>>& loaded,
+                                    const ScriptClassLayout& layout, SymbolType type,
+                                    Values& values)
+    {
+      const auto& members = layout.members(type);
+
+      for (const auto& v : loaded)
+      {
+        MemberSlotIndex slot = layout.findSlot(type, v.first);
+
+        if (slot == MEMBER_SLOT_INVALID) continue;
+
+        const ScriptClassMember& member = members[slot];
+
+        bs::UINT32 numValues = std::min(member.count, (bs::UINT32)v.second.size());
+
+        for (bs::UINT32 i = 0; i < numValues; i++)
+        {
+          values[member.offset + i] = v.second[i];
+        }
+      }
+    }
+
+    void ScriptObject::bindLayout(bs::SPtr<const ScriptClassLayout> layout)
+    {
+      mLayout = layout;
+
+      mInts.assign(layout->numValues(SymbolType::Int), 0);
+      mFloats.assign(layout->numValues(SymbolType::Float), 0.0f);
+      mStrings.assign(layout->numValues(SymbolType::String), "");
+      mFunctionPointers.assign(layout->numValues(SymbolType::ScriptFunction), 0);
+
+      if (mLoadedMembers)
+      {
+        restoreLoadedValues(mLoadedMembers->ints, *layout, SymbolType::Int, mInts);
+        restoreLoadedValues(mLoadedMembers->floats, *layout, SymbolType::Float, mFloats);
+        restoreLoadedValues(mLoadedMembers->strings, *layout, SymbolType::String, mStrings);
+
+        for (const auto& v : mLoadedMembers->functionPointers)
+        {
+          MemberSlotIndex slot = layout->findSlot(SymbolType::ScriptFunction, v.first);
+
+          if (slot == MEMBER_SLOT_INVALID) continue;
+
+          mFunctionPointers[layout->members(SymbolType::ScriptFunction)[slot].offset] = v.second;
+        }
+
+        mLoadedMembers = nullptr;
+      }
+    }
+
+    void ScriptObject::unbindLayout(
+        const std::function<bs::UINT32(bs::UINT32)>& remapFunctionPointer)
+    {
+      if (!mLayout) return;
+
+      mLoadedMembers = bs::bs_shared_ptr_new<ScriptObjectMembersByName>(membersByName());
+
+      for (auto& v : mLoadedMembers->functionPointers)
+      {
+        v.second = remapFunctionPointer(v.second);
+      }
+
+      mLayout = nullptr;
+
+      mInts.clear();
+      mFloats.clear();
+      mStrings.clear();
+      mFunctionPointers.clear();
+    }
+
+    void ScriptObject::copyMembersFrom(const ScriptObject& other)
+    {
+      if (!mLayout || mLayout != other.mLayout)
+      {
+        REGOTH_THROW(InvalidStateException, "Cannot copy members of " + other.className +
+                                                " into object of different layout");
+      }
+
+      mInts             = other.mInts;
+      mFloats           = other.mFloats;
+      mStrings          = other.mStrings;
+      mFunctionPointers = other.mFunctionPointers;
+    }
+
+    ScriptObjectMembersByName ScriptObject::membersByName() const
+    {
+      // Not bound yet, so we can only give back what has been loaded
+      if (!mLayout)
+      {
+        return mLoadedMembers ? *mLoadedMembers : ScriptObjectMembersByName();
+      }
+
+      ScriptObjectMembersByName result;
+
+      for (const auto& m : mLayout->members(SymbolType::Int))
+      {
+        result.ints[m.name].assign(mInts.begin() + m.offset,
+                                   mInts.begin() + m.offset + m.count);
+      }
+
+      for (const auto& m : mLayout->members(SymbolType::Float))
+      {
+        result.floats[m.name].assign(mFloats.begin() + m.offset,
+                                     mFloats.begin() + m.offset + m.count);
+      }
+
+      for (const auto& m : mLayout->members(SymbolType::String))
+      {
+        result.strings[m.name].assign(mStrings.begin() + m.offset,
+                                      mStrings.begin() + m.offset + m.count);
+      }
+
+      for (const auto& m : mLayout->members(SymbolType::ScriptFunction))
+      {
+        result.functionPointers[m.name] = mFunctionPointers[m.offset];
+      }
+
+      return result;
+    }
+
     void debugLogScriptObject(const ScriptObject& object)
     {
-      REGOTH_LOG(Info, Uncategorized, "Dumping object of class: {0}", object.className);
+      REGOTH_LOG(Info, VM, "Dumping object of class: {0}", object.className);
+
+      ScriptObjectMembersByName members = object.membersByName();
 
-      for (const auto& ints : object.ints)
+      for (const auto& ints : members.ints)
       {
         const auto& values = ints.second;
 
@@ -20,10 +147,10 @@ namespace REGoth
           line += bs::toString(v) + " ";
         }
 
-        REGOTH_LOG(Info, Uncategorized, " - {0} : {1} = {2}", ints.first, "int", line);
+        REGOTH_LOG(Info, VM, " - {0} : {1} = {2}", ints.first, "int", line);
       }
 
-      for (const auto& floats : object.floats)
+      for (const auto& floats : members.floats)
       {
         const auto& values = floats.second;
 
@@ -33,10 +160,10 @@ namespace REGoth
           line += bs::toString(v) + " ";
         }
 
-        REGOTH_LOG(Info, Uncategorized, " - {0} : {1} = {2}", floats.first, "int", line);
+        REGOTH_LOG(Info, VM, " - {0} : {1} = {2}", floats.first, "int", line);
       }
 
-      for (const auto& strings : object.strings)
+      for (const auto& strings : members.strings)
       {
         const auto& values = strings.second;
 
@@ -46,17 +173,17 @@ namespace REGoth
           line += "'" + v + "' ";
         }
 
-        REGOTH_LOG(Info, Uncategorized, " - {0} : {1} = {2}", strings.first, "string", line);
+        REGOTH_LOG(Info, VM, " - {0} : {1} = {2}", strings.first, "string", line);
       }
 
-      for (const auto& ints : object.functionPointers)
+      for (const auto& ints : members.functionPointers)
       {
         const auto& value = ints.second;
 
-        REGOTH_LOG(Info, Uncategorized, " - {0} : {1} = {2}", ints.first, "function", value);
+        REGOTH_LOG(Info, VM, " - {0} : {1} = {2}", ints.first, "function", value);
       }
 
-      REGOTH_LOG(Info, Uncategorized, "");
+      REGOTH_LOG(Info, VM, "");
     }
 
     REGOTH_DEFINE_RTTI(ScriptObject)
@@ -1,7 +1,10 @@
 #pragma once
+#include "ScriptClassLayout.hpp"
 #include "ScriptTypes.hpp"
 #include <BsPrerequisites.h>
+#include <core/MemoryAccounting.hpp>
 #include <exception/Throw.hpp>
+#include <functional>
 #include <RTTI/RTTIUtil.hpp>
 
 namespace REGoth
@@ -9,7 +12,29 @@ namespace REGoth
   namespace Scripting
   {
     /**
-     * General script object, storing key/value pairs of different types.
+     * Member variables of a script object as key/value pairs, like this:
+     *
+     *     int healh;
+     *     int attributes[50];
+     *     string name;
+     *
+     * Script objects don't store their data like this, see ScriptObject. This is
+     * only used for saving and loading, where the layout of the class is not known.
+     */
+    struct ScriptObjectMembersByName
+    {
+      bs::Map<bs::String, ScriptInts> ints;
+      bs::Map<bs::String, ScriptFloats> floats;
+      bs::Map<bs::String, ScriptStrings> strings;
+      bs::Map<bs::String, bs::UINT32> functionPointers;
+    };
+
+    /**
+     * General script object, storing the member variables of a script class.
+     *
+     * The values of all member variables are stored inside one flat array per type.
+     * Which values belong to which member is described by the layout of the class,
+     * which is shared by all objects of that class. See ScriptClassLayout.
      */
     struct ScriptObject : public bs::IReflectable
     {
@@ -30,38 +55,49 @@ namespace REGoth
       ScriptObjectHandle handle;
 
       /**
-       * Data storage mapping. Each of these holds a key/value pair to describe the
-       * member variables of the object like in this example:
+       * Sets the layout of this object and allocates the values for all members
+       * described by it with their default values.
        *
-       *     int healh;
-       *     int attributes[50];
-       *     string name;
+       * If the object has just been loaded, the loaded values are then moved into
+       * their places. The loaded values of members which are not part of the layout
+       * anymore are dropped.
+       */
+      void bindLayout(bs::SPtr<const ScriptClassLayout> layout);
+
+      /**
+       * Keeps the values of all members by name and forgets about the layout, so the layout of
+       * a changed class can be bound via bindLayout() again, e.g. after reloading the scripts.
        *
-       * Note that there are save access methods below.
+       * @param  remapFunctionPointer  Gives the new value of a function pointer member, since
+       *                               the functions might have moved.
        */
-      bs::Map<bs::String, ScriptInts> ints;
-      bs::Map<bs::String, ScriptFloats> floats;
-      bs::Map<bs::String, ScriptStrings> strings;
-      bs::Map<bs::String, bs::UINT32> functionPointers;
+      void unbindLayout(const std::function<bs::UINT32(bs::UINT32)>& remapFunctionPointer);
 
       /**
-       * Save access to a string value. Throws if the value does not exist.
+       * Sets all member variables to the values of the given object, which must have the same
+       * layout bound. Name, instance name and handle are left alone.
        */
-      bs::String& stringValue(const bs::String& name, bs::UINT32 arrayIndex = 0)
-      {
-        auto it = strings.find(name);
+      void copyMembersFrom(const ScriptObject& other);
 
-        if (it == strings.end())
-        {
-          throwVariableDoesNotExist(name, "String");
-        }
+      /**
+       * @return The layout of this objects class. nullptr, if none has been bound yet.
+       */
+      const bs::SPtr<const ScriptClassLayout>& layout() const
+      {
+        return mLayout;
+      }
 
-        if (arrayIndex >= it->second.size())
-        {
-          throwArrayOutOfRange(name, "String", arrayIndex);
-        }
+      /**
+       * @return Copy of all member variables with their names.
+       */
+      ScriptObjectMembersByName membersByName() const;
 
-        return it->second[arrayIndex];
+      /**
+       * Save access to a string value. Throws if the value does not exist.
+       */
+      bs::String& stringValue(const bs::String& name, bs::UINT32 arrayIndex = 0)
+      {
+        return valueByName(mStrings, SymbolType::String, name, arrayIndex, "String");
       }
 
       /**
@@ -69,19 +105,7 @@ namespace REGoth
        */
       float& floatValue(const bs::String& name, bs::UINT32 arrayIndex = 0)
       {
-        auto it = floats.find(name);
-
-        if (it == floats.end())
-        {
-          throwVariableDoesNotExist(name, "Float");
-        }
-
-        if (arrayIndex >= it->second.size())
-        {
-          throwArrayOutOfRange(name, "Float", arrayIndex);
-        }
-
-        return it->second[arrayIndex];
+        return valueByName(mFloats, SymbolType::Float, name, arrayIndex, "Float");
       }
 
       /**
@@ -89,19 +113,7 @@ namespace REGoth
        */
       bs::INT32& intValue(const bs::String& name, bs::UINT32 arrayIndex = 0)
       {
-        auto it = ints.find(name);
-
-        if (it == ints.end())
-        {
-          throwVariableDoesNotExist(name, "Int");
-        }
-
-        if (arrayIndex >= it->second.size())
-        {
-          throwArrayOutOfRange(name, "Int", arrayIndex);
-        }
-
-        return it->second[arrayIndex];
+        return valueByName(mInts, SymbolType::Int, name, arrayIndex, "Int");
       }
 
       /**
@@ -109,14 +121,38 @@ namespace REGoth
        */
       bs::UINT32& functionPointerValue(const bs::String& name)
       {
-        auto it = functionPointers.find(name);
+        return valueByName(mFunctionPointers, SymbolType::ScriptFunction, name, 0, "Int");
+      }
 
-        if (it == functionPointers.end())
-        {
-          throwVariableDoesNotExist(name, "Int");
-        }
+      /**
+       * Fast access to a member variable via its slot, without going through its name.
+       *
+       * See ScriptClassLayout for how slots are assigned and
+       * ScriptClassTemplates::getMemberSlot() to get the slot of a member symbol.
+       *
+       * Throws if the slot was taken from a different class than the one of this object.
+       */
+      ScriptIntsRef intSlot(const MemberSlot& slot)
+      {
+        return valuesBySlot(mInts, SymbolType::Int, slot, "Int");
+      }
 
-        return it->second;
+      /** @copydoc intSlot */
+      ScriptFloatsRef floatSlot(const MemberSlot& slot)
+      {
+        return valuesBySlot(mFloats, SymbolType::Float, slot, "Float");
+      }
+
+      /** @copydoc intSlot */
+      ScriptStringsRef stringSlot(const MemberSlot& slot)
+      {
+        return valuesBySlot(mStrings, SymbolType::String, slot, "String");
+      }
+
+      /** @copydoc intSlot */
+      bs::UINT32& functionPointerSlot(const MemberSlot& slot)
+      {
+        return valuesBySlot(mFunctionPointers, SymbolType::ScriptFunction, slot, "Function")[0];
       }
 
       void throwVariableDoesNotExist(const bs::String& name, const bs::String& type)
@@ -132,6 +168,78 @@ namespace REGoth
                                                      " with index " + bs::toString(index));
       }
 
+      void throwSlotDoesNotExist(const MemberSlot& slot, SymbolType type,
+                                 const bs::String& typeName)
+      {
+        bs::String name = "in slot " + bs::toString(slot.index);
+
+        if (slot.layout && slot.index < slot.layout->members(type).size())
+        {
+          name = slot.layout->className() + "." + slot.layout->members(type)[slot.index].name;
+        }
+
+        throwVariableDoesNotExist(name, typeName);
+      }
+
+    private:
+      template <typename T>
+      using Values = TrackedVector<T, MemoryTag::ScriptObjects>;
+
+      template <typename T>
+      T& valueByName(Values<T>& values, SymbolType type, const bs::String& name,
+                     bs::UINT32 arrayIndex, const bs::String& typeName)
+      {
+        MemberSlotIndex slot = mLayout ? mLayout->findSlot(type, name) : MEMBER_SLOT_INVALID;
+
+        if (slot == MEMBER_SLOT_INVALID)
+        {
+          throwVariableDoesNotExist(name, typeName);
+        }
+
+        const ScriptClassMember& member = mLayout->members(type)[slot];
+
+        if (arrayIndex >= member.count)
+        {
+          throwArrayOutOfRange(name, typeName, arrayIndex);
+        }
+
+        return values[member.offset + arrayIndex];
+      }
+
+      template <typename T>
+      ScriptValuesRef<T> valuesBySlot(Values<T>& values, SymbolType type,
+                                      const MemberSlot& slot, const bs::String& typeName)
+      {
+        if (!mLayout || slot.layout != mLayout.get() ||
+            slot.index >= mLayout->members(type).size())
+        {
+          throwSlotDoesNotExist(slot, type, typeName);
+        }
+
+        const ScriptClassMember& member = mLayout->members(type)[slot.index];
+
+        return {values.data() + member.offset, member.count};
+      }
+
+      /**
+       * Layout of this objects class, shared among all objects of the same class.
+       */
+      bs::SPtr<const ScriptClassLayout> mLayout;
+
+      /**
+       * Values of all member variables, see ScriptClassLayout.
+       */
+      Values<bs::INT32> mInts;
+      Values<float> mFloats;
+      Values<bs::String> mStrings;
+      Values<bs::UINT32> mFunctionPointers;
+
+      /**
+       * Member variables as they have been loaded, waiting for bindLayout().
+       * nullptr if nothing is waiting.
+       */
+      bs::SPtr<ScriptObjectMembersByName> mLoadedMembers;
+
     public:
       REGOTH_DECLARE_RTTI_FOR_REFLECTABLE(ScriptObject);
     };
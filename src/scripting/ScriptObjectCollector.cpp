@@ -0,0 +1,111 @@
+#include "ScriptObjectCollector.hpp"
+#include "ScriptVM.hpp"
+#include <Scene/BsSceneObject.h>
+#include <Utility/BsTime.h>
+#include <log/logging.hpp>
+
+namespace REGoth
+{
+  namespace Scripting
+  {
+    constexpr float ScriptObjectCollector::MARK_INTERVAL;
+    constexpr bs::UINT32 ScriptObjectCollector::MAX_DESTROYED_PER_UPDATE;
+
+    void ScriptObjectCollector::addRoot(ScriptObjectHandle handle)
+    {
+      if (handle == SCRIPT_OBJECT_HANDLE_INVALID) return;
+
+      bs::UINT32 slot = ScriptObjectStorage::slotIndexOf(handle);
+
+      if (slot >= mRootsBySlot.size())
+      {
+        mRootsBySlot.resize(slot + 1, SCRIPT_OBJECT_HANDLE_INVALID);
+      }
+
+      mRootsBySlot[slot] = handle;
+    }
+
+    void ScriptObjectCollector::update(ScriptVM& vm)
+    {
+      float now        = bs::gTime().getTime();
+      float timePassed = mLastUpdateTime < 0.0f ? 0.0f : now - mLastUpdateTime;
+      mLastUpdateTime  = now;
+
+      if (!mUnreferenced.empty())
+      {
+        sweep(vm, MAX_DESTROYED_PER_UPDATE);
+        return;
+      }
+
+      mTimeUntilMark -= timePassed;
+
+      if (mTimeUntilMark > 0.0f) return;
+
+      mTimeUntilMark = MARK_INTERVAL;
+
+      mark(vm);
+    }
+
+    bs::UINT32 ScriptObjectCollector::collect(ScriptVM& vm)
+    {
+      mark(vm);
+
+      bs::UINT32 numDestroyed = sweep(vm, (bs::UINT32)mUnreferenced.size());
+
+      if (numDestroyed != 0)
+      {
+        REGOTH_LOG(Info, VM, "[ScriptObjectCollector] Destroyed {0} unreferenced script objects",
+                   numDestroyed);
+      }
+
+      return numDestroyed;
+    }
+
+    void ScriptObjectCollector::mark(ScriptVM& vm)
+    {
+      mRootsBySlot.clear();
+      mUnreferenced.clear();
+
+      vm.markScriptObjectRoots(*this);
+
+      vm.scriptObjectsConst().forEachHandle([&](ScriptObjectHandle handle) {
+        bs::UINT32 slot = ScriptObjectStorage::slotIndexOf(handle);
+
+        if (slot < mRootsBySlot.size() && mRootsBySlot[slot] == handle) return;
+
+        mUnreferenced.push_back(handle);
+      });
+
+      mStats.numFound   = (bs::UINT32)mUnreferenced.size();
+      mStats.numPending = mStats.numFound;
+    }
+
+    bs::UINT32 ScriptObjectCollector::sweep(ScriptVM& vm, bs::UINT32 maxObjects)
+    {
+      bs::UINT32 numDestroyed = 0;
+
+      while (!mUnreferenced.empty() && numDestroyed < maxObjects)
+      {
+        ScriptObjectHandle handle = mUnreferenced.back();
+        mUnreferenced.pop_back();
+
+        // Whoever created it might have destroyed it on its own by now
+        if (!vm.scriptObjects().isValid(handle)) continue;
+
+        // Still mapped to a scene object which is gone
+        if (vm.mapping().isMappedToSomething(handle))
+        {
+          vm.mapping().unmap(handle, vm.mapping().getMappedSceneObject(handle));
+        }
+
+        vm.scriptObjects().destroy(handle);
+        numDestroyed++;
+      }
+
+      mStats.numPending = (bs::UINT32)mUnreferenced.size();
+      mStats.numDestroyed += numDestroyed;
+
+      return numDestroyed;
+    }
+  }  // namespace Scripting
+}  // namespace REGoth
@@ -0,0 +1,105 @@
+#pragma once
+#include "ScriptTypes.hpp"
+#include <BsPrerequisites.h>
+
+namespace REGoth
+{
+  namespace Scripting
+  {
+    class ScriptVM;
+
+    /**
+     * Destroys script objects nothing refers to anymore, so long sessions and their saves don't
+     * grow without bound. Those are usually left behind by native code which created an object
+     * for a short while and never destroyed it.
+     *
+     * Script objects don't refer to each other, so an object is in use exactly if something
+     * outside of the storage refers to it. These *roots* are collected by the VM, see
+     * ScriptVM::markScriptObjectRoots(): The instance symbols, the VMs current instance and the
+     * mapping to living scene objects, which covers the objects of all characters and items.
+     * Nothing can get hold of an object none of these refer to, so once an object has been
+     * found to be unreferenced, it stays that way.
+     *
+     * That makes it possible to collect incrementally: Finding the unreferenced objects is cheap
+     * and done at once every MARK_INTERVAL seconds, destroying them is spread over the following
+     * updates. Objects created after they have been found are never touched. collect() does
+     * all of it at once, e.g. right before saving.
+     */
+    class ScriptObjectCollector
+    {
+    public:
+      /**
+       * How much has been collected.
+       */
+      struct Stats
+      {
+        /** Objects found to be unreferenced the last time */
+        bs::UINT32 numFound = 0;
+
+        /** Objects found but not destroyed yet */
+        bs::UINT32 numPending = 0;
+
+        /** All objects destroyed so far */
+        bs::UINT32 numDestroyed = 0;
+      };
+
+      /** Seconds between two searches for unreferenced objects */
+      static constexpr float MARK_INTERVAL = 30.0f;
+
+      /** How many objects update() destroys at most */
+      static constexpr bs::UINT32 MAX_DESTROYED_PER_UPDATE = 64;
+
+      /**
+       * Marks the given object as referenced. To be called by ScriptVM::markScriptObjectRoots().
+       * Invalid handles are ignored.
+       */
+      void addRoot(ScriptObjectHandle handle);
+
+      /**
+       * Looks for unreferenced objects if it is time to, otherwise destroys some of those
+       * found before. Must not be called while script code is being executed.
+       */
+      void update(ScriptVM& vm);
+
+      /**
+       * Finds and destroys all unreferenced objects at once. Must not be called while script
+       * code is being executed.
+       *
+       * @return Number of objects destroyed.
+       */
+      bs::UINT32 collect(ScriptVM& vm);
+
+      const Stats& stats() const
+      {
+        return mStats;
+      }
+
+    private:
+      /**
+       * Fills mUnreferenced with all objects none of the roots of the given VM refer to.
+       */
+      void mark(ScriptVM& vm);
+
+      /**
+       * Destroys up to the given number of objects from mUnreferenced.
+       *
+       * @return Number of objects destroyed.
+       */
+      bs::UINT32 sweep(ScriptVM& vm, bs::UINT32 maxObjects);
+
+      /**
+       * Full handle of the root in each slot, see ScriptObjectStorage::slotIndexOf(). Only
+       * valid during mark().
+       */
+      bs::Vector<ScriptObjectHandle> mRootsBySlot;
+
+      /** Found by mark(), waiting to be destroyed */
+      bs::Vector<ScriptObjectHandle> mUnreferenced;
+
+      float mTimeUntilMark  = MARK_INTERVAL;
+      float mLastUpdateTime = -1.0f;
+
+      Stats mStats;
+    };
+  }  // namespace Scripting
+}  // namespace REGoth
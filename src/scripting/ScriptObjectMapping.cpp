@@ -1,35 +1,63 @@
 #include "ScriptObjectMapping.hpp"
 #include <RTTI/RTTI_ScriptObjectMapping.hpp>
+#include <components/ScriptBackedBy.hpp>
 
 namespace REGoth
 {
   namespace Scripting
   {
+    const ScriptObjectMapping::MappedSceneObject* ScriptObjectMapping::find(
+        ScriptObjectHandle scriptObject) const
+    {
+      bs::UINT32 slot = ScriptObjectStorage::slotIndexOf(scriptObject);
+
+      if (slot >= mSceneObjectsBySlot.size()) return nullptr;
+
+      const MappedSceneObject& mapped = mSceneObjectsBySlot[slot];
+
+      if (mapped.scriptObject != scriptObject) return nullptr;
+
+      return &mapped;
+    }
+
     bool ScriptObjectMapping::isMappedToSomething(ScriptObjectHandle scriptObject) const
     {
-      return mScriptToSceneObjectMapping.find(scriptObject) != mScriptToSceneObjectMapping.end();
+      return find(scriptObject) != nullptr;
     }
 
     bool ScriptObjectMapping::areMapped(ScriptObjectHandle scriptObject,
                                         bs::HSceneObject sceneObject) const
     {
-      auto reverseSceneObject = mScriptToSceneObjectMapping.find(scriptObject);
+      const MappedSceneObject* mapped = find(scriptObject);
 
-      if (reverseSceneObject->second != sceneObject) return false;
+      if (!mapped || mapped->sceneObject != sceneObject) return false;
 
       return true;
     }
 
     bs::HSceneObject ScriptObjectMapping::getMappedSceneObject(ScriptObjectHandle scriptObject) const
     {
-      auto it = mScriptToSceneObjectMapping.find(scriptObject);
+      const MappedSceneObject* mapped = find(scriptObject);
 
-      if (it == mScriptToSceneObjectMapping.end())
+      if (!mapped)
       {
         REGOTH_THROW(InvalidParametersException, "Script Object is not mapped to anything!");
       }
 
-      return it->second;
+      return mapped->sceneObject;
+    }
+
+    ScriptObjectHandle ScriptObjectMapping::getMappedScriptObject(
+        bs::HSceneObject sceneObject) const
+    {
+      bs::GameObjectHandle<ScriptBackedBy> backedBy = sceneObject->getComponent<ScriptBackedBy>();
+
+      if (!backedBy || !areMapped(backedBy->scriptObject(), sceneObject))
+      {
+        REGOTH_THROW(InvalidParametersException, "Scene Object is not mapped to anything!");
+      }
+
+      return backedBy->scriptObject();
     }
 
     void ScriptObjectMapping::unmap(ScriptObjectHandle scriptObject, bs::HSceneObject sceneObject)
@@ -40,7 +68,7 @@ namespace REGoth
                      "Those two objects were not mapped, so unmapping is impossible!");
       }
 
-      mScriptToSceneObjectMapping.erase(scriptObject);
+      mSceneObjectsBySlot[ScriptObjectStorage::slotIndexOf(scriptObject)] = {};
     }
 
     void ScriptObjectMapping::map(ScriptObjectHandle scriptObject, bs::HSceneObject sceneObject)
@@ -51,7 +79,41 @@ namespace REGoth
                      "Script Object already has a mapping, can't map twice!");
       }
 
-      mScriptToSceneObjectMapping[scriptObject] = sceneObject;
+      bs::UINT32 slot = ScriptObjectStorage::slotIndexOf(scriptObject);
+
+      if (slot >= mSceneObjectsBySlot.size())
+      {
+        mSceneObjectsBySlot.resize(slot + 1);
+      }
+
+      mSceneObjectsBySlot[slot].scriptObject = scriptObject;
+      mSceneObjectsBySlot[slot].sceneObject  = sceneObject;
+      mSceneObjectsBySlot[slot].hasPosition  = false;
+    }
+
+    void ScriptObjectMapping::setMappedPosition(ScriptObjectHandle scriptObject,
+                                                const bs::Vector3& position)
+    {
+      bs::UINT32 slot = ScriptObjectStorage::slotIndexOf(scriptObject);
+
+      if (slot >= mSceneObjectsBySlot.size()) return;
+
+      MappedSceneObject& mapped = mSceneObjectsBySlot[slot];
+
+      if (mapped.scriptObject != scriptObject) return;
+
+      mapped.position    = position;
+      mapped.hasPosition = true;
+    }
+
+    const bs::Vector3* ScriptObjectMapping::findMappedPosition(
+        ScriptObjectHandle scriptObject) const
+    {
+      const MappedSceneObject* mapped = find(scriptObject);
+
+      if (!mapped || !mapped->hasPosition) return nullptr;
+
+      return &mapped->position;
     }
 
     REGOTH_DEFINE_RTTI(ScriptObjectMapping)
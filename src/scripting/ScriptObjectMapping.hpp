@@ -1,7 +1,9 @@
 #pragma once
 #include "ScriptObject.hpp"
+#include "ScriptObjectStorage.hpp"
 #include <RTTI/RTTIUtil.hpp>
 #include <BsPrerequisites.h>
+#include <Math/BsVector3.h>
 
 namespace REGoth
 {
@@ -10,6 +12,15 @@ namespace REGoth
     /**
      * Some script objects directly belong to a scene object. This is where the
      * mapping between them is stored.
+     *
+     * Since it is looked up all the time, e.g. to find the character of `self`, the scene
+     * objects are kept in a table indexed by the slot of their script object, see
+     * ScriptObjectStorage::slotIndexOf(). The other way around, the handle is already kept
+     * by the ScriptBackedBy component of the scene object, see getMappedScriptObject().
+     *
+     * Next to the scene object, the table also keeps where it is, see setMappedPosition(). That
+     * way, externals asking for distances like `Npc_GetDistToNpc` don't need to go through the
+     * scene graph at all.
      */
     class ScriptObjectMapping : public bs::IReflectable
     {
@@ -47,6 +58,14 @@ namespace REGoth
        */
       bs::HSceneObject getMappedSceneObject(ScriptObjectHandle scriptObject) const;
 
+      /**
+       * @return The script object mapped to the given scene object. Taken from the
+       *         ScriptBackedBy component of the scene object.
+       *
+       * Throws if no such mapping exists.
+       */
+      ScriptObjectHandle getMappedScriptObject(bs::HSceneObject sceneObject) const;
+
       /**
        * @return Whether the given script object is mapped to a scene object.
        */
@@ -57,8 +76,57 @@ namespace REGoth
        */
       bool areMapped(ScriptObjectHandle scriptObject, bs::HSceneObject sceneObject) const;
 
+      /**
+       * Remembers where the scene object mapped to the given script object is. To be called
+       * whenever that scene object has moved, see ScriptBackedBy::updateMappedPosition().
+       *
+       * Does nothing if the script object is not mapped.
+       */
+      void setMappedPosition(ScriptObjectHandle scriptObject, const bs::Vector3& position);
+
+      /**
+       * @return Position last set via setMappedPosition(). nullptr if the script object is not
+       *         mapped or the position is not known, since positions are not saved.
+       */
+      const bs::Vector3* findMappedPosition(ScriptObjectHandle scriptObject) const;
+
+      /**
+       * Calls the given function with every mapped script object and its scene object, which
+       * may have been destroyed already.
+       */
+      template <typename Fn>
+      void forEachMapping(Fn fn) const
+      {
+        for (const MappedSceneObject& mapped : mSceneObjectsBySlot)
+        {
+          if (mapped.scriptObject != SCRIPT_OBJECT_HANDLE_INVALID)
+          {
+            fn(mapped.scriptObject, mapped.sceneObject);
+          }
+        }
+      }
+
     private:
-      bs::Map<ScriptObjectHandle, bs::HSceneObject> mScriptToSceneObjectMapping;
+      struct MappedSceneObject
+      {
+        /** Full handle, since a slot may be reused by a different script object */
+        ScriptObjectHandle scriptObject = SCRIPT_OBJECT_HANDLE_INVALID;
+        bs::HSceneObject sceneObject;
+
+        /** See setMappedPosition() */
+        bs::Vector3 position = bs::Vector3::ZERO;
+        bool hasPosition     = false;
+      };
+
+      /**
+       * @return The entry of the given script object. nullptr if it is not mapped.
+       */
+      const MappedSceneObject* find(ScriptObjectHandle scriptObject) const;
+
+      /**
+       * Indexed by ScriptObjectStorage::slotIndexOf(). Grows to the highest slot mapped.
+       */
+      bs::Vector<MappedSceneObject> mSceneObjectsBySlot;
 
     public:
       REGOTH_DECLARE_RTTI_FOR_REFLECTABLE(ScriptObjectMapping)
@@ -1,4 +1,5 @@
 #include "ScriptObjectStorage.hpp"
+#include "ScriptClassTemplates.hpp"
 #include <RTTI/RTTI_ScriptObjectStorage.hpp>
 
 namespace REGoth
@@ -11,9 +12,7 @@ namespace REGoth
 
     bool ScriptObjectStorage::isDestroyed(ScriptObjectHandle handle) const
     {
-      if (handle == SCRIPT_OBJECT_HANDLE_INVALID) return true;
-
-      return mObjects.find(handle) == mObjects.end();
+      return findSlot(handle) == nullptr;
     }
 
     bool ScriptObjectStorage::isValid(ScriptObjectHandle handle) const
@@ -23,18 +22,35 @@ namespace REGoth
 
     ScriptObject& ScriptObjectStorage::create()
     {
-      ScriptObject object;
-      object.handle = mNextHandle;
-      mNextHandle += 1;
+      bs::UINT32 index;
 
-      if (object.handle > mNextHandle)
+      if (!mFreeSlots.empty())
       {
-        REGOTH_THROW(InvalidStateException, "Script Object Handle overflow");
+        index = mFreeSlots.back();
+        mFreeSlots.pop_back();
       }
+      else
+      {
+        // Slot 0 is reserved, so SCRIPT_OBJECT_HANDLE_INVALID is never a valid handle
+        if (mSlots.empty()) mSlots.emplace_back();
 
-      invalidateCache();
+        index = (bs::UINT32)mSlots.size();
+
+        if (index > HANDLE_INDEX_MASK)
+        {
+          REGOTH_THROW(InvalidStateException, "Script Object Handle overflow");
+        }
 
-      return mObjects.insert({object.handle, std::move(object)}).first->second;
+        mSlots.emplace_back();
+      }
+
+      Slot& slot   = mSlots[index];
+      slot.isAlive = true;
+
+      slot.object        = ScriptObject();
+      slot.object.handle = makeHandle(index, slot.generation);
+
+      return slot.object;
     }
 
     void ScriptObjectStorage::destroy(ScriptObjectHandle scriptObjectHandle)
@@ -44,9 +60,19 @@ namespace REGoth
         REGOTH_THROW(InvalidStateException, "Script Object was destroyed already!");
       }
 
-      mObjects.erase(scriptObjectHandle);
+      bs::UINT32 index = indexOf(scriptObjectHandle);
+      Slot& slot       = mSlots[index];
+
+      slot.isAlive = false;
+      slot.object  = ScriptObject();
 
-      invalidateCache();
+      // Once all generations are used up, the slot is retired so no old handle
+      // could ever reference a new object.
+      if (slot.generation < MAX_GENERATION)
+      {
+        slot.generation += 1;
+        mFreeSlots.push_back(index);
+      }
     }
 
     ScriptObject& ScriptObjectStorage::get(ScriptObjectHandle handle)
@@ -56,69 +82,99 @@ namespace REGoth
         REGOTH_THROW(InvalidStateException, "Script Object Handle is invalid!");
       }
 
-      ScriptObject* pCached = findHandleInCache(handle);
+      const Slot* slot = findSlot(handle);
 
-      if (pCached)
+      if (!slot)
       {
-        return *pCached;
+        REGOTH_THROW(InvalidStateException, "Script Object Handle does reference a known object!");
       }
-      else
-      {
-        auto it = mObjects.find(handle);
 
-        if (it == mObjects.end())
-        {
-          REGOTH_THROW(InvalidStateException, "Script Object Handle does reference a known object!");
-        }
-
-        addObjectToCache(handle, it->second);
-
-        return it->second;
-      }
+      return const_cast<Slot*>(slot)->object;
     }
 
     void ScriptObjectStorage::clear()
     {
-      mObjects.clear();
-      mNextHandle = 1;
-
-      invalidateCache();
+      mSlots.clear();
+      mFreeSlots.clear();
     }
 
-    ScriptObject* ScriptObjectStorage::findHandleInCache(ScriptObjectHandle handle) const
+    void ScriptObjectStorage::bindClassLayouts(const ScriptClassTemplates& classTemplates)
     {
-      for (bs::UINT32 i = 0; i < ACCESS_CACHE_SIZE; i++)
+      for (Slot& slot : mSlots)
       {
-        if (mAccessCachedHandles[i] == handle)
-        {
-          return mAccessCachedObjects[i];
-        }
+        if (!slot.isAlive) continue;
+        if (slot.object.layout()) continue;
+
+        slot.object.bindLayout(classTemplates.getClassLayout(slot.object.className));
       }
+    }
+
+    void ScriptObjectStorage::unbindClassLayouts(
+        const std::function<bs::UINT32(bs::UINT32)>& remapFunctionPointer)
+    {
+      for (Slot& slot : mSlots)
+      {
+        if (!slot.isAlive) continue;
 
-      return nullptr;
+        slot.object.unbindLayout(remapFunctionPointer);
+      }
     }
 
-    void ScriptObjectStorage::addObjectToCache(ScriptObjectHandle handle, ScriptObject& object)
+    const ScriptObjectStorage::Slot* ScriptObjectStorage::findSlot(ScriptObjectHandle handle) const
     {
-      mAccessCachedHandles[mCachePosition] = handle;
-      mAccessCachedObjects[mCachePosition] = &object;
+      bs::UINT32 index = indexOf(handle);
+
+      if (index == 0 || index >= mSlots.size()) return nullptr;
+
+      const Slot& slot = mSlots[index];
 
-      mCachePosition = (mCachePosition + 1) % ACCESS_CACHE_SIZE;
+      if (!slot.isAlive || slot.generation != generationOf(handle)) return nullptr;
+
+      return &slot;
     }
 
-    void ScriptObjectStorage::invalidateCache()
+    void ScriptObjectStorage::insertWithHandle(ScriptObjectHandle handle,
+                                               const ScriptObject& object)
     {
-      for (auto& h : mAccessCachedHandles)
+      bs::UINT32 index = indexOf(handle);
+
+      if (index == 0)
       {
-        h = SCRIPT_OBJECT_HANDLE_INVALID;
+        REGOTH_THROW(InvalidStateException, "Cannot insert Script Object with invalid handle!");
       }
 
-      for (auto& p : mAccessCachedObjects)
+      if (index >= mSlots.size())
       {
-        p = nullptr;
+        mSlots.resize(index + 1);
       }
 
-      mCachePosition = 0;
+      Slot& slot      = mSlots[index];
+      slot.object     = object;
+      slot.generation = generationOf(handle);
+      slot.isAlive    = true;
+
+      slot.object.handle = handle;
+    }
+
+    void ScriptObjectStorage::rebuildFreeSlots()
+    {
+      mFreeSlots.clear();
+
+      // Slot 0 is reserved, see create()
+      for (bs::UINT32 i = 1; i < (bs::UINT32)mSlots.size(); i++)
+      {
+        Slot& slot = mSlots[i];
+
+        if (slot.isAlive) continue;
+
+        // Handles to objects destroyed before saving may still be around, don't let
+        // them reference whatever will be put into this slot next.
+        if (slot.generation < MAX_GENERATION)
+        {
+          slot.generation += 1;
+          mFreeSlots.push_back(i);
+        }
+      }
     }
 
     REGOTH_DEFINE_RTTI(ScriptObjectStorage)
@@ -6,16 +6,24 @@ namespace REGoth
 {
   namespace Scripting
   {
+    class ScriptClassTemplates;
+
     /**
      * Storage for all script objects used by the scripting backend to be used by the
      * native game code.
      *
      * Note that you should always access the storage using a handle. Do not save the
-     * reference to the actual data somewhere for later use!
+     * reference to the actual data somewhere for later use! References stay valid until
+     * the object is destroyed, though.
+     *
+     * Objects are stored inside a slot map: A handle is made of the index of the slot
+     * the object lives in and the generation of that slot. Every time an object is
+     * destroyed, the generation of its slot is increased, so old handles to it become
+     * invalid, even if the slot is reused for a new object. This makes looking up,
+     * creating and destroying objects O(1).
      *
-     * The handles used here are just a ever increasing number into a map. Deleted
-     * script objects will be taken out of the map, but all other handles will
-     * remain intact.
+     * The slot with index 0 is never used, so that `SCRIPT_OBJECT_HANDLE_INVALID` never
+     * references a valid object.
      */
     class ScriptObjectStorage : public bs::IReflectable
     {
@@ -61,54 +69,102 @@ namespace REGoth
        */
       void clear();
 
-    private:
-      bs::Map<ScriptObjectHandle, ScriptObject> mObjects;
-      ScriptObjectHandle mNextHandle = 1;
+      /**
+       * Binds the layouts of their classes to all objects which don't have one yet.
+       * Needs to be done after loading, see ScriptObject::bindLayout().
+       *
+       * Throws if the class of an object does not exist.
+       *
+       * @param  classTemplates  Class templates to take the layouts from.
+       */
+      void bindClassLayouts(const ScriptClassTemplates& classTemplates);
 
       /**
-       * Checks whether the script object behind the given handle is cached.
-       * If so, a pointer to that object is returned. If it was not cached,
-       * nullptr is returned.
+       * Unbinds the layouts of all objects, see ScriptObject::unbindLayout(). Bind them again
+       * via bindClassLayouts() once the class templates have been created anew.
        */
-      ScriptObject* findHandleInCache(ScriptObjectHandle handle) const;
+      void unbindClassLayouts(const std::function<bs::UINT32(bs::UINT32)>& remapFunctionPointer);
 
       /**
-       * Adds the given object to the cache. The oldest object inside the
-       * cache will be overridden.
+       * @return Index of the slot the given handle refers to. Slots are dense, so this can be
+       *         used to index tables kept next to the storage, see ScriptObjectMapping.
        */
-      void addObjectToCache(ScriptObjectHandle handle, ScriptObject& object);
+      static bs::UINT32 slotIndexOf(ScriptObjectHandle handle)
+      {
+        return indexOf(handle);
+      }
 
       /**
-       * Invalidates the cache and resets it to default, leaving it completely empty.
+       * Calls the given function with the handle of every living object.
        */
-      void invalidateCache();
+      template <typename Fn>
+      void forEachHandle(Fn fn) const
+      {
+        for (const Slot& slot : mSlots)
+        {
+          if (slot.isAlive) fn(slot.object.handle);
+        }
+      }
 
+    private:
       /**
-       * Cache for accessing script objects via handle. Since the objects are
-       * stored within a bs::Map, access to them is rather slow. To speed up
-       * accessing of the same objects over and over again, the last few
-       * objects are cached here.
-       *
-       * The cache is implemented using two std::arrays, so the data they hold
-       * is local to the class and can be accessed without an indirection.
-       *
-       * There are two arrays: The cached handles and pointers to actual
-       * objects. Both arrays index the same way: Index i in one array belongs
-       * to index i in the other one.
-       *
-       * When a new object is supposed to be cached, the oldest entry is overwritten.
+       * Number of bits of a handle used for the slot index. The remaining bits
+       * store the generation.
+       */
+      static constexpr bs::UINT32 HANDLE_INDEX_BITS = 20;
+      static constexpr bs::UINT32 HANDLE_INDEX_MASK = (1 << HANDLE_INDEX_BITS) - 1;
+      static constexpr bs::UINT32 MAX_GENERATION    = UINT32_MAX >> HANDLE_INDEX_BITS;
+
+      static ScriptObjectHandle makeHandle(bs::UINT32 index, bs::UINT32 generation)
+      {
+        return (generation << HANDLE_INDEX_BITS) | index;
+      }
+
+      static bs::UINT32 indexOf(ScriptObjectHandle handle)
+      {
+        return handle & HANDLE_INDEX_MASK;
+      }
+
+      static bs::UINT32 generationOf(ScriptObjectHandle handle)
+      {
+        return handle >> HANDLE_INDEX_BITS;
+      }
+
+      struct Slot
+      {
+        ScriptObject object;
+        bs::UINT32 generation = 0;
+        bool isAlive          = false;
+      };
+
+      /**
+       * Looks up the slot referenced by the given handle.
        *
-       * Since it's not required for the bs::Map to keep all objects at the
-       * same addresses, the cache is cleaned once the object map is updated.
-       * However, most implementations should leave the data where it is, so
-       * we might be able to keep the cache on those implementations of bs::Map.
-       * If we ever do that, we only have to take care of invalidating the cache
-       * when removing objects.
-       */
-      static constexpr bs::UINT32 ACCESS_CACHE_SIZE = 5;
-      std::array<ScriptObjectHandle, ACCESS_CACHE_SIZE> mAccessCachedHandles;
-      std::array<ScriptObject*, ACCESS_CACHE_SIZE> mAccessCachedObjects;
-      bs::UINT32 mCachePosition = 0;
+       * @return The slot, if the handle references a living object. nullptr otherwise.
+       */
+      const Slot* findSlot(ScriptObjectHandle handle) const;
+
+      /**
+       * Places an object with the given handle into its slot. Used when loading, where
+       * all objects need to keep the handles they were saved with.
+       */
+      void insertWithHandle(ScriptObjectHandle handle, const ScriptObject& object);
+
+      /**
+       * Collects all unused slots into mFreeSlots after loading.
+       */
+      void rebuildFreeSlots();
+
+      /**
+       * All slots. A deque is used so that references to objects stay valid
+       * while new slots are added.
+       */
+      TrackedDeque<Slot, MemoryTag::ScriptObjects> mSlots;
+
+      /**
+       * Indices of slots which don't hold an object and can be reused.
+       */
+      bs::Vector<bs::UINT32> mFreeSlots;
 
     public:
       REGOTH_DECLARE_RTTI_FOR_REFLECTABLE(ScriptObjectStorage)
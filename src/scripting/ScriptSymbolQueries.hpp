@@ -8,6 +8,11 @@ namespace REGoth
   {
     class ScriptSymbolStorage;
 
+    /**
+     * Common queries on the symbol storage. These are answered from the query indices
+     * of the storage, see ScriptSymbolStorage::buildQueryIndices(), so they don't have
+     * to look at every symbol.
+     */
     namespace Queries
     {
       /**
@@ -15,9 +20,9 @@ namespace REGoth
        *
        * @param  storage  The script symbol storage to query.
        *
-       * @return Indices of all found symbols.
+       * @return Indices of all found symbols. Only valid as long as the storage isn't modified.
        */
-      bs::Vector<SymbolIndex> findAllClasses(const ScriptSymbolStorage& storage);
+      SymbolIndexSpan findAllClasses(const ScriptSymbolStorage& storage);
 
 
       /**
@@ -26,21 +31,20 @@ namespace REGoth
        * @param  storage    The script symbol storage to query.
        * @param  className  Name of the class.
        *
-       * @return Indices of all found symbols.
+       * @return Indices of all found symbols. Only valid as long as the storage isn't modified.
        */
-      bs::Vector<SymbolIndex> findAllInstancesOfClass(const ScriptSymbolStorage& storage,
-                                                      const bs::String& className);
+      SymbolIndexSpan findAllInstancesOfClass(const ScriptSymbolStorage& storage,
+                                              const bs::String& className);
 
       /**
-       * Finds all Symbols which have the given parent.
+       * Finds all class variables which have the given parent.
        *
        * @param  storage  The script symbol storage to query.
        * @param  parent   Parent to search for.
        *
-       * @return Indices of all found symbols.
+       * @return Indices of all found symbols. Only valid as long as the storage isn't modified.
        */
-      bs::Vector<SymbolIndex> findAllWithParentOf(const ScriptSymbolStorage& storage,
-                                                  SymbolIndex parent);
+      SymbolIndexSpan findAllWithParentOf(const ScriptSymbolStorage& storage, SymbolIndex parent);
 
       /**
        * Given an address, finds the symbol of the function starting at that address.
@@ -5,6 +5,155 @@ namespace REGoth
 {
   namespace Scripting
   {
+    /**
+     * Appends a symbol of the given type and copies the data of the given symbol into it.
+     */
+    template <typename T>
+    static void copyIntoStorage(ScriptSymbolStorage& storage, const SymbolBase& symbol)
+    {
+      SymbolIndex index = storage.appendSymbol<T>(symbol.name);
+
+      storage.getSymbol<T>(index) = (const T&)symbol;
+    }
+
+    ScriptSymbolStorage::ScriptSymbolStorage(const ScriptSymbolStorage& other)
+    {
+      *this = other;
+    }
+
+    ScriptSymbolStorage& ScriptSymbolStorage::operator=(const ScriptSymbolStorage& other)
+    {
+      if (this == &other) return *this;
+
+      mArenas = decltype(mArenas)();
+      mSymbols.clear();
+      mSymbolsByName.clear();
+
+      for (const SymbolBase* symbol : other.mSymbols)
+      {
+        appendSymbolCopy(*symbol);
+      }
+
+      mFunctionsByAddress = other.mFunctionsByAddress;
+
+      for (bs::UINT32 i = 0; i < NUM_SYMBOL_TYPES; i++)
+      {
+        mSymbolsByType[i] = other.mSymbolsByType[i];
+      }
+
+      mClassVarsByParent = other.mClassVarsByParent;
+      mInstancesByClass  = other.mInstancesByClass;
+      mNumIndexedSymbols = other.mNumIndexedSymbols;
+
+      return *this;
+    }
+
+    void ScriptSymbolStorage::appendSymbolCopy(const SymbolBase& symbol)
+    {
+      if (symbol.index != mSymbols.size())
+      {
+        using namespace bs;
+        BS_EXCEPT(InvalidStateException,
+                  "Symbol " + symbol.name + " has index " + bs::toString(symbol.index) +
+                      ", but would be put at " + bs::toString((bs::UINT32)mSymbols.size()));
+      }
+
+      switch (symbol.type)
+      {
+        case SymbolType::Int:
+          copyIntoStorage<SymbolInt>(*this, symbol);
+          break;
+
+        case SymbolType::Float:
+          copyIntoStorage<SymbolFloat>(*this, symbol);
+          break;
+
+        case SymbolType::String:
+          copyIntoStorage<SymbolString>(*this, symbol);
+          break;
+
+        case SymbolType::Class:
+          copyIntoStorage<SymbolClass>(*this, symbol);
+          break;
+
+        case SymbolType::ScriptFunction:
+          copyIntoStorage<SymbolScriptFunction>(*this, symbol);
+          break;
+
+        case SymbolType::ExternalFunction:
+          copyIntoStorage<SymbolExternalFunction>(*this, symbol);
+          break;
+
+        case SymbolType::Prototype:
+          copyIntoStorage<SymbolPrototype>(*this, symbol);
+          break;
+
+        case SymbolType::Instance:
+          copyIntoStorage<SymbolInstance>(*this, symbol);
+          break;
+
+        default:
+          copyIntoStorage<SymbolUnsupported>(*this, symbol);
+          break;
+      }
+    }
+
+    void ScriptSymbolStorage::reserveSymbols(bs::UINT32 numSymbols)
+    {
+      mSymbols.reserve(numSymbols);
+      mSymbolsByName.reserve(numSymbols);
+    }
+
+    void ScriptSymbolStorage::buildNameIndex()
+    {
+      mSymbolsByName.clear();
+      mSymbolsByName.reserve(mSymbols.size());
+
+      for (const SymbolBase* s : mSymbols)
+      {
+        mSymbolsByName[s->name] = s->index;
+      }
+    }
+
+    void ScriptSymbolStorage::buildQueryIndices()
+    {
+      for (auto& indices : mSymbolsByType)
+      {
+        indices.clear();
+      }
+
+      mClassVarsByParent.clear();
+      mInstancesByClass.clear();
+
+      for (const SymbolBase* s : mSymbols)
+      {
+        mSymbolsByType[(bs::UINT32)s->type].push_back(s->index);
+
+        if (s->isClassVar)
+        {
+          mClassVarsByParent[s->parent].push_back(s->index);
+        }
+
+        if (s->type == SymbolType::Instance && s->parent < mSymbols.size())
+        {
+          // The parent of an instance is either the class itself or a prototype,
+          // which then has the class as parent.
+          const SymbolBase& parent = *mSymbols[s->parent];
+
+          if (parent.type == SymbolType::Class)
+          {
+            mInstancesByClass[parent.index].push_back(s->index);
+          }
+          else if (parent.type == SymbolType::Prototype && parent.parent != SYMBOL_INDEX_INVALID)
+          {
+            mInstancesByClass[parent.parent].push_back(s->index);
+          }
+        }
+      }
+
+      mNumIndexedSymbols = (bs::UINT32)mSymbols.size();
+    }
+
     REGOTH_DEFINE_RTTI(ScriptSymbolStorage)
   }
 }  // namespace REGoth
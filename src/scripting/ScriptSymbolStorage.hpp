@@ -1,23 +1,74 @@
 #pragma once
 #include "ScriptSymbols.hpp"
 #include <BsPrerequisites.h>
+#include <core/MemoryAccounting.hpp>
 #include <RTTI/RTTIUtil.hpp>
+#include <tuple>
 
 namespace REGoth
 {
   namespace Scripting
   {
+    /**
+     * Stores symbols of a single type in blocks of contiguous memory.
+     *
+     * Blocks are never resized once created, so references to symbols stay valid
+     * for as long as the arena exists.
+     */
+    template <typename T>
+    class ScriptSymbolArena
+    {
+    public:
+      /**
+       * Appends a default constructed symbol.
+       *
+       * @return Reference to the created symbol.
+       */
+      T& emplace()
+      {
+        if (mBlocks.empty() || mBlocks.back().size() == BLOCK_SIZE)
+        {
+          mBlocks.emplace_back();
+          mBlocks.back().reserve(BLOCK_SIZE);
+        }
+
+        mBlocks.back().emplace_back();
+
+        return mBlocks.back().back();
+      }
+
+    private:
+      static constexpr bs::UINT32 BLOCK_SIZE = 1024;
+
+      bs::Vector<TrackedVector<T, MemoryTag::ScriptSymbols>> mBlocks;
+    };
+
     /**
      * Holds the list of all created symbols and their data.
      *
      * This is the only place where symbols should created and have
      * their types and names be set.
+     *
+     * Symbols are stored by type inside a ScriptSymbolArena each, so that the tens of thousands
+     * of symbols found in a DAT-file don't need an allocation each. Looking up a symbol by its
+     * index goes through a flat list of pointers into these arenas.
      */
     class ScriptSymbolStorage : public bs::IReflectable
     {
     public:
       ScriptSymbolStorage() = default;
 
+      /**
+       * Copies all symbols into new arenas. The default would keep pointing into the arenas
+       * of the copied storage.
+       */
+      ScriptSymbolStorage(const ScriptSymbolStorage& other);
+      ScriptSymbolStorage& operator=(const ScriptSymbolStorage& other);
+
+      // Moving keeps the blocks of the arenas in place, so the pointers stay valid
+      ScriptSymbolStorage(ScriptSymbolStorage&& other) = default;
+      ScriptSymbolStorage& operator=(ScriptSymbolStorage&& other) = default;
+
       /**
        * Appends a symbol of the given type to the storage.
        *
@@ -29,27 +80,69 @@ namespace REGoth
       template <typename T>
       SymbolIndex appendSymbol(const bs::String& name)
       {
-        bs::SPtr<SymbolBase> symbol = bs::bs_shared_ptr_new<T>();
-
-        mStorage.emplace_back(std::move(symbol));
+        SymbolIndex index = appendUnnamedSymbol<T>();
 
-        SymbolIndex index = (SymbolIndex)(mStorage.size() - 1);
+        mSymbols[index]->name = name;
+        mSymbolsByName[name]  = index;
 
-        mStorage.back()->name  = name;
-        mStorage.back()->index = index;
-        mStorage.back()->type  = T::TYPE;
+        return index;
+      }
 
-        if (mStorage.size() >= SYMBOL_INDEX_MAX)
+      /**
+       * Appends a symbol of the given type without a name, which is not found by name until
+       * the name is set and buildNameIndex() was called.
+       *
+       * Meant for filling the storage with many symbols at once: Appending has to happen in
+       * order, but names and data of the appended symbols can then be set in parallel, since
+       * no other symbol is touched by that.
+       *
+       * @tparam T  Type of the symbol to create and append.
+       *
+       * @return Index of the created symbol.
+       */
+      template <typename T>
+      SymbolIndex appendUnnamedSymbol()
+      {
+        if (mSymbols.size() + 1 >= SYMBOL_INDEX_MAX)
         {
           using namespace bs;
           BS_EXCEPT(InvalidStateException, "Symbol Index limit reached!");
         }
 
-        mSymbolsByName[name] = index;
+        T& symbol = std::get<ScriptSymbolArena<T>>(mArenas).emplace();
+
+        SymbolIndex index = (SymbolIndex)mSymbols.size();
+
+        symbol.index = index;
+        symbol.type  = T::TYPE;
+
+        mSymbols.push_back(&symbol);
 
         return index;
       }
 
+      /**
+       * Makes room for the given number of symbols in total, so appending them doesn't have to
+       * grow the list of symbols and the name index again and again.
+       */
+      void reserveSymbols(bs::UINT32 numSymbols);
+
+      /**
+       * Rebuilds the index to look up symbols by name from the names of all symbols. Needed
+       * after symbols were added via appendUnnamedSymbol().
+       */
+      void buildNameIndex();
+
+      /**
+       * Appends a copy of the given symbol, which keeps all of its data. The index of the
+       * symbol has to match the index it will get inside this storage.
+       *
+       * Used to restore the storage from a savegame.
+       *
+       * @param  symbol  Symbol to copy. Its type has to be set correctly.
+       */
+      void appendSymbolCopy(const SymbolBase& symbol);
+
       /**
        * Looks up the symbol at the given index.
        *
@@ -102,7 +195,7 @@ namespace REGoth
       T& getSymbol(SymbolIndex index) const
       {
         throwOnInvalidSymbol(index);
-        throwOnMismatchingType<T>(*mStorage[index]);
+        throwOnMismatchingType<T>(*mSymbols[index]);
 
         return getTypedSymbolReference<T>(index);
       }
@@ -123,11 +216,19 @@ namespace REGoth
       {
         SymbolIndex index = findIndexBySymbolName(name);
         throwOnInvalidSymbol(index);
-        throwOnMismatchingType<T>(*mStorage[index]);
+        throwOnMismatchingType<T>(*mSymbols[index]);
 
         return getTypedSymbolReference<T>(index);
       }
 
+      /**
+       * @return Number of symbols inside the storage. Valid indices are below that.
+       */
+      bs::UINT32 numSymbols() const
+      {
+        return (bs::UINT32)mSymbols.size();
+      }
+
       /**
        * Runs a query agains the symbol storage. Assembles a list of all symbols
        * for which the given function returned true.
@@ -141,7 +242,7 @@ namespace REGoth
       {
         bs::Vector<SymbolIndex> result;
 
-        for (const auto& s : mStorage)
+        for (const SymbolBase* s : mSymbols)
         {
           if (addIf(*s))
           {
@@ -152,6 +253,51 @@ namespace REGoth
         return result;
       }
 
+      /**
+       * Builds the indices used by symbolsOfType(), classVarsWithParent() and
+       * instancesOfClass(). Needs to be called once all symbols have been added and
+       * their parents are set.
+       */
+      void buildQueryIndices();
+
+      /**
+       * @return Indices of all symbols of the given type, in order.
+       *
+       * Throws if the query indices are not up to date, see buildQueryIndices().
+       */
+      SymbolIndexSpan symbolsOfType(SymbolType type) const
+      {
+        throwIfQueryIndicesOutdated();
+
+        return spanOf(mSymbolsByType[(bs::UINT32)type]);
+      }
+
+      /**
+       * @return Indices of all class variables with the given parent, i.e. the member
+       *         variables of the given class.
+       *
+       * Throws if the query indices are not up to date, see buildQueryIndices().
+       */
+      SymbolIndexSpan classVarsWithParent(SymbolIndex parent) const
+      {
+        throwIfQueryIndicesOutdated();
+
+        return findInIndex(mClassVarsByParent, parent);
+      }
+
+      /**
+       * @return Indices of all instances of the given class. That includes instances which
+       *         are based on a prototype of the class.
+       *
+       * Throws if the query indices are not up to date, see buildQueryIndices().
+       */
+      SymbolIndexSpan instancesOfClass(SymbolIndex classSymbol) const
+      {
+        throwIfQueryIndicesOutdated();
+
+        return findInIndex(mInstancesByClass, classSymbol);
+      }
+
       /**
        * Looks up the type of the symbol with the given index.
        *
@@ -166,7 +312,7 @@ namespace REGoth
       {
         throwOnInvalidSymbol(index);
 
-        return mStorage[index]->type;
+        return mSymbols[index]->type;
       }
 
       /**
@@ -184,7 +330,7 @@ namespace REGoth
         SymbolIndex index = findIndexBySymbolName(name);
         throwOnInvalidSymbol(index);
 
-        return mStorage[index]->type;
+        return mSymbols[index]->type;
       }
 
       /**
@@ -232,7 +378,7 @@ namespace REGoth
       /**
        * @return Symbol of the function with the given address.
        */
-      SymbolIndex findFunctionByAddress(bs::UINT32 scriptAddress)
+      SymbolIndex findFunctionByAddress(bs::UINT32 scriptAddress) const
       {
         auto it = mFunctionsByAddress.find(scriptAddress);
 
@@ -245,13 +391,39 @@ namespace REGoth
       }
 
     private:
+      using QueryIndex = bs::UnorderedMap<SymbolIndex, bs::Vector<SymbolIndex>>;
+
+      static SymbolIndexSpan spanOf(const bs::Vector<SymbolIndex>& indices)
+      {
+        return {indices.data(), (bs::UINT32)indices.size()};
+      }
+
+      static SymbolIndexSpan findInIndex(const QueryIndex& index, SymbolIndex key)
+      {
+        auto it = index.find(key);
+
+        if (it == index.end()) return {};
+
+        return spanOf(it->second);
+      }
+
+      void throwIfQueryIndicesOutdated() const
+      {
+        if (mNumIndexedSymbols != mSymbols.size())
+        {
+          using namespace bs;
+          BS_EXCEPT(InvalidStateException,
+                    "Symbol query indices are outdated, call buildQueryIndices() first!");
+        }
+      }
+
       /**
        * @return The symbol at the given index cast to the passed type.
        */
       template <class T>
       T& getTypedSymbolReference(SymbolIndex index) const
       {
-        return *(T*)(mStorage[index].get());
+        return *(T*)mSymbols[index];
       }
 
       template <class T>
@@ -276,20 +448,42 @@ namespace REGoth
           BS_EXCEPT(InvalidStateException, "Symbol Index is set to INVALID!");
         }
 
-        if (index >= mStorage.size())
+        if (index >= mSymbols.size())
         {
           BS_EXCEPT(InvalidStateException, "Symbol Index out of range!");
         }
-
-        if (!mStorage[index])
-        {
-          BS_EXCEPT(InvalidStateException,
-                    "Symbol index " + bs::toString(index) + " pointing to NULL!");
-        }
       }
 
-      bs::Vector<bs::SPtr<SymbolBase>> mStorage;
-      bs::Map<bs::String, SymbolIndex> mSymbolsByName;
+      /**
+       * Holds the actual symbols, one arena per type of symbol.
+       */
+      std::tuple<ScriptSymbolArena<SymbolInt>, ScriptSymbolArena<SymbolFloat>,
+                 ScriptSymbolArena<SymbolString>, ScriptSymbolArena<SymbolClass>,
+                 ScriptSymbolArena<SymbolScriptFunction>,
+                 ScriptSymbolArena<SymbolExternalFunction>, ScriptSymbolArena<SymbolPrototype>,
+                 ScriptSymbolArena<SymbolInstance>, ScriptSymbolArena<SymbolUnsupported>>
+          mArenas;
+
+      /**
+       * Every symbol inside mArenas, by index.
+       */
+      bs::Vector<SymbolBase*> mSymbols;
+
+      bs::UnorderedMap<bs::String, SymbolIndex> mSymbolsByName;
+
+      /**
+       * Query indices, see buildQueryIndices(). Not saved, since they are rebuilt
+       * after loading.
+       */
+      bs::Vector<SymbolIndex> mSymbolsByType[NUM_SYMBOL_TYPES];
+      QueryIndex mClassVarsByParent;
+      QueryIndex mInstancesByClass;
+
+      /**
+       * Number of symbols the query indices were built for. If that doesn't match the number of
+       * symbols, the indices are outdated.
+       */
+      bs::UINT32 mNumIndexedSymbols = 0;
       bs::Map<bs::UINT32, SymbolIndex> mFunctionsByAddress;
 
     public:
@@ -77,7 +77,7 @@ namespace REGoth
       {
       }
 
-      REGOTH_LOG(Info, Uncategorized, line);
+      REGOTH_LOG(Info, VM, line);
     }
 
     REGOTH_DEFINE_RTTI(SymbolBase)
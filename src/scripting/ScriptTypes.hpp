@@ -32,6 +32,46 @@ namespace REGoth
       Unsupported,
     };
 
+    /**
+     * Number of different symbol types, see SymbolType.
+     */
+    constexpr bs::UINT32 NUM_SYMBOL_TYPES = (bs::UINT32)SymbolType::Unsupported + 1;
+
+    /**
+     * View onto a list of symbol indices owned by someone else, like the query indices of the
+     * ScriptSymbolStorage. Only valid as long as the owner of the list is not modified.
+     */
+    struct SymbolIndexSpan
+    {
+      const SymbolIndex* first = nullptr;
+      bs::UINT32 count         = 0;
+
+      const SymbolIndex* begin() const
+      {
+        return first;
+      }
+
+      const SymbolIndex* end() const
+      {
+        return first + count;
+      }
+
+      bs::UINT32 size() const
+      {
+        return count;
+      }
+
+      bool empty() const
+      {
+        return count == 0;
+      }
+
+      SymbolIndex operator[](bs::UINT32 index) const
+      {
+        return first[index];
+      }
+    };
+
     /**
      * Possible return types for script functions.
      */
@@ -45,8 +85,9 @@ namespace REGoth
     };
 
     /**
-     * Script objects will get a simple increasing number as a handle.
-     * No number can be used twice. An invalid handle will get the number 0.
+     * Handle of a script object. Made of a slot index and a generation, so a handle of a
+     * destroyed object will never reference a different object. See ScriptObjectStorage.
+     * An invalid handle will get the number 0.
      */
     typedef bs::UINT32 ScriptObjectHandle;
 
@@ -59,5 +100,41 @@ namespace REGoth
     using ScriptFloats = bs::Vector<float>;
     using ScriptStrings = bs::Vector<bs::String>;
 
+    /**
+     * Index of a member variable within the members of the same type of its class.
+     * See ScriptClassTemplates::getMemberSlot().
+     */
+    typedef bs::UINT32 MemberSlotIndex;
+
+    enum : MemberSlotIndex
+    {
+      MEMBER_SLOT_INVALID = UINT32_MAX
+    };
+
+    /**
+     * Reference to the values of a single member variable inside a script object.
+     * Only valid as long as the object exists.
+     */
+    template <typename T>
+    struct ScriptValuesRef
+    {
+      T* values;
+      bs::UINT32 count;
+
+      bs::UINT32 size() const
+      {
+        return count;
+      }
+
+      T& operator[](bs::UINT32 index) const
+      {
+        return values[index];
+      }
+    };
+
+    using ScriptIntsRef    = ScriptValuesRef<bs::INT32>;
+    using ScriptFloatsRef  = ScriptValuesRef<float>;
+    using ScriptStringsRef = ScriptValuesRef<bs::String>;
+
   }  // namespace Scripting
 }  // namespace REGoth
@@ -1,6 +1,10 @@
 #include "ScriptVM.hpp"
 #include "ScriptSymbolQueries.hpp"
+#include "ScriptVMSnapshot.hpp"
+#include <FileSystem/BsFileSystem.h>
 #include <RTTI/RTTI_ScriptVM.hpp>
+#include <Serialization/BsFileSerializer.h>
+#include <log/logging.hpp>
 
 namespace REGoth
 {
@@ -13,21 +17,89 @@ namespace REGoth
       mClassTemplates.createClassTemplates(mScriptSymbols);
     }
 
+    bool ScriptVM::initializeFromSnapshot(const bs::Path& path)
+    {
+      if (!bs::FileSystem::exists(path)) return false;
+
+      bs::SPtr<bs::IReflectable> decoded;
+
+      try
+      {
+        bs::FileDecoder decoder(path);
+        decoded = decoder.decode();
+      }
+      catch (const std::exception& e)
+      {
+        REGOTH_LOG(Warning, VM, "[ScriptVM] Failed to read snapshot {0}: {1}",
+                   path.toString(), e.what());
+        return false;
+      }
+
+      if (!decoded || !bs::rtti_is_of_type<ScriptVMSnapshot>(decoded.get()))
+      {
+        REGOTH_LOG(Warning, VM, "[ScriptVM] {0} is not a snapshot", path.toString());
+        return false;
+      }
+
+      auto snapshot = std::static_pointer_cast<ScriptVMSnapshot>(decoded);
+
+      if (snapshot->version != ScriptVMSnapshot::VERSION ||
+          snapshot->sourceHash != snapshotSourceHash())
+      {
+        REGOTH_LOG(Info, VM, "[ScriptVM] Snapshot {0} is outdated", path.toString());
+        return false;
+      }
+
+      mScriptSymbols       = std::move(snapshot->symbols);
+      mScriptObjects       = std::move(snapshot->objects);
+      mScriptObjectMapping = std::move(snapshot->mapping);
+
+      mClassTemplates.createClassTemplates(mScriptSymbols);
+      mScriptObjects.bindClassLayouts(mClassTemplates);
+
+      onRestoredFromSnapshot();
+
+      return true;
+    }
+
+    void ScriptVM::saveSnapshot(const bs::Path& path) const
+    {
+      auto snapshot = bs::bs_shared_ptr_new<ScriptVMSnapshot>();
+
+      snapshot->sourceHash = snapshotSourceHash();
+      snapshot->symbols    = mScriptSymbols;
+      snapshot->objects    = mScriptObjects;
+      snapshot->mapping    = mScriptObjectMapping;
+
+      bs::FileEncoder encoder(path);
+      encoder.encode(snapshot.get());
+    }
+
     ScriptObjectHandle ScriptVM::instanciateBlankObjectOfClass(const bs::String& className)
     {
       ScriptObject& obj = mScriptObjects.create();
 
       const ScriptObject& classTemplate = mClassTemplates.getClassTemplate(className);
 
-      obj.className        = className;
-      obj.functionPointers = classTemplate.functionPointers;
-      obj.floats           = classTemplate.floats;
-      obj.ints             = classTemplate.ints;
-      obj.strings          = classTemplate.strings;
+      obj.className = className;
+      obj.bindLayout(classTemplate.layout());
 
       return obj.handle;
     }
 
+    void ScriptVM::markScriptObjectRoots(ScriptObjectCollector& collector) const
+    {
+      for (SymbolIndex index : mScriptSymbols.symbolsOfType(SymbolType::Instance))
+      {
+        collector.addRoot(mScriptSymbols.getSymbol<SymbolInstance>(index).instance);
+      }
+
+      mScriptObjectMapping.forEachMapping(
+          [&](ScriptObjectHandle scriptObject, const bs::HSceneObject& sceneObject) {
+            if (!sceneObject.isDestroyed()) collector.addRoot(scriptObject);
+          });
+    }
+
     REGOTH_DEFINE_RTTI(ScriptVM)
   }  // namespace Scripting
 }  // namespace REGoth
@@ -1,5 +1,6 @@
 #pragma once
 #include "ScriptClassTemplates.hpp"
+#include "ScriptObjectCollector.hpp"
 #include "ScriptObjectMapping.hpp"
 #include "ScriptObjectStorage.hpp"
 #include "ScriptSymbolStorage.hpp"
@@ -30,6 +31,29 @@ namespace REGoth
        */
       virtual void initialize();
 
+      /**
+       * Initializes the ScriptVM from a snapshot saved by saveSnapshot(), instead of building
+       * everything from the original script files. To be called after the object is
+       * constructed, instead of initialize().
+       *
+       * The snapshot is only used if it has been created from the same script files and
+       * with the current snapshot format, see ScriptVMSnapshot.
+       *
+       * @param  path  File the snapshot has been saved to.
+       *
+       * @return True, if the VM has been initialized. False, if the snapshot did not exist or
+       *         could not be used. In that case, initialize() has to be called instead.
+       */
+      bool initializeFromSnapshot(const bs::Path& path);
+
+      /**
+       * Saves symbols, script objects and their mapping into a snapshot, so the next start can
+       * use initializeFromSnapshot(). Meant to be called right after initialize().
+       *
+       * @param  path  File to save the snapshot to. Overwritten, if it exists.
+       */
+      void saveSnapshot(const bs::Path& path) const;
+
       /**
        * Creates a blank script object and gives it all member variables needed for
        * the given class. This will NOT run the instance constructor function!
@@ -68,6 +92,13 @@ namespace REGoth
        */
       virtual void initializeWorld(const bs::String& worldName) = 0;
 
+      /**
+       * Tells the given collector about every script object which is referred to from
+       * outside of the storage, see ScriptObjectCollector. These are the objects of all
+       * instance symbols and those mapped to scene objects which still exist.
+       */
+      virtual void markScriptObjectRoots(ScriptObjectCollector& collector) const;
+
       /**
        * Access to the script object storage
        */
@@ -113,6 +144,18 @@ namespace REGoth
        */
       virtual void fillSymbolStorage() = 0;
 
+      /**
+       * @return Hash of the script files this VM is built from. Snapshots created from
+       *         other script files are not used.
+       */
+      virtual bs::UINT64 snapshotSourceHash() const = 0;
+
+      /**
+       * Called once symbols, script objects and class templates have been restored from
+       * a snapshot. Has to rebuild everything which was not part of the snapshot.
+       */
+      virtual void onRestoredFromSnapshot() = 0;
+
     protected:
       // Storages for symbols and objects -----------------------------------------------------------
       ScriptSymbolStorage mScriptSymbols;
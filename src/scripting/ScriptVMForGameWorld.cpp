@@ -7,8 +7,8 @@ namespace REGoth
   namespace Scripting
   {
     ScriptVMForGameWorld::ScriptVMForGameWorld(HGameWorld gameWorld,
-                                               const bs::Vector<bs::UINT8>& datFileData)
-        : DaedalusVMForGameWorld(gameWorld, datFileData)
+                                               bs::SPtr<const DaedalusProgram> program)
+        : DaedalusVMForGameWorld(gameWorld, std::move(program))
     {
     }
 
@@ -16,7 +16,7 @@ namespace REGoth
     class ScriptVMForGameWorld : public DaedalusVMForGameWorld
     {
     public:
-      ScriptVMForGameWorld(HGameWorld gameWorld, const bs::Vector<bs::UINT8>& datFileData);
+      ScriptVMForGameWorld(HGameWorld gameWorld, bs::SPtr<const DaedalusProgram> program);
 
     protected:
 
@@ -0,0 +1,24 @@
+#include "ScriptVMSnapshot.hpp"
+#include <RTTI/RTTI_ScriptVMSnapshot.hpp>
+
+namespace REGoth
+{
+  namespace Scripting
+  {
+    bs::UINT64 hashSnapshotSource(const std::vector<bs::UINT8>& data)
+    {
+      // 64-bit FNV-1a. Only has to tell different versions of the same file apart.
+      bs::UINT64 hash = 14695981039346656037ULL;
+
+      for (bs::UINT8 byte : data)
+      {
+        hash ^= byte;
+        hash *= 1099511628211ULL;
+      }
+
+      return hash;
+    }
+
+    REGOTH_DEFINE_RTTI(ScriptVMSnapshot)
+  }  // namespace Scripting
+}  // namespace REGoth
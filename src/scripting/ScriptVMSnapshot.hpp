@@ -0,0 +1,59 @@
+/**\file
+ */
+#pragma once
+#include "ScriptObjectMapping.hpp"
+#include "ScriptObjectStorage.hpp"
+#include "ScriptSymbolStorage.hpp"
+#include <BsPrerequisites.h>
+#include <RTTI/RTTIUtil.hpp>
+#include <Reflection/BsIReflectable.h>
+
+namespace REGoth
+{
+  namespace Scripting
+  {
+    /**
+     * Everything a ScriptVM builds from the original script files while it is initialized:
+     * The converted symbols and the script objects created during initialization.
+     *
+     * Building these from the DAT-file usually takes a while, so a snapshot of them can be
+     * saved and restored on the next start, see ScriptVM::saveSnapshot() and
+     * ScriptVM::initializeFromSnapshot().
+     *
+     * A snapshot is keyed by a hash of the original script files and by VERSION. If
+     * either of them doesn't match, the snapshot is not used.
+     */
+    class ScriptVMSnapshot : public bs::IReflectable
+    {
+    public:
+      /**
+       * Version of the snapshot format. Has to be increased whenever something about
+       * how the VM builds its storages changes, so that old snapshots are not used anymore.
+       */
+      static constexpr bs::UINT32 VERSION = 1;
+
+      ScriptVMSnapshot() = default;
+
+      /**
+       * Format version the snapshot has been saved with.
+       */
+      bs::UINT32 version = VERSION;
+
+      /**
+       * Hash of the script files the VM has been built from, see hashSnapshotSource().
+       */
+      bs::UINT64 sourceHash = 0;
+
+      ScriptSymbolStorage symbols;
+      ScriptObjectStorage objects;
+      ScriptObjectMapping mapping;
+
+      REGOTH_DECLARE_RTTI_FOR_REFLECTABLE(ScriptVMSnapshot)
+    };
+
+    /**
+     * @return Hash of the given data, to key a snapshot with.
+     */
+    bs::UINT64 hashSnapshotSource(const std::vector<bs::UINT8>& data);
+  }  // namespace Scripting
+}  // namespace REGoth
@@ -0,0 +1,89 @@
+#include "SvmTable.hpp"
+#include "ScriptObject.hpp"
+#include <exception/Throw.hpp>
+
+namespace REGoth
+{
+  namespace Scripting
+  {
+    void SvmTable::clear()
+    {
+      mKeysByName.clear();
+      mOutputNames.clear();
+      mKeyLayout = nullptr;
+      mNumVoices = 0;
+    }
+
+    void SvmTable::setKeys(const ScriptClassLayout& svmLayout)
+    {
+      clear();
+
+      mKeyLayout = &svmLayout;
+
+      const bs::Vector<ScriptClassMember>& members = svmLayout.members(SymbolType::String);
+
+      for (SvmKey key = 0; key < (SvmKey)members.size(); key++)
+      {
+        mKeysByName[members[key].name] = key;
+      }
+    }
+
+    void SvmTable::setVoice(bs::INT32 voice, ScriptObject& svm)
+    {
+      if (voice < 0)
+      {
+        REGOTH_THROW(InvalidParametersException, "Voice must not be negative");
+      }
+
+      bs::UINT32 numKeys = this->numKeys();
+
+      if ((bs::UINT32)voice >= mNumVoices)
+      {
+        mNumVoices = (bs::UINT32)voice + 1;
+        mOutputNames.resize(mNumVoices * numKeys);
+      }
+
+      for (SvmKey key = 0; key < numKeys; key++)
+      {
+        ScriptStringsRef values = svm.stringSlot({mKeyLayout, key});
+
+        if (values.size() == 0) continue;
+
+        mOutputNames[voice * numKeys + key] = values[0];
+      }
+    }
+
+    SvmKey SvmTable::findKey(const bs::String& svmName) const
+    {
+      bs::String name = svmName;
+
+      if (!name.empty() && name[0] == '$')
+      {
+        name.erase(0, 1);
+      }
+
+      bs::StringUtil::toUpperCase(name);
+
+      auto it = mKeysByName.find(name);
+
+      if (it == mKeysByName.end()) return SVM_KEY_INVALID;
+
+      return it->second;
+    }
+
+    const bs::String& SvmTable::outputName(bs::INT32 voice, SvmKey key) const
+    {
+      if (voice < 0 || (bs::UINT32)voice >= mNumVoices || key >= numKeys())
+      {
+        return bs::StringUtil::BLANK;
+      }
+
+      return mOutputNames[voice * numKeys() + key];
+    }
+
+    bs::String SvmTable::soundFileOf(const bs::String& outputName)
+    {
+      return outputName + ".WAV";
+    }
+  }  // namespace Scripting
+}  // namespace REGoth
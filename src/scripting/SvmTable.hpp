@@ -0,0 +1,95 @@
+#pragma once
+#include "ScriptClassLayout.hpp"
+#include <BsPrerequisites.h>
+
+namespace REGoth
+{
+  namespace Scripting
+  {
+    class ScriptObject;
+
+    /**
+     * Slot of an SVM among the string members of `C_SVM`, like the one of `SMALLTALK01`. Stays
+     * the same as long as the same script files are used. See SvmTable::findKey().
+     */
+    typedef MemberSlotIndex SvmKey;
+
+    enum : SvmKey
+    {
+      SVM_KEY_INVALID = MEMBER_SLOT_INVALID
+    };
+
+    /**
+     * What every voice says for each *Standard Voice Module* (SVM), like greetings or insults.
+     *
+     * Every voice has a `C_SVM` instance called `SVM_<voice>`, e.g. `SVM_11`. Its string
+     * members map the SVM keys to output names, e.g. `SMALLTALK01` to `SVM_11_SMALLTALK01`.
+     * Those are also the names of the sound files to play, see soundFileOf().
+     *
+     * Instead of creating the instance of the voice and looking up the member by name whenever
+     * a character speaks, all instances are read once after the scripts have been loaded. An
+     * output is then a lookup in a flat array by voice and key. See
+     * DaedalusVMForGameWorld::svmTable().
+     */
+    class SvmTable
+    {
+    public:
+      /**
+       * Forgets all keys and voices.
+       */
+      void clear();
+
+      /**
+       * Sets the keys to the string members of `C_SVM`. Forgets all voices.
+       */
+      void setKeys(const ScriptClassLayout& svmLayout);
+
+      /**
+       * Sets what the given voice says, taken from its `C_SVM` instance. The keys have to
+       * be set already, from the layout bound to that instance.
+       */
+      void setVoice(bs::INT32 voice, ScriptObject& svm);
+
+      /**
+       * @param  svmName  Name of the SVM as used by the scripts, e.g. `$SmallTalk01`. The
+       *                  leading `$` is optional and case doesn't matter.
+       *
+       * @return Key of the given SVM, SVM_KEY_INVALID if there is none.
+       */
+      SvmKey findKey(const bs::String& svmName) const;
+
+      /**
+       * @return What the given voice says for the given key, e.g. `SVM_11_SMALLTALK01`. Empty
+       *         if the voice or key is unknown or the voice has nothing to say for it.
+       */
+      const bs::String& outputName(bs::INT32 voice, SvmKey key) const;
+
+      /**
+       * @return Name of the sound file of the given output, e.g. `SVM_11_SMALLTALK01.WAV`.
+       */
+      static bs::String soundFileOf(const bs::String& outputName);
+
+      bs::UINT32 numVoices() const
+      {
+        return mNumVoices;
+      }
+
+      bs::UINT32 numKeys() const
+      {
+        return (bs::UINT32)mKeysByName.size();
+      }
+
+    private:
+      /** UPPERCASE name without `$` -> Key */
+      bs::UnorderedMap<bs::String, SvmKey> mKeysByName;
+
+      /** Layout of `C_SVM` the keys are slots of, see setKeys() */
+      const ScriptClassLayout* mKeyLayout = nullptr;
+
+      /** Output names by voice, then key: `voice * numKeys() + key` */
+      bs::Vector<bs::String> mOutputNames;
+
+      bs::UINT32 mNumVoices = 0;
+    };
+  }  // namespace Scripting
+}  // namespace REGoth
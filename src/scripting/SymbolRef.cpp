@@ -0,0 +1,36 @@
+#include "SymbolRef.hpp"
+#include "ScriptSymbolStorage.hpp"
+
+namespace REGoth
+{
+  namespace Scripting
+  {
+    bool SymbolRef::isCachedIn(const ScriptSymbolStorage& symbols) const
+    {
+      if (mIndex == SYMBOL_INDEX_INVALID) return false;
+      if (mIndex >= symbols.numSymbols()) return false;
+
+      return symbols.getSymbolName(mIndex) == mName;
+    }
+
+    SymbolIndex SymbolRef::resolve(const ScriptSymbolStorage& symbols) const
+    {
+      if (!isCachedIn(symbols))
+      {
+        mIndex = symbols.findIndexBySymbolName(mName);
+      }
+
+      return mIndex;
+    }
+
+    bool SymbolRef::exists(const ScriptSymbolStorage& symbols) const
+    {
+      if (isCachedIn(symbols)) return true;
+      if (!symbols.hasSymbolWithName(mName)) return false;
+
+      mIndex = symbols.findIndexBySymbolName(mName);
+
+      return true;
+    }
+  }  // namespace Scripting
+}  // namespace REGoth
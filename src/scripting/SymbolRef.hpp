@@ -0,0 +1,64 @@
+#pragma once
+#include "ScriptTypes.hpp"
+#include <BsPrerequisites.h>
+
+namespace REGoth
+{
+  namespace Scripting
+  {
+    class ScriptSymbolStorage;
+
+    /**
+     * Name of a symbol which is only looked up once, for native code calling into the scripts
+     * with a constant name, e.g. `PrintPlus`. Looking up a name means uppercasing it and
+     * searching the name index of the symbol storage, which is not free when done every frame.
+     *
+     * The index found is cached. Since the symbols might have been reloaded in the meantime or
+     * the reference might be used with a different storage, every use checks that the cached
+     * index still refers to a symbol with that name, which is a lot cheaper than searching it.
+     *
+     * Meant to be kept as `static const`, next to the code using it:
+     *
+     *     static const SymbolRef PRINT_PLUS("PRINTPLUS");
+     *     executeScriptFunction(PRINT_PLUS);
+     */
+    class SymbolRef
+    {
+    public:
+      /**
+       * @param  uppercaseName  Name of the symbol, already in uppercase like all symbol names.
+       *                        Must outlive the reference, which is the case for literals.
+       */
+      explicit SymbolRef(const char* uppercaseName)
+          : mName(uppercaseName)
+      {
+      }
+
+      /**
+       * @return Index of the symbol inside the given storage.
+       *
+       * Throws if no such symbol exists.
+       */
+      SymbolIndex resolve(const ScriptSymbolStorage& symbols) const;
+
+      /**
+       * @return Whether the symbol exists inside the given storage.
+       */
+      bool exists(const ScriptSymbolStorage& symbols) const;
+
+      const char* name() const
+      {
+        return mName;
+      }
+
+    private:
+      /**
+       * @return Whether mIndex refers to the symbol inside the given storage.
+       */
+      bool isCachedIn(const ScriptSymbolStorage& symbols) const;
+
+      const char* mName;
+      mutable SymbolIndex mIndex = SYMBOL_INDEX_INVALID;
+    };
+  }  // namespace Scripting
+}  // namespace REGoth
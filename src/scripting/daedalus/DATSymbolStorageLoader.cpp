@@ -1,4 +1,6 @@
 #include "DATSymbolStorageLoader.hpp"
+#include <core/Jobs.hpp>
+#include <core/Profiling.hpp>
 #include <daedalus/DATFile.h>
 #include <scripting/ScriptSymbolStorage.hpp>
 
@@ -15,6 +17,12 @@ namespace REGoth
      *  2. Create a matching script symbol instance in the storage
      *  3. Transfer information from the ZenLib-Symbol to the REGoth-Symbol.
      *
+     * The first two stages are cheap, but change the lists of the storage, so they are done
+     * for all symbols in order. The third one, which copies all the names, strings and arrays,
+     * only touches the symbol itself and is spread across threads. Everything which needs the
+     * finished symbols, i.e. the name index and the addresses of the script functions, is
+     * built afterwards.
+     *
      * You will see quite and repetitive looking switch- and if/else-statements. This
      * could be made shorter using templates, but I decided not to for clarity.
      */
@@ -34,17 +42,47 @@ namespace REGoth
       {
         const Daedalus::PARSymTable& symTable = mDatFile.getSymTable();
 
+        bs::UINT32 numSymbols = (bs::UINT32)symTable.symbols.size();
+        SymbolIndex first     = (SymbolIndex)mStorage.numSymbols();
+
+        mStorage.reserveSymbols(first + numSymbols);
+
         for (const Daedalus::PARSymbol& sym : symTable.symbols)
         {
-          SymbolType type    = guessSymbolType(sym);
-          SymbolIndex target = createSymbolOf(type, sym.name.c_str());
-          transferSymbol(target, sym);
+          createSymbolOf(guessSymbolType(sym));
+        }
+
+        Jobs::parallelFor("DATSymbols", numSymbols, SYMBOLS_PER_TASK,
+                          [&](bs::UINT32 begin, bs::UINT32 end) {
+                            REGOTH_PROFILE_SCOPE("DATSymbolsTask");
+
+                            for (bs::UINT32 i = begin; i < end; i++)
+                            {
+                              const Daedalus::PARSymbol& sym = symTable.symbols[i];
+
+                              mStorage.getSymbolBase(first + i).name = sym.name.c_str();
+                              transferSymbol(first + i, sym);
+                            }
+                          });
+
+        mStorage.buildNameIndex();
 
-          // debugLogSymbol(mStorage.getSymbolBase(target));
+        for (bs::UINT32 i = 0; i < numSymbols; i++)
+        {
+          if (mStorage.getSymbolType(first + i) == SymbolType::ScriptFunction)
+          {
+            mStorage.registerFunctionAddress(first + i);
+          }
         }
       }
 
     private:
+      /**
+       * Symbols filled by a single task. Most symbols are a single int or a function, so
+       * there have to be quite a few to be worth a task.
+       */
+      static constexpr bs::UINT32 SYMBOLS_PER_TASK = 2048;
+
       SymbolType guessSymbolType(const Daedalus::PARSymbol& sym)
       {
         uint32_t type  = sym.properties.elemProps.type;
@@ -91,29 +129,29 @@ namespace REGoth
         }
       }
 
-      SymbolIndex createSymbolOf(SymbolType type, const bs::String& name)
+      SymbolIndex createSymbolOf(SymbolType type)
       {
         switch (type)
         {
           case SymbolType::Float:
-            return mStorage.appendSymbol<SymbolFloat>(name);
+            return mStorage.appendUnnamedSymbol<SymbolFloat>();
           case SymbolType::Int:
-            return mStorage.appendSymbol<SymbolInt>(name);
+            return mStorage.appendUnnamedSymbol<SymbolInt>();
           case SymbolType::String:
-            return mStorage.appendSymbol<SymbolString>(name);
+            return mStorage.appendUnnamedSymbol<SymbolString>();
           case SymbolType::Class:
-            return mStorage.appendSymbol<SymbolClass>(name);
+            return mStorage.appendUnnamedSymbol<SymbolClass>();
           case SymbolType::ScriptFunction:
-            return mStorage.appendSymbol<SymbolScriptFunction>(name);
+            return mStorage.appendUnnamedSymbol<SymbolScriptFunction>();
           case SymbolType::ExternalFunction:
-            return mStorage.appendSymbol<SymbolExternalFunction>(name);
+            return mStorage.appendUnnamedSymbol<SymbolExternalFunction>();
           case SymbolType::Prototype:
-            return mStorage.appendSymbol<SymbolPrototype>(name);
+            return mStorage.appendUnnamedSymbol<SymbolPrototype>();
           case SymbolType::Instance:
-            return mStorage.appendSymbol<SymbolInstance>(name);
+            return mStorage.appendUnnamedSymbol<SymbolInstance>();
           case SymbolType::Unsupported:
           default:
-            return mStorage.appendSymbol<SymbolUnsupported>(name);
+            return mStorage.appendUnnamedSymbol<SymbolUnsupported>();
         }
       }
 
@@ -308,7 +346,7 @@ namespace REGoth
             break;
         }
 
-        mStorage.registerFunctionAddress(target.index);
+        // The address is registered once all symbols are filled, see loadFromDAT()
       }
 
       void fill(SymbolPrototype& target, const Daedalus::PARSymbol& source)
@@ -334,12 +372,16 @@ namespace REGoth
       ScriptSymbolStorage& mStorage;
     };
 
+    constexpr bs::UINT32 DATSymbolStorageLoader::SYMBOLS_PER_TASK;
+
     void convertDatToREGothSymbolStorage(ScriptSymbolStorage& storage,
                                          const Daedalus::DATFile& datFile)
     {
       DATSymbolStorageLoader loader(storage, datFile);
 
       loader.loadFromDAT();
+
+      storage.buildQueryIndices();
     }
   }  // namespace Scripting
 }  // namespace REGoth
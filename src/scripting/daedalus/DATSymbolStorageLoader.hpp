@@ -15,7 +15,8 @@ namespace REGoth
 
     /**
      * Will take the given DAT-File, convert all symbols inside and place them
-     * inside the given script symbol storage.
+     * inside the given script symbol storage. Also builds the query indices of the
+     * storage, see ScriptSymbolStorage::buildQueryIndices().
      *
      * @param  storage  The target script symbol storage.
      * @param  datFile  The input DAT-File to convert from.
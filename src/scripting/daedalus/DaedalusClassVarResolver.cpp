@@ -5,90 +5,55 @@ namespace REGoth
   namespace Scripting
   {
     DaedalusClassVarResolver::DaedalusClassVarResolver(const ScriptSymbolStorage& scriptSymbols,
-                                                       ScriptObjectStorage& scriptObjects)
+                                                       ScriptObjectStorage& scriptObjects,
+                                                       const ScriptClassTemplates& classTemplates)
         : mScriptSymbols(scriptSymbols)
         , mScriptObjects(scriptObjects)
+        , mClassTemplates(classTemplates)
     {
     }
 
-    ScriptInts& DaedalusClassVarResolver::resolveClassVariableInts(
-        const bs::String& memberSymbolName)
+    ScriptIntsRef DaedalusClassVarResolver::resolveClassVariableInts(SymbolIndex memberSymbol)
     {
-      throwIfCurrentInstanceNotMatching(memberSymbolName);
+      MemberSlot slot = getMemberSlotOrThrow(memberSymbol);
 
-      ScriptObject& obj = getCurrentInstanceObject();
-      bs::String member = demangleMemberName(memberSymbolName);
-
-      auto it = obj.ints.find(member);
-
-      if (it == obj.ints.end())
-      {
-        REGOTH_THROW(InvalidParametersException, "Current Instance Object of class " +
-                                                     obj.className + " does not have member " +
-                                                     member + " of type INT.");
-      }
-
-      return it->second;
+      return getCurrentInstanceObject().intSlot(slot);
     }
 
     bs::UINT32& DaedalusClassVarResolver::resolveClassVariableFunctionPointer(
-        const bs::String& memberSymbolName)
+        SymbolIndex memberSymbol)
     {
-      throwIfCurrentInstanceNotMatching(memberSymbolName);
-
-      ScriptObject& obj = getCurrentInstanceObject();
-      bs::String member = demangleMemberName(memberSymbolName);
-
-      auto it = obj.functionPointers.find(member);
-
-      if (it == obj.functionPointers.end())
-      {
-        REGOTH_THROW(InvalidParametersException, "Current Instance Object of class " +
-                                                     obj.className + " does not have member " +
-                                                     member + " of type FUNCTION POINTER.");
-      }
+      MemberSlot slot = getMemberSlotOrThrow(memberSymbol);
 
-      return it->second;
+      return getCurrentInstanceObject().functionPointerSlot(slot);
     }
 
-    ScriptFloats& DaedalusClassVarResolver::resolveClassVariableFloats(
-        const bs::String& memberSymbolName)
+    ScriptFloatsRef DaedalusClassVarResolver::resolveClassVariableFloats(SymbolIndex memberSymbol)
     {
-      throwIfCurrentInstanceNotMatching(memberSymbolName);
-
-      ScriptObject& obj = getCurrentInstanceObject();
-      bs::String member = demangleMemberName(memberSymbolName);
-
-      auto it = obj.floats.find(member);
+      MemberSlot slot = getMemberSlotOrThrow(memberSymbol);
 
-      if (it == obj.floats.end())
-      {
-        REGOTH_THROW(InvalidParametersException, "Current Instance Object of class " +
-                                                     obj.className + " does not have member " +
-                                                     member + " of type FLOAT.");
-      }
-
-      return it->second;
+      return getCurrentInstanceObject().floatSlot(slot);
     }
 
-    ScriptStrings& DaedalusClassVarResolver::resolveClassVariableStrings(
-        const bs::String& memberSymbolName)
+    ScriptStringsRef DaedalusClassVarResolver::resolveClassVariableStrings(
+        SymbolIndex memberSymbol)
     {
-      throwIfCurrentInstanceNotMatching(memberSymbolName);
+      MemberSlot slot = getMemberSlotOrThrow(memberSymbol);
 
-      ScriptObject& obj = getCurrentInstanceObject();
-      bs::String member = demangleMemberName(memberSymbolName);
+      return getCurrentInstanceObject().stringSlot(slot);
+    }
 
-      auto it = obj.strings.find(member);
+    MemberSlot DaedalusClassVarResolver::getMemberSlotOrThrow(SymbolIndex memberSymbol) const
+    {
+      MemberSlot slot = mClassTemplates.getMemberSlot(memberSymbol);
 
-      if (it == obj.strings.end())
+      if (!slot.isValid())
       {
-        REGOTH_THROW(InvalidParametersException, "Current Instance Object of class " +
-                                                     obj.className + " does not have member " +
-                                                     member + " of type STRING.");
+        REGOTH_THROW(InvalidParametersException,
+                     mScriptSymbols.getSymbolName(memberSymbol) + " is not a member variable.");
       }
 
-      return it->second;
+      return slot;
     }
 
     bool DaedalusClassVarResolver::isCurrentInstanceValid() const
@@ -143,36 +108,5 @@ namespace REGoth
         REGOTH_THROW(InvalidStateException, "Current Instance is not valid!");
       }
     }
-
-    void DaedalusClassVarResolver::throwIfCurrentInstanceNotMatching(
-        const bs::String& memberSymbolName) const
-    {
-      bs::String expected = extractClassNameFromMemberSymbol(memberSymbolName);
-
-      throwIfCurrentInstanceNotOfClass(expected);
-    }
-
-    bs::String DaedalusClassVarResolver::demangleMemberName(const bs::String& memberSymbolName)
-    {
-      auto nameParts = bs::StringUtil::split(memberSymbolName, ".");
-
-      if (nameParts.size() != 2) return memberSymbolName;
-
-      return nameParts[1];
-    }
-
-    bs::String DaedalusClassVarResolver::extractClassNameFromMemberSymbol(
-        const bs::String& memberSymbolName) const
-    {
-      auto nameParts = bs::StringUtil::split(memberSymbolName, ".");
-
-      if (nameParts.size() != 2)
-      {
-        REGOTH_THROW(InvalidParametersException,
-                     memberSymbolName + " does not look like a Member Symbol Name.");
-      }
-
-      return nameParts[0];
-    }
   }  // namespace Scripting
 }  // namespace REGoth
@@ -3,6 +3,7 @@
 #pragma once
 #include <BsPrerequisites.h>
 #include "scripting/ScriptSymbolStorage.hpp"
+#include <scripting/ScriptClassTemplates.hpp>
 #include <scripting/ScriptObjectStorage.hpp>
 
 namespace REGoth
@@ -22,7 +23,8 @@ namespace REGoth
     {
     public:
       DaedalusClassVarResolver(const ScriptSymbolStorage& scriptSymbols,
-                               ScriptObjectStorage& scriptObjects);
+                               ScriptObjectStorage& scriptObjects,
+                               const ScriptClassTemplates& classTemplates);
 
       /**
        * @return Whether the instance set in the *Current Instance*-register is valid.
@@ -53,30 +55,31 @@ namespace REGoth
       /**
        * Get a reference to the data of the member variable in the *Current Instance*.
        *
-       * If passed a string like `C_ITEM.VALUE`, this will return a reference to
+       * If passed the symbol of `C_ITEM.VALUE`, this will return a reference to
        * the `VALUE`-members data from the instance set in the *Current Instance*-
        * register.
        *
+       * The member is looked up via the slot assigned to the symbol when the class templates
+       * were created, see ScriptClassTemplates::getMemberSlot().
+       *
        * Throws if the member does not exist or no *Current Instance* is set.
        *
-       * @param  memberSymbolName  Actual symbol name of the member variable, e.g.
-       * `C_ITEM.VALUE`.
+       * @param  memberSymbol  Symbol of the member variable, e.g. `C_ITEM.VALUE`.
        *
        * @return Reference to that members data within the *Current Instance*.
        */
-      ScriptInts& resolveClassVariableInts(const bs::String& memberSymbolName);
+      ScriptIntsRef resolveClassVariableInts(SymbolIndex memberSymbol);
 
       /** @copydoc resolveClassVariableInts */
-      bs::UINT32& resolveClassVariableFunctionPointer(const bs::String& memberSymbolName);
+      bs::UINT32& resolveClassVariableFunctionPointer(SymbolIndex memberSymbol);
 
       /** @copydoc resolveClassVariableInts */
-      ScriptFloats& resolveClassVariableFloats(const bs::String& memberSymbolName);
+      ScriptFloatsRef resolveClassVariableFloats(SymbolIndex memberSymbol);
 
       /** @copydoc resolveClassVariableInts */
-      ScriptStrings& resolveClassVariableStrings(const bs::String& memberSymbolName);
+      ScriptStringsRef resolveClassVariableStrings(SymbolIndex memberSymbol);
 
     private:
-
       /**
        * Throws if the object referenced via *Current Instance* is not of the given
        * class name.
@@ -89,41 +92,10 @@ namespace REGoth
       void throwIfCurrentInstanceIsInvalid() const;
 
       /**
-       * Throws if the object referenced via *Current Instance* is not matching the
-       * class named within the member variables symbol name. So if the *Current Instance*
-       * is of class `C_NPC` and the given Member Symbol Name is like `C_ITEM.SOMETHING`,
-       * then this method will throw.
-       *
-       * It will also throw if the *Current Instance* is invalid.
-       */
-      void throwIfCurrentInstanceNotMatching(const bs::String& memberSymbolName) const;
-
-      /**
-       * Given the name of a member symbol, e.g. `C_ITEM.VALUE`, this will return the name
-       * of the class, so `C_ITEM`.
-       *
-       * Throws if the given name does not match the pattern.
-       *
-       * @return Name of the class the given member variable belongs to.
-       */
-      bs::String extractClassNameFromMemberSymbol(const bs::String& memberSymbolName) const;
-
-      /**
-       * Converts a symbol name to the actual member variable name.
-       *
-       * Inside the symbol-table the symbols for member variables are named
-       * like `C_ITEM.SOMETHING`. In our templates, we don't want to repeat
-       * the class name in all member variables, so we can just strip the
-       * part before and including the `.` to clean it.
-       *
-       * If there is no `.` or if there is more than one, then the whole name is returned.
-       *
-       * @param  memberSymbolName  Name of the symbol from the member variable, e.g.
-       *                           `C_ITEM.SOMETHING`.
-       *
-       * @return Actual member variable name.
+       * Looks up the slot of the given member symbol. Throws if the symbol
+       * is not a member variable.
        */
-      bs::String demangleMemberName(const bs::String& memberSymbolName);
+      MemberSlot getMemberSlotOrThrow(SymbolIndex memberSymbol) const;
 
       /**
        * *Current Instance*-Register of the VM. This is basically the this-pointer for code running
@@ -132,6 +104,7 @@ namespace REGoth
       ScriptObjectHandle mCurrentInstance;
       const ScriptSymbolStorage& mScriptSymbols;
       ScriptObjectStorage& mScriptObjects;
+      const ScriptClassTemplates& mClassTemplates;
     };
   }  // namespace Scripting
 }  // namespace REGoth
@@ -1,12 +1,13 @@
 #include "DaedalusDisassembler.hpp"
 #include "scripting/ScriptSymbolQueries.hpp"
+#include <daedalus/DATFile.h>
 #include <scripting/ScriptSymbolStorage.hpp>
 
 namespace REGoth
 {
   namespace Scripting
   {
-    bs::String disassembleOpcode(const Daedalus::PARStackOpCode& opcode,
+    bs::String disassembleOpcode(const DaedalusInstruction& opcode,
                                  const ScriptSymbolStorage& symbols, const bs::String& lhs,
                                  const bs::String& rhs, const bs::String& res)
     {
@@ -122,19 +123,20 @@ namespace REGoth
           // -----------------------------------------------------------------------------------
 
         case Daedalus::EParOp_PushInt:
-          return bs::StringUtil::format("PushInt {0}", opcode.value);
+          return bs::StringUtil::format("PushInt {0}", opcode.operand);
 
         case Daedalus::EParOp_PushVar:
-          return bs::StringUtil::format("PushVar {0}: {1}", symName(opcode.symbol),
-                                        symValue(opcode.symbol));
+          return bs::StringUtil::format("PushVar {0}: {1}", symName(opcode.symbol()),
+                                        symValue(opcode.symbol()));
 
         case Daedalus::EParOp_PushInstance:
-          return bs::StringUtil::format("PushInstance {0}", symName(opcode.symbol),
-                                        symValue(opcode.symbol));
+          return bs::StringUtil::format("PushInstance {0}", symName(opcode.symbol()),
+                                        symValue(opcode.symbol()));
 
         case Daedalus::EParOp_PushArrayVar:
-          return bs::StringUtil::format("PushArrayVar {0}[{1}]", symName(opcode.symbol),
-                                        (int)opcode.index, symValue(opcode.symbol, opcode.index));
+          return bs::StringUtil::format("PushArrayVar {0}[{1}]", symName(opcode.symbol()),
+                                        (int)opcode.arrayIndex,
+                                        symValue(opcode.symbol(), opcode.arrayIndex));
 
           // Assign
           // ----------------------------------------------------------------------------------
@@ -176,29 +178,152 @@ namespace REGoth
           return bs::StringUtil::format("Return");
 
         case Daedalus::EParOp_Jump:
-          return bs::StringUtil::format("Jump -> {0}", opcode.address);
+          return bs::StringUtil::format("Jump -> {0}", opcode.address());
 
         case Daedalus::EParOp_JumpIf:
-          return bs::StringUtil::format("JumpIf !{0} -> {1}", lhs, opcode.address);
+          return bs::StringUtil::format("JumpIf !{0} -> {1}", lhs, opcode.address());
 
         case Daedalus::EParOp_Call:
-          return bs::StringUtil::format("Call {0}", findFunctionFromAddress(opcode.address));
+          return bs::StringUtil::format("Call {0}", findFunctionFromAddress(opcode.address()));
 
         case Daedalus::EParOp_CallExternal:
-          return bs::StringUtil::format("CallExternal {0}", symName(opcode.symbol));
+          return bs::StringUtil::format("CallExternal {0}", symName(opcode.symbol()));
 
           // Other
           // -----------------------------------------------------------------------------------
 
         case Daedalus::EParOp_SetInstance:
-          return bs::StringUtil::format("SetInstance CurrentInstance = {0}", symName(opcode.symbol));
+          return bs::StringUtil::format("SetInstance CurrentInstance = {0}",
+                                        symName(opcode.symbol()));
+
+          // Superinstructions
+          // -----------------------------------------------------------------------------------
+
+        case SuperOp_JumpIfNotCompareVarInt:
+          return bs::StringUtil::format("JumpIfNot PushVar {0}; PushInt {1}; {2} {3}, {4} -> {5}",
+                                        symName(opcode.symbol()), opcode.operand2,
+                                        opcodeName(opcode.subOp), lhs, rhs, opcode.operand3);
+
+        case SuperOp_JumpIfNotCompareIntVar:
+          return bs::StringUtil::format("JumpIfNot PushInt {0}; PushVar {1}; {2} {3}, {4} -> {5}",
+                                        opcode.operand2, symName(opcode.symbol()),
+                                        opcodeName(opcode.subOp), lhs, rhs, opcode.operand3);
+
+        case SuperOp_PushInstanceSetInstance:
+          return bs::StringUtil::format("PushInstance {0}; SetInstance CurrentInstance = {1}",
+                                        symName(opcode.symbol()),
+                                        symName((SymbolIndex)opcode.operand2));
+
+        case SuperOp_AssignVar:
+          return bs::StringUtil::format("AssignVar {0} = {1}",
+                                        symName((SymbolIndex)opcode.operand2),
+                                        symName(opcode.symbol()));
 
         default:
-          return bs::StringUtil::format("Unknown Opcode {0}", opcode.op);
+          return bs::StringUtil::format("Unknown Opcode {0}", (int)opcode.op);
           break;
       }
     }
 
+    bs::String opcodeName(bs::UINT8 op)
+    {
+      switch (op)
+      {
+        case Daedalus::EParOp_Add:
+          return "Add";
+        case Daedalus::EParOp_Subract:
+          return "Subract";
+        case Daedalus::EParOp_Multiply:
+          return "Multiply";
+        case Daedalus::EParOp_Divide:
+          return "Divide";
+        case Daedalus::EParOp_Mod:
+          return "Mod";
+        case Daedalus::EParOp_BinOr:
+          return "BinOr";
+        case Daedalus::EParOp_BinAnd:
+          return "BinAnd";
+        case Daedalus::EParOp_ShiftLeft:
+          return "ShiftLeft";
+        case Daedalus::EParOp_ShiftRight:
+          return "ShiftRight";
+        case Daedalus::EParOp_Negate:
+          return "Negate";
+        case Daedalus::EParOp_LogOr:
+          return "LogOr";
+        case Daedalus::EParOp_LogAnd:
+          return "LogAnd";
+        case Daedalus::EParOp_Less:
+          return "Less";
+        case Daedalus::EParOp_Greater:
+          return "Greater";
+        case Daedalus::EParOp_LessOrEqual:
+          return "LessOrEqual";
+        case Daedalus::EParOp_Equal:
+          return "Equal";
+        case Daedalus::EParOp_NotEqual:
+          return "NotEqual";
+        case Daedalus::EParOp_GreaterOrEqual:
+          return "GreaterOrEqual";
+        case Daedalus::EParOp_Plus:
+          return "Plus";
+        case Daedalus::EParOp_Minus:
+          return "Minus";
+        case Daedalus::EParOp_Not:
+          return "Not";
+        case Daedalus::EParOp_PushInt:
+          return "PushInt";
+        case Daedalus::EParOp_PushVar:
+          return "PushVar";
+        case Daedalus::EParOp_PushInstance:
+          return "PushInstance";
+        case Daedalus::EParOp_PushArrayVar:
+          return "PushArrayVar";
+        case Daedalus::EParOp_AssignFunc:
+          return "AssignFunc";
+        case Daedalus::EParOp_AssignString:
+          return "AssignString";
+        case Daedalus::EParOp_AssignFloat:
+          return "AssignFloat";
+        case Daedalus::EParOp_AssignInstance:
+          return "AssignInstance";
+        case Daedalus::EParOp_Assign:
+          return "Assign";
+        case Daedalus::EParOp_AssignAdd:
+          return "AssignAdd";
+        case Daedalus::EParOp_AssignSubtract:
+          return "AssignSubtract";
+        case Daedalus::EParOp_AssignMultiply:
+          return "AssignMultiply";
+        case Daedalus::EParOp_AssignDivide:
+          return "AssignDivide";
+        case Daedalus::EParOp_AssignStringRef:
+          return "AssignStringRef";
+        case Daedalus::EParOp_Ret:
+          return "Ret";
+        case Daedalus::EParOp_Jump:
+          return "Jump";
+        case Daedalus::EParOp_JumpIf:
+          return "JumpIf";
+        case Daedalus::EParOp_Call:
+          return "Call";
+        case Daedalus::EParOp_CallExternal:
+          return "CallExternal";
+        case Daedalus::EParOp_SetInstance:
+          return "SetInstance";
+        case SuperOp_JumpIfNotCompareVarInt:
+          return "JumpIfNotCompareVarInt";
+        case SuperOp_JumpIfNotCompareIntVar:
+          return "JumpIfNotCompareIntVar";
+        case SuperOp_PushInstanceSetInstance:
+          return "PushInstanceSetInstance";
+        case SuperOp_AssignVar:
+          return "AssignVar";
+        default:
+          return "Unknown" + bs::toString((int)op);
+      }
+    }
+
     bs::String makeCallDepthString(bs::UINT32 callDepth)
     {
       bs::String depth = "";
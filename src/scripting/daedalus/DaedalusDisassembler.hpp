@@ -2,7 +2,7 @@
  */
 #pragma once
 #include <BsPrerequisites.h>
-#include <daedalus/DATFile.h>
+#include "DaedalusInstructionMemory.hpp"
 
 namespace REGoth
 {
@@ -15,10 +15,16 @@ namespace REGoth
      *
      * @return Disassembly as text.
      */
-    bs::String disassembleOpcode(const Daedalus::PARStackOpCode& opcode,
+    bs::String disassembleOpcode(const DaedalusInstruction& opcode,
                                  const ScriptSymbolStorage& symbols, const bs::String& lhs = "a",
                                  const bs::String& rhs = "b", const bs::String& res = "");
 
+    /**
+     * @return Name of the given opcode, like `PushVar`. Also knows the superinstructions,
+     *         see DaedalusSuperinstruction.
+     */
+    bs::String opcodeName(bs::UINT8 op);
+
     /**
      * Makes a string with different characters for every call-depth.
      *
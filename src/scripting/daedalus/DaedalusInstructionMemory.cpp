@@ -0,0 +1,649 @@
+#include "DaedalusInstructionMemory.hpp"
+#include <daedalus/DATFile.h>
+#include <exception/Throw.hpp>
+#include <limits>
+#include <scripting/ScriptSymbolStorage.hpp>
+
+namespace REGoth
+{
+  namespace Scripting
+  {
+    DaedalusInstruction toDaedalusInstruction(const Daedalus::PARStackOpCode& opcode)
+    {
+      DaedalusInstruction instruction;
+      instruction.op         = (bs::UINT8)opcode.op;
+      instruction.arrayIndex = (bs::UINT8)opcode.index;
+      instruction.size       = (bs::UINT8)opcode.opSize;
+      instruction.subOp      = 0;
+      instruction.operand2   = 0;
+      instruction.operand3   = 0;
+
+      switch (opcode.op)
+      {
+        case Daedalus::EParOp_PushInt:
+          instruction.operand = opcode.value;
+          break;
+
+        case Daedalus::EParOp_Jump:
+        case Daedalus::EParOp_JumpIf:
+        case Daedalus::EParOp_Call:
+          instruction.operand = opcode.address;
+          break;
+
+        default:
+          instruction.operand = opcode.symbol;
+          break;
+      }
+
+      return instruction;
+    }
+
+    bs::INT32 compareInts(bs::UINT8 op, bs::INT32 lhs, bs::INT32 rhs)
+    {
+      switch (op)
+      {
+        case Daedalus::EParOp_Less:
+          return lhs < rhs ? 1 : 0;
+        case Daedalus::EParOp_Greater:
+          return lhs > rhs ? 1 : 0;
+        case Daedalus::EParOp_LessOrEqual:
+          return lhs <= rhs ? 1 : 0;
+        case Daedalus::EParOp_Equal:
+          return lhs == rhs ? 1 : 0;
+        case Daedalus::EParOp_NotEqual:
+          return lhs != rhs ? 1 : 0;
+        case Daedalus::EParOp_GreaterOrEqual:
+          return lhs >= rhs ? 1 : 0;
+        default:
+          REGOTH_THROW(InvalidStateException,
+                       "Not a comparison opcode: " + bs::toString((int)op));
+      }
+    }
+
+    void DaedalusInstructionMemory::reset(bs::SPtr<Daedalus::DATFile> datFile)
+    {
+      mDatFile = datFile;
+
+      mInstructions.clear();
+      mInstructionIndexByAddress.clear();
+    }
+
+    void DaedalusInstructionMemory::decodeAllFunctions(const ScriptSymbolStorage& symbols)
+    {
+      for (SymbolIndex index : symbols.symbolsOfType(SymbolType::ScriptFunction))
+      {
+        decodeReachableFrom(symbols.getSymbol<SymbolScriptFunction>(index).address);
+      }
+    }
+
+    /**
+     * @return Whether the given opcode compares two integers and can be part of a
+     *         JumpIfNotCompare-superinstruction.
+     */
+    static bool isFusableComparison(bs::UINT8 op)
+    {
+      switch (op)
+      {
+        case Daedalus::EParOp_Less:
+        case Daedalus::EParOp_Greater:
+        case Daedalus::EParOp_LessOrEqual:
+        case Daedalus::EParOp_Equal:
+        case Daedalus::EParOp_NotEqual:
+        case Daedalus::EParOp_GreaterOrEqual:
+          return true;
+
+        default:
+          return false;
+      }
+    }
+
+    bs::Map<bs::UINT8, bs::UINT32> DaedalusInstructionMemory::fuseSuperinstructions(
+        const ScriptSymbolStorage& symbols)
+    {
+      bs::Map<bs::UINT8, bs::UINT32> numFused;
+
+      auto isIntVariable = [&](const DaedalusInstruction& instruction) {
+        return instruction.op == Daedalus::EParOp_PushVar &&
+               symbols.getSymbolType(instruction.symbol()) == SymbolType::Int;
+      };
+
+      for (bs::UINT32 address = 0; address < mInstructionIndexByAddress.size(); address++)
+      {
+        if (!isDecoded(address)) continue;
+
+        // Instructions following each other inside the bytecode, starting at the current
+        // address. Entries after the first one which is not decoded are nullptr.
+        const DaedalusInstruction* seq[4] = {};
+        bs::UINT32 seqEnd[4]              = {};
+        bs::UINT32 next                   = address;
+
+        for (bs::UINT32 i = 0; i < 4 && isDecoded(next); i++)
+        {
+          seq[i]    = &mInstructions[mInstructionIndexByAddress[next]];
+          next      = next + seq[i]->size;
+          seqEnd[i] = next;
+        }
+
+        // Since we're going through the addresses in order, everything at or after the
+        // current address is still an original instruction.
+        DaedalusInstruction fused = *seq[0];
+
+        if (seq[3] && isFusableComparison(seq[2]->op) && seq[3]->op == Daedalus::EParOp_JumpIf)
+        {
+          if (isIntVariable(*seq[0]) && seq[1]->op == Daedalus::EParOp_PushInt)
+          {
+            fused.op       = SuperOp_JumpIfNotCompareVarInt;
+            fused.operand  = seq[0]->operand;
+            fused.operand2 = seq[1]->operand;
+          }
+          else if (seq[0]->op == Daedalus::EParOp_PushInt && isIntVariable(*seq[1]))
+          {
+            fused.op       = SuperOp_JumpIfNotCompareIntVar;
+            fused.operand  = seq[1]->operand;
+            fused.operand2 = seq[0]->operand;
+          }
+
+          fused.subOp    = seq[2]->op;
+          fused.operand3 = seq[3]->operand;
+          fused.size     = (bs::UINT8)(seqEnd[3] - address);
+        }
+        else if (seq[1] && seq[0]->op == Daedalus::EParOp_PushInstance &&
+                 seq[1]->op == Daedalus::EParOp_SetInstance)
+        {
+          fused.op       = SuperOp_PushInstanceSetInstance;
+          fused.operand2 = seq[1]->operand;
+          fused.size     = (bs::UINT8)(seqEnd[1] - address);
+        }
+        else if (seq[2] && isIntVariable(*seq[0]) && isIntVariable(*seq[1]) &&
+                 seq[2]->op == Daedalus::EParOp_Assign)
+        {
+          fused.op       = SuperOp_AssignVar;
+          fused.operand2 = seq[1]->operand;
+          fused.size     = (bs::UINT8)(seqEnd[2] - address);
+        }
+
+        if (fused.op != seq[0]->op)
+        {
+          mInstructions[mInstructionIndexByAddress[address]] = fused;
+          numFused[fused.op] += 1;
+        }
+      }
+
+      return numFused;
+    }
+
+    /**
+     * @return Whether the given opcode assigns to the variable pushed right before it.
+     */
+    static bool isIntAssignment(bs::UINT8 op)
+    {
+      switch (op)
+      {
+        case Daedalus::EParOp_Assign:
+        case Daedalus::EParOp_AssignAdd:
+        case Daedalus::EParOp_AssignSubtract:
+        case Daedalus::EParOp_AssignMultiply:
+        case Daedalus::EParOp_AssignDivide:
+          return true;
+
+        default:
+          return false;
+      }
+    }
+
+    /**
+     * Computes a unary operation the same way the interpreter does, see `DaedalusOpcodes.inl`.
+     *
+     * @return Whether the opcode is a unary operation which could be computed.
+     */
+    static bool foldUnaryOperation(bs::UINT8 op, bs::INT32 lhs, bs::INT32& res)
+    {
+      switch (op)
+      {
+        case Daedalus::EParOp_Plus:
+          res = +lhs;
+          return true;
+
+        case Daedalus::EParOp_Minus:
+          if (lhs == std::numeric_limits<bs::INT32>::min()) return false;
+          res = -lhs;
+          return true;
+
+        case Daedalus::EParOp_Not:
+          res = !lhs;
+          return true;
+
+        case Daedalus::EParOp_Negate:
+          res = ~lhs;
+          return true;
+
+        default:
+          return false;
+      }
+    }
+
+    /**
+     * Computes a binary operation the same way the interpreter does, see `DaedalusOpcodes.inl`.
+     * `lhs` is the value pushed last.
+     *
+     * @return Whether the opcode is a binary operation which could be computed. Not the case
+     *         if it would be undefined behaviour, e.g. dividing by zero or overflowing.
+     */
+    static bool foldBinaryOperation(bs::UINT8 op, bs::INT32 lhs, bs::INT32 rhs, bs::INT32& res)
+    {
+      bs::INT64 wide;
+
+      switch (op)
+      {
+        case Daedalus::EParOp_Add:
+          wide = (bs::INT64)lhs + rhs;
+          break;
+
+        case Daedalus::EParOp_Subract:
+          wide = (bs::INT64)lhs - rhs;
+          break;
+
+        case Daedalus::EParOp_Multiply:
+          wide = (bs::INT64)lhs * rhs;
+          break;
+
+        case Daedalus::EParOp_Divide:
+        case Daedalus::EParOp_Mod:
+          if (rhs == 0) return false;
+          if (lhs == std::numeric_limits<bs::INT32>::min() && rhs == -1) return false;
+
+          res = op == Daedalus::EParOp_Divide ? lhs / rhs : lhs % rhs;
+          return true;
+
+        case Daedalus::EParOp_BinOr:
+          res = lhs | rhs;
+          return true;
+
+        case Daedalus::EParOp_BinAnd:
+          res = lhs & rhs;
+          return true;
+
+        case Daedalus::EParOp_ShiftLeft:
+        case Daedalus::EParOp_ShiftRight:
+          if (lhs < 0 || rhs < 0 || rhs >= 32) return false;
+
+          wide = op == Daedalus::EParOp_ShiftLeft ? (bs::INT64)lhs << rhs : lhs >> rhs;
+          break;
+
+        case Daedalus::EParOp_LogOr:
+          res = lhs || rhs ? 1 : 0;
+          return true;
+
+        case Daedalus::EParOp_LogAnd:
+          res = lhs && rhs ? 1 : 0;
+          return true;
+
+        default:
+          if (!isFusableComparison(op)) return false;
+
+          res = compareInts(op, lhs, rhs);
+          return true;
+      }
+
+      if (wide < std::numeric_limits<bs::INT32>::min() ||
+          wide > std::numeric_limits<bs::INT32>::max())
+      {
+        return false;
+      }
+
+      res = (bs::INT32)wide;
+      return true;
+    }
+
+    DaedalusFoldingStats DaedalusInstructionMemory::foldConstants(
+        const ScriptSymbolStorage& symbols)
+    {
+      DaedalusFoldingStats stats;
+
+      // The variable an assignment writes to is the one pushed right before it
+      bs::Set<SymbolIndex> assigned;
+      const DaedalusInstruction* previous = nullptr;
+      bs::UINT32 previousEnd              = 0;
+
+      forEachDecodedInstruction([&](bs::UINT32 address, const DaedalusInstruction& instruction) {
+        if (previous && previousEnd == address && isIntAssignment(instruction.op))
+        {
+          assigned.insert(previous->symbol());
+        }
+
+        previous    = &instruction;
+        previousEnd = address + instruction.size;
+      });
+
+      auto constantValueOf = [&](const DaedalusInstruction& instruction, bs::INT32& value) {
+        if (instruction.op == Daedalus::EParOp_PushInt)
+        {
+          value = instruction.operand;
+          return true;
+        }
+
+        if (instruction.op != Daedalus::EParOp_PushVar &&
+            instruction.op != Daedalus::EParOp_PushArrayVar)
+        {
+          return false;
+        }
+
+        if (symbols.getSymbolType(instruction.symbol()) != SymbolType::Int) return false;
+
+        const auto& symbol = symbols.getSymbol<SymbolInt>(instruction.symbol());
+
+        if (!symbol.isKeptAfterLoad || symbol.isClassVar) return false;
+        if (instruction.arrayIndex >= symbol.ints.size()) return false;
+        if (assigned.find(instruction.symbol()) != assigned.end()) return false;
+
+        value = symbol.ints[instruction.arrayIndex];
+        return true;
+      };
+
+      auto decodedAt = [&](bs::UINT32 address) -> const DaedalusInstruction* {
+        return isDecoded(address) ? &mInstructions[mInstructionIndexByAddress[address]] : nullptr;
+      };
+
+      // Once folded, a sequence might be folded into the one in front of it
+      bs::Set<bs::UINT32> replaced;
+      bool isChanged = true;
+
+      while (isChanged)
+      {
+        isChanged = false;
+
+        for (bs::UINT32 address = 0; address < mInstructionIndexByAddress.size(); address++)
+        {
+          if (!isDecoded(address)) continue;
+
+          DaedalusInstruction& head = mInstructions[mInstructionIndexByAddress[address]];
+          bs::INT32 value;
+
+          if (!constantValueOf(head, value)) continue;
+
+          bool isReplaced = head.op != Daedalus::EParOp_PushInt;
+
+          if (isReplaced)
+          {
+            head.op         = Daedalus::EParOp_PushInt;
+            head.arrayIndex = 0;
+            head.operand    = value;
+
+            stats.numInlinedConstants += 1;
+            isChanged = true;
+          }
+
+          // Keep folding the constant at the head with whatever follows it. Instructions
+          // replaced before do the same as the sequence they replaced, so they can be part of
+          // this one as well.
+          while (true)
+          {
+            bs::UINT32 end                  = address + head.size;
+            const DaedalusInstruction* next = decodedAt(end);
+
+            if (!next) break;
+
+            bs::INT32 result;
+            bs::UINT32 foldedEnd;
+
+            if (foldUnaryOperation(next->op, value, result))
+            {
+              foldedEnd = end + next->size;
+            }
+            else if (next->op == Daedalus::EParOp_JumpIf)
+            {
+              foldedEnd = end + next->size;
+
+              if (foldedEnd - address > std::numeric_limits<bs::UINT8>::max()) break;
+
+              // Jumps if the value is 0, otherwise continues right after
+              head.op      = Daedalus::EParOp_Jump;
+              head.operand = (bs::INT32)(value == 0 ? next->address() : foldedEnd);
+              head.size    = (bs::UINT8)(foldedEnd - address);
+
+              stats.numRemovedBranches += 1;
+              isReplaced = true;
+              isChanged  = true;
+              break;
+            }
+            else
+            {
+              bs::INT32 rhs;
+              const DaedalusInstruction* operation = decodedAt(end + next->size);
+
+              if (!operation || !constantValueOf(*next, rhs)) break;
+
+              // The value pushed last is the left hand side
+              if (!foldBinaryOperation(operation->op, rhs, value, result)) break;
+
+              foldedEnd = end + next->size + operation->size;
+            }
+
+            if (foldedEnd - address > std::numeric_limits<bs::UINT8>::max()) break;
+
+            head.operand = result;
+            head.size    = (bs::UINT8)(foldedEnd - address);
+            value        = result;
+
+            stats.numFoldedOperations += 1;
+            isReplaced = true;
+            isChanged  = true;
+          }
+
+          if (isReplaced)
+          {
+            replaced.insert(address);
+          }
+        }
+      }
+
+      stats.replacedAddresses.assign(replaced.begin(), replaced.end());
+
+      return stats;
+    }
+
+    /**
+     * @return Whether the given opcode only works on the values on the stack.
+     */
+    static bool isStackOperation(bs::UINT8 op)
+    {
+      switch (op)
+      {
+        case Daedalus::EParOp_Add:
+        case Daedalus::EParOp_Subract:
+        case Daedalus::EParOp_Multiply:
+        case Daedalus::EParOp_Divide:
+        case Daedalus::EParOp_Mod:
+        case Daedalus::EParOp_BinOr:
+        case Daedalus::EParOp_BinAnd:
+        case Daedalus::EParOp_ShiftLeft:
+        case Daedalus::EParOp_ShiftRight:
+        case Daedalus::EParOp_Negate:
+        case Daedalus::EParOp_LogOr:
+        case Daedalus::EParOp_LogAnd:
+        case Daedalus::EParOp_Less:
+        case Daedalus::EParOp_Greater:
+        case Daedalus::EParOp_LessOrEqual:
+        case Daedalus::EParOp_Equal:
+        case Daedalus::EParOp_NotEqual:
+        case Daedalus::EParOp_GreaterOrEqual:
+        case Daedalus::EParOp_Plus:
+        case Daedalus::EParOp_Minus:
+        case Daedalus::EParOp_Not:
+        case Daedalus::EParOp_PushInt:
+          return true;
+
+        default:
+          return false;
+      }
+    }
+
+    bool DaedalusInstructionMemory::isConstructorFreeOfSideEffects(
+        const ScriptSymbolStorage& symbols, bs::UINT32 address)
+    {
+      bs::Set<bs::UINT32> prototypeConstructors;
+
+      for (SymbolIndex index : symbols.symbolsOfType(SymbolType::Prototype))
+      {
+        prototypeConstructors.insert(symbols.getSymbol<SymbolPrototype>(index).constructorAddress);
+      }
+
+      auto isMember = [&](SymbolIndex index) {
+        return index < symbols.numSymbols() && symbols.getSymbolBase(index).isClassVar;
+      };
+
+      // Only members are assigned to below, the compiler doesn't allow it for constants anyways
+      auto isReadable = [&](SymbolIndex index) {
+        return isMember(index) || (index < symbols.numSymbols() &&
+                                   symbols.getSymbolBase(index).isKeptAfterLoad);
+      };
+
+      bs::Set<bs::UINT32> visited;
+      bs::Vector<bs::UINT32> open = {address};
+
+      while (!open.empty())
+      {
+        bs::UINT32 next = open.back();
+        open.pop_back();
+
+        // Whether the previous instruction pushed a member. The compiler pushes the variable to
+        // assign to right before the assignment.
+        bool isMemberPushed = false;
+
+        while (visited.insert(next).second)
+        {
+          // Copied, since decoding more might invalidate the reference
+          DaedalusInstruction instruction = instructionAt(next);
+          bs::UINT8 op                    = instruction.op;
+
+          if (instruction.size == 0) return false;
+
+          if (op == Daedalus::EParOp_Ret) break;
+
+          if (op == Daedalus::EParOp_Jump)
+          {
+            next = instruction.address();
+            continue;
+          }
+
+          bool isPushingMember = false;
+
+          if (op == Daedalus::EParOp_JumpIf)
+          {
+            open.push_back(instruction.address());
+          }
+          else if (op == Daedalus::EParOp_Call)
+          {
+            // Instance constructors start by running the one of their prototype
+            if (prototypeConstructors.count(instruction.address()) == 0) return false;
+
+            open.push_back(instruction.address());
+          }
+          else if (op == SuperOp_JumpIfNotCompareVarInt || op == SuperOp_JumpIfNotCompareIntVar)
+          {
+            if (!isReadable(instruction.operand)) return false;
+
+            open.push_back(instruction.operand3);
+          }
+          else if (op == SuperOp_AssignVar)
+          {
+            if (!isReadable(instruction.operand) || !isMember(instruction.operand2)) return false;
+          }
+          else if (op == Daedalus::EParOp_PushVar || op == Daedalus::EParOp_PushArrayVar ||
+                   op == Daedalus::EParOp_PushInstance)
+          {
+            if (!isReadable(instruction.symbol())) return false;
+
+            isPushingMember = isMember(instruction.symbol());
+          }
+          else if (isIntAssignment(op) || op == Daedalus::EParOp_AssignFloat ||
+                   op == Daedalus::EParOp_AssignString || op == Daedalus::EParOp_AssignStringRef ||
+                   op == Daedalus::EParOp_AssignFunc)
+          {
+            if (!isMemberPushed) return false;
+          }
+          else if (!isStackOperation(op))
+          {
+            // Calling externals, setting or assigning instances and whatever else there is
+            return false;
+          }
+
+          isMemberPushed = isPushingMember;
+          next += instruction.size;
+        }
+      }
+
+      return true;
+    }
+
+    bool DaedalusInstructionMemory::isDecoded(bs::UINT32 address) const
+    {
+      if (address >= mInstructionIndexByAddress.size()) return false;
+
+      return mInstructionIndexByAddress[address] != INSTRUCTION_INDEX_INVALID;
+    }
+
+    void DaedalusInstructionMemory::decodeReachableFrom(bs::UINT32 address)
+    {
+      if (!mDatFile)
+      {
+        REGOTH_THROW(InvalidStateException, "No DAT-file set to decode instructions from!");
+      }
+
+      bs::Vector<bs::UINT32> toVisit = {address};
+
+      while (!toVisit.empty())
+      {
+        bs::UINT32 pc = toVisit.back();
+        toVisit.pop_back();
+
+        // Walk down the straight-line code until we either hit something we already know
+        // or the control flow cannot continue with the next instruction.
+        while (!isDecoded(pc))
+        {
+          DaedalusInstruction instruction = toDaedalusInstruction(mDatFile->getStackOpCode(pc));
+
+          if (instruction.size == 0)
+          {
+            REGOTH_THROW(InvalidStateException,
+                         bs::StringUtil::format("Decoded instruction of size 0 at {0}", pc));
+          }
+
+          if (mInstructionIndexByAddress.size() < pc + instruction.size)
+          {
+            mInstructionIndexByAddress.resize(pc + instruction.size, INSTRUCTION_INDEX_INVALID);
+          }
+
+          mInstructionIndexByAddress[pc] = (bs::UINT32)mInstructions.size();
+          mInstructions.push_back(instruction);
+
+          bool canContinue = true;
+
+          switch (instruction.op)
+          {
+            case Daedalus::EParOp_Ret:
+              canContinue = false;
+              break;
+
+            case Daedalus::EParOp_Jump:
+              toVisit.push_back(instruction.address());
+              canContinue = false;
+              break;
+
+            case Daedalus::EParOp_JumpIf:
+            case Daedalus::EParOp_Call:
+              toVisit.push_back(instruction.address());
+              break;
+
+            default:
+              break;
+          }
+
+          if (!canContinue) break;
+
+          pc += instruction.size;
+        }
+      }
+    }
+  }  // namespace Scripting
+}  // namespace REGoth
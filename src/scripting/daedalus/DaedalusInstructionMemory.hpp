@@ -0,0 +1,319 @@
+/**\file
+ */
+#pragma once
+#include <BsPrerequisites.h>
+#include <scripting/ScriptTypes.hpp>
+
+namespace Daedalus
+{
+  class DATFile;
+  class PARStackOpCode;
+}  // namespace Daedalus
+
+namespace REGoth
+{
+  namespace Scripting
+  {
+    class ScriptSymbolStorage;
+
+    /**
+     * Opcodes of superinstructions, which do the work of a common sequence of instructions
+     * at once. These are not part of the original bytecode, but are put in place of the
+     * first instruction of such a sequence by DaedalusInstructionMemory::fuseSuperinstructions().
+     *
+     * The values are chosen to not overlap with `Daedalus::EParOp`.
+     */
+    enum DaedalusSuperinstruction : bs::UINT8
+    {
+      /**
+       * `PushVar x; PushInt k; <Comparison>; JumpIf address`, with `x` being an int variable.
+       *
+       * `operand` is `x`, `operand2` is `k`, `operand3` the address. `subOp` is the comparison.
+       */
+      SuperOp_JumpIfNotCompareVarInt = 0xE0,
+
+      /**
+       * `PushInt k; PushVar x; <Comparison>; JumpIf address`, with `x` being an int variable.
+       *
+       * `operand` is `x`, `operand2` is `k`, `operand3` the address. `subOp` is the comparison.
+       */
+      SuperOp_JumpIfNotCompareIntVar,
+
+      /**
+       * `PushInstance a; SetInstance b`.
+       *
+       * `operand` is `a`, `operand2` is `b`.
+       */
+      SuperOp_PushInstanceSetInstance,
+
+      /**
+       * `PushVar src; PushVar dst; Assign`, with both being int variables.
+       *
+       * `operand` is `src`, `operand2` is `dst`.
+       */
+      SuperOp_AssignVar,
+    };
+
+    /**
+     * A single, already decoded Daedalus instruction.
+     *
+     * This is a compact version of ZenLibs `PARStackOpCode`. Every instruction only
+     * needs one operand, which is either an immediate value, a symbol index or a
+     * bytecode address, depending on the opcode:
+     *
+     *  - `PushInt`: Immediate value
+     *  - `Jump`, `JumpIf`, `Call`: Bytecode address
+     *  - Everything else which has an operand: Symbol index
+     *
+     * `PushArrayVar` is the only instruction which also needs an array index.
+     *
+     * Superinstructions need more than one operand, see DaedalusSuperinstruction.
+     */
+    struct DaedalusInstruction
+    {
+      /**
+       * Opcode of this instruction. See `Daedalus::EParOp`.
+       */
+      bs::UINT8 op;
+
+      /**
+       * Array index for `PushArrayVar`.
+       */
+      bs::UINT8 arrayIndex;
+
+      /**
+       * Number of bytes this instruction takes up inside the bytecode.
+       * For superinstructions, this is the size of the whole sequence.
+       */
+      bs::UINT8 size;
+
+      /**
+       * Opcode of an instruction which is part of a superinstruction.
+       */
+      bs::UINT8 subOp;
+
+      /**
+       * Immediate value, symbol index or address. See the struct documentation.
+       */
+      bs::INT32 operand;
+
+      /**
+       * Additional operands of superinstructions.
+       */
+      bs::INT32 operand2;
+      bs::INT32 operand3;
+
+      /**
+       * @return The operand interpreted as symbol index.
+       */
+      SymbolIndex symbol() const
+      {
+        return (SymbolIndex)operand;
+      }
+
+      /**
+       * @return The operand interpreted as bytecode address.
+       */
+      bs::UINT32 address() const
+      {
+        return (bs::UINT32)operand;
+      }
+    };
+
+    /**
+     * Converts an opcode decoded by ZenLib into the compact form used by the VM.
+     */
+    DaedalusInstruction toDaedalusInstruction(const Daedalus::PARStackOpCode& opcode);
+
+    /**
+     * Runs one of the comparison opcodes on the given values, for superinstructions.
+     *
+     * Throws if the opcode is not a comparison.
+     */
+    bs::INT32 compareInts(bs::UINT8 op, bs::INT32 lhs, bs::INT32 rhs);
+
+    /**
+     * What DaedalusInstructionMemory::foldConstants() has done.
+     */
+    struct DaedalusFoldingStats
+    {
+      /**
+       * Pushes of constant variables replaced by `PushInt`.
+       */
+      bs::UINT32 numInlinedConstants = 0;
+
+      /**
+       * Operations on constant values replaced by a `PushInt` of their result.
+       */
+      bs::UINT32 numFoldedOperations = 0;
+
+      /**
+       * `JumpIf`s on a constant value replaced by a `Jump` to wherever they always go.
+       */
+      bs::UINT32 numRemovedBranches = 0;
+
+      /**
+       * Addresses of all instructions which have been replaced, see
+       * DaedalusVM::verifyConstantFolding().
+       */
+      bs::Vector<bs::UINT32> replacedAddresses;
+    };
+
+    /**
+     * Instruction Memory of the Daedalus VM.
+     *
+     * Decoding a raw instruction out of the DAT-files bytecode is not exactly cheap and
+     * would have to be done for every executed instruction. Since hundreds of NPC state
+     * loops are run every frame, all code is decoded once while loading the DAT-file and
+     * stored here inside a flat array. Looking up the instruction at a given address is then
+     * a matter of two array accesses.
+     *
+     * Since we don't know where the code section ends, decoding is done by following the
+     * control flow starting from all script functions. Any address that wasn't found that
+     * way (e.g. instance constructors) is decoded on demand the first time it is executed.
+     */
+    class DaedalusInstructionMemory
+    {
+    public:
+      DaedalusInstructionMemory() = default;
+
+      /**
+       * Clears all decoded instructions and sets the DAT-file to take the bytecode from.
+       */
+      void reset(bs::SPtr<Daedalus::DATFile> datFile);
+
+      /**
+       * Decodes the code of all script functions found inside the given symbol storage.
+       *
+       * @param  symbols  Symbol storage filled from the DAT-file set via reset().
+       */
+      void decodeAllFunctions(const ScriptSymbolStorage& symbols);
+
+      /**
+       * Looks up the instruction at the given address. If the address has not been
+       * decoded yet, it will be decoded now.
+       *
+       * @note The returned reference may be invalidated once a new address has to be decoded,
+       *       so copy the instruction if you need it for longer.
+       *
+       * @param  address  Bytecode address of the instruction.
+       *
+       * @return The decoded instruction at the given address.
+       */
+      const DaedalusInstruction& instructionAt(bs::UINT32 address)
+      {
+        if (address >= mInstructionIndexByAddress.size() ||
+            mInstructionIndexByAddress[address] == INSTRUCTION_INDEX_INVALID)
+        {
+          decodeReachableFrom(address);
+        }
+
+        return mInstructions[mInstructionIndexByAddress[address]];
+      }
+
+      /**
+       * Looks for common sequences of instructions in all code decoded so far and replaces
+       * the first instruction of every sequence with a superinstruction doing the work of
+       * the whole sequence. See DaedalusSuperinstruction.
+       *
+       * The rest of the sequence stays in place, so jumping into the middle of it still works.
+       * Code which is decoded later on is not fused.
+       *
+       * @param  symbols  Symbol storage to check the types of variables in.
+       *
+       * @return Number of superinstructions created, by opcode.
+       */
+      bs::Map<bs::UINT8, bs::UINT32> fuseSuperinstructions(const ScriptSymbolStorage& symbols);
+
+      /**
+       * Optimizes all code decoded so far for values known while loading:
+       *
+       *  - Pushes of constant int variables, like guild IDs or `TRUE`, become `PushInt`.
+       *  - Arithmetic, logic and comparisons on constant values become a `PushInt` of the
+       *    result. Operations which would divide by zero or overflow are left alone, to
+       *    behave just like the interpreter.
+       *  - A `JumpIf` on a constant value becomes a `Jump` to wherever it always goes.
+       *
+       * Like with superinstructions, the first instruction of a folded sequence is replaced
+       * and the rest stays in place, so jumping into the middle of it still works. To be done
+       * before fuseSuperinstructions(), so the folded code can be fused as well. Code which
+       * is decoded later on is not optimized.
+       *
+       * Constant means flagged as `const` inside the DAT-file, see SymbolBase::isKeptAfterLoad.
+       * The compiler doesn't allow to assign to those, which is also checked here: Constants
+       * assigned to anywhere in the decoded code are not inlined.
+       *
+       * @param  symbols  Symbol storage to take the constant values from.
+       */
+      DaedalusFoldingStats foldConstants(const ScriptSymbolStorage& symbols);
+
+      /**
+       * Checks whether the instance or prototype constructor at the given address only ever
+       * changes the object being constructed, based on nothing but constant values. Running
+       * such a constructor again leads to the very same object.
+       *
+       * The code may only read members and constants, assign to members, do arithmetic and
+       * logic on those and call prototype constructors fulfilling the same. Anything else,
+       * like calling an external or another script function, reading or writing a global
+       * variable, setting an instance or assigning one fails the check.
+       *
+       * @param  symbols  Symbol storage filled from the DAT-file set via reset().
+       * @param  address  Start of the constructor.
+       */
+      bool isConstructorFreeOfSideEffects(const ScriptSymbolStorage& symbols,
+                                          bs::UINT32 address);
+
+      /**
+       * Calls the given function for every decoded instruction, ordered by address.
+       *
+       * @param  fn  Function taking the address and the `const DaedalusInstruction&`.
+       */
+      template <typename Fn>
+      void forEachDecodedInstruction(Fn fn) const
+      {
+        for (bs::UINT32 address = 0; address < mInstructionIndexByAddress.size(); address++)
+        {
+          if (mInstructionIndexByAddress[address] != INSTRUCTION_INDEX_INVALID)
+          {
+            fn(address, mInstructions[mInstructionIndexByAddress[address]]);
+          }
+        }
+      }
+
+      /**
+       * @return Number of instructions decoded so far.
+       */
+      bs::UINT32 numDecodedInstructions() const
+      {
+        return (bs::UINT32)mInstructions.size();
+      }
+
+    private:
+      /**
+       * Decodes all instructions reachable from the given address by following
+       * the control flow. Stops at instructions which have already been decoded.
+       */
+      void decodeReachableFrom(bs::UINT32 address);
+
+      /**
+       * @return Whether the instruction at the given address has been decoded already.
+       */
+      bool isDecoded(bs::UINT32 address) const;
+
+      static constexpr bs::UINT32 INSTRUCTION_INDEX_INVALID = UINT32_MAX;
+
+      /**
+       * All decoded instructions.
+       */
+      bs::Vector<DaedalusInstruction> mInstructions;
+
+      /**
+       * Maps a bytecode address to the index of the instruction inside mInstructions.
+       * Addresses which do not start an instruction are set to INSTRUCTION_INDEX_INVALID.
+       */
+      bs::Vector<bs::UINT32> mInstructionIndexByAddress;
+
+      bs::SPtr<Daedalus::DATFile> mDatFile;
+    };
+  }  // namespace Scripting
+}  // namespace REGoth
@@ -0,0 +1,333 @@
+#include "DaedalusNativeCompiler.hpp"
+#include "DaedalusDisassembler.hpp"
+#include "DaedalusInstructionMemory.hpp"
+#include "DaedalusNativeModule.hpp"
+#include <algorithm>
+#include <daedalus/DATFile.h>
+#include <exception/Throw.hpp>
+#include <log/logging.hpp>
+#include <scripting/ScriptSymbolStorage.hpp>
+#include <sstream>
+
+namespace REGoth
+{
+  namespace Scripting
+  {
+    /**
+     * @return Whether the given opcode is one the VM knows. Superinstructions are not.
+     */
+    static bool isKnownOpcode(bs::UINT8 op)
+    {
+      switch (op)
+      {
+        case Daedalus::EParOp_Add:
+        case Daedalus::EParOp_Subract:
+        case Daedalus::EParOp_Multiply:
+        case Daedalus::EParOp_Divide:
+        case Daedalus::EParOp_Mod:
+        case Daedalus::EParOp_BinOr:
+        case Daedalus::EParOp_BinAnd:
+        case Daedalus::EParOp_ShiftLeft:
+        case Daedalus::EParOp_ShiftRight:
+        case Daedalus::EParOp_Negate:
+        case Daedalus::EParOp_LogOr:
+        case Daedalus::EParOp_LogAnd:
+        case Daedalus::EParOp_Less:
+        case Daedalus::EParOp_Greater:
+        case Daedalus::EParOp_LessOrEqual:
+        case Daedalus::EParOp_Equal:
+        case Daedalus::EParOp_NotEqual:
+        case Daedalus::EParOp_GreaterOrEqual:
+        case Daedalus::EParOp_Plus:
+        case Daedalus::EParOp_Minus:
+        case Daedalus::EParOp_Not:
+        case Daedalus::EParOp_PushInt:
+        case Daedalus::EParOp_PushVar:
+        case Daedalus::EParOp_PushInstance:
+        case Daedalus::EParOp_PushArrayVar:
+        case Daedalus::EParOp_AssignFunc:
+        case Daedalus::EParOp_AssignString:
+        case Daedalus::EParOp_AssignFloat:
+        case Daedalus::EParOp_AssignInstance:
+        case Daedalus::EParOp_Assign:
+        case Daedalus::EParOp_AssignAdd:
+        case Daedalus::EParOp_AssignSubtract:
+        case Daedalus::EParOp_AssignMultiply:
+        case Daedalus::EParOp_AssignDivide:
+        case Daedalus::EParOp_AssignStringRef:
+        case Daedalus::EParOp_Ret:
+        case Daedalus::EParOp_Jump:
+        case Daedalus::EParOp_JumpIf:
+        case Daedalus::EParOp_Call:
+        case Daedalus::EParOp_CallExternal:
+        case Daedalus::EParOp_SetInstance:
+          return true;
+
+        default:
+          return false;
+      }
+    }
+
+    /**
+     * Decoded instructions of a single function, ordered by address.
+     */
+    typedef bs::Vector<std::pair<bs::UINT32, DaedalusInstruction>> FunctionCode;
+
+    /**
+     * Collects all instructions reachable from the start of a function without following
+     * calls, like DaedalusInstructionMemory does.
+     *
+     * @return Whether the function only contains known opcodes.
+     */
+    static bool collectFunctionCode(DaedalusInstructionMemory& instructions, bs::UINT32 start,
+                                    FunctionCode& code)
+    {
+      bs::Set<bs::UINT32> visited;
+      bs::Vector<bs::UINT32> open = {start};
+
+      while (!open.empty())
+      {
+        bs::UINT32 address = open.back();
+        open.pop_back();
+
+        while (visited.insert(address).second)
+        {
+          // Copied, since decoding more might invalidate the reference
+          DaedalusInstruction instruction = instructions.instructionAt(address);
+
+          if (!isKnownOpcode(instruction.op) || instruction.size == 0) return false;
+
+          code.push_back({address, instruction});
+
+          if (instruction.op == Daedalus::EParOp_Ret) break;
+
+          if (instruction.op == Daedalus::EParOp_Jump)
+          {
+            address = instruction.address();
+            continue;
+          }
+
+          if (instruction.op == Daedalus::EParOp_JumpIf)
+          {
+            open.push_back(instruction.address());
+          }
+
+          address += instruction.size;
+        }
+      }
+
+      std::sort(code.begin(), code.end(),
+                [](const auto& a, const auto& b) { return a.first < b.first; });
+
+      return true;
+    }
+
+    /**
+     * @return The disassembly of the given instruction, safe to be put into a line comment.
+     */
+    static bs::String commentFor(const DaedalusInstruction& instruction,
+                                 const ScriptSymbolStorage& symbols)
+    {
+      bs::String text = disassembleOpcode(instruction, symbols, "", "", "");
+
+      std::replace(text.begin(), text.end(), '\n', ' ');
+      std::replace(text.begin(), text.end(), '\r', ' ');
+      std::replace(text.begin(), text.end(), '\\', '/');
+
+      return text;
+    }
+
+    /**
+     * Writes the native function for the given code.
+     */
+    static void writeFunction(std::ostringstream& out, bs::UINT32 start,
+                              const FunctionCode& code, const ScriptSymbolStorage& symbols)
+    {
+      // Only labels which are jumped to, to not have the compiler warn about the others
+      bs::Set<bs::UINT32> targets;
+
+      if (code.front().first != start)
+      {
+        targets.insert(start);
+      }
+
+      for (size_t i = 0; i < code.size(); i++)
+      {
+        const DaedalusInstruction& instruction = code[i].second;
+        bs::UINT32 next                        = code[i].first + instruction.size;
+
+        bool isFollowedByNext = i + 1 < code.size() && code[i + 1].first == next;
+
+        switch (instruction.op)
+        {
+          case Daedalus::EParOp_Ret:
+            break;
+
+          case Daedalus::EParOp_Jump:
+            targets.insert(instruction.address());
+            break;
+
+          case Daedalus::EParOp_JumpIf:
+            targets.insert(instruction.address());
+            if (!isFollowedByNext) targets.insert(next);
+            break;
+
+          default:
+            if (!isFollowedByNext) targets.insert(next);
+            break;
+        }
+      }
+
+      out << "  void f_" << start << "(DaedalusNativeContext& vm)\n  {\n";
+
+      if (targets.count(start) != 0)
+      {
+        out << "    goto L_" << start << ";\n";
+      }
+
+      for (size_t i = 0; i < code.size(); i++)
+      {
+        bs::UINT32 address                     = code[i].first;
+        const DaedalusInstruction& instruction = code[i].second;
+        bs::UINT32 next                        = address + instruction.size;
+
+        bool isFollowedByNext = i + 1 < code.size() && code[i + 1].first == next;
+
+        if (targets.count(address) != 0)
+        {
+          out << "  L_" << address << ":\n";
+        }
+
+        out << "    // " << commentFor(instruction, symbols) << "\n";
+
+        switch (instruction.op)
+        {
+          case Daedalus::EParOp_Ret:
+            out << "    vm.countInstruction();\n    return;\n";
+            continue;
+
+          case Daedalus::EParOp_Jump:
+            out << "    vm.countInstruction();\n    goto L_" << instruction.address() << ";\n";
+            continue;
+
+          case Daedalus::EParOp_JumpIf:
+            out << "    if (vm.jumpIf()) goto L_" << instruction.address() << ";\n";
+            break;
+
+          case Daedalus::EParOp_Call:
+            out << "    vm.call(" << instruction.address() << ");\n";
+            break;
+
+          default:
+            out << "    vm.run<" << (int)instruction.op << ">({" << (int)instruction.op << ", "
+                << (int)instruction.arrayIndex << ", " << (int)instruction.size << ", 0, "
+                << instruction.operand << ", 0, 0});\n";
+            break;
+        }
+
+        if (!isFollowedByNext)
+        {
+          out << "    goto L_" << next << ";\n";
+        }
+      }
+
+      out << "  }\n\n";
+    }
+
+    DaedalusNativeModuleSource generateDaedalusNativeModule(const ScriptSymbolStorage& symbols,
+                                                            DaedalusInstructionMemory& instructions,
+                                                            const bs::String& datName,
+                                                            bs::UINT64 datHash)
+    {
+      bs::Set<bs::UINT32> starts;
+
+      for (SymbolIndex index : symbols.symbolsOfType(SymbolType::ScriptFunction))
+      {
+        const auto& function = symbols.getSymbol<SymbolScriptFunction>(index);
+
+        if (!function.isClassVar) starts.insert(function.address);
+      }
+
+      for (SymbolIndex index : symbols.symbolsOfType(SymbolType::Prototype))
+      {
+        starts.insert(symbols.getSymbol<SymbolPrototype>(index).constructorAddress);
+      }
+
+      for (SymbolIndex index : symbols.symbolsOfType(SymbolType::Instance))
+      {
+        const auto& instance = symbols.getSymbol<SymbolInstance>(index);
+
+        if (!instance.isClassVar) starts.insert(instance.constructorAddress);
+      }
+
+      DaedalusNativeModuleSource result;
+      bs::Vector<bs::UINT32> compiled;
+      std::ostringstream out;
+
+      out << "// Generated by REGothDaedalusAOT from " << datName << ", do not edit.\n"
+          << "#include <scripting/daedalus/DaedalusNativeContext.hpp>\n\n"
+          << "using namespace REGoth::Scripting;\n\n"
+          << "namespace\n{\n";
+
+      for (bs::UINT32 start : starts)
+      {
+        FunctionCode code;
+        bool isCompilable;
+
+        // Instances without a body have no code at their address
+        try
+        {
+          isCompilable = collectFunctionCode(instructions, start, code);
+        }
+        catch (const std::exception&)
+        {
+          isCompilable = false;
+        }
+
+        if (!isCompilable || code.empty())
+        {
+          REGOTH_LOG(Verbose, VM, "[DaedalusNativeCompiler] Cannot compile code at {0}", start);
+          result.numSkippedFunctions += 1;
+          continue;
+        }
+
+        writeFunction(out, start, code, symbols);
+
+        compiled.push_back(start);
+        result.numInstructions += (bs::UINT32)code.size();
+      }
+
+      if (compiled.empty())
+      {
+        REGOTH_THROW(InvalidStateException, "No script function of " + datName + " compiled");
+      }
+
+      out << "  const DaedalusNativeFunctionEntry FUNCTIONS[] = {\n";
+
+      for (bs::UINT32 start : compiled)
+      {
+        out << "      {" << start << ", &f_" << start << "},\n";
+      }
+
+      out << "  };\n\n"
+          << "  const DaedalusNativeModuleInfo MODULE = {\n"
+          << "      " << DAEDALUS_NATIVE_ABI_VERSION << ",\n"
+          << "      " << datHash << "ULL,\n"
+          << "      \"" << datName << "\",\n"
+          << "      " << compiled.size() << ",\n"
+          << "      FUNCTIONS,\n"
+          << "  };\n"
+          << "}  // namespace\n\n"
+          << "REGOTH_DAEDALUS_NATIVE_MODULE_EXPORT const DaedalusNativeModuleInfo* "
+          << "REGothDaedalusNativeModule()\n"
+          << "{\n"
+          << "  return &MODULE;\n"
+          << "}\n";
+
+      result.code         = out.str().c_str();
+      result.numFunctions = (bs::UINT32)compiled.size();
+
+      return result;
+    }
+  }  // namespace Scripting
+}  // namespace REGoth
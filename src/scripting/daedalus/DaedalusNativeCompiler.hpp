@@ -0,0 +1,53 @@
+/**\file
+ */
+#pragma once
+#include <BsPrerequisites.h>
+
+namespace REGoth
+{
+  namespace Scripting
+  {
+    class DaedalusInstructionMemory;
+    class ScriptSymbolStorage;
+
+    /**
+     * What generateDaedalusNativeModule() has done.
+     */
+    struct DaedalusNativeModuleSource
+    {
+      /**
+       * C++ source of the module, see DaedalusNativeModule.
+       */
+      bs::String code;
+
+      bs::UINT32 numFunctions    = 0;
+      bs::UINT32 numInstructions = 0;
+
+      /**
+       * Functions which could not be compiled, e.g. because they contain an unknown opcode.
+       * These are left to the interpreter.
+       */
+      bs::UINT32 numSkippedFunctions = 0;
+    };
+
+    /**
+     * Translates the bytecode of every script function, prototype and instance constructor
+     * into a C++ function, to be built into a native module. See DaedalusNativeModule and
+     * DaedalusNativeContext.
+     *
+     * Every instruction becomes a single statement and jumps become `goto`s, so the compiler
+     * sees the whole function at once and no time is spent on decoding and dispatching
+     * instructions anymore. Superinstructions are not used, the compiler does better.
+     *
+     * @param  symbols       Symbols of the DAT-file.
+     * @param  instructions  Instruction memory of the DAT-file, without superinstructions.
+     *                       Will decode whatever has not been decoded yet.
+     * @param  datName       Name of the DAT-file, for logging.
+     * @param  datHash       Hash of the DAT-file, see hashSnapshotSource().
+     */
+    DaedalusNativeModuleSource generateDaedalusNativeModule(const ScriptSymbolStorage& symbols,
+                                                            DaedalusInstructionMemory& instructions,
+                                                            const bs::String& datName,
+                                                            bs::UINT64 datHash);
+  }  // namespace Scripting
+}  // namespace REGoth
@@ -0,0 +1,113 @@
+/**\file
+ *
+ * Everything code generated by REGothDaedalusAOT needs, see DaedalusNativeContext. Apart from
+ * the VM itself, only to be included by native modules.
+ */
+#pragma once
+#include "DaedalusClassVarResolver.hpp"
+#include "DaedalusNativeModule.hpp"
+#include "REGothDaedalusVM.hpp"
+#include <daedalus/DATFile.h>
+#include <exception/Throw.hpp>
+#include <log/logging.hpp>
+
+namespace REGoth
+{
+  namespace Scripting
+  {
+    /**
+     * What native code of a script function uses to run its instructions on a DaedalusVM.
+     *
+     * Instructions which don't change the control flow are run via run(), which executes the
+     * same implementation the interpreter uses, see `DaedalusOpcodes.inl`. Since the
+     * instruction is known when the native code is compiled, the compiler can inline and
+     * specialize it. Jumps and returns become plain C++ control flow and calls of other
+     * script functions go straight into their native code, if there is any.
+     *
+     * Instructions are counted just like in the interpreter, so DaedalusProfiler works the
+     * same.
+     */
+    class DaedalusNativeContext
+    {
+    public:
+      DaedalusNativeContext(DaedalusVM& vm)
+          : mVM(vm)
+      {
+      }
+
+      /**
+       * Runs an instruction which doesn't change the control flow.
+       *
+       * @tparam  op  Same as `instruction.op`.
+       */
+      template <bs::UINT8 op>
+      void run(const DaedalusInstruction& instruction)
+      {
+        mVM.mNumExecutedInstructions++;
+        mVM.executeNativeOpcode<op>(instruction);
+      }
+
+      /**
+       * Does the work of a `JumpIf`.
+       *
+       * @return Whether to jump, which is the case if the value on the stack is 0.
+       */
+      bool jumpIf()
+      {
+        mVM.mNumExecutedInstructions++;
+        return mVM.popIntValue() == 0;
+      }
+
+      /**
+       * Counts a `Jump` or `Ret`, the work is done by the native code itself.
+       */
+      void countInstruction()
+      {
+        mVM.mNumExecutedInstructions++;
+      }
+
+      /**
+       * Does the work of a `Call`, see DaedalusVM::callFromNativeCode().
+       */
+      void call(bs::UINT32 address)
+      {
+        mVM.mNumExecutedInstructions++;
+        mVM.callFromNativeCode(address);
+      }
+
+    private:
+      DaedalusVM& mVM;
+    };
+
+    // Every opcode as specialization of DaedalusVM::executeNativeOpcode(), see
+    // DaedalusNativeContext::run(). The control flow is handled by the native code, so the
+    // implementations of those opcodes are never used.
+
+#define REGOTH_DAEDALUS_OPCODE(op)                              \
+  template <>                                                   \
+  inline void DaedalusVM::executeNativeOpcode<Daedalus::op>(    \
+      const DaedalusInstruction& opcode)                        \
+  {                                                             \
+    constexpr bool isTracing = false;                           \
+    (void)isTracing;                                            \
+    (void)opcode;
+#define REGOTH_DAEDALUS_SUPERINSTRUCTION(op)                                         \
+  template <>                                                                        \
+  inline void DaedalusVM::executeNativeOpcode<op>(const DaedalusInstruction& opcode) \
+  {                                                                                  \
+    constexpr bool isTracing = false;                                                \
+    (void)isTracing;                                                                 \
+    (void)opcode;
+#define REGOTH_DAEDALUS_NEXT() \
+  }                            \
+  static_assert(true, "")
+#define REGOTH_DAEDALUS_RETURN() return
+
+#include "DaedalusOpcodes.inl"
+
+#undef REGOTH_DAEDALUS_OPCODE
+#undef REGOTH_DAEDALUS_SUPERINSTRUCTION
+#undef REGOTH_DAEDALUS_NEXT
+#undef REGOTH_DAEDALUS_RETURN
+  }  // namespace Scripting
+}  // namespace REGoth
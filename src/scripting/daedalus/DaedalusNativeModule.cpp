@@ -0,0 +1,76 @@
+#include "DaedalusNativeModule.hpp"
+#include <Utility/BsDynLib.h>
+#include <Utility/BsDynLibManager.h>
+#include <exception/Throw.hpp>
+#include <log/logging.hpp>
+
+namespace REGoth
+{
+  namespace Scripting
+  {
+    DaedalusNativeModule::DaedalusNativeModule(const DaedalusNativeModuleInfo& info)
+        : mDatHash(info.datHash)
+        , mDatName(info.datName ? info.datName : "")
+    {
+      mFunctions.reserve(info.numFunctions);
+
+      for (bs::UINT32 i = 0; i < info.numFunctions; i++)
+      {
+        mFunctions[info.functions[i].address] = info.functions[i].function;
+      }
+    }
+
+    void DaedalusNativeModules::load(const bs::Path& path)
+    {
+      bs::DynLib* library = bs::DynLibManager::instance().load(path.toString());
+
+      if (!library)
+      {
+        REGOTH_THROW(InvalidParametersException, "Cannot load native module " + path.toString());
+      }
+
+      auto entryPoint = (DaedalusNativeModuleEntryPoint)library->getSymbol(
+          REGOTH_DAEDALUS_NATIVE_MODULE_ENTRY_POINT);
+
+      if (!entryPoint)
+      {
+        REGOTH_THROW(InvalidParametersException,
+                     "Not a native module of Daedalus scripts: " + path.toString());
+      }
+
+      add(*entryPoint());
+    }
+
+    void DaedalusNativeModules::add(const DaedalusNativeModuleInfo& info)
+    {
+      if (info.abiVersion != DAEDALUS_NATIVE_ABI_VERSION)
+      {
+        REGOTH_THROW(InvalidParametersException,
+                     bs::StringUtil::format("Native module of {0} has been generated for version "
+                                            "{1} of the VM, expected version {2}",
+                                            info.datName, info.abiVersion,
+                                            DAEDALUS_NATIVE_ABI_VERSION));
+      }
+
+      auto module = bs::bs_shared_ptr_new<DaedalusNativeModule>(info);
+
+      REGOTH_LOG(Info, VM, "[DaedalusNativeModules] Loaded {0} native functions of {1}",
+                 module->numFunctions(), module->datName());
+
+      mModules[info.datHash] = module;
+    }
+
+    bs::SPtr<const DaedalusNativeModule> DaedalusNativeModules::find(bs::UINT64 datHash) const
+    {
+      auto it = mModules.find(datHash);
+
+      return it != mModules.end() ? it->second : nullptr;
+    }
+
+    DaedalusNativeModules& gDaedalusNativeModules()
+    {
+      static DaedalusNativeModules modules;
+      return modules;
+    }
+  }  // namespace Scripting
+}  // namespace REGoth
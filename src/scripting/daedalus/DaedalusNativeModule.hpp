@@ -0,0 +1,175 @@
+/**\file
+ */
+#pragma once
+#include <BsPrerequisites.h>
+
+/**
+ * Name of the function a native module exports, see DaedalusNativeModuleEntryPoint.
+ */
+#define REGOTH_DAEDALUS_NATIVE_MODULE_ENTRY_POINT "REGothDaedalusNativeModule"
+
+#if defined(_WIN32)
+#  define REGOTH_DAEDALUS_NATIVE_MODULE_EXPORT extern "C" __declspec(dllexport)
+#else
+#  define REGOTH_DAEDALUS_NATIVE_MODULE_EXPORT extern "C" __attribute__((visibility("default")))
+#endif
+
+namespace REGoth
+{
+  namespace Scripting
+  {
+    class DaedalusNativeContext;
+
+    /**
+     * Version of the interface between the VM and native modules. Modules generated for
+     * another version are not loaded. To be increased whenever DaedalusNativeContext or the
+     * opcodes change.
+     */
+    constexpr bs::UINT32 DAEDALUS_NATIVE_ABI_VERSION = 1;
+
+    /**
+     * A script function which has been compiled ahead of time, see REGothDaedalusAOT. Runs the
+     * function until it returns, just like the interpreter would.
+     */
+    typedef void (*DaedalusNativeFunction)(DaedalusNativeContext& context);
+
+    /**
+     * Native code of the function starting at the given bytecode address.
+     */
+    struct DaedalusNativeFunctionEntry
+    {
+      bs::UINT32 address;
+      DaedalusNativeFunction function;
+    };
+
+    /**
+     * Describes what a native module contains. Returned by its entry point.
+     */
+    struct DaedalusNativeModuleInfo
+    {
+      /**
+       * See DAEDALUS_NATIVE_ABI_VERSION.
+       */
+      bs::UINT32 abiVersion;
+
+      /**
+       * Hash of the DAT-file the module has been compiled from, see hashSnapshotSource().
+       * Native code only fits the exact bytecode it was compiled from.
+       */
+      bs::UINT64 datHash;
+
+      /**
+       * Name of the DAT-file the module has been compiled from, for logging.
+       */
+      const char* datName;
+
+      bs::UINT32 numFunctions;
+      const DaedalusNativeFunctionEntry* functions;
+    };
+
+    /**
+     * Function every native module exports under the name
+     * REGOTH_DAEDALUS_NATIVE_MODULE_ENTRY_POINT.
+     */
+    typedef const DaedalusNativeModuleInfo* (*DaedalusNativeModuleEntryPoint)();
+
+    /**
+     * Script functions compiled to native code ahead of time, for a single DAT-file.
+     *
+     * Native modules are generated as C++ by REGothDaedalusAOT and built as shared library,
+     * see `regoth_add_daedalus_native_module()` in the CMakeLists. They don't link against
+     * REGothEngine, but use the symbols of the executable loading them, so they only work
+     * where the executable exports its symbols, like with GCC and Clang.
+     */
+    class DaedalusNativeModule
+    {
+    public:
+      DaedalusNativeModule(const DaedalusNativeModuleInfo& info);
+
+      /**
+       * @return Native code of the script function starting at the given address. nullptr,
+       *         if it has not been compiled.
+       */
+      DaedalusNativeFunction functionAt(bs::UINT32 address) const
+      {
+        auto it = mFunctions.find(address);
+
+        return it != mFunctions.end() ? it->second : nullptr;
+      }
+
+      /**
+       * @return Hash of the DAT-file the module has been compiled from.
+       */
+      bs::UINT64 datHash() const
+      {
+        return mDatHash;
+      }
+
+      /**
+       * @return Name of the DAT-file the module has been compiled from.
+       */
+      const bs::String& datName() const
+      {
+        return mDatName;
+      }
+
+      bs::UINT32 numFunctions() const
+      {
+        return (bs::UINT32)mFunctions.size();
+      }
+
+    private:
+      bs::UnorderedMap<bs::UINT32, DaedalusNativeFunction> mFunctions;
+      bs::UINT64 mDatHash;
+      bs::String mDatName;
+    };
+
+    /**
+     * All native modules loaded, keyed by the hash of the DAT-file they have been compiled
+     * from. A DaedalusVM looks up the module for its DAT-file in here once it has decoded the
+     * bytecode, see DaedalusVM::isRunningNativeCode().
+     *
+     * There is one global instance, see gDaedalusNativeModules(). Modules are never unloaded.
+     */
+    class DaedalusNativeModules
+    {
+    public:
+      /**
+       * Loads the native module from the given shared library.
+       *
+       * Throws if the library cannot be loaded, is not a native module or has been generated
+       * for another version of the VM.
+       */
+      void load(const bs::Path& path);
+
+      /**
+       * Adds a module which is already part of the executable.
+       *
+       * Throws if it has been generated for another version of the VM.
+       */
+      void add(const DaedalusNativeModuleInfo& info);
+
+      /**
+       * @return The module compiled from the DAT-file with the given hash, nullptr if none
+       *         has been loaded.
+       */
+      bs::SPtr<const DaedalusNativeModule> find(bs::UINT64 datHash) const;
+
+      /**
+       * @return Whether no module has been loaded at all.
+       */
+      bool isEmpty() const
+      {
+        return mModules.empty();
+      }
+
+    private:
+      bs::UnorderedMap<bs::UINT64, bs::SPtr<const DaedalusNativeModule>> mModules;
+    };
+
+    /**
+     * @return The native modules looked up by every DaedalusVM.
+     */
+    DaedalusNativeModules& gDaedalusNativeModules();
+  }  // namespace Scripting
+}  // namespace REGoth
@@ -0,0 +1,834 @@
+/**\file
+ *
+ * Implementation of all opcodes of the Daedalus VM.
+ *
+ * This file is included by the different interpreter loops inside REGothDaedalusVM.cpp, so
+ * that there is only one place describing what an instruction does. Before including, the
+ * following makros need to be defined:
+ *
+ *  - `REGOTH_DAEDALUS_OPCODE(op)`: Starts the implementation of the given opcode.
+ *  - `REGOTH_DAEDALUS_SUPERINSTRUCTION(op)`: Same for a `DaedalusSuperinstruction`.
+ *  - `REGOTH_DAEDALUS_NEXT()`:     Continues with the next instruction.
+ *  - `REGOTH_DAEDALUS_RETURN()`:   Leaves the currently executed script function.
+ *
+ * The instruction to execute is expected to be available as `opcode`. The program counter
+ * has already been moved to the next instruction. `isTracing` needs to be a compile time constant
+ * telling whether instructions should be logged via the disassembler.
+ */
+
+// Arithmetic
+// ------------------------------------------------------------------------------
+
+REGOTH_DAEDALUS_OPCODE(EParOp_Add)
+{
+  bs::INT32 lhs = popIntValue();
+  bs::INT32 rhs = popIntValue();
+  bs::INT32 res = lhs + rhs;
+
+  if (isTracing)
+  {
+    disassembleAndLogOpcode(opcode, bs::toString(lhs), bs::toString(rhs), bs::toString(res));
+  }
+
+  mStack.pushInt(res);
+}
+REGOTH_DAEDALUS_NEXT();
+
+REGOTH_DAEDALUS_OPCODE(EParOp_Subract)
+{
+  bs::INT32 lhs = popIntValue();
+  bs::INT32 rhs = popIntValue();
+  bs::INT32 res = lhs - rhs;
+
+  if (isTracing)
+  {
+    disassembleAndLogOpcode(opcode, bs::toString(lhs), bs::toString(rhs), bs::toString(res));
+  }
+
+  mStack.pushInt(res);
+}
+REGOTH_DAEDALUS_NEXT();
+
+REGOTH_DAEDALUS_OPCODE(EParOp_Multiply)
+{
+  bs::INT32 lhs = popIntValue();
+  bs::INT32 rhs = popIntValue();
+  bs::INT32 res = lhs * rhs;
+
+  if (isTracing)
+  {
+    disassembleAndLogOpcode(opcode, bs::toString(lhs), bs::toString(rhs), bs::toString(res));
+  }
+
+  mStack.pushInt(res);
+}
+REGOTH_DAEDALUS_NEXT();
+
+REGOTH_DAEDALUS_OPCODE(EParOp_Divide)
+{
+  bs::INT32 lhs = popIntValue();
+  bs::INT32 rhs = popIntValue();
+  bs::INT32 res = lhs / rhs;
+
+  if (isTracing)
+  {
+    disassembleAndLogOpcode(opcode, bs::toString(lhs), bs::toString(rhs), bs::toString(res));
+  }
+
+  mStack.pushInt(res);
+}
+REGOTH_DAEDALUS_NEXT();
+
+REGOTH_DAEDALUS_OPCODE(EParOp_Mod)
+{
+  bs::INT32 lhs = popIntValue();
+  bs::INT32 rhs = popIntValue();
+  bs::INT32 res = lhs % rhs;
+
+  if (isTracing)
+  {
+    disassembleAndLogOpcode(opcode, bs::toString(lhs), bs::toString(rhs), bs::toString(res));
+  }
+
+  mStack.pushInt(res);
+}
+REGOTH_DAEDALUS_NEXT();
+
+// Binary
+// ----------------------------------------------------------------------------------
+
+REGOTH_DAEDALUS_OPCODE(EParOp_BinOr)
+{
+  bs::INT32 lhs = popIntValue();
+  bs::INT32 rhs = popIntValue();
+  bs::INT32 res = lhs | rhs;
+
+  if (isTracing)
+  {
+    disassembleAndLogOpcode(opcode, bs::toString(lhs), bs::toString(rhs), bs::toString(res));
+  }
+
+  mStack.pushInt(res);
+}
+REGOTH_DAEDALUS_NEXT();
+
+REGOTH_DAEDALUS_OPCODE(EParOp_BinAnd)
+{
+  bs::INT32 lhs = popIntValue();
+  bs::INT32 rhs = popIntValue();
+  bs::INT32 res = lhs & rhs;
+
+  if (isTracing)
+  {
+    disassembleAndLogOpcode(opcode, bs::toString(lhs), bs::toString(rhs), bs::toString(res));
+  }
+
+  mStack.pushInt(res);
+}
+REGOTH_DAEDALUS_NEXT();
+
+REGOTH_DAEDALUS_OPCODE(EParOp_ShiftLeft)
+{
+  bs::INT32 lhs = popIntValue();
+  bs::INT32 rhs = popIntValue();
+  bs::INT32 res = lhs << rhs;
+
+  if (isTracing)
+  {
+    disassembleAndLogOpcode(opcode, bs::toString(lhs), bs::toString(rhs), bs::toString(res));
+  }
+
+  mStack.pushInt(res);
+}
+REGOTH_DAEDALUS_NEXT();
+
+REGOTH_DAEDALUS_OPCODE(EParOp_ShiftRight)
+{
+  bs::INT32 lhs = popIntValue();
+  bs::INT32 rhs = popIntValue();
+  bs::INT32 res = lhs >> rhs;
+
+  if (isTracing)
+  {
+    disassembleAndLogOpcode(opcode, bs::toString(lhs), bs::toString(rhs), bs::toString(res));
+  }
+
+  mStack.pushInt(res);
+}
+REGOTH_DAEDALUS_NEXT();
+
+REGOTH_DAEDALUS_OPCODE(EParOp_Negate)
+{
+  bs::INT32 lhs = popIntValue();
+  bs::INT32 res = ~lhs;
+
+  if (isTracing)
+  {
+    disassembleAndLogOpcode(opcode, bs::toString(lhs), "", bs::toString(res));
+  }
+
+  mStack.pushInt(res);
+}
+REGOTH_DAEDALUS_NEXT();
+
+// Logic
+// -----------------------------------------------------------------------------------
+
+REGOTH_DAEDALUS_OPCODE(EParOp_LogOr)
+{
+  bs::INT32 lhs = popIntValue();
+  bs::INT32 rhs = popIntValue();
+  bs::INT32 res = lhs || rhs ? 1 : 0;
+
+  if (isTracing)
+  {
+    disassembleAndLogOpcode(opcode, bs::toString(lhs), bs::toString(rhs), bs::toString(res));
+  }
+
+  mStack.pushInt(res);
+}
+REGOTH_DAEDALUS_NEXT();
+
+REGOTH_DAEDALUS_OPCODE(EParOp_LogAnd)
+{
+  bs::INT32 lhs = popIntValue();
+  bs::INT32 rhs = popIntValue();
+  bs::INT32 res = lhs && rhs ? 1 : 0;
+
+  if (isTracing)
+  {
+    disassembleAndLogOpcode(opcode, bs::toString(lhs), bs::toString(rhs), bs::toString(res));
+  }
+
+  mStack.pushInt(res);
+}
+REGOTH_DAEDALUS_NEXT();
+
+// Comparision
+// -----------------------------------------------------------------------------
+
+REGOTH_DAEDALUS_OPCODE(EParOp_Less)
+{
+  bs::INT32 lhs = popIntValue();
+  bs::INT32 rhs = popIntValue();
+  bs::INT32 res = lhs < rhs ? 1 : 0;
+
+  if (isTracing)
+  {
+    disassembleAndLogOpcode(opcode, bs::toString(lhs), bs::toString(rhs), bs::toString(res));
+  }
+
+  mStack.pushInt(res);
+}
+REGOTH_DAEDALUS_NEXT();
+
+REGOTH_DAEDALUS_OPCODE(EParOp_Greater)
+{
+  bs::INT32 lhs = popIntValue();
+  bs::INT32 rhs = popIntValue();
+  bs::INT32 res = lhs > rhs ? 1 : 0;
+
+  if (isTracing)
+  {
+    disassembleAndLogOpcode(opcode, bs::toString(lhs), bs::toString(rhs), bs::toString(res));
+  }
+
+  mStack.pushInt(res);
+}
+REGOTH_DAEDALUS_NEXT();
+
+REGOTH_DAEDALUS_OPCODE(EParOp_LessOrEqual)
+{
+  bs::INT32 lhs = popIntValue();
+  bs::INT32 rhs = popIntValue();
+  bs::INT32 res = lhs <= rhs ? 1 : 0;
+
+  if (isTracing)
+  {
+    disassembleAndLogOpcode(opcode, bs::toString(lhs), bs::toString(rhs), bs::toString(res));
+  }
+
+  mStack.pushInt(res);
+}
+REGOTH_DAEDALUS_NEXT();
+
+REGOTH_DAEDALUS_OPCODE(EParOp_Equal)
+{
+  bs::INT32 lhs = popIntValue();
+  bs::INT32 rhs = popIntValue();
+  bs::INT32 res = lhs == rhs ? 1 : 0;
+
+  if (isTracing)
+  {
+    disassembleAndLogOpcode(opcode, bs::toString(lhs), bs::toString(rhs), bs::toString(res));
+  }
+
+  mStack.pushInt(res);
+}
+REGOTH_DAEDALUS_NEXT();
+
+REGOTH_DAEDALUS_OPCODE(EParOp_NotEqual)
+{
+  bs::INT32 lhs = popIntValue();
+  bs::INT32 rhs = popIntValue();
+  bs::INT32 res = lhs != rhs ? 1 : 0;
+
+  if (isTracing)
+  {
+    disassembleAndLogOpcode(opcode, bs::toString(lhs), bs::toString(rhs), bs::toString(res));
+  }
+
+  mStack.pushInt(res);
+}
+REGOTH_DAEDALUS_NEXT();
+
+REGOTH_DAEDALUS_OPCODE(EParOp_GreaterOrEqual)
+{
+  bs::INT32 lhs = popIntValue();
+  bs::INT32 rhs = popIntValue();
+  bs::INT32 res = lhs >= rhs ? 1 : 0;
+
+  if (isTracing)
+  {
+    disassembleAndLogOpcode(opcode, bs::toString(lhs), bs::toString(rhs), bs::toString(res));
+  }
+
+  mStack.pushInt(res);
+}
+REGOTH_DAEDALUS_NEXT();
+
+// Unary
+// -----------------------------------------------------------------------------------
+
+REGOTH_DAEDALUS_OPCODE(EParOp_Plus)
+{
+  bs::INT32 lhs = popIntValue();
+  bs::INT32 res = +lhs;
+
+  if (isTracing)
+  {
+    disassembleAndLogOpcode(opcode, bs::toString(lhs), "", bs::toString(res));
+  }
+
+  mStack.pushInt(res);
+}
+REGOTH_DAEDALUS_NEXT();
+
+REGOTH_DAEDALUS_OPCODE(EParOp_Minus)
+{
+  bs::INT32 lhs = popIntValue();
+  bs::INT32 res = -lhs;
+
+  if (isTracing)
+  {
+    disassembleAndLogOpcode(opcode, bs::toString(lhs), "", bs::toString(res));
+  }
+
+  mStack.pushInt(res);
+}
+REGOTH_DAEDALUS_NEXT();
+
+REGOTH_DAEDALUS_OPCODE(EParOp_Not)
+{
+  bs::INT32 lhs = popIntValue();
+  bs::INT32 res = !lhs;
+
+  if (isTracing)
+  {
+    disassembleAndLogOpcode(opcode, bs::toString(lhs), "", bs::toString(res));
+  }
+
+  mStack.pushInt(res);
+}
+REGOTH_DAEDALUS_NEXT();
+
+// Stack
+// -----------------------------------------------------------------------------------
+
+REGOTH_DAEDALUS_OPCODE(EParOp_PushInt)
+  if (isTracing)
+  {
+    disassembleAndLogOpcode(opcode, bs::toString(opcode.operand), "", "");
+  }
+
+  mStack.pushInt(opcode.operand);
+REGOTH_DAEDALUS_NEXT();
+
+REGOTH_DAEDALUS_OPCODE(EParOp_PushVar)
+  if (isTracing)
+  {
+    disassembleAndLogOpcode(opcode, "", "", "");
+  }
+
+  pushVariable(opcode.symbol(), 0);
+REGOTH_DAEDALUS_NEXT();
+
+REGOTH_DAEDALUS_OPCODE(EParOp_PushInstance)
+  if (isTracing)
+  {
+    disassembleAndLogOpcode(opcode, "", "", "");
+  }
+
+  mStack.pushInstance(opcode.symbol());
+REGOTH_DAEDALUS_NEXT();
+
+REGOTH_DAEDALUS_OPCODE(EParOp_PushArrayVar)
+  if (isTracing)
+  {
+    disassembleAndLogOpcode(opcode, "", "", "");
+  }
+
+  pushVariable(opcode.symbol(), opcode.arrayIndex);
+REGOTH_DAEDALUS_NEXT();
+
+// Assign
+// ----------------------------------------------------------------------------------
+
+REGOTH_DAEDALUS_OPCODE(EParOp_AssignFunc)
+  // Function Pointes are pushed as intergers
+  {
+    markRecordedCodeAsNotCacheable();
+
+    SymbolIndex targetIndex = mStack.popFunction();
+    SymbolIndex sourceIndex = (SymbolIndex)popIntValue();
+
+    if (isTracing)
+    {
+      disassembleAndLogOpcode(opcode, "", "", "");
+    }
+
+    auto& target = mScriptSymbols.getSymbol<SymbolScriptFunction>(targetIndex);
+
+    SymbolBase& sourceBase = mScriptSymbols.getSymbolBase(sourceIndex);
+
+    bs::UINT32 sourceAddress;
+
+    if (sourceBase.type == SymbolType::ScriptFunction)
+    {
+      auto& sourceFunction = (SymbolScriptFunction&)sourceBase;
+      sourceAddress        = sourceFunction.address;
+    }
+    else if (sourceBase.type == SymbolType::Instance)
+    {
+      // Because deadalus' type safety isn't what it seems like, we need to handle this
+      // stupid edgecase of an instance being assigned to a function-pointer class variable.
+      // Specifically `C_ITEM.owner`, which is declared as `VAR FUNC owner` but is then
+      // given instances of class `C_NPC`.
+      //
+      // Since the original just seems to store the symbol index, not caring about the type,
+      // it works there. However, REGoth stores the function address, so we have to work
+      // around that by storing the instances constructor address. Let's just hope it will
+      // work...
+      //
+      // We could also add another type of symbol for function pointers, but then we have
+      // Symbols which *should* refer to functions, but sometimes refer to instances, which
+      // sucks as well.
+      auto& sourceInstance = (SymbolInstance&)sourceBase;
+      sourceAddress        = sourceInstance.constructorAddress;
+    }
+    else
+    {
+      REGOTH_THROW(InvalidParametersException,
+                   bs::StringUtil::format("Cannot get the address of symbol {0} of type {1}",
+                                          sourceBase.name, (int)sourceBase.type));
+    }
+
+    if (target.isClassVar)
+    {
+      mClassVarResolver->resolveClassVariableFunctionPointer(targetIndex) = sourceAddress;
+    }
+    else
+    {
+      target.address = sourceAddress;
+    }
+  }
+REGOTH_DAEDALUS_NEXT();
+
+REGOTH_DAEDALUS_OPCODE(EParOp_AssignString)
+{
+  auto& lhs = popStringReference();
+
+  // Copy straight from the source variable or the string pool, without a temporary
+  if (mStack.isTopOfStringStackVariable())
+  {
+    const auto& rhs = popStringReference();
+
+    if (isTracing)
+    {
+      disassembleAndLogOpcode(opcode, rhs, lhs, "");
+    }
+
+    lhs = rhs;
+  }
+  else
+  {
+    DaedalusStringHandle rhs = mStack.popStringHandle();
+
+    if (isTracing)
+    {
+      disassembleAndLogOpcode(opcode, mStringPool.get(rhs), lhs, "");
+    }
+
+    lhs = mStringPool.get(rhs);
+    mStringPool.release(rhs);
+  }
+}
+
+REGOTH_DAEDALUS_NEXT();
+
+REGOTH_DAEDALUS_OPCODE(EParOp_AssignFloat)
+{
+  auto& lhs       = popFloatReference();
+  const auto& rhs = popFloatValue();
+
+  if (isTracing)
+  {
+    disassembleAndLogOpcode(opcode, bs::toString(rhs), bs::toString(lhs), "");
+  }
+
+  lhs = rhs;
+}
+REGOTH_DAEDALUS_NEXT();
+
+REGOTH_DAEDALUS_OPCODE(EParOp_AssignInstance)
+// -
+  {
+    markRecordedCodeAsNotCacheable();
+
+    SymbolIndex targetIndex = mStack.popInstance();
+    SymbolIndex sourceIndex = mStack.popInstance();
+
+    auto& target = mScriptSymbols.getSymbol<SymbolInstance>(targetIndex);
+    auto& source = mScriptSymbols.getSymbol<SymbolInstance>(sourceIndex);
+
+    if (isTracing)
+    {
+      disassembleAndLogOpcode(opcode, target.name, source.name, "");
+    }
+
+    target.instance = source.instance;
+  }
+REGOTH_DAEDALUS_NEXT();
+
+REGOTH_DAEDALUS_OPCODE(EParOp_Assign)
+{
+  auto& lhs       = popIntReference();
+  const auto& rhs = popIntValue();
+
+  if (isTracing)
+  {
+    disassembleAndLogOpcode(opcode);
+  }
+
+  lhs = rhs;
+}
+REGOTH_DAEDALUS_NEXT();
+
+REGOTH_DAEDALUS_OPCODE(EParOp_AssignAdd)
+{
+  auto& lhs       = popIntReference();
+  const auto& rhs = popIntValue();
+  auto res        = lhs + rhs;
+
+  if (isTracing)
+  {
+    disassembleAndLogOpcode(opcode);
+  }
+
+  lhs = res;
+}
+REGOTH_DAEDALUS_NEXT();
+
+REGOTH_DAEDALUS_OPCODE(EParOp_AssignSubtract)
+{
+  auto& lhs       = popIntReference();
+  const auto& rhs = popIntValue();
+  auto res        = lhs - rhs;
+
+  if (isTracing)
+  {
+    disassembleAndLogOpcode(opcode);
+  }
+
+  lhs = res;
+}
+REGOTH_DAEDALUS_NEXT();
+
+REGOTH_DAEDALUS_OPCODE(EParOp_AssignMultiply)
+{
+  auto& lhs       = popIntReference();
+  const auto& rhs = popIntValue();
+  auto res        = lhs * rhs;
+
+  if (isTracing)
+  {
+    disassembleAndLogOpcode(opcode);
+  }
+
+  lhs = res;
+}
+REGOTH_DAEDALUS_NEXT();
+
+REGOTH_DAEDALUS_OPCODE(EParOp_AssignDivide)
+{
+  auto& lhs       = popIntReference();
+  const auto& rhs = popIntValue();
+  auto res        = lhs / rhs;
+
+  if (isTracing)
+  {
+    disassembleAndLogOpcode(opcode);
+  }
+
+  lhs = res;
+}
+REGOTH_DAEDALUS_NEXT();
+
+REGOTH_DAEDALUS_OPCODE(EParOp_AssignStringRef)
+  REGOTH_THROW(NotImplementedException, "AssignStringRef is not implemented.");
+REGOTH_DAEDALUS_NEXT();
+
+// Control flow
+// ----------------------------------------------------------------------------
+
+REGOTH_DAEDALUS_OPCODE(EParOp_Ret)
+  if (isTracing)
+  {
+    disassembleAndLogOpcode(opcode);
+  }
+
+  // Script function Ends here!
+  if (mCallFrames.size() == mCallFramesBase)
+  {
+    REGOTH_DAEDALUS_RETURN();
+  }
+
+  // Continue with the calling function, see EParOp_Call
+  {
+    const DaedalusCallFrame& frame = mCallFrames.back();
+
+    mPC = frame.returnAddress;
+    mClassVarResolver->setCurrentInstance(frame.savedInstance);
+    mCallDepth -= 1;
+
+    if (frame.isProfiled && mProfiler)
+    {
+      mProfiler->leave(mNumExecutedInstructions);
+    }
+
+    mCallFrames.pop_back();
+  }
+REGOTH_DAEDALUS_NEXT();
+
+REGOTH_DAEDALUS_OPCODE(EParOp_Jump)
+  if (isTracing)
+  {
+    disassembleAndLogOpcode(opcode);
+  }
+
+  mPC = opcode.address();
+REGOTH_DAEDALUS_NEXT();
+
+REGOTH_DAEDALUS_OPCODE(EParOp_JumpIf)
+{
+  bs::UINT32 lhs = popIntValue();
+
+  if (isTracing)
+  {
+    disassembleAndLogOpcode(opcode, bs::toString(lhs));
+  }
+
+  // Jump if value on stack is 0
+  if (!lhs)
+  {
+    mPC = opcode.address();
+  }
+}
+REGOTH_DAEDALUS_NEXT();
+
+REGOTH_DAEDALUS_OPCODE(EParOp_Call)
+{
+  if (isTracing)
+  {
+    disassembleAndLogOpcode(opcode);
+  }
+
+  if (mIsTracingEnabled && mRunningFiber == DAEDALUS_FIBER_INVALID)
+  {
+    // The tracing VM has to check every called function for whether to disassemble it,
+    // so execute the whole sub-function on its own. Not within fibers, which need all
+    // functions in mCallFrames to be suspended.
+    NestedCallScope call(*this);
+
+    mPC = opcode.address();
+
+    executeUntilReturn();
+  }
+  else
+  {
+    // Save some of this functions state and continue with the sub-function.
+    // The Return-instruction of the sub-function will bring us back.
+    mCallFrames.push_back({mPC, mClassVarResolver->getCurrentInstance(), mProfiler != nullptr});
+
+    mPC = opcode.address();
+    mCallDepth += 1;
+
+    if (mProfiler)
+    {
+      mProfiler->enterFunction(mPC, mNumExecutedInstructions);
+    }
+  }
+}
+REGOTH_DAEDALUS_NEXT();
+
+REGOTH_DAEDALUS_OPCODE(EParOp_CallExternal)
+{
+  if (isTracing)
+  {
+    disassembleAndLogOpcode(opcode);
+  }
+
+  // Not implemented externals are in there as well, see setupExternals()
+  externalCallback callback = mExternals[opcode.symbol()];
+
+  // Constant, so release builds don't even check, see REGOTH_LOG_VERBOSITY_VM
+  if (REGOTH_LOG_IS_COMPILED(Verbose, VM))
+  {
+    logIfExternalNotImplemented(opcode.symbol());
+  }
+
+  {
+    NestedCallScope call(*this);
+
+    // Whatever this external does might depend on the work put off by the ones before. Might
+    // run script functions, which is why this comes after remembering where to go on.
+    if (mHasBatchedExternals && !mIsExternalBatchable[opcode.symbol()])
+    {
+      flushBatchedExternals();
+    }
+
+    if (mRecordedReads && !mIsExternalCacheable[opcode.symbol()])
+    {
+      mRecordedReads->isCacheable = false;
+    }
+
+    if (mProfiler)
+    {
+      // Keep the profiler alive, in case the external disables profiling
+      bs::SPtr<DaedalusProfiler> profiler = mProfiler;
+      profiler->enterExternal(opcode.symbol(), mNumExecutedInstructions);
+
+      (this->*callback)();
+
+      profiler->leave(mNumExecutedInstructions);
+    }
+    else
+    {
+      (this->*callback)();
+    }
+  }
+
+  // The external suspended the fiber, which continues after this instruction, see runFiber()
+  if (mIsYieldRequested)
+  {
+    REGOTH_DAEDALUS_RETURN();
+  }
+}
+REGOTH_DAEDALUS_NEXT();
+
+// Other
+// -----------------------------------------------------------------------------------
+
+REGOTH_DAEDALUS_OPCODE(EParOp_SetInstance)
+{
+  if (isTracing)
+  {
+    disassembleAndLogOpcode(opcode);
+  }
+
+  const SymbolInstance& instance =
+      mScriptSymbols.getSymbol<SymbolInstance>(opcode.symbol());
+  mClassVarResolver->setCurrentInstance(instance.instance);
+
+  if (mRecordedReads)
+  {
+    mRecordedReads->instances.push_back({opcode.symbol(), instance.instance});
+  }
+}
+REGOTH_DAEDALUS_NEXT();
+
+// Superinstructions, see DaedalusSuperinstruction
+// -----------------------------------------------------------------------------------
+
+REGOTH_DAEDALUS_SUPERINSTRUCTION(SuperOp_JumpIfNotCompareVarInt)
+{
+  // Same order as if the single instructions had popped the values
+  bs::INT32 lhs = opcode.operand2;
+  bs::INT32 rhs = intValue(opcode.symbol());
+  bs::INT32 res = compareInts(opcode.subOp, lhs, rhs);
+
+  if (isTracing)
+  {
+    disassembleAndLogOpcode(opcode, bs::toString(lhs), bs::toString(rhs), bs::toString(res));
+  }
+
+  if (!res)
+  {
+    mPC = (bs::UINT32)opcode.operand3;
+  }
+}
+REGOTH_DAEDALUS_NEXT();
+
+REGOTH_DAEDALUS_SUPERINSTRUCTION(SuperOp_JumpIfNotCompareIntVar)
+{
+  bs::INT32 lhs = intValue(opcode.symbol());
+  bs::INT32 rhs = opcode.operand2;
+  bs::INT32 res = compareInts(opcode.subOp, lhs, rhs);
+
+  if (isTracing)
+  {
+    disassembleAndLogOpcode(opcode, bs::toString(lhs), bs::toString(rhs), bs::toString(res));
+  }
+
+  if (!res)
+  {
+    mPC = (bs::UINT32)opcode.operand3;
+  }
+}
+REGOTH_DAEDALUS_NEXT();
+
+REGOTH_DAEDALUS_SUPERINSTRUCTION(SuperOp_PushInstanceSetInstance)
+{
+  if (isTracing)
+  {
+    disassembleAndLogOpcode(opcode);
+  }
+
+  mStack.pushInstance(opcode.symbol());
+
+  const SymbolInstance& instance =
+      mScriptSymbols.getSymbol<SymbolInstance>((SymbolIndex)opcode.operand2);
+  mClassVarResolver->setCurrentInstance(instance.instance);
+
+  if (mRecordedReads)
+  {
+    mRecordedReads->instances.push_back({(SymbolIndex)opcode.operand2, instance.instance});
+  }
+}
+REGOTH_DAEDALUS_NEXT();
+
+REGOTH_DAEDALUS_SUPERINSTRUCTION(SuperOp_AssignVar)
+{
+  markRecordedCodeAsNotCacheable();
+
+  auto& lhs       = intReference((SymbolIndex)opcode.operand2);
+  const auto& rhs = intReference(opcode.symbol());
+
+  if (isTracing)
+  {
+    disassembleAndLogOpcode(opcode);
+  }
+
+  lhs = rhs;
+}
+REGOTH_DAEDALUS_NEXT();
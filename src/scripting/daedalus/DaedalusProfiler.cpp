@@ -0,0 +1,236 @@
+#include "DaedalusProfiler.hpp"
+#include <algorithm>
+#include <chrono>
+#include <scripting/ScriptSymbolStorage.hpp>
+
+namespace REGoth
+{
+  namespace Scripting
+  {
+    static bs::UINT64 nanosecondsSinceEpoch()
+    {
+      auto sinceEpoch = std::chrono::steady_clock::now().time_since_epoch();
+
+      return (bs::UINT64)std::chrono::duration_cast<std::chrono::nanoseconds>(sinceEpoch).count();
+    }
+
+    /**
+     * Pads the given string with spaces on the left until it has the given length.
+     */
+    static bs::String padLeft(const bs::String& s, size_t length)
+    {
+      if (s.size() >= length) return s;
+
+      return bs::String(length - s.size(), ' ') + s;
+    }
+
+    static bs::String formatMilliseconds(bs::UINT64 nanoseconds)
+    {
+      return bs::toString(nanoseconds / 1000000.0, 3, 0, ' ', std::ios::fixed);
+    }
+
+    static bs::String formatMicroseconds(bs::UINT64 nanoseconds)
+    {
+      return bs::toString(nanoseconds / 1000.0, 3, 0, ' ', std::ios::fixed);
+    }
+
+    /**
+     * Names of all functions which can be executed by the VM, by their bytecode address.
+     */
+    static bs::UnorderedMap<bs::UINT32, bs::String> collectFunctionNames(
+        const ScriptSymbolStorage& symbols)
+    {
+      bs::UnorderedMap<bs::UINT32, bs::String> names;
+
+      for (SymbolIndex index : symbols.symbolsOfType(SymbolType::ScriptFunction))
+      {
+        const auto& symbol    = symbols.getSymbol<SymbolScriptFunction>(index);
+        names[symbol.address] = symbol.name;
+      }
+
+      for (SymbolIndex index : symbols.symbolsOfType(SymbolType::Prototype))
+      {
+        const auto& symbol               = symbols.getSymbol<SymbolPrototype>(index);
+        names[symbol.constructorAddress] = symbol.name;
+      }
+
+      for (SymbolIndex index : symbols.symbolsOfType(SymbolType::Instance))
+      {
+        const auto& symbol               = symbols.getSymbol<SymbolInstance>(index);
+        names[symbol.constructorAddress] = symbol.name;
+      }
+
+      return names;
+    }
+
+    DaedalusProfiler::DaedalusProfiler()
+        : mStartTime(nanosecondsSinceEpoch())
+    {
+    }
+
+    void DaedalusProfiler::enterFunction(bs::UINT32 address, bs::UINT64 numInstructions)
+    {
+      enter(false, address, numInstructions);
+    }
+
+    void DaedalusProfiler::enterExternal(SymbolIndex external, bs::UINT64 numInstructions)
+    {
+      enter(true, external, numInstructions);
+    }
+
+    void DaedalusProfiler::enter(bool isExternal, bs::UINT32 id, bs::UINT64 numInstructions)
+    {
+      ActiveCall call;
+      call.isExternal        = isExternal;
+      call.id                = id;
+      call.startInstructions = numInstructions;
+      call.startNanoseconds  = now();
+      call.childInstructions = 0;
+      call.childNanoseconds  = 0;
+
+      mActiveCalls.push_back(call);
+    }
+
+    void DaedalusProfiler::leave(bs::UINT64 numInstructions)
+    {
+      if (mActiveCalls.empty()) return;
+
+      const ActiveCall call = mActiveCalls.back();
+      mActiveCalls.pop_back();
+
+      bs::UINT64 instructions = numInstructions - call.startInstructions;
+      bs::UINT64 nanoseconds  = now() - call.startNanoseconds;
+
+      Stats& stats = call.isExternal ? mExternals[call.id] : mFunctions[call.id];
+
+      stats.numCalls += 1;
+      stats.inclusiveInstructions += instructions;
+      stats.exclusiveInstructions += instructions - call.childInstructions;
+      stats.inclusiveNanoseconds += nanoseconds;
+      stats.exclusiveNanoseconds += nanoseconds - call.childNanoseconds;
+
+      // Whatever happened in here is not part of the callers exclusive values
+      if (!mActiveCalls.empty())
+      {
+        mActiveCalls.back().childInstructions += instructions;
+        mActiveCalls.back().childNanoseconds += nanoseconds;
+      }
+
+      if (mTraceEvents.size() < MAX_TRACE_EVENTS)
+      {
+        mTraceEvents.push_back({call.isExternal, call.id, call.startNanoseconds, nanoseconds});
+      }
+    }
+
+    void DaedalusProfiler::unwindTo(bs::UINT32 depth, bs::UINT64 numInstructions)
+    {
+      while (mActiveCalls.size() > depth)
+      {
+        leave(numInstructions);
+      }
+    }
+
+    void DaedalusProfiler::reset()
+    {
+      mFunctions.clear();
+      mExternals.clear();
+      mActiveCalls.clear();
+      mTraceEvents.clear();
+
+      mStartTime = nanosecondsSinceEpoch();
+    }
+
+    bs::UINT64 DaedalusProfiler::now() const
+    {
+      return nanosecondsSinceEpoch() - mStartTime;
+    }
+
+    bs::String DaedalusProfiler::nameOf(
+        bool isExternal, bs::UINT32 id, const ScriptSymbolStorage& symbols,
+        const bs::UnorderedMap<bs::UINT32, bs::String>& functionNames) const
+    {
+      if (isExternal)
+      {
+        return symbols.getSymbolName(id);
+      }
+
+      auto it = functionNames.find(id);
+
+      if (it == functionNames.end())
+      {
+        return "<address " + bs::toString(id) + ">";
+      }
+
+      return it->second;
+    }
+
+    bs::String DaedalusProfiler::createReport(const ScriptSymbolStorage& symbols) const
+    {
+      struct Row
+      {
+        bs::String name;
+        bool isExternal;
+        Stats stats;
+      };
+
+      auto functionNames = collectFunctionNames(symbols);
+
+      bs::Vector<Row> rows;
+
+      for (const auto& f : mFunctions)
+      {
+        rows.push_back({nameOf(false, f.first, symbols, functionNames), false, f.second});
+      }
+
+      for (const auto& e : mExternals)
+      {
+        rows.push_back({nameOf(true, e.first, symbols, functionNames), true, e.second});
+      }
+
+      std::sort(rows.begin(), rows.end(), [](const Row& a, const Row& b) {
+        return a.stats.exclusiveNanoseconds > b.stats.exclusiveNanoseconds;
+      });
+
+      bs::String report = padLeft("Calls", 10) + padLeft("Excl. ms", 12) +
+                          padLeft("Incl. ms", 12) + padLeft("Excl. Instr.", 14) +
+                          padLeft("Incl. Instr.", 14) + "  Function\n";
+
+      for (const Row& row : rows)
+      {
+        report += padLeft(bs::toString(row.stats.numCalls), 10);
+        report += padLeft(formatMilliseconds(row.stats.exclusiveNanoseconds), 12);
+        report += padLeft(formatMilliseconds(row.stats.inclusiveNanoseconds), 12);
+        report += padLeft(bs::toString(row.stats.exclusiveInstructions), 14);
+        report += padLeft(bs::toString(row.stats.inclusiveInstructions), 14);
+        report += "  " + row.name + (row.isExternal ? " (external)" : "") + "\n";
+      }
+
+      return report;
+    }
+
+    bs::String DaedalusProfiler::createChromeTrace(const ScriptSymbolStorage& symbols) const
+    {
+      auto functionNames = collectFunctionNames(symbols);
+
+      bs::String json = "{\"traceEvents\":[\n";
+
+      for (size_t i = 0; i < mTraceEvents.size(); i++)
+      {
+        const TraceEvent& e = mTraceEvents[i];
+
+        // Symbol names can only contain characters which are fine inside a JSON string
+        json += "{\"name\":\"" + nameOf(e.isExternal, e.id, symbols, functionNames) + "\"";
+        json += ",\"cat\":\"" + bs::String(e.isExternal ? "external" : "script") + "\"";
+        json += ",\"ph\":\"X\",\"pid\":0,\"tid\":0";
+        json += ",\"ts\":" + formatMicroseconds(e.startNanoseconds);
+        json += ",\"dur\":" + formatMicroseconds(e.durationNanoseconds) + "}";
+
+        json += (i + 1 < mTraceEvents.size()) ? ",\n" : "\n";
+      }
+
+      json += "]}\n";
+
+      return json;
+    }
+  }  // namespace Scripting
+}  // namespace REGoth
@@ -0,0 +1,166 @@
+/**\file
+ */
+#pragma once
+#include <BsPrerequisites.h>
+#include <scripting/ScriptTypes.hpp>
+
+namespace REGoth
+{
+  namespace Scripting
+  {
+    class ScriptSymbolStorage;
+
+    /**
+     * Records how much time the Daedalus-VM spends in which script function.
+     *
+     * For every script function, this counts how often it was called, how many
+     * instructions were executed and how much wall time passed. *Inclusive* values
+     * contain everything which happened until the function returned, *exclusive* values
+     * only what happened inside the function itself, without the functions it called.
+     *
+     * Externals are recorded as well, but since they don't run instructions themselves,
+     * their instruction counts are only made up of script functions they called.
+     *
+     * Functions are identified by their bytecode address, since instance- and prototype
+     * constructors don't have a function symbol. Names are looked up once a report
+     * is created.
+     *
+     * The profiler is owned by the VM, see DaedalusVM::setProfilingEnabled().
+     */
+    class DaedalusProfiler
+    {
+    public:
+      /**
+       * Values recorded for a single function or external.
+       */
+      struct Stats
+      {
+        bs::UINT32 numCalls              = 0;
+        bs::UINT64 inclusiveInstructions = 0;
+        bs::UINT64 exclusiveInstructions = 0;
+        bs::UINT64 inclusiveNanoseconds  = 0;
+        bs::UINT64 exclusiveNanoseconds  = 0;
+      };
+
+      DaedalusProfiler();
+
+      /**
+       * To be called once the VM starts executing the script function at the given address.
+       *
+       * @param  address          Bytecode address of the function.
+       * @param  numInstructions  Number of instructions the VM executed so far.
+       */
+      void enterFunction(bs::UINT32 address, bs::UINT64 numInstructions);
+
+      /**
+       * To be called before the VM calls the given external.
+       */
+      void enterExternal(SymbolIndex external, bs::UINT64 numInstructions);
+
+      /**
+       * To be called once the function or external entered last has returned.
+       */
+      void leave(bs::UINT64 numInstructions);
+
+      /**
+       * @return Number of functions and externals which have been entered, but did not
+       *         return yet.
+       */
+      bs::UINT32 depth() const
+      {
+        return (bs::UINT32)mActiveCalls.size();
+      }
+
+      /**
+       * Leaves all functions until only the given number is left. Used if script execution
+       * was interrupted by an exception.
+       */
+      void unwindTo(bs::UINT32 depth, bs::UINT64 numInstructions);
+
+      /**
+       * Throws away everything recorded so far.
+       */
+      void reset();
+
+      /**
+       * @return Recorded values of all script functions, by address.
+       */
+      const bs::UnorderedMap<bs::UINT32, Stats>& functions() const
+      {
+        return mFunctions;
+      }
+
+      /**
+       * @return Recorded values of all externals, by symbol.
+       */
+      const bs::UnorderedMap<SymbolIndex, Stats>& externals() const
+      {
+        return mExternals;
+      }
+
+      /**
+       * Creates a human readable table of all functions and externals, sorted
+       * by their exclusive time, most expensive first.
+       */
+      bs::String createReport(const ScriptSymbolStorage& symbols) const;
+
+      /**
+       * Creates a JSON-document in the *Chrome Trace Event Format*, which can be loaded
+       * into `chrome://tracing` to see every single call on a timeline.
+       *
+       * Only the first MAX_TRACE_EVENTS calls are kept.
+       */
+      bs::String createChromeTrace(const ScriptSymbolStorage& symbols) const;
+
+      /**
+       * Maximum number of calls to keep for createChromeTrace().
+       */
+      static constexpr bs::UINT32 MAX_TRACE_EVENTS = 1 << 20;
+
+    private:
+      /**
+       * Function or external which has been entered, but did not return yet.
+       */
+      struct ActiveCall
+      {
+        bool isExternal;
+        bs::UINT32 id;  // Address or symbol index
+        bs::UINT64 startInstructions;
+        bs::UINT64 startNanoseconds;
+        bs::UINT64 childInstructions;
+        bs::UINT64 childNanoseconds;
+      };
+
+      /**
+       * A single completed call, for the chrome trace.
+       */
+      struct TraceEvent
+      {
+        bool isExternal;
+        bs::UINT32 id;
+        bs::UINT64 startNanoseconds;
+        bs::UINT64 durationNanoseconds;
+      };
+
+      void enter(bool isExternal, bs::UINT32 id, bs::UINT64 numInstructions);
+
+      /**
+       * @return Nanoseconds since the profiler was created.
+       */
+      bs::UINT64 now() const;
+
+      /**
+       * @return Name of the given function or external.
+       */
+      bs::String nameOf(bool isExternal, bs::UINT32 id, const ScriptSymbolStorage& symbols,
+                        const bs::UnorderedMap<bs::UINT32, bs::String>& functionNames) const;
+
+      bs::UnorderedMap<bs::UINT32, Stats> mFunctions;
+      bs::UnorderedMap<SymbolIndex, Stats> mExternals;
+      bs::Vector<ActiveCall> mActiveCalls;
+      bs::Vector<TraceEvent> mTraceEvents;
+
+      bs::UINT64 mStartTime;
+    };
+  }  // namespace Scripting
+}  // namespace REGoth
@@ -0,0 +1,73 @@
+#include "DaedalusProgram.hpp"
+#include <Threading/BsThreading.h>
+#include <daedalus/DATFile.h>
+#include <log/logging.hpp>
+#include <scripting/ScriptVMSnapshot.hpp>
+
+namespace REGoth
+{
+  namespace Scripting
+  {
+    /**
+     * Programs still in use by some VM, by the hash of their DAT-file, see
+     * DaedalusProgram::share(). Only weak references, so a program goes away with the last VM
+     * using it.
+     */
+    struct SharedDaedalusPrograms
+    {
+      bs::Mutex mutex;
+      bs::UnorderedMap<bs::UINT64, std::weak_ptr<const DaedalusProgram>> programs;
+    };
+
+    static SharedDaedalusPrograms& sharedDaedalusPrograms()
+    {
+      static SharedDaedalusPrograms shared;
+
+      return shared;
+    }
+
+    DaedalusProgram::DaedalusProgram(std::vector<bs::UINT8> datFileData)
+        : mDatFileData{std::move(datFileData)}
+    {
+      mDatFile    = bs::bs_shared_ptr_new<Daedalus::DATFile>(mDatFileData.data(),
+                                                             mDatFileData.size());
+      mSourceHash = hashSnapshotSource(mDatFileData);
+    }
+
+    bs::SPtr<const DaedalusProgram> DaedalusProgram::share(std::vector<bs::UINT8> datFileData)
+    {
+      SharedDaedalusPrograms& shared = sharedDaedalusPrograms();
+
+      bs::UINT64 hash = hashSnapshotSource(datFileData);
+
+      bs::Lock lock(shared.mutex);
+
+      auto it = shared.programs.find(hash);
+
+      if (it != shared.programs.end())
+      {
+        bs::SPtr<const DaedalusProgram> existing = it->second.lock();
+
+        // The hash only tells different versions of the same file apart
+        if (existing && existing->datFileData() == datFileData) return existing;
+      }
+
+      // Parsed while holding the lock, so a second VM asking for the same file meanwhile
+      // waits for this one instead of parsing it as well
+      auto program = bs::bs_shared_ptr_new<DaedalusProgram>(std::move(datFileData));
+
+      // Forget about the ones no VM uses anymore, e.g. from before the scripts were reloaded
+      for (auto other = shared.programs.begin(); other != shared.programs.end();)
+      {
+        other = other->second.expired() ? shared.programs.erase(other) : std::next(other);
+      }
+
+      shared.programs[hash] = program;
+
+      REGOTH_LOG(Verbose, VM, "[DaedalusProgram] Loaded a DAT-file of {0} KB, {1} in use",
+                 program->datFileData().size() / 1024, shared.programs.size());
+
+      return program;
+    }
+  }  // namespace Scripting
+}  // namespace REGoth
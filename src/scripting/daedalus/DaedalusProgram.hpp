@@ -0,0 +1,69 @@
+/**\file
+ */
+#pragma once
+#include <BsPrerequisites.h>
+
+namespace Daedalus
+{
+  class DATFile;
+}  // namespace Daedalus
+
+namespace REGoth
+{
+  namespace Scripting
+  {
+    /**
+     * A DAT-file as the DaedalusVM runs it: The original data, the parsed DAT-file and its
+     * hash. None of these change once loaded, everything a VM changes while running, like the
+     * values of symbols and the script objects, is part of the VM itself.
+     *
+     * Each world has its own VM, so running many worlds in one process used to mean having the
+     * same DAT-file in memory once per world. Get programs via share() instead of creating them
+     * directly, so all VMs running the same DAT-file use the same program, even from different
+     * threads.
+     */
+    class DaedalusProgram
+    {
+    public:
+      /**
+       * @param  datFileData  Contents of the DAT-file. Pass with std::move() to avoid a copy.
+       */
+      DaedalusProgram(std::vector<bs::UINT8> datFileData);
+
+      /**
+       * @return The program of the given DAT-file. The same as for every other program with
+       *         exactly the same contents still in use somewhere, a new one otherwise.
+       */
+      static bs::SPtr<const DaedalusProgram> share(std::vector<bs::UINT8> datFileData);
+
+      /**
+       * Original contents of the DAT-file, e.g. for serialization.
+       */
+      const std::vector<bs::UINT8>& datFileData() const
+      {
+        return mDatFileData;
+      }
+
+      /**
+       * The parsed DAT-file. Must not be modified, since it is shared.
+       */
+      const bs::SPtr<Daedalus::DATFile>& datFile() const
+      {
+        return mDatFile;
+      }
+
+      /**
+       * @return Hash of the DAT-file, see hashSnapshotSource(). Computed once on construction.
+       */
+      bs::UINT64 sourceHash() const
+      {
+        return mSourceHash;
+      }
+
+    private:
+      std::vector<bs::UINT8> mDatFileData;
+      bs::SPtr<Daedalus::DATFile> mDatFile;
+      bs::UINT64 mSourceHash = 0;
+    };
+  }  // namespace Scripting
+}  // namespace REGoth
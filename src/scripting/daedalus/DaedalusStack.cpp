@@ -1,147 +1,210 @@
 #include "DaedalusStack.hpp"
+#include <cstring>
 
 namespace REGoth
 {
   namespace Scripting
   {
+    /**
+     * Initial size of the stack. Scripts rarely go beyond a few dozen values,
+     * so this should be enough for the stack never to grow while running them.
+     */
+    static constexpr bs::UINT32 INITIAL_NUM_ENTRIES = 256;
+
+    DaedalusStack::DaedalusStack(DaedalusStringPool& strings)
+        : mStrings(strings)
+    {
+      mEntries.reserve(INITIAL_NUM_ENTRIES);
+    }
+
+    DaedalusStack::~DaedalusStack()
+    {
+      clear();
+    }
+
     void DaedalusStack::pushInt(bs::INT32 value)
     {
-      mStackInt.emplace_back();
-      mStackInt.back().isVariableValue = false;
-      mStackInt.back().value           = value;
+      pushEntry(EntryType::Int).intValue = value;
     }
 
-    void DaedalusStack::pushIntVariable(SymbolIndex symbol, bs::UINT32 arrayIndex)
+    void DaedalusStack::pushIntVariable(bs::INT32& value)
     {
-      mStackInt.emplace_back();
-      mStackInt.back().isVariableValue     = true;
-      mStackInt.back().variable.symbol     = symbol;
-      mStackInt.back().variable.arrayIndex = arrayIndex;
+      pushEntry(EntryType::IntVariable).global = &value;
+    }
+
+    void DaedalusStack::pushIntMemberVariable(const MemberSlot& slot, bs::UINT32 arrayIndex)
+    {
+      StackEntry& entry = pushEntry(EntryType::IntMemberVariable);
+
+      entry.member.slot       = slot;
+      entry.member.arrayIndex = arrayIndex;
     }
 
     void DaedalusStack::pushFloat(float value)
     {
-      mStackFloat.emplace_back();
-      mStackFloat.back().isVariableValue = false;
-      mStackFloat.back().value           = value;
+      pushEntry(EntryType::Float).floatValue = value;
     }
 
-    void DaedalusStack::pushFloatVariable(SymbolIndex symbol, bs::UINT32 arrayIndex)
+    void DaedalusStack::pushFloatVariable(float& value)
     {
-      mStackFloat.emplace_back();
-      mStackFloat.back().isVariableValue     = true;
-      mStackFloat.back().variable.symbol     = symbol;
-      mStackFloat.back().variable.arrayIndex = arrayIndex;
+      pushEntry(EntryType::FloatVariable).global = &value;
     }
 
-    void DaedalusStack::pushString(bs::String value)
+    void DaedalusStack::pushFloatMemberVariable(const MemberSlot& slot, bs::UINT32 arrayIndex)
     {
-      mStackString.emplace_back();
-      mStackString.back().isVariableValue = false;
-      mStackString.back().value           = value;
+      StackEntry& entry = pushEntry(EntryType::FloatMemberVariable);
+
+      entry.member.slot       = slot;
+      entry.member.arrayIndex = arrayIndex;
     }
 
-    void DaedalusStack::pushStringVariable(SymbolIndex symbol, bs::UINT32 arrayIndex)
+    void DaedalusStack::pushString(const bs::String& value)
     {
-      mStackString.emplace_back();
-      mStackString.back().isVariableValue     = true;
-      mStackString.back().variable.symbol     = symbol;
-      mStackString.back().variable.arrayIndex = arrayIndex;
+      pushStringHandle(mStrings.intern(value));
+    }
+
+    void DaedalusStack::pushStringHandle(DaedalusStringHandle handle)
+    {
+      pushEntry(EntryType::String).string = handle;
+    }
+
+    void DaedalusStack::pushStringVariable(bs::String& value)
+    {
+      pushEntry(EntryType::StringVariable).global = &value;
+    }
+
+    void DaedalusStack::pushStringMemberVariable(const MemberSlot& slot, bs::UINT32 arrayIndex)
+    {
+      StackEntry& entry = pushEntry(EntryType::StringMemberVariable);
+
+      entry.member.slot       = slot;
+      entry.member.arrayIndex = arrayIndex;
     }
 
     void DaedalusStack::pushInstance(SymbolIndex symbol)
     {
-      mStackInstance.push_back(symbol);
+      pushEntry(EntryType::Instance).symbol = symbol;
     }
 
     void DaedalusStack::pushFunction(SymbolIndex symbol)
     {
-      mStackFunction.push_back(symbol);
+      pushEntry(EntryType::Function).symbol = symbol;
     }
 
     bool DaedalusStack::isTopOfIntStackVariable() const
     {
-      if (mStackInt.empty())
-      {
-        // Gothic defaults to returning 0 on an empty stack, which is not a variable
-        return false;
-      }
-
-      return mStackInt.back().isVariableValue;
+      // Gothic defaults to returning 0 on an empty stack, which is not a variable
+      return isTopOfVariableType(EntryType::IntVariable, EntryType::IntMemberVariable);
     }
 
     bool DaedalusStack::isTopOfFloatStackVariable() const
     {
-      if (mStackFloat.empty())
-      {
-        // Gothic defaults to returning 0 on an empty stack, which is not a variable
-        return false;
-      }
-
-      return mStackFloat.back().isVariableValue;
+      // Gothic defaults to returning 0 on an empty stack, which is not a variable
+      return isTopOfVariableType(EntryType::FloatVariable, EntryType::FloatMemberVariable);
     }
 
     bool DaedalusStack::isTopOfStringStackVariable() const
     {
-      if (mStackString.empty())
-      {
-        // Gothic defaults to returning 0 on an empty stack, which is not a variable
-        return false;
-      }
-
-      return mStackString.back().isVariableValue;
+      // Gothic defaults to returning 0 on an empty stack, which is not a variable
+      return isTopOfVariableType(EntryType::StringVariable, EntryType::StringMemberVariable);
     }
 
     bs::INT32 DaedalusStack::popInt()
     {
-      if (mStackInt.empty())
+      if (mEntries.empty())
       {
         // Gothic defaults to returning 0 on an empty stack
         return 0;
       }
 
-      if (isTopOfIntStackVariable())
+      const StackEntry& entry = mEntries.back();
+      bs::INT32 v = 0;
+
+      switch (entry.type)
       {
-        REGOTH_THROW(
-            InvalidParametersException,
-            "Top of script stack is a variable, but we were expecting it to be a simple integer!");
+        case EntryType::Int:
+          v = entry.intValue;
+          break;
+
+        case EntryType::Float:
+          std::memcpy(&v, &entry.floatValue, sizeof(v));
+          break;
+
+        case EntryType::Instance:
+        case EntryType::Function:
+          // Symbol indices are passed as plain integers in the original
+          v = (bs::INT32)entry.symbol;
+          break;
+
+        case EntryType::IntVariable:
+        case EntryType::IntMemberVariable:
+          REGOTH_THROW(
+              InvalidParametersException,
+              "Top of script stack is a variable, but we were expecting it to be a simple integer!");
+
+        default:
+          throwUnexpectedType("a simple integer");
       }
 
-      bs::INT32 v = mStackInt.back().value;
-
-      mStackInt.pop_back();
+      mEntries.pop_back();
 
       return v;
     }
 
     float DaedalusStack::popFloat()
     {
-      if (mStackFloat.empty())
+      if (mEntries.empty())
       {
         // Gothic defaults to returning 0 on an empty stack
         return 0;
       }
 
-      if (isTopOfFloatStackVariable())
+      const StackEntry& entry = mEntries.back();
+      float v = 0;
+
+      switch (entry.type)
       {
-        REGOTH_THROW(
-            InvalidParametersException,
-            "Top of script stack is a variable, but we were expecting it to be a simple float!");
+        case EntryType::Float:
+          v = entry.floatValue;
+          break;
+
+        case EntryType::Int:
+          // Daedalus bytecode uses PushInt to push floats encoded as integers
+          std::memcpy(&v, &entry.intValue, sizeof(v));
+          break;
+
+        case EntryType::FloatVariable:
+        case EntryType::FloatMemberVariable:
+          REGOTH_THROW(
+              InvalidParametersException,
+              "Top of script stack is a variable, but we were expecting it to be a simple float!");
+
+        default:
+          throwUnexpectedType("a simple float");
       }
 
-      float v = mStackFloat.back().value;
-
-      mStackFloat.pop_back();
+      mEntries.pop_back();
 
       return v;
     }
 
     bs::String DaedalusStack::popString()
     {
-      if (mStackString.empty())
+      DaedalusStringHandle handle = popStringHandle();
+      bs::String v                = mStrings.get(handle);
+
+      mStrings.release(handle);
+
+      return v;
+    }
+
+    DaedalusStringHandle DaedalusStack::popStringHandle()
+    {
+      if (mEntries.empty())
       {
         // Gothic defaults to returning 0 on an empty stack, so we just guess ""?
-        return "";
+        mStrings.addRef(DAEDALUS_STRING_EMPTY);
+        return DAEDALUS_STRING_EMPTY;
       }
 
       if (isTopOfStringStackVariable())
@@ -151,96 +214,140 @@ namespace REGoth
             "Top of script stack is a variable, but we were expecting it to be a simple string!");
       }
 
-      bs::String v = mStackString.back().value;
+      if (!isTopOfType(EntryType::String))
+      {
+        throwUnexpectedType("a simple string");
+      }
+
+      DaedalusStringHandle v = mEntries.back().string;
 
-      mStackString.pop_back();
+      mEntries.pop_back();
 
       return v;
     }
 
     SymbolIndex DaedalusStack::popInstance()
     {
-      if (mStackInstance.empty())
+      if (mEntries.empty())
       {
         return SYMBOL_INDEX_INVALID;
       }
 
-      SymbolIndex v = mStackInstance.back();
+      const StackEntry& entry = mEntries.back();
+      SymbolIndex v = SYMBOL_INDEX_INVALID;
+
+      switch (entry.type)
+      {
+        case EntryType::Instance:
+          v = entry.symbol;
+          break;
+
+        case EntryType::Int:
+          v = (SymbolIndex)entry.intValue;
+          break;
 
-      mStackInstance.pop_back();
+        default:
+          throwUnexpectedType("an instance");
+      }
+
+      mEntries.pop_back();
 
       return v;
     }
 
     SymbolIndex DaedalusStack::popFunction()
     {
-      if (mStackFunction.empty())
+      if (mEntries.empty())
       {
         return SYMBOL_INDEX_INVALID;
       }
 
-      SymbolIndex v = mStackFunction.back();
+      const StackEntry& entry = mEntries.back();
+      SymbolIndex v = SYMBOL_INDEX_INVALID;
 
-      mStackFunction.pop_back();
+      switch (entry.type)
+      {
+        case EntryType::Function:
+          v = entry.symbol;
+          break;
 
-      return v;
-    }
+        case EntryType::Int:
+          v = (SymbolIndex)entry.intValue;
+          break;
 
-    DaedalusStack::StackVariableValue DaedalusStack::popIntVariable()
-    {
-      if (!isTopOfIntStackVariable())
-      {
-        REGOTH_THROW(
-            InvalidParametersException,
-            "Top of script stack is a simple integer, but we were expecting it to be a variable!");
+        default:
+          throwUnexpectedType("a function");
       }
 
-      StackVariableValue v = mStackInt.back().variable;
-
-      mStackInt.pop_back();
+      mEntries.pop_back();
 
       return v;
     }
 
-    DaedalusStack::StackVariableValue DaedalusStack::popFloatVariable()
+    DaedalusStack::StackVariableValue DaedalusStack::popIntVariable()
     {
-      if (!isTopOfFloatStackVariable())
-      {
-        REGOTH_THROW(
-            InvalidParametersException,
-            "Top of script stack is a simple float, but we were expecting it to be a variable!");
-      }
-
-      StackVariableValue v = mStackFloat.back().variable;
-
-      mStackFloat.pop_back();
+      return popVariable(EntryType::IntVariable, EntryType::IntMemberVariable, "integer");
+    }
 
-      return v;
+    DaedalusStack::StackVariableValue DaedalusStack::popFloatVariable()
+    {
+      return popVariable(EntryType::FloatVariable, EntryType::FloatMemberVariable, "float");
     }
 
     DaedalusStack::StackVariableValue DaedalusStack::popStringVariable()
     {
-      if (!isTopOfStringStackVariable())
+      return popVariable(EntryType::StringVariable, EntryType::StringMemberVariable, "string");
+    }
+
+    DaedalusStack::StackVariableValue DaedalusStack::popVariable(EntryType globalType,
+                                                                 EntryType memberType,
+                                                                 const char* typeName)
+    {
+      if (!isTopOfVariableType(globalType, memberType))
       {
-        REGOTH_THROW(
-            InvalidParametersException,
-            "Top of script stack is a simple string, but we were expecting it to be a variable!");
+        REGOTH_THROW(InvalidParametersException,
+                     bs::String("Top of script stack is not a variable, but we were expecting it "
+                                "to be a ") +
+                         typeName + " variable!");
       }
 
-      StackVariableValue v = mStackString.back().variable;
+      const StackEntry& entry = mEntries.back();
+      StackVariableValue v    = {nullptr, {nullptr, MEMBER_SLOT_INVALID}, 0};
 
-      mStackString.pop_back();
+      if (entry.type == globalType)
+      {
+        v.global = entry.global;
+      }
+      else
+      {
+        v.slot       = entry.member.slot;
+        v.arrayIndex = entry.member.arrayIndex;
+      }
+
+      mEntries.pop_back();
 
       return v;
     }
 
+    void DaedalusStack::throwUnexpectedType(const char* expected) const
+    {
+      REGOTH_THROW(InvalidParametersException,
+                   bs::String("Top of script stack has type ") +
+                       bs::toString((int)mEntries.back().type) +
+                       ", but we were expecting it to be " + expected + "!");
+    }
+
     void DaedalusStack::clear()
     {
-      mStackInt.clear();
-      mStackFloat.clear();
-      mStackString.clear();
-      mStackInstance.clear();
-      mStackFunction.clear();
+      for (const StackEntry& entry : mEntries)
+      {
+        if (entry.type == EntryType::String)
+        {
+          mStrings.release(entry.string);
+        }
+      }
+
+      mEntries.clear();
     }
   }  // namespace Scripting
 }  // namespace REGoth
@@ -1,6 +1,7 @@
 /**\file
  */
 #pragma once
+#include "DaedalusStringPool.hpp"
 #include <BsPrerequisites.h>
 #include <scripting/ScriptVM.hpp>
 
@@ -13,32 +14,60 @@ namespace REGoth
      *
      * In the original, the stack was a single list of 32-bit integers
      * which was used for everything. This is not unusual for a processor to do
-     * as memory is just bytes anyways. However, to save us from all the casting
-     * and string related hacks, this Daedalus-Stack is using multiple stacks under
-     * the hood for the different types of values.
+     * as memory is just bytes anyways. Like the original, this is a single stack
+     * as well, but every entry is tagged with what kind of value it is. That way
+     * the order of values of different types is kept (which externals rely on)
+     * and we can still tell variables from plain values.
      *
-     * This keeps the VM type-save internally.
+     * The bytecode pushes floats via PushInt, so an int entry popped as float is
+     * reinterpreted bit by bit, just like the original does it.
+     *
+     * Strings are not stored inside the entries. Instead, they hold a handle to
+     * the string inside the VMs DaedalusStringPool, so that pushing and popping
+     * strings does not copy them. Every string entry holds one reference.
      */
     class DaedalusStack
     {
     public:
+      DaedalusStack(DaedalusStringPool& strings);
+      ~DaedalusStack();
+
       /**
        * Push a simple value onto the stack.
        */
       void pushInt(bs::INT32 value);
       void pushFloat(float value);
-      void pushString(bs::String value);
+      void pushString(const bs::String& value);
+
+      /**
+       * Pushes a string from the string pool onto the stack. The stack takes over
+       * the reference held by the given handle.
+       */
+      void pushStringHandle(DaedalusStringHandle handle);
       void pushInstance(SymbolIndex symbol);
       void pushFunction(SymbolIndex symbol);
 
       /**
-       * Push a reference to a variable onto the stack.
+       * Push a reference to the value of a global variable onto the stack.
+       *
+       * The value has to stay in place until the entry has been popped again.
+       */
+      void pushIntVariable(bs::INT32& value);
+      void pushFloatVariable(float& value);
+      void pushStringVariable(bs::String& value);
+
+      /**
+       * Push a reference to a class variable onto the stack, which is resolved against the
+       * *Current Instance* once it is popped.
        *
-       * Attention! This does not check whether the type of the symbol is correct!
+       * Attention! This does not check whether the slot is of the correct type!
+       *
+       * @param  slot        Slot of the member, see ScriptClassTemplates::getMemberSlot().
+       * @param  arrayIndex  Index into the values of the member.
        */
-      void pushIntVariable(SymbolIndex symbol, bs::UINT32 arrayIndex);
-      void pushFloatVariable(SymbolIndex symbol, bs::UINT32 arrayIndex);
-      void pushStringVariable(SymbolIndex symbol, bs::UINT32 arrayIndex);
+      void pushIntMemberVariable(const MemberSlot& slot, bs::UINT32 arrayIndex);
+      void pushFloatMemberVariable(const MemberSlot& slot, bs::UINT32 arrayIndex);
+      void pushStringMemberVariable(const MemberSlot& slot, bs::UINT32 arrayIndex);
 
       /**
        * @return Whether the top of the stack is a variable (otherwise it's a pure data value)
@@ -71,6 +100,12 @@ namespace REGoth
        */
       bs::String popString();
 
+      /**
+       * Like popString(), but returns the handle of the string inside the string pool
+       * instead of copying it. The caller takes over the reference held by the handle.
+       */
+      DaedalusStringHandle popStringHandle();
+
       /**
        * Pops from the stack.
        */
@@ -79,10 +114,22 @@ namespace REGoth
 
       /**
        * Reference to a value from a variable for use on the stack.
+       *
+       * Global variables point directly to their value. Class variables can only be
+       * resolved once the *Current Instance* is known, so they carry the slot of the
+       * member instead.
        */
       struct StackVariableValue
       {
-        SymbolIndex symbol;
+        /**
+         * Value of a global variable. nullptr, if this is a class variable.
+         */
+        void* global;
+
+        /**
+         * Class variables only: Slot of the member and index into its values.
+         */
+        MemberSlot slot;
         bs::UINT32 arrayIndex;
       };
 
@@ -117,49 +164,87 @@ namespace REGoth
 
     private:
       /**
-       * Integer value to push onto the stack. Can be either a plain integer value
-       * or a variable value, which we have to look up in the symbol storage first.
+       * What kind of value an entry of the stack holds.
        */
-      struct StackInt
+      enum class EntryType : bs::UINT8
       {
-        bool isVariableValue;
-        union {
-          StackVariableValue variable;
-          bs::INT32 value;
-        };
+        Int,
+        Float,
+        String,
+        Instance,
+        Function,
+        IntVariable,
+        FloatVariable,
+        StringVariable,
+        IntMemberVariable,
+        FloatMemberVariable,
+        StringMemberVariable,
       };
 
       /**
-       * Integer value to push onto the stack. Can be either a plain integer value
-       * or a variable value, which we have to look up in the symbol storage first.
+       * Class variable inside an entry, see StackVariableValue.
        */
-      struct StackFloat
+      struct MemberVariable
       {
-        bool isVariableValue;
+        MemberSlot slot;
+        bs::UINT32 arrayIndex;
+      };
+
+      /**
+       * Single entry of the stack. Can be either a plain value or a variable value,
+       * which we have to dereference first.
+       */
+      struct StackEntry
+      {
+        EntryType type;
         union {
-          StackVariableValue variable;
-          float value;
+          void* global;
+          MemberVariable member;
+          SymbolIndex symbol;
+          DaedalusStringHandle string;
+          bs::INT32 intValue;
+          float floatValue;
         };
       };
 
       /**
-       * Integer value to push onto the stack. Can be either a plain integer value
-       * or a variable value, which we have to look up in the symbol storage first.
+       * Pushes a new entry of the given type and returns it to fill in its value.
        */
-      struct StackString
+      StackEntry& pushEntry(EntryType type)
       {
-        bool isVariableValue;
+        mEntries.emplace_back();
+        mEntries.back().type = type;
 
-        // Not a union to keep the default constructor
-        StackVariableValue variable;
-        bs::String value;
-      };
+        return mEntries.back();
+      }
+
+      /**
+       * @return Whether the stack is not empty and the entry on top is of the given type.
+       */
+      bool isTopOfType(EntryType type) const
+      {
+        return !mEntries.empty() && mEntries.back().type == type;
+      }
+
+      /**
+       * @return Whether the entry on top is a global- or class variable of the given types.
+       */
+      bool isTopOfVariableType(EntryType globalType, EntryType memberType) const
+      {
+        return isTopOfType(globalType) || isTopOfType(memberType);
+      }
+
+      /**
+       * Removes the entry on top and returns its variable. Throws if the entry is not
+       * of the given variable types.
+       */
+      StackVariableValue popVariable(EntryType globalType, EntryType memberType,
+                                     const char* typeName);
+
+      void throwUnexpectedType(const char* expected) const;
 
-      bs::Vector<StackInt> mStackInt;
-      bs::Vector<StackFloat> mStackFloat;
-      bs::Vector<StackString> mStackString;
-      bs::Vector<SymbolIndex> mStackInstance;
-      bs::Vector<SymbolIndex> mStackFunction;
+      bs::Vector<StackEntry> mEntries;
+      DaedalusStringPool& mStrings;
     };
   }  // namespace Scripting
 }  // namespace REGoth
@@ -0,0 +1,110 @@
+#include "DaedalusStringPool.hpp"
+#include <Utility/BsTime.h>
+
+namespace REGoth
+{
+  namespace Scripting
+  {
+    /**
+     * References held by pinned strings. High enough to never be released.
+     */
+    static constexpr bs::UINT32 PINNED_REFERENCES = 0x80000000;
+
+    DaedalusStringPool::DaedalusStringPool()
+    {
+      pin("");
+    }
+
+    DaedalusStringHandle DaedalusStringPool::intern(const bs::String& value)
+    {
+      auto it = mHandlesByValue.find(value);
+
+      if (it != mHandlesByValue.end())
+      {
+        currentFrameStats().numAllocationsAvoided++;
+
+        addRef(it->second);
+        return it->second;
+      }
+
+      return insert(bs::String(value));
+    }
+
+    DaedalusStringHandle DaedalusStringPool::intern(bs::String&& value)
+    {
+      auto it = mHandlesByValue.find(value);
+
+      if (it != mHandlesByValue.end())
+      {
+        // The given string has already been allocated by the caller, so nothing was avoided
+        addRef(it->second);
+        return it->second;
+      }
+
+      return insert(std::move(value));
+    }
+
+    void DaedalusStringPool::pin(const bs::String& value)
+    {
+      DaedalusStringHandle handle = intern(value);
+
+      mEntries[handle].numReferences = PINNED_REFERENCES;
+    }
+
+    void DaedalusStringPool::release(DaedalusStringHandle handle)
+    {
+      Entry& entry = mEntries[handle];
+
+      entry.numReferences--;
+
+      if (entry.numReferences == 0)
+      {
+        mHandlesByValue.erase(entry.value);
+        entry.value.clear();
+
+        mFreeEntries.push_back(handle);
+      }
+    }
+
+    DaedalusStringHandle DaedalusStringPool::insert(bs::String&& value)
+    {
+      currentFrameStats().numAllocations++;
+
+      DaedalusStringHandle handle;
+
+      if (mFreeEntries.empty())
+      {
+        handle = (DaedalusStringHandle)mEntries.size();
+        mEntries.emplace_back();
+      }
+      else
+      {
+        handle = mFreeEntries.back();
+        mFreeEntries.pop_back();
+      }
+
+      Entry& entry = mEntries[handle];
+
+      entry.value         = std::move(value);
+      entry.numReferences = 1;
+
+      mHandlesByValue[entry.value] = handle;
+
+      return handle;
+    }
+
+    DaedalusStringPoolStats& DaedalusStringPool::currentFrameStats()
+    {
+      bs::UINT64 frame = bs::gTime().getFrameIdx();
+
+      if (frame != mCurrentFrame)
+      {
+        mLastFrameStats    = mCurrentFrameStats;
+        mCurrentFrameStats = DaedalusStringPoolStats();
+        mCurrentFrame      = frame;
+      }
+
+      return mCurrentFrameStats;
+    }
+  }  // namespace Scripting
+}  // namespace REGoth
@@ -0,0 +1,133 @@
+/**\file
+ */
+#pragma once
+#include <BsPrerequisites.h>
+
+namespace REGoth
+{
+  namespace Scripting
+  {
+    /**
+     * Handle to a string inside the DaedalusStringPool.
+     */
+    typedef bs::UINT32 DaedalusStringHandle;
+
+    /**
+     * Handle of the empty string, which is always available.
+     */
+    constexpr DaedalusStringHandle DAEDALUS_STRING_EMPTY = 0;
+
+    /**
+     * Counters of the DaedalusStringPool, see DaedalusStringPool::lastFrameStats().
+     */
+    struct DaedalusStringPoolStats
+    {
+      /**
+       * Number of strings which had to be newly allocated.
+       */
+      bs::UINT32 numAllocations = 0;
+
+      /**
+       * Number of strings which were already inside the pool and could be reused,
+       * where we would have made a copy otherwise.
+       */
+      bs::UINT32 numAllocationsAvoided = 0;
+    };
+
+    /**
+     * Pool of interned, reference-counted strings as used by the Daedalus-VM.
+     *
+     * Most strings seen by scripts are constants from the DAT-file, like names, SVM keys
+     * or waypoint names. Instead of copying those whenever they are put onto the stack,
+     * every distinct string is stored only once inside this pool and passed around via
+     * its handle.
+     *
+     * A handle holds a reference to its string. Once all references have been released,
+     * the string is removed from the pool and its handle may be reused.
+     *
+     * Constant strings from the DAT-file should be added via pin(), which keeps them
+     * inside the pool for as long as it exists.
+     */
+    class DaedalusStringPool
+    {
+    public:
+      DaedalusStringPool();
+
+      /**
+       * Looks up the given string inside the pool, adding it if it isn't in there yet.
+       *
+       * @return Handle to the string, holding one reference which has to be released.
+       */
+      DaedalusStringHandle intern(const bs::String& value);
+      DaedalusStringHandle intern(bs::String&& value);
+
+      /**
+       * Adds the given string and keeps it inside the pool until the pool is destroyed.
+       */
+      void pin(const bs::String& value);
+
+      /**
+       * Adds a reference to the given string.
+       */
+      void addRef(DaedalusStringHandle handle)
+      {
+        mEntries[handle].numReferences++;
+      }
+
+      /**
+       * Removes a reference from the given string. Once no references are left,
+       * the string is removed from the pool.
+       */
+      void release(DaedalusStringHandle handle);
+
+      /**
+       * @return The string behind the given handle.
+       */
+      const bs::String& get(DaedalusStringHandle handle) const
+      {
+        return mEntries[handle].value;
+      }
+
+      /**
+       * @return Number of distinct strings currently inside the pool.
+       */
+      bs::UINT32 numStrings() const
+      {
+        return (bs::UINT32)mHandlesByValue.size();
+      }
+
+      /**
+       * @return Counters of the last completed frame.
+       */
+      const DaedalusStringPoolStats& lastFrameStats() const
+      {
+        return mLastFrameStats;
+      }
+
+    private:
+      struct Entry
+      {
+        bs::String value;
+        bs::UINT32 numReferences = 0;
+      };
+
+      /**
+       * Starts a new set of counters, if the frame has changed since the last call.
+       */
+      DaedalusStringPoolStats& currentFrameStats();
+
+      /**
+       * Puts the given string into a free entry and registers it.
+       */
+      DaedalusStringHandle insert(bs::String&& value);
+
+      bs::Vector<Entry> mEntries;
+      bs::Vector<DaedalusStringHandle> mFreeEntries;
+      bs::UnorderedMap<bs::String, DaedalusStringHandle> mHandlesByValue;
+
+      bs::UINT64 mCurrentFrame = 0;
+      DaedalusStringPoolStats mCurrentFrameStats;
+      DaedalusStringPoolStats mLastFrameStats;
+    };
+  }  // namespace Scripting
+}  // namespace REGoth
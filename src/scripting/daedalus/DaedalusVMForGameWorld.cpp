@@ -1,6 +1,11 @@
 #include "DaedalusVMForGameWorld.hpp"
 #include "DaedalusClassVarResolver.hpp"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <numeric>
 #include <RTTI/RTTI_DaedalusVMForGameWorld.hpp>
+#include <Scene/BsSceneManager.h>
 #include <Scene/BsSceneObject.h>
 #include <animation/StateNaming.hpp>
 #include <components/Character.hpp>
@@ -14,19 +19,35 @@
 #include <components/StoryInformation.hpp>
 #include <components/VisualCharacter.hpp>
 #include <components/Waynet.hpp>
+#include <daedalus/DATFile.h>
 #include <log/logging.hpp>
 #include <scripting/ScriptSymbolQueries.hpp>
 
-// TODO: Refactor, so we don't access deep into the UI code here for dialogues
-#include <components/GameplayUI.hpp>
-
 namespace REGoth
 {
   namespace Scripting
   {
+    /**
+     * Has the character go to the waypoint with the given name or, if there is none, to the
+     * object with that name. Scripts use both, see GameWorld::findSpawnPoint().
+     */
+    static void pushGotoWaypointOrObject(HGameWorld world, HCharacterEventQueue eventQueue,
+                                         const bs::String& name)
+    {
+      WaypointIndex waypoint = world->waynet()->findWaypoint(name);
+
+      if (waypoint != NO_WAYPOINT)
+      {
+        eventQueue->pushGotoPosition(world->waynet()->waypointPosition(waypoint));
+        return;
+      }
+
+      eventQueue->pushGotoObject(world->findObjectByName(name));
+    }
+
     DaedalusVMForGameWorld::DaedalusVMForGameWorld(HGameWorld gameWorld,
-                                                   const bs::Vector<bs::UINT8>& datFileData)
-        : DaedalusVM(datFileData)
+                                                   bs::SPtr<const DaedalusProgram> program)
+        : DaedalusVM(std::move(program))
         , mWorld(gameWorld)
     {
     }
@@ -36,12 +57,87 @@ namespace REGoth
       DaedalusVM::initialize();
 
       createAllInformationInstances();
+      createSvmTable();
+      analyzeDialogueOutputs();
     }
 
     void DaedalusVMForGameWorld::fillSymbolStorage()
     {
       DaedalusVM::fillSymbolStorage();
 
+      findSpecialSymbols();
+      findAIStateFunctions();
+    }
+
+    void DaedalusVMForGameWorld::onRestoredFromSnapshot()
+    {
+      DaedalusVM::onRestoredFromSnapshot();
+
+      findSpecialSymbols();
+
+      // The information instances themselves are part of the snapshot
+      mapInformationInstancesToNpcs();
+
+      // Refers to the values of the symbols which have just been replaced
+      mInfoConditionCache.clear();
+      mInstanceTemplates.clear();
+      mItemDefinitions.clear();
+
+      createSvmTable();
+      analyzeDialogueOutputs();
+    }
+
+    void DaedalusVMForGameWorld::onBeforeDATReload()
+    {
+      // Constructors and class layouts may change
+      mInstanceTemplates.clear();
+      mItemDefinitions.clear();
+
+      // Which infos are known is stored by index, which will be different
+      for (HStoryInformation info : bs::gSceneManager().findComponents<StoryInformation>(false))
+      {
+        mKnownInfosBeforeReload.push_back({info, info->knownInfoNames()});
+      }
+
+      for (SymbolIndex s : Queries::findAllInstancesOfClass(scriptSymbols(), "C_INFO"))
+      {
+        mInfoObjectsBeforeReload.push_back(scriptSymbols().getSymbol<SymbolInstance>(s).instance);
+      }
+    }
+
+    void DaedalusVMForGameWorld::onDATReloaded()
+    {
+      // Infos don't hold any state of their own, so they are created from the new scripts to
+      // pick up changed conditions and texts
+      for (ScriptObjectHandle h : mInfoObjectsBeforeReload)
+      {
+        if (scriptObjects().isValid(h))
+        {
+          scriptObjects().destroy(h);
+        }
+      }
+
+      createAllInformationInstances();
+
+      for (const KnownInfosBeforeReload& known : mKnownInfosBeforeReload)
+      {
+        if (known.storyInformation.isDestroyed()) continue;
+
+        known.storyInformation->setKnownInfoNames(known.knownInfoNames);
+      }
+
+      mKnownInfosBeforeReload.clear();
+      mInfoObjectsBeforeReload.clear();
+
+      // Refers to the symbols which have just been replaced
+      mInfoConditionCache.clear();
+
+      createSvmTable();
+      analyzeDialogueOutputs();
+    }
+
+    void DaedalusVMForGameWorld::findSpecialSymbols()
+    {
       mHeroSymbol   = scriptSymbols().findIndexBySymbolName("HERO");
       mSelfSymbol   = scriptSymbols().findIndexBySymbolName("SELF");
       mOtherSymbol  = scriptSymbols().findIndexBySymbolName("OTHER");
@@ -49,6 +145,277 @@ namespace REGoth
       mItemSymbol   = scriptSymbols().findIndexBySymbolName("ITEM");
     }
 
+    void DaedalusVMForGameWorld::findAIStateFunctions()
+    {
+      struct Tag
+      {
+        bs::String suffix;
+        SymbolIndex AIStateFunctions::*function;
+      };
+
+      static const Tag TAGS[] = {
+          {"_LOOP", &AIStateFunctions::loop},
+          {"_END", &AIStateFunctions::end},
+          {"_INTERRUPT", &AIStateFunctions::interrupt},
+      };
+
+      mAIStateFunctions.clear();
+
+      const ScriptSymbolStorage& symbols = scriptSymbolsConst();
+
+      for (SymbolIndex i = 0; i < symbols.numSymbols(); i++)
+      {
+        if (symbols.getSymbolType(i) != SymbolType::ScriptFunction) continue;
+
+        const bs::String& name = symbols.getSymbolName(i);
+
+        for (const Tag& tag : TAGS)
+        {
+          if (!bs::StringUtil::endsWith(name, tag.suffix, false)) continue;
+
+          bs::String mainName = name.substr(0, name.size() - tag.suffix.size());
+
+          if (!symbols.hasSymbolWithName(mainName)) break;
+
+          SymbolIndex main = symbols.findIndexBySymbolName(mainName);
+
+          if (symbols.getSymbolType(main) != SymbolType::ScriptFunction) break;
+
+          AIStateFunctions& functions = mAIStateFunctions[main];
+          functions.main              = main;
+          functions.*tag.function     = i;
+
+          break;
+        }
+      }
+    }
+
+    AIStateFunctions DaedalusVMForGameWorld::aiStateFunctions(SymbolIndex stateFunction) const
+    {
+      auto it = mAIStateFunctions.find(stateFunction);
+
+      if (it != mAIStateFunctions.end()) return it->second;
+
+      AIStateFunctions functions;
+      functions.main = stateFunction;
+
+      return functions;
+    }
+
+    const ItemDefinition& DaedalusVMForGameWorld::itemDefinition(SymbolIndex itemInstance)
+    {
+      auto it = mItemDefinitions.find(itemInstance);
+
+      if (it != mItemDefinitions.end()) return it->second;
+
+      SymbolInstance& symbol = mScriptSymbols.getSymbol<SymbolInstance>(itemInstance);
+
+      // Creating an object makes it the last one of the instance, which scripts can refer to
+      ScriptObjectHandle oldInstance = symbol.instance;
+      ScriptObjectHandle obj         = instanciateClass("C_ITEM", symbol, {});
+      symbol.instance                = oldInstance;
+
+      ScriptObject& data = mScriptObjects.get(obj);
+
+      ItemDefinition definition;
+      definition.name         = data.stringValue("NAME");
+      definition.description  = data.stringValue("DESCRIPTION");
+      definition.visual       = data.stringValue("VISUAL");
+      definition.visualChange = data.stringValue("VISUAL_CHANGE");
+      definition.value        = data.intValue("VALUE");
+      definition.mainFlag     = data.intValue("MAINFLAG");
+      definition.flags        = data.intValue("FLAGS");
+
+      mScriptObjects.destroy(obj);
+
+      return mItemDefinitions[itemInstance] = definition;
+    }
+
+    void DaedalusVMForGameWorld::createSvmTable()
+    {
+      mSvmTable.clear();
+
+      const bs::String prefix = "SVM_";
+      bool hasKeys            = false;
+
+      for (SymbolIndex s : Queries::findAllInstancesOfClass(scriptSymbols(), "C_SVM"))
+      {
+        SymbolInstance& symbol = mScriptSymbols.getSymbol<SymbolInstance>(s);
+
+        if (!bs::StringUtil::startsWith(symbol.name, prefix, false)) continue;
+
+        bs::String voiceText = symbol.name.substr(prefix.size());
+
+        if (voiceText.empty() || !std::all_of(voiceText.begin(), voiceText.end(), ::isdigit))
+        {
+          continue;
+        }
+
+        // Creating an object makes it the last one of the instance, which scripts can refer to
+        ScriptObjectHandle oldInstance = symbol.instance;
+        ScriptObjectHandle obj         = instanciateClass("C_SVM", symbol, {});
+        symbol.instance                = oldInstance;
+
+        ScriptObject& svm = mScriptObjects.get(obj);
+
+        if (!hasKeys)
+        {
+          mSvmTable.setKeys(*svm.layout());
+          hasKeys = true;
+        }
+
+        mSvmTable.setVoice(bs::parseINT32(voiceText), svm);
+
+        mScriptObjects.destroy(obj);
+      }
+
+      REGOTH_LOG(Verbose, VM, "[DaedalusVMForGameWorld] Read {0} SVMs for {1} voices",
+                 mSvmTable.numKeys(), mSvmTable.numVoices());
+    }
+
+    void DaedalusVMForGameWorld::analyzeDialogueOutputs()
+    {
+      mDialogueOutputs.clear();
+
+      bs::UINT32 numLines = 0;
+      bs::UINT32 numSvms  = 0;
+
+      for (const DialogueInfo& info : mDialogueInfos)
+      {
+        if (info.informationFunction == SYMBOL_INDEX_INVALID) continue;
+
+        const DialogueOutputs& outputs = dialogueOutputsOf(info.informationFunction);
+
+        numLines += (bs::UINT32)outputs.outputNames.size();
+        numSvms += (bs::UINT32)outputs.svmKeys.size();
+      }
+
+      REGOTH_LOG(Verbose, VM,
+                 "[DaedalusVMForGameWorld] Information functions say {0} lines and {1} SVMs",
+                 numLines, numSvms);
+    }
+
+    const DialogueOutputs& DaedalusVMForGameWorld::dialogueOutputsOf(SymbolIndex function)
+    {
+      return dialogueOutputsAt(scriptSymbols().getSymbol<SymbolScriptFunction>(function).address);
+    }
+
+    const DialogueOutputs& DaedalusVMForGameWorld::dialogueOutputsAt(bs::UINT32 start)
+    {
+      auto it = mDialogueOutputs.find(start);
+
+      if (it != mDialogueOutputs.end()) return it->second;
+
+      // Inserted before walking, so functions calling themselves stop here. References into
+      // the map stay valid while the functions called from here are added.
+      DialogueOutputs& outputs = mDialogueOutputs[start];
+
+      auto findExternal = [&](const char* name) -> SymbolIndex {
+        if (!scriptSymbols().hasSymbolWithName(name)) return SYMBOL_INDEX_INVALID;
+
+        return scriptSymbols().findIndexBySymbolName(name);
+      };
+
+      SymbolIndex outputExternal    = findExternal("AI_OUTPUT");
+      SymbolIndex outputSvmExternal = findExternal("AI_OUTPUTSVM");
+
+      auto addSvm = [&](const bs::String& svmName) {
+        SvmKey key = mSvmTable.findKey(svmName);
+
+        if (key != SVM_KEY_INVALID) outputs.svmKeys.push_back(key);
+      };
+
+      // Follows the jumps of the function like DaedalusNativeCompiler does
+      bs::Set<bs::UINT32> visited;
+      bs::Vector<bs::UINT32> open = {start};
+
+      while (!open.empty())
+      {
+        bs::UINT32 address = open.back();
+        open.pop_back();
+
+        const bs::String* pushedText = nullptr;
+
+        while (visited.insert(address).second)
+        {
+          // Copied, since decoding more might invalidate the reference
+          DaedalusInstruction instruction = instructionMemory().instructionAt(address);
+
+          if (instruction.size == 0 || instruction.op == Daedalus::EParOp_Ret) break;
+
+          if (instruction.op == Daedalus::EParOp_CallExternal && pushedText)
+          {
+            if (instruction.symbol() == outputExternal)
+            {
+              outputs.outputNames.push_back(*pushedText);
+            }
+            else if (instruction.symbol() == outputSvmExternal)
+            {
+              addSvm(*pushedText);
+            }
+          }
+
+          if (instruction.op == Daedalus::EParOp_Call)
+          {
+            // Like `B_Say (self, other, "$ALARM")`, which passes the SVM on to `AI_OutputSVM`
+            if (pushedText && !pushedText->empty() && (*pushedText)[0] == '$')
+            {
+              addSvm(*pushedText);
+            }
+
+            const DialogueOutputs& called = dialogueOutputsAt(instruction.address());
+
+            if (&called != &outputs)
+            {
+              outputs.outputNames.insert(outputs.outputNames.end(), called.outputNames.begin(),
+                                         called.outputNames.end());
+              outputs.svmKeys.insert(outputs.svmKeys.end(), called.svmKeys.begin(),
+                                     called.svmKeys.end());
+            }
+          }
+
+          pushedText = nullptr;
+
+          if (instruction.op == Daedalus::EParOp_PushVar)
+          {
+            const SymbolBase& pushed = scriptSymbols().getSymbolBase(instruction.symbol());
+
+            if (pushed.type == SymbolType::String && !pushed.isClassVar)
+            {
+              const ScriptStrings& strings =
+                  scriptSymbols().getSymbol<SymbolString>(instruction.symbol()).strings;
+
+              if (!strings.empty()) pushedText = &strings[0];
+            }
+          }
+
+          if (instruction.op == Daedalus::EParOp_Jump)
+          {
+            address = instruction.address();
+            continue;
+          }
+
+          if (instruction.op == Daedalus::EParOp_JumpIf)
+          {
+            open.push_back(instruction.address());
+          }
+
+          address += instruction.size;
+        }
+      }
+
+      std::sort(outputs.outputNames.begin(), outputs.outputNames.end());
+      outputs.outputNames.erase(
+          std::unique(outputs.outputNames.begin(), outputs.outputNames.end()),
+          outputs.outputNames.end());
+
+      std::sort(outputs.svmKeys.begin(), outputs.svmKeys.end());
+      outputs.svmKeys.erase(std::unique(outputs.svmKeys.begin(), outputs.svmKeys.end()),
+                            outputs.svmKeys.end());
+
+      return outputs;
+    }
+
     ScriptObjectHandle DaedalusVMForGameWorld::instanciateClass(const bs::String& className,
                                                                 const bs::String& instanceName,
                                                                 bs::HSceneObject mappedSceneObject)
@@ -90,6 +457,12 @@ namespace REGoth
       //
       // Since the constructor *can* call externals which refer to the scene object, we need
       // to also map the objects *before* executing the constructor.
+      //
+      // Most constructors, like those of items, only assign constant values to the members,
+      // so running them again leads to the same object. For those, the object created the
+      // first time is kept as template, which later objects are copied from instead of
+      // running the constructor. Constructors doing anything else, like calling externals,
+      // are always run. See DaedalusInstructionMemory::isConstructorFreeOfSideEffects().
 
       ScriptObjectHandle obj = instanciateBlankObjectOfClass(className);
       ScriptObject& objData  = mScriptObjects.get(obj);
@@ -105,16 +478,38 @@ namespace REGoth
 
       instance.instance = obj;
 
+      auto cached = mInstanceTemplates.find(instance.index);
+
+      if (cached != mInstanceTemplates.end() && cached->second.isCacheable &&
+          cached->second.object.layout() == objData.layout())
+      {
+        objData.copyMembersFrom(cached->second.object);
+
+        return obj;
+      }
+
       ScriptObjectHandle oldCurrentInstance = mClassVarResolver->getCurrentInstance();
-      ScriptObjectHandle oldSelf            = getInstance("SELF");
+      ScriptObjectHandle oldSelf            = getInstance(mSelfSymbol);
 
-      setInstance("SELF", obj);
+      setInstance(mSelfSymbol, obj);
       mClassVarResolver->setCurrentInstance(obj);
 
       executeScriptFunction(instance.constructorAddress);
 
       mClassVarResolver->setCurrentInstance(oldCurrentInstance);
-      setInstance("SELF", oldSelf);
+      setInstance(mSelfSymbol, oldSelf);
+
+      if (cached == mInstanceTemplates.end())
+      {
+        InstanceTemplate& created = mInstanceTemplates[instance.index];
+        created.isCacheable       = isConstructorFreeOfSideEffects(instance.constructorAddress);
+
+        if (created.isCacheable)
+        {
+          // The constructor might have created other objects, which invalidates objData
+          created.object = mScriptObjects.get(obj);
+        }
+      }
 
       // debugLogScriptObject(objData);
 
@@ -127,13 +522,64 @@ namespace REGoth
       executeScriptFunction(function);
     }
 
+    void DaedalusVMForGameWorld::runFunctionOnSelf(const SymbolRef& function, HCharacter self)
+    {
+      runFunctionOnSelf(function.resolve(mScriptSymbols), self);
+    }
+
     bool DaedalusVMForGameWorld::runStateLoopFunction(SymbolIndex function, HCharacter self)
+    {
+      return runStateLoop(scriptSymbols().getSymbol<SymbolScriptFunction>(function), self);
+    }
+
+    DaedalusVMForGameWorld::StateLoopBatchStats DaedalusVMForGameWorld::runStateLoopFunctions(
+        bs::Vector<StateLoopCall>& calls)
+    {
+      auto start = std::chrono::steady_clock::now();
+
+      // Group the calls by function, keeping the order of the characters within a group
+      bs::Vector<bs::UINT32> order(calls.size());
+      std::iota(order.begin(), order.end(), 0);
+
+      std::stable_sort(order.begin(), order.end(), [&](bs::UINT32 a, bs::UINT32 b) {
+        return calls[a].function < calls[b].function;
+      });
+
+      StateLoopBatchStats stats;
+      stats.numCalls = (bs::UINT32)calls.size();
+
+      SymbolIndex currentFunction             = SYMBOL_INDEX_INVALID;
+      const SymbolScriptFunction* functionSym = nullptr;
+
+      for (bs::UINT32 i : order)
+      {
+        StateLoopCall& call = calls[i];
+
+        if (!functionSym || call.function != currentFunction)
+        {
+          currentFunction = call.function;
+          functionSym     = &scriptSymbols().getSymbol<SymbolScriptFunction>(currentFunction);
+
+          stats.numFunctions += 1;
+        }
+
+        call.isDone = runStateLoop(*functionSym, call.self);
+      }
+
+      auto duration     = std::chrono::steady_clock::now() - start;
+      stats.nanoseconds = (bs::UINT64)std::chrono::duration_cast<std::chrono::nanoseconds>(duration)
+                              .count();
+
+      return stats;
+    }
+
+    bool DaedalusVMForGameWorld::runStateLoop(const SymbolScriptFunction& functionSym,
+                                              HCharacter self)
     {
       self->useAsSelf();
 
       mStack.clear();
 
-      const auto& functionSym = scriptSymbols().getSymbol<SymbolScriptFunction>(function);
       executeScriptFunction(functionSym.address);
 
       if (functionSym.returnType != ReturnType::Void)
@@ -158,9 +604,77 @@ namespace REGoth
 
       const auto& functionSym = scriptSymbols().getSymbol<SymbolScriptFunction>(function);
 
-      executeScriptFunction(functionSym.address);
+      // Conditions run from within another recorded piece of code are not cached on their own
+      if (isRecordingReads())
+      {
+        executeScriptFunction(functionSym.address);
+
+        return popIntValue() != 0;
+      }
+
+      InfoConditionKey key{function, self->scriptObject(), other->scriptObject()};
+
+      auto it = mInfoConditionCache.find(key);
+
+      if (it != mInfoConditionCache.end() && isCachedInfoConditionValid(it->second))
+      {
+        return it->second.result;
+      }
+
+      CachedInfoCondition& cached = mInfoConditionCache[key];
+      cached                      = CachedInfoCondition{};
+
+      mRecordedInfoCondition = &cached;
+      setRecordedReads(&cached.reads);
+
+      bool result;
+
+      try
+      {
+        executeScriptFunction(functionSym.address);
+
+        // The returned value might be a variable as well
+        result = popIntValue() != 0;
+      }
+      catch (...)
+      {
+        setRecordedReads(nullptr);
+        mRecordedInfoCondition = nullptr;
+        mInfoConditionCache.erase(key);
+
+        throw;
+      }
+
+      setRecordedReads(nullptr);
+      mRecordedInfoCondition = nullptr;
+
+      if (cached.reads.isCacheable)
+      {
+        cached.result = result;
+      }
+      else
+      {
+        mInfoConditionCache.erase(key);
+      }
 
-      return popIntValue() != 0;
+      return result;
+    }
+
+    bool DaedalusVMForGameWorld::isCachedInfoConditionValid(const CachedInfoCondition& cached)
+    {
+      for (const auto& knownInfos : cached.knownInfos)
+      {
+        if (knownInfos.first.isDestroyed()) return false;
+        if (knownInfos.first->knownInfosVersion() != knownInfos.second) return false;
+      }
+
+      for (const auto& inventory : cached.inventories)
+      {
+        if (inventory.first.isDestroyed()) return false;
+        if (inventory.first->itemsVersion() != inventory.second) return false;
+      }
+
+      return areRecordedReadsUnchanged(cached.reads);
     }
 
     void DaedalusVMForGameWorld::runInfoFunction(SymbolIndex function, HCharacter self,
@@ -184,6 +698,15 @@ namespace REGoth
       executeScriptFunction(functionSym.address);
     }
 
+    DaedalusFiberHandle DaedalusVMForGameWorld::startFiberOnSelf(SymbolIndex function,
+                                                                HCharacter self)
+    {
+      self->useAsSelf();
+
+      const auto& functionSym = scriptSymbols().getSymbol<SymbolScriptFunction>(function);
+      return startFiber(functionSym.address);
+    }
+
     void DaedalusVMForGameWorld::setHero(ScriptObjectHandle hero)
     {
       setInstance(mHeroSymbol, hero);
@@ -269,6 +792,12 @@ namespace REGoth
       symbol.instance = scriptObject;
     }
 
+    void DaedalusVMForGameWorld::setInstance(const SymbolRef& instance,
+                                             ScriptObjectHandle scriptObject)
+    {
+      setInstance(instance.resolve(mScriptSymbols), scriptObject);
+    }
+
     ScriptObjectHandle DaedalusVMForGameWorld::getInstance(const bs::String& instance) const
     {
       const SymbolInstance& symbol = mScriptSymbols.getSymbol<SymbolInstance>(instance);
@@ -276,6 +805,11 @@ namespace REGoth
       return symbol.instance;
     }
 
+    ScriptObjectHandle DaedalusVMForGameWorld::getInstance(const SymbolRef& instance) const
+    {
+      return getInstance(instance.resolve(mScriptSymbols));
+    }
+
     ScriptObjectHandle DaedalusVMForGameWorld::getInstance(SymbolIndex symbolIndex) const
     {
       const SymbolInstance& symbol = mScriptSymbols.getSymbol<SymbolInstance>(symbolIndex);
@@ -411,22 +945,75 @@ namespace REGoth
       return item;
     }
 
+    bs::Vector3 DaedalusVMForGameWorld::positionOfMappedObject(
+        ScriptObjectHandle scriptObject) const
+    {
+      const bs::Vector3* position = mappingConst().findMappedPosition(scriptObject);
+
+      if (position) return *position;
+
+      return mappingConst().getMappedSceneObject(scriptObject)->getTransform().pos();
+    }
+
     void DaedalusVMForGameWorld::initializeWorld(const bs::String& worldName)
     {
       // Some scripts already refer to the hero, so make sure that has been set
-      if (getInstance("HERO") == SCRIPT_OBJECT_HANDLE_INVALID)
+      if (getInstance(mHeroSymbol) == SCRIPT_OBJECT_HANDLE_INVALID)
       {
         REGOTH_THROW(InvalidStateException, "Hero-instance must be set to call world init scripts!");
       }
 
       // Some G1-Scripts refer to SELF during init while doing debug-output.
       // I can only assume they mean the hero.
-      setInstance("SELF", getInstance("HERO"));
+      setInstance(mSelfSymbol, getInstance(mHeroSymbol));
+
+      mIsCollectingInsertions = true;
 
       // FIXME: Do STARTUP_* only on first load?
       executeScriptFunction("STARTUP_" + worldName);
 
       executeScriptFunction("INIT_" + worldName);
+
+      flushBatchedExternals();
+      mIsCollectingInsertions = false;
+    }
+
+    void DaedalusVMForGameWorld::flushBatchedExternals()
+    {
+      // Cleared first, the constructors of the inserted instances call externals as well
+      mHasBatchedExternals = false;
+
+      mWorld->insertQueued();
+
+      // Includes the items given by the constructors of the instances inserted above
+      giveQueuedInventoryItems();
+    }
+
+    void DaedalusVMForGameWorld::giveQueuedInventoryItems()
+    {
+      bs::Vector<QueuedInventoryItems> queued = std::move(mQueuedInventoryItems);
+      mQueuedInventoryItems.clear();
+
+      // Items for the same character are usually created one after another by its
+      // constructor, so give those all at once.
+      bs::Vector<Inventory::ItemStack> items;
+
+      for (size_t i = 0; i < queued.size(); i++)
+      {
+        items.push_back({queued[i].instance, queued[i].count});
+
+        bool isLastOfInventory =
+            i + 1 == queued.size() || queued[i + 1].inventory != queued[i].inventory;
+
+        if (!isLastOfInventory) continue;
+
+        if (!queued[i].inventory.isDestroyed())
+        {
+          queued[i].inventory->giveItems(items);
+        }
+
+        items.clear();
+      }
     }
 
     void DaedalusVMForGameWorld::registerAllExternals()
@@ -463,6 +1050,8 @@ namespace REGoth
       registerExternal("AI_WAIT", (externalCallback)&This::external_AI_Wait);
       registerExternal("AI_STARTSTATE", (externalCallback)&This::external_AI_StartState);
       registerExternal("AI_PLAYANI", (externalCallback)&This::external_AI_PlayAnimation);
+      registerExternal("AI_OUTPUT", (externalCallback)&This::external_AI_Output);
+      registerExternal("AI_OUTPUTSVM", (externalCallback)&This::external_AI_OutputSVM);
       registerExternal("NPC_GETNEARESTWP", (externalCallback)&This::external_Npc_GetNearestWP);
       registerExternal("NPC_GETNEXTWP", (externalCallback)&This::external_Npc_GetNextWP);
       registerExternal("NPC_GETDISTTOWP", (externalCallback)&This::external_Npc_GetDistToWP);
@@ -474,6 +1063,9 @@ namespace REGoth
       registerExternal("NPC_KNOWSINFO", (externalCallback)&This::external_Npc_KnowsInfo);
       registerExternal("NPC_REFUSETALK", (externalCallback)&This::external_Npc_RefuseTalk);
       registerExternal("NPC_GETSTATETIME", (externalCallback)&This::external_Npc_GetStateTime);
+      registerExternal("NPC_PERCENABLE", (externalCallback)&This::external_Npc_Percenable);
+      registerExternal("NPC_PERCDISABLE", (externalCallback)&This::external_Npc_PercDisable);
+      registerExternal("NPC_SETPERCTIME", (externalCallback)&This::external_Npc_SetPercTime);
       registerExternal("NPC_GETBODYSTATE", (externalCallback)&This::external_Npc_GetBodyState);
       registerExternal("AI_PROCESSINFOS", (externalCallback)&This::external_AI_ProcessInfos);
       registerExternal("AI_STOPPROCESSINFOS", (externalCallback)&This::external_AI_StopProcessInfos);
@@ -487,11 +1079,39 @@ namespace REGoth
                        (externalCallback)&This::external_Npc_GetInvItemBySlot);
       registerExternal("INFOMANAGER_HASFINISHED",
                        (externalCallback)&This::external_InfoManager_HasFinished);
+
+      // Not part of the original scripts, only there if declared by a mod, see
+      // startFiberOnSelf()
+      if (scriptSymbols().hasSymbolWithName("REGOTH_STARTFIBER"))
+      {
+        registerExternal("REGOTH_STARTFIBER", (externalCallback)&This::external_REGOTH_StartFiber);
+      }
+
+      if (scriptSymbols().hasSymbolWithName("REGOTH_AI_WAITUNTILDONE"))
+      {
+        registerExternal("REGOTH_AI_WAITUNTILDONE",
+                         (externalCallback)&This::external_REGOTH_AI_WaitUntilDone);
+      }
+
+      // Only collected during the world init scripts, see mIsCollectingInsertions
+      markExternalAsBatchable("WLD_INSERTNPC");
+      markExternalAsBatchable("WLD_INSERTITEM");
+      markExternalAsBatchable("CREATEINVITEMS");
+      markExternalAsBatchable("CREATEINVITEM");
+
+      // Can be called from cached info conditions, see runInfoConditionFunction()
+      markExternalAsCacheable("HLP_GETNPC");
+      markExternalAsCacheable("INTTOSTRING");
+      markExternalAsCacheable("INTTOFLOAT");
+      markExternalAsCacheable("FLOATTOINT");
+      markExternalAsCacheable("CONCATSTRINGS");
+      markExternalAsCacheable("NPC_KNOWSINFO");
+      markExternalAsCacheable("NPC_HASITEMS");
     }
 
     void DaedalusVMForGameWorld::external_Print()
     {
-      REGOTH_LOG(Info, Uncategorized, "[ScriptVMInterface] [Print] " + popStringValue());
+      REGOTH_LOG(Info, VM, "[ScriptVMInterface] [Print] " + popStringValue());
     }
 
     void DaedalusVMForGameWorld::external_PrintDebugInstCh()
@@ -504,7 +1124,10 @@ namespace REGoth
 
     void DaedalusVMForGameWorld::external_HLP_Random()
     {
-      mStack.pushInt(rand() % popIntValue());
+      bs::INT32 bound = popIntValue();
+
+      // Drawn from the world, so the numbers are saved and replayed along with it
+      mStack.pushInt(bound > 0 ? (bs::INT32)mWorld->random().below((bs::UINT32)bound) : 0);
     }
 
     void DaedalusVMForGameWorld::external_HLP_GetNpc()
@@ -559,10 +1182,16 @@ namespace REGoth
 
     void DaedalusVMForGameWorld::external_ConcatStrings()
     {
-      bs::String b = popStringValue();
-      bs::String a = popStringValue();
+      DaedalusStringHandle b = popStringHandle();
+      DaedalusStringHandle a = popStringHandle();
+
+      // The only place where scripts create new strings
+      bs::String result = mStringPool.get(a) + mStringPool.get(b);
+
+      mStringPool.release(a);
+      mStringPool.release(b);
 
-      mStack.pushString(a + b);
+      mStack.pushStringHandle(mStringPool.intern(std::move(result)));
     }
 
     void DaedalusVMForGameWorld::external_WLD_InsertItem()
@@ -570,6 +1199,14 @@ namespace REGoth
       bs::String spawnpoint = popStringValue();
       SymbolIndex instance  = popIntValue();
 
+      if (mIsCollectingInsertions)
+      {
+        mWorld->queueInsertion({GameWorld::Insertion::Kind::Item,
+                                mScriptSymbols.getSymbolName(instance), spawnpoint});
+        mHasBatchedExternals = true;
+        return;
+      }
+
       mWorld->insertItem(mScriptSymbols.getSymbolName(instance), spawnpoint);
     }
 
@@ -578,6 +1215,14 @@ namespace REGoth
       bs::String waypoint  = popStringValue();
       SymbolIndex instance = popIntValue();
 
+      if (mIsCollectingInsertions)
+      {
+        mWorld->queueInsertion({GameWorld::Insertion::Kind::Character,
+                                mScriptSymbols.getSymbolName(instance), waypoint});
+        mHasBatchedExternals = true;
+        return;
+      }
+
       mWorld->insertCharacter(mScriptSymbols.getSymbolName(instance), waypoint);
     }
 
@@ -621,7 +1266,7 @@ namespace REGoth
       bs::INT32 talent     = popIntValue();
       HCharacter character = popCharacterInstance();
 
-      REGOTH_LOG(Warning, Uncategorized, "[External] Using external stub: NPC_SetTalentSkill");
+      REGOTH_LOG(Warning, VM, "[External] Using external stub: NPC_SetTalentSkill");
     }
 
     void DaedalusVMForGameWorld::external_MDL_SetVisual()
@@ -637,11 +1282,13 @@ namespace REGoth
       // }
       // else
       // {
-      characterVisual = character->SO()->getComponent<VisualCharacter>();
+      characterVisual = character->visual();
       // }
 
+      // Loading the model script would stall the scripts inserting the character. Body and
+      // head set meanwhile wait for it, see VisualCharacter.
       bs::StringUtil::toUpperCase(visual);
-      characterVisual->setVisual(visual);
+      characterVisual->setVisualAsync(visual);
     }
 
     void DaedalusVMForGameWorld::external_MDL_SetVisualBody()
@@ -660,29 +1307,20 @@ namespace REGoth
       // visual settings from inside the armor instance
       if (armorInstance != -1)
       {
-        // TODO: Original Gothic adds the Armor straight to the inventory. We just create a
-        // temporary instance to extract the visual information from it
-        ScriptObjectHandle armorSObj = getInstance(armorInstance);
-
-        if (!armorSObj)
-        {
-          armorSObj = instanciateClass("C_ITEM", armorInstance, {});
-        }
-
-        ScriptObject& armor = mScriptObjects.get(armorSObj);
-
-        bodyMesh = armor.stringValue("VISUAL_CHANGE");
+        // TODO: Original Gothic adds the Armor straight to the inventory. We only take the
+        // visual information from it.
+        bodyMesh = itemDefinition(armorInstance).visualChange;
       }
 
       HCharacter character = popCharacterInstance();
 
-      HVisualCharacter characterVisual = character->SO()->getComponent<VisualCharacter>();
+      HVisualCharacter characterVisual = character->visual();
 
       bs::StringUtil::toUpperCase(bodyMesh);
-      characterVisual->setBodyMesh(bodyMesh);
+      characterVisual->setBodyMesh(bodyMesh, (bs::UINT32)bodyTexIndex, (bs::UINT32)bodyTexColor);
 
       bs::StringUtil::toUpperCase(headMesh);
-      characterVisual->setHeadMesh(headMesh);
+      characterVisual->setHeadMesh(headMesh, (bs::UINT32)headTexIndex, (bs::UINT32)teethTexIndex);
     }
 
     void DaedalusVMForGameWorld::external_AI_GotoWaypoint()
@@ -692,9 +1330,7 @@ namespace REGoth
 
       bs::StringUtil::toUpperCase(waypoint);
 
-      auto eventQueue = self->SO()->getComponent<CharacterEventQueue>();
-
-      eventQueue->pushGotoObject(mWorld->findObjectByName(waypoint));
+      pushGotoWaypointOrObject(mWorld, self->eventQueue(), waypoint);
     }
 
     void DaedalusVMForGameWorld::external_AI_GotoFreepoint()
@@ -704,9 +1340,22 @@ namespace REGoth
 
       bs::StringUtil::toUpperCase(freepoint);
 
-      auto eventQueue = self->SO()->getComponent<CharacterEventQueue>();
+      auto eventQueue = self->eventQueue();
+      HWaynet waynet  = mWorld->waynet();
 
-      eventQueue->pushGotoObject(mWorld->findObjectByName(freepoint));
+      const auto& at = self->SO()->getTransform().pos();
+      bs::Vector<HFreepoint> available =
+          waynet->findClosestAvailableFreepoints(freepoint, at, 1, self->SO());
+
+      if (available.empty())
+      {
+        // Not a freepoint or all taken, go to whatever has that name
+        pushGotoWaypointOrObject(mWorld, eventQueue, freepoint);
+        return;
+      }
+
+      waynet->reserveFreepoint(available.front(), self->SO());
+      eventQueue->pushGotoObject(available.front()->SO());
     }
 
     void DaedalusVMForGameWorld::external_AI_GotoNextFreepoint()
@@ -716,13 +1365,29 @@ namespace REGoth
 
       bs::StringUtil::toUpperCase(freepointName);
 
-      auto eventQueue = self->SO()->getComponent<CharacterEventQueue>();
+      auto eventQueue = self->eventQueue();
+      HWaynet waynet  = mWorld->waynet();
 
       const auto& at = self->SO()->getTransform().pos();
-      HFreepoint freepoint =
-          mWorld->waynet()->findClosestFreepointTo(freepointName, at).secondClosest;
+      bs::Vector<HFreepoint> available =
+          waynet->findClosestAvailableFreepoints(freepointName, at, 2, self->SO());
+
+      // "Next" means any but the one the character is at right now. Without a reservation,
+      // that is assumed to be the closest one, unless it is the only one.
+      HFreepoint current = waynet->reservedFreepointOf(self->SO());
 
-      eventQueue->pushGotoObject(freepoint->SO());
+      bool isAtClosest        = !available.empty() && available.front() == current;
+      bool isAssumedAtClosest = !current && available.size() > 1;
+
+      if (isAtClosest || isAssumedAtClosest)
+      {
+        available.erase(available.begin());
+      }
+
+      if (available.empty()) return;
+
+      waynet->reserveFreepoint(available.front(), self->SO());
+      eventQueue->pushGotoObject(available.front()->SO());
     }
 
     void DaedalusVMForGameWorld::external_AI_GotoNpc()
@@ -730,7 +1395,7 @@ namespace REGoth
       HCharacter other = popCharacterInstance();
       HCharacter self  = popCharacterInstance();
 
-      auto eventQueue = self->SO()->getComponent<CharacterEventQueue>();
+      auto eventQueue = self->eventQueue();
 
       eventQueue->pushGotoObject(other->SO());
     }
@@ -759,10 +1424,11 @@ namespace REGoth
 
       if (action != SYMBOL_INDEX_INVALID)
       {
-        task.scriptFunction = scriptSymbols().getSymbolName(action);
+        task.scriptFunction      = scriptSymbols().getSymbolName(action);
+        task.scriptFunctionIndex = action;
       }
 
-      auto eventQueue = self->SO()->getComponent<CharacterEventQueue>();
+      auto eventQueue = self->eventQueue();
 
       eventQueue->insertRoutineTask(task);
     }
@@ -772,7 +1438,7 @@ namespace REGoth
       bs::String routineName = popStringValue();
       HCharacter self        = popCharacterInstance();
 
-      auto eventQueue = self->SO()->getComponent<CharacterEventQueue>();
+      auto eventQueue = self->eventQueue();
 
       bs::StringUtil::toUpperCase(routineName);
 
@@ -817,7 +1483,7 @@ namespace REGoth
           REGOTH_THROW(InvalidParametersException, "Invalid Walk-Mode!");
       }
 
-      auto eventQueue = self->SO()->getComponent<CharacterEventQueue>();
+      auto eventQueue = self->eventQueue();
 
       eventQueue->pushSetWalkMode(realWalkMode);
     }
@@ -827,7 +1493,7 @@ namespace REGoth
       float seconds   = popFloatValue();
       HCharacter self = popCharacterInstance();
 
-      auto eventQueue = self->SO()->getComponent<CharacterEventQueue>();
+      auto eventQueue = self->eventQueue();
 
       eventQueue->pushWait(seconds);
     }
@@ -841,17 +1507,19 @@ namespace REGoth
 
       const auto& functionSym = scriptSymbols().getSymbol<SymbolScriptFunction>(stateFnIndex);
 
-      auto eventQueue = self->SO()->getComponent<CharacterEventQueue>();
+      auto eventQueue = self->eventQueue();
 
       if (endOldState != 0)
       {
         // End old state gracefully
-        eventQueue->pushStartScriptState(functionSym.name, waypoint, other(), victim());
+        eventQueue->pushStartScriptState(functionSym.name, waypoint, other(), victim(),
+                                         functionSym.index);
       }
       else
       {
         // Interrupt old state
-        eventQueue->pushInterruptAndStartScriptState(functionSym.name, waypoint, other(), victim());
+        eventQueue->pushInterruptAndStartScriptState(functionSym.name, waypoint, other(), victim(),
+                                                     functionSym.index);
       }
     }
 
@@ -860,10 +1528,73 @@ namespace REGoth
       bs::String animation = popStringValue();
       HCharacter self      = popCharacterInstance();
 
-      auto eventQueue = self->SO()->getComponent<CharacterEventQueue>();
+      auto eventQueue = self->eventQueue();
       eventQueue->pushPlayAnimation(animation);
     }
 
+    void DaedalusVMForGameWorld::external_AI_Output()
+    {
+      bs::String outputName = popStringValue();
+      HCharacter target     = popCharacterInstance();
+      HCharacter self       = popCharacterInstance();
+
+      self->eventQueue()->pushOutput(target ? target->SO() : bs::HSceneObject(), outputName);
+    }
+
+    void DaedalusVMForGameWorld::external_AI_OutputSVM()
+    {
+      bs::String svmName = popStringValue();
+      HCharacter target  = popCharacterInstance();
+      HCharacter self    = popCharacterInstance();
+
+      self->ai()->output(target ? target->SO() : bs::HSceneObject(), svmName);
+    }
+
+    void DaedalusVMForGameWorld::external_REGOTH_StartFiber()
+    {
+      SymbolIndex function = popIntValue();
+      HCharacter self      = popCharacterInstance();
+
+      // The calling code still expects its own `self`
+      ScriptObjectHandle callerSelf = selfInstance();
+
+      startFiberOnSelf(function, self);
+
+      setSelf(callerSelf);
+    }
+
+    void DaedalusVMForGameWorld::external_REGOTH_AI_WaitUntilDone()
+    {
+      HCharacter self = popCharacterInstance();
+
+      if (!canYieldFiber())
+      {
+        REGOTH_LOG(Warning, VM,
+                   "[DaedalusVMForGameWorld] REGOTH_AI_WAITUNTILDONE called outside of a fiber, "
+                   "see REGOTH_STARTFIBER");
+        return;
+      }
+
+      // Messages are done in order, so this one is done once all the ones before it are
+      auto marker = self->eventQueue()->pushWait(0.0f);
+
+      // Executed right away if the queue was empty, nothing to wait for
+      if (marker->deleted) return;
+
+      DaedalusFiberHandle fiber = yieldFiber();
+
+      marker->onMessageDone.connect([this, fiber, self](EventQueue::SharedEMessage) {
+        if (self.isDestroyed())
+        {
+          cancelFiber(fiber);
+          return;
+        }
+
+        self->useAsSelf();
+        resumeFiber(fiber);
+      });
+    }
+
     void DaedalusVMForGameWorld::external_Npc_GetNearestWP()
     {
       HCharacter self = popCharacterInstance();
@@ -880,72 +1611,89 @@ namespace REGoth
 
     void DaedalusVMForGameWorld::external_Npc_GetDistToWP()
     {
-      bs::String waypoint = popStringValue();
-      HCharacter self     = popCharacterInstance();
+      bs::String waypoint           = popStringValue();
+      ScriptObjectHandle selfObject = popInstanceScriptObject();
 
-      float distanceMeters = self->getDistanceToWaypoint(waypoint);
+      WaypointIndex wp = mWorld->waynet()->findWaypoint(waypoint);
 
-      if (distanceMeters < 0)
+      if (wp == NO_WAYPOINT)
       {
+        REGOTH_LOG(Warning, AI, "[DaedalusVMForGameWorld] Waypoint {0} does not exist! "
+                                "(Npc_GetDistToWP)", waypoint);
         mStack.pushInt(INT32_MAX);
+        return;
       }
-      else
-      {
-        mStack.pushInt(distanceMeters * 100);
-      }
+
+      const bs::Vector3& wpPosition = mWorld->waynet()->waypointPosition(wp);
+
+      mStack.pushInt(positionOfMappedObject(selfObject).distance(wpPosition) * 100);
     }
 
+    // The distance externals are called all the time by perception and state loops, so they
+    // work on the positions kept by the mapping instead of going through the characters.
+
     void DaedalusVMForGameWorld::external_Npc_GetDistToNpc()
     {
-      HCharacter other = popCharacterInstance();
-      HCharacter self  = popCharacterInstance();
+      ScriptObjectHandle otherObject = popInstanceScriptObject();
+      ScriptObjectHandle selfObject  = popInstanceScriptObject();
 
       // This is sometimes used with Npc_DetectNpc() which is supposed to set
       // `other`. If that doesn't work we'll end up with an invalid handle here.
-      if (!other)
+      if (otherObject == SCRIPT_OBJECT_HANDLE_INVALID)
       {
         mStack.pushInt(INT32_MAX);
       }
       else
       {
-        mStack.pushInt(self->getDistanceToObject(other->SO()) * 100);
+        float distance =
+            positionOfMappedObject(selfObject).distance(positionOfMappedObject(otherObject));
+
+        mStack.pushInt(distance * 100);
       }
     }
 
     void DaedalusVMForGameWorld::external_Npc_GetDistToItem()
     {
-      HItem item      = popItemInstance();
-      HCharacter self = popCharacterInstance();
+      ScriptObjectHandle itemObject = popInstanceScriptObject();
+      ScriptObjectHandle selfObject = popInstanceScriptObject();
 
-      mStack.pushInt(self->getDistanceToObject(item->SO()) * 100);
+      float distance =
+          positionOfMappedObject(selfObject).distance(positionOfMappedObject(itemObject));
+
+      mStack.pushInt(distance * 100);
     }
 
     void DaedalusVMForGameWorld::external_Npc_GetDistToPlayer()
     {
-      HCharacter self = popCharacterInstance();
+      ScriptObjectHandle selfObject = popInstanceScriptObject();
 
       // I hope they don't mean the player controlled character but the hero.
       // FIXME: Clarify, does this is supposed to check the distance to the hero?
       //        Might as well fix this if we can easily get the reference to the player
       //        controlled character here. For normal gameplay using the hero should work though.
-      mStack.pushInt(self->getDistanceToHero() * 100);
+      float distance =
+          positionOfMappedObject(selfObject).distance(positionOfMappedObject(heroInstance()));
+
+      mStack.pushInt(distance * 100);
     }
 
     void DaedalusVMForGameWorld::external_Npc_IsNear()
     {
-      HCharacter other = popCharacterInstance();
-      HCharacter self  = popCharacterInstance();
+      ScriptObjectHandle otherObject = popInstanceScriptObject();
+      ScriptObjectHandle selfObject  = popInstanceScriptObject();
 
-      bool isNear = self->isNearCharacter(other);
+      float distance =
+          positionOfMappedObject(selfObject).distance(positionOfMappedObject(otherObject));
 
-      mStack.pushInt(isNear ? 1 : 0);
+      // 3 meters is expected by the scripts, same as Character::isNearCharacter()
+      mStack.pushInt(distance < 3.0f ? 1 : 0);
     }
 
     void DaedalusVMForGameWorld::external_Npc_SetToFistMode()
     {
       HCharacter self = popCharacterInstance();
 
-      auto eventQueue = self->SO()->getComponent<CharacterEventQueue>();
+      auto eventQueue = self->eventQueue();
 
       eventQueue->pushGoToFistModeImmediate();
     }
@@ -955,10 +1703,28 @@ namespace REGoth
       bs::INT32 infoSymbolIndex = popIntValue();
       HCharacter self           = popCharacterInstance();
 
-      const bs::String& infoName = scriptSymbols().getSymbolName(infoSymbolIndex);
-      auto information           = self->SO()->getComponent<StoryInformation>();
+      auto information = self->storyInformation();
+
+      if (mRecordedInfoCondition)
+      {
+        mRecordedInfoCondition->knownInfos.emplace_back(information,
+                                                        information->knownInfosVersion());
+      }
+
+      DialogueInfoIndex index = dialogueInfoIndex((SymbolIndex)infoSymbolIndex);
 
-      if (information->knowsInfo(infoName))
+      bool knowsInfo;
+
+      if (index != DIALOGUE_INFO_INDEX_INVALID)
+      {
+        knowsInfo = information->knowsInfo(index);
+      }
+      else
+      {
+        knowsInfo = information->knowsInfo(scriptSymbols().getSymbolName(infoSymbolIndex));
+      }
+
+      if (knowsInfo)
       {
         mStack.pushInt(1);
       }
@@ -972,7 +1738,7 @@ namespace REGoth
     {
       HCharacter self = popCharacterInstance();
 
-      REGOTH_LOG(Warning, Uncategorized, "[External] Using external stub: NPC_RefuseTalk");
+      REGOTH_LOG(Warning, VM, "[External] Using external stub: NPC_RefuseTalk");
 
       mStack.pushInt(0);
     }
@@ -981,7 +1747,7 @@ namespace REGoth
     {
       HCharacter self = popCharacterInstance();
 
-      auto eventQueue = self->SO()->getComponent<CharacterEventQueue>();
+      auto eventQueue = self->eventQueue();
 
       // Scripts expect this value to be rounded down
       mStack.pushInt((bs::INT32)eventQueue->getCurrentStateRunningTime());
@@ -989,39 +1755,55 @@ namespace REGoth
 
     void DaedalusVMForGameWorld::external_Npc_Percenable()
     {
+      bs::INT32 functionIndex = popIntValue();
+      bs::INT32 perceptionId  = popIntValue();
+      HCharacter self         = popCharacterInstance();
+
+      mWorld->perceptionSystem().enablePerception(self, perceptionId,
+                                                  (SymbolIndex)functionIndex);
+    }
+
+    void DaedalusVMForGameWorld::external_Npc_PercDisable()
+    {
+      bs::INT32 perceptionId = popIntValue();
+      HCharacter self        = popCharacterInstance();
+
+      mWorld->perceptionSystem().disablePerception(self, perceptionId);
+    }
+
+    void DaedalusVMForGameWorld::external_Npc_SetPercTime()
+    {
+      float seconds   = popFloatValue();
       HCharacter self = popCharacterInstance();
+
+      mWorld->perceptionSystem().setPerceptionTime(self, seconds);
     }
 
     void DaedalusVMForGameWorld::external_Npc_GetBodyState()
     {
       HCharacter self = popCharacterInstance();
 
-      // TODO: Implement this. There is no "stub"-debug log here because the function
-      //       is called so often and it would spam the terminal.
+      // TODO: Implement this. Called so often the stub log would spam the terminal, so only
+      //       very verbose builds have it.
+      REGOTH_LOG(VeryVerbose, VM, "[External] Using external stub: Npc_GetBodyState");
 
       mStack.pushInt(0);
     }
 
     void DaedalusVMForGameWorld::external_InfoManager_HasFinished()
     {
-      // REGOTH_LOG(Warning, Uncategorized, "[External] Using external stub:
-      // InfoManager_HasFinished");
-
-      if (gGameplayUI()->isDialogueInProgress())
-      {
-        mStack.pushInt(0);
-      }
-      else
-      {
-        mStack.pushInt(1);
-      }
+      mStack.pushInt(mIsDialogueInProgress ? 0 : 1);
     }
 
     void DaedalusVMForGameWorld::external_AI_ProcessInfos()
     {
       HCharacter self = popCharacterInstance();
 
-      auto storyInfo = self->SO()->getComponent<StoryInformation>();
+      mIsDialogueInProgress = true;
+
+      if (!mIsDialogueUIEnabled) return;
+
+      auto storyInfo = self->storyInformation();
 
       storyInfo->startDialogueWith(other());
     }
@@ -1030,7 +1812,11 @@ namespace REGoth
     {
       HCharacter self = popCharacterInstance();
 
-      auto storyInfo = self->SO()->getComponent<StoryInformation>();
+      mIsDialogueInProgress = false;
+
+      if (!mIsDialogueUIEnabled) return;
+
+      auto storyInfo = self->storyInformation();
 
       storyInfo->stopDialogueWith(other());
     }
@@ -1049,11 +1835,16 @@ namespace REGoth
       bs::INT32 instance   = popIntValue();
       HCharacter character = popCharacterInstance();
 
-      const bs::String& instanceName = scriptSymbols().getSymbolName(instance);
+      auto inventory = character->inventory();
 
-      auto inventory = character->SO()->getComponent<Inventory>();
+      if (mIsCollectingInsertions)
+      {
+        mQueuedInventoryItems.push_back({inventory, (SymbolIndex)instance, (bs::UINT32)num});
+        mHasBatchedExternals = true;
+        return;
+      }
 
-      inventory->giveItem(instanceName, num);
+      inventory->giveItem((SymbolIndex)instance, num);
     }
 
     void DaedalusVMForGameWorld::external_NPC_CreateInventoryItem()
@@ -1061,11 +1852,16 @@ namespace REGoth
       bs::INT32 instance   = popIntValue();
       HCharacter character = popCharacterInstance();
 
-      const bs::String& instanceName = scriptSymbols().getSymbolName(instance);
+      auto inventory = character->inventory();
 
-      auto inventory = character->SO()->getComponent<Inventory>();
+      if (mIsCollectingInsertions)
+      {
+        mQueuedInventoryItems.push_back({inventory, (SymbolIndex)instance, 1});
+        mHasBatchedExternals = true;
+        return;
+      }
 
-      inventory->giveItem(instanceName);
+      inventory->giveItem((SymbolIndex)instance);
     }
 
     void DaedalusVMForGameWorld::external_Npc_HasItems()
@@ -1073,11 +1869,14 @@ namespace REGoth
       bs::INT32 instance   = popIntValue();
       HCharacter character = popCharacterInstance();
 
-      const bs::String& instanceName = scriptSymbols().getSymbolName(instance);
+      auto inventory = character->inventory();
 
-      auto inventory = character->SO()->getComponent<Inventory>();
+      if (mRecordedInfoCondition)
+      {
+        mRecordedInfoCondition->inventories.emplace_back(inventory, inventory->itemsVersion());
+      }
 
-      if (inventory->hasItem(instanceName))
+      if (inventory->hasItem((SymbolIndex)instance))
       {
         mStack.pushInt(1);
       }
@@ -1093,7 +1892,7 @@ namespace REGoth
       bs::INT32 category   = popIntValue();
       HCharacter character = popCharacterInstance();
 
-      REGOTH_LOG(Warning, Uncategorized, "[External] Using external stub: Npc_GetInvItemBySlot");
+      REGOTH_LOG(Warning, VM, "[External] Using external stub: Npc_GetInvItemBySlot");
     }
 
     void DaedalusVMForGameWorld::external_Npc_RemoveInvItem()
@@ -1101,12 +1900,11 @@ namespace REGoth
       bs::INT32 instance   = popIntValue();
       HCharacter character = popCharacterInstance();
 
-      const bs::String& instanceName = scriptSymbols().getSymbolName(instance);
-      auto inventory                 = character->SO()->getComponent<Inventory>();
+      auto inventory = character->inventory();
 
-      if (inventory->hasItem(instanceName))
+      if (inventory->hasItem((SymbolIndex)instance))
       {
-        inventory->removeItem(instanceName);
+        inventory->removeItem((SymbolIndex)instance);
       }
     }
 
@@ -1116,75 +1914,132 @@ namespace REGoth
       bs::INT32 instance   = popIntValue();
       HCharacter character = popCharacterInstance();
 
-      const bs::String& instanceName = scriptSymbols().getSymbolName(instance);
-
-      auto inventory = character->SO()->getComponent<Inventory>();
+      auto inventory = character->inventory();
 
-      if (inventory->hasItem(instanceName))
+      if (inventory->hasItem((SymbolIndex)instance))
       {
-        bs::INT32 actualCount = inventory->itemCount(instanceName);
+        bs::INT32 actualCount = inventory->itemCount((SymbolIndex)instance);
 
-        inventory->removeItem(instanceName, bs::Math::min(actualCount, count));
+        inventory->removeItem((SymbolIndex)instance, bs::Math::min(actualCount, count));
       }
     }
 
     void DaedalusVMForGameWorld::script_PrintPlus(const bs::String& text)
     {
+      static const SymbolRef PRINT_PLUS("PRINTPLUS");
+
       mStack.pushString(text);
-      executeScriptFunction("PrintPlus");
+      executeScriptFunction(PRINT_PLUS);
     }
 
     void DaedalusVMForGameWorld::createAllInformationInstances()
     {
-      bs::Vector<SymbolIndex> instanceSymbols =
-          Queries::findAllInstancesOfClass(scriptSymbols(), "C_INFO");
+      SymbolIndexSpan instanceSymbols = Queries::findAllInstancesOfClass(scriptSymbols(), "C_INFO");
 
-      bs::Vector<ScriptObjectHandle> instances;
       for (SymbolIndex s : instanceSymbols)
       {
-        instances.push_back(instanciateClass("C_INFO", s, {}));
+        instanciateClass("C_INFO", s, {});
       }
 
-      bs::Vector<bs::UINT32> symbolIndices;
-      symbolIndices.reserve(instances.size());
+      mapInformationInstancesToNpcs();
+    }
+
+    void DaedalusVMForGameWorld::mapInformationInstancesToNpcs()
+    {
+      // Sorted by NPC first, so the infos of each NPC end up next to each other
+      bs::Map<SymbolIndex, bs::Vector<ScriptObjectHandle>> informationInstancesByNpcs;
 
-      for (ScriptObjectHandle h : instances)
+      // Every instance symbol refers to the object created last by its constructor, which
+      // is the only one there is for information instances.
+      for (SymbolIndex s : Queries::findAllInstancesOfClass(scriptSymbols(), "C_INFO"))
       {
-        symbolIndices.push_back(scriptObjects().get(h).intValue("NPC"));
+        ScriptObjectHandle infoHandle = scriptSymbols().getSymbol<SymbolInstance>(s).instance;
+
+        if (!scriptObjects().isValid(infoHandle)) continue;
+
+        SymbolIndex npcSymbol = scriptObjects().get(infoHandle).intValue("NPC");
+
+        informationInstancesByNpcs[npcSymbol].push_back(infoHandle);
       }
 
-      for (bs::UINT32 i = 0; i < (bs::UINT32)instances.size(); i++)
+      mDialogueInfos.clear();
+      mDialogueInfoRanges.clear();
+      mDialogueInfoIndexBySymbol.assign(scriptSymbols().numSymbols(), DIALOGUE_INFO_INDEX_INVALID);
+
+      for (const auto& npc : informationInstancesByNpcs)
       {
-        SymbolIndex npcSymbol         = symbolIndices[i];
-        ScriptObjectHandle infoHandle = instances[i];
+        DialogueInfoRange range;
+        range.first = (bs::UINT32)mDialogueInfos.size();
+        range.count = (bs::UINT32)npc.second.size();
+
+        for (ScriptObjectHandle h : npc.second)
+        {
+          const ScriptObject& data = scriptObjects().get(h);
+
+          DialogueInfo info;
+          info.name        = data.instanceName;
+          info.index       = (DialogueInfoIndex)mDialogueInfos.size();
+          info.priority    = data.intValue("NR");
+          info.isPermanent = data.intValue("PERMANENT") != 0;
+          info.isImportant = data.intValue("IMPORTANT") != 0;
+          info.isTrade     = data.intValue("TRADE") != 0;
+          info.choiceText  = data.stringValue("DESCRIPTION");
+
+          info.conditionFunction =
+              scriptSymbols().findFunctionByAddress(data.functionPointerValue("CONDITION"));
+          info.informationFunction =
+              scriptSymbols().findFunctionByAddress(data.functionPointerValue("INFORMATION"));
+
+          SymbolIndex symbol = scriptSymbols().findIndexBySymbolName(info.name);
+          mDialogueInfoIndexBySymbol[symbol] = info.index;
+
+          mDialogueInfos.push_back(std::move(info));
+        }
+
+        mDialogueInfoRanges[npc.first] = range;
+      }
+
+      mDialogueInfosVersion += 1;
+
+      REGOTH_LOG(Info, VM, "[DaedalusVMForGameWorld] {0} infos for {1} NPCs",
+                 mDialogueInfos.size(), mDialogueInfoRanges.size());
+    }
 
-        mInformationInstancesByNpcs[npcSymbol].push_back(infoHandle);
+    DialogueInfoIndex DaedalusVMForGameWorld::dialogueInfoIndex(
+        const bs::String& instanceName) const
+    {
+      if (!scriptSymbolsConst().hasSymbolWithName(instanceName))
+      {
+        return DIALOGUE_INFO_INDEX_INVALID;
       }
+
+      return dialogueInfoIndex(scriptSymbolsConst().findIndexBySymbolName(instanceName));
     }
 
-    const bs::Vector<ScriptObjectHandle>& DaedalusVMForGameWorld::allInfosOfNpc(
+    DialogueInfoSpan DaedalusVMForGameWorld::dialogueInfosOfNpc(
         const bs::String& instanceName) const
     {
       SymbolIndex npcInstance = scriptSymbolsConst().findIndexBySymbolName(instanceName);
 
-      if (mInformationInstancesByNpcs.empty())
+      if (mDialogueInfosVersion == 0)
       {
         REGOTH_THROW(InvalidStateException,
                      "createAllInformationInstances has not been called or failed!");
       }
 
-      auto it = mInformationInstancesByNpcs.find(npcInstance);
+      auto it = mDialogueInfoRanges.find(npcInstance);
 
       // Some NPCs don't have anything to say, so they don't appear in this list.
-      if (it == mInformationInstancesByNpcs.end())
+      if (it == mDialogueInfoRanges.end())
       {
-        // It's okay to return this static empty vector here because the return value is const.
-        static bs::Vector<ScriptObjectHandle> s_empty = {};
-
-        return s_empty;
+        return DialogueInfoSpan{};
       }
 
-      return it->second;
+      DialogueInfoSpan span;
+      span.first = mDialogueInfos.data() + it->second.first;
+      span.count = it->second.count;
+
+      return span;
     }
 
     REGOTH_DEFINE_RTTI(DaedalusVMForGameWorld)
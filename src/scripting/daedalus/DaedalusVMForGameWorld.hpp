@@ -3,6 +3,10 @@
 #pragma once
 #include "REGothDaedalusVM.hpp"
 #include <BsPrerequisites.h>
+#include <scripting/DialogueInfo.hpp>
+#include <scripting/ItemDefinition.hpp>
+#include <scripting/SvmTable.hpp>
+#include <tuple>
 
 namespace REGoth
 {
@@ -15,15 +19,76 @@ namespace REGoth
   class Item;
   using HItem = bs::GameObjectHandle<Item>;
 
+  class Inventory;
+  using HInventory = bs::GameObjectHandle<Inventory>;
+
+  class StoryInformation;
+  using HStoryInformation = bs::GameObjectHandle<StoryInformation>;
+
   namespace Scripting
   {
+    /**
+     * The script functions making up an AI state, like `ZS_TALK` with `ZS_TALK_LOOP`,
+     * `ZS_TALK_END` and `ZS_TALK_INTERRUPT`. All but the main function are optional.
+     */
+    struct AIStateFunctions
+    {
+      SymbolIndex main      = SYMBOL_INDEX_INVALID;
+      SymbolIndex loop      = SYMBOL_INDEX_INVALID;
+      SymbolIndex end       = SYMBOL_INDEX_INVALID;
+      SymbolIndex interrupt = SYMBOL_INDEX_INVALID;
+    };
+
     /**
      * DaedalusVM implementing the externals needed for GOTHIC.DAT.
+     *
+     * A VM only refers to its own world and the objects inside it. So as long as the dialogue UI
+     * is disabled (see setDialogueUIEnabled()), VMs of different worlds can run on different
+     * threads at the same time. A single VM must not be used by more than one thread at once.
      */
     class DaedalusVMForGameWorld : public DaedalusVM
     {
+      struct DialogueInfoRange
+      {
+        bs::UINT32 first = 0;
+        bs::UINT32 count = 0;
+      };
+
+      /**
+       * Result of a condition function run by runInfoConditionFunction(), together with
+       * everything it depended on.
+       */
+      struct CachedInfoCondition
+      {
+        bool result = false;
+
+        DaedalusRecordedReads reads;
+
+        /**
+         * Characters whose known infos or inventory have been looked at, with the version
+         * they had back then.
+         */
+        bs::Vector<std::pair<HStoryInformation, bs::UINT32>> knownInfos;
+        bs::Vector<std::pair<HInventory, bs::UINT32>> inventories;
+      };
+
+      /**
+       * Items created while mIsCollectingInsertions is set, see giveQueuedInventoryItems().
+       */
+      struct QueuedInventoryItems
+      {
+        HInventory inventory;
+        SymbolIndex instance;
+        bs::UINT32 count;
+      };
+
+      /**
+       * Condition function, `self` and `other`.
+       */
+      using InfoConditionKey = std::tuple<SymbolIndex, ScriptObjectHandle, ScriptObjectHandle>;
+
     public:
-      DaedalusVMForGameWorld(HGameWorld gameWorld, const bs::Vector<bs::UINT8>& datFileData);
+      DaedalusVMForGameWorld(HGameWorld gameWorld, bs::SPtr<const DaedalusProgram> program);
 
       /**
        * Initializes the ScriptVM. To be called after the object is constructed.
@@ -47,8 +112,25 @@ namespace REGoth
        * @param  self      Character to set `self` to.
        */
       void runFunctionOnSelf(const bs::String& function, HCharacter self);
+      void runFunctionOnSelf(const SymbolRef& function, HCharacter self);
       void runFunctionOnSelf(SymbolIndex function, HCharacter self);
 
+      /**
+       * Like runFunctionOnSelf(), but runs the function as fiber, see DaedalusVM::startFiber().
+       *
+       * Only REGoth-specific externals suspend fibers, so this is meant for native scripts
+       * and mods which declare them:
+       *
+       *  - `REGOTH_STARTFIBER(var C_NPC self, var func function)` calls this.
+       *  - `REGOTH_AI_WAITUNTILDONE(var C_NPC self)` suspends the fiber until everything
+       *    queued for `self` by `AI_`-externals so far is done. `self` is set again on
+       *    resuming.
+       *
+       * @return Handle of the fiber, if it has been suspended. DAEDALUS_FIBER_INVALID, if the
+       *         function has already returned.
+       */
+      DaedalusFiberHandle startFiberOnSelf(SymbolIndex function, HCharacter self);
+
       /**
        * Calls a function used during the LOOP-Part of the script states. e.g. `ZS_TALK_LOOP`.
        * See AI::ScriptState for more information.
@@ -61,10 +143,53 @@ namespace REGoth
        */
       bool runStateLoopFunction(SymbolIndex function, HCharacter self);
 
+      /**
+       * A single call of a LOOP-function, see runStateLoopFunctions().
+       */
+      struct StateLoopCall
+      {
+        SymbolIndex function = SYMBOL_INDEX_INVALID;
+        HCharacter self;
+
+        /** Set by runStateLoopFunctions(): Whether the State is done. */
+        bool isDone = false;
+      };
+
+      /**
+       * Timing of a single call of runStateLoopFunctions().
+       */
+      struct StateLoopBatchStats
+      {
+        bs::UINT32 numCalls     = 0;
+        bs::UINT32 numFunctions = 0;
+        bs::UINT64 nanoseconds  = 0;
+      };
+
+      /**
+       * Does runStateLoopFunction() for many characters at once, e.g. for all characters
+       * which are in a LOOP-Phase during one frame.
+       *
+       * Characters running the same state are run one after another, so the bytecode
+       * of that state stays in the cache and its symbol only has to be looked up once.
+       * Apart from the order, this does the same as calling runStateLoopFunction() for
+       * every entry.
+       *
+       * @param  calls  Functions to call on which character. Their `isDone`-flags are set
+       *                to what runStateLoopFunction() would have returned.
+       *
+       * @return How many calls and different functions there were and how long it took.
+       */
+      StateLoopBatchStats runStateLoopFunctions(bs::Vector<StateLoopCall>& calls);
+
       /**
        * Wrapper to call the function set in `C_INFO.condition` to check whether a dialogue line
        * should be displayed to the user in the UI.
        *
+       * Results are cached together with everything the condition has read, like global
+       * variables, members of `self` and `other`, known infos and inventories. As long as none
+       * of that changed, the condition isn't run again. Conditions which call externals with
+       * other inputs or side effects are run every time, see DaedalusRecordedReads.
+       *
        * @note  This function will clean the stack! Some script functions don't push a return value
        *        and so we would get whatever was on the stack before. Since this is only called from
        *        engine code, it's okay to throw away the whole script stack here.
@@ -80,6 +205,18 @@ namespace REGoth
 
       void initializeWorld(const bs::String& worldName) override;
 
+      /**
+       * Whether `AI_ProcessInfos` and `AI_StopProcessInfos` should open and close the dialogue
+       * window of the GameplayUI. Enabled by default.
+       *
+       * If disabled, the VM only keeps track of whether a dialogue is in progress. This is meant
+       * for headless worlds, which don't have a UI and may run on a thread of their own.
+       */
+      void setDialogueUIEnabled(bool enabled)
+      {
+        mIsDialogueUIEnabled = enabled;
+      }
+
       void setHero(ScriptObjectHandle hero);
       ScriptObjectHandle heroInstance();
 
@@ -112,10 +249,89 @@ namespace REGoth
       void setSelf(ScriptObjectHandle self);
 
       /**
-       * @return All *Information*-Instances meant for the given NPC. See
-       * createAllInformationInstances() for more information.
+       * @return All *Information*-Instances meant for the given NPC, converted to
+       *         DialogueInfos once for all NPCs. See createAllInformationInstances() for more
+       *         information.
+       */
+      DialogueInfoSpan dialogueInfosOfNpc(const bs::String& instanceName) const;
+
+      /**
+       * @return Changes whenever the dialogue infos are built again, which invalidates all
+       *         spans returned by dialogueInfosOfNpc() before.
+       */
+      bs::UINT32 dialogueInfosVersion() const
+      {
+        return mDialogueInfosVersion;
+      }
+
+      /**
+       * @return Dense index of the given *Information*-Instance, see DialogueInfoIndex.
+       *         DIALOGUE_INFO_INDEX_INVALID if that symbol is not an *Information*-Instance.
+       */
+      DialogueInfoIndex dialogueInfoIndex(SymbolIndex info) const
+      {
+        if (info >= mDialogueInfoIndexBySymbol.size()) return DIALOGUE_INFO_INDEX_INVALID;
+
+        return mDialogueInfoIndexBySymbol[info];
+      }
+
+      /**
+       * @copydoc dialogueInfoIndex
+       *
+       * @param  instanceName  UPPERCASE Name of the *Information*-Instance.
+       */
+      DialogueInfoIndex dialogueInfoIndex(const bs::String& instanceName) const;
+
+      /**
+       * @param  stateFunction  Main function of the state, like `ZS_TALK`. Any other script
+       *                        function works as well, it just has no further functions then.
+       *
+       * @return The functions of the state with the given main function. Found once after the
+       *         symbols have been loaded, so starting a state needs no name lookups.
+       */
+      AIStateFunctions aiStateFunctions(SymbolIndex stateFunction) const;
+
+      /**
+       * Looks up the properties items of the given `C_ITEM` instance have, without creating a
+       * script object for it. The constructor of the instance is only run the first time.
+       *
+       * Throws if the symbol is not an instance.
+       *
+       * @param  itemInstance  Instance symbol of the item, like `ITFO_APPLE`.
+       */
+      const ItemDefinition& itemDefinition(SymbolIndex itemInstance);
+
+      /**
+       * @return What every voice says for each SVM. Read once after the scripts have been
+       *         loaded, so outputting an SVM doesn't need any script objects.
+       */
+      const SvmTable& svmTable() const
+      {
+        return mSvmTable;
+      }
+
+      /**
+       * @return What the given information function and the script functions it calls say, so
+       *         the sound files can be prefetched before the lines are spoken. Looked up from
+       *         the bytecode, see analyzeDialogueOutputs().
        */
-      const bs::Vector<ScriptObjectHandle>& allInfosOfNpc(const bs::String& instanceName) const;
+      const DialogueOutputs& dialogueOutputsOf(SymbolIndex function);
+
+      /**
+       * @return Number of dialogue infos of all NPCs. Dense indices are below that.
+       */
+      bs::UINT32 numDialogueInfos() const
+      {
+        return (bs::UINT32)mDialogueInfos.size();
+      }
+
+      /**
+       * @return The dialogue info with the given dense index, see dialogueInfoIndex().
+       */
+      const DialogueInfo& dialogueInfo(DialogueInfoIndex index) const
+      {
+        return mDialogueInfos.at(index);
+      }
 
     protected:
       /**
@@ -127,6 +343,50 @@ namespace REGoth
        */
       void createAllInformationInstances();
 
+      /**
+       * Runs a LOOP-function on the given character, see runStateLoopFunction().
+       */
+      bool runStateLoop(const SymbolScriptFunction& function, HCharacter self);
+
+      /**
+       * Fills mDialogueInfos from the information instances created by
+       * createAllInformationInstances().
+       */
+      void mapInformationInstancesToNpcs();
+
+      /**
+       * Looks up what the information functions of all dialogue infos say, so presenting the
+       * choices doesn't have to walk any bytecode. See dialogueOutputsOf().
+       */
+      void analyzeDialogueOutputs();
+
+      /**
+       * Walks the bytecode of the function starting at the given address, following its jumps
+       * and the functions it calls. The name of a line is the string constant pushed right
+       * before calling `AI_Output` or `AI_OutputSVM`.
+       */
+      const DialogueOutputs& dialogueOutputsAt(bs::UINT32 address);
+
+      /**
+       * Fills mSvmTable from the `C_SVM`-instances of all voices, which are called `SVM_<voice>`.
+       */
+      void createSvmTable();
+
+      /**
+       * @return Whether nothing the given cached condition depended on has changed since.
+       */
+      bool isCachedInfoConditionValid(const CachedInfoCondition& cached);
+
+      /**
+       * Looks up the symbols of mHeroSymbol and friends.
+       */
+      void findSpecialSymbols();
+
+      /**
+       * Fills mAIStateFunctions from the names of all script functions.
+       */
+      void findAIStateFunctions();
+
       /**
        * Does popInstance() and resolves the Character-component.
        *
@@ -147,6 +407,15 @@ namespace REGoth
        */
       HItem popItemInstance();
 
+      /**
+       * @return Where the scene object mapped to the given script object is. Taken from
+       *         ScriptObjectMapping::findMappedPosition() if known, so the scene graph is only
+       *         touched if the position has not been set since loading.
+       *
+       * Throws if the script object is not mapped to a scene object.
+       */
+      bs::Vector3 positionOfMappedObject(ScriptObjectHandle scriptObject) const;
+
       /**
        * Sets the given instance to the given script object.
        *
@@ -156,6 +425,7 @@ namespace REGoth
        * @oaram  scriptObject  Script object to assign.
        */
       void setInstance(const bs::String& instance, ScriptObjectHandle scriptObject);
+      void setInstance(const SymbolRef& instance, ScriptObjectHandle scriptObject);
       void setInstance(SymbolIndex instance, ScriptObjectHandle scriptObject);
 
       /**
@@ -168,6 +438,7 @@ namespace REGoth
        * @return Handle the instance was set to. Might be invalid!
        */
       ScriptObjectHandle getInstance(const bs::String& instance) const;
+      ScriptObjectHandle getInstance(const SymbolRef& instance) const;
       ScriptObjectHandle getInstance(SymbolIndex symbolIndex) const;
 
       /**
@@ -214,6 +485,8 @@ namespace REGoth
       void external_AI_Wait();
       void external_AI_StartState();
       void external_AI_PlayAnimation();
+      void external_AI_Output();
+      void external_AI_OutputSVM();
       void external_Npc_GetNearestWP();
       void external_Npc_GetNextWP();
       void external_Npc_GetDistToWP();
@@ -226,6 +499,8 @@ namespace REGoth
       void external_Npc_RefuseTalk();
       void external_Npc_GetStateTime();
       void external_Npc_Percenable();
+      void external_Npc_PercDisable();
+      void external_Npc_SetPercTime();
       void external_Npc_GetBodyState();
       void external_InfoManager_HasFinished();
       void external_AI_ProcessInfos();
@@ -237,9 +512,21 @@ namespace REGoth
       void external_Npc_GetInvItemBySlot();
       void external_Npc_RemoveInvItem();
       void external_Npc_RemoveInvItems();
+      void external_REGOTH_StartFiber();
+      void external_REGOTH_AI_WaitUntilDone();
 
       void fillSymbolStorage() override;
+      void onRestoredFromSnapshot() override;
+      void onBeforeDATReload() override;
+      void onDATReloaded() override;
       void registerAllExternals() override;
+      void flushBatchedExternals() override;
+
+      /**
+       * Gives the items inside mQueuedInventoryItems to their inventories, so every inventory
+       * triggers its change event only once.
+       */
+      void giveQueuedInventoryItems();
 
     protected:
       /** Handle to the game world this is used in */
@@ -252,8 +539,89 @@ namespace REGoth
       SymbolIndex mVictimSymbol = SYMBOL_INDEX_INVALID;
       SymbolIndex mItemSymbol   = SYMBOL_INDEX_INVALID;
 
-      /** Cache of all information instances for all NPCs */
-      bs::Map<SymbolIndex, bs::Vector<ScriptObjectHandle>> mInformationInstancesByNpcs;
+      /**
+       * Dialogue infos of all information instances. The ones of the same NPC are next to
+       * each other, in the order of their symbols.
+       */
+      bs::Vector<DialogueInfo> mDialogueInfos;
+
+      /**
+       * Where the dialogue infos of each NPC are inside mDialogueInfos, by the NPC's
+       * instance symbol.
+       */
+      bs::UnorderedMap<SymbolIndex, DialogueInfoRange> mDialogueInfoRanges;
+
+      /**
+       * See aiStateFunctions(). Only states which have at least one of the optional
+       * functions are in here, by the symbol of their main function.
+       */
+      bs::UnorderedMap<SymbolIndex, AIStateFunctions> mAIStateFunctions;
+
+      /** Index into mDialogueInfos, by symbol. See dialogueInfoIndex(). */
+      bs::Vector<DialogueInfoIndex> mDialogueInfoIndexBySymbol;
+
+      /** See dialogueInfosVersion() */
+      bs::UINT32 mDialogueInfosVersion = 0;
+
+      /** See runInfoConditionFunction(). Not serialized. */
+      bs::Map<InfoConditionKey, CachedInfoCondition> mInfoConditionCache;
+
+      /** Condition currently run by runInfoConditionFunction(), if its reads are recorded */
+      CachedInfoCondition* mRecordedInfoCondition = nullptr;
+
+      /** See setDialogueUIEnabled() */
+      bool mIsDialogueUIEnabled = true;
+
+      /** Whether `AI_ProcessInfos` has been called without `AI_StopProcessInfos` yet */
+      bool mIsDialogueInProgress = false;
+
+      /**
+       * Set while the world init scripts run. `Wld_InsertNpc` and `Wld_InsertItem` then only
+       * queue their insertions, which are done together by GameWorld::insertQueued() once
+       * another external is called or the scripts are done. Same goes for the items created
+       * via `CreateInvItems`, see mQueuedInventoryItems.
+       */
+      bool mIsCollectingInsertions = false;
+
+      /** See giveQueuedInventoryItems() */
+      bs::Vector<QueuedInventoryItems> mQueuedInventoryItems;
+
+      /**
+       * An instance as it is after running its constructor, see instanciateClass().
+       */
+      struct InstanceTemplate
+      {
+        /** Whether running the constructor again would lead to the same object */
+        bool isCacheable = false;
+
+        /** Only set if cacheable */
+        ScriptObject object;
+      };
+
+      /** Instance symbol -> Its template. Not serialized. */
+      bs::UnorderedMap<SymbolIndex, InstanceTemplate> mInstanceTemplates;
+
+      /** See itemDefinition(). Not serialized. */
+      bs::UnorderedMap<SymbolIndex, ItemDefinition> mItemDefinitions;
+
+      /** See svmTable(). Not serialized, read from the scripts again. */
+      SvmTable mSvmTable;
+
+      /** Function address -> See dialogueOutputsOf(). Not serialized. */
+      bs::UnorderedMap<bs::UINT32, DialogueOutputs> mDialogueOutputs;
+
+      /**
+       * State kept across reloadDAT(), since it refers to the dialogue infos of the old
+       * scripts. Empty otherwise.
+       */
+      struct KnownInfosBeforeReload
+      {
+        HStoryInformation storyInformation;
+        bs::Set<bs::String> knownInfoNames;
+      };
+
+      bs::Vector<KnownInfosBeforeReload> mKnownInfosBeforeReload;
+      bs::Vector<ScriptObjectHandle> mInfoObjectsBeforeReload;
 
     public:
       REGOTH_DECLARE_RTTI_FOR_REFLECTABLE(DaedalusVMForGameWorld);
@@ -2,10 +2,21 @@
 #include "DATSymbolStorageLoader.hpp"
 #include "DaedalusClassVarResolver.hpp"
 #include "DaedalusDisassembler.hpp"
+#include "DaedalusNativeContext.hpp"
 #include <RTTI/RTTI_REGothDaedalusVM.hpp>
+#include <algorithm>
+#include <initializer_list>
+#include <core/Profiling.hpp>
 #include <daedalus/DATFile.h>
 #include <exception/Throw.hpp>
 #include <log/logging.hpp>
+#include <scripting/ScriptVMSnapshot.hpp>
+
+#if REGOTH_DAEDALUS_THREADED_DISPATCH && (defined(__GNUC__) || defined(__clang__))
+#  define REGOTH_DAEDALUS_HAS_COMPUTED_GOTO 1
+#else
+#  define REGOTH_DAEDALUS_HAS_COMPUTED_GOTO 0
+#endif
 
 namespace REGoth
 {
@@ -24,778 +35,844 @@ namespace REGoth
         "PRINTDEBUGINT",
     };
 
-    DaedalusVM::DaedalusVM(const bs::Vector<bs::UINT8>& datFileData)
+    DaedalusVM::DaedalusVM(bs::SPtr<const DaedalusProgram> program)
+        : mProgram{std::move(program)}
     {
-      mDatFile = bs::bs_shared_ptr_new<Daedalus::DATFile>(datFileData.data(), datFileData.size());
-      mClassVarResolver =
-          bs::bs_shared_ptr_new<DaedalusClassVarResolver>(mScriptSymbols, mScriptObjects);
-      mDatFileData = datFileData;
+      mClassVarResolver = bs::bs_shared_ptr_new<DaedalusClassVarResolver>(
+          mScriptSymbols, mScriptObjects, mClassTemplates);
     }
 
-    void DaedalusVM::fillSymbolStorage()
+    void DaedalusVM::initialize()
     {
-      REGoth::Scripting::convertDatToREGothSymbolStorage(mScriptSymbols, *mDatFile);
+      ScriptVM::initialize();
 
-      registerAllExternals();
+      // Member slots are only known once the class templates have been created
+      resolveVariables();
     }
 
-    bool DaedalusVM::shouldEnableDisassemblerForFunction(const bs::String& uppercaseName) const
+    void DaedalusVM::fillSymbolStorage()
     {
-      return FUNCTIONS_TO_ACTIVATE_DISASSEMBLER_FOR.find(uppercaseName) !=
-             FUNCTIONS_TO_ACTIVATE_DISASSEMBLER_FOR.end();
+      REGoth::Scripting::convertDatToREGothSymbolStorage(mScriptSymbols, *mProgram->datFile());
+
+      decodeInstructions();
+      pinConstantStrings();
+
+      setupExternals();
     }
 
-    bool DaedalusVM::shouldHideFunctionInDisassembly(const bs::String& uppercaseName) const
+    void DaedalusVM::markScriptObjectRoots(ScriptObjectCollector& collector) const
     {
-      return FUNCTIONS_TO_HIDE_IN_DISASSEMBLY.find(uppercaseName) !=
-             FUNCTIONS_TO_HIDE_IN_DISASSEMBLY.end();
+      ScriptVM::markScriptObjectRoots(collector);
+
+      if (mClassVarResolver)
+      {
+        collector.addRoot(mClassVarResolver->getCurrentInstance());
+      }
     }
 
-    void DaedalusVM::executeScriptFunction(const bs::String& name)
+    void DaedalusVM::reloadDAT(bs::SPtr<const DaedalusProgram> program)
     {
-      bs::String upper = name;
-      bs::StringUtil::toUpperCase(upper);
+      if (mCallDepth > 0 || !mCallFrames.empty())
+      {
+        REGOTH_THROW(InvalidStateException, "Cannot reload the scripts while they are running.");
+      }
 
-      const auto& symbol = mScriptSymbols.getSymbol<SymbolScriptFunction>(upper);
+      onBeforeDATReload();
 
-      mPC = symbol.address;
+      // Suspended somewhere inside the old bytecode
+      cancelAllFibers();
 
-      executeUntilReturn();
+      ScriptSymbolStorage oldSymbols = std::move(mScriptSymbols);
+      mScriptSymbols                 = ScriptSymbolStorage();
+
+      mProgram = std::move(program);
+
+      fillSymbolStorage();
+
+      // Bytecode addresses are different in the new scripts
+      mScriptObjects.unbindClassLayouts([&](bs::UINT32 address) -> bs::UINT32 {
+        SymbolIndex oldFunction = oldSymbols.findFunctionByAddress(address);
+
+        if (oldFunction == SYMBOL_INDEX_INVALID) return 0;
+
+        const bs::String& name = oldSymbols.getSymbolName(oldFunction);
+
+        if (!mScriptSymbols.hasSymbolWithName(name)) return 0;
+        if (mScriptSymbols.getSymbolType(name) != SymbolType::ScriptFunction) return 0;
+
+        return mScriptSymbols.getSymbol<SymbolScriptFunction>(name).address;
+      });
+
+      mClassTemplates.createClassTemplates(mScriptSymbols);
+      mScriptObjects.bindClassLayouts(mClassTemplates);
+
+      carryOverVariables(oldSymbols);
+
+      resolveVariables();
+
+      onDATReloaded();
+
+      REGOTH_LOG(Info, VM, "[DaedalusVM] Reloaded scripts, {0} symbols",
+                 mScriptSymbols.numSymbols());
     }
 
-    void DaedalusVM::executeScriptFunction(bs::UINT32 address)
+    /**
+     * Copies the values of all non-constant symbols of the given type into the symbols of the
+     * same name and type, see DaedalusVM::carryOverVariables().
+     */
+    template <typename T, typename CopyValues>
+    static void carryOverSymbolsOfType(const ScriptSymbolStorage& from, ScriptSymbolStorage& to,
+                                       CopyValues copyValues)
     {
-      mPC = address;
+      for (SymbolIndex index : from.symbolsOfType(T::TYPE))
+      {
+        const T& oldSymbol = from.getSymbol<T>(index);
 
-      executeUntilReturn();
+        if (oldSymbol.isClassVar) continue;
+        if (!to.hasSymbolWithName(oldSymbol.name)) continue;
+        if (to.getSymbolType(oldSymbol.name) != T::TYPE) continue;
+
+        T& newSymbol = to.getSymbol<T>(oldSymbol.name);
+
+        if (newSymbol.isKeptAfterLoad) continue;
+
+        copyValues(oldSymbol, newSymbol);
+      }
     }
 
-    void DaedalusVM::executeUntilReturn()
+    /**
+     * Copies as many values as both have, the new symbol might have a different array size.
+     */
+    template <typename T>
+    static void copyValuesInto(const bs::Vector<T>& from, bs::Vector<T>& to)
     {
-      bool wasDisassemblerEnabledBefore = mIsDisassemblerEnabled;
+      std::copy_n(from.begin(), std::min(from.size(), to.size()), to.begin());
+    }
 
-      auto symIndex = scriptSymbols().findFunctionByAddress(mPC);
+    void DaedalusVM::carryOverVariables(const ScriptSymbolStorage& oldSymbols)
+    {
+      carryOverSymbolsOfType<SymbolInt>(oldSymbols, mScriptSymbols,
+                                        [](const SymbolInt& from, SymbolInt& to) {
+                                          copyValuesInto(from.ints, to.ints);
+                                        });
+
+      carryOverSymbolsOfType<SymbolFloat>(oldSymbols, mScriptSymbols,
+                                          [](const SymbolFloat& from, SymbolFloat& to) {
+                                            copyValuesInto(from.floats, to.floats);
+                                          });
+
+      carryOverSymbolsOfType<SymbolString>(oldSymbols, mScriptSymbols,
+                                           [](const SymbolString& from, SymbolString& to) {
+                                             copyValuesInto(from.strings, to.strings);
+                                           });
+
+      carryOverSymbolsOfType<SymbolInstance>(oldSymbols, mScriptSymbols,
+                                             [](const SymbolInstance& from, SymbolInstance& to) {
+                                               to.instance = from.instance;
+                                             });
+    }
 
-      // TODO: Guard these by some configuration variable so they only run during development
-      if (symIndex != SYMBOL_INDEX_INVALID)
-      {
-        bs::String name = scriptSymbols().getSymbolName(symIndex);
+    bs::UINT64 DaedalusVM::snapshotSourceHash() const
+    {
+      return mProgram->sourceHash();
+    }
 
-        if (shouldEnableDisassemblerForFunction(name))
-        {
-          mIsDisassemblerEnabled = true;
-        }
+    void DaedalusVM::onRestoredFromSnapshot()
+    {
+      // Bytecode is cheap to decode and depends on what the VM has been configured to do,
+      // so it is not part of the snapshot.
+      decodeInstructions();
+      pinConstantStrings();
 
-        if (mIsDisassemblerEnabled && shouldHideFunctionInDisassembly(name))
-        {
-          mIsDisassemblerEnabled = false;
-        }
+      setupExternals();
+      resolveVariables();
 
-        if (mIsDisassemblerEnabled)
-        {
-          findFunctionAtAddressAndLog(mPC);
-        }
-      }
+      // Not part of the snapshot, see startFiber()
+      cancelAllFibers();
+    }
 
-      bool didNotReachReturn;
+    void DaedalusVM::decodeInstructions()
+    {
+      mInstructionMemory.reset(mProgram->datFile());
+      mInstructionMemory.decodeAllFunctions(mScriptSymbols);
 
-      do
+      // Before fusing, so the folded code can become part of a superinstruction
+      if (mIsConstantFoldingEnabled)
       {
-        didNotReachReturn = executeInstructionAtPC();
-      } while (didNotReachReturn);
+        DaedalusFoldingStats stats = mInstructionMemory.foldConstants(mScriptSymbols);
 
-      mIsDisassemblerEnabled = wasDisassemblerEnabledBefore;
-    }
+        REGOTH_LOG(Verbose, VM,
+                   "[DaedalusVM] Inlined {0} constants, folded {1} operations and removed {2} "
+                   "branches",
+                   stats.numInlinedConstants, stats.numFoldedOperations,
+                   stats.numRemovedBranches);
+      }
 
-    bool DaedalusVM::executeInstructionAtPC()
-    {
-      Daedalus::PARStackOpCode opcode = mDatFile->getStackOpCode(mPC);
+      if (mIsSuperinstructionsEnabled)
+      {
+        mInstructionMemory.fuseSuperinstructions(mScriptSymbols);
+      }
 
-      mPC += opcode.opSize;
+      // Native code is compiled from the bytecode, so it only fits the exact same DAT-file.
+      // Skips hashing it if there is nothing to look for anyways.
+      mNativeModule = nullptr;
 
-      switch (opcode.op)
+      if (!gDaedalusNativeModules().isEmpty())
       {
-          // Arithmetic
-          // ------------------------------------------------------------------------------
+        mNativeModule = gDaedalusNativeModules().find(snapshotSourceHash());
 
-        case Daedalus::EParOp_Add:
+        if (mNativeModule)
         {
-          bs::INT32 lhs = popIntValue();
-          bs::INT32 rhs = popIntValue();
-          bs::INT32 res = lhs + rhs;
+          REGOTH_LOG(Info, VM, "[DaedalusVM] Running {0} script functions as native code",
+                     mNativeModule->numFunctions());
+        }
+      }
+    }
 
-          if (mIsDisassemblerEnabled)
-          {
-            disassembleAndLogOpcode(opcode, bs::toString(lhs), bs::toString(rhs), bs::toString(res));
-          }
+    bool DaedalusVM::isConstructorFreeOfSideEffects(bs::UINT32 address)
+    {
+      // Instances without a body have no code at their address
+      try
+      {
+        return mInstructionMemory.isConstructorFreeOfSideEffects(mScriptSymbols, address);
+      }
+      catch (const std::exception&)
+      {
+        return false;
+      }
+    }
 
-          mStack.pushInt(res);
-        }
-        break;
+    void DaedalusVM::setSuperinstructionsEnabled(bool enabled)
+    {
+      if (enabled == mIsSuperinstructionsEnabled) return;
 
-        case Daedalus::EParOp_Subract:
-        {
-          bs::INT32 lhs = popIntValue();
-          bs::INT32 rhs = popIntValue();
-          bs::INT32 res = lhs - rhs;
+      mIsSuperinstructionsEnabled = enabled;
 
-          if (mIsDisassemblerEnabled)
-          {
-            disassembleAndLogOpcode(opcode, bs::toString(lhs), bs::toString(rhs), bs::toString(res));
-          }
+      decodeInstructions();
+    }
 
-          mStack.pushInt(res);
-        }
-        break;
+    void DaedalusVM::setConstantFoldingEnabled(bool enabled)
+    {
+      if (enabled == mIsConstantFoldingEnabled) return;
 
-        case Daedalus::EParOp_Multiply:
-        {
-          bs::INT32 lhs = popIntValue();
-          bs::INT32 rhs = popIntValue();
-          bs::INT32 res = lhs * rhs;
+      mIsConstantFoldingEnabled = enabled;
 
-          if (mIsDisassemblerEnabled)
-          {
-            disassembleAndLogOpcode(opcode, bs::toString(lhs), bs::toString(rhs), bs::toString(res));
-          }
+      decodeInstructions();
+    }
 
-          mStack.pushInt(res);
-        }
-        break;
+    bs::UINT32 DaedalusVM::verifyConstantFolding()
+    {
+      DaedalusInstructionMemory original;
+      original.reset(mProgram->datFile());
+      original.decodeAllFunctions(mScriptSymbols);
 
-        case Daedalus::EParOp_Divide:
-        {
-          bs::INT32 lhs = popIntValue();
-          bs::INT32 rhs = popIntValue();
-          bs::INT32 res = lhs / rhs;
+      DaedalusInstructionMemory folded = original;
+      DaedalusFoldingStats stats       = folded.foldConstants(mScriptSymbols);
 
-          if (mIsDisassemblerEnabled)
-          {
-            disassembleAndLogOpcode(opcode, bs::toString(lhs), bs::toString(rhs), bs::toString(res));
-          }
+      // The interpreter always runs what is inside mInstructionMemory
+      std::swap(mInstructionMemory, original);
 
-          mStack.pushInt(res);
-        }
-        break;
+      bs::UINT32 pc                      = mPC;
+      bs::UINT64 numExecutedInstructions = mNumExecutedInstructions;
+      bs::UINT32 numMismatches           = 0;
 
-        case Daedalus::EParOp_Mod:
-        {
-          bs::INT32 lhs = popIntValue();
-          bs::INT32 rhs = popIntValue();
-          bs::INT32 res = lhs % rhs;
+      for (bs::UINT32 address : stats.replacedAddresses)
+      {
+        const DaedalusInstruction replacement = folded.instructionAt(address);
+        bs::UINT32 end                        = address + replacement.size;
 
-          if (mIsDisassemblerEnabled)
-          {
-            disassembleAndLogOpcode(opcode, bs::toString(lhs), bs::toString(rhs), bs::toString(res));
-          }
+        // Straight-line code with a JumpIf at most at its end, so running as many instructions
+        // as have been replaced does exactly what the replacement does
+        bs::UINT32 numInstructions = 0;
 
-          mStack.pushInt(res);
+        for (bs::UINT32 i = address; i < end; i += mInstructionMemory.instructionAt(i).size)
+        {
+          numInstructions += 1;
         }
-        break;
 
-          // Binary
-          // ----------------------------------------------------------------------------------
+        mPC = address;
 
-        case Daedalus::EParOp_BinOr:
+        for (bs::UINT32 i = 0; i < numInstructions; i++)
         {
-          bs::INT32 lhs = popIntValue();
-          bs::INT32 rhs = popIntValue();
-          bs::INT32 res = lhs | rhs;
+          executeInstructionAtPC<false>();
+        }
 
-          if (mIsDisassemblerEnabled)
-          {
-            disassembleAndLogOpcode(opcode, bs::toString(lhs), bs::toString(rhs), bs::toString(res));
-          }
+        bs::String expected;
+        bs::String actual;
 
-          mStack.pushInt(res);
+        if (replacement.op == Daedalus::EParOp_Jump)
+        {
+          expected = "a jump to " + bs::toString(replacement.address());
+          actual   = "a jump to " + bs::toString(mPC);
         }
-        break;
-
-        case Daedalus::EParOp_BinAnd:
+        else
         {
-          bs::INT32 lhs = popIntValue();
-          bs::INT32 rhs = popIntValue();
-          bs::INT32 res = lhs & rhs;
-
-          if (mIsDisassemblerEnabled)
-          {
-            disassembleAndLogOpcode(opcode, bs::toString(lhs), bs::toString(rhs), bs::toString(res));
-          }
-
-          mStack.pushInt(res);
+          expected = bs::toString(replacement.operand);
+          actual   = bs::toString(popIntValue());
         }
-        break;
 
-        case Daedalus::EParOp_ShiftLeft:
+        if (expected != actual)
         {
-          bs::INT32 lhs = popIntValue();
-          bs::INT32 rhs = popIntValue();
-          bs::INT32 res = lhs << rhs;
-
-          if (mIsDisassemblerEnabled)
-          {
-            disassembleAndLogOpcode(opcode, bs::toString(lhs), bs::toString(rhs), bs::toString(res));
-          }
+          REGOTH_LOG(Error, VM,
+                     "[DaedalusVM] Constant folding at {0} gives {1}, the interpreter {2}",
+                     address, expected, actual);
 
-          mStack.pushInt(res);
+          numMismatches += 1;
         }
-        break;
+      }
 
-        case Daedalus::EParOp_ShiftRight:
-        {
-          bs::INT32 lhs = popIntValue();
-          bs::INT32 rhs = popIntValue();
-          bs::INT32 res = lhs >> rhs;
+      std::swap(mInstructionMemory, original);
 
-          if (mIsDisassemblerEnabled)
-          {
-            disassembleAndLogOpcode(opcode, bs::toString(lhs), bs::toString(rhs), bs::toString(res));
-          }
+      mPC                      = pc;
+      mNumExecutedInstructions = numExecutedInstructions;
 
-          mStack.pushInt(res);
-        }
-        break;
+      if (numMismatches > 0)
+      {
+        REGOTH_THROW(InvalidStateException,
+                     bs::toString(numMismatches) + " results of constant folding differ from the "
+                                                   "interpreter, see log");
+      }
 
-        case Daedalus::EParOp_Negate:
-        {
-          bs::INT32 lhs = popIntValue();
-          bs::INT32 res = ~lhs;
+      REGOTH_LOG(Info, VM, "[DaedalusVM] Verified constant folding of {0} instructions",
+                 stats.replacedAddresses.size());
 
-          if (mIsDisassemblerEnabled)
-          {
-            disassembleAndLogOpcode(opcode, bs::toString(lhs), "", bs::toString(res));
-          }
+      return (bs::UINT32)stats.replacedAddresses.size();
+    }
 
-          mStack.pushInt(res);
-        }
-        break;
+    void DaedalusVM::pinConstantStrings()
+    {
+      for (SymbolIndex index : mScriptSymbols.symbolsOfType(SymbolType::String))
+      {
+        const SymbolString& symbol = mScriptSymbols.getSymbol<SymbolString>(index);
 
-          // Logic
-          // -----------------------------------------------------------------------------------
+        if (!symbol.isKeptAfterLoad || symbol.isClassVar) continue;
 
-        case Daedalus::EParOp_LogOr:
+        for (const bs::String& value : symbol.strings)
         {
-          bs::INT32 lhs = popIntValue();
-          bs::INT32 rhs = popIntValue();
-          bs::INT32 res = lhs || rhs ? 1 : 0;
+          mStringPool.pin(value);
+        }
+      }
+    }
 
-          if (mIsDisassemblerEnabled)
-          {
-            disassembleAndLogOpcode(opcode, bs::toString(lhs), bs::toString(rhs), bs::toString(res));
-          }
+    bool DaedalusVM::shouldEnableDisassemblerForFunction(const bs::String& uppercaseName) const
+    {
+      return FUNCTIONS_TO_ACTIVATE_DISASSEMBLER_FOR.find(uppercaseName) !=
+             FUNCTIONS_TO_ACTIVATE_DISASSEMBLER_FOR.end();
+    }
 
-          mStack.pushInt(res);
-        }
-        break;
+    bool DaedalusVM::shouldHideFunctionInDisassembly(const bs::String& uppercaseName) const
+    {
+      return FUNCTIONS_TO_HIDE_IN_DISASSEMBLY.find(uppercaseName) !=
+             FUNCTIONS_TO_HIDE_IN_DISASSEMBLY.end();
+    }
 
-        case Daedalus::EParOp_LogAnd:
-        {
-          bs::INT32 lhs = popIntValue();
-          bs::INT32 rhs = popIntValue();
-          bs::INT32 res = lhs && rhs ? 1 : 0;
+    void DaedalusVM::executeScriptFunction(const bs::String& name)
+    {
+      bs::String upper = name;
+      bs::StringUtil::toUpperCase(upper);
 
-          if (mIsDisassemblerEnabled)
-          {
-            disassembleAndLogOpcode(opcode, bs::toString(lhs), bs::toString(rhs), bs::toString(res));
-          }
+      const auto& symbol = mScriptSymbols.getSymbol<SymbolScriptFunction>(upper);
 
-          mStack.pushInt(res);
-        }
-        break;
+      mPC = symbol.address;
 
-          // Comparision
-          // -----------------------------------------------------------------------------
+      executeUntilReturn();
+    }
 
-        case Daedalus::EParOp_Less:
-        {
-          bs::INT32 lhs = popIntValue();
-          bs::INT32 rhs = popIntValue();
-          bs::INT32 res = lhs < rhs ? 1 : 0;
+    void DaedalusVM::executeScriptFunction(const SymbolRef& function)
+    {
+      const auto& symbol =
+          mScriptSymbols.getSymbol<SymbolScriptFunction>(function.resolve(mScriptSymbols));
 
-          if (mIsDisassemblerEnabled)
-          {
-            disassembleAndLogOpcode(opcode, bs::toString(lhs), bs::toString(rhs), bs::toString(res));
-          }
+      mPC = symbol.address;
 
-          mStack.pushInt(res);
-        }
-        break;
+      executeUntilReturn();
+    }
 
-        case Daedalus::EParOp_Greater:
-        {
-          bs::INT32 lhs = popIntValue();
-          bs::INT32 rhs = popIntValue();
-          bs::INT32 res = lhs > rhs ? 1 : 0;
+    void DaedalusVM::executeScriptFunction(bs::UINT32 address)
+    {
+      mPC = address;
 
-          if (mIsDisassemblerEnabled)
-          {
-            disassembleAndLogOpcode(opcode, bs::toString(lhs), bs::toString(rhs), bs::toString(res));
-          }
+      executeUntilReturn();
+    }
 
-          mStack.pushInt(res);
-        }
-        break;
+    void DaedalusVM::executeUntilReturn()
+    {
+      REGOTH_PROFILE_SCOPE("ScriptVM");
 
-        case Daedalus::EParOp_LessOrEqual:
-        {
-          bs::INT32 lhs = popIntValue();
-          bs::INT32 rhs = popIntValue();
-          bs::INT32 res = lhs <= rhs ? 1 : 0;
+      bs::UINT32 outerCallFramesBase = mCallFramesBase;
+      mCallFramesBase                = (bs::UINT32)mCallFrames.size();
 
-          if (mIsDisassemblerEnabled)
-          {
-            disassembleAndLogOpcode(opcode, bs::toString(lhs), bs::toString(rhs), bs::toString(res));
-          }
+      // Whatever runs here is not part of a fiber, even if called from one, see startFiber()
+      DaedalusFiberHandle outerFiber = mRunningFiber;
+      mRunningFiber                  = DAEDALUS_FIBER_INVALID;
 
-          mStack.pushInt(res);
-        }
-        break;
+      // Keep the profiler alive, in case profiling is disabled from within the scripts
+      bs::SPtr<DaedalusProfiler> profiler = mProfiler;
+      bs::UINT32 profilerDepth            = 0;
 
-        case Daedalus::EParOp_Equal:
-        {
-          bs::INT32 lhs = popIntValue();
-          bs::INT32 rhs = popIntValue();
-          bs::INT32 res = lhs == rhs ? 1 : 0;
+      if (profiler)
+      {
+        profilerDepth = profiler->depth();
+        profiler->enterFunction(mPC, mNumExecutedInstructions);
+      }
 
-          if (mIsDisassemblerEnabled)
-          {
-            disassembleAndLogOpcode(opcode, bs::toString(lhs), bs::toString(rhs), bs::toString(res));
-          }
+      try
+      {
+        DaedalusNativeFunction native = nativeFunctionAt(mPC);
 
-          mStack.pushInt(res);
+        if (native)
+        {
+          DaedalusNativeContext context(*this);
+          native(context);
         }
-        break;
-
-        case Daedalus::EParOp_NotEqual:
+        else if (mIsTracingEnabled)
         {
-          bs::INT32 lhs = popIntValue();
-          bs::INT32 rhs = popIntValue();
-          bs::INT32 res = lhs != rhs ? 1 : 0;
-
-          if (mIsDisassemblerEnabled)
-          {
-            disassembleAndLogOpcode(opcode, bs::toString(lhs), bs::toString(rhs), bs::toString(res));
-          }
-
-          mStack.pushInt(res);
+          executeUntilReturnWithTracing();
+        }
+        else
+        {
+          runInterpreterUntilReturn<false>();
         }
-        break;
+      }
+      catch (...)
+      {
+        // Drop the frames of the functions which were interrupted
+        mCallDepth -= (bs::INT32)(mCallFrames.size() - mCallFramesBase);
+        mCallFrames.resize(mCallFramesBase);
+        mCallFramesBase = outerCallFramesBase;
+        mRunningFiber   = outerFiber;
 
-        case Daedalus::EParOp_GreaterOrEqual:
+        if (profiler)
         {
-          bs::INT32 lhs = popIntValue();
-          bs::INT32 rhs = popIntValue();
-          bs::INT32 res = lhs >= rhs ? 1 : 0;
+          profiler->unwindTo(profilerDepth, mNumExecutedInstructions);
+        }
 
-          if (mIsDisassemblerEnabled)
-          {
-            disassembleAndLogOpcode(opcode, bs::toString(lhs), bs::toString(rhs), bs::toString(res));
-          }
+        throw;
+      }
 
-          mStack.pushInt(res);
-        }
-        break;
+      mCallFramesBase = outerCallFramesBase;
+      mRunningFiber   = outerFiber;
 
-          // Unary
-          // -----------------------------------------------------------------------------------
+      if (profiler)
+      {
+        // Leaves the function entered above
+        profiler->unwindTo(profilerDepth, mNumExecutedInstructions);
+      }
+    }
 
-        case Daedalus::EParOp_Plus:
-        {
-          bs::INT32 lhs = popIntValue();
-          bs::INT32 res = +lhs;
+    DaedalusFiberHandle DaedalusVM::startFiber(bs::UINT32 address)
+    {
+      DaedalusFiberHandle handle = mNextFiberHandle++;
 
-          if (mIsDisassemblerEnabled)
-          {
-            disassembleAndLogOpcode(opcode, bs::toString(lhs), "", bs::toString(res));
-          }
+      if (mNextFiberHandle == DAEDALUS_FIBER_INVALID)
+      {
+        mNextFiberHandle += 1;
+      }
 
-          mStack.pushInt(res);
-        }
-        break;
+      DaedalusFiber fiber;
+      fiber.function      = address;
+      fiber.resumeAddress = address;
+      fiber.savedInstance = mClassVarResolver->getCurrentInstance();
 
-        case Daedalus::EParOp_Minus:
-        {
-          bs::INT32 lhs = popIntValue();
-          bs::INT32 res = -lhs;
+      return runFiber(handle, fiber) ? handle : DAEDALUS_FIBER_INVALID;
+    }
 
-          if (mIsDisassemblerEnabled)
-          {
-            disassembleAndLogOpcode(opcode, bs::toString(lhs), "", bs::toString(res));
-          }
+    bool DaedalusVM::resumeFiber(DaedalusFiberHandle handle)
+    {
+      auto it = mSuspendedFibers.find(handle);
 
-          mStack.pushInt(res);
-        }
-        break;
+      if (it == mSuspendedFibers.end())
+      {
+        return false;
+      }
 
-        case Daedalus::EParOp_Not:
-        {
-          bs::INT32 lhs = popIntValue();
-          bs::INT32 res = !lhs;
+      DaedalusFiber fiber = std::move(it->second);
+      mSuspendedFibers.erase(it);
 
-          if (mIsDisassemblerEnabled)
-          {
-            disassembleAndLogOpcode(opcode, bs::toString(lhs), "", bs::toString(res));
-          }
+      return runFiber(handle, fiber);
+    }
 
-          mStack.pushInt(res);
-        }
-        break;
+    void DaedalusVM::cancelFiber(DaedalusFiberHandle handle)
+    {
+      mSuspendedFibers.erase(handle);
+    }
 
-          // Stack
-          // -----------------------------------------------------------------------------------
+    void DaedalusVM::cancelAllFibers()
+    {
+      if (!mSuspendedFibers.empty())
+      {
+        REGOTH_LOG(Info, VM, "[DaedalusVM] Cancelling {0} suspended fibers",
+                   mSuspendedFibers.size());
+      }
 
-        case Daedalus::EParOp_PushInt:
-          if (mIsDisassemblerEnabled)
-          {
-            disassembleAndLogOpcode(opcode, bs::toString(opcode.value), "", "");
-          }
+      mSuspendedFibers.clear();
+    }
 
-          mStack.pushInt(opcode.value);
-          break;
+    DaedalusFiberHandle DaedalusVM::yieldFiber()
+    {
+      if (!canYieldFiber())
+      {
+        REGOTH_THROW(InvalidStateException,
+                     "Cannot suspend script code which is not running as fiber");
+      }
 
-        case Daedalus::EParOp_PushVar:
-          if (mIsDisassemblerEnabled)
-          {
-            disassembleAndLogOpcode(opcode, "", "", "");
-          }
+      mIsYieldRequested = true;
 
-          pushVariable((bs::UINT32)opcode.symbol, 0);
-          break;
+      return mRunningFiber;
+    }
 
-        case Daedalus::EParOp_PushInstance:
-          if (mIsDisassemblerEnabled)
-          {
-            disassembleAndLogOpcode(opcode, "", "", "");
-          }
+    bool DaedalusVM::runFiber(DaedalusFiberHandle handle, const DaedalusFiber& fiber)
+    {
+      REGOTH_PROFILE_SCOPE("ScriptVM");
 
-          mStack.pushInstance((bs::UINT32)opcode.symbol);
-          break;
+      bs::UINT32 outerCallFramesBase = mCallFramesBase;
+      mCallFramesBase                = (bs::UINT32)mCallFrames.size();
 
-        case Daedalus::EParOp_PushArrayVar:
-          if (mIsDisassemblerEnabled)
-          {
-            disassembleAndLogOpcode(opcode, "", "", "");
-          }
+      DaedalusFiberHandle outerFiber = mRunningFiber;
+      mRunningFiber                  = handle;
 
-          pushVariable((bs::UINT32)opcode.symbol, opcode.index);
-          break;
+      // Put back the functions the fiber was in when it yielded
+      mCallFrames.insert(mCallFrames.end(), fiber.callFrames.begin(), fiber.callFrames.end());
+      mCallDepth += (bs::INT32)fiber.callFrames.size();
 
-          // Assign
-          // ----------------------------------------------------------------------------------
+      mPC = fiber.resumeAddress;
+      mClassVarResolver->setCurrentInstance(fiber.savedInstance);
 
-        case Daedalus::EParOp_AssignFunc:
-          // Function Pointes are pushed as intergers
-          {
-            SymbolIndex targetIndex = mStack.popFunction();
-            SymbolIndex sourceIndex = (SymbolIndex)popIntValue();
-
-            if (mIsDisassemblerEnabled)
-            {
-              disassembleAndLogOpcode(opcode, "", "", "");
-            }
-
-            auto& target = mScriptSymbols.getSymbol<SymbolScriptFunction>(targetIndex);
-
-            SymbolBase& sourceBase = mScriptSymbols.getSymbolBase(sourceIndex);
-
-            bs::UINT32 sourceAddress;
-
-            if (sourceBase.type == SymbolType::ScriptFunction)
-            {
-              auto& sourceFunction = (SymbolScriptFunction&)sourceBase;
-              sourceAddress        = sourceFunction.address;
-            }
-            else if (sourceBase.type == SymbolType::Instance)
-            {
-              // Because deadalus' type safety isn't what it seems like, we need to handle this
-              // stupid edgecase of an instance being assigned to a function-pointer class variable.
-              // Specifically `C_ITEM.owner`, which is declared as `VAR FUNC owner` but is then
-              // given instances of class `C_NPC`.
-              //
-              // Since the original just seems to store the symbol index, not caring about the type,
-              // it works there. However, REGoth stores the function address, so we have to work
-              // around that by storing the instances constructor address. Let's just hope it will
-              // work...
-              //
-              // We could also add another type of symbol for function pointers, but then we have
-              // Symbols which *should* refer to functions, but sometimes refer to instances, which
-              // sucks as well.
-              auto& sourceInstance = (SymbolInstance&)sourceBase;
-              sourceAddress        = sourceInstance.constructorAddress;
-            }
-            else
-            {
-              REGOTH_THROW(InvalidParametersException,
-                           bs::StringUtil::format("Cannot get the address of symbol {0} of type {1}",
-                                                  sourceBase.name, (int)sourceBase.type));
-            }
-
-            if (target.isClassVar)
-            {
-              mClassVarResolver->resolveClassVariableFunctionPointer(target.name) = sourceAddress;
-            }
-            else
-            {
-              target.address = sourceAddress;
-            }
-          }
-          break;
+      // Keep the profiler alive, in case profiling is disabled from within the scripts.
+      // Everything the fiber does is accounted to the function it has been started with.
+      bs::SPtr<DaedalusProfiler> profiler = mProfiler;
+      bs::UINT32 profilerDepth            = 0;
 
-        case Daedalus::EParOp_AssignString:
-        {
-          auto& lhs       = popStringReference();
-          const auto& rhs = popStringValue();
+      if (profiler)
+      {
+        profilerDepth = profiler->depth();
+        profiler->enterFunction(fiber.function, mNumExecutedInstructions);
+      }
 
-          if (mIsDisassemblerEnabled)
-          {
-            disassembleAndLogOpcode(opcode, rhs, lhs, "");
-          }
+      try
+      {
+        runInterpreterUntilReturn<false>();
+      }
+      catch (...)
+      {
+        mCallDepth -= (bs::INT32)(mCallFrames.size() - mCallFramesBase);
+        mCallFrames.resize(mCallFramesBase);
+        mCallFramesBase   = outerCallFramesBase;
+        mRunningFiber     = outerFiber;
+        mIsYieldRequested = false;
 
-          lhs = rhs;
+        if (profiler)
+        {
+          profiler->unwindTo(profilerDepth, mNumExecutedInstructions);
         }
 
-        break;
+        throw;
+      }
+
+      bool isSuspended = mIsYieldRequested;
 
-        case Daedalus::EParOp_AssignFloat:
-        {
-          auto& lhs       = popFloatReference();
-          const auto& rhs = popFloatValue();
+      if (isSuspended)
+      {
+        mIsYieldRequested = false;
 
-          if (mIsDisassemblerEnabled)
-          {
-            disassembleAndLogOpcode(opcode, bs::toString(rhs), bs::toString(lhs), "");
-          }
+        DaedalusFiber& suspended = mSuspendedFibers[handle];
+        suspended.function       = fiber.function;
+        suspended.resumeAddress  = mPC;
+        suspended.savedInstance  = mClassVarResolver->getCurrentInstance();
+
+        suspended.callFrames.assign(mCallFrames.begin() + mCallFramesBase, mCallFrames.end());
 
-          lhs = rhs;
+        // Profiled calls have been left by unwinding below, resuming does not enter them again
+        for (DaedalusCallFrame& frame : suspended.callFrames)
+        {
+          frame.isProfiled = false;
         }
-        break;
 
-        case Daedalus::EParOp_AssignInstance:
-          // -
-          {
-            SymbolIndex targetIndex = mStack.popInstance();
-            SymbolIndex sourceIndex = mStack.popInstance();
+        mCallDepth -= (bs::INT32)suspended.callFrames.size();
+        mCallFrames.resize(mCallFramesBase);
+      }
 
-            auto& target = mScriptSymbols.getSymbol<SymbolInstance>(targetIndex);
-            auto& source = mScriptSymbols.getSymbol<SymbolInstance>(sourceIndex);
+      mCallFramesBase = outerCallFramesBase;
+      mRunningFiber   = outerFiber;
 
-            if (mIsDisassemblerEnabled)
-            {
-              disassembleAndLogOpcode(opcode, target.name, source.name, "");
-            }
+      if (profiler)
+      {
+        profiler->unwindTo(profilerDepth, mNumExecutedInstructions);
+      }
 
-            target.instance = source.instance;
-          }
-          break;
+      return isSuspended;
+    }
 
-        case Daedalus::EParOp_Assign:
-        {
-          auto& lhs       = popIntReference();
-          const auto& rhs = popIntValue();
+    void DaedalusVM::callFromNativeCode(bs::UINT32 address)
+    {
+      DaedalusNativeFunction native = nativeFunctionAt(address);
 
-          if (mIsDisassemblerEnabled)
-          {
-            disassembleAndLogOpcode(opcode);
-          }
+      NestedCallScope call(*this);
 
-          lhs = rhs;
-        }
-        break;
+      if (native)
+      {
+        // Keep the profiler alive, in case profiling is disabled from within the scripts
+        bs::SPtr<DaedalusProfiler> profiler = mProfiler;
 
-        case Daedalus::EParOp_AssignAdd:
+        if (profiler)
         {
-          auto& lhs       = popIntReference();
-          const auto& rhs = popIntValue();
-          auto res        = lhs + rhs;
+          profiler->enterFunction(address, mNumExecutedInstructions);
+        }
 
-          if (mIsDisassemblerEnabled)
-          {
-            disassembleAndLogOpcode(opcode);
-          }
+        DaedalusNativeContext context(*this);
+        native(context);
 
-          lhs = res;
+        if (profiler)
+        {
+          profiler->leave(mNumExecutedInstructions);
         }
-        break;
+      }
+      else
+      {
+        mPC = address;
 
-        case Daedalus::EParOp_AssignSubtract:
-        {
-          auto& lhs       = popIntReference();
-          const auto& rhs = popIntValue();
-          auto res        = lhs - rhs;
+        executeUntilReturn();
+      }
+    }
 
-          if (mIsDisassemblerEnabled)
-          {
-            disassembleAndLogOpcode(opcode);
-          }
+    void DaedalusVM::setProfilingEnabled(bool enabled)
+    {
+      if (enabled && !mProfiler)
+      {
+        mProfiler = bs::bs_shared_ptr_new<DaedalusProfiler>();
+      }
+      else if (!enabled)
+      {
+        mProfiler = nullptr;
+      }
+    }
 
-          lhs = res;
-        }
-        break;
+    void DaedalusVM::executeUntilReturnWithTracing()
+    {
+      bool wasDisassemblerEnabledBefore = mIsDisassemblerEnabled;
 
-        case Daedalus::EParOp_AssignMultiply:
-        {
-          auto& lhs       = popIntReference();
-          const auto& rhs = popIntValue();
-          auto res        = lhs * rhs;
+      auto symIndex = scriptSymbols().findFunctionByAddress(mPC);
 
-          if (mIsDisassemblerEnabled)
-          {
-            disassembleAndLogOpcode(opcode);
-          }
+      if (symIndex != SYMBOL_INDEX_INVALID)
+      {
+        const bs::String& name = scriptSymbols().getSymbolName(symIndex);
 
-          lhs = res;
+        if (shouldEnableDisassemblerForFunction(name))
+        {
+          mIsDisassemblerEnabled = true;
         }
-        break;
 
-        case Daedalus::EParOp_AssignDivide:
+        if (mIsDisassemblerEnabled && shouldHideFunctionInDisassembly(name))
         {
-          auto& lhs       = popIntReference();
-          const auto& rhs = popIntValue();
-          auto res        = lhs / rhs;
-
-          if (mIsDisassemblerEnabled)
-          {
-            disassembleAndLogOpcode(opcode);
-          }
-
-          lhs = res;
+          mIsDisassemblerEnabled = false;
         }
-        break;
-
-        case Daedalus::EParOp_AssignStringRef:
-          REGOTH_THROW(NotImplementedException, "AssignStringRef is not implemented.");
-          break;
-
-          // Control flow
-          // ----------------------------------------------------------------------------
 
-        case Daedalus::EParOp_Ret:
-          if (mIsDisassemblerEnabled)
-          {
-            disassembleAndLogOpcode(opcode);
-          }
+        if (mIsDisassemblerEnabled)
+        {
+          findFunctionAtAddressAndLog(mPC);
+        }
+      }
 
-          // Script function Ends here!
-          return false;
+      if (mIsDisassemblerEnabled)
+      {
+        runInterpreterUntilReturn<true>();
+      }
+      else
+      {
+        runInterpreterUntilReturn<false>();
+      }
 
-        case Daedalus::EParOp_Jump:
-          if (mIsDisassemblerEnabled)
-          {
-            disassembleAndLogOpcode(opcode);
-          }
+      mIsDisassemblerEnabled = wasDisassemblerEnabledBefore;
+    }
 
-          mPC = (bs::UINT32)opcode.address;
+    template <bool isTracing>
+    void DaedalusVM::runInterpreterUntilReturn()
+    {
+      switch (mInterpreter)
+      {
+        case DaedalusInterpreter::Threaded:
+          executeUntilReturnThreaded<isTracing>();
           break;
 
-        case Daedalus::EParOp_JumpIf:
-        {
-          bs::UINT32 lhs = popIntValue();
-
-          if (mIsDisassemblerEnabled)
-          {
-            disassembleAndLogOpcode(opcode, bs::toString(lhs));
-          }
+        case DaedalusInterpreter::Switch:
+        default:
+          executeUntilReturnSwitch<isTracing>();
+          break;
+      }
+    }
 
-          // Jump if value on stack is 0
-          if (!lhs)
-          {
-            mPC = (bs::UINT32)opcode.address;
-          }
-        }
-        break;
+    template <bool isTracing>
+    void DaedalusVM::executeUntilReturnSwitch()
+    {
+      bool didNotReachReturn;
 
-        case Daedalus::EParOp_Call:
-        {
-          if (mIsDisassemblerEnabled)
-          {
-            disassembleAndLogOpcode(opcode);
-          }
+      do
+      {
+        didNotReachReturn = executeInstructionAtPC<isTracing>();
+      } while (didNotReachReturn);
+    }
 
-          // Save some of this functions state and execute the whole sub-function
-          SymbolIndex currentInstance = mClassVarResolver->getCurrentInstance();
-          bs::UINT32 pc               = mPC;
+#if REGOTH_DAEDALUS_HAS_COMPUTED_GOTO
+    /**
+     * Where to jump to for every opcode, see executeUntilReturnThreaded().
+     */
+    struct DaedalusDispatchTable
+    {
+      void* targets[256];
+    };
 
-          mPC = (bs::UINT32)opcode.address;
-          mCallDepth += 1;
+    struct DaedalusDispatchEntry
+    {
+      bs::UINT32 op;
+      void* target;
+    };
 
-          executeUntilReturn();
+    /**
+     * @return Table jumping to the given targets, and to `invalidTarget` for all other opcodes.
+     */
+    static DaedalusDispatchTable makeDaedalusDispatchTable(
+        void* invalidTarget, std::initializer_list<DaedalusDispatchEntry> entries)
+    {
+      DaedalusDispatchTable table;
 
-          mCallDepth -= 1;
-          mPC = pc;
-          mClassVarResolver->setCurrentInstance(currentInstance);
-        }
-        break;
+      for (void*& target : table.targets)
+      {
+        target = invalidTarget;
+      }
 
-        case Daedalus::EParOp_CallExternal:
-        {
-          if (mIsDisassemblerEnabled)
-          {
-            disassembleAndLogOpcode(opcode);
-          }
+      for (const DaedalusDispatchEntry& entry : entries)
+      {
+        table.targets[entry.op] = entry.target;
+      }
 
-          auto it = mExternals.find(opcode.symbol);
+      return table;
+    }
+#endif
 
-          if (it != mExternals.end())
+    template <bool isTracing>
+    void DaedalusVM::executeUntilReturnThreaded()
+    {
+#if REGOTH_DAEDALUS_HAS_COMPUTED_GOTO
+      // Label addresses are the same for all calls, so the table is only built once. As a
+      // static local, that is done by the first call, even if several threads call at once.
+      // It can't be filled by a lambda, since the labels only exist inside this function.
+      // Note that every instantiation of this template has its own table.
+      static const DaedalusDispatchTable dispatchTable = makeDaedalusDispatchTable(
+          &&L_InvalidOpcode,
           {
-            SymbolIndex currentInstance = mClassVarResolver->getCurrentInstance();
-            bs::UINT32 pc               = mPC;
-            mCallDepth += 1;
+#define REGOTH_DAEDALUS_DISPATCH(op) {Daedalus::op, &&L_##op},
+
+          REGOTH_DAEDALUS_DISPATCH(EParOp_Add)
+          REGOTH_DAEDALUS_DISPATCH(EParOp_Subract)
+          REGOTH_DAEDALUS_DISPATCH(EParOp_Multiply)
+          REGOTH_DAEDALUS_DISPATCH(EParOp_Divide)
+          REGOTH_DAEDALUS_DISPATCH(EParOp_Mod)
+          REGOTH_DAEDALUS_DISPATCH(EParOp_BinOr)
+          REGOTH_DAEDALUS_DISPATCH(EParOp_BinAnd)
+          REGOTH_DAEDALUS_DISPATCH(EParOp_ShiftLeft)
+          REGOTH_DAEDALUS_DISPATCH(EParOp_ShiftRight)
+          REGOTH_DAEDALUS_DISPATCH(EParOp_Negate)
+          REGOTH_DAEDALUS_DISPATCH(EParOp_LogOr)
+          REGOTH_DAEDALUS_DISPATCH(EParOp_LogAnd)
+          REGOTH_DAEDALUS_DISPATCH(EParOp_Less)
+          REGOTH_DAEDALUS_DISPATCH(EParOp_Greater)
+          REGOTH_DAEDALUS_DISPATCH(EParOp_LessOrEqual)
+          REGOTH_DAEDALUS_DISPATCH(EParOp_Equal)
+          REGOTH_DAEDALUS_DISPATCH(EParOp_NotEqual)
+          REGOTH_DAEDALUS_DISPATCH(EParOp_GreaterOrEqual)
+          REGOTH_DAEDALUS_DISPATCH(EParOp_Plus)
+          REGOTH_DAEDALUS_DISPATCH(EParOp_Minus)
+          REGOTH_DAEDALUS_DISPATCH(EParOp_Not)
+          REGOTH_DAEDALUS_DISPATCH(EParOp_PushInt)
+          REGOTH_DAEDALUS_DISPATCH(EParOp_PushVar)
+          REGOTH_DAEDALUS_DISPATCH(EParOp_PushInstance)
+          REGOTH_DAEDALUS_DISPATCH(EParOp_PushArrayVar)
+          REGOTH_DAEDALUS_DISPATCH(EParOp_AssignFunc)
+          REGOTH_DAEDALUS_DISPATCH(EParOp_AssignString)
+          REGOTH_DAEDALUS_DISPATCH(EParOp_AssignFloat)
+          REGOTH_DAEDALUS_DISPATCH(EParOp_AssignInstance)
+          REGOTH_DAEDALUS_DISPATCH(EParOp_Assign)
+          REGOTH_DAEDALUS_DISPATCH(EParOp_AssignAdd)
+          REGOTH_DAEDALUS_DISPATCH(EParOp_AssignSubtract)
+          REGOTH_DAEDALUS_DISPATCH(EParOp_AssignMultiply)
+          REGOTH_DAEDALUS_DISPATCH(EParOp_AssignDivide)
+          REGOTH_DAEDALUS_DISPATCH(EParOp_AssignStringRef)
+          REGOTH_DAEDALUS_DISPATCH(EParOp_Ret)
+          REGOTH_DAEDALUS_DISPATCH(EParOp_Jump)
+          REGOTH_DAEDALUS_DISPATCH(EParOp_JumpIf)
+          REGOTH_DAEDALUS_DISPATCH(EParOp_Call)
+          REGOTH_DAEDALUS_DISPATCH(EParOp_CallExternal)
+          REGOTH_DAEDALUS_DISPATCH(EParOp_SetInstance)
+
+#undef REGOTH_DAEDALUS_DISPATCH
+#define REGOTH_DAEDALUS_DISPATCH(op) {op, &&L_##op},
+
+          REGOTH_DAEDALUS_DISPATCH(SuperOp_JumpIfNotCompareVarInt)
+          REGOTH_DAEDALUS_DISPATCH(SuperOp_JumpIfNotCompareIntVar)
+          REGOTH_DAEDALUS_DISPATCH(SuperOp_PushInstanceSetInstance)
+          REGOTH_DAEDALUS_DISPATCH(SuperOp_AssignVar)
+
+#undef REGOTH_DAEDALUS_DISPATCH
+          });
+
+      // Copied, since executing a CALL might decode more instructions and invalidate references.
+      DaedalusInstruction opcode = {};
+
+#define REGOTH_DAEDALUS_OPCODE(op) L_##op:
+#define REGOTH_DAEDALUS_SUPERINSTRUCTION(op) L_##op:
+#define REGOTH_DAEDALUS_NEXT()                            \
+  do                                                      \
+  {                                                       \
+    opcode = mInstructionMemory.instructionAt(mPC);       \
+    mPC += opcode.size;                                   \
+    mNumExecutedInstructions++;                           \
+    goto* dispatchTable.targets[opcode.op];               \
+  } while (false)
+#define REGOTH_DAEDALUS_RETURN() return
+
+      REGOTH_DAEDALUS_NEXT();
+
+#include "DaedalusOpcodes.inl"
+
+#undef REGOTH_DAEDALUS_OPCODE
+#undef REGOTH_DAEDALUS_SUPERINSTRUCTION
+#undef REGOTH_DAEDALUS_NEXT
+#undef REGOTH_DAEDALUS_RETURN
+
+    L_InvalidOpcode:
+      REGOTH_THROW(InvalidParametersException,
+                   "Unsupported or invalid opcode: " + bs::toString((int)opcode.op));
+#else
+      executeUntilReturnSwitch<isTracing>();
+#endif
+    }
 
-            (this->*it->second)();
+    template <bool isTracing>
+    bool DaedalusVM::executeInstructionAtPC()
+    {
+      // Copied, since executing a CALL might decode more instructions and invalidate references.
+      const DaedalusInstruction opcode = mInstructionMemory.instructionAt(mPC);
 
-            mCallDepth -= 1;
-            mPC = pc;
-            mClassVarResolver->setCurrentInstance(currentInstance);
-          }
-          else
-          {
-            auto& sym = mScriptSymbols.getSymbol<SymbolExternalFunction>(opcode.symbol);
-
-            // REGOTH_LOG(Info, Uncategorized, "[REGothDaedalusVM] External not implemented: " + sym.name);
-
-            // Put a dummy value onto the stack to get deterministic results
-            switch (sym.returnType)
-            {
-              case ReturnType::Int:
-                mStack.pushInt(0);
-                break;
-              case ReturnType::Float:
-                mStack.pushFloat(0.0f);
-                break;
-              case ReturnType::String:
-                mStack.pushString("");
-                break;
-              case ReturnType::Invalid:
-              case ReturnType::Void:
-                break;
-            }
-
-            // REGOTH_THROW(
-            //     NotImplementedException,
-            //     "External not implemented: " +
-            //     mScriptSymbols.getSymbolBase(opcode.symbol).name);
-          }
-        }
-        break;
+      mPC += opcode.size;
+      mNumExecutedInstructions++;
 
-          // Other
-          // -----------------------------------------------------------------------------------
+      switch (opcode.op)
+      {
+#define REGOTH_DAEDALUS_OPCODE(op) case Daedalus::op:
+#define REGOTH_DAEDALUS_SUPERINSTRUCTION(op) case op:
+#define REGOTH_DAEDALUS_NEXT() break
+#define REGOTH_DAEDALUS_RETURN() return false
 
-        case Daedalus::EParOp_SetInstance:
-        {
-          if (mIsDisassemblerEnabled)
-          {
-            disassembleAndLogOpcode(opcode);
-          }
+#include "DaedalusOpcodes.inl"
 
-          const SymbolInstance& instance = mScriptSymbols.getSymbol<SymbolInstance>(opcode.symbol);
-          mClassVarResolver->setCurrentInstance(instance.instance);
-        }
-        break;
+#undef REGOTH_DAEDALUS_OPCODE
+#undef REGOTH_DAEDALUS_SUPERINSTRUCTION
+#undef REGOTH_DAEDALUS_NEXT
+#undef REGOTH_DAEDALUS_RETURN
 
         default:
           REGOTH_THROW(InvalidParametersException,
-                       "Unsupported or invalid opcode: " + bs::toString(opcode.op));
+                       "Unsupported or invalid opcode: " + bs::toString((int)opcode.op));
           break;
       }
 
@@ -808,7 +885,28 @@ namespace REGoth
     {
       if (mStack.isTopOfIntStackVariable())
       {
-        return popIntReference();
+        DaedalusStack::StackVariableValue var = mStack.popIntVariable();
+
+        bs::INT32 value = intReference(var);
+
+        if (mRecordedReads)
+        {
+          DaedalusRecordedReads::IntRead read;
+          read.global     = (const bs::INT32*)var.global;
+          read.object     = SCRIPT_OBJECT_HANDLE_INVALID;
+          read.slot       = var.slot;
+          read.arrayIndex = var.arrayIndex;
+          read.value      = value;
+
+          if (!var.global)
+          {
+            read.object = (ScriptObjectHandle)mClassVarResolver->getCurrentInstance();
+          }
+
+          mRecordedReads->ints.push_back(read);
+        }
+
+        return value;
       }
       else
       {
@@ -824,18 +922,7 @@ namespace REGoth
       }
       else
       {
-        bs::INT32 asInt = popIntValue();
-
-        // TODO: Daedalus bytecode uses PushInt to push floats encoded as integers.
-        //       Since REGoth has it's own stack for floats, this is a problem!
-        //       We also cannot just scrap the float-stack and put everything onto
-        //       the integer stack instead, as that would not work with float-variables!
-        //       Maybe we should just scrap the notion of "float" alltogether and encode them as
-        //       integers all the time.
-        //
-        //       Luckily, floats are only rarely used. 
-        return *reinterpret_cast<float*>(&asInt);
-        //return mStack.popFloat();
+        return mStack.popFloat();
       }
     }
 
@@ -851,6 +938,18 @@ namespace REGoth
       }
     }
 
+    DaedalusStringHandle DaedalusVM::popStringHandle()
+    {
+      if (mStack.isTopOfStringStackVariable())
+      {
+        return mStringPool.intern(popStringReference());
+      }
+      else
+      {
+        return mStack.popStringHandle();
+      }
+    }
+
     ScriptObjectHandle DaedalusVM::popInstanceScriptObject()
     {
       SymbolIndex symbol   = mStack.popInstance();
@@ -861,176 +960,413 @@ namespace REGoth
         REGOTH_THROW(InvalidParametersException, "Instances cannot be classvars!");
       }
 
+      if (mRecordedReads)
+      {
+        mRecordedReads->instances.push_back({symbol, instance.instance});
+      }
+
       return instance.instance;
     }
 
+    /**
+     * @return The value at the given index. Throws if the index is out of range.
+     */
+    template <typename T>
+    static T& valueAt(const ScriptValuesRef<T>& values, bs::UINT32 arrayIndex)
+    {
+      if (arrayIndex >= values.size())
+      {
+        REGOTH_THROW(InvalidParametersException,
+                     bs::StringUtil::format("Array index out of range! (index: {0}, ArraySize: {1})",
+                                            arrayIndex, values.size()));
+      }
+
+      return values[arrayIndex];
+    }
+
+    /**
+     * @return The value of a global variable at the given index. Throws if the index
+     *         is out of range.
+     */
+    template <typename T>
+    static T& globalValueAt(const DaedalusResolvedVariable& var, bs::UINT32 arrayIndex)
+    {
+      return valueAt(ScriptValuesRef<T>{(T*)var.values, var.numValues}, arrayIndex);
+    }
+
     bs::INT32& DaedalusVM::popIntReference()
     {
+      markRecordedCodeAsNotCacheable();
+
       DaedalusStack::StackVariableValue var = mStack.popIntVariable();
 
-      SymbolBase& symbol = mScriptSymbols.getSymbolBase(var.symbol);
+      return intReference(var);
+    }
 
-      if (symbol.type == SymbolType::Int)
+    bs::INT32& DaedalusVM::intReference(const DaedalusStack::StackVariableValue& var)
+    {
+      if (var.global)
       {
-        if (symbol.isClassVar)
-        {
-          ScriptInts& ints = mClassVarResolver->resolveClassVariableInts(symbol.name);
+        return *(bs::INT32*)var.global;
+      }
 
-          if (var.arrayIndex >= ints.size())
-          {
-            REGOTH_THROW(
-                InvalidParametersException,
-                bs::StringUtil::format("Array index out of range! (index: {0}, ArraySize: {1})",
-                                       var.arrayIndex, ints.size()));
-          }
+      ScriptObject& object = mClassVarResolver->getCurrentInstanceObject();
 
-          return ints[var.arrayIndex];
-        }
-        else
-        {
-          SymbolInt& symbolInt = (SymbolInt&)symbol;
+      return valueAt(object.intSlot(var.slot), var.arrayIndex);
+    }
 
-          if (var.arrayIndex >= symbolInt.ints.size())
-          {
-            REGOTH_THROW(
-                InvalidParametersException,
-                bs::StringUtil::format("Array index out of range! (index: {0}, ArraySize: {1})",
-                                       var.arrayIndex, symbolInt.ints.size()));
-          }
+    bs::INT32& DaedalusVM::intReference(SymbolIndex symbol)
+    {
+      const DaedalusResolvedVariable& var = resolvedVariable(symbol);
 
-          return symbolInt.ints[var.arrayIndex];
-        }
-      }
-      else
+      switch (var.kind)
       {
-        REGOTH_THROW(InvalidStateException, "Popped variable is not an integer: " + symbol.name);
+        case DaedalusResolvedVariable::Kind::Int:
+          return globalValueAt<bs::INT32>(var, 0);
+
+        case DaedalusResolvedVariable::Kind::IntMember:
+          return valueAt(mClassVarResolver->getCurrentInstanceObject().intSlot(var.slot), 0);
+
+        default:
+          REGOTH_THROW(InvalidStateException, "Variable is not an integer: " +
+                                                  mScriptSymbols.getSymbolName(symbol));
       }
     }
 
-    float& DaedalusVM::popFloatReference()
+    bs::INT32 DaedalusVM::intValue(SymbolIndex symbol)
     {
-      DaedalusStack::StackVariableValue var = mStack.popFloatVariable();
+      bs::INT32 value = intReference(symbol);
 
-      SymbolBase& symbol = mScriptSymbols.getSymbolBase(var.symbol);
+      if (mRecordedReads)
+      {
+        const DaedalusResolvedVariable& var = resolvedVariable(symbol);
+        bool isGlobal = var.kind == DaedalusResolvedVariable::Kind::Int;
+
+        DaedalusRecordedReads::IntRead read;
+        read.global     = isGlobal ? (const bs::INT32*)var.values : nullptr;
+        read.object     = isGlobal ? SCRIPT_OBJECT_HANDLE_INVALID
+                                   : (ScriptObjectHandle)mClassVarResolver->getCurrentInstance();
+        read.slot       = var.slot;
+        read.arrayIndex = 0;
+        read.value      = value;
+
+        mRecordedReads->ints.push_back(read);
+      }
+
+      return value;
+    }
 
-      if (symbol.type == SymbolType::Float)
+    bool DaedalusVM::areRecordedReadsUnchanged(const DaedalusRecordedReads& reads)
+    {
+      for (const auto& read : reads.instances)
       {
-        if (symbol.isClassVar)
+        if (mScriptSymbols.getSymbol<SymbolInstance>(read.symbol).instance != read.object)
         {
-          ScriptFloats& floats = mClassVarResolver->resolveClassVariableFloats(symbol.name);
+          return false;
+        }
+      }
 
-          if (var.arrayIndex >= floats.size())
-          {
-            REGOTH_THROW(
-                InvalidParametersException,
-                bs::StringUtil::format("Array index out of range! (index: {0}, ArraySize: {1})",
-                                       var.arrayIndex, floats.size()));
-          }
+      for (const auto& read : reads.ints)
+      {
+        if (read.global)
+        {
+          if (*read.global != read.value) return false;
 
-          return floats[var.arrayIndex];
+          continue;
         }
-        else
-        {
-          SymbolFloat& symbolFloat = (SymbolFloat&)symbol;
 
-          if (var.arrayIndex >= symbolFloat.floats.size())
-          {
-            REGOTH_THROW(
-                InvalidParametersException,
-                bs::StringUtil::format("Array index out of range! (index: {0}, ArraySize: {1})",
-                                       var.arrayIndex, symbolFloat.floats.size()));
-          }
+        if (!mScriptObjects.isValid(read.object)) return false;
+
+        ScriptObject& object = mScriptObjects.get(read.object);
+
+        // The class has changed since the read, e.g. by reloading the scripts
+        if (object.layout().get() != read.slot.layout) return false;
+
+        ScriptIntsRef values = object.intSlot(read.slot);
 
-          return symbolFloat.floats[var.arrayIndex];
+        if (read.arrayIndex >= values.size() || values[read.arrayIndex] != read.value)
+        {
+          return false;
         }
       }
-      else
+
+      return true;
+    }
+
+    float& DaedalusVM::popFloatReference()
+    {
+      // Floats are not recorded, so reading them isn't cacheable either
+      markRecordedCodeAsNotCacheable();
+
+      DaedalusStack::StackVariableValue var = mStack.popFloatVariable();
+
+      if (var.global)
       {
-        REGOTH_THROW(InvalidStateException, "Popped variable is not an float: " + symbol.name);
+        return *(float*)var.global;
       }
+
+      ScriptObject& object = mClassVarResolver->getCurrentInstanceObject();
+
+      return valueAt(object.floatSlot(var.slot), var.arrayIndex);
     }
 
     bs::String& DaedalusVM::popStringReference()
     {
+      // Strings are not recorded, so reading them isn't cacheable either
+      markRecordedCodeAsNotCacheable();
+
       DaedalusStack::StackVariableValue var = mStack.popStringVariable();
 
-      SymbolBase& symbol = mScriptSymbols.getSymbolBase(var.symbol);
+      if (var.global)
+      {
+        return *(bs::String*)var.global;
+      }
+
+      ScriptObject& object = mClassVarResolver->getCurrentInstanceObject();
+
+      return valueAt(object.stringSlot(var.slot), var.arrayIndex);
+    }
+
+    void DaedalusVM::pushVariable(SymbolIndex symbolIndex, bs::UINT32 arrayIndex)
+    {
+      const DaedalusResolvedVariable& var = resolvedVariable(symbolIndex);
+
+      switch (var.kind)
+      {
+        case DaedalusResolvedVariable::Kind::Int:
+          mStack.pushIntVariable(globalValueAt<bs::INT32>(var, arrayIndex));
+          break;
+
+        case DaedalusResolvedVariable::Kind::Float:
+          mStack.pushFloatVariable(globalValueAt<float>(var, arrayIndex));
+          break;
+
+        case DaedalusResolvedVariable::Kind::String:
+          mStack.pushStringVariable(globalValueAt<bs::String>(var, arrayIndex));
+          break;
+
+        case DaedalusResolvedVariable::Kind::IntMember:
+          mStack.pushIntMemberVariable(var.slot, arrayIndex);
+          break;
+
+        case DaedalusResolvedVariable::Kind::FloatMember:
+          mStack.pushFloatMemberVariable(var.slot, arrayIndex);
+          break;
+
+        case DaedalusResolvedVariable::Kind::StringMember:
+          mStack.pushStringMemberVariable(var.slot, arrayIndex);
+          break;
+
+        case DaedalusResolvedVariable::Kind::Instance:
+          mStack.pushInstance(symbolIndex);
+          break;
+
+        case DaedalusResolvedVariable::Kind::Function:
+          mStack.pushFunction(symbolIndex);
+          break;
 
-      if (symbol.type == SymbolType::String)
+        case DaedalusResolvedVariable::Kind::InvalidMember:
+          REGOTH_THROW(InvalidParametersException,
+                       mScriptSymbols.getSymbolName(symbolIndex) + " is not a member variable.");
+
+        case DaedalusResolvedVariable::Kind::None:
+          break;
+      }
+    }
+
+    void DaedalusVM::resolveVariables()
+    {
+      using Kind = DaedalusResolvedVariable::Kind;
+
+      DaedalusResolvedVariable unresolved = {Kind::None, nullptr, 0,
+                                             {nullptr, MEMBER_SLOT_INVALID}};
+      mResolvedVariables.assign(mScriptSymbols.numSymbols(), unresolved);
+
+      for (SymbolIndex i = 0; i < (SymbolIndex)mResolvedVariables.size(); i++)
       {
+        SymbolBase& symbol            = mScriptSymbols.getSymbolBase(i);
+        DaedalusResolvedVariable& var = mResolvedVariables[i];
+
         if (symbol.isClassVar)
         {
-          ScriptStrings& strings = mClassVarResolver->resolveClassVariableStrings(symbol.name);
+          var.slot = mClassTemplates.getMemberSlot(i);
+        }
+
+        // Class variables are looked up in the *Current Instance* via their member slot
+        auto variableKind = [&](Kind global, Kind member) {
+          if (!symbol.isClassVar) return global;
 
-          if (var.arrayIndex >= strings.size())
+          return var.slot.isValid() ? member : Kind::InvalidMember;
+        };
+
+        switch (symbol.type)
+        {
+          case SymbolType::Int:
           {
-            REGOTH_THROW(
-                InvalidParametersException,
-                bs::StringUtil::format("Array index out of range! (index: {0}, ArraySize: {1})",
-                                       var.arrayIndex, strings.size()));
+            auto& ints    = ((SymbolInt&)symbol).ints;
+            var.kind      = variableKind(Kind::Int, Kind::IntMember);
+            var.values    = ints.data();
+            var.numValues = (bs::UINT32)ints.size();
           }
+          break;
 
-          return strings[var.arrayIndex];
-        }
-        else
-        {
-          SymbolString& symbolString = (SymbolString&)symbol;
+          case SymbolType::Float:
+          {
+            auto& floats  = ((SymbolFloat&)symbol).floats;
+            var.kind      = variableKind(Kind::Float, Kind::FloatMember);
+            var.values    = floats.data();
+            var.numValues = (bs::UINT32)floats.size();
+          }
+          break;
 
-          if (var.arrayIndex >= symbolString.strings.size())
+          case SymbolType::String:
           {
-            REGOTH_THROW(
-                InvalidParametersException,
-                bs::StringUtil::format("Array index out of range! (index: {0}, ArraySize: {1})",
-                                       var.arrayIndex, symbolString.strings.size()));
+            auto& strings = ((SymbolString&)symbol).strings;
+            var.kind      = variableKind(Kind::String, Kind::StringMember);
+            var.values    = strings.data();
+            var.numValues = (bs::UINT32)strings.size();
           }
+          break;
+
+          case SymbolType::Instance:
+            var.kind = Kind::Instance;
+            break;
+
+          case SymbolType::ScriptFunction:
+            var.kind = Kind::Function;
+            break;
 
-          return symbolString.strings[var.arrayIndex];
+          default:
+            break;
         }
       }
-      else
-      {
-        REGOTH_THROW(InvalidStateException, "Popped variable is not an string: " + symbol.name);
-      }
     }
 
-    void DaedalusVM::pushVariable(SymbolIndex symbolIndex, bs::UINT32 arrayIndex)
+    void DaedalusVM::throwSymbolNotResolved(SymbolIndex symbol) const
     {
-      SymbolBase& symbol = mScriptSymbols.getSymbolBase(symbolIndex);
+      REGOTH_THROW(InvalidParametersException,
+                   "Symbol " + bs::toString(symbol) + " does not exist or was not resolved yet");
+    }
 
-      if (symbol.type == SymbolType::Int)
-      {
-        mStack.pushIntVariable(symbolIndex, arrayIndex);
-      }
-      else if (symbol.type == SymbolType::Float)
+    void DaedalusVM::registerExternal(const bs::String& name, externalCallback callback)
+    {
+      SymbolIndex symbol = mScriptSymbols.findIndexBySymbolName(name);
+
+      if (mScriptSymbols.getSymbolType(symbol) != SymbolType::ExternalFunction)
       {
-        mStack.pushFloatVariable(symbolIndex, arrayIndex);
+        REGOTH_THROW(InvalidParametersException, "Symbol is not an external function: " + name);
       }
-      else if (symbol.type == SymbolType::String)
+
+      mExternals[symbol] = callback;
+
+      // Implemented externals might do anything, see markExternalAsCacheable()
+      mIsExternalCacheable[symbol] = false;
+    }
+
+    void DaedalusVM::markExternalAsBatchable(const bs::String& name)
+    {
+      SymbolIndex symbol = mScriptSymbols.findIndexBySymbolName(name);
+
+      if (mScriptSymbols.getSymbolType(symbol) != SymbolType::ExternalFunction)
       {
-        mStack.pushStringVariable(symbolIndex, arrayIndex);
+        REGOTH_THROW(InvalidParametersException, "Symbol is not an external function: " + name);
       }
-      else if (symbol.type == SymbolType::Instance)
+
+      mIsExternalBatchable[symbol] = true;
+    }
+
+    void DaedalusVM::markExternalAsCacheable(const bs::String& name)
+    {
+      SymbolIndex symbol = mScriptSymbols.findIndexBySymbolName(name);
+
+      if (mScriptSymbols.getSymbolType(symbol) != SymbolType::ExternalFunction)
       {
-        mStack.pushInstance(symbolIndex);
+        REGOTH_THROW(InvalidParametersException, "Symbol is not an external function: " + name);
       }
-      else if (symbol.type == SymbolType::ScriptFunction)
+
+      mIsExternalCacheable[symbol] = true;
+    }
+
+    void DaedalusVM::setupExternals()
+    {
+      mExternals.assign(mScriptSymbols.numSymbols(), &DaedalusVM::externalInvalid);
+      mIsExternalBatchable.assign(mScriptSymbols.numSymbols(), false);
+      mIsExternalCacheable.assign(mScriptSymbols.numSymbols(), false);
+      mIsNotImplementedLogged.assign(mScriptSymbols.numSymbols(), false);
+
+      for (SymbolIndex index : mScriptSymbols.symbolsOfType(SymbolType::ExternalFunction))
       {
-        mStack.pushFunction(symbolIndex);
+        // Not implemented externals always push the same dummy value
+        mIsExternalCacheable[index] = true;
+
+        switch (mScriptSymbols.getSymbol<SymbolExternalFunction>(index).returnType)
+        {
+          case ReturnType::Int:
+            mExternals[index] = &DaedalusVM::externalNotImplementedInt;
+            break;
+          case ReturnType::Float:
+            mExternals[index] = &DaedalusVM::externalNotImplementedFloat;
+            break;
+          case ReturnType::String:
+            mExternals[index] = &DaedalusVM::externalNotImplementedString;
+            break;
+          case ReturnType::Invalid:
+          case ReturnType::Void:
+            mExternals[index] = &DaedalusVM::externalNotImplementedVoid;
+            break;
+        }
       }
+
+      registerAllExternals();
     }
 
-    void DaedalusVM::registerExternal(const bs::String& name, externalCallback callback)
+    void DaedalusVM::externalNotImplementedInt()
     {
-      SymbolIndex symbol = mScriptSymbols.findIndexBySymbolName(name);
+      mStack.pushInt(0);
+    }
 
-      mExternals[symbol] = callback;
+    void DaedalusVM::externalNotImplementedFloat()
+    {
+      mStack.pushFloat(0.0f);
+    }
+
+    void DaedalusVM::externalNotImplementedString()
+    {
+      mStack.pushStringHandle(DAEDALUS_STRING_EMPTY);
+      mStringPool.addRef(DAEDALUS_STRING_EMPTY);
+    }
+
+    void DaedalusVM::externalNotImplementedVoid()
+    {
+    }
+
+    void DaedalusVM::externalInvalid()
+    {
+      REGOTH_THROW(InvalidStateException, "Called symbol is not an external function!");
+    }
+
+    void DaedalusVM::logIfExternalNotImplemented(SymbolIndex symbol)
+    {
+      externalCallback callback = mExternals[symbol];
+
+      bool isNotImplemented = callback == &DaedalusVM::externalNotImplementedInt ||
+                              callback == &DaedalusVM::externalNotImplementedFloat ||
+                              callback == &DaedalusVM::externalNotImplementedString ||
+                              callback == &DaedalusVM::externalNotImplementedVoid;
+
+      if (!isNotImplemented || mIsNotImplementedLogged[symbol]) return;
+
+      mIsNotImplementedLogged[symbol] = true;
+
+      REGOTH_LOG(Verbose, VM, "[DaedalusVM] Called external {0}, which is not implemented",
+                 mScriptSymbols.getSymbolBase(symbol).name);
     }
 
-    void DaedalusVM::disassembleAndLogOpcode(const Daedalus::PARStackOpCode& opcode,
+    void DaedalusVM::disassembleAndLogOpcode(const DaedalusInstruction& opcode,
                                              const bs::String& lhs, const bs::String& rhs,
                                              const bs::String& res)
     {
-      REGOTH_LOG(Info, Uncategorized,
+      REGOTH_LOG(Info, VM,
              bs::StringUtil::format("[DaedalusVM] Exec: {0}{1}", makeCallDepthString(mCallDepth),
                                     disassembleOpcode(opcode, mScriptSymbols, lhs, rhs, res)));
     }
@@ -1051,7 +1387,7 @@ namespace REGoth
         name = fnSymbol.name;
       }
 
-      REGOTH_LOG(Info, Uncategorized,
+      REGOTH_LOG(Info, VM,
              bs::StringUtil::format("[DaedalusVM] Exec: {0}Call {1}",
                                     makeCallDepthString(mCallDepth), name));
     }
@@ -1,14 +1,18 @@
 /**\file
  */
 #pragma once
+#include "DaedalusInstructionMemory.hpp"
+#include "DaedalusNativeModule.hpp"
+#include "DaedalusProfiler.hpp"
+#include "DaedalusProgram.hpp"
 #include "DaedalusStack.hpp"
 #include <BsPrerequisites.h>
 #include <scripting/ScriptVM.hpp>
+#include <scripting/SymbolRef.hpp>
 
 namespace Daedalus
 {
   class DATFile;
-  class PARStackOpCode;
 }  // namespace Daedalus
 
 namespace REGoth
@@ -17,12 +21,430 @@ namespace REGoth
   {
     class DATSymbolStorageLoader;
     class DaedalusClassVarResolver;
+
+    /**
+     * Different implementations of the loop which runs the instructions.
+     *
+     * Both execute the same opcode implementations found in `DaedalusOpcodes.inl`.
+     */
+    enum class DaedalusInterpreter
+    {
+      /**
+       * A plain `switch` inside a loop. This is the reference implementation.
+       */
+      Switch,
+
+      /**
+       * Direct threaded code using computed gotos, where every opcode jumps straight
+       * into the next one. Only available on GCC and Clang, falls back to `Switch` on
+       * other compilers.
+       */
+      Threaded,
+    };
+
+    /**
+     * State of a script function which called another script function, so it can be
+     * continued once the called function returns.
+     */
+    struct DaedalusCallFrame
+    {
+      /**
+       * Address of the instruction after the call.
+       */
+      bs::UINT32 returnAddress;
+
+      /**
+       * Current instance at the time of the call.
+       */
+      SymbolIndex savedInstance;
+
+      /**
+       * Whether the profiler has been told about the call.
+       */
+      bool isProfiled;
+    };
+
+    /**
+     * Handle of a script function running as fiber, see DaedalusVM::startFiber().
+     */
+    typedef bs::UINT32 DaedalusFiberHandle;
+
+    enum : DaedalusFiberHandle
+    {
+      DAEDALUS_FIBER_INVALID = 0
+    };
+
+    /**
+     * State of a suspended fiber, so it can be continued where it yielded.
+     */
+    struct DaedalusFiber
+    {
+      /**
+       * Address of the function the fiber has been started with, for the profiler.
+       */
+      bs::UINT32 function;
+
+      /**
+       * Address of the instruction after the external which yielded.
+       */
+      bs::UINT32 resumeAddress;
+
+      /**
+       * Current instance at the time of yielding.
+       */
+      SymbolIndex savedInstance;
+
+      /**
+       * Functions waiting for the one which yielded to return, see DaedalusVM::mCallFrames.
+       */
+      bs::Vector<DaedalusCallFrame> callFrames;
+    };
+
+    /**
+     * Where the VM finds the value of a variable symbol.
+     *
+     * Resolved once for every symbol after loading, so that pushing a variable onto the
+     * stack does not have to look at the symbol itself anymore. See
+     * DaedalusVM::resolveVariables().
+     */
+    struct DaedalusResolvedVariable
+    {
+      /**
+       * What to do when the symbol is pushed onto the stack.
+       */
+      enum class Kind : bs::UINT8
+      {
+        /**
+         * Symbol cannot be pushed, nothing happens.
+         */
+        None,
+
+        Int,
+        Float,
+        String,
+        IntMember,
+        FloatMember,
+        StringMember,
+        Instance,
+        Function,
+
+        /**
+         * Class variable without a member slot, throws when pushed.
+         */
+        InvalidMember,
+      };
+
+      Kind kind;
+
+      /**
+       * Global variables only: Values stored inside the symbol.
+       */
+      void* values;
+      bs::UINT32 numValues;
+
+      /**
+       * Class variables only: Slot of the member, see ScriptClassTemplates::getMemberSlot().
+       */
+      MemberSlot slot;
+    };
+
+    /**
+     * Everything some script code has read from variables and instance symbols while it was
+     * running, recorded by the VM. As long as none of these values changed, running the code
+     * again would give the same result, if it is cacheable. See DaedalusVM::setRecordedReads().
+     *
+     * Only int variables are recorded, since that is what conditions look at. Code which reads
+     * anything else, writes to any variable or calls an external not marked as cacheable
+     * will not be cacheable.
+     */
+    struct DaedalusRecordedReads
+    {
+      /**
+       * A single int variable which has been read.
+       */
+      struct IntRead
+      {
+        /**
+         * Value of a global variable. nullptr, if this is a class variable.
+         */
+        const bs::INT32* global;
+
+        /**
+         * Class variables only: Object it was read from, the slot of the member and the
+         * index into its values.
+         */
+        ScriptObjectHandle object;
+        MemberSlot slot;
+        bs::UINT32 arrayIndex;
+
+        bs::INT32 value;
+      };
+
+      /**
+       * An instance symbol which has been read, with the object it referred to.
+       */
+      struct InstanceRead
+      {
+        SymbolIndex symbol;
+        ScriptObjectHandle object;
+      };
+
+      bs::Vector<IntRead> ints;
+      bs::Vector<InstanceRead> instances;
+
+      /**
+       * Whether the code only read things which are recorded here, see DaedalusRecordedReads.
+       */
+      bool isCacheable = true;
+    };
+
     class DaedalusVM : public ScriptVM
     {
     public:
-      DaedalusVM(const bs::Vector<bs::UINT8>& datFileData);
+      /**
+       * @param  program  DAT-file to run, see DaedalusProgram::share().
+       */
+      DaedalusVM(bs::SPtr<const DaedalusProgram> program);
+
+      void initialize() override;
+
+      /**
+       * Also marks the object of the *Current Instance*, see ScriptVM::markScriptObjectRoots().
+       */
+      void markScriptObjectRoots(ScriptObjectCollector& collector) const override;
+
+      /**
+       * Replaces the scripts with the given DAT-file while the game keeps running, so changed
+       * scripts can be tried out without restarting the engine and loading the world again.
+       *
+       * The bytecode and symbols are taken from the new file and the externals are looked
+       * up again by name. What the world has done so far is kept:
+       *
+       *  - Script objects keep their values by member name, see ScriptObject::unbindLayout().
+       *    Members pointing to functions are pointed to the function of the same name.
+       *  - Global variables and instance symbols keep their values if the new scripts still
+       *    have them with the same type. Constants come from the new scripts.
+       *
+       * Instance constructors are not run again, so objects which already exist don't pick up
+       * changes to them.
+       *
+       * Throws if script code is being executed right now.
+       *
+       * @param  program  The new DAT-file, see the constructor.
+       */
+      void reloadDAT(bs::SPtr<const DaedalusProgram> program);
+
+      /**
+       * The DAT-file being run, possibly shared with other VMs.
+       */
+      const bs::SPtr<const DaedalusProgram>& program() const
+      {
+        return mProgram;
+      }
+
+      /**
+       * Sets which interpreter loop shall be used to execute script functions.
+       *
+       * The default depends on the `REGOTH_DAEDALUS_THREADED_DISPATCH` build option.
+       */
+      void setInterpreter(DaedalusInterpreter interpreter)
+      {
+        mInterpreter = interpreter;
+      }
+
+      /**
+       * @return The interpreter loop used to execute script functions.
+       */
+      DaedalusInterpreter interpreter() const
+      {
+        return mInterpreter;
+      }
+
+      /**
+       * Enables or disables the tracing VM.
+       *
+       * When enabled, every called function is checked against the lists of functions
+       * to disassemble and instructions are run through a separate instantiation of the
+       * interpreter which logs them. When disabled, the instantiation without any
+       * disassembler hooks is used and no per-call lookups are done.
+       *
+       * Enabled by default in builds with assertions turned on.
+       */
+      void setTracingEnabled(bool enabled)
+      {
+        mIsTracingEnabled = enabled;
+      }
+
+      /**
+       * @return Whether the tracing VM is used, see setTracingEnabled().
+       */
+      bool isTracingEnabled() const
+      {
+        return mIsTracingEnabled;
+      }
+
+      /**
+       * Sets whether common sequences of instructions should be fused into
+       * superinstructions, see DaedalusSuperinstruction. Enabled by default.
+       *
+       * This decodes all instructions again, so it must not be called while
+       * script code is being executed.
+       */
+      void setSuperinstructionsEnabled(bool enabled);
+
+      /**
+       * @return Whether superinstructions are used, see setSuperinstructionsEnabled().
+       */
+      bool isSuperinstructionsEnabled() const
+      {
+        return mIsSuperinstructionsEnabled;
+      }
+
+      /**
+       * Sets whether the bytecode should be optimized for the values of constants, see
+       * DaedalusInstructionMemory::foldConstants(). Enabled by default.
+       *
+       * This decodes all instructions again, so it must not be called while
+       * script code is being executed.
+       */
+      void setConstantFoldingEnabled(bool enabled);
+
+      /**
+       * @return Whether constants are folded, see setConstantFoldingEnabled().
+       */
+      bool isConstantFoldingEnabled() const
+      {
+        return mIsConstantFoldingEnabled;
+      }
+
+      /**
+       * Cross-checks constant folding against the interpreter: For every instruction
+       * DaedalusInstructionMemory::foldConstants() would replace, the original instructions
+       * are run one by one and the value they leave on the stack, or where they jump to, is
+       * compared to what the folded instruction does. The replaced instructions only read
+       * constants, so running them doesn't have any side effects.
+       *
+       * Works on a separate copy of the bytecode, so it doesn't matter whether constant folding
+       * is enabled. Must not be called while script code is being executed.
+       *
+       * Throws if any result differs, after logging all of them.
+       *
+       * @return Number of replaced instructions checked.
+       */
+      bs::UINT32 verifyConstantFolding();
+
+      /**
+       * Sets whether script functions should run as native code, if a native module has been
+       * loaded for the DAT-file, see DaedalusNativeModules. Enabled by default. Native code is
+       * never used while the tracing VM is enabled, see setTracingEnabled().
+       */
+      void setNativeCodeEnabled(bool enabled)
+      {
+        mIsNativeCodeEnabled = enabled;
+      }
+
+      /**
+       * @return Whether script functions run as native code, see setNativeCodeEnabled().
+       */
+      bool isRunningNativeCode() const
+      {
+        return mNativeModule && mIsNativeCodeEnabled && !mIsTracingEnabled;
+      }
+
+      /**
+       * Runs a script function as fiber, which may be suspended by an external and resumed
+       * later on, e.g. once the messages queued by `AI_`-externals are done. Code waiting
+       * for something doesn't need to be polled every frame that way.
+       *
+       * Suspending is only possible at calls of externals implemented using yieldFiber(),
+       * issued by the code of the fiber itself or the script functions called from there.
+       * Script functions called by the engine from within an external are never part of
+       * the fiber.
+       *
+       * As with every script function, parameters and locals live inside their symbols, so
+       * running the same function again while the fiber is suspended overwrites them.
+       *
+       * Fibers are always run by the interpreter without tracing, see setTracingEnabled().
+       * Suspended fibers are neither part of snapshots nor do they survive reloadDAT().
+       *
+       * @param  address  Bytecode address of the function to run.
+       *
+       * @return Handle to resume the fiber with, if it has been suspended.
+       *         DAEDALUS_FIBER_INVALID, if the function has already returned.
+       */
+      DaedalusFiberHandle startFiber(bs::UINT32 address);
+
+      /**
+       * Continues a suspended fiber until it returns or is suspended again.
+       *
+       * @return Whether the fiber has been suspended again. Resuming a fiber which is not
+       *         suspended, e.g. because it has been cancelled, does nothing and returns false.
+       */
+      bool resumeFiber(DaedalusFiberHandle fiber);
+
+      /**
+       * Throws away a suspended fiber, it will never be continued.
+       */
+      void cancelFiber(DaedalusFiberHandle fiber);
+
+      /**
+       * @return Whether the given fiber has been suspended and waits to be resumed.
+       */
+      bool isFiberSuspended(DaedalusFiberHandle fiber) const
+      {
+        return mSuspendedFibers.find(fiber) != mSuspendedFibers.end();
+      }
+
+      /**
+       * @return Number of fibers waiting to be resumed.
+       */
+      bs::UINT32 numSuspendedFibers() const
+      {
+        return (bs::UINT32)mSuspendedFibers.size();
+      }
+
+      /**
+       * Turns the profiler on or off. Turning it off throws away everything recorded.
+       *
+       * See DaedalusProfiler. While turned off, it doesn't cost more than a check
+       * on every call.
+       */
+      void setProfilingEnabled(bool enabled);
+
+      /**
+       * @return The profiler, if profiling is enabled. Otherwise nullptr.
+       */
+      DaedalusProfiler* profiler() const
+      {
+        return mProfiler.get();
+      }
+
+      /**
+       * @return Number of instructions executed since the VM was created.
+       */
+      bs::UINT64 numExecutedInstructions() const
+      {
+        return mNumExecutedInstructions;
+      }
+
+      /**
+       * @return Counters of the string pool from the last frame, telling how many
+       *         string copies could be avoided by interning them.
+       */
+      const DaedalusStringPoolStats& stringPoolStats() const
+      {
+        return mStringPool.lastFrameStats();
+      }
 
     protected:
+      /**
+       * @return Bytecode of the DAT-file, decoded into instructions. Decodes more on demand.
+       */
+      DaedalusInstructionMemory& instructionMemory()
+      {
+        return mInstructionMemory;
+      }
+
       /**
        * Executes a script function until it hits its return.
        *
@@ -31,6 +453,7 @@ namespace REGoth
        * @param  name  Name of the script function to execute.
        */
       void executeScriptFunction(const bs::String& name);
+      void executeScriptFunction(const SymbolRef& function);
 
       /**
        * Executs a script function until it hits its return.
@@ -47,16 +470,71 @@ namespace REGoth
        * @note If this encounteres a CALL-instruction, it will execute the
        *       whole sub-function.
        *
+       * @tparam  isTracing  Whether to log the instruction using the disassembler.
+       *
        * @return Whether the script function is not over yet. If this returns
        *         `false` then a Return-statement has been executed.
        */
+      template <bool isTracing>
       bool executeInstructionAtPC();
 
       /**
        * Runs from the current PC until the function it is in returned.
+       *
+       * Script functions called from there are run within the same interpreter loop,
+       * see mCallFrames. Only calls coming from the outside, like from an external,
+       * end up here again.
        */
       void executeUntilReturn();
 
+      /**
+       * Implementations of executeUntilReturn() for the different interpreter loops.
+       * See DaedalusInterpreter.
+       *
+       * @tparam  isTracing  Whether to log every instruction using the disassembler. Since this
+       *                     is known at compile time, the version without tracing does
+       *                     not contain any of the disassembler hooks.
+       */
+      template <bool isTracing>
+      void executeUntilReturnSwitch();
+      template <bool isTracing>
+      void executeUntilReturnThreaded();
+
+      /**
+       * Runs the selected interpreter loop from the current PC until the function returns.
+       */
+      template <bool isTracing>
+      void runInterpreterUntilReturn();
+
+      /**
+       * Checks whether the disassembler should be turned on for the function at the current PC
+       * and runs it with the tracing interpreter, if so.
+       */
+      void executeUntilReturnWithTracing();
+
+      /**
+       * To be called by an external: Suspends the fiber which called it as soon as the external
+       * returns. The fiber is to be resumed by whatever the external is waiting for.
+       *
+       * Throws if the external has not been called by a fiber, see canYieldFiber().
+       *
+       * @return Handle of the fiber, to resume it with.
+       */
+      DaedalusFiberHandle yieldFiber();
+
+      /**
+       * @return Whether the external being run has been called by a fiber, so it can yield.
+       */
+      bool canYieldFiber() const
+      {
+        return mRunningFiber != DAEDALUS_FIBER_INVALID && !mIsYieldRequested;
+      }
+
+      /**
+       * Throws away all suspended fibers, e.g. because the bytecode they were in is gone.
+       */
+      void cancelAllFibers();
+
       /**
        * Looks up the instruction memory at the given address and returns
        * the byte at that location.
@@ -70,6 +548,47 @@ namespace REGoth
       bs::UINT8 instructionMemoryAt(bs::UINT32 address);
 
       void fillSymbolStorage() override;
+      bs::UINT64 snapshotSourceHash() const override;
+      void onRestoredFromSnapshot() override;
+
+      /**
+       * Called by reloadDAT() while the old symbols are still in place, e.g. to remember state
+       * which refers to them by index.
+       */
+      virtual void onBeforeDATReload()
+      {
+      }
+
+      /**
+       * Called by reloadDAT() once everything has been switched over to the new scripts.
+       */
+      virtual void onDATReloaded()
+      {
+      }
+
+      /**
+       * Copies the values of global variables and instance symbols from the given symbols into
+       * those of the same name, see reloadDAT().
+       */
+      void carryOverVariables(const ScriptSymbolStorage& oldSymbols);
+
+      /**
+       * Decodes all bytecode from the DAT-file into the instruction memory. Also looks up the
+       * native module compiled from the DAT-file, see DaedalusNativeModules.
+       */
+      void decodeInstructions();
+
+      /**
+       * See DaedalusInstructionMemory::isConstructorFreeOfSideEffects(). Also false if there is
+       * no code at the given address.
+       */
+      bool isConstructorFreeOfSideEffects(bs::UINT32 address);
+
+      /**
+       * Puts all constant strings from the DAT-file into the string pool, so pushing them
+       * onto the stack won't have to allocate.
+       */
+      void pinConstantStrings();
 
       /**
        * Pops an value from the stack. Also resolves variables.
@@ -80,7 +599,13 @@ namespace REGoth
       ScriptObjectHandle popInstanceScriptObject();
 
       /**
-       * Pops a reference to an variable stored inside a script symbol.
+       * Like popStringValue(), but returns the string as handle into the string pool.
+       * The caller has to release the handle.
+       */
+      DaedalusStringHandle popStringHandle();
+
+      /**
+       * Pops a reference to an variable stored inside a script symbol, to write to it.
        *
        * Throws if the value on the stack is not a variable.
        */
@@ -88,6 +613,89 @@ namespace REGoth
       float& popFloatReference();
       bs::String& popStringReference();
 
+      /**
+       * Looks up the storage of the given int variable, like popIntReference() does for the
+       * variable on top of the stack.
+       */
+      bs::INT32& intReference(const DaedalusStack::StackVariableValue& var);
+
+      /**
+       * Looks up the storage of the first value of the given int variable symbol, to write to
+       * it. See intValue() for reading it.
+       *
+       * Throws if the symbol is not an int variable.
+       */
+      bs::INT32& intReference(SymbolIndex symbol);
+
+      /**
+       * Resolves where the values of all variable symbols are stored, see
+       * DaedalusResolvedVariable. Needs the class templates to be created already.
+       *
+       * Must be done again if the symbols were replaced, since the values of global
+       * variables are referenced directly.
+       */
+      void resolveVariables();
+
+      /**
+       * @return How the given symbol is pushed onto the stack. Throws if the symbol
+       *         does not exist.
+       */
+      const DaedalusResolvedVariable& resolvedVariable(SymbolIndex symbol) const
+      {
+        if (symbol >= mResolvedVariables.size())
+        {
+          throwSymbolNotResolved(symbol);
+        }
+
+        return mResolvedVariables[symbol];
+      }
+
+      void throwSymbolNotResolved(SymbolIndex symbol) const;
+
+      /**
+       * Like intReference(), but for reading the value: Records the read if reads are recorded
+       * right now, see setRecordedReads().
+       */
+      bs::INT32 intValue(SymbolIndex symbol);
+
+      /**
+       * Starts to record every read into the given object, until this is called with nullptr.
+       * Code executed while recording is marked as not cacheable if it does anything which
+       * cannot be recorded, see DaedalusRecordedReads.
+       *
+       * Recording costs a check per variable access while it is off.
+       */
+      void setRecordedReads(DaedalusRecordedReads* reads)
+      {
+        mRecordedReads = reads;
+      }
+
+      /**
+       * @return Whether reads are being recorded, see setRecordedReads().
+       */
+      bool isRecordingReads() const
+      {
+        return mRecordedReads != nullptr;
+      }
+
+      /**
+       * Marks the code currently recorded as not cacheable, e.g. from an external which has
+       * side effects. Does nothing if nothing is recorded.
+       */
+      void markRecordedCodeAsNotCacheable()
+      {
+        if (mRecordedReads)
+        {
+          mRecordedReads->isCacheable = false;
+        }
+      }
+
+      /**
+       * @return Whether all variables and instance symbols in the given recording still have
+       *         the values they had when they were read.
+       */
+      bool areRecordedReadsUnchanged(const DaedalusRecordedReads& reads);
+
       /**
        * Pushes the given variable onto the stack.
        *
@@ -106,6 +714,13 @@ namespace REGoth
        */
       virtual void registerAllExternals(){};
 
+      /**
+       * Builds the table of external functions: Every external gets its default
+       * implementation first, then registerAllExternals() is called to fill in the
+       * implemented ones.
+       */
+      void setupExternals();
+
       /**
        * Callback type for a script external function.
        */
@@ -120,16 +735,146 @@ namespace REGoth
        */
       void registerExternal(const bs::String& name, externalCallback callback);
 
+      /**
+       * Default implementations for externals which are not implemented. These
+       * put a dummy value of the right type onto the stack to get deterministic results.
+       */
+      void externalNotImplementedInt();
+      void externalNotImplementedFloat();
+      void externalNotImplementedString();
+      void externalNotImplementedVoid();
+
+      /**
+       * Put into the table of externals for all symbols which are not external functions.
+       */
+      void externalInvalid();
+
+      /**
+       * Logs the first call of the given external, if it's one of the not implemented ones.
+       * Only called if verbose messages of the VM are compiled in, see REGOTH_LOG_IS_COMPILED().
+       */
+      void logIfExternalNotImplemented(SymbolIndex symbol);
+
+      /**
+       * Marks the given external as one whose work can be collected and done later, see
+       * flushBatchedExternals(). To be called from registerAllExternals().
+       *
+       * @param  name  Name of the external function, UPPERCASE.
+       */
+      void markExternalAsBatchable(const bs::String& name);
+
+      /**
+       * Does the work collected by batchable externals. Called right before any external
+       * which is not batchable runs, if mHasBatchedExternals is set, so no script can
+       * observe that the work has been put off. Implementations must clear
+       * mHasBatchedExternals.
+       */
+      virtual void flushBatchedExternals()
+      {
+        mHasBatchedExternals = false;
+      }
+
+      /**
+       * To be set by batchable externals which have collected work, see
+       * flushBatchedExternals().
+       */
+      bool mHasBatchedExternals = false;
+
+      /**
+       * Marks the given external as one which can be called from cacheable code, see
+       * DaedalusRecordedReads. Its result must only depend on its arguments, or the external
+       * has to record what else it depends on itself. Externals which are not implemented
+       * are cacheable, since they always return the same. To be called from
+       * registerAllExternals().
+       *
+       * @param  name  Name of the external function, UPPERCASE.
+       */
+      void markExternalAsCacheable(const bs::String& name);
+
     protected:
       bs::SPtr<DaedalusClassVarResolver> mClassVarResolver;
-      DaedalusStack mStack;
+      DaedalusStringPool mStringPool;
+      DaedalusStack mStack{mStringPool};
 
       /**
        * If true, every executed instruction will be logged to the console.
+       * Only used while tracing is enabled, see setTracingEnabled().
        */
       bool mIsDisassemblerEnabled = false;
 
+      /**
+       * Whether the tracing VM is used, see setTracingEnabled().
+       */
+#ifdef REGOTH_ENABLE_ASSERTIONS
+      bool mIsTracingEnabled = true;
+#else
+      bool mIsTracingEnabled = false;
+#endif
+
     private:
+      friend class DaedalusNativeContext;
+
+      /**
+       * Counts a call which runs on the native stack, like an external, into the call depth.
+       * Once the call is left, also by an exception, the call depth, the program counter and
+       * the *Current Instance* are back to what they were before.
+       */
+      class NestedCallScope
+      {
+      public:
+        NestedCallScope(DaedalusVM& vm)
+            : mVM(vm)
+            , mPC(vm.mPC)
+            , mCurrentInstance(vm.mClassVarResolver->getCurrentInstance())
+        {
+          mVM.mCallDepth += 1;
+        }
+
+        ~NestedCallScope()
+        {
+          mVM.mCallDepth -= 1;
+          mVM.mPC = mPC;
+          mVM.mClassVarResolver->setCurrentInstance(mCurrentInstance);
+        }
+
+        NestedCallScope(const NestedCallScope&) = delete;
+        NestedCallScope& operator=(const NestedCallScope&) = delete;
+
+      private:
+        DaedalusVM& mVM;
+        bs::UINT32 mPC;
+        SymbolIndex mCurrentInstance;
+      };
+
+      /**
+       * @return Native code of the script function at the given address, if native code is
+       *         to be run, see isRunningNativeCode(). Otherwise nullptr.
+       */
+      DaedalusNativeFunction nativeFunctionAt(bs::UINT32 address) const
+      {
+        return isRunningNativeCode() ? mNativeModule->functionAt(address) : nullptr;
+      }
+
+      /**
+       * Calls a script function from native code, like the `Call` instruction does. Runs its
+       * native code, if there is any, otherwise the interpreter.
+       */
+      void callFromNativeCode(bs::UINT32 address);
+
+      /**
+       * Runs a single instruction from native code, see DaedalusNativeContext::run(). The
+       * specializations for every opcode are found in `DaedalusNativeContext.hpp`.
+       */
+      template <bs::UINT8 op>
+      void executeNativeOpcode(const DaedalusInstruction& opcode);
+
+      /**
+       * Runs the given fiber from where it left off, see startFiber() and resumeFiber().
+       *
+       * @return Whether the fiber has been suspended, see yieldFiber().
+       */
+      bool runFiber(DaedalusFiberHandle handle, const DaedalusFiber& fiber);
+
       /**
        * Whether the disassembler should be turned on for the given function.
        */
@@ -143,7 +888,7 @@ namespace REGoth
       /**
        * Disassembles and logs the given opcode in respect ti the call-depth.
        */
-      void disassembleAndLogOpcode(const Daedalus::PARStackOpCode& opcode,
+      void disassembleAndLogOpcode(const DaedalusInstruction& opcode,
                                    const bs::String& lhs = "", const bs::String& rhs = "",
                                    const bs::String& res = "");
 
@@ -162,12 +907,123 @@ namespace REGoth
        */
       bs::INT32 mCallDepth = 0;
 
-      bs::SPtr<Daedalus::DATFile> mDatFile;
+      /**
+       * Functions waiting for a called script function to return. Script-to-script calls
+       * push a frame here instead of recursing on the native stack.
+       */
+      bs::Vector<DaedalusCallFrame> mCallFrames;
+
+      /**
+       * Number of frames inside mCallFrames which belong to outer calls of
+       * executeUntilReturn(). Once a Return-instruction is hit with no frames above that,
+       * the function executeUntilReturn() was called for has returned.
+       */
+      bs::UINT32 mCallFramesBase = 0;
+
+      /**
+       * Fiber whose code is being run by the innermost interpreter loop. DAEDALUS_FIBER_INVALID
+       * while running anything else, like a script function called from within an external.
+       */
+      DaedalusFiberHandle mRunningFiber = DAEDALUS_FIBER_INVALID;
+
+      /**
+       * Set by yieldFiber(), makes the `CallExternal`-instruction leave the interpreter loop.
+       */
+      bool mIsYieldRequested = false;
+
+      /**
+       * Fibers waiting to be resumed, see startFiber().
+       */
+      bs::UnorderedMap<DaedalusFiberHandle, DaedalusFiber> mSuspendedFibers;
+
+      /**
+       * Handle given to the next fiber started.
+       */
+      DaedalusFiberHandle mNextFiberHandle = 1;
+
+      /**
+       * Counts every executed instruction, for the profiler.
+       */
+      bs::UINT64 mNumExecutedInstructions = 0;
+
+      /**
+       * See setProfilingEnabled(). nullptr, if profiling is turned off.
+       */
+      bs::SPtr<DaedalusProfiler> mProfiler;
+
+      /**
+       * See setSuperinstructionsEnabled().
+       */
+      bool mIsSuperinstructionsEnabled = true;
+
+      /**
+       * See setConstantFoldingEnabled().
+       */
+      bool mIsConstantFoldingEnabled = true;
+
+      /**
+       * See setNativeCodeEnabled().
+       */
+      bool mIsNativeCodeEnabled = true;
 
-      // The whole DAT-file, for serialization
-      bs::Vector<bs::UINT8> mDatFileData;
+      /**
+       * Native code compiled from the DAT-file, if loaded. See decodeInstructions().
+       */
+      bs::SPtr<const DaedalusNativeModule> mNativeModule;
 
-      bs::Map<SymbolIndex, externalCallback> mExternals;
+      /**
+       * The DAT-file being run. Shared with all other VMs running the same one, everything
+       * specific to this VM is kept in here instead.
+       */
+      bs::SPtr<const DaedalusProgram> mProgram;
+
+      /**
+       * Bytecode of the DAT-file, already decoded into instructions.
+       */
+      DaedalusInstructionMemory mInstructionMemory;
+
+      /**
+       * Implementation of every external function, indexed by the symbol of the
+       * external. Contains an entry for every symbol, see setupExternals().
+       */
+      bs::Vector<externalCallback> mExternals;
+
+      /**
+       * Whether the external of a symbol is batchable, indexed by symbol, see
+       * markExternalAsBatchable().
+       */
+      bs::Vector<bool> mIsExternalBatchable;
+
+      /**
+       * Whether the external of a symbol is cacheable, indexed by symbol, see
+       * markExternalAsCacheable().
+       */
+      bs::Vector<bool> mIsExternalCacheable;
+
+      /**
+       * Whether the first call of a not implemented external has been logged, indexed by
+       * symbol, see logIfExternalNotImplemented().
+       */
+      bs::Vector<bool> mIsNotImplementedLogged;
+
+      /**
+       * Where reads are recorded to, see setRecordedReads(). nullptr if nothing is recorded.
+       */
+      DaedalusRecordedReads* mRecordedReads = nullptr;
+
+      /**
+       * Where to find the values of every symbol, indexed by symbol. See resolveVariables().
+       */
+      bs::Vector<DaedalusResolvedVariable> mResolvedVariables;
+
+      /**
+       * Interpreter loop used to execute script functions.
+       */
+#if REGOTH_DAEDALUS_THREADED_DISPATCH
+      DaedalusInterpreter mInterpreter = DaedalusInterpreter::Threaded;
+#else
+      DaedalusInterpreter mInterpreter = DaedalusInterpreter::Switch;
+#endif
 
     public:
       // Remember, this is abstract, so don't create an rttiCreateEmpty()
@@ -0,0 +1,206 @@
+#include "AmbientSoundVoices.hpp"
+#include <Audio/BsAudioClip.h>
+#include <Components/BsCAudioSource.h>
+#include <Scene/BsSceneObject.h>
+#include <Utility/BsTime.h>
+#include <components/AmbientSound.hpp>
+#include <original-content/SoundStreaming.hpp>
+#include <algorithm>
+#include <cmath>
+
+namespace REGoth
+{
+  constexpr bs::UINT32 AmbientSoundVoices::MAX_VOICES;
+  constexpr float AmbientSoundVoices::CHECK_INTERVAL;
+
+  /**
+   * Part of the radius of a sound within which it is at full volume.
+   */
+  static constexpr float FULL_VOLUME_RADIUS_FACTOR = 0.25f;
+
+  void AmbientSoundVoices::reset()
+  {
+    for (ManagedSound& managed : mSounds)
+    {
+      virtualize(managed);
+    }
+
+    mSounds.clear();
+    mCandidates.clear();
+
+    mTimeUntilCheck = 0.0f;
+    mStats          = {};
+  }
+
+  void AmbientSoundVoices::addSound(HAmbientSound sound)
+  {
+    float now = bs::gTime().getTime();
+
+    ManagedSound managed;
+    managed.sound        = sound;
+    managed.soundFile    = sound->soundFile();
+    managed.startTime    = now;
+    managed.nextPlayTime = now + randomDelayOf(*sound);
+
+    mSounds.push_back(managed);
+
+    mStats.numSounds = (bs::UINT32)mSounds.size();
+
+    // The new sound might be closer than those voiced right now
+    mTimeUntilCheck = 0.0f;
+  }
+
+  void AmbientSoundVoices::update(const bs::Vector3& listenerPosition)
+  {
+    float now        = bs::gTime().getTime();
+    float timePassed = mLastUpdateTime < 0.0f ? 0.0f : now - mLastUpdateTime;
+    mLastUpdateTime  = now;
+
+    mTimeUntilCheck -= timePassed;
+
+    if (mTimeUntilCheck > 0.0f) return;
+
+    mTimeUntilCheck = CHECK_INTERVAL;
+
+    mCandidates.clear();
+
+    for (bs::UINT32 i = 0; i < (bs::UINT32)mSounds.size(); i++)
+    {
+      ManagedSound& managed = mSounds[i];
+
+      if (managed.sound.isDestroyed())
+      {
+        virtualize(managed);
+        continue;
+      }
+
+      float radius   = std::max(managed.sound->radius(), 0.01f);
+      float distance = managed.sound->SO()->getTransform().pos().distance(listenerPosition);
+
+      if (distance > radius)
+      {
+        virtualize(managed);
+        continue;
+      }
+
+      managed.relativeDistance = distance / radius;
+      mCandidates.push_back(i);
+    }
+
+    auto isCloser = [&](bs::UINT32 a, bs::UINT32 b) {
+      return mSounds[a].relativeDistance < mSounds[b].relativeDistance;
+    };
+
+    size_t numVoiced = std::min<size_t>(mCandidates.size(), MAX_VOICES);
+
+    std::nth_element(mCandidates.begin(), mCandidates.begin() + numVoiced, mCandidates.end(),
+                     isCloser);
+
+    for (size_t i = 0; i < mCandidates.size(); i++)
+    {
+      ManagedSound& managed = mSounds[mCandidates[i]];
+
+      if (i < numVoiced)
+      {
+        voice(managed, now);
+        playRandomSound(managed, now);
+      }
+      else
+      {
+        virtualize(managed);
+      }
+    }
+
+    mStats.numSounds       = (bs::UINT32)mSounds.size();
+    mStats.numVoicedSounds = (bs::UINT32)numVoiced;
+  }
+
+  void AmbientSoundVoices::voice(ManagedSound& managed, float now)
+  {
+    if (managed.isVoiced) return;
+
+    const AmbientSound& sound = *managed.sound;
+
+    if (sound.mode() == AmbientSound::Mode::Once && managed.hasPlayed) return;
+
+    bs::HAudioClip clip = gSoundStreaming().acquire(managed.soundFile);
+
+    if (!clip) return;
+
+    managed.isVoiced = true;
+
+    // Not saved, reset() starts over with all sounds being virtual
+    bs::HSceneObject voiceSO = bs::SceneObject::create(managed.sound->SO()->getName() + ".voice",
+                                                       bs::SOF_DontSave);
+    voiceSO->setParent(managed.sound->SO(), false);
+
+    managed.source = voiceSO->addComponent<bs::CAudioSource>();
+    managed.source->setClip(clip);
+    managed.source->setVolume(sound.volume());
+    managed.source->setMinDistance(sound.radius() * FULL_VOLUME_RADIUS_FACTOR);
+
+    switch (sound.mode())
+    {
+      case AmbientSound::Mode::Loop:
+      {
+        float length = clip->getLength();
+
+        managed.source->setIsLooping(true);
+        managed.source->play();
+
+        // Continue where the sound would be if it had been playing all along
+        if (length > 0.0f)
+        {
+          managed.source->setTime(std::fmod(now - managed.startTime, length));
+        }
+        break;
+      }
+
+      case AmbientSound::Mode::Once:
+        managed.source->play();
+        managed.hasPlayed = true;
+        break;
+
+      case AmbientSound::Mode::Random:
+        // See playRandomSound()
+        break;
+    }
+  }
+
+  void AmbientSoundVoices::virtualize(ManagedSound& managed)
+  {
+    if (!managed.isVoiced) return;
+
+    if (!managed.source.isDestroyed())
+    {
+      managed.source->stop();
+      managed.source->SO()->destroy();
+    }
+
+    managed.source   = {};
+    managed.isVoiced = false;
+
+    gSoundStreaming().release(managed.soundFile);
+  }
+
+  void AmbientSoundVoices::playRandomSound(ManagedSound& managed, float now)
+  {
+    if (!managed.isVoiced || managed.source.isDestroyed()) return;
+    if (managed.sound->mode() != AmbientSound::Mode::Random) return;
+    if (now < managed.nextPlayTime) return;
+
+    managed.source->setTime(0.0f);
+    managed.source->play();
+
+    float length = managed.source->getClip()->getLength();
+
+    managed.nextPlayTime = now + length + randomDelayOf(*managed.sound);
+  }
+
+  float AmbientSoundVoices::randomDelayOf(const AmbientSound& sound)
+  {
+    float offset = (mRandom.nextFloat() * 2.0f - 1.0f) * sound.randomDelayVariance();
+
+    return std::max(sound.randomDelay() + offset, 0.0f);
+  }
+}  // namespace REGoth
@@ -0,0 +1,111 @@
+#pragma once
+#include <BsPrerequisites.h>
+#include <core/Random.hpp>
+
+namespace REGoth
+{
+  class AmbientSound;
+  using HAmbientSound = bs::GameObjectHandle<AmbientSound>;
+
+  /**
+   * Decides which of the ambient sounds of a world are actually playing.
+   *
+   * Worlds have hundreds of ambient sounds, but only those near the listener can be heard.
+   * Those are *voiced*: They get an audio source on a child scene object of their own, with a
+   * streaming clip from SoundStreaming. All others are *virtual*: They have no audio source and
+   * their clip is released, they only keep track of where in their sound they would be. Once a
+   * looping sound becomes voiced again, it continues from there instead of starting over.
+   *
+   * A few times per second, the MAX_VOICES sounds which are closest to the listener relative to
+   * their radius are voiced, out of those in range.
+   *
+   * Every GameWorld has one, see GameWorld::ambientSoundVoices(). Not saved, the world sets it
+   * up again after loading, see reset().
+   */
+  class AmbientSoundVoices
+  {
+  public:
+    /**
+     * How many sounds there are and how many of them are voiced.
+     */
+    struct Stats
+    {
+      bs::UINT32 numSounds       = 0;
+      bs::UINT32 numVoicedSounds = 0;
+    };
+
+    /** Most sounds playing at the same time */
+    static constexpr bs::UINT32 MAX_VOICES = 16;
+
+    /** Seconds between two checks of which sounds to voice */
+    static constexpr float CHECK_INTERVAL = 0.25f;
+
+    /**
+     * Virtualizes all sounds and forgets about them.
+     */
+    void reset();
+
+    /**
+     * Adds an ambient sound, which starts virtual.
+     */
+    void addSound(HAmbientSound sound);
+
+    /**
+     * Voices and virtualizes the sounds for the listener being at the given position.
+     */
+    void update(const bs::Vector3& listenerPosition);
+
+    const Stats& stats() const
+    {
+      return mStats;
+    }
+
+  private:
+    struct ManagedSound
+    {
+      HAmbientSound sound;
+
+      /** Copied, so the clip can be released even if the sound has been destroyed */
+      bs::String soundFile;
+
+      /** Only set while voiced */
+      bs::HAudioSource source;
+      bool isVoiced = false;
+
+      /** Time at which the sound has started, looping sounds are virtually still playing */
+      float startTime = 0.0f;
+
+      /** Time at which a sound of AmbientSound::Mode::Random is played next */
+      float nextPlayTime = 0.0f;
+
+      /** Whether a sound of AmbientSound::Mode::Once has been played */
+      bool hasPlayed = false;
+
+      /** Distance to the listener relative to the radius, only valid during a check */
+      float relativeDistance = 0.0f;
+    };
+
+    void voice(ManagedSound& managed, float now);
+    void virtualize(ManagedSound& managed);
+
+    /**
+     * Plays the sound once more, if it is voiced and it is time for it.
+     */
+    void playRandomSound(ManagedSound& managed, float now);
+
+    float randomDelayOf(const AmbientSound& sound);
+
+    bs::Vector<ManagedSound> mSounds;
+
+    /** Indices into mSounds, reused for every check so there are no allocations */
+    bs::Vector<bs::UINT32> mCandidates;
+
+    /** Not the one of the world, so sounds don't change what the scripts roll */
+    Random mRandom;
+
+    float mTimeUntilCheck = 0.0f;
+    float mLastUpdateTime = -1.0f;
+
+    Stats mStats;
+  };
+}  // namespace REGoth
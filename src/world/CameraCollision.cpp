@@ -0,0 +1,83 @@
+#include "CameraCollision.hpp"
+#include <Math/BsSphere.h>
+#include <Physics/BsPhysics.h>
+#include <Scene/BsSceneManager.h>
+#include <algorithm>
+#include <world/PhysicsLayers.hpp>
+
+namespace REGoth
+{
+  constexpr float CameraCollision::CAMERA_RADIUS;
+  constexpr float CameraCollision::MOVE_TOLERANCE;
+  constexpr float CameraCollision::EASE_OUT_SPEED;
+  constexpr float CameraCollision::MIN_DISTANCE;
+
+  bs::Vector3 CameraCollision::resolve(const bs::Vector3& pivot, const bs::Vector3& desired,
+                                       float deltaTime)
+  {
+    bs::Vector3 offset    = desired - pivot;
+    float desiredDistance = offset.length();
+
+    if (desiredDistance <= MIN_DISTANCE) return desired;
+
+    bs::Vector3 direction = offset / desiredDistance;
+
+    const float toleranceSq = MOVE_TOLERANCE * MOVE_TOLERANCE;
+
+    bool hasMoved = !mHasSwept || pivot.squaredDistance(mLastPivot) > toleranceSq ||
+                    desired.squaredDistance(mLastDesired) > toleranceSq;
+
+    if (hasMoved)
+    {
+      mFreeDistance = sweep(pivot, direction, desiredDistance);
+      mLastPivot    = pivot;
+      mLastDesired  = desired;
+      mHasSwept     = true;
+
+      mStats.numSweeps += 1;
+    }
+    else
+    {
+      mStats.numReused += 1;
+    }
+
+    float allowed = std::max(MIN_DISTANCE, std::min(desiredDistance, mFreeDistance));
+
+    if (allowed < mDistance)
+    {
+      mDistance = allowed;
+    }
+    else
+    {
+      mDistance = std::min(allowed, mDistance + EASE_OUT_SPEED * deltaTime);
+    }
+
+    return pivot + direction * mDistance;
+  }
+
+  void CameraCollision::reset()
+  {
+    mHasSwept     = false;
+    mFreeDistance = FLT_MAX;
+    mDistance     = FLT_MAX;
+  }
+
+  float CameraCollision::sweep(const bs::Vector3& pivot, const bs::Vector3& direction,
+                               float distance)
+  {
+    auto physicsScene = bs::gSceneManager().getMainScene()->getPhysicsScene();
+
+    if (!physicsScene) return FLT_MAX;
+
+    bs::PhysicsQueryHit hit;
+    bs::Sphere sphere(pivot, CAMERA_RADIUS);
+
+    // Characters and props standing in between are looked past, see PhysicsLayer
+    if (!physicsScene->sphereCast(sphere, direction, hit, PhysicsLayer::LEVEL_GEOMETRY, distance))
+    {
+      return FLT_MAX;
+    }
+
+    return hit.distance;
+  }
+}  // namespace REGoth
@@ -0,0 +1,86 @@
+#pragma once
+#include <BsPrerequisites.h>
+#include <Math/BsVector3.h>
+
+namespace REGoth
+{
+  /**
+   * Keeps a camera following a character out of the walls: Pulls it in along the line from
+   * what it looks at, the pivot, to where it wants to be, up to the first level geometry in
+   * the way. See ThirdPersonCamera.
+   *
+   * A sphere is swept from the pivot against nothing but PhysicsLayer::LEVEL_GEOMETRY, so
+   * characters and small props don't make the camera jump. Those are static, so as long as
+   * neither the pivot nor the camera move, the last sweep still holds and is reused. That
+   * makes standing around, or the camera settling behind a character, free. Otherwise there
+   * is one sweep per update, however dense the geometry.
+   *
+   * The camera is pulled in right away, to not show what's behind a wall for a single
+   * frame. Once the way is clear again, it moves back out at EASE_OUT_SPEED, so pillars
+   * passing by don't make it jump back and forth.
+   *
+   * Not saved, the first update after loading sweeps again.
+   */
+  class CameraCollision
+  {
+  public:
+    /** Radius of the sphere swept towards the camera, keeps the near plane out of walls */
+    static constexpr float CAMERA_RADIUS = 0.2f;
+
+    /** Pivot and camera moving less than this reuse the last sweep, in meters */
+    static constexpr float MOVE_TOLERANCE = 0.01f;
+
+    /** How quickly the camera moves back out once the way is clear, in meters per second */
+    static constexpr float EASE_OUT_SPEED = 4.0f;
+
+    /** The camera doesn't get closer to the pivot than this, in meters */
+    static constexpr float MIN_DISTANCE = 0.3f;
+
+    struct Stats
+    {
+      /** Sweeps done against the level geometry */
+      bs::UINT64 numSweeps = 0;
+
+      /** Updates which reused the last sweep */
+      bs::UINT64 numReused = 0;
+    };
+
+    /**
+     * @param  pivot      What the camera looks at, like the head of the character.
+     * @param  desired    Where the camera wants to be.
+     * @param  deltaTime  Seconds since the last call.
+     *
+     * @return Where to put the camera instead, on the line from the pivot to `desired`.
+     */
+    bs::Vector3 resolve(const bs::Vector3& pivot, const bs::Vector3& desired, float deltaTime);
+
+    /**
+     * Forgets the last sweep, e.g. after the camera has been teleported.
+     */
+    void reset();
+
+    const Stats& stats() const
+    {
+      return mStats;
+    }
+
+  private:
+    /**
+     * @return How far the camera can get from the pivot in the given direction before
+     *         touching the level geometry. FLT_MAX if nothing is in the way.
+     */
+    static float sweep(const bs::Vector3& pivot, const bs::Vector3& direction, float distance);
+
+    bool mHasSwept = false;
+    bs::Vector3 mLastPivot;
+    bs::Vector3 mLastDesired;
+
+    /** Result of the last sweep */
+    float mFreeDistance = FLT_MAX;
+
+    /** Distance from the pivot given out last, eased towards the free distance */
+    float mDistance = FLT_MAX;
+
+    Stats mStats;
+  };
+}  // namespace REGoth
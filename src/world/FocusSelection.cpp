@@ -0,0 +1,111 @@
+#include "FocusSelection.hpp"
+#include <Scene/BsSceneObject.h>
+#include <components/Focusable.hpp>
+#include <components/GameWorld.hpp>
+#include <components/Item.hpp>
+#include <cmath>
+
+namespace REGoth
+{
+  constexpr float FocusSelection::FOCUS_RANGE;
+  constexpr float FocusSelection::KEEP_FOCUS_RANGE;
+  constexpr float FocusSelection::FOCUS_CONE_COS;
+  constexpr float FocusSelection::KEEP_FOCUS_CONE_COS;
+  constexpr float FocusSelection::SWITCH_FOCUS_FACTOR;
+  constexpr float FocusSelection::UPDATE_INTERVAL;
+
+  /** How much being off to the side counts against an object compared to its distance */
+  constexpr float ANGLE_WEIGHT = 2.0f;
+
+  bool FocusSelection::update(const bs::Vector3& viewerPosition,
+                              const bs::Vector3& viewerForward, float deltaTime)
+  {
+    // Picked up items lose their focusable right away, so don't wait for the next choice
+    if (mHasFocus && mFocus.isDestroyed())
+    {
+      mFocus    = {};
+      mHasFocus = false;
+      return true;
+    }
+
+    mTimeUntilUpdate -= deltaTime;
+
+    if (mTimeUntilUpdate > 0.0f) return false;
+
+    mTimeUntilUpdate = UPDATE_INTERVAL;
+
+    if (!mWorld) return false;
+
+    float currentScore = -1.0f;
+
+    if (mHasFocus)
+    {
+      currentScore = score(viewerPosition, viewerForward, mFocus->SO()->getTransform().pos(),
+                           KEEP_FOCUS_RANGE, KEEP_FOCUS_CONE_COS);
+    }
+
+    HFocusable best;
+    float bestScore = -1.0f;
+
+    mWorld->findItemsInRange(FOCUS_RANGE, viewerPosition, mCandidates);
+
+    for (HItem item : mCandidates)
+    {
+      float s = score(viewerPosition, viewerForward, item->SO()->getTransform().pos(),
+                      FOCUS_RANGE, FOCUS_CONE_COS);
+
+      if (s < 0.0f || (bestScore >= 0.0f && s >= bestScore)) continue;
+
+      // Only looked up for the few objects which could win
+      HFocusable focusable = item->SO()->getComponent<Focusable>();
+
+      if (!focusable) continue;
+
+      best      = focusable;
+      bestScore = s;
+    }
+
+    HFocusable chosen = best;
+
+    if (currentScore >= 0.0f)
+    {
+      bool isClearlyBetter = bestScore >= 0.0f && bestScore < currentScore * SWITCH_FOCUS_FACTOR;
+
+      if (!isClearlyBetter) chosen = mFocus;
+    }
+
+    bool hasChosen = bestScore >= 0.0f || currentScore >= 0.0f;
+
+    if (hasChosen == mHasFocus && (!hasChosen || chosen == mFocus)) return false;
+
+    mFocus    = chosen;
+    mHasFocus = hasChosen;
+
+    return true;
+  }
+
+  float FocusSelection::score(const bs::Vector3& viewerPosition,
+                              const bs::Vector3& viewerForward, const bs::Vector3& position,
+                              float range, float coneCos)
+  {
+    bs::Vector3 difference = position - viewerPosition;
+    bs::Vector3 forward    = viewerForward;
+
+    difference.y = 0.0f;
+    forward.y    = 0.0f;
+
+    float distanceSq = difference.squaredLength();
+
+    if (distanceSq > range * range) return -1.0f;
+
+    // Standing right on top of it
+    if (distanceSq < 0.0001f) return 0.0f;
+
+    float distance = std::sqrt(distanceSq);
+    float cosAngle = difference.dot(forward) / (distance * forward.length());
+
+    if (!(cosAngle >= coneCos)) return -1.0f;
+
+    return distance * (1.0f + (1.0f - cosAngle) * ANGLE_WEIGHT);
+  }
+}  // namespace REGoth
@@ -0,0 +1,100 @@
+#pragma once
+#include <BsPrerequisites.h>
+
+namespace REGoth
+{
+  class GameWorld;
+  using HGameWorld = bs::GameObjectHandle<GameWorld>;
+
+  class Focusable;
+  using HFocusable = bs::GameObjectHandle<Focusable>;
+
+  class Item;
+  using HItem = bs::GameObjectHandle<Item>;
+
+  /**
+   * Decides which Focusable the hero is looking at, like the item whose name is shown above
+   * it, see UIFocusText.
+   *
+   * Only the focusables close to the viewer are looked at, which are found through the
+   * spatial index of the world, see GameWorld::findItemsInRange(). Of those inside the view
+   * cone, the one closest to the viewer and to the center of the cone wins. The choice is
+   * only made a few times per second.
+   *
+   * To not have the focus jump back and forth between two objects next to each other, the
+   * current focus is kept while it's still inside a slightly larger range and cone, unless
+   * another one is clearly better.
+   *
+   * Every GameWorld has one, see GameWorld::focusSelection(). Not saved, the focus is
+   * chosen again after loading.
+   */
+  class FocusSelection
+  {
+  public:
+    /** Objects further away from the viewer than this can't be focused, in meters */
+    static constexpr float FOCUS_RANGE = 3.0f;
+
+    /** The current focus is kept until it is further away than this, in meters */
+    static constexpr float KEEP_FOCUS_RANGE = 3.5f;
+
+    /** Cosine of the angle between the view and an object to focus, about 45 degrees */
+    static constexpr float FOCUS_CONE_COS = 0.7f;
+
+    /** Cosine of the angle the current focus is kept up to, about 60 degrees */
+    static constexpr float KEEP_FOCUS_CONE_COS = 0.5f;
+
+    /**
+     * Another object only takes over the focus if its score is below that of the current
+     * focus times this, see score().
+     */
+    static constexpr float SWITCH_FOCUS_FACTOR = 0.75f;
+
+    /** Seconds between two choices of the focus */
+    static constexpr float UPDATE_INTERVAL = 0.1f;
+
+    /**
+     * Sets the world whose focusables are chosen from.
+     */
+    void setWorld(HGameWorld world)
+    {
+      mWorld = world;
+    }
+
+    /**
+     * Chooses the focus again, if it's time to do so.
+     *
+     * @param  viewerPosition  Where the hero is.
+     * @param  viewerForward   Where the hero is looking.
+     * @param  deltaTime       Seconds since the last call.
+     *
+     * @return Whether the focus has changed, see focus().
+     */
+    bool update(const bs::Vector3& viewerPosition, const bs::Vector3& viewerForward,
+                float deltaTime);
+
+    /**
+     * @return The object currently in focus. Invalid if there is none.
+     */
+    HFocusable focus() const
+    {
+      return mHasFocus ? mFocus : HFocusable();
+    }
+
+  private:
+    /**
+     * @return How much the viewer is looking at the given position, lower is better. Negative
+     *         if the position is outside of the given range or cone. Height is ignored, items
+     *         lie on the ground below the eyes of the hero.
+     */
+    static float score(const bs::Vector3& viewerPosition, const bs::Vector3& viewerForward,
+                       const bs::Vector3& position, float range, float coneCos);
+
+    HGameWorld mWorld;
+    HFocusable mFocus;
+    bool mHasFocus         = false;
+    float mTimeUntilUpdate = 0.0f;
+
+    /** Reused for every update to not allocate */
+    bs::Vector<HItem> mCandidates;
+  };
+}  // namespace REGoth
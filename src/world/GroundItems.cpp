@@ -0,0 +1,139 @@
+#include "GroundItems.hpp"
+#include <Scene/BsSceneObject.h>
+#include <Utility/BsTime.h>
+#include <components/GameWorld.hpp>
+#include <components/Item.hpp>
+
+namespace REGoth
+{
+  constexpr float GroundItems::MATERIALIZE_RANGE;
+  constexpr float GroundItems::DEMATERIALIZE_RANGE;
+  constexpr float GroundItems::CHECK_INTERVAL;
+  constexpr bs::UINT32 GroundItems::MAX_MATERIALIZATIONS_PER_UPDATE;
+
+  void GroundItems::addDormantItem(const bs::String& instance, const bs::Vector3& position,
+                                   const bs::Quaternion& rotation)
+  {
+    mDormantItems.push_back({instance, position, rotation});
+
+    mStats.numDormantItems = (bs::UINT32)mDormantItems.size();
+
+    // Might be right next to the hero
+    mTimeUntilCheck = 0.0f;
+  }
+
+  void GroundItems::onItemInserted(HItem item)
+  {
+    mMaterializedItems.push_back(item);
+
+    mStats.numMaterializedItems = (bs::UINT32)mMaterializedItems.size();
+  }
+
+  void GroundItems::reset(const bs::Vector<HItem>& items)
+  {
+    mMaterializedItems.clear();
+
+    for (HItem item : items)
+    {
+      if (!item.isDestroyed()) mMaterializedItems.push_back(item);
+    }
+
+    mTimeUntilCheck = 0.0f;
+
+    mStats.numDormantItems      = (bs::UINT32)mDormantItems.size();
+    mStats.numMaterializedItems = (bs::UINT32)mMaterializedItems.size();
+  }
+
+  void GroundItems::update(const bs::Vector3& heroPosition)
+  {
+    float now        = bs::gTime().getTime();
+    float timePassed = mLastUpdateTime < 0.0f ? 0.0f : now - mLastUpdateTime;
+    mLastUpdateTime  = now;
+
+    mTimeUntilCheck -= timePassed;
+
+    if (mTimeUntilCheck > 0.0f) return;
+
+    mTimeUntilCheck = CHECK_INTERVAL;
+
+    // By index, since dematerializing removes from the list
+    for (size_t i = 0; i < mMaterializedItems.size();)
+    {
+      HItem item = mMaterializedItems[i];
+
+      // Picked up or otherwise gone
+      if (item.isDestroyed())
+      {
+        mMaterializedItems[i] = mMaterializedItems.back();
+        mMaterializedItems.pop_back();
+        continue;
+      }
+
+      bs::HSceneObject so = item->SO();
+
+      // Only items lying around, not those attached to something
+      bool isFarAway = so->getParent() == mWorld->SO() &&
+                       so->getTransform().pos().distance(heroPosition) > DEMATERIALIZE_RANGE;
+
+      if (!isFarAway)
+      {
+        i++;
+        continue;
+      }
+
+      mMaterializedItems[i] = mMaterializedItems.back();
+      mMaterializedItems.pop_back();
+
+      dematerialize(item);
+    }
+
+    bs::UINT32 numMaterialized = 0;
+
+    for (size_t i = 0; i < mDormantItems.size();)
+    {
+      if (mDormantItems[i].position.distance(heroPosition) > MATERIALIZE_RANGE)
+      {
+        i++;
+        continue;
+      }
+
+      if (numMaterialized == MAX_MATERIALIZATIONS_PER_UPDATE)
+      {
+        // Go on with the rest right away
+        mTimeUntilCheck = 0.0f;
+        break;
+      }
+
+      // Replaces the item at i with the last one
+      materialize((bs::UINT32)i);
+      numMaterialized++;
+    }
+
+    mStats.numDormantItems      = (bs::UINT32)mDormantItems.size();
+    mStats.numMaterializedItems = (bs::UINT32)mMaterializedItems.size();
+  }
+
+  void GroundItems::materialize(bs::UINT32 index)
+  {
+    DormantItem dormant = std::move(mDormantItems[index]);
+
+    mDormantItems[index] = std::move(mDormantItems.back());
+    mDormantItems.pop_back();
+
+    bs::Transform transform;
+    transform.setPosition(dormant.position);
+    transform.setRotation(dormant.rotation);
+
+    // Registers the item via onItemInserted()
+    mWorld->insertItem(dormant.instance, transform);
+  }
+
+  void GroundItems::dematerialize(HItem item)
+  {
+    const bs::Transform& transform = item->SO()->getTransform();
+
+    mDormantItems.push_back({item->scriptInstance(), transform.pos(), transform.rot()});
+
+    item->SO()->destroy();
+  }
+}  // namespace REGoth
@@ -0,0 +1,139 @@
+#pragma once
+#include <BsPrerequisites.h>
+#include <Math/BsQuaternion.h>
+#include <Math/BsVector3.h>
+
+namespace REGoth
+{
+  class GameWorld;
+  using HGameWorld = bs::GameObjectHandle<GameWorld>;
+
+  class Item;
+  using HItem = bs::GameObjectHandle<Item>;
+
+  /**
+   * Keeps items lying around far away from the hero as nothing but their instance and
+   * transform, instead of a scene object with visual, focusable and backing script object each.
+   * The original worlds have thousands of them, of which only those around the hero can be
+   * seen, focused or picked up.
+   *
+   * Such a *dormant* item is turned into a full item via GameWorld::insertItem() once the hero
+   * comes closer than MATERIALIZE_RANGE. Items further away than DEMATERIALIZE_RANGE are turned
+   * back into dormant ones, which destroys their scene object and script object. An item which
+   * is picked up is destroyed by then, so it doesn't come back. Destroying far away items means
+   * that handles to them don't stay valid and the scripts can't find them, which is fine since
+   * nothing interacts with items that far away from the hero.
+   *
+   * Only a few items are materialized per update, to not stall a single frame for too long.
+   *
+   * Every GameWorld has one, see GameWorld::groundItems(). The dormant items are saved with
+   * the world, which sets up the rest again after loading, see reset().
+   */
+  class GroundItems
+  {
+  public:
+    /**
+     * How many items there are in which form.
+     */
+    struct Stats
+    {
+      bs::UINT32 numDormantItems      = 0;
+      bs::UINT32 numMaterializedItems = 0;
+    };
+
+    /**
+     * An item of which only the instance and transform are known.
+     */
+    struct DormantItem
+    {
+      bs::String instance;
+      bs::Vector3 position;
+      bs::Quaternion rotation;
+    };
+
+    /**
+     * Dormant items closer to the hero than this are materialized, in meters. Must be smaller
+     * than DEMATERIALIZE_RANGE.
+     */
+    static constexpr float MATERIALIZE_RANGE = 40.0f;
+
+    /** Items further away from the hero than this are made dormant, in meters */
+    static constexpr float DEMATERIALIZE_RANGE = 50.0f;
+
+    /** Seconds between two checks of which items to materialize */
+    static constexpr float CHECK_INTERVAL = 0.5f;
+
+    /** How many items are materialized in one update at most */
+    static constexpr bs::UINT32 MAX_MATERIALIZATIONS_PER_UPDATE = 32;
+
+    /**
+     * Sets the world to insert the materialized items into.
+     */
+    void setWorld(HGameWorld world)
+    {
+      mWorld = world;
+    }
+
+    /**
+     * Adds an item which starts dormant. It is materialized by the next update() if the hero
+     * is close enough.
+     */
+    void addDormantItem(const bs::String& instance, const bs::Vector3& position,
+                        const bs::Quaternion& rotation);
+
+    /**
+     * To be called for every item inserted into the world, so it can be made dormant once the
+     * hero is far away.
+     */
+    void onItemInserted(HItem item);
+
+    /**
+     * Forgets which items are materialized and takes the given ones instead. The dormant
+     * items are kept.
+     *
+     * @param  items  All items of the world.
+     */
+    void reset(const bs::Vector<HItem>& items);
+
+    /**
+     * Materializes and dematerializes what needs to be for the hero being at the given
+     * position.
+     */
+    void update(const bs::Vector3& heroPosition);
+
+    /**
+     * @return All items which are dormant right now.
+     */
+    const bs::Vector<DormantItem>& dormantItems() const
+    {
+      return mDormantItems;
+    }
+
+    const Stats& stats() const
+    {
+      return mStats;
+    }
+
+  private:
+    /**
+     * Inserts the dormant item at the given index as full item and removes it from
+     * mDormantItems.
+     */
+    void materialize(bs::UINT32 index);
+
+    /**
+     * Destroys the given item and adds it as dormant item instead.
+     */
+    void dematerialize(HItem item);
+
+    HGameWorld mWorld;
+
+    bs::Vector<DormantItem> mDormantItems;
+    bs::Vector<HItem> mMaterializedItems;
+
+    float mTimeUntilCheck = 0.0f;
+    float mLastUpdateTime = -1.0f;
+
+    Stats mStats;
+  };
+}  // namespace REGoth
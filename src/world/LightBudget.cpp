@@ -0,0 +1,97 @@
+#include "LightBudget.hpp"
+#include <Components/BsCLight.h>
+#include <Scene/BsSceneObject.h>
+#include <Utility/BsTime.h>
+#include <algorithm>
+
+namespace REGoth
+{
+  constexpr bs::UINT32 LightBudget::MAX_ACTIVE_LIGHTS;
+  constexpr float LightBudget::MAX_LIGHT_DISTANCE;
+  constexpr float LightBudget::CHECK_INTERVAL;
+
+  void LightBudget::reset()
+  {
+    mLights.clear();
+    mCandidates.clear();
+
+    mTimeUntilCheck = 0.0f;
+    mStats          = {};
+  }
+
+  void LightBudget::addLight(bs::HLight light)
+  {
+    ManagedLight managed;
+    managed.light    = light;
+    managed.isActive = true;
+
+    setLightActive(managed, false);
+
+    mLights.push_back(managed);
+
+    mStats.numLights = (bs::UINT32)mLights.size();
+
+    // The new light might be more important than those turned on right now
+    mTimeUntilCheck = 0.0f;
+  }
+
+  void LightBudget::update(const bs::Vector3& cameraPosition)
+  {
+    float now        = bs::gTime().getTime();
+    float timePassed = mLastUpdateTime < 0.0f ? 0.0f : now - mLastUpdateTime;
+    mLastUpdateTime  = now;
+
+    mTimeUntilCheck -= timePassed;
+
+    if (mTimeUntilCheck > 0.0f) return;
+
+    mTimeUntilCheck = CHECK_INTERVAL;
+
+    mCandidates.clear();
+
+    for (bs::UINT32 i = 0; i < (bs::UINT32)mLights.size(); i++)
+    {
+      ManagedLight& managed = mLights[i];
+
+      if (managed.light.isDestroyed()) continue;
+
+      float range    = managed.light->getAttenuationRadius();
+      float distance = managed.light->SO()->getTransform().pos().distance(cameraPosition);
+
+      if (distance - range > MAX_LIGHT_DISTANCE)
+      {
+        setLightActive(managed, false);
+        continue;
+      }
+
+      managed.importance = range / std::max(distance, 1.0f);
+      mCandidates.push_back(i);
+    }
+
+    auto isMoreImportant = [&](bs::UINT32 a, bs::UINT32 b) {
+      return mLights[a].importance > mLights[b].importance;
+    };
+
+    size_t numActive = std::min<size_t>(mCandidates.size(), MAX_ACTIVE_LIGHTS);
+
+    std::nth_element(mCandidates.begin(), mCandidates.begin() + numActive, mCandidates.end(),
+                     isMoreImportant);
+
+    for (size_t i = 0; i < mCandidates.size(); i++)
+    {
+      setLightActive(mLights[mCandidates[i]], i < numActive);
+    }
+
+    mStats.numLights       = (bs::UINT32)mLights.size();
+    mStats.numActiveLights = (bs::UINT32)numActive;
+  }
+
+  void LightBudget::setLightActive(ManagedLight& managed, bool isActive)
+  {
+    if (managed.isActive == isActive) return;
+    if (managed.light.isDestroyed()) return;
+
+    managed.isActive = isActive;
+    managed.light->SO()->setActive(isActive);
+  }
+}  // namespace REGoth
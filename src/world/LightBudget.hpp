@@ -0,0 +1,86 @@
+#pragma once
+#include <BsPrerequisites.h>
+
+namespace REGoth
+{
+  /**
+   * Keeps the number of real-time lights bounded, no matter how many light vobs are around.
+   *
+   * Camps of the original worlds have dozens of torches and campfires right next to each
+   * other. Only the MAX_ACTIVE_LIGHTS most important ones around the camera are turned on, a few
+   * times per second. A light is the more important the larger its range is compared to its
+   * distance to the camera, lights whose range ends further away than MAX_LIGHT_DISTANCE are
+   * never turned on.
+   *
+   * Lights are turned on and off by activating and deactivating the scene object holding their
+   * CLight, which should therefore not hold anything else.
+   *
+   * Every GameWorld has one, see GameWorld::lightBudget(). Not saved, the world sets it up
+   * again after loading, see reset().
+   */
+  class LightBudget
+  {
+  public:
+    /**
+     * How many lights there are and how many of them are turned on.
+     */
+    struct Stats
+    {
+      bs::UINT32 numLights       = 0;
+      bs::UINT32 numActiveLights = 0;
+    };
+
+    /** Most lights turned on at the same time */
+    static constexpr bs::UINT32 MAX_ACTIVE_LIGHTS = 24;
+
+    /** Lights are off once the camera is further away from their range than this, in meters */
+    static constexpr float MAX_LIGHT_DISTANCE = 40.0f;
+
+    /** Seconds between two checks of which lights to turn on */
+    static constexpr float CHECK_INTERVAL = 0.25f;
+
+    /**
+     * Forgets all lights.
+     */
+    void reset();
+
+    /**
+     * Adds a light, which starts turned off.
+     */
+    void addLight(bs::HLight light);
+
+    /**
+     * Turns on the most important lights as seen from the given position and turns off all
+     * others.
+     */
+    void update(const bs::Vector3& cameraPosition);
+
+    const Stats& stats() const
+    {
+      return mStats;
+    }
+
+  private:
+    struct ManagedLight
+    {
+      bs::HLight light;
+
+      /** Higher is more important, only valid during an update */
+      float importance = 0.0f;
+
+      bool isActive = false;
+    };
+
+    void setLightActive(ManagedLight& light, bool isActive);
+
+    bs::Vector<ManagedLight> mLights;
+
+    /** Indices into mLights, reused for every check so there are no allocations */
+    bs::Vector<bs::UINT32> mCandidates;
+
+    float mTimeUntilCheck = 0.0f;
+    float mLastUpdateTime = -1.0f;
+
+    Stats mStats;
+  };
+}  // namespace REGoth
@@ -0,0 +1,12 @@
+#include "PhysicsLayers.hpp"
+#include <Physics/BsPhysics.h>
+
+namespace REGoth
+{
+  bool rayCastLevelGeometry(bs::PhysicsScene& scene, const bs::Vector3& origin,
+                            const bs::Vector3& direction, bs::PhysicsQueryHit& hit,
+                            float maxDistance)
+  {
+    return scene.rayCast(origin, direction, hit, PhysicsLayer::LEVEL_GEOMETRY, maxDistance);
+  }
+}  // namespace REGoth
@@ -0,0 +1,60 @@
+#pragma once
+#include <BsPrerequisites.h>
+#include <Math/BsVector3.h>
+
+namespace bs
+{
+  class PhysicsScene;
+  struct PhysicsQueryHit;
+}  // namespace bs
+
+namespace REGoth
+{
+  /**
+   * Layers colliders are put on when they are created, so physics queries can choose what to
+   * test against instead of hitting everything.
+   *
+   * bs:f puts every collider onto the first layer by default, which is used for the level
+   * geometry. Anything not put onto a layer explicitly counts as level geometry.
+   *
+   * Items have no colliders in the world, so there is no layer for them.
+   */
+  namespace PhysicsLayer
+  {
+    /**
+     * The world mesh and vobs colliding with their triangles. Those are everything large,
+     * like houses and bridges, see Internals::fitColliderShape().
+     */
+    constexpr bs::UINT64 LEVEL_GEOMETRY = 1 << 0;
+
+    /**
+     * Small vobs colliding with a box, a capsule or their convex hull, like barrels or
+     * chairs.
+     */
+    constexpr bs::UINT64 DECORATION = 1 << 1;
+
+    /**
+     * Character controllers.
+     */
+    constexpr bs::UINT64 CHARACTERS = 1 << 2;
+  }  // namespace PhysicsLayer
+
+  /**
+   * Casts a ray against nothing but the level geometry, see PhysicsLayer::LEVEL_GEOMETRY.
+   *
+   * Meant for the queries of the AI: Whether a character can walk somewhere directly doesn't
+   * depend on other characters or a chair standing in the way, which they walk around or
+   * push aside anyways. Leaving those out also makes the query cheaper.
+   *
+   * @param  scene        Scene to query.
+   * @param  origin       Where the ray starts.
+   * @param  direction    Direction of the ray, normalized.
+   * @param  hit          Set to the closest hit, if there is one.
+   * @param  maxDistance  How far along the ray to look for hits.
+   *
+   * @return Whether anything was hit.
+   */
+  bool rayCastLevelGeometry(bs::PhysicsScene& scene, const bs::Vector3& origin,
+                            const bs::Vector3& direction, bs::PhysicsQueryHit& hit,
+                            float maxDistance = FLT_MAX);
+}  // namespace REGoth
@@ -0,0 +1,346 @@
+#include "PortalMap.hpp"
+#include <BsZenLib/ImportPath.hpp>
+#include <FileSystem/BsDataStream.h>
+#include <FileSystem/BsFileSystem.h>
+#include <Math/BsMath.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace REGoth
+{
+  constexpr bs::UINT32 PortalMap::OUTDOORS;
+  constexpr float PortalMap::CELL_SIZE;
+  constexpr float PortalMap::MIN_CELL_HEIGHT;
+  constexpr bs::UINT32 PortalMap::FILE_VERSION;
+
+  /**
+   * Start of a saved map, to recognize it.
+   */
+  struct PortalMapFileHeader
+  {
+    char magic[4]         = {'R', 'G', 'P', 'M'};
+    bs::UINT32 version    = 0;
+    bs::UINT32 numSectors = 0;
+    bs::UINT32 numPortals = 0;
+  };
+
+  /**
+   * A single cell of a sector as saved.
+   */
+  struct PortalMapFileCell
+  {
+    bs::INT32 x;
+    bs::INT32 z;
+    float minY;
+    float maxY;
+  };
+
+  /**
+   * @return Whether the given point lies inside the given triangle on the XZ-plane, no matter
+   *         which way the triangle is wound.
+   */
+  static bool isInsideTriangleXZ(float x, float z, const bs::Vector3& a, const bs::Vector3& b,
+                                 const bs::Vector3& c)
+  {
+    auto side = [&](const bs::Vector3& from, const bs::Vector3& to) {
+      return (to.x - from.x) * (z - from.z) - (to.z - from.z) * (x - from.x);
+    };
+
+    float ab = side(a, b);
+    float bc = side(b, c);
+    float ca = side(c, a);
+
+    bool hasNegative = ab < 0.0f || bc < 0.0f || ca < 0.0f;
+    bool hasPositive = ab > 0.0f || bc > 0.0f || ca > 0.0f;
+
+    return !(hasNegative && hasPositive);
+  }
+
+  bs::UINT32 PortalMap::addSector()
+  {
+    mSectors.emplace_back();
+
+    return (bs::UINT32)mSectors.size() - 1;
+  }
+
+  void PortalMap::addSectorTriangle(bs::UINT32 sector, const bs::Vector3& a, const bs::Vector3& b,
+                                    const bs::Vector3& c)
+  {
+    Sector& s = mSectors[sector];
+
+    if (!s.hasBounds)
+    {
+      s.bounds    = bs::AABox(a, a);
+      s.hasBounds = true;
+    }
+
+    s.bounds.merge(a);
+    s.bounds.merge(b);
+    s.bounds.merge(c);
+
+    bs::Vector3 normal = (b - a).cross(c - a);
+
+    // Walls don't say anything about how high the sector is
+    if (std::abs(normal.y) < 0.5f * normal.length()) return;
+
+    float minY = std::min({a.y, b.y, c.y});
+    float maxY = std::max({a.y, b.y, c.y});
+
+    bs::INT32 fromX = cellCoordinateOf(std::min({a.x, b.x, c.x}));
+    bs::INT32 toX   = cellCoordinateOf(std::max({a.x, b.x, c.x}));
+    bs::INT32 fromZ = cellCoordinateOf(std::min({a.z, b.z, c.z}));
+    bs::INT32 toZ   = cellCoordinateOf(std::max({a.z, b.z, c.z}));
+
+    for (bs::INT32 x = fromX; x <= toX; x++)
+    {
+      for (bs::INT32 z = fromZ; z <= toZ; z++)
+      {
+        float centerX = (x + 0.5f) * CELL_SIZE;
+        float centerZ = (z + 0.5f) * CELL_SIZE;
+
+        if (isInsideTriangleXZ(centerX, centerZ, a, b, c))
+        {
+          addToCell(s, x, z, minY, maxY);
+        }
+      }
+    }
+
+    // Triangles smaller than a cell may not contain any cell center
+    bs::Vector3 center = (a + b + c) / 3.0f;
+    addToCell(s, cellCoordinateOf(center.x), cellCoordinateOf(center.z), minY, maxY);
+  }
+
+  void PortalMap::addToCell(Sector& sector, bs::INT32 x, bs::INT32 z, float minY, float maxY)
+  {
+    auto it = sector.cells.find(cellKey(x, z));
+
+    if (it == sector.cells.end())
+    {
+      sector.cells[cellKey(x, z)] = {minY, maxY};
+    }
+    else
+    {
+      it->second.minY = std::min(it->second.minY, minY);
+      it->second.maxY = std::max(it->second.maxY, maxY);
+    }
+  }
+
+  void PortalMap::addPortal(const bs::AABox& bounds, bs::UINT32 sectorA, bs::UINT32 sectorB)
+  {
+    Portal portal;
+    portal.bounds     = bounds;
+    portal.sectors[0] = sectorA;
+    portal.sectors[1] = sectorB;
+
+    bs::UINT32 index = (bs::UINT32)mPortals.size();
+    mPortals.push_back(portal);
+
+    for (bs::UINT32 sector : portal.sectors)
+    {
+      if (sector == OUTDOORS)
+      {
+        mOutdoorPortals.push_back(index);
+      }
+      else
+      {
+        mSectors[sector].portals.push_back(index);
+      }
+    }
+  }
+
+  bs::UINT32 PortalMap::findSectorAt(const bs::Vector3& position) const
+  {
+    bs::UINT32 found  = OUTDOORS;
+    float foundVolume = 0.0f;
+
+    for (bs::UINT32 i = 0; i < (bs::UINT32)mSectors.size(); i++)
+    {
+      const Sector& sector = mSectors[i];
+
+      if (!sector.hasBounds || !isInSector(sector, position)) continue;
+
+      bs::Vector3 size = sector.bounds.getSize();
+      float volume     = size.x * size.y * size.z;
+
+      if (found == OUTDOORS || volume < foundVolume)
+      {
+        found       = i;
+        foundVolume = volume;
+      }
+    }
+
+    return found;
+  }
+
+  bs::UINT32 PortalMap::findSectorContaining(const bs::AABox& box) const
+  {
+    const bs::Vector3& min = box.getMin();
+    const bs::Vector3& max = box.getMax();
+    float centerY          = (min.y + max.y) * 0.5f;
+
+    bs::UINT32 sector = findSectorAt(bs::Vector3(min.x, centerY, min.z));
+
+    if (sector == OUTDOORS) return OUTDOORS;
+
+    const Sector& s = mSectors[sector];
+
+    bool isInside = isInSector(s, bs::Vector3(max.x, centerY, min.z)) &&
+                    isInSector(s, bs::Vector3(min.x, centerY, max.z)) &&
+                    isInSector(s, bs::Vector3(max.x, centerY, max.z));
+
+    return isInside ? sector : OUTDOORS;
+  }
+
+  bool PortalMap::touchesAnySector(const bs::AABox& box) const
+  {
+    for (const Sector& sector : mSectors)
+    {
+      if (sector.hasBounds && sector.bounds.intersects(box)) return true;
+    }
+
+    return false;
+  }
+
+  bool PortalMap::isInSector(const Sector& sector, const bs::Vector3& position) const
+  {
+    auto it = sector.cells.find(
+        cellKey(cellCoordinateOf(position.x), cellCoordinateOf(position.z)));
+
+    if (it == sector.cells.end()) return false;
+
+    const CellRange& range = it->second;
+    float maxY             = std::max(range.maxY, range.minY + MIN_CELL_HEIGHT);
+
+    return position.y >= range.minY - CELL_SIZE && position.y <= maxY;
+  }
+
+  bs::INT32 PortalMap::cellCoordinateOf(float value)
+  {
+    return (bs::INT32)std::floor(value / CELL_SIZE);
+  }
+
+  bs::UINT64 PortalMap::cellKey(bs::INT32 x, bs::INT32 z)
+  {
+    return ((bs::UINT64)(bs::UINT32)x << 32) | (bs::UINT32)z;
+  }
+
+  bs::Path PortalMap::cachePathFor(const bs::String& zenFile)
+  {
+    return BsZenLib::GothicPathToCachedWorld(zenFile + ".PORTALS");
+  }
+
+  bs::SPtr<PortalMap> PortalMap::load(const bs::Path& path)
+  {
+    if (!bs::FileSystem::exists(path)) return nullptr;
+
+    bs::SPtr<bs::DataStream> stream = bs::FileSystem::openFile(path, true);
+
+    if (!stream) return nullptr;
+
+    auto read = [&](void* data, size_t numBytes) {
+      return stream->read(data, numBytes) == numBytes;
+    };
+
+    PortalMapFileHeader header;
+    PortalMapFileHeader expected;
+
+    if (!read(&header, sizeof(header))) return nullptr;
+
+    if (std::memcmp(header.magic, expected.magic, sizeof(header.magic)) != 0) return nullptr;
+    if (header.version != FILE_VERSION) return nullptr;
+
+    auto map = bs::bs_shared_ptr_new<PortalMap>();
+
+    for (bs::UINT32 i = 0; i < header.numSectors; i++)
+    {
+      Sector& sector = map->mSectors[map->addSector()];
+
+      bs::Vector3 min;
+      bs::Vector3 max;
+      bs::UINT32 numCells;
+
+      if (!read(&min, sizeof(min)) || !read(&max, sizeof(max))) return nullptr;
+      if (!read(&numCells, sizeof(numCells))) return nullptr;
+
+      bs::Vector<PortalMapFileCell> cells(numCells);
+
+      if (!read(cells.data(), cells.size() * sizeof(PortalMapFileCell))) return nullptr;
+
+      // Sectors are only saved along with their triangles, see Internals::extractPortalMap()
+      sector.bounds    = bs::AABox(min, max);
+      sector.hasBounds = true;
+
+      for (const PortalMapFileCell& cell : cells)
+      {
+        sector.cells[cellKey(cell.x, cell.z)] = {cell.minY, cell.maxY};
+      }
+    }
+
+    for (bs::UINT32 i = 0; i < header.numPortals; i++)
+    {
+      bs::Vector3 min;
+      bs::Vector3 max;
+      bs::UINT32 sectors[2];
+
+      if (!read(&min, sizeof(min)) || !read(&max, sizeof(max))) return nullptr;
+      if (!read(sectors, sizeof(sectors))) return nullptr;
+
+      for (bs::UINT32 sector : sectors)
+      {
+        if (sector != OUTDOORS && sector >= header.numSectors) return nullptr;
+      }
+
+      map->addPortal(bs::AABox(min, max), sectors[0], sectors[1]);
+    }
+
+    return map;
+  }
+
+  void PortalMap::save(const bs::Path& path) const
+  {
+    bs::SPtr<bs::DataStream> stream = bs::FileSystem::createAndOpenFile(path);
+
+    if (!stream) return;
+
+    PortalMapFileHeader header;
+    header.version    = FILE_VERSION;
+    header.numSectors = (bs::UINT32)mSectors.size();
+    header.numPortals = (bs::UINT32)mPortals.size();
+
+    stream->write(&header, sizeof(header));
+
+    for (const Sector& sector : mSectors)
+    {
+      bs::Vector<PortalMapFileCell> cells;
+      cells.reserve(sector.cells.size());
+
+      for (const auto& it : sector.cells)
+      {
+        PortalMapFileCell cell;
+        cell.x    = (bs::INT32)(it.first >> 32);
+        cell.z    = (bs::INT32)(bs::UINT32)it.first;
+        cell.minY = it.second.minY;
+        cell.maxY = it.second.maxY;
+
+        cells.push_back(cell);
+      }
+
+      bs::UINT32 numCells = (bs::UINT32)cells.size();
+
+      stream->write(&sector.bounds.getMin(), sizeof(bs::Vector3));
+      stream->write(&sector.bounds.getMax(), sizeof(bs::Vector3));
+      stream->write(&numCells, sizeof(numCells));
+      stream->write(cells.data(), cells.size() * sizeof(PortalMapFileCell));
+    }
+
+    for (const Portal& portal : mPortals)
+    {
+      stream->write(&portal.bounds.getMin(), sizeof(bs::Vector3));
+      stream->write(&portal.bounds.getMax(), sizeof(bs::Vector3));
+      stream->write(portal.sectors, sizeof(portal.sectors));
+    }
+
+    stream->close();
+  }
+}  // namespace REGoth
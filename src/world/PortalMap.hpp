@@ -0,0 +1,159 @@
+#pragma once
+#include <BsPrerequisites.h>
+#include <Math/BsAABox.h>
+
+namespace REGoth
+{
+  /**
+   * Indoor sectors of a world and the portals between them, as marked in the world mesh of a
+   * ZEN-file. Sectors are usually the inside of buildings, portals their doors and windows.
+   * Everything not inside a sector is the outdoors, see OUTDOORS.
+   *
+   * The space of a sector is approximated by square cells on the XZ-plane, each covering the
+   * height between the lowest floor and highest ceiling of the sector inside it. That is
+   * coarse, but good enough to tell in which sector the camera or a vob is.
+   *
+   * Built once from the world mesh via Internals::extractPortalMap() and cached, see save()
+   * and cachePathFor(). Used by PortalVisibility.
+   */
+  class PortalMap
+  {
+  public:
+    /** Stands for everything not inside a sector */
+    static constexpr bs::UINT32 OUTDOORS = 0xFFFFFFFF;
+
+    /** Length of a side of a cell in meters */
+    static constexpr float CELL_SIZE = 1.0f;
+
+    /**
+     * Cells spanning less height than this are extended upwards to it, in meters. Cells
+     * without a ceiling above their floor would otherwise only contain the floor itself.
+     */
+    static constexpr float MIN_CELL_HEIGHT = 3.0f;
+
+    /**
+     * Opening between two sectors or between a sector and the outdoors.
+     */
+    struct Portal
+    {
+      bs::AABox bounds;
+
+      /** The sectors on either side, one of them may be OUTDOORS */
+      bs::UINT32 sectors[2] = {OUTDOORS, OUTDOORS};
+    };
+
+    /**
+     * Adds a new, empty sector.
+     *
+     * @return Index of the new sector.
+     */
+    bs::UINT32 addSector();
+
+    /**
+     * Adds a triangle of the given sector to its bounds. Adds it to the cells it covers if it
+     * is a floor or a ceiling, i.e. mostly horizontal.
+     */
+    void addSectorTriangle(bs::UINT32 sector, const bs::Vector3& a, const bs::Vector3& b,
+                           const bs::Vector3& c);
+
+    /**
+     * Adds a portal between the given sectors. These must not be the same.
+     */
+    void addPortal(const bs::AABox& bounds, bs::UINT32 sectorA, bs::UINT32 sectorB);
+
+    /**
+     * @return The smallest sector the given position is in, or OUTDOORS.
+     */
+    bs::UINT32 findSectorAt(const bs::Vector3& position) const;
+
+    /**
+     * @return The sector the given box is completely inside of on the XZ-plane, or OUTDOORS if
+     *         there is none.
+     */
+    bs::UINT32 findSectorContaining(const bs::AABox& box) const;
+
+    /**
+     * @return Whether the given box overlaps the bounds of any sector.
+     */
+    bool touchesAnySector(const bs::AABox& box) const;
+
+    bs::UINT32 numSectors() const
+    {
+      return (bs::UINT32)mSectors.size();
+    }
+
+    bs::UINT32 numPortals() const
+    {
+      return (bs::UINT32)mPortals.size();
+    }
+
+    const Portal& portal(bs::UINT32 index) const
+    {
+      return mPortals[index];
+    }
+
+    /**
+     * @return Indices of the portals leading into or out of the given sector, which may be
+     *         OUTDOORS.
+     */
+    const bs::Vector<bs::UINT32>& portalsOf(bs::UINT32 sector) const
+    {
+      return sector == OUTDOORS ? mOutdoorPortals : mSectors[sector].portals;
+    }
+
+    /**
+     * @return Where the portal map of the given ZEN-file is cached.
+     */
+    static bs::Path cachePathFor(const bs::String& zenFile);
+
+    /**
+     * Loads a map saved via save().
+     *
+     * @return The map. Nullptr if there is none at the given path or it is outdated.
+     */
+    static bs::SPtr<PortalMap> load(const bs::Path& path);
+
+    /**
+     * Saves the map, so it can be loaded by load().
+     */
+    void save(const bs::Path& path) const;
+
+  private:
+    /** Increase whenever the file format changes */
+    static constexpr bs::UINT32 FILE_VERSION = 1;
+
+    /** Heights in meters the cell spans in its sector */
+    struct CellRange
+    {
+      float minY;
+      float maxY;
+    };
+
+    struct Sector
+    {
+      bs::AABox bounds;
+      bool hasBounds = false;
+
+      /** Cell key -> Heights the sector covers there, see cellKey() */
+      bs::UnorderedMap<bs::UINT64, CellRange> cells;
+
+      bs::Vector<bs::UINT32> portals;
+    };
+
+    static bs::INT32 cellCoordinateOf(float value);
+    static bs::UINT64 cellKey(bs::INT32 x, bs::INT32 z);
+
+    /**
+     * @return Whether the given position is inside the cells of the given sector.
+     */
+    bool isInSector(const Sector& sector, const bs::Vector3& position) const;
+
+    void addToCell(Sector& sector, bs::INT32 x, bs::INT32 z, float minY, float maxY);
+
+    bs::Vector<Sector> mSectors;
+    bs::Vector<Portal> mPortals;
+
+    /** Portals with one side being OUTDOORS */
+    bs::Vector<bs::UINT32> mOutdoorPortals;
+  };
+}  // namespace REGoth
@@ -0,0 +1,181 @@
+#include "PortalVisibility.hpp"
+#include <Components/BsCRenderable.h>
+#include <Math/BsMatrix4.h>
+#include <Renderer/BsCamera.h>
+#include <Scene/BsSceneObject.h>
+#include <world/PortalMap.hpp>
+#include <algorithm>
+#include <limits>
+
+namespace REGoth
+{
+  constexpr bs::UINT64 PortalVisibility::CULLED_LAYER;
+
+  /**
+   * Portal corners closer to the camera plane than this can't be projected sensibly, in
+   * clip space. Portals with such a corner are treated as covering the whole screen.
+   */
+  static constexpr float MIN_CLIP_W = 0.01f;
+
+  void PortalVisibility::reset(bs::SPtr<const PortalMap> map)
+  {
+    for (Group& group : mGroups)
+    {
+      setGroupVisible(group, true);
+    }
+
+    mPortalMap = map;
+    mGroups.clear();
+    mStats = {};
+
+    if (!mPortalMap) return;
+
+    mGroups.resize(mPortalMap->numSectors() + 1);
+    mStats.numSectors = mPortalMap->numSectors();
+  }
+
+  void PortalVisibility::addStaticObject(bs::HSceneObject object)
+  {
+    if (!mPortalMap || mPortalMap->numSectors() == 0) return;
+
+    bs::HRenderable renderable = object->getComponent<bs::CRenderable>();
+
+    if (!renderable) return;
+
+    bs::AABox box = renderable->getBounds().getBox();
+
+    bs::UINT32 sector = mPortalMap->findSectorContaining(box);
+
+    // Partly inside: Visible from both sides
+    if (sector == PortalMap::OUTDOORS && mPortalMap->touchesAnySector(box)) return;
+
+    Group& group = mGroups[indexOf(sector)];
+
+    // Added visible, so the layer matches the group
+    setGroupVisible(group, true);
+
+    group.renderables.push_back({renderable, renderable->getLayer()});
+  }
+
+  void PortalVisibility::update(bs::Camera& camera)
+  {
+    if (camera.getLayers() & CULLED_LAYER)
+    {
+      camera.setLayers(camera.getLayers() & ~CULLED_LAYER);
+    }
+
+    if (!mPortalMap || mPortalMap->numSectors() == 0) return;
+
+    bs::Matrix4 viewProjection      = camera.getProjectionMatrix() * camera.getViewMatrix();
+    const bs::ConvexVolume& frustum = camera.getWorldFrustum();
+
+    mIsSectorVisible.assign(mGroups.size(), false);
+    mIsPortalPassed.assign(mPortalMap->numPortals(), false);
+    mOpenSectors.clear();
+
+    bs::UINT32 cameraSector = mPortalMap->findSectorAt(camera.getTransform().pos());
+
+    mIsSectorVisible[indexOf(cameraSector)] = true;
+    mOpenSectors.push_back({cameraSector, ScreenRect{}});
+
+    // Breadth first, so portals are passed with the largest view through them first
+    for (size_t open = 0; open < mOpenSectors.size(); open++)
+    {
+      bs::UINT32 sector      = mOpenSectors[open].first;
+      ScreenRect seenThrough = mOpenSectors[open].second;
+
+      for (bs::UINT32 index : mPortalMap->portalsOf(sector))
+      {
+        if (mIsPortalPassed[index]) continue;
+
+        const PortalMap::Portal& portal = mPortalMap->portal(index);
+
+        if (!frustum.intersects(portal.bounds)) continue;
+
+        ScreenRect through;
+
+        if (!projectPortal(viewProjection, portal.bounds, seenThrough, through)) continue;
+
+        bs::UINT32 other = portal.sectors[0] == sector ? portal.sectors[1] : portal.sectors[0];
+
+        mIsPortalPassed[index]           = true;
+        mIsSectorVisible[indexOf(other)] = true;
+
+        mOpenSectors.push_back({other, through});
+      }
+    }
+
+    mStats.numVisibleSectors = 0;
+    mStats.numCulledObjects  = 0;
+    mStats.isCameraIndoors   = cameraSector != PortalMap::OUTDOORS;
+
+    for (size_t i = 0; i < mGroups.size(); i++)
+    {
+      setGroupVisible(mGroups[i], mIsSectorVisible[i]);
+
+      if (mIsSectorVisible[i])
+      {
+        if (i < mPortalMap->numSectors()) mStats.numVisibleSectors += 1;
+      }
+      else
+      {
+        mStats.numCulledObjects += (bs::UINT32)mGroups[i].renderables.size();
+      }
+    }
+  }
+
+  bs::UINT32 PortalVisibility::indexOf(bs::UINT32 sector) const
+  {
+    return sector == PortalMap::OUTDOORS ? mPortalMap->numSectors() : sector;
+  }
+
+  void PortalVisibility::setGroupVisible(Group& group, bool isVisible)
+  {
+    if (group.isVisible == isVisible) return;
+
+    group.isVisible = isVisible;
+
+    for (const CulledRenderable& culled : group.renderables)
+    {
+      if (culled.renderable.isDestroyed()) continue;
+
+      culled.renderable->setLayer(isVisible ? culled.layer : CULLED_LAYER);
+    }
+  }
+
+  bool PortalVisibility::projectPortal(const bs::Matrix4& viewProjection,
+                                       const bs::AABox& bounds, const ScreenRect& seenThrough,
+                                       ScreenRect& result)
+  {
+    const float inf      = std::numeric_limits<float>::infinity();
+    ScreenRect projected = {inf, inf, -inf, -inf};
+
+    for (bs::UINT32 i = 0; i < 8; i++)
+    {
+      bs::Vector3 corner = bounds.getCorner((bs::AABox::Corner)i);
+      bs::Vector4 clip   = viewProjection.multiply(bs::Vector4(corner, 1.0f));
+
+      // The camera is right at the portal
+      if (clip.w < MIN_CLIP_W)
+      {
+        result = seenThrough;
+        return true;
+      }
+
+      float x = clip.x / clip.w;
+      float y = clip.y / clip.w;
+
+      projected.minX = std::min(projected.minX, x);
+      projected.minY = std::min(projected.minY, y);
+      projected.maxX = std::max(projected.maxX, x);
+      projected.maxY = std::max(projected.maxY, y);
+    }
+
+    result.minX = std::max(projected.minX, seenThrough.minX);
+    result.minY = std::max(projected.minY, seenThrough.minY);
+    result.maxX = std::min(projected.maxX, seenThrough.maxX);
+    result.maxY = std::min(projected.maxY, seenThrough.maxY);
+
+    return result.minX < result.maxX && result.minY < result.maxY;
+  }
+}  // namespace REGoth
@@ -0,0 +1,128 @@
+#pragma once
+#include <BsPrerequisites.h>
+
+namespace REGoth
+{
+  class PortalMap;
+
+  /**
+   * Hides the static parts of the world which can't be seen from where the camera is, because
+   * they are behind the walls of a building or the building is seen from the outside.
+   *
+   * Static objects are sorted once into the sector of the PortalMap they are inside of, the
+   * outdoors if they don't touch any sector, or are left alone if they are partly inside and
+   * partly outside. The latter is the case for most tiles of the world mesh containing
+   * buildings.
+   *
+   * Every update, the sectors are flooded starting at the one the camera is in: A neighbouring
+   * sector is visible if the portal leading there is inside the view frustum and overlaps the
+   * part of the screen the sector it is seen from is visible through. Each portal is only
+   * passed once per update. Objects in sectors which turned invisible are moved to
+   * CULLED_LAYER, which the camera doesn't render, and back once visible again.
+   *
+   * Every GameWorld has one. Not saved, the world sets it up again after loading, see reset().
+   */
+  class PortalVisibility
+  {
+  public:
+    /**
+     * How much of the world was visible at the last update.
+     */
+    struct Stats
+    {
+      bs::UINT32 numSectors        = 0;
+      bs::UINT32 numVisibleSectors = 0;
+      bs::UINT32 numCulledObjects  = 0;
+      bool isCameraIndoors         = false;
+    };
+
+    /** Layer of the renderables which are hidden right now */
+    static constexpr bs::UINT64 CULLED_LAYER = 1ULL << 63;
+
+    /**
+     * Forgets all static objects and shows them again.
+     *
+     * @param  map  Sectors and portals of the world. Nothing is culled without one.
+     */
+    void reset(bs::SPtr<const PortalMap> map);
+
+    /**
+     * Adds an object which doesn't move and has a renderable.
+     */
+    void addStaticObject(bs::HSceneObject object);
+
+    /**
+     * Hides and shows the static objects as seen from the given camera. Makes sure the camera
+     * doesn't render CULLED_LAYER.
+     */
+    void update(bs::Camera& camera);
+
+    const Stats& stats() const
+    {
+      return mStats;
+    }
+
+  private:
+    /**
+     * Part of the screen in normalized device coordinates.
+     */
+    struct ScreenRect
+    {
+      float minX = -1.0f;
+      float minY = -1.0f;
+      float maxX = 1.0f;
+      float maxY = 1.0f;
+    };
+
+    struct CulledRenderable
+    {
+      bs::HRenderable renderable;
+
+      /** Layer the renderable had before it was added */
+      bs::UINT64 layer;
+    };
+
+    /**
+     * Objects in the same sector or the outdoors.
+     */
+    struct Group
+    {
+      bs::Vector<CulledRenderable> renderables;
+
+      /** Whether the renderables are on their original layer. They are when they are added. */
+      bool isVisible = true;
+    };
+
+    /**
+     * @return Index of the given sector, which may be PortalMap::OUTDOORS, in mGroups and
+     *         mIsSectorVisible.
+     */
+    bs::UINT32 indexOf(bs::UINT32 sector) const;
+
+    /**
+     * Shows or hides the renderables of the given group, if it isn't already.
+     */
+    void setGroupVisible(Group& group, bool isVisible);
+
+    /**
+     * Projects the given portal bounds onto the screen and intersects the result with the
+     * given rectangle.
+     *
+     * @return Whether anything of the rectangle is left.
+     */
+    static bool projectPortal(const bs::Matrix4& viewProjection, const bs::AABox& bounds,
+                              const ScreenRect& seenThrough, ScreenRect& result);
+
+    bs::SPtr<const PortalMap> mPortalMap;
+
+    /** One per sector, followed by the one of the outdoors */
+    bs::Vector<Group> mGroups;
+
+    /** Reused for every update, so there are no allocations. Indexed like mGroups. */
+    bs::Vector<bool> mIsSectorVisible;
+    bs::Vector<bool> mIsPortalPassed;
+    bs::Vector<std::pair<bs::UINT32, ScreenRect>> mOpenSectors;
+
+    Stats mStats;
+  };
+}  // namespace REGoth
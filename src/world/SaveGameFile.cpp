@@ -0,0 +1,139 @@
+#include "SaveGameFile.hpp"
+#include <FileSystem/BsDataStream.h>
+#include <FileSystem/BsFileSystem.h>
+#include <Resources/BsResources.h>
+#include <Serialization/BsMemorySerializer.h>
+#include <Utility/BsCompression.h>
+#include <Utility/BsUtility.h>
+#include <cstring>
+#include <log/logging.hpp>
+
+namespace REGoth
+{
+  constexpr bs::UINT32 SaveGameFile::FILE_VERSION;
+
+  /**
+   * Start of a save game file, to recognize it and to know how large it is once decompressed.
+   */
+  struct SaveGameFileHeader
+  {
+    char magic[4]              = {'R', 'G', 'S', 'V'};
+    bs::UINT32 version         = 0;
+    bs::UINT64 numBytesDecoded = 0;
+  };
+
+  PendingSave SaveGameFile::writeAsync(bs::IReflectable& object, const bs::Path& path)
+  {
+    bs::UINT32 numBytes = 0;
+
+    bs::MemorySerializer serializer;
+    bs::UINT8* encoded = serializer.encode(&object, numBytes);
+
+    // Frees the buffer once the task is done with it
+    bs::SPtr<bs::DataStream> snapshot =
+        bs::bs_shared_ptr_new<bs::MemoryDataStream>(encoded, numBytes);
+
+    PendingSave save;
+    save.mState = bs::bs_shared_ptr_new<PendingSave::State>();
+
+    bs::SPtr<PendingSave::State> state = save.mState;
+
+    save.mTask = bs::Task::create("WriteSaveGame", [state, snapshot, path]() {
+      bs::SPtr<bs::DataStream> input = snapshot;
+
+      bs::SPtr<bs::MemoryDataStream> compressed = bs::Compression::compress(input, [&](float p) {
+        state->progress.store(p * 0.9f, std::memory_order_relaxed);
+      });
+
+      // Written next to it first, so a crash while writing doesn't leave half a save behind
+      bs::Path tempPath = path;
+      tempPath.setFilename(path.getFilename() + ".TMP");
+
+      bs::SPtr<bs::DataStream> stream =
+          compressed ? bs::FileSystem::createAndOpenFile(tempPath) : nullptr;
+
+      bool isWritten = false;
+
+      if (stream)
+      {
+        SaveGameFileHeader header;
+        header.version         = FILE_VERSION;
+        header.numBytesDecoded = input->size();
+
+        isWritten = stream->write(&header, sizeof(header)) == sizeof(header) &&
+                    stream->write(compressed->data(), compressed->size()) == compressed->size();
+
+        stream->close();
+
+        if (!isWritten)
+        {
+          bs::FileSystem::remove(tempPath);
+        }
+      }
+
+      if (isWritten)
+      {
+        bs::FileSystem::move(tempPath, path, true);
+
+        state->hasSucceeded.store(true, std::memory_order_release);
+      }
+      else
+      {
+        REGOTH_LOG(Warning, World, "[SaveGameFile] Failed to write {0}",
+                   path.toString());
+      }
+
+      state->progress.store(1.0f, std::memory_order_relaxed);
+      state->isDone.store(true, std::memory_order_release);
+    });
+
+    bs::TaskScheduler::instance().addTask(save.mTask);
+
+    return save;
+  }
+
+  bs::SPtr<bs::IReflectable> SaveGameFile::read(const bs::Path& path)
+  {
+    if (!bs::FileSystem::exists(path)) return nullptr;
+
+    bs::SPtr<bs::DataStream> stream = bs::FileSystem::openFile(path, true);
+
+    if (!stream) return nullptr;
+
+    SaveGameFileHeader header;
+    SaveGameFileHeader expected;
+
+    if (stream->read(&header, sizeof(header)) != sizeof(header)) return nullptr;
+
+    if (std::memcmp(header.magic, expected.magic, sizeof(header.magic)) != 0) return nullptr;
+    if (header.version != FILE_VERSION) return nullptr;
+
+    bs::SPtr<bs::DataStream> decompressed = bs::Compression::decompress(stream);
+
+    if (!decompressed || decompressed->size() != header.numBytesDecoded)
+    {
+      REGOTH_LOG(Warning, World, "[SaveGameFile] {0} is broken", path.toString());
+      return nullptr;
+    }
+
+    bs::Vector<bs::UINT8> buffer(decompressed->size());
+    decompressed->read(buffer.data(), buffer.size());
+
+    bs::MemorySerializer serializer;
+    bs::SPtr<bs::IReflectable> object =
+        serializer.decode(buffer.data(), (bs::UINT32)buffer.size());
+
+    if (!object) return nullptr;
+
+    // bs::Resources would do this when loading a resource saved through it
+    for (const bs::ResourceDependency& dependency : bs::Utility::findResourceDependencies(*object))
+    {
+      if (!dependency.resource.isLoaded(false))
+      {
+        bs::gResources().loadFromUUID(dependency.resource.getUUID());
+      }
+    }
+
+    return object;
+  }
+}  // namespace REGoth
@@ -0,0 +1,119 @@
+/** \file
+ */
+
+#pragma once
+
+#include <atomic>
+#include <BsPrerequisites.h>
+#include <Threading/BsTaskScheduler.h>
+
+namespace REGoth
+{
+  /**
+   * Save being compressed and written in the background, see GameWorld::saveDeltaAsync().
+   * Check isDone() once per frame, e.g. to show progress() in the UI and to tell the player
+   * once it is. Dropping this does not cancel the save.
+   */
+  class PendingSave
+  {
+  public:
+    PendingSave() = default;
+
+    /**
+     * @return Whether a save has been started at all.
+     */
+    bool isRequested() const
+    {
+      return mState != nullptr;
+    }
+
+    /**
+     * @return Whether writing has finished, successfully or not. Also true if nothing has been
+     *         started.
+     */
+    bool isDone() const
+    {
+      return !mState || mState->isDone.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @return Whether writing has finished and the save is on disk.
+     */
+    bool hasSucceeded() const
+    {
+      return mState && isDone() && mState->hasSucceeded.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @return How far along the save is, from 0 to 1.
+     */
+    float progress() const
+    {
+      if (!mState) return 1.0f;
+
+      return mState->progress.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Blocks until writing has finished, e.g. before quitting the game.
+     *
+     * @return Whether the save is on disk.
+     */
+    bool wait() const
+    {
+      if (!mState) return false;
+
+      mTask->wait();
+
+      return hasSucceeded();
+    }
+
+  private:
+    friend class SaveGameFile;
+
+    struct State
+    {
+      std::atomic<bool> isDone{false};
+      std::atomic<bool> hasSucceeded{false};
+      std::atomic<float> progress{0.0f};
+    };
+
+    // The task owns the state, so the save goes on if nobody waits for it
+    bs::SPtr<State> mState;
+    bs::SPtr<bs::Task> mTask;
+  };
+
+  /**
+   * File holding a serialized object, compressed, such as the prefab of a delta save.
+   *
+   * Unlike saving a resource via bs::Resources, encoding and writing are split: The object
+   * is encoded into memory right away, so what ends up in the file is the state at the time
+   * of the call. Compressing and writing that buffer is the slow part and happens on a
+   * background thread, so saving while playing doesn't hitch.
+   */
+  class SaveGameFile
+  {
+  public:
+    /**
+     * Encodes the given object on this thread, then compresses and writes it to the given
+     * path in the background.
+     *
+     * @param  object  Object to save. Not needed anymore once this returns.
+     * @param  path    Where to save to. Overwritten once the save has been written completely,
+     *                 so it always holds either the old or the new save.
+     */
+    static PendingSave writeAsync(bs::IReflectable& object, const bs::Path& path);
+
+    /**
+     * Reads an object written via writeAsync(). Resources it refers to are loaded as well.
+     *
+     * @return The object. nullptr if the file doesn't exist or is broken.
+     */
+    static bs::SPtr<bs::IReflectable> read(const bs::Path& path);
+
+    /**
+     * Bump this whenever something about the format changes, so older files are not read.
+     */
+    static constexpr bs::UINT32 FILE_VERSION = 1;
+  };
+}  // namespace REGoth
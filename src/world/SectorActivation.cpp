@@ -0,0 +1,241 @@
+#include "SectorActivation.hpp"
+#include <Scene/BsSceneObject.h>
+#include <Utility/BsTime.h>
+#include <components/Character.hpp>
+#include <components/CharacterAI.hpp>
+#include <components/GameWorld.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+namespace REGoth
+{
+  constexpr float SectorActivation::SECTOR_SIZE;
+  constexpr bs::INT32 SectorActivation::ACTIVE_SECTOR_RADIUS;
+  constexpr float SectorActivation::SHRINK_RANGE;
+  constexpr float SectorActivation::UNSHRINK_RANGE;
+  constexpr float SectorActivation::CHARACTER_CHECK_INTERVAL;
+
+  void SectorActivation::addStaticVob(bs::HSceneObject vob)
+  {
+    const bs::Vector3& position = vob->getTransform().pos();
+
+    bs::INT32 x = sectorCoordinateOf(position.x);
+    bs::INT32 z = sectorCoordinateOf(position.z);
+
+    auto it = mSectors.find(sectorKey(x, z));
+
+    if (it == mSectors.end())
+    {
+      Sector sector;
+      sector.x = x;
+      sector.z = z;
+
+      it = mSectors.emplace(sectorKey(x, z), std::move(sector)).first;
+
+      // The next update needs to decide about this sector as well
+      mHasHeroSector = false;
+    }
+
+    it->second.vobs.push_back(vob);
+  }
+
+  void SectorActivation::onCharacterInserted(HCharacter character)
+  {
+    mActiveCharacters.push_back(character);
+  }
+
+  void SectorActivation::removeCharacter(HCharacter character)
+  {
+    for (size_t i = 0; i < mActiveCharacters.size(); i++)
+    {
+      if (mActiveCharacters[i] != character) continue;
+
+      mActiveCharacters[i] = mActiveCharacters.back();
+      mActiveCharacters.pop_back();
+
+      return;
+    }
+  }
+
+  void SectorActivation::reset(const bs::Vector<HCharacter>& characters)
+  {
+    mSectors.clear();
+    mActiveSectors.clear();
+    mActiveCharacters.clear();
+
+    mHasHeroSector           = false;
+    mTimeUntilCharacterCheck = 0.0f;
+
+    for (const HCharacter& character : characters)
+    {
+      if (character.isDestroyed()) continue;
+
+      auto ai = character->ai();
+
+      if (ai && ai->isPhysicsActive())
+      {
+        mActiveCharacters.push_back(character);
+      }
+    }
+  }
+
+  void SectorActivation::update(const bs::Vector3& heroPosition)
+  {
+    float now        = bs::gTime().getTime();
+    float timePassed = mLastUpdateTime < 0.0f ? 0.0f : now - mLastUpdateTime;
+    mLastUpdateTime  = now;
+
+    updateSectors(sectorCoordinateOf(heroPosition.x), sectorCoordinateOf(heroPosition.z));
+
+    mTimeUntilCharacterCheck -= timePassed;
+
+    if (mTimeUntilCharacterCheck <= 0.0f)
+    {
+      mTimeUntilCharacterCheck = CHARACTER_CHECK_INTERVAL;
+
+      updateCharacters(heroPosition);
+    }
+
+    mStats.numActiveCharacters = (bs::UINT32)mActiveCharacters.size();
+    mStats.numActiveSectors    = (bs::UINT32)mActiveSectors.size();
+    mStats.numSectors          = (bs::UINT32)mSectors.size();
+  }
+
+  void SectorActivation::updateSectors(bs::INT32 heroX, bs::INT32 heroZ)
+  {
+    auto distanceToHero = [&](const Sector& sector) {
+      return std::max(std::abs(sector.x - heroX), std::abs(sector.z - heroZ));
+    };
+
+    if (!mHasHeroSector)
+    {
+      // Nothing known about the state of the sectors, so look at every one of them
+      mActiveSectors.clear();
+
+      for (auto& it : mSectors)
+      {
+        Sector& sector = it.second;
+        bool isActive  = distanceToHero(sector) <= ACTIVE_SECTOR_RADIUS;
+
+        // Vobs loaded from a save might not be in the state the sector thinks they are
+        sector.isActive = !isActive;
+        setSectorActive(sector, isActive);
+
+        if (isActive) mActiveSectors.push_back(it.first);
+      }
+    }
+    else if (heroX != mHeroSectorX || heroZ != mHeroSectorZ)
+    {
+      // Anything too far away now must have been active before
+      for (size_t i = 0; i < mActiveSectors.size();)
+      {
+        Sector& sector = mSectors[mActiveSectors[i]];
+
+        if (distanceToHero(sector) > ACTIVE_SECTOR_RADIUS + 1)
+        {
+          setSectorActive(sector, false);
+
+          mActiveSectors[i] = mActiveSectors.back();
+          mActiveSectors.pop_back();
+        }
+        else
+        {
+          i += 1;
+        }
+      }
+
+      for (bs::INT32 z = heroZ - ACTIVE_SECTOR_RADIUS; z <= heroZ + ACTIVE_SECTOR_RADIUS; z++)
+      {
+        for (bs::INT32 x = heroX - ACTIVE_SECTOR_RADIUS; x <= heroX + ACTIVE_SECTOR_RADIUS; x++)
+        {
+          auto it = mSectors.find(sectorKey(x, z));
+
+          if (it == mSectors.end() || it->second.isActive) continue;
+
+          setSectorActive(it->second, true);
+          mActiveSectors.push_back(it->first);
+        }
+      }
+    }
+
+    mHasHeroSector = true;
+    mHeroSectorX   = heroX;
+    mHeroSectorZ   = heroZ;
+  }
+
+  void SectorActivation::updateCharacters(const bs::Vector3& heroPosition)
+  {
+    if (!mWorld) return;
+
+    const float shrinkRangeSq = SHRINK_RANGE * SHRINK_RANGE;
+
+    for (size_t i = 0; i < mActiveCharacters.size();)
+    {
+      const HCharacter& character = mActiveCharacters[i];
+
+      bool isGone = true;
+
+      if (!character.isDestroyed())
+      {
+        auto ai = character->ai();
+
+        // Might have been shrunk by someone else
+        isGone = !ai || !ai->isPhysicsActive();
+
+        if (!isGone &&
+            character->SO()->getTransform().pos().squaredDistance(heroPosition) > shrinkRangeSq)
+        {
+          ai->deactivatePhysics();
+          isGone = true;
+        }
+      }
+
+      if (isGone)
+      {
+        mActiveCharacters[i] = mActiveCharacters.back();
+        mActiveCharacters.pop_back();
+      }
+      else
+      {
+        i += 1;
+      }
+    }
+
+    mWorld->findCharactersInRange(UNSHRINK_RANGE, heroPosition, mNearbyCharacters);
+
+    for (const HCharacter& character : mNearbyCharacters)
+    {
+      auto ai = character->ai();
+
+      if (!ai || ai->isPhysicsActive()) continue;
+
+      ai->activatePhysics();
+      mActiveCharacters.push_back(character);
+    }
+  }
+
+  void SectorActivation::setSectorActive(Sector& sector, bool isActive)
+  {
+    if (sector.isActive == isActive) return;
+
+    for (const bs::HSceneObject& vob : sector.vobs)
+    {
+      if (vob.isDestroyed()) continue;
+
+      vob->setActive(isActive);
+    }
+
+    sector.isActive = isActive;
+  }
+
+  bs::INT32 SectorActivation::sectorCoordinateOf(float value)
+  {
+    return (bs::INT32)std::floor(value / SECTOR_SIZE);
+  }
+
+  bs::UINT64 SectorActivation::sectorKey(bs::INT32 x, bs::INT32 z)
+  {
+    return ((bs::UINT64)(bs::UINT32)x << 32) | (bs::UINT32)z;
+  }
+}  // namespace REGoth
@@ -0,0 +1,163 @@
+#pragma once
+#include <BsPrerequisites.h>
+
+namespace REGoth
+{
+  class GameWorld;
+  using HGameWorld = bs::GameObjectHandle<GameWorld>;
+
+  class Character;
+  using HCharacter = bs::GameObjectHandle<Character>;
+
+  /**
+   * Keeps only the part of the world around the hero fully simulated.
+   *
+   * Characters far away from the hero are *shrunk*, like in the original engine: Their
+   * physics are turned off via CharacterAI::deactivatePhysics(), so they only follow their
+   * routines, see ScriptState::doAIStateDuringShrink(). Routes they walk are followed without
+   * physics or animations, see CharacterAI::moveKinematicTowards(). To not have characters
+   * on the edge pop in and out of range every other frame, they are shrunk at a larger
+   * distance than they are un-shrunk again. Only the characters which aren't shrunk and those
+   * near the hero are looked at, a few times per second.
+   *
+   * Static vobs, i.e. those which only have a visual and maybe a collider, are sorted into
+   * square sectors along the X- and Z-axis once. Whenever the hero enters a new sector, the
+   * scene objects of the vobs in sectors which got too far away are deactivated, which turns
+   * off their renderables and colliders, and those which came close are activated again.
+   *
+   * Every GameWorld has one, see GameWorld::sectorActivation(). Not saved, the world sets it
+   * up again after loading, see reset().
+   */
+  class SectorActivation
+  {
+  public:
+    /**
+     * How much work the last update was and how much of the world is active.
+     */
+    struct Stats
+    {
+      bs::UINT32 numActiveCharacters = 0;
+      bs::UINT32 numActiveSectors    = 0;
+      bs::UINT32 numSectors          = 0;
+    };
+
+    /** Length of a side of a sector in meters */
+    static constexpr float SECTOR_SIZE = 25.0f;
+
+    /**
+     * How many sectors in each direction around the sector of the hero have their vobs active.
+     * Sectors are deactivated again once they are one more sector away.
+     */
+    static constexpr bs::INT32 ACTIVE_SECTOR_RADIUS = 3;
+
+    /**
+     * Characters further away from the hero than this are shrunk, in meters. Must be
+     * larger than UNSHRINK_RANGE.
+     */
+    static constexpr float SHRINK_RANGE = 45.0f;
+
+    /** Characters closer to the hero than this are un-shrunk, in meters */
+    static constexpr float UNSHRINK_RANGE = 40.0f;
+
+    /** Seconds between two checks of which characters to shrink or un-shrink */
+    static constexpr float CHARACTER_CHECK_INTERVAL = 0.25f;
+
+    /**
+     * Sets the world whose characters are shrunk and un-shrunk.
+     */
+    void setWorld(HGameWorld world)
+    {
+      mWorld = world;
+    }
+
+    /**
+     * Adds a vob which doesn't move and only has a visual and maybe a collider.
+     */
+    void addStaticVob(bs::HSceneObject vob);
+
+    /**
+     * To be called for every new character. Those start un-shrunk.
+     */
+    void onCharacterInserted(HCharacter character);
+
+    /**
+     * Forgets about the given character, e.g. because it has been destroyed.
+     */
+    void removeCharacter(HCharacter character);
+
+    /**
+     * Forgets which characters are active and which sectors are, so the next update() looks
+     * at the whole world again. Also forgets all static vobs.
+     *
+     * @param  characters  All characters of the world.
+     */
+    void reset(const bs::Vector<HCharacter>& characters);
+
+    /**
+     * Shrinks, un-shrinks, activates and deactivates what needs to be for the hero being at
+     * the given position.
+     */
+    void update(const bs::Vector3& heroPosition);
+
+    const Stats& stats() const
+    {
+      return mStats;
+    }
+
+  private:
+    struct Sector
+    {
+      bs::INT32 x;
+      bs::INT32 z;
+
+      bs::Vector<bs::HSceneObject> vobs;
+
+      /** Whether the vobs are active right now. They all are when they are added. */
+      bool isActive = true;
+    };
+
+    static bs::INT32 sectorCoordinateOf(float value);
+    static bs::UINT64 sectorKey(bs::INT32 x, bs::INT32 z);
+
+    /**
+     * Activates or deactivates the vobs of the given sector, if it isn't already.
+     */
+    void setSectorActive(Sector& sector, bool isActive);
+
+    /**
+     * Does the sector part of update(), for the hero being in the given sector.
+     */
+    void updateSectors(bs::INT32 heroX, bs::INT32 heroZ);
+
+    /**
+     * Does the character part of update().
+     */
+    void updateCharacters(const bs::Vector3& heroPosition);
+
+    HGameWorld mWorld;
+
+    bs::UnorderedMap<bs::UINT64, Sector> mSectors;
+
+    /** Keys of the sectors which are active right now */
+    bs::Vector<bs::UINT64> mActiveSectors;
+
+    /** Sector the hero was in at the last update, if there was one since reset() */
+    bool mHasHeroSector = false;
+    bs::INT32 mHeroSectorX = 0;
+    bs::INT32 mHeroSectorZ = 0;
+
+    /**
+     * Characters which aren't shrunk. Characters only ever get un-shrunk when they are near
+     * the hero, so only these need to be looked at to find those to shrink.
+     */
+    bs::Vector<HCharacter> mActiveCharacters;
+
+    /** Reused for every check, so there are no allocations */
+    bs::Vector<HCharacter> mNearbyCharacters;
+
+    float mTimeUntilCharacterCheck = 0.0f;
+    float mLastUpdateTime          = -1.0f;
+
+    Stats mStats;
+  };
+}  // namespace REGoth
@@ -0,0 +1,224 @@
+#pragma once
+#include <BsPrerequisites.h>
+#include <cmath>
+
+namespace REGoth
+{
+  /**
+   * Grid over the world to quickly find the objects near some position, like all characters
+   * within a few meters of another one.
+   *
+   * The world is divided into square cells along the X- and Z-axis, height doesn't matter.
+   * Only cells with objects in them exist, so the size of the world doesn't matter either.
+   * Each object is stored in the cell its position is in, together with that position,
+   * so finding objects in a range only looks at the objects of the cells touching it.
+   *
+   * Objects don't register their position with the grid by themselves. Whoever moves them
+   * has to tell the grid via move().
+   *
+   * @tparam  Handle  Handle to the objects, e.g. HCharacter.
+   */
+  template <typename Handle>
+  class SpatialHash
+  {
+  public:
+    /**
+     * @param  cellSize  Length of a side of a cell in meters. Should be around the range of
+     *                   most searches, so they only need to look at a few cells.
+     */
+    SpatialHash(float cellSize = 10.0f)
+        : mCellSize(cellSize)
+    {
+    }
+
+    /**
+     * Adds an object at the given position. If it already is in the grid, it is moved there.
+     */
+    void insert(const Handle& object, const bs::Vector3& position)
+    {
+      move(object, position);
+    }
+
+    /**
+     * Updates the position of the given object. Objects not in the grid yet are added.
+     */
+    void move(const Handle& object, const bs::Vector3& position)
+    {
+      bs::UINT64 id      = object.getInstanceId();
+      bs::UINT64 newCell = cellOf(position);
+
+      auto it = mCellsByObject.find(id);
+
+      if (it != mCellsByObject.end())
+      {
+        if (it->second == newCell)
+        {
+          findEntry(newCell, id).position = position;
+          return;
+        }
+
+        removeEntry(it->second, id);
+        it->second = newCell;
+      }
+      else
+      {
+        mCellsByObject[id] = newCell;
+      }
+
+      mCells[newCell].push_back({object, position});
+    }
+
+    /**
+     * Removes the given object. Does nothing if it isn't in the grid.
+     */
+    void remove(const Handle& object)
+    {
+      auto it = mCellsByObject.find(object.getInstanceId());
+
+      if (it == mCellsByObject.end()) return;
+
+      removeEntry(it->second, it->first);
+      mCellsByObject.erase(it);
+    }
+
+    void clear()
+    {
+      mCells.clear();
+      mCellsByObject.clear();
+    }
+
+    /**
+     * Finds all objects closer than `range` to the given position, in no particular order.
+     *
+     * @param  result  Filled with the objects found. Anything in there is dropped, so the
+     *                 same vector can be passed again and again without allocating. Any
+     *                 vector of handles works, like a ScratchVector.
+     */
+    template <typename Result>
+    void findInRange(const bs::Vector3& around, float range, Result& result) const
+    {
+      result.clear();
+
+      float rangeSq = range * range;
+
+      auto visit = [&](const Cell& cell) {
+        for (const Entry& entry : cell)
+        {
+          if (entry.position.squaredDistance(around) < rangeSq)
+          {
+            result.push_back(entry.object);
+          }
+        }
+      };
+
+      // Covering more cells than there are? Then just look at all of them, which also
+      // handles ranges too large for cell coordinates, like infinity.
+      float cellsAcross = 2.0f * range / mCellSize + 1.0f;
+
+      if (!(cellsAcross * cellsAcross < (float)mCells.size()))
+      {
+        for (const auto& cell : mCells)
+        {
+          visit(cell.second);
+        }
+
+        return;
+      }
+
+      bs::INT32 minX = cellCoordinateOf(around.x - range);
+      bs::INT32 maxX = cellCoordinateOf(around.x + range);
+      bs::INT32 minZ = cellCoordinateOf(around.z - range);
+      bs::INT32 maxZ = cellCoordinateOf(around.z + range);
+
+      for (bs::INT32 x = minX; x <= maxX; x++)
+      {
+        for (bs::INT32 z = minZ; z <= maxZ; z++)
+        {
+          auto it = mCells.find(cellKey(x, z));
+
+          if (it != mCells.end())
+          {
+            visit(it->second);
+          }
+        }
+      }
+    }
+
+    /**
+     * @return Number of objects in the grid.
+     */
+    size_t size() const
+    {
+      return mCellsByObject.size();
+    }
+
+  private:
+    struct Entry
+    {
+      Handle object;
+      bs::Vector3 position;
+    };
+
+    using Cell = bs::Vector<Entry>;
+
+    bs::INT32 cellCoordinateOf(float value) const
+    {
+      return (bs::INT32)std::floor(value / mCellSize);
+    }
+
+    static bs::UINT64 cellKey(bs::INT32 x, bs::INT32 z)
+    {
+      return ((bs::UINT64)(bs::UINT32)x << 32) | (bs::UINT32)z;
+    }
+
+    bs::UINT64 cellOf(const bs::Vector3& position) const
+    {
+      return cellKey(cellCoordinateOf(position.x), cellCoordinateOf(position.z));
+    }
+
+    Entry& findEntry(bs::UINT64 cell, bs::UINT64 id)
+    {
+      Cell& entries = mCells[cell];
+
+      for (Entry& entry : entries)
+      {
+        if (entry.object.getInstanceId() == id) return entry;
+      }
+
+      // mCellsByObject says it's here, so this can't happen
+      return entries.front();
+    }
+
+    void removeEntry(bs::UINT64 cell, bs::UINT64 id)
+    {
+      auto it = mCells.find(cell);
+
+      if (it == mCells.end()) return;
+
+      Cell& entries = it->second;
+
+      for (size_t i = 0; i < entries.size(); i++)
+      {
+        if (entries[i].object.getInstanceId() != id) continue;
+
+        // Order doesn't matter, so don't move everything behind it
+        entries[i] = std::move(entries.back());
+        entries.pop_back();
+        break;
+      }
+
+      // Keep only cells with objects, so looking at all of them stays cheap
+      if (entries.empty())
+      {
+        mCells.erase(it);
+      }
+    }
+
+    float mCellSize;
+
+    bs::UnorderedMap<bs::UINT64, Cell> mCells;
+
+    /** Cell each object is in, by the instance ID of the object */
+    bs::UnorderedMap<bs::UINT64, bs::UINT64> mCellsByObject;
+  };
+}  // namespace REGoth
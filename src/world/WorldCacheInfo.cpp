@@ -0,0 +1,180 @@
+#include "WorldCacheInfo.hpp"
+#include <FileSystem/BsFileSystem.h>
+#include <RTTI/RTTI_WorldCacheInfo.hpp>
+#include <Scene/BsSceneObject.h>
+#include <Serialization/BsFileSerializer.h>
+#include <components/VisualStaticMesh.hpp>
+#include <log/logging.hpp>
+#include <original-content/VirtualFileSystem.hpp>
+
+namespace REGoth
+{
+  constexpr bs::UINT32 WorldCacheInfo::VERSION;
+
+  /**
+   * Script file whose state ends up in a cached world, see GameWorld::initScriptVM().
+   */
+  static const char* const WORLD_SCRIPT_FILE = "GOTHIC.DAT";
+
+  /**
+   * Start of a 64-bit FNV-1a hash. Only has to tell different versions of the same file apart.
+   */
+  constexpr bs::UINT64 HASH_OFFSET_BASIS = 14695981039346656037ULL;
+  constexpr bs::UINT64 HASH_PRIME        = 1099511628211ULL;
+
+  static bs::UINT64 hashFile(const bs::String& file, bs::UINT64 hash = HASH_OFFSET_BASIS);
+  static bs::UINT64 hashVisual(const bs::String& visual);
+
+  bs::SPtr<WorldCacheInfo> WorldCacheInfo::describe(const bs::String& zenFile, bool isStreamed,
+                                                    bs::HSceneObject root)
+  {
+    auto info = bs::bs_shared_ptr_new<WorldCacheInfo>();
+
+    info->zenFile    = zenFile;
+    info->zenHash    = hashFile(zenFile);
+    info->scriptHash = hashFile(WORLD_SCRIPT_FILE);
+    info->isStreamed = isStreamed;
+
+    bs::Vector<bs::HSceneObject> open = {root};
+
+    while (!open.empty())
+    {
+      bs::HSceneObject so = open.back();
+      open.pop_back();
+
+      for (bs::UINT32 i = 0; i < so->getNumChildren(); i++)
+      {
+        open.push_back(so->getChild(i));
+      }
+
+      HVisualStaticMesh visual = so->getComponent<VisualStaticMesh>();
+
+      if (!visual) continue;
+
+      for (const bs::String& file : visual->meshFileNames())
+      {
+        if (info->visualHashes.find(file) != info->visualHashes.end()) continue;
+
+        info->visualHashes[file] = hashVisual(file);
+      }
+    }
+
+    return info;
+  }
+
+  bs::Path WorldCacheInfo::pathFor(const bs::Path& cachePath)
+  {
+    bs::Path path = cachePath;
+    path.setFilename(cachePath.getFilename() + ".INFO");
+
+    return path;
+  }
+
+  bs::SPtr<WorldCacheInfo> WorldCacheInfo::load(const bs::Path& path)
+  {
+    if (!bs::FileSystem::exists(path)) return nullptr;
+
+    bs::SPtr<bs::IReflectable> decoded;
+
+    try
+    {
+      bs::FileDecoder decoder(path);
+      decoded = decoder.decode();
+    }
+    catch (const std::exception& e)
+    {
+      REGOTH_LOG(Warning, World, "[WorldCacheInfo] Failed to read {0}: {1}",
+                 path.toString(), e.what());
+      return nullptr;
+    }
+
+    if (!decoded || !bs::rtti_is_of_type<WorldCacheInfo>(decoded.get()))
+    {
+      REGOTH_LOG(Warning, World, "[WorldCacheInfo] {0} is not a world cache info",
+                 path.toString());
+      return nullptr;
+    }
+
+    return std::static_pointer_cast<WorldCacheInfo>(decoded);
+  }
+
+  void WorldCacheInfo::save(const bs::Path& path) const
+  {
+    bs::FileEncoder encoder(path);
+    encoder.encode(const_cast<WorldCacheInfo*>(this));
+  }
+
+  WorldCacheInfo::Staleness WorldCacheInfo::compareWithGameFiles(
+      const bs::String& zenFile, bool isStreamed, bs::Vector<bs::String>& changedVisuals) const
+  {
+    changedVisuals.clear();
+
+    // Static meshes are cached on their own, so those which changed are outdated either way
+    for (const auto& v : visualHashes)
+    {
+      if (hashVisual(v.first) != v.second)
+      {
+        changedVisuals.push_back(v.first);
+      }
+    }
+
+    if (version != VERSION || this->zenFile != zenFile || zenHash != hashFile(zenFile))
+    {
+      return Staleness::ZenChanged;
+    }
+
+    if (this->isStreamed != isStreamed || scriptHash != hashFile(WORLD_SCRIPT_FILE))
+    {
+      return Staleness::ScriptsChanged;
+    }
+
+    return changedVisuals.empty() ? Staleness::UpToDate : Staleness::VisualsChanged;
+  }
+
+  /**
+   * Adds the contents of the given file from the virtual file system to the given hash. The
+   * file name goes in too, so a file moving to another name counts as a change. Files which
+   * don't exist don't change the hash.
+   */
+  static bs::UINT64 hashFile(const bs::String& file, bs::UINT64 hash)
+  {
+    if (!gVirtualFileSystem().hasFile(file)) return hash;
+
+    FileView data = gVirtualFileSystem().viewFile(file);
+
+    for (char c : file)
+    {
+      hash ^= (bs::UINT8)c;
+      hash *= HASH_PRIME;
+    }
+
+    for (bs::UINT8 byte : data)
+    {
+      hash ^= byte;
+      hash *= HASH_PRIME;
+    }
+
+    return hash;
+  }
+
+  /**
+   * The original game ships its static meshes compiled, while mods might ship the files they
+   * were made from, so the importer looks for both.
+   *
+   * @return Hash of all files the given static mesh can be imported from.
+   */
+  static bs::UINT64 hashVisual(const bs::String& visual)
+  {
+    bs::String base = visual.substr(0, visual.find_last_of('.'));
+
+    bs::UINT64 hash = HASH_OFFSET_BASIS;
+
+    hash = hashFile(visual, hash);
+    hash = hashFile(base + ".MRM", hash);
+    hash = hashFile(base + ".MSH", hash);
+
+    return hash;
+  }
+
+  REGOTH_DEFINE_RTTI(WorldCacheInfo)
+}  // namespace REGoth
@@ -0,0 +1,119 @@
+/** \file
+ */
+
+#pragma once
+
+#include <BsPrerequisites.h>
+#include <RTTI/RTTIUtil.hpp>
+#include <Reflection/BsIReflectable.h>
+
+namespace REGoth
+{
+  /**
+   * What a cached world has been built from, stored next to it, see GameWorld::save().
+   *
+   * Caches of a world were only ever checked for being there, so after the game files or
+   * the import code changed, an outdated world was loaded until the cache got deleted by
+   * hand. With this, a cache is checked against the original files it came from, see
+   * compareWithGameFiles():
+   *
+   *  - If the ZEN, the scripts, the import settings or VERSION differ, the world has to be
+   *    imported again.
+   *  - If only some of the static meshes shown in the world differ, only the vobs showing
+   *    those need to be updated.
+   *
+   * Everything is compared by a hash of the file contents, so touching a file without
+   * changing it doesn't invalidate anything.
+   */
+  class WorldCacheInfo : public bs::IReflectable
+  {
+  public:
+    /**
+     * Version of the world import. Has to be increased whenever something about how worlds
+     * are imported or cached changes, so that old caches are not used anymore.
+     */
+    static constexpr bs::UINT32 VERSION = 3;
+
+    /**
+     * How a cache compares to the game files, see compareWithGameFiles().
+     */
+    enum class Staleness
+    {
+      /** Can be used as it is */
+      UpToDate,
+
+      /** Only the static meshes in changedVisuals differ */
+      VisualsChanged,
+
+      /** The world has to be imported again, but what has been cached for the ZEN is fine */
+      ScriptsChanged,
+
+      /** The world has to be imported again, including everything cached for the ZEN */
+      ZenChanged,
+    };
+
+    WorldCacheInfo() = default;
+
+    /**
+     * Describes what the given world built from the given ZEN now consists of.
+     *
+     * @param  zenFile     ZEN-file the world was imported from, e.g. `NEWWORLD.ZEN`.
+     * @param  isStreamed  Whether the static parts of the world are streamed in. Those are
+     *                     cached by WorldStreaming and only rebuilt when the ZEN changes.
+     * @param  root        Scene object of the world. The static meshes of all
+     *                     VisualStaticMesh-components below are looked at.
+     */
+    static bs::SPtr<WorldCacheInfo> describe(const bs::String& zenFile, bool isStreamed,
+                                             bs::HSceneObject root);
+
+    /**
+     * @return Where the information for the cache saved at the given path goes.
+     */
+    static bs::Path pathFor(const bs::Path& cachePath);
+
+    /**
+     * @return The information saved at the given path. Empty if there is none or it can't
+     *         be read.
+     */
+    static bs::SPtr<WorldCacheInfo> load(const bs::Path& path);
+
+    void save(const bs::Path& path) const;
+
+    /**
+     * Compares this with what the game files contain now.
+     *
+     * @param  zenFile         ZEN-file the world should be imported from.
+     * @param  isStreamed      Whether the world should be streamed in.
+     * @param  changedVisuals  Filled with the static meshes which differ. Their cached
+     *                         versions are outdated, no matter what else differs.
+     */
+    Staleness compareWithGameFiles(const bs::String& zenFile, bool isStreamed,
+                                   bs::Vector<bs::String>& changedVisuals) const;
+
+    /**
+     * Format version the information has been saved with.
+     */
+    bs::UINT32 version = VERSION;
+
+    bs::String zenFile;
+
+    /**
+     * Hash of the ZEN-file's contents.
+     */
+    bs::UINT64 zenHash = 0;
+
+    /**
+     * Hash of the scripts. A cached world usually has its init scripts run already.
+     */
+    bs::UINT64 scriptHash = 0;
+
+    bool isStreamed = false;
+
+    /**
+     * Hash of the original files of each static mesh shown in the world, by file name.
+     */
+    bs::Map<bs::String, bs::UINT64> visualHashes;
+
+    REGOTH_DECLARE_RTTI_FOR_REFLECTABLE(WorldCacheInfo)
+  };
+}  // namespace REGoth
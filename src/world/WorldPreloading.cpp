@@ -0,0 +1,139 @@
+#include "WorldPreloading.hpp"
+#include <FileSystem/BsFileSystem.h>
+#include <Resources/BsResources.h>
+#include <Scene/BsPrefab.h>
+#include <Scene/BsSceneObject.h>
+#include <Utility/BsTime.h>
+#include <components/GameWorld.hpp>
+#include <components/LevelChangeTrigger.hpp>
+#include <log/logging.hpp>
+
+namespace REGoth
+{
+  constexpr float WorldPreloading::PRELOAD_RANGE;
+  constexpr float WorldPreloading::RELEASE_RANGE;
+  constexpr float WorldPreloading::CHECK_INTERVAL;
+
+  void WorldPreloading::reset()
+  {
+    while (!mPreloaded.empty())
+    {
+      release(mPreloaded.begin()->first);
+    }
+
+    mTriggers.clear();
+
+    mTimeUntilCheck = 0.0f;
+
+    mStats = {};
+  }
+
+  void WorldPreloading::addTrigger(HLevelChangeTrigger trigger)
+  {
+    mTriggers.push_back(trigger);
+
+    mStats.numTriggers = (bs::UINT32)mTriggers.size();
+  }
+
+  void WorldPreloading::update(const bs::Vector3& heroPosition)
+  {
+    float now        = bs::gTime().getTime();
+    float timePassed = mLastUpdateTime < 0.0f ? 0.0f : now - mLastUpdateTime;
+    mLastUpdateTime  = now;
+
+    mTimeUntilCheck -= timePassed;
+
+    if (mTimeUntilCheck > 0.0f) return;
+
+    mTimeUntilCheck = CHECK_INTERVAL;
+
+    // Distance to the closest trigger of each world, some have more than one leading there
+    bs::UnorderedMap<bs::String, float> distances;
+
+    for (const HLevelChangeTrigger& trigger : mTriggers)
+    {
+      if (trigger.isDestroyed() || trigger->zenFile().empty()) continue;
+
+      float distance = trigger->SO()->getTransform().pos().distance(heroPosition);
+
+      auto it = distances.find(trigger->zenFile());
+
+      if (it == distances.end() || distance < it->second)
+      {
+        distances[trigger->zenFile()] = distance;
+      }
+    }
+
+    for (const auto& it : distances)
+    {
+      if (it.second < PRELOAD_RANGE && mPreloaded.find(it.first) == mPreloaded.end())
+      {
+        preload(it.first);
+      }
+    }
+
+    bs::Vector<bs::String> toRelease;
+
+    for (const auto& it : mPreloaded)
+    {
+      auto distance = distances.find(it.first);
+
+      if (distance == distances.end() || distance->second > RELEASE_RANGE)
+      {
+        toRelease.push_back(it.first);
+      }
+    }
+
+    for (const bs::String& zenFile : toRelease)
+    {
+      release(zenFile);
+    }
+
+    mStats.numPreloadedWorlds = (bs::UINT32)mPreloaded.size();
+  }
+
+  bool WorldPreloading::isPreloaded(const bs::String& zenFile) const
+  {
+    auto it = mPreloaded.find(zenFile);
+
+    if (it == mPreloaded.end()) return false;
+
+    for (const bs::HPrefab& prefab : it->second)
+    {
+      if (!prefab.isLoaded(false)) return false;
+    }
+
+    return true;
+  }
+
+  void WorldPreloading::preload(const bs::String& zenFile)
+  {
+    bs::Vector<bs::HPrefab>& prefabs = mPreloaded[zenFile];
+
+    for (const bs::Path& path : GameWorld::worldStatePaths(zenFile))
+    {
+      // Worlds not visited yet might not have been imported either
+      if (!bs::FileSystem::exists(path)) continue;
+
+      prefabs.push_back(bs::gResources().loadAsync<bs::Prefab>(path));
+    }
+
+    REGOTH_LOG(Info, World, "[WorldPreloading] Preloading {0} save(s) of {1}", prefabs.size(),
+               zenFile);
+  }
+
+  void WorldPreloading::release(const bs::String& zenFile)
+  {
+    auto it = mPreloaded.find(zenFile);
+
+    if (it == mPreloaded.end()) return;
+
+    // A world which has been loaded in the meantime holds on to its own reference
+    for (bs::HPrefab& prefab : it->second)
+    {
+      bs::gResources().release(prefab);
+    }
+
+    mPreloaded.erase(it);
+  }
+}  // namespace REGoth
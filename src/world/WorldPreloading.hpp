@@ -0,0 +1,100 @@
+#pragma once
+#include <BsPrerequisites.h>
+
+namespace REGoth
+{
+  class LevelChangeTrigger;
+  using HLevelChangeTrigger = bs::GameObjectHandle<LevelChangeTrigger>;
+
+  /**
+   * Loads the worlds the level changes of a world lead to in the background, once the hero
+   * comes close to one of them.
+   *
+   * Moving over into another world means loading its saved state, see
+   * GameWorld::loadWorldState(). Started only once the hero has reached the trigger, the game
+   * stalls for as long as reading the save takes. Preloaded, the save is in memory by then
+   * and only needs to be instantiated.
+   *
+   * The saves of a world are preloaded once the hero comes closer to one of its
+   * LevelChangeTriggers than PRELOAD_RANGE and released again once the hero is further away
+   * than RELEASE_RANGE from all of them, so they don't take up memory while the hero is
+   * somewhere else.
+   *
+   * Every GameWorld has one, see GameWorld::worldPreloading(). Not saved, the world sets it up
+   * again after loading, see reset().
+   */
+  class WorldPreloading
+  {
+  public:
+    /**
+     * How many worlds are preloaded.
+     */
+    struct Stats
+    {
+      bs::UINT32 numTriggers        = 0;
+      bs::UINT32 numPreloadedWorlds = 0;
+    };
+
+    /**
+     * The saves a trigger leads to are preloaded once the hero is closer than this, in meters.
+     * Must be smaller than RELEASE_RANGE.
+     */
+    static constexpr float PRELOAD_RANGE = 40.0f;
+
+    /** Preloaded saves are released once the hero is further away than this, in meters */
+    static constexpr float RELEASE_RANGE = 80.0f;
+
+    /** Seconds between two checks of what to preload */
+    static constexpr float CHECK_INTERVAL = 1.0f;
+
+    /**
+     * Releases all preloaded saves and forgets about the triggers.
+     */
+    void reset();
+
+    /**
+     * Adds a level change to preload the world of.
+     */
+    void addTrigger(HLevelChangeTrigger trigger);
+
+    /**
+     * Preloads and releases what needs to be for the hero being at the given position.
+     */
+    void update(const bs::Vector3& heroPosition);
+
+    /**
+     * @return Whether the saves of the world of the given ZEN have been preloaded and are done
+     *         loading.
+     */
+    bool isPreloaded(const bs::String& zenFile) const;
+
+    const Stats& stats() const
+    {
+      return mStats;
+    }
+
+  private:
+    /**
+     * Starts loading the saves of the world of the given ZEN, see
+     * GameWorld::worldStatePaths().
+     */
+    void preload(const bs::String& zenFile);
+
+    /**
+     * Releases the preloaded saves of the world of the given ZEN.
+     */
+    void release(const bs::String& zenFile);
+
+    bs::Vector<HLevelChangeTrigger> mTriggers;
+
+    /**
+     * ZEN-file -> Saves preloaded for it.
+     */
+    bs::UnorderedMap<bs::String, bs::Vector<bs::HPrefab>> mPreloaded;
+
+    float mTimeUntilCheck = 0.0f;
+    float mLastUpdateTime = -1.0f;
+
+    Stats mStats;
+  };
+}  // namespace REGoth
@@ -0,0 +1,667 @@
+#include "WorldSnapshots.hpp"
+#include <Scene/BsSceneObject.h>
+#include <Utility/BsTime.h>
+#include <algorithm>
+#include <cmath>
+#include <components/Character.hpp>
+#include <components/GameClock.hpp>
+#include <components/GameWorld.hpp>
+#include <components/Item.hpp>
+#include <core/Profiling.hpp>
+#include <limits>
+
+namespace REGoth
+{
+  constexpr float WorldSnapshots::INTEREST_RANGE;
+  constexpr float WorldSnapshots::SNAPSHOT_INTERVAL;
+  constexpr float WorldSnapshots::POSITION_UNITS_PER_METER;
+  constexpr bs::UINT32 WorldSnapshots::MAX_UNACKNOWLEDGED;
+
+  /**
+   * What is sent of an entity, see WorldSnapshots::encode(). Entities with SNAPSHOT_NEW are
+   * sent in full, the others only with the fields flagged.
+   */
+  enum SnapshotFieldFlags : bs::UINT8
+  {
+    SNAPSHOT_NEW        = 1 << 0,
+    SNAPSHOT_POSITION_X = 1 << 1,
+    SNAPSHOT_POSITION_Y = 1 << 2,
+    SNAPSHOT_POSITION_Z = 1 << 3,
+    SNAPSHOT_ROTATION   = 1 << 4,
+  };
+
+  /** Largest value of the three smaller components of a normalized quaternion */
+  constexpr float SNAPSHOT_MAX_SMALLER_COMPONENT = 0.70710678f;
+
+  /** Largest value a component is packed into, see WorldSnapshots::packRotation() */
+  constexpr bs::UINT32 SNAPSHOT_COMPONENT_MAX = (1 << 10) - 1;
+
+  /**
+   * Writes a packet. Numbers are written as varints, 7 bits per byte, so small ones like
+   * the difference between two positions only take a byte or two.
+   */
+  struct SnapshotPacketWriter
+  {
+    bs::Vector<bs::UINT8>& data;
+
+    void varint(bs::UINT32 value)
+    {
+      while (value >= 0x80)
+      {
+        data.push_back((bs::UINT8)(value | 0x80));
+        value >>= 7;
+      }
+
+      data.push_back((bs::UINT8)value);
+    }
+
+    /** Keeps small negative numbers small, see varint() */
+    void zigzag(bs::INT32 value)
+    {
+      varint(((bs::UINT32)value << 1) ^ (bs::UINT32)(value >> 31));
+    }
+
+    void byte(bs::UINT8 value)
+    {
+      data.push_back(value);
+    }
+
+    void string(const bs::String& value)
+    {
+      varint((bs::UINT32)value.size());
+      data.insert(data.end(), value.begin(), value.end());
+    }
+
+    void fixed32(bs::UINT32 value)
+    {
+      for (bs::UINT32 i = 0; i < 4; i++)
+      {
+        data.push_back((bs::UINT8)(value >> (i * 8)));
+      }
+    }
+  };
+
+  /**
+   * Reads what SnapshotPacketWriter wrote. Every read returns false once the packet is over.
+   */
+  struct SnapshotPacketReader
+  {
+    const bs::Vector<bs::UINT8>& data;
+    size_t offset = 0;
+
+    bool varint(bs::UINT32& value)
+    {
+      value = 0;
+
+      for (bs::UINT32 shift = 0; shift < 35; shift += 7)
+      {
+        if (offset >= data.size()) return false;
+
+        bs::UINT8 byte = data[offset++];
+        value |= (bs::UINT32)(byte & 0x7F) << shift;
+
+        if (!(byte & 0x80)) return true;
+      }
+
+      return false;
+    }
+
+    bool zigzag(bs::INT32& value)
+    {
+      bs::UINT32 encoded;
+
+      if (!varint(encoded)) return false;
+
+      value = (bs::INT32)(encoded >> 1) ^ -(bs::INT32)(encoded & 1);
+
+      return true;
+    }
+
+    bool byte(bs::UINT8& value)
+    {
+      if (offset >= data.size()) return false;
+
+      value = data[offset++];
+
+      return true;
+    }
+
+    bool string(bs::String& value)
+    {
+      bs::UINT32 size;
+
+      if (!varint(size) || data.size() - offset < size) return false;
+
+      value.assign((const char*)data.data() + offset, size);
+      offset += size;
+
+      return true;
+    }
+
+    bool fixed32(bs::UINT32& value)
+    {
+      if (data.size() - offset < 4) return false;
+
+      value = 0;
+
+      for (bs::UINT32 i = 0; i < 4; i++)
+      {
+        value |= (bs::UINT32)data[offset++] << (i * 8);
+      }
+
+      return true;
+    }
+  };
+
+  void WorldSnapshots::reset()
+  {
+    mClients.clear();
+    mCaptured.clear();
+
+    mTimeUntilSnapshot = 0.0f;
+
+    mStats = {};
+  }
+
+  bs::UINT32 WorldSnapshots::addClient(const bs::Vector3& viewPosition)
+  {
+    Client client;
+    client.id           = mNextClientId++;
+    client.viewPosition = viewPosition;
+
+    mClients.push_back(std::move(client));
+
+    return mClients.back().id;
+  }
+
+  void WorldSnapshots::removeClient(bs::UINT32 client)
+  {
+    mClients.erase(std::remove_if(mClients.begin(), mClients.end(),
+                                  [&](const Client& c) { return c.id == client; }),
+                   mClients.end());
+  }
+
+  void WorldSnapshots::setViewPosition(bs::UINT32 client, const bs::Vector3& viewPosition)
+  {
+    Client* c = findClient(client);
+
+    if (c) c->viewPosition = viewPosition;
+  }
+
+  void WorldSnapshots::acknowledge(bs::UINT32 client, bs::UINT32 sequence)
+  {
+    Client* c = findClient(client);
+
+    if (!c || sequence <= c->acknowledged) return;
+
+    auto it = std::find_if(c->sent.begin(), c->sent.end(),
+                           [&](const WorldSnapshot& s) { return s.sequence == sequence; });
+
+    // Forgotten already, see MAX_UNACKNOWLEDGED
+    if (it == c->sent.end()) return;
+
+    // Snapshots before it won't be needed as baseline anymore
+    c->sent.erase(c->sent.begin(), it);
+    c->acknowledged = sequence;
+  }
+
+  const bs::Vector<bs::UINT8>& WorldSnapshots::packetFor(bs::UINT32 client) const
+  {
+    static const bs::Vector<bs::UINT8> noPacket;
+
+    for (const Client& c : mClients)
+    {
+      if (c.id == client) return c.packet;
+    }
+
+    return noPacket;
+  }
+
+  void WorldSnapshots::update()
+  {
+    if (mClients.empty() || !mWorld)
+    {
+      mStats = {};
+      return;
+    }
+
+    float now        = bs::gTime().getTime();
+    float timePassed = mLastUpdateTime < 0.0f ? 0.0f : now - mLastUpdateTime;
+    mLastUpdateTime  = now;
+
+    mTimeUntilSnapshot -= timePassed;
+
+    if (mTimeUntilSnapshot > 0.0f) return;
+
+    mTimeUntilSnapshot = SNAPSHOT_INTERVAL;
+
+    takeSnapshots();
+  }
+
+  void WorldSnapshots::takeSnapshots()
+  {
+    if (!mWorld) return;
+
+    REGOTH_PROFILE_SCOPE("WorldSnapshots");
+
+    mSequence += 1;
+    mCaptured.clear();
+
+    mStats            = {};
+    mStats.numClients = (bs::UINT32)mClients.size();
+
+    for (Client& client : mClients)
+    {
+      updateClient(client);
+
+      mStats.numEntities += (bs::UINT32)client.sent.back().entities.size();
+      mStats.numBytesSent += (bs::UINT32)client.packet.size();
+    }
+  }
+
+  void WorldSnapshots::updateClient(Client& client)
+  {
+    WorldSnapshot snapshot;
+    snapshot.sequence = mSequence;
+
+    HGameClock clock = mWorld->gameclock();
+
+    if (clock)
+    {
+      snapshot.day        = clock->getDay();
+      snapshot.daySeconds = (bs::UINT32)clock->getDaySeconds();
+    }
+
+    for (const HCharacter& character :
+         mWorld->findCharactersInRange(INTEREST_RANGE, client.viewPosition))
+    {
+      snapshot.entities.push_back(capture(*character, SnapshotEntityKind::Character));
+    }
+
+    for (const HItem& item : mWorld->findItemsInRange(INTEREST_RANGE, client.viewPosition))
+    {
+      snapshot.entities.push_back(capture(*item, SnapshotEntityKind::Item));
+    }
+
+    std::sort(snapshot.entities.begin(), snapshot.entities.end(),
+              [](const SnapshotEntity& a, const SnapshotEntity& b) { return a.id < b.id; });
+
+    const WorldSnapshot* baseline = client.acknowledged != 0 ? &client.sent.front() : nullptr;
+
+    client.packet.clear();
+    encode(snapshot, baseline, client.packet);
+
+    client.sent.push_back(std::move(snapshot));
+
+    // The acknowledged one stays as baseline
+    size_t firstUnacknowledged = client.acknowledged != 0 ? 1 : 0;
+
+    if (client.sent.size() - firstUnacknowledged > MAX_UNACKNOWLEDGED)
+    {
+      client.sent.erase(client.sent.begin() + firstUnacknowledged);
+    }
+  }
+
+  const SnapshotEntity& WorldSnapshots::capture(const ScriptBackedBy& object,
+                                                SnapshotEntityKind kind)
+  {
+    bs::UINT32 id = (bs::UINT32)object.SO().getInstanceId();
+
+    auto it = mCaptured.find(id);
+
+    if (it != mCaptured.end()) return it->second;
+
+    const bs::Transform& transform = object.SO()->getTransform();
+
+    SnapshotEntity& entity = mCaptured[id];
+    entity.id              = id;
+    entity.kind            = kind;
+    entity.instance        = object.scriptInstance();
+    entity.position[0]     = quantizePosition(transform.pos().x);
+    entity.position[1]     = quantizePosition(transform.pos().y);
+    entity.position[2]     = quantizePosition(transform.pos().z);
+    entity.rotation        = packRotation(transform.rot());
+
+    return entity;
+  }
+
+  bs::INT32 WorldSnapshots::quantizePosition(float meters)
+  {
+    return (bs::INT32)std::lround(meters * POSITION_UNITS_PER_METER);
+  }
+
+  void WorldSnapshots::encode(const WorldSnapshot& snapshot, const WorldSnapshot* baseline,
+                              bs::Vector<bs::UINT8>& packet)
+  {
+    static const bs::Vector<SnapshotEntity> noEntities;
+
+    const bs::Vector<SnapshotEntity>& before = baseline ? baseline->entities : noEntities;
+
+    bs::Vector<bs::UINT32> removed;
+    bs::Vector<std::pair<const SnapshotEntity*, bs::UINT8>> written;
+
+    // Both are sorted by ID, so walk them side by side
+    size_t next = 0;
+
+    for (const SnapshotEntity& entity : snapshot.entities)
+    {
+      while (next < before.size() && before[next].id < entity.id)
+      {
+        removed.push_back(before[next++].id);
+      }
+
+      if (next >= before.size() || before[next].id != entity.id)
+      {
+        written.emplace_back(&entity, SNAPSHOT_NEW);
+        continue;
+      }
+
+      const SnapshotEntity& old = before[next++];
+
+      if (old.kind != entity.kind || old.instance != entity.instance)
+      {
+        written.emplace_back(&entity, SNAPSHOT_NEW);
+        continue;
+      }
+
+      bs::UINT8 flags = 0;
+
+      if (old.position[0] != entity.position[0]) flags |= SNAPSHOT_POSITION_X;
+      if (old.position[1] != entity.position[1]) flags |= SNAPSHOT_POSITION_Y;
+      if (old.position[2] != entity.position[2]) flags |= SNAPSHOT_POSITION_Z;
+      if (old.rotation != entity.rotation) flags |= SNAPSHOT_ROTATION;
+
+      if (flags) written.emplace_back(&entity, flags);
+    }
+
+    while (next < before.size())
+    {
+      removed.push_back(before[next++].id);
+    }
+
+    SnapshotPacketWriter writer{packet};
+
+    writer.varint(snapshot.sequence);
+    writer.varint(baseline ? baseline->sequence : 0);
+    writer.zigzag(snapshot.day);
+    writer.varint(snapshot.daySeconds);
+
+    // IDs only as difference to the one before, they are sorted and close to each other
+    bs::UINT32 lastId = 0;
+
+    writer.varint((bs::UINT32)removed.size());
+
+    for (bs::UINT32 id : removed)
+    {
+      writer.varint(id - lastId);
+      lastId = id;
+    }
+
+    lastId = 0;
+
+    writer.varint((bs::UINT32)written.size());
+
+    for (const auto& w : written)
+    {
+      const SnapshotEntity& entity = *w.first;
+      bs::UINT8 flags              = w.second;
+
+      writer.varint(entity.id - lastId);
+      writer.byte(flags);
+
+      lastId = entity.id;
+
+      if (flags & SNAPSHOT_NEW)
+      {
+        writer.byte((bs::UINT8)entity.kind);
+        writer.string(entity.instance);
+
+        for (bs::INT32 axis : entity.position)
+        {
+          writer.zigzag(axis);
+        }
+
+        writer.fixed32(entity.rotation);
+        continue;
+      }
+
+      // Whatever it moved since the baseline, in whole units
+      const SnapshotEntity& old = *std::lower_bound(
+          before.begin(), before.end(), entity.id,
+          [](const SnapshotEntity& e, bs::UINT32 id) { return e.id < id; });
+
+      if (flags & SNAPSHOT_POSITION_X) writer.zigzag(entity.position[0] - old.position[0]);
+      if (flags & SNAPSHOT_POSITION_Y) writer.zigzag(entity.position[1] - old.position[1]);
+      if (flags & SNAPSHOT_POSITION_Z) writer.zigzag(entity.position[2] - old.position[2]);
+      if (flags & SNAPSHOT_ROTATION) writer.fixed32(entity.rotation);
+    }
+  }
+
+  bool WorldSnapshots::decode(const bs::Vector<bs::UINT8>& packet,
+                              const bs::Vector<WorldSnapshot>& received, WorldSnapshot& result)
+  {
+    SnapshotPacketReader reader{packet};
+
+    bs::UINT32 baselineSequence;
+
+    if (!reader.varint(result.sequence) || !reader.varint(baselineSequence)) return false;
+    if (!reader.zigzag(result.day) || !reader.varint(result.daySeconds)) return false;
+
+    const WorldSnapshot* baseline = nullptr;
+
+    if (baselineSequence != 0)
+    {
+      for (const WorldSnapshot& s : received)
+      {
+        if (s.sequence == baselineSequence) baseline = &s;
+      }
+
+      if (!baseline) return false;
+    }
+
+    bs::UINT32 numRemoved;
+    bs::Vector<bs::UINT32> removed;
+    bs::UINT32 lastId = 0;
+
+    if (!reader.varint(numRemoved) || numRemoved > packet.size()) return false;
+
+    for (bs::UINT32 i = 0; i < numRemoved; i++)
+    {
+      bs::UINT32 delta;
+
+      if (!reader.varint(delta)) return false;
+
+      lastId += delta;
+      removed.push_back(lastId);
+    }
+
+    // Changed entities hold the difference to the baseline until merged below
+    bs::UINT32 numWritten;
+    bs::Vector<std::pair<SnapshotEntity, bs::UINT8>> written;
+    lastId = 0;
+
+    if (!reader.varint(numWritten) || numWritten > packet.size()) return false;
+
+    for (bs::UINT32 i = 0; i < numWritten; i++)
+    {
+      bs::UINT32 delta;
+      bs::UINT8 flags;
+      SnapshotEntity entity;
+
+      if (!reader.varint(delta) || !reader.byte(flags)) return false;
+
+      lastId += delta;
+      entity.id = lastId;
+
+      if (flags & SNAPSHOT_NEW)
+      {
+        bs::UINT8 kind;
+
+        if (!reader.byte(kind) || !reader.string(entity.instance)) return false;
+
+        entity.kind = (SnapshotEntityKind)kind;
+
+        for (bs::INT32& axis : entity.position)
+        {
+          if (!reader.zigzag(axis)) return false;
+        }
+
+        if (!reader.fixed32(entity.rotation)) return false;
+      }
+      else
+      {
+        const bs::UINT8 axisFlags[] = {SNAPSHOT_POSITION_X, SNAPSHOT_POSITION_Y,
+                                       SNAPSHOT_POSITION_Z};
+
+        for (bs::UINT32 axis = 0; axis < 3; axis++)
+        {
+          if ((flags & axisFlags[axis]) && !reader.zigzag(entity.position[axis])) return false;
+        }
+
+        if ((flags & SNAPSHOT_ROTATION) && !reader.fixed32(entity.rotation)) return false;
+      }
+
+      written.emplace_back(std::move(entity), flags);
+    }
+
+    static const bs::Vector<SnapshotEntity> noEntities;
+
+    const bs::Vector<SnapshotEntity>& before = baseline ? baseline->entities : noEntities;
+
+    result.entities.clear();
+
+    // Baseline, removed and written entities are all sorted by ID
+    const bs::UINT64 none = std::numeric_limits<bs::UINT64>::max();
+
+    size_t nextBefore  = 0;
+    size_t nextRemoved = 0;
+    size_t nextWritten = 0;
+
+    while (nextBefore < before.size() || nextWritten < written.size())
+    {
+      bs::UINT64 beforeId  = nextBefore < before.size() ? before[nextBefore].id : none;
+      bs::UINT64 writtenId = nextWritten < written.size() ? written[nextWritten].first.id : none;
+
+      if (beforeId < writtenId)
+      {
+        while (nextRemoved < removed.size() && removed[nextRemoved] < beforeId)
+        {
+          nextRemoved++;
+        }
+
+        bool isRemoved = nextRemoved < removed.size() && removed[nextRemoved] == beforeId;
+
+        if (!isRemoved) result.entities.push_back(before[nextBefore]);
+
+        nextBefore++;
+        continue;
+      }
+
+      const SnapshotEntity& entity = written[nextWritten].first;
+      bs::UINT8 flags              = written[nextWritten].second;
+
+      if (flags & SNAPSHOT_NEW)
+      {
+        result.entities.push_back(entity);
+      }
+      else
+      {
+        // Changed, but never sent before?
+        if (beforeId != writtenId) return false;
+
+        SnapshotEntity changed = before[nextBefore];
+
+        for (bs::UINT32 axis = 0; axis < 3; axis++)
+        {
+          changed.position[axis] += entity.position[axis];
+        }
+
+        if (flags & SNAPSHOT_ROTATION) changed.rotation = entity.rotation;
+
+        result.entities.push_back(std::move(changed));
+      }
+
+      if (beforeId == writtenId) nextBefore++;
+
+      nextWritten++;
+    }
+
+    return true;
+  }
+
+  bs::UINT32 WorldSnapshots::packRotation(const bs::Quaternion& rotation)
+  {
+    float components[4] = {rotation.w, rotation.x, rotation.y, rotation.z};
+    float length        = std::sqrt(components[0] * components[0] + components[1] * components[1] +
+                                    components[2] * components[2] + components[3] * components[3]);
+
+    // Nothing sensible to send, take it as no rotation at all
+    if (length < 0.0001f)
+    {
+      components[0] = 1.0f;
+      components[1] = components[2] = components[3] = 0.0f;
+      length        = 1.0f;
+    }
+
+    bs::UINT32 largest = 0;
+
+    for (bs::UINT32 i = 1; i < 4; i++)
+    {
+      if (std::abs(components[i]) > std::abs(components[largest])) largest = i;
+    }
+
+    // The quaternion negated is the same rotation, so the largest component can be positive
+    float scale = (components[largest] < 0.0f ? -1.0f : 1.0f) / length;
+
+    bs::UINT32 packed = largest;
+    bs::UINT32 shift  = 2;
+
+    for (bs::UINT32 i = 0; i < 4; i++)
+    {
+      if (i == largest) continue;
+
+      float normalized = (components[i] * scale / SNAPSHOT_MAX_SMALLER_COMPONENT) * 0.5f + 0.5f;
+      normalized       = std::min(std::max(normalized, 0.0f), 1.0f);
+
+      packed |= (bs::UINT32)std::lround(normalized * SNAPSHOT_COMPONENT_MAX) << shift;
+      shift += 10;
+    }
+
+    return packed;
+  }
+
+  bs::Quaternion WorldSnapshots::unpackRotation(bs::UINT32 packed)
+  {
+    bs::UINT32 largest = packed & 3;
+
+    float components[4];
+    float sumOfSquares = 0.0f;
+    bs::UINT32 shift   = 2;
+
+    for (bs::UINT32 i = 0; i < 4; i++)
+    {
+      if (i == largest) continue;
+
+      float normalized = (float)((packed >> shift) & SNAPSHOT_COMPONENT_MAX) /
+                         (float)SNAPSHOT_COMPONENT_MAX;
+
+      components[i] = (normalized * 2.0f - 1.0f) * SNAPSHOT_MAX_SMALLER_COMPONENT;
+      sumOfSquares += components[i] * components[i];
+      shift += 10;
+    }
+
+    components[largest] = std::sqrt(std::max(0.0f, 1.0f - sumOfSquares));
+
+    return bs::Quaternion(components[0], components[1], components[2], components[3]);
+  }
+
+  WorldSnapshots::Client* WorldSnapshots::findClient(bs::UINT32 client)
+  {
+    for (Client& c : mClients)
+    {
+      if (c.id == client) return &c;
+    }
+
+    return nullptr;
+  }
+}  // namespace REGoth
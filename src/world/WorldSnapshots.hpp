@@ -0,0 +1,246 @@
+#pragma once
+#include <BsPrerequisites.h>
+#include <Math/BsQuaternion.h>
+#include <Math/BsVector3.h>
+
+namespace REGoth
+{
+  class GameWorld;
+  using HGameWorld = bs::GameObjectHandle<GameWorld>;
+
+  class ScriptBackedBy;
+
+  /**
+   * What a snapshot entity is, so the client knows what to show for it.
+   */
+  enum class SnapshotEntityKind : bs::UINT8
+  {
+    Character = 0,
+    Item      = 1,
+  };
+
+  /**
+   * The state of a single character or item as sent to clients, quantized so it packs
+   * tightly and compares exactly, see WorldSnapshots.
+   */
+  struct SnapshotEntity
+  {
+    /**
+     * Same for as long as the object exists. Taken from the instance ID of its scene object,
+     * which bs:f hands out in order, so sorted IDs are close to each other.
+     */
+    bs::UINT32 id = 0;
+
+    SnapshotEntityKind kind = SnapshotEntityKind::Character;
+
+    /** Script instance the object was created from, e.g. `ITFO_APPLE` */
+    bs::String instance;
+
+    /** Position in centimeters, see POSITION_UNITS_PER_METER */
+    bs::INT32 position[3] = {0, 0, 0};
+
+    /** Rotation, see packRotation() */
+    bs::UINT32 rotation = 0;
+  };
+
+  /**
+   * Everything a client is told about the world at one point in time.
+   */
+  struct WorldSnapshot
+  {
+    /** Counts up with every snapshot the server takes, starting at 1 */
+    bs::UINT32 sequence = 0;
+
+    /** Ingame time, see GameClock */
+    bs::INT32 day         = 0;
+    bs::UINT32 daySeconds = 0;
+
+    /** The characters and items the client is interested in, sorted by ID */
+    bs::Vector<SnapshotEntity> entities;
+  };
+
+  /**
+   * Lets an authoritative server tell any number of clients what goes on in the world
+   * around them: Where the characters and items they are close to are and what time it is.
+   *
+   * Every SNAPSHOT_INTERVAL, a snapshot of the characters and items within INTEREST_RANGE of
+   * each client is taken, using the spatial hashes of the world, see
+   * GameWorld::findCharactersInRange(). Each object is only quantized once per snapshot, no
+   * matter how many clients see it.
+   *
+   * The snapshot is then encoded as a delta against the last one the client acknowledged, see
+   * acknowledge(): Objects which didn't change are left out, changed positions only send the
+   * difference per axis and objects which are new to the client are sent in full. Until a
+   * client has acknowledged anything, everything is sent in full. Clients keep the snapshots
+   * they have received and rebuild the current one via decode().
+   *
+   * Only the encoded packets are produced, sending them is up to whoever runs the server, see
+   * packetFor(). Does nothing without clients, so it costs nothing outside of servers.
+   *
+   * Every GameWorld has one, see GameWorld::worldSnapshots(). Not saved, clients connect again
+   * after the world has been loaded.
+   */
+  class WorldSnapshots
+  {
+  public:
+    /**
+     * How much was sent by the last update.
+     */
+    struct Stats
+    {
+      bs::UINT32 numClients   = 0;
+      bs::UINT32 numEntities  = 0;
+      bs::UINT32 numBytesSent = 0;
+    };
+
+    /** Clients are told about the characters and items within this range, in meters */
+    static constexpr float INTEREST_RANGE = 50.0f;
+
+    /** Seconds between two snapshots */
+    static constexpr float SNAPSHOT_INTERVAL = 0.05f;
+
+    /** Positions are sent in units of this many per meter */
+    static constexpr float POSITION_UNITS_PER_METER = 100.0f;
+
+    /**
+     * A client not acknowledging anything for this many snapshots has its oldest
+     * unacknowledged ones forgotten. Acknowledging those later on does nothing.
+     */
+    static constexpr bs::UINT32 MAX_UNACKNOWLEDGED = 32;
+
+    /**
+     * Sets the world to take the snapshots of.
+     */
+    void setWorld(HGameWorld world)
+    {
+      mWorld = world;
+    }
+
+    /**
+     * Forgets about all clients.
+     */
+    void reset();
+
+    /**
+     * Adds a client, which gets its first snapshot with the next update.
+     *
+     * @return ID of the client, to refer to it later on.
+     */
+    bs::UINT32 addClient(const bs::Vector3& viewPosition);
+
+    void removeClient(bs::UINT32 client);
+
+    /**
+     * Sets around where the client is interested in the world, usually where its character or
+     * camera is.
+     */
+    void setViewPosition(bs::UINT32 client, const bs::Vector3& viewPosition);
+
+    /**
+     * To be called once the client has received the snapshot with the given sequence number.
+     * Later snapshots are encoded against it.
+     */
+    void acknowledge(bs::UINT32 client, bs::UINT32 sequence);
+
+    /**
+     * Calls takeSnapshots(), if it's time to.
+     */
+    void update();
+
+    /**
+     * Takes a snapshot for every client and encodes it against what the client acknowledged,
+     * see packetFor().
+     */
+    void takeSnapshots();
+
+    /**
+     * @return What to send to the client, taken by the last update(). Empty if nothing has
+     *         been taken for it yet.
+     */
+    const bs::Vector<bs::UINT8>& packetFor(bs::UINT32 client) const;
+
+    /**
+     * Rebuilds the snapshot encoded into the given packet. Meant for clients.
+     *
+     * @param  received  Snapshots the client has received so far. Must contain the one the
+     *                   packet was encoded against, which is one the client has acknowledged.
+     * @param  result    The snapshot the packet contains.
+     *
+     * @return Whether the packet could be decoded. False if it is malformed or its baseline is
+     *         not part of `received`.
+     */
+    static bool decode(const bs::Vector<bs::UINT8>& packet,
+                       const bs::Vector<WorldSnapshot>& received, WorldSnapshot& result);
+
+    /**
+     * Packs the given rotation into 32 bits: The index of the largest component in 2 bits and
+     * the other three in 10 bits each. The largest one can be computed from the others, since
+     * the quaternion is normalized.
+     */
+    static bs::UINT32 packRotation(const bs::Quaternion& rotation);
+
+    /**
+     * @return The rotation packed by packRotation().
+     */
+    static bs::Quaternion unpackRotation(bs::UINT32 packed);
+
+    const Stats& stats() const
+    {
+      return mStats;
+    }
+
+  private:
+    struct Client
+    {
+      bs::UINT32 id = 0;
+      bs::Vector3 viewPosition;
+
+      /**
+       * The snapshot last acknowledged first, if any, followed by the ones sent after it.
+       * Oldest first.
+       */
+      bs::Vector<WorldSnapshot> sent;
+
+      /** Sequence of the snapshot at the front of `sent`, 0 if none is acknowledged */
+      bs::UINT32 acknowledged = 0;
+
+      bs::Vector<bs::UINT8> packet;
+    };
+
+    Client* findClient(bs::UINT32 client);
+
+    /**
+     * Takes the snapshot for the given client and encodes it into its packet.
+     */
+    void updateClient(Client& client);
+
+    /**
+     * @return The quantized state of the given object, captured once per snapshot.
+     */
+    const SnapshotEntity& capture(const ScriptBackedBy& object, SnapshotEntityKind kind);
+
+    /**
+     * Encodes `snapshot` as delta against `baseline`, which may be null.
+     */
+    static void encode(const WorldSnapshot& snapshot, const WorldSnapshot* baseline,
+                       bs::Vector<bs::UINT8>& packet);
+
+    static bs::INT32 quantizePosition(float meters);
+
+    HGameWorld mWorld;
+
+    bs::Vector<Client> mClients;
+    bs::UINT32 mNextClientId = 1;
+
+    /** Sequence number of the snapshot being taken */
+    bs::UINT32 mSequence = 0;
+
+    /** Entity ID -> What has been captured of the object for the current snapshot */
+    bs::UnorderedMap<bs::UINT32, SnapshotEntity> mCaptured;
+
+    float mTimeUntilSnapshot = 0.0f;
+    float mLastUpdateTime    = -1.0f;
+
+    Stats mStats;
+  };
+}  // namespace REGoth
@@ -0,0 +1,327 @@
+#include "WorldStreaming.hpp"
+#include <BsZenLib/ImportPath.hpp>
+#include <Components/BsCRenderable.h>
+#include <FileSystem/BsDataStream.h>
+#include <FileSystem/BsFileSystem.h>
+#include <Resources/BsResources.h>
+#include <Scene/BsPrefab.h>
+#include <Scene/BsSceneObject.h>
+#include <components/GameWorld.hpp>
+#include <exception/Throw.hpp>
+#include <log/logging.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+namespace REGoth
+{
+  constexpr float WorldStreaming::SECTOR_SIZE;
+  constexpr bs::INT32 WorldStreaming::LOAD_RADIUS;
+  constexpr bs::UINT32 WorldStreaming::MAX_INSTANTIATIONS_PER_UPDATE;
+
+  /**
+   * Names of scene objects holding the instance of a sector start with this.
+   */
+  const char* const SECTOR_NAME_PREFIX = "StreamedSector_";
+
+  /**
+   * Start of the file listing the cached sectors of a ZEN.
+   */
+  struct SectorIndexFileHeader
+  {
+    char magic[4]         = {'R', 'G', 'W', 'S'};
+    bs::UINT32 version    = 1;
+    bs::UINT32 numSectors = 0;
+    bs::UINT32 padding    = 0;
+  };
+
+  struct SectorIndexEntry
+  {
+    bs::INT32 x;
+    bs::INT32 z;
+  };
+
+  bool WorldStreaming::hasCache(const bs::String& zenFile)
+  {
+    // The index is written last, so once it is there, all sectors are
+    return bs::FileSystem::exists(indexPath(zenFile));
+  }
+
+  void WorldStreaming::removeCache(const bs::String& zenFile)
+  {
+    // Without the index, the sectors are not used and get overwritten once created again
+    if (hasCache(zenFile))
+    {
+      bs::FileSystem::remove(indexPath(zenFile));
+    }
+  }
+
+  void WorldStreaming::createCache(const bs::String& zenFile,
+                                   const bs::Vector<bs::HSceneObject>& staticObjects)
+  {
+    bs::UnorderedMap<bs::UINT64, bs::HSceneObject> sectorSOs;
+    bs::Vector<SectorIndexEntry> entries;
+
+    for (bs::HSceneObject object : staticObjects)
+    {
+      if (object.isDestroyed()) continue;
+
+      bs::Vector3 position = positionForSector(object);
+
+      bs::INT32 x = sectorCoordinateOf(position.x);
+      bs::INT32 z = sectorCoordinateOf(position.z);
+
+      auto it = sectorSOs.find(sectorKey(x, z));
+
+      if (it == sectorSOs.end())
+      {
+        it = sectorSOs.emplace(sectorKey(x, z), bs::SceneObject::create(sectorName(x, z))).first;
+        entries.push_back({x, z});
+      }
+
+      // Keeps the world transform
+      object->setParent(it->second);
+    }
+
+    enum
+    {
+      Overwrite    = true,
+      KeepExisting = false,
+    };
+
+    // Sectors are loaded while playing, where reading less from disk matters most
+    enum
+    {
+      Compress = true,
+    };
+
+    for (const SectorIndexEntry& entry : entries)
+    {
+      bs::HSceneObject sectorSO = sectorSOs[sectorKey(entry.x, entry.z)];
+
+      bs::HPrefab prefab = bs::Prefab::create(sectorSO);
+      bs::gResources().save(prefab, sectorPath(zenFile, entry.x, entry.z), Overwrite, Compress);
+      bs::gResources().release(prefab);
+
+      sectorSO->destroy();
+    }
+
+    bs::SPtr<bs::DataStream> stream = bs::FileSystem::createAndOpenFile(indexPath(zenFile));
+
+    if (!stream)
+    {
+      REGOTH_LOG(Error, World, "[WorldStreaming] Failed to write sector index of {0}",
+                 zenFile);
+      return;
+    }
+
+    SectorIndexFileHeader header;
+    header.numSectors = (bs::UINT32)entries.size();
+
+    stream->write(&header, sizeof(header));
+    stream->write(entries.data(), entries.size() * sizeof(SectorIndexEntry));
+    stream->close();
+
+    REGOTH_LOG(Info, World, "[WorldStreaming] Cached {0} objects of {1} in {2} sectors",
+               staticObjects.size(), zenFile, entries.size());
+  }
+
+  void WorldStreaming::start(const bs::String& zenFile)
+  {
+    for (auto& s : mSectors)
+    {
+      unloadSector(s.second);
+    }
+
+    mSectors.clear();
+    mLoadedSectors.clear();
+    mStats = {};
+
+    mZenFile = zenFile;
+
+    bs::Path path = indexPath(zenFile);
+
+    bs::SPtr<bs::DataStream> stream =
+        bs::FileSystem::exists(path) ? bs::FileSystem::openFile(path, true) : nullptr;
+
+    if (!stream)
+    {
+      REGOTH_THROW(FileNotFoundException, "No sector cache exists for ZEN " + zenFile);
+    }
+
+    SectorIndexFileHeader header;
+    SectorIndexFileHeader expected;
+
+    if (stream->read(&header, sizeof(header)) != sizeof(header) ||
+        std::memcmp(header.magic, expected.magic, sizeof(header.magic)) != 0 ||
+        header.version != expected.version)
+    {
+      REGOTH_THROW(InvalidStateException, "Invalid sector cache for ZEN " + zenFile);
+    }
+
+    bs::Vector<SectorIndexEntry> entries(header.numSectors);
+    size_t numBytes = entries.size() * sizeof(SectorIndexEntry);
+
+    if (stream->read(entries.data(), numBytes) != numBytes)
+    {
+      REGOTH_THROW(InvalidStateException, "Invalid sector cache for ZEN " + zenFile);
+    }
+
+    for (const SectorIndexEntry& entry : entries)
+    {
+      Sector sector;
+      sector.x = entry.x;
+      sector.z = entry.z;
+
+      mSectors.emplace(sectorKey(entry.x, entry.z), std::move(sector));
+    }
+
+    mStats.numSectors = (bs::UINT32)mSectors.size();
+
+    // Sectors which were instantiated when the world was saved
+    bs::HSceneObject worldSO = mWorld->SO();
+    bs::String prefix        = SECTOR_NAME_PREFIX;
+
+    for (bs::UINT32 i = worldSO->getNumChildren(); i > 0; i--)
+    {
+      bs::HSceneObject child = worldSO->getChild(i - 1);
+
+      if (bs::StringUtil::startsWith(child->getName(), prefix, false))
+      {
+        child->destroy();
+      }
+    }
+  }
+
+  void WorldStreaming::update(const bs::Vector3& center)
+  {
+    bs::INT32 centerX = sectorCoordinateOf(center.x);
+    bs::INT32 centerZ = sectorCoordinateOf(center.z);
+
+    // Unload what got too far away
+    for (size_t i = 0; i < mLoadedSectors.size();)
+    {
+      Sector& sector = mSectors[mLoadedSectors[i]];
+
+      bs::INT32 distance = std::max(std::abs(sector.x - centerX), std::abs(sector.z - centerZ));
+
+      if (distance <= LOAD_RADIUS + 1)
+      {
+        i++;
+        continue;
+      }
+
+      unloadSector(sector);
+
+      mLoadedSectors[i] = mLoadedSectors.back();
+      mLoadedSectors.pop_back();
+    }
+
+    // Start loading what came close
+    for (bs::INT32 z = centerZ - LOAD_RADIUS; z <= centerZ + LOAD_RADIUS; z++)
+    {
+      for (bs::INT32 x = centerX - LOAD_RADIUS; x <= centerX + LOAD_RADIUS; x++)
+      {
+        auto it = mSectors.find(sectorKey(x, z));
+
+        if (it == mSectors.end()) continue;
+
+        if (!it->second.prefab)
+        {
+          loadSector(it->second);
+          mLoadedSectors.push_back(it->first);
+        }
+      }
+    }
+
+    // Instantiate what has finished loading
+    bs::UINT32 numInstantiated = 0;
+    mStats.numLoadingSectors   = 0;
+
+    for (bs::UINT64 key : mLoadedSectors)
+    {
+      Sector& sector = mSectors[key];
+
+      if (sector.instance) continue;
+
+      if (!sector.prefab.isLoaded() || numInstantiated >= MAX_INSTANTIATIONS_PER_UPDATE)
+      {
+        mStats.numLoadingSectors += 1;
+        continue;
+      }
+
+      sector.instance = sector.prefab->instantiate();
+      sector.instance->setParent(mWorld->SO());
+
+      numInstantiated += 1;
+      mStats.numInstantiatedSectors += 1;
+    }
+  }
+
+  void WorldStreaming::loadSector(Sector& sector)
+  {
+    if (sector.prefab) return;
+
+    sector.prefab =
+        bs::gResources().loadAsync<bs::Prefab>(sectorPath(mZenFile, sector.x, sector.z));
+  }
+
+  void WorldStreaming::unloadSector(Sector& sector)
+  {
+    if (sector.instance)
+    {
+      if (!sector.instance.isDestroyed())
+      {
+        sector.instance->destroy();
+      }
+
+      sector.instance = {};
+      mStats.numInstantiatedSectors -= 1;
+    }
+
+    if (sector.prefab)
+    {
+      bs::gResources().release(sector.prefab);
+      sector.prefab = {};
+    }
+  }
+
+  bs::Vector3 WorldStreaming::positionForSector(bs::HSceneObject object)
+  {
+    bs::HRenderable renderable = object->getComponent<bs::CRenderable>();
+
+    if (renderable && renderable->getMesh())
+    {
+      return renderable->getBounds().getBox().getCenter();
+    }
+
+    return object->getTransform().pos();
+  }
+
+  bs::INT32 WorldStreaming::sectorCoordinateOf(float value)
+  {
+    return (bs::INT32)std::floor(value / SECTOR_SIZE);
+  }
+
+  bs::UINT64 WorldStreaming::sectorKey(bs::INT32 x, bs::INT32 z)
+  {
+    return ((bs::UINT64)(bs::UINT32)x << 32) | (bs::UINT32)z;
+  }
+
+  bs::String WorldStreaming::sectorName(bs::INT32 x, bs::INT32 z)
+  {
+    return SECTOR_NAME_PREFIX + bs::toString(x) + "_" + bs::toString(z);
+  }
+
+  bs::Path WorldStreaming::sectorPath(const bs::String& zenFile, bs::INT32 x, bs::INT32 z)
+  {
+    return BsZenLib::GothicPathToCachedWorld(zenFile + "." + sectorName(x, z));
+  }
+
+  bs::Path WorldStreaming::indexPath(const bs::String& zenFile)
+  {
+    return BsZenLib::GothicPathToCachedWorld(zenFile + ".sectors");
+  }
+
+}  // namespace REGoth
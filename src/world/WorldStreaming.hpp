@@ -0,0 +1,151 @@
+#pragma once
+#include <BsPrerequisites.h>
+
+namespace REGoth
+{
+  class GameWorld;
+  using HGameWorld = bs::GameObjectHandle<GameWorld>;
+
+  /**
+   * Loads the static parts of a world only where the hero or camera is.
+   *
+   * The static parts are the tiles of the world mesh and the vobs which only have a static
+   * mesh, see Internals::StaticParts. For a streamed world, they are sorted into square
+   * sectors along the X- and Z-axis once and each sector is cached as its own prefab, see
+   * createCache(). When the world is loaded again, the static parts are not imported at all.
+   *
+   * The prefabs of the sectors near the center given to update() are then loaded in the
+   * background via bs::Resources and instantiated as children of the world once they are
+   * there. Sectors which got too far away are destroyed and their prefabs released again.
+   * That way, how long starting a world takes and how much of it is in memory depends on the
+   * view distance, not on how large the world is.
+   *
+   * Instantiating has to happen on the main thread, so only a few sectors are instantiated
+   * per update, to not stall a single frame for too long.
+   *
+   * Every streamed GameWorld has one, see GameWorld::worldStreaming(). Not saved, the world
+   * starts it again after loading, see start().
+   */
+  class WorldStreaming
+  {
+  public:
+    /**
+     * How much of the world is streamed in.
+     */
+    struct Stats
+    {
+      bs::UINT32 numSectors             = 0;
+      bs::UINT32 numLoadingSectors      = 0;
+      bs::UINT32 numInstantiatedSectors = 0;
+    };
+
+    /** Length of a side of a sector in meters */
+    static constexpr float SECTOR_SIZE = 64.0f;
+
+    /**
+     * How many sectors in each direction around the center are loaded. Sectors are unloaded
+     * again once they are one more sector away.
+     */
+    static constexpr bs::INT32 LOAD_RADIUS = 2;
+
+    /** How many loaded sectors are instantiated in one update at most */
+    static constexpr bs::UINT32 MAX_INSTANTIATIONS_PER_UPDATE = 2;
+
+    /**
+     * Sets the world to instantiate the sectors in.
+     */
+    void setWorld(HGameWorld world)
+    {
+      mWorld = world;
+    }
+
+    /**
+     * @return Whether a complete sector cache exists for the given ZEN.
+     */
+    static bool hasCache(const bs::String& zenFile);
+
+    /**
+     * Sorts the given scene objects into sectors and caches each sector as prefab.
+     *
+     * The scene objects are destroyed afterwards, they are to be streamed in via update()
+     * from then on.
+     *
+     * @param  zenFile        ZEN the objects were imported from, e.g. `NEWWORLD.ZEN`.
+     * @param  staticObjects  Static parts of the world, see Internals::StaticParts.
+     */
+    static void createCache(const bs::String& zenFile,
+                            const bs::Vector<bs::HSceneObject>& staticObjects);
+
+    /**
+     * Makes the sectors of the given ZEN be created again on the next import, see hasCache().
+     */
+    static void removeCache(const bs::String& zenFile);
+
+    /**
+     * Starts streaming the cached sectors of the given ZEN. Instances of sectors found in the
+     * world, e.g. because they were saved with it, are destroyed, the next update() brings
+     * those needed back.
+     *
+     * Throws if there is no cache for the given ZEN.
+     */
+    void start(const bs::String& zenFile);
+
+    /**
+     * Loads, instantiates and unloads sectors for the given position being the center of
+     * what should be there.
+     */
+    void update(const bs::Vector3& center);
+
+    const Stats& stats() const
+    {
+      return mStats;
+    }
+
+  private:
+    struct Sector
+    {
+      bs::INT32 x;
+      bs::INT32 z;
+
+      /** Set while the prefab is loading or loaded */
+      bs::HPrefab prefab;
+
+      /** Set once the prefab has been instantiated */
+      bs::HSceneObject instance;
+    };
+
+    static bs::INT32 sectorCoordinateOf(float value);
+    static bs::UINT64 sectorKey(bs::INT32 x, bs::INT32 z);
+    static bs::String sectorName(bs::INT32 x, bs::INT32 z);
+    static bs::Path sectorPath(const bs::String& zenFile, bs::INT32 x, bs::INT32 z);
+    static bs::Path indexPath(const bs::String& zenFile);
+
+    /**
+     * @return Where the given static object is, for sorting it into a sector. For objects
+     *         with a renderable, this is the center of its bounds, since world mesh tiles all
+     *         sit at the origin.
+     */
+    static bs::Vector3 positionForSector(bs::HSceneObject object);
+
+    /**
+     * Starts loading the prefab of the given sector, if it isn't already.
+     */
+    void loadSector(Sector& sector);
+
+    /**
+     * Destroys the instance of the given sector and releases its prefab.
+     */
+    void unloadSector(Sector& sector);
+
+    HGameWorld mWorld;
+
+    bs::String mZenFile;
+
+    bs::UnorderedMap<bs::UINT64, Sector> mSectors;
+
+    /** Keys of the sectors which are loading, loaded or instantiated */
+    bs::Vector<bs::UINT64> mLoadedSectors;
+
+    Stats mStats;
+  };
+}  // namespace REGoth
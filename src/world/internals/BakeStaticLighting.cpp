@@ -0,0 +1,115 @@
+#include "BakeStaticLighting.hpp"
+#include <Math/BsMath.h>
+#include <zenload/zTypes.h>
+#include <cmath>
+
+namespace REGoth
+{
+  /**
+   * Length of a side of the cells lights are sorted into, in meters.
+   */
+  static constexpr float LIGHT_CELL_SIZE = 10.0f;
+
+  /**
+   * Light every lightmapped polygon gets, no matter whether a static light is near.
+   */
+  static const bs::Color LIGHTMAP_AMBIENT = bs::Color(0.25f, 0.25f, 0.25f, 1.0f);
+
+  static bs::INT32 lightCellCoordinateOf(float value)
+  {
+    return (bs::INT32)std::floor(value / LIGHT_CELL_SIZE);
+  }
+
+  static bs::UINT64 lightCellKey(bs::INT32 x, bs::INT32 z)
+  {
+    return ((bs::UINT64)(bs::UINT32)x << 32) | (bs::UINT32)z;
+  }
+
+  bs::UINT32 Internals::bakeStaticLighting(ZenLoad::PackedMesh& worldMesh,
+                                           const bs::Vector<BakedLight>& lights)
+  {
+    // Every light goes into all cells its range touches, so each vertex only needs to look at
+    // the lights of its own cell
+    bs::UnorderedMap<bs::UINT64, bs::Vector<bs::UINT32>> lightsByCell;
+
+    for (bs::UINT32 i = 0; i < (bs::UINT32)lights.size(); i++)
+    {
+      const BakedLight& light = lights[i];
+
+      bs::INT32 fromX = lightCellCoordinateOf(light.position.x - light.range);
+      bs::INT32 toX   = lightCellCoordinateOf(light.position.x + light.range);
+      bs::INT32 fromZ = lightCellCoordinateOf(light.position.z - light.range);
+      bs::INT32 toZ   = lightCellCoordinateOf(light.position.z + light.range);
+
+      for (bs::INT32 x = fromX; x <= toX; x++)
+      {
+        for (bs::INT32 z = fromZ; z <= toZ; z++)
+        {
+          lightsByCell[lightCellKey(x, z)].push_back(i);
+        }
+      }
+    }
+
+    bs::Vector<bool> isLightmapped(worldMesh.vertices.size(), false);
+
+    for (const ZenLoad::PackedMesh::SubMesh& subMesh : worldMesh.subMeshes)
+    {
+      for (size_t i = 0; i + 2 < subMesh.indices.size(); i += 3)
+      {
+        if (i / 3 >= subMesh.triangleLightmapIndices.size()) break;
+        if (subMesh.triangleLightmapIndices[i / 3] < 0) continue;
+
+        for (size_t v = 0; v < 3; v++)
+        {
+          isLightmapped[subMesh.indices[i + v]] = true;
+        }
+      }
+    }
+
+    bs::UINT32 numBaked = 0;
+
+    for (size_t i = 0; i < worldMesh.vertices.size(); i++)
+    {
+      if (!isLightmapped[i]) continue;
+
+      ZenLoad::WorldVertex& vertex = worldMesh.vertices[i];
+
+      bs::Vector3 position(vertex.Position.x, vertex.Position.y, vertex.Position.z);
+      bs::Vector3 normal(vertex.Normal.x, vertex.Normal.y, vertex.Normal.z);
+      normal.normalize();
+
+      bs::Color color = LIGHTMAP_AMBIENT;
+
+      auto it = lightsByCell.find(
+          lightCellKey(lightCellCoordinateOf(position.x), lightCellCoordinateOf(position.z)));
+
+      if (it != lightsByCell.end())
+      {
+        for (bs::UINT32 index : it->second)
+        {
+          const BakedLight& light = lights[index];
+
+          bs::Vector3 toLight = light.position - position;
+          float distance      = toLight.length();
+
+          if (distance >= light.range) continue;
+
+          float facing  = distance > 0.0f ? normal.dot(toLight / distance) : 1.0f;
+          float falloff = 1.0f - distance / light.range;
+
+          color += light.color * (falloff * bs::Math::clamp01(facing));
+        }
+      }
+
+      color.r = bs::Math::clamp01(color.r);
+      color.g = bs::Math::clamp01(color.g);
+      color.b = bs::Math::clamp01(color.b);
+      color.a = 1.0f;
+
+      vertex.Color = color.getAsRGBA();
+      numBaked += 1;
+    }
+
+    return numBaked;
+  }
+}  // namespace REGoth
@@ -0,0 +1,51 @@
+/** \file
+ */
+
+#pragma once
+
+#include <BsPrerequisites.h>
+#include <Image/BsColor.h>
+#include <Math/BsVector3.h>
+
+namespace ZenLoad
+{
+  struct PackedMesh;
+};
+
+namespace REGoth
+{
+  namespace Internals
+  {
+    /**
+     * Static light of a vob, see bakeStaticLighting().
+     */
+    struct BakedLight
+    {
+      /** In meters */
+      bs::Vector3 position;
+
+      /** In meters */
+      float range;
+
+      bs::Color color;
+    };
+
+    /**
+     * Bakes the given static lights into the vertex colors of the lightmapped polygons of the
+     * world mesh.
+     *
+     * The original engine lights those polygons with lightmaps instead of their vertex colors.
+     * As the lightmaps aren't imported, their vertex colors are replaced by an ambient term
+     * plus the light of every static light in range, falling off linearly to its range like in
+     * the original engine. Walls don't cast shadows. All other polygons already had the static
+     * lights baked into their vertex colors by the original tools.
+     *
+     * @param  worldMesh  Packed world mesh, see zCMesh::packMesh().
+     * @param  lights     Static lights of the world.
+     *
+     * @return Number of vertices the lights have been baked into.
+     */
+    bs::UINT32 bakeStaticLighting(ZenLoad::PackedMesh& worldMesh,
+                                  const bs::Vector<BakedLight>& lights);
+  }  // namespace Internals
+}  // namespace REGoth
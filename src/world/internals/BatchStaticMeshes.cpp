@@ -0,0 +1,225 @@
+#include "BatchStaticMeshes.hpp"
+#include "MergeMeshes.hpp"
+#include <BsZenLib/ImportPath.hpp>
+#include <Components/BsCCollider.h>
+#include <Components/BsCRenderable.h>
+#include <Mesh/BsMesh.h>
+#include <Resources/BsResources.h>
+#include <Scene/BsSceneObject.h>
+#include <components/VisualStaticMesh.hpp>
+#include <log/logging.hpp>
+#include <original-content/ResourceManifestJournal.hpp>
+#include <algorithm>
+#include <cmath>
+
+namespace REGoth
+{
+  /**
+   * Vobs which show the same mesh inside the same cell.
+   */
+  struct InstanceGroup
+  {
+    bs::HMesh mesh;
+    bs::Vector<bs::HSceneObject> vobs;
+  };
+
+  static bool canBeBatched(bs::HSceneObject vob);
+  static bs::HSceneObject createBatch(bs::HSceneObject parent,
+                                      const bs::Vector<bs::HSceneObject>& vobs,
+                                      const bs::String& name);
+  static void removeBatchedVob(bs::HSceneObject vob);
+
+  void Internals::batchStaticMeshInstances(bs::HSceneObject parent,
+                                           bs::Vector<bs::HSceneObject>& vobs,
+                                           const bs::String& cacheName)
+  {
+    bs::UnorderedMap<bs::String, InstanceGroup> groups;
+
+    // Keep the groups in the order they were first seen in, so the cached batches always get
+    // the same names for the same world
+    bs::Vector<bs::String> groupOrder;
+
+    for (bs::HSceneObject vob : vobs)
+    {
+      if (!canBeBatched(vob)) continue;
+
+      bs::HMesh mesh = vob->getComponent<VisualStaticMesh>()->mesh();
+
+      const bs::Vector3& position = vob->getTransform().pos();
+
+      bs::INT32 x = (bs::INT32)std::floor(position.x / STATIC_MESH_BATCH_CELL_SIZE);
+      bs::INT32 z = (bs::INT32)std::floor(position.z / STATIC_MESH_BATCH_CELL_SIZE);
+
+      bs::String key = mesh.getUUID().toString() + "_" + bs::toString(x) + "_" + bs::toString(z);
+
+      auto it = groups.find(key);
+
+      if (it == groups.end())
+      {
+        InstanceGroup group;
+        group.mesh = mesh;
+
+        it = groups.emplace(key, std::move(group)).first;
+        groupOrder.push_back(key);
+      }
+
+      it->second.vobs.push_back(vob);
+    }
+
+    bs::Vector<bs::HSceneObject> batches;
+    bs::UINT32 numBatchedVobs = 0;
+
+    for (const bs::String& key : groupOrder)
+    {
+      const InstanceGroup& group = groups[key];
+
+      if (group.vobs.size() < STATIC_MESH_MIN_INSTANCES_PER_BATCH) continue;
+
+      bs::UINT32 verticesPerInstance = group.mesh->getProperties().getNumVertices();
+      bs::UINT32 instancesPerBatch =
+          std::max(1u, STATIC_MESH_MAX_VERTICES_PER_BATCH / std::max(1u, verticesPerInstance));
+
+      for (size_t first = 0; first < group.vobs.size(); first += instancesPerBatch)
+      {
+        size_t last = std::min(group.vobs.size(), first + instancesPerBatch);
+
+        if (last - first < STATIC_MESH_MIN_INSTANCES_PER_BATCH) break;
+
+        bs::Vector<bs::HSceneObject> instances(group.vobs.begin() + first,
+                                               group.vobs.begin() + last);
+
+        bs::String name = cacheName + ".batch" + bs::toString((bs::UINT32)batches.size());
+
+        bs::HSceneObject batch = createBatch(parent, instances, name);
+
+        if (!batch) continue;
+
+        for (bs::HSceneObject vob : instances)
+        {
+          removeBatchedVob(vob);
+        }
+
+        batches.push_back(batch);
+        numBatchedVobs += (bs::UINT32)instances.size();
+      }
+    }
+
+    vobs.erase(std::remove_if(vobs.begin(), vobs.end(),
+                              [](const bs::HSceneObject& vob) { return vob.isDestroyed(); }),
+               vobs.end());
+
+    vobs.insert(vobs.end(), batches.begin(), batches.end());
+
+    REGOTH_LOG(Info, World, "[BatchStaticMeshes] Batched {0} vobs into {1} batches",
+               numBatchedVobs, batches.size());
+  }
+
+  static bool canBeBatched(bs::HSceneObject vob)
+  {
+    if (vob.isDestroyed()) return false;
+    if (!vob->getName().empty()) return false;
+    if (vob->getNumChildren() != 0) return false;
+
+    HVisualStaticMesh visual = vob->getComponent<VisualStaticMesh>();
+
+    if (!visual || !visual->isBatchable() || visual->hasLODs()) return false;
+
+    bs::HMesh mesh = visual->mesh();
+
+    return mesh && mesh->getCachedData();
+  }
+
+  /**
+   * Merges the meshes of the given vobs into a new scene object.
+   *
+   * @return The new scene object. Empty if the meshes couldn't be merged.
+   */
+  static bs::HSceneObject createBatch(bs::HSceneObject parent,
+                                      const bs::Vector<bs::HSceneObject>& vobs,
+                                      const bs::String& name)
+  {
+    HVisualStaticMesh firstVisual = vobs.front()->getComponent<VisualStaticMesh>();
+
+    bs::HMesh mesh                      = firstVisual->mesh();
+    bs::Vector<bs::HMaterial> materials = firstVisual->materials();
+    bs::UINT32 numSubMeshes             = mesh->getProperties().getNumSubMeshes();
+
+    // Put the batch in the middle of its vobs, so it has a sensible position for deciding
+    // where in the world it is
+    bs::Vector3 center = bs::Vector3::ZERO;
+
+    for (bs::HSceneObject vob : vobs)
+    {
+      center += vob->getTransform().pos();
+    }
+
+    center /= (float)vobs.size();
+
+    bs::HSceneObject batchSO = bs::SceneObject::create(name);
+    batchSO->setParent(parent);
+    batchSO->setPosition(center);
+
+    bs::Matrix4 toBatch = batchSO->getTransform().getInvMatrix();
+
+    bs::Vector<Internals::MeshMergePart> parts;
+
+    for (bs::HSceneObject vob : vobs)
+    {
+      for (bs::UINT32 s = 0; s < numSubMeshes; s++)
+      {
+        Internals::MeshMergePart part;
+        part.mesh          = mesh;
+        part.subMesh       = s;
+        part.targetSubMesh = s;
+        part.transform     = toBatch * vob->getTransform().getMatrix();
+
+        parts.push_back(part);
+      }
+    }
+
+    bs::HMesh merged = Internals::mergeMeshes(parts, numSubMeshes);
+
+    if (!merged)
+    {
+      batchSO->destroy(true);
+      return {};
+    }
+
+    enum
+    {
+      Overwrite    = true,
+      KeepExisting = false,
+    };
+
+    bs::Path path = BsZenLib::GothicPathToCachedStaticMesh(name);
+
+    merged->setName(name);
+
+    addToGothicCacheManifest(merged, path);
+    bs::gResources().save(merged, path, Overwrite);
+
+    HVisualStaticMesh visual = batchSO->addComponent<VisualStaticMesh>();
+    visual->setBatchedMesh(merged, materials, firstVisual->meshFileNames());
+
+    return batchSO;
+  }
+
+  /**
+   * Takes away what the batch now does for the given vob. Vobs without a collider have
+   * nothing left to do.
+   *
+   * Destroys right away, so anything going through the scene after importing doesn't find
+   * what was batched anymore.
+   */
+  static void removeBatchedVob(bs::HSceneObject vob)
+  {
+    if (!vob->getComponent<bs::CCollider>())
+    {
+      vob->destroy(true);
+      return;
+    }
+
+    vob->getComponent<VisualStaticMesh>()->destroy(true);
+    vob->getComponent<bs::CRenderable>()->destroy(true);
+  }
+}  // namespace REGoth
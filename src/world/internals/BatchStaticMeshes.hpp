@@ -0,0 +1,50 @@
+/** \file
+ */
+
+#pragma once
+
+#include <BsPrerequisites.h>
+
+namespace REGoth
+{
+  namespace Internals
+  {
+    /**
+     * Length of a side of the square cells, along the X- and Z-axis, inside which vobs with
+     * the same mesh are batched, in meters.
+     */
+    constexpr float STATIC_MESH_BATCH_CELL_SIZE = 32.0f;
+
+    /** Fewer vobs with the same mesh inside a cell are not worth a batch */
+    constexpr bs::UINT32 STATIC_MESH_MIN_INSTANCES_PER_BATCH = 4;
+
+    /** Batches are split so no single one gets larger than this */
+    constexpr bs::UINT32 STATIC_MESH_MAX_VERTICES_PER_BATCH = 65536;
+
+    /**
+     * Draws vobs which show the same static mesh and are close to each other as one.
+     *
+     * bs:f can't draw instances of a mesh with per-instance transforms, so the meshes of a
+     * group of vobs are instead merged into a single mesh with the transforms of the vobs
+     * applied, see mergeMeshes(). That mesh is shown by a new scene object with a
+     * VisualStaticMesh, which takes the place of all the vobs' renderables. One draw call
+     * and one scene object per group is left, instead of one per vob.
+     *
+     * A vob takes part if it has a VisualStaticMesh which is batchable (see
+     * VisualStaticMesh::setBatchable()), has no less detailed versions of its mesh (those
+     * are large enough to be drawn on their own), no name (scripts might look for it) and no
+     * children. Afterwards, vobs with a collider keep it and only lose their renderable,
+     * all others are destroyed.
+     *
+     * The merged meshes are cached under the given name, so a world saved with them can be
+     * loaded again.
+     *
+     * @param  parent     Scene object to put the batches into.
+     * @param  vobs       Scene objects of static vobs to batch. Destroyed ones are removed,
+     *                    the batches are added.
+     * @param  cacheName  Name to cache the merged meshes under, e.g. the ZEN-file.
+     */
+    void batchStaticMeshInstances(bs::HSceneObject parent, bs::Vector<bs::HSceneObject>& vobs,
+                                  const bs::String& cacheName);
+  }  // namespace Internals
+}  // namespace REGoth
@@ -0,0 +1,198 @@
+#include "ChunkWorldMesh.hpp"
+#include <Math/BsMath.h>
+#include <original-content/MeshOptimization.hpp>
+#include <zenload/zTypes.h>
+#include <cmath>
+
+namespace REGoth
+{
+  /**
+   * Tile of the world mesh while it is being filled.
+   */
+  struct WorldMeshTile
+  {
+    ZenLoad::PackedMesh mesh;
+
+    /** Index of a vertex in the world mesh -> index in the tile */
+    bs::UnorderedMap<bs::UINT32, bs::UINT32> vertexIndices;
+
+    /** Index of a submesh in the world mesh -> index in the tile */
+    bs::UnorderedMap<bs::UINT32, bs::UINT32> subMeshIndices;
+  };
+
+  static bs::UINT64 tileKey(bs::INT32 x, bs::INT32 z)
+  {
+    return ((bs::UINT64)(bs::UINT32)x << 32) | (bs::UINT32)z;
+  }
+
+  static bs::UINT32 addVertexToTile(WorldMeshTile& tile, const ZenLoad::PackedMesh& worldMesh,
+                                    bs::UINT32 vertex);
+  static void growBoundingBox(ZenLoad::PackedMesh& mesh, const ZenLoad::WorldVertex& vertex);
+  static void optimizeTileOrder(ZenLoad::PackedMesh& mesh);
+
+  bs::Vector<ZenLoad::PackedMesh> Internals::chunkWorldMesh(const ZenLoad::PackedMesh& worldMesh,
+                                                            float tileSize)
+  {
+    bs::UnorderedMap<bs::UINT64, WorldMeshTile> tiles;
+
+    // Keep the tiles in the order they were first seen in, so the result doesn't depend on how
+    // the map is laid out
+    bs::Vector<bs::UINT64> tileOrder;
+
+    for (bs::UINT32 s = 0; s < (bs::UINT32)worldMesh.subMeshes.size(); s++)
+    {
+      const ZenLoad::PackedMesh::SubMesh& subMesh = worldMesh.subMeshes[s];
+
+      for (size_t i = 0; i + 2 < subMesh.indices.size(); i += 3)
+      {
+        const ZenLoad::WorldVertex& a = worldMesh.vertices[subMesh.indices[i + 0]];
+        const ZenLoad::WorldVertex& b = worldMesh.vertices[subMesh.indices[i + 1]];
+        const ZenLoad::WorldVertex& c = worldMesh.vertices[subMesh.indices[i + 2]];
+
+        float centerX = (a.Position.x + b.Position.x + c.Position.x) / 3.0f;
+        float centerZ = (a.Position.z + b.Position.z + c.Position.z) / 3.0f;
+
+        bs::UINT64 key = tileKey((bs::INT32)std::floor(centerX / tileSize),
+                                 (bs::INT32)std::floor(centerZ / tileSize));
+
+        auto it = tiles.find(key);
+
+        if (it == tiles.end())
+        {
+          it = tiles.emplace(key, WorldMeshTile{}).first;
+          tileOrder.push_back(key);
+        }
+
+        WorldMeshTile& tile = it->second;
+
+        auto subMeshIt = tile.subMeshIndices.find(s);
+
+        if (subMeshIt == tile.subMeshIndices.end())
+        {
+          ZenLoad::PackedMesh::SubMesh tileSubMesh;
+          tileSubMesh.material = subMesh.material;
+
+          tile.mesh.subMeshes.push_back(tileSubMesh);
+
+          subMeshIt =
+              tile.subMeshIndices.emplace(s, (bs::UINT32)tile.mesh.subMeshes.size() - 1).first;
+        }
+
+        ZenLoad::PackedMesh::SubMesh& tileSubMesh = tile.mesh.subMeshes[subMeshIt->second];
+
+        for (size_t v = 0; v < 3; v++)
+        {
+          tileSubMesh.indices.push_back(addVertexToTile(tile, worldMesh, subMesh.indices[i + v]));
+        }
+
+        if (i / 3 < subMesh.triangleLightmapIndices.size())
+        {
+          tileSubMesh.triangleLightmapIndices.push_back(subMesh.triangleLightmapIndices[i / 3]);
+        }
+      }
+    }
+
+    bs::Vector<ZenLoad::PackedMesh> result;
+    result.reserve(tileOrder.size());
+
+    for (bs::UINT64 key : tileOrder)
+    {
+      optimizeTileOrder(tiles[key].mesh);
+
+      result.push_back(std::move(tiles[key].mesh));
+    }
+
+    return result;
+  }
+
+  /**
+   * @return Index of the given vertex of the world mesh inside the tile. Adds it, if the tile
+   *         doesn't have it yet.
+   */
+  static bs::UINT32 addVertexToTile(WorldMeshTile& tile, const ZenLoad::PackedMesh& worldMesh,
+                                    bs::UINT32 vertex)
+  {
+    auto it = tile.vertexIndices.find(vertex);
+
+    if (it != tile.vertexIndices.end()) return it->second;
+
+    const ZenLoad::WorldVertex& v = worldMesh.vertices[vertex];
+
+    if (tile.mesh.vertices.empty())
+    {
+      tile.mesh.bbox[0] = v.Position;
+      tile.mesh.bbox[1] = v.Position;
+    }
+
+    tile.mesh.vertices.push_back(v);
+    growBoundingBox(tile.mesh, v);
+
+    bs::UINT32 index = (bs::UINT32)tile.mesh.vertices.size() - 1;
+
+    tile.vertexIndices[vertex] = index;
+
+    return index;
+  }
+
+  static void growBoundingBox(ZenLoad::PackedMesh& mesh, const ZenLoad::WorldVertex& vertex)
+  {
+    mesh.bbox[0].x = bs::Math::min(mesh.bbox[0].x, vertex.Position.x);
+    mesh.bbox[0].y = bs::Math::min(mesh.bbox[0].y, vertex.Position.y);
+    mesh.bbox[0].z = bs::Math::min(mesh.bbox[0].z, vertex.Position.z);
+
+    mesh.bbox[1].x = bs::Math::max(mesh.bbox[1].x, vertex.Position.x);
+    mesh.bbox[1].y = bs::Math::max(mesh.bbox[1].y, vertex.Position.y);
+    mesh.bbox[1].z = bs::Math::max(mesh.bbox[1].z, vertex.Position.z);
+  }
+
+  /**
+   * Reorders the triangles and vertices of the given tile so the GPU can reuse more of the
+   * transformed vertices, see optimizeTriangleOrder() and remapVerticesByFirstUse().
+   */
+  static void optimizeTileOrder(ZenLoad::PackedMesh& mesh)
+  {
+    bs::UINT32 numVertices = (bs::UINT32)mesh.vertices.size();
+
+    bs::Vector<bs::UINT32> allIndices;
+
+    for (ZenLoad::PackedMesh::SubMesh& subMesh : mesh.subMeshes)
+    {
+      bs::Vector<bs::UINT32> order = optimizeTriangleOrder(
+          subMesh.indices.data(), (bs::UINT32)subMesh.indices.size(), numVertices);
+
+      if (subMesh.triangleLightmapIndices.size() == order.size())
+      {
+        auto lightmapIndices = subMesh.triangleLightmapIndices;
+
+        for (size_t t = 0; t < order.size(); t++)
+        {
+          subMesh.triangleLightmapIndices[t] = lightmapIndices[order[t]];
+        }
+      }
+
+      allIndices.insert(allIndices.end(), subMesh.indices.begin(), subMesh.indices.end());
+    }
+
+    // The sub-meshes of a tile share its vertices, so they are remapped all at once
+    bs::Vector<bs::UINT32> origins =
+        remapVerticesByFirstUse(allIndices.data(), (bs::UINT32)allIndices.size(), numVertices);
+
+    size_t next = 0;
+
+    for (ZenLoad::PackedMesh::SubMesh& subMesh : mesh.subMeshes)
+    {
+      for (auto& index : subMesh.indices)
+      {
+        index = allIndices[next++];
+      }
+    }
+
+    auto vertices = mesh.vertices;
+
+    for (size_t v = 0; v < origins.size(); v++)
+    {
+      mesh.vertices[v] = vertices[origins[v]];
+    }
+  }
+
+}  // namespace REGoth
@@ -0,0 +1,36 @@
+/** \file
+ */
+
+#pragma once
+
+#include <BsPrerequisites.h>
+
+namespace ZenLoad
+{
+  struct PackedMesh;
+};
+
+namespace REGoth
+{
+  namespace Internals
+  {
+    /**
+     * Splits the packed world mesh into square tiles on the XZ-plane, so the renderer can cull
+     * them one by one and physics doesn't have to deal with a single huge triangle mesh.
+     *
+     * A triangle goes into the tile its center lies in, so tiles may overlap a little at their
+     * borders. Every tile only contains the vertices and materials its triangles use. Tiles
+     * without any triangles are left out.
+     *
+     * Triangles and vertices of each tile are ordered to make good use of the vertex cache of
+     * the GPU, see optimizeTriangleOrder().
+     *
+     * @param  worldMesh  Packed world mesh, see zCMesh::packMesh().
+     * @param  tileSize   Length of a tile's side in meters.
+     *
+     * @return One packed mesh per tile, with its bounding box set.
+     */
+    bs::Vector<ZenLoad::PackedMesh> chunkWorldMesh(const ZenLoad::PackedMesh& worldMesh,
+                                                   float tileSize);
+  }  // namespace Internals
+}  // namespace REGoth
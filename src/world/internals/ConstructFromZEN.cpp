@@ -1,95 +1,398 @@
 #include "ConstructFromZEN.hpp"
+#include "BakeStaticLighting.hpp"
+#include "BatchStaticMeshes.hpp"
+#include "ChunkWorldMesh.hpp"
+#include "ExtractPortals.hpp"
 #include "ImportSingleVob.hpp"
+#include <Allocators/BsFrameAlloc.h>
 #include <BsZenLib/ImportPath.hpp>
 #include <BsZenLib/ImportStaticMesh.hpp>
 #include <BsZenLib/ResourceManifest.hpp>
 #include <BsZenLib/ZenResources.hpp>
 #include <Components/BsCMeshCollider.h>
+#include <Components/BsCRenderable.h>
+#include <FileSystem/BsFileSystem.h>
 #include <Physics/BsPhysicsMesh.h>
 #include <Resources/BsResources.h>
 #include <Scene/BsSceneManager.h>
 #include <Scene/BsSceneObject.h>
 #include <components/Freepoint.hpp>
 #include <components/GameWorld.hpp>
+#include <components/Visual.hpp>
 #include <components/Waynet.hpp>
-#include <components/Waypoint.hpp>
+#include <core/Jobs.hpp>
+#include <core/Profiling.hpp>
 #include <exception/Throw.hpp>
 #include <log/logging.hpp>
+#include <original-content/PhysicsMeshCache.hpp>
+#include <original-content/SharedMaterials.hpp>
 #include <original-content/VirtualFileSystem.hpp>
+#include <world/PortalMap.hpp>
 #include <zenload/zCMesh.h>
 #include <zenload/zenParser.h>
+#include <chrono>
+#include <exception>
+#include <memory>
 
 namespace REGoth
 {
+  /**
+   * Length of a side of the tiles the world mesh is split into, in meters.
+   */
+  constexpr float WORLD_MESH_TILE_SIZE = 64.0f;
+
   struct OriginalZen
   {
     bs::String fileName;
     ZenLoad::oCWorldData vobTree;
+
+    /**
+     * Kept around so the world mesh can be packed later on. Packing takes a long time and
+     * is only needed if the world mesh hasn't been cached yet, see packedWorldMesh().
+     */
+    std::unique_ptr<ZenLoad::ZenParser> parser;
+
     ZenLoad::PackedMesh worldMesh;
+    bool isWorldMeshPacked = false;
+  };
+
+  /**
+   * Releases everything allocated through bs:f's frame allocator during an import in one go,
+   * once the import is done. Lists only needed while importing, like all vobs of the world,
+   * are kept there instead of the heap, so loading a large world doesn't leave the heap
+   * fragmented by them. Has to be created before any of these lists, so they are all gone
+   * once it is destroyed.
+   */
+  struct ImportScratchScope
+  {
+    ImportScratchScope()
+    {
+      bs::bs_frame_mark();
+    }
+
+    ~ImportScratchScope()
+    {
+      bs::bs_frame_clear();
+    }
+
+    ImportScratchScope(const ImportScratchScope&) = delete;
+    ImportScratchScope& operator=(const ImportScratchScope&) = delete;
+  };
+
+  /**
+   * What walkVobTree() needs to know about the import as a whole.
+   */
+  struct VobImport
+  {
+    HGameWorld gameWorld;
+    Internals::VobResources resources;
+    Internals::StaticParts staticParts;
+
+    /** Scene objects created for static vobs, see Internals::isStaticVob() */
+    bs::Vector<bs::HSceneObject> staticVobs;
   };
 
   static bool importZEN(const bs::String& zenFile, OriginalZen& result);
-  static bs::HSceneObject importWorldMesh(const OriginalZen& zen);
-  static void importVobs(bs::HSceneObject sceneRoot, HGameWorld gameWorld, const OriginalZen& zen);
+  static bs::HSceneObject importWorldMesh(OriginalZen& zen);
+  static bs::HSceneObject importCachedWorldMesh(const bs::String& zenFile);
+  static const ZenLoad::PackedMesh& packedWorldMesh(OriginalZen& zen);
+  static bs::String worldMeshTileFileName(const bs::String& meshFileName, bs::UINT32 tile);
+  static void importVobs(bs::HSceneObject sceneRoot, HGameWorld gameWorld, const OriginalZen& zen,
+                         Internals::StaticParts staticParts,
+                         bs::Vector<bs::HSceneObject>* staticObjects);
   static void importWaynet(bs::HSceneObject sceneRoot, const OriginalZen& zen);
-  static void walkVobTree(bs::HSceneObject bsfParent, HGameWorld gameWorld,
-                          const ZenLoad::zCVobData& zenParent);
-
-  bs::HSceneObject Internals::constructFromZEN(HGameWorld gameWorld, const bs::String& zenFile)
+  static void walkVobTree(bs::HSceneObject bsfParent, const ZenLoad::zCVobData& zenParent,
+                          VobImport& import);
+  static bs::FrameVector<const ZenLoad::zCVobData*> collectVobs(
+      const OriginalZen& zen, Internals::StaticParts staticParts);
+  static void prefetchVobFiles(const bs::FrameVector<const ZenLoad::zCVobData*>& vobs);
+
+  bs::HSceneObject Internals::constructFromZEN(HGameWorld gameWorld, const bs::String& zenFile,
+                                               StaticParts staticParts,
+                                               bs::Vector<bs::HSceneObject>* staticObjects)
   {
+    REGOTH_PROFILE_SCOPE("ImportZEN");
+
+    using Clock = std::chrono::steady_clock;
+
+    ImportScratchScope scratch;
+
     OriginalZen zen;
+    bool hasLoadedZEN = false;
 
-    bool hasLoadedZEN = importZEN(zenFile, zen);
+    bs::HSceneObject worldMesh;
+
+    // Exceptions can't leave the job, so a broken ZEN is rethrown once parsing is done
+    std::exception_ptr parseError;
+
+    auto start        = Clock::now();
+    auto parsed       = start;
+    auto worldMeshEnd = start;
+
+    {
+      // Parsing large worlds takes long. A cached world mesh doesn't need anything parsed, so
+      // it is loaded and set up meanwhile.
+      Jobs::JobGroup parsing("ParseZEN");
+      parsing.run([&]() {
+        try
+        {
+          hasLoadedZEN = importZEN(zenFile, zen);
+        }
+        catch (...)
+        {
+          parseError = std::current_exception();
+        }
+
+        parsed = Clock::now();
+      });
+
+      if (staticParts == StaticParts::Import)
+      {
+        worldMesh    = importCachedWorldMesh(zenFile);
+        worldMeshEnd = Clock::now();
+      }
+
+      parsing.wait();
+    }
+
+    if (parseError)
+    {
+      if (worldMesh) worldMesh->destroy();
+
+      std::rethrow_exception(parseError);
+    }
 
     if (!hasLoadedZEN)
     {
-      REGOTH_LOG(Warning, Uncategorized, "[ConstructFromZEN] Failed to read zen-file: {0}", zenFile);
+      if (worldMesh) worldMesh->destroy();
+
+      REGOTH_LOG(Warning, World, "[ConstructFromZEN] Failed to read zen-file: {0}", zenFile);
       return {};
     }
 
-    bs::HSceneObject worldMesh = importWorldMesh(zen);
-    worldMesh->setParent(gameWorld->SO());
+    auto toMs = [&](Clock::time_point t) {
+      return (bs::UINT32)std::chrono::duration_cast<std::chrono::milliseconds>(t - start).count();
+    };
 
-    importVobs(gameWorld->SO(), gameWorld, zen);
+    REGOTH_LOG(Info, World,
+               "[ConstructFromZEN] Parsed {0} in {1} ms, cached world mesh {2} after {3} ms",
+               zenFile, toMs(parsed), worldMesh ? "set up" : "not found", toMs(worldMeshEnd));
+
+    bs::HSceneObject root = gameWorld->SO();
+
+    if (staticParts == StaticParts::Import)
+    {
+      root = worldMesh ? worldMesh : importWorldMesh(zen);
+      root->setParent(gameWorld->SO());
+
+      if (staticObjects)
+      {
+        for (bs::UINT32 i = 0; i < root->getNumChildren(); i++)
+        {
+          staticObjects->push_back(root->getChild(i));
+        }
+      }
+    }
+
+    importVobs(gameWorld->SO(), gameWorld, zen, staticParts, staticObjects);
     importWaynet(gameWorld->SO(), zen);
 
-    return worldMesh;
+    return root;
   }
 
   bs::HSceneObject Internals::loadWorldMeshFromZEN(const bs::String& zenFile)
   {
+    // The ZEN only has to be parsed if the world mesh isn't cached
+    bs::HSceneObject cached = importCachedWorldMesh(zenFile);
+
+    if (cached) return cached;
+
     OriginalZen zen;
 
     bool hasLoadedZEN = importZEN(zenFile, zen);
 
     if (!hasLoadedZEN)
     {
-      REGOTH_LOG(Warning, Uncategorized, "[ConstructFromZEN] Failed to read zen-file: {0}", zenFile);
+      REGOTH_LOG(Warning, World, "[ConstructFromZEN] Failed to read zen-file: {0}", zenFile);
       return {};
     }
 
     return importWorldMesh(zen);
   }
 
-  static void importVobs(bs::HSceneObject sceneRoot, HGameWorld gameWorld, const OriginalZen& zen)
+  void Internals::removeCachedWorldMesh(const bs::String& zenFile)
   {
+    bs::String meshFileName = zenFile + ".worldmesh";
+
+    // The first tile goes first, so the others are never used without it, see
+    // importAndCacheWorldMeshTiles()
+    for (bs::UINT32 tile = 0;; tile++)
+    {
+      bs::String tileFileName = worldMeshTileFileName(meshFileName, tile);
+
+      if (!BsZenLib::HasCachedStaticMesh(tileFileName)) break;
+
+      bs::FileSystem::remove(BsZenLib::GothicPathToCachedStaticMesh(tileFileName));
+      gPhysicsMeshCache().remove(tileFileName);
+    }
+
+    bs::Path portalMapPath = PortalMap::cachePathFor(zenFile);
+
+    if (bs::FileSystem::exists(portalMapPath))
+    {
+      bs::FileSystem::remove(portalMapPath);
+    }
+  }
+
+  static void importVobs(bs::HSceneObject sceneRoot, HGameWorld gameWorld, const OriginalZen& zen,
+                         Internals::StaticParts staticParts,
+                         bs::Vector<bs::HSceneObject>* staticObjects)
+  {
+    using Clock = std::chrono::steady_clock;
+
+    // Loading the resources the vobs need is what takes long. Get them all loading at once
+    // first, so creating the scene objects afterwards doesn't have to wait for each one.
+    auto start = Clock::now();
+
+    bs::FrameVector<const ZenLoad::zCVobData*> vobs = collectVobs(zen, staticParts);
+    prefetchVobFiles(vobs);
+
+    VobImport import;
+    import.gameWorld     = gameWorld;
+    import.staticParts = staticParts;
+
+    Internals::prepareVobResources(vobs, import.resources);
+
+    auto resourcesDone = Clock::now();
+
+    for (const ZenLoad::zCVobData& root : zen.vobTree.rootVobs)
+    {
+      walkVobTree(sceneRoot, root, import);
+    }
+
+    Internals::batchStaticMeshInstances(sceneRoot, import.staticVobs, zen.fileName);
+
+    if (staticObjects)
+    {
+      staticObjects->insert(staticObjects->end(), import.staticVobs.begin(),
+                            import.staticVobs.end());
+    }
+
+    auto vobsDone = Clock::now();
+
+    auto toMs = [](Clock::duration d) {
+      return (bs::UINT32)std::chrono::duration_cast<std::chrono::milliseconds>(d).count();
+    };
+
+    REGOTH_LOG(Info, World,
+               "[ConstructFromZEN] Imported {0} vobs: {1} ms for resources of {2} visuals ({3} "
+               "physics meshes), {4} ms for scene objects",
+               vobs.size(), toMs(resourcesDone - start), import.resources.numUniqueVisuals,
+               import.resources.numPhysicsMeshes, toMs(vobsDone - resourcesDone));
+  }
+
+  /**
+   * @return All vobs walkVobTree() will import, in no particular order.
+   */
+  static bs::FrameVector<const ZenLoad::zCVobData*> collectVobs(
+      const OriginalZen& zen, Internals::StaticParts staticParts)
+  {
+    bs::FrameVector<const ZenLoad::zCVobData*> vobs;
+    bs::FrameVector<const ZenLoad::zCVobData*> parents;
+
     for (const ZenLoad::zCVobData& root : zen.vobTree.rootVobs)
     {
-      walkVobTree(sceneRoot, gameWorld, root);
+      parents.push_back(&root);
     }
+
+    while (!parents.empty())
+    {
+      const ZenLoad::zCVobData* parent = parents.back();
+      parents.pop_back();
+
+      for (const auto& v : parent->childVobs)
+      {
+        if (staticParts == Internals::StaticParts::Skip && Internals::isStaticVob(v)) continue;
+
+        vobs.push_back(&v);
+        parents.push_back(&v);
+      }
+    }
+
+    return vobs;
   }
 
-  static void walkVobTree(bs::HSceneObject bsfParent, HGameWorld gameWorld,
-                          const ZenLoad::zCVobData& zenParent)
+  /**
+   * Lets the VDFS start loading the original files of the visuals the given vobs show, so
+   * importing the ones not cached yet doesn't have to wait for the disk as much.
+   */
+  static void prefetchVobFiles(const bs::FrameVector<const ZenLoad::zCVobData*>& vobs)
+  {
+    bs::FrameUnorderedSet<bs::String> visuals;
+
+    for (const ZenLoad::zCVobData* vob : vobs)
+    {
+      if (!vob->visual.empty()) visuals.insert(vob->visual.c_str());
+    }
+
+    bs::Vector<bs::String> files;
+
+    for (const bs::String& visual : visuals)
+    {
+      bs::String base = visual.substr(0, visual.find_last_of('.'));
+
+      switch (Visual::guessVisualKind(visual))
+      {
+        case Visual::VisualKind::StaticMesh:
+          // Cached meshes are not read from the VDFS at all
+          if (BsZenLib::HasCachedStaticMesh(visual)) break;
+
+          files.push_back(visual);
+          files.push_back(base + ".MRM");
+          break;
+
+        case Visual::VisualKind::MorphMesh:
+          files.push_back(base + ".MMB");
+          break;
+
+        case Visual::VisualKind::InteractiveObject:
+          files.push_back(base + ".MDS");
+          files.push_back(base + ".MSB");
+          files.push_back(base + ".MDH");
+          files.push_back(base + ".MDM");
+          break;
+
+        default:
+          break;
+      }
+    }
+
+    bs::UINT64 numBytes = gVirtualFileSystem().prefetch(files);
+
+    REGOTH_LOG(Info, World, "[ConstructFromZEN] Prefetching {0} KB for {1} visuals",
+               numBytes / 1024, visuals.size());
+  }
+
+  static void walkVobTree(bs::HSceneObject bsfParent, const ZenLoad::zCVobData& zenParent,
+                          VobImport& import)
   {
     for (const auto& v : zenParent.childVobs)
     {
-      bs::HSceneObject so = Internals::importSingleVob(v, bsfParent, gameWorld);
+      bool isStatic = Internals::isStaticVob(v);
+
+      if (isStatic && import.staticParts == Internals::StaticParts::Skip) continue;
+
+      bs::HSceneObject so =
+          Internals::importSingleVob(v, bsfParent, import.gameWorld, import.resources);
+
+      if (!so) continue;
 
-      if (so)
+      if (isStatic)
       {
-        walkVobTree(so, gameWorld, v);
+        import.staticVobs.push_back(so);
       }
+
+      walkVobTree(so, v, import);
     }
   }
 
@@ -98,83 +401,255 @@ namespace REGoth
    */
   static bool importZEN(const bs::String& zenFile, OriginalZen& result)
   {
-    ZenLoad::ZenParser zenParser(zenFile.c_str(), gVirtualFileSystem().getFileIndex());
+    auto zenParser =
+        std::make_unique<ZenLoad::ZenParser>(zenFile.c_str(), gVirtualFileSystem().getFileIndex());
 
-    if (zenParser.getFileSize() == 0) return false;
+    if (zenParser->getFileSize() == 0) return false;
 
-    zenParser.readHeader();
+    zenParser->readHeader();
 
     result.fileName = zenFile;
 
-    zenParser.readWorld(result.vobTree);
+    zenParser->readWorld(result.vobTree);
 
-    // FIXME: Don't pack the mesh if it was already cached, packing takes a long time...
-    zenParser.getWorldMesh()->packMesh(result.worldMesh, 0.01f);
+    // The world mesh is only packed on demand, see packedWorldMesh()
+    result.parser            = std::move(zenParser);
+    result.isWorldMeshPacked = false;
 
     return true;
   }
 
   /**
-   * Create a bs:f scene object holding the world mesh.
+   * Collects the static lights of the given vob and its children, see
+   * Internals::bakeStaticLighting().
    */
-  static bs::HSceneObject importWorldMesh(const OriginalZen& zen)
+  static void collectStaticLights(const ZenLoad::zCVobData& vob,
+                                  bs::Vector<Internals::BakedLight>& lights)
   {
-    bs::String meshFileName = zen.fileName + ".worldmesh";
+    if (vob.objectClass == "zCVobLight:zCVob" && vob.zCVobLight.lightStatic)
+    {
+      bs::Vector3 positionCM    = bs::Vector3(vob.position.x, vob.position.y, vob.position.z);
+      float centimetersToMeters = 0.01f;
+
+      Internals::BakedLight light;
+      light.position = positionCM * centimetersToMeters;
+      light.range    = vob.zCVobLight.range * centimetersToMeters;
+      light.color    = bs::Color::fromRGBA(vob.zCVobLight.color);
+
+      lights.push_back(light);
+    }
 
-    BsZenLib::Res::HMeshWithMaterials mesh;
-    if (BsZenLib::HasCachedStaticMesh(meshFileName))
+    for (const ZenLoad::zCVobData& child : vob.childVobs)
     {
-      mesh = BsZenLib::LoadCachedStaticMesh(meshFileName);
+      collectStaticLights(child, lights);
+    }
+  }
 
-      // This shouldn't be needed, but sometimes the worldmesh in mesh->getMesh() seems to get lost?
-      if (!mesh.isLoaded())
+  /**
+   * @return The world mesh of the given zen, packed the first time it is needed. The static
+   *         lights are baked into it, see Internals::bakeStaticLighting().
+   */
+  static const ZenLoad::PackedMesh& packedWorldMesh(OriginalZen& zen)
+  {
+    if (!zen.isWorldMeshPacked)
+    {
+      REGOTH_LOG(Info, World, "[ConstructFromZEN] Packing world mesh of {0}",
+                 zen.fileName);
+
+      zen.parser->getWorldMesh()->packMesh(zen.worldMesh, 0.01f);
+      zen.isWorldMeshPacked = true;
+
+      bs::Vector<Internals::BakedLight> lights;
+
+      for (const ZenLoad::zCVobData& root : zen.vobTree.rootVobs)
       {
-        REGOTH_LOG(Warning, Uncategorized,
-                   "Failed to load cached world mesh of zen {0} - rechaching it!", zen.fileName);
-        mesh = BsZenLib::ImportAndCacheStaticMesh(meshFileName, zen.worldMesh,
-                                                  gVirtualFileSystem().getFileIndex());
+        collectStaticLights(root, lights);
       }
+
+      bs::UINT32 numBaked = Internals::bakeStaticLighting(zen.worldMesh, lights);
+
+      REGOTH_LOG(Info, World, "[ConstructFromZEN] Baked {0} static lights into {1} vertices",
+                 lights.size(), numBaked);
     }
-    else
+
+    return zen.worldMesh;
+  }
+
+  /**
+   * @return Name the tile with the given index of the world mesh is cached under.
+   */
+  static bs::String worldMeshTileFileName(const bs::String& meshFileName, bs::UINT32 tile)
+  {
+    return meshFileName + ".tile" + bs::toString(tile);
+  }
+
+  /**
+   * Splits the world mesh into tiles and caches each of them, see Internals::chunkWorldMesh().
+   */
+  static bs::Vector<BsZenLib::Res::HMeshWithMaterials> importAndCacheWorldMeshTiles(
+      OriginalZen& zen, const bs::String& meshFileName)
+  {
+    bs::Vector<ZenLoad::PackedMesh> tiles =
+        Internals::chunkWorldMesh(packedWorldMesh(zen), WORLD_MESH_TILE_SIZE);
+
+    REGOTH_LOG(Info, World, "[ConstructFromZEN] Split world mesh of {0} into {1} tiles",
+               zen.fileName, tiles.size());
+
+    bs::Vector<BsZenLib::Res::HMeshWithMaterials> meshes(tiles.size());
+
+    // Cache the first tile last: Finding it means all others have been cached too, even if
+    // caching was interrupted.
+    for (size_t i = tiles.size(); i > 0; i--)
     {
-      mesh = BsZenLib::ImportAndCacheStaticMesh(meshFileName, zen.worldMesh,
-                                                gVirtualFileSystem().getFileIndex());
+      bs::UINT32 tile = (bs::UINT32)i - 1;
+
+      meshes[tile] = BsZenLib::ImportAndCacheStaticMesh(worldMeshTileFileName(meshFileName, tile),
+                                                        tiles[tile],
+                                                        gVirtualFileSystem().getFileIndex());
     }
 
-    bs::HMesh actualMesh = mesh->getMesh();
+    return meshes;
+  }
+
+  /**
+   * Loads the cached tiles of the world mesh.
+   *
+   * @return Tiles of the world mesh. Empty if they are not cached or some failed to load.
+   */
+  static bs::Vector<BsZenLib::Res::HMeshWithMaterials> loadCachedWorldMeshTiles(
+      const bs::String& meshFileName)
+  {
+    bs::Vector<BsZenLib::Res::HMeshWithMaterials> meshes;
+
+    // Tiles are loaded in parallel
+    for (bs::UINT32 tile = 0;; tile++)
+    {
+      bs::String tileFileName = worldMeshTileFileName(meshFileName, tile);
+
+      if (!BsZenLib::HasCachedStaticMesh(tileFileName)) break;
+
+      meshes.push_back(bs::gResources().loadAsync<BsZenLib::Res::MeshWithMaterials>(
+          BsZenLib::GothicPathToCachedStaticMesh(tileFileName)));
+    }
 
-    if (!mesh.isLoaded())
+    for (auto& mesh : meshes)
     {
-      REGOTH_THROW(InvalidStateException, "Failed to load world mesh for zen " + zen.fileName);
+      mesh.blockUntilLoaded();
+
+      // This shouldn't be needed, but sometimes the worldmesh in mesh->getMesh() seems to get lost?
+      if (!mesh.isLoaded() || !mesh->getMesh())
+      {
+        return {};
+      }
     }
 
-    bs::HSceneObject meshSO    = bs::SceneObject::create(meshFileName);
-    bs::HRenderable renderable = meshSO->addComponent<bs::CRenderable>();
-    renderable->setMesh(mesh->getMesh());
-    renderable->setMaterials(mesh->getMaterials());
+    return meshes;
+  }
 
-    if (!actualMesh->getCachedData())
+  /**
+   * Creates the scene object holding the given tiles of the world mesh, see importWorldMesh().
+   */
+  static bs::HSceneObject createWorldMeshObject(
+      const bs::String& meshFileName,
+      const bs::Vector<BsZenLib::Res::HMeshWithMaterials>& meshes)
+  {
+    bs::HSceneObject meshSO = bs::SceneObject::create(meshFileName);
+
+    for (bs::UINT32 tile = 0; tile < (bs::UINT32)meshes.size(); tile++)
     {
-      REGOTH_LOG(Error, Uncategorized,
-                 "Cannot extract world mesh for physics, no mesh data available!");
+      const BsZenLib::Res::HMeshWithMaterials& mesh = meshes[tile];
+
+      if (!mesh.isLoaded() || !mesh->getMesh())
+      {
+        REGOTH_THROW(InvalidStateException, "Failed to load world mesh " + meshFileName);
+      }
+
+      gPhysicsMeshCache().request(worldMeshTileFileName(meshFileName, tile), mesh->getMesh());
     }
-    else
+
+    // Cooks the missing tiles in parallel
+    gPhysicsMeshCache().finishRequests();
+
+    for (bs::UINT32 tile = 0; tile < (bs::UINT32)meshes.size(); tile++)
     {
-      bs::HPhysicsMesh physicsMesh =
-          bs::PhysicsMesh::create(mesh->getMesh()->getCachedData(), bs::PhysicsMeshType::Triangle);
+      const BsZenLib::Res::HMeshWithMaterials& mesh = meshes[tile];
+
+      bs::String tileFileName = worldMeshTileFileName(meshFileName, tile);
+
+      bs::HSceneObject tileSO = bs::SceneObject::create(tileFileName);
+      tileSO->setParent(meshSO);
 
-      bs::Path physicsMeshPath = BsZenLib::GothicPathToCachedStaticMesh(meshFileName + ".physics");
+      bs::HRenderable renderable = tileSO->addComponent<bs::CRenderable>();
+      renderable->setMesh(mesh->getMesh());
+      renderable->setMaterials(gSharedMaterials().find(mesh->getMaterials()));
 
-      BsZenLib::AddToResourceManifest(physicsMesh, physicsMeshPath);
-      bs::gResources().save(physicsMesh, physicsMeshPath, true);
+      bs::HPhysicsMesh physicsMesh = gPhysicsMeshCache().get(tileFileName);
 
-      bs::HMeshCollider collider = meshSO->addComponent<bs::CMeshCollider>();
-      collider->setMesh(physicsMesh);
+      if (physicsMesh)
+      {
+        bs::HMeshCollider collider = tileSO->addComponent<bs::CMeshCollider>();
+        collider->setMesh(physicsMesh);
+      }
     }
 
     return meshSO;
   }
 
+  /**
+   * Like importWorldMesh(), but only from the cache, so the ZEN doesn't have to be parsed.
+   *
+   * @return The world mesh. Empty if its tiles or its portal map are not cached.
+   */
+  static bs::HSceneObject importCachedWorldMesh(const bs::String& zenFile)
+  {
+    if (!bs::FileSystem::exists(PortalMap::cachePathFor(zenFile))) return {};
+
+    bs::String meshFileName = zenFile + ".worldmesh";
+
+    bs::Vector<BsZenLib::Res::HMeshWithMaterials> meshes = loadCachedWorldMeshTiles(meshFileName);
+
+    if (meshes.empty()) return {};
+
+    return createWorldMeshObject(meshFileName, meshes);
+  }
+
+  /**
+   * Create a bs:f scene object holding the world mesh.
+   *
+   * The world mesh is split into tiles, each being a child scene object with its own renderable
+   * and collider. That way, the renderer can cull the parts not in view and physics only has to
+   * deal with the tiles something is actually near. Every tile is cached on its own.
+   *
+   * The sectors and portals of the world mesh are cached next to the tiles, see PortalMap.
+   */
+  static bs::HSceneObject importWorldMesh(OriginalZen& zen)
+  {
+    bs::String meshFileName = zen.fileName + ".worldmesh";
+
+    bs::Vector<BsZenLib::Res::HMeshWithMaterials> meshes = loadCachedWorldMeshTiles(meshFileName);
+
+    if (meshes.empty())
+    {
+      if (BsZenLib::HasCachedStaticMesh(worldMeshTileFileName(meshFileName, 0)))
+      {
+        REGOTH_LOG(Warning, World,
+                   "Failed to load cached world mesh of zen {0} - rechaching it!", zen.fileName);
+      }
+
+      meshes = importAndCacheWorldMeshTiles(zen, meshFileName);
+    }
+
+    // Sectors and portals come from the same polygons, see PortalVisibility
+    bs::Path portalMapPath = PortalMap::cachePathFor(zen.fileName);
+
+    if (!bs::FileSystem::exists(portalMapPath))
+    {
+      Internals::extractPortalMap(packedWorldMesh(zen))->save(portalMapPath);
+    }
+
+    return createWorldMeshObject(meshFileName, meshes);
+  }
+
   static void importWaynet(bs::HSceneObject sceneRoot, const OriginalZen& zen)
   {
     const ZenLoad::zCWayNetData& zenWaynet = zen.vobTree.waynet;
@@ -184,34 +659,24 @@ namespace REGoth
 
     HWaynet waynet = waynetSO->addComponent<Waynet>();
 
-    bs::Vector<HWaypoint> waypoints;
-
+    // Waypoints are plain data of the waynet, no scene objects, see Waynet
     for (const ZenLoad::zCWaypointData& zenWP : zenWaynet.waypoints)
     {
-      bs::String wpName     = zenWP.wpName.c_str();
-      bs::HSceneObject wpSO = bs::SceneObject::create(wpName);
-      wpSO->setParent(waynetSO);
-
       bs::Vector3 positionCM = bs::Vector3(zenWP.position.x, zenWP.position.y, zenWP.position.z);
+      bs::Vector3 direction  = bs::Vector3(zenWP.direction.x, zenWP.direction.y, zenWP.direction.z);
 
-      wpSO->setPosition(positionCM * 0.01f);
-      wpSO->setForward(bs::Vector3(zenWP.direction.x, zenWP.direction.y, zenWP.direction.z));
-
-      HWaypoint wp = wpSO->addComponent<Waypoint>();
-
-      waynet->addWaypoint(wp);
-      waypoints.push_back(wp);
+      waynet->addWaypoint(zenWP.wpName.c_str(), positionCM * 0.01f, direction);
     }
 
     for (const auto& edge : zenWaynet.edges)
     {
-      if (edge.first > waypoints.size() || edge.second > waypoints.size())
+      if (edge.first >= waynet->numWaypoints() || edge.second >= waynet->numWaypoints())
       {
         REGOTH_THROW(InvalidParametersException, "Waynet Edge Indices out of range!");
       }
 
-      waypoints[edge.first]->addPathTo(waypoints[edge.second]);
-      waypoints[edge.second]->addPathTo(waypoints[edge.first]);
+      waynet->addPath(edge.first, edge.second);
+      waynet->addPath(edge.second, edge.first);
     }
 
     // FIXME: Initializes internal data structures for findComponents() to work. Should be removed
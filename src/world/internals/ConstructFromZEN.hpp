@@ -12,24 +12,53 @@ namespace REGoth
 
   namespace Internals
   {
+    /**
+     * What to do with the static parts of a world: The tiles of the world mesh and the vobs
+     * which only have a static mesh, see isStaticVob(). Those can be streamed in instead,
+     * see WorldStreaming.
+     */
+    enum class StaticParts
+    {
+      Import,
+      Skip,
+    };
+
     /**
      * This function will load the given zenFile from the virtual file system
      * and fully convert it into a bs::f scene.
      *
-     * @param  gameWorld  World to create the objects in.
-     * @param  zenFile    Uppercase ZEN-file name, e.g. "OLDWORLD.ZEN".
+     * The ZEN is parsed on a worker thread while a cached world mesh is set up on the calling
+     * one, since neither needs the other.
      *
-     * @return Root of the created scene.
+     * @param  gameWorld      World to create the objects in.
+     * @param  zenFile        Uppercase ZEN-file name, e.g. "OLDWORLD.ZEN".
+     * @param  staticParts    Whether to import the static parts of the world.
+     * @param  staticObjects  If set and the static parts are imported, the scene objects
+     *                        created for them are put in here.
+     *
+     * @return Root of the created scene: The world mesh, or the scene object of the world if
+     *         the static parts were skipped. Empty if the ZEN could not be read.
      */
-    bs::HSceneObject constructFromZEN(HGameWorld gameWorld, const bs::String& zenFile);
+    bs::HSceneObject constructFromZEN(HGameWorld gameWorld, const bs::String& zenFile,
+                                      StaticParts staticParts = StaticParts::Import,
+                                      bs::Vector<bs::HSceneObject>* staticObjects = nullptr);
 
     /**
-     * Will load the given ZEN, but only add its world mesh to the scene.
+     * Will load the given ZEN, but only add its world mesh to the scene. The ZEN isn't even
+     * parsed if the world mesh is cached already.
      *
      * @param  zenFile  Uppercase ZEN-File name, e.g. "OLDWORLD.ZEN".
      *
      * @return Root of the created scene.
      */
     bs::HSceneObject loadWorldMeshFromZEN(const bs::String& zenFile);
+
+    /**
+     * Removes the cached world mesh of the given ZEN, so it is imported from the ZEN again
+     * next time. Meant for when the ZEN changed.
+     *
+     * @param  zenFile  Uppercase ZEN-File name, e.g. "OLDWORLD.ZEN".
+     */
+    void removeCachedWorldMesh(const bs::String& zenFile);
   }  // namespace Internals
 }  // namespace REGoth
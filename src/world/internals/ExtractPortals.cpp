@@ -0,0 +1,171 @@
+#include "ExtractPortals.hpp"
+#include <Math/BsMath.h>
+#include <log/logging.hpp>
+#include <world/PortalMap.hpp>
+#include <zenload/zTypes.h>
+#include <cmath>
+
+namespace REGoth
+{
+  /**
+   * How far in front of and behind a portal to look for the sectors it connects, in meters.
+   */
+  static constexpr float PORTAL_PROBE_DISTANCE = 0.5f;
+
+  static bs::Vector3 toVector3(const ZenLoad::WorldVertex& vertex)
+  {
+    return bs::Vector3(vertex.Position.x, vertex.Position.y, vertex.Position.z);
+  }
+
+  /**
+   * Key of a vertex position, so vertices at the same place share it. Rounded to centimeters.
+   */
+  static bs::String vertexKey(const bs::Vector3& position)
+  {
+    return bs::toString((bs::INT32)std::lround(position.x * 100.0f)) + "," +
+           bs::toString((bs::INT32)std::lround(position.y * 100.0f)) + "," +
+           bs::toString((bs::INT32)std::lround(position.z * 100.0f));
+  }
+
+  static size_t findGroup(bs::Vector<size_t>& parents, size_t index)
+  {
+    while (parents[index] != index)
+    {
+      parents[index] = parents[parents[index]];
+      index          = parents[index];
+    }
+
+    return index;
+  }
+
+  bs::SPtr<PortalMap> Internals::extractPortalMap(const ZenLoad::PackedMesh& worldMesh)
+  {
+    auto map = bs::bs_shared_ptr_new<PortalMap>();
+
+    // Sector index of the world mesh -> Sector in the map
+    bs::UnorderedMap<bs::UINT32, bs::UINT32> sectors;
+
+    // Indices of the portal triangles
+    bs::Vector<size_t> portalTriangles;
+
+    for (size_t i = 0; i < worldMesh.triangles.size(); i++)
+    {
+      const ZenLoad::WorldTriangle& triangle = worldMesh.triangles[i];
+
+      if (triangle.flags.portalPoly)
+      {
+        portalTriangles.push_back(i);
+        continue;
+      }
+
+      if (!triangle.flags.sectorPoly) continue;
+
+      auto it = sectors.find(triangle.flags.sectorIndex);
+
+      if (it == sectors.end())
+      {
+        it = sectors.emplace(triangle.flags.sectorIndex, map->addSector()).first;
+      }
+
+      map->addSectorTriangle(it->second, toVector3(triangle.vertices[0]),
+                             toVector3(triangle.vertices[1]), toVector3(triangle.vertices[2]));
+    }
+
+    if (sectors.empty()) return map;
+
+    // Join portal triangles sharing a vertex, a single door is made of several of them
+    bs::Vector<size_t> parents(portalTriangles.size());
+    bs::UnorderedMap<bs::String, size_t> firstTriangleAt;
+
+    for (size_t p = 0; p < portalTriangles.size(); p++)
+    {
+      parents[p] = p;
+
+      for (const ZenLoad::WorldVertex& vertex : worldMesh.triangles[portalTriangles[p]].vertices)
+      {
+        bs::String key = vertexKey(toVector3(vertex));
+        auto it        = firstTriangleAt.find(key);
+
+        if (it == firstTriangleAt.end())
+        {
+          firstTriangleAt[key] = p;
+        }
+        else
+        {
+          parents[findGroup(parents, p)] = findGroup(parents, it->second);
+        }
+      }
+    }
+
+    struct PortalGroup
+    {
+      bs::AABox bounds;
+      bs::Vector3 normal = bs::Vector3::ZERO;
+
+      /** Area of the largest triangle, whose normal is used */
+      float largestArea = -1.0f;
+    };
+
+    bs::Map<size_t, PortalGroup> groups;
+
+    for (size_t p = 0; p < portalTriangles.size(); p++)
+    {
+      const ZenLoad::WorldTriangle& triangle = worldMesh.triangles[portalTriangles[p]];
+
+      bs::Vector3 a = toVector3(triangle.vertices[0]);
+      bs::Vector3 b = toVector3(triangle.vertices[1]);
+      bs::Vector3 c = toVector3(triangle.vertices[2]);
+
+      auto it = groups.find(findGroup(parents, p));
+
+      if (it == groups.end())
+      {
+        it                = groups.emplace(findGroup(parents, p), PortalGroup{}).first;
+        it->second.bounds = bs::AABox(a, a);
+      }
+
+      PortalGroup& group = it->second;
+
+      group.bounds.merge(a);
+      group.bounds.merge(b);
+      group.bounds.merge(c);
+
+      bs::Vector3 cross = (b - a).cross(c - a);
+      float area        = cross.length();
+
+      if (area > group.largestArea)
+      {
+        group.largestArea = area;
+        group.normal      = area > 0.0f ? cross / area : bs::Vector3::UNIT_X;
+      }
+    }
+
+    bs::UINT32 numSkipped = 0;
+
+    for (const auto& it : groups)
+    {
+      const PortalGroup& group = it.second;
+
+      bs::Vector3 center = group.bounds.getCenter();
+      bs::Vector3 offset = group.normal * PORTAL_PROBE_DISTANCE;
+
+      bs::UINT32 front = map->findSectorAt(center + offset);
+      bs::UINT32 back  = map->findSectorAt(center - offset);
+
+      if (front == back)
+      {
+        numSkipped += 1;
+        continue;
+      }
+
+      map->addPortal(group.bounds, front, back);
+    }
+
+    REGOTH_LOG(Info, World,
+               "[ExtractPortals] Found {0} sectors and {1} portals, skipped {2} portals leading "
+               "nowhere",
+               map->numSectors(), map->numPortals(), numSkipped);
+
+    return map;
+  }
+}  // namespace REGoth
@@ -0,0 +1,33 @@
+/** \file
+ */
+
+#pragma once
+
+#include <BsPrerequisites.h>
+
+namespace ZenLoad
+{
+  struct PackedMesh;
+};
+
+namespace REGoth
+{
+  class PortalMap;
+
+  namespace Internals
+  {
+    /**
+     * Collects the sectors and portals marked on the polygons of the packed world mesh.
+     *
+     * Every distinct sector index of the sector polygons becomes a sector. Portal polygons
+     * which share vertices are joined into one portal. To find out which sectors a portal
+     * connects, the space a little in front of and a little behind it is looked at, see
+     * PortalMap::findSectorAt(). Portals with the same sector on both sides are left out.
+     *
+     * @param  worldMesh  Packed world mesh, see zCMesh::packMesh().
+     *
+     * @return The portal map, empty if the world mesh has no sectors.
+     */
+    bs::SPtr<PortalMap> extractPortalMap(const ZenLoad::PackedMesh& worldMesh);
+  }  // namespace Internals
+}  // namespace REGoth
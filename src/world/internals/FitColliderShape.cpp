@@ -0,0 +1,216 @@
+#include "FitColliderShape.hpp"
+#include <Math/BsMath.h>
+#include <Mesh/BsMesh.h>
+#include <RenderAPI/BsVertexDataDesc.h>
+#include <cstring>
+
+namespace REGoth
+{
+  static float boxError(const bs::Vector<bs::Vector3>& points, const bs::Vector3& center,
+                        const bs::Vector3& extents);
+  static float capsuleError(const bs::Vector<bs::Vector3>& points,
+                            const Internals::ColliderShape& capsule);
+  static float concavityError(const bs::Vector<bs::Vector3>& vertices,
+                              const bs::Vector<bs::UINT32>& indices);
+
+  Internals::ColliderShape Internals::fitColliderShape(const bs::HMesh& mesh)
+  {
+    ColliderShape shape;
+
+    bs::SPtr<bs::MeshData> data = mesh ? mesh->getCachedData() : nullptr;
+
+    if (!data) return shape;
+
+    bs::SPtr<bs::VertexDataDesc> vertexDesc = data->getVertexDesc();
+
+    bs::UINT32 numVertices = data->getNumVertices();
+    bs::UINT32 numIndices  = data->getNumIndices();
+    bs::UINT32 stride      = vertexDesc->getVertexStride(0);
+
+    const bs::UINT8* positions = data->getElementData(bs::VES_POSITION);
+
+    if (!positions || numVertices == 0 || numIndices < 3) return shape;
+
+    bs::Vector<bs::Vector3> vertices(numVertices);
+
+    for (bs::UINT32 v = 0; v < numVertices; v++)
+    {
+      std::memcpy(&vertices[v], positions + (size_t)v * stride, sizeof(bs::Vector3));
+    }
+
+    bs::Vector<bs::UINT32> indices(numIndices);
+
+    for (bs::UINT32 i = 0; i < numIndices; i++)
+    {
+      indices[i] = data->getIndexType() == bs::IT_32BIT ? data->getIndices32()[i]
+                                                        : (bs::UINT32)data->getIndices16()[i];
+    }
+
+    bs::Vector3 boundsMin = vertices[0];
+    bs::Vector3 boundsMax = vertices[0];
+
+    for (const bs::Vector3& v : vertices)
+    {
+      boundsMin = bs::Vector3::min(boundsMin, v);
+      boundsMax = bs::Vector3::max(boundsMax, v);
+    }
+
+    bs::Vector3 center  = (boundsMin + boundsMax) * 0.5f;
+    bs::Vector3 extents = (boundsMax - boundsMin) * 0.5f;
+    float radius        = extents.length();
+
+    if (radius > PRIMITIVE_COLLIDER_MAX_RADIUS || radius <= 0.0f) return shape;
+
+    // Vertices alone would miss large triangles cutting through a shape
+    bs::Vector<bs::Vector3> points = vertices;
+
+    for (bs::UINT32 i = 0; i + 2 < numIndices; i += 3)
+    {
+      const bs::Vector3& a = vertices[indices[i + 0]];
+      const bs::Vector3& b = vertices[indices[i + 1]];
+      const bs::Vector3& c = vertices[indices[i + 2]];
+
+      points.push_back((a + b + c) / 3.0f);
+    }
+
+    // Flat meshes, like a plate, still need some thickness to collide with
+    constexpr float MIN_EXTENT = 0.02f;
+
+    bs::Vector3 boxExtents =
+        bs::Vector3::max(extents, bs::Vector3(MIN_EXTENT, MIN_EXTENT, MIN_EXTENT));
+
+    if (boxError(points, center, boxExtents) <= PRIMITIVE_COLLIDER_MAX_ERROR * radius)
+    {
+      shape.type    = ColliderShapeType::Box;
+      shape.center  = center;
+      shape.extents = boxExtents;
+
+      return shape;
+    }
+
+    // The capsule goes along the longest axis of the mesh
+    bs::UINT32 longest = 0;
+
+    for (bs::UINT32 a = 1; a < 3; a++)
+    {
+      if (extents[a] > extents[longest]) longest = a;
+    }
+
+    ColliderShape capsule;
+    capsule.type   = ColliderShapeType::Capsule;
+    capsule.center = center;
+    capsule.axis   = bs::Vector3::ZERO;
+
+    capsule.axis[longest] = 1.0f;
+
+    capsule.radius = bs::Math::max((extents[(longest + 1) % 3] + extents[(longest + 2) % 3]) * 0.5f,
+                                   MIN_EXTENT);
+    capsule.halfHeight = bs::Math::max(extents[longest] - capsule.radius, 0.0f);
+
+    if (capsuleError(points, capsule) <= PRIMITIVE_COLLIDER_MAX_ERROR * radius)
+    {
+      return capsule;
+    }
+
+    if (numIndices / 3 <= CONVEX_COLLIDER_MAX_TRIANGLES &&
+        concavityError(vertices, indices) <= CONVEX_COLLIDER_MAX_ERROR * radius)
+    {
+      shape.type = ColliderShapeType::Convex;
+    }
+
+    return shape;
+  }
+
+  /**
+   * @return Average distance of the given points to the surface of the box.
+   */
+  static float boxError(const bs::Vector<bs::Vector3>& points, const bs::Vector3& center,
+                        const bs::Vector3& extents)
+  {
+    float sum = 0.0f;
+
+    for (const bs::Vector3& p : points)
+    {
+      bs::Vector3 d = p - center;
+
+      // Distance to the nearest face for points inside, to the box for points outside
+      bs::Vector3 outside = bs::Vector3::max(
+          bs::Vector3(std::abs(d.x), std::abs(d.y), std::abs(d.z)) - extents, bs::Vector3::ZERO);
+
+      float inside = bs::Math::min(
+          bs::Math::min(extents.x - std::abs(d.x), extents.y - std::abs(d.y)),
+          extents.z - std::abs(d.z));
+
+      sum += outside == bs::Vector3::ZERO ? inside : outside.length();
+    }
+
+    return sum / (float)points.size();
+  }
+
+  /**
+   * @return Average distance of the given points to the surface of the capsule.
+   */
+  static float capsuleError(const bs::Vector<bs::Vector3>& points,
+                            const Internals::ColliderShape& capsule)
+  {
+    float sum = 0.0f;
+
+    for (const bs::Vector3& p : points)
+    {
+      bs::Vector3 d = p - capsule.center;
+
+      float along = bs::Math::clamp(d.dot(capsule.axis), -capsule.halfHeight, capsule.halfHeight);
+
+      float toSegment = (d - capsule.axis * along).length();
+
+      sum += std::abs(toSegment - capsule.radius);
+    }
+
+    return sum / (float)points.size();
+  }
+
+  /**
+   * Convex meshes have all their vertices on one side of the plane of each of their triangles.
+   * Which side that is depends on the winding, so the closer one counts.
+   *
+   * @return Average over all triangles of how far the vertices reach to the other side.
+   */
+  static float concavityError(const bs::Vector<bs::Vector3>& vertices,
+                              const bs::Vector<bs::UINT32>& indices)
+  {
+    float sum            = 0.0f;
+    bs::UINT32 numPlanes = 0;
+
+    for (size_t i = 0; i + 2 < indices.size(); i += 3)
+    {
+      const bs::Vector3& a = vertices[indices[i + 0]];
+      const bs::Vector3& b = vertices[indices[i + 1]];
+      const bs::Vector3& c = vertices[indices[i + 2]];
+
+      bs::Vector3 normal = (b - a).cross(c - a);
+
+      // Degenerate, doesn't say anything about the shape
+      if (normal.squaredLength() < 1e-12f) continue;
+
+      normal.normalize();
+
+      float furthestFront = 0.0f;
+      float furthestBack  = 0.0f;
+
+      for (const bs::Vector3& v : vertices)
+      {
+        float distance = normal.dot(v - a);
+
+        furthestFront = bs::Math::max(furthestFront, distance);
+        furthestBack  = bs::Math::max(furthestBack, -distance);
+      }
+
+      sum += bs::Math::min(furthestFront, furthestBack);
+      numPlanes += 1;
+    }
+
+    if (numPlanes == 0) return 0.0f;
+
+    return sum / (float)numPlanes;
+  }
+}  // namespace REGoth
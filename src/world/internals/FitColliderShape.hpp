@@ -0,0 +1,79 @@
+/** \file
+ */
+
+#pragma once
+
+#include <BsPrerequisites.h>
+#include <Math/BsVector3.h>
+
+namespace REGoth
+{
+  namespace Internals
+  {
+    /**
+     * Shapes a collider of a static mesh can have, from cheapest to most expensive.
+     */
+    enum class ColliderShapeType
+    {
+      Box,
+      Capsule,
+      Convex,
+      Triangles,
+    };
+
+    /**
+     * Collider fitted to a mesh, in the mesh's local space. See fitColliderShape().
+     */
+    struct ColliderShape
+    {
+      ColliderShapeType type = ColliderShapeType::Triangles;
+
+      /** Center of the box or capsule */
+      bs::Vector3 center = bs::Vector3::ZERO;
+
+      /** Half the size of the box along each axis */
+      bs::Vector3 extents = bs::Vector3::ZERO;
+
+      /** Direction the capsule points to */
+      bs::Vector3 axis = bs::Vector3::UNIT_Y;
+      float radius     = 0.0f;
+      float halfHeight = 0.0f;
+    };
+
+    /**
+     * Meshes with a bounding sphere larger than this, in meters, always collide with their
+     * triangles. Everything a character walks on falls into that, like houses and bridges.
+     */
+    constexpr float PRIMITIVE_COLLIDER_MAX_RADIUS = 2.0f;
+
+    /**
+     * How far the surface of the mesh may lie from the surface of a box or capsule on
+     * average, relative to the radius of the mesh's bounding sphere.
+     */
+    constexpr float PRIMITIVE_COLLIDER_MAX_ERROR = 0.06f;
+
+    /**
+     * Meshes with more triangles than this are too complex to be told apart from their
+     * convex hull cheaply and keep colliding with their triangles.
+     */
+    constexpr bs::UINT32 CONVEX_COLLIDER_MAX_TRIANGLES = 512;
+
+    /**
+     * How far the mesh may dent inwards from its convex hull on average, relative to the
+     * radius of the mesh's bounding sphere.
+     */
+    constexpr float CONVEX_COLLIDER_MAX_ERROR = 0.1f;
+
+    /**
+     * Finds the cheapest collider shape which is still close enough to the given mesh.
+     *
+     * Small meshes which are close to a box or a capsule get one. Small meshes which are
+     * close to being convex collide with their convex hull. Everything else, and everything
+     * large, keeps colliding with its triangles.
+     *
+     * The mesh must have CPU-caching enabled, so its data is available. Without it, the
+     * triangles are used.
+     */
+    ColliderShape fitColliderShape(const bs::HMesh& mesh);
+  }  // namespace Internals
+}  // namespace REGoth
@@ -1,22 +1,28 @@
 #include "ImportSingleVob.hpp"
 #include <BsZenLib/ImportPath.hpp>
-#include <BsZenLib/ResourceManifest.hpp>
 #include <BsZenLib/ZenResources.hpp>
+#include <Components/BsCBoxCollider.h>
+#include <Components/BsCCapsuleCollider.h>
+#include <Components/BsCCollider.h>
 #include <Components/BsCLight.h>
 #include <Components/BsCMeshCollider.h>
 #include <Components/BsCRenderable.h>
-#include <FileSystem/BsFileSystem.h>
+#include <Math/BsMath.h>
 #include <Math/BsMatrix4.h>
 #include <Mesh/BsMesh.h>
 #include <Physics/BsPhysicsMesh.h>
 #include <Resources/BsResources.h>
 #include <Scene/BsSceneObject.h>
+#include <components/AmbientSound.hpp>
 #include <components/Freepoint.hpp>
 #include <components/GameWorld.hpp>
-#include <components/Item.hpp>
+#include <components/LevelChangeTrigger.hpp>
 #include <components/Visual.hpp>
 #include <components/VisualStaticMesh.hpp>
 #include <log/logging.hpp>
+#include <original-content/OriginalGameResources.hpp>
+#include <original-content/PhysicsMeshCache.hpp>
+#include <world/PhysicsLayers.hpp>
 #include <zenload/zTypes.h>
 
 namespace
@@ -33,80 +39,109 @@ namespace
 namespace REGoth
 {
   static bs::HSceneObject import_zCVob(const ZenLoad::zCVobData& vob, bs::HSceneObject bsfParent,
-                                       HGameWorld gameWorld);
+                                       HGameWorld gameWorld,
+                                       const VobResources& resources);
   static bs::HSceneObject import_zCVobLight(const ZenLoad::zCVobData& vob,
-                                            bs::HSceneObject bsfParent, HGameWorld gameWorld);
+                                            bs::HSceneObject bsfParent, HGameWorld gameWorld,
+                                            const VobResources& resources);
   static bs::HSceneObject import_zCVobStartpoint(const ZenLoad::zCVobData& vob,
-                                                 bs::HSceneObject bsfParent, HGameWorld gameWorld);
+                                                 bs::HSceneObject bsfParent, HGameWorld gameWorld,
+                                                 const VobResources& resources);
   static bs::HSceneObject import_zCVobSpot(const ZenLoad::zCVobData& vob, bs::HSceneObject bsfParent,
-                                           HGameWorld gameWorld);
+                                           HGameWorld gameWorld,
+                                           const VobResources& resources);
   static bs::HSceneObject import_oCItem(const ZenLoad::zCVobData& vob, bs::HSceneObject bsfParent,
-                                        HGameWorld gameWorld);
+                                        HGameWorld gameWorld,
+                                        const VobResources& resources);
   static bs::HSceneObject import_zCVobSound(const ZenLoad::zCVobData& vob,
-                                            bs::HSceneObject bsfParent, HGameWorld gameWorld);
+                                            bs::HSceneObject bsfParent, HGameWorld gameWorld,
+                                            const VobResources& resources);
   static bs::HSceneObject import_zCVobAnimate(const ZenLoad::zCVobData& vob,
-                                              bs::HSceneObject bsfParent, HGameWorld gameWorld);
+                                              bs::HSceneObject bsfParent, HGameWorld gameWorld,
+                                              const VobResources& resources);
+  static bs::HSceneObject import_oCTriggerChangeLevel(const ZenLoad::zCVobData& vob,
+                                                      bs::HSceneObject bsfParent,
+                                                      HGameWorld gameWorld,
+                                                      const VobResources& resources);
   static bs::HSceneObject import_oCMobInter(const ZenLoad::zCVobData& vob,
-                                            bs::HSceneObject bsfParent, HGameWorld gameWorld);
+                                            bs::HSceneObject bsfParent, HGameWorld gameWorld,
+                                            const VobResources& resources);
   static bs::HSceneObject import_oCMobContainer(const ZenLoad::zCVobData& vob,
-                                                bs::HSceneObject bsfParent, HGameWorld gameWorld);
+                                                bs::HSceneObject bsfParent, HGameWorld gameWorld,
+                                                const VobResources& resources);
   static bs::HSceneObject import_oCMobBed(const ZenLoad::zCVobData& vob, bs::HSceneObject bsfParent,
-                                          HGameWorld gameWorld);
+                                          HGameWorld gameWorld,
+                                          const VobResources& resources);
   static bs::HSceneObject import_oCMobDoor(const ZenLoad::zCVobData& vob, bs::HSceneObject bsfParent,
-                                           HGameWorld gameWorld);
+                                           HGameWorld gameWorld,
+                                           const VobResources& resources);
   static void addVisualTo(bs::HSceneObject sceneObject, const bs::String& visualName);
-  static void addCollisionTo(bs::HSceneObject sceneObject);
+  static void addCollisionTo(bs::HSceneObject sceneObject, const VobResources& resources);
+
+  bool Internals::isStaticVob(const ZenLoad::zCVobData& vob)
+  {
+    if (vob.objectClass != "zCVob") return false;
+    if (!vob.childVobs.empty()) return false;
+    if (vob.visual.empty()) return false;
+
+    return Visual::guessVisualKind(vob.visual.c_str()) == Visual::VisualKind::StaticMesh;
+  }
 
   bs::HSceneObject Internals::importSingleVob(const ZenLoad::zCVobData& vob,
-                                              bs::HSceneObject bsfParent, HGameWorld gameWorld)
+                                              bs::HSceneObject bsfParent, HGameWorld gameWorld,
+                                              const VobResources& resources)
   {
     if (vob.objectClass == "zCVob")
     {
-      return import_zCVob(vob, bsfParent, gameWorld);
+      return import_zCVob(vob, bsfParent, gameWorld, resources);
     }
     else if (vob.objectClass == "zCVobLight:zCVob")
     {
-      return import_zCVobLight(vob, bsfParent, gameWorld);
+      return import_zCVobLight(vob, bsfParent, gameWorld, resources);
     }
     else if (vob.objectClass == "zCVobStartpoint:zCVob")
     {
-      return import_zCVobStartpoint(vob, bsfParent, gameWorld);
+      return import_zCVobStartpoint(vob, bsfParent, gameWorld, resources);
     }
     else if (vob.objectClass == "zCVobSpot:zCVob")
     {
-      return import_zCVobSpot(vob, bsfParent, gameWorld);
+      return import_zCVobSpot(vob, bsfParent, gameWorld, resources);
     }
     else if (vob.objectClass == "zCVobSound:zCVob")
     {
-      return import_zCVobSound(vob, bsfParent, gameWorld);
+      return import_zCVobSound(vob, bsfParent, gameWorld, resources);
     }
     else if (vob.objectClass == "oCItem:zCVob")
     {
-      return import_oCItem(vob, bsfParent, gameWorld);
+      return import_oCItem(vob, bsfParent, gameWorld, resources);
     }
     else if (vob.objectClass == "zCVobAnimate:zCVob")
     {
-      return import_zCVobAnimate(vob, bsfParent, gameWorld);
+      return import_zCVobAnimate(vob, bsfParent, gameWorld, resources);
+    }
+    else if (vob.objectClass == "oCTriggerChangeLevel:zCTrigger:zCVob")
+    {
+      return import_oCTriggerChangeLevel(vob, bsfParent, gameWorld, resources);
     }
     // else if (vob.objectClass == "oCMobInter:oCMOB:zCVob")
     // {
-    //   return import_oCMobInter(vob, bsfParent, gameWorld);
+    //   return import_oCMobInter(vob, bsfParent, gameWorld, resources);
     // }
     // else if (vob.objectClass == "oCMobContainer:oCMobInter:oCMOB:zCVob")
     // {
-    //   return import_oCMobContainer(vob, bsfParent, gameWorld);
+    //   return import_oCMobContainer(vob, bsfParent, gameWorld, resources);
     // }
     // else if (vob.objectClass == "oCMobBed:oCMobInter:oCMOB:zCVob")
     // {
-    //   return import_oCMobBed(vob, bsfParent, gameWorld);
+    //   return import_oCMobBed(vob, bsfParent, gameWorld, resources);
     // }
     // else if (vob.objectClass == "oCMobDoor:oCMobInter:oCMOB:zCVob")
     // {
-    //   return import_oCMobDoor(vob, bsfParent, gameWorld);
+    //   return import_oCMobDoor(vob, bsfParent, gameWorld, resources);
     // }
     else
     {
-      REGOTH_LOG(Warning, Uncategorized, "[ImportSingleVob] Unsupported vob class: {0}",
+      REGOTH_LOG(Warning, World, "[ImportSingleVob] Unsupported vob class: {0}",
                  bs::String(vob.objectClass.c_str()));
 
       return {};
@@ -119,7 +154,8 @@ namespace REGoth
    * position, rotation and the visual here as these are used by all vobs.
    */
   static bs::HSceneObject import_zCVob(const ZenLoad::zCVobData& vob, bs::HSceneObject bsfParent,
-                                       HGameWorld gameWorld)
+                                       HGameWorld gameWorld,
+                                       const VobResources& resources)
   {
     bs::HSceneObject so = bs::SceneObject::create(vob.vobName.c_str());
 
@@ -143,47 +179,64 @@ namespace REGoth
     // cdDyn seems to be the general "this is supposed to collide with stuff"-flag.
     if (vob.cdDyn)
     {
-      addCollisionTo(so);
+      addCollisionTo(so, resources);
     }
 
     return so;
   }
 
+  /**
+   * Lights smaller than this are not worth a real-time light, in meters.
+   */
+  static constexpr float MIN_LIGHT_RANGE = 2.0f;
+
   /**
    * Lights can be pointlights or spotlights, altough spotlights are not
    * used within the original game as it seems.
+   *
+   * Only dynamic lights get a real-time light, static ones are already part of the lighting
+   * of the world mesh. The light goes onto a scene object of its own, so LightBudget can turn
+   * it on and off without touching the vob.
    */
   static bs::HSceneObject import_zCVobLight(const ZenLoad::zCVobData& vob,
-                                            bs::HSceneObject bsfParent, HGameWorld gameWorld)
+                                            bs::HSceneObject bsfParent, HGameWorld gameWorld,
+                                            const VobResources& resources)
   {
-    bs::HSceneObject so = import_zCVob(vob, bsfParent, gameWorld);
+    bs::HSceneObject so = import_zCVob(vob, bsfParent, gameWorld, resources);
 
-    // FIXME: Put lights back in
-    return so;
-#if 0
-    bs::HLight light = so->addComponent<bs::CLight>();
+    float range = vob.zCVobLight.range * 0.01f;
+
+    if (vob.zCVobLight.lightStatic || range < MIN_LIGHT_RANGE)
+    {
+      return so;
+    }
+
+    bs::HSceneObject lightSO = bs::SceneObject::create(so->getName() + ".light");
+    lightSO->setParent(so, false);
+
+    bs::HLight light = lightSO->addComponent<bs::CLight>();
 
     auto lightColor = bs::Color::fromRGBA(vob.zCVobLight.color);
 
     light->setType(bs::LightType::Radial);
     light->setUseAutoAttenuation(false);
-    light->setAttenuationRadius(vob.zCVobLight.range);
+    light->setAttenuationRadius(range);
     light->setColor(lightColor);
 
     return so;
-#endif
   }
 
   /**
    * The startpoint of the player in the current world. There should be only one.
    */
   static bs::HSceneObject import_zCVobStartpoint(const ZenLoad::zCVobData& vob,
-                                                 bs::HSceneObject bsfParent, HGameWorld gameWorld)
+                                                 bs::HSceneObject bsfParent, HGameWorld gameWorld,
+                                                 const VobResources& resources)
   {
-    bs::HSceneObject so = import_zCVob(vob, bsfParent, gameWorld);
+    bs::HSceneObject so = import_zCVob(vob, bsfParent, gameWorld, resources);
 
     // Startpoint is found by name of the scene object
-    REGOTH_LOG(Info, Uncategorized, "[ImportSingleVob] Found startpoint: {0}", so->getName());
+    REGOTH_LOG(Info, World, "[ImportSingleVob] Found startpoint: {0}", so->getName());
 
     // A startpoint has an arbitrary names, which makes it hard to find it at a later point.
     // Thus, rename it to a known constant. As there should always only be one startpoint in
@@ -197,9 +250,10 @@ namespace REGoth
    * Spots like free-points.
    */
   static bs::HSceneObject import_zCVobSpot(const ZenLoad::zCVobData& vob, bs::HSceneObject bsfParent,
-                                           HGameWorld gameWorld)
+                                           HGameWorld gameWorld,
+                                           const VobResources& resources)
   {
-    bs::HSceneObject so = import_zCVob(vob, bsfParent, gameWorld);
+    bs::HSceneObject so = import_zCVob(vob, bsfParent, gameWorld, resources);
 
     so->addComponent<Freepoint>();
 
@@ -207,46 +261,106 @@ namespace REGoth
   }
 
   static bs::HSceneObject import_oCItem(const ZenLoad::zCVobData& vob, bs::HSceneObject bsfParent,
-                                        HGameWorld gameWorld)
+                                        HGameWorld gameWorld,
+                                        const VobResources& resources)
   {
     if (vob.oCItem.instanceName.empty())
     {
-      REGOTH_LOG(Warning, Uncategorized, "[ImportSingleVob] Item with empty script instance: {0}",
+      REGOTH_LOG(Warning, World, "[ImportSingleVob] Item with empty script instance: {0}",
                  bs::String(vob.vobName.c_str()));
       return {};
     }
 
-    bs::HSceneObject so = import_zCVob(vob, bsfParent, gameWorld);
+    // Only becomes a full item once the hero comes close, see GroundItems
+    bs::Matrix4 worldMatrix = convertMatrix(vob.worldMatrix);
+    bs::Quaternion rotation;
+    rotation.fromRotationMatrix(worldMatrix.get3x3());
 
-    so->addComponent<Item>(vob.oCItem.instanceName.c_str(), gameWorld);
+    bs::Vector3 positionCM    = bs::Vector3(vob.position.x, vob.position.y, vob.position.z);
+    float centimetersToMeters = 0.01f;
 
-    return so;
+    gameWorld->groundItems().addDormantItem(vob.oCItem.instanceName.c_str(),
+                                            positionCM * centimetersToMeters, rotation);
+
+    // Nothing to attach child vobs to, but items don't have any
+    return {};
   }
 
   static bs::HSceneObject import_zCVobSound(const ZenLoad::zCVobData& vob,
-                                            bs::HSceneObject bsfParent, HGameWorld gameWorld)
+                                            bs::HSceneObject bsfParent, HGameWorld gameWorld,
+                                            const VobResources& resources)
   {
-    bs::HSceneObject so = import_zCVob(vob, bsfParent, gameWorld);
+    bs::HSceneObject so = import_zCVob(vob, bsfParent, gameWorld, resources);
 
-    // TODO: Implement
+    bs::String soundFile = vob.zCVobSound.sndName.c_str();
+    bs::StringUtil::toUpperCase(soundFile);
+
+    if (soundFile.empty()) return so;
+
+    // Sounds started by triggers have nothing to start them yet
+    if (!vob.zCVobSound.sndStartOn) return so;
+
+    // FIXME: Names without extension are instances of C_SFX, whose file is set in SFX.DAT.
+    //        Until that one is loaded, assume the file is named like the instance.
+    if (!bs::StringUtil::endsWith(soundFile, ".WAV"))
+    {
+      soundFile += ".WAV";
+    }
+
+    float centimetersToMeters = 0.01f;
+    float radius              = vob.zCVobSound.sndRadius * centimetersToMeters;
+    float volume              = bs::Math::clamp01(vob.zCVobSound.sndVolume / 100.0f);
+
+    auto mode = (AmbientSound::Mode)bs::Math::clamp((int)vob.zCVobSound.sndMode, 0, 2);
+
+    HAmbientSound sound = so->addComponent<AmbientSound>(soundFile, radius, volume, mode);
+    sound->setRandomDelay(vob.zCVobSound.sndRandDelay, vob.zCVobSound.sndRandDelayVar);
 
     return so;
   }
 
   static bs::HSceneObject import_zCVobAnimate(const ZenLoad::zCVobData& vob,
-                                              bs::HSceneObject bsfParent, HGameWorld gameWorld)
+                                              bs::HSceneObject bsfParent, HGameWorld gameWorld,
+                                              const VobResources& resources)
   {
-    bs::HSceneObject so = import_zCVob(vob, bsfParent, gameWorld);
+    bs::HSceneObject so = import_zCVob(vob, bsfParent, gameWorld, resources);
 
     // TODO: Implement
 
     return so;
   }
 
+  static bs::HSceneObject import_oCTriggerChangeLevel(const ZenLoad::zCVobData& vob,
+                                                      bs::HSceneObject bsfParent,
+                                                      HGameWorld gameWorld,
+                                                      const VobResources& resources)
+  {
+    bs::HSceneObject so = import_zCVob(vob, bsfParent, gameWorld, resources);
+
+    // Given with the directory inside the VDFS, e.g. `NEWWORLD\NEWWORLD.ZEN`
+    bs::String zenFile = vob.oCTriggerChangeLevel.levelName.c_str();
+    size_t separator   = zenFile.find_last_of("\\/");
+
+    if (separator != bs::String::npos)
+    {
+      zenFile = zenFile.substr(separator + 1);
+    }
+
+    bs::StringUtil::toUpperCase(zenFile);
+
+    if (zenFile.empty()) return so;
+
+    so->addComponent<LevelChangeTrigger>(zenFile,
+                                         vob.oCTriggerChangeLevel.startVobName.c_str());
+
+    return so;
+  }
+
   static bs::HSceneObject import_oCMobInter(const ZenLoad::zCVobData& vob,
-                                            bs::HSceneObject bsfParent, HGameWorld gameWorld)
+                                            bs::HSceneObject bsfParent, HGameWorld gameWorld,
+                                            const VobResources& resources)
   {
-    bs::HSceneObject so = import_zCVob(vob, bsfParent, gameWorld);
+    bs::HSceneObject so = import_zCVob(vob, bsfParent, gameWorld, resources);
 
     // TODO: Implement
 
@@ -254,9 +368,10 @@ namespace REGoth
   }
 
   static bs::HSceneObject import_oCMobContainer(const ZenLoad::zCVobData& vob,
-                                                bs::HSceneObject bsfParent, HGameWorld gameWorld)
+                                                bs::HSceneObject bsfParent, HGameWorld gameWorld,
+                                                const VobResources& resources)
   {
-    bs::HSceneObject so = import_zCVob(vob, bsfParent, gameWorld);
+    bs::HSceneObject so = import_zCVob(vob, bsfParent, gameWorld, resources);
 
     // TODO: Implement
 
@@ -264,9 +379,10 @@ namespace REGoth
   }
 
   static bs::HSceneObject import_oCMobBed(const ZenLoad::zCVobData& vob, bs::HSceneObject bsfParent,
-                                          HGameWorld gameWorld)
+                                          HGameWorld gameWorld,
+                                          const VobResources& resources)
   {
-    bs::HSceneObject so = import_zCVob(vob, bsfParent, gameWorld);
+    bs::HSceneObject so = import_zCVob(vob, bsfParent, gameWorld, resources);
 
     // TODO: Implement
 
@@ -274,9 +390,10 @@ namespace REGoth
   }
 
   static bs::HSceneObject import_oCMobDoor(const ZenLoad::zCVobData& vob, bs::HSceneObject bsfParent,
-                                           HGameWorld gameWorld)
+                                           HGameWorld gameWorld,
+                                           const VobResources& resources)
   {
-    bs::HSceneObject so = import_zCVob(vob, bsfParent, gameWorld);
+    bs::HSceneObject so = import_zCVob(vob, bsfParent, gameWorld, resources);
 
     // TODO: Implement
 
@@ -293,16 +410,35 @@ namespace REGoth
 
     if (!hasAdded)
     {
-      REGOTH_LOG(Warning, Uncategorized, "[ImportSingleVob] Unsupported visual: {0}", visualName);
+      REGOTH_LOG(Warning, World, "[ImportSingleVob] Unsupported visual: {0}", visualName);
+    }
+  }
+
+  /**
+   * @return Name the physics mesh for the given collider shape of the given mesh is cached
+   *         under. Empty if the shape doesn't need one.
+   */
+  static bs::String physicsMeshNameOf(const bs::HMesh& mesh, const Internals::ColliderShape& shape)
+  {
+    switch (shape.type)
+    {
+      case Internals::ColliderShapeType::Triangles:
+        return mesh->getName();
+
+      case Internals::ColliderShapeType::Convex:
+        return mesh->getName() + ".convex";
+
+      default:
+        return {};
     }
   }
 
   /**
-   * Adds a triangle physics mesh to the given scene object. Only works if the
-   * scene object has a renderable with a mesh set. The mesh must also have
-   * CPU-caching enabled, so we get access to the mesh data.
+   * Adds a collider to the given scene object, shaped by fitColliderShape(). Only works if
+   * the scene object has a renderable with a mesh set. The mesh must also have CPU-caching
+   * enabled, so we get access to the mesh data.
    */
-  static void addCollisionTo(bs::HSceneObject sceneObject)
+  static void addCollisionTo(bs::HSceneObject sceneObject, const VobResources& resources)
   {
     bs::HRenderable renderable = sceneObject->getComponent<bs::CRenderable>();
 
@@ -312,32 +448,183 @@ namespace REGoth
 
     if (!mesh) return;
 
-    auto meshData = mesh->getCachedData();
+    // Usually prepared by prepareVobResources() already
+    auto it = resources.colliderShapes.find(mesh->getName());
 
-    if (!meshData) return;
+    Internals::ColliderShape shape = it != resources.colliderShapes.end()
+                                         ? it->second
+                                         : Internals::fitColliderShape(mesh);
 
-    bs::Path physicsMeshPath = BsZenLib::GothicPathToCachedStaticMesh(mesh->getName() + ".physics");
+    switch (shape.type)
+    {
+      case Internals::ColliderShapeType::Box:
+      {
+        bs::HBoxCollider collider = sceneObject->addComponent<bs::CBoxCollider>();
+        collider->setLayer(PhysicsLayer::DECORATION);
+        collider->setCenter(shape.center);
+        collider->setExtents(shape.extents);
+      }
+      break;
+
+      case Internals::ColliderShapeType::Capsule:
+      {
+        bs::HCapsuleCollider collider = sceneObject->addComponent<bs::CCapsuleCollider>();
+        collider->setLayer(PhysicsLayer::DECORATION);
+        collider->setCenter(shape.center);
+        collider->setNormal(shape.axis);
+        collider->setRadius(shape.radius);
+        collider->setHalfHeight(shape.halfHeight);
+      }
+      break;
+
+      case Internals::ColliderShapeType::Convex:
+      case Internals::ColliderShapeType::Triangles:
+      {
+        bs::PhysicsMeshType type = shape.type == Internals::ColliderShapeType::Convex
+                                       ? bs::PhysicsMeshType::Convex
+                                       : bs::PhysicsMeshType::Triangle;
+
+        bs::HPhysicsMesh physicsMesh =
+            gPhysicsMeshCache().loadOrCreate(physicsMeshNameOf(mesh, shape), mesh, type);
+
+        if (!physicsMesh) return;
+
+        bs::HMeshCollider collider = sceneObject->addComponent<bs::CMeshCollider>();
+        collider->setMesh(physicsMesh);
+
+        // Only meshes small enough collide with their convex hull
+        collider->setLayer(shape.type == Internals::ColliderShapeType::Convex
+                               ? PhysicsLayer::DECORATION
+                               : PhysicsLayer::LEVEL_GEOMETRY);
+      }
+      break;
+    }
+  }
 
-    bs::HPhysicsMesh physicsMesh;
-    if (bs::FileSystem::exists(physicsMeshPath))
+  void Internals::prepareVobResources(const bs::FrameVector<const ZenLoad::zCVobData*>& vobs,
+                                      VobResources& resources)
+  {
+    // Only static meshes can be prepared, see Visual::addToSceneObject(). Whether any vob
+    // using the visual collides decides whether the physics mesh is needed.
+    bs::FrameUnorderedMap<bs::String, bool> staticMeshVisuals;
+
+    for (const ZenLoad::zCVobData* vob : vobs)
     {
-      physicsMesh = bs::gResources().load<bs::PhysicsMesh>(physicsMeshPath);
+      if (vob->visual.empty()) continue;
+
+      bs::String visual = vob->visual.c_str();
+
+      if (Visual::guessVisualKind(visual) != Visual::VisualKind::StaticMesh) continue;
+
+      staticMeshVisuals[visual] = staticMeshVisuals[visual] || vob->cdDyn;
     }
-    else
+
+    resources.numUniqueVisuals = (bs::UINT32)staticMeshVisuals.size();
+
+    // First get all cached meshes loading in the background, then import the others meanwhile
+    bs::FrameVector<std::pair<BsZenLib::Res::HMeshWithMaterials, bool>> meshes;
+    meshes.reserve(staticMeshVisuals.size());
+
+    for (const auto& v : staticMeshVisuals)
     {
-      REGOTH_LOG(Info, Uncategorized, "[ImportSingleVob] Caching physics mesh for {0}",
-                 mesh->getName());
+      if (!BsZenLib::HasCachedStaticMesh(v.first)) continue;
+
+      meshes.emplace_back(bs::gResources().loadAsync<BsZenLib::Res::MeshWithMaterials>(
+                              BsZenLib::GothicPathToCachedStaticMesh(v.first)),
+                          v.second);
+    }
 
-      physicsMesh = bs::PhysicsMesh::create(meshData, bs::PhysicsMeshType::Triangle);
+    for (const auto& v : staticMeshVisuals)
+    {
+      if (BsZenLib::HasCachedStaticMesh(v.first)) continue;
 
-      BsZenLib::AddToResourceManifest(physicsMesh, physicsMeshPath);
-      bs::gResources().save(physicsMesh, physicsMeshPath, true);
+      meshes.emplace_back(gOriginalGameResources().staticMesh(v.first), v.second);
     }
 
-    if (!physicsMesh) return;
+    // Physics meshes can only be requested once the mesh is there
+    for (auto& m : meshes)
+    {
+      BsZenLib::Res::HMeshWithMaterials& mesh = m.first;
+      bool needsPhysicsMesh                   = m.second;
+
+      mesh.blockUntilLoaded();
+
+      if (!mesh.isLoaded()) continue;
+
+      resources.meshes.push_back(mesh);
+
+      if (!needsPhysicsMesh) continue;
+
+      bs::HMesh actualMesh = mesh->getMesh();
+
+      if (!actualMesh) continue;
+
+      actualMesh.blockUntilLoaded();
+
+      Internals::ColliderShape shape = Internals::fitColliderShape(actualMesh);
+
+      resources.colliderShapes[actualMesh->getName()] = shape;
+
+      bs::String physicsMeshName = physicsMeshNameOf(actualMesh, shape);
 
-    bs::HMeshCollider collider = sceneObject->addComponent<bs::CMeshCollider>();
-    collider->setMesh(physicsMesh);
+      if (physicsMeshName.empty()) continue;
+
+      gPhysicsMeshCache().request(physicsMeshName, actualMesh,
+                                  shape.type == Internals::ColliderShapeType::Convex
+                                      ? bs::PhysicsMeshType::Convex
+                                      : bs::PhysicsMeshType::Triangle);
+
+      resources.numPhysicsMeshes += 1;
+    }
+
+    gPhysicsMeshCache().finishRequests();
+  }
+
+  void Internals::removeCachedStaticMesh(const bs::String& visual)
+  {
+    // The physics meshes are named after the mesh, which is only known from the old one
+    if (BsZenLib::HasCachedStaticMesh(visual))
+    {
+      BsZenLib::Res::HMeshWithMaterials cached = gOriginalGameResources().staticMesh(visual);
+
+      if (cached && cached->getMesh())
+      {
+        bs::HMesh mesh = cached->getMesh();
+
+        for (ColliderShapeType type : {ColliderShapeType::Convex, ColliderShapeType::Triangles})
+        {
+          ColliderShape shape;
+          shape.type = type;
+
+          gPhysicsMeshCache().remove(physicsMeshNameOf(mesh, shape));
+        }
+      }
+    }
+
+    gOriginalGameResources().removeCachedStaticMesh(visual);
+  }
+
+  void Internals::reloadStaticMesh(bs::HSceneObject vob)
+  {
+    HVisualStaticMesh visual = vob->getComponent<VisualStaticMesh>();
+
+    if (!visual || visual->isMerged() || visual->meshFileNames().empty()) return;
+
+    bool hasCollision = false;
+
+    // Might be shaped differently now
+    while (bs::HCollider collider = vob->getComponent<bs::CCollider>())
+    {
+      collider->destroy(true);
+      hasCollision = true;
+    }
+
+    visual->setMesh(visual->meshFileNames().front());
+
+    if (hasCollision)
+    {
+      addCollisionTo(vob, VobResources{});
+    }
   }
 
 }  // namespace REGoth
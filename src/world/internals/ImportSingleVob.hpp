@@ -3,6 +3,8 @@
 
 #pragma once
 
+#include "FitColliderShape.hpp"
+#include <Allocators/BsFrameAlloc.h>
 #include <BsPrerequisites.h>
 
 namespace ZenLoad
@@ -10,6 +12,15 @@ namespace ZenLoad
   struct zCVobData;
 };
 
+namespace BsZenLib
+{
+  namespace Res
+  {
+    class MeshWithMaterials;
+    typedef bs::ResourceHandle<MeshWithMaterials> HMeshWithMaterials;
+  }  // namespace Res
+}  // namespace BsZenLib
+
 namespace REGoth
 {
   class GameWorld;
@@ -17,16 +28,81 @@ namespace REGoth
 
   namespace Internals
   {
+    /**
+     * Resources needed by the vobs of a world, see prepareVobResources().
+     */
+    struct VobResources
+    {
+      /**
+       * Static meshes of all visuals, so they stay loaded until the vobs using them have
+       * been created.
+       */
+      bs::Vector<BsZenLib::Res::HMeshWithMaterials> meshes;
+
+      /** Collider shapes by the name of the mesh they were fitted to, see fitColliderShape() */
+      bs::UnorderedMap<bs::String, ColliderShape> colliderShapes;
+
+      /** Number of different physics meshes needed, see gPhysicsMeshCache() */
+      bs::UINT32 numPhysicsMeshes = 0;
+
+      /** Number of different visuals found */
+      bs::UINT32 numUniqueVisuals = 0;
+    };
+
+    /**
+     * Loads the meshes and physics meshes the given vobs need, every one of them only once.
+     * Physics meshes are only needed for meshes which can't collide as a box or capsule.
+     *
+     * Resources which have been cached before are loaded asynchronously through
+     * bs::Resources, so they are read and deserialized in parallel. Meshes which are not
+     * cached yet are imported and cached right away, since importing has to happen on the
+     * main thread. Missing physics meshes are cooked in parallel by the physics mesh cache,
+     * see PhysicsMeshCache::finishRequests().
+     *
+     * importSingleVob() can then create the vobs without waiting for the disk.
+     *
+     * The lists needed only while preparing are kept in bs:f's frame allocator, see
+     * constructFromZEN().
+     *
+     * @param  vobs       All vobs of the world.
+     * @param  resources  Where to put the loaded resources.
+     */
+    void prepareVobResources(const bs::FrameVector<const ZenLoad::zCVobData*>& vobs,
+                             VobResources& resources);
+
+    /**
+     * @return Whether the given vob is nothing but a static mesh, which never changes and
+     *         which no script needs to know about. See StaticParts.
+     */
+    bool isStaticVob(const ZenLoad::zCVobData& vob);
+
     /**
      * Imports a single vob and creates a bs:f object as similar as possible.
      *
      * @param  vob        Information from importing the zen-file.
      * @param  bsfParent  Parent game object.
      * @param  gameWorld  World to create the object in.
+     * @param  resources  Resources prepared by prepareVobResources(). Anything missing in
+     *                    there is loaded when needed.
      *
      * @return Scene object modeled after the vob
      */
     bs::HSceneObject importSingleVob(const ZenLoad::zCVobData& vob, bs::HSceneObject bsfParent,
-                                     HGameWorld gameWorld);
+                                     HGameWorld gameWorld, const VobResources& resources);
+
+    /**
+     * Removes the given static mesh from the cache, together with everything made from it
+     * for vobs, like its physics meshes. Meant for when its original files changed. Vobs
+     * already showing it need reloadStaticMesh() afterwards.
+     *
+     * @param  visual  Original file of the static mesh, e.g. `STONE.3DS`.
+     */
+    void removeCachedStaticMesh(const bs::String& visual);
+
+    /**
+     * Sets up the static mesh of a vob imported before again and, if it had one, its
+     * collider. See removeCachedStaticMesh().
+     */
+    void reloadStaticMesh(bs::HSceneObject vob);
   }  // namespace Worlds
 }  // namespace REGoth
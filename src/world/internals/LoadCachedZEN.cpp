@@ -5,6 +5,7 @@
 #include <Resources/BsResources.h>
 #include <Scene/BsPrefab.h>
 #include <exception/Throw.hpp>
+#include <world/WorldCacheInfo.hpp>
 
 namespace REGoth
 {
@@ -24,23 +25,48 @@ namespace REGoth
       return prefab->instantiate();
     }
 
-    void saveCacheForZEN(bs::HSceneObject root, const bs::String& zenFile)
+    void saveCacheForZEN(bs::HSceneObject root, const bs::String& zenFile,
+                         Internals::StaticGeometry staticGeometry)
     {
+      if (staticGeometry == Internals::StaticGeometry::Merge)
+      {
+        Internals::mergeStaticGeometry(root, zenFile);
+      }
+
       bs::HPrefab cached = bs::Prefab::create(root);
 
       enum
       {
-        Overwrite = true,
+        Overwrite    = true,
         KeepExisting = false,
       };
 
+      // Decompressing is quicker than reading the whole world from disk, see GameWorld::save()
+      enum
+      {
+        Compress = true,
+      };
+
       bs::Path path = BsZenLib::GothicPathToCachedWorld(zenFile);
-      bs::gResources().save(cached, path, Overwrite);
+      bs::gResources().save(cached, path, Overwrite, Compress);
+
+      WorldCacheInfo::describe(zenFile, false, root)->save(WorldCacheInfo::pathFor(path));
     }
 
     bool hasCachedZEN(const bs::String& zenFile)
     {
-      return bs::FileSystem::exists(BsZenLib::GothicPathToCachedWorld(zenFile));
+      bs::Path path = BsZenLib::GothicPathToCachedWorld(zenFile);
+
+      if (!bs::FileSystem::exists(path)) return false;
+
+      bs::SPtr<WorldCacheInfo> info = WorldCacheInfo::load(WorldCacheInfo::pathFor(path));
+
+      if (!info) return false;
+
+      bs::Vector<bs::String> changedVisuals;
+
+      return info->compareWithGameFiles(zenFile, false, changedVisuals) ==
+             WorldCacheInfo::Staleness::UpToDate;
     }
   }  // namespace World
 }  // namespace REGoth
@@ -1,5 +1,6 @@
 #pragma once
 #include <BsPrerequisites.h>
+#include <world/internals/MergeStaticGeometry.hpp>
 
 namespace REGoth
 {
@@ -33,14 +34,21 @@ namespace REGoth
      * so with init-scripts already ran but you don't have to. Just be
      * careful of the scene looks that you are saving.
      *
-     * @param  root     Root of the ZEN to cache.
-     * @param  zenFile  Name of the ZEN to save for, e.g. `NEWWORLD.ZEN`.
-     *                  This should be a valid ZEN-file name!
+     * Optionally, the static geometry of the ZEN can be merged first, so the
+     * cache holds far fewer scene objects, see Internals::mergeStaticGeometry().
+     * That changes the given scene as well.
+     *
+     * @param  root            Root of the ZEN to cache.
+     * @param  zenFile         Name of the ZEN to save for, e.g. `NEWWORLD.ZEN`.
+     *                         This should be a valid ZEN-file name!
+     * @param  staticGeometry  Whether to merge the static geometry first.
      */
-    void saveCacheForZEN(bs::HSceneObject root, const bs::String& zenFile);
+    void saveCacheForZEN(
+        bs::HSceneObject root, const bs::String& zenFile,
+        Internals::StaticGeometry staticGeometry = Internals::StaticGeometry::Keep);
 
     /**
-     * @return Whether a cache exists for the given zenFile.
+     * @return Whether an up to date cache exists for the given zenFile, see WorldCacheInfo.
      *
      * @See saveCacheForZEN() to create a cache.
      * @See loadCachedZEN() to load it.
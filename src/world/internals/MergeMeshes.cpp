@@ -0,0 +1,194 @@
+#include "MergeMeshes.hpp"
+#include <Mesh/BsMesh.h>
+#include <RenderAPI/BsVertexDataDesc.h>
+#include <cstring>
+
+namespace REGoth
+{
+  /**
+   * Where the elements which need transforming are inside a vertex. Those a mesh doesn't
+   * have are NO_ELEMENT.
+   */
+  struct VertexLayout
+  {
+    static constexpr bs::UINT32 NO_ELEMENT = (bs::UINT32)-1;
+
+    bs::UINT32 stride   = 0;
+    bs::UINT32 position = NO_ELEMENT;
+    bs::UINT32 normal   = NO_ELEMENT;
+    bs::UINT32 tangent  = NO_ELEMENT;
+  };
+
+  constexpr bs::UINT32 VertexLayout::NO_ELEMENT;
+
+  static bool findVertexLayout(const bs::MeshData& data, VertexLayout& layout);
+  static void transformVertex(bs::UINT8* vertex, const VertexLayout& layout,
+                              const bs::Matrix4& transform);
+  static bs::UINT32 indexAt(const bs::MeshData& data, bs::UINT32 i);
+
+  bs::HMesh Internals::mergeMeshes(const bs::Vector<MeshMergePart>& parts,
+                                   bs::UINT32 numTargetSubMeshes)
+  {
+    if (parts.empty()) return {};
+
+    bs::SPtr<bs::MeshData> firstData = parts.front().mesh->getCachedData();
+
+    if (!firstData) return {};
+
+    bs::SPtr<bs::VertexDataDesc> vertexDesc = firstData->getVertexDesc();
+
+    VertexLayout layout;
+
+    if (!findVertexLayout(*firstData, layout)) return {};
+
+    // Count first, so the mesh data can be created at the right size
+    bs::UINT32 numVertices = 0;
+    bs::UINT32 numIndices  = 0;
+
+    for (const MeshMergePart& part : parts)
+    {
+      bs::SPtr<bs::MeshData> data = part.mesh->getCachedData();
+
+      if (!data) return {};
+      if (part.targetSubMesh >= numTargetSubMeshes) return {};
+      if (part.subMesh >= part.mesh->getProperties().getNumSubMeshes()) return {};
+
+      VertexLayout partLayout;
+
+      if (!findVertexLayout(*data, partLayout)) return {};
+
+      if (data->getVertexDesc()->getNumElements() != vertexDesc->getNumElements() ||
+          partLayout.stride != layout.stride || partLayout.position != layout.position ||
+          partLayout.normal != layout.normal || partLayout.tangent != layout.tangent)
+      {
+        return {};
+      }
+
+      const bs::SubMesh& subMesh = part.mesh->getProperties().getSubMesh(part.subMesh);
+
+      if (subMesh.drawOp != bs::DOT_TRIANGLE_LIST) return {};
+
+      // Vertices are copied once per part, even those the sub-mesh doesn't use. Not worth
+      // remapping, meshes worth merging are small.
+      numVertices += data->getNumVertices();
+      numIndices += subMesh.indexCount;
+    }
+
+    bs::SPtr<bs::MeshData> merged =
+        bs::MeshData::create(numVertices, numIndices, vertexDesc, bs::IT_32BIT);
+
+    bs::UINT8* vertices = merged->getStreamData(0);
+    bs::UINT32* indices = merged->getIndices32();
+
+    bs::UINT32 vertexOffset = 0;
+    bs::UINT32 indexOffset  = 0;
+
+    bs::Vector<bs::SubMesh> subMeshes;
+
+    for (bs::UINT32 target = 0; target < numTargetSubMeshes; target++)
+    {
+      bs::SubMesh targetSubMesh;
+      targetSubMesh.indexOffset = indexOffset;
+      targetSubMesh.drawOp      = bs::DOT_TRIANGLE_LIST;
+
+      for (const MeshMergePart& part : parts)
+      {
+        if (part.targetSubMesh != target) continue;
+
+        bs::SPtr<bs::MeshData> data = part.mesh->getCachedData();
+        const bs::SubMesh& subMesh  = part.mesh->getProperties().getSubMesh(part.subMesh);
+
+        bs::UINT32 partVertices = data->getNumVertices();
+
+        std::memcpy(vertices + (size_t)vertexOffset * layout.stride, data->getStreamData(0),
+                    (size_t)partVertices * layout.stride);
+
+        for (bs::UINT32 v = 0; v < partVertices; v++)
+        {
+          transformVertex(vertices + (size_t)(vertexOffset + v) * layout.stride, layout,
+                          part.transform);
+        }
+
+        for (bs::UINT32 i = 0; i < subMesh.indexCount; i++)
+        {
+          indices[indexOffset++] = vertexOffset + indexAt(*data, subMesh.indexOffset + i);
+        }
+
+        vertexOffset += partVertices;
+      }
+
+      targetSubMesh.indexCount = indexOffset - targetSubMesh.indexOffset;
+
+      if (targetSubMesh.indexCount == 0) return {};
+
+      subMeshes.push_back(targetSubMesh);
+    }
+
+    bs::MESH_DESC desc;
+    desc.numVertices = numVertices;
+    desc.numIndices  = numIndices;
+    desc.vertexDesc  = vertexDesc;
+    desc.indexType   = bs::IT_32BIT;
+    desc.subMeshes   = subMeshes;
+    desc.usage       = bs::MU_STATIC | bs::MU_CPUCACHED;
+
+    return bs::Mesh::create(merged, desc);
+  }
+
+  static bool findVertexLayout(const bs::MeshData& data, VertexLayout& layout)
+  {
+    bs::SPtr<bs::VertexDataDesc> desc = data.getVertexDesc();
+
+    // Everything has to be in one stream, so vertices can be copied as a whole
+    if (desc->getMaxStreamIdx() != 0) return false;
+
+    const bs::UINT8* stream = data.getStreamData(0);
+
+    if (!stream || !desc->hasElement(bs::VES_POSITION)) return false;
+
+    auto offsetOf = [&](bs::VertexElementSemantic semantic) {
+      return (bs::UINT32)(data.getElementData(semantic) - stream);
+    };
+
+    layout.stride   = desc->getVertexStride(0);
+    layout.position = offsetOf(bs::VES_POSITION);
+
+    if (desc->hasElement(bs::VES_NORMAL) && desc->getElementSize(bs::VES_NORMAL) >= 12)
+    {
+      layout.normal = offsetOf(bs::VES_NORMAL);
+    }
+
+    if (desc->hasElement(bs::VES_TANGENT) && desc->getElementSize(bs::VES_TANGENT) >= 12)
+    {
+      layout.tangent = offsetOf(bs::VES_TANGENT);
+    }
+
+    return true;
+  }
+
+  static void transformVertex(bs::UINT8* vertex, const VertexLayout& layout,
+                              const bs::Matrix4& transform)
+  {
+    bs::Vector3 value;
+
+    std::memcpy(&value, vertex + layout.position, sizeof(value));
+    value = transform.multiplyAffine(value);
+    std::memcpy(vertex + layout.position, &value, sizeof(value));
+
+    // Vobs are never scaled, so directions only need rotating
+    for (bs::UINT32 offset : {layout.normal, layout.tangent})
+    {
+      if (offset == VertexLayout::NO_ELEMENT) continue;
+
+      std::memcpy(&value, vertex + offset, sizeof(value));
+      value = bs::Vector3::normalize(transform.multiplyDirection(value));
+      std::memcpy(vertex + offset, &value, sizeof(value));
+    }
+  }
+
+  static bs::UINT32 indexAt(const bs::MeshData& data, bs::UINT32 i)
+  {
+    return data.getIndexType() == bs::IT_32BIT ? data.getIndices32()[i]
+                                               : (bs::UINT32)data.getIndices16()[i];
+  }
+}  // namespace REGoth
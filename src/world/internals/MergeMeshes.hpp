@@ -0,0 +1,47 @@
+/** \file
+ */
+
+#pragma once
+
+#include <BsPrerequisites.h>
+#include <Math/BsMatrix4.h>
+
+namespace REGoth
+{
+  namespace Internals
+  {
+    /**
+     * A sub-mesh to put into the mesh created by mergeMeshes().
+     */
+    struct MeshMergePart
+    {
+      /** Mesh to take the sub-mesh from. Must be CPU-cached. */
+      bs::HMesh mesh;
+
+      /** Sub-mesh of *mesh* to take */
+      bs::UINT32 subMesh = 0;
+
+      /** Sub-mesh of the merged mesh to put it into */
+      bs::UINT32 targetSubMesh = 0;
+
+      /** Transform from the space of *mesh* into the space of the merged mesh */
+      bs::Matrix4 transform = bs::Matrix4::IDENTITY;
+    };
+
+    /**
+     * Merges sub-meshes of (possibly different) meshes into a single mesh, with their vertices
+     * transformed as given. Positions, normals and tangents are transformed, anything else
+     * about a vertex is copied as it is.
+     *
+     * All meshes must share the same vertex layout, keep all vertex data in a single stream
+     * and only consist of triangle lists, which is how BsZenLib imports static meshes.
+     *
+     * @param  parts               Sub-meshes to merge.
+     * @param  numTargetSubMeshes  How many sub-meshes the merged mesh has. Each of them must
+     *                             get at least one part.
+     *
+     * @return The merged mesh, CPU-cached. Empty if the parts don't fit the requirements above.
+     */
+    bs::HMesh mergeMeshes(const bs::Vector<MeshMergePart>& parts, bs::UINT32 numTargetSubMeshes);
+  }  // namespace Internals
+}  // namespace REGoth
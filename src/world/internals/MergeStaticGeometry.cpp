@@ -0,0 +1,281 @@
+#include "MergeStaticGeometry.hpp"
+#include "MergeMeshes.hpp"
+#include <BsZenLib/ImportPath.hpp>
+#include <Components/BsCCollider.h>
+#include <Components/BsCMeshCollider.h>
+#include <Components/BsCRenderable.h>
+#include <Mesh/BsMesh.h>
+#include <Physics/BsPhysicsMesh.h>
+#include <RenderAPI/BsVertexDataDesc.h>
+#include <Resources/BsResources.h>
+#include <Scene/BsSceneObject.h>
+#include <components/VisualStaticMesh.hpp>
+#include <log/logging.hpp>
+#include <original-content/ResourceManifestJournal.hpp>
+#include <cmath>
+
+namespace REGoth
+{
+  /**
+   * Static geometry of one cell with the same vertex layout.
+   */
+  struct GeometryCell
+  {
+    bs::Vector<bs::HSceneObject> objects;
+  };
+
+  static bool isStaticGeometry(bs::HSceneObject so);
+  static bool hasTriangleCollider(bs::HSceneObject so);
+  static void removeMergedObject(bs::HSceneObject so);
+  static bool mergeCell(bs::HSceneObject root, const bs::Vector<bs::HSceneObject>& objects,
+                        const bs::String& name);
+
+  void Internals::mergeStaticGeometry(bs::HSceneObject root, const bs::String& cacheName)
+  {
+    bs::UnorderedMap<bs::String, GeometryCell> cells;
+
+    // Keep the cells in the order they were first seen in, so the cached meshes always get
+    // the same names for the same world
+    bs::Vector<bs::String> cellOrder;
+
+    for (bs::UINT32 i = 0; i < root->getNumChildren(); i++)
+    {
+      bs::HSceneObject child = root->getChild(i);
+
+      if (!isStaticGeometry(child)) continue;
+
+      bs::HMesh mesh = child->getComponent<VisualStaticMesh>()->mesh();
+
+      const bs::Vector3& position = child->getTransform().pos();
+
+      bs::INT32 x = (bs::INT32)std::floor(position.x / STATIC_GEOMETRY_CELL_SIZE);
+      bs::INT32 z = (bs::INT32)std::floor(position.z / STATIC_GEOMETRY_CELL_SIZE);
+
+      // Only meshes with the same vertex layout can be merged
+      bs::UINT32 stride = mesh->getCachedData()->getVertexDesc()->getVertexStride(0);
+
+      bs::String key = bs::toString(x) + "_" + bs::toString(z) + "_" + bs::toString(stride);
+
+      auto it = cells.find(key);
+
+      if (it == cells.end())
+      {
+        it = cells.emplace(key, GeometryCell{}).first;
+        cellOrder.push_back(key);
+      }
+
+      it->second.objects.push_back(child);
+    }
+
+    bs::UINT32 numMergedObjects = 0;
+    bs::UINT32 numCells         = 0;
+
+    for (const bs::String& key : cellOrder)
+    {
+      const GeometryCell& cell = cells[key];
+
+      // Nothing to win
+      if (cell.objects.size() < 2) continue;
+
+      bs::String name = cacheName + ".static" + bs::toString(numCells);
+
+      if (!mergeCell(root, cell.objects, name)) continue;
+
+      for (bs::HSceneObject so : cell.objects)
+      {
+        removeMergedObject(so);
+      }
+
+      numMergedObjects += (bs::UINT32)cell.objects.size();
+      numCells += 1;
+    }
+
+    REGOTH_LOG(Info, World,
+               "[MergeStaticGeometry] Merged {0} scene objects of {1} into {2}", numMergedObjects,
+               cacheName, numCells);
+  }
+
+  static bool isStaticGeometry(bs::HSceneObject so)
+  {
+    if (so->getNumChildren() != 0) return false;
+
+    HVisualStaticMesh visual = so->getComponent<VisualStaticMesh>();
+
+    if (!visual || !visual->isBatchable() || visual->hasLODs()) return false;
+    if (!so->getName().empty() && !visual->isMerged()) return false;
+
+    bs::HMesh mesh = visual->mesh();
+
+    if (!mesh || !mesh->getCachedData()) return false;
+
+    // Anything else means the scene object has something else to do
+    for (const bs::HComponent& component : so->getComponents())
+    {
+      if (bs::rtti_is_of_type<VisualStaticMesh>(component.get())) continue;
+      if (bs::rtti_is_of_type<bs::CRenderable>(component.get())) continue;
+      if (bs::rtti_is_subclass<bs::CCollider>(component.get())) continue;
+
+      return false;
+    }
+
+    return true;
+  }
+
+  /**
+   * Creates one scene object holding all the geometry of the given objects.
+   *
+   * @return Whether that worked out.
+   */
+  static bool mergeCell(bs::HSceneObject root, const bs::Vector<bs::HSceneObject>& objects,
+                        const bs::String& name)
+  {
+    bs::Vector3 center = bs::Vector3::ZERO;
+
+    for (bs::HSceneObject so : objects)
+    {
+      center += so->getTransform().pos();
+    }
+
+    center /= (float)objects.size();
+
+    bs::HSceneObject mergedSO = bs::SceneObject::create(name);
+    mergedSO->setParent(root);
+    mergedSO->setPosition(center);
+
+    bs::Matrix4 toMerged = mergedSO->getTransform().getInvMatrix();
+
+    // One sub-mesh per material
+    bs::Vector<bs::HMaterial> materials;
+    bs::UnorderedMap<bs::String, bs::UINT32> subMeshByMaterial;
+
+    bs::Vector<Internals::MeshMergePart> renderParts;
+    bs::Vector<Internals::MeshMergePart> collisionParts;
+
+    bs::UnorderedSet<bs::String> meshFileNames;
+
+    for (bs::HSceneObject so : objects)
+    {
+      HVisualStaticMesh visual = so->getComponent<VisualStaticMesh>();
+
+      bs::HMesh mesh                            = visual->mesh();
+      bs::Vector<bs::HMaterial> objectMaterials = visual->materials();
+      bool hasCollision                         = hasTriangleCollider(so);
+
+      meshFileNames.insert(visual->meshFileNames().begin(), visual->meshFileNames().end());
+
+      for (bs::UINT32 s = 0; s < mesh->getProperties().getNumSubMeshes(); s++)
+      {
+        if (s >= objectMaterials.size() || !objectMaterials[s]) continue;
+
+        bs::String materialKey = objectMaterials[s].getUUID().toString();
+
+        auto it = subMeshByMaterial.find(materialKey);
+
+        if (it == subMeshByMaterial.end())
+        {
+          materials.push_back(objectMaterials[s]);
+
+          it = subMeshByMaterial.emplace(materialKey, (bs::UINT32)materials.size() - 1).first;
+        }
+
+        Internals::MeshMergePart part;
+        part.mesh          = mesh;
+        part.subMesh       = s;
+        part.targetSubMesh = it->second;
+        part.transform     = toMerged * so->getTransform().getMatrix();
+
+        renderParts.push_back(part);
+
+        if (hasCollision)
+        {
+          part.targetSubMesh = 0;
+          collisionParts.push_back(part);
+        }
+      }
+    }
+
+    bs::HMesh merged = Internals::mergeMeshes(renderParts, (bs::UINT32)materials.size());
+
+    if (!merged)
+    {
+      mergedSO->destroy(true);
+      return false;
+    }
+
+    enum
+    {
+      Overwrite    = true,
+      KeepExisting = false,
+    };
+
+    bs::Path meshPath = BsZenLib::GothicPathToCachedStaticMesh(name);
+
+    merged->setName(name);
+
+    addToGothicCacheManifest(merged, meshPath);
+    bs::gResources().save(merged, meshPath, Overwrite);
+
+    HVisualStaticMesh visual = mergedSO->addComponent<VisualStaticMesh>();
+    visual->setBatchedMesh(merged, materials,
+                           bs::Vector<bs::String>(meshFileNames.begin(), meshFileNames.end()));
+
+    if (!collisionParts.empty())
+    {
+      bs::HMesh collisionMesh = Internals::mergeMeshes(collisionParts, 1);
+
+      if (collisionMesh)
+      {
+        bs::HPhysicsMesh physicsMesh =
+            bs::PhysicsMesh::create(collisionMesh->getCachedData(), bs::PhysicsMeshType::Triangle);
+
+        bs::Path physicsMeshPath = BsZenLib::GothicPathToCachedStaticMesh(name + ".physics");
+
+        addToGothicCacheManifest(physicsMesh, physicsMeshPath);
+        bs::gResources().save(physicsMesh, physicsMeshPath, Overwrite);
+
+        bs::HMeshCollider collider = mergedSO->addComponent<bs::CMeshCollider>();
+        collider->setMesh(physicsMesh);
+      }
+      else
+      {
+        // Walking through walls is worse than a few more scene objects
+        mergedSO->destroy(true);
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+  /**
+   * @return Whether the given object collides with the triangles of its mesh. Those go into
+   *         the merged physics mesh, cheaper colliders are kept as they are.
+   */
+  static bool hasTriangleCollider(bs::HSceneObject so)
+  {
+    bs::HMeshCollider collider = so->getComponent<bs::CMeshCollider>();
+
+    if (!collider || !collider->getMesh()) return false;
+
+    return collider->getMesh()->getType() == bs::PhysicsMeshType::Triangle;
+  }
+
+  /**
+   * Takes away what the merged scene object now does for the given one. Objects with a
+   * collider which wasn't merged keep it, everything else is destroyed.
+   *
+   * Destroys right away, so anything going through the scene after merging doesn't find
+   * what was merged anymore.
+   */
+  static void removeMergedObject(bs::HSceneObject so)
+  {
+    if (!so->getComponent<bs::CCollider>() || hasTriangleCollider(so))
+    {
+      so->destroy(true);
+      return;
+    }
+
+    so->getComponent<VisualStaticMesh>()->destroy(true);
+    so->getComponent<bs::CRenderable>()->destroy(true);
+  }
+}  // namespace REGoth
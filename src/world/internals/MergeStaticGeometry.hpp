@@ -0,0 +1,49 @@
+/** \file
+ */
+
+#pragma once
+
+#include <BsPrerequisites.h>
+
+namespace REGoth
+{
+  namespace Internals
+  {
+    /**
+     * What to do with the static geometry of a world when caching or saving it, see
+     * mergeStaticGeometry().
+     */
+    enum class StaticGeometry
+    {
+      Keep,
+      Merge,
+    };
+
+    /**
+     * Length of a side of the square cells, along the X- and Z-axis, whose static geometry
+     * is merged together, in meters.
+     */
+    constexpr float STATIC_GEOMETRY_CELL_SIZE = 32.0f;
+
+    /**
+     * Merges the static geometry inside each cell of the world into a single scene object,
+     * so a cached world holds far fewer scene objects. That speeds up instantiating it as
+     * well as everything going through the scene each frame.
+     *
+     * Static geometry means the direct children of the given root which show a static mesh
+     * and do nothing else: They only have a batchable VisualStaticMesh without less detailed
+     * versions, a renderable and maybe a collider, no name (scripts might look for it)
+     * unless they were merged before, and no children. See VisualStaticMesh::setBatchable()
+     * to keep a vob out.
+     *
+     * Per cell, their meshes are merged into one mesh with a sub-mesh per material, and the
+     * meshes of those colliding with their triangles into one physics mesh, see mergeMeshes().
+     * Both are cached under the given name. The merged scene objects are destroyed, except
+     * for those with a cheaper collider, which only keep that.
+     *
+     * @param  root       Scene object whose children should be merged, e.g. a GameWorld.
+     * @param  cacheName  Name to cache the merged meshes under, e.g. the ZEN-file.
+     */
+    void mergeStaticGeometry(bs::HSceneObject root, const bs::String& cacheName);
+  }  // namespace Internals
+}  // namespace REGoth